@@ -553,22 +553,79 @@ void WriteTilingToTIFF(const std::string& filename, Int diamond_size,
 }
 #endif  // ifdef CATAMARI_HAVE_LIBTIFF
 
-// Samples the Aztec diamond domino tiling a requested number of times using
-// both
-// sequential and OpenMP-parallelized algorithms.
+// Forms the marginal kernel of the DPP over the dimers of the domino tilings
+// of the Aztec diamond.
 template <typename Real>
-void DominoTilings(bool maximum_likelihood, Int diamond_size, Int block_size,
-                   Int tile_size, Int num_rounds, unsigned int random_seed,
-                   bool write_tiff, Int box_size) {
+void DominoTilingKernel(Int diamond_size,
+                        BlasMatrix<Complex<Real>>* kenyon_matrix) {
   CoordinateMatrix<Complex<Real>> kasteleyn_matrix;
   KasteleynMatrix(diamond_size, &kasteleyn_matrix);
 
   BlasMatrix<Complex<Real>> inverse_kasteleyn_matrix;
   InvertKasteleynMatrix(kasteleyn_matrix, &inverse_kasteleyn_matrix);
 
-  BlasMatrix<Complex<Real>> kenyon_matrix;
   KenyonMatrix(diamond_size, kasteleyn_matrix, inverse_kasteleyn_matrix,
-               &kenyon_matrix);
+               kenyon_matrix);
+}
+
+// Measures the throughput of sampling domino tilings of the Aztec diamond:
+// the kernel is formed, and the sampler constructed, once, and then each of
+// 'num_batches' batches draws 'num_samples' tilings concurrently, with every
+// thread reusing its factorization workspace across the samples and batches.
+template <typename Real>
+void DominoTilingThroughput(bool maximum_likelihood, Int diamond_size,
+                            Int block_size, Int num_samples, Int num_batches,
+                            unsigned int random_seed) {
+  quotient::Timer timer;
+  timer.Start();
+  BlasMatrix<Complex<Real>> kenyon_matrix;
+  DominoTilingKernel(diamond_size, &kenyon_matrix);
+  const catamari::NonHermitianDPPSampler<Complex<Real>> sampler(
+      kenyon_matrix.ConstView(), block_size);
+  const double setup_time = timer.Stop();
+  std::cout << "Kernel construction time: " << setup_time << " seconds."
+            << std::endl;
+
+  const Int matrix_size = sampler.NumItems();
+  const Int expected_sample_size = diamond_size * (diamond_size + 1);
+  const double flops_per_sample = 4 * 2 * std::pow(1. * matrix_size, 3.) / 3.;
+  double total_time = 0;
+  for (Int batch = 0; batch < num_batches; ++batch) {
+    timer.Start();
+    const std::vector<std::vector<Int>> samples = sampler.SampleMany(
+        num_samples, maximum_likelihood, random_seed + batch);
+    const double runtime = timer.Stop();
+    total_time += runtime;
+
+    for (const std::vector<Int>& sample : samples) {
+      if (Int(sample.size()) != expected_sample_size) {
+        std::cerr << "ERROR: Sampled " << sample.size() << " instead of "
+                  << expected_sample_size << " dimers." << std::endl;
+      }
+    }
+    std::cout << "Batch " << batch << ": " << num_samples / runtime
+              << " tilings/s, "
+              << num_samples * flops_per_sample / (1.e9 * runtime)
+              << " GFlop/s." << std::endl;
+  }
+
+  const Int total_samples = num_samples * num_batches;
+  std::cout << "Sampling throughput: " << total_samples / total_time
+            << " tilings/s." << std::endl;
+  std::cout << "Amortized time per tiling (with construction): "
+            << (setup_time + total_time) / total_samples << " seconds."
+            << std::endl;
+}
+
+// Samples the Aztec diamond domino tiling a requested number of times using
+// both
+// sequential and OpenMP-parallelized algorithms.
+template <typename Real>
+void DominoTilings(bool maximum_likelihood, Int diamond_size, Int block_size,
+                   Int tile_size, Int num_rounds, unsigned int random_seed,
+                   bool write_tiff, Int box_size) {
+  BlasMatrix<Complex<Real>> kenyon_matrix;
+  DominoTilingKernel(diamond_size, &kenyon_matrix);
 
   const Int expected_sample_size = diamond_size * (diamond_size + 1);
 
@@ -677,10 +734,31 @@ int main(int argc, char** argv) {
       "write_tiff", "Write out the results into a TIFF file?", true);
   const Int box_size = parser.OptionalInput<Int>(
       "box_size", "The pixel width of each TIFF vertex.", 10);
+  const Int num_samples = parser.OptionalInput<Int>(
+      "num_samples",
+      "If positive, the number of tilings sampled concurrently per batch of "
+      "a throughput benchmark, which replaces the rounds.",
+      0);
+  const Int num_batches = parser.OptionalInput<Int>(
+      "num_batches", "The number of batches of the throughput benchmark.", 3);
   if (!parser.OK()) {
     return 0;
   }
 
+  if (num_samples > 0) {
+    std::cout << "Single-precision throughput:" << std::endl;
+    DominoTilingThroughput<float>(maximum_likelihood, diamond_size,
+                                  block_size, num_samples, num_batches,
+                                  random_seed);
+    std::cout << std::endl;
+
+    std::cout << "Double-precision throughput:" << std::endl;
+    DominoTilingThroughput<double>(maximum_likelihood, diamond_size,
+                                   block_size, num_samples, num_batches,
+                                   random_seed);
+    return 0;
+  }
+
   std::cout << "Single-precision:" << std::endl;
   DominoTilings<float>(maximum_likelihood, diamond_size, block_size, tile_size,
                        num_rounds, random_seed, write_tiff, box_size);
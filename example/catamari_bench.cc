@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+// This driver times the symbolic analysis, factorization, refactorization
+// through a conversion plan, and multiple right-hand side solves of a fixed
+// corpus of sparse matrices -- the SuiteSparse matrices downloaded by
+// 'scripts/download-tests.sh' together with generated 2D and 3D negative
+// Laplacians and a 3D Helmholtz problem -- over a list of thread counts, and
+// emits the timings as JSON so that performance regressions can be tracked.
+//
+// Each timing is the minimum over the requested number of repetitions.
+//
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catamari/trace.hpp"
+#include "specify.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+// The timings of a single matrix at a single thread count.
+struct BenchmarkRecord {
+  // The name of the matrix.
+  std::string name;
+
+  // The scalar type of the matrix, either "real" or "complex".
+  std::string field;
+
+  // The name of the factorization type.
+  std::string factorization_type;
+
+  // The number of TBB threads the timings were collected with.
+  int num_threads = 1;
+
+  // The number of rows of the matrix.
+  Int num_rows = 0;
+
+  // The number of stored entries of the matrix.
+  Int num_entries = 0;
+
+  // The number of (structural) nonzeros in the factor.
+  Int num_factor_entries = 0;
+
+  // The number of floating-point operations of the factorization.
+  double num_flops = 0;
+
+  // Whether every pivot of each factorization succeeded.
+  bool success = true;
+
+  // The seconds spent in the symbolic analysis.
+  double symbolic_seconds = std::numeric_limits<double>::infinity();
+
+  // The seconds spent in the first numerical factorization.
+  double factor_seconds = std::numeric_limits<double>::infinity();
+
+  // The seconds spent forming the conversion plan.
+  double conversion_plan_seconds = std::numeric_limits<double>::infinity();
+
+  // The seconds spent refactoring through the conversion plan.
+  double refactor_seconds = std::numeric_limits<double>::infinity();
+
+  // The seconds spent in the solve with each number of right-hand sides.
+  std::vector<double> solve_seconds;
+};
+
+// The options shared by every benchmark.
+struct BenchmarkConfig {
+  // The thread counts to time each matrix with.
+  std::vector<int> thread_counts;
+
+  // The numbers of right-hand sides to time the solves with.
+  std::vector<int> num_right_hand_sides;
+
+  // The number of times each benchmark is repeated.
+  Int num_repetitions = 3;
+
+  // The control structure for real symmetric positive-definite matrices.
+  catamari::SparseLDLControl<double> real_control;
+
+  // The control structure for complex symmetric matrices.
+  catamari::SparseLDLControl<Complex<double>> complex_control;
+
+  // Print the progress of the benchmarks?
+  bool print_progress = false;
+};
+
+// Parses a comma-separated list of integers, keeping the positive ones.
+std::vector<int> ParseIntegerList(const std::string& list) {
+  std::vector<int> values;
+  std::istringstream stream(list);
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    if (token.empty()) continue;
+    const int value = std::stoi(token);
+    if (value > 0) values.push_back(value);
+  }
+  return values;
+}
+
+// Returns the name of a factorization type.
+std::string FactorizationTypeName(catamari::SymmetricFactorizationType type) {
+  switch (type) {
+    case catamari::kCholeskyFactorization:
+      return "cholesky";
+    case catamari::kLDLAdjointFactorization:
+      return "ldl_adjoint";
+    default:
+      return "ldl_transpose";
+  }
+}
+
+// Returns the scalar type name of a field.
+template <typename Field>
+std::string FieldName() {
+  return catamari::IsComplex<Field>::value ? "complex" : "real";
+}
+
+// Returns the shifted negative Laplacian of a 2D (if 'num_z' is one) or 3D
+// grid, where 'shift' is added to each diagonal entry.
+template <typename Field>
+std::unique_ptr<catamari::CoordinateMatrix<Field>> ShiftedNegativeLaplacian(
+    Int num_x, Int num_y, Int num_z, const Field& shift) {
+  std::unique_ptr<catamari::CoordinateMatrix<Field>> matrix(
+      new catamari::CoordinateMatrix<Field>);
+  const Int num_rows = num_x * num_y * num_z;
+  const Int num_dimensions = num_z > 1 ? 3 : 2;
+  matrix->Resize(num_rows, num_rows);
+  matrix->ReserveEntryAdditions((2 * num_dimensions + 1) * num_rows);
+  for (Int z = 0; z < num_z; ++z) {
+    for (Int y = 0; y < num_y; ++y) {
+      for (Int x = 0; x < num_x; ++x) {
+        const Int row = x + y * num_x + z * num_x * num_y;
+        matrix->QueueEntryAddition(row, row,
+                                   Field{2. * num_dimensions} + shift);
+        if (x > 0) matrix->QueueEntryAddition(row, row - 1, Field{-1});
+        if (x < num_x - 1) matrix->QueueEntryAddition(row, row + 1, Field{-1});
+        if (y > 0) matrix->QueueEntryAddition(row, row - num_x, Field{-1});
+        if (y < num_y - 1) {
+          matrix->QueueEntryAddition(row, row + num_x, Field{-1});
+        }
+        if (z > 0) {
+          matrix->QueueEntryAddition(row, row - num_x * num_y, Field{-1});
+        }
+        if (z < num_z - 1) {
+          matrix->QueueEntryAddition(row, row + num_x * num_y, Field{-1});
+        }
+      }
+    }
+  }
+  matrix->FlushEntryQueues();
+  return matrix;
+}
+
+// Returns a 7-point discretization of the 3D Helmholtz operator,
+// -Laplacian - omega^2, on a grid with ten points per wavelength, with a
+// damping imaginary shift standing in for absorbing boundary conditions.
+std::unique_ptr<catamari::CoordinateMatrix<Complex<double>>> Helmholtz3D(
+    Int num_x, Int num_y, Int num_z) {
+  const double pi = std::acos(-1.);
+  const double omega_squared = std::pow(2 * pi / 10, 2.);
+  return ShiftedNegativeLaplacian(
+      num_x, num_y, num_z,
+      Complex<double>(-omega_squared, omega_squared / 2));
+}
+
+// Times the factorization pipeline of a matrix at each thread count and
+// appends the results to 'records'.
+template <typename Field>
+void RunBenchmark(const std::string& name,
+                  const catamari::CoordinateMatrix<Field>& matrix,
+                  const catamari::SparseLDLControl<Field>& control,
+                  const BenchmarkConfig& config,
+                  std::vector<BenchmarkRecord>* records) {
+  const Int num_rows = matrix.NumRows();
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  for (const int num_threads : config.thread_counts) {
+    if (config.print_progress) {
+      std::cerr << "Benchmarking " << name << " with " << num_threads
+                << " threads..." << std::endl;
+    }
+    BenchmarkRecord record;
+    record.name = name;
+    record.field = FieldName<Field>();
+    record.factorization_type =
+        FactorizationTypeName(control.supernodal_control.factorization_type);
+    record.num_threads = num_threads;
+    record.num_rows = num_rows;
+    record.num_entries = matrix.NumEntries();
+    record.solve_seconds.assign(config.num_right_hand_sides.size(),
+                                std::numeric_limits<double>::infinity());
+
+    tbb::task_arena arena(num_threads);
+    arena.execute([&]() {
+      for (Int repetition = 0; repetition < config.num_repetitions;
+           ++repetition) {
+        catamari::SparseLDL<Field> ldl;
+        quotient::Timer timer;
+
+        timer.Start();
+        ldl.Factor(matrix, control, /* symbolic_only = */ true);
+        record.symbolic_seconds =
+            std::min(record.symbolic_seconds, timer.Stop());
+
+        timer.Start();
+        const catamari::SparseLDLResult<Field> result =
+            ldl.RefactorWithFixedSparsityPattern(matrix);
+        record.factor_seconds = std::min(record.factor_seconds, timer.Stop());
+        record.num_factor_entries = result.num_factorization_entries;
+        record.num_flops = result.num_factorization_flops;
+        record.success =
+            record.success && result.num_successful_pivots == num_rows;
+
+        catamari::ConversionPlan cplan;
+        timer.Start();
+        ldl.FormConversionPlan(matrix, &cplan);
+        record.conversion_plan_seconds =
+            std::min(record.conversion_plan_seconds, timer.Stop());
+
+        timer.Start();
+        const catamari::SparseLDLResult<Field> refactor_result =
+            ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+        record.refactor_seconds =
+            std::min(record.refactor_seconds, timer.Stop());
+        record.success = record.success &&
+                         refactor_result.num_successful_pivots == num_rows;
+
+        for (std::size_t k = 0; k < record.solve_seconds.size(); ++k) {
+          const Int num_rhs = config.num_right_hand_sides[k];
+          BlasMatrix<Field> right_hand_sides;
+          right_hand_sides.Resize(num_rows, num_rhs);
+          for (Int j = 0; j < num_rhs; ++j) {
+            for (Int i = 0; i < num_rows; ++i) {
+              right_hand_sides(i, j) = Field(double((i + j) % 5));
+            }
+          }
+          timer.Start();
+          ldl.Solve(&right_hand_sides.view);
+          record.solve_seconds[k] =
+              std::min(record.solve_seconds[k], timer.Stop());
+        }
+      }
+    });
+    records->push_back(record);
+  }
+}
+
+// Benchmarks each of the matrices downloaded by 'scripts/download-tests.sh'
+// which is present in the given directory.
+void RunSuiteSparseBenchmarks(const std::string& matrix_market_directory,
+                              const BenchmarkConfig& config,
+                              std::vector<BenchmarkRecord>* records) {
+  const std::vector<std::string> matrix_names{
+      "Serena",
+      "Geo_1438",
+      "Hook_1498",
+      "bone010",
+      "ldoor",
+      "boneS10",
+      "Emilia_923",
+      "PFlow_742",
+      "inline_1",
+      "nd24k",
+      "Fault_639",
+      "StocF-1465",
+      "bundle_adj",
+      "msdoor",
+      "af_shell7",
+      "af_shell8",
+      "af_shell4",
+      "af_shell3",
+      "af_3_k101",
+      "ted_B",
+      "ted_B_unscaled",
+      "bodyy6",
+      "bodyy5",
+      "aft01",
+      "bodyy4",
+      "bcsstk15",
+      "crystm01",
+      "nasa4704",
+      "LF10000",
+      "mesh3e1",
+      "bcsstm09",
+      "bcsstm08",
+      "nos1",
+      "bcsstm19",
+      "bcsstk22",
+      "bcsstk03",
+      "nos4",
+      "bcsstm20",
+      "bcsstm06",
+      "bcsstk01",
+      "mesh1em6",
+      "mesh1em1",
+      "mesh1e1",
+  };
+  for (const std::string& matrix_name : matrix_names) {
+    const std::string filename =
+        matrix_market_directory + "/" + matrix_name + ".mtx";
+    if (!std::ifstream(filename).good()) {
+      if (config.print_progress) {
+        std::cerr << "Skipping missing " << filename << std::endl;
+      }
+      continue;
+    }
+    std::unique_ptr<catamari::CoordinateMatrix<double>> matrix =
+        catamari::CoordinateMatrix<double>::FromMappedMatrixMarket(
+            filename, /* skip_explicit_zeros = */ false);
+    if (!matrix) {
+      std::cerr << "Could not read " << filename << std::endl;
+      continue;
+    }
+    RunBenchmark(matrix_name, *matrix, config.real_control, config, records);
+  }
+}
+
+// Writes a string as a JSON string literal.
+void WriteJSONString(const std::string& value, std::ostream& os) {
+  os << '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\') os << '\\';
+    os << c;
+  }
+  os << '"';
+}
+
+// Writes a (possibly infinite) number of seconds as a JSON value.
+void WriteJSONSeconds(double seconds, std::ostream& os) {
+  if (std::isfinite(seconds)) {
+    os << seconds;
+  } else {
+    os << "null";
+  }
+}
+
+// Writes the records as a JSON document.
+void WriteJSON(const BenchmarkConfig& config,
+               const std::vector<BenchmarkRecord>& records, std::ostream& os) {
+  os.precision(6);
+  os << "{\n  \"benchmarks\": [";
+  for (std::size_t index = 0; index < records.size(); ++index) {
+    const BenchmarkRecord& record = records[index];
+    os << (index ? ",\n" : "\n") << "    {\"name\": ";
+    WriteJSONString(record.name, os);
+    os << ", \"field\": ";
+    WriteJSONString(record.field, os);
+    os << ", \"factorization_type\": ";
+    WriteJSONString(record.factorization_type, os);
+    os << ",\n     \"num_threads\": " << record.num_threads
+       << ", \"num_rows\": " << record.num_rows
+       << ", \"num_entries\": " << record.num_entries
+       << ", \"num_factor_entries\": " << record.num_factor_entries
+       << ", \"num_flops\": " << record.num_flops
+       << ", \"success\": " << (record.success ? "true" : "false");
+    os << ",\n     \"symbolic_seconds\": ";
+    WriteJSONSeconds(record.symbolic_seconds, os);
+    os << ", \"factor_seconds\": ";
+    WriteJSONSeconds(record.factor_seconds, os);
+    os << ", \"conversion_plan_seconds\": ";
+    WriteJSONSeconds(record.conversion_plan_seconds, os);
+    os << ", \"refactor_seconds\": ";
+    WriteJSONSeconds(record.refactor_seconds, os);
+    os << ",\n     \"solve_seconds\": {";
+    for (std::size_t k = 0; k < record.solve_seconds.size(); ++k) {
+      os << (k ? ", " : "") << '"' << config.num_right_hand_sides[k]
+         << "\": ";
+      WriteJSONSeconds(record.solve_seconds[k], os);
+    }
+    os << "}}";
+  }
+  os << "\n  ]\n}" << std::endl;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  specify::ArgumentParser parser(argc, argv);
+  const std::string matrix_market_directory = parser.OptionalInput<std::string>(
+      "matrix_market_directory",
+      "The directory into which scripts/download-tests.sh downloaded the "
+      "SuiteSparse matrices (which are skipped if empty).",
+      "");
+  const Int laplacian_2d_size = parser.OptionalInput<Int>(
+      "laplacian_2d_size",
+      "The number of grid points in each dimension of the 2D negative "
+      "Laplacian (zero skips it).",
+      500);
+  const Int laplacian_3d_size = parser.OptionalInput<Int>(
+      "laplacian_3d_size",
+      "The number of grid points in each dimension of the 3D negative "
+      "Laplacian (zero skips it).",
+      50);
+  const Int helmholtz_3d_size = parser.OptionalInput<Int>(
+      "helmholtz_3d_size",
+      "The number of grid points in each dimension of the 3D Helmholtz "
+      "problem (zero skips it).",
+      40);
+  const std::string thread_counts = parser.OptionalInput<std::string>(
+      "thread_counts",
+      "A comma-separated list of thread counts (by default, one and the "
+      "maximum concurrency).",
+      "");
+  const std::string num_right_hand_sides = parser.OptionalInput<std::string>(
+      "num_right_hand_sides",
+      "A comma-separated list of the numbers of right-hand sides to solve "
+      "against.",
+      "1,16,256");
+  const Int num_repetitions = parser.OptionalInput<Int>(
+      "num_repetitions", "The number of times each benchmark is repeated.",
+      3);
+  const bool nested_dissection = parser.OptionalInput<bool>(
+      "nested_dissection",
+      "Reorder by nested dissection rather than minimum degree?", false);
+  const std::string output = parser.OptionalInput<std::string>(
+      "output", "The file to write the JSON results to (default: stdout).",
+      "");
+  const bool print_progress = parser.OptionalInput<bool>(
+      "print_progress", "Print the progress of the benchmarks?", false);
+  const std::string trace_output = parser.OptionalInput<std::string>(
+      "trace_output",
+      "If nonempty, the file to write a Chrome trace of the runs to.", "");
+  if (!parser.OK()) {
+    return 0;
+  }
+
+  BenchmarkConfig config;
+  config.thread_counts = ParseIntegerList(thread_counts);
+  if (config.thread_counts.empty()) {
+    config.thread_counts.push_back(1);
+    const int max_concurrency = tbb::this_task_arena::max_concurrency();
+    if (max_concurrency > 1) config.thread_counts.push_back(max_concurrency);
+  }
+  config.num_right_hand_sides = ParseIntegerList(num_right_hand_sides);
+  config.num_repetitions = std::max(num_repetitions, Int(1));
+  config.print_progress = print_progress;
+
+  // The real matrices are factored with a supernodal Cholesky factorization
+  // and the complex symmetric ones with a supernodal LDL^T factorization.
+  config.real_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  config.complex_control.SetFactorizationType(
+      catamari::kLDLTransposeFactorization);
+  config.real_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  config.complex_control.supernodal_strategy =
+      catamari::kSupernodalFactorization;
+  if (nested_dissection) {
+    config.real_control.reordering_strategy =
+        catamari::kNestedDissectionReordering;
+    config.complex_control.reordering_strategy =
+        catamari::kNestedDissectionReordering;
+  }
+
+  if (!trace_output.empty()) {
+    catamari::Tracer::Global().Enable();
+  }
+
+  std::vector<BenchmarkRecord> records;
+  if (!matrix_market_directory.empty()) {
+    RunSuiteSparseBenchmarks(matrix_market_directory, config, &records);
+  }
+  if (laplacian_2d_size > 0) {
+    const auto matrix = ShiftedNegativeLaplacian<double>(
+        laplacian_2d_size, laplacian_2d_size, 1, 0.);
+    RunBenchmark("laplacian_2d_" + std::to_string(laplacian_2d_size), *matrix,
+                 config.real_control, config, &records);
+  }
+  if (laplacian_3d_size > 0) {
+    const auto matrix = ShiftedNegativeLaplacian<double>(
+        laplacian_3d_size, laplacian_3d_size, laplacian_3d_size, 0.);
+    RunBenchmark("laplacian_3d_" + std::to_string(laplacian_3d_size), *matrix,
+                 config.real_control, config, &records);
+  }
+  if (helmholtz_3d_size > 0) {
+    const auto matrix =
+        Helmholtz3D(helmholtz_3d_size, helmholtz_3d_size, helmholtz_3d_size);
+    RunBenchmark("helmholtz_3d_" + std::to_string(helmholtz_3d_size), *matrix,
+                 config.complex_control, config, &records);
+  }
+
+  if (!trace_output.empty()) {
+    catamari::Tracer& tracer = catamari::Tracer::Global();
+    tracer.Disable();
+    if (!tracer.WriteChromeTrace(trace_output)) {
+      std::cerr << "Could not open " << trace_output << std::endl;
+      return 1;
+    }
+    if (tracer.NumDroppedEvents()) {
+      std::cerr << "The trace dropped " << tracer.NumDroppedEvents()
+                << " of the earliest events." << std::endl;
+    }
+  }
+
+  if (output.empty()) {
+    WriteJSON(config, records, std::cout);
+  } else {
+    std::ofstream file(output);
+    if (!file) {
+      std::cerr << "Could not open " << output << std::endl;
+      return 1;
+    }
+    WriteJSON(config, records, file);
+  }
+
+  return 0;
+}
@@ -5,7 +5,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include <fstream>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "catamari/apply_sparse.hpp"
@@ -115,14 +117,42 @@ std::pair<Int, Int> DensestRow(
   return std::make_pair(densest_row_size, densest_row_index);
 }
 
+// Reads the Matrix Market file. If 'binary_cache' is true, the parsed matrix
+// is cached in a binary file alongside it (keyed by the reading options) so
+// that subsequent runs need not parse the text again.
+template <typename Field>
+std::unique_ptr<catamari::CoordinateMatrix<Field>> ReadMatrix(
+    const std::string& filename, bool skip_explicit_zeros,
+    quotient::EntryMask mask, bool binary_cache) {
+  typedef catamari::CoordinateMatrix<Field> Matrix;
+  if (!binary_cache) {
+    return Matrix::FromMappedMatrixMarket(filename, skip_explicit_zeros, mask);
+  }
+
+  const std::string cache_filename =
+      filename + ".mask" + std::to_string(int(mask)) +
+      (skip_explicit_zeros ? ".nonzero" : "") + ".bin";
+  std::unique_ptr<Matrix> matrix;
+  if (std::ifstream(cache_filename).good()) {
+    matrix = Matrix::FromBinary(cache_filename);
+  }
+  if (!matrix) {
+    matrix =
+        Matrix::FromMappedMatrixMarket(filename, skip_explicit_zeros, mask);
+    if (matrix) matrix->ToBinary(cache_filename);
+  }
+  return matrix;
+}
+
 // With a sufficiently large choice of 'relative_shift', this routine returns
 // a symmetric positive-definite sparse matrix corresponding to the Matrix
 // Market example living in the given file.
 template <typename Field>
 std::unique_ptr<catamari::CoordinateMatrix<Field>> LoadMatrix(
     const std::string& filename, bool skip_explicit_zeros,
-    quotient::EntryMask mask, bool force_symmetry, bool hermitian,
-    const Field& relative_shift, double drop_tolerance, bool print_progress) {
+    quotient::EntryMask mask, bool binary_cache, bool force_symmetry,
+    bool hermitian, const Field& relative_shift, double drop_tolerance,
+    bool print_progress) {
   typedef catamari::ComplexBase<Field> Real;
 
   if (print_progress) {
@@ -130,8 +160,7 @@ std::unique_ptr<catamari::CoordinateMatrix<Field>> LoadMatrix(
               << std::endl;
   }
   std::unique_ptr<catamari::CoordinateMatrix<Field>> matrix =
-      catamari::CoordinateMatrix<Field>::FromMatrixMarket(
-          filename, skip_explicit_zeros, mask);
+      ReadMatrix<Field>(filename, skip_explicit_zeros, mask, binary_cache);
   if (!matrix) {
     std::cerr << "Could not open " << filename << "." << std::endl;
     return matrix;
@@ -207,8 +236,8 @@ void GenerateRightHandSide(Int num_rows, BlasMatrix<Field>* right_hand_side) {
 // Returns the Experiment statistics for a single Matrix Market input matrix.
 Experiment RunMatrixMarketTest(
     const std::string& filename, bool skip_explicit_zeros,
-    quotient::EntryMask mask, bool force_symmetry, double relative_shift,
-    double drop_tolerance,
+    quotient::EntryMask mask, bool binary_cache, bool force_symmetry,
+    double relative_shift, double drop_tolerance,
     const catamari::SparseLDLControl<double>& ldl_control,
     bool print_progress) {
   typedef double Field;
@@ -219,8 +248,9 @@ Experiment RunMatrixMarketTest(
   const bool hermitian = ldl_control.supernodal_control.factorization_type !=
                          catamari::kLDLTransposeFactorization;
   std::unique_ptr<catamari::CoordinateMatrix<Field>> matrix =
-      LoadMatrix(filename, skip_explicit_zeros, mask, force_symmetry, hermitian,
-                 relative_shift, drop_tolerance, print_progress);
+      LoadMatrix(filename, skip_explicit_zeros, mask, binary_cache,
+                 force_symmetry, hermitian, relative_shift, drop_tolerance,
+                 print_progress);
   if (!matrix) {
     return experiment;
   }
@@ -241,6 +271,15 @@ Experiment RunMatrixMarketTest(
               << " pivots." << std::endl;
     return experiment;
   }
+  if (print_progress) {
+    std::cout << "  Relaxed " << result.num_fundamental_supernodes
+              << " fundamental supernodes into "
+              << result.num_relaxed_supernodes << " with "
+              << result.num_relaxation_zeros
+              << " explicit zeros (predicted factorization time: "
+              << result.relaxation_estimated_seconds << " seconds)."
+              << std::endl;
+  }
   experiment.num_nonzeros = result.num_factorization_entries;
   experiment.num_diagonal_flops = result.num_diagonal_flops;
   experiment.num_subdiag_solve_flops = result.num_subdiag_solve_flops;
@@ -289,7 +328,8 @@ Experiment RunMatrixMarketTest(
 // suite of SPD Matrix Market matrices.
 std::unordered_map<std::string, Experiment> RunCustomTests(
     const std::string& matrix_market_directory, bool skip_explicit_zeros,
-    quotient::EntryMask mask, double relative_shift, double drop_tolerance,
+    quotient::EntryMask mask, bool binary_cache, double relative_shift,
+    double drop_tolerance,
     const catamari::SparseLDLControl<double>& ldl_control,
     bool print_progress) {
   // The list of matrices tested in:
@@ -341,8 +381,8 @@ std::unordered_map<std::string, Experiment> RunCustomTests(
     std::cout << "Testing " << filename << std::endl;
     try {
       experiments[matrix_name] = RunMatrixMarketTest(
-          filename, skip_explicit_zeros, mask, force_symmetry, relative_shift,
-          drop_tolerance, ldl_control, print_progress);
+          filename, skip_explicit_zeros, mask, binary_cache, force_symmetry,
+          relative_shift, drop_tolerance, ldl_control, print_progress);
       PrintExperiment(experiments[matrix_name], matrix_name);
     } catch (std::exception& error) {
       std::cerr << "Caught exception: " << error.what() << std::endl;
@@ -366,6 +406,9 @@ int main(int argc, char** argv) {
                                 "The quotient::EntryMask integer.\n"
                                 "0:full, 1:lower-triangle, 2:upper-triangle",
                                 0);
+  const bool binary_cache = parser.OptionalInput<bool>(
+      "binary_cache",
+      "Cache the parsed matrix in a binary file next to the input?", false);
   const bool allow_supernodes = parser.OptionalInput<bool>(
       "allow_supernodes", "Allow Minimum Degree supernodes?", true);
   const int degree_type_int =
@@ -406,8 +449,16 @@ int main(int argc, char** argv) {
                                 "The SupernodalStrategy int.\n"
                                 "0:scalar, 1:supernodal, 2:adaptive",
                                 2);
+  const bool nested_dissection = parser.OptionalInput<bool>(
+      "nested_dissection",
+      "Reorder by nested dissection rather than minimum degree?", false);
   const bool relax_supernodes = parser.OptionalInput<bool>(
       "relax_supernodes", "Relax the supernodes?", true);
+  const bool relaxation_cost_model = parser.OptionalInput<bool>(
+      "relaxation_cost_model",
+      "Relax the supernodes using a calibrated cost model rather than fixed "
+      "explicit zero ratios?",
+      false);
   const double relative_shift = parser.OptionalInput<Real>(
       "relative_shift", "We add || A ||_F * relative_shift to the diagonal",
       2.1);
@@ -458,6 +509,9 @@ int main(int argc, char** argv) {
           factorization_type_int));
   ldl_control.supernodal_strategy =
       static_cast<catamari::SupernodalStrategy>(supernodal_strategy_int);
+  if (nested_dissection) {
+    ldl_control.reordering_strategy = catamari::kNestedDissectionReordering;
+  }
 
   // Set the minimum degree control options.
   {
@@ -488,20 +542,26 @@ int main(int argc, char** argv) {
     sn_control.sort_grain_size = sort_grain_size;
 #endif  // ifdef CATAMARI_OPENMP
     sn_control.relaxation_control.relax_supernodes = relax_supernodes;
+    sn_control.relaxation_control.use_cost_model = relaxation_cost_model;
+    if (relaxation_cost_model) {
+      sn_control.relaxation_control.cost_model =
+          catamari::supernodal_ldl::CalibrateSupernodalRelaxationCostModel<
+              double>();
+    }
   }
 
   if (!matrix_market_directory.empty()) {
     const std::unordered_map<std::string, Experiment> experiments =
         RunCustomTests(matrix_market_directory, skip_explicit_zeros, mask,
-                       relative_shift, drop_tolerance, ldl_control,
-                       print_progress);
+                       binary_cache, relative_shift, drop_tolerance,
+                       ldl_control, print_progress);
     for (const std::pair<std::string, Experiment>& pairing : experiments) {
       PrintExperiment(pairing.second, pairing.first);
     }
   } else {
     const Experiment experiment = RunMatrixMarketTest(
-        filename, skip_explicit_zeros, mask, force_symmetry, relative_shift,
-        drop_tolerance, ldl_control, print_progress);
+        filename, skip_explicit_zeros, mask, binary_cache, force_symmetry,
+        relative_shift, drop_tolerance, ldl_control, print_progress);
     PrintExperiment(experiment, filename);
   }
 
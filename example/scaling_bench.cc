@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+// This driver measures the strong scaling of the multithreaded right-looking
+// factorization and of the multithreaded triangular solves of a 2D or 3D
+// negative Laplacian by sweeping the number of TBB threads (as limited by a
+// 'tbb::global_control') from one up to a maximum, both with the threads
+// left to the operating system and with each pinned to its own CPU.
+//
+// For each thread count it reports the minimum factorization and solve
+// times over the repetitions, the speedups and parallel efficiencies
+// relative to a single thread, the number of supernodal tasks, and the idle
+// seconds of the threads: the time not spent within a traced scope of a
+// supernode (see 'TraceScope') during the factorization. The speedup bound given by the ratio
+// of the total work to the critical path of the assembly forest is also
+// printed.
+//
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // ifdef __linux__
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catamari/trace.hpp"
+#include "specify.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns the negative Laplacian of a 2D (if 'num_z' is one) or 3D grid.
+std::unique_ptr<catamari::CoordinateMatrix<double>> NegativeLaplacian(
+    Int num_x, Int num_y, Int num_z) {
+  std::unique_ptr<catamari::CoordinateMatrix<double>> matrix(
+      new catamari::CoordinateMatrix<double>);
+  const Int num_rows = num_x * num_y * num_z;
+  const Int num_dimensions = num_z > 1 ? 3 : 2;
+  matrix->Resize(num_rows, num_rows);
+  matrix->ReserveEntryAdditions((2 * num_dimensions + 1) * num_rows);
+  for (Int z = 0; z < num_z; ++z) {
+    for (Int y = 0; y < num_y; ++y) {
+      for (Int x = 0; x < num_x; ++x) {
+        const Int row = x + y * num_x + z * num_x * num_y;
+        matrix->QueueEntryAddition(row, row, 2. * num_dimensions);
+        if (x > 0) matrix->QueueEntryAddition(row, row - 1, -1.);
+        if (x < num_x - 1) matrix->QueueEntryAddition(row, row + 1, -1.);
+        if (y > 0) matrix->QueueEntryAddition(row, row - num_x, -1.);
+        if (y < num_y - 1) matrix->QueueEntryAddition(row, row + num_x, -1.);
+        if (z > 0) {
+          matrix->QueueEntryAddition(row, row - num_x * num_y, -1.);
+        }
+        if (z < num_z - 1) {
+          matrix->QueueEntryAddition(row, row + num_x * num_y, -1.);
+        }
+      }
+    }
+  }
+  matrix->FlushEntryQueues();
+  return matrix;
+}
+
+// Pins each thread which joins an arena to its own CPU (in the order of its
+// slot within the arena), and restores the original affinity of the thread
+// when it leaves.
+class PinningObserver : public tbb::task_scheduler_observer {
+ public:
+  explicit PinningObserver(tbb::task_arena& arena)
+      : tbb::task_scheduler_observer(arena) {
+#ifdef __linux__
+    CPU_ZERO(&original_cpus_);
+    sched_getaffinity(0, sizeof(original_cpus_), &original_cpus_);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &original_cpus_)) cpus_.push_back(cpu);
+    }
+#endif  // ifdef __linux__
+    observe(true);
+  }
+
+  ~PinningObserver() { observe(false); }
+
+  void on_scheduler_entry(bool /* is_worker */) override {
+#ifdef __linux__
+    const int slot = tbb::this_task_arena::current_thread_index();
+    if (cpus_.empty() || slot < 0) return;
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpus_[slot % cpus_.size()], &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#endif  // ifdef __linux__
+  }
+
+  void on_scheduler_exit(bool /* is_worker */) override {
+#ifdef __linux__
+    pthread_setaffinity_np(pthread_self(), sizeof(original_cpus_),
+                           &original_cpus_);
+#endif  // ifdef __linux__
+  }
+
+ private:
+#ifdef __linux__
+  // The affinity of the thread which created the observer.
+  cpu_set_t original_cpus_;
+#endif  // ifdef __linux__
+
+  // The CPUs within the original affinity.
+  std::vector<int> cpus_;
+};
+
+// The measurements of a single thread count.
+struct ScalingRecord {
+  // The number of threads.
+  int num_threads = 1;
+
+  // Whether the threads were pinned to CPUs.
+  bool pinned = false;
+
+  // Whether every pivot of each factorization succeeded.
+  bool success = true;
+
+  // The minimum seconds of the factorizations and of the solves.
+  double factor_seconds = std::numeric_limits<double>::infinity();
+  double solve_seconds = std::numeric_limits<double>::infinity();
+
+  // The number of factor, trsm, herk, and merge tasks of a factorization.
+  Int num_tasks = 0;
+
+  // The seconds during which the threads of the (last) factorization were
+  // not within the traced scope of a supernode.
+  double idle_seconds = 0;
+};
+
+// Returns the seconds spent by each thread within the union of its events
+// which belong to a supernode (e.g., rather than to the entire
+// factorization).
+std::vector<double> BusySeconds(
+    const std::vector<catamari::TraceEvent>& events, double ticks_per_second) {
+  std::vector<double> busy_seconds;
+  std::vector<std::uint64_t> covered_end;
+  for (const catamari::TraceEvent& event : events) {
+    if (event.supernode < 0) continue;
+
+    // The events are ordered by their beginnings, so the portion of each
+    // beyond the end of those before it on its thread is newly covered.
+    if (std::size_t(event.thread) >= busy_seconds.size()) {
+      busy_seconds.resize(event.thread + 1, 0.);
+      covered_end.resize(event.thread + 1, 0);
+    }
+    const std::uint64_t begin =
+        std::max(event.begin, covered_end[event.thread]);
+    if (event.end > begin) {
+      busy_seconds[event.thread] += (event.end - begin) / ticks_per_second;
+      covered_end[event.thread] = event.end;
+    }
+  }
+  return busy_seconds;
+}
+
+// Factors and solves with the given number of threads.
+ScalingRecord MeasureScaling(const catamari::CoordinateMatrix<double>& matrix,
+                             int num_threads, bool pinned, Int num_rhs,
+                             Int num_repetitions,
+                             catamari::SparseLDL<double>* ldl) {
+  const Int num_rows = matrix.NumRows();
+  ScalingRecord record;
+  record.num_threads = num_threads;
+  record.pinned = pinned;
+
+  tbb::global_control global_control(
+      tbb::global_control::max_allowed_parallelism, num_threads);
+  tbb::task_arena arena(num_threads);
+  std::unique_ptr<PinningObserver> observer;
+  if (pinned) observer.reset(new PinningObserver(arena));
+
+  catamari::Tracer& tracer = catamari::Tracer::Global();
+  arena.execute([&]() {
+    for (Int repetition = 0; repetition < num_repetitions; ++repetition) {
+      // Only the last factorization is traced.
+      const bool traced = repetition == num_repetitions - 1;
+      if (traced) tracer.Enable();
+      const std::uint64_t begin_ticks = catamari::TraceTimestamp();
+      quotient::Timer timer;
+      timer.Start();
+      const catamari::SparseLDLResult<double> result =
+          ldl->RefactorWithFixedSparsityPattern(matrix);
+      const double seconds = timer.Stop();
+      const std::uint64_t end_ticks = catamari::TraceTimestamp();
+      record.factor_seconds = std::min(record.factor_seconds, seconds);
+      record.success =
+          record.success && result.num_successful_pivots == num_rows;
+      record.num_tasks = result.num_factor_tasks + result.num_trsm_tasks +
+                         result.num_herk_tasks + result.num_merge_tasks;
+
+      if (traced) {
+        tracer.Disable();
+        const double ticks_per_second = (end_ticks - begin_ticks) / seconds;
+        const std::vector<double> busy_seconds =
+            BusySeconds(tracer.Events(), ticks_per_second);
+        double total_busy_seconds = 0;
+        for (const double thread_seconds : busy_seconds) {
+          total_busy_seconds += thread_seconds;
+        }
+        record.idle_seconds =
+            std::max(num_threads * seconds - total_busy_seconds, 0.);
+      }
+
+      BlasMatrix<double> right_hand_sides;
+      right_hand_sides.Resize(num_rows, num_rhs, 1.);
+      timer.Start();
+      ldl->Solve(&right_hand_sides.view);
+      record.solve_seconds = std::min(record.solve_seconds, timer.Stop());
+    }
+  });
+  return record;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  specify::ArgumentParser parser(argc, argv);
+  const Int num_x = parser.OptionalInput<Int>(
+      "num_x", "The number of grid points in the x dimension.", 40);
+  const Int num_y = parser.OptionalInput<Int>(
+      "num_y", "The number of grid points in the y dimension.", 40);
+  const Int num_z = parser.OptionalInput<Int>(
+      "num_z", "The number of grid points in the z dimension (one for 2D).",
+      40);
+  const int max_threads = parser.OptionalInput<int>(
+      "max_threads",
+      "The largest number of threads (by default, the maximum concurrency).",
+      0);
+  const Int num_rhs = parser.OptionalInput<Int>(
+      "num_rhs", "The number of right-hand sides of the solves.", 1);
+  const Int num_repetitions = parser.OptionalInput<Int>(
+      "num_repetitions", "The number of times each measurement is repeated.",
+      3);
+  const bool dataflow_scheduling = parser.OptionalInput<bool>(
+      "dataflow_scheduling",
+      "Schedule the supernodes above the serial subtrees as a dataflow "
+      "graph?",
+      false);
+  const bool nested_dissection = parser.OptionalInput<bool>(
+      "nested_dissection",
+      "Reorder by nested dissection rather than minimum degree?", false);
+  if (!parser.OK()) {
+    return 0;
+  }
+
+  const int num_threads_limit =
+      max_threads > 0 ? max_threads : tbb::this_task_arena::max_concurrency();
+  const auto matrix = NegativeLaplacian(num_x, num_y, num_z);
+
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  control.supernodal_control.dataflow_scheduling = dataflow_scheduling;
+  if (nested_dissection) {
+    control.reordering_strategy = catamari::kNestedDissectionReordering;
+  }
+
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(*matrix, control, /* symbolic_only = */ true);
+  double critical_path_work;
+  const double total_work =
+      ldl.supernodal_factorization->WorkEstimates(&critical_path_work);
+  std::cout << "Matrix: " << num_x << " x " << num_y << " x " << num_z
+            << " negative Laplacian, " << matrix->NumRows() << " rows\n"
+            << "Total work: " << total_work
+            << ", critical path work: " << critical_path_work
+            << ", speedup bound: " << total_work / critical_path_work
+            << "\n\n";
+
+  std::cout << std::setw(8) << "threads" << std::setw(8) << "pinned"
+            << std::setw(14) << "factor_sec" << std::setw(10) << "speedup"
+            << std::setw(12) << "efficiency" << std::setw(14) << "solve_sec"
+            << std::setw(10) << "speedup" << std::setw(12) << "efficiency"
+            << std::setw(10) << "tasks" << std::setw(12) << "idle_sec"
+            << "\n";
+  for (const bool pinned : {false, true}) {
+    ScalingRecord serial;
+    for (int num_threads = 1; num_threads <= num_threads_limit;
+         ++num_threads) {
+      const ScalingRecord record =
+          MeasureScaling(*matrix, num_threads, pinned, num_rhs,
+                         std::max(num_repetitions, Int(1)), &ldl);
+      if (num_threads == 1) serial = record;
+      const double factor_speedup =
+          serial.factor_seconds / record.factor_seconds;
+      const double solve_speedup = serial.solve_seconds / record.solve_seconds;
+      std::cout << std::setw(8) << num_threads << std::setw(8)
+                << (pinned ? "yes" : "no") << std::setw(14)
+                << record.factor_seconds << std::setw(10) << factor_speedup
+                << std::setw(12) << factor_speedup / num_threads
+                << std::setw(14) << record.solve_seconds << std::setw(10)
+                << solve_speedup << std::setw(12)
+                << solve_speedup / num_threads << std::setw(10)
+                << record.num_tasks << std::setw(12) << record.idle_seconds
+                << (record.success ? "" : "  (failed)") << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+// This driver sweeps the dense kernels which the supernodal factorizations
+// apply to small fronts over a range of front heights and reports the
+// GFLOP/s and the GB/s of each, along with their fractions of the machine
+// peaks, so that the kernels can be tuned and the dispatch thresholds of
+// 'SmallKernelThresholds' validated:
+//
+//   * the matrix multiplies and Hermitian outer products, through the small
+//     compile-time specialized kernels, BLAS, and the dynamic dispatch between
+//     them (whose choice is printed),
+//   * the scaled transposes of the subdiagonal blocks ('FormScaledTranspose'),
+//   * the merges of child Schur complements into their parents' fronts
+//     ('MergeChildSchurComplement'), with scattered relative indices, with
+//     runs of them, and through the kernels specialized on the child degree,
+//   * the loading of the matrix entries into the fronts through a conversion
+//     plan ('Factorization::MatrixData::injectEntries'), scattered and in
+//     runs, and
+//   * the row permutations of the right-hand sides ('Permute').
+//
+// The peaks default to those measured for a large BLAS matrix multiply and a
+// large copy, and may instead be given. The multiversioned kernels (see
+// 'CATAMARI_MULTIVERSIONED') run the variant for the instruction sets of the
+// CPU, which are printed; other instruction sets are compared by rerunning a
+// build for each target (e.g., with different '-march' flags).
+//
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "quotient/timer.hpp"
+#include "specify.hpp"
+
+using catamari::BlasMatrix;
+using catamari::BlasMatrixView;
+using catamari::Buffer;
+using catamari::Complex;
+using catamari::ConstBlasMatrixView;
+using catamari::Int;
+
+namespace {
+
+// The machine peaks which the measured rates are reported against.
+struct MachinePeaks {
+  double gflops_per_sec = 0;
+  double gbytes_per_sec = 0;
+};
+
+// Returns the instruction set extensions of the running CPU which select
+// between the variants of the multiversioned kernels.
+std::string InstructionSets() {
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_cpu_init();
+  std::string sets = "sse2";
+  if (__builtin_cpu_supports("avx2")) sets += " avx2";
+  if (__builtin_cpu_supports("fma")) sets += " fma";
+  if (__builtin_cpu_supports("avx512f")) sets += " avx512f";
+  return sets;
+#elif defined(__aarch64__)
+  return "neon";
+#else
+  return "unknown";
+#endif
+}
+
+// Returns the instruction set baseline of the build.
+std::string BuildTarget() {
+#if defined(__AVX512F__)
+  std::string target = "avx512f";
+#elif defined(__AVX2__)
+  std::string target = "avx2";
+#elif defined(__aarch64__)
+  std::string target = "neon";
+#else
+  std::string target = "default";
+#endif
+#ifdef CATAMARI_TARGET_CLONES
+  target += " (multiversioned)";
+#endif
+  return target;
+}
+
+// Returns the average number of seconds of each call of 'function', which is
+// repeated in doubling batches until at least 'min_seconds' have passed.
+template <class Function>
+double AverageSeconds(double min_seconds, const Function& function) {
+  quotient::Timer timer;
+  Int num_calls = 0;
+  double seconds = 0;
+  for (Int batch_size = 1;; batch_size *= 2) {
+    timer.Start();
+    for (Int call = 0; call < batch_size; ++call) function();
+    seconds += timer.Stop();
+    num_calls += batch_size;
+    if (seconds >= min_seconds) break;
+  }
+  return seconds / num_calls;
+}
+
+// Prints the header of the table of measurements.
+void PrintHeader() {
+  std::cout << std::left << std::setw(22) << "kernel" << std::right
+            << std::setw(8) << "height" << std::setw(6) << "rank"
+            << std::setw(13) << "usec" << std::setw(10) << "GFLOP/s"
+            << std::setw(10) << "GB/s" << std::setw(9) << "%flops"
+            << std::setw(9) << "%bw" << "\n";
+}
+
+// Prints a row of the table for a kernel which performed 'flops' flops and
+// moved 'bytes' bytes in 'seconds' seconds.
+void PrintRow(const std::string& kernel, Int height, Int rank, double seconds,
+              double flops, double bytes, const MachinePeaks& peaks) {
+  const double gflops_per_sec = flops / (1.e9 * seconds);
+  const double gbytes_per_sec = bytes / (1.e9 * seconds);
+  std::cout << std::left << std::setw(22) << kernel << std::right
+            << std::setw(8) << height << std::setw(6) << rank << std::fixed
+            << std::setprecision(3) << std::setw(13) << 1.e6 * seconds
+            << std::setprecision(2) << std::setw(10) << gflops_per_sec
+            << std::setw(10) << gbytes_per_sec << std::setprecision(1)
+            << std::setw(9)
+            << (peaks.gflops_per_sec > 0
+                    ? 100. * gflops_per_sec / peaks.gflops_per_sec
+                    : 0.)
+            << std::setw(9)
+            << (peaks.gbytes_per_sec > 0
+                    ? 100. * gbytes_per_sec / peaks.gbytes_per_sec
+                    : 0.)
+            << std::defaultfloat << "\n";
+}
+
+// Fills the missing peaks with the rates of a large matrix multiply and a
+// large copy.
+template <typename Field>
+void MeasurePeaks(double min_seconds, MachinePeaks* peaks) {
+  const bool is_complex = catamari::IsComplex<Field>::value;
+  if (peaks->gflops_per_sec <= 0) {
+#ifdef CATAMARI_HAVE_BLAS
+    const Int size = 512;
+    BlasMatrix<Field> left, right, output;
+    left.Resize(size, size, Field{1});
+    right.Resize(size, size, Field{1});
+    output.Resize(size, size, Field{0});
+    const double seconds = AverageSeconds(min_seconds, [&]() {
+      catamari::MatrixMultiplyNormalNormal(Field{-1}, left.ConstView(),
+                                           right.ConstView(), Field{1},
+                                           &output.view);
+    });
+    peaks->gflops_per_sec =
+        (is_complex ? 8. : 2.) * std::pow(1. * size, 3.) / (1.e9 * seconds);
+#endif  // ifdef CATAMARI_HAVE_BLAS
+  }
+  if (peaks->gbytes_per_sec <= 0) {
+    const std::size_t num_entries = std::size_t(1) << 23;
+    std::vector<double> source(num_entries, 1.), target(num_entries);
+    const double seconds = AverageSeconds(min_seconds, [&]() {
+      std::copy(source.begin(), source.end(), target.begin());
+    });
+    peaks->gbytes_per_sec =
+        2. * sizeof(double) * num_entries / (1.e9 * seconds);
+  }
+}
+
+// Times the products of a 'height' x 'rank' matrix with a 'rank' x 'rank'
+// matrix and the lower-triangular Hermitian outer products of a 'height' x
+// 'rank' matrix through the small kernels, BLAS, and the dynamic dispatch.
+template <typename Field>
+void RunProducts(Int height, Int rank, double min_seconds,
+                 const MachinePeaks& peaks) {
+  typedef catamari::ComplexBase<Field> Real;
+  const bool is_complex = catamari::IsComplex<Field>::value;
+  const double entry_bytes = sizeof(Field);
+  BlasMatrix<Field> left, right, output;
+  left.Resize(height, rank, Field{1});
+  right.Resize(rank, rank, Field{1});
+  output.Resize(height, std::max(height, rank), Field{0});
+  BlasMatrixView<Field> product = output.view.Submatrix(0, 0, height, rank);
+  BlasMatrixView<Field> outer_product =
+      output.view.Submatrix(0, 0, height, height);
+  const catamari::SmallKernelThresholds& thresholds =
+      catamari::GetSmallKernelThresholds();
+
+  const double multiply_flops = (is_complex ? 8. : 2.) * height * rank * rank;
+  const double multiply_bytes =
+      entry_bytes * (2. * height * rank + 1. * rank * rank + height * rank);
+  if (rank <= catamari::kMaxSmallKernelSize) {
+    PrintRow("gemm small", height, rank,
+             AverageSeconds(min_seconds,
+                            [&]() {
+                              catamari::SmallMatrixMultiplyNormalNormal(
+                                  Field{-1}, left.ConstView(),
+                                  right.ConstView(), Field{1}, &product);
+                            }),
+             multiply_flops, multiply_bytes, peaks);
+  }
+#ifdef CATAMARI_HAVE_BLAS
+  PrintRow("gemm blas", height, rank,
+           AverageSeconds(min_seconds,
+                          [&]() {
+                            catamari::MatrixMultiplyNormalNormal(
+                                Field{-1}, left.ConstView(), right.ConstView(),
+                                Field{1}, &product);
+                          }),
+           multiply_flops, multiply_bytes, peaks);
+  const bool multiply_blas = height > thresholds.matrix_multiply_height;
+#else
+  const bool multiply_blas = false;
+#endif  // ifdef CATAMARI_HAVE_BLAS
+  PrintRow(multiply_blas ? "gemm dispatch (blas)" : "gemm dispatch (small)",
+           height, rank,
+           AverageSeconds(min_seconds,
+                          [&]() {
+                            catamari::
+                                MatrixMultiplyNormalNormalDynamicBLASDispatch(
+                                    Field{-1}, left.ConstView(),
+                                    right.ConstView(), Field{1}, &product);
+                          }),
+           multiply_flops, multiply_bytes, peaks);
+
+  // Only the lower triangle of the output is read and written.
+  const double outer_flops = (is_complex ? 4. : 1.) * height * height * rank;
+  const double outer_bytes =
+      entry_bytes * (1. * height * rank + 1. * height * (height + 1));
+  if (rank <= catamari::kMaxSmallKernelSize) {
+    PrintRow("herk small", height, rank,
+             AverageSeconds(min_seconds,
+                            [&]() {
+                              catamari::SmallLowerNormalHermitianOuterProduct(
+                                  Real{-1}, left.ConstView(), Real{1},
+                                  &outer_product);
+                            }),
+             outer_flops, outer_bytes, peaks);
+  }
+#ifdef CATAMARI_HAVE_BLAS
+  PrintRow("herk blas", height, rank,
+           AverageSeconds(min_seconds,
+                          [&]() {
+                            catamari::LowerNormalHermitianOuterProduct(
+                                Real{-1}, left.ConstView(), Real{1},
+                                &outer_product);
+                          }),
+           outer_flops, outer_bytes, peaks);
+  const bool outer_blas =
+      height > thresholds.hermitian_outer_product_height && rank > 1;
+#else
+  const bool outer_blas = false;
+#endif  // ifdef CATAMARI_HAVE_BLAS
+  PrintRow(outer_blas ? "herk dispatch (blas)" : "herk dispatch (small)",
+           height, rank,
+           AverageSeconds(
+               min_seconds,
+               [&]() {
+                 catamari::LowerNormalHermitianOuterProductDynamicBLASDispatch(
+                     Real{-1}, left.ConstView(), Real{1}, &outer_product);
+               }),
+           outer_flops, outer_bytes, peaks);
+}
+
+// Times the formation of the scaled adjoint of a 'height' x 'rank'
+// subdiagonal block.
+template <typename Field>
+void RunScaledTranspose(Int height, Int rank, double min_seconds,
+                        const MachinePeaks& peaks) {
+  const bool is_complex = catamari::IsComplex<Field>::value;
+  BlasMatrix<Field> diagonal_block, lower_block, scaled_transpose;
+  diagonal_block.Resize(rank, rank, Field{2});
+  lower_block.Resize(height, rank, Field{1});
+  scaled_transpose.Resize(rank, height);
+  const double seconds = AverageSeconds(min_seconds, [&]() {
+    catamari::supernodal_ldl::FormScaledTranspose(
+        catamari::kLDLAdjointFactorization, diagonal_block.ConstView(),
+        lower_block.ConstView(), &scaled_transpose.view);
+  });
+  PrintRow("scaled transpose", height, rank, seconds,
+           (is_complex ? 6. : 1.) * height * rank,
+           2. * sizeof(Field) * height * rank, peaks);
+}
+
+// Times the merges of the Schur complement of a child of degree 'height' into
+// the front of a parent with 'height' columns and 'height' rows beneath them,
+// whose relative indices are either every other row of the front or
+// alternating runs of 'run_length' rows.
+template <typename Field>
+void RunMerge(Int height, Int run_length, double min_seconds,
+              const MachinePeaks& peaks) {
+  const bool is_complex = catamari::IsComplex<Field>::value;
+  const Int supernode_size = height;
+
+  // The two-supernode forest of the child (0) and its parent (1).
+  catamari::SymmetricOrdering ordering;
+  ordering.supernode_sizes.Resize(2);
+  ordering.supernode_sizes[0] = 1;
+  ordering.supernode_sizes[1] = supernode_size;
+  catamari::AssemblyForest& forest = ordering.assembly_forest;
+  forest.parents.Resize(2);
+  forest.parents[0] = 1;
+  forest.parents[1] = -1;
+  forest.FillFromParents();
+
+  std::shared_ptr<catamari::ChildRelativeIndices> relative_indices(
+      new catamari::ChildRelativeIndices);
+  relative_indices->offsets.Resize(3);
+  relative_indices->offsets[0] = 0;
+  relative_indices->offsets[1] = height;
+  relative_indices->offsets[2] = height;
+  relative_indices->indices.Resize(height);
+  relative_indices->num_diag_indices.Resize(2, 0);
+  for (Int i = 0; i < height; ++i) {
+    const Int index = run_length > 1
+                          ? 2 * run_length * (i / run_length) + i % run_length
+                          : 2 * i;
+    relative_indices->indices[i] = index;
+    if (index < supernode_size) ++relative_indices->num_diag_indices[0];
+  }
+  relative_indices->runs.Encode(2, relative_indices->offsets.Data(),
+                                relative_indices->indices.Data(),
+                                relative_indices->num_diag_indices.Data());
+  relative_indices->SelectMergeKernels();
+  forest.child_relative_indices = relative_indices;
+
+  // The diagonal and lower blocks of the front are stored contiguously.
+  BlasMatrix<Field> child_schur_complement, front, schur_complement;
+  child_schur_complement.Resize(height, height, Field{1});
+  front.Resize(2 * supernode_size, supernode_size, Field{0});
+  schur_complement.Resize(height, height, Field{0});
+  BlasMatrixView<Field> diagonal_block =
+      front.view.Submatrix(0, 0, supernode_size, supernode_size);
+  BlasMatrixView<Field> lower_block =
+      front.view.Submatrix(supernode_size, 0, supernode_size, supernode_size);
+
+  const double seconds = AverageSeconds(min_seconds, [&]() {
+    catamari::supernodal_ldl::MergeChildSchurComplement<Field>(
+        1, 0, ordering, nullptr, child_schur_complement.view, lower_block,
+        diagonal_block, schur_complement.view,
+        /* freshShurComplement = */ false);
+  });
+
+  std::string kernel = "merge";
+  if (catamari::supernodal_ldl::MergeKernelDegree(forest, 0)) {
+    kernel += " specialized";
+  } else if (relative_indices->runs.Encoded(0)) {
+    kernel += " runs";
+  } else {
+    kernel += " scattered";
+  }
+  // Each entry of the child's lower triangle is read and added into a front
+  // entry, which is read and written.
+  const double num_entries = 0.5 * height * (height + 1);
+  PrintRow(kernel, height, run_length, seconds,
+           (is_complex ? 2. : 1.) * num_entries,
+           3. * sizeof(Field) * num_entries, peaks);
+}
+
+// Times the loading of 'rank' matrix entries into each of the columns of a
+// front of height and width 'height' through a conversion plan whose entries
+// are either contiguous (and hence loaded in runs) or scattered.
+template <typename Field>
+void RunInjection(Int height, Int rank, bool contiguous, double min_seconds,
+                  const MachinePeaks& peaks) {
+  rank = std::min(rank, height);
+  const Int num_entries = height * rank;
+  std::mt19937 generator(17u);
+  Buffer<Int> sources(num_entries);
+  for (Int index = 0; index < num_entries; ++index) sources[index] = index;
+  if (!contiguous) {
+    std::shuffle(sources.begin(), sources.end(), generator);
+  }
+
+  catamari::ConversionPlan plan;
+  plan.resize(num_entries);
+  plan.columnOffsets.resize(height + 1);
+  for (Int j = 0; j <= height; ++j) plan.columnOffsets[j] = j * rank;
+  for (Int j = 0; j < height; ++j) {
+    for (Int k = 0; k < rank; ++k) {
+      // Every other row below the diagonal if scattered.
+      const Int row = contiguous ? k : (2 * k) % height;
+      catamari::ConversionPlan::Entry& entry = plan.entries()[j * rank + k];
+      entry.dst = j * height + row;
+      entry.src = sources[j * rank + k];
+    }
+  }
+  plan.encodeRuns();
+
+  Buffer<Field> values(num_entries, Field{1});
+  Buffer<Field> front(height * height, Field{0});
+  typename catamari::supernodal_ldl::Factorization<Field>::MatrixData data;
+  data.set(plan, values.Data(), Field{0}, nullptr);
+  const double seconds = AverageSeconds(min_seconds, [&]() {
+    for (Int j = 0; j < height; ++j) {
+      data.injectEntries(j, front.Data(), front[j * height + j]);
+    }
+  });
+  PrintRow(plan.hasRuns() ? "inject runs" : "inject scattered", height, rank,
+           seconds, 0.,
+           num_entries * (sizeof(catamari::ConversionPlan::Entry) +
+                          2. * sizeof(Field)),
+           peaks);
+}
+
+// Times the out-of-place permutation of the rows of 64 'height' x 'rank'
+// blocks of right-hand sides.
+template <typename Field>
+void RunPermute(Int height, Int rank, double min_seconds,
+                const MachinePeaks& peaks) {
+  const Int num_rows = 64 * height;
+  std::mt19937 generator(17u);
+  Buffer<Int> permutation(num_rows);
+  for (Int row = 0; row < num_rows; ++row) permutation[row] = row;
+  std::shuffle(permutation.begin(), permutation.end(), generator);
+  BlasMatrix<Field> input, output;
+  input.Resize(num_rows, rank, Field{1});
+  output.Resize(num_rows, rank);
+  const double seconds = AverageSeconds(min_seconds, [&]() {
+    catamari::Permute(permutation, input.view, &output.view);
+  });
+  PrintRow("permute", num_rows, rank, seconds, 0.,
+           num_rows * (2. * sizeof(Field) * rank + sizeof(Int)), peaks);
+}
+
+template <typename Field>
+void RunSweep(Int min_height, Int max_height, Int rank, double min_seconds,
+              MachinePeaks peaks) {
+  MeasurePeaks<Field>(min_seconds, &peaks);
+  const catamari::SmallKernelThresholds& thresholds =
+      catamari::GetSmallKernelThresholds();
+  std::cout << "CPU instruction sets: " << InstructionSets() << "\n"
+            << "Build target: " << BuildTarget() << "\n"
+            << "Peak GFLOP/s: " << peaks.gflops_per_sec
+            << ", peak GB/s: " << peaks.gbytes_per_sec << "\n"
+            << "Small kernel thresholds: gemm height "
+            << thresholds.matrix_multiply_height << ", herk height "
+            << thresholds.hermitian_outer_product_height
+            << ", max small kernel size " << catamari::kMaxSmallKernelSize
+            << ", max merge kernel degree "
+            << catamari::ChildRelativeIndices::kMaxMergeKernelDegree << "\n\n";
+  PrintHeader();
+  for (Int height = std::max(min_height, Int(1)); height <= max_height;
+       height *= 2) {
+    RunProducts<Field>(height, rank, min_seconds, peaks);
+    RunScaledTranspose<Field>(height, rank, min_seconds, peaks);
+    for (Int run_length : {1, 8}) {
+      RunMerge<Field>(height, run_length, min_seconds, peaks);
+    }
+    for (bool contiguous : {false, true}) {
+      RunInjection<Field>(height, rank, contiguous, min_seconds, peaks);
+    }
+    RunPermute<Field>(height, rank, min_seconds, peaks);
+    std::cout << "\n";
+  }
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  specify::ArgumentParser parser(argc, argv);
+  const Int min_height = parser.OptionalInput<Int>(
+      "min_height", "The smallest front height of the sweep.", 4);
+  const Int max_height = parser.OptionalInput<Int>(
+      "max_height", "The largest front height of the sweep.", 512);
+  const Int rank = parser.OptionalInput<Int>(
+      "rank", "The rank of the updates (the supernode size).", 8);
+  const double min_seconds = parser.OptionalInput<double>(
+      "min_seconds", "The minimum number of seconds to time each kernel.",
+      0.05);
+  const double peak_gflops = parser.OptionalInput<double>(
+      "peak_gflops", "The peak GFLOP/s, or zero to measure it.", 0.);
+  const double peak_gbs = parser.OptionalInput<double>(
+      "peak_gbs", "The peak GB/s, or zero to measure it.", 0.);
+  const bool complex = parser.OptionalInput<bool>(
+      "complex", "Whether to use complex rather than real doubles.", false);
+  if (!parser.OK()) {
+    return 0;
+  }
+
+  MachinePeaks peaks;
+  peaks.gflops_per_sec = peak_gflops;
+  peaks.gbytes_per_sec = peak_gbs;
+  if (complex) {
+    RunSweep<Complex<double>>(min_height, max_height, rank, min_seconds,
+                              peaks);
+  } else {
+    RunSweep<double>(min_height, max_height, rank, min_seconds, peaks);
+  }
+
+  return 0;
+}
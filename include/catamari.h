@@ -15,6 +15,7 @@
 #include "catamari/blas_matrix_view.h"
 #include "catamari/buffer.h"
 #include "catamari/dense_dpp.h"
+#include "catamari/sparse_ldl.h"
 
 std::mt19937* CatamariGenerator();
 
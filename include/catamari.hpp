@@ -8,18 +8,39 @@
 #ifndef CATAMARI_H_
 #define CATAMARI_H_
 
+#include "catamari/aligned_buffer.hpp"
 #include "catamari/apply_sparse.hpp"
+#include "catamari/batched_sparse_ldl.hpp"
 #include "catamari/blas_matrix.hpp"
+#include "catamari/cancellation_token.hpp"
 #include "catamari/complex.hpp"
 #include "catamari/coordinate_matrix.hpp"
 #include "catamari/dense_dpp.hpp"
 #include "catamari/dense_factorizations.hpp"
+#include "catamari/dense_row_deferral.hpp"
+#include "catamari/distributed_sparse_ldl.hpp"
+#include "catamari/eigen_sparse_ldl.hpp"
+#include "catamari/execution_context.hpp"
 #include "catamari/fgmres.hpp"
 #include "catamari/givens_rotation.hpp"
+#include "catamari/hardware_counters.hpp"
+#include "catamari/helmholtz_pml.hpp"
+#include "catamari/index_runs.hpp"
 #include "catamari/integers.hpp"
 #include "catamari/macros.hpp"
+#include "catamari/matrix_market_pipeline.hpp"
+#include "catamari/mixed_precision_sparse_ldl.hpp"
+#include "catamari/nested_dissection.hpp"
 #include "catamari/norms.hpp"
+#include "catamari/ordering_cache.hpp"
+#include "catamari/packed_lower_matrix_view.hpp"
+#include "catamari/parallel_minimum_degree.hpp"
+#include "catamari/philox.hpp"
+#include "catamari/reduced_precision.hpp"
 #include "catamari/scalar_functions.hpp"
+#include "catamari/shift_invert_lanczos.hpp"
 #include "catamari/sparse_ldl.hpp"
+#include "catamari/trace.hpp"
+#include "catamari/uniform_spanning_tree.hpp"
 
 #endif  // ifndef CATAMARI_H_
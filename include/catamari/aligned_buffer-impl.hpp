@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_ALIGNED_BUFFER_IMPL_H_
+#define CATAMARI_ALIGNED_BUFFER_IMPL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif  // ifdef __linux__
+
+#include "catamari/aligned_buffer.hpp"
+
+namespace catamari {
+
+template <class T>
+Int PaddedLeadingDimension(Int height, const AllocationControl& control) {
+  if (!control.pad_leading_dimensions || height <= 1) {
+    return std::max<Int>(height, 1);
+  }
+  const Int unit = std::max<Int>(control.alignment / sizeof(T), Int(1));
+  Int leading_dim = ((height + unit - 1) / unit) * unit;
+  if ((leading_dim * sizeof(T)) % 4096 == 0) {
+    leading_dim += unit;
+  }
+  return leading_dim;
+}
+
+template <class T>
+AlignedBuffer<T>::AlignedBuffer(const AllocationControl& control)
+    : control_(control) {}
+
+template <class T>
+AlignedBuffer<T>::AlignedBuffer(const AlignedBuffer<T>& buffer)
+    : control_(buffer.control_) {
+  Resize(buffer.size_);
+  if (size_) std::memcpy(data_, buffer.data_, size_ * sizeof(T));
+}
+
+template <class T>
+AlignedBuffer<T>::AlignedBuffer(AlignedBuffer<T>&& buffer) CATAMARI_NOEXCEPT
+    : control_(buffer.control_),
+      allocation_(buffer.allocation_),
+      data_(buffer.data_),
+      size_(buffer.size_) {
+  buffer.allocation_ = nullptr;
+  buffer.data_ = nullptr;
+  buffer.size_ = 0;
+}
+
+template <class T>
+AlignedBuffer<T>& AlignedBuffer<T>::operator=(const AlignedBuffer<T>& buffer) {
+  if (this != &buffer) {
+    control_ = buffer.control_;
+    Resize(buffer.size_);
+    if (size_) std::memcpy(data_, buffer.data_, size_ * sizeof(T));
+  }
+  return *this;
+}
+
+template <class T>
+AlignedBuffer<T>& AlignedBuffer<T>::operator=(AlignedBuffer<T>&& buffer)
+    CATAMARI_NOEXCEPT {
+  if (this != &buffer) {
+    std::free(allocation_);
+    control_ = buffer.control_;
+    allocation_ = buffer.allocation_;
+    data_ = buffer.data_;
+    size_ = buffer.size_;
+    buffer.allocation_ = nullptr;
+    buffer.data_ = nullptr;
+    buffer.size_ = 0;
+  }
+  return *this;
+}
+
+template <class T>
+AlignedBuffer<T>::~AlignedBuffer() {
+  std::free(allocation_);
+}
+
+template <class T>
+void AlignedBuffer<T>::SetControl(const AllocationControl& control) {
+  control_ = control;
+}
+
+template <class T>
+const AllocationControl& AlignedBuffer<T>::Control() const CATAMARI_NOEXCEPT {
+  return control_;
+}
+
+template <class T>
+void AlignedBuffer<T>::Resize(std::size_t size) {
+  if (size == size_) return;
+  Clear();
+  if (!size) return;
+
+  const std::size_t num_bytes = size * sizeof(T);
+  std::size_t alignment = std::max(control_.alignment, alignof(T));
+  const bool huge = control_.huge_page_threshold &&
+                    num_bytes >= control_.huge_page_threshold;
+  if (huge) alignment = std::max(alignment, kHugePageSize);
+  CATAMARI_ASSERT((alignment & (alignment - 1)) == 0,
+                  "The allocation alignment must be a power of two.");
+
+  // Over-allocate so that an aligned address with room for the entries is
+  // guaranteed to exist within the allocation.
+  allocation_ = std::malloc(num_bytes + alignment - 1);
+  if (!allocation_) throw std::bad_alloc();
+  const std::uintptr_t address =
+      reinterpret_cast<std::uintptr_t>(allocation_);
+  const std::uintptr_t aligned_address =
+      (address + alignment - 1) & ~std::uintptr_t(alignment - 1);
+  data_ = reinterpret_cast<T*>(aligned_address);
+  size_ = size;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (huge) {
+    // The advice only covers whole pages, and a failure merely leaves the
+    // buffer on base pages.
+    const std::size_t advised_bytes = num_bytes & ~(kHugePageSize - 1);
+    if (advised_bytes) madvise(data_, advised_bytes, MADV_HUGEPAGE);
+  }
+#endif  // if defined(__linux__) && defined(MADV_HUGEPAGE)
+}
+
+template <class T>
+void AlignedBuffer<T>::Clear() {
+  std::free(allocation_);
+  allocation_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+template <class T>
+std::size_t AlignedBuffer<T>::Size() const CATAMARI_NOEXCEPT {
+  return size_;
+}
+
+template <class T>
+bool AlignedBuffer<T>::Empty() const CATAMARI_NOEXCEPT {
+  return size_ == 0;
+}
+
+template <class T>
+T* AlignedBuffer<T>::Data() CATAMARI_NOEXCEPT {
+  return data_;
+}
+
+template <class T>
+const T* AlignedBuffer<T>::Data() const CATAMARI_NOEXCEPT {
+  return data_;
+}
+
+template <class T>
+T& AlignedBuffer<T>::operator[](std::size_t index) {
+  return data_[index];
+}
+
+template <class T>
+const T& AlignedBuffer<T>::operator[](std::size_t index) const {
+  return data_[index];
+}
+
+template <class T>
+T* AlignedBuffer<T>::begin() CATAMARI_NOEXCEPT {
+  return data_;
+}
+
+template <class T>
+T* AlignedBuffer<T>::end() CATAMARI_NOEXCEPT {
+  return data_ + size_;
+}
+
+template <class T>
+const T* AlignedBuffer<T>::begin() const CATAMARI_NOEXCEPT {
+  return data_;
+}
+
+template <class T>
+const T* AlignedBuffer<T>::end() const CATAMARI_NOEXCEPT {
+  return data_ + size_;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_ALIGNED_BUFFER_IMPL_H_
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_ALIGNED_BUFFER_H_
+#define CATAMARI_ALIGNED_BUFFER_H_
+
+#include <cstddef>
+
+#include "catamari/integers.hpp"
+#include "catamari/macros.hpp"
+
+// The build-time defaults of 'AllocationControl', which may be overridden
+// with, e.g., '-DCATAMARI_DEFAULT_ALIGNMENT=128'.
+#ifndef CATAMARI_DEFAULT_ALIGNMENT
+#define CATAMARI_DEFAULT_ALIGNMENT 64
+#endif  // ifndef CATAMARI_DEFAULT_ALIGNMENT
+
+#ifndef CATAMARI_DEFAULT_HUGE_PAGE_THRESHOLD
+#define CATAMARI_DEFAULT_HUGE_PAGE_THRESHOLD (std::size_t(1) << 24)
+#endif  // ifndef CATAMARI_DEFAULT_HUGE_PAGE_THRESHOLD
+
+#ifndef CATAMARI_DEFAULT_PAD_LEADING_DIMENSIONS
+#define CATAMARI_DEFAULT_PAD_LEADING_DIMENSIONS false
+#endif  // ifndef CATAMARI_DEFAULT_PAD_LEADING_DIMENSIONS
+
+namespace catamari {
+
+// The policy for the allocation of the large buffers of a factorization.
+struct AllocationControl {
+  // The alignment, in bytes, of each allocation. It must be a power of two,
+  // and it is raised to the alignment of the entry type if need be.
+  std::size_t alignment = CATAMARI_DEFAULT_ALIGNMENT;
+
+  // The number of bytes at or above which an allocation is aligned to, and
+  // advised to be backed by, transparent huge pages, so that TLB misses are
+  // rare when streaming through it. Zero disables the advice. The advice is
+  // only given on Linux.
+  std::size_t huge_page_threshold = CATAMARI_DEFAULT_HUGE_PAGE_THRESHOLD;
+
+  // Whether the leading dimensions of dense blocks whose layout is free to
+  // choose should be padded (see 'PaddedLeadingDimension').
+  bool pad_leading_dimensions = CATAMARI_DEFAULT_PAD_LEADING_DIMENSIONS;
+};
+
+// The size, in bytes, of the transparent huge pages advised for large
+// allocations.
+constexpr std::size_t kHugePageSize = std::size_t(1) << 21;
+
+// Returns the leading dimension of a column-major block of the given height
+// under the allocation policy. If padding is enabled, the column stride is
+// rounded up to a multiple of the alignment and, if it is then a multiple
+// of 4 KiB, grown by one more alignment unit, so that successive columns
+// neither map onto the same cache sets nor alias in the load/store buffers.
+template <class T>
+Int PaddedLeadingDimension(Int height, const AllocationControl& control);
+
+// A contiguous array of uninitialized entries of a trivially copyable type
+// which is allocated following an 'AllocationControl'. Unlike 'Buffer', its
+// entries are not preserved when it is resized.
+template <class T>
+class AlignedBuffer {
+ public:
+  // Constructs an empty buffer with the default allocation policy.
+  AlignedBuffer() = default;
+
+  // Constructs an empty buffer with the given allocation policy.
+  explicit AlignedBuffer(const AllocationControl& control);
+
+  // Copies the policy and the entries of a buffer.
+  AlignedBuffer(const AlignedBuffer<T>& buffer);
+
+  // Takes ownership of the allocation of a buffer.
+  AlignedBuffer(AlignedBuffer<T>&& buffer) CATAMARI_NOEXCEPT;
+
+  // Copies the policy and the entries of a buffer.
+  AlignedBuffer<T>& operator=(const AlignedBuffer<T>& buffer);
+
+  // Takes ownership of the allocation of a buffer.
+  AlignedBuffer<T>& operator=(AlignedBuffer<T>&& buffer) CATAMARI_NOEXCEPT;
+
+  // Frees the allocation.
+  ~AlignedBuffer();
+
+  // Sets the policy for subsequent allocations.
+  void SetControl(const AllocationControl& control);
+
+  // Returns the allocation policy.
+  const AllocationControl& Control() const CATAMARI_NOEXCEPT;
+
+  // Reallocates the buffer, without initialization, if its size changes.
+  void Resize(std::size_t size);
+
+  // Frees the allocation.
+  void Clear();
+
+  // Returns the number of entries of the buffer.
+  std::size_t Size() const CATAMARI_NOEXCEPT;
+
+  // Returns true if the buffer has no entries.
+  bool Empty() const CATAMARI_NOEXCEPT;
+
+  // Returns a pointer to the first entry, or null if the buffer is empty.
+  T* Data() CATAMARI_NOEXCEPT;
+  const T* Data() const CATAMARI_NOEXCEPT;
+
+  // Returns a reference to an entry of the buffer.
+  T& operator[](std::size_t index);
+  const T& operator[](std::size_t index) const;
+
+  // Iterators over the entries of the buffer.
+  T* begin() CATAMARI_NOEXCEPT;
+  T* end() CATAMARI_NOEXCEPT;
+  const T* begin() const CATAMARI_NOEXCEPT;
+  const T* end() const CATAMARI_NOEXCEPT;
+
+ private:
+  // The allocation policy.
+  AllocationControl control_;
+
+  // The (unaligned) allocation, which is freed upon destruction.
+  void* allocation_ = nullptr;
+
+  // The aligned first entry within the allocation.
+  T* data_ = nullptr;
+
+  // The number of entries.
+  std::size_t size_ = 0;
+};
+
+}  // namespace catamari
+
+#include "catamari/aligned_buffer-impl.hpp"
+
+#endif  // ifndef CATAMARI_ALIGNED_BUFFER_H_
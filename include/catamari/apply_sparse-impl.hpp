@@ -8,17 +8,134 @@
 #ifndef CATAMARI_APPLY_SPARSE_IMPL_H_
 #define CATAMARI_APPLY_SPARSE_IMPL_H_
 
+#include <algorithm>
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "catamari/apply_sparse.hpp"
 #include "catamari/integers.hpp"
 #include "catamari/macros.hpp"
 
 namespace catamari {
+namespace apply_sparse {
+
+// The number of (entry, right-hand side) products below which the
+// multiplications are performed serially.
+static constexpr Int kMinParallelWork = 1 << 15;
 
+// Returns the number of row blocks to split a multiplication with the given
+// number of right-hand sides over.
 template <class Field>
-void ApplySparse(const Field& alpha,
-                 const CoordinateMatrix<Field>& sparse_matrix,
-                 const ConstBlasMatrixView<Field>& input_matrix,
-                 const Field& beta, BlasMatrixView<Field>* result) {
+Int NumRowBlocks(const CoordinateMatrix<Field>& sparse_matrix, Int num_rhs) {
+  const Int work = sparse_matrix.NumEntries() * num_rhs;
+  return std::max<Int>(
+      1, std::min<Int>(tbb::this_task_arena::max_concurrency(),
+                       work / kMinParallelWork));
+}
+
+// Returns the first row of the given block of a partition of the rows into
+// 'num_blocks' contiguous pieces with (nearly) equal numbers of entries.
+template <class Field>
+Int RowBlockBegin(const CoordinateMatrix<Field>& sparse_matrix, Int num_blocks,
+                  Int block) {
+  if (block == num_blocks) {
+    return sparse_matrix.NumRows();
+  }
+  const Buffer<Int>& row_entry_offsets = sparse_matrix.RowEntryOffsets();
+  const Int entry_beg = (sparse_matrix.NumEntries() * block) / num_blocks;
+  return std::lower_bound(row_entry_offsets.begin(), row_entry_offsets.end(),
+                          entry_beg) -
+         row_entry_offsets.begin();
+}
+
+// result := alpha matrix input + beta result, where the products are formed
+// in the (typically higher-precision) 'Scalar' type.
+//
+// Each row of the result is independent, so the rows are partitioned across
+// threads. Within a row, the entries stay in cache while they are applied to
+// each right-hand side in turn, and the dot products accumulate in a register
+// over contiguous lists of column indices.
+// Sets 'sum' and 'error' such that sum + error = a + b exactly, where 'sum'
+// is the floating-point sum (Knuth's TwoSum).
+inline void TwoSum(double a, double b, double* sum, double* error) {
+  *sum = a + b;
+  const double b_virtual = *sum - a;
+  *error = (a - (*sum - b_virtual)) + (b - b_virtual);
+}
+
+// Sets 'sum' and 'error' such that sum + error = a + b exactly, assuming that
+// |a| >= |b| (or a = 0).
+inline void QuickTwoSum(double a, double b, double* sum, double* error) {
+  *sum = a + b;
+  *error = b - (*sum - a);
+}
+
+// Sets 'product' and 'error' such that product + error = a * b exactly,
+// using a fused multiply-add for the rounding error of the product.
+inline void TwoProduct(double a, double b, double* product, double* error) {
+  *product = a * b;
+  *error = std::fma(a, b, -*product);
+}
+
+// An unnormalized double-double accumulator: the sum is upper + lower, where
+// the rounding errors of the upper part are collected (in double precision)
+// into the lower part and only renormalized once the accumulation completes.
+struct DoubleDoubleAccumulator {
+  double upper = 0;
+  double lower = 0;
+
+  // Adds value * (input_upper + input_lower), dropping only the product of
+  // the rounding errors.
+  void AddProduct(double value, double input_upper, double input_lower) {
+    double product, product_error;
+    TwoProduct(value, input_upper, &product, &product_error);
+    product_error = std::fma(value, input_lower, product_error);
+    double sum_error;
+    TwoSum(upper, product, &upper, &sum_error);
+    lower += sum_error + product_error;
+  }
+
+  // Merges another accumulator into this one.
+  void Add(const DoubleDoubleAccumulator& other) {
+    double sum_error;
+    TwoSum(upper, other.upper, &upper, &sum_error);
+    lower += sum_error + other.lower;
+  }
+
+  // Returns the renormalized sum.
+  mantis::DoubleMantissa<double> Sum() const {
+    double sum, error;
+    QuickTwoSum(upper, lower, &sum, &error);
+    return mantis::DoubleMantissa<double>(sum, error);
+  }
+};
+
+// target += input * value, in the (typically higher-precision) 'Scalar' type.
+template <class Field, class Scalar>
+void AddProduct(const Field& value, const Scalar& input, Scalar* target) {
+  *target += input * Scalar(value);
+}
+
+// The double-double specialization of the above, which avoids promoting the
+// (double-precision) matrix entry and so halves the cost of the product.
+inline void AddProduct(const double& value,
+                       const mantis::DoubleMantissa<double>& input,
+                       mantis::DoubleMantissa<double>* target) {
+  DoubleDoubleAccumulator accumulator;
+  accumulator.upper = target->Upper();
+  accumulator.lower = target->Lower();
+  accumulator.AddProduct(value, input.Upper(), input.Lower());
+  *target = accumulator.Sum();
+}
+
+template <class Field, class Scalar>
+void MultiplyRows(const Scalar& alpha,
+                  const CoordinateMatrix<Field>& sparse_matrix,
+                  const ConstBlasMatrixView<Scalar>& input_matrix,
+                  const Scalar& beta, BlasMatrixView<Scalar>* result) {
   const Int num_rows = sparse_matrix.NumRows();
   const Int num_rhs = input_matrix.width;
   CATAMARI_ASSERT(input_matrix.height == sparse_matrix.NumColumns(),
@@ -28,32 +145,55 @@ void ApplySparse(const Field& alpha,
   CATAMARI_ASSERT(input_matrix.width == result->width,
                   "result was the incorrect width.");
 
-  // vec1 += alpha matrix vec0 + beta vec1
   const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    for (Int j = 0; j < num_rhs; ++j) {
-      result->Entry(row, j) *= beta;
-    }
-
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
+  const Buffer<Int>& row_entry_offsets = sparse_matrix.RowEntryOffsets();
+  const Buffer<Int>& column_indices = sparse_matrix.ColumnIndices();
+  auto multiply_rows = [&](Int row_beg, Int row_end) {
+    for (Int row = row_beg; row < row_end; ++row) {
+      const Int entry_beg = row_entry_offsets[row];
+      const Int entry_end = row_entry_offsets[row + 1];
       for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(row, j) +=
-            alpha * entry.value * input_matrix(entry.column, j);
+        const Scalar* input_column = input_matrix.Pointer(0, j);
+        Scalar sum{0};
+        for (Int index = entry_beg; index < entry_end; ++index) {
+          sum += input_column[column_indices[index]] *
+                 Scalar(entries[index].value);
+        }
+        Scalar& result_entry = result->Entry(row, j);
+        result_entry = beta * result_entry + alpha * sum;
       }
     }
+  };
+
+  const Int num_blocks = NumRowBlocks(sparse_matrix, num_rhs);
+  if (num_blocks == 1) {
+    multiply_rows(0, num_rows);
+    return;
   }
+  tbb::parallel_for(Int(0), num_blocks, [&](Int block) {
+    multiply_rows(RowBlockBegin(sparse_matrix, num_blocks, block),
+                  RowBlockBegin(sparse_matrix, num_blocks, block + 1));
+  });
 }
 
-template <class Field>
-void ApplySparse(const Promote<Field>& alpha,
-                 const CoordinateMatrix<Field>& sparse_matrix,
-                 const ConstBlasMatrixView<Promote<Field>>& input_matrix,
-                 const Promote<Field>& beta,
-                 BlasMatrixView<Promote<Field>>* result) {
+// The double-double specialization of the above for double-precision
+// matrices, which is the working precision of promoted iterative refinement.
+//
+// Each product of a double-precision entry with a double-double input is
+// formed with an error-free transformation (a fused multiply-add recovers
+// the rounding error) rather than through a full double-double product, and
+// the sums of each row are split over 'kNumLanes' independent accumulators so
+// that consecutive entries do not wait on each other's additions (and can be
+// vectorized by the compiler). The lanes are merged, and the sum
+// renormalized, once per row and right-hand side.
+inline void MultiplyRows(
+    const mantis::DoubleMantissa<double>& alpha,
+    const CoordinateMatrix<double>& sparse_matrix,
+    const ConstBlasMatrixView<mantis::DoubleMantissa<double>>& input_matrix,
+    const mantis::DoubleMantissa<double>& beta,
+    BlasMatrixView<mantis::DoubleMantissa<double>>* result) {
+  typedef mantis::DoubleMantissa<double> Scalar;
+  static constexpr Int kNumLanes = 4;
   const Int num_rows = sparse_matrix.NumRows();
   const Int num_rhs = input_matrix.width;
   CATAMARI_ASSERT(input_matrix.height == sparse_matrix.NumColumns(),
@@ -63,63 +203,166 @@ void ApplySparse(const Promote<Field>& alpha,
   CATAMARI_ASSERT(input_matrix.width == result->width,
                   "result was the incorrect width.");
 
-  // vec1 += alpha matrix vec0 + beta vec1
-  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    for (Int j = 0; j < num_rhs; ++j) {
-      result->Entry(row, j) *= beta;
-    }
-
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
+  const Buffer<MatrixEntry<double>>& entries = sparse_matrix.Entries();
+  const Buffer<Int>& row_entry_offsets = sparse_matrix.RowEntryOffsets();
+  const Buffer<Int>& column_indices = sparse_matrix.ColumnIndices();
+  auto multiply_rows = [&](Int row_beg, Int row_end) {
+    for (Int row = row_beg; row < row_end; ++row) {
+      const Int entry_beg = row_entry_offsets[row];
+      const Int entry_end = row_entry_offsets[row + 1];
+      const Int lane_end =
+          entry_beg + ((entry_end - entry_beg) / kNumLanes) * kNumLanes;
       for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(row, j) += alpha * (input_matrix(entry.column, j) *
-                                          Promote<Field>(entry.value));
+        const Scalar* input_column = input_matrix.Pointer(0, j);
+        DoubleDoubleAccumulator lanes[kNumLanes];
+        for (Int index = entry_beg; index < lane_end; index += kNumLanes) {
+          for (Int lane = 0; lane < kNumLanes; ++lane) {
+            const Scalar& input =
+                input_column[column_indices[index + lane]];
+            lanes[lane].AddProduct(entries[index + lane].value, input.Upper(),
+                                   input.Lower());
+          }
+        }
+        for (Int index = lane_end; index < entry_end; ++index) {
+          const Scalar& input = input_column[column_indices[index]];
+          lanes[0].AddProduct(entries[index].value, input.Upper(),
+                              input.Lower());
+        }
+        for (Int lane = 1; lane < kNumLanes; ++lane) {
+          lanes[0].Add(lanes[lane]);
+        }
+        Scalar& result_entry = result->Entry(row, j);
+        result_entry = beta * result_entry + alpha * lanes[0].Sum();
       }
     }
+  };
+
+  const Int num_blocks = NumRowBlocks(sparse_matrix, num_rhs);
+  if (num_blocks == 1) {
+    multiply_rows(0, num_rows);
+    return;
   }
+  tbb::parallel_for(Int(0), num_blocks, [&](Int block) {
+    multiply_rows(RowBlockBegin(sparse_matrix, num_blocks, block),
+                  RowBlockBegin(sparse_matrix, num_blocks, block + 1));
+  });
 }
 
-template <class Field>
-void ApplyTransposeSparse(const Field& alpha,
-                          const CoordinateMatrix<Field>& sparse_matrix,
-                          const ConstBlasMatrixView<Field>& input_matrix,
-                          const Field& beta, BlasMatrixView<Field>* result) {
+// result := alpha op(matrix) input + beta result, where op is either the
+// transpose or, if 'conjugate' is true, the adjoint, and the products are
+// formed in the (typically higher-precision) 'Scalar' type.
+//
+// Different rows of the matrix scatter into the same rows of the result, so
+// each block of rows accumulates into its own workspace, and the workspaces
+// are then summed (in a fixed order) in parallel over the rows of the result.
+template <class Field, class Scalar>
+void MultiplyColumns(bool conjugate, const Scalar& alpha,
+                     const CoordinateMatrix<Field>& sparse_matrix,
+                     const ConstBlasMatrixView<Scalar>& input_matrix,
+                     const Scalar& beta, BlasMatrixView<Scalar>* result) {
   const Int num_rows = sparse_matrix.NumRows();
+  const Int num_columns = sparse_matrix.NumColumns();
   const Int num_rhs = input_matrix.width;
   CATAMARI_ASSERT(input_matrix.height == num_rows,
                   "input_matrix was the incorrect height.");
-  CATAMARI_ASSERT(result->height == sparse_matrix.NumColumns(),
+  CATAMARI_ASSERT(result->height == num_columns,
                   "result was the incorrect height.");
   CATAMARI_ASSERT(input_matrix.width == result->width,
                   "result was the incorrect width.");
 
-  // Scale the input by beta.
-  if (beta != Field(1)) {
-    for (Int j = 0; j < result->width; ++j) {
-      for (Int i = 0; i < result->height; ++i) {
-        result->Entry(i, j) *= beta;
+  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
+  const Buffer<Int>& row_entry_offsets = sparse_matrix.RowEntryOffsets();
+  const Buffer<Int>& column_indices = sparse_matrix.ColumnIndices();
+
+  // Adds scale op(matrix(row_beg:row_end, :)) input(row_beg:row_end, :) into
+  // the column-major 'num_columns' x 'num_rhs' matrix starting at 'target'.
+  auto multiply_rows = [&](Int row_beg, Int row_end, const Scalar& scale,
+                           Scalar* target, Int target_leading_dim) {
+    for (Int row = row_beg; row < row_end; ++row) {
+      const Int entry_beg = row_entry_offsets[row];
+      const Int entry_end = row_entry_offsets[row + 1];
+      for (Int j = 0; j < num_rhs; ++j) {
+        const Scalar input_entry = scale * input_matrix(row, j);
+        Scalar* target_column = target + j * target_leading_dim;
+        if (conjugate) {
+          for (Int index = entry_beg; index < entry_end; ++index) {
+            AddProduct(mantis::Conjugate(entries[index].value), input_entry,
+                       &target_column[column_indices[index]]);
+          }
+        } else {
+          for (Int index = entry_beg; index < entry_end; ++index) {
+            AddProduct(entries[index].value, input_entry,
+                       &target_column[column_indices[index]]);
+          }
+        }
       }
     }
-  }
+  };
 
-  // vec1 += alpha matrix vec0 + beta vec1
-  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
+  const Int num_blocks = NumRowBlocks(sparse_matrix, num_rhs);
+  if (num_blocks == 1) {
+    if (beta != Scalar(1)) {
       for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(entry.column, j) +=
-            alpha * entry.value * input_matrix(row, j);
+        for (Int i = 0; i < num_columns; ++i) {
+          result->Entry(i, j) *= beta;
+        }
       }
     }
+    multiply_rows(0, num_rows, alpha, result->Pointer(0, 0),
+                  result->leading_dim);
+    return;
   }
+
+  const Int workspace_size = num_columns * num_rhs;
+  Buffer<Scalar> workspaces(num_blocks * workspace_size, Scalar{0});
+  tbb::parallel_for(Int(0), num_blocks, [&](Int block) {
+    multiply_rows(RowBlockBegin(sparse_matrix, num_blocks, block),
+                  RowBlockBegin(sparse_matrix, num_blocks, block + 1),
+                  Scalar{1}, &workspaces[block * workspace_size], num_columns);
+  });
+
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_columns),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int j = 0; j < num_rhs; ++j) {
+          for (Int i = range.begin(); i < range.end(); ++i) {
+            Scalar sum{0};
+            for (Int block = 0; block < num_blocks; ++block) {
+              sum += workspaces[block * workspace_size + i + j * num_columns];
+            }
+            Scalar& result_entry = result->Entry(i, j);
+            result_entry = beta * result_entry + alpha * sum;
+          }
+        }
+      });
+}
+
+}  // namespace apply_sparse
+
+template <class Field>
+void ApplySparse(const Field& alpha,
+                 const CoordinateMatrix<Field>& sparse_matrix,
+                 const ConstBlasMatrixView<Field>& input_matrix,
+                 const Field& beta, BlasMatrixView<Field>* result) {
+  apply_sparse::MultiplyRows(alpha, sparse_matrix, input_matrix, beta, result);
+}
+
+template <class Field>
+void ApplySparse(const Promote<Field>& alpha,
+                 const CoordinateMatrix<Field>& sparse_matrix,
+                 const ConstBlasMatrixView<Promote<Field>>& input_matrix,
+                 const Promote<Field>& beta,
+                 BlasMatrixView<Promote<Field>>* result) {
+  apply_sparse::MultiplyRows(alpha, sparse_matrix, input_matrix, beta, result);
+}
+
+template <class Field>
+void ApplyTransposeSparse(const Field& alpha,
+                          const CoordinateMatrix<Field>& sparse_matrix,
+                          const ConstBlasMatrixView<Field>& input_matrix,
+                          const Field& beta, BlasMatrixView<Field>* result) {
+  apply_sparse::MultiplyColumns(/* conjugate = */ false, alpha, sparse_matrix,
+                                input_matrix, beta, result);
 }
 
 template <class Field>
@@ -127,38 +370,8 @@ void ApplyTransposeSparse(
     const Promote<Field>& alpha, const CoordinateMatrix<Field>& sparse_matrix,
     const ConstBlasMatrixView<Promote<Field>>& input_matrix,
     const Promote<Field>& beta, BlasMatrixView<Promote<Field>>* result) {
-  const Int num_rows = sparse_matrix.NumRows();
-  const Int num_rhs = input_matrix.width;
-  CATAMARI_ASSERT(input_matrix.height == num_rows,
-                  "input_matrix was the incorrect height.");
-  CATAMARI_ASSERT(result->height == sparse_matrix.NumColumns(),
-                  "result was the incorrect height.");
-  CATAMARI_ASSERT(input_matrix.width == result->width,
-                  "result was the incorrect width.");
-
-  // Scale the input by beta.
-  if (beta != Field(1)) {
-    for (Int j = 0; j < result->width; ++j) {
-      for (Int i = 0; i < result->height; ++i) {
-        result->Entry(i, j) *= beta;
-      }
-    }
-  }
-
-  // vec1 += alpha matrix vec0 + beta vec1
-  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
-      for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(entry.column, j) +=
-            alpha * (input_matrix(row, j) * Promote<Field>(entry.value));
-      }
-    }
-  }
+  apply_sparse::MultiplyColumns(/* conjugate = */ false, alpha, sparse_matrix,
+                                input_matrix, beta, result);
 }
 
 template <class Field>
@@ -166,38 +379,8 @@ void ApplyAdjointSparse(const Field& alpha,
                         const CoordinateMatrix<Field>& sparse_matrix,
                         const ConstBlasMatrixView<Field>& input_matrix,
                         const Field& beta, BlasMatrixView<Field>* result) {
-  const Int num_rows = sparse_matrix.NumRows();
-  const Int num_rhs = input_matrix.width;
-  CATAMARI_ASSERT(input_matrix.height == num_rows,
-                  "input_matrix was the incorrect height.");
-  CATAMARI_ASSERT(result->height == sparse_matrix.NumColumns(),
-                  "result was the incorrect height.");
-  CATAMARI_ASSERT(input_matrix.width == result->width,
-                  "result was the incorrect width.");
-
-  // Scale the input by beta.
-  if (beta != Field(1)) {
-    for (Int j = 0; j < result->width; ++j) {
-      for (Int i = 0; i < result->height; ++i) {
-        result->Entry(i, j) *= beta;
-      }
-    }
-  }
-
-  // vec1 += alpha matrix vec0 + beta vec1
-  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
-      const Field value = mantis::Conjugate(entry.value);
-      for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(entry.column, j) += alpha * value * input_matrix(row, j);
-      }
-    }
-  }
+  apply_sparse::MultiplyColumns(/* conjugate = */ true, alpha, sparse_matrix,
+                                input_matrix, beta, result);
 }
 
 template <class Field>
@@ -206,39 +389,8 @@ void ApplyAdjointSparse(const Promote<Field>& alpha,
                         const ConstBlasMatrixView<Promote<Field>>& input_matrix,
                         const Promote<Field>& beta,
                         BlasMatrixView<Promote<Field>>* result) {
-  const Int num_rows = sparse_matrix.NumRows();
-  const Int num_rhs = input_matrix.width;
-  CATAMARI_ASSERT(input_matrix.height == num_rows,
-                  "input_matrix was the incorrect height.");
-  CATAMARI_ASSERT(result->height == sparse_matrix.NumColumns(),
-                  "result was the incorrect height.");
-  CATAMARI_ASSERT(input_matrix.width == result->width,
-                  "result was the incorrect width.");
-
-  // Scale the input by beta.
-  if (beta != Field(1)) {
-    for (Int j = 0; j < result->width; ++j) {
-      for (Int i = 0; i < result->height; ++i) {
-        result->Entry(i, j) *= beta;
-      }
-    }
-  }
-
-  // vec1 += alpha matrix vec0 + beta vec1
-  const Buffer<MatrixEntry<Field>>& entries = sparse_matrix.Entries();
-  for (Int row = 0; row < num_rows; ++row) {
-    const Int row_beg = sparse_matrix.RowEntryOffset(row);
-    const Int row_end = sparse_matrix.RowEntryOffset(row + 1);
-    for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      CATAMARI_ASSERT(entry.row == row, "Invalid entry row index.");
-      const Promote<Field> value = mantis::Conjugate(entry.value);
-      for (Int j = 0; j < num_rhs; ++j) {
-        result->Entry(entry.column, j) +=
-            alpha * (input_matrix(row, j) * value);
-      }
-    }
-  }
+  apply_sparse::MultiplyColumns(/* conjugate = */ true, alpha, sparse_matrix,
+                                input_matrix, beta, result);
 }
 
 }  // namespace catamari
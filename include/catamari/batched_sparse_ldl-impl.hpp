@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_BATCHED_SPARSE_LDL_IMPL_H_
+#define CATAMARI_BATCHED_SPARSE_LDL_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <tbb/parallel_for.h>
+
+#include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
+
+#include "catamari/batched_sparse_ldl.hpp"
+
+namespace catamari {
+
+template <class Field>
+void BatchedSparseLDL<Field>::Analyze(
+    Int num_rows, const Int* offsets, const Int* indices, bool compressed_rows,
+    Int batch_size, const BatchedSparseLDLControl<Field>& control) {
+  if (batch_size < 0 || control.lanes_per_task < 1) {
+    throw std::runtime_error("Invalid batch configuration");
+  }
+  if (control.ldl_control.equilibrate ||
+      control.ldl_control.scalar_control.dynamic_regularization.enabled) {
+    throw std::runtime_error(
+        "Batched factorizations support neither equilibration nor dynamic "
+        "regularization");
+  }
+  control_ = control;
+  batch_size_ = batch_size;
+
+  // The symbolic analysis of the full pattern (with arbitrary values).
+  SparseLDLControl<Field> ldl_control = control.ldl_control;
+  ldl_control.supernodal_strategy = kScalarFactorization;
+  SparseLDL<Field> analysis;
+  {
+    CoordinateMatrix<Field> pattern;
+    pattern.Resize(num_rows, num_rows);
+    pattern.ReserveEntryAdditions(2 * offsets[num_rows]);
+    for (Int outer = 0; outer < num_rows; ++outer) {
+      for (Int index = offsets[outer]; index < offsets[outer + 1]; ++index) {
+        const Int inner = indices[index];
+        if (inner < 0 || inner >= num_rows) {
+          throw std::runtime_error("Invalid pattern index: " +
+                                   std::to_string(inner));
+        }
+        pattern.QueueEntryAddition(outer, inner, Field{1});
+        pattern.QueueEntryAddition(inner, outer, Field{1});
+      }
+    }
+    pattern.FlushEntryQueues();
+    analysis.Factor(pattern, ldl_control, /* symbolic_only = */ true);
+  }
+  analysis.FormConversionPlan(num_rows, offsets, indices, compressed_rows,
+                              &cplan_);
+
+  scalar_ldl::Factorization<Field>& factorization =
+      *analysis.scalar_factorization;
+  ordering_ = std::move(factorization.ordering);
+  lower_structure_ = std::move(factorization.lower_factor.structure);
+  scalar_ldl::FormRowPatterns(lower_structure_, &row_patterns_);
+
+  lower_values_.Resize(lower_structure_.indices.Size() * batch_size_);
+  diagonal_values_.Resize(num_rows * batch_size_);
+}
+
+template <class Field>
+Int BatchedSparseLDL<Field>::Factor(const Field* values,
+                                    Buffer<Int>* num_successful_pivots) {
+  Buffer<Int> pivots(batch_size_);
+  const Int lanes = control_.lanes_per_task;
+  const Int num_tasks = (batch_size_ + lanes - 1) / lanes;
+  tbb::parallel_for(Int(0), num_tasks, [&](Int task) {
+    const Int item_beg = task * lanes;
+    const Int item_end = std::min(item_beg + lanes, batch_size_);
+    FactorItems(item_beg, item_end, values, pivots.Data());
+  });
+
+  const Int num_rows = NumRows();
+  Int num_factored = 0;
+  for (Int item = 0; item < batch_size_; ++item) {
+    if (pivots[item] == num_rows) ++num_factored;
+  }
+  if (num_successful_pivots) {
+    *num_successful_pivots = std::move(pivots);
+  }
+  return num_factored;
+}
+
+template <class Field>
+void BatchedSparseLDL<Field>::FactorItems(Int item_beg, Int item_end,
+                                          const Field* values,
+                                          Int* num_successful_pivots) {
+  const SymmetricFactorizationType factorization_type =
+      control_.ldl_control.scalar_control.factorization_type;
+  const bool is_cholesky = factorization_type == kCholeskyFactorization;
+  const bool is_selfadjoint =
+      factorization_type != kLDLTransposeFactorization;
+  const Int num_rows = NumRows();
+  const Int num_lower_entries = lower_structure_.indices.Size();
+  const Int stride = batch_size_;
+  const Int num_items = item_end - item_beg;
+  Field* lower_values = lower_values_.Data() + item_beg;
+  Field* diagonal_values = diagonal_values_.Data() + item_beg;
+
+  // Load the values of each system into its factor.
+  for (Int index = 0; index < num_lower_entries; ++index) {
+    std::fill(lower_values + index * stride,
+              lower_values + index * stride + num_items, Field{0});
+  }
+  for (Int row = 0; row < num_rows; ++row) {
+    std::fill(diagonal_values + row * stride,
+              diagonal_values + row * stride + num_items, Field{0});
+  }
+  const ConversionPlan::Entry* entries = cplan_.entries();
+  const Int num_plan_entries = cplan_.columnOffsets[num_rows];
+  for (Int index = 0; index < num_plan_entries; ++index) {
+    const ConversionPlan::Entry& entry = entries[index];
+    Field* target = entry.dst < num_lower_entries
+                        ? lower_values + entry.dst * stride
+                        : diagonal_values +
+                              (entry.dst - num_lower_entries) * stride;
+    const Field* source = values + item_beg + entry.src * stride;
+    std::copy(source, source + num_items, target);
+  }
+
+  for (Int item = 0; item < num_items; ++item) {
+    num_successful_pivots[item_beg + item] = num_rows;
+  }
+
+  // The left-looking factorization of every system at once, where each
+  // update is applied to all of the lanes.
+  Buffer<Int> column_update_ptrs(num_rows);
+  Buffer<Field> etas(num_items);
+  for (Int column = 0; column < num_rows; ++column) {
+    column_update_ptrs[column] = lower_structure_.ColumnOffset(column);
+    Field* pivots = diagonal_values + column * stride;
+
+    // for j = find(L(column, :))
+    //   L(column:n, column) -= L(column:n, j) * (d(j) * conj(L(column, j)))
+    for (const Int* iter = row_patterns_.ColumnBeg(column);
+         iter != row_patterns_.ColumnEnd(column); ++iter) {
+      const Int j = *iter;
+      Int j_ptr = column_update_ptrs[j]++;
+      const Int j_end = lower_structure_.ColumnOffset(j + 1);
+      CATAMARI_ASSERT(lower_structure_.indices[j_ptr] == column,
+                      "Did not find L(column, j)");
+
+      const Field* lambdas = lower_values + j_ptr * stride;
+      const Field* deltas = diagonal_values + j * stride;
+      if (is_cholesky) {
+        for (Int item = 0; item < num_items; ++item) {
+          etas[item] = Conjugate(lambdas[item]);
+        }
+      } else if (is_selfadjoint) {
+        for (Int item = 0; item < num_items; ++item) {
+          etas[item] = deltas[item] * Conjugate(lambdas[item]);
+        }
+      } else {
+        for (Int item = 0; item < num_items; ++item) {
+          etas[item] = deltas[item] * lambdas[item];
+        }
+      }
+      for (Int item = 0; item < num_items; ++item) {
+        pivots[item] -= lambdas[item] * etas[item];
+      }
+      ++j_ptr;
+
+      // L(column+1:n, column) -= L(column+1:n, j) * eta.
+      Int column_ptr = lower_structure_.ColumnOffset(column);
+      for (; j_ptr != j_end; ++j_ptr) {
+        const Int row = lower_structure_.indices[j_ptr];
+        while (lower_structure_.indices[column_ptr] < row) {
+          ++column_ptr;
+        }
+        const Field* source = lower_values + j_ptr * stride;
+        Field* target = lower_values + column_ptr * stride;
+        for (Int item = 0; item < num_items; ++item) {
+          target[item] -= source[item] * etas[item];
+        }
+      }
+    }
+
+    // Finalize the pivots. A failed system keeps being factored with unit
+    // pivots, so that its lanes stay finite, but it is reported as failed.
+    for (Int item = 0; item < num_items; ++item) {
+      Field pivot = pivots[item];
+      const bool failed = is_cholesky
+                              ? RealPart(pivot) <= 0
+                              : (is_selfadjoint ? RealPart(pivot) == 0
+                                                : pivot == Field{0});
+      if (failed) {
+        Int& num_pivots = num_successful_pivots[item_beg + item];
+        num_pivots = std::min(num_pivots, column);
+        pivot = Field{1};
+      }
+      if (is_cholesky) {
+        pivot = std::sqrt(RealPart(pivot));
+      } else if (is_selfadjoint) {
+        pivot = RealPart(pivot);
+      }
+      pivots[item] = pivot;
+    }
+
+    // L(column+1:n, column) /= d(column).
+    for (Int index = lower_structure_.ColumnOffset(column);
+         index < lower_structure_.ColumnOffset(column + 1); ++index) {
+      Field* target = lower_values + index * stride;
+      for (Int item = 0; item < num_items; ++item) {
+        target[item] /= pivots[item];
+      }
+    }
+  }
+}
+
+template <class Field>
+void BatchedSparseLDL<Field>::Solve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  if (right_hand_sides->height != batch_size_ ||
+      right_hand_sides->width != NumRows()) {
+    throw std::runtime_error("The right-hand sides have the wrong shape");
+  }
+  const Int lanes = control_.lanes_per_task;
+  const Int num_tasks = (batch_size_ + lanes - 1) / lanes;
+  tbb::parallel_for(Int(0), num_tasks, [&](Int task) {
+    const Int item_beg = task * lanes;
+    const Int item_end = std::min(item_beg + lanes, batch_size_);
+    Buffer<Field> workspace(NumRows() * (item_end - item_beg));
+    SolveItems(item_beg, item_end, right_hand_sides, workspace.Data());
+  });
+}
+
+template <class Field>
+void BatchedSparseLDL<Field>::SolveItems(
+    Int item_beg, Int item_end, BlasMatrixView<Field>* right_hand_sides,
+    Field* workspace) const {
+  const SymmetricFactorizationType factorization_type =
+      control_.ldl_control.scalar_control.factorization_type;
+  const bool is_cholesky = factorization_type == kCholeskyFactorization;
+  const bool is_selfadjoint =
+      factorization_type != kLDLTransposeFactorization;
+  const bool have_permutation = !ordering_.permutation.Empty();
+  const Int num_rows = NumRows();
+  const Int stride = batch_size_;
+  const Int num_items = item_end - item_beg;
+  const Field* lower_values = lower_values_.Data() + item_beg;
+  const Field* diagonal_values = diagonal_values_.Data() + item_beg;
+
+  // Gather the right-hand sides, in the ordering of the factorization, into
+  // the workspace, whose lanes have unit stride.
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int permuted_row =
+        have_permutation ? ordering_.permutation[row] : row;
+    const Field* source = right_hand_sides->Pointer(item_beg, row);
+    std::copy(source, source + num_items, workspace + permuted_row * num_items);
+  }
+
+  // Solve against the lower factor.
+  for (Int column = 0; column < num_rows; ++column) {
+    Field* etas = workspace + column * num_items;
+    if (is_cholesky) {
+      const Field* deltas = diagonal_values + column * stride;
+      for (Int item = 0; item < num_items; ++item) {
+        etas[item] /= deltas[item];
+      }
+    }
+    for (Int index = lower_structure_.ColumnOffset(column);
+         index < lower_structure_.ColumnOffset(column + 1); ++index) {
+      const Field* values = lower_values + index * stride;
+      Field* target = workspace + lower_structure_.indices[index] * num_items;
+      for (Int item = 0; item < num_items; ++item) {
+        target[item] -= values[item] * etas[item];
+      }
+    }
+  }
+
+  // Solve against the diagonal factor.
+  if (!is_cholesky) {
+    for (Int column = 0; column < num_rows; ++column) {
+      Field* etas = workspace + column * num_items;
+      const Field* deltas = diagonal_values + column * stride;
+      for (Int item = 0; item < num_items; ++item) {
+        etas[item] /= deltas[item];
+      }
+    }
+  }
+
+  // Solve against the transpose (or adjoint) of the lower factor.
+  for (Int column = num_rows - 1; column >= 0; --column) {
+    Field* etas = workspace + column * num_items;
+    for (Int index = lower_structure_.ColumnOffset(column);
+         index < lower_structure_.ColumnOffset(column + 1); ++index) {
+      const Field* values = lower_values + index * stride;
+      const Field* source =
+          workspace + lower_structure_.indices[index] * num_items;
+      if (is_selfadjoint) {
+        for (Int item = 0; item < num_items; ++item) {
+          etas[item] -= Conjugate(values[item]) * source[item];
+        }
+      } else {
+        for (Int item = 0; item < num_items; ++item) {
+          etas[item] -= values[item] * source[item];
+        }
+      }
+    }
+    if (is_cholesky) {
+      const Field* deltas = diagonal_values + column * stride;
+      for (Int item = 0; item < num_items; ++item) {
+        etas[item] /= deltas[item];
+      }
+    }
+  }
+
+  // Scatter the solutions back into the original ordering.
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int permuted_row =
+        have_permutation ? ordering_.permutation[row] : row;
+    const Field* source = workspace + permuted_row * num_items;
+    std::copy(source, source + num_items,
+              right_hand_sides->Pointer(item_beg, row));
+  }
+}
+
+template <class Field>
+Int BatchedSparseLDL<Field>::NumRows() const {
+  return lower_structure_.column_offsets.Empty()
+             ? 0
+             : lower_structure_.column_offsets.Size() - 1;
+}
+
+template <class Field>
+Int BatchedSparseLDL<Field>::BatchSize() const {
+  return batch_size_;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_BATCHED_SPARSE_LDL_IMPL_H_
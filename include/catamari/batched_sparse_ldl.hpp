@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_BATCHED_SPARSE_LDL_H_
+#define CATAMARI_BATCHED_SPARSE_LDL_H_
+
+#include "catamari/blas_matrix_view.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// Configuration options for a batched factorization.
+template <typename Field>
+struct BatchedSparseLDLControl {
+  // The configuration of the shared symbolic analysis: its reordering, the
+  // factorization type of 'scalar_control', and how the pattern is stored.
+  // A scalar factorization is always used, and equilibration and dynamic
+  // regularization are not supported.
+  SparseLDLControl<Field> ldl_control;
+
+  // The number of systems, stored in consecutive (interleaved) lanes, which
+  // each task factors or solves together. The innermost loops of the kernels
+  // run over these lanes with unit stride, so they can be vectorized, and the
+  // tasks are distributed over the TBB threads.
+  Int lanes_per_task = 64;
+};
+
+// A batch of sparse LDL' factorizations of matrices which share a single
+// symmetric sparsity pattern, e.g., one per mesh patch. The reordering, the
+// structure of the factor, and the conversion plan of the values are
+// computed once for the whole batch, and the values of the factors of all of
+// the systems are stored interleaved -- the entries of a given position in
+// every factor are contiguous -- so that each step of the left-looking
+// factorization and of the triangular solves is applied to many systems at
+// once.
+template <class Field>
+class BatchedSparseLDL {
+ public:
+  // The underlying real datatype of the scalar type.
+  typedef ComplexBase<Field> Real;
+
+  // Reorders and symbolically factors the symmetric compressed-sparse-column
+  // (or, if 'compressed_rows' is true, compressed-sparse-row) pattern
+  // 'offsets'/'indices' of 'num_rows' rows and forms the plan for loading
+  // 'batch_size' value sets stored in that pattern. Either triangle, or the
+  // full matrix, may be stored (see
+  // scalar_ldl::Factorization::FormConversionPlan).
+  void Analyze(Int num_rows, const Int* offsets, const Int* indices,
+               bool compressed_rows, Int batch_size,
+               const BatchedSparseLDLControl<Field>& control);
+
+  // Numerically factors every system of the batch. The value of entry
+  // 'index' (in the order of the analyzed 'indices') of system 'item' is
+  // 'values[item + index * BatchSize()]'. Returns the number of systems which
+  // were successfully factored and, if 'num_successful_pivots' is non-null,
+  // fills it with the number of successful pivots of each system.
+  Int Factor(const Field* values, Buffer<Int>* num_successful_pivots = nullptr);
+
+  // Solves each system of the batch against a single right-hand side in
+  // place. The right-hand sides are interleaved as the columns of the
+  // 'BatchSize() x NumRows()' matrix, so that entry (item, row) is entry
+  // 'row' of the right-hand side of system 'item'.
+  void Solve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Returns the number of rows of each system.
+  Int NumRows() const;
+
+  // Returns the number of systems in the batch.
+  Int BatchSize() const;
+
+ private:
+  // The configuration of the analysis.
+  BatchedSparseLDLControl<Field> control_;
+
+  // The number of systems in the batch.
+  Int batch_size_ = 0;
+
+  // The reordering shared by every system.
+  SymmetricOrdering ordering_;
+
+  // The structure of the strictly lower factor shared by every system.
+  scalar_ldl::LowerStructure lower_structure_;
+
+  // The patterns of the rows of the strictly lower factor (the transpose of
+  // 'lower_structure_'), which drive the left-looking updates.
+  scalar_ldl::LowerStructure row_patterns_;
+
+  // The plan for loading the values of each system into its factor.
+  ConversionPlan cplan_;
+
+  // The interleaved values of the strictly lower factors, where entry
+  // 'index' of system 'item' is stored at 'item + index * batch_size_'.
+  Buffer<Field> lower_values_;
+
+  // The interleaved diagonals of the factors, laid out as 'lower_values_'.
+  Buffer<Field> diagonal_values_;
+
+  // Factors the systems 'item_beg' through 'item_end - 1'.
+  void FactorItems(Int item_beg, Int item_end, const Field* values,
+                   Int* num_successful_pivots);
+
+  // Solves the systems 'item_beg' through 'item_end - 1', using a workspace
+  // of 'NumRows() * (item_end - item_beg)' entries.
+  void SolveItems(Int item_beg, Int item_end,
+                  BlasMatrixView<Field>* right_hand_sides,
+                  Field* workspace) const;
+};
+
+}  // namespace catamari
+
+#include "catamari/batched_sparse_ldl-impl.hpp"
+
+#endif  // ifndef CATAMARI_BATCHED_SPARSE_LDL_H_
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_BLAS_CUBLAS_H_
+#define CATAMARI_BLAS_CUBLAS_H_
+
+#include <type_traits>
+
+#include <cublas_v2.h>
+#include <cuda_runtime.h>
+
+#include "catamari/complex.hpp"
+
+namespace catamari {
+namespace cublas {
+
+// Whether values of the field can be handed to cuBLAS.
+template <class Field>
+struct IsDeviceField : std::false_type {};
+template <>
+struct IsDeviceField<float> : std::true_type {};
+template <>
+struct IsDeviceField<double> : std::true_type {};
+template <>
+struct IsDeviceField<Complex<float>> : std::true_type {};
+template <>
+struct IsDeviceField<Complex<double>> : std::true_type {};
+
+// B := alpha op(A)^{-1} B or B := alpha B op(A)^{-1}, with A triangular.
+inline cublasStatus_t Trsm(cublasHandle_t handle, cublasSideMode_t side,
+                           cublasFillMode_t uplo, cublasOperation_t trans,
+                           cublasDiagType_t diag, int height, int width,
+                           const float& alpha, const float* triangular_matrix,
+                           int triangular_leading_dim, float* matrix,
+                           int leading_dim) {
+  return cublasStrsm(handle, side, uplo, trans, diag, height, width, &alpha,
+                     triangular_matrix, triangular_leading_dim, matrix,
+                     leading_dim);
+}
+
+inline cublasStatus_t Trsm(cublasHandle_t handle, cublasSideMode_t side,
+                           cublasFillMode_t uplo, cublasOperation_t trans,
+                           cublasDiagType_t diag, int height, int width,
+                           const double& alpha,
+                           const double* triangular_matrix,
+                           int triangular_leading_dim, double* matrix,
+                           int leading_dim) {
+  return cublasDtrsm(handle, side, uplo, trans, diag, height, width, &alpha,
+                     triangular_matrix, triangular_leading_dim, matrix,
+                     leading_dim);
+}
+
+inline cublasStatus_t Trsm(cublasHandle_t handle, cublasSideMode_t side,
+                           cublasFillMode_t uplo, cublasOperation_t trans,
+                           cublasDiagType_t diag, int height, int width,
+                           const Complex<float>& alpha,
+                           const Complex<float>* triangular_matrix,
+                           int triangular_leading_dim, Complex<float>* matrix,
+                           int leading_dim) {
+  return cublasCtrsm(
+      handle, side, uplo, trans, diag, height, width,
+      reinterpret_cast<const cuComplex*>(&alpha),
+      reinterpret_cast<const cuComplex*>(triangular_matrix),
+      triangular_leading_dim, reinterpret_cast<cuComplex*>(matrix),
+      leading_dim);
+}
+
+inline cublasStatus_t Trsm(cublasHandle_t handle, cublasSideMode_t side,
+                           cublasFillMode_t uplo, cublasOperation_t trans,
+                           cublasDiagType_t diag, int height, int width,
+                           const Complex<double>& alpha,
+                           const Complex<double>* triangular_matrix,
+                           int triangular_leading_dim, Complex<double>* matrix,
+                           int leading_dim) {
+  return cublasZtrsm(
+      handle, side, uplo, trans, diag, height, width,
+      reinterpret_cast<const cuDoubleComplex*>(&alpha),
+      reinterpret_cast<const cuDoubleComplex*>(triangular_matrix),
+      triangular_leading_dim, reinterpret_cast<cuDoubleComplex*>(matrix),
+      leading_dim);
+}
+
+// The lower or upper triangle of C := alpha op(A) op(A)' + beta C.
+inline cublasStatus_t Herk(cublasHandle_t handle, cublasFillMode_t uplo,
+                           cublasOperation_t trans, int height,
+                           int rank, const float& alpha, const float* matrix,
+                           int leading_dim, const float& beta, float* result,
+                           int result_leading_dim) {
+  return cublasSsyrk(handle, uplo, trans, height, rank, &alpha, matrix,
+                     leading_dim, &beta, result, result_leading_dim);
+}
+
+inline cublasStatus_t Herk(cublasHandle_t handle, cublasFillMode_t uplo,
+                           cublasOperation_t trans, int height,
+                           int rank, const double& alpha, const double* matrix,
+                           int leading_dim, const double& beta, double* result,
+                           int result_leading_dim) {
+  return cublasDsyrk(handle, uplo, trans, height, rank, &alpha, matrix,
+                     leading_dim, &beta, result, result_leading_dim);
+}
+
+inline cublasStatus_t Herk(cublasHandle_t handle, cublasFillMode_t uplo,
+                           cublasOperation_t trans, int height, int rank,
+                           const float& alpha, const Complex<float>* matrix,
+                           int leading_dim, const float& beta,
+                           Complex<float>* result, int result_leading_dim) {
+  return cublasCherk(handle, uplo, trans, height, rank, &alpha,
+                     reinterpret_cast<const cuComplex*>(matrix), leading_dim,
+                     &beta, reinterpret_cast<cuComplex*>(result),
+                     result_leading_dim);
+}
+
+inline cublasStatus_t Herk(cublasHandle_t handle, cublasFillMode_t uplo,
+                           cublasOperation_t trans, int height, int rank,
+                           const double& alpha, const Complex<double>* matrix,
+                           int leading_dim, const double& beta,
+                           Complex<double>* result, int result_leading_dim) {
+  return cublasZherk(handle, uplo, trans, height, rank, &alpha,
+                     reinterpret_cast<const cuDoubleComplex*>(matrix),
+                     leading_dim, &beta,
+                     reinterpret_cast<cuDoubleComplex*>(result),
+                     result_leading_dim);
+}
+
+// The lower or upper triangle of C := alpha op(A) op(B)' + beta C, where the
+// result is assumed to be Hermitian.
+inline cublasStatus_t Herkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const float& alpha, const float* left_matrix,
+                            int left_leading_dim, const float* right_matrix,
+                            int right_leading_dim, const float& beta,
+                            float* result, int result_leading_dim) {
+  return cublasSsyrkx(handle, uplo, trans, height, rank, &alpha, left_matrix,
+                      left_leading_dim, right_matrix, right_leading_dim, &beta,
+                      result, result_leading_dim);
+}
+
+inline cublasStatus_t Herkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const double& alpha, const double* left_matrix,
+                            int left_leading_dim, const double* right_matrix,
+                            int right_leading_dim, const double& beta,
+                            double* result, int result_leading_dim) {
+  return cublasDsyrkx(handle, uplo, trans, height, rank, &alpha, left_matrix,
+                      left_leading_dim, right_matrix, right_leading_dim, &beta,
+                      result, result_leading_dim);
+}
+
+inline cublasStatus_t Herkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const Complex<float>& alpha,
+                            const Complex<float>* left_matrix,
+                            int left_leading_dim,
+                            const Complex<float>* right_matrix,
+                            int right_leading_dim, const float& beta,
+                            Complex<float>* result, int result_leading_dim) {
+  return cublasCherkx(handle, uplo, trans, height, rank,
+                      reinterpret_cast<const cuComplex*>(&alpha),
+                      reinterpret_cast<const cuComplex*>(left_matrix),
+                      left_leading_dim,
+                      reinterpret_cast<const cuComplex*>(right_matrix),
+                      right_leading_dim, &beta,
+                      reinterpret_cast<cuComplex*>(result),
+                      result_leading_dim);
+}
+
+inline cublasStatus_t Herkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const Complex<double>& alpha,
+                            const Complex<double>* left_matrix,
+                            int left_leading_dim,
+                            const Complex<double>* right_matrix,
+                            int right_leading_dim, const double& beta,
+                            Complex<double>* result, int result_leading_dim) {
+  return cublasZherkx(handle, uplo, trans, height, rank,
+                      reinterpret_cast<const cuDoubleComplex*>(&alpha),
+                      reinterpret_cast<const cuDoubleComplex*>(left_matrix),
+                      left_leading_dim,
+                      reinterpret_cast<const cuDoubleComplex*>(right_matrix),
+                      right_leading_dim, &beta,
+                      reinterpret_cast<cuDoubleComplex*>(result),
+                      result_leading_dim);
+}
+
+// The lower or upper triangle of C := alpha op(A) op(B)^T + beta C, where the
+// result is assumed to be complex symmetric.
+inline cublasStatus_t Syrkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const float& alpha, const float* left_matrix,
+                            int left_leading_dim, const float* right_matrix,
+                            int right_leading_dim, const float& beta,
+                            float* result, int result_leading_dim) {
+  return cublasSsyrkx(handle, uplo, trans, height, rank, &alpha, left_matrix,
+                      left_leading_dim, right_matrix, right_leading_dim, &beta,
+                      result, result_leading_dim);
+}
+
+inline cublasStatus_t Syrkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const double& alpha, const double* left_matrix,
+                            int left_leading_dim, const double* right_matrix,
+                            int right_leading_dim, const double& beta,
+                            double* result, int result_leading_dim) {
+  return cublasDsyrkx(handle, uplo, trans, height, rank, &alpha, left_matrix,
+                      left_leading_dim, right_matrix, right_leading_dim, &beta,
+                      result, result_leading_dim);
+}
+
+inline cublasStatus_t Syrkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const Complex<float>& alpha,
+                            const Complex<float>* left_matrix,
+                            int left_leading_dim,
+                            const Complex<float>* right_matrix,
+                            int right_leading_dim, const Complex<float>& beta,
+                            Complex<float>* result, int result_leading_dim) {
+  return cublasCsyrkx(handle, uplo, trans, height, rank,
+                      reinterpret_cast<const cuComplex*>(&alpha),
+                      reinterpret_cast<const cuComplex*>(left_matrix),
+                      left_leading_dim,
+                      reinterpret_cast<const cuComplex*>(right_matrix),
+                      right_leading_dim,
+                      reinterpret_cast<const cuComplex*>(&beta),
+                      reinterpret_cast<cuComplex*>(result),
+                      result_leading_dim);
+}
+
+inline cublasStatus_t Syrkx(cublasHandle_t handle, cublasFillMode_t uplo,
+                            cublasOperation_t trans, int height, int rank,
+                            const Complex<double>& alpha,
+                            const Complex<double>* left_matrix,
+                            int left_leading_dim,
+                            const Complex<double>* right_matrix,
+                            int right_leading_dim, const Complex<double>& beta,
+                            Complex<double>* result, int result_leading_dim) {
+  return cublasZsyrkx(handle, uplo, trans, height, rank,
+                      reinterpret_cast<const cuDoubleComplex*>(&alpha),
+                      reinterpret_cast<const cuDoubleComplex*>(left_matrix),
+                      left_leading_dim,
+                      reinterpret_cast<const cuDoubleComplex*>(right_matrix),
+                      right_leading_dim,
+                      reinterpret_cast<const cuDoubleComplex*>(&beta),
+                      reinterpret_cast<cuDoubleComplex*>(result),
+                      result_leading_dim);
+}
+
+// C := A diag(x) or C := diag(x) A.
+inline cublasStatus_t Dgmm(cublasHandle_t handle, cublasSideMode_t side,
+                           int height, int width, const float* matrix,
+                           int leading_dim, const float* diagonal,
+                           int diagonal_stride, float* result,
+                           int result_leading_dim) {
+  return cublasSdgmm(handle, side, height, width, matrix, leading_dim,
+                     diagonal, diagonal_stride, result, result_leading_dim);
+}
+
+inline cublasStatus_t Dgmm(cublasHandle_t handle, cublasSideMode_t side,
+                           int height, int width, const double* matrix,
+                           int leading_dim, const double* diagonal,
+                           int diagonal_stride, double* result,
+                           int result_leading_dim) {
+  return cublasDdgmm(handle, side, height, width, matrix, leading_dim,
+                     diagonal, diagonal_stride, result, result_leading_dim);
+}
+
+inline cublasStatus_t Dgmm(cublasHandle_t handle, cublasSideMode_t side,
+                           int height, int width,
+                           const Complex<float>* matrix, int leading_dim,
+                           const Complex<float>* diagonal, int diagonal_stride,
+                           Complex<float>* result, int result_leading_dim) {
+  return cublasCdgmm(handle, side, height, width,
+                     reinterpret_cast<const cuComplex*>(matrix), leading_dim,
+                     reinterpret_cast<const cuComplex*>(diagonal),
+                     diagonal_stride, reinterpret_cast<cuComplex*>(result),
+                     result_leading_dim);
+}
+
+inline cublasStatus_t Dgmm(cublasHandle_t handle, cublasSideMode_t side,
+                           int height, int width,
+                           const Complex<double>* matrix, int leading_dim,
+                           const Complex<double>* diagonal,
+                           int diagonal_stride, Complex<double>* result,
+                           int result_leading_dim) {
+  return cublasZdgmm(handle, side, height, width,
+                     reinterpret_cast<const cuDoubleComplex*>(matrix),
+                     leading_dim,
+                     reinterpret_cast<const cuDoubleComplex*>(diagonal),
+                     diagonal_stride,
+                     reinterpret_cast<cuDoubleComplex*>(result),
+                     result_leading_dim);
+}
+
+// C := alpha op(A) op(B) + beta C.
+inline cublasStatus_t Gemm(cublasHandle_t handle, cublasOperation_t left_trans,
+                           cublasOperation_t right_trans, int height,
+                           int width, int rank, const float& alpha,
+                           const float* left_matrix, int left_leading_dim,
+                           const float* right_matrix, int right_leading_dim,
+                           const float& beta, float* result,
+                           int result_leading_dim) {
+  return cublasSgemm(handle, left_trans, right_trans, height, width, rank,
+                     &alpha, left_matrix, left_leading_dim, right_matrix,
+                     right_leading_dim, &beta, result, result_leading_dim);
+}
+
+inline cublasStatus_t Gemm(cublasHandle_t handle, cublasOperation_t left_trans,
+                           cublasOperation_t right_trans, int height,
+                           int width, int rank, const double& alpha,
+                           const double* left_matrix, int left_leading_dim,
+                           const double* right_matrix, int right_leading_dim,
+                           const double& beta, double* result,
+                           int result_leading_dim) {
+  return cublasDgemm(handle, left_trans, right_trans, height, width, rank,
+                     &alpha, left_matrix, left_leading_dim, right_matrix,
+                     right_leading_dim, &beta, result, result_leading_dim);
+}
+
+inline cublasStatus_t Gemm(cublasHandle_t handle, cublasOperation_t left_trans,
+                           cublasOperation_t right_trans, int height,
+                           int width, int rank, const Complex<float>& alpha,
+                           const Complex<float>* left_matrix,
+                           int left_leading_dim,
+                           const Complex<float>* right_matrix,
+                           int right_leading_dim, const Complex<float>& beta,
+                           Complex<float>* result, int result_leading_dim) {
+  return cublasCgemm(handle, left_trans, right_trans, height, width, rank,
+                     reinterpret_cast<const cuComplex*>(&alpha),
+                     reinterpret_cast<const cuComplex*>(left_matrix),
+                     left_leading_dim,
+                     reinterpret_cast<const cuComplex*>(right_matrix),
+                     right_leading_dim,
+                     reinterpret_cast<const cuComplex*>(&beta),
+                     reinterpret_cast<cuComplex*>(result), result_leading_dim);
+}
+
+inline cublasStatus_t Gemm(cublasHandle_t handle, cublasOperation_t left_trans,
+                           cublasOperation_t right_trans, int height,
+                           int width, int rank, const Complex<double>& alpha,
+                           const Complex<double>* left_matrix,
+                           int left_leading_dim,
+                           const Complex<double>* right_matrix,
+                           int right_leading_dim, const Complex<double>& beta,
+                           Complex<double>* result, int result_leading_dim) {
+  return cublasZgemm(handle, left_trans, right_trans, height, width, rank,
+                     reinterpret_cast<const cuDoubleComplex*>(&alpha),
+                     reinterpret_cast<const cuDoubleComplex*>(left_matrix),
+                     left_leading_dim,
+                     reinterpret_cast<const cuDoubleComplex*>(right_matrix),
+                     right_leading_dim,
+                     reinterpret_cast<const cuDoubleComplex*>(&beta),
+                     reinterpret_cast<cuDoubleComplex*>(result),
+                     result_leading_dim);
+}
+
+}  // namespace cublas
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_BLAS_CUBLAS_H_
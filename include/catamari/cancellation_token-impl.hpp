@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_CANCELLATION_TOKEN_IMPL_H_
+#define CATAMARI_CANCELLATION_TOKEN_IMPL_H_
+
+#include "catamari/cancellation_token.hpp"
+
+namespace catamari {
+
+inline void CancellationToken::Cancel() {
+  cancelled_.store(true, std::memory_order_relaxed);
+}
+
+inline void CancellationToken::SetDeadline(Clock::time_point deadline) {
+  deadline_.store(deadline.time_since_epoch().count(),
+                  std::memory_order_relaxed);
+}
+
+inline void CancellationToken::SetTimeLimit(double seconds) {
+  SetDeadline(Clock::now() +
+              std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(seconds)));
+}
+
+inline void CancellationToken::Reset() {
+  cancelled_.store(false, std::memory_order_relaxed);
+  deadline_.store(kNoDeadline, std::memory_order_relaxed);
+}
+
+inline bool CancellationToken::Cancelled() const {
+  if (cancelled_.load(std::memory_order_relaxed)) return true;
+  // The clock is only read if a deadline was set.
+  const Clock::rep deadline = deadline_.load(std::memory_order_relaxed);
+  return deadline != kNoDeadline &&
+         Clock::now().time_since_epoch().count() >= deadline;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_CANCELLATION_TOKEN_IMPL_H_
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_CANCELLATION_TOKEN_H_
+#define CATAMARI_CANCELLATION_TOKEN_H_
+
+#include <atomic>
+#include <chrono>
+
+namespace catamari {
+
+// A thread-safe request that a running factorization stop as soon as
+// possible, either because 'Cancel' was called (e.g., from another thread
+// once a newer request has made the factorization stale) or because its
+// deadline has passed. A factorization observing a cancelled token stops
+// scheduling work, cancels its outstanding tasks, and reports an incomplete
+// result (see 'SparseLDLResult::cancelled'). A token may be shared by any
+// number of concurrent factorizations, and must outlive them.
+class CancellationToken {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  // Requests that the factorizations observing the token stop.
+  void Cancel();
+
+  // Sets the time after which the token counts as cancelled.
+  void SetDeadline(Clock::time_point deadline);
+
+  // Sets the deadline to 'seconds' from now.
+  void SetTimeLimit(double seconds);
+
+  // Clears the cancellation request and the deadline, so that the token can
+  // be reused.
+  void Reset();
+
+  // Returns whether a cancellation was requested or the deadline has passed.
+  bool Cancelled() const;
+
+ private:
+  // The representation of the absence of a deadline.
+  static constexpr Clock::rep kNoDeadline = Clock::duration::max().count();
+
+  // Whether 'Cancel' was called since the last 'Reset'.
+  std::atomic<bool> cancelled_{false};
+
+  // The deadline, as a count since the epoch of 'Clock'.
+  std::atomic<Clock::rep> deadline_{kNoDeadline};
+};
+
+}  // namespace catamari
+
+#include "catamari/cancellation_token-impl.hpp"
+
+#endif  // ifndef CATAMARI_CANCELLATION_TOKEN_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_CONVERSION_PLAN_H_
+#define CATAMARI_CONVERSION_PLAN_H_
+
+#include <cstddef>
+
+#include <Eigen/Dense>
+
+#include "catamari/buffer.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+
+// Sparse record of destination location and source entry for each input
+// matrix entry in the lower factor. This is stored in a
+// compressed-sparse-column-type format.
+struct ConversionPlan {
+    // Destination and source of each input matrix entry appearing in the factor.
+    // Crucially does no value initialization, unlike std::pair!
+    struct Entry { Int dst, src; };
+
+    // A maximal sequence of a column's entries whose destinations and sources
+    // are both consecutive, which can be loaded with a contiguous copy.
+    struct Run { Int dst, src, length; };
+
+    void resize(size_t size) { m_entries.Resize(size); m_runOffsets.Clear(); }
+    bool empty() const { return m_entries.Size() == 0; }
+
+    const Entry *entries() const { return m_entries.Data(); }
+          Entry *entries()       { return m_entries.Data(); }
+    const Entry *columnData(int j) const { return entries() + columnOffsets[j]; }
+
+    // Re-encodes the entries of each column into runs, which are then used to
+    // load the values if their average length is at least
+    // 'min_average_length' (otherwise, the entries are scattered one at a
+    // time). This must be called again after modifying the entries.
+    void encodeRuns(Int min_average_length = 4) {
+        m_runOffsets.Clear();
+        m_sortedColumns = true;
+        const Int numColumns = columnOffsets.size() - 1;
+        if (numColumns <= 0) return;
+        Int numRuns = 0;
+        for (Int j = 0; j < numColumns; ++j) {
+            for (Int k = columnOffsets[j]; k < columnOffsets[j + 1]; ++k) {
+                numRuns += (k == columnOffsets[j]) || !extendsRun(k);
+                if (k > columnOffsets[j] && m_entries[k].dst <= m_entries[k - 1].dst)
+                    m_sortedColumns = false;
+            }
+        }
+        if (numRuns * min_average_length > columnOffsets[numColumns]) return;
+
+        m_runs.Resize(numRuns);
+        m_runOffsets.Resize(numColumns + 1);
+        Int r = 0;
+        for (Int j = 0; j < numColumns; ++j) {
+            m_runOffsets[j] = r;
+            for (Int k = columnOffsets[j]; k < columnOffsets[j + 1]; ++k) {
+                if ((k > columnOffsets[j]) && extendsRun(k)) { ++m_runs[r - 1].length; continue; }
+                m_runs[r++] = Run{m_entries[k].dst, m_entries[k].src, 1};
+            }
+        }
+        m_runOffsets[numColumns] = r;
+    }
+
+    bool hasRuns() const { return !m_runOffsets.Empty(); }
+
+    // Whether the destinations of each column's entries are strictly
+    // increasing (as determined by the last call to 'encodeRuns'), so that a
+    // column can be loaded in a single forward sweep.
+    bool sortedColumns() const { return m_sortedColumns; }
+    const Run *columnRunsBegin(Int j) const { return m_runs.Data() + m_runOffsets[j]; }
+    const Run *columnRunsEnd  (Int j) const { return m_runs.Data() + m_runOffsets[j + 1]; }
+
+    Eigen::Array<Int, Eigen::Dynamic, 1> columnOffsets;
+
+    // The structure epoch (see 'Factorization::StructureEpoch') of the
+    // factorization which formed the plan. The destinations are only valid
+    // while the factorization's structure is unchanged.
+    Int structureEpoch = 0;
+private:
+    bool extendsRun(Int k) const {
+        return (m_entries[k].dst == m_entries[k - 1].dst + 1) &&
+               (m_entries[k].src == m_entries[k - 1].src + 1);
+    }
+
+    Buffer<Entry> m_entries;
+    Buffer<Run> m_runs;
+    Buffer<Int> m_runOffsets;
+    bool m_sortedColumns = false;
+};
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_CONVERSION_PLAN_H_
@@ -9,20 +9,30 @@
 #define CATAMARI_COORDINATE_MATRIX_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+
 #include "catamari/complex.hpp"
 #include "catamari/integers.hpp"
 #include "catamari/macros.hpp"
 #include "catamari/matrix_market.hpp"
+#include "catamari/trace.hpp"
+#include "quotient/index_utils.hpp"
 
 #include "catamari/coordinate_matrix.hpp"
-#include "../../../../../src/lib/MeshFEM/GlobalBenchmark.hh"
 
 namespace catamari {
 
@@ -48,6 +58,7 @@ CoordinateMatrix<Ring>& CoordinateMatrix<Ring>::operator=(
   num_columns_ = matrix.num_columns_;
   entries_ = matrix.entries_;
   row_entry_offsets_ = matrix.row_entry_offsets_;
+  column_indices_ = matrix.column_indices_;
   entries_to_add_ = matrix.entries_to_add_;
   entries_to_remove_ = matrix.entries_to_remove_;
 
@@ -161,6 +172,167 @@ CoordinateMatrix<Ring>::FromMatrixMarket(const std::string& filename,
   return result;
 }
 
+template <class Ring>
+std::unique_ptr<CoordinateMatrix<Ring>>
+CoordinateMatrix<Ring>::FromMappedMatrixMarket(const std::string& filename,
+                                               bool skip_explicit_zeros,
+                                               EntryMask mask) {
+  std::unique_ptr<CoordinateMatrix<Ring>> result;
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return result;
+  }
+
+  // Fill the description of the Matrix Market data.
+  MatrixMarketDescription description;
+  if (!quotient::ReadMatrixMarketDescription(file, &description)) {
+    return result;
+  }
+  if (description.format == quotient::kMatrixMarketFormatArray) {
+    // Dense files are rare enough that the streaming reader suffices.
+    file.close();
+    return FromMatrixMarket(filename, skip_explicit_zeros, mask);
+  }
+
+  // Read in the number of matrix dimensions and the number of entries specified
+  // in the file.
+  Int num_rows, num_columns, num_entries;
+  if (!quotient::ReadMatrixMarketCoordinateMetadata(
+          description, file, &num_rows, &num_columns, &num_entries)) {
+    return result;
+  }
+  const std::streamoff data_offset = file.tellg();
+  file.close();
+  if (data_offset < 0) {
+    std::cerr << "Could not locate the entries of " << filename << std::endl;
+    return result;
+  }
+
+  MappedFile mapped_file;
+  if (!mapped_file.Map(filename)) {
+    std::cerr << "Could not map " << filename << std::endl;
+    return result;
+  }
+  const char* data_beg = mapped_file.Data() + data_offset;
+  const char* data_end = mapped_file.Data() + mapped_file.Size();
+  if (data_beg > data_end) data_beg = data_end;
+
+  // Split the entries into chunks which begin at line boundaries.
+  const std::size_t data_size = data_end - data_beg;
+  const Int num_chunks = std::max<Int>(
+      1, std::min<Int>(4 * tbb::this_task_arena::max_concurrency(),
+                       data_size / 4096));
+  Buffer<const char*> chunk_offsets(num_chunks + 1);
+  chunk_offsets[0] = data_beg;
+  for (Int chunk = 1; chunk < num_chunks; ++chunk) {
+    const char* iter = std::max(chunk_offsets[chunk - 1],
+                                data_beg + (chunk * data_size) / num_chunks);
+    while (iter != data_end && iter[-1] != '\n') ++iter;
+    chunk_offsets[chunk] = iter;
+  }
+  chunk_offsets[num_chunks] = data_end;
+
+  // Parse each chunk into its own list of entries, so that the symmetric
+  // expansion and explicit-zero skipping are also performed in parallel.
+  const bool symmetric =
+      description.symmetry != quotient::kMatrixMarketSymmetryGeneral;
+  Buffer<std::vector<MatrixEntry<Ring>>> chunk_entries(num_chunks);
+  Buffer<Int> chunk_num_read(num_chunks, 0);
+  Buffer<Int> chunk_num_skipped(num_chunks, 0);
+  Buffer<char> chunk_failed(num_chunks, false);
+  tbb::parallel_for(Int(0), num_chunks, [&](Int chunk) {
+    std::vector<MatrixEntry<Ring>>& entries = chunk_entries[chunk];
+    const char* iter = chunk_offsets[chunk];
+    const char* chunk_end = chunk_offsets[chunk + 1];
+    const std::size_t entries_estimate = (chunk_end - iter) / 16;
+    entries.reserve(symmetric ? 2 * entries_estimate : entries_estimate);
+    while (true) {
+      while (iter != chunk_end && matrix_market::IsWhitespace(*iter)) ++iter;
+      if (iter == chunk_end) break;
+
+      Int row, column;
+      Ring value;
+      iter = ParseMatrixMarketCoordinateEntry(description, iter, chunk_end,
+                                              &row, &column, &value);
+      if (!iter || row < 0 || row >= num_rows || column < 0 ||
+          column >= num_columns) {
+        chunk_failed[chunk] = true;
+        return;
+      }
+      ++chunk_num_read[chunk];
+
+      if ((mask == quotient::kEntryMaskLowerTriangle && row < column) ||
+          (mask == quotient::kEntryMaskUpperTriangle && row > column)) {
+        continue;
+      }
+
+      if (skip_explicit_zeros) {
+        // Skip this entry if it is numerically zero.
+        if (value == Ring(0)) {
+          ++chunk_num_skipped[chunk];
+          continue;
+        }
+      }
+
+      entries.emplace_back(row, column, value);
+      if (row != column) {
+        if (description.symmetry == quotient::kMatrixMarketSymmetrySymmetric) {
+          entries.emplace_back(column, row, value);
+        } else if (description.symmetry ==
+                   quotient::kMatrixMarketSymmetryHermitian) {
+          entries.emplace_back(column, row, Conjugate(value));
+        } else if (description.symmetry ==
+                   quotient::kMatrixMarketSymmetrySkewSymmetric) {
+          entries.emplace_back(column, row, -value);
+        }
+      }
+    }
+  });
+
+  Int num_read = 0;
+  Int num_skipped_entries = 0;
+  Buffer<Int> entry_offsets(num_chunks + 1);
+  entry_offsets[0] = 0;
+  for (Int chunk = 0; chunk < num_chunks; ++chunk) {
+    if (chunk_failed[chunk]) {
+      std::cerr << "Could not parse the entries of " << filename << std::endl;
+      return result;
+    }
+    num_read += chunk_num_read[chunk];
+    num_skipped_entries += chunk_num_skipped[chunk];
+    entry_offsets[chunk + 1] =
+        entry_offsets[chunk] + chunk_entries[chunk].size();
+  }
+  if (num_read != num_entries) {
+    std::cerr << "Expected " << num_entries << " entries in " << filename
+              << " but found " << num_read << std::endl;
+    return result;
+  }
+
+  // Concatenate, sort, and combine the entries.
+  result.reset(new CoordinateMatrix<Ring>);
+  result->Resize(num_rows, num_columns);
+  Buffer<MatrixEntry<Ring>>& entries = result->entries_;
+  entries.Resize(entry_offsets[num_chunks]);
+  tbb::parallel_for(Int(0), num_chunks, [&](Int chunk) {
+    std::vector<MatrixEntry<Ring>>& local_entries = chunk_entries[chunk];
+    std::copy(local_entries.begin(), local_entries.end(),
+              entries.begin() + entry_offsets[chunk]);
+    SwapClearVector(&local_entries);
+  });
+  tbb::parallel_sort(entries.begin(), entries.end());
+  CombineSortedEntries(&entries);
+  result->UpdateRowEntryOffsets();
+
+  if (num_skipped_entries) {
+    std::cout << "Skipped " << num_skipped_entries << " explicit zeros."
+              << std::endl;
+  }
+
+  return result;
+}
+
 template <class Ring>
 void CoordinateMatrix<Ring>::ToMatrixMarket(const std::string& filename) const {
   std::ofstream file(filename);
@@ -204,6 +376,311 @@ void CoordinateMatrix<Ring>::ToMatrixMarket(const std::string& filename) const {
   }
 }
 
+template <class Ring>
+std::unique_ptr<CoordinateMatrix<Ring>> CoordinateMatrix<Ring>::FromBinary(
+    const std::string& filename) {
+  std::unique_ptr<CoordinateMatrix<Ring>> result;
+  MappedFile mapped_file;
+  if (!mapped_file.Map(filename)) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return result;
+  }
+  const std::uint64_t num_bytes = mapped_file.Size();
+  if (num_bytes < sizeof(CoordinateMatrixBinaryHeader)) {
+    std::cerr << filename << " is not a binary CoordinateMatrix." << std::endl;
+    return result;
+  }
+
+  // Validate the header and the array bounds.
+  const CoordinateMatrixBinaryHeader& header =
+      *reinterpret_cast<const CoordinateMatrixBinaryHeader*>(
+          mapped_file.Data());
+  std::string error;
+  if (std::memcmp(header.magic, "CATAMTRX", sizeof(header.magic))) {
+    error = " is not a binary CoordinateMatrix.";
+  } else if (header.version != kCoordinateMatrixBinaryVersion) {
+    error = " has unsupported version " + std::to_string(header.version) + ".";
+  } else if (header.byte_order != 0x01020304 ||
+             header.int_size != sizeof(Int)) {
+    error = " was written on an incompatible platform.";
+  } else if (header.field_size != sizeof(Ring) ||
+             header.is_complex != IsComplex<Ring>::value) {
+    error = " holds a different scalar type.";
+  } else if (header.num_rows < 0 || header.num_columns < 0 ||
+             header.num_entries < 0) {
+    error = " is truncated or corrupt.";
+  } else {
+    const std::uint64_t array_offsets[] = {header.row_offsets_offset,
+                                           header.columns_offset,
+                                           header.values_offset};
+    const std::uint64_t array_sizes[] = {
+        (header.num_rows + 1) * sizeof(Int), header.num_entries * sizeof(Int),
+        header.num_entries * sizeof(Ring)};
+    for (int array = 0; array < 3; ++array) {
+      if (array_offsets[array] % kCoordinateMatrixBinaryAlignment ||
+          array_offsets[array] > num_bytes ||
+          array_sizes[array] > num_bytes - array_offsets[array]) {
+        error = " is truncated or corrupt.";
+      }
+    }
+  }
+  if (!error.empty()) {
+    std::cerr << filename << error << std::endl;
+    return result;
+  }
+  const Int num_rows = header.num_rows;
+  const Int num_columns = header.num_columns;
+  const Int num_entries = header.num_entries;
+  const Int* row_offsets = reinterpret_cast<const Int*>(
+      mapped_file.Data() + header.row_offsets_offset);
+  const Int* columns =
+      reinterpret_cast<const Int*>(mapped_file.Data() + header.columns_offset);
+  const Ring* values =
+      reinterpret_cast<const Ring*>(mapped_file.Data() + header.values_offset);
+
+  // The row offsets must be a monotone partition of the entries.
+  if (row_offsets[0] != 0 || row_offsets[num_rows] != num_entries) {
+    std::cerr << filename << " is truncated or corrupt." << std::endl;
+    return result;
+  }
+  for (Int row = 0; row < num_rows; ++row) {
+    if (row_offsets[row] > row_offsets[row + 1]) {
+      std::cerr << filename << " is truncated or corrupt." << std::endl;
+      return result;
+    }
+  }
+
+  // Expand the rows into entries in parallel, checking the column indices.
+  result.reset(new CoordinateMatrix<Ring>);
+  result->num_rows_ = num_rows;
+  result->num_columns_ = num_columns;
+  result->row_entry_offsets_.Resize(num_rows + 1);
+  std::copy(row_offsets, row_offsets + num_rows + 1,
+            result->row_entry_offsets_.Data());
+  result->column_indices_.Resize(num_entries);
+  std::copy(columns, columns + num_entries, result->column_indices_.Data());
+  result->entries_.Resize(num_entries);
+  MatrixEntry<Ring>* entries = result->entries_.Data();
+  std::atomic<bool> invalid_column(false);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          for (Int index = row_offsets[row]; index < row_offsets[row + 1];
+               ++index) {
+            const Int column = columns[index];
+            if (column < 0 || column >= num_columns ||
+                (index > row_offsets[row] && column <= columns[index - 1])) {
+              invalid_column = true;
+            }
+            entries[index] = MatrixEntry<Ring>(row, column, values[index]);
+          }
+        }
+      });
+  if (invalid_column) {
+    std::cerr << filename << " has invalid or unsorted column indices."
+              << std::endl;
+    result.reset();
+  }
+
+  return result;
+}
+
+template <class Ring>
+void CoordinateMatrix<Ring>::ToBinary(const std::string& filename) const {
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return;
+  }
+  const Int num_entries = NumEntries();
+
+  CoordinateMatrixBinaryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "CATAMTRX", sizeof(header.magic));
+  header.version = kCoordinateMatrixBinaryVersion;
+  header.byte_order = 0x01020304;
+  header.int_size = sizeof(Int);
+  header.field_size = sizeof(Ring);
+  header.is_complex = IsComplex<Ring>::value;
+  header.num_rows = num_rows_;
+  header.num_columns = num_columns_;
+  header.num_entries = num_entries;
+
+  // Each array begins at an aligned offset.
+  std::uint64_t offset = sizeof(header);
+  auto align_offset = [&]() {
+    offset += (kCoordinateMatrixBinaryAlignment -
+               offset % kCoordinateMatrixBinaryAlignment) %
+              kCoordinateMatrixBinaryAlignment;
+    return offset;
+  };
+  header.row_offsets_offset = align_offset();
+  offset += (num_rows_ + 1) * sizeof(Int);
+  header.columns_offset = align_offset();
+  offset += num_entries * sizeof(Int);
+  header.values_offset = align_offset();
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  static const char kPadding[kCoordinateMatrixBinaryAlignment] = {};
+  std::uint64_t num_written = sizeof(header);
+  auto write_array = [&](std::uint64_t array_offset, const char* data,
+                         std::uint64_t num_bytes) {
+    file.write(kPadding, array_offset - num_written);
+    file.write(data, num_bytes);
+    num_written = array_offset + num_bytes;
+  };
+  write_array(header.row_offsets_offset,
+              reinterpret_cast<const char*>(row_entry_offsets_.Data()),
+              (num_rows_ + 1) * sizeof(Int));
+
+  Buffer<Ring> values(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    values[index] = entries_[index].value;
+  }
+  write_array(header.columns_offset,
+              reinterpret_cast<const char*>(column_indices_.Data()),
+              num_entries * sizeof(Int));
+  write_array(header.values_offset,
+              reinterpret_cast<const char*>(values.Data()),
+              num_entries * sizeof(Ring));
+
+  file.close();
+  if (!file) {
+    std::cerr << "Could not write " << filename << std::endl;
+  }
+}
+
+template <class Ring>
+std::unique_ptr<CoordinateMatrix<Ring>> CoordinateMatrix<Ring>::FromTriplets(
+    Int num_rows, Int num_columns, const Buffer<Int>& rows,
+    const Buffer<Int>& columns, const Buffer<Ring>& values,
+    DuplicateCombination combination) {
+  const Int num_triplets = rows.Size();
+  CATAMARI_ASSERT(Int(columns.Size()) == num_triplets &&
+                      Int(values.Size()) == num_triplets,
+                  "The triplet lists had different lengths.");
+  std::unique_ptr<CoordinateMatrix<Ring>> result(new CoordinateMatrix<Ring>);
+  result->Resize(num_rows, num_columns);
+
+  // Each block of triplets counts its own rows, so the number of blocks is
+  // limited to keep the counts no larger than the triplets themselves.
+  const Int num_blocks = std::max<Int>(
+      1, std::min<Int>(tbb::this_task_arena::max_concurrency(),
+                       num_triplets / std::max<Int>(num_rows, 1)));
+  const Int block_size = (num_triplets + num_blocks - 1) / num_blocks;
+  auto block_range = [&](Int block) {
+    return std::make_pair(std::min(block * block_size, num_triplets),
+                          std::min((block + 1) * block_size, num_triplets));
+  };
+
+  // The first pass: 'block_offsets[block * num_rows + row]' is the number of
+  // triplets of the block in the given row.
+  Buffer<Int> block_offsets(num_blocks * num_rows, 0);
+  tbb::parallel_for(Int(0), num_blocks, [&](Int block) {
+    Int* counts = &block_offsets[block * num_rows];
+    const std::pair<Int, Int> range = block_range(block);
+    for (Int index = range.first; index < range.second; ++index) {
+      const Int row = rows[index];
+      CATAMARI_ASSERT(row >= 0 && row < num_rows,
+                      "ERROR: Row index was out of bounds.");
+      CATAMARI_ASSERT(columns[index] >= 0 && columns[index] < num_columns,
+                      "ERROR: Column index was out of bounds.");
+      ++counts[row];
+    }
+  });
+
+  // Convert the counts into the beginning of each block's portion of each
+  // row, with the blocks in order so that the sort is stable.
+  Buffer<Int> row_sizes(num_rows);
+  tbb::parallel_for(Int(0), num_rows, [&](Int row) {
+    Int row_size = 0;
+    for (Int block = 0; block < num_blocks; ++block) {
+      row_size += block_offsets[block * num_rows + row];
+    }
+    row_sizes[row] = row_size;
+  });
+  Buffer<Int> row_offsets;
+  quotient::OffsetScan(row_sizes, &row_offsets);
+  tbb::parallel_for(Int(0), num_rows, [&](Int row) {
+    Int offset = row_offsets[row];
+    for (Int block = 0; block < num_blocks; ++block) {
+      const Int count = block_offsets[block * num_rows + row];
+      block_offsets[block * num_rows + row] = offset;
+      offset += count;
+    }
+  });
+
+  // The second pass scatters the triplets into their rows.
+  Buffer<MatrixEntry<Ring>> bucketed_entries(num_triplets);
+  tbb::parallel_for(Int(0), num_blocks, [&](Int block) {
+    Int* offsets = &block_offsets[block * num_rows];
+    const std::pair<Int, Int> range = block_range(block);
+    for (Int index = range.first; index < range.second; ++index) {
+      const Int row = rows[index];
+      bucketed_entries[offsets[row]++] =
+          MatrixEntry<Ring>{row, columns[index], values[index]};
+    }
+  });
+  block_offsets.Clear();
+
+  // Sort each row by column (stably, so that the triplet order of the
+  // duplicates is preserved) and combine its duplicates in place.
+  auto column_less = [](const MatrixEntry<Ring>& a,
+                        const MatrixEntry<Ring>& b) {
+    return a.column < b.column;
+  };
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          MatrixEntry<Ring>* row_entries =
+              bucketed_entries.Data() + row_offsets[row];
+          const Int row_size = row_sizes[row];
+          std::stable_sort(row_entries, row_entries + row_size, column_less);
+
+          Int num_packed = 0;
+          for (Int index = 0; index < row_size; ++index) {
+            const MatrixEntry<Ring>& entry = row_entries[index];
+            if (num_packed && row_entries[num_packed - 1].column ==
+                                  entry.column) {
+              if (combination == kSumDuplicates) {
+                row_entries[num_packed - 1].value += entry.value;
+              } else if (combination == kKeepLastDuplicate) {
+                row_entries[num_packed - 1].value = entry.value;
+              }
+            } else {
+              row_entries[num_packed++] = entry;
+            }
+          }
+          row_sizes[row] = num_packed;
+        }
+      });
+
+  // Pack the combined rows.
+  Buffer<Int>& row_entry_offsets = result->row_entry_offsets_;
+  quotient::OffsetScan(row_sizes, &row_entry_offsets);
+  const Int num_entries = row_entry_offsets[num_rows];
+  result->entries_.Resize(num_entries);
+  result->column_indices_.Resize(num_entries);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          const MatrixEntry<Ring>* row_entries =
+              bucketed_entries.Data() + row_offsets[row];
+          const Int offset = row_entry_offsets[row];
+          for (Int index = 0; index < row_sizes[row]; ++index) {
+            result->entries_[offset + index] = row_entries[index];
+            result->column_indices_[offset + index] =
+                row_entries[index].column;
+          }
+        }
+      });
+
+  return result;
+}
+
 template <class Ring>
 CoordinateMatrix<Ring>::~CoordinateMatrix() {}
 
@@ -226,6 +703,7 @@ template <class Ring>
 void CoordinateMatrix<Ring>::Empty() {
   entries_.Clear();
   row_entry_offsets_.Clear();
+  column_indices_.Clear();
   SwapClearVector(&entries_to_add_);
   SwapClearVector(&entries_to_remove_);
 
@@ -246,6 +724,7 @@ void CoordinateMatrix<Ring>::Resize(Int num_rows, Int num_columns) {
   num_columns_ = num_columns;
 
   entries_.Clear();
+  column_indices_.Clear();
   entries_to_add_.clear();
   entries_to_remove_.clear();
 
@@ -295,7 +774,7 @@ void CoordinateMatrix<Ring>::QueueEntryAdditions(
 template <class Ring>
 void CoordinateMatrix<Ring>::FlushEntryAdditionQueue(
     bool update_row_entry_offsets) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("FlushEntryAdditionQueue");
+  TraceScope trace_scope("FlushEntryAdditionQueue");
   if (!entries_to_add_.empty()) {
     // Sort and combine the list of entries to add.
     std::sort(entries_to_add_.begin(), entries_to_add_.end());
@@ -456,6 +935,88 @@ void CoordinateMatrix<Ring>::AddToEntry(const MatrixEntry<Ring>& entry) {
   AddToEntry(entry.row, entry.column, entry.value);
 }
 
+template <class Ring>
+EntryValuesView<Ring> CoordinateMatrix<Ring>::ValuesView() CATAMARI_NOEXCEPT {
+  return EntryValuesView<Ring>(entries_.Data(), entries_.Size());
+}
+
+template <class Ring>
+ValueAssemblyPlan CoordinateMatrix<Ring>::FormValueAssemblyPlan(
+    const Buffer<Int>& rows, const Buffer<Int>& columns) const {
+  const Int num_contributions = rows.Size();
+  const Int num_entries = entries_.Size();
+  CATAMARI_ASSERT(columns.Size() == num_contributions,
+                  "Mismatched number of row and column indices.");
+
+  // Find the entry of each contribution.
+  Buffer<Int> entry_indices(num_contributions);
+  std::atomic<bool> missing_entry(false);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_contributions),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int index = range.begin(); index < range.end(); ++index) {
+          const Int row = rows[index];
+          const Int column = columns[index];
+          CATAMARI_ASSERT(row >= 0 && row < num_rows_, "Row out of bounds.");
+          const Int entry_index = EntryOffset(row, column);
+          if (entry_index == RowEntryOffset(row + 1) ||
+              column_indices_[entry_index] != column) {
+            missing_entry = true;
+            return;
+          }
+          entry_indices[index] = entry_index;
+        }
+      });
+  if (missing_entry) {
+    throw std::invalid_argument("Entry does not exist.");
+  }
+
+  // Invert the map with a (stable) counting sort.
+  ValueAssemblyPlan plan;
+  plan.num_contributions = num_contributions;
+  Buffer<Int> entry_counts(num_entries, 0);
+  for (Int index = 0; index < num_contributions; ++index) {
+    ++entry_counts[entry_indices[index]];
+  }
+  quotient::OffsetScan(entry_counts, &plan.contribution_offsets);
+
+  plan.contributions.Resize(num_contributions);
+  std::copy(plan.contribution_offsets.begin(),
+            plan.contribution_offsets.end() - 1, entry_counts.begin());
+  for (Int index = 0; index < num_contributions; ++index) {
+    plan.contributions[entry_counts[entry_indices[index]]++] = index;
+  }
+
+  return plan;
+}
+
+template <class Ring>
+void CoordinateMatrix<Ring>::AssembleValues(const ValueAssemblyPlan& plan,
+                                            const Buffer<Ring>& contributions) {
+  const Int num_entries = entries_.Size();
+  CATAMARI_ASSERT(plan.contribution_offsets.Size() == num_entries + 1,
+                  "The assembly plan does not match the sparsity pattern.");
+  CATAMARI_ASSERT(contributions.Size() == plan.num_contributions,
+                  "Mismatched number of contributions.");
+
+  // Each entry is summed independently (and in a fixed order), so the result
+  // is deterministic regardless of the number of threads.
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_entries),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int index = range.begin(); index < range.end(); ++index) {
+          const Int contribution_beg = plan.contribution_offsets[index];
+          const Int contribution_end = plan.contribution_offsets[index + 1];
+          Ring value{0};
+          for (Int offset = contribution_beg; offset < contribution_end;
+               ++offset) {
+            value += contributions[plan.contributions[offset]];
+          }
+          entries_[index].value = value;
+        }
+      });
+}
+
 template <class Ring>
 const MatrixEntry<Ring>& CoordinateMatrix<Ring>::Entry(Int entry_index) const
     CATAMARI_NOEXCEPT {
@@ -484,6 +1045,12 @@ const Buffer<Int>& CoordinateMatrix<Ring>::RowEntryOffsets() const
   return row_entry_offsets_;
 }
 
+template <class Ring>
+const Buffer<Int>& CoordinateMatrix<Ring>::ColumnIndices() const
+    CATAMARI_NOEXCEPT {
+  return column_indices_;
+}
+
 template <class Ring>
 Int CoordinateMatrix<Ring>::RowEntryOffset(Int row) const CATAMARI_NOEXCEPT {
   CATAMARI_ASSERT(
@@ -497,11 +1064,10 @@ Int CoordinateMatrix<Ring>::EntryOffset(Int row,
                                         Int column) const CATAMARI_NOEXCEPT {
   const Int row_entry_offset = RowEntryOffset(row);
   const Int next_row_entry_offset = RowEntryOffset(row + 1);
-  const MatrixEntry<Ring> target_entry{row, column, Ring{0}};
-  auto iter =
-      std::lower_bound(entries_.begin() + row_entry_offset,
-                       entries_.begin() + next_row_entry_offset, target_entry);
-  return iter - entries_.begin();
+  auto iter = std::lower_bound(column_indices_.begin() + row_entry_offset,
+                               column_indices_.begin() + next_row_entry_offset,
+                               column);
+  return iter - column_indices_.begin();
 }
 
 template <class Ring>
@@ -545,8 +1111,11 @@ CoordinateMatrix<Ring>::CoordinateGraph() const CATAMARI_NOEXCEPT {
       new quotient::CoordinateGraph);
   graph->AsymmetricResize(NumRows(), NumColumns());
   graph->ReserveEdgeAdditions(NumEntries());
-  for (const MatrixEntry<Ring>& entry : Entries()) {
-    graph->QueueEdgeAddition(entry.row, entry.column);
+  for (Int row = 0; row < num_rows_; ++row) {
+    for (Int index = row_entry_offsets_[row];
+         index < row_entry_offsets_[row + 1]; ++index) {
+      graph->QueueEdgeAddition(row, column_indices_[index]);
+    }
   }
   graph->FlushEdgeQueues();
   return graph;
@@ -556,11 +1125,13 @@ template <class Ring>
 void CoordinateMatrix<Ring>::UpdateRowEntryOffsets() {
   const Int num_entries = entries_.Size();
   row_entry_offsets_.Resize(num_rows_ + 1);
+  column_indices_.Resize(num_entries);
   Int row_entry_offset = 0;
   Int prev_row = -1;
   for (Int entry_index = 0; entry_index < num_entries; ++entry_index) {
     const Int row = entries_[entry_index].row;
     CATAMARI_ASSERT(row >= prev_row, "Rows were not properly sorted.");
+    column_indices_[entry_index] = entries_[entry_index].column;
 
     // Fill in the row offsets from prev_row to row - 1.
     for (; prev_row < row; ++prev_row) {
@@ -8,6 +8,8 @@
 #ifndef CATAMARI_COORDINATE_MATRIX_H_
 #define CATAMARI_COORDINATE_MATRIX_H_
 
+#include <cstdint>
+
 #include "catamari/buffer.hpp"
 #include "catamari/integers.hpp"
 #include "catamari/macros.hpp"
@@ -20,6 +22,99 @@ using quotient::GraphEdge;
 using quotient::MatrixEntry;
 using quotient::SwapClearVector;
 
+// The version of the binary CoordinateMatrix format. It must be incremented
+// whenever the layout of the header or of the arrays changes.
+static constexpr std::uint32_t kCoordinateMatrixBinaryVersion = 1;
+
+// The alignment, in bytes, of each array of a binary CoordinateMatrix file.
+static constexpr std::uint64_t kCoordinateMatrixBinaryAlignment = 64;
+
+// The fixed-size header at the beginning of a binary CoordinateMatrix file.
+// It is followed by three raw, aligned arrays in native byte order: the
+// 'num_rows + 1' row offsets, the 'num_entries' column indices and the
+// 'num_entries' values.
+struct CoordinateMatrixBinaryHeader {
+  // Always "CATAMTRX".
+  char magic[8];
+
+  // The format version (see 'kCoordinateMatrixBinaryVersion').
+  std::uint32_t version;
+
+  // The value 0x01020304 as written in the native byte order.
+  std::uint32_t byte_order;
+
+  // The sizes of 'Int' and of the scalar type, and whether the latter is
+  // complex.
+  std::uint32_t int_size;
+  std::uint32_t field_size;
+  std::uint32_t is_complex;
+  std::uint32_t padding;
+
+  // The dimensions and number of entries of the matrix.
+  std::int64_t num_rows;
+  std::int64_t num_columns;
+  std::int64_t num_entries;
+
+  // The offsets, in bytes, of the arrays from the beginning of the file.
+  std::uint64_t row_offsets_offset;
+  std::uint64_t columns_offset;
+  std::uint64_t values_offset;
+};
+
+// The means of combining the values of triplets with the same indices in
+// 'CoordinateMatrix::FromTriplets'.
+enum DuplicateCombination {
+  // The values are summed (in the order of the triplets).
+  kSumDuplicates,
+
+  // The value of the first such triplet is kept.
+  kKeepFirstDuplicate,
+
+  // The value of the last such triplet is kept.
+  kKeepLastDuplicate,
+};
+
+// A view of the values of a list of entries, in the same order, so that the
+// values may be updated in place without touching the sparsity pattern.
+template <class Ring>
+class EntryValuesView {
+ public:
+  EntryValuesView(MatrixEntry<Ring>* entries, Int size)
+      : entries_(entries), size_(size) {}
+
+  // Returns the number of values.
+  Int Size() const CATAMARI_NOEXCEPT { return size_; }
+
+  // Returns a reference to the value of the entry with the given index.
+  Ring& operator[](Int index) const CATAMARI_NOEXCEPT {
+    return entries_[index].value;
+  }
+
+ private:
+  // The underlying entries.
+  MatrixEntry<Ring>* entries_;
+
+  // The number of entries.
+  Int size_;
+};
+
+// A precomputed map from a fixed list of (row, column) contributions -- e.g.,
+// the concatenated element matrices of a finite-element assembly -- onto the
+// entries of a CoordinateMatrix with a fixed sparsity pattern. The map is
+// stored by entry so that each value can be assembled independently.
+struct ValueAssemblyPlan {
+  // The number of contributions.
+  Int num_contributions = 0;
+
+  // A list of length 'num_entries + 1', where the contributions to entry
+  // 'index' are listed in 'contributions[contribution_offsets[index]]' through
+  // 'contributions[contribution_offsets[index + 1] - 1]', in increasing order.
+  Buffer<Int> contribution_offsets;
+
+  // The concatenated lists of contribution indices of each entry.
+  Buffer<Int> contributions;
+};
+
 // A coordinate-format sparse matrix data structure. The primary storage is a
 // lexicographically sorted Buffer<MatrixEntry<Ring>> and an associated
 // Buffer<Int> of row offsets (which serve the same role as in a Compressed
@@ -85,9 +180,37 @@ class CoordinateMatrix {
       const std::string& filename, bool skip_explicit_zeros,
       EntryMask mask = EntryMask::kEntryMaskFull);
 
+  // Builds and returns a CoordinateMatrix from a Matrix Market description by
+  // memory-mapping the file and parsing its entries in parallel. The result
+  // is identical to that of 'FromMatrixMarket', which array-format files fall
+  // back to.
+  static std::unique_ptr<CoordinateMatrix<Ring>> FromMappedMatrixMarket(
+      const std::string& filename, bool skip_explicit_zeros,
+      EntryMask mask = EntryMask::kEntryMaskFull);
+
   // Writes a copy of the CoordinateMatrix to a Matrix Market file.
   void ToMatrixMarket(const std::string& filename) const;
 
+  // Builds and returns a CoordinateMatrix from lists of (row, column, value)
+  // triplets, in any order, without the entry queues. The triplets are
+  // bucketed by row with a stable, parallel two-pass counting sort, and each
+  // row is then sorted and has its duplicates combined independently, so the
+  // work is linear in the number of triplets for rows of bounded length.
+  static std::unique_ptr<CoordinateMatrix<Ring>> FromTriplets(
+      Int num_rows, Int num_columns, const Buffer<Int>& rows,
+      const Buffer<Int>& columns, const Buffer<Ring>& values,
+      DuplicateCombination combination = kSumDuplicates);
+
+  // Builds and returns a CoordinateMatrix from a file written by 'ToBinary'.
+  // The file is memory-mapped and its arrays are expanded in parallel, without
+  // any parsing, sorting or combination of entries.
+  static std::unique_ptr<CoordinateMatrix<Ring>> FromBinary(
+      const std::string& filename);
+
+  // Writes a copy of the (flushed) CoordinateMatrix to a binary file which is
+  // only readable on platforms with the same byte order and scalar sizes.
+  void ToBinary(const std::string& filename) const;
+
   // A trivial destructor.
   ~CoordinateMatrix();
 
@@ -183,6 +306,23 @@ class CoordinateMatrix {
   void AddToEntry(Int row, Int column, const Ring& value);
   void AddToEntry(const MatrixEntry<Ring>& entry);
 
+  // Returns a view of the values of the entries, in sorted-entry order, which
+  // may be modified in place (and in parallel) without any searches.
+  EntryValuesView<Ring> ValuesView() CATAMARI_NOEXCEPT;
+
+  // Returns the plan for assembling the values of the matrix from the
+  // contributions with the given indices, each of which must lie within the
+  // current (flushed) sparsity pattern.
+  ValueAssemblyPlan FormValueAssemblyPlan(const Buffer<Int>& rows,
+                                          const Buffer<Int>& columns) const;
+
+  // Overwrites the values of the matrix with the sums of their contributions
+  // under the given plan; entries without contributions are set to zero. The
+  // sparsity pattern is unchanged, so the result may be passed directly to
+  // 'SparseLDL::RefactorWithFixedSparsityPattern'.
+  void AssembleValues(const ValueAssemblyPlan& plan,
+                      const Buffer<Ring>& contributions);
+
   // Returns a reference to the entry with the given index.
   const MatrixEntry<Ring>& Entry(Int entry_index) const CATAMARI_NOEXCEPT;
 
@@ -201,6 +341,12 @@ class CoordinateMatrix {
   // NOTE: Not recommended for typical usage.
   const Buffer<Int>& RowEntryOffsets() const CATAMARI_NOEXCEPT;
 
+  // Returns the column indices of the entries, in the same order as
+  // 'Entries()', so that traversals of the sparsity pattern need not stream
+  // the row indices and values. Together with 'RowEntryOffsets()', this is
+  // the index structure of a Compressed Sparse Row (CSR) format.
+  const Buffer<Int>& ColumnIndices() const CATAMARI_NOEXCEPT;
+
   // Returns the offset into the entry vector where entries from the given row
   // begin.
   Int RowEntryOffset(Int row) const CATAMARI_NOEXCEPT;
@@ -240,6 +386,10 @@ class CoordinateMatrix {
   // be inserted (ignoring any sorting based upon the value).
   Buffer<Int> row_entry_offsets_;
 
+  // A list of length 'entries_.Size()', where 'column_indices_[index]' is
+  // equal to 'entries_[index].column'.
+  Buffer<Int> column_indices_;
+
   // The list of entries currently queued for addition into the sparse matrix.
   std::vector<MatrixEntry<Ring>> entries_to_add_;
 
@@ -254,7 +404,8 @@ class CoordinateMatrix {
   // (and then clears 'entries_to_remove_').
   void FlushEntryRemovalQueue(bool update_row_entry_offsets);
 
-  // Recomputes 'row_entry_offsets_' based upon the current value of 'entries_'.
+  // Recomputes 'row_entry_offsets_' and 'column_indices_' based upon the
+  // current value of 'entries_'.
   void UpdateRowEntryOffsets();
 
   // Packs a sorted list of entries by summing the floating-point values of
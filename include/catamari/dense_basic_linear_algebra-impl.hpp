@@ -8,7 +8,15 @@
 #ifndef CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_IMPL_H_
 #define CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_IMPL_H_
 
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "catamari/blas.hpp"
 #include "catamari/macros.hpp"
 
@@ -669,9 +677,13 @@ void MatrixMultiplyNormalNormalDynamicBLASDispatch(const Field& alpha,
                                 const Field& beta,
                                 BlasMatrixView<Field>* output_matrix) {
 #ifdef CATAMARI_HAVE_BLAS
-    if (left_matrix.height > 15) // only use BLAS call for large enough matrices
+    // Only use BLAS for large enough matrices.
+    if (left_matrix.height > GetSmallKernelThresholds().matrix_multiply_height)
         return MatrixMultiplyNormalNormal(alpha, left_matrix, right_matrix, beta, output_matrix);
 #endif
+    if (left_matrix.width <= kMaxSmallKernelSize)
+        return SmallMatrixMultiplyNormalNormal(alpha, left_matrix, right_matrix, beta, output_matrix);
+
     CATAMARI_ASSERT( left_matrix.height == output_matrix->height, "Output height was incompatible");
     CATAMARI_ASSERT(right_matrix. width == output_matrix->width,  "Output width was incompatible");
     CATAMARI_ASSERT( left_matrix. width ==  right_matrix.height,  "Contraction dimensions were incompatible.");
@@ -707,6 +719,7 @@ void MatrixMultiplyNormalNormalDynamicBLASDispatch(const Field& alpha,
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyNormalNormal(const Field& alpha,
                                 const ConstBlasMatrixView<Field>& left_matrix,
                                 const ConstBlasMatrixView<Field>& right_matrix,
@@ -724,7 +737,7 @@ void MatrixMultiplyNormalNormal(const Field& alpha,
   for (Int j = 0; j < output_width; ++j) {
     for (Int i = 0; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(i, k) * right_matrix(k, j);
       }
@@ -856,6 +869,7 @@ inline void MatrixMultiplyNormalNormal(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyNormalTranspose(
     const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
     const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
@@ -872,7 +886,7 @@ void MatrixMultiplyNormalTranspose(
   for (Int j = 0; j < output_width; ++j) {
     for (Int i = 0; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(i, k) * right_matrix(j, k);
       }
@@ -998,6 +1012,7 @@ inline void MatrixMultiplyNormalTranspose(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyNormalAdjoint(const Field& alpha,
                                  const ConstBlasMatrixView<Field>& left_matrix,
                                  const ConstBlasMatrixView<Field>& right_matrix,
@@ -1015,7 +1030,7 @@ void MatrixMultiplyNormalAdjoint(const Field& alpha,
   for (Int j = 0; j < output_width; ++j) {
     for (Int i = 0; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry +=
             alpha * left_matrix(i, k) * Conjugate(right_matrix(j, k));
@@ -1108,6 +1123,7 @@ inline void MatrixMultiplyNormalAdjoint(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyTransposeNormal(
     const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
     const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
@@ -1118,7 +1134,7 @@ void MatrixMultiplyTransposeNormal(
   for (Int j = 0; j < output_width; ++j) {
     for (Int i = 0; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(k, i) * right_matrix(k, j);
       }
@@ -1220,6 +1236,7 @@ inline void MatrixMultiplyTransposeNormal(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyAdjointNormal(const Field& alpha,
                                  const ConstBlasMatrixView<Field>& left_matrix,
                                  const ConstBlasMatrixView<Field>& right_matrix,
@@ -1231,7 +1248,7 @@ void MatrixMultiplyAdjointNormal(const Field& alpha,
   for (Int j = 0; j < output_width; ++j) {
     for (Int i = 0; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry +=
             alpha * Conjugate(left_matrix(k, i)) * right_matrix(k, j);
@@ -1371,18 +1388,18 @@ void LowerNormalHermitianOuterProductDynamicBLASDispatch(
 #ifdef CATAMARI_HAVE_BLAS
     // Only use BLAS for large enough jobs.
     // Rather than basing the treshold on a flop estimate (h^2 c) it seems better to base it
-    // separately on `output_height` and `contraction_size`; the naive implementation below
-    // performs well if the output matrix fits in cache or if only a rank 1 matrix is added.
+    // separately on `output_height` and `contraction_size`; the small kernels below
+    // perform well if the output matrix fits in cache or if only a rank 1 matrix is added.
     //
-#ifdef DARWIN
-    const bool use_blas = (output_height > 128 && contraction_size > 1);
-#else
-    const bool use_blas = (output_height > 64 && contraction_size > 1);
-#endif
+    const bool use_blas =
+        (output_height > GetSmallKernelThresholds().hermitian_outer_product_height &&
+         contraction_size > 1);
     if (use_blas) {
         return LowerNormalHermitianOuterProduct(alpha, left_matrix, beta, output_matrix);
     }
 #endif
+    if (contraction_size <= kMaxSmallKernelSize)
+        return SmallLowerNormalHermitianOuterProduct(alpha, left_matrix, beta, output_matrix);
 
   using EVec = Eigen::Matrix<Field, Eigen::Dynamic, 1>;
   int k_start = 0;
@@ -1420,6 +1437,43 @@ void LowerNormalHermitianOuterProductDynamicBLASDispatch(
 }
 
 template <class Field>
+void PackedLowerNormalHermitianOuterProduct(
+    const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta,
+    PackedLowerMatrixView<Field>* output_matrix) {
+  CATAMARI_ASSERT(left_matrix.height == output_matrix->size,
+                  "Output size was incompatible");
+  const Int size = output_matrix->size;
+  const Int contraction_size = left_matrix.width;
+  const Int num_panels = output_matrix->NumPanels();
+  for (Int panel = 0; panel < num_panels; ++panel) {
+    BlasMatrixView<Field> panel_view = output_matrix->Panel(panel);
+    const Int panel_beg = output_matrix->PanelBeg(panel);
+    const Int panel_width = panel_view.width;
+    const ConstBlasMatrixView<Field> panel_rows =
+        left_matrix.Submatrix(panel_beg, 0, panel_width, contraction_size);
+
+    BlasMatrixView<Field> diagonal_update =
+        panel_view.Submatrix(0, 0, panel_width, panel_width);
+    LowerNormalHermitianOuterProductDynamicBLASDispatch(
+        alpha, panel_rows, beta, &diagonal_update);
+
+    const Int trailing_beg = panel_beg + panel_width;
+    if (trailing_beg < size) {
+      BlasMatrixView<Field> subdiagonal_update = panel_view.Submatrix(
+          panel_width, 0, size - trailing_beg, panel_width);
+      MatrixMultiplyNormalAdjoint(
+          Field{alpha},
+          left_matrix.Submatrix(trailing_beg, 0, size - trailing_beg,
+                                contraction_size),
+          panel_rows, Field{beta}, &subdiagonal_update);
+    }
+  }
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
 void LowerNormalHermitianOuterProduct(
     const ComplexBase<Field>& alpha,
     const ConstBlasMatrixView<Field>& left_matrix,
@@ -1428,12 +1482,9 @@ void LowerNormalHermitianOuterProduct(
   const Int contraction_size = left_matrix.width;
 
   int k_start = 0;
-  if (beta != Field(1)) {
-      for (Int j = 0; j < output_height; ++j)
-        for (Int i = j; i < output_height; ++i)
-            output_matrix->Entry(i, j) *= beta;
-  }
-  else if (beta == Field(0)) {
+  // A zero beta must be checked before the general scaling so that the
+  // (possibly uninitialized) output is overwritten rather than scaled.
+  if (beta == Field(0)) {
       Int k = 0;
       const Field *col_k = left_matrix.Pointer(0, k);
       for (Int j = 0; j < output_height; ++j) {
@@ -1445,6 +1496,11 @@ void LowerNormalHermitianOuterProduct(
       }
       k_start = 1;
   }
+  else if (beta != Field(1)) {
+      for (Int j = 0; j < output_height; ++j)
+        for (Int i = j; i < output_height; ++i)
+            output_matrix->Entry(i, j) *= beta;
+  }
   for (Int k = k_start; k < contraction_size; ++k) {
       const Field *col_k = left_matrix.Pointer(0, k);
       for (Int j = 0; j < output_height; ++j) {
@@ -1526,6 +1582,7 @@ inline void LowerNormalHermitianOuterProduct(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyLowerNormalNormal(
     const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
     const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
@@ -1535,7 +1592,7 @@ void MatrixMultiplyLowerNormalNormal(
   for (Int j = 0; j < output_height; ++j) {
     for (Int i = j; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(i, k) * right_matrix(k, j);
       }
@@ -1700,6 +1757,7 @@ inline void MatrixMultiplyLowerNormalNormal(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyLowerNormalTranspose(
     const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
     const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
@@ -1709,7 +1767,7 @@ void MatrixMultiplyLowerNormalTranspose(
   for (Int j = 0; j < output_height; ++j) {
     for (Int i = j; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(i, k) * right_matrix(j, k);
       }
@@ -1874,6 +1932,7 @@ inline void MatrixMultiplyLowerNormalTranspose(
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MatrixMultiplyLowerTransposeNormal(
     const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
     const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
@@ -1883,7 +1942,7 @@ void MatrixMultiplyLowerTransposeNormal(
   for (Int j = 0; j < output_height; ++j) {
     for (Int i = j; i < output_height; ++i) {
       Field& output_entry = output_matrix->Entry(i, j);
-      output_entry *= beta;
+      output_entry = (beta == Field{0}) ? Field{0} : output_entry * beta;
       for (Int k = 0; k < contraction_size; ++k) {
         output_entry += alpha * left_matrix(k, i) * right_matrix(k, j);
       }
@@ -2056,9 +2115,12 @@ void LeftLowerTriangularSolvesDynamicBLASDispatch(
                   "Incompatible matrix dimensions");
 
 #ifdef CATAMARI_HAVE_BLAS
-    if (triangular_matrix.height > 5) // only use BLAS call for large enough matrices
+    // Only use BLAS for large enough matrices.
+    if (triangular_matrix.height > GetSmallKernelThresholds().triangular_solve_size)
         return LeftLowerTriangularSolves(triangular_matrix, matrix);
 #endif
+    if (triangular_matrix.height <= kMaxSmallKernelSize)
+        return SmallLeftLowerTriangularSolves(triangular_matrix, matrix);
 
   const Int width = matrix->width;
   for (Int j = 0; j < width; ++j) {
@@ -2320,9 +2382,12 @@ void LeftLowerAdjointTriangularSolvesDynamicBLASDispatch(
                     triangular_matrix.height == matrix->height,
                     "Incompatible matrix dimensions");
 #ifdef CATAMARI_HAVE_BLAS
-    if (triangular_matrix.height > 5) // only use BLAS call for large enough matrices
+    // Only use BLAS for large enough matrices.
+    if (triangular_matrix.height > GetSmallKernelThresholds().triangular_solve_size)
         return LeftLowerAdjointTriangularSolves(triangular_matrix, matrix);
 #endif
+    if (triangular_matrix.height <= kMaxSmallKernelSize)
+        return SmallLeftLowerAdjointTriangularSolves(triangular_matrix, matrix);
 
     const Int width = matrix->width;
     for (Int j = 0; j < width; ++j) {
@@ -3253,41 +3318,215 @@ inline void RightUpperTriangularSolves(
 }
 #endif  // ifdef CATAMARI_HAVE_BLAS
 
-// In-place permutation
-// Perm can be, e.g., Buffer<Int>, ConstBlasMatrixView<Int>
-template <class Perm, class Field>
-void Permute(const Perm &permutation, BlasMatrixView<Field>* matrix) {
-  Buffer<Field> column_copy(matrix->height);
-  for (Int j = 0; j < matrix->width; ++j) {
-    // Make a copy of the current column.
-    for (Int i = 0; i < matrix->height; ++i) {
-      column_copy[i] = matrix->Entry(i, j);
+namespace dense_permutation {
+
+// The number of columns moved together for each load of a permutation index.
+static constexpr Int kColumnBlockSize = 8;
+
+// How many rows ahead of the current one the permuted rows are prefetched.
+static constexpr Int kPrefetchDistance = 16;
+
+// The number of rows of each task of a parallel permutation.
+static constexpr Int kRowGrainSize = 2048;
+
+// Matrices with fewer entries are permuted serially.
+static constexpr Int kMinParallelSize = Int(1) << 16;
+
+// Returns true if a matrix of the given dimensions should be permuted with
+// concurrent tasks.
+inline bool PermuteInParallel(Int height, Int width) {
+  return height * width >= kMinParallelSize &&
+         tbb::this_task_arena::max_concurrency() > 1;
+}
+
+// Calls 'function(row_beg, row_end)' over a partition of the rows, in
+// parallel if the matrix is large enough.
+template <class Function>
+void ForEachRowBlock(Int height, Int width, const Function& function) {
+  if (PermuteInParallel(height, width)) {
+    tbb::parallel_for(tbb::blocked_range<Int>(0, height, kRowGrainSize),
+                      [&](const tbb::blocked_range<Int>& range) {
+                        function(range.begin(), range.end());
+                      });
+  } else {
+    function(0, height);
+  }
+}
+
+// Calls 'function(column_beg, column_end)' over the blocks of columns, in
+// parallel if the matrix is large enough.
+template <class Function>
+void ForEachColumnBlock(Int height, Int width, const Function& function) {
+  const Int num_blocks = (width + kColumnBlockSize - 1) / kColumnBlockSize;
+  auto block_function = [&](Int block) {
+    const Int column_beg = block * kColumnBlockSize;
+    function(column_beg, std::min(width, column_beg + kColumnBlockSize));
+  };
+  if (num_blocks > 1 && PermuteInParallel(height, width)) {
+    tbb::parallel_for(Int(0), num_blocks, block_function);
+  } else {
+    for (Int block = 0; block < num_blocks; ++block) {
+      block_function(block);
     }
+  }
+}
 
-    // Apply the permutation.
-    for (Int i = 0; i < matrix->height; ++i) {
-      matrix->Entry(permutation[i], j) = column_copy[i];
+// Fills 'cycle_starts' with the smallest index of each nontrivial cycle of
+// the permutation.
+template <class Perm>
+void PermutationCycleStarts(const Perm& permutation, Int size,
+                            std::vector<Int>* cycle_starts) {
+  cycle_starts->clear();
+  Buffer<unsigned char> visited(size, 0);
+  for (Int start = 0; start < size; ++start) {
+    if (visited[start]) continue;
+    visited[start] = 1;
+    if (permutation[start] == start) continue;
+    cycle_starts->push_back(start);
+    for (Int i = permutation[start]; i != start; i = permutation[i]) {
+      visited[i] = 1;
     }
   }
 }
 
+// Sets row 'permutation[i]' of the matrix to its original row 'i' by
+// following the cycles of the permutation, one block of columns at a time,
+// so that no copy of the matrix is needed.
+template <class Perm, class Field>
+void PermuteInPlace(const Perm& permutation, BlasMatrixView<Field>* matrix) {
+  std::vector<Int> cycle_starts;
+  PermutationCycleStarts(permutation, matrix->height, &cycle_starts);
+  ForEachColumnBlock(
+      matrix->height, matrix->width, [&](Int column_beg, Int column_end) {
+        const Int num_columns = column_end - column_beg;
+        Field carry[kColumnBlockSize];
+        for (const Int& start : cycle_starts) {
+          for (Int j = 0; j < num_columns; ++j) {
+            carry[j] = matrix->Entry(start, column_beg + j);
+          }
+          Int i = start;
+          do {
+            const Int target = permutation[i];
+            CATAMARI_PREFETCH(matrix->Pointer(permutation[target], column_beg));
+            for (Int j = 0; j < num_columns; ++j) {
+              std::swap(carry[j], matrix->Entry(target, column_beg + j));
+            }
+            i = target;
+          } while (i != start);
+        }
+      });
+}
+
+// Sets row 'i' of the matrix to its original row 'permutation[i]' by
+// following the cycles of the permutation, one block of columns at a time.
+template <class Perm, class Field>
+void InversePermuteInPlace(const Perm& permutation,
+                           BlasMatrixView<Field>* matrix) {
+  std::vector<Int> cycle_starts;
+  PermutationCycleStarts(permutation, matrix->height, &cycle_starts);
+  ForEachColumnBlock(
+      matrix->height, matrix->width, [&](Int column_beg, Int column_end) {
+        const Int num_columns = column_end - column_beg;
+        Field carry[kColumnBlockSize];
+        for (const Int& start : cycle_starts) {
+          for (Int j = 0; j < num_columns; ++j) {
+            carry[j] = matrix->Entry(start, column_beg + j);
+          }
+          Int i = start;
+          for (Int source = permutation[i]; source != start;
+               source = permutation[i]) {
+            CATAMARI_PREFETCH(matrix->Pointer(permutation[source], column_beg));
+            for (Int j = 0; j < num_columns; ++j) {
+              matrix->Entry(i, column_beg + j) =
+                  matrix->Entry(source, column_beg + j);
+            }
+            i = source;
+          }
+          for (Int j = 0; j < num_columns; ++j) {
+            matrix->Entry(i, column_beg + j) = carry[j];
+          }
+        }
+      });
+}
+
+}  // namespace dense_permutation
+
+// In-place permutation
+// Perm can be, e.g., Buffer<Int>, ConstBlasMatrixView<Int>
+template <class Perm, class Field>
+CATAMARI_MULTIVERSIONED
+void Permute(const Perm &permutation, BlasMatrixView<Field>* matrix) {
+  dense_permutation::PermuteInPlace(permutation, matrix);
+}
+
 // Out-of-place permutation
 // Perm can be, e.g., Buffer<Int>, ConstBlasMatrixView<Int>
 template <class Perm, class Field>
+CATAMARI_MULTIVERSIONED
 void Permute(const Perm &permutation, const BlasMatrixView<Field> &in, BlasMatrixView<Field> *out) {
-    if (in.width != out->width || in.height != out->height) throw std::runtime_error("Size mismatch");
-    for (Int j = 0; j < out->width; ++j) {
-        // Apply the permutation.
-        const Field *in_ptr = in.Pointer(0, j);
-        Field *out_ptr = out->Pointer(0, j);
-        //parallel_for_range(out->height, [&](Int i) {
-        for (Int i = 0; i < out->height; ++i)
-            out_ptr[permutation[i]] = in_ptr[i];
-        //});
+  if (in.width != out->width || in.height != out->height) {
+    throw std::runtime_error("Size mismatch");
+  }
+  const Int height = out->height;
+  const Int width = out->width;
+  dense_permutation::ForEachRowBlock(height, width, [&](Int row_beg,
+                                                        Int row_end) {
+    // Scatter each row of a block of columns with a single index load.
+    for (Int column_beg = 0; column_beg < width;
+         column_beg += dense_permutation::kColumnBlockSize) {
+      const Int column_end =
+          std::min(width, column_beg + dense_permutation::kColumnBlockSize);
+      for (Int i = row_beg; i < row_end; ++i) {
+        if (i + dense_permutation::kPrefetchDistance < row_end) {
+          CATAMARI_PREFETCH(out->Pointer(
+              permutation[i + dense_permutation::kPrefetchDistance],
+              column_beg));
+        }
+        const Int target = permutation[i];
+        for (Int j = column_beg; j < column_end; ++j) {
+          out->Entry(target, j) = in(i, j);
+        }
+      }
+    }
+  });
+}
+
+// Out-of-place inverse permutation
+// Perm can be, e.g., Buffer<Int>, ConstBlasMatrixView<Int>
+template <class Perm, class Field>
+CATAMARI_MULTIVERSIONED
+void InversePermute(const Perm& permutation,
+                    const ConstBlasMatrixView<Field>& in,
+                    BlasMatrixView<Field>* out) {
+  if (in.width != out->width || in.height != out->height) {
+    throw std::runtime_error("Size mismatch");
+  }
+  const Int height = out->height;
+  const Int width = out->width;
+  dense_permutation::ForEachRowBlock(height, width, [&](Int row_beg,
+                                                        Int row_end) {
+    // Gather each row of a block of columns with a single index load.
+    for (Int column_beg = 0; column_beg < width;
+         column_beg += dense_permutation::kColumnBlockSize) {
+      const Int column_end =
+          std::min(width, column_beg + dense_permutation::kColumnBlockSize);
+      for (Int i = row_beg; i < row_end; ++i) {
+        if (i + dense_permutation::kPrefetchDistance < row_end) {
+          CATAMARI_PREFETCH(in.Pointer(
+              permutation[i + dense_permutation::kPrefetchDistance],
+              column_beg));
+        }
+        const Int source = permutation[i];
+        for (Int j = column_beg; j < column_end; ++j) {
+          out->Entry(i, j) = in(source, j);
+        }
+      }
     }
+  });
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void PermuteColumns(const Buffer<Int>& permutation,
                     BlasMatrixView<Field>* matrix) {
   Buffer<Field> row_copy(matrix->width);
@@ -3305,6 +3544,7 @@ void PermuteColumns(const Buffer<Int>& permutation,
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void PermuteColumns(const ConstBlasMatrixView<Int>& permutation,
                     BlasMatrixView<Field>* matrix) {
   Buffer<Field> row_copy(matrix->width);
@@ -3322,40 +3562,21 @@ void PermuteColumns(const ConstBlasMatrixView<Int>& permutation,
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void InversePermute(const Buffer<Int>& permutation,
                     BlasMatrixView<Field>* matrix) {
-  Buffer<Field> column_copy(matrix->height);
-  for (Int j = 0; j < matrix->width; ++j) {
-    // Make a copy of the current column.
-    for (Int i = 0; i < matrix->height; ++i) {
-      column_copy[i] = matrix->Entry(i, j);
-    }
-
-    // Apply the inverse permutation.
-    for (Int i = 0; i < matrix->height; ++i) {
-      matrix->Entry(i, j) = column_copy[permutation[i]];
-    }
-  }
+  dense_permutation::InversePermuteInPlace(permutation, matrix);
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void InversePermute(const ConstBlasMatrixView<Int>& permutation,
                     BlasMatrixView<Field>* matrix) {
-  Buffer<Field> column_copy(matrix->height);
-  for (Int j = 0; j < matrix->width; ++j) {
-    // Make a copy of the current column.
-    for (Int i = 0; i < matrix->height; ++i) {
-      column_copy[i] = matrix->Entry(i, j);
-    }
-
-    // Apply the inverse permutation.
-    for (Int i = 0; i < matrix->height; ++i) {
-      matrix->Entry(i, j) = column_copy[permutation(i)];
-    }
-  }
+  dense_permutation::InversePermuteInPlace(permutation, matrix);
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void InversePermuteColumns(const Buffer<Int>& permutation,
                            BlasMatrixView<Field>* matrix) {
   Buffer<Field> row_copy(matrix->width);
@@ -3373,6 +3594,7 @@ void InversePermuteColumns(const Buffer<Int>& permutation,
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void InversePermuteColumns(const ConstBlasMatrixView<Int>& permutation,
                            BlasMatrixView<Field>* matrix) {
   Buffer<Field> row_copy(matrix->width);
@@ -3392,5 +3614,6 @@ void InversePermuteColumns(const ConstBlasMatrixView<Int>& permutation,
 }  // namespace catamari
 
 #include "catamari/dense_basic_linear_algebra/openmp-impl.hpp"
+#include "catamari/dense_basic_linear_algebra/small_kernels-impl.hpp"
 
 #endif  // ifndef CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_IMPL_H_
@@ -12,6 +12,7 @@
 #include "catamari/buffer.hpp"
 #include "catamari/complex.hpp"
 #include "catamari/integers.hpp"
+#include "catamari/packed_lower_matrix_view.hpp"
 
 namespace catamari {
 
@@ -72,6 +73,10 @@ template <class Field>
 void TriangularSolveLeftUpper(
     const ConstBlasMatrixView<Field>& triangular_matrix, Field* vector);
 
+// As in the BLAS, the following updates overwrite 'output_matrix' without
+// reading it when 'beta' is zero, so that it may start out uninitialized
+// (scaling a stale NaN by zero would still yield a NaN).
+
 // Updates
 //
 //   output_matrix := alpha left_matrix right_matrix + beta output_matrix
@@ -135,6 +140,20 @@ void LowerNormalHermitianOuterProduct(
     const ConstBlasMatrixView<Field>& left_matrix,
     const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix);
 
+// Updates the lower triangle of the packed matrix (see
+// 'PackedLowerMatrixView')
+//
+//   output_matrix := alpha left_matrix left_matrix^H + beta output_matrix
+//
+// a panel at a time: the diagonal block of each is updated by a Hermitian
+// outer product and the rows beneath it by a matrix multiplication.
+template <class Field>
+void PackedLowerNormalHermitianOuterProduct(
+    const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta,
+    PackedLowerMatrixView<Field>* output_matrix);
+
 // Updates the lower triangular of
 //
 //   output_matrix := alpha left_matrix right_matrix^T + beta output_matrix.
@@ -264,15 +283,116 @@ void OpenMPLowerNormalHermitianOuterProduct(
     const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix);
 #endif  // ifdef CATAMARI_OPENMP
 
-// Applies a row permutation to a dense matrix.
+// The largest dimension for which the small kernels below are specialized at
+// compile time.
+#ifndef CATAMARI_MAX_SMALL_KERNEL_SIZE
+#define CATAMARI_MAX_SMALL_KERNEL_SIZE 32
+#endif
+constexpr Int kMaxSmallKernelSize = CATAMARI_MAX_SMALL_KERNEL_SIZE;
+
+// The default thresholds of the dynamic BLAS dispatches, which may be
+// overridden at build time.
+#ifndef CATAMARI_SMALL_MATRIX_MULTIPLY_HEIGHT
+#define CATAMARI_SMALL_MATRIX_MULTIPLY_HEIGHT 15
+#endif
+#ifndef CATAMARI_SMALL_HERMITIAN_OUTER_PRODUCT_HEIGHT
+#ifdef DARWIN
+#define CATAMARI_SMALL_HERMITIAN_OUTER_PRODUCT_HEIGHT 128
+#else
+#define CATAMARI_SMALL_HERMITIAN_OUTER_PRODUCT_HEIGHT 64
+#endif  // ifdef DARWIN
+#endif
+#ifndef CATAMARI_SMALL_TRIANGULAR_SOLVE_SIZE
+#define CATAMARI_SMALL_TRIANGULAR_SOLVE_SIZE 5
+#endif
+#ifndef CATAMARI_SMALL_FACTORIZATION_SIZE
+#define CATAMARI_SMALL_FACTORIZATION_SIZE 16
+#endif
+
+// The sizes up to which the '*DynamicBLASDispatch' routines prefer the small,
+// compile-time specialized kernels over BLAS/LAPACK.
+struct SmallKernelThresholds {
+  // The maximum output height of a matrix multiplication (whose contraction
+  // size is at most kMaxSmallKernelSize).
+  Int matrix_multiply_height = CATAMARI_SMALL_MATRIX_MULTIPLY_HEIGHT;
+
+  // The maximum output height of a Hermitian outer product (whose rank is at
+  // most kMaxSmallKernelSize).
+  Int hermitian_outer_product_height =
+      CATAMARI_SMALL_HERMITIAN_OUTER_PRODUCT_HEIGHT;
+
+  // The maximum size of the triangular matrix in a triangular solve.
+  Int triangular_solve_size = CATAMARI_SMALL_TRIANGULAR_SOLVE_SIZE;
+
+  // The maximum size of a diagonal block in an LDL^H factorization.
+  Int factorization_size = CATAMARI_SMALL_FACTORIZATION_SIZE;
+};
+
+// Returns the process-wide thresholds used by the dynamic BLAS dispatches.
+// They may be overwritten, e.g., with the result of
+// CalibrateSmallKernelThresholds, before any factorization begins.
+SmallKernelThresholds& GetSmallKernelThresholds();
+
+// Performs 'output_matrix := alpha left_matrix right_matrix +
+// beta output_matrix' using a kernel specialized on the contraction size,
+// which must be at most kMaxSmallKernelSize.
+template <class Field>
+void SmallMatrixMultiplyNormalNormal(
+    const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
+    const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
+    BlasMatrixView<Field>* output_matrix);
+
+// Performs the lower triangle of 'output_matrix := alpha left_matrix
+// left_matrix' + beta output_matrix' using a kernel specialized on the width
+// of 'left_matrix', which must be at most kMaxSmallKernelSize.
+template <class Field>
+void SmallLowerNormalHermitianOuterProduct(
+    const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix);
+
+// Performs LeftLowerTriangularSolves using a kernel specialized on the size
+// of 'triangular_matrix', which must be at most kMaxSmallKernelSize.
+template <class Field>
+void SmallLeftLowerTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix);
+
+// Performs LeftLowerAdjointTriangularSolves using a kernel specialized on the
+// size of 'triangular_matrix', which must be at most kMaxSmallKernelSize.
+template <class Field>
+void SmallLeftLowerAdjointTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix);
+
+// Performs an unblocked LDL^H factorization using a kernel specialized on the
+// size of 'matrix', which must be at most kMaxSmallKernelSize. The return
+// value is the number of successful pivots.
+template <class Field>
+Int SmallLDLAdjointFactorization(BlasMatrixView<Field>* matrix);
+
+// Applies a row permutation to a dense matrix, moving row 'i' to row
+// 'permutation[i]' by following the cycles of the permutation for a block of
+// columns at a time, with the blocks of large matrices handled by concurrent
+// TBB tasks.
 // Perm can be, e.g., Buffer<Int>, ConstBlasMatrixView<Int>
 template <class Perm, class Field>
 void Permute(const Perm &permutation, BlasMatrixView<Field>* matrix);
 
-// Out-of-place permutation
+// Out-of-place permutation: row 'i' of 'in' is scattered into row
+// 'permutation[i]' of 'out', with the rows of large matrices split amongst
+// concurrent TBB tasks.
 template <class Perm, class Field>
 void Permute(const Perm &permutation, const BlasMatrixView<Field> &in, BlasMatrixView<Field> *out);
 
+// Out-of-place inverse permutation: row 'i' of 'out' is gathered from row
+// 'permutation[i]' of 'in', with the rows of large matrices split amongst
+// concurrent TBB tasks.
+template <class Perm, class Field>
+void InversePermute(const Perm& permutation,
+                    const ConstBlasMatrixView<Field>& in,
+                    BlasMatrixView<Field>* out);
+
 // Applies a column permutation to a dense matrix.
 template <class Field>
 void PermuteColumn(const Buffer<Int>& permutation,
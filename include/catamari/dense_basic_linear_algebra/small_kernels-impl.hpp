@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_SMALL_KERNELS_IMPL_H_
+#define CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_SMALL_KERNELS_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+namespace catamari {
+
+namespace small_kernels {
+
+// Each kernel below fixes the (small) dimension it is templated on at compile
+// time so that the loops over it are fully unrolled and the coefficients it
+// multiplies by are kept in registers, leaving a single unit-stride loop over
+// the dynamic dimension for the compiler to vectorize.
+
+// Overwrites the entries in [begin, end) of 'output' with
+//
+//   beta output[i] + sum_k columns[k][i] coefficients[k],
+//
+// where 'output' is not read when 'beta' is zero.
+template <Int size, class Field>
+void MultiplyAddColumns(Int begin, Int end, const Field* const* columns,
+                        const Field* coefficients, const Field& beta,
+                        Field* output) {
+  // A local copy lets the compiler keep the coefficients in registers, as
+  // they could otherwise alias 'output'.
+  Field local_coefficients[size];
+  for (Int k = 0; k < size; ++k) {
+    local_coefficients[k] = coefficients[k];
+  }
+
+  if (beta == Field{0}) {
+    for (Int i = begin; i < end; ++i) {
+      Field sum{0};
+      for (Int k = 0; k < size; ++k) {
+        sum += columns[k][i] * local_coefficients[k];
+      }
+      output[i] = sum;
+    }
+  } else {
+    for (Int i = begin; i < end; ++i) {
+      Field sum = beta * output[i];
+      for (Int k = 0; k < size; ++k) {
+        sum += columns[k][i] * local_coefficients[k];
+      }
+      output[i] = sum;
+    }
+  }
+}
+
+// The number of consecutive entries of an output column which the complex
+// kernels below accumulate in registers at a time.
+constexpr Int kComplexChunkSize = 8;
+
+// Adds the products of the 'length / 2' consecutive complex entries of each
+// column beginning at (real) index 'offset' with the corresponding
+// coefficient into the interleaved real and imaginary parts 'sums'. Each
+// product is formed with fused multiply-adds of the entries against the
+// broadcast real part of the coefficient and of the pair-swapped entries
+// against its imaginary part (the fmaddsub pattern), rather than with the
+// complex multiplication operator.
+template <Int size, class Real>
+void AccumulateComplexChunk(Int offset, Int length,
+                            const Real* const* real_columns,
+                            const Real* coefficients_real,
+                            const Real* coefficients_imag, Real* sums) {
+  for (Int k = 0; k < size; ++k) {
+    const Real* column = real_columns[k] + offset;
+    const Real coefficient_real = coefficients_real[k];
+    const Real coefficient_imag = coefficients_imag[k];
+    for (Int t = 0; t < length; t += 2) {
+      sums[t] += column[t] * coefficient_real;
+      sums[t + 1] += column[t + 1] * coefficient_real;
+      sums[t] -= column[t + 1] * coefficient_imag;
+      sums[t + 1] += column[t] * coefficient_imag;
+    }
+  }
+}
+
+// The single- and double-precision complex analogue of 'MultiplyAddColumns',
+// which views the data as interleaved real and imaginary parts (a layout
+// std::complex guarantees). The output is formed in chunks of
+// 'kComplexChunkSize' entries held in a local buffer so that the vectorizer
+// need not prove that 'output' does not alias the columns.
+template <Int size, class Real>
+void ComplexMultiplyAddColumns(Int begin, Int end,
+                               const Complex<Real>* const* columns,
+                               const Complex<Real>* coefficients,
+                               const Complex<Real>& beta,
+                               Complex<Real>* output) {
+  constexpr Int kChunkLength = 2 * kComplexChunkSize;
+  const Real* real_columns[size];
+  Real coefficients_real[size];
+  Real coefficients_imag[size];
+  for (Int k = 0; k < size; ++k) {
+    real_columns[k] = reinterpret_cast<const Real*>(columns[k]);
+    coefficients_real[k] = RealPart(coefficients[k]);
+    coefficients_imag[k] = ImagPart(coefficients[k]);
+  }
+  Real* real_output = reinterpret_cast<Real*>(output);
+  const Real beta_real = RealPart(beta);
+  const Real beta_imag = ImagPart(beta);
+  const bool scale_output = beta_real != Real{0} || beta_imag != Real{0};
+
+  for (Int i = begin; i < end; i += kComplexChunkSize) {
+    const Int offset = 2 * i;
+    const Int length = std::min(kChunkLength, 2 * (end - i));
+    Real sums[kChunkLength];
+    for (Int t = 0; t < length; t += 2) {
+      if (scale_output) {
+        const Real output_real = real_output[offset + t];
+        const Real output_imag = real_output[offset + t + 1];
+        sums[t] = beta_real * output_real - beta_imag * output_imag;
+        sums[t + 1] = beta_real * output_imag + beta_imag * output_real;
+      } else {
+        sums[t] = sums[t + 1] = Real{0};
+      }
+    }
+    if (length == kChunkLength) {
+      AccumulateComplexChunk<size>(offset, kChunkLength, real_columns,
+                                   coefficients_real, coefficients_imag, sums);
+    } else {
+      AccumulateComplexChunk<size>(offset, length, real_columns,
+                                   coefficients_real, coefficients_imag, sums);
+    }
+    for (Int t = 0; t < length; ++t) {
+      real_output[offset + t] = sums[t];
+    }
+  }
+}
+
+template <Int size>
+void MultiplyAddColumns(Int begin, Int end,
+                        const Complex<float>* const* columns,
+                        const Complex<float>* coefficients,
+                        const Complex<float>& beta, Complex<float>* output) {
+  ComplexMultiplyAddColumns<size>(begin, end, columns, coefficients, beta,
+                                  output);
+}
+
+template <Int size>
+void MultiplyAddColumns(Int begin, Int end,
+                        const Complex<double>* const* columns,
+                        const Complex<double>* coefficients,
+                        const Complex<double>& beta, Complex<double>* output) {
+  ComplexMultiplyAddColumns<size>(begin, end, columns, coefficients, beta,
+                                  output);
+}
+
+template <Int contraction_size, class Field>
+void MatrixMultiplyNormalNormal(const Field& alpha,
+                                const ConstBlasMatrixView<Field>& left_matrix,
+                                const ConstBlasMatrixView<Field>& right_matrix,
+                                const Field& beta,
+                                BlasMatrixView<Field>* output_matrix) {
+  const Int output_height = output_matrix->height;
+  const Int output_width = output_matrix->width;
+  const Field* left_columns[contraction_size];
+  for (Int k = 0; k < contraction_size; ++k) {
+    left_columns[k] = left_matrix.Pointer(0, k);
+  }
+
+  for (Int j = 0; j < output_width; ++j) {
+    Field coefficients[contraction_size];
+    const Field* right_column = right_matrix.Pointer(0, j);
+    for (Int k = 0; k < contraction_size; ++k) {
+      coefficients[k] = alpha * right_column[k];
+    }
+
+    MultiplyAddColumns<contraction_size>(0, output_height, left_columns,
+                                         coefficients, beta,
+                                         output_matrix->Pointer(0, j));
+  }
+}
+
+template <Int contraction_size, class Field>
+void LowerNormalHermitianOuterProduct(
+    const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix) {
+  const Int output_height = output_matrix->height;
+  const Field* left_columns[contraction_size];
+  for (Int k = 0; k < contraction_size; ++k) {
+    left_columns[k] = left_matrix.Pointer(0, k);
+  }
+
+  for (Int j = 0; j < output_height; ++j) {
+    Field coefficients[contraction_size];
+    for (Int k = 0; k < contraction_size; ++k) {
+      coefficients[k] = alpha * Conjugate(left_columns[k][j]);
+    }
+
+    MultiplyAddColumns<contraction_size>(j, output_height, left_columns,
+                                         coefficients, Field(beta),
+                                         output_matrix->Pointer(0, j));
+  }
+}
+
+template <Int size, class Field>
+void LeftLowerTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix) {
+  const Int width = matrix->width;
+  for (Int j = 0; j < width; ++j) {
+    Field* column = matrix->Pointer(0, j);
+    Field x[size];
+    for (Int i = 0; i < size; ++i) {
+      x[i] = column[i];
+    }
+    for (Int i = 0; i < size; ++i) {
+      const Field* l_column = triangular_matrix.Pointer(0, i);
+      x[i] /= l_column[i];
+      for (Int k = i + 1; k < size; ++k) {
+        x[k] -= l_column[k] * x[i];
+      }
+    }
+    for (Int i = 0; i < size; ++i) {
+      column[i] = x[i];
+    }
+  }
+}
+
+template <Int size, class Field>
+void LeftLowerAdjointTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix) {
+  const Int width = matrix->width;
+  for (Int j = 0; j < width; ++j) {
+    Field* column = matrix->Pointer(0, j);
+    Field x[size];
+    for (Int i = 0; i < size; ++i) {
+      x[i] = column[i];
+    }
+    for (Int k = size - 1; k >= 0; --k) {
+      const Field* l_column = triangular_matrix.Pointer(0, k);
+      Field eta = x[k];
+      for (Int i = k + 1; i < size; ++i) {
+        eta -= Conjugate(l_column[i]) * x[i];
+      }
+      x[k] = eta / Conjugate(l_column[k]);
+    }
+    for (Int i = 0; i < size; ++i) {
+      column[i] = x[i];
+    }
+  }
+}
+
+template <Int size, class Field>
+Int LDLAdjointFactorization(BlasMatrixView<Field>* matrix) {
+  typedef ComplexBase<Field> Real;
+  for (Int i = 0; i < size; ++i) {
+    Field* column = matrix->Pointer(0, i);
+    const Real delta = RealPart(column[i]);
+    column[i] = delta;
+    if (delta == Real{0}) {
+      return i;
+    }
+
+    // Solve for the remainder of the i'th column of L while forming the
+    // coefficients of the rank-one update.
+    Field coefficients[size];
+    for (Int k = i + 1; k < size; ++k) {
+      coefficients[k] = Conjugate(column[k]);
+      column[k] /= delta;
+    }
+
+    // Perform the rank-one update.
+    for (Int j = i + 1; j < size; ++j) {
+      Field* update_column = matrix->Pointer(0, j);
+      for (Int k = j; k < size; ++k) {
+        update_column[k] -= column[k] * coefficients[j];
+      }
+    }
+  }
+  return size;
+}
+
+// Dispatches to the kernel instance whose compile-time size matches the
+// runtime size 'size', which must lie in [1, kMaxSmallKernelSize].
+template <class Field, std::size_t... sizes>
+void MatrixMultiplyNormalNormal(Int size, const Field& alpha,
+                                const ConstBlasMatrixView<Field>& left_matrix,
+                                const ConstBlasMatrixView<Field>& right_matrix,
+                                const Field& beta,
+                                BlasMatrixView<Field>* output_matrix,
+                                std::index_sequence<sizes...>) {
+  typedef void (*Kernel)(const Field&, const ConstBlasMatrixView<Field>&,
+                         const ConstBlasMatrixView<Field>&, const Field&,
+                         BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &MatrixMultiplyNormalNormal<Int(sizes) + 1, Field>...};
+  kernels[size - 1](alpha, left_matrix, right_matrix, beta, output_matrix);
+}
+
+template <class Field, std::size_t... sizes>
+void LowerNormalHermitianOuterProduct(
+    Int size, const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix,
+    std::index_sequence<sizes...>) {
+  typedef void (*Kernel)(const ComplexBase<Field>&,
+                         const ConstBlasMatrixView<Field>&,
+                         const ComplexBase<Field>&, BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &LowerNormalHermitianOuterProduct<Int(sizes) + 1, Field>...};
+  kernels[size - 1](alpha, left_matrix, beta, output_matrix);
+}
+
+template <class Field, std::size_t... sizes>
+void LeftLowerTriangularSolves(
+    Int size, const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix, std::index_sequence<sizes...>) {
+  typedef void (*Kernel)(const ConstBlasMatrixView<Field>&,
+                         BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &LeftLowerTriangularSolves<Int(sizes) + 1, Field>...};
+  kernels[size - 1](triangular_matrix, matrix);
+}
+
+template <class Field, std::size_t... sizes>
+void LeftLowerAdjointTriangularSolves(
+    Int size, const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix, std::index_sequence<sizes...>) {
+  typedef void (*Kernel)(const ConstBlasMatrixView<Field>&,
+                         BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &LeftLowerAdjointTriangularSolves<Int(sizes) + 1, Field>...};
+  kernels[size - 1](triangular_matrix, matrix);
+}
+
+template <class Field, std::size_t... sizes>
+Int LDLAdjointFactorization(Int size, BlasMatrixView<Field>* matrix,
+                            std::index_sequence<sizes...>) {
+  typedef Int (*Kernel)(BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &LDLAdjointFactorization<Int(sizes) + 1, Field>...};
+  return kernels[size - 1](matrix);
+}
+
+typedef std::make_index_sequence<kMaxSmallKernelSize> KernelSizes;
+
+}  // namespace small_kernels
+
+inline SmallKernelThresholds& GetSmallKernelThresholds() {
+  static SmallKernelThresholds thresholds;
+  return thresholds;
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+void SmallMatrixMultiplyNormalNormal(
+    const Field& alpha, const ConstBlasMatrixView<Field>& left_matrix,
+    const ConstBlasMatrixView<Field>& right_matrix, const Field& beta,
+    BlasMatrixView<Field>* output_matrix) {
+  CATAMARI_ASSERT(left_matrix.height == output_matrix->height,
+                  "Output height was incompatible");
+  CATAMARI_ASSERT(right_matrix.width == output_matrix->width,
+                  "Output width was incompatible");
+  CATAMARI_ASSERT(left_matrix.width == right_matrix.height,
+                  "Contraction dimensions were incompatible.");
+  CATAMARI_ASSERT(left_matrix.width <= kMaxSmallKernelSize,
+                  "Contraction size was too large for a small kernel.");
+  if (!left_matrix.width) {
+    // There is nothing to contract, so this is a (possibly zero) scaling.
+    for (Int j = 0; j < output_matrix->width; ++j) {
+      Field* output_column = output_matrix->Pointer(0, j);
+      for (Int i = 0; i < output_matrix->height; ++i) {
+        output_column[i] =
+            beta == Field{0} ? Field{0} : beta * output_column[i];
+      }
+    }
+    return;
+  }
+  small_kernels::MatrixMultiplyNormalNormal(
+      left_matrix.width, alpha, left_matrix, right_matrix, beta,
+      output_matrix, small_kernels::KernelSizes());
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+void SmallLowerNormalHermitianOuterProduct(
+    const ComplexBase<Field>& alpha,
+    const ConstBlasMatrixView<Field>& left_matrix,
+    const ComplexBase<Field>& beta, BlasMatrixView<Field>* output_matrix) {
+  CATAMARI_ASSERT(left_matrix.height == output_matrix->height,
+                  "Output height was incompatible");
+  CATAMARI_ASSERT(left_matrix.width <= kMaxSmallKernelSize,
+                  "Contraction size was too large for a small kernel.");
+  if (!left_matrix.width) {
+    for (Int j = 0; j < output_matrix->height; ++j) {
+      Field* output_column = output_matrix->Pointer(0, j);
+      for (Int i = j; i < output_matrix->height; ++i) {
+        output_column[i] = beta == ComplexBase<Field>{0}
+                               ? Field{0}
+                               : beta * output_column[i];
+      }
+    }
+    return;
+  }
+  small_kernels::LowerNormalHermitianOuterProduct(
+      left_matrix.width, alpha, left_matrix, beta, output_matrix,
+      small_kernels::KernelSizes());
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+void SmallLeftLowerTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix) {
+  CATAMARI_ASSERT(triangular_matrix.height == triangular_matrix.width &&
+                      triangular_matrix.height == matrix->height,
+                  "Incompatible matrix dimensions");
+  CATAMARI_ASSERT(triangular_matrix.height <= kMaxSmallKernelSize,
+                  "Triangular matrix was too large for a small kernel.");
+  if (!triangular_matrix.height) return;
+  small_kernels::LeftLowerTriangularSolves(triangular_matrix.height,
+                                           triangular_matrix, matrix,
+                                           small_kernels::KernelSizes());
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+void SmallLeftLowerAdjointTriangularSolves(
+    const ConstBlasMatrixView<Field>& triangular_matrix,
+    BlasMatrixView<Field>* matrix) {
+  CATAMARI_ASSERT(triangular_matrix.height == triangular_matrix.width &&
+                      triangular_matrix.height == matrix->height,
+                  "Incompatible matrix dimensions");
+  CATAMARI_ASSERT(triangular_matrix.height <= kMaxSmallKernelSize,
+                  "Triangular matrix was too large for a small kernel.");
+  if (!triangular_matrix.height) return;
+  small_kernels::LeftLowerAdjointTriangularSolves(
+      triangular_matrix.height, triangular_matrix, matrix,
+      small_kernels::KernelSizes());
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+Int SmallLDLAdjointFactorization(BlasMatrixView<Field>* matrix) {
+  CATAMARI_ASSERT(matrix->height == matrix->width,
+                  "Can only factor square matrices.");
+  CATAMARI_ASSERT(matrix->height <= kMaxSmallKernelSize,
+                  "Matrix was too large for a small kernel.");
+  if (!matrix->height) return 0;
+  return small_kernels::LDLAdjointFactorization(matrix->height, matrix,
+                                                small_kernels::KernelSizes());
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_BASIC_LINEAR_ALGEBRA_SMALL_KERNELS_IMPL_H_
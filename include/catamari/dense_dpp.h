@@ -34,6 +34,34 @@ CATAMARI_EXPORT void CatamariSampleLowerHermitianDPPComplexDouble(
     CatamariInt block_size, bool maximum_likelihood,
     CatamariBlasMatrixViewComplexDouble* matrix, CatamariBufferInt* sample);
 
+// Draws 'num_samples' independent samples from the DPP with the given
+// Hermitian marginal kernel, of which only the lower triangle is read. Unlike
+// the single-sample routines, the kernel is left unmodified: each sample
+// factors its own copy, and the samples are drawn concurrently. Sample i uses
+// the i'th counter-based random stream keyed by 'seed', so that the result
+// is reproducible regardless of the number of threads and no state is shared
+// with concurrent calls. The 'samples' buffer holds the concatenated samples,
+// the i'th of which is 'samples[sample_offsets[i]:sample_offsets[i + 1]]'.
+CATAMARI_EXPORT void CatamariSampleLowerHermitianDPPBatchFloat(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewFloat* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples);
+
+CATAMARI_EXPORT void CatamariSampleLowerHermitianDPPBatchDouble(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewDouble* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples);
+
+CATAMARI_EXPORT void CatamariSampleLowerHermitianDPPBatchComplexFloat(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewComplexFloat* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples);
+
+CATAMARI_EXPORT void CatamariSampleLowerHermitianDPPBatchComplexDouble(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewComplexDouble* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples);
+
 #ifdef CATAMARI_OPENMP
 CATAMARI_EXPORT void CatamariOpenMPSampleLowerHermitianDPPFloat(
     CatamariInt tile_size, CatamariInt block_size, bool maximum_likelihood,
@@ -8,33 +8,73 @@
 #ifndef CATAMARI_DENSE_DPP_H_
 #define CATAMARI_DENSE_DPP_H_
 
+#include <cstdint>
 #include <random>
 
+#include <tbb/enumerable_thread_specific.h>
+
+#include "catamari/blas_matrix.hpp"
 #include "catamari/blas_matrix_view.hpp"
 #include "catamari/buffer.hpp"
 #include "catamari/complex.hpp"
 #include "catamari/dense_factorizations.hpp"
+#include "catamari/execution_context.hpp"
 #include "catamari/integers.hpp"
 
 namespace catamari {
 
+// NOTE: The samplers below accept any uniform random bit generator, such as
+// std::mt19937 or the counter-based catamari::PhiloxEngine.
+
+// The decision imposed upon an item of a DPP sample.
+enum DPPItemConstraint {
+  // The item is kept or dropped based upon its coin flip.
+  kFreeItem,
+
+  // The item is forced into the sample.
+  kIncludedItem,
+
+  // The item is forced out of the sample.
+  kExcludedItem,
+};
+
+// Items of a DPP, in the original ordering, whose decisions are imposed upon
+// a sample.
+struct DPPConstraints {
+  // The items forced into the sample.
+  std::vector<Int> included;
+
+  // The items forced out of the sample.
+  std::vector<Int> excluded;
+};
+
 // Returns a sample from the Determinantal Point Process implied by the
 // marginal kernel matrix (i.e., a Hermitian matrix with all eigenvalues
 // contained in [0, 1]). The input matrix is overwritten with the associated
 // L D L^H factorization of the modified kernel (each diagonal pivot with a
 // failed coin-flip is decremented by one).
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> SampleLowerHermitianDPP(Int block_size,
                                          bool maximum_likelihood,
                                          BlasMatrixView<Field>* matrix,
-                                         std::mt19937* generator);
+                                         Generator* generator);
+
+// An equivalent where, if 'constraints' is non-null, its i'th entry replaces
+// the coin flip of the i'th pivot. Every later pivot is then sampled
+// conditionally upon the imposed decision.
+template <class Field, class Generator>
+std::vector<Int> SampleLowerHermitianDPP(Int block_size,
+                                         bool maximum_likelihood,
+                                         const DPPItemConstraint* constraints,
+                                         BlasMatrixView<Field>* matrix,
+                                         Generator* generator);
 
 #ifdef CATAMARI_OPENMP
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPSampleLowerHermitianDPP(Int tile_size, Int block_size,
                                                bool maximum_likelihood,
                                                BlasMatrixView<Field>* matrix,
-                                               std::mt19937* generator,
+                                               Generator* generator,
                                                std::vector<Field>* buffer);
 #endif  // ifdef CATAMARI_OPENMP
 
@@ -49,12 +89,69 @@ std::vector<Int> OpenMPSampleLowerHermitianDPP(Int tile_size, Int block_size,
 // smaller block sizes, the complexity becomes O(n^2 rank). When n / rank is
 // large, which is where the elementary sampler performs best, the lazy
 // approach should be preferred.
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> SampleElementaryLowerHermitianDPP(
     Int block_size, Int rank, bool maximum_likelihood,
-    BlasMatrixView<Field>* matrix, std::mt19937* generator);
+    BlasMatrixView<Field>* matrix, Generator* generator);
 // TODO(Jack Poulson): Implement an OpenMP version of the elementary sampler.
 
+// Returns a sample from the L-ensemble Determinantal Point Process whose
+// (Hermitian positive semi-definite) kernel is L = B B^H, given the n x k
+// factor B. The sampler works with the k x k dual matrix I + B^H B and never
+// forms an n x n matrix, so that it requires O(n k^2) work and O(n k) memory.
+// The distribution, and the maximum-likelihood sample, match those of
+// SampleLowerHermitianDPP applied to the marginal kernel L (I + L)^{-1}.
+template <class Field, class Generator>
+std::vector<Int> SampleLowRankHermitianDPP(
+    Int block_size, bool maximum_likelihood,
+    const ConstBlasMatrixView<Field>& factor, Generator* generator);
+
+// The eigendecomposition of an L-ensemble kernel along with the elementary
+// symmetric polynomials of its eigenvalues, which allows the k-DPP of a
+// fixed sample size [1] to be sampled repeatedly without refactoring the
+// kernel.
+//
+// [1] Kulesza and Taskar, k-DPPs: Fixed-Size Determinantal Point Processes,
+//     ICML, 2011.
+//
+template <typename Field>
+struct KDPPDecomposition {
+  // The size, k, of every sample.
+  Int size = 0;
+
+  // The (nonnegative) eigenvalues of the kernel in increasing order.
+  Buffer<ComplexBase<Field>> eigenvalues;
+
+  // The orthonormal eigenvectors of the kernel, stored as columns.
+  BlasMatrix<Field> eigenvectors;
+
+  // The logarithms of the elementary symmetric polynomials e_l of the first
+  // m eigenvalues, for 0 <= l <= k and 0 <= m <= n, stored with leading
+  // dimension k + 1.
+  Buffer<ComplexBase<Field>> log_elementary_polynomials;
+};
+
+// Fills the k-DPP decomposition of the given Hermitian positive
+// semi-definite L-ensemble kernel (of which only the lower triangle is
+// accessed) for samples of the given size. An exception is thrown if the
+// kernel has fewer positive eigenvalues than the sample size.
+template <typename Field>
+void FormKDPPDecomposition(Int size, const ConstBlasMatrixView<Field>& kernel,
+                           KDPPDecomposition<Field>* decomposition);
+
+// Returns a sample (in increasing order) of exactly 'decomposition.size'
+// items from the k-DPP, P[\mathbb{Y} = Y] \propto det(L_Y) for |Y| = k. The
+// eigenvectors are selected using the elementary symmetric polynomials and
+// the elementary DPP which they span is then sampled in O(n k^2) work.
+template <class Field, class Generator>
+std::vector<Int> SampleKDPP(const KDPPDecomposition<Field>& decomposition,
+                            Generator* generator);
+
+// An equivalent which decomposes the kernel for a single sample.
+template <class Field, class Generator>
+std::vector<Int> SampleKDPP(Int size, const ConstBlasMatrixView<Field>& kernel,
+                            Generator* generator);
+
 // Returns a sample from the Determinantal Point Process implied by a
 // *non-Hermitian* marginal kernel matrix: a real or complex matrix with real
 // diagonal which satisfies [1]
@@ -68,19 +165,91 @@ std::vector<Int> SampleElementaryLowerHermitianDPP(
 // [1] Brunel, Learning Signed Determinantal Point Processes through the
 //     Principal Minor Assignment Problem.
 //
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> SampleNonHermitianDPP(Int block_size, bool maximum_likelihood,
                                        BlasMatrixView<Field>* matrix,
-                                       std::mt19937* generator);
+                                       Generator* generator);
+
+// A tiled, TBB-parallel version of 'SampleNonHermitianDPP', which shares the
+// task runtime of the sparse factorizations. Each diagonal tile is sampled by
+// a recursive L U factorization -- so that no block size needs to be tuned --
+// while the solves against it and the trailing updates are split into tasks
+// of one tile (or pair of tiles) each. The pivots, and thus the coin flips,
+// are still visited in their natural order, so that the sample has the same
+// distribution as that of the sequential sampler.
+template <class Field, class Generator>
+std::vector<Int> TiledSampleNonHermitianDPP(Int tile_size,
+                                            bool maximum_likelihood,
+                                            BlasMatrixView<Field>* matrix,
+                                            Generator* generator);
 
 #ifdef CATAMARI_OPENMP
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPSampleNonHermitianDPP(Int tile_size, Int block_size,
                                              bool maximum_likelihood,
                                              BlasMatrixView<Field>* matrix,
-                                             std::mt19937* generator);
+                                             Generator* generator);
 #endif  // ifdef CATAMARI_OPENMP
 
+// A reusable sampler of the DPP with a fixed non-Hermitian marginal kernel,
+// such as that of the domino tilings of an Aztec diamond, for drawing many
+// samples. The kernel is copied once, as the sampler is constructed, and
+// each thread which samples keeps a workspace -- across calls -- which is
+// overwritten with the kernel and then with the L U factorization of each of
+// its samples (see 'SampleNonHermitianDPP') rather than being reallocated.
+// The sampling routines are const and may be called by several threads at
+// once.
+//
+// Usage:
+//
+//   const catamari::NonHermitianDPPSampler<Field> sampler(
+//       kernel.ConstView(), block_size);
+//   const std::vector<std::vector<catamari::Int>> samples =
+//       sampler.SampleMany(num_samples, maximum_likelihood, seed);
+//
+template <class Field>
+class NonHermitianDPPSampler {
+ public:
+  // Copies the kernel. If 'execution_context' is non-null, which it must then
+  // outlive, the samples are drawn within it.
+  NonHermitianDPPSampler(const ConstBlasMatrixView<Field>& kernel,
+                         Int block_size,
+                         const ExecutionContext* execution_context = nullptr);
+
+  // Returns the number of items of the DPP.
+  Int NumItems() const CATAMARI_NOEXCEPT;
+
+  // Returns a sample drawn using the given generator within the workspace of
+  // the calling thread.
+  template <class Generator>
+  std::vector<Int> Sample(bool maximum_likelihood, Generator* generator) const;
+
+  // Returns 'num_samples' samples drawn concurrently, with sample 'index'
+  // drawn from 'PhiloxEngine(seed, index)', so that the samples do not depend
+  // upon the number of threads. BLAS calls are single-threaded meanwhile, as
+  // the parallelism is over the samples.
+  std::vector<std::vector<Int>> SampleMany(Int num_samples,
+                                           bool maximum_likelihood,
+                                           std::uint64_t seed) const;
+
+ private:
+  // The block size of the L U factorizations.
+  Int block_size_;
+
+  // The marginal kernel of the DPP.
+  BlasMatrix<Field> kernel_;
+
+  // The context which the samples are drawn within, if any.
+  const ExecutionContext* execution_context_;
+
+  // The factorization workspace of each thread which has drawn a sample.
+  mutable tbb::enumerable_thread_specific<BlasMatrix<Field>> workspaces_;
+
+  // Copies the kernel into the workspace of the calling thread and returns
+  // it.
+  BlasMatrixView<Field> LoadWorkspace() const;
+};
+
 // Returns the log-likelihood of a general DPP sample based upon the product of
 // the (real part of the) diagonal of the factored result.
 template <typename Field>
@@ -99,13 +268,67 @@ template <typename Field>
 ComplexBase<Field> ElementaryDPPLogLikelihood(
     Int rank, const ConstBlasMatrixView<Field>& matrix);
 
+// Returns the log-normalizer, log det(L + I), of the L-ensemble with the
+// given Hermitian positive semi-definite kernel L, whose lower triangle is
+// accessed.
+template <typename Field>
+ComplexBase<Field> LEnsembleLogNormalizer(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel);
+
+// Returns the log-likelihoods,
+//
+//   log P[\mathbb{Y} = Y] = log det(L_Y) - log det(L + I),
+//
+// of a batch of subsets of the L-ensemble with the given kernel (of which
+// only the lower triangle is accessed). The principal submatrices are
+// gathered and factored concurrently, with the small ones handled by the
+// specialized small-kernel LDL^H factorization, while the normalizer is
+// computed once for the whole batch. Singular subsets have a log-likelihood
+// of -infinity.
+template <typename Field>
+std::vector<ComplexBase<Field>> LEnsembleLogLikelihoods(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel,
+    const std::vector<std::vector<Int>>& subsets);
+
+// An equivalent which reuses a normalizer from LEnsembleLogNormalizer, e.g.,
+// across the batches of a training loop with a fixed kernel.
+template <typename Field>
+std::vector<ComplexBase<Field>> LEnsembleLogLikelihoods(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel,
+    const std::vector<std::vector<Int>>& subsets,
+    const ComplexBase<Field>& log_normalizer);
+
+// Returns up to 'max_size' items, in the order in which they were selected,
+// greedily chosen to maximize det(L_Y) for the L-ensemble with the given
+// Hermitian positive semi-definite kernel L (of which only the lower triangle
+// is accessed) [1]. Each step adds the item maximizing the ratio
+// det(L_{Y + i}) / det(L_Y), which is the squared pivot of an incremental
+// Cholesky factorization of L_Y, and the selection stops early once no ratio
+// exceeds 'min_gain'. A 'min_gain' of one only grows the selection while its
+// likelihood increases, whereas zero only stops at singularity. The cost is
+// O(n max_size^2) rather than that of a factorization per step.
+//
+// [1] Chen, Zhang, and Zhou, Fast Greedy MAP Inference for Determinantal
+//     Point Process to Improve Recommendation Diversity, NeurIPS, 2018.
+//
+template <typename Field>
+std::vector<Int> GreedyLEnsembleMAP(Int max_size,
+                                    const ComplexBase<Field>& min_gain,
+                                    const ConstBlasMatrixView<Field>& kernel);
+
 }  // namespace catamari
 
 #include "catamari/dense_dpp/dpp_log_likelihood-impl.hpp"
 #include "catamari/dense_dpp/elementary_hermitian_dpp-impl.hpp"
+#include "catamari/dense_dpp/greedy_map-impl.hpp"
 #include "catamari/dense_dpp/hermitian_dpp-impl.hpp"
 #include "catamari/dense_dpp/hermitian_dpp_openmp-impl.hpp"
+#include "catamari/dense_dpp/k_dpp-impl.hpp"
+#include "catamari/dense_dpp/l_ensemble_log_likelihood-impl.hpp"
+#include "catamari/dense_dpp/low_rank_hermitian_dpp-impl.hpp"
 #include "catamari/dense_dpp/nonhermitian_dpp-impl.hpp"
 #include "catamari/dense_dpp/nonhermitian_dpp_openmp-impl.hpp"
+#include "catamari/dense_dpp/nonhermitian_dpp_sampler-impl.hpp"
+#include "catamari/dense_dpp/nonhermitian_dpp_tiled-impl.hpp"
 
 #endif  // ifndef CATAMARI_DENSE_DPP_H_
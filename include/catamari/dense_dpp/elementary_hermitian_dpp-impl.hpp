@@ -90,11 +90,11 @@ void LowerHermitianSwap(Int index0, Int index1, BlasMatrixView<Field>* matrix) {
 
 namespace elem_herm_dpp {
 
-template <class Field>
+template <class Field, class Generator>
 Int PanelPivotSelection(Int rel_index, Int rank, bool maximum_likelihood,
                         const ConstBlasMatrixView<Field>& panel,
                         const Buffer<ComplexBase<Field>>& diagonal,
-                        std::mt19937* generator) {
+                        Generator* generator) {
   typedef ComplexBase<Field> Real;
   const Int diag_length = diagonal.Size();
 
@@ -132,12 +132,12 @@ Int PanelPivotSelection(Int rel_index, Int rank, bool maximum_likelihood,
   }
 }
 
-template <class Field>
+template <class Field, class Generator>
 void PanelSampleElementaryLowerHermitianDPP(
     Int panel_offset, Int panel_width, Int rank, bool maximum_likelihood,
     Buffer<Int>* indices, BlasMatrixView<Field>* matrix,
     Buffer<Field>* panel_row, Buffer<ComplexBase<Field>>* diagonal,
-    std::mt19937* generator, std::vector<Int>* sample) {
+    Generator* generator, std::vector<Int>* sample) {
   typedef ComplexBase<Field> Real;
   const Int panel_height = matrix->height - panel_offset;
   const Int rank_remaining = rank - panel_offset;
@@ -203,10 +203,10 @@ void PanelSampleElementaryLowerHermitianDPP(
 
 }  // namespace elem_herm_dpp
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> BlockedSampleElementaryLowerHermitianDPP(
     Int block_size, Int rank, bool maximum_likelihood,
-    BlasMatrixView<Field>* matrix, std::mt19937* generator) {
+    BlasMatrixView<Field>* matrix, Generator* generator) {
   typedef ComplexBase<Field> Real;
   const Int height = matrix->height;
   rank = std::min(height, rank);
@@ -252,10 +252,10 @@ std::vector<Int> BlockedSampleElementaryLowerHermitianDPP(
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> SampleElementaryLowerHermitianDPP(
     Int block_size, Int rank, bool maximum_likelihood,
-    BlasMatrixView<Field>* matrix, std::mt19937* generator) {
+    BlasMatrixView<Field>* matrix, Generator* generator) {
   return BlockedSampleElementaryLowerHermitianDPP(
       block_size, rank, maximum_likelihood, matrix, generator);
 }
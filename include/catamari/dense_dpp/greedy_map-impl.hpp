@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_GREEDY_MAP_IMPL_H_
+#define CATAMARI_DENSE_DPP_GREEDY_MAP_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+template <typename Field>
+std::vector<Int> GreedyLEnsembleMAP(Int max_size,
+                                    const ComplexBase<Field>& min_gain,
+                                    const ConstBlasMatrixView<Field>& kernel) {
+  typedef ComplexBase<Field> Real;
+  const Int num_items = kernel.height;
+  max_size = std::max(std::min(max_size, num_items), Int(0));
+  std::vector<Int> sample;
+  sample.reserve(max_size);
+
+  // The Schur complements of the items with respect to the selection, i.e.,
+  // the ratios det(L_{Y + i}) / det(L_Y).
+  Buffer<Real> gains(num_items);
+  for (Int i = 0; i < num_items; ++i) {
+    gains[i] = RealPart(kernel(i, i));
+  }
+  Buffer<char> selected(num_items, 0);
+
+  // The columns of the incremental Cholesky factor of the kernel restricted
+  // to the selection, so that L_Y = C_Y C_Y^H, along with the conjugate of a
+  // row of the factor to allow for a direct GEMV call.
+  BlasMatrix<Field> factor;
+  factor.Resize(num_items, std::max(max_size - 1, Int(0)));
+  Buffer<Field> pivot_row(max_size);
+
+  for (Int index = 0; index < max_size; ++index) {
+    Int pivot = -1;
+    Real pivot_gain = min_gain;
+    for (Int i = 0; i < num_items; ++i) {
+      if (!selected[i] && gains[i] > pivot_gain) {
+        pivot = i;
+        pivot_gain = gains[i];
+      }
+    }
+    if (pivot < 0) {
+      break;
+    }
+    sample.push_back(pivot);
+    selected[pivot] = 1;
+    if (index == max_size - 1) {
+      break;
+    }
+
+    // factor(:, index) :=
+    //     (kernel(:, pivot) - factor(:, 0:index) factor(pivot, 0:index)') /
+    //     sqrt(pivot_gain)
+    Field* column = factor.view.Pointer(0, index);
+    for (Int i = 0; i < pivot; ++i) {
+      column[i] = Conjugate(kernel(pivot, i));
+    }
+    for (Int i = pivot; i < num_items; ++i) {
+      column[i] = kernel(i, pivot);
+    }
+    for (Int j = 0; j < index; ++j) {
+      pivot_row[j] = Conjugate(factor(pivot, j));
+    }
+    MatrixVectorProduct(
+        Field{-1}, factor.view.Submatrix(0, 0, num_items, index).ToConst(),
+        pivot_row.Data(), column);
+
+    // Update the gains of the remaining items.
+    const Real pivot_inv_sqrt = Real(1) / std::sqrt(pivot_gain);
+    for (Int i = 0; i < num_items; ++i) {
+      if (selected[i]) {
+        continue;
+      }
+      Field& entry = column[i];
+      entry *= pivot_inv_sqrt;
+      gains[i] -= RealPart(entry * Conjugate(entry));
+      gains[i] = std::max(gains[i], Real(0));
+    }
+  }
+
+  return sample;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_GREEDY_MAP_IMPL_H_
@@ -17,58 +17,74 @@
 
 namespace catamari {
 
-template <class Field>
-std::vector<Int> UnblockedSampleLowerHermitianDPP(bool maximum_likelihood,
-                                                  BlasMatrixView<Field>* matrix,
-                                                  std::mt19937* generator) {
+template <class Field, class Generator>
+std::vector<Int> UnblockedSampleLowerHermitianDPP(
+    bool maximum_likelihood, const DPPItemConstraint* constraints,
+    BlasMatrixView<Field>* matrix, Generator* generator) {
   typedef ComplexBase<Field> Real;
   const Int height = matrix->height;
   std::vector<Int> sample;
   sample.reserve(height);
 
-  std::uniform_real_distribution<Real> uniform_dist{Real{0}, Real{1}};
+  // Draw all of the uniforms for the block up front, in pivot order, so that
+  // the elimination loop below is free of calls into the generator.
+  Buffer<Real> uniforms;
+  if (!maximum_likelihood) {
+    std::uniform_real_distribution<Real> uniform_dist{Real{0}, Real{1}};
+    uniforms.Resize(height);
+    for (Real& uniform : uniforms) {
+      uniform = uniform_dist(*generator);
+    }
+  }
 
 #ifdef CATAMARI_DEBUG
   const Real tolerance = 10 * std::numeric_limits<Real>::epsilon();
 #endif  // ifdef CATAMARI_DEBUG
 
+  const Int leading_dim = matrix->leading_dim;
   for (Int i = 0; i < height; ++i) {
-    Real delta = RealPart(matrix->Entry(i, i));
+    Field* column = matrix->Pointer(0, i);
+    Real delta = RealPart(column[i]);
     CATAMARI_ASSERT(
         delta >= -tolerance && delta <= Real{1} + tolerance,
         "Diagonal value was outside of [0, 1]: " + std::to_string(delta));
-    const bool keep_index = maximum_likelihood
-                                ? delta >= Real(1) / Real(2)
-                                : uniform_dist(*generator) <= delta;
+    bool keep_index;
+    if (constraints && constraints[i] != kFreeItem) {
+      keep_index = constraints[i] == kIncludedItem;
+    } else {
+      keep_index = maximum_likelihood ? delta >= Real(1) / Real(2)
+                                      : uniforms[i] <= delta;
+    }
     if (keep_index) {
       sample.push_back(i);
     } else {
       delta -= Real{1};
-      matrix->Entry(i, i) = delta;
+      column[i] = delta;
     }
 
     // Solve for the remainder of the i'th column of L.
     for (Int k = i + 1; k < height; ++k) {
-      matrix->Entry(k, i) /= delta;
+      column[k] /= delta;
     }
 
-    // Perform the rank-one update.
+    // Perform the rank-one update one contiguous column at a time, so that
+    // each inner loop is a unit-stride AXPY.
     for (Int j = i + 1; j < height; ++j) {
-      const Field eta = delta * Conjugate(matrix->Entry(j, i));
+      const Field eta = delta * Conjugate(column[j]);
+      Field* target_column = column + (j - i) * leading_dim;
       for (Int k = j; k < height; ++k) {
-        const Field& lambda_left = matrix->Entry(k, i);
-        matrix->Entry(k, j) -= lambda_left * eta;
+        target_column[k] -= column[k] * eta;
       }
     }
   }
   return sample;
 }
 
-template <class Field>
-std::vector<Int> BlockedSampleLowerHermitianDPP(Int block_size,
-                                                bool maximum_likelihood,
-                                                BlasMatrixView<Field>* matrix,
-                                                std::mt19937* generator) {
+template <class Field, class Generator>
+std::vector<Int> BlockedSampleLowerHermitianDPP(
+    Int block_size, bool maximum_likelihood,
+    const DPPItemConstraint* constraints, BlasMatrixView<Field>* matrix,
+    Generator* generator) {
   const Int height = matrix->height;
 
   std::vector<Int> sample;
@@ -85,7 +101,8 @@ std::vector<Int> BlockedSampleLowerHermitianDPP(Int block_size,
     BlasMatrixView<Field> diagonal_block =
         matrix->Submatrix(i, i, bsize, bsize);
     std::vector<Int> block_sample = UnblockedSampleLowerHermitianDPP(
-        maximum_likelihood, &diagonal_block, generator);
+        maximum_likelihood, constraints ? constraints + i : nullptr,
+        &diagonal_block, generator);
     for (const Int& index : block_sample) {
       sample.push_back(i + index);
     }
@@ -126,13 +143,23 @@ std::vector<Int> BlockedSampleLowerHermitianDPP(Int block_size,
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
+std::vector<Int> SampleLowerHermitianDPP(Int block_size,
+                                         bool maximum_likelihood,
+                                         BlasMatrixView<Field>* matrix,
+                                         Generator* generator) {
+  return BlockedSampleLowerHermitianDPP(block_size, maximum_likelihood,
+                                        nullptr, matrix, generator);
+}
+
+template <class Field, class Generator>
 std::vector<Int> SampleLowerHermitianDPP(Int block_size,
                                          bool maximum_likelihood,
+                                         const DPPItemConstraint* constraints,
                                          BlasMatrixView<Field>* matrix,
-                                         std::mt19937* generator) {
-  return BlockedSampleLowerHermitianDPP(block_size, maximum_likelihood, matrix,
-                                        generator);
+                                         Generator* generator) {
+  return BlockedSampleLowerHermitianDPP(block_size, maximum_likelihood,
+                                        constraints, matrix, generator);
 }
 
 }  // namespace catamari
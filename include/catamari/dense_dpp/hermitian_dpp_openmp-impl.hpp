@@ -18,10 +18,10 @@
 
 namespace catamari {
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPBlockedSampleLowerHermitianDPP(
     Int tile_size, Int block_size, bool maximum_likelihood,
-    BlasMatrixView<Field>* matrix, std::mt19937* generator,
+    BlasMatrixView<Field>* matrix, Generator* generator,
     Buffer<Field>* buffer) {
   const Int height = matrix->height;
   if (buffer->Size() < static_cast<std::size_t>(height * height)) {
@@ -62,7 +62,7 @@ std::vector<Int> OpenMPBlockedSampleLowerHermitianDPP(
         depend(inout: matrix_data[i + i * leading_dim])
     {
       *block_sample_ptr = BlockedSampleLowerHermitianDPP(
-          block_size, maximum_likelihood, &diagonal_block, generator);
+          block_size, maximum_likelihood, nullptr, &diagonal_block, generator);
       for (const Int& index : *block_sample_ptr) {
         sample_ptr->push_back(i + index);
       }
@@ -143,11 +143,11 @@ std::vector<Int> OpenMPBlockedSampleLowerHermitianDPP(
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPSampleLowerHermitianDPP(Int tile_size, Int block_size,
                                                bool maximum_likelihood,
                                                BlasMatrixView<Field>* matrix,
-                                               std::mt19937* generator,
+                                               Generator* generator,
                                                Buffer<Field>* buffer) {
   return OpenMPBlockedSampleLowerHermitianDPP(
       tile_size, block_size, maximum_likelihood, matrix, generator, buffer);
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_K_DPP_IMPL_H_
+#define CATAMARI_DENSE_DPP_K_DPP_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include <Eigen/Eigenvalues>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_dpp/low_rank_hermitian_dpp-impl.hpp"
+#include "catamari/eigen_scalar.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+namespace k_dpp {
+
+// Returns log(exp(a) + exp(b)), where either argument may be -infinity.
+template <typename Real>
+Real LogSumExp(const Real& a, const Real& b) {
+  const Real larger = std::max(a, b);
+  if (larger == -std::numeric_limits<Real>::infinity()) {
+    return larger;
+  }
+  return larger + std::log1p(std::exp(std::min(a, b) - larger));
+}
+
+}  // namespace k_dpp
+
+template <typename Field>
+void FormKDPPDecomposition(Int size, const ConstBlasMatrixView<Field>& kernel,
+                           KDPPDecomposition<Field>* decomposition) {
+  typedef ComplexBase<Field> Real;
+  typedef EigenScalar<Field> Conversion;
+  typedef Eigen::Matrix<typename Conversion::type, Eigen::Dynamic,
+                        Eigen::Dynamic>
+      EigenMatrix;
+  const Int num_items = kernel.height;
+  if (size < 0 || size > num_items) {
+    throw std::invalid_argument("The k-DPP size must lie within [0, n]");
+  }
+
+  // Eigen's Hermitian eigensolver only accesses the lower triangle.
+  EigenMatrix matrix(num_items, num_items);
+  for (Int j = 0; j < num_items; ++j) {
+    for (Int i = j; i < num_items; ++i) {
+      matrix(i, j) = Conversion::ToEigen(kernel(i, j));
+    }
+  }
+  const Eigen::SelfAdjointEigenSolver<EigenMatrix> solver(matrix);
+
+  // Round away any (roundoff-level) negative eigenvalues.
+  decomposition->size = size;
+  decomposition->eigenvalues.Resize(num_items);
+  decomposition->eigenvectors.Resize(num_items, num_items);
+  for (Int j = 0; j < num_items; ++j) {
+    decomposition->eigenvalues[j] =
+        std::max(Real(solver.eigenvalues()(j)), Real(0));
+    for (Int i = 0; i < num_items; ++i) {
+      decomposition->eigenvectors(i, j) =
+          Conversion::FromEigen(solver.eigenvectors()(i, j));
+    }
+  }
+
+  // The recurrence
+  //
+  //   e_l(lambda_0, ..., lambda_m) =
+  //       e_l(lambda_0, ..., lambda_{m-1}) +
+  //       lambda_m e_{l-1}(lambda_0, ..., lambda_{m-1})
+  //
+  // is evaluated in log-space, as the polynomials readily overflow.
+  const Real neg_infinity = -std::numeric_limits<Real>::infinity();
+  const Int leading_dim = size + 1;
+  Buffer<Real>& log_polynomials = decomposition->log_elementary_polynomials;
+  log_polynomials.Resize(leading_dim * (num_items + 1));
+  log_polynomials[0] = 0;
+  for (Int l = 1; l <= size; ++l) {
+    log_polynomials[l] = neg_infinity;
+  }
+  for (Int m = 1; m <= num_items; ++m) {
+    const Real eigenvalue = decomposition->eigenvalues[m - 1];
+    const Real log_eigenvalue =
+        eigenvalue > Real(0) ? std::log(eigenvalue) : neg_infinity;
+    const Real* previous = &log_polynomials[(m - 1) * leading_dim];
+    Real* current = &log_polynomials[m * leading_dim];
+    current[0] = 0;
+    for (Int l = 1; l <= size; ++l) {
+      current[l] =
+          k_dpp::LogSumExp(previous[l], log_eigenvalue + previous[l - 1]);
+    }
+  }
+  if (log_polynomials[size + num_items * leading_dim] == neg_infinity) {
+    throw std::invalid_argument(
+        "The kernel has fewer positive eigenvalues than the k-DPP size");
+  }
+}
+
+template <class Field, class Generator>
+std::vector<Int> SampleKDPP(const KDPPDecomposition<Field>& decomposition,
+                            Generator* generator) {
+  typedef ComplexBase<Field> Real;
+  const Int size = decomposition.size;
+  const Int num_items = decomposition.eigenvalues.Size();
+  const Int leading_dim = size + 1;
+  const Buffer<Real>& log_polynomials =
+      decomposition.log_elementary_polynomials;
+
+  // Choose the eigenvectors from last to first: given that 'remaining' of
+  // the first m eigenvectors are to be chosen, the last of them is chosen
+  // with probability lambda_{m-1} e_{remaining-1}(m-1) / e_remaining(m).
+  std::uniform_real_distribution<Real> uniform_dist{Real{0}, Real{1}};
+  std::vector<Int> eigenvector_indices;
+  eigenvector_indices.reserve(size);
+  Int remaining = size;
+  for (Int m = num_items; m > 0 && remaining > 0; --m) {
+    const Real eigenvalue = decomposition.eigenvalues[m - 1];
+    bool keep = remaining == m;
+    if (!keep && eigenvalue > Real(0)) {
+      const Real log_probability =
+          std::log(eigenvalue) +
+          log_polynomials[(remaining - 1) + (m - 1) * leading_dim] -
+          log_polynomials[remaining + m * leading_dim];
+      keep = uniform_dist(*generator) < std::exp(log_probability);
+    }
+    if (keep) {
+      eigenvector_indices.push_back(m - 1);
+      --remaining;
+    }
+  }
+
+  // Sample the elementary DPP spanned by the chosen eigenvectors.
+  BlasMatrix<Field> basis;
+  basis.Resize(num_items, size);
+  for (Int j = 0; j < size; ++j) {
+    const Int index = eigenvector_indices[j];
+    for (Int i = 0; i < num_items; ++i) {
+      basis(i, j) = decomposition.eigenvectors(i, index);
+    }
+  }
+  return low_rank_herm_dpp::SampleFactoredMarginalKernel(
+      false, basis.view.ToConst(), generator);
+}
+
+template <class Field, class Generator>
+std::vector<Int> SampleKDPP(Int size, const ConstBlasMatrixView<Field>& kernel,
+                            Generator* generator) {
+  KDPPDecomposition<Field> decomposition;
+  FormKDPPDecomposition(size, kernel, &decomposition);
+  return SampleKDPP(decomposition, generator);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_K_DPP_IMPL_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_L_ENSEMBLE_LOG_LIKELIHOOD_IMPL_H_
+#define CATAMARI_DENSE_DPP_L_ENSEMBLE_LOG_LIKELIHOOD_IMPL_H_
+
+#include <cmath>
+#include <limits>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_factorizations.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+namespace l_ensemble {
+
+// Overwrites the lower triangle of an HPD matrix with a factorization and
+// returns its log-determinant, or -infinity if the matrix was singular.
+template <typename Field>
+ComplexBase<Field> LogDeterminant(Int block_size,
+                                  BlasMatrixView<Field>* matrix) {
+  typedef ComplexBase<Field> Real;
+  const Int matrix_size = matrix->height;
+  Real log_determinant = 0;
+  if (matrix_size <= kMaxSmallKernelSize) {
+    // The specialized kernel leaves D on the diagonal of the L D L^H factor.
+    if (SmallLDLAdjointFactorization(matrix) < matrix_size) {
+      return -std::numeric_limits<Real>::infinity();
+    }
+    for (Int i = 0; i < matrix_size; ++i) {
+      const Real pivot = RealPart(matrix->Entry(i, i));
+      if (pivot <= Real(0)) {
+        return -std::numeric_limits<Real>::infinity();
+      }
+      log_determinant += std::log(pivot);
+    }
+  } else {
+    if (LowerCholeskyFactorization(block_size, matrix) < matrix_size) {
+      return -std::numeric_limits<Real>::infinity();
+    }
+    for (Int i = 0; i < matrix_size; ++i) {
+      log_determinant += 2 * std::log(RealPart(matrix->Entry(i, i)));
+    }
+  }
+  return log_determinant;
+}
+
+}  // namespace l_ensemble
+
+template <typename Field>
+ComplexBase<Field> LEnsembleLogNormalizer(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel) {
+  const Int matrix_size = kernel.height;
+  BlasMatrix<Field> shifted_kernel;
+  shifted_kernel.Resize(matrix_size, matrix_size);
+  for (Int j = 0; j < matrix_size; ++j) {
+    for (Int i = j; i < matrix_size; ++i) {
+      shifted_kernel(i, j) = kernel(i, j);
+    }
+    shifted_kernel(j, j) += Field{1};
+  }
+  return l_ensemble::LogDeterminant(block_size, &shifted_kernel.view);
+}
+
+template <typename Field>
+std::vector<ComplexBase<Field>> LEnsembleLogLikelihoods(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel,
+    const std::vector<std::vector<Int>>& subsets,
+    const ComplexBase<Field>& log_normalizer) {
+  typedef ComplexBase<Field> Real;
+  const Int num_subsets = subsets.size();
+  std::vector<Real> log_likelihoods(num_subsets);
+
+  // Each thread gathers its principal submatrices into a reused buffer.
+  tbb::enumerable_thread_specific<Buffer<Field>> buffers;
+  tbb::parallel_for(Int(0), num_subsets, [&](Int subset_index) {
+    const std::vector<Int>& subset = subsets[subset_index];
+    const Int subset_size = subset.size();
+    Buffer<Field>& buffer = buffers.local();
+    if (buffer.Size() < subset_size * subset_size) {
+      buffer.Resize(subset_size * subset_size);
+    }
+
+    BlasMatrixView<Field> submatrix;
+    submatrix.height = submatrix.width = subset_size;
+    submatrix.leading_dim = subset_size;
+    submatrix.data = buffer.Data();
+    for (Int j = 0; j < subset_size; ++j) {
+      for (Int i = j; i < subset_size; ++i) {
+        // Only the lower triangle of the kernel is accessed.
+        const Int row = subset[i];
+        const Int column = subset[j];
+        submatrix(i, j) = row >= column ? kernel(row, column)
+                                        : Conjugate(kernel(column, row));
+      }
+    }
+
+    log_likelihoods[subset_index] =
+        l_ensemble::LogDeterminant(block_size, &submatrix) - log_normalizer;
+  });
+
+  return log_likelihoods;
+}
+
+template <typename Field>
+std::vector<ComplexBase<Field>> LEnsembleLogLikelihoods(
+    Int block_size, const ConstBlasMatrixView<Field>& kernel,
+    const std::vector<std::vector<Int>>& subsets) {
+  return LEnsembleLogLikelihoods(block_size, kernel, subsets,
+                                 LEnsembleLogNormalizer(block_size, kernel));
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_L_ENSEMBLE_LOG_LIKELIHOOD_IMPL_H_
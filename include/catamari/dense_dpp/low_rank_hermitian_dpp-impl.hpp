@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_LOW_RANK_HERMITIAN_DPP_IMPL_H_
+#define CATAMARI_DENSE_DPP_LOW_RANK_HERMITIAN_DPP_IMPL_H_
+
+#include <cmath>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_factorizations.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+namespace low_rank_herm_dpp {
+
+// Returns a sample from the DPP with the marginal kernel W W^H, given the
+// n x k matrix W.
+template <class Field, class Generator>
+std::vector<Int> SampleFactoredMarginalKernel(
+    bool maximum_likelihood, const ConstBlasMatrixView<Field>& basis,
+    Generator* generator) {
+  typedef ComplexBase<Field> Real;
+  const Int height = basis.height;
+  const Int rank = basis.width;
+  std::vector<Int> sample;
+  sample.reserve(rank);
+
+  // Every Schur complement of the marginal kernel remains of the form
+  // W M W^H, so we eliminate the pivots in their natural order -- exactly as
+  // in SampleLowerHermitianDPP -- using rank-one updates of the k x k matrix
+  // M rather than of the n x n kernel. The lower triangle of M is stored.
+  std::uniform_real_distribution<Real> uniform_dist{Real{0}, Real{1}};
+  BlasMatrix<Field> middle;
+  middle.Resize(rank, rank, Field{0});
+  for (Int j = 0; j < rank; ++j) {
+    middle(j, j) = Field{1};
+  }
+  Buffer<Field> update(rank);
+  for (Int i = 0; i < height; ++i) {
+    // update := M w^H, where w is the i'th row of W.
+    for (Int a = 0; a < rank; ++a) {
+      Field value{0};
+      for (Int b = 0; b < a; ++b) {
+        value += middle(a, b) * Conjugate(basis(i, b));
+      }
+      for (Int b = a; b < rank; ++b) {
+        value += Conjugate(middle(b, a)) * Conjugate(basis(i, b));
+      }
+      update[a] = value;
+    }
+
+    // The diagonal entry of the current Schur complement, w M w^H.
+    Real delta = 0;
+    for (Int a = 0; a < rank; ++a) {
+      delta += RealPart(basis(i, a) * update[a]);
+    }
+
+    const bool keep_index = maximum_likelihood
+                                ? delta >= Real(1) / Real(2)
+                                : uniform_dist(*generator) <= delta;
+    if (keep_index) {
+      sample.push_back(i);
+    } else {
+      delta -= Real{1};
+    }
+
+    // M := M - (M w^H) (M w^H)^H / delta.
+    for (Int b = 0; b < rank; ++b) {
+      const Field eta = Conjugate(update[b]) / delta;
+      for (Int a = b; a < rank; ++a) {
+        middle(a, b) -= update[a] * eta;
+      }
+    }
+  }
+
+  return sample;
+}
+
+}  // namespace low_rank_herm_dpp
+
+template <class Field, class Generator>
+std::vector<Int> SampleLowRankHermitianDPP(
+    Int block_size, bool maximum_likelihood,
+    const ConstBlasMatrixView<Field>& factor, Generator* generator) {
+  const Int height = factor.height;
+  const Int rank = factor.width;
+
+  // Form the Cholesky factor R R^H of the dual matrix I + B^H B.
+  BlasMatrix<Field> dual_factor;
+  dual_factor.Resize(rank, rank, Field{0});
+  for (Int j = 0; j < rank; ++j) {
+    dual_factor(j, j) = Field{1};
+  }
+  MatrixMultiplyAdjointNormal(Field{1}, factor, factor, Field{1},
+                              &dual_factor.view);
+  const Int num_pivots CATAMARI_UNUSED =
+      LowerCholeskyFactorization(block_size, &dual_factor.view);
+  CATAMARI_ASSERT(num_pivots == rank, "Dual matrix was not HPD.");
+
+  // The marginal kernel is then
+  //
+  //   K = L (I + L)^{-1} = B (I + B^H B)^{-1} B^H = W W^H,
+  //
+  // with W = B R^{-H}.
+  BlasMatrix<Field> basis;
+  basis.Resize(height, rank);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      basis(i, j) = factor(i, j);
+    }
+  }
+  RightLowerAdjointTriangularSolves(dual_factor.view.ToConst(), &basis.view);
+
+  return low_rank_herm_dpp::SampleFactoredMarginalKernel(
+      maximum_likelihood, basis.view.ToConst(), generator);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_LOW_RANK_HERMITIAN_DPP_IMPL_H_
@@ -17,10 +17,10 @@
 
 namespace catamari {
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> UnblockedSampleNonHermitianDPP(bool maximum_likelihood,
                                                 BlasMatrixView<Field>* matrix,
-                                                std::mt19937* generator) {
+                                                Generator* generator) {
   typedef ComplexBase<Field> Real;
   const Int height = matrix->height;
   CATAMARI_ASSERT(height == matrix->width, "Can only sample square kernels.");
@@ -68,11 +68,11 @@ std::vector<Int> UnblockedSampleNonHermitianDPP(bool maximum_likelihood,
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> BlockedSampleNonHermitianDPP(Int block_size,
                                               bool maximum_likelihood,
                                               BlasMatrixView<Field>* matrix,
-                                              std::mt19937* generator) {
+                                              Generator* generator) {
   const Int height = matrix->height;
 
   std::vector<Int> sample;
@@ -112,10 +112,10 @@ std::vector<Int> BlockedSampleNonHermitianDPP(Int block_size,
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> SampleNonHermitianDPP(Int block_size, bool maximum_likelihood,
                                        BlasMatrixView<Field>* matrix,
-                                       std::mt19937* generator) {
+                                       Generator* generator) {
   return BlockedSampleNonHermitianDPP(block_size, maximum_likelihood, matrix,
                                       generator);
 }
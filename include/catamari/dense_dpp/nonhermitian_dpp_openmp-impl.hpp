@@ -18,10 +18,10 @@
 
 namespace catamari {
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPBlockedSampleNonHermitianDPP(
     Int tile_size, Int block_size, bool maximum_likelihood,
-    BlasMatrixView<Field>* matrix, std::mt19937* generator) {
+    BlasMatrixView<Field>* matrix, Generator* generator) {
   const Int height = matrix->height;
 
   std::vector<Int> sample;
@@ -116,11 +116,11 @@ std::vector<Int> OpenMPBlockedSampleNonHermitianDPP(
   return sample;
 }
 
-template <class Field>
+template <class Field, class Generator>
 std::vector<Int> OpenMPSampleNonHermitianDPP(Int tile_size, Int block_size,
                                              bool maximum_likelihood,
                                              BlasMatrixView<Field>* matrix,
-                                             std::mt19937* generator) {
+                                             Generator* generator) {
   return OpenMPBlockedSampleNonHermitianDPP(
       tile_size, block_size, maximum_likelihood, matrix, generator);
 }
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_SAMPLER_IMPL_H_
+#define CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_SAMPLER_IMPL_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+#include "catamari/dense_dpp/nonhermitian_dpp-impl.hpp"
+#include "catamari/philox.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+template <class Field>
+NonHermitianDPPSampler<Field>::NonHermitianDPPSampler(
+    const ConstBlasMatrixView<Field>& kernel, Int block_size,
+    const ExecutionContext* execution_context)
+    : block_size_(block_size), execution_context_(execution_context) {
+  CATAMARI_ASSERT(kernel.height == kernel.width,
+                  "Can only sample square kernels.");
+  const Int num_items = kernel.height;
+  kernel_.Resize(num_items, num_items);
+  for (Int j = 0; j < num_items; ++j) {
+    std::copy(kernel.Pointer(0, j), kernel.Pointer(num_items, j),
+              kernel_.Pointer(0, j));
+  }
+}
+
+template <class Field>
+Int NonHermitianDPPSampler<Field>::NumItems() const CATAMARI_NOEXCEPT {
+  return kernel_.Height();
+}
+
+template <class Field>
+BlasMatrixView<Field> NonHermitianDPPSampler<Field>::LoadWorkspace() const {
+  const Int num_items = kernel_.Height();
+  BlasMatrix<Field>& workspace = workspaces_.local();
+  workspace.Resize(num_items, num_items);
+  std::copy(kernel_.Data(), kernel_.Data() + num_items * num_items,
+            workspace.Data());
+  return workspace.view;
+}
+
+template <class Field>
+template <class Generator>
+std::vector<Int> NonHermitianDPPSampler<Field>::Sample(
+    bool maximum_likelihood, Generator* generator) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return Sample(maximum_likelihood, generator); });
+  }
+  BlasMatrixView<Field> workspace = LoadWorkspace();
+  return SampleNonHermitianDPP(block_size_, maximum_likelihood, &workspace,
+                               generator);
+}
+
+template <class Field>
+std::vector<std::vector<Int>> NonHermitianDPPSampler<Field>::SampleMany(
+    Int num_samples, bool maximum_likelihood, std::uint64_t seed) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute([&]() {
+      return SampleMany(num_samples, maximum_likelihood, seed);
+    });
+  }
+  std::vector<std::vector<Int>> samples(std::max(num_samples, Int(0)));
+  if (num_samples <= 0) {
+    return samples;
+  }
+
+  const int old_max_threads = GetMaxBlasThreads();
+  SetNumBlasThreads(1);
+
+  tbb::parallel_for(Int(0), num_samples, [&](Int sample_index) {
+    PhiloxEngine generator(seed, static_cast<std::uint32_t>(sample_index));
+    BlasMatrixView<Field> workspace = LoadWorkspace();
+    samples[sample_index] = SampleNonHermitianDPP(
+        block_size_, maximum_likelihood, &workspace, &generator);
+  });
+
+  SetNumBlasThreads(old_max_threads);
+
+  return samples;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_SAMPLER_IMPL_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_TILED_IMPL_H_
+#define CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_TILED_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_dpp/nonhermitian_dpp-impl.hpp"
+
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+namespace nonherm_dpp {
+
+// Appends to 'sample' the (offset) sample of the non-Hermitian DPP whose
+// kernel is 'matrix', which is overwritten with the L U factorization of the
+// modified kernel, by splitting it in half, recursively sampling the leading
+// diagonal block, solving for the off-diagonal blocks, updating the trailing
+// block, and then recursively sampling it. The coin flips remain in the
+// natural order of the pivots, while the updates shrink geometrically so that
+// no block size needs to be tuned.
+template <class Field, class Generator>
+void RecursiveSampleNonHermitianDPP(bool maximum_likelihood, Int offset,
+                                    BlasMatrixView<Field>* matrix,
+                                    Generator* generator,
+                                    std::vector<Int>* sample) {
+  const Int height = matrix->height;
+  if (height <= kMaxSmallKernelSize) {
+    const std::vector<Int> block_sample =
+        UnblockedSampleNonHermitianDPP(maximum_likelihood, matrix, generator);
+    for (const Int& index : block_sample) {
+      sample->push_back(offset + index);
+    }
+    return;
+  }
+  const Int leading_size = height / 2;
+  const Int trailing_size = height - leading_size;
+
+  BlasMatrixView<Field> leading_block =
+      matrix->Submatrix(0, 0, leading_size, leading_size);
+  RecursiveSampleNonHermitianDPP(maximum_likelihood, offset, &leading_block,
+                                 generator, sample);
+  const ConstBlasMatrixView<Field> const_leading_block =
+      leading_block.ToConst();
+
+  BlasMatrixView<Field> subdiagonal =
+      matrix->Submatrix(leading_size, 0, trailing_size, leading_size);
+  RightUpperTriangularSolves(const_leading_block, &subdiagonal);
+  BlasMatrixView<Field> superdiagonal =
+      matrix->Submatrix(0, leading_size, leading_size, trailing_size);
+  LeftLowerUnitTriangularSolves(const_leading_block, &superdiagonal);
+
+  BlasMatrixView<Field> trailing_block = matrix->Submatrix(
+      leading_size, leading_size, trailing_size, trailing_size);
+  MatrixMultiplyNormalNormal(Field{-1}, subdiagonal.ToConst(),
+                             superdiagonal.ToConst(), Field{1},
+                             &trailing_block);
+  RecursiveSampleNonHermitianDPP(maximum_likelihood, offset + leading_size,
+                                 &trailing_block, generator, sample);
+}
+
+}  // namespace nonherm_dpp
+
+template <class Field, class Generator>
+std::vector<Int> TiledSampleNonHermitianDPP(Int tile_size,
+                                            bool maximum_likelihood,
+                                            BlasMatrixView<Field>* matrix,
+                                            Generator* generator) {
+  const Int height = matrix->height;
+  tile_size = std::max(tile_size, Int(1));
+
+  std::vector<Int> sample;
+  sample.reserve(height);
+
+  std::vector<std::pair<Int, Int>> tile_pairs;
+  for (Int i = 0; i < height; i += tile_size) {
+    const Int tsize = std::min(height - i, tile_size);
+
+    // Sample the diagonal tile, overwriting it with its L U factorization.
+    BlasMatrixView<Field> diagonal_block =
+        matrix->Submatrix(i, i, tsize, tsize);
+    nonherm_dpp::RecursiveSampleNonHermitianDPP(
+        maximum_likelihood, i, &diagonal_block, generator, &sample);
+    if (height == i + tsize) {
+      break;
+    }
+    const ConstBlasMatrixView<Field> const_diagonal_block =
+        diagonal_block.ToConst();
+
+    const Int trailing_beg = i + tsize;
+    const Int num_tiles = (height - trailing_beg + tile_size - 1) / tile_size;
+    auto tile_beg = [&](Int tile) { return trailing_beg + tile * tile_size; };
+    auto tile_height = [&](Int tile) {
+      return std::min(tile_size, height - tile_beg(tile));
+    };
+
+    // Solve for the remainders of the block column of L and the block row of
+    // U, one tile per task.
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(0, 2 * num_tiles, 1),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int index = range.begin(); index < range.end(); ++index) {
+            const Int tile = index / 2;
+            if (index % 2 == 0) {
+              BlasMatrixView<Field> subdiagonal_block = matrix->Submatrix(
+                  tile_beg(tile), i, tile_height(tile), tsize);
+              RightUpperTriangularSolves(const_diagonal_block,
+                                         &subdiagonal_block);
+            } else {
+              BlasMatrixView<Field> superdiagonal_block = matrix->Submatrix(
+                  i, tile_beg(tile), tsize, tile_height(tile));
+              LeftLowerUnitTriangularSolves(const_diagonal_block,
+                                            &superdiagonal_block);
+            }
+          }
+        });
+
+    // Update the trailing matrix, one tile per task.
+    tile_pairs.clear();
+    for (Int column = 0; column < num_tiles; ++column) {
+      for (Int row = 0; row < num_tiles; ++row) {
+        tile_pairs.emplace_back(row, column);
+      }
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, tile_pairs.size(), 1),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+          for (std::size_t index = range.begin(); index < range.end();
+               ++index) {
+            const Int row = tile_pairs[index].first;
+            const Int column = tile_pairs[index].second;
+            const ConstBlasMatrixView<Field> row_block =
+                matrix->Submatrix(tile_beg(row), i, tile_height(row), tsize)
+                    .ToConst();
+            const ConstBlasMatrixView<Field> column_block =
+                matrix
+                    ->Submatrix(i, tile_beg(column), tsize,
+                                tile_height(column))
+                    .ToConst();
+            BlasMatrixView<Field> update_block =
+                matrix->Submatrix(tile_beg(row), tile_beg(column),
+                                  tile_height(row), tile_height(column));
+            MatrixMultiplyNormalNormal(Field{-1}, row_block, column_block,
+                                       Field{1}, &update_block);
+          }
+        });
+  }
+
+  return sample;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_DPP_NONHERMITIAN_DPP_TILED_IMPL_H_
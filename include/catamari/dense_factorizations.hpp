@@ -13,11 +13,27 @@
 #include "catamari/blas_matrix_view.hpp"
 #include "catamari/buffer.hpp"
 #include "catamari/complex.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dynamic_regularization.hpp"
 #include "catamari/integers.hpp"
 
 namespace catamari {
 
+// The triangular factorizations shared by the tiled and recursive drivers.
+enum DenseFactorizationKind {
+  kDenseCholesky,
+  kDenseLDLAdjoint,
+  kDenseLDLTranspose,
+};
+
+// The smallest matrix height for which the dense factorizations which are not
+// handed off to LAPACK switch from a blocked to a recursive algorithm.
+#ifndef CATAMARI_MIN_RECURSIVE_FACTORIZATION_SIZE
+#define CATAMARI_MIN_RECURSIVE_FACTORIZATION_SIZE 64
+#endif
+constexpr Int kMinRecursiveFactorizationSize =
+    CATAMARI_MIN_RECURSIVE_FACTORIZATION_SIZE;
+
 // Attempts to overwrite the lower triangle of an (implicitly) Hermitian
 // Positive-Definite matrix with its lower-triangular Cholesky factor. The
 // return value is the number of successful pivots; the factorization was
@@ -32,6 +48,20 @@ Int OpenMPLowerCholeskyFactorization(Int tile_size, Int block_size,
                                      BlasMatrixView<Field>* matrix);
 #endif  // ifdef CATAMARI_OPENMP
 
+// A tiled version of 'LowerCholeskyFactorization' whose triangular solves and
+// trailing updates are TBB tasks over tiles of size 'tile_size', so that it
+// can be called from within a running TBB task, e.g., to factor a large
+// front, without nesting a second thread pool.
+template <class Field>
+Int TiledLowerCholeskyFactorization(Int tile_size, Int block_size,
+                                    BlasMatrixView<Field>* matrix);
+
+// A recursive, cache-oblivious version of 'LowerCholeskyFactorization' which
+// halves the matrix until reaching an unblocked base case, so that the bulk of
+// the work is in a few large BLAS 3 updates and no block size need be tuned.
+template <class Field>
+Int RecursiveLowerCholeskyFactorization(BlasMatrixView<Field>* matrix);
+
 template <class Field>
 Int DynamicallyRegularizedLowerCholeskyFactorization(
     Int block_size,
@@ -48,6 +78,19 @@ Int OpenMPDynamicallyRegularizedLowerCholeskyFactorization(
     std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
 #endif  // ifdef CATAMARI_OPENMP
 
+template <class Field>
+Int TiledDynamicallyRegularizedLowerCholeskyFactorization(
+    Int tile_size, Int block_size,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
+template <class Field>
+Int RecursiveDynamicallyRegularizedLowerCholeskyFactorization(
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
 // Attempts to overwrite the lower triangle of an (implicitly) Hermitian
 // matrix with its L D L^H factorization, where L is lower-triangular with
 // unit diagonal and D is diagonal (D is stored in place of the implicit
@@ -64,6 +107,20 @@ Int OpenMPLDLAdjointFactorization(Int tile_size, Int block_size,
                                   Buffer<Field>* buffer);
 #endif  // ifdef CATAMARI_OPENMP
 
+// A tiled, TBB-parallel version of 'LDLAdjointFactorization' (see
+// 'TiledLowerCholeskyFactorization'). The buffer is resized as needed to hold
+// one block column of tiles.
+template <class Field>
+Int TiledLDLAdjointFactorization(Int tile_size, Int block_size,
+                                 BlasMatrixView<Field>* matrix,
+                                 Buffer<Field>* buffer);
+
+// A recursive version of 'LDLAdjointFactorization' (see
+// 'RecursiveLowerCholeskyFactorization') whose base case is the
+// register-blocked 'SmallLDLAdjointFactorization'.
+template <class Field>
+Int RecursiveLDLAdjointFactorization(BlasMatrixView<Field>* matrix);
+
 template <class Field>
 Int DynamicallyRegularizedLDLAdjointFactorization(
     Int block_size,
@@ -80,6 +137,19 @@ Int OpenMPDynamicallyRegularizedLDLAdjointFactorization(
     std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
 #endif  // ifdef CATAMARI_OPENMP
 
+template <class Field>
+Int TiledDynamicallyRegularizedLDLAdjointFactorization(
+    Int tile_size, Int block_size,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix, Buffer<Field>* buffer,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
+template <class Field>
+Int RecursiveDynamicallyRegularizedLDLAdjointFactorization(
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
 // Attempts to overwrite the lower triangle of an (implicitly) symmetric
 // matrix with its L D L^T factorization, where L is lower-triangular with
 // unit diagonal and D is diagonal (D is stored in place of the implicit
@@ -96,6 +166,18 @@ Int OpenMPLDLTransposeFactorization(Int tile_size, Int block_size,
                                     Buffer<Field>* buffer);
 #endif  // ifdef CATAMARI_OPENMP
 
+// A tiled, TBB-parallel version of 'LDLTransposeFactorization' (see
+// 'TiledLDLAdjointFactorization').
+template <class Field>
+Int TiledLDLTransposeFactorization(Int tile_size, Int block_size,
+                                   BlasMatrixView<Field>* matrix,
+                                   Buffer<Field>* buffer);
+
+// A recursive version of 'LDLTransposeFactorization' (see
+// 'RecursiveLowerCholeskyFactorization').
+template <class Field>
+Int RecursiveLDLTransposeFactorization(BlasMatrixView<Field>* matrix);
+
 // Attempts to overwrite the lower triangle of an (implicitly) Hermitian
 // matrix with its diagonally-pivoted L D L^H factorization, where L is
 // lower-triangular with unit diagonal and D is real diagonal (D is stored in
@@ -114,8 +196,43 @@ Int OpenMPPivotedLDLAdjointFactorization(Int tile_size, Int block_size,
                                          BlasMatrixView<Int>* permutation);
 #endif  // ifdef CATAMARI_OPENMP
 
+// Attempts to overwrite the lower triangle of an (implicitly) Hermitian,
+// possibly indefinite, matrix with its Bunch-Kaufman factorization
+// P A P^T = L D L^H, where L is lower-triangular with unit diagonal and D is
+// block diagonal with Hermitian 1x1 and 2x2 blocks, using the bounded pivoting
+// of LAPACK's (c/z)hetrf with panels of (roughly) 'block_size' columns. Entry
+// 'i' of 'permutation' is the original index of the 'i'-th pivot, and entry
+// 'i' of 'pivot_sizes' is one for a 1x1 pivot, two for the first index of a
+// 2x2 pivot, and zero for its second index. D is stored in place of the
+// implicit diagonal blocks of L; in particular, the subdiagonal entry of each
+// 2x2 pivot is stored where L is implicitly zero. The return value is the
+// number of successful pivots; the factorization was successful if and only
+// if the return value is the height of the input matrix.
+template <class Field>
+Int BunchKaufmanLDLAdjointFactorization(Int block_size,
+                                        BlasMatrixView<Field>* matrix,
+                                        BlasMatrixView<Int>* permutation,
+                                        Buffer<Int>* pivot_sizes);
+
+// Overwrites 'right_hand_sides' with the solutions of 'A X = B' given the
+// result of 'BunchKaufmanLDLAdjointFactorization' applied to A.
+template <class Field>
+void BunchKaufmanLDLAdjointSolve(const ConstBlasMatrixView<Field>& factor,
+                                 const ConstBlasMatrixView<Int>& permutation,
+                                 const Buffer<Int>& pivot_sizes,
+                                 BlasMatrixView<Field>* right_hand_sides);
+
+// Returns the SmallKernelThresholds at which the small, compile-time
+// specialized kernels stop outperforming the general (BLAS/LAPACK) routines
+// on this machine, as timed over 'num_repetitions' calls of each kernel with
+// the given rank (or contraction size) of the updates.
+template <class Field>
+SmallKernelThresholds CalibrateSmallKernelThresholds(Int contraction_size = 8,
+                                                     Int num_repetitions = 100);
+
 }  // namespace catamari
 
+#include "catamari/dense_factorizations/bunch_kaufman_ldl_adjoint-impl.hpp"
 #include "catamari/dense_factorizations/cholesky-impl.hpp"
 #include "catamari/dense_factorizations/cholesky_openmp-impl.hpp"
 #include "catamari/dense_factorizations/ldl_adjoint-impl.hpp"
@@ -124,5 +241,8 @@ Int OpenMPPivotedLDLAdjointFactorization(Int tile_size, Int block_size,
 #include "catamari/dense_factorizations/ldl_transpose_openmp-impl.hpp"
 #include "catamari/dense_factorizations/pivoted_ldl_adjoint-impl.hpp"
 #include "catamari/dense_factorizations/pivoted_ldl_adjoint_openmp-impl.hpp"
+#include "catamari/dense_factorizations/recursive-impl.hpp"
+#include "catamari/dense_factorizations/small_kernel_calibration-impl.hpp"
+#include "catamari/dense_factorizations/tiled-impl.hpp"
 
 #endif  // ifndef CATAMARI_DENSE_FACTORIZATIONS_H_
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_FACTORIZATIONS_BUNCH_KAUFMAN_LDL_ADJOINT_IMPL_H_
+#define CATAMARI_DENSE_FACTORIZATIONS_BUNCH_KAUFMAN_LDL_ADJOINT_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+#include "catamari/dense_factorizations.hpp"
+
+// For the LowerHermitianSwap subroutine.
+#include "catamari/dense_dpp.hpp"
+
+namespace catamari {
+
+namespace bunch_kaufman {
+
+// The Bunch-Kaufman constant, (1 + sqrt(17)) / 8, which minimizes the bound
+// on the element growth of each pair of 1x1 pivots and each 2x2 pivot.
+template <typename Real>
+Real Alpha() {
+  return (Real(1) + std::sqrt(Real(17))) / Real(8);
+}
+
+// Overwrites 'column' with the entries of rows [index, height) of the column
+// 'source' of the current Schur complement, i.e., of the lower triangle of
+// 'matrix' (implicitly Hermitian) minus the contributions of the
+// 'num_factored' columns of the panel beginning at 'panel_offset', whose
+// conjugated L D products are stored in 'scaled_adjoint'.
+template <class Field>
+void SchurComplementColumn(Int panel_offset, Int num_factored, Int index,
+                           Int source,
+                           const ConstBlasMatrixView<Field>& matrix,
+                           const ConstBlasMatrixView<Field>& scaled_adjoint,
+                           Field* column) {
+  const Int height = matrix.height;
+  for (Int i = index; i < height; ++i) {
+    column[i - index] =
+        i < source ? Conjugate(matrix(source, i)) : matrix(i, source);
+  }
+  for (Int j = 0; j < num_factored; ++j) {
+    const Field eta = scaled_adjoint(source - panel_offset, j);
+    const Field* factor_column = matrix.Pointer(0, panel_offset + j);
+    for (Int i = index; i < height; ++i) {
+      column[i - index] -= factor_column[i] * eta;
+    }
+  }
+}
+
+// Factors between 'panel_width' and 'panel_width + 1' columns, beginning at
+// 'panel_offset', of the Schur complement of the previous panels, using the
+// bounded Bunch-Kaufman pivoting of LAPACK's (c/z)hetrf. Only the panel is
+// updated; 'scaled_adjoint' (whose height is that of the Schur complement and
+// whose width is at least 'panel_width + 1') is overwritten with the
+// conjugate of L D for the panel columns so that the caller may update the
+// remaining trailing matrix. The return value is the number of factored
+// columns.
+template <class Field>
+Int PanelFactorization(Int panel_offset, Int panel_width,
+                       BlasMatrixView<Field>* matrix,
+                       BlasMatrixView<Int>* permutation,
+                       Buffer<Int>* pivot_sizes,
+                       BlasMatrixView<Field>* scaled_adjoint,
+                       Buffer<Field>* columns) {
+  typedef ComplexBase<Field> Real;
+  const Int height = matrix->height;
+  const Real alpha = Alpha<Real>();
+  const Int panel_end = std::min(panel_offset + panel_width, height);
+  Field* column = columns->Data();
+  Field* pivot_column = columns->Data() + height;
+
+  Int index = panel_offset;
+  while (index < panel_end) {
+    const Int num_factored = index - panel_offset;
+    const Int num_left = height - index;
+    SchurComplementColumn(panel_offset, num_factored, index, index,
+                          matrix->ToConst(), scaled_adjoint->ToConst(),
+                          column);
+
+    // Find the largest subdiagonal entry of the column.
+    const Real abs_diagonal = std::abs(RealPart(column[0]));
+    Int max_index = index;
+    Real column_max = 0;
+    for (Int i = 1; i < num_left; ++i) {
+      const Real abs_value = std::abs(column[i]);
+      if (abs_value > column_max) {
+        max_index = index + i;
+        column_max = abs_value;
+      }
+    }
+    if (std::max(abs_diagonal, column_max) == Real(0)) {
+      break;
+    }
+
+    Int pivot_size = 1;
+    Int pivot_index = index;
+    if (abs_diagonal < alpha * column_max) {
+      SchurComplementColumn(panel_offset, num_factored, index, max_index,
+                            matrix->ToConst(), scaled_adjoint->ToConst(),
+                            pivot_column);
+      Real row_max = 0;
+      for (Int i = 0; i < num_left; ++i) {
+        if (index + i != max_index) {
+          row_max = std::max(row_max, std::abs(pivot_column[i]));
+        }
+      }
+
+      if (abs_diagonal >= alpha * column_max * (column_max / row_max)) {
+        // The original diagonal entry is an acceptable 1x1 pivot.
+      } else if (std::abs(RealPart(pivot_column[max_index - index])) >=
+                 alpha * row_max) {
+        // Use the 'max_index' diagonal entry as a 1x1 pivot.
+        pivot_index = max_index;
+        std::swap(column, pivot_column);
+      } else {
+        // Use a 2x2 pivot of 'index' and 'max_index'.
+        pivot_size = 2;
+        pivot_index = max_index;
+      }
+    }
+
+    // Symmetrically move the pivot to the last index of the pivot block.
+    const Int last_index = index + pivot_size - 1;
+    if (pivot_index != last_index) {
+      LowerHermitianSwap(last_index, pivot_index, matrix);
+      std::swap(permutation->Entry(last_index),
+                permutation->Entry(pivot_index));
+      for (Int j = 0; j < num_factored; ++j) {
+        std::swap(scaled_adjoint->Entry(last_index - panel_offset, j),
+                  scaled_adjoint->Entry(pivot_index - panel_offset, j));
+      }
+      std::swap(column[last_index - index], column[pivot_index - index]);
+      if (pivot_size == 2) {
+        std::swap(pivot_column[last_index - index],
+                  pivot_column[pivot_index - index]);
+      }
+    }
+
+    if (pivot_size == 1) {
+      const Real delta = RealPart(column[0]);
+      matrix->Entry(index, index) = delta;
+      scaled_adjoint->Entry(index - panel_offset, num_factored) = delta;
+      for (Int i = 1; i < num_left; ++i) {
+        scaled_adjoint->Entry(index + i - panel_offset, num_factored) =
+            Conjugate(column[i]);
+        matrix->Entry(index + i, index) = column[i] / delta;
+      }
+      (*pivot_sizes)[index] = 1;
+    } else {
+      // Store D = [delta11, conj(delta21); delta21, delta22] in place of the
+      // 2x2 identity block of L and solve against it.
+      const Real delta11 = RealPart(column[0]);
+      const Field delta21 = column[1];
+      const Real delta22 = RealPart(pivot_column[1]);
+      const Real delta21_abs = std::abs(delta21);
+      const Real determinant = delta11 * delta22 - delta21_abs * delta21_abs;
+      matrix->Entry(index, index) = delta11;
+      matrix->Entry(index + 1, index) = delta21;
+      matrix->Entry(index + 1, index + 1) = delta22;
+      scaled_adjoint->Entry(index - panel_offset, num_factored) = delta11;
+      scaled_adjoint->Entry(index - panel_offset, num_factored + 1) = delta21;
+      scaled_adjoint->Entry(index + 1 - panel_offset, num_factored) =
+          Conjugate(delta21);
+      scaled_adjoint->Entry(index + 1 - panel_offset, num_factored + 1) =
+          delta22;
+      for (Int i = 2; i < num_left; ++i) {
+        const Field& beta0 = column[i];
+        const Field& beta1 = pivot_column[i];
+        scaled_adjoint->Entry(index + i - panel_offset, num_factored) =
+            Conjugate(beta0);
+        scaled_adjoint->Entry(index + i - panel_offset, num_factored + 1) =
+            Conjugate(beta1);
+        matrix->Entry(index + i, index) =
+            (beta0 * delta22 - beta1 * delta21) / determinant;
+        matrix->Entry(index + i, index + 1) =
+            (beta1 * delta11 - beta0 * Conjugate(delta21)) / determinant;
+      }
+      (*pivot_sizes)[index] = 2;
+      (*pivot_sizes)[index + 1] = 0;
+    }
+    index += pivot_size;
+  }
+
+  return index - panel_offset;
+}
+
+}  // namespace bunch_kaufman
+
+template <class Field>
+Int BlockedBunchKaufmanLDLAdjointFactorization(
+    Int block_size, BlasMatrixView<Field>* matrix,
+    BlasMatrixView<Int>* permutation, Buffer<Int>* pivot_sizes) {
+  const Int height = matrix->height;
+  block_size = std::max(std::min(block_size, height), Int(1));
+
+  // The conjugate of L D for the current panel, which may have one more
+  // column than the block size if it ends with a 2x2 pivot.
+  Buffer<Field> buffer(height * (block_size + 1));
+  BlasMatrixView<Field> scaled_adjoint;
+  scaled_adjoint.data = buffer.Data();
+
+  // For storing the candidate pivot columns of the Schur complement.
+  Buffer<Field> columns(2 * height);
+
+  // Initialize the original indices.
+  CATAMARI_ASSERT(permutation->height == height,
+                  "Incorrect permutation height.");
+  CATAMARI_ASSERT(permutation->width == 1, "Incorrect permutation width.");
+  for (Int i = 0; i < height; ++i) {
+    permutation->Entry(i) = i;
+  }
+  pivot_sizes->Resize(height);
+
+  Int i = 0;
+  while (i < height) {
+    const Int bsize = std::min(height - i, block_size);
+    scaled_adjoint.height = height - i;
+    scaled_adjoint.width = block_size + 1;
+    scaled_adjoint.leading_dim = height - i;
+
+    const Int num_panel_pivots = bunch_kaufman::PanelFactorization(
+        i, bsize, matrix, permutation, pivot_sizes, &scaled_adjoint, &columns);
+    if (num_panel_pivots < bsize) {
+      return i + num_panel_pivots;
+    }
+    if (i + num_panel_pivots == height) {
+      break;
+    }
+
+    const Int size_left = height - (i + num_panel_pivots);
+    const ConstBlasMatrixView<Field> panel_lower =
+        matrix->Submatrix(i + num_panel_pivots, i, size_left, num_panel_pivots)
+            .ToConst();
+    const ConstBlasMatrixView<Field> factor =
+        scaled_adjoint
+            .Submatrix(num_panel_pivots, 0, size_left, num_panel_pivots)
+            .ToConst();
+    BlasMatrixView<Field> matrix_bottom_right = matrix->Submatrix(
+        i + num_panel_pivots, i + num_panel_pivots, size_left, size_left);
+    MatrixMultiplyLowerNormalTranspose(Field{-1}, panel_lower, factor,
+                                       Field{1}, &matrix_bottom_right);
+    i += num_panel_pivots;
+  }
+
+  return height;
+}
+
+template <class Field>
+Int BunchKaufmanLDLAdjointFactorization(Int block_size,
+                                        BlasMatrixView<Field>* matrix,
+                                        BlasMatrixView<Int>* permutation,
+                                        Buffer<Int>* pivot_sizes) {
+  return BlockedBunchKaufmanLDLAdjointFactorization(block_size, matrix,
+                                                    permutation, pivot_sizes);
+}
+
+template <class Field>
+void BunchKaufmanLDLAdjointSolve(const ConstBlasMatrixView<Field>& factor,
+                                 const ConstBlasMatrixView<Int>& permutation,
+                                 const Buffer<Int>& pivot_sizes,
+                                 BlasMatrixView<Field>* right_hand_sides) {
+  typedef ComplexBase<Field> Real;
+  const Int height = factor.height;
+  Buffer<Field> permuted(height);
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    Field* rhs = right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < height; ++i) {
+      permuted[i] = rhs[permutation(i)];
+    }
+
+    // Solve against L, whose diagonal pivot blocks are implicitly identity.
+    for (Int k = 0; k < height; k += pivot_sizes[k]) {
+      for (Int l = k; l < k + pivot_sizes[k]; ++l) {
+        const Field eta = permuted[l];
+        for (Int i = k + pivot_sizes[k]; i < height; ++i) {
+          permuted[i] -= factor(i, l) * eta;
+        }
+      }
+    }
+
+    // Solve against the block diagonal D.
+    for (Int k = 0; k < height; k += pivot_sizes[k]) {
+      if (pivot_sizes[k] == 1) {
+        permuted[k] /= RealPart(factor(k, k));
+        continue;
+      }
+      const Real delta11 = RealPart(factor(k, k));
+      const Field delta21 = factor(k + 1, k);
+      const Real delta22 = RealPart(factor(k + 1, k + 1));
+      const Real delta21_abs = std::abs(delta21);
+      const Real determinant = delta11 * delta22 - delta21_abs * delta21_abs;
+      const Field beta0 = permuted[k];
+      const Field beta1 = permuted[k + 1];
+      permuted[k] =
+          (delta22 * beta0 - Conjugate(delta21) * beta1) / determinant;
+      permuted[k + 1] = (delta11 * beta1 - delta21 * beta0) / determinant;
+    }
+
+    // Solve against L^H.
+    Int k = height;
+    while (k > 0) {
+      k -= pivot_sizes[k - 1] ? 1 : 2;
+      for (Int l = k; l < k + pivot_sizes[k]; ++l) {
+        Field& eta = permuted[l];
+        for (Int i = k + pivot_sizes[k]; i < height; ++i) {
+          eta -= Conjugate(factor(i, l)) * permuted[i];
+        }
+      }
+    }
+
+    for (Int i = 0; i < height; ++i) {
+      rhs[permutation(i)] = permuted[i];
+    }
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_FACTORIZATIONS_BUNCH_KAUFMAN_LDL_ADJOINT_IMPL_H_
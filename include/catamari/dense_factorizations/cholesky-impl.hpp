@@ -77,7 +77,8 @@ Int UnblockedDynamicallyRegularizedLowerCholeskyFactorization(
       CATAMARI_ASSERT((*dynamic_reg_params.signatures)[orig_index],
                       "Spurious negative pivot.");
       const Real regularization = dynamic_reg_params.positive_threshold - delta;
-      dynamic_regularization->emplace_back(orig_index, regularization);
+      RecordDynamicRegularization(dynamic_reg_params, orig_index,
+                                  regularization, dynamic_regularization);
       delta = dynamic_reg_params.positive_threshold;
     }
 
@@ -331,7 +332,9 @@ Int LowerCholeskyFactorizationDynamicBLASDispatch(Int block_size, BlasMatrixView
 
 template <class Field>
 inline Int LowerCholeskyFactorization(Int block_size,
-                                      BlasMatrixView<float>* matrix) {
+                                      BlasMatrixView<Field>* matrix) {
+  if (matrix->height >= kMinRecursiveFactorizationSize)
+      return RecursiveLowerCholeskyFactorization(matrix);
   if (matrix->height < 2 * block_size)
       return UnblockedLowerCholeskyFactorization(matrix);
   return BlockedLowerCholeskyFactorization(block_size, matrix);
@@ -423,6 +426,10 @@ Int DynamicallyRegularizedLowerCholeskyFactorization(
     const DynamicRegularizationParams<Field>& dynamic_reg_params,
     BlasMatrixView<Field>* matrix,
     std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  if (matrix->height >= kMinRecursiveFactorizationSize) {
+    return RecursiveDynamicallyRegularizedLowerCholeskyFactorization(
+        dynamic_reg_params, matrix, dynamic_regularization);
+  }
   return BlockedDynamicallyRegularizedLowerCholeskyFactorization(
       block_size, dynamic_reg_params, matrix, dynamic_regularization);
 }
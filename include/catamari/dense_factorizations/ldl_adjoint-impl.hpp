@@ -68,7 +68,8 @@ Int UnblockedDynamicallyRegularizedLDLAdjointFactorization(
       } else if (delta < dynamic_reg_params.positive_threshold) {
         const Real regularization =
             dynamic_reg_params.positive_threshold - delta;
-        dynamic_regularization->emplace_back(orig_index, regularization);
+        RecordDynamicRegularization(dynamic_reg_params, orig_index,
+                                    regularization, dynamic_regularization);
         delta = dynamic_reg_params.positive_threshold;
       }
     } else {
@@ -78,7 +79,9 @@ Int UnblockedDynamicallyRegularizedLDLAdjointFactorization(
       } else if (delta > -dynamic_reg_params.negative_threshold) {
         const Real regularization =
             dynamic_reg_params.negative_threshold - (-delta);
-        dynamic_regularization->emplace_back(orig_index, -regularization);
+        RecordDynamicRegularization(dynamic_reg_params, orig_index,
+                                    Real(-regularization),
+                                    dynamic_regularization);
         delta = -dynamic_reg_params.negative_threshold;
       }
     }
@@ -212,15 +215,32 @@ Int BlockedDynamicallyRegularizedLDLAdjointFactorization(
 
 template <class Field>
 Int LDLAdjointFactorization(Int block_size, BlasMatrixView<Field>* matrix) {
+  if (matrix->height >= kMinRecursiveFactorizationSize) {
+    return RecursiveLDLAdjointFactorization(matrix);
+  }
   return BlockedLDLAdjointFactorization(block_size, matrix);
 }
 
+template <class Field>
+Int LDLAdjointFactorizationDynamicBLASDispatch(Int block_size,
+                                               BlasMatrixView<Field>* matrix) {
+  if (matrix->height <= GetSmallKernelThresholds().factorization_size &&
+      matrix->height <= kMaxSmallKernelSize) {
+    return SmallLDLAdjointFactorization(matrix);
+  }
+  return LDLAdjointFactorization(block_size, matrix);
+}
+
 template <class Field>
 Int DynamicallyRegularizedLDLAdjointFactorization(
     Int block_size,
     const DynamicRegularizationParams<Field>& dynamic_reg_params,
     BlasMatrixView<Field>* matrix,
     std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  if (matrix->height >= kMinRecursiveFactorizationSize) {
+    return RecursiveDynamicallyRegularizedLDLAdjointFactorization(
+        dynamic_reg_params, matrix, dynamic_regularization);
+  }
   return BlockedDynamicallyRegularizedLDLAdjointFactorization(
       block_size, dynamic_reg_params, matrix, dynamic_regularization);
 }
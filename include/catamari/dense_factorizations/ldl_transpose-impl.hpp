@@ -96,6 +96,9 @@ Int BlockedLDLTransposeFactorization(Int block_size,
 
 template <class Field>
 Int LDLTransposeFactorization(Int block_size, BlasMatrixView<Field>* matrix) {
+  if (matrix->height >= kMinRecursiveFactorizationSize) {
+    return RecursiveLDLTransposeFactorization(matrix);
+  }
   return BlockedLDLTransposeFactorization(block_size, matrix);
 }
 
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_FACTORIZATIONS_RECURSIVE_IMPL_H_
+#define CATAMARI_DENSE_FACTORIZATIONS_RECURSIVE_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+#include "catamari/dense_factorizations.hpp"
+
+namespace catamari {
+namespace recursive_factorization {
+
+// The size of the diagonal blocks at which the recursion switches to the
+// (register-blocked, for L D L^H) base case kernels.
+constexpr Int kBaseSize = kMaxSmallKernelSize;
+
+// Returns the size of the buffer needed by 'Factorization' for a matrix of
+// the given height: the largest subdiagonal block, which is formed by the
+// first split.
+inline Int BufferSize(Int height) {
+  return height <= kBaseSize ? 0 : (height - height / 2) * (height / 2);
+}
+
+// Overwrites the lower triangle of 'matrix' with its factorization of the
+// given kind by splitting it in half, recursively factoring the leading
+// diagonal block, solving for the subdiagonal block, updating the trailing
+// diagonal block, and then recursively factoring it, where
+// 'factor_base(offset, block)' factors the diagonal blocks of at most
+// 'kBaseSize' beginning at index 'offset'. Since the problems and updates
+// shrink geometrically, each level of the memory hierarchy is eventually
+// used well without tuning a block size. For the LDL factorizations, 'buffer'
+// must hold at least 'BufferSize(matrix->height)' entries.
+template <class Field, class FactorBase>
+Int Factorization(DenseFactorizationKind kind, const FactorBase& factor_base,
+                  Int offset, BlasMatrixView<Field>* matrix, Field* buffer) {
+  typedef ComplexBase<Field> Real;
+  const Int height = matrix->height;
+  if (height <= kBaseSize) {
+    return factor_base(offset, matrix);
+  }
+  const Int leading_size = height / 2;
+  const Int trailing_size = height - leading_size;
+
+  BlasMatrixView<Field> leading_block =
+      matrix->Submatrix(0, 0, leading_size, leading_size);
+  const Int num_leading_pivots =
+      Factorization(kind, factor_base, offset, &leading_block, buffer);
+  if (num_leading_pivots < leading_size) {
+    return num_leading_pivots;
+  }
+  const ConstBlasMatrixView<Field> const_leading_block =
+      leading_block.ToConst();
+
+  BlasMatrixView<Field> subdiagonal =
+      matrix->Submatrix(leading_size, 0, trailing_size, leading_size);
+  BlasMatrixView<Field> trailing_block = matrix->Submatrix(
+      leading_size, leading_size, trailing_size, trailing_size);
+  if (kind == kDenseCholesky) {
+    RightLowerAdjointTriangularSolves(const_leading_block, &subdiagonal);
+    LowerNormalHermitianOuterProduct(Real{-1}, subdiagonal.ToConst(), Real{1},
+                                     &trailing_block);
+  } else {
+    if (kind == kDenseLDLAdjoint) {
+      RightLowerAdjointUnitTriangularSolves(const_leading_block,
+                                            &subdiagonal);
+    } else {
+      RightLowerTransposeUnitTriangularSolves(const_leading_block,
+                                              &subdiagonal);
+    }
+
+    // Copy the (conjugated) subdiagonal block and divide by the diagonal.
+    BlasMatrixView<Field> factor;
+    factor.height = trailing_size;
+    factor.width = leading_size;
+    factor.leading_dim = trailing_size;
+    factor.data = buffer;
+    for (Int j = 0; j < leading_size; ++j) {
+      const Field delta = kind == kDenseLDLAdjoint
+                              ? Field(RealPart(const_leading_block(j, j)))
+                              : const_leading_block(j, j);
+      for (Int k = 0; k < trailing_size; ++k) {
+        factor(k, j) = kind == kDenseLDLAdjoint ? Conjugate(subdiagonal(k, j))
+                                                : subdiagonal(k, j);
+        subdiagonal(k, j) /= delta;
+      }
+    }
+    MatrixMultiplyLowerNormalTranspose(Field{-1}, subdiagonal.ToConst(),
+                                       factor.ToConst(), Field{1},
+                                       &trailing_block);
+  }
+
+  // The buffer is no longer needed by this level, so the trailing recursion
+  // may reuse it.
+  return leading_size + Factorization(kind, factor_base,
+                                      offset + leading_size, &trailing_block,
+                                      buffer);
+}
+
+}  // namespace recursive_factorization
+
+template <class Field>
+Int RecursiveLowerCholeskyFactorization(BlasMatrixView<Field>* matrix) {
+  auto factor_base = [](Int /* offset */, BlasMatrixView<Field>* block) {
+    return UnblockedLowerCholeskyFactorization(block);
+  };
+  return recursive_factorization::Factorization<Field>(
+      kDenseCholesky, factor_base, 0, matrix, nullptr);
+}
+
+template <class Field>
+Int RecursiveDynamicallyRegularizedLowerCholeskyFactorization(
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+  auto factor_base = [&](Int offset, BlasMatrixView<Field>* block) {
+    subparams.offset = dynamic_reg_params.offset + offset;
+    return UnblockedDynamicallyRegularizedLowerCholeskyFactorization(
+        subparams, block, dynamic_regularization);
+  };
+  return recursive_factorization::Factorization<Field>(
+      kDenseCholesky, factor_base, 0, matrix, nullptr);
+}
+
+template <class Field>
+Int RecursiveLDLAdjointFactorization(BlasMatrixView<Field>* matrix) {
+  Buffer<Field> buffer(
+      recursive_factorization::BufferSize(matrix->height));
+  auto factor_base = [](Int /* offset */, BlasMatrixView<Field>* block) {
+    return SmallLDLAdjointFactorization(block);
+  };
+  return recursive_factorization::Factorization(
+      kDenseLDLAdjoint, factor_base, 0, matrix, buffer.Data());
+}
+
+template <class Field>
+Int RecursiveDynamicallyRegularizedLDLAdjointFactorization(
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  Buffer<Field> buffer(
+      recursive_factorization::BufferSize(matrix->height));
+  DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+  auto factor_base = [&](Int offset, BlasMatrixView<Field>* block) {
+    subparams.offset = dynamic_reg_params.offset + offset;
+    return UnblockedDynamicallyRegularizedLDLAdjointFactorization(
+        subparams, block, dynamic_regularization);
+  };
+  return recursive_factorization::Factorization(
+      kDenseLDLAdjoint, factor_base, 0, matrix, buffer.Data());
+}
+
+template <class Field>
+Int RecursiveLDLTransposeFactorization(BlasMatrixView<Field>* matrix) {
+  Buffer<Field> buffer(
+      recursive_factorization::BufferSize(matrix->height));
+  auto factor_base = [](Int /* offset */, BlasMatrixView<Field>* block) {
+    return UnblockedLDLTransposeFactorization(block);
+  };
+  return recursive_factorization::Factorization(
+      kDenseLDLTranspose, factor_base, 0, matrix, buffer.Data());
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_FACTORIZATIONS_RECURSIVE_IMPL_H_
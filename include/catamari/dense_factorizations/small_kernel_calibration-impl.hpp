@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_FACTORIZATIONS_SMALL_KERNEL_CALIBRATION_IMPL_H_
+#define CATAMARI_DENSE_FACTORIZATIONS_SMALL_KERNEL_CALIBRATION_IMPL_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "quotient/timer.hpp"
+
+#include "catamari/dense_factorizations.hpp"
+
+namespace catamari {
+
+namespace small_kernels {
+
+// Returns the average number of seconds taken by each of 'num_repetitions'
+// calls of 'function'.
+template <class Function>
+double AverageSeconds(Int num_repetitions, const Function& function) {
+  quotient::Timer timer;
+  timer.Start();
+  for (Int repetition = 0; repetition < num_repetitions; ++repetition) {
+    function();
+  }
+  return timer.Stop() / num_repetitions;
+}
+
+// Returns the largest of the increasing 'sizes' for which the small kernel is
+// no slower than the general one, stopping at the first size where it is.
+template <class SmallSeconds, class GeneralSeconds>
+Int Crossover(const std::vector<Int>& sizes, const SmallSeconds& small_seconds,
+              const GeneralSeconds& general_seconds) {
+  Int crossover = 0;
+  for (const Int& size : sizes) {
+    if (small_seconds(size) > general_seconds(size)) break;
+    crossover = size;
+  }
+  return crossover;
+}
+
+}  // namespace small_kernels
+
+template <class Field>
+SmallKernelThresholds CalibrateSmallKernelThresholds(Int contraction_size,
+                                                     Int num_repetitions) {
+  typedef ComplexBase<Field> Real;
+  contraction_size =
+      std::min(std::max(contraction_size, Int(1)), kMaxSmallKernelSize);
+
+  // The small kernels are meant for fronts of at most a few hundred rows, so
+  // the products are sampled geometrically up to that height and the square
+  // kernels at every other size up to the largest specialization.
+  std::vector<Int> heights;
+  for (Int height = 4; height <= 512; height *= 2) heights.push_back(height);
+  std::vector<Int> sizes;
+  for (Int size = 2; size <= kMaxSmallKernelSize; size += 2) {
+    sizes.push_back(size);
+  }
+  const Int max_height = heights.back();
+
+  // A unit lower-trapezoid with a dominant diagonal, so that the triangular
+  // solves against its leading block remain well-conditioned.
+  BlasMatrix<Field> left;
+  left.Resize(max_height, kMaxSmallKernelSize, Field{1});
+  for (Int i = 0; i < kMaxSmallKernelSize; ++i) {
+    left(i, i) = Real(kMaxSmallKernelSize);
+  }
+  BlasMatrix<Field> right;
+  right.Resize(kMaxSmallKernelSize, max_height, Field{1});
+  BlasMatrix<Field> output;
+  output.Resize(max_height, max_height, Field{0});
+
+  SmallKernelThresholds thresholds;
+
+  auto time_multiply = [&](Int height, bool small) {
+    const ConstBlasMatrixView<Field> left_block =
+        left.view.Submatrix(0, 0, height, contraction_size).ToConst();
+    const ConstBlasMatrixView<Field> right_block =
+        right.view.Submatrix(0, 0, contraction_size, contraction_size)
+            .ToConst();
+    BlasMatrixView<Field> output_block =
+        output.view.Submatrix(0, 0, height, contraction_size);
+    return small_kernels::AverageSeconds(num_repetitions, [&]() {
+      if (small) {
+        SmallMatrixMultiplyNormalNormal(Field{-1}, left_block, right_block,
+                                        Field{1}, &output_block);
+      } else {
+        MatrixMultiplyNormalNormal(Field{-1}, left_block, right_block,
+                                   Field{1}, &output_block);
+      }
+    });
+  };
+  thresholds.matrix_multiply_height = small_kernels::Crossover(
+      heights, [&](Int height) { return time_multiply(height, true); },
+      [&](Int height) { return time_multiply(height, false); });
+
+  auto time_outer_product = [&](Int height, bool small) {
+    const ConstBlasMatrixView<Field> left_block =
+        left.view.Submatrix(0, 0, height, contraction_size).ToConst();
+    BlasMatrixView<Field> output_block =
+        output.view.Submatrix(0, 0, height, height);
+    return small_kernels::AverageSeconds(num_repetitions, [&]() {
+      if (small) {
+        SmallLowerNormalHermitianOuterProduct(Real{-1}, left_block, Real{1},
+                                              &output_block);
+      } else {
+        LowerNormalHermitianOuterProduct(Real{-1}, left_block, Real{1},
+                                         &output_block);
+      }
+    });
+  };
+  thresholds.hermitian_outer_product_height = small_kernels::Crossover(
+      heights, [&](Int height) { return time_outer_product(height, true); },
+      [&](Int height) { return time_outer_product(height, false); });
+
+  // The triangular solves are timed against as many right-hand sides as the
+  // triangle has rows, which is typical of the supernodal solves.
+  auto time_triangular_solve = [&](Int size, bool small) {
+    const ConstBlasMatrixView<Field> triangle =
+        left.view.Submatrix(0, 0, size, size).ToConst();
+    BlasMatrixView<Field> right_hand_sides =
+        right.view.Submatrix(0, 0, size, size);
+    return small_kernels::AverageSeconds(num_repetitions, [&]() {
+      if (small) {
+        SmallLeftLowerTriangularSolves(triangle, &right_hand_sides);
+      } else {
+        LeftLowerTriangularSolves(triangle, &right_hand_sides);
+      }
+    });
+  };
+  thresholds.triangular_solve_size = small_kernels::Crossover(
+      sizes, [&](Int size) { return time_triangular_solve(size, true); },
+      [&](Int size) { return time_triangular_solve(size, false); });
+
+  // The factorizations overwrite their input, so each repetition refactors a
+  // fresh copy of a diagonally-dominant matrix.
+  BlasMatrix<Field> factor;
+  auto time_factorization = [&](Int size, bool small) {
+    return small_kernels::AverageSeconds(num_repetitions, [&]() {
+      factor.Resize(size, size, Field{1});
+      for (Int i = 0; i < size; ++i) factor(i, i) = Real(size + 1);
+      if (small) {
+        SmallLDLAdjointFactorization(&factor.view);
+      } else {
+        LDLAdjointFactorization(size, &factor.view);
+      }
+    });
+  };
+  thresholds.factorization_size = small_kernels::Crossover(
+      sizes, [&](Int size) { return time_factorization(size, true); },
+      [&](Int size) { return time_factorization(size, false); });
+
+  return thresholds;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_FACTORIZATIONS_SMALL_KERNEL_CALIBRATION_IMPL_H_
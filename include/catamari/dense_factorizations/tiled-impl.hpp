@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_FACTORIZATIONS_TILED_IMPL_H_
+#define CATAMARI_DENSE_FACTORIZATIONS_TILED_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+#include "catamari/dense_factorizations.hpp"
+
+namespace catamari {
+namespace tiled_factorization {
+
+// Overwrites the lower triangle of 'matrix' with its right-looking tiled
+// factorization of the given kind, where 'factor_diagonal_tile(offset, tile)'
+// factors the diagonal tile beginning at index 'offset' and returns its number
+// of successful pivots. The solves against each diagonal tile, and the
+// updates of the trailing tiles, are split into TBB tasks of one tile (or
+// pair of tiles) each. For the LDL factorizations, 'buffer' holds the
+// unscaled copy of the current block column of L.
+template <class Field, class FactorDiagonalTile>
+Int Factorization(DenseFactorizationKind kind, Int tile_size,
+                  const FactorDiagonalTile& factor_diagonal_tile,
+                  BlasMatrixView<Field>* matrix, Buffer<Field>* buffer) {
+  typedef ComplexBase<Field> Real;
+  const Int height = matrix->height;
+  tile_size = std::max(tile_size, Int(1));
+  if (kind != kDenseCholesky) {
+    const std::size_t panel_size = std::min(height, tile_size) * height;
+    if (buffer->Size() < panel_size) {
+      buffer->Resize(panel_size);
+    }
+  }
+
+  std::vector<std::pair<Int, Int>> tile_pairs;
+  Int num_pivots = 0;
+  for (Int i = 0; i < height; i += tile_size) {
+    const Int tsize = std::min(height - i, tile_size);
+
+    // Overwrite the diagonal tile with its factorization.
+    BlasMatrixView<Field> diagonal_block =
+        matrix->Submatrix(i, i, tsize, tsize);
+    const Int num_diag_pivots = factor_diagonal_tile(i, &diagonal_block);
+    num_pivots += num_diag_pivots;
+    if (num_diag_pivots < tsize || height == i + tsize) {
+      break;
+    }
+    const ConstBlasMatrixView<Field> const_diagonal_block =
+        diagonal_block.ToConst();
+
+    const Int trailing_beg = i + tsize;
+    const Int trailing_size = height - trailing_beg;
+    const Int num_tiles = (trailing_size + tile_size - 1) / tile_size;
+    auto tile_beg = [&](Int tile) { return trailing_beg + tile * tile_size; };
+    auto tile_height = [&](Int tile) {
+      return std::min(tile_size, height - tile_beg(tile));
+    };
+
+    // The conjugate (or, for L D L^T, the copy) of the block column of L
+    // before its solve against the diagonal.
+    BlasMatrixView<Field> factor;
+    factor.height = trailing_size;
+    factor.width = tsize;
+    factor.leading_dim = trailing_size;
+    factor.data = kind == kDenseCholesky ? nullptr : buffer->Data();
+
+    // Solve for the remainder of the block column of L, one tile per task.
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(0, num_tiles, 1),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int tile = range.begin(); tile < range.end(); ++tile) {
+            BlasMatrixView<Field> subdiagonal_block = matrix->Submatrix(
+                tile_beg(tile), i, tile_height(tile), tsize);
+            if (kind == kDenseCholesky) {
+              RightLowerAdjointTriangularSolves(const_diagonal_block,
+                                                &subdiagonal_block);
+              continue;
+            }
+            if (kind == kDenseLDLAdjoint) {
+              RightLowerAdjointUnitTriangularSolves(const_diagonal_block,
+                                                    &subdiagonal_block);
+            } else {
+              RightLowerTransposeUnitTriangularSolves(const_diagonal_block,
+                                                      &subdiagonal_block);
+            }
+
+            // Copy into 'factor' and solve against the diagonal.
+            BlasMatrixView<Field> factor_block = factor.Submatrix(
+                tile_beg(tile) - trailing_beg, 0, tile_height(tile), tsize);
+            for (Int j = 0; j < tsize; ++j) {
+              const Field delta = kind == kDenseLDLAdjoint
+                                      ? Field(RealPart(const_diagonal_block(
+                                            j, j)))
+                                      : const_diagonal_block(j, j);
+              for (Int k = 0; k < subdiagonal_block.height; ++k) {
+                factor_block(k, j) = kind == kDenseLDLAdjoint
+                                         ? Conjugate(subdiagonal_block(k, j))
+                                         : subdiagonal_block(k, j);
+                subdiagonal_block(k, j) /= delta;
+              }
+            }
+          }
+        });
+
+    // Update the lower triangle of the trailing matrix, one tile per task.
+    tile_pairs.clear();
+    for (Int column = 0; column < num_tiles; ++column) {
+      for (Int row = column; row < num_tiles; ++row) {
+        tile_pairs.emplace_back(row, column);
+      }
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, tile_pairs.size(), 1),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+          for (std::size_t index = range.begin(); index < range.end();
+               ++index) {
+            const Int row = tile_pairs[index].first;
+            const Int column = tile_pairs[index].second;
+            const ConstBlasMatrixView<Field> row_block =
+                matrix->Submatrix(tile_beg(row), i, tile_height(row), tsize)
+                    .ToConst();
+            BlasMatrixView<Field> update_block =
+                matrix->Submatrix(tile_beg(row), tile_beg(column),
+                                  tile_height(row), tile_height(column));
+            if (kind == kDenseCholesky) {
+              const ConstBlasMatrixView<Field> column_block =
+                  matrix
+                      ->Submatrix(tile_beg(column), i, tile_height(column),
+                                  tsize)
+                      .ToConst();
+              if (row == column) {
+                LowerNormalHermitianOuterProduct(Real{-1}, column_block,
+                                                 Real{1}, &update_block);
+              } else {
+                MatrixMultiplyNormalAdjoint(Field{-1}, row_block,
+                                            column_block, Field{1},
+                                            &update_block);
+              }
+            } else {
+              const ConstBlasMatrixView<Field> column_block =
+                  factor
+                      .Submatrix(tile_beg(column) - trailing_beg, 0,
+                                 tile_height(column), tsize)
+                      .ToConst();
+              if (row == column) {
+                MatrixMultiplyLowerNormalTranspose(Field{-1}, row_block,
+                                                   column_block, Field{1},
+                                                   &update_block);
+              } else {
+                MatrixMultiplyNormalTranspose(Field{-1}, row_block,
+                                              column_block, Field{1},
+                                              &update_block);
+              }
+            }
+          }
+        });
+  }
+
+  return num_pivots;
+}
+
+}  // namespace tiled_factorization
+
+template <class Field>
+Int TiledLowerCholeskyFactorization(Int tile_size, Int block_size,
+                                    BlasMatrixView<Field>* matrix) {
+  auto factor_diagonal_tile = [&](Int /* offset */,
+                                  BlasMatrixView<Field>* tile) {
+    return LowerCholeskyFactorization(block_size, tile);
+  };
+  return tiled_factorization::Factorization<Field>(
+      kDenseCholesky, tile_size, factor_diagonal_tile, matrix, nullptr);
+}
+
+template <class Field>
+Int TiledDynamicallyRegularizedLowerCholeskyFactorization(
+    Int tile_size, Int block_size,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+  auto factor_diagonal_tile = [&](Int offset, BlasMatrixView<Field>* tile) {
+    subparams.offset = dynamic_reg_params.offset + offset;
+    return DynamicallyRegularizedLowerCholeskyFactorization(
+        block_size, subparams, tile, dynamic_regularization);
+  };
+  return tiled_factorization::Factorization<Field>(
+      kDenseCholesky, tile_size, factor_diagonal_tile, matrix, nullptr);
+}
+
+template <class Field>
+Int TiledLDLAdjointFactorization(Int tile_size, Int block_size,
+                                 BlasMatrixView<Field>* matrix,
+                                 Buffer<Field>* buffer) {
+  auto factor_diagonal_tile = [&](Int /* offset */,
+                                  BlasMatrixView<Field>* tile) {
+    return LDLAdjointFactorization(block_size, tile);
+  };
+  return tiled_factorization::Factorization(
+      kDenseLDLAdjoint, tile_size, factor_diagonal_tile, matrix, buffer);
+}
+
+template <class Field>
+Int TiledDynamicallyRegularizedLDLAdjointFactorization(
+    Int tile_size, Int block_size,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* matrix, Buffer<Field>* buffer,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+  auto factor_diagonal_tile = [&](Int offset, BlasMatrixView<Field>* tile) {
+    subparams.offset = dynamic_reg_params.offset + offset;
+    return DynamicallyRegularizedLDLAdjointFactorization(
+        block_size, subparams, tile, dynamic_regularization);
+  };
+  return tiled_factorization::Factorization(
+      kDenseLDLAdjoint, tile_size, factor_diagonal_tile, matrix, buffer);
+}
+
+template <class Field>
+Int TiledLDLTransposeFactorization(Int tile_size, Int block_size,
+                                   BlasMatrixView<Field>* matrix,
+                                   Buffer<Field>* buffer) {
+  auto factor_diagonal_tile = [&](Int /* offset */,
+                                  BlasMatrixView<Field>* tile) {
+    return LDLTransposeFactorization(block_size, tile);
+  };
+  return tiled_factorization::Factorization(
+      kDenseLDLTranspose, tile_size, factor_diagonal_tile, matrix, buffer);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_FACTORIZATIONS_TILED_IMPL_H_
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_ROW_DEFERRAL_IMPL_H_
+#define CATAMARI_DENSE_ROW_DEFERRAL_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "catamari/dense_row_deferral.hpp"
+#include "catamari/index_utils.hpp"
+
+namespace catamari {
+
+template <class Field>
+bool DetectDenseRows(const CoordinateMatrix<Field>& matrix,
+                     const DenseRowControl& control,
+                     DenseRowPartition* partition) {
+  const Int num_rows = matrix.NumRows();
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  partition->degree_threshold = std::max(
+      control.min_dense_degree,
+      Int(control.dense_ratio * std::sqrt(double(num_rows))));
+  partition->max_dense_degree = 0;
+
+  Int num_dense = 0;
+  partition->sparse_index.Resize(num_rows);
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int row_beg = matrix.RowEntryOffset(row);
+    const Int row_end = matrix.RowEntryOffset(row + 1);
+    Int degree = row_end - row_beg;
+    for (Int index = row_beg; index < row_end; ++index) {
+      if (entries[index].column == row) {
+        --degree;
+        break;
+      }
+    }
+    if (control.defer_dense_rows && degree > partition->degree_threshold) {
+      partition->sparse_index[row] = -1;
+      partition->max_dense_degree =
+          std::max(partition->max_dense_degree, degree);
+      ++num_dense;
+    } else {
+      partition->sparse_index[row] = row - num_dense;
+    }
+  }
+
+  const Int num_sparse = num_rows - num_dense;
+  partition->sparse_rows.Resize(num_sparse);
+  partition->dense_rows.Resize(num_dense);
+  Int num_dense_so_far = 0;
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int sparse_index = partition->sparse_index[row];
+    if (sparse_index >= 0) {
+      partition->sparse_rows[sparse_index] = row;
+    } else {
+      partition->dense_rows[num_dense_so_far++] = row;
+    }
+  }
+
+  return num_dense > 0 && num_sparse > 0;
+}
+
+template <class Field>
+void SparseRowEntries(const CoordinateMatrix<Field>& matrix,
+                      const DenseRowPartition& partition,
+                      Buffer<MatrixEntry<Field>>* entries) {
+  const Buffer<Int>& sparse_index = partition.sparse_index;
+  Int num_sparse_entries = 0;
+  for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (sparse_index[entry.row] >= 0 && sparse_index[entry.column] >= 0) {
+      ++num_sparse_entries;
+    }
+  }
+
+  entries->Resize(num_sparse_entries);
+  Int index = 0;
+  for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (sparse_index[entry.row] >= 0 && sparse_index[entry.column] >= 0) {
+      MatrixEntry<Field>& sparse_entry = (*entries)[index++];
+      sparse_entry.row = sparse_index[entry.row];
+      sparse_entry.column = sparse_index[entry.column];
+      sparse_entry.value = entry.value;
+    }
+  }
+}
+
+template <class Field>
+void AppendDenseRows(const CoordinateMatrix<Field>& matrix,
+                     const DenseRowPartition& partition, bool supernodal,
+                     SymmetricOrdering* ordering) {
+  const Int num_rows = matrix.NumRows();
+  const Int num_sparse = partition.sparse_rows.Size();
+  const Int num_dense = partition.dense_rows.Size();
+
+  // The reordered positions of the sparse rows, which are only changed if the
+  // trees of the sparse forest must be rearranged.
+  Buffer<Int> sparse_inverse_permutation = ordering->inverse_permutation;
+
+  if (supernodal) {
+    const Int num_sparse_supernodes = ordering->supernode_sizes.Size();
+    const Buffer<Int>& parents = ordering->assembly_forest.parents;
+    Buffer<Int> supernode_offsets;
+    OffsetScan(ordering->supernode_sizes, &supernode_offsets);
+
+    // Find the root of the tree containing each supernode (since the forest
+    // is postordered, parents follow their children).
+    Buffer<Int> tree_roots(num_sparse_supernodes);
+    for (Int supernode = num_sparse_supernodes - 1; supernode >= 0;
+         --supernode) {
+      const Int parent = parents[supernode];
+      tree_roots[supernode] = parent >= 0 ? tree_roots[parent] : supernode;
+    }
+    Buffer<Int> member_to_supernode(num_sparse);
+    for (Int supernode = 0; supernode < num_sparse_supernodes; ++supernode) {
+      for (Int index = supernode_offsets[supernode];
+           index < supernode_offsets[supernode + 1]; ++index) {
+        member_to_supernode[index] = supernode;
+      }
+    }
+
+    // Mark the trees which contain a neighbor of a dense row.
+    Buffer<Int> coupled(num_sparse_supernodes, 0);
+    for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+      const Int row_index = partition.sparse_index[entry.row];
+      const Int column_index = partition.sparse_index[entry.column];
+      if ((row_index < 0) == (column_index < 0)) {
+        continue;
+      }
+      const Int sparse_row = row_index >= 0 ? row_index : column_index;
+      const Int supernode =
+          member_to_supernode[ordering->permutation[sparse_row]];
+      coupled[tree_roots[supernode]] = 1;
+    }
+
+    // Move the uncoupled trees ahead of the coupled ones, so that the subtree
+    // of the dense supernode is contiguous.
+    Buffer<Int> new_supernodes(num_sparse_supernodes);
+    Buffer<Int> new_supernode_sizes(num_sparse_supernodes + 1);
+    Int num_new_supernodes = 0;
+    Int num_new_rows = 0;
+    for (Int pass = 0; pass < 2; ++pass) {
+      Int tree_beg = 0;
+      for (Int root = 0; root < num_sparse_supernodes; ++root) {
+        if (parents[root] >= 0) {
+          continue;
+        }
+        if (coupled[root] == pass) {
+          for (Int supernode = tree_beg; supernode <= root; ++supernode) {
+            new_supernodes[supernode] = num_new_supernodes;
+            new_supernode_sizes[num_new_supernodes++] =
+                ordering->supernode_sizes[supernode];
+            for (Int index = supernode_offsets[supernode];
+                 index < supernode_offsets[supernode + 1]; ++index) {
+              sparse_inverse_permutation[num_new_rows++] =
+                  ordering->inverse_permutation[index];
+            }
+          }
+        }
+        tree_beg = root + 1;
+      }
+    }
+    new_supernode_sizes[num_sparse_supernodes] = num_dense;
+
+    Buffer<Int> new_parents(num_sparse_supernodes + 1);
+    for (Int supernode = 0; supernode < num_sparse_supernodes; ++supernode) {
+      const Int parent = parents[supernode];
+      Int new_parent;
+      if (parent >= 0) {
+        new_parent = new_supernodes[parent];
+      } else {
+        new_parent = coupled[supernode] ? num_sparse_supernodes : -1;
+      }
+      new_parents[new_supernodes[supernode]] = new_parent;
+    }
+    new_parents[num_sparse_supernodes] = -1;
+
+    ordering->supernode_sizes = new_supernode_sizes;
+    OffsetScan(ordering->supernode_sizes, &ordering->supernode_offsets);
+    ordering->assembly_forest.parents = new_parents;
+    ordering->assembly_forest.FillFromParents();
+  }
+
+  ordering->inverse_permutation.Resize(num_rows);
+  for (Int index = 0; index < num_sparse; ++index) {
+    ordering->inverse_permutation[index] =
+        partition.sparse_rows[sparse_inverse_permutation[index]];
+  }
+  for (Int index = 0; index < num_dense; ++index) {
+    ordering->inverse_permutation[num_sparse + index] =
+        partition.dense_rows[index];
+  }
+  InvertPermutation(ordering->inverse_permutation, &ordering->permutation);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DENSE_ROW_DEFERRAL_IMPL_H_
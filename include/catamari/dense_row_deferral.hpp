@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DENSE_ROW_DEFERRAL_H_
+#define CATAMARI_DENSE_ROW_DEFERRAL_H_
+
+#include "catamari/buffer.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+#include "catamari/symmetric_ordering.hpp"
+
+namespace catamari {
+
+// Configuration options for the detection of (nearly) dense rows, such as
+// constraint rows or Lagrange multipliers, which are removed from the graph
+// before the minimum degree reordering and then ordered last, as a single
+// root supernode, so that they neither distort the degrees of the remaining
+// vertices nor merge the rest of the assembly forest into one root front.
+struct DenseRowControl {
+  // Whether dense rows should be detected and deferred.
+  bool defer_dense_rows = true;
+
+  // A row is dense if its number of off-diagonal entries exceeds
+  // 'max(min_dense_degree, dense_ratio * sqrt(num_rows))', as in AMD.
+  double dense_ratio = 10;
+
+  // The minimum number of off-diagonal entries of a dense row.
+  Int min_dense_degree = 16;
+};
+
+// The split of the rows of a matrix into sparse and dense rows.
+struct DenseRowPartition {
+  // The index of each row amongst the sparse rows, or -1 for dense rows.
+  Buffer<Int> sparse_index;
+
+  // The original indices of the sparse rows, in increasing order.
+  Buffer<Int> sparse_rows;
+
+  // The original indices of the dense rows, in increasing order.
+  Buffer<Int> dense_rows;
+
+  // The number of off-diagonal entries above which a row is dense.
+  Int degree_threshold = 0;
+
+  // The largest number of off-diagonal entries of a dense row.
+  Int max_dense_degree = 0;
+};
+
+// Fills the partition of the rows of the matrix into dense and sparse rows and
+// returns true if there is at least one dense row and one sparse row (so that
+// the deferral is meaningful).
+template <class Field>
+bool DetectDenseRows(const CoordinateMatrix<Field>& matrix,
+                     const DenseRowControl& control,
+                     DenseRowPartition* partition);
+
+// Fills the entries of the submatrix of the sparse rows and columns, in terms
+// of the sparse indices (and in the same, sorted, order as the matrix).
+template <class Field>
+void SparseRowEntries(const CoordinateMatrix<Field>& matrix,
+                      const DenseRowPartition& partition,
+                      Buffer<MatrixEntry<Field>>* entries);
+
+// Converts a postordered reordering of the submatrix of the sparse rows into a
+// reordering of the full matrix which orders the dense rows last. If
+// 'supernodal' is true, the supernodal partition and assembly forest are
+// extended with a trailing supernode of the dense rows, which becomes the
+// parent of each tree of the sparse forest that is coupled to a dense row;
+// the uncoupled trees are moved first so that every subtree remains
+// contiguous.
+template <class Field>
+void AppendDenseRows(const CoordinateMatrix<Field>& matrix,
+                     const DenseRowPartition& partition, bool supernodal,
+                     SymmetricOrdering* ordering);
+
+}  // namespace catamari
+
+#include "catamari/dense_row_deferral-impl.hpp"
+
+#endif  // ifndef CATAMARI_DENSE_ROW_DEFERRAL_H_
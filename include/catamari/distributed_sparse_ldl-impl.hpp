@@ -0,0 +1,1219 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DISTRIBUTED_SPARSE_LDL_IMPL_H_
+#define CATAMARI_DISTRIBUTED_SPARSE_LDL_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/distributed_sparse_ldl.hpp"
+#include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
+
+namespace catamari {
+namespace distributed_ldl {
+
+// The MPI datatype of the real components of the entries of a field.
+template <class Real>
+inline MPI_Datatype RealMPIType();
+
+template <>
+inline MPI_Datatype RealMPIType<float>() {
+  return MPI_FLOAT;
+}
+
+template <>
+inline MPI_Datatype RealMPIType<double>() {
+  return MPI_DOUBLE;
+}
+
+// The MPI datatype of 'Int'.
+inline MPI_Datatype IntMPIType() {
+  return sizeof(Int) == 8 ? MPI_INT64_T : MPI_INT32_T;
+}
+
+// Returns the number of real components communicated for 'size' entries.
+template <class Field>
+inline int NumComponents(Int size) {
+  return int(size * (IsComplex<Field>::value ? 2 : 1));
+}
+
+// Sums the given entries over the processes of the communicator.
+template <class Field>
+void SumAll(Field* values, Int size, MPI_Comm comm) {
+  if (!size) return;
+  MPI_Allreduce(MPI_IN_PLACE, values, NumComponents<Field>(size),
+                RealMPIType<ComplexBase<Field>>(), MPI_SUM, comm);
+}
+
+// Sums the given entries onto the root process of the communicator.
+template <class Field>
+void SumToRoot(Field* values, Int size, int root, MPI_Comm comm) {
+  if (!size) return;
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Reduce(rank == root ? MPI_IN_PLACE : values, values,
+             NumComponents<Field>(size), RealMPIType<ComplexBase<Field>>(),
+             MPI_SUM, root, comm);
+}
+
+// Broadcasts the given entries from the root process of the communicator.
+template <class Field>
+void Broadcast(Field* values, Int size, int root, MPI_Comm comm) {
+  if (!size) return;
+  MPI_Bcast(values, NumComponents<Field>(size),
+            RealMPIType<ComplexBase<Field>>(), root, comm);
+}
+
+// An entry of a child's Schur complement, sent to the owner of its position
+// in the parent front.
+template <class Field>
+struct FrontEntry {
+  Int row;
+  Int column;
+  Field value;
+};
+
+// Fills the indices in [0, size) whose blocks, of the given size, are
+// congruent to 'shift' modulo 'stride'.
+inline void OwnedIndices(Int size, Int block_size, int stride, int shift,
+                         Buffer<Int>* indices) {
+  Int num_owned = 0;
+  for (Int start = shift * block_size; start < size;
+       start += stride * block_size) {
+    num_owned += std::min(block_size, size - start);
+  }
+  indices->Resize(num_owned);
+  Int offset = 0;
+  for (Int start = shift * block_size; start < size;
+       start += stride * block_size) {
+    const Int end = std::min(start + block_size, size);
+    for (Int index = start; index < end; ++index) {
+      (*indices)[offset++] = index;
+    }
+  }
+}
+
+// Returns the height of the most square process grid with the given number
+// of processes.
+inline int GridHeight(int num_ranks) {
+  int grid_height = 1;
+  for (int height = 1; height * height <= num_ranks; ++height) {
+    if (num_ranks % height == 0) grid_height = height;
+  }
+  return grid_height;
+}
+
+template <class Field>
+Int DistributedFront<Field>::LocalRowOffset(Int index) const {
+  return std::lower_bound(local_rows.Data(),
+                          local_rows.Data() + local_rows.Size(), index) -
+         local_rows.Data();
+}
+
+template <class Field>
+Int DistributedFront<Field>::LocalColumnOffset(Int index) const {
+  return std::lower_bound(local_columns.Data(),
+                          local_columns.Data() + local_columns.Size(),
+                          index) -
+         local_columns.Data();
+}
+
+// Appends the node of the given subgraph (and, recursively, its descendants)
+// to the tree and returns its index.
+inline Int FormTreeRecursion(const nested_dissection::Graph& graph,
+                             int first_rank, int num_ranks, Int parent,
+                             const NestedDissectionControl& nd_control,
+                             Int min_distributed_size,
+                             std::vector<TreeNode>* tree) {
+  const Int index = tree->size();
+  tree->emplace_back();
+  (*tree)[index].parent = parent;
+  (*tree)[index].first_rank = first_rank;
+  (*tree)[index].num_ranks = num_ranks;
+
+  const Int num_vertices = graph.NumVertices();
+  Buffer<Int> parts;
+  bool split = false;
+  if (num_ranks > 1 && num_vertices > min_distributed_size) {
+    Buffer<Int> components;
+    const Int num_components =
+        nested_dissection::ConnectedComponents(graph, &components);
+    if (num_components > 1) {
+      // Deal the components, largest first, to the lighter half, which
+      // requires no separator.
+      Buffer<Int> component_sizes(num_components, 0);
+      for (Int i = 0; i < num_vertices; ++i) {
+        ++component_sizes[components[i]];
+      }
+      Buffer<Int> order(num_components);
+      for (Int c = 0; c < num_components; ++c) order[c] = c;
+      std::sort(order.begin(), order.end(), [&](Int a, Int b) {
+        return component_sizes[a] > component_sizes[b] ||
+               (component_sizes[a] == component_sizes[b] && a < b);
+      });
+      Buffer<Int> component_parts(num_components);
+      Int half_sizes[2] = {0, 0};
+      for (const Int& component : order) {
+        const Int part = half_sizes[1] < half_sizes[0] ? 1 : 0;
+        component_parts[component] = part;
+        half_sizes[part] += component_sizes[component];
+      }
+      parts.Resize(num_vertices);
+      for (Int i = 0; i < num_vertices; ++i) {
+        parts[i] = component_parts[components[i]];
+      }
+      split = true;
+    } else {
+      split = nested_dissection::Bisect(graph, nd_control, &parts);
+    }
+  }
+  if (!split) {
+    (*tree)[index].vertices = graph.vertices;
+    return index;
+  }
+
+  Int num_separator = 0;
+  for (Int i = 0; i < num_vertices; ++i) {
+    if (parts[i] < 0) ++num_separator;
+  }
+  Buffer<Int> separator(num_separator);
+  num_separator = 0;
+  for (Int i = 0; i < num_vertices; ++i) {
+    if (parts[i] < 0) separator[num_separator++] = graph.vertices[i];
+  }
+  (*tree)[index].vertices = std::move(separator);
+
+  // The larger half is mapped to the larger share of the processes.
+  Buffer<nested_dissection::Graph> subgraphs;
+  nested_dissection::SplitGraph(graph, parts, 2, &subgraphs);
+  const Int larger =
+      subgraphs[0].NumVertices() >= subgraphs[1].NumVertices() ? 0 : 1;
+  const int larger_ranks = (num_ranks + 1) / 2;
+  Buffer<Int> children(2);
+  children[0] = FormTreeRecursion(subgraphs[larger], first_rank, larger_ranks,
+                                  index, nd_control, min_distributed_size,
+                                  tree);
+  children[1] = FormTreeRecursion(
+      subgraphs[1 - larger], first_rank + larger_ranks,
+      num_ranks - larger_ranks, index, nd_control, min_distributed_size, tree);
+  (*tree)[index].children = std::move(children);
+  return index;
+}
+
+// Fills the boundary of each node: the vertices of its ancestors coupled to
+// its subtree (including fill), sorted by elimination position.
+inline void FillBoundaries(const nested_dissection::Graph& graph,
+                           std::vector<TreeNode>* tree) {
+  const Int num_vertices = graph.NumVertices();
+  const Int num_nodes = tree->size();
+
+  // Assign elimination positions in a postorder of the tree, recording the
+  // end of the positions of each subtree.
+  Buffer<Int> position(num_vertices);
+  Buffer<Int> subtree_end(num_nodes);
+  std::vector<Int> postorder;
+  postorder.reserve(num_nodes);
+  std::vector<std::pair<Int, bool>> stack(1, std::make_pair(Int(0), false));
+  while (!stack.empty()) {
+    const std::pair<Int, bool> item = stack.back();
+    stack.pop_back();
+    if (item.second) {
+      postorder.push_back(item.first);
+      continue;
+    }
+    stack.emplace_back(item.first, true);
+    const Buffer<Int>& children = (*tree)[item.first].children;
+    for (Int index = children.Size() - 1; index >= 0; --index) {
+      stack.emplace_back(children[index], false);
+    }
+  }
+  Int offset = 0;
+  for (const Int& node : postorder) {
+    for (const Int& vertex : (*tree)[node].vertices) {
+      position[vertex] = offset++;
+    }
+    subtree_end[node] = offset;
+  }
+
+  Buffer<Int> marks(num_vertices, -1);
+  for (const Int& node : postorder) {
+    TreeNode& tree_node = (*tree)[node];
+    std::vector<Int> boundary;
+    auto add = [&](Int vertex) {
+      if (position[vertex] >= subtree_end[node] && marks[vertex] != node) {
+        marks[vertex] = node;
+        boundary.push_back(vertex);
+      }
+    };
+    for (const Int& child : tree_node.children) {
+      for (const Int& vertex : (*tree)[child].boundary) add(vertex);
+    }
+    for (const Int& vertex : tree_node.vertices) {
+      for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+           ++index) {
+        add(graph.neighbors[index]);
+      }
+    }
+    std::sort(boundary.begin(), boundary.end(), [&](Int a, Int b) {
+      return position[a] < position[b];
+    });
+    tree_node.boundary.Resize(boundary.size());
+    std::copy(boundary.begin(), boundary.end(), tree_node.boundary.begin());
+  }
+}
+
+// Appends a buffer, preceded by its length, to a serialization.
+inline void PackBuffer(const Buffer<Int>& buffer, std::vector<Int>* packed) {
+  packed->push_back(buffer.Size());
+  packed->insert(packed->end(), buffer.begin(), buffer.end());
+}
+
+// Reads a buffer, preceded by its length, from a serialization.
+inline void UnpackBuffer(const std::vector<Int>& packed, std::size_t* offset,
+                         Buffer<Int>* buffer) {
+  const Int size = packed[(*offset)++];
+  buffer->Resize(size);
+  std::copy(packed.begin() + *offset, packed.begin() + *offset + size,
+            buffer->begin());
+  *offset += size;
+}
+
+}  // namespace distributed_ldl
+
+template <class Field>
+DistributedSparseLDL<Field>::DistributedSparseLDL(MPI_Comm comm) {
+  MPI_Comm_dup(comm, &comm_);
+  MPI_Comm_rank(comm_, &rank_);
+  MPI_Comm_size(comm_, &num_ranks_);
+}
+
+template <class Field>
+DistributedSparseLDL<Field>::~DistributedSparseLDL() {
+  FreeCommunicators();
+  if (comm_ != MPI_COMM_NULL) MPI_Comm_free(&comm_);
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::FreeCommunicators() {
+  for (distributed_ldl::DistributedFront<Field>& front : fronts_) {
+    MPI_Comm_free(&front.row_comm);
+    MPI_Comm_free(&front.column_comm);
+    MPI_Comm_free(&front.comm);
+  }
+  fronts_.clear();
+}
+
+template <class Field>
+Int DistributedSparseLDL<Field>::NumRows() const {
+  return num_rows_;
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::FormTree(
+    const CoordinateMatrix<Field>& matrix,
+    const DistributedSparseLDLControl<Field>& control) {
+  // The bisections are computed once, on the root process, so that every
+  // process agrees on the tree.
+  std::vector<Int> packed;
+  if (rank_ == 0) {
+    nested_dissection::Graph graph;
+    nested_dissection::MatrixGraph(matrix, &graph);
+    std::vector<distributed_ldl::TreeNode> tree;
+    distributed_ldl::FormTreeRecursion(graph, 0, num_ranks_, -1,
+                                       control.nd_control,
+                                       control.min_distributed_size, &tree);
+    distributed_ldl::FillBoundaries(graph, &tree);
+
+    packed.push_back(tree.size());
+    for (const distributed_ldl::TreeNode& node : tree) {
+      packed.push_back(node.parent);
+      packed.push_back(node.first_rank);
+      packed.push_back(node.num_ranks);
+      distributed_ldl::PackBuffer(node.children, &packed);
+      distributed_ldl::PackBuffer(node.vertices, &packed);
+      distributed_ldl::PackBuffer(node.boundary, &packed);
+    }
+  }
+
+  Int packed_size = packed.size();
+  MPI_Bcast(&packed_size, 1, distributed_ldl::IntMPIType(), 0, comm_);
+  packed.resize(packed_size);
+  MPI_Bcast(packed.data(), int(packed_size), distributed_ldl::IntMPIType(), 0,
+            comm_);
+
+  std::size_t offset = 0;
+  tree_.resize(packed[offset++]);
+  for (distributed_ldl::TreeNode& node : tree_) {
+    node.parent = packed[offset++];
+    node.first_rank = packed[offset++];
+    node.num_ranks = packed[offset++];
+    distributed_ldl::UnpackBuffer(packed, &offset, &node.children);
+    distributed_ldl::UnpackBuffer(packed, &offset, &node.vertices);
+    distributed_ldl::UnpackBuffer(packed, &offset, &node.boundary);
+  }
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::FormFronts(
+    const DistributedSparseLDLControl<Field>& control) {
+  // Walk down from the root to the leaf containing this process, splitting
+  // the communicator of each internal node between its children.
+  std::vector<Int> downward;
+  MPI_Comm node_comm;
+  MPI_Comm_dup(comm_, &node_comm);
+  Int node = 0;
+  while (true) {
+    const distributed_ldl::TreeNode& tree_node = tree_[node];
+    if (tree_node.children.Empty()) {
+      if (rank_ == tree_node.first_rank) leaf_ = node;
+      MPI_Comm_free(&node_comm);
+      break;
+    }
+
+    distributed_ldl::DistributedFront<Field> front;
+    front.comm = node_comm;
+    const int group_rank = rank_ - tree_node.first_rank;
+    front.grid_height = distributed_ldl::GridHeight(tree_node.num_ranks);
+    front.grid_width = tree_node.num_ranks / front.grid_height;
+    front.grid_row = group_rank % front.grid_height;
+    front.grid_column = group_rank / front.grid_height;
+    MPI_Comm_split(node_comm, front.grid_row, front.grid_column,
+                   &front.row_comm);
+    MPI_Comm_split(node_comm, front.grid_column, front.grid_row,
+                   &front.column_comm);
+
+    front.block_size = control.block_size;
+    front.num_pivots = tree_node.vertices.Size();
+    front.size = front.num_pivots + tree_node.boundary.Size();
+    front.indices.Resize(front.size);
+    std::copy(tree_node.vertices.begin(), tree_node.vertices.end(),
+              front.indices.begin());
+    std::copy(tree_node.boundary.begin(), tree_node.boundary.end(),
+              front.indices.begin() + front.num_pivots);
+    distributed_ldl::OwnedIndices(front.size, front.block_size,
+                                  front.grid_height, front.grid_row,
+                                  &front.local_rows);
+    distributed_ldl::OwnedIndices(front.size, front.block_size,
+                                  front.grid_width, front.grid_column,
+                                  &front.local_columns);
+    downward.push_back(node);
+    fronts_.push_back(std::move(front));
+
+    Int child = -1;
+    for (const Int& candidate : tree_node.children) {
+      const distributed_ldl::TreeNode& child_node = tree_[candidate];
+      if (rank_ >= child_node.first_rank &&
+          rank_ < child_node.first_rank + child_node.num_ranks) {
+        child = candidate;
+      }
+    }
+    MPI_Comm child_comm;
+    MPI_Comm_split(node_comm, int(child), rank_, &child_comm);
+    node_comm = child_comm;
+    node = child;
+  }
+
+  // The fronts are stored from the bottom up.
+  std::reverse(downward.begin(), downward.end());
+  std::reverse(fronts_.begin(), fronts_.end());
+  path_.Resize(downward.size());
+  std::copy(downward.begin(), downward.end(), path_.begin());
+}
+
+template <class Field>
+SparseLDLResult<Field> DistributedSparseLDL<Field>::FactorLeaf(
+    const CoordinateMatrix<Field>& matrix,
+    const DistributedSparseLDLControl<Field>& control,
+    BlasMatrix<Field>* schur_complement) {
+  const distributed_ldl::TreeNode& node = tree_[leaf_];
+  const Int num_interior = node.vertices.Size();
+  const Int num_boundary = node.boundary.Size();
+  const Int num_local_rows = num_interior + num_boundary;
+
+  // Map the vertices of the leaf, followed by its boundary, to local indices.
+  Buffer<Int> local_index(num_rows_, -1);
+  Buffer<Int> original_index(num_local_rows);
+  for (Int i = 0; i < num_interior; ++i) {
+    local_index[node.vertices[i]] = i;
+    original_index[i] = node.vertices[i];
+  }
+  for (Int i = 0; i < num_boundary; ++i) {
+    local_index[node.boundary[i]] = num_interior + i;
+    original_index[num_interior + i] = node.boundary[i];
+  }
+
+  // Gather the entries coupled to the interior; those between two boundary
+  // vertices belong to the ancestors.
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  CoordinateMatrix<Field> local_matrix, interior_matrix;
+  local_matrix.Resize(num_local_rows, num_local_rows);
+  interior_matrix.Resize(num_interior, num_interior);
+  for (Int local_row = 0; local_row < num_local_rows; ++local_row) {
+    const Int row = original_index[local_row];
+    const Int row_beg = matrix.RowEntryOffset(row);
+    const Int row_end = matrix.RowEntryOffset(row + 1);
+    for (Int index = row_beg; index < row_end; ++index) {
+      const Int local_column = local_index[entries[index].column];
+      if (local_column < 0 ||
+          (local_row >= num_interior && local_column >= num_interior)) {
+        continue;
+      }
+      local_matrix.QueueEntryAddition(local_row, local_column,
+                                      entries[index].value);
+      if (local_row < num_interior && local_column < num_interior) {
+        interior_matrix.QueueEntryAddition(local_row, local_column,
+                                           entries[index].value);
+      }
+    }
+  }
+  local_matrix.FlushEntryQueues();
+  interior_matrix.FlushEntryQueues();
+
+  // Reorder the interior by nested dissection while keeping the interface
+  // rows trailing.
+  SymmetricOrdering interior_ordering;
+  if (num_interior) {
+    NestedDissection(interior_matrix, control.nd_control, &interior_ordering);
+  }
+  SymmetricOrdering ordering;
+  ordering.permutation.Resize(num_local_rows);
+  ordering.inverse_permutation.Resize(num_local_rows);
+  for (Int i = 0; i < num_local_rows; ++i) {
+    const bool permuted =
+        i < num_interior && !interior_ordering.permutation.Empty();
+    ordering.permutation[i] = permuted ? interior_ordering.permutation[i] : i;
+    ordering.inverse_permutation[i] =
+        permuted ? interior_ordering.inverse_permutation[i] : i;
+  }
+
+  SparseLDLControl<Field> ldl_control = control.ldl_control;
+  ldl_control.supernodal_strategy = kSupernodalFactorization;
+  SparseLDLResult<Field> result = leaf_ldl_.FactorPartial(
+      local_matrix, ordering, num_interior, ldl_control,
+      num_boundary ? schur_complement : nullptr);
+  return result;
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::AssembleFront(
+    const CoordinateMatrix<Field>& matrix, Int path_index) {
+  distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+  const Int num_local_rows = front.local_rows.Size();
+  const Int num_local_columns = front.local_columns.Size();
+  front.values.Resize(num_local_rows, num_local_columns, Field{0});
+
+  Buffer<Int> front_index(num_rows_, -1);
+  for (Int i = 0; i < front.size; ++i) {
+    front_index[front.indices[i]] = i;
+  }
+  Buffer<Int> local_column_index(front.size, -1);
+  for (Int j = 0; j < num_local_columns; ++j) {
+    local_column_index[front.local_columns[j]] = j;
+  }
+
+  // Add the lower-triangular entries whose columns are eliminated by the
+  // front.
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  for (Int local_row = 0; local_row < num_local_rows; ++local_row) {
+    const Int front_row = front.local_rows[local_row];
+    const Int row = front.indices[front_row];
+    const Int row_beg = matrix.RowEntryOffset(row);
+    const Int row_end = matrix.RowEntryOffset(row + 1);
+    for (Int index = row_beg; index < row_end; ++index) {
+      const Int front_column = front_index[entries[index].column];
+      if (front_column < 0 || front_column > front_row ||
+          front_column >= front.num_pivots) {
+        continue;
+      }
+      const Int local_column = local_column_index[front_column];
+      if (local_column >= 0) {
+        front.values(local_row, local_column) += entries[index].value;
+      }
+    }
+  }
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::ExtendAdd(
+    Int path_index, const BlasMatrix<Field>& leaf_schur_complement) {
+  typedef distributed_ldl::FrontEntry<Field> FrontEntry;
+  distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+  const distributed_ldl::TreeNode& node = tree_[path_[path_index]];
+
+  // Map the boundary of the child containing this process into the front.
+  Int child = -1;
+  for (const Int& candidate : node.children) {
+    const distributed_ldl::TreeNode& child_node = tree_[candidate];
+    if (rank_ >= child_node.first_rank &&
+        rank_ < child_node.first_rank + child_node.num_ranks) {
+      child = candidate;
+    }
+  }
+  const Buffer<Int>& child_boundary = tree_[child].boundary;
+  Buffer<Int> front_index(num_rows_, -1);
+  for (Int i = 0; i < front.size; ++i) {
+    front_index[front.indices[i]] = i;
+  }
+  Buffer<Int> relative_indices(child_boundary.Size());
+  for (Int i = 0; i < Int(child_boundary.Size()); ++i) {
+    relative_indices[i] = front_index[child_boundary[i]];
+  }
+
+  // Bucket the locally-owned lower-triangular entries of the child's Schur
+  // complement by their owners in the front.
+  const int num_ranks = node.num_ranks;
+  std::vector<std::vector<FrontEntry>> sends(num_ranks);
+  auto queue = [&](Int i, Int j, const Field& value) {
+    const Int row = relative_indices[i];
+    const Int column = relative_indices[j];
+    const int owner =
+        front.RowOwner(row) + front.ColumnOwner(column) * front.grid_height;
+    sends[owner].push_back(FrontEntry{row, column, value});
+  };
+  if (path_index == 0) {
+    if (leaf_ == child) {
+      const Int size = leaf_schur_complement.Height();
+      for (Int j = 0; j < size; ++j) {
+        for (Int i = j; i < size; ++i) {
+          queue(i, j, leaf_schur_complement(i, j));
+        }
+      }
+    }
+  } else {
+    distributed_ldl::DistributedFront<Field>& child_front =
+        fronts_[path_index - 1];
+    const Int num_pivots = child_front.num_pivots;
+    const Int row_beg = child_front.LocalRowOffset(num_pivots);
+    const Int column_beg = child_front.LocalColumnOffset(num_pivots);
+    for (Int local_column = column_beg;
+         local_column < Int(child_front.local_columns.Size());
+         ++local_column) {
+      const Int column = child_front.local_columns[local_column];
+      for (Int local_row = std::max(row_beg, child_front.LocalRowOffset(column));
+           local_row < Int(child_front.local_rows.Size()); ++local_row) {
+        queue(child_front.local_rows[local_row] - num_pivots,
+              column - num_pivots,
+              child_front.values(local_row, local_column));
+      }
+    }
+
+    // Only the eliminated columns of the child are needed from now on.
+    BlasMatrix<Field> eliminated(child_front.values.Submatrix(
+        0, 0, child_front.values.Height(), column_beg));
+    child_front.values = eliminated;
+  }
+
+  // Exchange the entries.
+  std::vector<int> send_counts(num_ranks), send_displs(num_ranks);
+  std::vector<int> recv_counts(num_ranks), recv_displs(num_ranks);
+  int total_send = 0;
+  for (int rank = 0; rank < num_ranks; ++rank) {
+    send_counts[rank] = sends[rank].size() * sizeof(FrontEntry);
+    send_displs[rank] = total_send;
+    total_send += send_counts[rank];
+  }
+  MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+               front.comm);
+  int total_recv = 0;
+  for (int rank = 0; rank < num_ranks; ++rank) {
+    recv_displs[rank] = total_recv;
+    total_recv += recv_counts[rank];
+  }
+  std::vector<FrontEntry> send_buffer, recv_buffer(total_recv /
+                                                   sizeof(FrontEntry));
+  send_buffer.reserve(total_send / sizeof(FrontEntry));
+  for (const std::vector<FrontEntry>& bucket : sends) {
+    send_buffer.insert(send_buffer.end(), bucket.begin(), bucket.end());
+  }
+  MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displs.data(),
+                MPI_BYTE, recv_buffer.data(), recv_counts.data(),
+                recv_displs.data(), MPI_BYTE, front.comm);
+
+  for (const FrontEntry& entry : recv_buffer) {
+    front.values(front.LocalRowOffset(entry.row),
+                 front.LocalColumnOffset(entry.column)) += entry.value;
+  }
+}
+
+template <class Field>
+Int DistributedSparseLDL<Field>::FactorFront(Int path_index,
+                                             Int inner_block_size) {
+  distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+  const Int block_size = front.block_size;
+  const Int size = front.size;
+  const Int num_pivots = front.num_pivots;
+  const Int num_local_rows = front.local_rows.Size();
+  const Int num_local_columns = front.local_columns.Size();
+  const bool is_cholesky = factorization_type_ == kCholeskyFactorization;
+  const bool is_transpose = factorization_type_ == kLDLTransposeFactorization;
+  front.pivots.Resize(num_pivots, Field{1});
+
+  DynamicRegularizationParams<Field> dynamic_reg_params;
+  std::vector<std::pair<Int, Real>> dynamic_regularization;
+  BlasMatrix<Field> diagonal, panel, row_panel, column_panel;
+  Buffer<Field> diagonal_pivots, packed_panel;
+  for (Int start = 0; start < num_pivots; start += block_size) {
+    const Int end = std::min(start + block_size, num_pivots);
+    const Int width = end - start;
+    const int owner_row = front.RowOwner(start);
+    const int owner_column = front.ColumnOwner(start);
+    const int owner = owner_row + owner_column * front.grid_height;
+    const Int row_start = front.LocalRowOffset(start);
+    const Int column_start = front.LocalColumnOffset(start);
+    const Int row_end = front.LocalRowOffset(end);
+    const Int column_end = front.LocalColumnOffset(end);
+
+    // Factor the diagonal block on its owner.
+    diagonal.Resize(width, width);
+    Int num_block_pivots = width;
+    if (front.grid_row == owner_row && front.grid_column == owner_column) {
+      BlasMatrixView<Field> block =
+          front.values.Submatrix(row_start, column_start, width, width);
+      num_block_pivots = supernodal_ldl::FactorDiagonalBlock(
+          inner_block_size, factorization_type_, dynamic_reg_params, &block,
+          &dynamic_regularization);
+      diagonal = block;
+    }
+    MPI_Bcast(&num_block_pivots, 1, distributed_ldl::IntMPIType(), owner,
+              front.comm);
+    if (num_block_pivots < width) {
+      return start + num_block_pivots;
+    }
+
+    // Solve the panel against the diagonal block within the owning process
+    // column and gather it there.
+    const Int panel_height = size - end;
+    panel.Resize(panel_height, width);
+    diagonal_pivots.Resize(width);
+    if (front.grid_column == owner_column) {
+      distributed_ldl::Broadcast(diagonal.data.Data(), width * width,
+                                 owner_row, front.column_comm);
+      for (Int i = 0; i < width; ++i) {
+        diagonal_pivots[i] = is_cholesky ? Field{1} : diagonal(i, i);
+      }
+
+      const Int num_panel_rows = num_local_rows - row_end;
+      BlasMatrixView<Field> local_panel = front.values.Submatrix(
+          row_end, column_start, num_panel_rows, width);
+      if (num_panel_rows) {
+        supernodal_ldl::SolveAgainstDiagonalBlock(
+            factorization_type_, diagonal.ConstView(), &local_panel);
+      }
+
+      std::vector<int> counts(front.grid_height), displs(front.grid_height);
+      std::vector<Buffer<Int>> panel_rows(front.grid_height);
+      int total = 0;
+      for (int grid_row = 0; grid_row < front.grid_height; ++grid_row) {
+        distributed_ldl::OwnedIndices(size, block_size, front.grid_height,
+                                      grid_row, &panel_rows[grid_row]);
+        Buffer<Int>& rows = panel_rows[grid_row];
+        const Int first = std::lower_bound(rows.begin(), rows.end(), end) -
+                          rows.begin();
+        Buffer<Int> trailing(rows.Size() - first);
+        std::copy(rows.begin() + first, rows.end(), trailing.begin());
+        rows = std::move(trailing);
+        counts[grid_row] =
+            distributed_ldl::NumComponents<Field>(rows.Size() * width);
+        displs[grid_row] = total;
+        total += counts[grid_row];
+      }
+      Buffer<Field> local_packed(num_panel_rows * width);
+      for (Int j = 0; j < width; ++j) {
+        for (Int i = 0; i < num_panel_rows; ++i) {
+          local_packed[i + j * num_panel_rows] = local_panel(i, j);
+        }
+      }
+      packed_panel.Resize(panel_height * width);
+      MPI_Allgatherv(local_packed.Data(), counts[front.grid_row],
+                     distributed_ldl::RealMPIType<Real>(), packed_panel.Data(),
+                     counts.data(), displs.data(),
+                     distributed_ldl::RealMPIType<Real>(), front.column_comm);
+      Int offset = 0;
+      for (int grid_row = 0; grid_row < front.grid_height; ++grid_row) {
+        const Buffer<Int>& rows = panel_rows[grid_row];
+        const Int num_rows = rows.Size();
+        for (Int j = 0; j < width; ++j) {
+          for (Int i = 0; i < num_rows; ++i) {
+            panel(rows[i] - end, j) = packed_panel[offset + i + j * num_rows];
+          }
+        }
+        offset += num_rows * width;
+      }
+    }
+
+    // Broadcast the panel and its pivots along the process rows.
+    distributed_ldl::Broadcast(panel.data.Data(), panel_height * width,
+                               owner_column, front.row_comm);
+    distributed_ldl::Broadcast(diagonal_pivots.Data(), width, owner_column,
+                               front.row_comm);
+    for (Int i = 0; i < width; ++i) {
+      front.pivots[start + i] = diagonal_pivots[i];
+    }
+
+    // Update the locally-owned trailing entries,
+    //   A(i, j) -= L(i, K) D(K) L(j, K)^{H,T}, for i >= j >= end,
+    // one lower-trapezoidal column block at a time.
+    const Int num_trailing_rows = num_local_rows - row_end;
+    const Int num_trailing_columns = num_local_columns - column_end;
+    if (!num_trailing_rows || !num_trailing_columns) continue;
+    row_panel.Resize(num_trailing_rows, width);
+    column_panel.Resize(num_trailing_columns, width);
+    for (Int j = 0; j < width; ++j) {
+      for (Int i = 0; i < num_trailing_rows; ++i) {
+        row_panel(i, j) = panel(front.local_rows[row_end + i] - end, j);
+      }
+      for (Int i = 0; i < num_trailing_columns; ++i) {
+        column_panel(i, j) =
+            panel(front.local_columns[column_end + i] - end, j) *
+            diagonal_pivots[j];
+      }
+    }
+    for (Int column_beg = column_end; column_beg < num_local_columns;) {
+      const Int block = front.local_columns[column_beg] / block_size;
+      Int column_stop = column_beg;
+      while (column_stop < num_local_columns &&
+             front.local_columns[column_stop] / block_size == block) {
+        ++column_stop;
+      }
+      const Int row_beg =
+          front.LocalRowOffset(front.local_columns[column_beg]);
+      if (row_beg < num_local_rows) {
+        const ConstBlasMatrixView<Field> left = row_panel.Submatrix(
+            row_beg - row_end, 0, num_local_rows - row_beg, width);
+        const ConstBlasMatrixView<Field> right = column_panel.Submatrix(
+            column_beg - column_end, 0, column_stop - column_beg, width);
+        BlasMatrixView<Field> output =
+            front.values.Submatrix(row_beg, column_beg, num_local_rows - row_beg,
+                                   column_stop - column_beg);
+        if (is_transpose) {
+          MatrixMultiplyNormalTranspose(Field{-1}, left, right, Field{1},
+                                        &output);
+        } else {
+          MatrixMultiplyNormalAdjoint(Field{-1}, left, right, Field{1},
+                                      &output);
+        }
+      }
+      column_beg = column_stop;
+    }
+  }
+  return num_pivots;
+}
+
+template <class Field>
+SparseLDLResult<Field> DistributedSparseLDL<Field>::Factor(
+    const CoordinateMatrix<Field>& matrix,
+    const DistributedSparseLDLControl<Field>& control) {
+  const supernodal_ldl::Control<Field>& supernodal_control =
+      control.ldl_control.supernodal_control;
+  if (supernodal_control.supernodal_pivoting) {
+    throw std::runtime_error(
+        "Pivoting is not supported by the distributed factorization.");
+  }
+  if (supernodal_control.dynamic_regularization.enabled) {
+    throw std::runtime_error(
+        "Dynamic regularization is not supported by the distributed "
+        "factorization.");
+  }
+
+  FreeCommunicators();
+  tree_.clear();
+  path_.Clear();
+  leaf_ = -1;
+  num_rows_ = matrix.NumRows();
+  factorization_type_ = supernodal_control.factorization_type;
+  FormTree(matrix, control);
+  FormFronts(control);
+
+  // Factor the subtree of this process.
+  SparseLDLResult<Field> result;
+  BlasMatrix<Field> leaf_schur_complement;
+  Int num_successful_pivots = 0;
+  double num_factorization_entries = 0;
+  bool failed = false;
+  if (leaf_ >= 0) {
+    result = FactorLeaf(matrix, control, &leaf_schur_complement);
+    num_successful_pivots = result.num_successful_pivots;
+    num_factorization_entries = result.num_factorization_entries;
+    failed = num_successful_pivots < Int(tree_[leaf_].vertices.Size());
+  }
+
+  // Assemble and factor the shared fronts from the bottom up.
+  const double flop_scale = IsComplex<Field>::value ? 4. : 1.;
+  for (Int path_index = 0; path_index < Int(path_.Size()); ++path_index) {
+    distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+    int any_failed = failed;
+    MPI_Allreduce(MPI_IN_PLACE, &any_failed, 1, MPI_INT, MPI_LOR, front.comm);
+    if (any_failed) {
+      failed = true;
+      continue;
+    }
+
+    AssembleFront(matrix, path_index);
+    ExtendAdd(path_index, leaf_schur_complement);
+    const Int num_front_pivots =
+        FactorFront(path_index, supernodal_control.block_size);
+    failed = num_front_pivots < front.num_pivots;
+
+    const double num_pivots = front.num_pivots;
+    const double degree = front.size - front.num_pivots;
+    result.largest_supernode =
+        std::max(result.largest_supernode, front.num_pivots);
+    if (rank_ == tree_[path_[path_index]].first_rank) {
+      num_successful_pivots += num_front_pivots;
+      num_factorization_entries +=
+          num_pivots * (num_pivots + 1) / 2 + num_pivots * degree;
+      result.num_factorization_flops +=
+          flop_scale * (std::pow(num_pivots, 3.) / 3 +
+                        std::pow(num_pivots, 2.) * degree +
+                        num_pivots * std::pow(degree, 2.));
+    }
+  }
+  // Every process returns the combined statistics.
+  Int largest_supernode = result.largest_supernode;
+  double flops = result.num_factorization_flops;
+  MPI_Allreduce(MPI_IN_PLACE, &num_successful_pivots, 1,
+                distributed_ldl::IntMPIType(), MPI_SUM, comm_);
+  MPI_Allreduce(MPI_IN_PLACE, &num_factorization_entries, 1, MPI_DOUBLE,
+                MPI_SUM, comm_);
+  MPI_Allreduce(MPI_IN_PLACE, &flops, 1, MPI_DOUBLE, MPI_SUM, comm_);
+  MPI_Allreduce(MPI_IN_PLACE, &largest_supernode, 1,
+                distributed_ldl::IntMPIType(), MPI_MAX, comm_);
+  SparseLDLResult<Field> combined;
+  combined.num_successful_pivots = num_successful_pivots;
+  combined.num_factorization_entries = Int(num_factorization_entries);
+  combined.num_factorization_flops = flops;
+  combined.largest_supernode = largest_supernode;
+  return combined;
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::FrontForwardSolve(
+    Int path_index, BlasMatrix<Field>* right_hand_sides,
+    BlasMatrix<Field>* boundary_update) const {
+  const distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+  const Int block_size = front.block_size;
+  const Int num_pivots = front.num_pivots;
+  const Int num_local_rows = front.local_rows.Size();
+  const Int num_rhs = right_hand_sides->Width();
+  const bool is_cholesky = factorization_type_ == kCholeskyFactorization;
+
+  // The locally-owned portions of L(i, :) y(:) for the rows below each solved
+  // block.
+  BlasMatrix<Field> partial(num_local_rows, num_rhs, Field{0});
+  BlasMatrix<Field> block;
+  for (Int start = 0; start < num_pivots; start += block_size) {
+    const Int end = std::min(start + block_size, num_pivots);
+    const Int width = end - start;
+    const int owner_row = front.RowOwner(start);
+    const int owner_column = front.ColumnOwner(start);
+    const int owner = owner_row + owner_column * front.grid_height;
+    const Int row_start = front.LocalRowOffset(start);
+    const Int column_start = front.LocalColumnOffset(start);
+
+    // Sum the updates of the block onto the owner of its diagonal, which
+    // solves against it.
+    block.Resize(width, num_rhs);
+    if (front.grid_row == owner_row) {
+      for (Int j = 0; j < num_rhs; ++j) {
+        for (Int i = 0; i < width; ++i) {
+          block(i, j) = partial(row_start + i, j);
+        }
+      }
+      distributed_ldl::SumToRoot(block.data.Data(), width * num_rhs,
+                                 owner_column, front.row_comm);
+      if (front.grid_column == owner_column) {
+        for (Int j = 0; j < num_rhs; ++j) {
+          for (Int i = 0; i < width; ++i) {
+            block(i, j) = (*right_hand_sides)(start + i, j) - block(i, j);
+          }
+        }
+        const ConstBlasMatrixView<Field> diagonal =
+            front.values.Submatrix(row_start, column_start, width, width);
+        if (is_cholesky) {
+          LeftLowerTriangularSolves(diagonal, &block.view);
+        } else {
+          LeftLowerUnitTriangularSolves(diagonal, &block.view);
+        }
+      }
+    }
+    distributed_ldl::Broadcast(block.data.Data(), width * num_rhs, owner,
+                               front.comm);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < width; ++i) {
+        (*right_hand_sides)(start + i, j) = block(i, j);
+      }
+    }
+
+    // Accumulate the contributions of the block column to the rows below.
+    const Int row_end = front.LocalRowOffset(end);
+    if (front.grid_column == owner_column && row_end < num_local_rows) {
+      BlasMatrixView<Field> partial_below = partial.Submatrix(
+          row_end, 0, num_local_rows - row_end, num_rhs);
+      MatrixMultiplyNormalNormal(
+          Field{1},
+          front.values.Submatrix(row_end, column_start,
+                                 num_local_rows - row_end, width),
+          block.ConstView(), Field{1}, &partial_below);
+    }
+  }
+
+  // The boundary rows receive -L(B, S) y(S).
+  for (Int local_row = front.LocalRowOffset(num_pivots);
+       local_row < num_local_rows; ++local_row) {
+    const Int row = front.local_rows[local_row] - num_pivots;
+    for (Int j = 0; j < num_rhs; ++j) {
+      (*boundary_update)(row, j) -= partial(local_row, j);
+    }
+  }
+
+  if (!is_cholesky) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_pivots; ++i) {
+        (*right_hand_sides)(i, j) /= front.pivots[i];
+      }
+    }
+  }
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::FrontBackwardSolve(
+    Int path_index, const BlasMatrix<Field>& boundary_solution,
+    BlasMatrix<Field>* right_hand_sides) const {
+  const distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+  const Int block_size = front.block_size;
+  const Int num_pivots = front.num_pivots;
+  const Int num_local_rows = front.local_rows.Size();
+  const Int num_rhs = right_hand_sides->Width();
+  const bool is_cholesky = factorization_type_ == kCholeskyFactorization;
+  const bool is_transpose = factorization_type_ == kLDLTransposeFactorization;
+
+  // The locally-owned portions of L(:, j)^{H,T} x(:) for each eliminated
+  // column, starting with the contributions of the boundary.
+  const Int num_pivot_columns = front.LocalColumnOffset(num_pivots);
+  BlasMatrix<Field> partial(num_pivot_columns, num_rhs, Field{0});
+  const Int boundary_row_beg = front.LocalRowOffset(num_pivots);
+  const Int num_boundary_rows = num_local_rows - boundary_row_beg;
+  if (num_boundary_rows && num_pivot_columns) {
+    BlasMatrix<Field> local_solution(num_boundary_rows, num_rhs);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_boundary_rows; ++i) {
+        local_solution(i, j) = boundary_solution(
+            front.local_rows[boundary_row_beg + i] - num_pivots, j);
+      }
+    }
+    const ConstBlasMatrixView<Field> lower = front.values.Submatrix(
+        boundary_row_beg, 0, num_boundary_rows, num_pivot_columns);
+    if (is_transpose) {
+      MatrixMultiplyTransposeNormal(Field{1}, lower,
+                                    local_solution.ConstView(), Field{1},
+                                    &partial.view);
+    } else {
+      MatrixMultiplyAdjointNormal(Field{1}, lower, local_solution.ConstView(),
+                                  Field{1}, &partial.view);
+    }
+  }
+
+  BlasMatrix<Field> block;
+  const Int last_start = num_pivots ? ((num_pivots - 1) / block_size) * block_size : -1;
+  for (Int start = last_start; start >= 0; start -= block_size) {
+    const Int end = std::min(start + block_size, num_pivots);
+    const Int width = end - start;
+    const int owner_row = front.RowOwner(start);
+    const int owner_column = front.ColumnOwner(start);
+    const int owner = owner_row + owner_column * front.grid_height;
+    const Int row_start = front.LocalRowOffset(start);
+    const Int column_start = front.LocalColumnOffset(start);
+
+    block.Resize(width, num_rhs);
+    if (front.grid_column == owner_column) {
+      for (Int j = 0; j < num_rhs; ++j) {
+        for (Int i = 0; i < width; ++i) {
+          block(i, j) = partial(column_start + i, j);
+        }
+      }
+      distributed_ldl::SumToRoot(block.data.Data(), width * num_rhs,
+                                 owner_row, front.column_comm);
+      if (front.grid_row == owner_row) {
+        for (Int j = 0; j < num_rhs; ++j) {
+          for (Int i = 0; i < width; ++i) {
+            block(i, j) = (*right_hand_sides)(start + i, j) - block(i, j);
+          }
+        }
+        const ConstBlasMatrixView<Field> diagonal =
+            front.values.Submatrix(row_start, column_start, width, width);
+        if (is_cholesky) {
+          LeftLowerAdjointTriangularSolves(diagonal, &block.view);
+        } else if (is_transpose) {
+          LeftLowerTransposeUnitTriangularSolves(diagonal, &block.view);
+        } else {
+          LeftLowerAdjointUnitTriangularSolves(diagonal, &block.view);
+        }
+      }
+    }
+    distributed_ldl::Broadcast(block.data.Data(), width * num_rhs, owner,
+                               front.comm);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < width; ++i) {
+        (*right_hand_sides)(start + i, j) = block(i, j);
+      }
+    }
+
+    // Accumulate the contributions of the block row to the earlier columns.
+    if (front.grid_row == owner_row && column_start > 0) {
+      BlasMatrixView<Field> partial_before =
+          partial.Submatrix(0, 0, column_start, num_rhs);
+      const ConstBlasMatrixView<Field> lower =
+          front.values.Submatrix(row_start, 0, width, column_start);
+      if (is_transpose) {
+        MatrixMultiplyTransposeNormal(Field{1}, lower, block.ConstView(),
+                                      Field{1}, &partial_before);
+      } else {
+        MatrixMultiplyAdjointNormal(Field{1}, lower, block.ConstView(),
+                                    Field{1}, &partial_before);
+      }
+    }
+  }
+}
+
+template <class Field>
+void DistributedSparseLDL<Field>::Solve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int num_rhs = right_hand_sides->width;
+
+  // The updates of the subtree of this process to the rows of its ancestors.
+  BlasMatrix<Field> updates(num_rows_, num_rhs, Field{0});
+  BlasMatrix<Field> solution(num_rows_, num_rhs, Field{0});
+
+  BlasMatrix<Field> leaf_right_hand_sides;
+  if (leaf_ >= 0) {
+    const distributed_ldl::TreeNode& node = tree_[leaf_];
+    const Int num_interior = node.vertices.Size();
+    const Int num_boundary = node.boundary.Size();
+    leaf_right_hand_sides.Resize(num_interior + num_boundary, num_rhs,
+                                 Field{0});
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_interior; ++i) {
+        leaf_right_hand_sides(i, j) = (*right_hand_sides)(node.vertices[i], j);
+      }
+    }
+    leaf_ldl_.PartialForwardSolve(&leaf_right_hand_sides.view);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_boundary; ++i) {
+        updates(node.boundary[i], j) +=
+            leaf_right_hand_sides(num_interior + i, j);
+      }
+    }
+  }
+
+  const Int num_fronts = path_.Size();
+  std::vector<BlasMatrix<Field>> front_right_hand_sides(num_fronts);
+  for (Int path_index = 0; path_index < num_fronts; ++path_index) {
+    const distributed_ldl::TreeNode& node = tree_[path_[path_index]];
+    const distributed_ldl::DistributedFront<Field>& front = fronts_[path_index];
+    const Int num_pivots = front.num_pivots;
+    const Int num_boundary = front.size - num_pivots;
+
+    // Sum the updates of the subtree onto the front, keeping a single copy
+    // of those to the boundary for the ancestors.
+    BlasMatrix<Field> sums(front.size, num_rhs);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < front.size; ++i) {
+        sums(i, j) = updates(front.indices[i], j);
+      }
+    }
+    distributed_ldl::SumAll(sums.data.Data(), front.size * num_rhs,
+                            front.comm);
+    const bool first = rank_ == node.first_rank;
+    BlasMatrix<Field>& front_rhs = front_right_hand_sides[path_index];
+    front_rhs.Resize(num_pivots, num_rhs);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_pivots; ++i) {
+        front_rhs(i, j) =
+            (*right_hand_sides)(node.vertices[i], j) + sums(i, j);
+      }
+      for (Int i = 0; i < num_boundary; ++i) {
+        updates(node.boundary[i], j) =
+            first ? sums(num_pivots + i, j) : Field{0};
+      }
+    }
+
+    BlasMatrix<Field> boundary_update(num_boundary, num_rhs, Field{0});
+    FrontForwardSolve(path_index, &front_rhs, &boundary_update);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_boundary; ++i) {
+        updates(node.boundary[i], j) += boundary_update(i, j);
+      }
+    }
+  }
+
+  // Back-substitute from the root, where the solution of each separator is
+  // replicated over the processes sharing it.
+  for (Int path_index = num_fronts - 1; path_index >= 0; --path_index) {
+    const distributed_ldl::TreeNode& node = tree_[path_[path_index]];
+    const Int num_boundary = node.boundary.Size();
+    BlasMatrix<Field> boundary_solution(num_boundary, num_rhs);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_boundary; ++i) {
+        boundary_solution(i, j) = solution(node.boundary[i], j);
+      }
+    }
+    BlasMatrix<Field>& front_rhs = front_right_hand_sides[path_index];
+    FrontBackwardSolve(path_index, boundary_solution, &front_rhs);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < Int(node.vertices.Size()); ++i) {
+        solution(node.vertices[i], j) = front_rhs(i, j);
+      }
+    }
+  }
+  if (leaf_ >= 0) {
+    const distributed_ldl::TreeNode& node = tree_[leaf_];
+    const Int num_interior = node.vertices.Size();
+    const Int num_boundary = node.boundary.Size();
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_boundary; ++i) {
+        leaf_right_hand_sides(num_interior + i, j) =
+            solution(node.boundary[i], j);
+      }
+    }
+    leaf_ldl_.PartialBackwardSolve(&leaf_right_hand_sides.view);
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_interior; ++i) {
+        solution(node.vertices[i], j) = leaf_right_hand_sides(i, j);
+      }
+    }
+  }
+
+  // Each row of the solution is contributed by a single process.
+  BlasMatrix<Field> gathered(num_rows_, num_rhs, Field{0});
+  auto contribute = [&](const Buffer<Int>& vertices) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (const Int& vertex : vertices) {
+        gathered(vertex, j) = solution(vertex, j);
+      }
+    }
+  };
+  if (leaf_ >= 0) contribute(tree_[leaf_].vertices);
+  for (Int path_index = 0; path_index < num_fronts; ++path_index) {
+    const distributed_ldl::TreeNode& node = tree_[path_[path_index]];
+    if (rank_ == node.first_rank) contribute(node.vertices);
+  }
+  distributed_ldl::SumAll(gathered.data.Data(), num_rows_ * num_rhs, comm_);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows_; ++i) {
+      (*right_hand_sides)(i, j) = gathered(i, j);
+    }
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_DISTRIBUTED_SPARSE_LDL_IMPL_H_
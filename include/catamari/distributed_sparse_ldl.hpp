@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_DISTRIBUTED_SPARSE_LDL_H_
+#define CATAMARI_DISTRIBUTED_SPARSE_LDL_H_
+
+#ifdef CATAMARI_HAVE_MPI
+
+#include <mpi.h>
+
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/nested_dissection.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// Configuration options for the distributed-memory factorization.
+template <class Field>
+struct DistributedSparseLDLControl {
+  // The configuration of the shared-memory (TBB) factorization of the subtree
+  // of the assembly forest owned by each process. A supernodal factorization is
+  // always used, and pivoting is not supported.
+  SparseLDLControl<Field> ldl_control;
+
+  // The configuration of the bisections which carve the top of the assembly
+  // forest out of the graph of the matrix.
+  NestedDissectionControl nd_control;
+
+  // The (square) block size of the 2D block-cyclic distribution of the fronts
+  // of the separators shared by more than one process.
+  Int block_size = 64;
+
+  // Subgraphs with at most this many vertices are not split further, even if
+  // more than one process was mapped to them.
+  Int min_distributed_size = 512;
+};
+
+namespace distributed_ldl {
+
+// A node of the top of the assembly forest, which is mapped onto a
+// contiguous range of processes (the subtree-to-subcube mapping): each
+// separator is shared by the processes of both of its subtrees, and each
+// leaf is factored by the first process of its range.
+struct TreeNode {
+  // The parent of the node, or -1 for the root.
+  Int parent = -1;
+
+  // The children of the node, which is a leaf if there are none.
+  Buffer<Int> children;
+
+  // The range of processes mapped to the node.
+  int first_rank = 0;
+  int num_ranks = 1;
+
+  // The original indices of the vertices eliminated by the node, in their
+  // elimination order: the entire subgraph of a leaf, or the separator of an
+  // internal node.
+  Buffer<Int> vertices;
+
+  // The original indices of the vertices of ancestor separators which are
+  // coupled to the subtree of the node (including fill), in their
+  // elimination order. They index the Schur complement passed to the parent.
+  Buffer<Int> boundary;
+};
+
+// The lower triangle of the front of a separator, distributed over a
+// 'grid_height x grid_width' process grid in a 2D block-cyclic manner. The
+// leading 'num_pivots' rows and columns are eliminated, and the remaining
+// trailing block holds the Schur complement onto the boundary of the node.
+template <class Field>
+struct DistributedFront {
+  // The communicator of the processes of the node, and those of the rows and
+  // columns of its process grid.
+  MPI_Comm comm = MPI_COMM_NULL;
+  MPI_Comm row_comm = MPI_COMM_NULL;
+  MPI_Comm column_comm = MPI_COMM_NULL;
+
+  // The dimensions of the process grid and this process's coordinates in it.
+  // Process 'rank' of 'comm' is at grid position
+  // (rank % grid_height, rank / grid_height).
+  int grid_height = 1;
+  int grid_width = 1;
+  int grid_row = 0;
+  int grid_column = 0;
+
+  // The block size of the distribution.
+  Int block_size = 64;
+
+  // The number of rows of the front and the number of eliminated rows.
+  Int size = 0;
+  Int num_pivots = 0;
+
+  // The original index of each row of the front.
+  Buffer<Int> indices;
+
+  // The (increasing) front indices of the locally-owned rows and columns.
+  Buffer<Int> local_rows;
+  Buffer<Int> local_columns;
+
+  // The locally-owned entries of the front.
+  BlasMatrix<Field> values;
+
+  // The diagonal of the eliminated block (all ones for Cholesky), which is
+  // replicated over the processes of the node.
+  Buffer<Field> pivots;
+
+  // Returns the grid row owning front index 'index'.
+  int RowOwner(Int index) const {
+    return (index / block_size) % grid_height;
+  }
+
+  // Returns the grid column owning front index 'index'.
+  int ColumnOwner(Int index) const {
+    return (index / block_size) % grid_width;
+  }
+
+  // Returns the number of locally-owned rows with front index below 'index'.
+  Int LocalRowOffset(Int index) const;
+
+  // Returns the number of locally-owned columns with front index below
+  // 'index'.
+  Int LocalColumnOffset(Int index) const;
+};
+
+}  // namespace distributed_ldl
+
+// A sparse LDL' factorization distributed over the processes of an MPI
+// communicator. The top levels of the assembly forest are formed by recursive
+// bisection and mapped onto halves of the process set, each process factors
+// its own subtree with the shared-memory supernodal factorization (leaving a
+// dense Schur complement onto its boundary), and the fronts of the separators
+// are assembled and factored in 2D block-cyclic distributions over the
+// processes which share them.
+//
+// The input matrix and right-hand sides are replicated on every process,
+// while the factor itself is distributed.
+template <class Field>
+class DistributedSparseLDL {
+ public:
+  typedef ComplexBase<Field> Real;
+
+  // Constructs a factorization over a duplicate of the given communicator.
+  explicit DistributedSparseLDL(MPI_Comm comm);
+
+  DistributedSparseLDL(const DistributedSparseLDL&) = delete;
+  DistributedSparseLDL& operator=(const DistributedSparseLDL&) = delete;
+
+  // Frees the communicators of the factorization; MPI must not yet have been
+  // finalized.
+  ~DistributedSparseLDL();
+
+  // Factors the given (structurally symmetric) matrix, which must be
+  // identical on every process. Every process returns the same result.
+  SparseLDLResult<Field> Factor(
+      const CoordinateMatrix<Field>& matrix,
+      const DistributedSparseLDLControl<Field>& control);
+
+  // Overwrites the right-hand sides, which must be identical on every
+  // process, with the solution on every process.
+  void Solve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Returns the number of rows of the last factored matrix.
+  Int NumRows() const;
+
+ private:
+  // The duplicated communicator of the factorization.
+  MPI_Comm comm_ = MPI_COMM_NULL;
+  int rank_ = 0;
+  int num_ranks_ = 1;
+
+  // The number of rows of the factored matrix.
+  Int num_rows_ = 0;
+
+  // The type of factorization.
+  SymmetricFactorizationType factorization_type_ = kLDLAdjointFactorization;
+
+  // The top of the assembly forest, which is replicated on every process.
+  std::vector<distributed_ldl::TreeNode> tree_;
+
+  // The leaf factored by this process, or -1.
+  Int leaf_ = -1;
+
+  // The partial factorization of the leaf, whose interior rows are the
+  // vertices of the leaf and whose interface rows are its boundary.
+  SparseLDL<Field> leaf_ldl_;
+
+  // The internal nodes shared by this process, from the bottom up, and their
+  // fronts.
+  Buffer<Int> path_;
+  std::vector<distributed_ldl::DistributedFront<Field>> fronts_;
+
+  // Frees the communicators of the fronts.
+  void FreeCommunicators();
+
+  // Forms the top of the assembly forest on the root process and broadcasts
+  // it.
+  void FormTree(const CoordinateMatrix<Field>& matrix,
+                const DistributedSparseLDLControl<Field>& control);
+
+  // Splits the communicators of the nodes shared by this process and lays
+  // out their fronts.
+  void FormFronts(const DistributedSparseLDLControl<Field>& control);
+
+  // Performs the partial factorization of the leaf of this process, filling
+  // its Schur complement.
+  SparseLDLResult<Field> FactorLeaf(
+      const CoordinateMatrix<Field>& matrix,
+      const DistributedSparseLDLControl<Field>& control,
+      BlasMatrix<Field>* schur_complement);
+
+  // Adds the original matrix entries of the front at the given position of
+  // the path.
+  void AssembleFront(const CoordinateMatrix<Field>& matrix, Int path_index);
+
+  // Adds the Schur complement of the child of this process into the front at
+  // the given position of the path. The child's Schur complement is either
+  // the dense 'leaf_schur_complement' or the trailing block of the previous
+  // front on the path.
+  void ExtendAdd(Int path_index,
+                 const BlasMatrix<Field>& leaf_schur_complement);
+
+  // Eliminates the leading block of the front at the given position of the
+  // path and returns the number of successful pivots.
+  Int FactorFront(Int path_index, Int inner_block_size);
+
+  // Solves against the eliminated block of a front after the contributions of
+  // its subtree are added, in the forward and backward directions.
+  void FrontForwardSolve(Int path_index, BlasMatrix<Field>* right_hand_sides,
+                         BlasMatrix<Field>* boundary_update) const;
+  void FrontBackwardSolve(Int path_index,
+                          const BlasMatrix<Field>& boundary_solution,
+                          BlasMatrix<Field>* right_hand_sides) const;
+};
+
+}  // namespace catamari
+
+#include "catamari/distributed_sparse_ldl-impl.hpp"
+
+#endif  // ifdef CATAMARI_HAVE_MPI
+
+#endif  // ifndef CATAMARI_DISTRIBUTED_SPARSE_LDL_H_
@@ -8,6 +8,7 @@
 #ifndef CATAMARI_DYNAMIC_REGULARIZATION_H_
 #define CATAMARI_DYNAMIC_REGULARIZATION_H_
 
+#include <utility>
 #include <vector>
 
 #include "catamari/buffer.hpp"
@@ -41,6 +42,13 @@ struct DynamicRegularizationControl {
   // maximum entry magnitude in the matrix times machine epsilon raised to this
   // power, then it will be increased up to it.
   Real negative_threshold_exponent = Real(1);
+
+  // If true, the supernodal factorizations write each shift directly into
+  // the length-n 'SparseLDLResult::dynamic_regularization_diagonal' (in the
+  // original ordering) rather than collecting (index, shift) pairs into
+  // 'SparseLDLResult::dynamic_regularization', which are then concatenated up
+  // the assembly tree. The scalar factorizations always collect pairs.
+  bool diagonal_output = false;
 };
 
 // A structure for use in processing diagonal blocks of a dynamically
@@ -72,8 +80,28 @@ struct DynamicRegularizationParams {
   // matrices indices, over which 'signatures' is defined. If it is null, then
   // the permutation is trivial.
   const Buffer<Int>* inverse_permutation;
+
+  // If non-null, the length-n diagonal, over the original indices, into
+  // which the shifts are written in place of being appended to a list. Each
+  // index is pivoted exactly once, so concurrent fronts write disjoint
+  // entries.
+  Real* diagonal = nullptr;
 };
 
+// Records the shift of the pivot with the given original index, either in
+// the diagonal of 'params' or, if there is none, in 'dynamic_regularization'.
+template <typename Field>
+void RecordDynamicRegularization(
+    const DynamicRegularizationParams<Field>& params, Int orig_index,
+    const ComplexBase<Field>& regularization,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  if (params.diagonal) {
+    params.diagonal[orig_index] = regularization;
+  } else {
+    dynamic_regularization->emplace_back(orig_index, regularization);
+  }
+}
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_DYNAMIC_REGULARIZATION_H_
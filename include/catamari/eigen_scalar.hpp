@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_EIGEN_SCALAR_H_
+#define CATAMARI_EIGEN_SCALAR_H_
+
+#include <complex>
+
+#include "catamari/complex.hpp"
+
+namespace catamari {
+
+// The scalar type used by Eigen for a real or complex field, along with the
+// conversions to and from it.
+template <typename Field>
+struct EigenScalar {
+  typedef Field type;
+  static Field ToEigen(const Field& value) { return value; }
+  static Field FromEigen(const Field& value) { return value; }
+};
+
+template <typename Real>
+struct EigenScalar<Complex<Real>> {
+  typedef std::complex<Real> type;
+  static std::complex<Real> ToEigen(const Complex<Real>& value) {
+    return std::complex<Real>(RealPart(value), ImagPart(value));
+  }
+  static Complex<Real> FromEigen(const std::complex<Real>& value) {
+    return Complex<Real>(value.real(), value.imag());
+  }
+};
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_EIGEN_SCALAR_H_
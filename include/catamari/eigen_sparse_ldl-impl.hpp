@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_EIGEN_SPARSE_LDL_IMPL_H_
+#define CATAMARI_EIGEN_SPARSE_LDL_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "catamari/eigen_sparse_ldl.hpp"
+
+namespace catamari {
+
+template <class Field, typename StorageIndex>
+const Field* EigenSparseLDL<Field, StorageIndex>::Values(
+    const SparseMatrix& matrix) {
+  // Catamari's complex numbers share the (real, imaginary) layout of
+  // std::complex.
+  static_assert(sizeof(Field) == sizeof(Scalar),
+                "The field must share the layout of the Eigen scalar.");
+  return reinterpret_cast<const Field*>(matrix.valuePtr());
+}
+
+template <class Field, typename StorageIndex>
+bool EigenSparseLDL<Field, StorageIndex>::HasAnalyzedPattern(
+    const SparseMatrix& matrix) const {
+  if (matrix.rows() != num_rows_ || matrix.cols() != num_rows_ ||
+      Int(column_offsets_.Size()) != num_rows_ + 1) {
+    return false;
+  }
+  const StorageIndex* offsets = matrix.outerIndexPtr();
+  const StorageIndex num_entries = offsets[num_rows_];
+  return Int(row_indices_.Size()) == Int(num_entries) &&
+         std::equal(offsets, offsets + num_rows_ + 1,
+                    column_offsets_.begin()) &&
+         std::equal(matrix.innerIndexPtr(),
+                    matrix.innerIndexPtr() + num_entries,
+                    row_indices_.begin());
+}
+
+template <class Field, typename StorageIndex>
+void EigenSparseLDL<Field, StorageIndex>::Analyze(
+    const SparseMatrix& matrix, const SparseLDLControl<Field>& control) {
+  if (control.equilibrate && !control.fuse_equilibration) {
+    throw std::invalid_argument(
+        "The values loaded through a conversion plan require a fused "
+        "equilibration");
+  }
+  if (IsComplex<Field>::value && triangle_storage &&
+      control.supernodal_control.factorization_type !=
+          kLDLTransposeFactorization) {
+    throw std::invalid_argument(
+        "The mirrored values of a stored triangle are not conjugated");
+  }
+  const Int num_rows = matrix.rows();
+  const StorageIndex* offsets = matrix.outerIndexPtr();
+  const StorageIndex* indices = matrix.innerIndexPtr();
+  const Int num_entries = offsets[num_rows];
+  const Field* values = Values(matrix);
+
+  // The symbolic analysis (and any equilibration) traverses a coordinate
+  // copy of the matrix, with a stored triangle mirrored into both, which is
+  // only formed once per pattern.
+  {
+    CoordinateMatrix<Field> coordinate_matrix;
+    coordinate_matrix.Resize(num_rows, num_rows);
+    coordinate_matrix.ReserveEntryAdditions((triangle_storage ? 2 : 1) *
+                                            num_entries);
+    for (Int column = 0; column < num_rows; ++column) {
+      for (Int index = offsets[column]; index < offsets[column + 1];
+           ++index) {
+        const Int row = indices[index];
+        coordinate_matrix.QueueEntryAddition(row, column, values[index]);
+        if (triangle_storage && row != column) {
+          coordinate_matrix.QueueEntryAddition(column, row, values[index]);
+        }
+      }
+    }
+    coordinate_matrix.FlushEntryQueues();
+    ldl.Factor(coordinate_matrix, control, true);
+  }
+
+  num_rows_ = num_rows;
+  column_offsets_.Resize(num_rows + 1);
+  std::copy(offsets, offsets + num_rows + 1, column_offsets_.begin());
+  row_indices_.Resize(num_entries);
+  std::copy(indices, indices + num_entries, row_indices_.begin());
+  FormPlan();
+}
+
+template <class Field, typename StorageIndex>
+void EigenSparseLDL<Field, StorageIndex>::FormPlan() {
+  if (std::is_same<StorageIndex, Int>::value) {
+    ldl.FormConversionPlan(
+        num_rows_, reinterpret_cast<const Int*>(column_offsets_.Data()),
+        reinterpret_cast<const Int*>(row_indices_.Data()), false, &cplan_);
+  } else {
+    const Int num_entries = row_indices_.Size();
+    Buffer<Int> wide_offsets(num_rows_ + 1);
+    Buffer<Int> wide_indices(num_entries);
+    std::copy(column_offsets_.begin(), column_offsets_.end(),
+              wide_offsets.begin());
+    std::copy(row_indices_.begin(), row_indices_.end(), wide_indices.begin());
+    ldl.FormConversionPlan(num_rows_, wide_offsets.Data(), wide_indices.Data(),
+                           false, &cplan_);
+  }
+}
+
+template <class Field, typename StorageIndex>
+SparseLDLResult<Field> EigenSparseLDL<Field, StorageIndex>::LoadThroughPlan(
+    const SparseMatrix& matrix) {
+  const SparseLDLResult<Field> result =
+      ldl.RefactorWithFixedSparsityPattern(cplan_, Values(matrix));
+  if (!ldl.ConversionPlanIsCurrent(cplan_)) {
+    // Delayed pivots refolded the factor, so the plan is re-formed for it.
+    FormPlan();
+  }
+  return result;
+}
+
+template <class Field, typename StorageIndex>
+SparseLDLResult<Field> EigenSparseLDL<Field, StorageIndex>::Factor(
+    const SparseMatrix& matrix, const SparseLDLControl<Field>& control) {
+  if (!matrix.isCompressed()) {
+    throw std::invalid_argument("The sparse matrix must be compressed");
+  }
+  if (matrix.rows() != matrix.cols()) {
+    throw std::invalid_argument("The sparse matrix must be square");
+  }
+  if (!HasAnalyzedPattern(matrix)) {
+    Analyze(matrix, control);
+  }
+  return LoadThroughPlan(matrix);
+}
+
+template <class Field, typename StorageIndex>
+SparseLDLResult<Field>
+EigenSparseLDL<Field, StorageIndex>::RefactorWithFixedSparsityPattern(
+    const SparseMatrix& matrix) {
+  if (num_rows_ < 0 || matrix.rows() != num_rows_ ||
+      matrix.nonZeros() != Int(row_indices_.Size()) ||
+      !matrix.isCompressed()) {
+    throw std::invalid_argument(
+        "The sparse matrix does not have the analyzed pattern");
+  }
+  return LoadThroughPlan(matrix);
+}
+
+template <class Field, typename StorageIndex>
+void EigenSparseLDL<Field, StorageIndex>::Solve(
+    Eigen::Ref<DenseMatrix> right_hand_sides) const {
+  static_assert(sizeof(Field) == sizeof(Scalar),
+                "The field must share the layout of the Eigen scalar.");
+  BlasMatrixView<Field> view;
+  view.height = right_hand_sides.rows();
+  view.width = right_hand_sides.cols();
+  view.leading_dim = right_hand_sides.outerStride();
+  view.data = reinterpret_cast<Field*>(right_hand_sides.data());
+  ldl.Solve(&view);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_EIGEN_SPARSE_LDL_IMPL_H_
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_EIGEN_SPARSE_LDL_H_
+#define CATAMARI_EIGEN_SPARSE_LDL_H_
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "catamari/conversion_plan.hpp"
+#include "catamari/eigen_scalar.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// A front end of 'SparseLDL' for (compressed) column-major Eigen sparse
+// matrices and Eigen dense right-hand sides. The first factorization of a
+// sparsity pattern copies the matrix into a 'CoordinateMatrix' once for the
+// symbolic analysis and forms a 'ConversionPlan' from the compressed
+// columns; every numerical (re)factorization then loads the values straight
+// from the Eigen matrix through the plan, and the solves overwrite the Eigen
+// right-hand sides in place. Either triangle or the full matrix may be stored
+// (see 'triangle_storage'), and an equilibration must be fused into the
+// factorization.
+template <class Field, typename StorageIndex = int>
+class EigenSparseLDL {
+ public:
+  // The Eigen scalar type of the field.
+  typedef typename EigenScalar<Field>::type Scalar;
+
+  // The compressed-sparse-column matrix type.
+  typedef Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex>
+      SparseMatrix;
+
+  // The dense (column-major) right-hand side type.
+  typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> DenseMatrix;
+
+  // The underlying factorization.
+  SparseLDL<Field> ldl;
+
+  // If only one triangle (including the diagonal) of the matrices is stored.
+  // The pattern is mirrored for the symbolic analysis of each new pattern,
+  // while the plan mirrors the values without conjugation, so complex
+  // matrices must be fully stored unless an LDL^T factorization is requested.
+  bool triangle_storage = false;
+
+  // Analyzes the sparsity pattern of 'matrix' -- which must be compressed --
+  // and factors it. The analysis is reused, and only the values are loaded,
+  // if the pattern matches that of the previous factorization.
+  SparseLDLResult<Field> Factor(const SparseMatrix& matrix,
+                                const SparseLDLControl<Field>& control);
+
+  // Factors a matrix with the sparsity pattern of the previous factorization
+  // by loading its values through the conversion plan.
+  SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
+      const SparseMatrix& matrix);
+
+  // Overwrites the right-hand sides, which may be a block of a larger
+  // matrix, with the solutions of the factored system in place.
+  void Solve(Eigen::Ref<DenseMatrix> right_hand_sides) const;
+
+  // Returns the plan which loads the values of the analyzed pattern.
+  const ConversionPlan& Plan() const { return cplan_; }
+
+ private:
+  // The plan which loads the values of the analyzed pattern into the factor.
+  ConversionPlan cplan_;
+
+  // The dimension and column offsets of the analyzed pattern, along with its
+  // row indices, against which matrices are checked before being loaded.
+  Int num_rows_ = -1;
+  Buffer<StorageIndex> column_offsets_;
+  Buffer<StorageIndex> row_indices_;
+
+  // Returns whether 'matrix' has the analyzed pattern.
+  bool HasAnalyzedPattern(const SparseMatrix& matrix) const;
+
+  // Performs the symbolic analysis of the pattern of 'matrix' and forms the
+  // conversion plan of its values.
+  void Analyze(const SparseMatrix& matrix,
+               const SparseLDLControl<Field>& control);
+
+  // Forms the conversion plan of the analyzed pattern against the current
+  // layout of the factor.
+  void FormPlan();
+
+  // Factors 'matrix', which has the analyzed pattern, by loading its values
+  // through the plan, which is re-formed if the factorization refolded the
+  // layout of the factor (see 'SparseLDL::ConversionPlanIsCurrent').
+  SparseLDLResult<Field> LoadThroughPlan(const SparseMatrix& matrix);
+
+  // Returns the values of 'matrix' viewed in the field.
+  static const Field* Values(const SparseMatrix& matrix);
+};
+
+}  // namespace catamari
+
+#include "catamari/eigen_sparse_ldl-impl.hpp"
+
+#endif  // ifndef CATAMARI_EIGEN_SPARSE_LDL_H_
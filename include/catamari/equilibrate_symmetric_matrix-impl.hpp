@@ -10,70 +10,132 @@
 
 #include <limits>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "catamari/equilibrate_symmetric_matrix.hpp"
 
 namespace catamari {
 
 template <typename Field>
-void EquilibrateSymmetricMatrix(CoordinateMatrix<Field>* matrix,
-                                BlasMatrix<ComplexBase<Field>>* scaling,
-                                bool verbose) {
+Int ComputeSymmetricEquilibration(
+    const CoordinateMatrix<Field>& matrix,
+    BlasMatrix<ComplexBase<Field>>* scaling,
+    const EquilibrationControl<ComplexBase<Field>>& control) {
   typedef ComplexBase<Field> Real;
-  const Int num_rows = matrix->NumRows();
-  CATAMARI_ASSERT(num_rows == matrix->NumColumns(), "Expected square matrix.");
+  const Int num_rows = matrix.NumRows();
+  CATAMARI_ASSERT(num_rows == matrix.NumColumns(), "Expected square matrix.");
 
   scaling->Resize(num_rows, 1, Real(1));
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Real* scaling_data = scaling->data.Data();
 
-  // Compute the maximum and minimum absolute value in each column.
-  Buffer<Real> column_max_abs(num_rows, Real(0));
-  Buffer<Real> new_scaling(num_rows);
-  for (const auto& entry : matrix->Entries()) {
-    const Int j = entry.column;
-    const Real value_abs = std::abs(entry.value);
-    column_max_abs[j] = std::max(column_max_abs[j], value_abs);
-  }
-  for (Int i = 0; i < num_rows; ++i) {
-    new_scaling[i] = std::sqrt(column_max_abs[i]);
-  }
+  // The infinity norm of each row of the currently rescaled matrix, which (by
+  // symmetry) is also that of the corresponding column.
+  Buffer<Real> row_max_abs(num_rows);
+  auto compute_row_norms = [&](bool rescaled) {
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(0, num_rows),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int i = range.begin(); i < range.end(); ++i) {
+            const Int row_beg = matrix.RowEntryOffset(i);
+            const Int row_end = matrix.RowEntryOffset(i + 1);
+            Real max_abs = 0;
+            for (Int index = row_beg; index < row_end; ++index) {
+              const MatrixEntry<Field>& entry = entries[index];
+              Real value_abs = std::abs(entry.value);
+              if (rescaled) {
+                value_abs /= scaling_data[i] * scaling_data[entry.column];
+              }
+              max_abs = std::max(max_abs, value_abs);
+            }
+            row_max_abs[i] = max_abs;
+          }
+        });
+  };
 
-  // Perform the rescaling iterations.
-  const Int kNumPasses = 1;
-  for (Int pass = 0; pass < kNumPasses; ++pass) {
-    if (verbose) {
-      // Find the largest and smallest absolute values.
-      const Real max_abs =
-          *std::max_element(column_max_abs.begin(), column_max_abs.end());
-      std::cout << "Pass " << pass << ":\n"
-                << "  max_abs: " << max_abs << std::endl;
+  compute_row_norms(false);
+  Int num_passes = 0;
+  while (true) {
+    Real max_abs = 0;
+    Real deviation = 0;
+    for (Int i = 0; i < num_rows; ++i) {
+      max_abs = std::max(max_abs, row_max_abs[i]);
+      if (row_max_abs[i] > Real(0)) {
+        deviation = std::max(deviation, std::abs(Real(1) - row_max_abs[i]));
+      }
     }
-
-    // Rescale the problem using the row geometric means and update the
-    // minimum and maximum absolute values.
-    column_max_abs.Resize(num_rows, Real(0));
-    for (auto& entry : matrix->Entries()) {
-      const Int i = entry.row;
-      const Int j = entry.column;
-      entry.value /= new_scaling[i] * new_scaling[j];
-      const Real abs_value = std::abs(entry.value);
-      column_max_abs[j] = std::max(column_max_abs[j], abs_value);
+    if (control.verbose) {
+      std::cout << "Pass " << num_passes << ":\n"
+                << "  max_abs: " << max_abs << "\n"
+                << "  deviation: " << deviation << std::endl;
     }
-    for (Int j = 0; j < num_rows; ++j) {
-      scaling->Entry(j) *= new_scaling[j];
+    if (num_passes == control.max_iterations ||
+        deviation <= control.tolerance) {
+      break;
     }
 
-    if (pass != kNumPasses - 1) {
-      for (Int i = 0; i < num_rows; ++i) {
-        new_scaling[i] = std::sqrt(column_max_abs[i]);
+    // Empty rows are left unscaled.
+    for (Int i = 0; i < num_rows; ++i) {
+      if (row_max_abs[i] > Real(0)) {
+        scaling->Entry(i) *= std::sqrt(row_max_abs[i]);
       }
     }
-  }
+    ++num_passes;
 
-  if (verbose) {
-    const Real max_abs =
-        *std::max_element(column_max_abs.begin(), column_max_abs.end());
-    std::cout << "Final results:\n"
-              << "  max_abs: " << max_abs << std::endl;
+    // The norms after the last allowed pass are only needed for reporting.
+    if (num_passes == control.max_iterations && !control.verbose) {
+      break;
+    }
+    compute_row_norms(true);
   }
+
+  return num_passes;
+}
+
+template <typename Field>
+void ComputeSymmetricEquilibration(const CoordinateMatrix<Field>& matrix,
+                                   BlasMatrix<ComplexBase<Field>>* scaling,
+                                   bool verbose) {
+  EquilibrationControl<ComplexBase<Field>> control;
+  control.verbose = verbose;
+  ComputeSymmetricEquilibration(matrix, scaling, control);
+}
+
+template <typename Field>
+Int EquilibrateSymmetricMatrix(
+    CoordinateMatrix<Field>* matrix, BlasMatrix<ComplexBase<Field>>* scaling,
+    const EquilibrationControl<ComplexBase<Field>>& control) {
+  const Int num_passes =
+      ComputeSymmetricEquilibration(*matrix, scaling, control);
+
+  // Apply the accumulated scaling in a single sweep over the rows.
+  const Int num_rows = matrix->NumRows();
+  const ComplexBase<Field>* scaling_data = scaling->data.Data();
+  Buffer<MatrixEntry<Field>>& entries = matrix->Entries();
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int i = range.begin(); i < range.end(); ++i) {
+          const Int row_beg = matrix->RowEntryOffset(i);
+          const Int row_end = matrix->RowEntryOffset(i + 1);
+          for (Int index = row_beg; index < row_end; ++index) {
+            MatrixEntry<Field>& entry = entries[index];
+            entry.value /= scaling_data[i] * scaling_data[entry.column];
+          }
+        }
+      });
+
+  return num_passes;
+}
+
+template <typename Field>
+void EquilibrateSymmetricMatrix(CoordinateMatrix<Field>* matrix,
+                                BlasMatrix<ComplexBase<Field>>* scaling,
+                                bool verbose) {
+  EquilibrationControl<ComplexBase<Field>> control;
+  control.verbose = verbose;
+  EquilibrateSymmetricMatrix(matrix, scaling, control);
 }
 
 }  // namespace catamari
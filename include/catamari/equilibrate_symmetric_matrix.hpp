@@ -13,6 +13,21 @@
 
 namespace catamari {
 
+// The configuration of the iterative equilibration of a symmetric or
+// Hermitian matrix.
+template <typename Real>
+struct EquilibrationControl {
+  // The maximum number of rescaling passes.
+  Int max_iterations = 1;
+
+  // The passes stop early once the infinity norm of every row of the
+  // rescaled matrix is within this distance of one.
+  Real tolerance = 0;
+
+  // If the progress of the passes should be printed.
+  bool verbose = false;
+};
+
 // Rescales a symmetric or Hermitian matrix in-place and returns the
 // corresponding scaling. Our approach is essentially the simple algorithm
 // described in [Ruiz-2001].
@@ -29,11 +44,35 @@ namespace catamari {
 //
 //     A_{rescaled} = inv(D) A inv(D).
 //
+// Each pass divides every row and column of the rescaled matrix by the
+// square root of its infinity norm, so that the norms converge to one. The
+// number of passes performed is returned.
+template <typename Field>
+Int EquilibrateSymmetricMatrix(
+    CoordinateMatrix<Field>* matrix, BlasMatrix<ComplexBase<Field>>* scaling,
+    const EquilibrationControl<ComplexBase<Field>>& control);
+
+// A single pass of 'EquilibrateSymmetricMatrix'.
 template <typename Field>
 void EquilibrateSymmetricMatrix(CoordinateMatrix<Field>* matrix,
                                 BlasMatrix<ComplexBase<Field>>* scaling,
                                 bool verbose = false);
 
+// Computes the scaling D of 'EquilibrateSymmetricMatrix' without rescaling
+// the matrix, so that inv(D) A inv(D) can be formed on the fly. The number
+// of passes performed is returned.
+template <typename Field>
+Int ComputeSymmetricEquilibration(
+    const CoordinateMatrix<Field>& matrix,
+    BlasMatrix<ComplexBase<Field>>* scaling,
+    const EquilibrationControl<ComplexBase<Field>>& control);
+
+// A single pass of 'ComputeSymmetricEquilibration'.
+template <typename Field>
+void ComputeSymmetricEquilibration(const CoordinateMatrix<Field>& matrix,
+                                   BlasMatrix<ComplexBase<Field>>* scaling,
+                                   bool verbose = false);
+
 // References:
 //
 // [Ruiz-2001]
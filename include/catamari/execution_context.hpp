@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_EXECUTION_CONTEXT_H_
+#define CATAMARI_EXECUTION_CONTEXT_H_
+
+
+#include <tbb/task_arena.h>
+
+#include "catamari/blas.hpp"
+#include "catamari/flush_to_zero.hpp"
+
+namespace catamari {
+
+struct ExecutionContextControl {
+  // The maximum number of threads which execute within the context --
+  // including the calling thread -- or zero for the TBB default of one per
+  // hardware thread.
+  int num_threads = 0;
+
+  // The number of threads of each BLAS call made within the context (see
+  // 'SetNumLocalBlasThreads'). Since the parallelism is provided by the tasks
+  // of the arena, the default of one avoids oversubscribing the cores with
+  // BLAS threads. If nonpositive, the BLAS threading is left unchanged.
+  int num_blas_threads = 1;
+
+  // If subnormals are flushed to zero (see 'EnableFlushToZero') on the
+  // threads executing within the context. Otherwise, its tasks run with the
+  // floating-point settings of the thread which constructed it.
+  bool flush_to_zero = true;
+};
+
+class ExecutionContext;
+
+namespace execution_context {
+
+// The context which the calling thread is executing within, if any.
+inline const ExecutionContext*& CurrentContext() {
+  static thread_local const ExecutionContext* context = nullptr;
+  return context;
+}
+
+}  // namespace execution_context
+
+// A persistent execution environment shared by the factorizations, solves
+// and samplers which are bound to it, e.g., through
+// 'SparseLDLControl::execution_context', and by any other routine run through
+// 'Execute': a TBB task arena, which keeps its thread limit between calls
+// rather than every entry point sizing its own parallelism, along with the
+// BLAS threading policy and the flush-to-zero setup of its threads. The
+// flushing is attached to the arena once, as the context is constructed,
+// rather than per call.
+//
+// A context is typically constructed once per process (or per independent
+// pool of work) and must outlive the objects bound to it. It may be used by
+// several threads at once; their calls then share the threads of the arena.
+//
+// Usage:
+//
+//   catamari::ExecutionContextControl context_control;
+//   context_control.num_threads = 8;
+//   const catamari::ExecutionContext context(context_control);
+//
+//   catamari::SparseLDLControl<double> ldl_control;
+//   ldl_control.execution_context = &context;
+//   catamari::SparseLDL<double> ldl;
+//   ldl.Factor(matrix, ldl_control);
+//   ldl.Solve(&right_hand_sides.view);  // Also runs within the context.
+//
+//   const std::vector<catamari::Int> sample = context.Execute([&]() {
+//     return catamari::SampleLowerHermitianDPP(block_size, false,
+//                                              &kernel.view, &generator);
+//   });
+//
+class ExecutionContext {
+ public:
+  // Initializes the arena. The arena captures the floating-point settings of
+  // the thread which initializes it, and TBB applies them around each of its
+  // tasks -- whichever thread executes them -- before restoring the previous
+  // settings of that thread. Flushing is thus enabled while it is captured.
+  explicit ExecutionContext(
+      const ExecutionContextControl& control = ExecutionContextControl())
+      : control_(control),
+        arena_(control.num_threads > 0 ? control.num_threads
+                                       : int(tbb::task_arena::automatic)) {
+    if (control_.flush_to_zero) {
+      const flush_to_zero::ScopedRequest request;
+      arena_.initialize();
+    } else {
+      arena_.initialize();
+    }
+  }
+
+  ExecutionContext(const ExecutionContext&) = delete;
+  ExecutionContext& operator=(const ExecutionContext&) = delete;
+
+  // Returns the maximum number of threads executing within the context.
+  int NumThreads() const { return arena_.max_concurrency(); }
+
+  // Returns the arena of the context, e.g., for 'SparseLDL::FactorAsync'.
+  tbb::task_arena* Arena() const { return &arena_; }
+
+  // Returns whether the calling thread is executing within the context.
+  bool IsActive() const {
+    return execution_context::CurrentContext() == this;
+  }
+
+  // Runs 'functor' within the arena of the context, with the calling thread
+  // flushing subnormals and the BLAS threading policy applied, and returns
+  // its result. A call from a thread already executing within the context
+  // runs 'functor' directly.
+  template <typename Functor>
+  auto Execute(Functor&& functor) const -> decltype(functor()) {
+    if (IsActive()) return functor();
+    return arena_.execute([&]() {
+      const Scope scope(this);
+      return functor();
+    });
+  }
+
+ private:
+  // Marks the calling thread as executing within the context and applies the
+  // policy of the context to it for the lifetime of the object.
+  class Scope {
+   public:
+    explicit Scope(const ExecutionContext* context)
+        : context_(context),
+          previous_context_(execution_context::CurrentContext()) {
+      execution_context::CurrentContext() = context;
+      if (context_->control_.flush_to_zero) flush_to_zero::BeginRequest();
+      if (context_->control_.num_blas_threads > 0) {
+        previous_blas_threads_ =
+            SetNumLocalBlasThreads(context_->control_.num_blas_threads);
+      }
+    }
+
+    ~Scope() {
+      if (context_->control_.num_blas_threads > 0) {
+        SetNumLocalBlasThreads(previous_blas_threads_);
+      }
+      if (context_->control_.flush_to_zero) flush_to_zero::EndRequest();
+      execution_context::CurrentContext() = previous_context_;
+    }
+
+   private:
+    const ExecutionContext* context_;
+    const ExecutionContext* previous_context_;
+    int previous_blas_threads_ = 0;
+  };
+
+  // The configuration of the context.
+  ExecutionContextControl control_;
+
+  // The arena which the work of the context executes within.
+  mutable tbb::task_arena arena_;
+};
+
+// Returns whether an entry point bound to 'context' should re-enter itself
+// through 'context->Execute', i.e., whether a context is set and the calling
+// thread is not yet executing within it.
+inline bool ShouldEnterExecutionContext(const ExecutionContext* context) {
+  return context != nullptr && !context->IsActive();
+}
+
+// Returns whether an entry point should re-enter itself through
+// 'RunWithFlushToZero', i.e., whether the calling thread neither flushes
+// subnormals already nor executes within a context, whose control then
+// decides the flushing.
+inline bool ShouldEnterFlushToZero() {
+  return !flush_to_zero::IsEnabled() &&
+         execution_context::CurrentContext() == nullptr;
+}
+
+// Runs 'functor' with subnormals flushed to zero on the calling thread and on
+// every TBB worker which executes its tasks, and returns its result. Unless
+// 'ShouldEnterFlushToZero' holds, 'functor' is run directly.
+//
+// Otherwise, 'functor' runs within a temporary context with the thread limit
+// of the arena of the calling thread. Since the flushing is applied around
+// each task of that context (see the 'ExecutionContext' constructor), no
+// thread keeps flushing once its task completes. Binding a persistent context
+// avoids forming an arena per call.
+template <typename Functor>
+auto RunWithFlushToZero(Functor&& functor) -> decltype(functor()) {
+  if (!ShouldEnterFlushToZero()) return functor();
+  ExecutionContextControl control;
+  control.num_threads = tbb::this_task_arena::max_concurrency();
+  control.num_blas_threads = 0;
+  const ExecutionContext context(control);
+  return context.Execute(functor);
+}
+
+// Runs 'functor' within 'context' (see 'ExecutionContext::Execute') if it is
+// non-null, and directly otherwise, and returns its result.
+template <typename Functor>
+auto RunInExecutionContext(const ExecutionContext* context, Functor&& functor)
+    -> decltype(functor()) {
+  return context ? context->Execute(functor) : functor();
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_EXECUTION_CONTEXT_H_
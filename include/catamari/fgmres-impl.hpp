@@ -9,7 +9,8 @@
 
 #include <limits>
 
-#include "catamari/givens_rotation.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/norms.hpp"
 
 #include "catamari/fgmres.hpp"
 
@@ -17,278 +18,292 @@ namespace catamari {
 
 namespace fgmres {
 
-template <class Field, class ApplyMatrix, class ApplyPreconditioner>
-FGMRESStatus<ComplexBase<Field>> SingleSolve(
-    const ApplyMatrix apply_matrix,
-    const ApplyPreconditioner apply_preconditioner,
-    const FGMRESControl<ComplexBase<Field>>& control,
-    const ConstBlasMatrixView<Field>& right_hand_side,
-    BlasMatrixView<Field>* solution) {
+// Sets the initial guess of a right-hand side to zero and returns whether
+// the right-hand side is nonzero (and so needs to be iterated on).
+template <class Field>
+bool Initialize(const FGMRESControl<ComplexBase<Field>>& control,
+                const ConstBlasMatrixView<Field>& right_hand_side,
+                BlasMatrixView<Field>* solution, ColumnState<Field>* state) {
   typedef ComplexBase<Field> Real;
-  CATAMARI_ASSERT(right_hand_side.width == 1, "Assumed a column vector.");
   const Int height = right_hand_side.height;
-  const Int max_inner_iterations = control.max_inner_iterations;
-
-  static const Real epsilon = std::numeric_limits<Real>::epsilon();
-  const Real relative_tolerance =
-      control.relative_tolerance_coefficient *
-      std::pow(epsilon, control.relative_tolerance_exponent);
 
   // Begin with the initial guess of zero.
   for (Int i = 0; i < height; ++i) {
     solution->Entry(i) = Field(0);
   }
 
-  // Form the image of the zero vector.
-  BlasMatrix<Field> image(height, 1, Field(0));
-
   // Form the residual of the zero vector.
-  BlasMatrix<Field> residual = right_hand_side;
-  const Real original_residual_norm = EuclideanNorm(residual.ConstView());
+  state->residual = right_hand_side;
+  state->original_residual_norm =
+      EuclideanNorm(state->residual.ConstView());
   if (control.verbose) {
-    std::cout << "|| b ||_2 = " << original_residual_norm << std::endl;
+    std::cout << "|| b ||_2 = " << state->original_residual_norm << std::endl;
   }
 
-  FGMRESStatus<Real> status;
-  status.num_iterations = 0;
-  status.num_outer_iterations = 0;
+  state->status.relative_error = 0;
+  state->status.num_iterations = 0;
+  state->status.num_outer_iterations = 0;
+  state->finished = false;
+  state->start_outer_iteration = true;
+  state->givens_rotations.resize(control.max_inner_iterations);
 
   // Early exit if the right-hand side is identically zero.
-  if (original_residual_norm == Real(0)) {
+  if (state->original_residual_norm == Real(0)) {
     if (control.verbose) {
       std::cout << "Early-exiting FGMRES since || b ||_2 = 0." << std::endl;
     }
-    status.relative_error = 0;
-    return status;
+    state->finished = true;
+    return false;
   }
+  return true;
+}
 
-  bool finished = false;
-  std::vector<GivensRotation<Field>> givens_rotations(max_inner_iterations);
-  BlasMatrix<Field> arnoldi_matrix;
-  BlasMatrix<Field> arnoldi_vectors;
-  BlasMatrix<Field> preconditioned_vectors;
-  BlasMatrix<Field> preconditioned_images;
-  BlasMatrix<Field> projected_image;
-  BlasMatrix<Field> projected_residual;
-  BlasMatrix<Field> projected_solution;
-  BlasMatrix<Field> initial_solution;
-  BlasMatrix<Field> solution_image;
-  BlasMatrix<Field> initial_solution_image;
-  while (!finished) {
-    if (control.verbose) {
-      std::cout << "Starting outer FGMRES iteration "
-                << status.num_outer_iterations << std::endl;
-    }
+// Begins an outer iteration by normalizing the current residual into the
+// first Arnoldi vector.
+template <class Field>
+void StartOuterIteration(const FGMRESControl<ComplexBase<Field>>& control,
+                         const BlasMatrixView<Field>& solution,
+                         ColumnState<Field>* state) {
+  typedef ComplexBase<Field> Real;
+  const Int height = solution.height;
+  const Int max_inner_iterations = control.max_inner_iterations;
+  if (control.verbose) {
+    std::cout << "Starting outer FGMRES iteration "
+              << state->status.num_outer_iterations << std::endl;
+  }
 
-    arnoldi_matrix.Resize(max_inner_iterations, max_inner_iterations, Field(0));
-    arnoldi_vectors.Resize(height, max_inner_iterations, Field(0));
-    preconditioned_vectors.Resize(height, max_inner_iterations, Field(0));
-    preconditioned_images.Resize(height, max_inner_iterations, Field(0));
-
-    // Set the initial guess of the outer iteration to the current estimate.
-    initial_solution = *solution;
-    if (status.num_outer_iterations > 0) {
-      initial_solution_image = solution_image;
-    } else {
-      initial_solution_image = initial_solution;
-    }
+  state->arnoldi_matrix.Resize(max_inner_iterations, max_inner_iterations,
+                               Field(0));
+  state->arnoldi_vectors.Resize(height, max_inner_iterations, Field(0));
+  state->preconditioned_vectors.Resize(height, max_inner_iterations,
+                                       Field(0));
+  state->preconditioned_images.Resize(height, max_inner_iterations, Field(0));
+
+  // Set the initial guess of the outer iteration to the current estimate.
+  state->initial_solution = solution;
+  if (state->status.num_outer_iterations > 0) {
+    state->initial_solution_image = state->solution_image;
+  } else {
+    state->initial_solution_image = state->initial_solution;
+  }
 
-    // Compute the two-norm of the current residual vector.
-    const Real outer_residual_norm = EuclideanNorm(residual.ConstView());
+  // Store the normalization of the current residual as the first column
+  // of the Arnoldi basis for the inner FGMRES iteration.
+  const Real outer_residual_norm =
+      EuclideanNorm(state->residual.ConstView());
+  for (Int i = 0; i < height; ++i) {
+    state->arnoldi_vectors(i, 0) = state->residual(i) / outer_residual_norm;
+  }
 
-    // Store the normalization of the current residual as the first column
-    // of the Arnoldi basis for the inner FGMRES iteration.
-    BlasMatrixView<Field> v0 = arnoldi_vectors.Submatrix(0, 0, height, 1);
-    for (Int i = 0; i < height; ++i) {
-      v0(i) = residual(i) / outer_residual_norm;
-    }
+  // Initialize the projected residual as beta e_0.
+  state->projected_residual.Resize(max_inner_iterations + 1, 1, Field(0));
+  state->projected_residual(0) = outer_residual_norm;
 
-    // Initialize the projected residual as beta e_0.
-    projected_residual.Resize(max_inner_iterations + 1, 1, Field(0));
-    projected_residual(0) = outer_residual_norm;
+  state->inner_iter = 0;
+  state->inner_iteration_cap = max_inner_iterations;
+  state->start_outer_iteration = false;
+}
 
-    // Run the inner FGMRES sequence.
-    Int inner_iteration_cap = max_inner_iterations;
-    for (Int inner_iter = 0; inner_iter < inner_iteration_cap; ++inner_iter) {
-      if (control.verbose) {
-        std::cout << "  Starting inner FGMRES iteration " << inner_iter
-                  << std::endl;
-      }
+// Ends the current outer iteration, so that the next inner iteration (if the
+// solve is not finished) restarts from the current estimate.
+template <class Field>
+void EndOuterIteration(ColumnState<Field>* state) {
+  ++state->status.num_outer_iterations;
+  state->start_outer_iteration = true;
+}
 
-      // Form the preconditioning of the most recent Arnoldi basis vector.
-      const ConstBlasMatrixView<Field> arnoldi_vector =
-          arnoldi_vectors.Submatrix(0, inner_iter, height, 1);
-      BlasMatrixView<Field> preconditioned_vector =
-          preconditioned_vectors.Submatrix(0, inner_iter, height, 1);
-      for (Int i = 0; i < height; ++i) {
-        preconditioned_vector(i) = arnoldi_vector(i);
-      }
-      apply_preconditioner(&preconditioned_vector);
-
-      // Form the image of the preconditioning of the Arnoldi basis vector.
-      BlasMatrixView<Field> preconditioned_image =
-          preconditioned_images.Submatrix(0, inner_iter, height, 1);
-      apply_matrix(Field(1), preconditioned_vector.ToConst(), Field(0),
-                   &preconditioned_image);
-      projected_image = preconditioned_image;
-
-      // Run an Arnoldi step.
-      for (Int i = 0; i <= inner_iter; ++i) {
-        // H(i, inner_iter) = v_i' w, where 'w' is the projected image.
-        const ConstBlasMatrixView<Field> vi =
-            arnoldi_vectors.Submatrix(0, i, height, 1);
-        Real arnoldi_component = Field(0);
-        for (Int k = 0; k < height; ++k) {
-          arnoldi_component += vi(k) * projected_image(k);
-        }
-        arnoldi_matrix(i, inner_iter) = arnoldi_component;
-
-        // w := w - v_i H(i, inner_iter).
-        for (Int k = 0; k < height; ++k) {
-          projected_image(k) -= arnoldi_component * vi(k);
-        }
-      }
-      const Real projected_image_norm =
-          EuclideanNorm(projected_image.ConstView());
-      if (!std::isfinite(projected_image_norm)) {
-        if (control.verbose) {
-          std::cout << "Non-finite projected image norm in FGMRES."
-                    << std::endl;
-        }
-        if (inner_iter == 0) {
-          finished = true;
-        }
-        ++status.num_iterations;
-        break;
-      }
-      if (projected_image_norm == Real(0)) {
-        inner_iteration_cap = inner_iter + 1;
-      }
-      if (inner_iter + 1 < inner_iteration_cap) {
-        // v_{j + 1} := w / || w ||_2.
-        BlasMatrixView<Field> new_arnoldi_vector =
-            arnoldi_vectors.Submatrix(0, inner_iter + 1, height, 1);
-        for (Int k = 0; k < height; ++k) {
-          new_arnoldi_vector(k) = projected_image(k) / projected_image_norm;
-        }
-      }
+// Orthogonalizes the projected image against the first 'num_vectors' Arnoldi
+// vectors using two passes of classical Gram-Schmidt, storing the
+// coefficients in column 'num_vectors - 1' of the Arnoldi matrix. Unlike
+// modified Gram-Schmidt, each pass is a pair of matrix products rather than a
+// sequence of dependent inner products.
+template <class Field>
+void Orthogonalize(Int num_vectors, ColumnState<Field>* state) {
+  const Int height = state->arnoldi_vectors.Height();
+  const ConstBlasMatrixView<Field> basis =
+      state->arnoldi_vectors.Submatrix(0, 0, height, num_vectors);
+  BlasMatrixView<Field> coefficients = state->arnoldi_matrix.Submatrix(
+      0, num_vectors - 1, num_vectors, 1);
+  BlasMatrixView<Field> image = state->projected_image.view;
+
+  // H(0 : j, j) = V' w, w := w - V H(0 : j, j).
+  MatrixMultiplyAdjointNormal(Field(1), basis, image.ToConst(), Field(0),
+                              &coefficients);
+  MatrixMultiplyNormalNormal(Field(-1), basis, coefficients.ToConst(),
+                             Field(1), &image);
+
+  // Reorthogonalize and accumulate the corrections into H(0 : j, j).
+  state->reorthogonalization.Resize(num_vectors, 1);
+  MatrixMultiplyAdjointNormal(Field(1), basis, image.ToConst(), Field(0),
+                              &state->reorthogonalization.view);
+  MatrixMultiplyNormalNormal(Field(-1), basis,
+                             state->reorthogonalization.ConstView(), Field(1),
+                             &image);
+  for (Int i = 0; i < num_vectors; ++i) {
+    coefficients(i) += state->reorthogonalization(i);
+  }
+}
 
-      // Apply the existing Givens rotations to the new column of H.
-      for (Int i = 0; i < inner_iter; ++i) {
-        givens_rotations[i].Apply(&arnoldi_matrix(i, inner_iter),
-                                  &arnoldi_matrix(i + 1, inner_iter));
-      }
+// Completes an inner iteration of a right-hand side, whose preconditioned
+// Arnoldi vector and its image have been stored.
+template <class Field>
+void InnerIteration(const FGMRESControl<ComplexBase<Field>>& control,
+                    const ConstBlasMatrixView<Field>& right_hand_side,
+                    BlasMatrixView<Field>* solution,
+                    ColumnState<Field>* state) {
+  typedef ComplexBase<Field> Real;
+  const Int height = right_hand_side.height;
+  const Int inner_iter = state->inner_iter;
+  FGMRESStatus<Real>& status = state->status;
+  BlasMatrix<Field>& arnoldi_matrix = state->arnoldi_matrix;
 
-      // Generate a new Givens rotation.
-      const Field eta_j_j = arnoldi_matrix(inner_iter, inner_iter);
-      const Real eta_jp1_j = projected_image_norm;
-      if (!std::isfinite(std::real(eta_j_j)) ||
-          !std::isfinite(std::imag(eta_j_j))) {
-        std::cout << "H(" << inner_iter << ", " << inner_iter
-                  << ") was non-finite." << std::endl;
-        if (inner_iter == 0) {
-          finished = true;
-        }
-        ++status.num_iterations;
-        break;
-      }
-      if (!std::isfinite(eta_jp1_j)) {
-        std::cout << "H(" << inner_iter + 1 << ", " << inner_iter << ") was "
-                  << "non-finite." << std::endl;
-        if (inner_iter == 0) {
-          finished = true;
-        }
-        ++status.num_iterations;
-        break;
-      }
-      GivensRotation<Field>& new_rotation = givens_rotations[inner_iter];
-      const Field combined_entry = new_rotation.Generate(eta_j_j, eta_jp1_j);
-      if (!std::isfinite(std::real(combined_entry)) ||
-          !std::isfinite(std::imag(combined_entry))) {
-        std::cout << "Givens rotation generation produced non-finite combined "
-                  << "entry." << std::endl;
-        if (inner_iter == 0) {
-          finished = true;
-        }
-        ++status.num_iterations;
-        break;
-      }
-      arnoldi_matrix(inner_iter, inner_iter) = combined_entry;
-
-      // Apply the new Givens rotation to the projected residual.
-      new_rotation.Apply(&projected_residual(inner_iter),
-                         &projected_residual(inner_iter + 1));
-
-      // Minimize the residual via a triangular solve to produce a vector, y.
-      const ConstBlasMatrixView<Field> arnoldi_matrix_active =
-          arnoldi_matrix.Submatrix(0, 0, inner_iter + 1, inner_iter + 1);
-      projected_solution = projected_residual;
-      TriangularSolveLeftUpper(arnoldi_matrix_active,
-                               projected_solution.Data());
-
-      // Set the new approximate solution via:
-      //
-      //   x := x_0 + Z_j y.
-      //
-      const ConstBlasMatrixView<Field> active_preconditioned_vectors =
-          preconditioned_vectors.Submatrix(0, 0, height, inner_iter + 1);
-      for (Int i = 0; i < height; ++i) {
-        solution->Entry(i) = initial_solution(i);
-      }
-      MatrixVectorProduct(Field(1), active_preconditioned_vectors,
-                          projected_solution.Data(), solution->Data());
-
-      // Form the image of the solution without applying A, via:
-      //
-      //   A x = A x_0 + (A Z_j) y.
-      //
-      const ConstBlasMatrixView<Field> active_preconditioned_images =
-          preconditioned_images.Submatrix(0, 0, height, inner_iter + 1);
-      solution_image = initial_solution_image;
-      MatrixVectorProduct(Field(1), active_preconditioned_images,
-                          projected_solution.Data(), solution_image.Data());
-
-      // Form the residual,
-      //
-      //   w := b - A x,
-      //
-      // and compute its two-norm.
-      //
-      for (Int i = 0; i < height; ++i) {
-        residual(i) = right_hand_side(i) - solution_image(i);
-      }
-      const Real residual_norm = EuclideanNorm(residual.ConstView());
-      const Real relative_residual_norm =
-          residual_norm / original_residual_norm;
-      status.relative_error = relative_residual_norm;
-      ++status.num_iterations;
-
-      // Check for convergence.
-      if (status.relative_error <= relative_tolerance) {
-        if (control.verbose) {
-          std::cout << "FGMRES converged with relative_error = "
-                    << status.relative_error << " < " << relative_tolerance
-                    << std::endl;
-        }
-        finished = true;
-        break;
-      } else if (control.verbose) {
-        std::cout << "  FGMRES inner iter finished with relative_error = "
-                  << status.relative_error << std::endl;
-      }
+  static const Real epsilon = std::numeric_limits<Real>::epsilon();
+  const Real relative_tolerance =
+      control.relative_tolerance_coefficient *
+      std::pow(epsilon, control.relative_tolerance_exponent);
 
-      if (status.num_iterations == control.max_iterations) {
-        if (control.verbose) {
-          std::cout << "FGMRES did not converge." << std::endl;
-        }
-        finished = true;
-        break;
-      }
+  // Gives up on the current outer iteration (and on the solve, if it was the
+  // first inner iteration).
+  auto abandon = [&]() {
+    if (inner_iter == 0) {
+      state->finished = true;
+    }
+    ++status.num_iterations;
+    EndOuterIteration(state);
+  };
+
+  // Run an Arnoldi step.
+  state->projected_image =
+      state->preconditioned_images.Submatrix(0, inner_iter, height, 1);
+  Orthogonalize(inner_iter + 1, state);
+  const Real projected_image_norm =
+      EuclideanNorm(state->projected_image.ConstView());
+  if (!std::isfinite(projected_image_norm)) {
+    if (control.verbose) {
+      std::cout << "Non-finite projected image norm in FGMRES." << std::endl;
+    }
+    abandon();
+    return;
+  }
+  if (projected_image_norm == Real(0)) {
+    state->inner_iteration_cap = inner_iter + 1;
+  }
+  if (inner_iter + 1 < state->inner_iteration_cap) {
+    // v_{j + 1} := w / || w ||_2.
+    for (Int k = 0; k < height; ++k) {
+      state->arnoldi_vectors(k, inner_iter + 1) =
+          state->projected_image(k) / projected_image_norm;
     }
-    ++status.num_outer_iterations;
   }
 
-  return status;
+  // Apply the existing Givens rotations to the new column of H.
+  for (Int i = 0; i < inner_iter; ++i) {
+    state->givens_rotations[i].Apply(&arnoldi_matrix(i, inner_iter),
+                                     &arnoldi_matrix(i + 1, inner_iter));
+  }
+
+  // Generate a new Givens rotation.
+  const Field eta_j_j = arnoldi_matrix(inner_iter, inner_iter);
+  const Real eta_jp1_j = projected_image_norm;
+  if (!std::isfinite(std::real(eta_j_j)) ||
+      !std::isfinite(std::imag(eta_j_j))) {
+    std::cout << "H(" << inner_iter << ", " << inner_iter
+              << ") was non-finite." << std::endl;
+    abandon();
+    return;
+  }
+  if (!std::isfinite(eta_jp1_j)) {
+    std::cout << "H(" << inner_iter + 1 << ", " << inner_iter << ") was "
+              << "non-finite." << std::endl;
+    abandon();
+    return;
+  }
+  GivensRotation<Field>& new_rotation = state->givens_rotations[inner_iter];
+  const Field combined_entry = new_rotation.Generate(eta_j_j, eta_jp1_j);
+  if (!std::isfinite(std::real(combined_entry)) ||
+      !std::isfinite(std::imag(combined_entry))) {
+    std::cout << "Givens rotation generation produced non-finite combined "
+              << "entry." << std::endl;
+    abandon();
+    return;
+  }
+  arnoldi_matrix(inner_iter, inner_iter) = combined_entry;
+
+  // Apply the new Givens rotation to the projected residual.
+  new_rotation.Apply(&state->projected_residual(inner_iter),
+                     &state->projected_residual(inner_iter + 1));
+
+  // Minimize the residual via a triangular solve to produce a vector, y.
+  const ConstBlasMatrixView<Field> arnoldi_matrix_active =
+      arnoldi_matrix.Submatrix(0, 0, inner_iter + 1, inner_iter + 1);
+  state->projected_solution = state->projected_residual;
+  TriangularSolveLeftUpper(arnoldi_matrix_active,
+                           state->projected_solution.Data());
+
+  // Set the new approximate solution via:
+  //
+  //   x := x_0 + Z_j y.
+  //
+  const ConstBlasMatrixView<Field> active_preconditioned_vectors =
+      state->preconditioned_vectors.Submatrix(0, 0, height, inner_iter + 1);
+  for (Int i = 0; i < height; ++i) {
+    solution->Entry(i) = state->initial_solution(i);
+  }
+  MatrixVectorProduct(Field(1), active_preconditioned_vectors,
+                      state->projected_solution.Data(), solution->Data());
+
+  // Form the image of the solution without applying A, via:
+  //
+  //   A x = A x_0 + (A Z_j) y.
+  //
+  const ConstBlasMatrixView<Field> active_preconditioned_images =
+      state->preconditioned_images.Submatrix(0, 0, height, inner_iter + 1);
+  state->solution_image = state->initial_solution_image;
+  MatrixVectorProduct(Field(1), active_preconditioned_images,
+                      state->projected_solution.Data(),
+                      state->solution_image.Data());
+
+  // Form the residual,
+  //
+  //   w := b - A x,
+  //
+  // and compute its two-norm.
+  //
+  for (Int i = 0; i < height; ++i) {
+    state->residual(i) = right_hand_side(i) - state->solution_image(i);
+  }
+  const Real residual_norm = EuclideanNorm(state->residual.ConstView());
+  status.relative_error = residual_norm / state->original_residual_norm;
+  ++status.num_iterations;
+
+  // Check for convergence.
+  if (status.relative_error <= relative_tolerance) {
+    if (control.verbose) {
+      std::cout << "FGMRES converged with relative_error = "
+                << status.relative_error << " < " << relative_tolerance
+                << std::endl;
+    }
+    state->finished = true;
+    EndOuterIteration(state);
+    return;
+  } else if (control.verbose) {
+    std::cout << "  FGMRES inner iter finished with relative_error = "
+              << status.relative_error << std::endl;
+  }
+
+  if (status.num_iterations == control.max_iterations) {
+    if (control.verbose) {
+      std::cout << "FGMRES did not converge." << std::endl;
+    }
+    state->finished = true;
+    EndOuterIteration(state);
+    return;
+  }
+
+  ++state->inner_iter;
+  if (state->inner_iter == state->inner_iteration_cap) {
+    EndOuterIteration(state);
+  }
 }
 
 }  // namespace fgmres
@@ -300,29 +315,102 @@ FGMRESStatus<ComplexBase<Field>> FGMRES(
     const FGMRESControl<ComplexBase<Field>>& control,
     const ConstBlasMatrixView<Field>& right_hand_sides,
     BlasMatrix<Field>* solutions) {
+  FGMRESWorkspace<Field> workspace;
+  return FGMRES(apply_matrix, apply_preconditioner, control, right_hand_sides,
+                solutions, &workspace);
+}
+
+template <class Field, class ApplyMatrix, class ApplyPreconditioner>
+FGMRESStatus<ComplexBase<Field>> FGMRES(
+    const ApplyMatrix apply_matrix,
+    const ApplyPreconditioner apply_preconditioner,
+    const FGMRESControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& right_hand_sides,
+    BlasMatrix<Field>* solutions, FGMRESWorkspace<Field>* workspace) {
   typedef ComplexBase<Field> Real;
   const Int height = right_hand_sides.height;
   const Int num_rhs = right_hand_sides.width;
   solutions->Resize(height, num_rhs);
 
-  FGMRESStatus<Real> status;
-  status.relative_error = 0;
-  status.num_iterations = 0;
-  status.num_outer_iterations = 0;
-
+  std::vector<fgmres::ColumnState<Field>>& states = workspace->states;
+  states.resize(num_rhs);
   for (Int j = 0; j < num_rhs; ++j) {
     const ConstBlasMatrixView<Field> rhs =
         right_hand_sides.Submatrix(0, j, height, 1);
     BlasMatrixView<Field> solution = solutions->Submatrix(0, j, height, 1);
-    auto single_status = fgmres::SingleSolve(apply_matrix, apply_preconditioner,
-                                             control, rhs, &solution);
+    fgmres::Initialize(control, rhs, &solution, &states[j]);
+  }
 
+  // Every unfinished right-hand side performs one inner iteration per sweep,
+  // so that the preconditioner and the matrix are each applied once per
+  // sweep to the batch of their Arnoldi vectors.
+  std::vector<Int>& active = workspace->active;
+  BlasMatrix<Field>& batch_vectors = workspace->batch_vectors;
+  BlasMatrix<Field>& batch_images = workspace->batch_images;
+  while (true) {
+    active.clear();
+    for (Int j = 0; j < num_rhs; ++j) {
+      if (!states[j].finished) {
+        active.push_back(j);
+      }
+    }
+    const Int num_active = active.size();
+    if (!num_active) {
+      break;
+    }
+
+    // Gather the most recent Arnoldi vector of each active right-hand side.
+    batch_vectors.Resize(height, num_active);
+    for (Int k = 0; k < num_active; ++k) {
+      const Int j = active[k];
+      fgmres::ColumnState<Field>& state = states[j];
+      if (state.start_outer_iteration) {
+        fgmres::StartOuterIteration(control,
+                                    solutions->Submatrix(0, j, height, 1),
+                                    &state);
+      }
+      if (control.verbose) {
+        std::cout << "  Starting inner FGMRES iteration " << state.inner_iter
+                  << std::endl;
+      }
+      for (Int i = 0; i < height; ++i) {
+        batch_vectors(i, k) = state.arnoldi_vectors(i, state.inner_iter);
+      }
+    }
+
+    // Form the preconditioning of the Arnoldi vectors and their images.
+    apply_preconditioner(&batch_vectors.view);
+    batch_images.Resize(height, num_active);
+    apply_matrix(Field(1), batch_vectors.ConstView(), Field(0),
+                 &batch_images.view);
+
+    for (Int k = 0; k < num_active; ++k) {
+      const Int j = active[k];
+      fgmres::ColumnState<Field>& state = states[j];
+      for (Int i = 0; i < height; ++i) {
+        state.preconditioned_vectors(i, state.inner_iter) =
+            batch_vectors(i, k);
+        state.preconditioned_images(i, state.inner_iter) =
+            batch_images(i, k);
+      }
+      const ConstBlasMatrixView<Field> rhs =
+          right_hand_sides.Submatrix(0, j, height, 1);
+      BlasMatrixView<Field> solution = solutions->Submatrix(0, j, height, 1);
+      fgmres::InnerIteration(control, rhs, &solution, &state);
+    }
+  }
+
+  FGMRESStatus<Real> status;
+  status.relative_error = 0;
+  status.num_iterations = 0;
+  status.num_outer_iterations = 0;
+  for (const fgmres::ColumnState<Field>& state : states) {
     status.relative_error =
-        std::max(status.relative_error, single_status.relative_error);
+        std::max(status.relative_error, state.status.relative_error);
     status.num_iterations =
-        std::max(status.num_iterations, single_status.num_iterations);
+        std::max(status.num_iterations, state.status.num_iterations);
     status.num_outer_iterations = std::max(status.num_outer_iterations,
-                                           single_status.num_outer_iterations);
+                                           state.status.num_outer_iterations);
   }
 
   return status;
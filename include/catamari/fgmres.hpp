@@ -7,7 +7,10 @@
 #ifndef CATAMARI_FGMRES_H_
 #define CATAMARI_FGMRES_H_
 
+#include <vector>
+
 #include "catamari/blas_matrix.hpp"
+#include "catamari/givens_rotation.hpp"
 
 namespace catamari {
 
@@ -62,6 +65,70 @@ struct FGMRESStatus {
   Int num_outer_iterations;
 };
 
+namespace fgmres {
+
+// The state of the FGMRES iteration for a single right-hand side.
+template <class Field>
+struct ColumnState {
+  typedef ComplexBase<Field> Real;
+
+  // The summary of the iteration so far.
+  FGMRESStatus<Real> status;
+
+  // Whether the iteration has converged or given up.
+  bool finished = false;
+
+  // Whether the next inner iteration begins a new outer iteration.
+  bool start_outer_iteration = true;
+
+  // The index of the current inner iteration and the number of inner
+  // iterations allowed in the current outer iteration.
+  Int inner_iter = 0;
+  Int inner_iteration_cap = 0;
+
+  // The two-norm of the right-hand side.
+  Real original_residual_norm = 0;
+
+  std::vector<GivensRotation<Field>> givens_rotations;
+  BlasMatrix<Field> arnoldi_matrix;
+  BlasMatrix<Field> arnoldi_vectors;
+  BlasMatrix<Field> preconditioned_vectors;
+  BlasMatrix<Field> preconditioned_images;
+  BlasMatrix<Field> projected_image;
+  BlasMatrix<Field> projected_residual;
+  BlasMatrix<Field> projected_solution;
+  BlasMatrix<Field> reorthogonalization;
+  BlasMatrix<Field> residual;
+  BlasMatrix<Field> initial_solution;
+  BlasMatrix<Field> solution_image;
+  BlasMatrix<Field> initial_solution_image;
+};
+
+}  // namespace fgmres
+
+// The buffers of an FGMRES solve. A workspace can be passed to successive
+// calls to 'FGMRES' so that, once the first call has sized them, solves with
+// the same dimensions and control do not allocate.
+template <class Field>
+struct FGMRESWorkspace {
+  // The iteration state of each right-hand side.
+  std::vector<fgmres::ColumnState<Field>> states;
+
+  // The indices of the right-hand sides that are still being iterated on.
+  std::vector<Int> active;
+
+  // The batches of Arnoldi vectors and their images passed to the callbacks.
+  BlasMatrix<Field> batch_vectors;
+  BlasMatrix<Field> batch_images;
+};
+
+// Solves 'A X = B' with restarted FGMRES. All of the columns of 'B' are
+// iterated in lockstep, so that each inner iteration makes a single call to
+// 'apply_preconditioner' and to 'apply_matrix' on the block of (not yet
+// converged) columns; both callbacks should therefore accept views with an
+// arbitrary number of columns. Each Arnoldi vector is orthogonalized with
+// classical Gram-Schmidt with reorthogonalization (CGS2) using matrix-vector
+// products against the basis.
 template <class Field, class ApplyMatrix, class ApplyPreconditioner>
 FGMRESStatus<ComplexBase<Field>> FGMRES(
     const ApplyMatrix apply_matrix,
@@ -70,6 +137,15 @@ FGMRESStatus<ComplexBase<Field>> FGMRES(
     const ConstBlasMatrixView<Field>& right_hand_sides,
     BlasMatrix<Field>* solutions);
 
+// Equivalent to the above, but reuses the buffers held by 'workspace'.
+template <class Field, class ApplyMatrix, class ApplyPreconditioner>
+FGMRESStatus<ComplexBase<Field>> FGMRES(
+    const ApplyMatrix apply_matrix,
+    const ApplyPreconditioner apply_preconditioner,
+    const FGMRESControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& right_hand_sides,
+    BlasMatrix<Field>* solutions, FGMRESWorkspace<Field>* workspace);
+
 }  // namespace catamari
 
 #include "catamari/fgmres-impl.hpp"
@@ -9,6 +9,7 @@
 #define CATAMARI_FLUSH_TO_ZERO_H_
 
 #ifdef CATAMARI_HAVE_XMMINTRIN
+#include <pmmintrin.h>
 #include <xmmintrin.h>
 #elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
 #include <cfenv>
@@ -17,12 +18,14 @@
 namespace catamari {
 
 // Avoid the potential for order-of-magnitude performance degradation from
-// slow subnormal processing.
+// slow subnormal processing: both subnormal results (flush-to-zero) and
+// subnormal inputs (denormals-are-zero) are treated as zero.
 //
 // Note that this flushing is not guaranteed on all platforms.
 inline void EnableFlushToZero() {
 #ifdef CATAMARI_HAVE_XMMINTRIN
   _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+  _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
 #elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
 #pragma FENV_ACCESS ON
 #ifdef X86
@@ -33,32 +36,94 @@ inline void EnableFlushToZero() {
 #endif  // ifdef CATAMARI_HAVE_XMMINTRIN
 }
 
-struct ScopedEnableFlushToZero {
-    ScopedEnableFlushToZero() {
+// The subnormal handling of the floating-point environment of a thread.
+struct FlushToZeroState {
 #ifdef CATAMARI_HAVE_XMMINTRIN
-        m_mode = _MM_GET_FLUSH_ZERO_MODE();
-#else
-        fegetenv(&m_env);
-#endif
-        EnableFlushToZero();
-    }
+  unsigned int flush_zero_mode;
+  unsigned int denormals_zero_mode;
+#elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
+  fenv_t env;
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
 
-    ~ScopedEnableFlushToZero() {
+  // Records the state of the calling thread.
+  void Save() {
 #ifdef CATAMARI_HAVE_XMMINTRIN
-        _MM_SET_FLUSH_ZERO_MODE(m_mode);
-#else
-        fesetenv(&m_env);
-#endif
-    }
+    flush_zero_mode = _MM_GET_FLUSH_ZERO_MODE();
+    denormals_zero_mode = _MM_GET_DENORMALS_ZERO_MODE();
+#elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
+    fegetenv(&env);
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
+  }
 
-private:
+  // Restores the recorded state on the calling thread.
+  void Restore() const {
 #ifdef CATAMARI_HAVE_XMMINTRIN
-    int m_mode;
+    _MM_SET_FLUSH_ZERO_MODE(flush_zero_mode);
+    _MM_SET_DENORMALS_ZERO_MODE(denormals_zero_mode);
+#elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
+    fesetenv(&env);
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
+  }
+};
+
+namespace flush_to_zero {
+
+// The number of (possibly nested) requests for flushing which are active on
+// the calling thread, and the state from before the first of them.
+struct ThreadRequests {
+  int depth = 0;
+  FlushToZeroState state;
+};
+
+inline ThreadRequests& LocalThreadRequests() {
+  static thread_local ThreadRequests requests;
+  return requests;
+}
+
+// Enables flushing on the calling thread, recording its previous state if
+// this is its outermost request. Returns whether it was.
+inline bool BeginRequest() {
+  ThreadRequests& requests = LocalThreadRequests();
+  const bool outermost = requests.depth++ == 0;
+  if (outermost) {
+    requests.state.Save();
+    EnableFlushToZero();
+  }
+  return outermost;
+}
+
+// Ends a request on the calling thread, restoring its previous state if
+// this was its outermost request.
+inline void EndRequest() {
+  ThreadRequests& requests = LocalThreadRequests();
+  if (requests.depth > 0 && --requests.depth == 0) {
+    requests.state.Restore();
+  }
+}
+
+// Returns whether subnormals are flushed to zero on the calling thread -- or,
+// where this cannot be queried, whether a request for flushing is active on
+// it. Where flushing is not supported, there is nothing to enable, and true
+// is returned.
+inline bool IsEnabled() {
+#ifdef CATAMARI_HAVE_XMMINTRIN
+  return _MM_GET_FLUSH_ZERO_MODE() == _MM_FLUSH_ZERO_ON &&
+         _MM_GET_DENORMALS_ZERO_MODE() == _MM_DENORMALS_ZERO_ON;
+#elif CATAMARI_HAVE_FENV_DISABLE_DENORMS
+  return LocalThreadRequests().depth > 0;
 #else
-    fenv_t m_env;
-#endif
+  return true;
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
+}
+
+// Enables flushing on the calling thread for the lifetime of the object.
+struct ScopedRequest {
+  ScopedRequest() { BeginRequest(); }
+  ~ScopedRequest() { EndRequest(); }
 };
 
+}  // namespace flush_to_zero
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_FLUSH_TO_ZERO_H_
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HARDWARE_COUNTERS_IMPL_H_
+#define CATAMARI_HARDWARE_COUNTERS_IMPL_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // ifdef __linux__
+
+#include "catamari/hardware_counters.hpp"
+
+namespace catamari {
+
+namespace hardware_counters {
+
+#ifdef __linux__
+// Opens a user-space counter of the calling thread on any CPU, in the group
+// of the given leader (or as a leader if it is negative).
+inline int OpenCounter(std::uint32_t type, std::uint64_t config,
+                       int group_fd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif  // ifdef __linux__
+
+// The counter group of a thread, which is closed when the thread exits.
+struct ThreadCounters {
+  // The file descriptors of the cycle counter (the group leader) and of the
+  // last-level cache miss counter, or -1 if they are not open.
+  int cycles_fd = -1;
+  int llc_misses_fd = -1;
+
+  ThreadCounters() {
+#ifdef __linux__
+    cycles_fd = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (cycles_fd < 0) return;
+    llc_misses_fd = OpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+                                cycles_fd);
+    if (llc_misses_fd < 0) {
+      close(cycles_fd);
+      cycles_fd = -1;
+    }
+#endif  // ifdef __linux__
+  }
+
+  ~ThreadCounters() {
+#ifdef __linux__
+    if (llc_misses_fd >= 0) close(llc_misses_fd);
+    if (cycles_fd >= 0) close(cycles_fd);
+#endif  // ifdef __linux__
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+};
+
+// Returns the calling thread's counter group.
+inline ThreadCounters& LocalCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+// Returns the ratio of two counts, or zero if the denominator vanishes.
+inline double SafeRatio(double numerator, double denominator) {
+  return denominator > 0 ? numerator / denominator : 0.;
+}
+
+// Writes one line of the report.
+inline void WriteReportLine(const PhaseCounters& counters,
+                            Int cache_line_size, std::ostream& os) {
+  const double bytes = double(counters.llc_misses) * cache_line_size;
+  os << std::setw(12) << counters.seconds << std::setw(16) << counters.cycles
+     << std::setw(14) << counters.llc_misses << std::setw(12)
+     << counters.flops / 1.e9 << std::setw(12)
+     << SafeRatio(counters.flops / 1.e9, counters.seconds) << std::setw(12)
+     << SafeRatio(counters.flops, bytes) << std::setw(12)
+     << SafeRatio(bytes / 1.e9, counters.seconds) << "\n";
+}
+
+}  // namespace hardware_counters
+
+inline const char* CounterPhaseName(CounterPhase phase) {
+  switch (phase) {
+    case kMergeCounterPhase:
+      return "merge";
+    case kFactorCounterPhase:
+      return "factor";
+    case kTrsmCounterPhase:
+      return "trsm";
+    case kHerkCounterPhase:
+      return "herk";
+    default:
+      return "unknown";
+  }
+}
+
+inline bool HardwareCountersAvailable() {
+  return hardware_counters::LocalCounters().cycles_fd >= 0;
+}
+
+inline HardwareCounterReading ReadHardwareCounters() {
+  HardwareCounterReading reading;
+  reading.nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count();
+#ifdef __linux__
+  const hardware_counters::ThreadCounters& counters =
+      hardware_counters::LocalCounters();
+  if (counters.cycles_fd >= 0) {
+    // The group is read as its number of counters followed by their values.
+    std::uint64_t values[3];
+    if (read(counters.cycles_fd, values, sizeof(values)) ==
+            ssize_t(sizeof(values)) &&
+        values[0] == 2) {
+      reading.cycles = values[1];
+      reading.llc_misses = values[2];
+    }
+  }
+#endif  // ifdef __linux__
+  return reading;
+}
+
+inline PhaseCounterScope::PhaseCounterScope(PhaseCounters* counters,
+                                            double flops)
+    : counters_(counters), begin_(ReadHardwareCounters()) {
+  counters_->flops += flops;
+}
+
+inline PhaseCounterScope::~PhaseCounterScope() {
+  const HardwareCounterReading end = ReadHardwareCounters();
+  counters_->seconds += (end.nanoseconds - begin_.nanoseconds) / 1.e9;
+  counters_->cycles += end.cycles - begin_.cycles;
+  counters_->llc_misses += end.llc_misses - begin_.llc_misses;
+}
+
+inline void SupernodeCountersToReport(const std::string& filename,
+                                      const Buffer<SupernodeCounters>& counters,
+                                      Int cache_line_size) {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return;
+  }
+
+  const Int num_supernodes = counters.Size();
+  PhaseCounters totals[kNumCounterPhases];
+  std::vector<double> supernode_seconds(num_supernodes, 0.);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    for (int phase = 0; phase < kNumCounterPhases; ++phase) {
+      const PhaseCounters& phase_counters = counters[supernode].phases[phase];
+      totals[phase].seconds += phase_counters.seconds;
+      totals[phase].cycles += phase_counters.cycles;
+      totals[phase].llc_misses += phase_counters.llc_misses;
+      totals[phase].flops += phase_counters.flops;
+      supernode_seconds[supernode] += phase_counters.seconds;
+    }
+  }
+
+  std::vector<Int> order;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    if (supernode_seconds[supernode] > 0) order.push_back(supernode);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](Int a, Int b) {
+    return supernode_seconds[a] > supernode_seconds[b];
+  });
+
+  const char* kColumns =
+      "     seconds          cycles    llc_misses      gflops  gflops/sec"
+      "  flops/byte   gbyte/sec\n";
+  file << "# Hardware counters: "
+       << (HardwareCountersAvailable() ? "perf_event" : "unavailable")
+       << ", cache line: " << cache_line_size << " bytes\n";
+  file << "# Totals by phase\n"
+       << "phase  " << kColumns;
+  for (int phase = 0; phase < kNumCounterPhases; ++phase) {
+    file << std::left << std::setw(7)
+         << CounterPhaseName(static_cast<CounterPhase>(phase)) << std::right;
+    hardware_counters::WriteReportLine(totals[phase], cache_line_size, file);
+  }
+
+  file << "\n# Supernodes by decreasing time\n"
+       << " supernode      size    degree  phase  " << kColumns;
+  for (const Int supernode : order) {
+    const SupernodeCounters& supernode_counters = counters[supernode];
+    for (int phase = 0; phase < kNumCounterPhases; ++phase) {
+      const PhaseCounters& phase_counters = supernode_counters.phases[phase];
+      if (phase_counters.seconds == 0 && phase_counters.flops == 0) continue;
+      file << std::setw(10) << supernode << std::setw(10)
+           << supernode_counters.size << std::setw(10)
+           << supernode_counters.degree << "  " << std::left << std::setw(7)
+           << CounterPhaseName(static_cast<CounterPhase>(phase)) << std::right;
+      hardware_counters::WriteReportLine(phase_counters, cache_line_size,
+                                         file);
+    }
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_HARDWARE_COUNTERS_IMPL_H_
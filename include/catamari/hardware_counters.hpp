@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HARDWARE_COUNTERS_H_
+#define CATAMARI_HARDWARE_COUNTERS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "catamari/buffer.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+
+// The phases of the processing of a supernode which hardware counters are
+// attributed to.
+enum CounterPhase {
+  // The assembly of the children's Schur complements into the front.
+  kMergeCounterPhase,
+
+  // The factorization of the diagonal block.
+  kFactorCounterPhase,
+
+  // The solve of the subdiagonal block against the diagonal block.
+  kTrsmCounterPhase,
+
+  // The (scaled) Hermitian outer product forming the Schur complement.
+  kHerkCounterPhase,
+
+  kNumCounterPhases,
+};
+
+// Returns the lowercase name of a counter phase, e.g., "merge".
+const char* CounterPhaseName(CounterPhase phase);
+
+// A snapshot of the calling thread's counters.
+struct HardwareCounterReading {
+  // The nanoseconds elapsed on a steady clock.
+  std::uint64_t nanoseconds = 0;
+
+  // The (user-space) core cycles.
+  std::uint64_t cycles = 0;
+
+  // The last-level cache misses.
+  std::uint64_t llc_misses = 0;
+};
+
+// Returns true if the calling thread could open its cycle and last-level
+// cache miss counters through the Linux perf_event interface. Otherwise, the
+// readings only track the elapsed time. The kernel's 'perf_event_paranoid'
+// setting must be at most two for the (user-space only) counters to open.
+bool HardwareCountersAvailable();
+
+// Returns a snapshot of the calling thread's counters, lazily opening them
+// upon the first call from each thread.
+HardwareCounterReading ReadHardwareCounters();
+
+// The counts accumulated by one phase of a supernode.
+struct PhaseCounters {
+  // The elapsed seconds.
+  double seconds = 0;
+
+  // The core cycles.
+  std::uint64_t cycles = 0;
+
+  // The last-level cache misses.
+  std::uint64_t llc_misses = 0;
+
+  // The (analytic) number of floating-point operations.
+  double flops = 0;
+};
+
+// The counts of each of the phases of a supernode.
+struct SupernodeCounters {
+  // The number of columns of the supernode.
+  Int size = 0;
+
+  // The number of rows of the supernode's subdiagonal block.
+  Int degree = 0;
+
+  // The counts of each phase, indexed by 'CounterPhase'.
+  PhaseCounters phases[kNumCounterPhases];
+};
+
+// Accumulates the counts of the calling thread over the lifetime of the
+// scope, along with an analytic operation count, into a phase.
+class PhaseCounterScope {
+ public:
+  PhaseCounterScope(PhaseCounters* counters, double flops);
+  ~PhaseCounterScope();
+
+  PhaseCounterScope(const PhaseCounterScope&) = delete;
+  PhaseCounterScope& operator=(const PhaseCounterScope&) = delete;
+
+ private:
+  // The phase the counts are accumulated into.
+  PhaseCounters* counters_;
+
+  // The counters upon construction.
+  HardwareCounterReading begin_;
+};
+
+// Writes a roofline-style report of the per-supernode counters: for each
+// phase, and then for each phase of each supernode (in decreasing order of
+// elapsed time), the achieved GFlop/sec is listed next to the arithmetic
+// intensity, in flops per byte moved past the last-level cache (assuming
+// each miss moves 'cache_line_size' bytes), and the corresponding
+// bandwidth. Supernodes whose phases took no time are skipped.
+void SupernodeCountersToReport(const std::string& filename,
+                               const Buffer<SupernodeCounters>& counters,
+                               Int cache_line_size = 64);
+
+}  // namespace catamari
+
+// Attributes the counts of the remainder of the enclosing scope to the given
+// phase of a 'SupernodeCounters'. It expands to nothing unless the hardware
+// counters are enabled.
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+#define CATAMARI_COUNT_PHASE(supernode_counters, phase, flops)    \
+  catamari::PhaseCounterScope catamari_phase_counter_scope(      \
+      &(supernode_counters).phases[catamari::phase], (flops))
+#else
+#define CATAMARI_COUNT_PHASE(supernode_counters, phase, flops)
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+
+#include "catamari/hardware_counters-impl.hpp"
+
+#endif  // ifndef CATAMARI_HARDWARE_COUNTERS_H_
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_H_
+#define CATAMARI_HELMHOLTZ_PML_H_
+
+// Generators of finite-element discretizations of the 2D and 3D Helmholtz
+// equations in the unit box with Perfectly Matched Layer absorbing boundary
+// conditions on all sides, over bilinear (Q4) rectangles and trilinear
+// hexahedra, respectively. The bilinear forms are integrated over each element
+// using a simple tensor product of three-point 1D Gaussian quadratures.
+//
+// A good reference for the weak formulation of the Helmholtz equation with PML
+// is:
+//
+//   Erkki Heikkola, Tuomo Rossi, and Jari Toivanen,
+//   "Fast solvers for the Helmholtz equation with a perfectly matched layer /
+//   an absorbing boundary condition", 2002.
+//
+#include "catamari/helmholtz_pml/common.hpp"
+#include "catamari/helmholtz_pml/helmholtz_2d.hpp"
+#include "catamari/helmholtz_pml/helmholtz_3d.hpp"
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_H_
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_COMMON_IMPL_H_
+#define CATAMARI_HELMHOLTZ_PML_COMMON_IMPL_H_
+
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/helmholtz_pml/common.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+template <typename Real>
+Complex<Real> GaussianSource2D<Real>::operator()(
+    const Point2D<Real>& target) const {
+  const Real variance = stddev * stddev;
+  const Real x_diff = target.x - point.x;
+  const Real y_diff = target.y - point.y;
+  const Real dist_squared = x_diff * x_diff + y_diff * y_diff;
+  const Real gaussian = scale * std::exp(-dist_squared / (2 * variance));
+  return Complex<Real>(gaussian);
+}
+
+template <typename Real>
+Complex<Real> GaussianSource3D<Real>::operator()(
+    const Point3D<Real>& target) const {
+  const Real variance = stddev * stddev;
+  const Real x_diff = target.x - point.x;
+  const Real y_diff = target.y - point.y;
+  const Real z_diff = target.z - point.z;
+  const Real dist_squared =
+      x_diff * x_diff + y_diff * y_diff + z_diff * z_diff;
+  const Real gaussian = scale * std::exp(-dist_squared / (2 * variance));
+  return Complex<Real>(gaussian);
+}
+
+template <typename Real>
+Speed<Real>::Speed(SpeedProfile profile) : profile_(profile) {}
+
+template <typename Real>
+Real Speed<Real>::FreeSpace(const Point2D<Real>& point) const {
+  return Real{1};
+}
+
+template <typename Real>
+Real Speed<Real>::FreeSpace(const Point3D<Real>& point) const {
+  return Real{1};
+}
+
+template <typename Real>
+Real Speed<Real>::ConvergingLens(const Point2D<Real>& point) const {
+  const Real x_center = Real{1} / Real{2};
+  const Real y_center = Real{1} / Real{2};
+  const Real center_speed = 0.675;
+  const Real max_speed = 1.325;
+  const Real variance = 0.01;
+  const Real dist_squared = (point.x - x_center) * (point.x - x_center) +
+                            (point.y - y_center) * (point.y - y_center);
+  const Real gaussian_scale = max_speed - center_speed;
+  return max_speed - gaussian_scale * std::exp(-dist_squared / (2 * variance));
+}
+
+template <typename Real>
+Real Speed<Real>::ConvergingLens(const Point3D<Real>& point) const {
+  const Real x_center = Real{1} / Real{2};
+  const Real y_center = Real{1} / Real{2};
+  const Real z_center = Real{1} / Real{2};
+  const Real center_speed = 0.675;
+  const Real max_speed = 1.325;
+  const Real variance = 0.01;
+  const Real dist_squared = (point.x - x_center) * (point.x - x_center) +
+                            (point.y - y_center) * (point.y - y_center) +
+                            (point.z - z_center) * (point.z - z_center);
+  const Real gaussian_scale = max_speed - center_speed;
+  return max_speed - gaussian_scale * std::exp(-dist_squared / (2 * variance));
+}
+
+template <typename Real>
+Real Speed<Real>::WaveGuide(const Point2D<Real>& point) const {
+  const Real x_center = Real{1} / Real{2};
+  const Real center_speed = 0.675;
+  const Real max_speed = 1.325;
+  const Real variance = 0.01;
+  const Real dist_squared = (point.x - x_center) * (point.x - x_center);
+  const Real gaussian_scale = max_speed - center_speed;
+  return max_speed - gaussian_scale * std::exp(-dist_squared / (2 * variance));
+}
+
+template <typename Real>
+Real Speed<Real>::WaveGuide(const Point3D<Real>& point) const {
+  return WaveGuide(Point2D<Real>{point.x, point.y});
+}
+
+template <typename Real>
+template <class Point>
+Real Speed<Real>::Evaluate(const Point& point) const {
+  if (profile_ == kFreeSpace) {
+    return FreeSpace(point);
+  } else if (profile_ == kConvergingLens) {
+    return ConvergingLens(point);
+  } else if (profile_ == kWaveGuide) {
+    return WaveGuide(point);
+  } else {
+    return 1;
+  }
+}
+
+template <typename Real>
+Real Speed<Real>::operator()(const Point2D<Real>& point) const {
+  return Evaluate(point);
+}
+
+template <typename Real>
+Real Speed<Real>::operator()(const Point3D<Real>& point) const {
+  return Evaluate(point);
+}
+
+template <typename Real>
+PMLDifferential<Real>::PMLDifferential(const Real& omega,
+                                       const Real& pml_scale,
+                                       const Real& pml_exponent,
+                                       const Real& pml_width)
+    : omega_(omega),
+      pml_scale_(pml_scale),
+      pml_exponent_(pml_exponent),
+      pml_width_(pml_width) {}
+
+template <typename Real>
+Complex<Real> PMLDifferential<Real>::operator()(const Real& x) const {
+  Real profile;
+  const Real first_pml_end = pml_width_;
+  const Real last_pml_beg = 1 - pml_width_;
+  if (x < first_pml_end) {
+    const Real pml_rel_depth = (first_pml_end - x) / pml_width_;
+    profile = pml_scale_ * std::pow(pml_rel_depth, pml_exponent_);
+  } else if (x > last_pml_beg) {
+    const Real pml_rel_depth = (x - last_pml_beg) / pml_width_;
+    profile = pml_scale_ * std::pow(pml_rel_depth, pml_exponent_);
+  } else {
+    profile = 0;
+  }
+
+  return Complex<Real>(Real{1}, profile / omega_);
+}
+
+template <typename Real>
+void ThirdOrderGaussianPointsAndWeights(const Real& a, const Real& b,
+                                        Real* points, Real* weights) {
+  const Real scale = (b - a) / 2;
+
+  static const Real orig_points[] = {-std::sqrt(Real{3}) / std::sqrt(Real{5}),
+                                     Real{0},
+                                     std::sqrt(Real{3}) / std::sqrt(Real{5})};
+
+  static const Real orig_weights[] = {Real(5) / Real(9), Real(8) / Real(9),
+                                      Real(5) / Real(9)};
+
+  for (int i = 0; i < 3; ++i) {
+    points[i] = a + scale * (1 + orig_points[i]);
+    weights[i] = scale * orig_weights[i];
+  }
+}
+
+template <int kDimension>
+constexpr int ElementGrid<kDimension>::kNumElementNodes;
+
+template <int kDimension>
+Int ElementGrid<kDimension>::NumNodes() const {
+  Int num_nodes = 1;
+  for (int dimension = 0; dimension < kDimension; ++dimension) {
+    num_nodes *= num_elements[dimension] + 1;
+  }
+  return num_nodes;
+}
+
+template <int kDimension>
+Int ElementGrid<kDimension>::NumElements() const {
+  Int num_grid_elements = 1;
+  for (int dimension = 0; dimension < kDimension; ++dimension) {
+    num_grid_elements *= num_elements[dimension];
+  }
+  return num_grid_elements;
+}
+
+template <int kDimension>
+Int ElementGrid<kDimension>::NodeStride(int dimension) const {
+  Int stride = 1;
+  for (int lower = 0; lower < dimension; ++lower) {
+    stride *= num_elements[lower] + 1;
+  }
+  return stride;
+}
+
+template <int kDimension, class Field>
+void FormElementGridPattern(const ElementGrid<kDimension>& grid,
+                            CoordinateMatrix<Field>* pattern) {
+  const Int num_rows = grid.NumNodes();
+  Int num_neighbor_offsets = 1;
+  for (int dimension = 0; dimension < kDimension; ++dimension) {
+    num_neighbor_offsets *= 3;
+  }
+
+  // In each direction, a node is coupled to itself and to each of the
+  // neighbors which exist.
+  auto decode_row = [&](Int row, Int* coordinates, Int* counts) {
+    Int num_row_entries = 1;
+    for (int dimension = 0; dimension < kDimension; ++dimension) {
+      const Int num_nodes = grid.num_elements[dimension] + 1;
+      coordinates[dimension] = row % num_nodes;
+      row /= num_nodes;
+      counts[dimension] = 1 + (coordinates[dimension] > 0) +
+                          (coordinates[dimension] < num_nodes - 1);
+      num_row_entries *= counts[dimension];
+    }
+    return num_row_entries;
+  };
+
+  Buffer<Int> row_counts(num_rows);
+  tbb::parallel_for(tbb::blocked_range<Int>(0, num_rows),
+                    [&](const tbb::blocked_range<Int>& range) {
+                      Int coordinates[kDimension];
+                      Int counts[kDimension];
+                      for (Int row = range.begin(); row < range.end(); ++row) {
+                        row_counts[row] = decode_row(row, coordinates, counts);
+                      }
+                    });
+  Buffer<Int> row_entry_offsets;
+  quotient::OffsetScan(row_counts, &row_entry_offsets);
+
+  // Since the node strides increase with the dimension, traversing the
+  // neighbor offsets with the first dimension varying fastest generates the
+  // columns of each row in increasing order.
+  Buffer<MatrixEntry<Field>> entries(row_entry_offsets[num_rows]);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        Int coordinates[kDimension];
+        Int counts[kDimension];
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          decode_row(row, coordinates, counts);
+          Int index = row_entry_offsets[row];
+          for (Int neighbor = 0; neighbor < num_neighbor_offsets;
+               ++neighbor) {
+            Int column = row;
+            Int remainder = neighbor;
+            bool valid = true;
+            for (int dimension = 0; dimension < kDimension; ++dimension) {
+              const Int offset = remainder % 3 - 1;
+              remainder /= 3;
+              const Int coordinate = coordinates[dimension] + offset;
+              if (coordinate < 0 || coordinate > grid.num_elements[dimension]) {
+                valid = false;
+                break;
+              }
+              column += offset * grid.NodeStride(dimension);
+            }
+            if (valid) {
+              entries[index++] = MatrixEntry<Field>{row, column, Field{0}};
+            }
+          }
+        }
+      });
+
+  pattern->Empty();
+  pattern->Resize(num_rows, num_rows);
+  pattern->SetSortedEntries(std::move(entries));
+}
+
+template <int kDimension>
+Int ElementGridEntryIndex(const ElementGrid<kDimension>& grid,
+                          const Buffer<Int>& row_entry_offsets,
+                          const Int* coordinates, const int* offsets) {
+  // The neighbors of the row are enumerated in the same order as in
+  // 'FormElementGridPattern', so the position of the entry within its row is
+  // a mixed-radix number whose digits are the ranks of its offsets among the
+  // admissible offsets of each direction.
+  Int row = 0;
+  Int position = 0;
+  Int position_stride = 1;
+  for (int dimension = 0; dimension < kDimension; ++dimension) {
+    const Int coordinate = coordinates[dimension];
+    const Int num_nodes = grid.num_elements[dimension] + 1;
+    row += coordinate * grid.NodeStride(dimension);
+    position += (offsets[dimension] + (coordinate > 0)) * position_stride;
+    position_stride *= 1 + (coordinate > 0) + (coordinate < num_nodes - 1);
+  }
+  return row_entry_offsets[row] + position;
+}
+
+template <int kDimension, class ElementFunction>
+void ForEachGridElement(const ElementGrid<kDimension>& grid,
+                        const ElementFunction& element_function) {
+  const int num_colors = 1 << kDimension;
+  for (int color = 0; color < num_colors; ++color) {
+    // The elements of this color are those whose coordinates have the
+    // parities of the bits of the color.
+    Int num_color_elements[kDimension];
+    Int num_total_color_elements = 1;
+    for (int dimension = 0; dimension < kDimension; ++dimension) {
+      const Int parity = (color >> dimension) & 1;
+      num_color_elements[dimension] =
+          (grid.num_elements[dimension] - parity + 1) / 2;
+      num_total_color_elements *= num_color_elements[dimension];
+    }
+    if (num_total_color_elements <= 0) {
+      continue;
+    }
+
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(0, num_total_color_elements),
+        [&](const tbb::blocked_range<Int>& range) {
+          Int element[kDimension];
+          for (Int index = range.begin(); index < range.end(); ++index) {
+            Int remainder = index;
+            for (int dimension = 0; dimension < kDimension; ++dimension) {
+              const Int parity = (color >> dimension) & 1;
+              element[dimension] =
+                  parity + 2 * (remainder % num_color_elements[dimension]);
+              remainder /= num_color_elements[dimension];
+            }
+            element_function(element);
+          }
+        });
+  }
+}
+
+template <int kDimension, class Field, class ElementMatrixFunction,
+          class ValueArray>
+void AssembleElementGridMatrix(
+    const ElementGrid<kDimension>& grid, const Buffer<Int>& row_entry_offsets,
+    const ElementMatrixFunction& element_matrix_function, ValueArray* values) {
+  const int num_element_nodes = ElementGrid<kDimension>::kNumElementNodes;
+  const Int num_entries = row_entry_offsets.Back();
+  tbb::parallel_for(tbb::blocked_range<Int>(0, num_entries),
+                    [&](const tbb::blocked_range<Int>& range) {
+                      for (Int index = range.begin(); index < range.end();
+                           ++index) {
+                        (*values)[index] = Field{0};
+                      }
+                    });
+
+  ForEachGridElement(grid, [&](const Int* element) {
+    Field element_data[num_element_nodes * num_element_nodes];
+    BlasMatrixView<Field> element_matrix;
+    element_matrix.height = num_element_nodes;
+    element_matrix.width = num_element_nodes;
+    element_matrix.leading_dim = num_element_nodes;
+    element_matrix.data = element_data;
+    element_matrix_function(element, &element_matrix);
+
+    for (int element_row = 0; element_row < num_element_nodes;
+         ++element_row) {
+      Int coordinates[kDimension];
+      for (int dimension = 0; dimension < kDimension; ++dimension) {
+        coordinates[dimension] =
+            element[dimension] + ((element_row >> dimension) & 1);
+      }
+      for (int element_column = 0; element_column < num_element_nodes;
+           ++element_column) {
+        int offsets[kDimension];
+        for (int dimension = 0; dimension < kDimension; ++dimension) {
+          offsets[dimension] = ((element_column >> dimension) & 1) -
+                               ((element_row >> dimension) & 1);
+        }
+        const Int index = ElementGridEntryIndex(grid, row_entry_offsets,
+                                                coordinates, offsets);
+        (*values)[index] += element_matrix(element_row, element_column);
+      }
+    }
+  });
+}
+
+template <int kDimension, class Field, class ElementVectorFunction>
+void AssembleElementGridVector(
+    const ElementGrid<kDimension>& grid,
+    const ElementVectorFunction& element_vector_function, Int column,
+    BlasMatrixView<Field>* right_hand_sides) {
+  const int num_element_nodes = ElementGrid<kDimension>::kNumElementNodes;
+  const Int num_rows = grid.NumNodes();
+  for (Int row = 0; row < num_rows; ++row) {
+    right_hand_sides->Entry(row, column) = Field{0};
+  }
+
+  ForEachGridElement(grid, [&](const Int* element) {
+    Field element_vector[num_element_nodes];
+    element_vector_function(element, element_vector);
+
+    for (int element_row = 0; element_row < num_element_nodes;
+         ++element_row) {
+      Int row = 0;
+      for (int dimension = 0; dimension < kDimension; ++dimension) {
+        row += (element[dimension] + ((element_row >> dimension) & 1)) *
+               grid.NodeStride(dimension);
+      }
+      right_hand_sides->Entry(row, column) += element_vector[element_row];
+    }
+  });
+}
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_COMMON_IMPL_H_
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_COMMON_H_
+#define CATAMARI_HELMHOLTZ_PML_COMMON_H_
+
+#include "catamari/blas_matrix_view.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/complex.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+// A point in the 2D domain, [0, 1]^2.
+template <typename Real>
+struct Point2D {
+  Real x;
+  Real y;
+};
+
+// A point in the 3D domain, [0, 1]^3.
+template <typename Real>
+struct Point3D {
+  Real x;
+  Real y;
+  Real z;
+};
+
+// A Gaussian point source in the 2D domain.
+template <typename Real>
+struct GaussianSource2D {
+  Point2D<Real> point;
+  Real scale;
+  Real stddev;
+
+  // Returns the value of the source at the given point.
+  Complex<Real> operator()(const Point2D<Real>& target) const;
+};
+
+// A Gaussian point source in the 3D domain.
+template <typename Real>
+struct GaussianSource3D {
+  Point3D<Real> point;
+  Real scale;
+  Real stddev;
+
+  // Returns the value of the source at the given point.
+  Complex<Real> operator()(const Point3D<Real>& target) const;
+};
+
+enum SpeedProfile {
+  kFreeSpace,
+  kConvergingLens,
+  kWaveGuide,
+};
+
+// The pointwise acoustic speed.
+template <typename Real>
+class Speed {
+ public:
+  Speed(SpeedProfile profile);
+
+  Real FreeSpace(const Point2D<Real>& point) const;
+  Real FreeSpace(const Point3D<Real>& point) const;
+
+  Real ConvergingLens(const Point2D<Real>& point) const;
+  Real ConvergingLens(const Point3D<Real>& point) const;
+
+  Real WaveGuide(const Point2D<Real>& point) const;
+  Real WaveGuide(const Point3D<Real>& point) const;
+
+  Real operator()(const Point2D<Real>& point) const;
+  Real operator()(const Point3D<Real>& point) const;
+
+ private:
+  const SpeedProfile profile_;
+
+  // Evaluates the profile at a point in either domain.
+  template <class Point>
+  Real Evaluate(const Point& point) const;
+};
+
+// The differential mapping the trivial tangent space of the real line into
+// the tangent space of the complex-stretched domain.
+template <typename Real>
+class PMLDifferential {
+ public:
+  PMLDifferential(const Real& omega, const Real& pml_scale,
+                  const Real& pml_exponent, const Real& pml_width);
+
+  Complex<Real> operator()(const Real& x) const;
+
+ private:
+  const Real omega_;
+  const Real pml_scale_;
+  const Real pml_exponent_;
+  const Real pml_width_;
+};
+
+// Fills the three entries of 'points' and 'weights' with the transformed
+// evaluation points and weights of the third-order Gaussian quadrature over
+// the interval [a, b].
+template <typename Real>
+void ThirdOrderGaussianPointsAndWeights(const Real& a, const Real& b,
+                                        Real* points, Real* weights);
+
+// A structured grid of the (multi)linear elements spanning [0, 1]^d, whose
+// nodes are the element corners. The nodes are ordered lexicographically,
+// with the x coordinate varying fastest, and the corners of each element are
+// indexed by the bits of their offsets from its first corner, i.e.,
+// 'i + 2 j + 4 k'.
+template <int kDimension>
+struct ElementGrid {
+  // The number of nodes of each element.
+  static constexpr int kNumElementNodes = 1 << kDimension;
+
+  // The number of elements in each direction.
+  Int num_elements[kDimension];
+
+  // Returns the number of nodes, i.e., the number of rows of the
+  // discretization.
+  Int NumNodes() const;
+
+  // Returns the number of elements.
+  Int NumElements() const;
+
+  // Returns the distance between the indices of neighboring nodes in the
+  // given direction.
+  Int NodeStride(int dimension) const;
+};
+
+// Forms the sparsity pattern of a discretization over the grid -- in which
+// each node is coupled to every node of each element it belongs to -- with
+// zero values. The sorted entries are generated directly (and in parallel)
+// rather than through an entry queue.
+template <int kDimension, class Field>
+void FormElementGridPattern(const ElementGrid<kDimension>& grid,
+                            CoordinateMatrix<Field>* pattern);
+
+// Returns the index of the entry of the pattern from 'FormElementGridPattern'
+// coupling the node with the given coordinates to the node with the given
+// (unit) offsets, without any search.
+template <int kDimension>
+Int ElementGridEntryIndex(const ElementGrid<kDimension>& grid,
+                          const Buffer<Int>& row_entry_offsets,
+                          const Int* coordinates, const int* offsets);
+
+// Calls 'element_function(element)' -- where 'element' is the array of the
+// grid coordinates of the element -- for every element of the grid. The
+// elements are split into 2^d colors by the parities of their coordinates, so
+// that no two elements of the same color share a node. The colors are
+// traversed in order, and the elements of each color in parallel, so that
+// the contributions of the elements to any node are accumulated without races
+// and in an order independent of the number of threads.
+template <int kDimension, class ElementFunction>
+void ForEachGridElement(const ElementGrid<kDimension>& grid,
+                        const ElementFunction& element_function);
+
+// Overwrites the values -- in the order of the entries of the pattern from
+// 'FormElementGridPattern' -- with the sum of the element matrices formed by
+// 'element_matrix_function(element, &element_matrix)'. The values may be
+// stored in either a 'Buffer' or an 'EntryValuesView' of the pattern.
+template <int kDimension, class Field, class ElementMatrixFunction,
+          class ValueArray>
+void AssembleElementGridMatrix(
+    const ElementGrid<kDimension>& grid, const Buffer<Int>& row_entry_offsets,
+    const ElementMatrixFunction& element_matrix_function, ValueArray* values);
+
+// Overwrites column 'column' of 'right_hand_sides' with the sum of the element
+// vectors formed by 'element_vector_function(element, element_vector)'.
+template <int kDimension, class Field, class ElementVectorFunction>
+void AssembleElementGridVector(
+    const ElementGrid<kDimension>& grid,
+    const ElementVectorFunction& element_vector_function, Int column,
+    BlasMatrixView<Field>* right_hand_sides);
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#include "catamari/helmholtz_pml/common-impl.hpp"
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_COMMON_H_
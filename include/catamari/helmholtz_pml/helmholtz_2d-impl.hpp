@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_IMPL_H_
+#define CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_IMPL_H_
+
+#include "catamari/helmholtz_pml/helmholtz_2d.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+template <class Real>
+constexpr Int HelmholtzWithPMLQ4<Real>::kDimension;
+
+template <class Real>
+constexpr Int HelmholtzWithPMLQ4<Real>::kQuadratureOrder;
+
+template <class Real>
+constexpr Int HelmholtzWithPMLQ4<Real>::kNumQuadraturePoints;
+
+template <class Real>
+Real HelmholtzWithPMLQ4<Real>::Basis(int i, int j, const Box& extent,
+                                     const Point2D<Real>& point) const {
+  CATAMARI_ASSERT(i == 0 || i == 1, "Invalid choice of i basis index.");
+  CATAMARI_ASSERT(j == 0 || j == 1, "Invalid choice of j basis index.");
+  const Real area =
+      (extent.x_end - extent.x_beg) * (extent.y_end - extent.y_beg);
+
+  Real product = Real{1} / area;
+
+  if (i == 0) {
+    product *= extent.x_end - point.x;
+  } else {
+    product *= point.x - extent.x_beg;
+  }
+
+  if (j == 0) {
+    product *= extent.y_end - point.y;
+  } else {
+    product *= point.y - extent.y_beg;
+  }
+
+  return product;
+}
+
+template <class Real>
+Real HelmholtzWithPMLQ4<Real>::BasisGradient(
+    int i, int j, int l, const Box& extent, const Point2D<Real>& point) const {
+  CATAMARI_ASSERT(i == 0 || i == 1, "Invalid choice of i basis index.");
+  CATAMARI_ASSERT(j == 0 || j == 1, "Invalid choice of j basis index.");
+  CATAMARI_ASSERT(l == 0 || l == 1, "Invalid choice of gradient index.");
+  const Real area =
+      (extent.x_end - extent.x_beg) * (extent.y_end - extent.y_beg);
+
+  Real product = Real{1} / area;
+
+  // Either multiply by the (rescaled) psi_{x, i} or its gradient.
+  if (l == 0) {
+    if (i == 0) {
+      product *= -1;
+    }
+  } else {
+    if (i == 0) {
+      product *= extent.x_end - point.x;
+    } else {
+      product *= point.x - extent.x_beg;
+    }
+  }
+
+  // Either multiply by the (rescaled) psi_{y, j} or its gradient.
+  if (l == 1) {
+    if (j == 0) {
+      product *= -1;
+    }
+  } else {
+    if (j == 0) {
+      product *= extent.y_end - point.y;
+    } else {
+      product *= point.y - extent.y_beg;
+    }
+  }
+
+  return product;
+}
+
+template <class Real>
+HelmholtzWithPMLQ4<Real>::HelmholtzWithPMLQ4(
+    Int num_x_elements, Int num_y_elements, const Real& omega,
+    const Real& pml_scale, const Real& pml_exponent, Int num_pml_elements,
+    const Speed<Real>& speed)
+    : num_x_elements_(num_x_elements),
+      num_y_elements_(num_y_elements),
+      element_x_size_(Real{1} / num_x_elements),
+      element_y_size_(Real{1} / num_y_elements),
+      omega_(omega),
+      speed_(speed) {
+  const Int num_basis_functions = 4;
+  const Real x_pml_width = num_pml_elements * element_x_size_;
+  const Real y_pml_width = num_pml_elements * element_y_size_;
+
+  // Exploit the fact that the elements are translations of each other to
+  // precompute the basis and gradient evaluations.
+  const Box extent{0, element_x_size_, 0, element_y_size_};
+
+  ThirdOrderGaussianPointsAndWeights(extent.x_beg, extent.x_end,
+                                     quadrature_x_points_,
+                                     quadrature_x_weights_);
+  ThirdOrderGaussianPointsAndWeights(extent.y_beg, extent.y_end,
+                                     quadrature_y_points_,
+                                     quadrature_y_weights_);
+
+  // The differentials from the real axes to the PML Profile tangent spaces.
+  const PMLDifferential<Real> gamma_x(omega, pml_scale, pml_exponent,
+                                      x_pml_width);
+  const PMLDifferential<Real> gamma_y(omega, pml_scale, pml_exponent,
+                                      y_pml_width);
+
+  pml_x_points_.Resize(num_x_elements * kQuadratureOrder);
+  for (Int x_element = 0; x_element < num_x_elements; ++x_element) {
+    const Int x_offset = x_element * kQuadratureOrder;
+    const Real x_beg = x_element * element_x_size_;
+    for (Int i = 0; i < kQuadratureOrder; ++i) {
+      const Real& x_point = quadrature_x_points_[i];
+      pml_x_points_[x_offset + i] = gamma_x(x_beg + x_point);
+    }
+  }
+
+  pml_y_points_.Resize(num_y_elements * kQuadratureOrder);
+  for (Int y_element = 0; y_element < num_y_elements; ++y_element) {
+    const Int y_offset = y_element * kQuadratureOrder;
+    const Real y_beg = y_element * element_y_size_;
+    for (Int i = 0; i < kQuadratureOrder; ++i) {
+      const Real& y_point = quadrature_y_points_[i];
+      pml_y_points_[y_offset + i] = gamma_y(y_beg + y_point);
+    }
+  }
+
+  // Store the quadrature weights over the tensor product grid.
+  quadrature_weights_.Resize(kNumQuadraturePoints);
+  for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+    const Real& y_weight = quadrature_y_weights_[y_quad];
+    for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+      const Real& x_weight = quadrature_x_weights_[x_quad];
+      const int row = x_quad + y_quad * kQuadratureOrder;
+      quadrature_weights_[row] = x_weight * y_weight;
+    }
+  }
+
+  // Store the evaluations of the basis functions.
+  basis_evals_.Resize(kNumQuadraturePoints, num_basis_functions);
+  for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+    const Real& y_point = quadrature_y_points_[y_quad];
+    for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+      const Real& x_point = quadrature_x_points_[x_quad];
+      const Point2D<Real> point{x_point, y_point};
+      const int row = x_quad + y_quad * kQuadratureOrder;
+      for (int j = 0; j <= 1; ++j) {
+        for (int i = 0; i <= 1; ++i) {
+          const int column = i + j * 2;
+          basis_evals_(row, column) = Basis(i, j, extent, point);
+        }
+      }
+    }
+  }
+
+  // Store the evaluations of the basis function gradients.
+  basis_grad_evals_.Resize(kNumQuadraturePoints,
+                           num_basis_functions * kDimension);
+  for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+    const Real& y_point = quadrature_y_points_[y_quad];
+    for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+      const Real& x_point = quadrature_x_points_[x_quad];
+      const Point2D<Real> point{x_point, y_point};
+      const int row = x_quad + y_quad * kQuadratureOrder;
+      for (int l = 0; l < kDimension; ++l) {
+        for (int j = 0; j <= 1; ++j) {
+          for (int i = 0; i <= 1; ++i) {
+            const int column = i + j * 2 + l * num_basis_functions;
+            basis_grad_evals_(row, column) =
+                BasisGradient(i, j, l, extent, point);
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class Real>
+void HelmholtzWithPMLQ4<Real>::ElementBilinearForms(
+    Int x_element, Int y_element,
+    BlasMatrixView<Complex<Real>>* element_updates) const {
+  const int num_basis_functions = 4;
+  const Int x_offset = x_element * kQuadratureOrder;
+  const Int y_offset = y_element * kQuadratureOrder;
+  const Real x_beg = x_element * element_x_size_;
+  const Real y_beg = y_element * element_y_size_;
+
+  // Evaluate the weight tensor over the element. Entry 'l' of quadrature
+  // point 'q' is stored at position 'q + l * kNumQuadraturePoints'.
+  Complex<Real> gradient_evals[kNumQuadraturePoints * kDimension];
+  for (int l = 0; l < kDimension; ++l) {
+    for (int j = 0; j < kQuadratureOrder; ++j) {
+      const Complex<Real>& gamma_y = pml_y_points_[y_offset + j];
+      for (int i = 0; i < kQuadratureOrder; ++i) {
+        const Complex<Real>& gamma_x = pml_x_points_[x_offset + i];
+        const int quadrature_index = i + j * kQuadratureOrder;
+
+        const Complex<Real> gamma_product = gamma_x * gamma_y;
+        Complex<Real>& gradient_eval =
+            gradient_evals[quadrature_index + l * kNumQuadraturePoints];
+        if (l == 0) {
+          gradient_eval = gamma_product / (gamma_x * gamma_x);
+        } else if (l == 1) {
+          gradient_eval = gamma_product / (gamma_y * gamma_y);
+        }
+      }
+    }
+  }
+
+  // Evaluate the diagonal shifts over the element.
+  Complex<Real> scalar_evals[kNumQuadraturePoints];
+  for (int j = 0; j < kQuadratureOrder; ++j) {
+    const Real y = y_beg + quadrature_y_points_[j];
+    const Complex<Real>& gamma_y = pml_y_points_[y_offset + j];
+    for (int i = 0; i < kQuadratureOrder; ++i) {
+      const Real x = x_beg + quadrature_x_points_[i];
+      const Complex<Real>& gamma_x = pml_x_points_[x_offset + i];
+
+      const Point2D<Real> point{x, y};
+      const Complex<Real> gamma_product = gamma_x * gamma_y;
+      const int quadrature_index = i + j * kQuadratureOrder;
+
+      const Real rel_omega = omega_ / speed_(point);
+      scalar_evals[quadrature_index] = rel_omega * rel_omega * gamma_product;
+    }
+  }
+
+  // Compute the element updates.
+  for (int j_test = 0; j_test <= 1; ++j_test) {
+    for (int i_test = 0; i_test <= 1; ++i_test) {
+      const int element_row = i_test + j_test * 2;
+      for (int j_trial = 0; j_trial <= 1; ++j_trial) {
+        for (int i_trial = 0; i_trial <= 1; ++i_trial) {
+          const int element_column = i_trial + j_trial * 2;
+
+          Complex<Real> result = 0;
+          for (int j = 0; j < kQuadratureOrder; ++j) {
+            for (int i = 0; i < kQuadratureOrder; ++i) {
+              const int quadrature_index = i + j * kQuadratureOrder;
+              Complex<Real> update = 0;
+
+              // Add in the (grad v)' (A grad u) contribution. Recall
+              // that A is diagonal.
+              for (int l = 0; l < kDimension; ++l) {
+                const Real test_grad_entry = basis_grad_evals_(
+                    quadrature_index, element_row + num_basis_functions * l);
+                const Real trial_grad_entry = basis_grad_evals_(
+                    quadrature_index, element_column + num_basis_functions * l);
+                const Complex<Real> weight_entry =
+                    gradient_evals[quadrature_index + l * kNumQuadraturePoints];
+                // We explicitly call 'Conjugate' even though the basis
+                // functions are real.
+                update += Conjugate(test_grad_entry) *
+                          (weight_entry * trial_grad_entry);
+              }
+
+              // Add in the -s u conj(v) contribution.
+              // Again, we explicitly call 'Conjugate' even though the
+              // basis functions are real.
+              const Real test_entry =
+                  basis_evals_(quadrature_index, element_row);
+              const Real trial_entry =
+                  basis_evals_(quadrature_index, element_column);
+              const Complex<Real> diagonal_shift =
+                  scalar_evals[quadrature_index];
+              update -= diagonal_shift * trial_entry * Conjugate(test_entry);
+
+              result += quadrature_weights_[quadrature_index] * update;
+            }
+          }
+          element_updates->Entry(element_row, element_column) = result;
+        }
+      }
+    }
+  }
+}
+
+template <class Real>
+template <class RightHandSideFunction>
+void HelmholtzWithPMLQ4<Real>::ElementRightHandSide(
+    Int x_element, Int y_element, const RightHandSideFunction& rhs_function,
+    Complex<Real>* element_updates) const {
+  const Real x_beg = x_element * element_x_size_;
+  const Real y_beg = y_element * element_y_size_;
+
+  // Evaluate the right-hand side over the element.
+  Complex<Real> scalar_evals[kNumQuadraturePoints];
+  for (int j = 0; j < kQuadratureOrder; ++j) {
+    const Real y = y_beg + quadrature_y_points_[j];
+    for (int i = 0; i < kQuadratureOrder; ++i) {
+      const Real x = x_beg + quadrature_x_points_[i];
+      const Point2D<Real> point{x, y};
+      const int quadrature_index = i + j * kQuadratureOrder;
+      scalar_evals[quadrature_index] = rhs_function(point);
+    }
+  }
+
+  // Compute the element updates.
+  for (int j_test = 0; j_test <= 1; ++j_test) {
+    for (int i_test = 0; i_test <= 1; ++i_test) {
+      const int element_row = i_test + j_test * 2;
+      Complex<Real> result = 0;
+      for (int j = 0; j < kQuadratureOrder; ++j) {
+        for (int i = 0; i < kQuadratureOrder; ++i) {
+          const int quadrature_index = i + j * kQuadratureOrder;
+
+          // Add in the f conj(v) contribution.
+          // Again, we explicitly call 'Conjugate' even though the
+          // basis functions are real.
+          const Real test_entry = basis_evals_(quadrature_index, element_row);
+          const Complex<Real> rhs_value = scalar_evals[quadrature_index];
+          result += quadrature_weights_[quadrature_index] * rhs_value *
+                    Conjugate(test_entry);
+        }
+      }
+
+      element_updates[element_row] = result;
+    }
+  }
+}
+
+template <class Real>
+HelmholtzPMLProblem2D<Real>::HelmholtzPMLProblem2D(
+    SpeedProfile profile, Int num_x_elements, Int num_y_elements,
+    const Real& pml_scale, const Real& pml_exponent, Int num_pml_elements)
+    : speed_(profile),
+      pml_scale_(pml_scale),
+      pml_exponent_(pml_exponent),
+      num_pml_elements_(num_pml_elements) {
+  grid_.num_elements[0] = num_x_elements;
+  grid_.num_elements[1] = num_y_elements;
+  FormElementGridPattern(grid_, &pattern_);
+}
+
+template <class Real>
+Int HelmholtzPMLProblem2D<Real>::NumRows() const {
+  return grid_.NumNodes();
+}
+
+template <class Real>
+const CoordinateMatrix<Complex<Real>>& HelmholtzPMLProblem2D<Real>::Pattern()
+    const {
+  return pattern_;
+}
+
+template <class Real>
+template <class ValueArray>
+void HelmholtzPMLProblem2D<Real>::AssembleValueArray(
+    const Real& omega, ValueArray* values) const {
+  const HelmholtzWithPMLQ4<Real> discretization(
+      grid_.num_elements[0], grid_.num_elements[1], omega, pml_scale_,
+      pml_exponent_, num_pml_elements_, speed_);
+  AssembleElementGridMatrix<2, Complex<Real>>(
+      grid_, pattern_.RowEntryOffsets(),
+      [&](const Int* element, BlasMatrixView<Complex<Real>>* element_updates) {
+        discretization.ElementBilinearForms(element[0], element[1],
+                                            element_updates);
+      },
+      values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem2D<Real>::AssembleValues(
+    const Real& omega, Buffer<Complex<Real>>* values) const {
+  values->Resize(pattern_.NumEntries());
+  AssembleValueArray(omega, values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem2D<Real>::FormMatrix(
+    const Real& omega, CoordinateMatrix<Complex<Real>>* matrix) const {
+  *matrix = pattern_;
+  EntryValuesView<Complex<Real>> values = matrix->ValuesView();
+  AssembleValueArray(omega, &values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem2D<Real>::FormConversionPlan(
+    const SparseLDL<Complex<Real>>& ldl, ConversionPlan* cplan) const {
+  ldl.FormConversionPlan(pattern_, cplan);
+}
+
+template <class Real>
+void HelmholtzPMLProblem2D<Real>::FormRightHandSides(
+    const Buffer<GaussianSource2D<Real>>& sources,
+    BlasMatrix<Complex<Real>>* right_hand_sides) const {
+  // The right-hand sides do not depend upon the frequency used to construct
+  // the discretization.
+  const HelmholtzWithPMLQ4<Real> discretization(
+      grid_.num_elements[0], grid_.num_elements[1], Real{1}, pml_scale_,
+      pml_exponent_, num_pml_elements_, speed_);
+  const Int num_sources = sources.Size();
+  right_hand_sides->Resize(NumRows(), num_sources);
+  for (Int s = 0; s < num_sources; ++s) {
+    const GaussianSource2D<Real>& source = sources[s];
+    AssembleElementGridVector<2, Complex<Real>>(
+        grid_,
+        [&](const Int* element, Complex<Real>* element_updates) {
+          discretization.ElementRightHandSide(element[0], element[1], source,
+                                              element_updates);
+        },
+        s, &right_hand_sides->view);
+  }
+}
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_IMPL_H_
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_H_
+#define CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_H_
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/helmholtz_pml/common.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+// This currently uses third-order Gaussian quadrature. The basis functions
+// over [-1, 1]^2 are:
+//
+//   psi_{0, 0}(x, y) = (1 - x) (1 - y) / 2^2,
+//   psi_{0, 1}(x, y) = (1 - x) (1 + y) / 2^2,
+//   psi_{1, 0}(x, y) = (1 + x) (1 - y) / 2^2,
+//   psi_{1, 1}(x, y) = (1 + x) (1 + y) / 2^2.
+//
+// Over an element [x_beg, x_end] x [y_beg, y_end], where we denote the lengths
+// by L_x and L_y, and their product by A = L_x L_y,
+//
+//   psi_{0, 0}(x, y) = (x_end - x) (y_end - y) / A,
+//   psi_{0, 1}(x, y) = (x_end - x) (y - y_beg) / A,
+//   psi_{1, 0}(x, y) = (x - x_beg) (y_end - y) / A,
+//   psi_{1, 1}(x, y) = (x - x_beg) (y - y_beg) / A.
+//
+// More compactly, if we define:
+//
+//   psi_{x, 0} = (x_end - x) / L_x,  psi_{x, 1} = (x - x_beg) / L_x,
+//   psi_{y, 0} = (y_end - y) / L_y,  psi_{y, 1} = (y - y_beg) / L_y,
+//
+// then we have
+//
+//   psi_I = psi_{x, I_x} psi_{y, I_y},
+//
+// and
+//
+//   grad_l psi_I = (prod_{alpha != l} psi_{alpha, I_alpha}) grad_l psi_alpha.
+//
+// The element routines only read the precomputed state, so they may be called
+// concurrently.
+template <class Real>
+class HelmholtzWithPMLQ4 {
+ public:
+  // A representation of an arbitrary axis-aligned box,
+  //
+  //     [x_beg, x_end] x [y_beg, y_end].
+  //
+  struct Box {
+    Real x_beg;
+    Real x_end;
+    Real y_beg;
+    Real y_end;
+  };
+
+  // The dimension of the domain.
+  constexpr static Int kDimension = 2;
+
+  // The number of quadrature points per dimension.
+  constexpr static Int kQuadratureOrder = 3;
+
+  // The number of quadrature points over each element.
+  constexpr static Int kNumQuadraturePoints =
+      kQuadratureOrder * kQuadratureOrder;
+
+  // Returns \psi_{i, j} evaluated at the given point.
+  Real Basis(int i, int j, const Box& extent,
+             const Point2D<Real>& point) const;
+
+  // Returns index 'l' of the gradient of psi_{i, j} evaluated at the given
+  // point.
+  Real BasisGradient(int i, int j, int l, const Box& extent,
+                     const Point2D<Real>& point) const;
+
+  // The constructor for the Q4 elements.
+  HelmholtzWithPMLQ4(Int num_x_elements, Int num_y_elements, const Real& omega,
+                     const Real& pml_scale, const Real& pml_exponent,
+                     Int num_pml_elements, const Speed<Real>& speed);
+
+  // Form all of the matrix updates for a particular element.
+  void ElementBilinearForms(
+      Int x_element, Int y_element,
+      BlasMatrixView<Complex<Real>>* element_updates) const;
+
+  // Form all of the right-hand side updates for a single element, which are
+  // written into the four entries of 'element_updates'.
+  template <class RightHandSideFunction>
+  void ElementRightHandSide(Int x_element, Int y_element,
+                            const RightHandSideFunction& rhs_function,
+                            Complex<Real>* element_updates) const;
+
+ private:
+  // The number of elements in the x direction.
+  const Int num_x_elements_;
+
+  // The number of elements in the y direction.
+  const Int num_y_elements_;
+
+  // The x-length of each rectangular element.
+  const Real element_x_size_;
+
+  // The y-length of each rectangular element.
+  const Real element_y_size_;
+
+  // The angular frequency of the harmonic forcing function.
+  const Real omega_;
+
+  // The sound speed over the domain.
+  const Speed<Real> speed_;
+
+  // Evaluations of the PML profile over the quadrature points in the x
+  // direction.
+  Buffer<Complex<Real>> pml_x_points_;
+
+  // Evaluations of the PML profile over the quadrature points in the y
+  // direction.
+  Buffer<Complex<Real>> pml_y_points_;
+
+  // The locations of quadrature points in each of the two dimensions.
+  Real quadrature_x_points_[kQuadratureOrder];
+  Real quadrature_y_points_[kQuadratureOrder];
+
+  // The weights of quadrature points in each of the two dimensions.
+  Real quadrature_x_weights_[kQuadratureOrder];
+  Real quadrature_y_weights_[kQuadratureOrder];
+
+  Buffer<Real> quadrature_weights_;
+
+  BlasMatrix<Real> basis_evals_;
+
+  BlasMatrix<Real> basis_grad_evals_;
+};
+
+// A generator of the Q4 discretizations of the 2D Helmholtz equation over
+// [0, 1]^2 with inserted PML at any number of frequencies. The sparsity
+// pattern is formed once, and the matrix of each frequency is assembled in
+// parallel straight into its values (the entries of the pattern), so that a
+// frequency sweep can refactor in place through a single conversion plan:
+//
+//   catamari::helmholtz_pml::HelmholtzPMLProblem2D<double> problem(...);
+//   catamari::CoordinateMatrix<Complex<double>> matrix;
+//   problem.FormMatrix(omega, &matrix);
+//   ldl.Factor(matrix, control);
+//   catamari::ConversionPlan plan;
+//   problem.FormConversionPlan(ldl, &plan);
+//   Buffer<Complex<double>> values;
+//   for (const double& next_omega : omegas) {
+//     problem.AssembleValues(next_omega, &values);
+//     ldl.RefactorWithFixedSparsityPattern(plan, values.Data());
+//     ...
+//   }
+//
+template <class Real>
+class HelmholtzPMLProblem2D {
+ public:
+  // The constructor for the problem over a grid of the given size.
+  HelmholtzPMLProblem2D(SpeedProfile profile, Int num_x_elements,
+                        Int num_y_elements, const Real& pml_scale,
+                        const Real& pml_exponent, Int num_pml_elements);
+
+  // Returns the number of rows of the discretization.
+  Int NumRows() const;
+
+  // Returns the sparsity pattern (with zero values) of the discretization.
+  const CoordinateMatrix<Complex<Real>>& Pattern() const;
+
+  // Overwrites 'values' with the values of the discretization at the given
+  // angular frequency, in the order of the entries of the pattern.
+  void AssembleValues(const Real& omega, Buffer<Complex<Real>>* values) const;
+
+  // Overwrites 'matrix' with the discretization at the given angular
+  // frequency.
+  void FormMatrix(const Real& omega,
+                  CoordinateMatrix<Complex<Real>>* matrix) const;
+
+  // Forms the plan for refactoring 'ldl' -- after a factorization of a
+  // discretization from 'FormMatrix' (or of the pattern) -- with the values
+  // from 'AssembleValues'.
+  void FormConversionPlan(const SparseLDL<Complex<Real>>& ldl,
+                          ConversionPlan* cplan) const;
+
+  // Overwrites 'right_hand_sides' with the discretizations of the given
+  // sources, one per column, which do not depend upon the frequency.
+  void FormRightHandSides(const Buffer<GaussianSource2D<Real>>& sources,
+                          BlasMatrix<Complex<Real>>* right_hand_sides) const;
+
+ private:
+  // The sound speed over the domain.
+  const Speed<Real> speed_;
+
+  // The scaling factor of the PML profile.
+  const Real pml_scale_;
+
+  // The exponent of the PML profile.
+  const Real pml_exponent_;
+
+  // The number of elements the PML spans.
+  const Int num_pml_elements_;
+
+  // The grid of elements.
+  ElementGrid<2> grid_;
+
+  // The sparsity pattern of the discretization.
+  CoordinateMatrix<Complex<Real>> pattern_;
+
+  // Overwrites the values -- stored in either a 'Buffer' or an
+  // 'EntryValuesView' -- of the discretization at the given frequency.
+  template <class ValueArray>
+  void AssembleValueArray(const Real& omega, ValueArray* values) const;
+};
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#include "catamari/helmholtz_pml/helmholtz_2d-impl.hpp"
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_2D_H_
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_IMPL_H_
+#define CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_IMPL_H_
+
+#include "catamari/helmholtz_pml/helmholtz_3d.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+template <class Real>
+constexpr Int HelmholtzWithPMLTrilinearHexahedra<Real>::kDimension;
+
+template <class Real>
+constexpr Int HelmholtzWithPMLTrilinearHexahedra<Real>::kQuadratureOrder;
+
+template <class Real>
+constexpr Int HelmholtzWithPMLTrilinearHexahedra<Real>::kNumQuadraturePoints;
+
+template <class Real>
+Real HelmholtzWithPMLTrilinearHexahedra<Real>::Basis(
+    int i, int j, int k, const Box& extent, const Point3D<Real>& point) const {
+  CATAMARI_ASSERT(i == 0 || i == 1, "Invalid choice of i basis index.");
+  CATAMARI_ASSERT(j == 0 || j == 1, "Invalid choice of j basis index.");
+  CATAMARI_ASSERT(k == 0 || k == 1, "Invalid choice of k basis index.");
+  const Real volume = (extent.x_end - extent.x_beg) *
+                      (extent.y_end - extent.y_beg) *
+                      (extent.z_end - extent.z_beg);
+
+  Real product = Real{1} / volume;
+
+  if (i == 0) {
+    product *= extent.x_end - point.x;
+  } else {
+    product *= point.x - extent.x_beg;
+  }
+
+  if (j == 0) {
+    product *= extent.y_end - point.y;
+  } else {
+    product *= point.y - extent.y_beg;
+  }
+
+  if (k == 0) {
+    product *= extent.z_end - point.z;
+  } else {
+    product *= point.z - extent.z_beg;
+  }
+
+  return product;
+}
+
+template <class Real>
+Real HelmholtzWithPMLTrilinearHexahedra<Real>::BasisGradient(
+    int i, int j, int k, int l, const Box& extent,
+    const Point3D<Real>& point) const {
+  CATAMARI_ASSERT(i == 0 || i == 1, "Invalid choice of i basis index.");
+  CATAMARI_ASSERT(j == 0 || j == 1, "Invalid choice of j basis index.");
+  CATAMARI_ASSERT(k == 0 || k == 1, "Invalid choice of k basis index.");
+  CATAMARI_ASSERT(l == 0 || l == 1 || l == 2,
+                  "Invalid choice of gradient index.");
+  const Real volume = (extent.x_end - extent.x_beg) *
+                      (extent.y_end - extent.y_beg) *
+                      (extent.z_end - extent.z_beg);
+
+  Real product = Real{1} / volume;
+
+  // Either multiply by the (rescaled) psi_{x, i} or its gradient.
+  if (l == 0) {
+    if (i == 0) {
+      product *= -1;
+    }
+  } else {
+    if (i == 0) {
+      product *= extent.x_end - point.x;
+    } else {
+      product *= point.x - extent.x_beg;
+    }
+  }
+
+  // Either multiply by the (rescaled) psi_{y, j} or its gradient.
+  if (l == 1) {
+    if (j == 0) {
+      product *= -1;
+    }
+  } else {
+    if (j == 0) {
+      product *= extent.y_end - point.y;
+    } else {
+      product *= point.y - extent.y_beg;
+    }
+  }
+
+  // Either multiply by the (rescaled) psi_{z, k} or its gradient.
+  if (l == 2) {
+    if (k == 0) {
+      product *= -1;
+    }
+  } else {
+    if (k == 0) {
+      product *= extent.z_end - point.z;
+    } else {
+      product *= point.z - extent.z_beg;
+    }
+  }
+
+  return product;
+}
+
+template <class Real>
+HelmholtzWithPMLTrilinearHexahedra<Real>::HelmholtzWithPMLTrilinearHexahedra(
+    Int num_x_elements, Int num_y_elements, Int num_z_elements,
+    const Real& omega, const Real& pml_scale, const Real& pml_exponent,
+    Int num_pml_elements, const Speed<Real>& speed)
+    : num_x_elements_(num_x_elements),
+      num_y_elements_(num_y_elements),
+      num_z_elements_(num_z_elements),
+      element_x_size_(Real{1} / num_x_elements),
+      element_y_size_(Real{1} / num_y_elements),
+      element_z_size_(Real{1} / num_z_elements),
+      omega_(omega),
+      speed_(speed) {
+  const Int num_basis_functions = 8;
+  const Real x_pml_width = num_pml_elements * element_x_size_;
+  const Real y_pml_width = num_pml_elements * element_y_size_;
+  const Real z_pml_width = num_pml_elements * element_z_size_;
+
+  // Exploit the fact that the elements are translations of each other to
+  // precompute the basis and gradient evaluations.
+  const Box extent{0, element_x_size_, 0, element_y_size_,
+                   0, element_z_size_};
+
+  ThirdOrderGaussianPointsAndWeights(extent.x_beg, extent.x_end,
+                                     quadrature_x_points_,
+                                     quadrature_x_weights_);
+  ThirdOrderGaussianPointsAndWeights(extent.y_beg, extent.y_end,
+                                     quadrature_y_points_,
+                                     quadrature_y_weights_);
+  ThirdOrderGaussianPointsAndWeights(extent.z_beg, extent.z_end,
+                                     quadrature_z_points_,
+                                     quadrature_z_weights_);
+
+  // The differentials from the real axes to the PML Profile tangent spaces.
+  const PMLDifferential<Real> gamma_x(omega, pml_scale, pml_exponent,
+                                      x_pml_width);
+  const PMLDifferential<Real> gamma_y(omega, pml_scale, pml_exponent,
+                                      y_pml_width);
+  const PMLDifferential<Real> gamma_z(omega, pml_scale, pml_exponent,
+                                      z_pml_width);
+
+  pml_x_points_.Resize(num_x_elements * kQuadratureOrder);
+  for (Int x_element = 0; x_element < num_x_elements; ++x_element) {
+    const Int x_offset = x_element * kQuadratureOrder;
+    const Real x_beg = x_element * element_x_size_;
+    for (Int i = 0; i < kQuadratureOrder; ++i) {
+      const Real& x_point = quadrature_x_points_[i];
+      pml_x_points_[x_offset + i] = gamma_x(x_beg + x_point);
+    }
+  }
+
+  pml_y_points_.Resize(num_y_elements * kQuadratureOrder);
+  for (Int y_element = 0; y_element < num_y_elements; ++y_element) {
+    const Int y_offset = y_element * kQuadratureOrder;
+    const Real y_beg = y_element * element_y_size_;
+    for (Int i = 0; i < kQuadratureOrder; ++i) {
+      const Real& y_point = quadrature_y_points_[i];
+      pml_y_points_[y_offset + i] = gamma_y(y_beg + y_point);
+    }
+  }
+
+  pml_z_points_.Resize(num_z_elements * kQuadratureOrder);
+  for (Int z_element = 0; z_element < num_z_elements; ++z_element) {
+    const Int z_offset = z_element * kQuadratureOrder;
+    const Real z_beg = z_element * element_z_size_;
+    for (Int i = 0; i < kQuadratureOrder; ++i) {
+      const Real& z_point = quadrature_z_points_[i];
+      pml_z_points_[z_offset + i] = gamma_z(z_beg + z_point);
+    }
+  }
+
+  // Store the quadrature weights over the tensor product grid.
+  quadrature_weights_.Resize(kNumQuadraturePoints);
+  for (int z_quad = 0; z_quad < kQuadratureOrder; ++z_quad) {
+    const Real& z_weight = quadrature_z_weights_[z_quad];
+    for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+      const Real& y_weight = quadrature_y_weights_[y_quad];
+      for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+        const Real& x_weight = quadrature_x_weights_[x_quad];
+        const int row = x_quad + y_quad * kQuadratureOrder +
+                        z_quad * kQuadratureOrder * kQuadratureOrder;
+        quadrature_weights_[row] = x_weight * y_weight * z_weight;
+      }
+    }
+  }
+
+  // Store the evaluations of the basis functions.
+  basis_evals_.Resize(kNumQuadraturePoints, num_basis_functions);
+  for (int z_quad = 0; z_quad < kQuadratureOrder; ++z_quad) {
+    const Real& z_point = quadrature_z_points_[z_quad];
+    for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+      const Real& y_point = quadrature_y_points_[y_quad];
+      for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+        const Real& x_point = quadrature_x_points_[x_quad];
+        const Point3D<Real> point{x_point, y_point, z_point};
+        const int row = x_quad + y_quad * kQuadratureOrder +
+                        z_quad * kQuadratureOrder * kQuadratureOrder;
+        for (int k = 0; k <= 1; ++k) {
+          for (int j = 0; j <= 1; ++j) {
+            for (int i = 0; i <= 1; ++i) {
+              const int column = i + j * 2 + k * 4;
+              basis_evals_(row, column) = Basis(i, j, k, extent, point);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Store the evaluations of the basis function gradients.
+  basis_grad_evals_.Resize(kNumQuadraturePoints,
+                           num_basis_functions * kDimension);
+  for (int z_quad = 0; z_quad < kQuadratureOrder; ++z_quad) {
+    const Real& z_point = quadrature_z_points_[z_quad];
+    for (int y_quad = 0; y_quad < kQuadratureOrder; ++y_quad) {
+      const Real& y_point = quadrature_y_points_[y_quad];
+      for (int x_quad = 0; x_quad < kQuadratureOrder; ++x_quad) {
+        const Real& x_point = quadrature_x_points_[x_quad];
+        const Point3D<Real> point{x_point, y_point, z_point};
+        const int row = x_quad + y_quad * kQuadratureOrder +
+                        z_quad * kQuadratureOrder * kQuadratureOrder;
+        for (int l = 0; l < kDimension; ++l) {
+          for (int k = 0; k <= 1; ++k) {
+            for (int j = 0; j <= 1; ++j) {
+              for (int i = 0; i <= 1; ++i) {
+                const int column = i + j * 2 + k * 4 + l * num_basis_functions;
+                basis_grad_evals_(row, column) =
+                    BasisGradient(i, j, k, l, extent, point);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class Real>
+void HelmholtzWithPMLTrilinearHexahedra<Real>::ElementBilinearForms(
+    Int x_element, Int y_element, Int z_element,
+    BlasMatrixView<Complex<Real>>* element_updates) const {
+  const int num_basis_functions = 8;
+  const Int x_offset = x_element * kQuadratureOrder;
+  const Int y_offset = y_element * kQuadratureOrder;
+  const Int z_offset = z_element * kQuadratureOrder;
+  const Real x_beg = x_element * element_x_size_;
+  const Real y_beg = y_element * element_y_size_;
+  const Real z_beg = z_element * element_z_size_;
+
+  // Evaluate the weight tensor over the element. Entry 'l' of quadrature
+  // point 'q' is stored at position 'q + l * kNumQuadraturePoints'.
+  Complex<Real> gradient_evals[kNumQuadraturePoints * kDimension];
+  for (int l = 0; l < kDimension; ++l) {
+    for (int k = 0; k < kQuadratureOrder; ++k) {
+      const Complex<Real>& gamma_z = pml_z_points_[z_offset + k];
+      for (int j = 0; j < kQuadratureOrder; ++j) {
+        const Complex<Real>& gamma_y = pml_y_points_[y_offset + j];
+        for (int i = 0; i < kQuadratureOrder; ++i) {
+          const Complex<Real>& gamma_x = pml_x_points_[x_offset + i];
+          const int quadrature_index = i + j * kQuadratureOrder +
+                                       k * kQuadratureOrder * kQuadratureOrder;
+
+          const Complex<Real> gamma_product = gamma_x * gamma_y * gamma_z;
+          Complex<Real>& gradient_eval =
+              gradient_evals[quadrature_index + l * kNumQuadraturePoints];
+          if (l == 0) {
+            gradient_eval = gamma_product / (gamma_x * gamma_x);
+          } else if (l == 1) {
+            gradient_eval = gamma_product / (gamma_y * gamma_y);
+          } else {
+            gradient_eval = gamma_product / (gamma_z * gamma_z);
+          }
+        }
+      }
+    }
+  }
+
+  // Evaluate the diagonal shifts over the element.
+  Complex<Real> scalar_evals[kNumQuadraturePoints];
+  for (int k = 0; k < kQuadratureOrder; ++k) {
+    const Real z = z_beg + quadrature_z_points_[k];
+    const Complex<Real>& gamma_z = pml_z_points_[z_offset + k];
+    for (int j = 0; j < kQuadratureOrder; ++j) {
+      const Real y = y_beg + quadrature_y_points_[j];
+      const Complex<Real>& gamma_y = pml_y_points_[y_offset + j];
+      for (int i = 0; i < kQuadratureOrder; ++i) {
+        const Real x = x_beg + quadrature_x_points_[i];
+        const Complex<Real>& gamma_x = pml_x_points_[x_offset + i];
+
+        const Point3D<Real> point{x, y, z};
+        const Complex<Real> gamma_product = gamma_x * gamma_y * gamma_z;
+        const int quadrature_index = i + j * kQuadratureOrder +
+                                     k * kQuadratureOrder * kQuadratureOrder;
+
+        const Real rel_omega = omega_ / speed_(point);
+        scalar_evals[quadrature_index] = rel_omega * rel_omega * gamma_product;
+      }
+    }
+  }
+
+  // Compute the element updates.
+  for (int element_row = 0; element_row < num_basis_functions;
+       ++element_row) {
+    for (int element_column = 0; element_column < num_basis_functions;
+         ++element_column) {
+      Complex<Real> result = 0;
+      for (int quadrature_index = 0; quadrature_index < kNumQuadraturePoints;
+           ++quadrature_index) {
+        Complex<Real> update = 0;
+
+        // Add in the (grad v)' (A grad u) contribution. Recall that A is
+        // diagonal.
+        for (int l = 0; l < kDimension; ++l) {
+          const Real test_grad_entry = basis_grad_evals_(
+              quadrature_index, element_row + num_basis_functions * l);
+          const Real trial_grad_entry = basis_grad_evals_(
+              quadrature_index, element_column + num_basis_functions * l);
+          const Complex<Real> weight_entry =
+              gradient_evals[quadrature_index + l * kNumQuadraturePoints];
+          // We explicitly call 'Conjugate' even though the basis functions
+          // are real.
+          update +=
+              Conjugate(test_grad_entry) * (weight_entry * trial_grad_entry);
+        }
+
+        // Add in the -s u conj(v) contribution. Again, we explicitly call
+        // 'Conjugate' even though the basis functions are real.
+        const Real test_entry = basis_evals_(quadrature_index, element_row);
+        const Real trial_entry =
+            basis_evals_(quadrature_index, element_column);
+        const Complex<Real> diagonal_shift = scalar_evals[quadrature_index];
+        update -= diagonal_shift * trial_entry * Conjugate(test_entry);
+
+        result += quadrature_weights_[quadrature_index] * update;
+      }
+
+      element_updates->Entry(element_row, element_column) = result;
+    }
+  }
+}
+
+template <class Real>
+template <class RightHandSideFunction>
+void HelmholtzWithPMLTrilinearHexahedra<Real>::ElementRightHandSide(
+    Int x_element, Int y_element, Int z_element,
+    const RightHandSideFunction& rhs_function,
+    Complex<Real>* element_updates) const {
+  const Real x_beg = x_element * element_x_size_;
+  const Real y_beg = y_element * element_y_size_;
+  const Real z_beg = z_element * element_z_size_;
+  const int num_basis_functions = 8;
+
+  // Evaluate the right-hand side over the element.
+  Complex<Real> scalar_evals[kNumQuadraturePoints];
+  for (int k = 0; k < kQuadratureOrder; ++k) {
+    const Real z = z_beg + quadrature_z_points_[k];
+    for (int j = 0; j < kQuadratureOrder; ++j) {
+      const Real y = y_beg + quadrature_y_points_[j];
+      for (int i = 0; i < kQuadratureOrder; ++i) {
+        const Real x = x_beg + quadrature_x_points_[i];
+        const Point3D<Real> point{x, y, z};
+        const int quadrature_index = i + j * kQuadratureOrder +
+                                     k * kQuadratureOrder * kQuadratureOrder;
+        scalar_evals[quadrature_index] = rhs_function(point);
+      }
+    }
+  }
+
+  // Compute the element updates.
+  for (int element_row = 0; element_row < num_basis_functions;
+       ++element_row) {
+    Complex<Real> result = 0;
+    for (int quadrature_index = 0; quadrature_index < kNumQuadraturePoints;
+         ++quadrature_index) {
+      // Add in the f conj(v) contribution. Again, we explicitly call
+      // 'Conjugate' even though the basis functions are real.
+      const Real test_entry = basis_evals_(quadrature_index, element_row);
+      const Complex<Real> rhs_value = scalar_evals[quadrature_index];
+      result += quadrature_weights_[quadrature_index] * rhs_value *
+                Conjugate(test_entry);
+    }
+    element_updates[element_row] = result;
+  }
+}
+
+template <class Real>
+HelmholtzPMLProblem3D<Real>::HelmholtzPMLProblem3D(
+    SpeedProfile profile, Int num_x_elements, Int num_y_elements,
+    Int num_z_elements, const Real& pml_scale, const Real& pml_exponent,
+    Int num_pml_elements)
+    : speed_(profile),
+      pml_scale_(pml_scale),
+      pml_exponent_(pml_exponent),
+      num_pml_elements_(num_pml_elements) {
+  grid_.num_elements[0] = num_x_elements;
+  grid_.num_elements[1] = num_y_elements;
+  grid_.num_elements[2] = num_z_elements;
+  FormElementGridPattern(grid_, &pattern_);
+}
+
+template <class Real>
+Int HelmholtzPMLProblem3D<Real>::NumRows() const {
+  return grid_.NumNodes();
+}
+
+template <class Real>
+const CoordinateMatrix<Complex<Real>>& HelmholtzPMLProblem3D<Real>::Pattern()
+    const {
+  return pattern_;
+}
+
+template <class Real>
+template <class ValueArray>
+void HelmholtzPMLProblem3D<Real>::AssembleValueArray(
+    const Real& omega, ValueArray* values) const {
+  const HelmholtzWithPMLTrilinearHexahedra<Real> discretization(
+      grid_.num_elements[0], grid_.num_elements[1], grid_.num_elements[2],
+      omega, pml_scale_, pml_exponent_, num_pml_elements_, speed_);
+  AssembleElementGridMatrix<3, Complex<Real>>(
+      grid_, pattern_.RowEntryOffsets(),
+      [&](const Int* element, BlasMatrixView<Complex<Real>>* element_updates) {
+        discretization.ElementBilinearForms(element[0], element[1],
+                                            element[2], element_updates);
+      },
+      values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem3D<Real>::AssembleValues(
+    const Real& omega, Buffer<Complex<Real>>* values) const {
+  values->Resize(pattern_.NumEntries());
+  AssembleValueArray(omega, values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem3D<Real>::FormMatrix(
+    const Real& omega, CoordinateMatrix<Complex<Real>>* matrix) const {
+  *matrix = pattern_;
+  EntryValuesView<Complex<Real>> values = matrix->ValuesView();
+  AssembleValueArray(omega, &values);
+}
+
+template <class Real>
+void HelmholtzPMLProblem3D<Real>::FormConversionPlan(
+    const SparseLDL<Complex<Real>>& ldl, ConversionPlan* cplan) const {
+  ldl.FormConversionPlan(pattern_, cplan);
+}
+
+template <class Real>
+void HelmholtzPMLProblem3D<Real>::FormRightHandSides(
+    const Buffer<GaussianSource3D<Real>>& sources,
+    BlasMatrix<Complex<Real>>* right_hand_sides) const {
+  // The right-hand sides do not depend upon the frequency used to construct
+  // the discretization.
+  const HelmholtzWithPMLTrilinearHexahedra<Real> discretization(
+      grid_.num_elements[0], grid_.num_elements[1], grid_.num_elements[2],
+      Real{1}, pml_scale_, pml_exponent_, num_pml_elements_, speed_);
+  const Int num_sources = sources.Size();
+  right_hand_sides->Resize(NumRows(), num_sources);
+  for (Int s = 0; s < num_sources; ++s) {
+    const GaussianSource3D<Real>& source = sources[s];
+    AssembleElementGridVector<3, Complex<Real>>(
+        grid_,
+        [&](const Int* element, Complex<Real>* element_updates) {
+          discretization.ElementRightHandSide(element[0], element[1],
+                                              element[2], source,
+                                              element_updates);
+        },
+        s, &right_hand_sides->view);
+  }
+}
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_IMPL_H_
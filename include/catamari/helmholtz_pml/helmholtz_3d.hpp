@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_H_
+#define CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_H_
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/helmholtz_pml/common.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+namespace helmholtz_pml {
+
+// This currently uses third-order Gaussian quadrature. The basis functions
+// over [-1, 1]^3 are:
+//
+//   psi_{0, 0, 0}(x, y, z) = (1 - x) (1 - y) (1 - z) / 2^3,
+//   psi_{0, 0, 1}(x, y, z) = (1 - x) (1 - y) (1 + z) / 2^3,
+//   psi_{0, 1, 0}(x, y, z) = (1 - x) (1 + y) (1 - z) / 2^3,
+//   psi_{0, 1, 1}(x, y, z) = (1 - x) (1 + y) (1 + z) / 2^3,
+//   psi_{1, 0, 0}(x, y, z) = (1 + x) (1 - y) (1 - z) / 2^3,
+//   psi_{1, 0, 1}(x, y, z) = (1 + x) (1 - y) (1 + z) / 2^3,
+//   psi_{1, 1, 0}(x, y, z) = (1 + x) (1 + y) (1 - z) / 2^3.
+//   psi_{1, 1, 1}(x, y, z) = (1 + x) (1 + y) (1 + z) / 2^3.
+//
+// Over an element [x_beg, x_end] x [y_beg, y_end] x [z_beg, z_end], where we
+// denote the lengths by L_x, L_y, and L_z, and their product by
+// V = L_x L_y L_z,
+//
+//   psi_{0, 0, 0}(x, y, z) = (x_end - x) (y_end - y) (z_end - z) / V,
+//   psi_{0, 0, 1}(x, y, z) = (x_end - x) (y_end - y) (z - z_beg) / V,
+//   psi_{0, 1, 0}(x, y, z) = (x_end - x) (y - y_beg) (z_end - z) / V,
+//   psi_{0, 1, 1}(x, y, z) = (x_end - x) (y - y_beg) (z - z_beg) / V,
+//   psi_{1, 0, 0}(x, y, z) = (x - x_beg) (y_end - y) (z_end - z) / V,
+//   psi_{1, 0, 1}(x, y, z) = (x - x_beg) (y_end - y) (z - z_beg) / V,
+//   psi_{1, 1, 0}(x, y, z) = (x - x_beg) (y - y_beg) (z_end - z) / V.
+//   psi_{1, 1, 1}(x, y, z) = (x - x_beg) (y - y_beg) (z - z_beg) / V.
+//
+// More compactly, if we define:
+//
+//   psi_{x, 0} = (x_end - x) / L_x,  psi_{x, 1} = (x - x_beg) / L_x,
+//   psi_{y, 0} = (y_end - y) / L_y,  psi_{y, 1} = (y - y_beg) / L_y,
+//   psi_{z, 0} = (z_end - z) / L_z,  psi_{z, 1} = (z - z_beg) / L_z,
+//
+// then we have
+//
+//   psi_I = psi_{x, I_x} psi_{y, I_y} psi_{z, I_z},
+//
+// and
+//
+//   grad_l psi_I = (prod_{alpha != l} psi_{alpha, I_alpha}) grad_l psi_alpha.
+//
+// The element routines only read the precomputed state, so they may be called
+// concurrently.
+template <class Real>
+class HelmholtzWithPMLTrilinearHexahedra {
+ public:
+  // A representation of an arbitrary axis-aligned box,
+  //
+  //     [x_beg, x_end] x [y_beg, y_end] x [z_beg, z_end].
+  //
+  struct Box {
+    Real x_beg;
+    Real x_end;
+    Real y_beg;
+    Real y_end;
+    Real z_beg;
+    Real z_end;
+  };
+
+  // The dimension of the domain.
+  constexpr static Int kDimension = 3;
+
+  // The number of quadrature points per dimension.
+  constexpr static Int kQuadratureOrder = 3;
+
+  // The number of quadrature points over each element.
+  constexpr static Int kNumQuadraturePoints =
+      kQuadratureOrder * kQuadratureOrder * kQuadratureOrder;
+
+  // Returns \psi_{i, j, k} evaluated at the given point.
+  Real Basis(int i, int j, int k, const Box& extent,
+             const Point3D<Real>& point) const;
+
+  // Returns index 'l' of the gradient of psi_{i, j, k} evaluated at the given
+  // point.
+  Real BasisGradient(int i, int j, int k, int l, const Box& extent,
+                     const Point3D<Real>& point) const;
+
+  // The constructor for the trilinear hexahedron.
+  HelmholtzWithPMLTrilinearHexahedra(Int num_x_elements, Int num_y_elements,
+                                     Int num_z_elements, const Real& omega,
+                                     const Real& pml_scale,
+                                     const Real& pml_exponent,
+                                     Int num_pml_elements,
+                                     const Speed<Real>& speed);
+
+  // Form all of the matrix updates for a particular element.
+  void ElementBilinearForms(
+      Int x_element, Int y_element, Int z_element,
+      BlasMatrixView<Complex<Real>>* element_updates) const;
+
+  // Form all of the right-hand side updates for a single element, which are
+  // written into the eight entries of 'element_updates'.
+  template <class RightHandSideFunction>
+  void ElementRightHandSide(Int x_element, Int y_element, Int z_element,
+                            const RightHandSideFunction& rhs_function,
+                            Complex<Real>* element_updates) const;
+
+ private:
+  // The number of elements in the x direction.
+  const Int num_x_elements_;
+
+  // The number of elements in the y direction.
+  const Int num_y_elements_;
+
+  // The number of elements in the z direction.
+  const Int num_z_elements_;
+
+  // The x-length of each box element.
+  const Real element_x_size_;
+
+  // The y-length of each box element.
+  const Real element_y_size_;
+
+  // The z-length of each box element.
+  const Real element_z_size_;
+
+  // The angular frequency of the harmonic forcing function.
+  const Real omega_;
+
+  // The sound speed over the domain.
+  const Speed<Real> speed_;
+
+  // Evaluations of the PML profile over the quadrature points in the x
+  // direction.
+  Buffer<Complex<Real>> pml_x_points_;
+
+  // Evaluations of the PML profile over the quadrature points in the y
+  // direction.
+  Buffer<Complex<Real>> pml_y_points_;
+
+  // Evaluations of the PML profile over the quadrature points in the z
+  // direction.
+  Buffer<Complex<Real>> pml_z_points_;
+
+  // Locations of quadrature points in each of the three dimensions.
+  Real quadrature_x_points_[kQuadratureOrder];
+  Real quadrature_y_points_[kQuadratureOrder];
+  Real quadrature_z_points_[kQuadratureOrder];
+
+  // Weights of the quadrature points in each of the three dimensions.
+  Real quadrature_x_weights_[kQuadratureOrder];
+  Real quadrature_y_weights_[kQuadratureOrder];
+  Real quadrature_z_weights_[kQuadratureOrder];
+
+  // The quadrature weights over the tensor-product grid.
+  Buffer<Real> quadrature_weights_;
+
+  BlasMatrix<Real> basis_evals_;
+
+  BlasMatrix<Real> basis_grad_evals_;
+};
+
+// A generator of the trilinear hexahedral discretizations of the 3D Helmholtz
+// equation over [0, 1]^3 with inserted PML at any number of frequencies (see
+// 'HelmholtzPMLProblem2D', whose usage is identical).
+template <class Real>
+class HelmholtzPMLProblem3D {
+ public:
+  // The constructor for the problem over a grid of the given size.
+  HelmholtzPMLProblem3D(SpeedProfile profile, Int num_x_elements,
+                        Int num_y_elements, Int num_z_elements,
+                        const Real& pml_scale, const Real& pml_exponent,
+                        Int num_pml_elements);
+
+  // Returns the number of rows of the discretization.
+  Int NumRows() const;
+
+  // Returns the sparsity pattern (with zero values) of the discretization.
+  const CoordinateMatrix<Complex<Real>>& Pattern() const;
+
+  // Overwrites 'values' with the values of the discretization at the given
+  // angular frequency, in the order of the entries of the pattern.
+  void AssembleValues(const Real& omega, Buffer<Complex<Real>>* values) const;
+
+  // Overwrites 'matrix' with the discretization at the given angular
+  // frequency.
+  void FormMatrix(const Real& omega,
+                  CoordinateMatrix<Complex<Real>>* matrix) const;
+
+  // Forms the plan for refactoring 'ldl' -- after a factorization of a
+  // discretization from 'FormMatrix' (or of the pattern) -- with the values
+  // from 'AssembleValues'.
+  void FormConversionPlan(const SparseLDL<Complex<Real>>& ldl,
+                          ConversionPlan* cplan) const;
+
+  // Overwrites 'right_hand_sides' with the discretizations of the given
+  // sources, one per column, which do not depend upon the frequency.
+  void FormRightHandSides(const Buffer<GaussianSource3D<Real>>& sources,
+                          BlasMatrix<Complex<Real>>* right_hand_sides) const;
+
+ private:
+  // The sound speed over the domain.
+  const Speed<Real> speed_;
+
+  // The scaling factor of the PML profile.
+  const Real pml_scale_;
+
+  // The exponent of the PML profile.
+  const Real pml_exponent_;
+
+  // The number of elements the PML spans.
+  const Int num_pml_elements_;
+
+  // The grid of elements.
+  ElementGrid<3> grid_;
+
+  // The sparsity pattern of the discretization.
+  CoordinateMatrix<Complex<Real>> pattern_;
+
+  // Overwrites the values -- stored in either a 'Buffer' or an
+  // 'EntryValuesView' -- of the discretization at the given frequency.
+  template <class ValueArray>
+  void AssembleValueArray(const Real& omega, ValueArray* values) const;
+};
+
+}  // namespace helmholtz_pml
+}  // namespace catamari
+
+#include "catamari/helmholtz_pml/helmholtz_3d-impl.hpp"
+
+#endif  // ifndef CATAMARI_HELMHOLTZ_PML_HELMHOLTZ_3D_H_
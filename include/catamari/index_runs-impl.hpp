@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_INDEX_RUNS_IMPL_H_
+#define CATAMARI_INDEX_RUNS_IMPL_H_
+
+#include <algorithm>
+
+#include "catamari/index_runs.hpp"
+
+namespace catamari {
+
+template <typename Index>
+void IndexRunList::Encode(Int num_lists, const Int* list_offsets,
+                          const Index* indices, const Int* breaks) {
+  // Returns whether a run begins at position 'k' of the given list.
+  auto run_begins = [&](Int list, Int k) {
+    const Int list_beg = list_offsets[list];
+    return k == list_beg || indices[k] != indices[k - 1] + 1 ||
+           (breaks && k - list_beg == breaks[list]);
+  };
+
+  // Count the runs of each list and keep only those which are long enough.
+  offsets_.Resize(num_lists + 1);
+  offsets_[0] = 0;
+  for (Int list = 0; list < num_lists; ++list) {
+    const Int list_beg = list_offsets[list];
+    const Int list_end = list_offsets[list + 1];
+    Int num_runs = 0;
+    for (Int k = list_beg; k < list_end; ++k) {
+      num_runs += run_begins(list, k);
+    }
+    const bool encode = num_runs * kMinAverageLength <= list_end - list_beg;
+    offsets_[list + 1] = offsets_[list] + (encode ? num_runs : 0);
+  }
+
+  runs_.Resize(offsets_[num_lists]);
+  for (Int list = 0; list < num_lists; ++list) {
+    if (!Encoded(list)) continue;
+    const Int list_beg = list_offsets[list];
+    const Int list_end = list_offsets[list + 1];
+    IndexRun* run = runs_.Data() + offsets_[list] - 1;
+    for (Int k = list_beg; k < list_end; ++k) {
+      if (run_begins(list, k)) {
+        *++run = IndexRun{k - list_beg, indices[k], 1};
+      } else {
+        ++run->length;
+      }
+    }
+  }
+}
+
+inline bool IndexRunList::Encoded(Int list) const {
+  return offsets_[list] < offsets_[list + 1];
+}
+
+inline const IndexRun* IndexRunList::Beg(Int list) const {
+  return runs_.Data() + offsets_[list];
+}
+
+inline const IndexRun* IndexRunList::End(Int list) const {
+  return runs_.Data() + offsets_[list + 1];
+}
+
+inline Int IndexRunList::NumRuns() const { return runs_.Size(); }
+
+template <class Function>
+void ForEachIndexRun(const IndexRun* runs_beg, const IndexRun* runs_end,
+                     Int begin, const Function& func) {
+  // Find the run containing 'begin' (the last run starting at or before it).
+  const IndexRun* run = std::upper_bound(
+      runs_beg, runs_end, begin,
+      [](Int position, const IndexRun& run) { return position < run.position; });
+  if (run == runs_beg) {
+    if (run == runs_end) return;
+  } else {
+    --run;
+    const Int offset = begin - run->position;
+    if (offset < run->length) {
+      func(begin, run->index + offset, run->length - offset);
+    }
+    ++run;
+  }
+  for (; run != runs_end; ++run) {
+    func(run->position, run->index, run->length);
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_INDEX_RUNS_IMPL_H_
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_INDEX_RUNS_H_
+#define CATAMARI_INDEX_RUNS_H_
+
+#include "catamari/buffer.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+
+// A maximal sequence of consecutive indices within a list of indices.
+struct IndexRun {
+  // The position of the first index of the run within its list.
+  Int position;
+
+  // The value of the first index of the run.
+  Int index;
+
+  // The number of indices in the run.
+  Int length;
+};
+
+// The runs of consecutive indices of each of a packed set of increasing index
+// lists (such as the structures of the supernodes), which allow the lists to
+// be gathered from and scattered into with contiguous copies. Only the lists
+// whose runs are at least 'kMinAverageLength' indices long on average are
+// encoded; the remainder should be traversed one index at a time.
+class IndexRunList {
+ public:
+  // The minimum average run length of an encoded list.
+  static constexpr Int kMinAverageLength = 4;
+
+  // Encodes the runs of the 'num_lists' lists, where list 'j' is stored in
+  // 'indices[list_offsets[j]]' through 'indices[list_offsets[j + 1] - 1]'.
+  // The indices may be stored in either 'Int' or 'LocalInt'. If 'breaks' is
+  // non-null, each run of list 'j' is also ended before position 'breaks[j]'
+  // of the list, so that no run straddles it.
+  template <typename Index>
+  void Encode(Int num_lists, const Int* list_offsets, const Index* indices,
+              const Int* breaks = nullptr);
+
+  // Returns whether the runs of the given list were encoded.
+  bool Encoded(Int list) const;
+
+  // Returns a pointer to the beginning of the runs of the given list.
+  const IndexRun* Beg(Int list) const;
+
+  // Returns a pointer to the end of the runs of the given list.
+  const IndexRun* End(Int list) const;
+
+  // Returns the total number of encoded runs.
+  Int NumRuns() const;
+
+ private:
+  // The runs of list 'j' are stored between indices 'offsets_[j]' and
+  // 'offsets_[j + 1]' of 'runs_'.
+  Buffer<Int> offsets_;
+
+  // The packed runs.
+  Buffer<IndexRun> runs_;
+};
+
+// Calls 'func(position, index, length)' on each maximal segment of
+// consecutive indices at positions 'begin' and beyond of the list encoded by
+// the runs [runs_beg, runs_end).
+template <class Function>
+void ForEachIndexRun(const IndexRun* runs_beg, const IndexRun* runs_end,
+                     Int begin, const Function& func);
+
+}  // namespace catamari
+
+#include "catamari/index_runs-impl.hpp"
+
+#endif  // ifndef CATAMARI_INDEX_RUNS_H_
@@ -8,6 +8,8 @@
 #ifndef CATAMARI_INTEGERS_H_
 #define CATAMARI_INTEGERS_H_
 
+#include <cstdint>
+
 #include "quotient/integers.hpp"
 
 namespace catamari {
@@ -15,6 +17,18 @@ namespace catamari {
 using quotient::Int;
 using quotient::UInt;
 
+// The integer type of the indices which are local to a (super)node, such as
+// the relative indices of a child's structure within the front of its parent.
+// They are bounded by the largest front rather than by the number of
+// nonzeros, so, when CATAMARI_MIXED_WIDTH_INDICES is defined, they are stored
+// in 32 bits (halving the index traffic of the merges) while 'Int' -- and
+// hence the offsets into the factor values -- may remain 64 bits.
+#ifdef CATAMARI_MIXED_WIDTH_INDICES
+typedef std::int32_t LocalInt;
+#else
+typedef Int LocalInt;
+#endif  // ifdef CATAMARI_MIXED_WIDTH_INDICES
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_INTEGERS_H_
@@ -16,6 +16,27 @@
 
 #define CATAMARI_UNUSED QUOTIENT_UNUSED
 
+#ifdef __GNUC__
+#define CATAMARI_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CATAMARI_PREFETCH(address)
+#endif  // ifdef __GNUC__
+
+// Marks a (non-inline) kernel to be compiled for several x86-64 instruction
+// set extensions, with the variant best suited to the running CPU selected
+// when the program is loaded (via GCC's function multiversioning), so that a
+// single binary uses AVX2 and FMA, or AVX-512, where they are available. The
+// NEON extensions are part of the AArch64 baseline, so no dispatch is needed
+// there.
+#if defined(CATAMARI_TARGET_CLONES) && defined(__x86_64__) && \
+    defined(__GNUC__) && !defined(__clang__)
+#define CATAMARI_MULTIVERSIONED \
+  __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", \
+                               "default")))
+#else
+#define CATAMARI_MULTIVERSIONED
+#endif
+
 #ifdef CATAMARI_ENABLE_TIMERS
 #define CATAMARI_START_TIMER(timer) timer.Start()
 #define CATAMARI_STOP_TIMER(timer) timer.Stop()
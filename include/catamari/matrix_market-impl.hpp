@@ -8,6 +8,20 @@
 #ifndef CATAMARI_MATRIX_MARKET_IMPL_H_
 #define CATAMARI_MATRIX_MARKET_IMPL_H_
 
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // if !defined _WIN32
+
 #include "catamari/matrix_market.hpp"
 
 namespace catamari {
@@ -48,6 +62,239 @@ bool ReadMatrixMarketCoordinateEntry(const MatrixMarketDescription& description,
   return status;
 }
 
+inline MappedFile::~MappedFile() { Unmap(); }
+
+inline bool MappedFile::Map(const std::string& filename) {
+  Unmap();
+#if !defined _WIN32
+  const int file_descriptor = open(filename.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    return false;
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0) {
+    close(file_descriptor);
+    return false;
+  }
+  if (file_status.st_size == 0) {
+    close(file_descriptor);
+    return true;
+  }
+
+  // The mapping outlives the descriptor.
+  void* mapping = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE,
+                       file_descriptor, 0);
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+  data_ = static_cast<char*>(mapping);
+  num_bytes_ = file_status.st_size;
+#ifdef MADV_SEQUENTIAL
+  madvise(data_, num_bytes_, MADV_SEQUENTIAL);
+#endif  // ifdef MADV_SEQUENTIAL
+  return true;
+#else
+  return false;
+#endif  // if !defined _WIN32
+}
+
+inline void MappedFile::Unmap() {
+#if !defined _WIN32
+  if (data_) munmap(data_, num_bytes_);
+#endif  // if !defined _WIN32
+  data_ = nullptr;
+  num_bytes_ = 0;
+}
+
+namespace matrix_market {
+
+// Returns true if the character separates the tokens of a Matrix Market file.
+inline bool IsWhitespace(char character) {
+  return character == ' ' || character == '\n' || character == '\t' ||
+         character == '\r';
+}
+
+// Returns the first non-whitespace position in [iter, end).
+inline const char* SkipWhitespace(const char* iter, const char* end) {
+  while (iter != end && IsWhitespace(*iter)) ++iter;
+  return iter;
+}
+
+// Returns 10^exponent for exponent in [0, 22], each of which is exactly
+// representable in double precision.
+inline double ExactPowerOfTen(int exponent) {
+  static const double kPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+  return kPowers[exponent];
+}
+
+// Converts the token in [iter, token_end) with std::strtod.
+inline const char* ParseRealFallback(const char* iter, const char* token_end,
+                                     double* value) {
+  // The mapping need not be null-terminated, so the token is copied.
+  char token[128];
+  const std::size_t token_size = token_end - iter;
+  if (token_size == 0 || token_size >= sizeof(token)) {
+    return nullptr;
+  }
+  std::memcpy(token, iter, token_size);
+  token[token_size] = '\0';
+  char* parse_end;
+  errno = 0;
+  *value = std::strtod(token, &parse_end);
+  if (parse_end != token + token_size ||
+      (errno == ERANGE && std::abs(*value) > 1)) {
+    return nullptr;
+  }
+  return token_end;
+}
+
+}  // namespace matrix_market
+
+inline const char* ParseMatrixMarketInteger(const char* iter, const char* end,
+                                            Int* value) {
+  iter = matrix_market::SkipWhitespace(iter, end);
+  bool negative = false;
+  if (iter != end && (*iter == '-' || *iter == '+')) {
+    negative = *iter == '-';
+    ++iter;
+  }
+  if (iter == end || *iter < '0' || *iter > '9') {
+    return nullptr;
+  }
+  Int result = 0;
+  for (; iter != end && *iter >= '0' && *iter <= '9'; ++iter) {
+    const Int digit = *iter - '0';
+    if (result > (std::numeric_limits<Int>::max() - digit) / 10) {
+      return nullptr;
+    }
+    result = 10 * result + digit;
+  }
+  if (iter != end && !matrix_market::IsWhitespace(*iter)) {
+    return nullptr;
+  }
+  *value = negative ? -result : result;
+  return iter;
+}
+
+template <class Real, typename>
+const char* ParseMatrixMarketReal(const char* iter, const char* end,
+                                  Real* value) {
+  iter = matrix_market::SkipWhitespace(iter, end);
+  const char* token_beg = iter;
+  const char* token_end = iter;
+  while (token_end != end && !matrix_market::IsWhitespace(*token_end)) {
+    ++token_end;
+  }
+
+  // Accumulate up to 19 significant digits, which fit in 64 bits.
+  bool negative = false;
+  if (iter != token_end && (*iter == '-' || *iter == '+')) {
+    negative = *iter == '-';
+    ++iter;
+  }
+  std::uint64_t mantissa = 0;
+  int num_digits = 0;
+  int exponent = 0;
+  bool has_digits = false;
+  for (; iter != token_end && *iter >= '0' && *iter <= '9'; ++iter) {
+    has_digits = true;
+    if (mantissa || *iter != '0') {
+      if (num_digits == 19) break;
+      mantissa = 10 * mantissa + (*iter - '0');
+      ++num_digits;
+    }
+  }
+  if (iter != token_end && *iter == '.') {
+    for (++iter; iter != token_end && *iter >= '0' && *iter <= '9'; ++iter) {
+      has_digits = true;
+      if (mantissa || *iter != '0') {
+        if (num_digits == 19) break;
+        mantissa = 10 * mantissa + (*iter - '0');
+        ++num_digits;
+      }
+      --exponent;
+    }
+  }
+  if (has_digits && iter != token_end && (*iter == 'e' || *iter == 'E')) {
+    Int explicit_exponent;
+    const char* exponent_end =
+        ParseMatrixMarketInteger(iter + 1, token_end, &explicit_exponent);
+    if (exponent_end == token_end && explicit_exponent > -1000 &&
+        explicit_exponent < 1000) {
+      exponent += explicit_exponent;
+      iter = token_end;
+    }
+  }
+
+  double result;
+  if (has_digits && iter == token_end && num_digits <= 15 &&
+      exponent >= -22 && exponent <= 22) {
+    // Both the mantissa and the power of ten are exact, so the single
+    // multiplication or division is correctly rounded.
+    result = double(mantissa);
+    if (exponent >= 0) {
+      result *= matrix_market::ExactPowerOfTen(exponent);
+    } else {
+      result /= matrix_market::ExactPowerOfTen(-exponent);
+    }
+    if (negative) result = -result;
+  } else if (!matrix_market::ParseRealFallback(token_beg, token_end,
+                                               &result)) {
+    return nullptr;
+  }
+  *value = result;
+  return token_end;
+}
+
+template <class Real, typename>
+const char* ParseMatrixMarketCoordinateEntry(
+    const MatrixMarketDescription& description, const char* iter,
+    const char* end, Int* row, Int* column, Real* value) {
+  iter = ParseMatrixMarketInteger(iter, end, row);
+  if (iter) iter = ParseMatrixMarketInteger(iter, end, column);
+  if (!iter) return nullptr;
+
+  // Convert from 1-based to 0-based indexing.
+  --*row;
+  --*column;
+
+  if (description.field == quotient::kMatrixMarketFieldPattern) {
+    *value = Real{1};
+    return iter;
+  }
+  if (description.field == quotient::kMatrixMarketFieldComplex) {
+    // Complex entries cannot be read into a real matrix.
+    return nullptr;
+  }
+  return ParseMatrixMarketReal(iter, end, value);
+}
+
+template <class Real, typename>
+const char* ParseMatrixMarketCoordinateEntry(
+    const MatrixMarketDescription& description, const char* iter,
+    const char* end, Int* row, Int* column, std::complex<Real>* value) {
+  Real real_value = 0, imag_value = 0;
+  if (description.field == quotient::kMatrixMarketFieldComplex) {
+    iter = ParseMatrixMarketInteger(iter, end, row);
+    if (iter) iter = ParseMatrixMarketInteger(iter, end, column);
+    if (iter) iter = ParseMatrixMarketReal(iter, end, &real_value);
+    if (iter) iter = ParseMatrixMarketReal(iter, end, &imag_value);
+    if (!iter) return nullptr;
+    --*row;
+    --*column;
+  } else {
+    iter = ParseMatrixMarketCoordinateEntry(description, iter, end, row,
+                                            column, &real_value);
+    if (!iter) return nullptr;
+  }
+  *value = std::complex<Real>{real_value, imag_value};
+  return iter;
+}
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_MATRIX_MARKET_IMPL_H_
@@ -9,7 +9,9 @@
 #define CATAMARI_MATRIX_MARKET_H_
 
 #include <complex>
+#include <cstddef>
 #include <fstream>
+#include <string>
 
 #include "catamari/integers.hpp"
 #include "quotient/matrix_market.hpp"
@@ -52,6 +54,69 @@ bool ReadMatrixMarketCoordinateEntry(const MatrixMarketDescription& description,
                                      std::ifstream& file, Int* row, Int* column,
                                      std::complex<Real>* value);
 
+// A read-only memory mapping of a (Matrix Market) file.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  // Maps the given file. Returns true if successful.
+  bool Map(const std::string& filename);
+
+  // Releases the mapping, if there is one.
+  void Unmap();
+
+  // Returns the beginning of the mapped bytes.
+  const char* Data() const { return data_; }
+
+  // Returns the number of mapped bytes.
+  std::size_t Size() const { return num_bytes_; }
+
+ private:
+  // The mapped bytes.
+  char* data_ = nullptr;
+
+  // The number of mapped bytes.
+  std::size_t num_bytes_ = 0;
+};
+
+// Parses a decimal integer from the characters in [iter, end), after any
+// leading whitespace.
+//
+// Returns the position after the integer if successful, or nullptr otherwise.
+const char* ParseMatrixMarketInteger(const char* iter, const char* end,
+                                     Int* value);
+
+// Parses a floating-point value from the characters in [iter, end), after any
+// leading whitespace. Values with at most 15 significant digits and a decimal
+// exponent of magnitude at most 22 are converted directly, with correct
+// rounding; the rest fall back to std::strtod.
+//
+// Returns the position after the value if successful, or nullptr otherwise.
+template <class Real, typename = EnableIf<IsReal<Real>>>
+const char* ParseMatrixMarketReal(const char* iter, const char* end,
+                                  Real* value);
+
+// Parses a single real entry of a coordinate-format Matrix Market file from
+// the characters in [iter, end), converting to 0-based indexing.
+//
+// Returns the position after the entry if successful, or nullptr otherwise.
+template <class Real, typename = EnableIf<IsReal<Real>>>
+const char* ParseMatrixMarketCoordinateEntry(
+    const MatrixMarketDescription& description, const char* iter,
+    const char* end, Int* row, Int* column, Real* value);
+
+// Parses a single complex entry of a coordinate-format Matrix Market file from
+// the characters in [iter, end), converting to 0-based indexing.
+//
+// Returns the position after the entry if successful, or nullptr otherwise.
+template <class Real, typename = EnableIf<IsReal<Real>>>
+const char* ParseMatrixMarketCoordinateEntry(
+    const MatrixMarketDescription& description, const char* iter,
+    const char* end, Int* row, Int* column, std::complex<Real>* value);
+
 }  // namespace catamari
 
 #include "catamari/matrix_market-impl.hpp"
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_MATRIX_MARKET_PIPELINE_IMPL_H_
+#define CATAMARI_MATRIX_MARKET_PIPELINE_IMPL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_arena.h>
+
+#include "catamari/complex.hpp"
+#include "catamari/matrix_market.hpp"
+#include "catamari/trace.hpp"
+#include "quotient/index_utils.hpp"
+
+#include "catamari/matrix_market_pipeline.hpp"
+
+namespace catamari {
+
+namespace matrix_market {
+
+// A line-aligned chunk of the entries of a coordinate-format file, along with
+// the pattern entries and values parsed from it. The sources of the pattern
+// entries index into the values of the chunk.
+template <class Field>
+struct PipelineChunk {
+  const char* beg;
+  const char* end;
+  std::vector<Int> rows;
+  std::vector<Int> columns;
+  std::vector<Int> sources;
+  std::vector<Field> values;
+  Int num_read = 0;
+  Int num_skipped = 0;
+  bool failed = false;
+};
+
+// A column of a row of the pattern and the index of its value.
+struct PatternEntry {
+  Int column, source;
+};
+
+}  // namespace matrix_market
+
+template <class Field>
+bool PipelinedMatrixMarket<Field>::Load(const std::string& filename,
+                                        bool skip_explicit_zeros,
+                                        EntryMask mask) {
+  TraceScope trace_scope("PipelinedMatrixMarket.Load");
+  typedef matrix_market::PipelineChunk<Field> Chunk;
+  pattern.Empty();
+  sources.Clear();
+  values.Clear();
+
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return false;
+  }
+  MatrixMarketDescription description;
+  if (!quotient::ReadMatrixMarketDescription(file, &description)) {
+    return false;
+  }
+  if (description.format == quotient::kMatrixMarketFormatArray) {
+    std::cerr << "Array-format files cannot be pipelined: " << filename
+              << std::endl;
+    return false;
+  }
+  Int num_rows, num_columns, num_entries;
+  if (!quotient::ReadMatrixMarketCoordinateMetadata(
+          description, file, &num_rows, &num_columns, &num_entries)) {
+    return false;
+  }
+  const std::streamoff data_offset = file.tellg();
+  file.close();
+  if (data_offset < 0) {
+    std::cerr << "Could not locate the entries of " << filename << std::endl;
+    return false;
+  }
+
+  MappedFile mapped_file;
+  if (!mapped_file.Map(filename)) {
+    std::cerr << "Could not map " << filename << std::endl;
+    return false;
+  }
+  const char* data_end = mapped_file.Data() + mapped_file.Size();
+  const char* data_iter =
+      std::min(mapped_file.Data() + data_offset, data_end);
+
+  // The mirrors of the off-diagonal entries of a symmetric file share their
+  // values, while those which must be conjugated or negated are stored.
+  const bool expand =
+      description.symmetry != quotient::kMatrixMarketSymmetryGeneral;
+  const bool share_mirrored_values =
+      description.symmetry == quotient::kMatrixMarketSymmetrySymmetric ||
+      (description.symmetry == quotient::kMatrixMarketSymmetryHermitian &&
+       !IsComplex<Field>::value);
+  const Int max_values =
+      expand && !share_mirrored_values ? 2 * num_entries : num_entries;
+  const Int max_pattern_entries = expand ? 2 * num_entries : num_entries;
+  values.Resize(max_values);
+  Buffer<Int> rows(max_pattern_entries);
+  Buffer<Int> columns(max_pattern_entries);
+  sources.Resize(max_pattern_entries);
+  Buffer<Int> row_sizes(num_rows, 0);
+
+  Int num_values = 0;
+  Int num_pattern_entries = 0;
+  Int num_read = 0;
+  Int num_skipped_entries = 0;
+  std::atomic<bool> failed(false);
+  const std::size_t num_chunk_bytes = std::max<std::size_t>(chunk_bytes, 1);
+
+  // Cuts the next chunk, ending at a line boundary, from the mapping.
+  auto cut_chunk = [&](tbb::flow_control& control) -> Chunk* {
+    if (data_iter == data_end || failed) {
+      control.stop();
+      return nullptr;
+    }
+    Chunk* chunk = new Chunk;
+    chunk->beg = data_iter;
+    data_iter = data_end - data_iter > std::ptrdiff_t(num_chunk_bytes)
+                    ? data_iter + num_chunk_bytes
+                    : data_end;
+    while (data_iter != data_end && data_iter[-1] != '\n') ++data_iter;
+    chunk->end = data_iter;
+    return chunk;
+  };
+
+  // Parses the entries of a chunk, applying the mask, the skipping of
+  // explicit zeros, and the symmetric expansion.
+  auto parse_chunk = [&](Chunk* chunk) -> Chunk* {
+    const char* iter = chunk->beg;
+    const std::size_t entries_estimate = (chunk->end - iter) / 16;
+    chunk->values.reserve(entries_estimate);
+    chunk->rows.reserve(expand ? 2 * entries_estimate : entries_estimate);
+    chunk->columns.reserve(chunk->rows.capacity());
+    chunk->sources.reserve(chunk->rows.capacity());
+    auto append = [&](Int row, Int column, Int source) {
+      chunk->rows.push_back(row);
+      chunk->columns.push_back(column);
+      chunk->sources.push_back(source);
+    };
+    while (true) {
+      iter = matrix_market::SkipWhitespace(iter, chunk->end);
+      if (iter == chunk->end) break;
+
+      Int row, column;
+      Field value;
+      iter = ParseMatrixMarketCoordinateEntry(description, iter, chunk->end,
+                                              &row, &column, &value);
+      if (!iter || row < 0 || row >= num_rows || column < 0 ||
+          column >= num_columns) {
+        chunk->failed = true;
+        break;
+      }
+      ++chunk->num_read;
+
+      if ((mask == quotient::kEntryMaskLowerTriangle && row < column) ||
+          (mask == quotient::kEntryMaskUpperTriangle && row > column)) {
+        continue;
+      }
+      if (skip_explicit_zeros && value == Field(0)) {
+        ++chunk->num_skipped;
+        continue;
+      }
+
+      const Int source = chunk->values.size();
+      chunk->values.push_back(value);
+      append(row, column, source);
+      if (!expand || row == column) continue;
+      if (share_mirrored_values) {
+        append(column, row, source);
+        continue;
+      }
+      chunk->values.push_back(
+          description.symmetry == quotient::kMatrixMarketSymmetryHermitian
+              ? Conjugate(value)
+              : -value);
+      append(column, row, source + 1);
+    }
+    return chunk;
+  };
+
+  // Appends the parsed values and pattern entries in the order of the file,
+  // counting the entries of each row as they arrive.
+  auto append_chunk = [&](Chunk* chunk) {
+    std::unique_ptr<Chunk> chunk_guard(chunk);
+    num_read += chunk->num_read;
+    num_skipped_entries += chunk->num_skipped;
+    if (chunk->failed) failed = true;
+    const Int num_chunk_values = chunk->values.size();
+    const Int num_chunk_entries = chunk->rows.size();
+    if (failed || num_values + num_chunk_values > max_values ||
+        num_pattern_entries + num_chunk_entries > max_pattern_entries) {
+      failed = true;
+      return;
+    }
+    std::copy(chunk->values.begin(), chunk->values.end(),
+              values.begin() + num_values);
+    for (Int index = 0; index < num_chunk_entries; ++index) {
+      const Int row = chunk->rows[index];
+      rows[num_pattern_entries] = row;
+      columns[num_pattern_entries] = chunk->columns[index];
+      sources[num_pattern_entries] = num_values + chunk->sources[index];
+      ++num_pattern_entries;
+      ++row_sizes[row];
+    }
+    num_values += num_chunk_values;
+  };
+
+  {
+    TraceScope pipeline_trace_scope("PipelinedMatrixMarket.Pipeline");
+    tbb::parallel_pipeline(
+        2 * tbb::this_task_arena::max_concurrency(),
+        tbb::make_filter<void, Chunk*>(tbb::filter_mode::serial_in_order,
+                                       cut_chunk) &
+            tbb::make_filter<Chunk*, Chunk*>(tbb::filter_mode::parallel,
+                                             parse_chunk) &
+            tbb::make_filter<Chunk*, void>(tbb::filter_mode::serial_in_order,
+                                           append_chunk));
+  }
+  mapped_file.Unmap();
+
+  if (failed) {
+    std::cerr << "Could not parse the entries of " << filename << std::endl;
+    values.Clear();
+    sources.Clear();
+    return false;
+  }
+  if (num_read != num_entries) {
+    std::cerr << "Expected " << num_entries << " entries in " << filename
+              << " but found " << num_read << std::endl;
+    values.Clear();
+    sources.Clear();
+    return false;
+  }
+  values.Resize(num_values);
+
+  // Bucket the pattern entries by row in the order of the file, so that the
+  // stable sort of each row keeps the last of any duplicates.
+  Buffer<Int> row_offsets;
+  quotient::OffsetScan(row_sizes, &row_offsets);
+  Buffer<matrix_market::PatternEntry> row_entries(num_pattern_entries);
+  {
+    Buffer<Int> row_ptrs(num_rows);
+    std::copy(row_offsets.begin(), row_offsets.begin() + num_rows,
+              row_ptrs.begin());
+    for (Int index = 0; index < num_pattern_entries; ++index) {
+      row_entries[row_ptrs[rows[index]]++] =
+          matrix_market::PatternEntry{columns[index], sources[index]};
+    }
+  }
+  rows.Clear();
+  columns.Clear();
+
+  auto column_less = [](const matrix_market::PatternEntry& a,
+                        const matrix_market::PatternEntry& b) {
+    return a.column < b.column;
+  };
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          matrix_market::PatternEntry* row_beg =
+              row_entries.Data() + row_offsets[row];
+          const Int row_size = row_sizes[row];
+          std::stable_sort(row_beg, row_beg + row_size, column_less);
+          Int num_packed = 0;
+          for (Int index = 0; index < row_size; ++index) {
+            if (num_packed &&
+                row_beg[num_packed - 1].column == row_beg[index].column) {
+              row_beg[num_packed - 1].source = row_beg[index].source;
+            } else {
+              row_beg[num_packed++] = row_beg[index];
+            }
+          }
+          row_sizes[row] = num_packed;
+        }
+      });
+
+  // Pack the rows into the pattern and its sources.
+  Buffer<Int> packed_offsets;
+  quotient::OffsetScan(row_sizes, &packed_offsets);
+  const Int num_unique = packed_offsets[num_rows];
+  Buffer<MatrixEntry<Field>> entries(num_unique);
+  sources.Resize(num_unique);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int row = range.begin(); row < range.end(); ++row) {
+          const matrix_market::PatternEntry* row_beg =
+              row_entries.Data() + row_offsets[row];
+          for (Int index = 0; index < row_sizes[row]; ++index) {
+            const Int entry_index = packed_offsets[row] + index;
+            entries[entry_index] =
+                MatrixEntry<Field>{row, row_beg[index].column, Field{0}};
+            sources[entry_index] = row_beg[index].source;
+          }
+        }
+      });
+  pattern.Resize(num_rows, num_columns);
+  pattern.SetSortedEntries(std::move(entries));
+
+  if (num_skipped_entries) {
+    std::cout << "Skipped " << num_skipped_entries << " explicit zeros."
+              << std::endl;
+  }
+
+  return true;
+}
+
+template <class Field>
+void PipelinedMatrixMarket<Field>::FormConversionPlan(
+    const SparseLDL<Field>& ldl, ConversionPlan* cplan) const {
+  // Form the plan of the entries of the pattern, and then redirect their
+  // sources to the values.
+  ldl.FormConversionPlan(pattern, cplan);
+  const Int num_plan_entries =
+      cplan->columnOffsets[cplan->columnOffsets.size() - 1];
+  ConversionPlan::Entry* plan_entries = cplan->entries();
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_plan_entries),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int index = range.begin(); index < range.end(); ++index) {
+          plan_entries[index].src = sources[plan_entries[index].src];
+        }
+      });
+  cplan->encodeRuns();
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_MATRIX_MARKET_PIPELINE_IMPL_H_
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_MATRIX_MARKET_PIPELINE_H_
+#define CATAMARI_MATRIX_MARKET_PIPELINE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "catamari/buffer.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// A coordinate-format Matrix Market file loaded for refactorization through a
+// 'ConversionPlan'. Rather than forming a 'CoordinateMatrix' of the values,
+// the file is memory-mapped and passed through a pipeline: line-aligned
+// chunks are cut from the mapping in order, parsed concurrently, and then
+// appended in order, so that the values are written once (in the order in
+// which they were read) into a compact array while the row counts of the
+// pattern are accumulated. Once the last chunk has been appended, the
+// pattern is bucketed by row without any comparison sort of the entries.
+//
+// A typical usage is:
+//
+//   catamari::PipelinedMatrixMarket<double> input;
+//   if (!input.Load(filename, /* skip_explicit_zeros = */ false)) { ... }
+//   catamari::SparseLDL<double> ldl;
+//   ldl.Factor(input.pattern, control, /* symbolic_only = */ true);
+//   catamari::ConversionPlan plan;
+//   input.FormConversionPlan(ldl, &plan);
+//   ldl.RefactorWithFixedSparsityPattern(plan, input.values.Data());
+//
+// Since the values of 'pattern' are all zero, it should only be factored
+// symbolically and without equilibration. As with 'FromMatrixMarket', the
+// symmetric, Hermitian and skew-symmetric files are expanded into both
+// triangles. Unlike it, duplicate entries keep the last of their values (as
+// do conversion plans) rather than being summed.
+template <class Field>
+struct PipelinedMatrixMarket {
+  // The number of bytes of the file parsed by each pipeline task.
+  std::size_t chunk_bytes = std::size_t(1) << 20;
+
+  // The (expanded) sparsity pattern of the matrix, whose values are zero,
+  // which is used for the reordering and symbolic factorization.
+  CoordinateMatrix<Field> pattern;
+
+  // The index in 'values' of the value of each entry of 'pattern'.
+  Buffer<Int> sources;
+
+  // The values of the file in the order in which they were read. The mirror
+  // of each off-diagonal entry of a symmetric file shares its value, whereas
+  // that of a (complex) Hermitian or skew-symmetric file is stored next.
+  Buffer<Field> values;
+
+  // Loads a coordinate-format Matrix Market file. Returns true if
+  // successful.
+  bool Load(const std::string& filename, bool skip_explicit_zeros,
+            EntryMask mask = EntryMask::kEntryMaskFull);
+
+  // Forms the plan for refactoring 'ldl' -- after a (symbolic) factorization
+  // of 'pattern' -- with the values loaded straight from 'values'.
+  void FormConversionPlan(const SparseLDL<Field>& ldl,
+                          ConversionPlan* cplan) const;
+};
+
+}  // namespace catamari
+
+#include "catamari/matrix_market_pipeline-impl.hpp"
+
+#endif  // ifndef CATAMARI_MATRIX_MARKET_PIPELINE_H_
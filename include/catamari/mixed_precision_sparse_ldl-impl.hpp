@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_MIXED_PRECISION_SPARSE_LDL_IMPL_H_
+#define CATAMARI_MIXED_PRECISION_SPARSE_LDL_IMPL_H_
+
+#include <algorithm>
+#include <utility>
+
+#include "catamari/apply_sparse.hpp"
+#include "catamari/norms.hpp"
+#include "catamari/refined_solve.hpp"
+
+#include "catamari/mixed_precision_sparse_ldl.hpp"
+
+namespace catamari {
+
+template <class Field>
+void DemoteCoordinateMatrix(const CoordinateMatrix<Field>& matrix,
+                            CoordinateMatrix<Demote<Field>>* lower) {
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Int num_entries = entries.Size();
+  Buffer<MatrixEntry<Demote<Field>>> lower_entries(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    const MatrixEntry<Field>& entry = entries[index];
+    MatrixEntry<Demote<Field>>& lower_entry = lower_entries[index];
+    lower_entry.row = entry.row;
+    lower_entry.column = entry.column;
+    lower_entry.value = entry.value;
+  }
+
+  // The entries are already sorted and unique, so they need not be merged.
+  lower->Resize(matrix.NumRows(), matrix.NumColumns());
+  lower->SetSortedEntries(std::move(lower_entries));
+}
+
+template <class Field>
+SparseLDLResult<Demote<Field>> MixedPrecisionSparseLDL<Field>::Factor(
+    const CoordinateMatrix<Field>& matrix,
+    const MixedPrecisionSparseLDLControl<Field>& control) {
+  control_ = control;
+  CoordinateMatrix<LowerField> lower_matrix;
+  DemoteCoordinateMatrix(matrix, &lower_matrix);
+  return ldl.Factor(lower_matrix, control_.ldl_control);
+}
+
+template <class Field>
+SparseLDLResult<Demote<Field>>
+MixedPrecisionSparseLDL<Field>::RefactorWithFixedSparsityPattern(
+    const CoordinateMatrix<Field>& matrix) {
+  CoordinateMatrix<LowerField> lower_matrix;
+  DemoteCoordinateMatrix(matrix, &lower_matrix);
+  return ldl.RefactorWithFixedSparsityPattern(lower_matrix);
+}
+
+template <class Field>
+Int MixedPrecisionSparseLDL<Field>::NumRows() const {
+  return ldl.NumRows();
+}
+
+template <class Field>
+void MixedPrecisionSparseLDL<Field>::LowerPrecisionSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int num_rows = right_hand_sides->height;
+  const Int num_rhs = right_hand_sides->width;
+
+  Buffer<Real> scales(num_rhs);
+  BlasMatrix<LowerField> lower_right_hand_sides(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    const Real norm =
+        MaxNorm(right_hand_sides->Submatrix(0, j, num_rows, 1).ToConst());
+    scales[j] = norm == Real(0) ? Real(1) : norm;
+    for (Int i = 0; i < num_rows; ++i) {
+      lower_right_hand_sides(i, j) = right_hand_sides->Entry(i, j) / scales[j];
+    }
+  }
+
+  ldl.Solve(&lower_right_hand_sides.view);
+
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      Field value = lower_right_hand_sides(i, j);
+      right_hand_sides->Entry(i, j) = value * scales[j];
+    }
+  }
+}
+
+template <class Field>
+MixedPrecisionSolveStatus<ComplexBase<Field>>
+MixedPrecisionSparseLDL<Field>::Solve(
+    const CoordinateMatrix<Field>& matrix,
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int num_rows = right_hand_sides->height;
+  const Int num_rhs = right_hand_sides->width;
+  const Real relative_tol = control_.refined_solve_control.relative_tol;
+  MixedPrecisionSolveStatus<Real> status;
+
+  auto apply_matrix = [&](Field alpha, const ConstBlasMatrixView<Field>& input,
+                          Field beta, BlasMatrixView<Field>* output) {
+    ApplySparse(alpha, matrix, input, beta, output);
+  };
+  auto apply_inverse = [&](BlasMatrixView<Field>* input) {
+    LowerPrecisionSolve(input);
+  };
+
+  const BlasMatrix<Field> rhs_orig = *right_hand_sides;
+  const RefinedSolveStatus<Real> refined_status = catamari::RefinedSolve(
+      apply_matrix, apply_inverse, control_.refined_solve_control,
+      right_hand_sides);
+  status.num_refinement_iterations = refined_status.num_iterations;
+  status.residual_relative_max_norm = refined_status.residual_relative_max_norm;
+  if (!control_.fgmres_fallback ||
+      status.residual_relative_max_norm <= relative_tol) {
+    return status;
+  }
+
+  // Solve for the remaining corrections of the right-hand sides whose
+  // refinement stalled, A d = b - A x, using FGMRES preconditioned by the
+  // lower-precision factorization. A correction is only accepted if it
+  // reduces the residual.
+  BlasMatrix<Field> residuals = rhs_orig;
+  apply_matrix(Field{-1}, right_hand_sides->ToConst(), Field{1},
+               &residuals.view);
+  BlasMatrix<Field> correction, candidate, candidate_residual;
+  FGMRESWorkspace<Field> fgmres_workspace;
+  status.residual_relative_max_norm = 0;
+  for (Int j = 0; j < num_rhs; ++j) {
+    const Real rhs_norm = MaxNorm(rhs_orig.Submatrix(0, j, num_rows, 1));
+    const Real scale = rhs_norm == Real(0) ? Real(1) : rhs_norm;
+    const ConstBlasMatrixView<Field> residual =
+        residuals.Submatrix(0, j, num_rows, 1).ToConst();
+    Real relative_error = MaxNorm(residual) / scale;
+    if (relative_error > relative_tol) {
+      const FGMRESStatus<Real> fgmres_status =
+          FGMRES(apply_matrix, apply_inverse, control_.fgmres_control,
+                 residual, &correction, &fgmres_workspace);
+      ++status.num_fgmres_solves;
+      status.num_fgmres_iterations =
+          std::max(status.num_fgmres_iterations, fgmres_status.num_iterations);
+
+      candidate.Resize(num_rows, 1);
+      for (Int i = 0; i < num_rows; ++i) {
+        candidate(i) = right_hand_sides->Entry(i, j) + correction(i);
+      }
+      candidate_residual.Resize(num_rows, 1);
+      for (Int i = 0; i < num_rows; ++i) {
+        candidate_residual(i) = rhs_orig(i, j);
+      }
+      apply_matrix(Field{-1}, candidate.ConstView(), Field{1},
+                   &candidate_residual.view);
+      const Real candidate_error =
+          MaxNorm(candidate_residual.ConstView()) / scale;
+      if (candidate_error < relative_error) {
+        for (Int i = 0; i < num_rows; ++i) {
+          right_hand_sides->Entry(i, j) = candidate(i);
+        }
+        relative_error = candidate_error;
+      }
+    }
+    status.residual_relative_max_norm =
+        std::max(status.residual_relative_max_norm, relative_error);
+  }
+
+  return status;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_MIXED_PRECISION_SPARSE_LDL_IMPL_H_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_MIXED_PRECISION_SPARSE_LDL_H_
+#define CATAMARI_MIXED_PRECISION_SPARSE_LDL_H_
+
+#include <type_traits>
+
+#include "catamari/fgmres.hpp"
+#include "catamari/promote.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// Configuration options for a mixed-precision factorization and solve.
+template <typename Field>
+struct MixedPrecisionSparseLDLControl {
+  // The configuration options for the lower-precision factorization.
+  SparseLDLControl<Demote<Field>> ldl_control;
+
+  // The configuration options for the iterative refinement, which is run in
+  // the working precision against the original matrix. The tolerance should
+  // be that of the working precision, and, since each refinement step only
+  // gains roughly the precision of the factorization, more steps are allowed
+  // than for a full-precision factorization.
+  RefinedSolveControl<ComplexBase<Field>> refined_solve_control;
+
+  // If true, the right-hand sides for which iterative refinement stalls above
+  // the tolerance are handed to FGMRES, preconditioned by the lower-precision
+  // factorization, to solve for the remaining correction.
+  bool fgmres_fallback = true;
+
+  // The configuration options for the FGMRES fallback.
+  FGMRESControl<ComplexBase<Field>> fgmres_control;
+
+  MixedPrecisionSparseLDLControl() {
+    refined_solve_control.max_iters = 10;
+    fgmres_control.relative_tolerance_coefficient = 10;
+    fgmres_control.relative_tolerance_exponent = 1;
+  }
+};
+
+// The return value of a mixed-precision solve.
+template <typename Real>
+struct MixedPrecisionSolveStatus {
+  // The number of performed iterative refinement iterations.
+  Int num_refinement_iterations = 0;
+
+  // The number of right-hand sides which were handed to the FGMRES fallback.
+  Int num_fgmres_solves = 0;
+
+  // The maximum number of FGMRES iterations performed for any of the
+  // right-hand sides.
+  Int num_fgmres_iterations = 0;
+
+  // The maximum of the relative max norms of the final residuals, i.e.,
+  //
+  //   max_j || b_j - A x_j ||_{max} / || b_j ||_{max},
+  //
+  // where we replace any division by zero with division by one.
+  Real residual_relative_max_norm = 0;
+};
+
+// A sparse LDL' factorization that is stored and computed in a lower
+// precision (e.g., single precision for a double-precision matrix), with
+// solves refined in the working precision against the original matrix. For
+// reasonably well-conditioned systems, this halves the memory of the factor
+// and roughly doubles the throughput of its dense kernels, while still
+// converging to working-precision accuracy.
+template <class Field>
+class MixedPrecisionSparseLDL {
+ public:
+  // The underlying real datatype of the scalar type.
+  typedef ComplexBase<Field> Real;
+
+  // The precision of the factorization.
+  typedef Demote<Field> LowerField;
+
+  static_assert(std::is_same<Promote<LowerField>, Field>::value,
+                "The factorization precision must promote to the working one.");
+
+  // The lower-precision factorization.
+  SparseLDL<LowerField> ldl;
+
+  // Factors a lower-precision copy of the matrix using an automatically
+  // determined ordering. The matrix itself must be kept alive by the caller
+  // and passed to 'Solve'.
+  SparseLDLResult<LowerField> Factor(
+      const CoordinateMatrix<Field>& matrix,
+      const MixedPrecisionSparseLDLControl<Field>& control);
+
+  // Factors a lower-precision copy of a new matrix with the same sparsity
+  // pattern as the previous factorization.
+  SparseLDLResult<LowerField> RefactorWithFixedSparsityPattern(
+      const CoordinateMatrix<Field>& matrix);
+
+  // Solves a set of linear systems with 'matrix', which must be the most
+  // recently factored matrix, using iterative refinement in the working
+  // precision and, if enabled, an FGMRES fallback for the right-hand sides
+  // whose refinement stalled.
+  MixedPrecisionSolveStatus<Real> Solve(
+      const CoordinateMatrix<Field>& matrix,
+      BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Returns the number of rows of the last factored matrix.
+  Int NumRows() const;
+
+ private:
+  // The configuration of the last factorization and its solves.
+  MixedPrecisionSparseLDLControl<Field> control_;
+
+  // Solves against the lower-precision factorization in place. Each column is
+  // scaled by its max norm before being demoted so that small residuals do
+  // not underflow the lower precision.
+  void LowerPrecisionSolve(BlasMatrixView<Field>* right_hand_sides) const;
+};
+
+// Fills 'lower' with a copy of 'matrix' in the lower precision.
+template <class Field>
+void DemoteCoordinateMatrix(const CoordinateMatrix<Field>& matrix,
+                            CoordinateMatrix<Demote<Field>>* lower);
+
+}  // namespace catamari
+
+#include "catamari/mixed_precision_sparse_ldl-impl.hpp"
+
+#endif  // ifndef CATAMARI_MIXED_PRECISION_SPARSE_LDL_H_
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_NESTED_DISSECTION_IMPL_H_
+#define CATAMARI_NESTED_DISSECTION_IMPL_H_
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#include <tbb/task_group.h>
+
+#include "catamari/index_utils.hpp"
+
+#include "catamari/nested_dissection.hpp"
+
+namespace catamari {
+namespace nested_dissection {
+
+template <class Field>
+void MatrixGraph(const CoordinateMatrix<Field>& matrix, Graph* graph) {
+  const Int num_rows = matrix.NumRows();
+
+  // Count the (possibly duplicated) neighbors of each vertex from both
+  // triangles so that the graph is symmetric even if only one is stored.
+  Buffer<Int> offsets(num_rows + 1, 0);
+  for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (entry.row == entry.column) continue;
+    ++offsets[entry.row + 1];
+    ++offsets[entry.column + 1];
+  }
+  for (Int row = 0; row < num_rows; ++row) offsets[row + 1] += offsets[row];
+  Buffer<Int> neighbors(offsets[num_rows]);
+  Buffer<Int> ptrs(num_rows);
+  for (Int row = 0; row < num_rows; ++row) ptrs[row] = offsets[row];
+  for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (entry.row == entry.column) continue;
+    neighbors[ptrs[entry.row]++] = entry.column;
+    neighbors[ptrs[entry.column]++] = entry.row;
+  }
+
+  // Sort and deduplicate each neighbor list in place.
+  graph->offsets.Resize(num_rows + 1);
+  graph->offsets[0] = 0;
+  Int num_neighbors = 0;
+  for (Int row = 0; row < num_rows; ++row) {
+    Int* beg = neighbors.Data() + offsets[row];
+    Int* end = neighbors.Data() + offsets[row + 1];
+    std::sort(beg, end);
+    end = std::unique(beg, end);
+    for (const Int* neighbor = beg; neighbor != end; ++neighbor) {
+      neighbors[num_neighbors++] = *neighbor;
+    }
+    graph->offsets[row + 1] = num_neighbors;
+  }
+  neighbors.Resize(num_neighbors);
+  graph->neighbors = std::move(neighbors);
+
+  graph->vertices.Resize(num_rows);
+  for (Int row = 0; row < num_rows; ++row) graph->vertices[row] = row;
+}
+
+inline void SplitGraph(const Graph& graph, const Buffer<Int>& parts,
+                       Int num_parts, Buffer<Graph>* subgraphs) {
+  const Int num_vertices = graph.NumVertices();
+
+  // Map each vertex to its index within its part and count the sizes of the
+  // parts.
+  Buffer<Int> local_indices(num_vertices, -1);
+  Buffer<Int> part_sizes(num_parts, 0);
+  Buffer<Int> part_num_neighbors(num_parts, 0);
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    const Int part = parts[vertex];
+    if (part < 0) continue;
+    local_indices[vertex] = part_sizes[part]++;
+    for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+         ++index) {
+      if (parts[graph.neighbors[index]] == part) ++part_num_neighbors[part];
+    }
+  }
+
+  subgraphs->Resize(num_parts);
+  for (Int part = 0; part < num_parts; ++part) {
+    Graph& subgraph = (*subgraphs)[part];
+    subgraph.offsets.Resize(part_sizes[part] + 1);
+    subgraph.offsets[0] = 0;
+    subgraph.neighbors.Resize(part_num_neighbors[part]);
+    subgraph.vertices.Resize(part_sizes[part]);
+  }
+
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    const Int part = parts[vertex];
+    if (part < 0) continue;
+    Graph& subgraph = (*subgraphs)[part];
+    const Int local_index = local_indices[vertex];
+    Int num_neighbors = subgraph.offsets[local_index];
+    for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+         ++index) {
+      const Int neighbor = graph.neighbors[index];
+      if (parts[neighbor] == part) {
+        subgraph.neighbors[num_neighbors++] = local_indices[neighbor];
+      }
+    }
+    subgraph.offsets[local_index + 1] = num_neighbors;
+    subgraph.vertices[local_index] = graph.vertices[vertex];
+  }
+}
+
+inline Int ConnectedComponents(const Graph& graph, Buffer<Int>* components) {
+  const Int num_vertices = graph.NumVertices();
+  components->Resize(num_vertices);
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    (*components)[vertex] = -1;
+  }
+
+  Buffer<Int> queue(num_vertices);
+  Int num_components = 0;
+  for (Int root = 0; root < num_vertices; ++root) {
+    if ((*components)[root] != -1) continue;
+    Int queue_beg = 0;
+    Int queue_end = 0;
+    queue[queue_end++] = root;
+    (*components)[root] = num_components;
+    while (queue_beg < queue_end) {
+      const Int vertex = queue[queue_beg++];
+      for (Int index = graph.offsets[vertex];
+           index < graph.offsets[vertex + 1]; ++index) {
+        const Int neighbor = graph.neighbors[index];
+        if ((*components)[neighbor] == -1) {
+          (*components)[neighbor] = num_components;
+          queue[queue_end++] = neighbor;
+        }
+      }
+    }
+    ++num_components;
+  }
+  return num_components;
+}
+
+// Fills the breadth-first levels of the vertices from the given root and
+// returns the number of levels.
+inline Int BreadthFirstLevels(const Graph& graph, Int root,
+                              Buffer<Int>* levels) {
+  const Int num_vertices = graph.NumVertices();
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    (*levels)[vertex] = -1;
+  }
+
+  Buffer<Int> queue(num_vertices);
+  Int queue_beg = 0;
+  Int queue_end = 0;
+  queue[queue_end++] = root;
+  (*levels)[root] = 0;
+  Int num_levels = 1;
+  while (queue_beg < queue_end) {
+    const Int vertex = queue[queue_beg++];
+    const Int level = (*levels)[vertex];
+    for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+         ++index) {
+      const Int neighbor = graph.neighbors[index];
+      if ((*levels)[neighbor] == -1) {
+        (*levels)[neighbor] = level + 1;
+        num_levels = level + 2;
+        queue[queue_end++] = neighbor;
+      }
+    }
+  }
+  return num_levels;
+}
+
+inline Int PseudoPeripheralLevels(const Graph& graph, Int max_searches,
+                                  Buffer<Int>* levels) {
+  const Int num_vertices = graph.NumVertices();
+  levels->Resize(num_vertices);
+  auto degree = [&](Int vertex) {
+    return graph.offsets[vertex + 1] - graph.offsets[vertex];
+  };
+
+  // Start from a vertex of minimum degree and repeatedly restart from a
+  // vertex of minimum degree in the last level while the eccentricity grows.
+  Int root = 0;
+  for (Int vertex = 1; vertex < num_vertices; ++vertex) {
+    if (degree(vertex) < degree(root)) root = vertex;
+  }
+  Int num_levels = BreadthFirstLevels(graph, root, levels);
+  Buffer<Int> candidate_levels(num_vertices);
+  for (Int search = 1; search < max_searches; ++search) {
+    Int candidate = -1;
+    for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+      if ((*levels)[vertex] != num_levels - 1) continue;
+      if (candidate == -1 || degree(vertex) < degree(candidate)) {
+        candidate = vertex;
+      }
+    }
+    const Int candidate_num_levels =
+        BreadthFirstLevels(graph, candidate, &candidate_levels);
+    if (candidate_num_levels <= num_levels) break;
+    num_levels = candidate_num_levels;
+    std::swap(*levels, candidate_levels);
+  }
+  return num_levels;
+}
+
+inline bool Bisect(const Graph& graph, const NestedDissectionControl& control,
+                   Buffer<Int>* parts) {
+  const Int num_vertices = graph.NumVertices();
+  Buffer<Int> levels;
+  const Int num_levels =
+      PseudoPeripheralLevels(graph, control.max_peripheral_searches, &levels);
+  if (num_levels < 3) {
+    // Every interior level would leave one of the halves empty.
+    return false;
+  }
+
+  // Choose the interior level which most evenly splits the remaining
+  // vertices, as the vertices of each level are only adjacent to those of the
+  // neighboring levels.
+  Buffer<Int> level_sizes(num_levels, 0);
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    ++level_sizes[levels[vertex]];
+  }
+  Int separator_level = 1;
+  Int best_imbalance = num_vertices;
+  Int num_before = level_sizes[0];
+  for (Int level = 1; level < num_levels - 1; ++level) {
+    const Int num_after = num_vertices - num_before - level_sizes[level];
+    const Int imbalance = std::abs(num_after - num_before);
+    if (imbalance < best_imbalance) {
+      best_imbalance = imbalance;
+      separator_level = level;
+    }
+    num_before += level_sizes[level];
+  }
+
+  parts->Resize(num_vertices);
+  Int part_sizes[2] = {0, 0};
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    const Int level = levels[vertex];
+    const Int part =
+        level < separator_level ? 0 : (level == separator_level ? -1 : 1);
+    (*parts)[vertex] = part;
+    if (part >= 0) ++part_sizes[part];
+  }
+
+  // Thin the separator: a separator vertex which is not adjacent to one of
+  // the halves may join the other one. Since the labels are updated
+  // immediately, the remaining separator still splits the two halves. Ties
+  // are broken in favor of the smaller half.
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    if ((*parts)[vertex] != -1) continue;
+    bool adjacent[2] = {false, false};
+    for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+         ++index) {
+      const Int part = (*parts)[graph.neighbors[index]];
+      if (part >= 0) adjacent[part] = true;
+    }
+    if (adjacent[0] && adjacent[1]) continue;
+    Int part;
+    if (adjacent[0]) {
+      part = 0;
+    } else if (adjacent[1]) {
+      part = 1;
+    } else {
+      part = part_sizes[0] <= part_sizes[1] ? 0 : 1;
+    }
+    (*parts)[vertex] = part;
+    ++part_sizes[part];
+  }
+
+  return part_sizes[0] > 0 && part_sizes[1] > 0;
+}
+
+// Reorders a leaf of the dissection by minimum degree and fills its subtree.
+template <class Field>
+void OrderLeaf(const Graph& graph, Int offset,
+               const NestedDissectionControl& control,
+               Buffer<Int>* inverse_permutation, Subtree* subtree) {
+  const Int num_vertices = graph.NumVertices();
+  Buffer<MatrixEntry<Field>> entries(num_vertices + graph.neighbors.Size());
+  Int num_entries = 0;
+  auto append_entry = [&](Int row, Int column) {
+    MatrixEntry<Field>& entry = entries[num_entries++];
+    entry.row = row;
+    entry.column = column;
+    entry.value = Field{1};
+  };
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    // The neighbor lists are sorted, so the diagonal entry is inserted in
+    // place to keep the entries lexicographically sorted.
+    bool inserted_diagonal = false;
+    for (Int index = graph.offsets[vertex]; index < graph.offsets[vertex + 1];
+         ++index) {
+      const Int neighbor = graph.neighbors[index];
+      if (!inserted_diagonal && neighbor > vertex) {
+        append_entry(vertex, vertex);
+        inserted_diagonal = true;
+      }
+      append_entry(vertex, neighbor);
+    }
+    if (!inserted_diagonal) {
+      append_entry(vertex, vertex);
+    }
+  }
+
+  quotient::QuotientGraph quotient_graph(num_vertices, entries,
+                                         control.md_control);
+  quotient::MinimumDegree(&quotient_graph);
+  Buffer<Int> leaf_inverse_permutation;
+  quotient_graph.ComputePostorder(&leaf_inverse_permutation);
+  for (Int index = 0; index < num_vertices; ++index) {
+    (*inverse_permutation)[offset + index] =
+        graph.vertices[leaf_inverse_permutation[index]];
+  }
+
+  if (control.leaf_assembly_forests) {
+    Buffer<Int> leaf_permutation;
+    InvertPermutation(leaf_inverse_permutation, &leaf_permutation);
+    Buffer<Int> member_to_supernode;
+    quotient_graph.PermutedMemberToSupernode(leaf_inverse_permutation,
+                                             &member_to_supernode);
+    quotient_graph.PermutedAssemblyParents(leaf_permutation,
+                                           member_to_supernode,
+                                           &subtree->parents);
+    quotient_graph.PermutedSupernodeSizes(leaf_inverse_permutation,
+                                          &subtree->supernode_sizes);
+  } else {
+    subtree->supernode_sizes.Resize(1);
+    subtree->parents.Resize(1);
+    subtree->supernode_sizes[0] = num_vertices;
+    subtree->parents[0] = -1;
+  }
+}
+
+// Dissects each of the given subgraphs into consecutive positions beginning
+// at 'offset' (concurrently if there are enough vertices) and appends their
+// subtrees, as siblings, to 'subtree'.
+template <class Field>
+void DissectParts(const Buffer<Graph>& subgraphs, Int offset,
+                  bool parallel, const NestedDissectionControl& control,
+                  Buffer<Int>* inverse_permutation, Subtree* subtree) {
+  const Int num_parts = subgraphs.Size();
+  Buffer<Int> part_offsets(num_parts);
+  for (Int part = 0; part < num_parts; ++part) {
+    part_offsets[part] = offset;
+    offset += subgraphs[part].NumVertices();
+  }
+
+  Buffer<Subtree> subtrees(num_parts);
+  if (parallel) {
+    tbb::task_group group;
+    for (Int part = 0; part < num_parts; ++part) {
+      group.run([&, part]() {
+        NestedDissectionRecursion<Field>(subgraphs[part], part_offsets[part],
+                                         control, inverse_permutation,
+                                         &subtrees[part]);
+      });
+    }
+    group.wait();
+  } else {
+    for (Int part = 0; part < num_parts; ++part) {
+      NestedDissectionRecursion<Field>(subgraphs[part], part_offsets[part],
+                                       control, inverse_permutation,
+                                       &subtrees[part]);
+    }
+  }
+
+  Int num_supernodes = subtree->supernode_sizes.Size();
+  for (const Subtree& part_subtree : subtrees) {
+    num_supernodes += part_subtree.supernode_sizes.Size();
+  }
+  Int supernode = subtree->supernode_sizes.Size();
+  subtree->supernode_sizes.Resize(num_supernodes);
+  subtree->parents.Resize(num_supernodes);
+  for (const Subtree& part_subtree : subtrees) {
+    const Int base = supernode;
+    for (Int index = 0; index < part_subtree.supernode_sizes.Size(); ++index) {
+      const Int parent = part_subtree.parents[index];
+      subtree->supernode_sizes[supernode] = part_subtree.supernode_sizes[index];
+      subtree->parents[supernode++] = parent == -1 ? -1 : base + parent;
+    }
+  }
+}
+
+template <class Field>
+void NestedDissectionRecursion(const Graph& graph, Int offset,
+                               const NestedDissectionControl& control,
+                               Buffer<Int>* inverse_permutation,
+                               Subtree* subtree) {
+  const Int num_vertices = graph.NumVertices();
+  const bool parallel = num_vertices >= control.parallel_size;
+  subtree->supernode_sizes.Clear();
+  subtree->parents.Clear();
+  if (!num_vertices) return;
+
+  // Dissect each connected component independently, as sibling subtrees.
+  Buffer<Int> parts;
+  const Int num_components = ConnectedComponents(graph, &parts);
+  if (num_components > 1) {
+    Buffer<Graph> components;
+    SplitGraph(graph, parts, num_components, &components);
+    DissectParts<Field>(components, offset, parallel, control,
+                        inverse_permutation, subtree);
+    return;
+  }
+
+  if (num_vertices <= control.leaf_size || !Bisect(graph, control, &parts)) {
+    OrderLeaf<Field>(graph, offset, control, inverse_permutation, subtree);
+    return;
+  }
+
+  Buffer<Graph> halves;
+  SplitGraph(graph, parts, 2, &halves);
+  DissectParts<Field>(halves, offset, parallel, control, inverse_permutation,
+                      subtree);
+
+  // Order the separator last, as the parent of the roots of both halves.
+  Int separator_offset =
+      offset + halves[0].NumVertices() + halves[1].NumVertices();
+  const Int separator_size = num_vertices - (separator_offset - offset);
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    if (parts[vertex] == -1) {
+      (*inverse_permutation)[separator_offset++] = graph.vertices[vertex];
+    }
+  }
+  const Int separator = subtree->supernode_sizes.Size();
+  for (Int supernode = 0; supernode < separator; ++supernode) {
+    if (subtree->parents[supernode] == -1) {
+      subtree->parents[supernode] = separator;
+    }
+  }
+  subtree->supernode_sizes.Resize(separator + 1);
+  subtree->parents.Resize(separator + 1);
+  subtree->supernode_sizes[separator] = separator_size;
+  subtree->parents[separator] = -1;
+}
+
+}  // namespace nested_dissection
+
+template <class Field>
+void NestedDissection(const CoordinateMatrix<Field>& matrix,
+                      const NestedDissectionControl& control,
+                      SymmetricOrdering* ordering) {
+  const Int num_rows = matrix.NumRows();
+  nested_dissection::Graph graph;
+  nested_dissection::MatrixGraph(matrix, &graph);
+
+  nested_dissection::Subtree subtree;
+  ordering->inverse_permutation.Resize(num_rows);
+  nested_dissection::NestedDissectionRecursion<Field>(
+      graph, 0, control, &ordering->inverse_permutation, &subtree);
+  InvertPermutation(ordering->inverse_permutation, &ordering->permutation);
+
+  ordering->supernode_sizes = std::move(subtree.supernode_sizes);
+  OffsetScan(ordering->supernode_sizes, &ordering->supernode_offsets);
+  ordering->assembly_forest.parents = std::move(subtree.parents);
+  ordering->assembly_forest.FillFromParents();
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_NESTED_DISSECTION_IMPL_H_
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_NESTED_DISSECTION_H_
+#define CATAMARI_NESTED_DISSECTION_H_
+
+#include "catamari/buffer.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+#include "catamari/symmetric_ordering.hpp"
+#include "quotient/minimum_degree.hpp"
+
+namespace catamari {
+
+// Configuration options for the nested-dissection reordering of the graph of
+// an arbitrary sparse matrix.
+struct NestedDissectionControl {
+  // Connected subgraphs with at most this many vertices are not dissected
+  // further and are instead reordered by minimum degree.
+  Int leaf_size = 128;
+
+  // The configuration options for the minimum degree reordering of the
+  // leaves of the dissection.
+  quotient::MinimumDegreeControl md_control;
+
+  // Subgraphs with at least this many vertices have their parts dissected by
+  // concurrent TBB tasks.
+  Int parallel_size = 4096;
+
+  // The maximum number of breadth-first searches used to find a
+  // pseudo-peripheral root for the level structure of each bisection.
+  Int max_peripheral_searches = 5;
+
+  // If true, the supernodal assembly forest of the minimum degree reordering
+  // of each leaf is kept, rather than treating each leaf as a single
+  // supernode, which is necessary for large leaves.
+  bool leaf_assembly_forests = false;
+};
+
+namespace nested_dissection {
+
+// A subgraph of the (symmetrized) graph of a sparse matrix, without
+// self-loops, in a compressed sparse row format over local vertex indices.
+struct Graph {
+  // The neighbors of local vertex 'i' are stored in indices 'offsets[i]'
+  // through 'offsets[i + 1]' of 'neighbors'.
+  Buffer<Int> offsets;
+
+  // The packed local indices of the neighbors of each vertex.
+  Buffer<Int> neighbors;
+
+  // The index of each local vertex in the original matrix.
+  Buffer<Int> vertices;
+
+  // Returns the number of vertices in the subgraph.
+  Int NumVertices() const { return vertices.Size(); }
+};
+
+// The supernodal assembly forest of the dissection of a subgraph, in
+// postorder and with local supernode indices.
+struct Subtree {
+  // The number of vertices in each supernode.
+  Buffer<Int> supernode_sizes;
+
+  // The parent of each supernode, or -1 for the roots of the subtree.
+  Buffer<Int> parents;
+};
+
+// Fills the symmetrized graph of the matrix (excluding the diagonal).
+template <class Field>
+void MatrixGraph(const CoordinateMatrix<Field>& matrix, Graph* graph);
+
+// Splits the vertices of 'graph' with non-negative labels in 'parts' into
+// 'num_parts' subgraphs, preserving the relative order of the vertices.
+void SplitGraph(const Graph& graph, const Buffer<Int>& parts, Int num_parts,
+                Buffer<Graph>* subgraphs);
+
+// Labels the connected components of 'graph' and returns their number.
+Int ConnectedComponents(const Graph& graph, Buffer<Int>* components);
+
+// Fills the breadth-first level of each vertex from a pseudo-peripheral root
+// of the (connected) graph and returns the number of levels.
+Int PseudoPeripheralLevels(const Graph& graph, Int max_searches,
+                           Buffer<Int>* levels);
+
+// Labels each vertex of the (connected) graph with 0 or 1, for the two halves
+// of a bisection, or -1, for the vertex separator between them, and returns
+// false if no such bisection with non-empty halves was found.
+bool Bisect(const Graph& graph, const NestedDissectionControl& control,
+            Buffer<Int>* parts);
+
+// Reorders the vertices of 'graph' into positions 'offset' through
+// 'offset + graph.NumVertices()' of 'inverse_permutation' and fills the
+// assembly forest of the dissection.
+template <class Field>
+void NestedDissectionRecursion(const Graph& graph, Int offset,
+                               const NestedDissectionControl& control,
+                               Buffer<Int>* inverse_permutation,
+                               Subtree* subtree);
+
+}  // namespace nested_dissection
+
+// Fills 'ordering' with a nested-dissection reordering of the graph of the
+// given (structurally symmetric) matrix, along with the supernodal assembly
+// forest implied by its separators, which is suitable for the parallel
+// symbolic analysis and factorization.
+//
+// Each connected subgraph is recursively bisected using the level structure
+// of a breadth-first search from a pseudo-peripheral vertex (as in George's
+// automatic nested dissection), with the most balanced level as the vertex
+// separator, which is then thinned of vertices that are not adjacent to both
+// halves. The leaves of the dissection are reordered by minimum degree.
+template <class Field>
+void NestedDissection(const CoordinateMatrix<Field>& matrix,
+                      const NestedDissectionControl& control,
+                      SymmetricOrdering* ordering);
+
+}  // namespace catamari
+
+#include "catamari/nested_dissection-impl.hpp"
+
+#endif  // ifndef CATAMARI_NESTED_DISSECTION_H_
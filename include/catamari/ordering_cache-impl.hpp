@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_ORDERING_CACHE_IMPL_H_
+#define CATAMARI_ORDERING_CACHE_IMPL_H_
+
+#include "catamari/ordering_cache.hpp"
+
+namespace catamari {
+
+namespace ordering_cache {
+
+// Mixes a value into a running hash using the multiply-xorshift finalizer of
+// SplitMix64, which avalanches every input bit.
+inline std::uint64_t MixHash(std::uint64_t hash, std::uint64_t value) {
+  hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+// Returns the number of bytes held by the buffers of an ordering.
+inline std::size_t OrderingNumBytes(const SymmetricOrdering& ordering) {
+  const AssemblyForest& forest = ordering.assembly_forest;
+  const Int num_indices =
+      ordering.permutation.Size() + ordering.inverse_permutation.Size() +
+      ordering.supernode_sizes.Size() + ordering.supernode_offsets.Size() +
+      forest.parents.Size() + forest.children.Size() +
+      forest.child_offsets.Size() + forest.roots.Size();
+  return num_indices * sizeof(Int);
+}
+
+}  // namespace ordering_cache
+
+inline bool SparsityPatternFingerprint::operator==(
+    const SparsityPatternFingerprint& other) const {
+  return num_rows == other.num_rows && num_entries == other.num_entries &&
+         hashes[0] == other.hashes[0] && hashes[1] == other.hashes[1];
+}
+
+template <class Field>
+SparsityPatternFingerprint PatternFingerprint(
+    const CoordinateMatrix<Field>& matrix) {
+  SparsityPatternFingerprint fingerprint;
+  fingerprint.num_rows = matrix.NumRows();
+  fingerprint.num_entries = matrix.NumEntries();
+
+  // The two hashes are seeded differently and consume the row offsets and
+  // column indices in opposite orders so that they are independent.
+  std::uint64_t hashes[2] = {0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+  const Buffer<Int>& row_entry_offsets = matrix.RowEntryOffsets();
+  for (const Int& offset : row_entry_offsets) {
+    hashes[0] = ordering_cache::MixHash(hashes[0], offset);
+  }
+  for (const Int& column : matrix.ColumnIndices()) {
+    hashes[0] = ordering_cache::MixHash(hashes[0], column);
+    hashes[1] = ordering_cache::MixHash(hashes[1], column);
+  }
+  for (const Int& offset : row_entry_offsets) {
+    hashes[1] = ordering_cache::MixHash(hashes[1], offset);
+  }
+  fingerprint.hashes[0] = hashes[0];
+  fingerprint.hashes[1] = hashes[1];
+
+  return fingerprint;
+}
+
+inline bool OrderingCache::Key::operator==(const Key& other) const {
+  return fingerprint == other.fingerprint &&
+         reordering_strategy == other.reordering_strategy &&
+         block_size == other.block_size &&
+         num_threads == other.num_threads;
+}
+
+inline OrderingCache& OrderingCache::Global() {
+  static OrderingCache cache;
+  return cache;
+}
+
+inline bool OrderingCache::Lookup(const Key& key, CachedOrdering* ordering) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto location = locations_.find(key);
+  if (location == locations_.end()) {
+    ++statistics_.num_misses;
+    return false;
+  }
+  ++statistics_.num_hits;
+  entries_.splice(entries_.begin(), entries_, location->second);
+  *ordering = location->second->ordering;
+  return true;
+}
+
+inline void OrderingCache::Insert(const Key& key,
+                                  const CachedOrdering& ordering) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto location = locations_.find(key);
+  if (location != locations_.end()) {
+    num_bytes_ -= location->second->num_bytes;
+    entries_.erase(location->second);
+    locations_.erase(location);
+  }
+
+  // The relative indices of the assembly forest are formed by (and shared
+  // with) the factorization; they are not part of the reordering.
+  Entry entry{key, ordering,
+              ordering_cache::OrderingNumBytes(ordering.ordering)};
+  entry.ordering.ordering.assembly_forest.child_relative_indices.reset();
+  num_bytes_ += entry.num_bytes;
+  entries_.push_front(std::move(entry));
+  locations_[key] = entries_.begin();
+  EnforceLimits();
+}
+
+inline void OrderingCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  locations_.clear();
+  num_bytes_ = 0;
+}
+
+inline void OrderingCache::SetLimits(Int max_num_orderings,
+                                     std::size_t max_num_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_num_orderings_ = max_num_orderings;
+  max_num_bytes_ = max_num_bytes;
+  EnforceLimits();
+}
+
+inline Int OrderingCache::NumOrderings() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+inline std::size_t OrderingCache::NumBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_bytes_;
+}
+
+inline OrderingCache::Statistics OrderingCache::LookupStatistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+inline void OrderingCache::EnforceLimits() {
+  auto exceeded = [&]() {
+    return (max_num_orderings_ > 0 &&
+            Int(entries_.size()) > max_num_orderings_) ||
+           (max_num_bytes_ > 0 && num_bytes_ > max_num_bytes_);
+  };
+  while (!entries_.empty() && exceeded()) {
+    const Entry& entry = entries_.back();
+    num_bytes_ -= entry.num_bytes;
+    locations_.erase(entry.key);
+    entries_.pop_back();
+    ++statistics_.num_evictions;
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_ORDERING_CACHE_IMPL_H_
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_ORDERING_CACHE_H_
+#define CATAMARI_ORDERING_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+#include "catamari/symmetric_ordering.hpp"
+
+namespace catamari {
+
+// A fingerprint of the sparsity pattern of a matrix: its dimensions and two
+// independent 64-bit hashes of its row offsets and column indices (with a
+// collision probability of roughly 2^{-128} for distinct patterns).
+struct SparsityPatternFingerprint {
+  // The number of rows of the matrix.
+  Int num_rows = 0;
+
+  // The number of stored entries of the matrix.
+  Int num_entries = 0;
+
+  // The two hashes of the pattern.
+  std::uint64_t hashes[2] = {0, 0};
+
+  // Returns true if the fingerprints are identical.
+  bool operator==(const SparsityPatternFingerprint& other) const;
+};
+
+// Returns the fingerprint of the sparsity pattern of the given matrix.
+template <class Field>
+SparsityPatternFingerprint PatternFingerprint(
+    const CoordinateMatrix<Field>& matrix);
+
+// The reordering of a sparsity pattern, as stored in an 'OrderingCache'.
+struct CachedOrdering {
+  // The reordering, including (if it was computed) its supernodal partition
+  // and assembly forest, which allow the symbolic analysis to run in
+  // parallel.
+  SymmetricOrdering ordering;
+
+  // Whether the reordering analysis chose a supernodal factorization.
+  bool supernodal = true;
+};
+
+// A thread-safe, least-recently-used cache mapping the sparsity pattern
+// fingerprints (and the reordering strategy) of factored matrices to their
+// reorderings, so that matrices with a previously seen pattern -- even if
+// held by different factorization objects -- skip the reordering. Entries are
+// evicted once either the number of cached orderings or their total number of
+// bytes exceeds its limit.
+//
+// The cached orderings are keyed by the pattern and the reordering strategy
+// (and, for automatic reorderings, the thread count they were selected for),
+// not by the remaining reordering options, which should therefore be
+// consistent amongst the users of a cache.
+class OrderingCache {
+ public:
+  // The key of a cached ordering.
+  struct Key {
+    // The fingerprint of the sparsity pattern.
+    SparsityPatternFingerprint fingerprint;
+
+    // The (integer value of the) reordering strategy.
+    int reordering_strategy = 0;
+
+    // The number of rows of each node which was reordered.
+    Int block_size = 1;
+
+    // The number of threads which an automatic reordering was selected for
+    // (or zero for the other strategies).
+    Int num_threads = 0;
+
+    // Returns true if the keys are identical.
+    bool operator==(const Key& other) const;
+  };
+
+  // Counts of the lookups into the cache.
+  struct Statistics {
+    // The number of lookups which found a cached ordering.
+    Int num_hits = 0;
+
+    // The number of lookups which did not.
+    Int num_misses = 0;
+
+    // The number of cached orderings which were evicted.
+    Int num_evictions = 0;
+  };
+
+  // Returns the process-wide cache used by 'SparseLDL' (see
+  // 'SparseLDLControl::cache_orderings').
+  static OrderingCache& Global();
+
+  // Fills 'ordering' with the cached ordering for the key, marking it as the
+  // most recently used, and returns true, or returns false if there is none.
+  bool Lookup(const Key& key, CachedOrdering* ordering);
+
+  // Inserts (or replaces) the ordering for the key, evicting the least
+  // recently used orderings as needed to respect the limits.
+  void Insert(const Key& key, const CachedOrdering& ordering);
+
+  // Removes every cached ordering.
+  void Clear();
+
+  // Sets the maximum number of cached orderings and of their total bytes
+  // (where a value of zero is unlimited), evicting orderings as needed.
+  void SetLimits(Int max_num_orderings, std::size_t max_num_bytes);
+
+  // Returns the number of cached orderings.
+  Int NumOrderings() const;
+
+  // Returns the total number of bytes of the cached orderings.
+  std::size_t NumBytes() const;
+
+  // Returns the lookup statistics since construction.
+  Statistics LookupStatistics() const;
+
+ private:
+  // A hash of a key, which is already a hash.
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return key.fingerprint.hashes[0] ^ std::size_t(key.reordering_strategy);
+    }
+  };
+
+  // A cached ordering and its size in bytes.
+  struct Entry {
+    Key key;
+    CachedOrdering ordering;
+    std::size_t num_bytes;
+  };
+
+  // The list of entries, from most to least recently used.
+  typedef std::list<Entry> EntryList;
+
+  // Guards every member.
+  mutable std::mutex mutex_;
+
+  // The cached entries, in order of use.
+  EntryList entries_;
+
+  // The location of the entry of each key within 'entries_'.
+  std::unordered_map<Key, EntryList::iterator, KeyHash> locations_;
+
+  // The maximum number of cached orderings (or zero, for no limit).
+  Int max_num_orderings_ = 32;
+
+  // The maximum total number of bytes of the cached orderings (or zero, for
+  // no limit).
+  std::size_t max_num_bytes_ = std::size_t(256) << 20;
+
+  // The total number of bytes of the cached orderings.
+  std::size_t num_bytes_ = 0;
+
+  // The lookup statistics.
+  Statistics statistics_;
+
+  // Evicts the least recently used orderings until the limits are respected.
+  // The mutex must be held.
+  void EnforceLimits();
+};
+
+}  // namespace catamari
+
+#include "catamari/ordering_cache-impl.hpp"
+
+#endif  // ifndef CATAMARI_ORDERING_CACHE_H_
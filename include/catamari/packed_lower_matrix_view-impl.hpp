@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PACKED_LOWER_MATRIX_VIEW_IMPL_H_
+#define CATAMARI_PACKED_LOWER_MATRIX_VIEW_IMPL_H_
+
+#include <algorithm>
+
+#include "catamari/packed_lower_matrix_view.hpp"
+
+namespace catamari {
+
+namespace packed_lower {
+
+// Returns the width of the (non-final) panels of a matrix of the given size.
+inline Int EffectivePanelWidth(Int size, Int panel_width) CATAMARI_NOEXCEPT {
+  return (panel_width <= 0 || panel_width >= size) ? size : panel_width;
+}
+
+// Returns the number of entries preceding the given panel, each of whose
+// predecessors 'q' holds 'panel_width (size - q panel_width)' entries.
+inline Int PanelOffset(Int size, Int panel_width, Int panel) CATAMARI_NOEXCEPT {
+  return panel_width *
+         (panel * size - panel_width * ((panel * (panel - 1)) / 2));
+}
+
+}  // namespace packed_lower
+
+template <class Field>
+Int PackedLowerMatrixView<Field>::NumEntries(Int size,
+                                             Int panel_width) CATAMARI_NOEXCEPT {
+  if (size <= 0) return 0;
+  const Int width = packed_lower::EffectivePanelWidth(size, panel_width);
+  const Int last_panel = (size - 1) / width;
+  const Int last_beg = last_panel * width;
+  return packed_lower::PanelOffset(size, width, last_panel) +
+         (size - last_beg) * (size - last_beg);
+}
+
+template <class Field>
+Int PackedLowerMatrixView<Field>::NumEntries() const CATAMARI_NOEXCEPT {
+  return NumEntries(size, panel_width);
+}
+
+template <class Field>
+Int PackedLowerMatrixView<Field>::NumPanels() const CATAMARI_NOEXCEPT {
+  if (size <= 0) return 0;
+  const Int width = packed_lower::EffectivePanelWidth(size, panel_width);
+  return (size + width - 1) / width;
+}
+
+template <class Field>
+Int PackedLowerMatrixView<Field>::PanelBeg(Int panel) const CATAMARI_NOEXCEPT {
+  return panel * packed_lower::EffectivePanelWidth(size, panel_width);
+}
+
+template <class Field>
+BlasMatrixView<Field> PackedLowerMatrixView<Field>::Panel(Int panel) const {
+  const Int width = packed_lower::EffectivePanelWidth(size, panel_width);
+  const Int panel_beg = panel * width;
+  BlasMatrixView<Field> view;
+  view.height = size - panel_beg;
+  view.width = std::min(width, size - panel_beg);
+  view.leading_dim = view.height;
+  view.data = data + packed_lower::PanelOffset(size, width, panel);
+  return view;
+}
+
+template <class Field>
+Field* PackedLowerMatrixView<Field>::ColumnPointer(Int column) const {
+  const Int width = packed_lower::EffectivePanelWidth(size, panel_width);
+  const Int panel = column / width;
+  const Int panel_beg = panel * width;
+  // The offset is nonnegative since each preceding panel holds at least
+  // 'width' entries per column, so the pointer stays within the storage.
+  return data + packed_lower::PanelOffset(size, width, panel) +
+         (column - panel_beg) * (size - panel_beg) - panel_beg;
+}
+
+template <class Field>
+Field& PackedLowerMatrixView<Field>::operator()(Int row, Int column) const {
+  return ColumnPointer(column)[row];
+}
+
+template <class Field>
+void PackedLowerMatrixView<Field>::SetZero() const {
+  std::fill(data, data + NumEntries(), Field{0});
+}
+
+template <class Field>
+PackedLowerMatrixView<Field> PackedLowerMatrixView<Field>::FromSquare(
+    const BlasMatrixView<Field>& matrix) {
+  CATAMARI_ASSERT(matrix.height == matrix.width &&
+                      matrix.leading_dim == matrix.height,
+                  "Only a contiguous square can be viewed as packed");
+  PackedLowerMatrixView<Field> view;
+  view.size = matrix.height;
+  view.panel_width = matrix.height;
+  view.data = matrix.data;
+  return view;
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_PACKED_LOWER_MATRIX_VIEW_IMPL_H_
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PACKED_LOWER_MATRIX_VIEW_H_
+#define CATAMARI_PACKED_LOWER_MATRIX_VIEW_H_
+
+#include "catamari/blas_matrix_view.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+
+// A view of the lower triangle of a square matrix whose columns are grouped
+// into consecutive panels of 'panel_width' columns (the last of which may be
+// narrower), each stored as a column-major matrix holding only the rows from
+// the panel's first column down and immediately following its predecessor.
+// For a matrix of size 'n', this requires roughly 'n (n + panel_width) / 2'
+// entries rather than the 'n^2' of a full square, and each panel can still be
+// updated with BLAS. A panel width which is nonpositive, or at least 'n',
+// yields a single panel: the full column-major square with leading dimension
+// 'n'.
+template <class Field>
+struct PackedLowerMatrixView {
+  // The number of rows (and columns) of the matrix.
+  Int size = 0;
+
+  // The number of columns of each panel (but perhaps the last).
+  Int panel_width = 0;
+
+  // The pointer to the first entry of the first panel.
+  Field* data = nullptr;
+
+  // Returns the number of entries of the packed storage of a matrix of the
+  // given size.
+  static Int NumEntries(Int size, Int panel_width) CATAMARI_NOEXCEPT;
+
+  // Returns the number of entries of the packed storage of the matrix.
+  Int NumEntries() const CATAMARI_NOEXCEPT;
+
+  // Returns the number of panels of the matrix.
+  Int NumPanels() const CATAMARI_NOEXCEPT;
+
+  // Returns the index of the first column of the given panel.
+  Int PanelBeg(Int panel) const CATAMARI_NOEXCEPT;
+
+  // Returns a view of the given panel, whose top-left entry is the diagonal
+  // entry of its first column. Only the lower triangle of its top square is
+  // meaningful.
+  BlasMatrixView<Field> Panel(Int panel) const;
+
+  // Returns a pointer through which entry (row, column) of the matrix, for
+  // any row at or below 'column', is at offset 'row'. Each column is thus
+  // addressed as that of a full square would be.
+  Field* ColumnPointer(Int column) const;
+
+  // Returns a reference to the entry in position (row, column), which must
+  // lie in the lower triangle.
+  Field& operator()(Int row, Int column) const;
+
+  // Zeros the packed storage.
+  void SetZero() const;
+
+  // Returns the view of a full square matrix whose leading dimension is its
+  // height.
+  static PackedLowerMatrixView<Field> FromSquare(
+      const BlasMatrixView<Field>& matrix);
+};
+
+}  // namespace catamari
+
+#include "catamari/packed_lower_matrix_view-impl.hpp"
+
+#endif  // ifndef CATAMARI_PACKED_LOWER_MATRIX_VIEW_H_
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PARALLEL_MINIMUM_DEGREE_IMPL_H_
+#define CATAMARI_PARALLEL_MINIMUM_DEGREE_IMPL_H_
+
+#include <algorithm>
+
+#include <tbb/task_arena.h>
+
+#include "catamari/parallel_minimum_degree.hpp"
+
+namespace catamari {
+
+template <class Field>
+void ParallelMinimumDegree(const CoordinateMatrix<Field>& matrix,
+                           const ParallelMinimumDegreeControl& control,
+                           SymmetricOrdering* ordering) {
+  const Int num_threads = control.num_threads > 0
+                              ? control.num_threads
+                              : Int(tbb::this_task_arena::max_concurrency());
+  const Int num_subgraphs =
+      std::max(Int(1), num_threads * control.subgraphs_per_thread);
+
+  // Subgraphs of the target size are left to minimum degree, and every
+  // dissection above them spawns concurrent tasks.
+  NestedDissectionControl nd_control;
+  nd_control.md_control = control.md_control;
+  nd_control.leaf_size = std::max(control.min_subgraph_size,
+                                  matrix.NumRows() / num_subgraphs + 1);
+  nd_control.parallel_size = nd_control.leaf_size;
+  nd_control.max_peripheral_searches = control.max_peripheral_searches;
+  nd_control.leaf_assembly_forests = true;
+  NestedDissection(matrix, nd_control, ordering);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_PARALLEL_MINIMUM_DEGREE_IMPL_H_
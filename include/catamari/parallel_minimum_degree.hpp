@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PARALLEL_MINIMUM_DEGREE_H_
+#define CATAMARI_PARALLEL_MINIMUM_DEGREE_H_
+
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/integers.hpp"
+#include "catamari/nested_dissection.hpp"
+#include "catamari/symmetric_ordering.hpp"
+#include "quotient/minimum_degree.hpp"
+
+namespace catamari {
+
+// Configuration options for the parallel minimum degree reordering.
+struct ParallelMinimumDegreeControl {
+  // The configuration options for the minimum degree reordering of each
+  // subgraph.
+  quotient::MinimumDegreeControl md_control;
+
+  // The number of threads to create subgraphs for, or zero for the
+  // concurrency of the current task arena.
+  Int num_threads = 0;
+
+  // The number of subgraphs to aim for per thread, so that the concurrent
+  // reorderings of subgraphs of uneven cost can be balanced.
+  Int subgraphs_per_thread = 4;
+
+  // Graphs are not dissected into subgraphs with fewer than this many
+  // vertices, so that small graphs are reordered serially.
+  Int min_subgraph_size = 16384;
+
+  // The maximum number of breadth-first searches used to find a
+  // pseudo-peripheral root for the level structure of each bisection.
+  Int max_peripheral_searches = 5;
+};
+
+// Fills 'ordering' with a minimum degree reordering of the graph of the given
+// (structurally symmetric) matrix which is computed in parallel: the graph is
+// dissected, with concurrent TBB tasks, only until there are roughly
+// 'subgraphs_per_thread' subgraphs per thread, and the subgraphs are then
+// reordered by minimum degree concurrently, with their separators ordered
+// last. The supernodal assembly forests of the minimum degree reorderings are
+// kept, and joined through the separators, so that the ordering is suitable
+// for 'SparseLDL::Factor(matrix, ordering, control)'.
+template <class Field>
+void ParallelMinimumDegree(const CoordinateMatrix<Field>& matrix,
+                           const ParallelMinimumDegreeControl& control,
+                           SymmetricOrdering* ordering);
+
+}  // namespace catamari
+
+#include "catamari/parallel_minimum_degree-impl.hpp"
+
+#endif  // ifndef CATAMARI_PARALLEL_MINIMUM_DEGREE_H_
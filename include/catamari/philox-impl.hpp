@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PHILOX_IMPL_H_
+#define CATAMARI_PHILOX_IMPL_H_
+
+#include "catamari/philox.hpp"
+
+namespace catamari {
+
+inline PhiloxEngine::PhiloxEngine(std::uint64_t key, std::uint32_t stream,
+                                  std::uint32_t substream) {
+  Seed(key, stream, substream);
+}
+
+inline void PhiloxEngine::Seed(std::uint64_t key, std::uint32_t stream,
+                               std::uint32_t substream) {
+  key_[0] = static_cast<std::uint32_t>(key);
+  key_[1] = static_cast<std::uint32_t>(key >> 32);
+  counter_[2] = stream;
+  counter_[3] = substream;
+  SetPosition(0);
+}
+
+inline PhiloxEngine::result_type PhiloxEngine::operator()() {
+  if (block_index_ == kBlockSize) {
+    SetPosition(Position() + 1);
+  }
+  return block_[block_index_++];
+}
+
+inline void PhiloxEngine::discard(unsigned long long num_values) {
+  const unsigned long long offset = block_index_ + num_values;
+  const unsigned long long num_blocks = offset / kBlockSize;
+  if (num_blocks) {
+    SetPosition(Position() + num_blocks);
+  }
+  block_index_ = offset % kBlockSize;
+}
+
+inline std::array<std::uint32_t, PhiloxEngine::kBlockSize> PhiloxEngine::Block(
+    const std::array<std::uint32_t, kBlockSize>& counter,
+    const std::array<std::uint32_t, 2>& key) {
+  const std::uint64_t kMultiplier0 = 0xD2511F53;
+  const std::uint64_t kMultiplier1 = 0xCD9E8D57;
+  const std::uint32_t kWeyl0 = 0x9E3779B9;
+  const std::uint32_t kWeyl1 = 0xBB67AE85;
+  const int kNumRounds = 10;
+
+  std::array<std::uint32_t, kBlockSize> block = counter;
+  std::array<std::uint32_t, 2> round_key = key;
+  for (int round = 0; round < kNumRounds; ++round) {
+    if (round > 0) {
+      round_key[0] += kWeyl0;
+      round_key[1] += kWeyl1;
+    }
+    const std::uint64_t product0 = kMultiplier0 * block[0];
+    const std::uint64_t product1 = kMultiplier1 * block[2];
+    const std::uint32_t high0 = static_cast<std::uint32_t>(product0 >> 32);
+    const std::uint32_t low0 = static_cast<std::uint32_t>(product0);
+    const std::uint32_t high1 = static_cast<std::uint32_t>(product1 >> 32);
+    const std::uint32_t low1 = static_cast<std::uint32_t>(product1);
+    block = {{high1 ^ block[1] ^ round_key[0], low1,
+              high0 ^ block[3] ^ round_key[1], low0}};
+  }
+  return block;
+}
+
+inline void PhiloxEngine::SetPosition(std::uint64_t position) {
+  counter_[0] = static_cast<std::uint32_t>(position);
+  counter_[1] = static_cast<std::uint32_t>(position >> 32);
+  block_ = Block(counter_, key_);
+  block_index_ = 0;
+}
+
+inline std::uint64_t PhiloxEngine::Position() const {
+  return (static_cast<std::uint64_t>(counter_[1]) << 32) | counter_[0];
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_PHILOX_IMPL_H_
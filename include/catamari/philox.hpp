@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_PHILOX_H_
+#define CATAMARI_PHILOX_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace catamari {
+
+// A counter-based Philox4x32-10 random number engine [1] which satisfies the
+// requirements of a uniform random bit generator. Each (key, stream,
+// substream) triple selects an independent sequence of 2^66 values, each of
+// which is a pure function of its position, so that parallel consumers can
+// be assigned reproducible streams without sharing any state.
+//
+// [1] Salmon, Moraes, Dror, and Shaw, "Parallel Random Numbers: As Easy as
+//     1, 2, 3", Proceedings of SC11, 2011.
+//
+class PhiloxEngine {
+ public:
+  typedef std::uint32_t result_type;
+
+  // The number of values produced by each evaluation of the bijection.
+  static constexpr int kBlockSize = 4;
+
+  // Returns the smallest value the engine produces.
+  static constexpr result_type min() { return 0; }
+
+  // Returns the largest value the engine produces.
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  // Constructs an engine at the beginning of the given stream.
+  explicit PhiloxEngine(std::uint64_t key = 0, std::uint32_t stream = 0,
+                        std::uint32_t substream = 0);
+
+  // Restarts the engine at the beginning of the given stream.
+  void Seed(std::uint64_t key, std::uint32_t stream, std::uint32_t substream);
+
+  // Returns the next value of the stream.
+  result_type operator()();
+
+  // Advances the stream by the given number of values.
+  void discard(unsigned long long num_values);
+
+  // Returns the Philox4x32-10 bijection of a counter under a key.
+  static std::array<std::uint32_t, kBlockSize> Block(
+      const std::array<std::uint32_t, kBlockSize>& counter,
+      const std::array<std::uint32_t, 2>& key);
+
+ private:
+  // The key of the bijection.
+  std::array<std::uint32_t, 2> key_;
+
+  // The counter of the current block. The leading two words are the
+  // position of the block within the stream, and the trailing two are the
+  // stream and substream.
+  std::array<std::uint32_t, kBlockSize> counter_;
+
+  // The bijection of the current counter.
+  std::array<std::uint32_t, kBlockSize> block_;
+
+  // The index of the next unused value of the current block.
+  int block_index_;
+
+  // Sets the position of the current block and evaluates it.
+  void SetPosition(std::uint64_t position);
+
+  // Returns the position of the current block.
+  std::uint64_t Position() const;
+};
+
+}  // namespace catamari
+
+#include "catamari/philox-impl.hpp"
+
+#endif  // ifndef CATAMARI_PHILOX_H_
@@ -34,11 +34,31 @@ struct PromoteHelper<Complex<Real>> {
   typedef Complex<typename PromoteHelper<Real>::type> type;
 };
 
+template <typename Real>
+struct DemoteHelper {
+  typedef Real type;
+};
+
+template <>
+struct DemoteHelper<double> {
+  typedef float type;
+};
+
+template <typename Real>
+struct DemoteHelper<Complex<Real>> {
+  typedef Complex<typename DemoteHelper<Real>::type> type;
+};
+
 }  // namespace promote
 
 template <typename Field>
 using Promote = typename promote::PromoteHelper<Field>::type;
 
+// The lower-precision type whose promotion is (usually) 'Field', e.g., for
+// factoring in single precision while refining in double precision.
+template <typename Field>
+using Demote = typename promote::DemoteHelper<Field>::type;
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_PROMOTE_H_
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_REDUCED_PRECISION_IMPL_H_
+#define CATAMARI_REDUCED_PRECISION_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "catamari/macros.hpp"
+
+#include "catamari/reduced_precision.hpp"
+
+namespace catamari {
+namespace reduced_precision {
+
+inline std::uint32_t FloatBits(float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float BitsToFloat(std::uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Overwrites the components of a real or complex entry.
+template <class Real>
+void SetComponents(const Real* components, Real* value) {
+  *value = components[0];
+}
+
+template <class Real>
+void SetComponents(const Real* components, Complex<Real>* value) {
+  *value = Complex<Real>(components[0], components[1]);
+}
+
+}  // namespace reduced_precision
+
+// The conversions follow F. Giesen's branch-light constructions, which reuse
+// the floating-point units to round subnormals.
+inline std::uint16_t FloatToHalf(float value) {
+  const std::uint32_t infinity_bits = 255u << 23;
+  const std::uint32_t overflow_bits = (127u + 16u) << 23;
+  const std::uint32_t subnormal_bits = (127u - 15u + 1u) << 23;
+  const float subnormal_magic =
+      reduced_precision::BitsToFloat(((127u - 15u) + (23u - 10u) + 1u) << 23);
+
+  std::uint32_t bits = reduced_precision::FloatBits(value);
+  const std::uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  std::uint32_t result;
+  if (bits >= overflow_bits) {
+    // Infinities and overflows become infinite, and NaNs stay quiet NaNs.
+    result = bits > infinity_bits ? 0x7e00u : 0x7c00u;
+  } else if (bits < subnormal_bits) {
+    // Let the addition round the mantissa into the subnormal position.
+    const float shifted =
+        reduced_precision::BitsToFloat(bits) + subnormal_magic;
+    result = reduced_precision::FloatBits(shifted) -
+             reduced_precision::FloatBits(subnormal_magic);
+  } else {
+    // Rebias the exponent and round the mantissa to nearest, ties to even.
+    const std::uint32_t mantissa_odd = (bits >> 13) & 1u;
+    bits += ((15u - 127u) << 23) + 0xfffu + mantissa_odd;
+    result = bits >> 13;
+  }
+  return static_cast<std::uint16_t>(result | (sign >> 16));
+}
+
+inline float HalfToFloat(std::uint16_t value) {
+  const std::uint32_t magnitude = value & 0x7fffu;
+  // Shifting into place and rescaling by 2^112 handles both the normal and
+  // the subnormal halves exactly.
+  float result =
+      reduced_precision::BitsToFloat(magnitude << 13) *
+      reduced_precision::BitsToFloat((254u - 15u) << 23);
+  std::uint32_t bits = reduced_precision::FloatBits(result);
+  if (magnitude >= 0x7c00u) bits |= 255u << 23;
+  bits |= std::uint32_t(value & 0x8000u) << 16;
+  return reduced_precision::BitsToFloat(bits);
+}
+
+inline std::uint16_t FloatToBFloat16(float value) {
+  const std::uint32_t bits = reduced_precision::FloatBits(value);
+  if ((bits & 0x7fffffffu) > 0x7f800000u) {
+    // Keep NaNs quiet rather than letting the rounding carry them to
+    // infinity.
+    return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+  }
+  const std::uint32_t rounding = 0x7fffu + ((bits >> 16) & 1u);
+  return static_cast<std::uint16_t>((bits + rounding) >> 16);
+}
+
+inline float BFloat16ToFloat(std::uint16_t value) {
+  return reduced_precision::BitsToFloat(std::uint32_t(value) << 16);
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::Assign(
+    StoragePrecision precision, const ConstBlasMatrixView<Field>& matrix) {
+  CATAMARI_ASSERT(precision != kWorkingPrecision,
+                  "Reduced-precision matrices require a reduced precision.");
+  precision_ = precision;
+  height_ = matrix.height;
+  width_ = matrix.width;
+  column_scales_.Resize(width_);
+  values_.Resize(kNumComponents * height_ * width_);
+  for (Int j = 0; j < width_; ++j) {
+    Real scale = 0;
+    for (Int i = 0; i < height_; ++i) {
+      scale = std::max(scale, std::abs(RealPart(matrix(i, j))));
+      scale = std::max(scale, std::abs(ImagPart(matrix(i, j))));
+    }
+    column_scales_[j] = scale;
+    const Real inverse_scale = scale > Real{0} ? Real{1} / scale : Real{0};
+
+    std::uint16_t* column_values =
+        values_.Data() + j * kNumComponents * height_;
+    for (Int i = 0; i < height_; ++i) {
+      const Real components[] = {RealPart(matrix(i, j)) * inverse_scale,
+                                 ImagPart(matrix(i, j)) * inverse_scale};
+      for (Int k = 0; k < kNumComponents; ++k) {
+        const float component = static_cast<float>(components[k]);
+        column_values[i * kNumComponents + k] =
+            precision == kHalfPrecision ? FloatToHalf(component)
+                                        : FloatToBFloat16(component);
+      }
+    }
+  }
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::Clear() {
+  height_ = width_ = 0;
+  column_scales_.Clear();
+  values_.Clear();
+}
+
+template <class Field>
+bool ReducedPrecisionMatrix<Field>::Empty() const {
+  return values_.Empty();
+}
+
+template <class Field>
+StoragePrecision ReducedPrecisionMatrix<Field>::Precision() const {
+  return precision_;
+}
+
+template <class Field>
+Int ReducedPrecisionMatrix<Field>::Height() const {
+  return height_;
+}
+
+template <class Field>
+Int ReducedPrecisionMatrix<Field>::Width() const {
+  return width_;
+}
+
+template <class Field>
+std::size_t ReducedPrecisionMatrix<Field>::NumBytes() const {
+  return values_.Size() * sizeof(std::uint16_t) +
+         column_scales_.Size() * sizeof(Real);
+}
+
+template <class Field>
+Field ReducedPrecisionMatrix<Field>::Entry(Int row, Int column) const {
+  const std::uint16_t* entry_values =
+      values_.Data() + (column * height_ + row) * kNumComponents;
+  Real components[kNumComponents];
+  for (Int k = 0; k < kNumComponents; ++k) {
+    const float component = precision_ == kHalfPrecision
+                                ? HalfToFloat(entry_values[k])
+                                : BFloat16ToFloat(entry_values[k]);
+    components[k] = column_scales_[column] * Real(component);
+  }
+  Field value;
+  reduced_precision::SetComponents(components, &value);
+  return value;
+}
+
+template <class Field>
+template <float (*decode)(std::uint16_t)>
+void ReducedPrecisionMatrix<Field>::DecodeColumnWith(Int column,
+                                                     Field* values) const {
+  const std::uint16_t* column_values =
+      values_.Data() + column * kNumComponents * height_;
+  const Real scale = column_scales_[column];
+  for (Int i = 0; i < height_; ++i) {
+    Real components[kNumComponents];
+    for (Int k = 0; k < kNumComponents; ++k) {
+      components[k] =
+          scale * Real(decode(column_values[i * kNumComponents + k]));
+    }
+    reduced_precision::SetComponents(components, &values[i]);
+  }
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::DecodeColumn(Int column,
+                                                 Field* values) const {
+  if (precision_ == kHalfPrecision) {
+    DecodeColumnWith<HalfToFloat>(column, values);
+  } else {
+    DecodeColumnWith<BFloat16ToFloat>(column, values);
+  }
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::MultiplyNormal(
+    const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output, Buffer<Field>* workspace) const {
+  CATAMARI_ASSERT(input.height == width_ && output->height == height_ &&
+                      input.width == output->width,
+                  "Incompatible reduced-precision multiply dimensions.");
+  if (workspace->Size() < std::size_t(height_)) workspace->Resize(height_);
+  Field* column = workspace->Data();
+  for (Int j = 0; j < width_; ++j) {
+    DecodeColumn(j, column);
+    for (Int k = 0; k < input.width; ++k) {
+      const Field coefficient = alpha * input(j, k);
+      Field* output_column = output->Pointer(0, k);
+      for (Int i = 0; i < height_; ++i) {
+        output_column[i] += column[i] * coefficient;
+      }
+    }
+  }
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::MultiplyAdjointOrTranspose(
+    bool conjugate, const Field& alpha,
+    const ConstBlasMatrixView<Field>& input, BlasMatrixView<Field>* output,
+    Buffer<Field>* workspace) const {
+  CATAMARI_ASSERT(input.height == height_ && output->height == width_ &&
+                      input.width == output->width,
+                  "Incompatible reduced-precision multiply dimensions.");
+  if (workspace->Size() < std::size_t(height_)) workspace->Resize(height_);
+  Field* column = workspace->Data();
+  for (Int j = 0; j < width_; ++j) {
+    DecodeColumn(j, column);
+    if (conjugate) {
+      for (Int i = 0; i < height_; ++i) column[i] = Conjugate(column[i]);
+    }
+    for (Int k = 0; k < input.width; ++k) {
+      const Field* input_column = input.Pointer(0, k);
+      Field dot = 0;
+      for (Int i = 0; i < height_; ++i) {
+        dot += column[i] * input_column[i];
+      }
+      output->Entry(j, k) += alpha * dot;
+    }
+  }
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::MultiplyAdjoint(
+    const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output, Buffer<Field>* workspace) const {
+  MultiplyAdjointOrTranspose(true, alpha, input, output, workspace);
+}
+
+template <class Field>
+void ReducedPrecisionMatrix<Field>::MultiplyTranspose(
+    const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output, Buffer<Field>* workspace) const {
+  MultiplyAdjointOrTranspose(false, alpha, input, output, workspace);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_REDUCED_PRECISION_IMPL_H_
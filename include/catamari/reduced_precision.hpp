@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_REDUCED_PRECISION_H_
+#define CATAMARI_REDUCED_PRECISION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/complex.hpp"
+
+namespace catamari {
+
+// The formats in which a matrix may be stored. The reduced formats are for
+// storage only: their entries are upcast to the working precision as they
+// are applied, so that only the memory footprint and bandwidth are reduced.
+enum StoragePrecision {
+  // The precision of the matrix's field.
+  kWorkingPrecision,
+
+  // IEEE 754 binary16, with 11 significant bits and a maximum of 65504.
+  kHalfPrecision,
+
+  // The upper half of an IEEE 754 binary32, with 8 significant bits and the
+  // exponent range of 'float'.
+  kBFloat16Precision,
+};
+
+// Rounds a float to the nearest IEEE half, with ties to even. Values beyond
+// the range of half precision become infinite.
+std::uint16_t FloatToHalf(float value);
+
+// Returns the float which exactly represents an IEEE half.
+float HalfToFloat(std::uint16_t value);
+
+// Rounds a float to the nearest bfloat16, with ties to even.
+std::uint16_t FloatToBFloat16(float value);
+
+// Returns the float which exactly represents a bfloat16.
+float BFloat16ToFloat(std::uint16_t value);
+
+// A column-major matrix stored in half or bfloat16 precision. Each column is
+// scaled by the largest magnitude of the real and imaginary parts of its
+// entries, so that half precision neither overflows nor loses the relative
+// accuracy of columns with small entries.
+template <class Field>
+class ReducedPrecisionMatrix {
+ public:
+  typedef ComplexBase<Field> Real;
+
+  // Stores a rounded copy of 'matrix' in the given reduced precision.
+  void Assign(StoragePrecision precision,
+              const ConstBlasMatrixView<Field>& matrix);
+
+  // Discards the stored entries.
+  void Clear();
+
+  // Returns true if no matrix is stored.
+  bool Empty() const;
+
+  // Returns the precision of the stored entries.
+  StoragePrecision Precision() const;
+
+  // Returns the dimensions of the stored matrix.
+  Int Height() const;
+  Int Width() const;
+
+  // Returns the number of bytes used to store the matrix.
+  std::size_t NumBytes() const;
+
+  // Returns the working-precision value of the given entry.
+  Field Entry(Int row, Int column) const;
+
+  // Overwrites 'values' with the working-precision values of the given
+  // column.
+  void DecodeColumn(Int column, Field* values) const;
+
+  // Performs 'output += alpha A input', where each column of A is decoded
+  // once into 'workspace'.
+  void MultiplyNormal(const Field& alpha,
+                      const ConstBlasMatrixView<Field>& input,
+                      BlasMatrixView<Field>* output,
+                      Buffer<Field>* workspace) const;
+
+  // Performs 'output += alpha A' input', where each column of A is decoded
+  // once into 'workspace'.
+  void MultiplyAdjoint(const Field& alpha,
+                       const ConstBlasMatrixView<Field>& input,
+                       BlasMatrixView<Field>* output,
+                       Buffer<Field>* workspace) const;
+
+  // Performs 'output += alpha A^T input', where each column of A is decoded
+  // once into 'workspace'.
+  void MultiplyTranspose(const Field& alpha,
+                         const ConstBlasMatrixView<Field>& input,
+                         BlasMatrixView<Field>* output,
+                         Buffer<Field>* workspace) const;
+
+ private:
+  // The number of stored values per entry: one for real fields, and a real
+  // and an imaginary part for complex fields.
+  static constexpr Int kNumComponents = IsComplex<Field>::value ? 2 : 1;
+
+  // The precision of the stored values.
+  StoragePrecision precision_ = kHalfPrecision;
+
+  // The dimensions of the matrix.
+  Int height_ = 0;
+  Int width_ = 0;
+
+  // The scale of each column.
+  Buffer<Real> column_scales_;
+
+  // The scaled values of each column, with the real and imaginary parts of
+  // complex entries interleaved.
+  Buffer<std::uint16_t> values_;
+
+  // Overwrites 'values' with the decoded scaled values of the given column
+  // using the given conversion.
+  template <float (*decode)(std::uint16_t)>
+  void DecodeColumnWith(Int column, Field* values) const;
+
+  // Accumulates the adjoint (or, if 'conjugate' is false, the transpose) of
+  // the matrix against 'input'.
+  void MultiplyAdjointOrTranspose(bool conjugate, const Field& alpha,
+                                  const ConstBlasMatrixView<Field>& input,
+                                  BlasMatrixView<Field>* output,
+                                  Buffer<Field>* workspace) const;
+};
+
+}  // namespace catamari
+
+#include "catamari/reduced_precision-impl.hpp"
+
+#endif  // ifndef CATAMARI_REDUCED_PRECISION_H_
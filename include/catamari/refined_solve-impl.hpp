@@ -7,6 +7,11 @@
 #ifndef CATAMARI_REFINED_SOLVE_IMPL_H_
 #define CATAMARI_REFINED_SOLVE_IMPL_H_
 
+#include <algorithm>
+#include <iostream>
+
+#include "catamari/norms.hpp"
+
 #include "catamari/refined_solve.hpp"
 
 namespace catamari {
@@ -73,14 +78,27 @@ RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
     const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
     const RefinedSolveControl<ComplexBase<Field>>& control,
     BlasMatrixView<Field>* right_hand_sides) {
+  RefinedSolveWorkspace<Field> workspace;
+  return RefinedSolve(apply_matrix, apply_inverse, control, right_hand_sides,
+                      &workspace);
+}
+
+template <class Field, class ApplyMatrix, class ApplyInverse>
+RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
+    const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
+    const RefinedSolveControl<ComplexBase<Field>>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    RefinedSolveWorkspace<Field>* workspace) {
   typedef ComplexBase<Field> Real;
   const Int num_rows = right_hand_sides->height;
   const Int num_rhs = right_hand_sides->width;
   RefinedSolveStatus<Real> state;
 
   // Compute the original maximum norms.
-  const BlasMatrix<Field> rhs_orig = *right_hand_sides;
-  Buffer<Real> rhs_orig_norms(num_rhs);
+  BlasMatrix<Field>& rhs_orig = workspace->original_right_hand_sides;
+  rhs_orig = *right_hand_sides;
+  Buffer<Real>& rhs_orig_norms = workspace->original_norms;
+  rhs_orig_norms.Resize(num_rhs);
   for (Int j = 0; j < num_rhs; ++j) {
     const ConstBlasMatrixView<Field> column =
         rhs_orig.view.Submatrix(0, j, num_rows, 1);
@@ -89,11 +107,12 @@ RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
 
   // Compute the initial guesses.
   // TODO(Jack Poulson): Avoid solving against all zero right-hand sides.
-  BlasMatrix<Field> solution = rhs_orig;
+  BlasMatrix<Field>& solution = workspace->solution;
+  solution = rhs_orig;
   apply_inverse(&solution.view);
 
   // image := matrix * solution
-  BlasMatrix<Field> image;
+  BlasMatrix<Field>& image = workspace->image;
   image.Resize(num_rows, num_rhs, Field{0});
   apply_matrix(Field{1}, solution.ConstView(), Field{1}, &image.view);
 
@@ -102,8 +121,10 @@ RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
   // We will begin with each nonzero right-hand side being 'active' and deflate
   // out each that has converged (or diverged) during iterative refinement.
   Int num_nonzero = 0;
-  Buffer<Real> error_norms(num_rhs);
-  Buffer<Int> active_indices(num_rhs);
+  Buffer<Real>& error_norms = workspace->error_norms;
+  error_norms.Resize(num_rhs);
+  Buffer<Int>& active_indices = workspace->active_indices;
+  active_indices.Resize(num_rhs);
   for (Int j = 0; j < num_rhs; ++j) {
     BlasMatrixView<Field> column =
         right_hand_sides->Submatrix(0, j, num_rows, 1);
@@ -129,7 +150,8 @@ RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
   active_indices.Resize(num_nonzero);
 
   state.num_iterations = 0;
-  BlasMatrix<Field> update, candidate_solution;
+  BlasMatrix<Field>& update = workspace->update;
+  BlasMatrix<Field>& candidate_solution = workspace->candidate_solution;
   while (true) {
     // Deflate any converged active right-hand sides.
     {
@@ -239,14 +261,27 @@ RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
     const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
     const RefinedSolveControl<ComplexBase<Field>>& control,
     BlasMatrixView<Field>* right_hand_sides_lower) {
+  RefinedSolveWorkspace<Field> workspace;
+  return PromotedRefinedSolve(apply_matrix, apply_inverse, control,
+                              right_hand_sides_lower, &workspace);
+}
+
+template <class Field, class ApplyMatrix, class ApplyInverse>
+RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
+    const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
+    const RefinedSolveControl<ComplexBase<Field>>& control,
+    BlasMatrixView<Field>* right_hand_sides_lower,
+    RefinedSolveWorkspace<Field>* workspace) {
   typedef ComplexBase<Field> Real;
   const Int num_rows = right_hand_sides_lower->height;
   const Int num_rhs = right_hand_sides_lower->width;
   RefinedSolveStatus<Real> state;
 
   // Compute the original maximum norms.
-  const BlasMatrix<Field> rhs_orig_lower = *right_hand_sides_lower;
-  Buffer<Real> rhs_orig_norms(num_rhs);
+  BlasMatrix<Field>& rhs_orig_lower = workspace->original_right_hand_sides;
+  rhs_orig_lower = *right_hand_sides_lower;
+  Buffer<Real>& rhs_orig_norms = workspace->original_norms;
+  rhs_orig_norms.Resize(num_rhs);
   for (Int j = 0; j < num_rhs; ++j) {
     const ConstBlasMatrixView<Field> column =
         rhs_orig_lower.view.Submatrix(0, j, num_rows, 1);
@@ -255,19 +290,21 @@ RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
 
   // Compute the initial guesses.
   // TODO(Jack Poulson): Avoid solving against all zero right-hand sides.
-  BlasMatrix<Field> solution_lower = rhs_orig_lower;
+  BlasMatrix<Field>& solution_lower = workspace->solution;
+  solution_lower = rhs_orig_lower;
   apply_inverse(&solution_lower.view);
-  BlasMatrix<Promote<Field>> solution_higher;
+  BlasMatrix<Promote<Field>>& solution_higher = workspace->solution_higher;
   promote::LowerToHigher(solution_lower, &solution_higher);
 
   // image := matrix * solution
-  BlasMatrix<Promote<Field>> image_higher;
+  BlasMatrix<Promote<Field>>& image_higher = workspace->image_higher;
   image_higher.Resize(num_rows, num_rhs, Field{0});
   apply_matrix(Promote<Field>{1}, solution_higher.ConstView(),
                Promote<Field>{1}, &image_higher.view);
 
   // Convert the right-hand sides into higher precision.
-  BlasMatrix<Promote<Field>> right_hand_sides_higher;
+  BlasMatrix<Promote<Field>>& right_hand_sides_higher =
+      workspace->right_hand_sides_higher;
   promote::LowerToHigher(right_hand_sides_lower->ToConst(),
                          &right_hand_sides_higher);
 
@@ -276,8 +313,10 @@ RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
   // We will begin with each nonzero right-hand side being 'active' and deflate
   // out each that has converged (or diverged) during iterative refinement.
   Int num_nonzero = 0;
-  Buffer<Real> error_norms(num_rhs);
-  Buffer<Int> active_indices(num_rhs);
+  Buffer<Real>& error_norms = workspace->error_norms;
+  error_norms.Resize(num_rhs);
+  Buffer<Int>& active_indices = workspace->active_indices;
+  active_indices.Resize(num_rhs);
   for (Int j = 0; j < num_rhs; ++j) {
     BlasMatrixView<Promote<Field>> column =
         right_hand_sides_higher.Submatrix(0, j, num_rows, 1);
@@ -303,8 +342,10 @@ RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
   active_indices.Resize(num_nonzero);
 
   state.num_iterations = 0;
-  BlasMatrix<Field> update_lower;
-  BlasMatrix<Promote<Field>> update_higher, candidate_solution_higher;
+  BlasMatrix<Field>& update_lower = workspace->update;
+  BlasMatrix<Promote<Field>>& update_higher = workspace->update_higher;
+  BlasMatrix<Promote<Field>>& candidate_solution_higher =
+      workspace->candidate_solution_higher;
   while (true) {
     // Deflate any converged active right-hand sides.
     {
@@ -7,10 +7,65 @@
 #ifndef CATAMARI_REFINED_SOLVE_H_
 #define CATAMARI_REFINED_SOLVE_H_
 
+#include <limits>
+
 #include "catamari/blas_matrix.hpp"
+#include "catamari/promote.hpp"
 
 namespace catamari {
 
+// Configuration options for solving linear systems with iterative refinement.
+template <typename Real>
+struct RefinedSolveControl {
+  // The desired relative error (in the max norm) of the solution. Iteration
+  // stops early if this tolerance is achieved.
+  Real relative_tol = 10 * std::numeric_limits<Real>::epsilon();
+
+  // The maximum number of iterations of iterative refinement to perform.
+  Int max_iters = 3;
+
+  // Whether (typically) higher-precision arithmetic should be used for the
+  // iterative refinement.
+  bool promote = false;
+
+  // If true, 'SparseLDL::RefinedSolve' and
+  // 'SparseLDL::DynamicallyRegularizedRefinedSolve' skip iterative refinement
+  // -- and with it every residual evaluation -- whenever the a priori
+  // backward error estimate of the factorization (see
+  // 'SparseLDL::BackwardErrorEstimate') is at most 'relative_tol'. The
+  // solution is then the result of a single solve. Note that the estimate
+  // bounds the normwise backward error, || b - A x || / (|| A || || x ||),
+  // rather than the relative residual norm, so this should only be enabled
+  // when a backward stable solution suffices.
+  bool skip_if_estimated_accurate = false;
+
+  // Whether convergence progress information should be printed.
+  bool verbose = false;
+};
+
+// The return value of iterative refinement.
+template <typename Real>
+struct RefinedSolveStatus {
+  // The number of performed refinement iterations.
+  Int num_iterations;
+
+  // The maximum of the relative max norms of the residual matrix, i.e.,
+  //
+  //   max_j || b_j - A x_j ||_{max} / || b_j ||_{max},
+  //
+  // where we replace any division by zero with division by one. That is, we
+  // use absolute residual norms for any zero right-hand sides.
+  Real residual_relative_max_norm;
+
+  // The a priori estimate of the relative backward error of a single solve
+  // with the factorization, or infinity if none was available. If refinement
+  // was skipped because of this estimate (see
+  // 'RefinedSolveControl::skip_if_estimated_accurate'), then no residual was
+  // computed, 'num_iterations' is zero, and 'residual_relative_max_norm' is
+  // set to the estimate.
+  Real backward_error_estimate = std::numeric_limits<Real>::infinity();
+};
+
 namespace promote {
 
 template <typename Field>
@@ -35,18 +90,67 @@ void LowerToHigher(const BlasMatrix<Field>& lower,
 
 }  // namespace promote
 
+// The buffers of (possibly promoted) iterative refinement. A workspace can be
+// passed to successive refined solves so that, once the first call has sized
+// them, solves with the same dimensions do not allocate.
+template <typename Field>
+struct RefinedSolveWorkspace {
+  // The original right-hand sides and their max norms.
+  BlasMatrix<Field> original_right_hand_sides;
+  Buffer<ComplexBase<Field>> original_norms;
+
+  // The max norms of the current residuals.
+  Buffer<ComplexBase<Field>> error_norms;
+
+  // The indices of the right-hand sides that are still being refined.
+  Buffer<Int> active_indices;
+
+  // The working-precision iterates.
+  BlasMatrix<Field> solution;
+  BlasMatrix<Field> image;
+  BlasMatrix<Field> update;
+  BlasMatrix<Field> candidate_solution;
+
+  // The higher-precision iterates of 'PromotedRefinedSolve'.
+  BlasMatrix<Promote<Field>> right_hand_sides_higher;
+  BlasMatrix<Promote<Field>> solution_higher;
+  BlasMatrix<Promote<Field>> image_higher;
+  BlasMatrix<Promote<Field>> update_higher;
+  BlasMatrix<Promote<Field>> candidate_solution_higher;
+
+  // The rescaled inputs of diagonally-scaled matrix applications.
+  BlasMatrix<Field> scaled_input;
+  BlasMatrix<Promote<Field>> scaled_input_higher;
+};
+
 template <class Field, class ApplyMatrix, class ApplyInverse>
 RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
     const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
     const RefinedSolveControl<ComplexBase<Field>>& control,
     BlasMatrixView<Field>* right_hand_sides);
 
+// Equivalent to the above, but reuses the buffers held by 'workspace'.
+template <class Field, class ApplyMatrix, class ApplyInverse>
+RefinedSolveStatus<ComplexBase<Field>> RefinedSolve(
+    const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
+    const RefinedSolveControl<ComplexBase<Field>>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    RefinedSolveWorkspace<Field>* workspace);
+
 template <class Field, class ApplyMatrix, class ApplyInverse>
 RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
     const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
     const RefinedSolveControl<ComplexBase<Field>>& control,
     BlasMatrixView<Field>* right_hand_sides_lower);
 
+// Equivalent to the above, but reuses the buffers held by 'workspace'.
+template <class Field, class ApplyMatrix, class ApplyInverse>
+RefinedSolveStatus<ComplexBase<Field>> PromotedRefinedSolve(
+    const ApplyMatrix apply_matrix, const ApplyInverse apply_inverse,
+    const RefinedSolveControl<ComplexBase<Field>>& control,
+    BlasMatrixView<Field>* right_hand_sides_lower,
+    RefinedSolveWorkspace<Field>* workspace);
+
 }  // namespace catamari
 
 #include "catamari/refined_solve-impl.hpp"
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SHIFT_INVERT_LANCZOS_IMPL_H_
+#define CATAMARI_SHIFT_INVERT_LANCZOS_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Eigenvalues>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_factorizations.hpp"
+#include "catamari/eigen_scalar.hpp"
+
+#include "catamari/shift_invert_lanczos.hpp"
+
+namespace catamari {
+
+namespace shift_invert_lanczos {
+
+// B-orthonormalizes the columns of 'block', and updates its image under B,
+// 'mass_block', accordingly, through the lower Cholesky factor L of the Gram
+// matrix block^H B block, which is left in 'gram' (so that the original block
+// is the orthonormalized one times L^H). Returns false if the block is
+// (numerically) rank-deficient relative to 'scale'.
+template <class Field>
+bool MassOrthonormalize(const ComplexBase<Field>& scale,
+                        BlasMatrixView<Field>* block,
+                        BlasMatrixView<Field>* mass_block,
+                        BlasMatrix<Field>* gram) {
+  typedef ComplexBase<Field> Real;
+  const Int width = block->width;
+  gram->Resize(width, width);
+  MatrixMultiplyAdjointNormal(Field(1), block->ToConst(), mass_block->ToConst(),
+                              Field(0), &gram->view);
+  if (LowerCholeskyFactorization(width, &gram->view) < width) {
+    return false;
+  }
+  const Real min_pivot =
+      std::sqrt(std::numeric_limits<Real>::epsilon()) * scale;
+  for (Int j = 0; j < width; ++j) {
+    if (RealPart(gram->Entry(j, j)) <= min_pivot) {
+      return false;
+    }
+  }
+  RightLowerAdjointTriangularSolves(gram->ConstView(), block);
+  RightLowerAdjointTriangularSolves(gram->ConstView(), mass_block);
+  return true;
+}
+
+}  // namespace shift_invert_lanczos
+
+template <class Field, class ApplyMass>
+ShiftInvertLanczosStatus<ComplexBase<Field>> ShiftInvertLanczos(
+    const ConversionPlan& cplan, const Field* Ax, const Field* Bx,
+    const ApplyMass apply_mass, const ComplexBase<Field>& shift,
+    const ShiftInvertLanczosControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& initial_block, SparseLDL<Field>* ldl,
+    Buffer<ComplexBase<Field>>* eigenvalues, BlasMatrix<Field>* eigenvectors,
+    ShiftInvertLanczosWorkspace<Field>* workspace) {
+  typedef ComplexBase<Field> Real;
+  typedef EigenScalar<Field> Conversion;
+  typedef Eigen::Matrix<typename Conversion::type, Eigen::Dynamic,
+                        Eigen::Dynamic>
+      EigenMatrix;
+  const Int height = initial_block.height;
+  const Int block_size = initial_block.width;
+  if (block_size <= 0 || control.num_eigenpairs <= 0 ||
+      control.max_iterations <= 0) {
+    throw std::invalid_argument(
+        "Lanczos requires a nonempty initial block and positive counts");
+  }
+  const Real tolerance =
+      control.relative_tolerance_coefficient *
+      std::pow(std::numeric_limits<Real>::epsilon(),
+               control.relative_tolerance_exponent);
+
+  // Only refactor A - sigma B when the shift has moved.
+  ShiftInvertLanczosStatus<Real> status;
+  if (!workspace->factored || workspace->shift != shift) {
+    workspace->factored = false;
+    const SparseLDLResult<Field> result =
+        ldl->RefactorWithFixedSparsityPattern(cplan, Ax, Field(-shift), Bx);
+    if (result.num_successful_pivots < height) {
+      throw std::runtime_error("Could not factor the shifted matrix");
+    }
+    workspace->factored = true;
+    workspace->shift = shift;
+    status.refactored = true;
+  }
+
+  const Int max_basis_size = block_size * (control.max_iterations + 1);
+  workspace->basis.Resize(height, max_basis_size);
+  workspace->mass_basis.Resize(height, max_basis_size);
+  workspace->projection.Resize(max_basis_size, max_basis_size, Field(0));
+  workspace->block.Resize(height, block_size);
+  workspace->mass_block.Resize(height, block_size);
+
+  // The leading block of the basis is the B-orthonormalized initial block.
+  {
+    BlasMatrixView<Field> first_block =
+        workspace->basis.Submatrix(0, 0, height, block_size);
+    BlasMatrixView<Field> first_mass_block =
+        workspace->mass_basis.Submatrix(0, 0, height, block_size);
+    for (Int j = 0; j < block_size; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        first_block(i, j) = initial_block(i, j);
+      }
+    }
+    apply_mass(Field(1), first_block.ToConst(), Field(0), &first_mass_block);
+    if (!shift_invert_lanczos::MassOrthonormalize(
+            Real(0), &first_block, &first_mass_block, &workspace->gram)) {
+      throw std::invalid_argument("The initial block must have full rank");
+    }
+  }
+
+  Int basis_size = 0;
+  Int num_wanted = 0;
+  EigenMatrix ritz_vectors;
+  std::vector<Real> ritz_values;
+  std::vector<Int> order;
+  for (Int iter = 0; iter < control.max_iterations; ++iter) {
+    const Int offset = iter * block_size;
+    basis_size = offset + block_size;
+    const ConstBlasMatrixView<Field> basis =
+        workspace->basis.Submatrix(0, 0, height, basis_size);
+    const ConstBlasMatrixView<Field> mass_basis =
+        workspace->mass_basis.Submatrix(0, 0, height, basis_size);
+    ++status.num_iterations;
+
+    // Apply inv(A - sigma B) B to the newest block with a single solve.
+    for (Int j = 0; j < block_size; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        workspace->block(i, j) = mass_basis(i, offset + j);
+      }
+    }
+    ldl->Solve(&workspace->block.view);
+
+    // B-orthogonalize the image against the basis with classical Gram-Schmidt
+    // with reorthogonalization, accumulating the coefficients of both passes
+    // into the projection.
+    BlasMatrixView<Field> projection_block =
+        workspace->projection.Submatrix(0, offset, basis_size, block_size);
+    workspace->coefficients.Resize(basis_size, block_size);
+    Real scale = 0;
+    for (Int pass = 0; pass < 2; ++pass) {
+      MatrixMultiplyAdjointNormal(Field(1), mass_basis,
+                                  workspace->block.ConstView(), Field(0),
+                                  &workspace->coefficients.view);
+      MatrixMultiplyNormalNormal(Field(-1), basis,
+                                 workspace->coefficients.ConstView(), Field(1),
+                                 &workspace->block.view);
+      for (Int j = 0; j < block_size; ++j) {
+        for (Int i = 0; i < basis_size; ++i) {
+          projection_block(i, j) += workspace->coefficients(i, j);
+          scale = std::max(scale, std::abs(projection_block(i, j)));
+        }
+      }
+    }
+
+    // Normalize the remainder into the next block of the basis unless the
+    // basis has (numerically) become invariant, in which case its coupling
+    // to the next block, L^H, vanishes.
+    bool extended = basis_size < max_basis_size;
+    if (extended) {
+      apply_mass(Field(1), workspace->block.ConstView(), Field(0),
+                 &workspace->mass_block.view);
+      extended = shift_invert_lanczos::MassOrthonormalize(
+          scale, &workspace->block.view, &workspace->mass_block.view,
+          &workspace->gram);
+    }
+    EigenMatrix coupling = EigenMatrix::Zero(block_size, block_size);
+    if (extended) {
+      for (Int j = 0; j < block_size; ++j) {
+        for (Int i = 0; i <= j; ++i) {
+          const Field entry = Conjugate(workspace->gram(j, i));
+          workspace->projection(basis_size + i, offset + j) = entry;
+          coupling(i, j) = Conversion::ToEigen(entry);
+        }
+        for (Int i = 0; i < height; ++i) {
+          workspace->basis(i, basis_size + j) = workspace->block(i, j);
+          workspace->mass_basis(i, basis_size + j) =
+              workspace->mass_block(i, j);
+        }
+      }
+    }
+
+    // Form the Ritz pairs from the (symmetrized) projection, ordered by
+    // decreasing magnitude of theta, i.e., by increasing distance from the
+    // shift.
+    EigenMatrix projection(basis_size, basis_size);
+    for (Int j = 0; j < basis_size; ++j) {
+      for (Int i = j; i < basis_size; ++i) {
+        projection(i, j) = Conversion::ToEigen(
+            (workspace->projection(i, j) +
+             Conjugate(workspace->projection(j, i))) /
+            Real(2));
+      }
+    }
+    const Eigen::SelfAdjointEigenSolver<EigenMatrix> solver(projection);
+    ritz_vectors = solver.eigenvectors();
+    ritz_values.resize(basis_size);
+    order.resize(basis_size);
+    for (Int k = 0; k < basis_size; ++k) {
+      ritz_values[k] = solver.eigenvalues()(k);
+    }
+    std::iota(order.begin(), order.end(), Int(0));
+    std::stable_sort(order.begin(), order.end(), [&](Int a, Int b) {
+      return std::abs(ritz_values[a]) > std::abs(ritz_values[b]);
+    });
+
+    // The B-norm of the residual of a Ritz pair (theta, V y) is that of the
+    // coupling times the trailing block of y.
+    num_wanted = std::min(control.num_eigenpairs, basis_size);
+    status.num_converged = 0;
+    status.relative_residual = 0;
+    for (Int k = 0; k < num_wanted; ++k) {
+      const Int index = order[k];
+      const Real residual =
+          (coupling *
+           ritz_vectors.col(index).tail(block_size)).norm() /
+          std::abs(ritz_values[index]);
+      status.relative_residual = std::max(status.relative_residual, residual);
+      status.num_converged += residual <= tolerance;
+    }
+    if (control.verbose) {
+      std::cout << "Lanczos step " << iter << ": " << status.num_converged
+                << " of " << num_wanted << " Ritz pairs converged, max "
+                << "relative residual " << status.relative_residual
+                << std::endl;
+    }
+    if (!extended || (num_wanted == control.num_eigenpairs &&
+                      status.num_converged == num_wanted)) {
+      break;
+    }
+  }
+
+  // Map the Ritz pairs back to the eigenpairs of the pencil.
+  eigenvalues->Resize(num_wanted);
+  BlasMatrix<Field> coordinates;
+  coordinates.Resize(basis_size, num_wanted);
+  for (Int k = 0; k < num_wanted; ++k) {
+    const Int index = order[k];
+    (*eigenvalues)[k] = shift + Real(1) / ritz_values[index];
+    for (Int i = 0; i < basis_size; ++i) {
+      coordinates(i, k) = Conversion::FromEigen(ritz_vectors(i, index));
+    }
+  }
+  eigenvectors->Resize(height, num_wanted);
+  MatrixMultiplyNormalNormal(
+      Field(1), workspace->basis.Submatrix(0, 0, height, basis_size).ToConst(),
+      coordinates.ConstView(), Field(0), &eigenvectors->view);
+
+  return status;
+}
+
+template <class Field, class ApplyMass>
+ShiftInvertLanczosStatus<ComplexBase<Field>> ShiftInvertLanczos(
+    const ConversionPlan& cplan, const Field* Ax, const Field* Bx,
+    const ApplyMass apply_mass, const ComplexBase<Field>& shift,
+    const ShiftInvertLanczosControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& initial_block, SparseLDL<Field>* ldl,
+    Buffer<ComplexBase<Field>>* eigenvalues, BlasMatrix<Field>* eigenvectors) {
+  ShiftInvertLanczosWorkspace<Field> workspace;
+  return ShiftInvertLanczos(cplan, Ax, Bx, apply_mass, shift, control,
+                            initial_block, ldl, eigenvalues, eigenvectors,
+                            &workspace);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SHIFT_INVERT_LANCZOS_IMPL_H_
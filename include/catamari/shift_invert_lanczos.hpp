@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SHIFT_INVERT_LANCZOS_H_
+#define CATAMARI_SHIFT_INVERT_LANCZOS_H_
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+// The configuration parameters of the block shift-invert Lanczos iteration
+// for the eigenpairs of a Hermitian pencil (A, B), with B positive-definite,
+// nearest to a shift sigma. The iteration builds a B-orthonormal Krylov basis
+// of the operator inv(A - sigma B) B, whose eigenvalues, theta, are related to
+// those of the pencil through lambda = sigma + 1 / theta.
+template <typename Real>
+struct ShiftInvertLanczosControl {
+  // The number of eigenpairs nearest to the shift which are desired.
+  Int num_eigenpairs = 1;
+
+  // The maximum number of block Lanczos steps, each of which adds as many
+  // basis vectors as there are columns in the initial block.
+  Int max_iterations = 50;
+
+  // A Ritz pair (theta, x) of the shift-inverted operator is considered
+  // converged once its B-norm residual relative to |theta| is below
+  //
+  //   coefficient * epsilon^exponent,
+  //
+  // where 'epsilon' is the precision of type 'Real'.
+  Real relative_tolerance_coefficient = Real(1);
+  Real relative_tolerance_exponent = Real(0.5);
+
+  // If true, progress information is printed.
+  bool verbose = false;
+};
+
+// The summary of a run of the block shift-invert Lanczos iteration.
+template <typename Real>
+struct ShiftInvertLanczosStatus {
+  // The number of block Lanczos steps performed.
+  Int num_iterations = 0;
+
+  // The number of returned eigenpairs which met the tolerance.
+  Int num_converged = 0;
+
+  // The maximum relative residual of the returned eigenpairs (see
+  // 'ShiftInvertLanczosControl').
+  Real relative_residual = 0;
+
+  // Whether 'A - sigma B' was refactored.
+  bool refactored = false;
+};
+
+// The buffers of a block shift-invert Lanczos run, along with the shift of
+// the factorization it last formed. A workspace can be passed to successive
+// calls to 'ShiftInvertLanczos' so that, once the first call has sized them,
+// runs with the same dimensions do not allocate, and so that the matrix is
+// only refactored when the shift moves. If the factorization is modified
+// elsewhere, 'factored' should be reset.
+template <class Field>
+struct ShiftInvertLanczosWorkspace {
+  // Whether the factorization currently holds 'A - shift B'.
+  bool factored = false;
+  ComplexBase<Field> shift = 0;
+
+  // The B-orthonormal Krylov basis and its image under B.
+  BlasMatrix<Field> basis;
+  BlasMatrix<Field> mass_basis;
+
+  // The block being extended, and orthogonalized, and its image under B.
+  BlasMatrix<Field> block;
+  BlasMatrix<Field> mass_block;
+
+  // The projection of the shift-inverted operator onto the basis (along with
+  // the coupling of the basis to its next block).
+  BlasMatrix<Field> projection;
+
+  // The coefficients of a block against the basis and the Gram matrix of a
+  // block.
+  BlasMatrix<Field> coefficients;
+  BlasMatrix<Field> gram;
+};
+
+// Computes up to 'control.num_eigenpairs' eigenpairs of the Hermitian pencil
+// (A, B) nearest to 'shift' with block shift-invert Lanczos (with full
+// reorthogonalization) starting from the columns of 'initial_block'. The
+// values of A and B are loaded into 'ldl', which must hold an analysis of
+// their (shared) sparsity pattern, through 'cplan' (see
+// 'SparseLDL::RefactorWithFixedSparsityPattern'), and each step applies the
+// shift-inverted operator to a whole block with one multi-right-hand-side
+// solve. 'apply_mass(alpha, X, beta, Y)' should overwrite 'Y' with
+// 'alpha B X + beta Y' for a block 'X' of any width. The eigenvalues are
+// returned in order of increasing distance from the shift, and the columns of
+// 'eigenvectors' are the corresponding B-orthonormal eigenvectors.
+template <class Field, class ApplyMass>
+ShiftInvertLanczosStatus<ComplexBase<Field>> ShiftInvertLanczos(
+    const ConversionPlan& cplan, const Field* Ax, const Field* Bx,
+    const ApplyMass apply_mass, const ComplexBase<Field>& shift,
+    const ShiftInvertLanczosControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& initial_block, SparseLDL<Field>* ldl,
+    Buffer<ComplexBase<Field>>* eigenvalues, BlasMatrix<Field>* eigenvectors,
+    ShiftInvertLanczosWorkspace<Field>* workspace);
+
+// Equivalent to the above, but with a temporary workspace (so that the
+// matrix is always refactored).
+template <class Field, class ApplyMass>
+ShiftInvertLanczosStatus<ComplexBase<Field>> ShiftInvertLanczos(
+    const ConversionPlan& cplan, const Field* Ax, const Field* Bx,
+    const ApplyMass apply_mass, const ComplexBase<Field>& shift,
+    const ShiftInvertLanczosControl<ComplexBase<Field>>& control,
+    const ConstBlasMatrixView<Field>& initial_block, SparseLDL<Field>* ldl,
+    Buffer<ComplexBase<Field>>* eigenvalues, BlasMatrix<Field>* eigenvectors);
+
+}  // namespace catamari
+
+#include "catamari/shift_invert_lanczos-impl.hpp"
+
+#endif  // ifndef CATAMARI_SHIFT_INVERT_LANCZOS_H_
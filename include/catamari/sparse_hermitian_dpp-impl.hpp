@@ -8,7 +8,10 @@
 #ifndef CATAMARI_SPARSE_HERMITIAN_DPP_IMPL_H_
 #define CATAMARI_SPARSE_HERMITIAN_DPP_IMPL_H_
 
-#include "catamari/flush_to_zero.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "catamari/execution_context.hpp"
 
 #include "catamari/sparse_hermitian_dpp.hpp"
 
@@ -16,11 +19,32 @@ namespace catamari {
 
 template <class Field>
 SparseHermitianDPP<Field>::SparseHermitianDPP(
+    const CoordinateMatrix<Field>& matrix,
+    const SparseHermitianDPPControl& control)
+    : execution_context_(control.execution_context) {
+  RunInExecutionContext(execution_context_,
+                        [&]() { Initialize(matrix, control); });
+}
+
+template <class Field>
+SparseHermitianDPP<Field>::SparseHermitianDPP(
+    const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+    const SparseHermitianDPPControl& control)
+    : execution_context_(control.execution_context) {
+  RunInExecutionContext(execution_context_,
+                        [&]() { Initialize(matrix, ordering, control); });
+}
+
+template <class Field>
+void SparseHermitianDPP<Field>::Initialize(
     const CoordinateMatrix<Field>& matrix,
     const SparseHermitianDPPControl& control) {
   // Avoid the potential for order-of-magnitude performance degradation from
   // slow subnormal processing.
-  EnableFlushToZero();
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() { Initialize(matrix, control); });
+    return;
+  }
 
   scalar_dpp_.reset();
   supernodal_dpp_.reset();
@@ -78,12 +102,15 @@ SparseHermitianDPP<Field>::SparseHermitianDPP(
 }
 
 template <class Field>
-SparseHermitianDPP<Field>::SparseHermitianDPP(
+void SparseHermitianDPP<Field>::Initialize(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
     const SparseHermitianDPPControl& control) {
   // Avoid the potential for order-of-magnitude performance degradation from
   // slow subnormal processing.
-  EnableFlushToZero();
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() { Initialize(matrix, ordering, control); });
+    return;
+  }
 
   scalar_dpp_.reset();
   supernodal_dpp_.reset();
@@ -112,6 +139,13 @@ SparseHermitianDPP<Field>::SparseHermitianDPP(
 template <class Field>
 std::vector<Int> SparseHermitianDPP<Field>::Sample(
     bool maximum_likelihood) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return Sample(maximum_likelihood); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero([&]() { return Sample(maximum_likelihood); });
+  }
   if (is_supernodal_) {
     return supernodal_dpp_->Sample(maximum_likelihood);
   } else {
@@ -119,8 +153,54 @@ std::vector<Int> SparseHermitianDPP<Field>::Sample(
   }
 }
 
+template <class Field>
+std::vector<Int> SparseHermitianDPP<Field>::Sample(
+    bool maximum_likelihood, const DPPConstraints& constraints) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return Sample(maximum_likelihood, constraints); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return Sample(maximum_likelihood, constraints); });
+  }
+  if (is_supernodal_) {
+    return supernodal_dpp_->Sample(maximum_likelihood, constraints);
+  } else {
+    return scalar_dpp_->Sample(maximum_likelihood, constraints);
+  }
+}
+
+template <class Field>
+std::vector<std::vector<Int>> SparseHermitianDPP<Field>::SampleMany(
+    Int num_samples, bool maximum_likelihood) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return SampleMany(num_samples, maximum_likelihood); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return SampleMany(num_samples, maximum_likelihood); });
+  }
+  if (is_supernodal_) {
+    return supernodal_dpp_->SampleMany(num_samples, maximum_likelihood);
+  }
+  std::vector<std::vector<Int>> samples;
+  samples.reserve(std::max(num_samples, Int(0)));
+  for (Int sample_index = 0; sample_index < num_samples; ++sample_index) {
+    samples.push_back(scalar_dpp_->Sample(maximum_likelihood));
+  }
+  return samples;
+}
+
 template <class Field>
 ComplexBase<Field> SparseHermitianDPP<Field>::LogLikelihood() const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute([&]() { return LogLikelihood(); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero([&]() { return LogLikelihood(); });
+  }
   if (is_supernodal_) {
     return supernodal_dpp_->LogLikelihood();
   } else {
@@ -128,6 +208,115 @@ ComplexBase<Field> SparseHermitianDPP<Field>::LogLikelihood() const {
   }
 }
 
+template <class Field>
+std::vector<Int> GreedyLEnsembleMAP(Int max_size,
+                                    const ComplexBase<Field>& min_gain,
+                                    const CoordinateMatrix<Field>& kernel) {
+  typedef ComplexBase<Field> Real;
+  const Int num_items = kernel.NumRows();
+  const Buffer<MatrixEntry<Field>>& entries = kernel.Entries();
+  max_size = std::max(std::min(max_size, num_items), Int(0));
+  std::vector<Int> sample;
+  sample.reserve(max_size);
+
+  // The Schur complements of the items with respect to the selection, i.e.,
+  // the ratios det(L_{Y + i}) / det(L_Y).
+  Buffer<Real> gains(num_items, Real(0));
+  for (const MatrixEntry<Field>& entry : entries) {
+    if (entry.row == entry.column) {
+      gains[entry.row] = RealPart(entry.value);
+    }
+  }
+  Buffer<char> selected(num_items, 0);
+
+  // The incremental Cholesky factor of the kernel restricted to the
+  // selection, L_Y = C_Y C_Y^H, along with the items with a nonzero in each
+  // of its columns.
+  BlasMatrix<Field> factor;
+  factor.Resize(num_items, std::max(max_size - 1, Int(0)), Field{0});
+  std::vector<std::vector<Int>> column_supports(max_size);
+
+  // The nonzero columns of the pivot's row of the factor, the items whose
+  // new factor entry can be nonzero, and the marks of the latter.
+  std::vector<Int> pivot_support;
+  std::vector<Int> candidates;
+  Buffer<Int> candidate_marks(num_items, -1);
+
+  for (Int index = 0; index < max_size; ++index) {
+    Int pivot = -1;
+    Real pivot_gain = min_gain;
+    for (Int i = 0; i < num_items; ++i) {
+      if (!selected[i] && gains[i] > pivot_gain) {
+        pivot = i;
+        pivot_gain = gains[i];
+      }
+    }
+    if (pivot < 0) {
+      break;
+    }
+    sample.push_back(pivot);
+    selected[pivot] = 1;
+    if (index == max_size - 1) {
+      break;
+    }
+
+    // Accumulate kernel(:, pivot) over the neighbors of the pivot.
+    Field* column = factor.view.Pointer(0, index);
+    candidates.clear();
+    const Int row_beg = kernel.RowEntryOffset(pivot);
+    const Int row_end = kernel.RowEntryOffset(pivot + 1);
+    for (Int entry_index = row_beg; entry_index < row_end; ++entry_index) {
+      const MatrixEntry<Field>& entry = entries[entry_index];
+      if (selected[entry.column]) {
+        continue;
+      }
+      if (candidate_marks[entry.column] != index) {
+        candidate_marks[entry.column] = index;
+        candidates.push_back(entry.column);
+      }
+      column[entry.column] += Conjugate(entry.value);
+    }
+
+    // Subtract factor(:, 0:index) factor(pivot, 0:index)' over the items
+    // sharing a nonzero column with the pivot's row.
+    pivot_support.clear();
+    for (Int j = 0; j < index; ++j) {
+      if (factor(pivot, j) != Field{0}) {
+        pivot_support.push_back(j);
+        for (const Int i : column_supports[j]) {
+          if (!selected[i] && candidate_marks[i] != index) {
+            candidate_marks[i] = index;
+            candidates.push_back(i);
+          }
+        }
+      }
+    }
+    for (const Int i : candidates) {
+      Field value = column[i];
+      for (const Int j : pivot_support) {
+        value -= factor(i, j) * Conjugate(factor(pivot, j));
+      }
+      column[i] = value;
+    }
+
+    // Scale the new column and update the gains of its items.
+    const Real pivot_inv_sqrt = Real(1) / std::sqrt(pivot_gain);
+    std::vector<Int>& support = column_supports[index];
+    for (const Int i : candidates) {
+      Field& entry = column[i];
+      entry *= pivot_inv_sqrt;
+      if (entry == Field{0}) {
+        continue;
+      }
+      support.push_back(i);
+      gains[i] -= RealPart(entry * Conjugate(entry));
+      gains[i] = std::max(gains[i], Real(0));
+    }
+  }
+
+  return sample;
+}
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_SPARSE_HERMITIAN_DPP_IMPL_H_
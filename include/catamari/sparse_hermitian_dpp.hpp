@@ -8,6 +8,7 @@
 #ifndef CATAMARI_SPARSE_HERMITIAN_DPP_H_
 #define CATAMARI_SPARSE_HERMITIAN_DPP_H_
 
+#include "catamari/execution_context.hpp"
 #include "catamari/sparse_hermitian_dpp/scalar.hpp"
 #include "catamari/sparse_hermitian_dpp/supernodal.hpp"
 #include "quotient/minimum_degree.hpp"
@@ -26,6 +27,10 @@ struct SparseHermitianDPPControl {
 
   // The configuration options for the supernodal DPP sampler.
   SupernodalHermitianDPPControl supernodal_control;
+
+  // If non-null, the execution context which the factorization and the
+  // sampling run within. The context must outlive the sampler.
+  const ExecutionContext* execution_context = nullptr;
 };
 
 // The user-facing data structure for storing an LDL'-based DPP sampler.
@@ -46,10 +51,26 @@ class SparseHermitianDPP {
   // pivot is kept based upon which choice is most likely.
   std::vector<Int> Sample(bool maximum_likelihood) const;
 
+  // Returns a sample from the DPP with the given items (in the original
+  // ordering) forced into or out of it. Each forced decision replaces the coin
+  // flip of its pivot, so that the items eliminated after it are sampled
+  // conditionally upon it; the cost matches that of an unconstrained sample.
+  std::vector<Int> Sample(bool maximum_likelihood,
+                          const DPPConstraints& constraints) const;
+
+  // Returns 'num_samples' independent samples from the DPP. The supernodal
+  // sampler draws them concurrently.
+  std::vector<std::vector<Int>> SampleMany(Int num_samples,
+                                           bool maximum_likelihood) const;
+
   // Returns the log-likelihood of the last DPP sample.
   ComplexBase<Field> LogLikelihood() const;
 
  private:
+  // The execution context of the sampler (see
+  // 'SparseHermitianDPPControl::execution_context'), if any.
+  const ExecutionContext* execution_context_;
+
   // Whether or not a supernodal sampler was used. If it is true, only
   // 'supernodal_dpp_' should be non-null, and vice versa.
   bool is_supernodal_;
@@ -59,8 +80,28 @@ class SparseHermitianDPP {
 
   // The supernodal DPP sampling structure.
   std::unique_ptr<SupernodalHermitianDPP<Field>> supernodal_dpp_;
+
+  // Forms the sampler using an automatically-determined reordering.
+  void Initialize(const CoordinateMatrix<Field>& matrix,
+                  const SparseHermitianDPPControl& control);
+
+  // Forms the sampler using a user-specified ordering.
+  void Initialize(const CoordinateMatrix<Field>& matrix,
+                  const SymmetricOrdering& ordering,
+                  const SparseHermitianDPPControl& control);
 };
 
+// A sparse equivalent of the dense GreedyLEnsembleMAP, where both triangles
+// of the Hermitian positive semi-definite kernel are stored. Each column of
+// the incremental Cholesky factor is only formed over the neighbors of the
+// new item in the kernel and the items whose factor rows overlap its own, so
+// selections of mutually distant items remain cheap for large sparse
+// kernels.
+template <class Field>
+std::vector<Int> GreedyLEnsembleMAP(Int max_size,
+                                    const ComplexBase<Field>& min_gain,
+                                    const CoordinateMatrix<Field>& kernel);
+
 }  // namespace catamari
 
 #include "catamari/sparse_hermitian_dpp-impl.hpp"
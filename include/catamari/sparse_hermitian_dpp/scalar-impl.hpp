@@ -92,7 +92,7 @@ void ScalarHermitianDPP<Field>::UpLookingRowUpdate(
 
 template <class Field>
 std::vector<Int> ScalarHermitianDPP<Field>::UpLookingSample(
-    bool maximum_likelihood) const {
+    bool maximum_likelihood, const DPPConstraints& constraints) const {
   const Int num_rows = matrix_.NumRows();
   const Buffer<Int>& parents = ordering_.assembly_forest.parents;
   const scalar_ldl::LowerStructure& lower_structure = lower_factor_->structure;
@@ -108,6 +108,24 @@ std::vector<Int> ScalarHermitianDPP<Field>::UpLookingSample(
 
   std::uniform_real_distribution<Real> uniform_dist{Real{0}, Real{1}};
 
+  // The decisions imposed upon each row, in the permuted ordering.
+  Buffer<DPPItemConstraint> row_constraints;
+  if (!constraints.included.empty() || !constraints.excluded.empty()) {
+    row_constraints.Resize(num_rows, kFreeItem);
+    for (const Int& item : constraints.included) {
+      const Int row =
+          ordering_.permutation.Empty() ? item : ordering_.permutation[item];
+      row_constraints[row] = kIncludedItem;
+    }
+    for (const Int& item : constraints.excluded) {
+      const Int row =
+          ordering_.permutation.Empty() ? item : ordering_.permutation[item];
+      CATAMARI_ASSERT(row_constraints[row] != kIncludedItem,
+                      "Item was both included and excluded.");
+      row_constraints[row] = kExcludedItem;
+    }
+  }
+
   std::vector<Int> sample;
   sample.reserve(num_rows);
   for (Int row = 0; row < num_rows; ++row) {
@@ -134,9 +152,13 @@ std::vector<Int> ScalarHermitianDPP<Field>::UpLookingSample(
 
     // Early exit if solving would involve division by zero.
     Real pivot = diagonal_factor_->values[row];
-    const bool keep_index = maximum_likelihood
-                                ? pivot >= Real(1) / Real(2)
-                                : uniform_dist(state.generator) <= pivot;
+    bool keep_index;
+    if (!row_constraints.Empty() && row_constraints[row] != kFreeItem) {
+      keep_index = row_constraints[row] == kIncludedItem;
+    } else {
+      keep_index = maximum_likelihood ? pivot >= Real(1) / Real(2)
+                                      : uniform_dist(state.generator) <= pivot;
+    }
     if (keep_index) {
       sample.push_back(row);
     } else {
@@ -153,7 +175,13 @@ std::vector<Int> ScalarHermitianDPP<Field>::UpLookingSample(
 template <class Field>
 std::vector<Int> ScalarHermitianDPP<Field>::Sample(
     bool maximum_likelihood) const {
-  return UpLookingSample(maximum_likelihood);
+  return UpLookingSample(maximum_likelihood, DPPConstraints());
+}
+
+template <class Field>
+std::vector<Int> ScalarHermitianDPP<Field>::Sample(
+    bool maximum_likelihood, const DPPConstraints& constraints) const {
+  return UpLookingSample(maximum_likelihood, constraints);
 }
 
 template <typename Field>
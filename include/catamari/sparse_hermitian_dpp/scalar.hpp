@@ -11,6 +11,7 @@
 #include <random>
 
 #include "catamari/buffer.hpp"
+#include "catamari/dense_dpp.hpp"
 #include "catamari/sparse_ldl.hpp"
 
 namespace catamari {
@@ -32,6 +33,11 @@ class ScalarHermitianDPP {
   // pivot is kept based upon which choice is most likely.
   std::vector<Int> Sample(bool maximum_likelihood) const;
 
+  // Returns a sample from the DPP with the given items forced into or out of
+  // it, with each forced decision replacing the coin flip of its pivot.
+  std::vector<Int> Sample(bool maximum_likelihood,
+                          const DPPConstraints& constraints) const;
+
   // Returns the log-likelihood of the last sample.
   ComplexBase<Field> LogLikelihood() const;
 
@@ -65,7 +71,8 @@ class ScalarHermitianDPP {
   const ScalarHermitianDPPControl control_;
 
   // Return a sample from the DPP using an up-looking algorithm.
-  std::vector<Int> UpLookingSample(bool maximum_likelihood) const;
+  std::vector<Int> UpLookingSample(bool maximum_likelihood,
+                                   const DPPConstraints& constraints) const;
 
   // Initializes for running an up-looking factorization.
   void UpLookingSetup() CATAMARI_NOEXCEPT;
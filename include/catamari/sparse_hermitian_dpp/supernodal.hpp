@@ -8,9 +8,14 @@
 #ifndef CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_H_
 #define CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_H_
 
+#include <cstdint>
 #include <random>
 
+#include <tbb/enumerable_thread_specific.h>
+
 #include "catamari/buffer.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catamari/philox.hpp"
 #include "catamari/sparse_ldl.hpp"
 
 namespace catamari {
@@ -26,11 +31,10 @@ struct SupernodalHermitianDPPControl {
   // The algorithmic block size for the factorization.
   Int block_size = 64;
 
-#ifdef CATAMARI_OPENMP
-  // The size of the matrix tiles for factorization OpenMP tasks.
+  // The size of the matrix tiles for factorization tasks.
   Int factor_tile_size = 128;
 
-  // The size of the matrix tiles for dense outer product OpenMP tasks.
+  // The size of the matrix tiles for dense outer product tasks.
   Int outer_product_tile_size = 240;
 
   // The number of columns to group into a single task when multithreading
@@ -43,13 +47,18 @@ struct SupernodalHermitianDPPControl {
 
   // The minimum ratio of the amount of work in a subtree relative to the
   // nominal amount of flops assigned to each thread (total_work / max_threads)
-  // before OpenMP subtasks are launched in the subtree.
+  // before TBB subtasks are launched in the subtree.
   double parallel_ratio_threshold = 0.02;
 
-  // The minimum number of flops in a subtree before OpenMP subtasks are
+  // The minimum number of flops in a subtree before TBB subtasks are
   // generated.
   double min_parallel_threshold = 1e5;
-#endif  // ifdef CATAMARI_OPENMP
+
+  // The key of the counter-based random number streams. Each supernode of
+  // each sample draws from its own stream, so that the samples are
+  // reproducible regardless of the number of threads. If negative, a key is
+  // drawn from std::random_device.
+  Int seed = -1;
 
 #ifdef CATAMARI_ENABLE_TIMERS
   // The max number of levels of the supernodal tree to visualize timings of.
@@ -79,6 +88,25 @@ class SupernodalHermitianDPP {
   // pivot is kept based upon which choice is most likely.
   std::vector<Int> Sample(bool maximum_likelihood) const;
 
+  // Returns a sample from the DPP with the given items forced into or out of
+  // it. Each forced decision replaces the coin flip of its pivot as the
+  // supernodes are processed, so that the items eliminated later are sampled
+  // conditionally on it, at the cost of an unconstrained sample. The result
+  // is thus drawn from the conditioned DPP when the constrained items precede
+  // the others in the elimination ordering. The log-likelihood remains that
+  // of the sample under the unconditioned DPP.
+  std::vector<Int> Sample(bool maximum_likelihood,
+                          const DPPConstraints& constraints) const;
+
+  // Returns 'num_samples' independent samples from the DPP. The samples are
+  // drawn concurrently, each with a private copy of the factor values and its
+  // own random number streams, while sharing the symbolic analysis. With a
+  // fixed seed, the result matches 'num_samples' calls to 'Sample'. The factor
+  // (and hence the log-likelihood) from the last call to 'Sample' is
+  // preserved.
+  std::vector<std::vector<Int>> SampleMany(Int num_samples,
+                                           bool maximum_likelihood) const;
+
   // Returns the log-likelihood of the last sample.
   ComplexBase<Field> LogLikelihood() const;
 
@@ -88,8 +116,26 @@ class SupernodalHermitianDPP {
   struct PrivateState {
     supernodal_ldl::PrivateState<Field> ldl_state;
 
-    // A random number generator.
-    std::mt19937 generator;
+    // The index of the sample being drawn, which selects its random number
+    // streams.
+    Int sample_index = 0;
+
+    // If non-null, the decisions imposed upon each row, in the permuted
+    // ordering.
+    const DPPItemConstraint* constraints = nullptr;
+
+    // If non-empty, the private factor values of a sample, laid out as in
+    // 'factor_values_'. Otherwise, the shared factor values are used.
+    Buffer<Field> factor_values;
+  };
+
+  // The thread-local private states of a multithreaded sampler.
+  typedef tbb::enumerable_thread_specific<PrivateState> PrivateStates;
+
+  // The workspace of a thread drawing a sequence of independent samples.
+  struct SampleManyWorkspace {
+    supernodal_ldl::RightLookingSharedState<Field> shared_state;
+    PrivateState private_state;
   };
 
   // A copy of the input matrix.
@@ -115,6 +161,10 @@ class SupernodalHermitianDPP {
   // The size of the scaled transpose matrix needed for left-looking updates.
   Int left_looking_scaled_transpose_size_;
 
+  // The storage for the factor, with the diagonal and subdiagonal blocks of
+  // each supernode interleaved to form contiguous frontal matrix columns.
+  mutable BlasMatrix<Field> factor_values_;
+
   // The subdiagonal-block portion of the lower-triangular factor.
   mutable std::unique_ptr<supernodal_ldl::LowerFactor<Field>> lower_factor_;
 
@@ -134,20 +184,44 @@ class SupernodalHermitianDPP {
   // The chosen minimum amount of work to deem worthy of parallelization.
   double min_parallel_work_;
 
+  // The key of the random number streams.
+  std::uint64_t seed_;
+
+  // The number of samples drawn so far, which is the index of the next one.
+  mutable Int num_samples_drawn_;
+
   void FormSupernodes();
 
-#ifdef CATAMARI_OPENMP
   void OpenMPFormSupernodes();
-#endif  // ifdef CATAMARI_OPENMP
 
   void FormStructure();
 
-#ifdef CATAMARI_OPENMP
   void OpenMPFormStructure();
-#endif  // ifdef CATAMARI_OPENMP
+
+  // Allocates the factor storage for the supernodal structure, with the
+  // diagonal and lower blocks interleaved into contiguous fronts.
+  void AllocateFactors();
+
+  // Maps the structure of each supernode into its parent's front.
+  void MapChildrenIntoFronts();
+
+  // Estimates the work in each subtree and the minimum amount of work worth
+  // parallelizing.
+  void FillWorkEstimates();
+
+  // Returns the random number stream of a supernode within a sample.
+  PhiloxEngine SupernodeGenerator(Int supernode, Int sample_index) const;
+
+  // Fills the decisions imposed upon each row in the permuted ordering.
+  void PermuteConstraints(const DPPConstraints& constraints,
+                          Buffer<DPPItemConstraint>* row_constraints) const;
+
+  // Loads the input matrix into the (otherwise zeroed) factors.
+  void InitializeFactors(bool multithreaded) const;
 
   // Return a sample from the DPP using a left-looking algorithm.
-  std::vector<Int> LeftLookingSample(bool maximum_likelihood) const;
+  std::vector<Int> LeftLookingSample(
+      bool maximum_likelihood, const DPPItemConstraint* constraints) const;
 
 #ifdef CATAMARI_OPENMP
   std::vector<Int> OpenMPLeftLookingSample(bool maximum_likelihood) const;
@@ -189,35 +263,51 @@ class SupernodalHermitianDPP {
 #endif  // ifdef CATAMARI_OPENMP
 
   // Return a sample from the DPP using a right-looking algorithm.
-  std::vector<Int> RightLookingSample(bool maximum_likelihood) const;
+  std::vector<Int> RightLookingSample(
+      bool maximum_likelihood, const DPPItemConstraint* constraints) const;
 
-#ifdef CATAMARI_OPENMP
-  std::vector<Int> OpenMPRightLookingSample(bool maximum_likelihood) const;
-#endif  // ifdef CATAMARI_OPENMP
+  // Samples each tree of the assembly forest in turn.
+  void RightLookingForest(
+      bool maximum_likelihood,
+      supernodal_ldl::RightLookingSharedState<Field>* shared_state,
+      PrivateState* private_state, std::vector<Int>* sample) const;
 
+  // A multithreaded equivalent which launches TBB tasks for the subtrees
+  // with enough work.
+  std::vector<Int> OpenMPRightLookingSample(
+      bool maximum_likelihood, const DPPItemConstraint* constraints) const;
+
+  // Samples the subtree rooted at 'supernode', whose Schur complement and
+  // those of all of its descendants are pushed onto 'subtree_storage'.
   void RightLookingSubtree(
       Int supernode, bool maximum_likelihood,
       supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-      PrivateState* private_state, std::vector<Int>* sample) const;
-
-#ifdef CATAMARI_OPENMP
+      PrivateState* private_state,
+      supernodal_ldl::SchurComplementStorage<Field>* subtree_storage,
+      std::vector<Int>* sample) const;
+
+  // Samples the subtree rooted at 'supernode', with its children run as
+  // separate TBB tasks if the subtree has enough work. Otherwise, the subtree
+  // is sampled sequentially using the existing 'subtree_storage' stack, or
+  // one which this supernode allocates if it is null.
   void OpenMPRightLookingSubtree(
       Int supernode, bool maximum_likelihood,
       supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-      Buffer<PrivateState>* private_states, std::vector<Int>* sample) const;
-#endif  // ifdef CATAMARI_OPENMP
+      PrivateStates* private_states,
+      supernodal_ldl::SchurComplementStorage<Field>* subtree_storage,
+      std::vector<Int>* sample) const;
 
+  // Samples a supernode whose front has been assembled and forms its Schur
+  // complement.
   void RightLookingSupernodeSample(
       Int supernode, bool maximum_likelihood,
       supernodal_ldl::RightLookingSharedState<Field>* shared_state,
       PrivateState* private_state, std::vector<Int>* sample) const;
 
-#ifdef CATAMARI_OPENMP
-  void OpenMPRightLookingSupernodeSample(
-      Int supernode, bool maximum_likelihood,
-      supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-      Buffer<PrivateState>* private_states, std::vector<Int>* sample) const;
-#endif  // ifdef CATAMARI_OPENMP
+  // Returns the view of a factor block within the private factor values of
+  // a sample, if there are any, or else within the shared factor values.
+  BlasMatrixView<Field> PrivateBlock(const BlasMatrixView<Field>& block,
+                                     PrivateState* private_state) const;
 
   // Appends a supernode sample into an unsorted sample vector in the
   // original ordering.
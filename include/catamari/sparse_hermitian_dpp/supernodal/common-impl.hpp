@@ -9,6 +9,10 @@
 #define CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_COMMON_IMPL_H_
 
 #include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
 
 #include "catamari/sparse_hermitian_dpp/supernodal.hpp"
 
@@ -18,37 +22,25 @@ template <class Field>
 SupernodalHermitianDPP<Field>::SupernodalHermitianDPP(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
     const SupernodalHermitianDPPControl& control)
-    : matrix_(matrix), ordering_(ordering), control_(control) {
-#ifdef CATAMARI_OPENMP
-  const int max_threads = omp_get_max_threads();
-  if (max_threads > 1) {
-    #pragma omp parallel
-    #pragma omp single
-    {
-      OpenMPFormSupernodes();
-      OpenMPFormStructure();
-    }
-
-    // Compute flop-count estimates so that we may prioritize the expensive
-    // tasks before the cheaper ones.
-    const Int num_supernodes = ordering_.supernode_sizes.Size();
-    work_estimates_.Resize(num_supernodes);
-    for (const Int& root : ordering_.assembly_forest.roots) {
-      supernodal_ldl::FillSubtreeWorkEstimates(
-          root, ordering_.assembly_forest, *lower_factor_, &work_estimates_);
-    }
-    total_work_ =
-        std::accumulate(work_estimates_.begin(), work_estimates_.end(), 0.);
-    const double min_parallel_ratio_work =
-        (total_work_ * control_.parallel_ratio_threshold) / max_threads;
-    min_parallel_work_ =
-        std::max(control_.min_parallel_threshold, min_parallel_ratio_work);
+    : matrix_(matrix),
+      ordering_(ordering),
+      control_(control),
+      num_samples_drawn_(0) {
+  if (control_.seed >= 0) {
+    seed_ = control_.seed;
+  } else {
+    std::random_device random_device;
+    seed_ = (std::uint64_t(random_device()) << 32) | random_device();
+  }
 
-    return;
+  if (get_max_num_tbb_threads() > 1) {
+    OpenMPFormSupernodes();
+    OpenMPFormStructure();
+  } else {
+    FormSupernodes();
+    FormStructure();
   }
-#endif  // ifdef CATAMARI_OPENMP
-  FormSupernodes();
-  FormStructure();
+  FillWorkEstimates();
 }
 
 template <class Field>
@@ -110,16 +102,14 @@ void SupernodalHermitianDPP<Field>::FormStructure() {
   CATAMARI_ASSERT(supernode_degrees_.Size() == ordering_.supernode_sizes.Size(),
                   "Invalid supernode degrees size.");
 
-  lower_factor_.reset(new supernodal_ldl::LowerFactor<Field>(
-      ordering_.supernode_sizes, supernode_degrees_));
-  diagonal_factor_.reset(
-      new supernodal_ldl::DiagonalFactor<Field>(ordering_.supernode_sizes));
+  AllocateFactors();
 
   max_supernode_size_ = *std::max_element(ordering_.supernode_sizes.begin(),
                                           ordering_.supernode_sizes.end());
 
   supernodal_ldl::FillStructureIndices(
       matrix_, ordering_, supernode_member_to_index_, lower_factor_.get());
+  MapChildrenIntoFronts();
 
   if (control_.algorithm == kLeftLookingLDL) {
     lower_factor_->FillIntersectionSizes(ordering_.supernode_sizes,
@@ -159,20 +149,154 @@ void SupernodalHermitianDPP<Field>::FormStructure() {
   }
 }
 
+template <class Field>
+void SupernodalHermitianDPP<Field>::AllocateFactors() {
+  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  Int diagonal_size = 0;
+  Int lower_size = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int supernode_size = ordering_.supernode_sizes[supernode];
+    diagonal_size += supernode_size * supernode_size;
+    lower_size += supernode_size * supernode_degrees_[supernode];
+  }
+
+  factor_values_.Resize(diagonal_size + lower_size, 1);
+  diagonal_factor_.reset(new supernodal_ldl::DiagonalFactor<Field>(
+      ordering_.supernode_sizes,
+      factor_values_.Submatrix(0, 0, diagonal_size, 1)));
+  lower_factor_.reset(new supernodal_ldl::LowerFactor<Field>(
+      ordering_.supernode_sizes, supernode_degrees_,
+      factor_values_.Submatrix(diagonal_size, 0, lower_size, 1)));
+
+  // Interleave the diagonal and lower blocks so that each supernode's front
+  // columns are contiguous, as the child merges require.
+  Int offset = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+    diagonal_block.data = factor_values_.Data() + offset;
+    lower_block.data = diagonal_block.data + diagonal_block.height;
+    diagonal_block.leading_dim = lower_block.leading_dim =
+        diagonal_block.height + lower_block.height;
+    offset += diagonal_block.width * diagonal_block.leading_dim;
+  }
+}
+
+template <class Field>
+void SupernodalHermitianDPP<Field>::MapChildrenIntoFronts() {
+  auto child_relative_indices = std::make_shared<ChildRelativeIndices>();
+  supernodal_ldl::FillChildRelativeIndices(ordering_, *lower_factor_,
+                                           child_relative_indices.get());
+  ordering_.assembly_forest.child_relative_indices =
+      std::move(child_relative_indices);
+}
+
+template <class Field>
+void SupernodalHermitianDPP<Field>::FillWorkEstimates() {
+  // Compute flop-count estimates so that we may prioritize the expensive
+  // tasks before the cheaper ones.
+  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  work_estimates_.Resize(num_supernodes);
+  for (const Int& root : ordering_.assembly_forest.roots) {
+    supernodal_ldl::FillSubtreeWorkEstimates(
+        root, ordering_.assembly_forest, *lower_factor_, &work_estimates_);
+  }
+  total_work_ =
+      std::accumulate(work_estimates_.begin(), work_estimates_.end(), 0.);
+
+  // Parallelism is forbidden entirely with a single thread.
+  const int max_threads = get_max_num_tbb_threads();
+  const double min_parallel_ratio_work =
+      (total_work_ * control_.parallel_ratio_threshold) / max_threads;
+  min_parallel_work_ = std::max(
+      std::max(control_.min_parallel_threshold, min_parallel_ratio_work),
+      max_threads < 2 ? std::numeric_limits<double>::infinity() : 0.);
+}
+
+template <class Field>
+void SupernodalHermitianDPP<Field>::InitializeFactors(
+    bool multithreaded) const {
+  // The interleaved blocks exactly tile the factor storage.
+  std::fill(factor_values_.Data(),
+            factor_values_.Data() + factor_values_.Height(), Field{0});
+  if (multithreaded) {
+    supernodal_ldl::OpenMPFillNonzeros(
+        matrix_, ordering_, supernode_member_to_index_, lower_factor_.get(),
+        diagonal_factor_.get());
+  } else {
+    supernodal_ldl::FillNonzeros(matrix_, ordering_,
+                                 supernode_member_to_index_,
+                                 lower_factor_.get(), diagonal_factor_.get());
+  }
+}
+
 template <class Field>
 std::vector<Int> SupernodalHermitianDPP<Field>::Sample(
     bool maximum_likelihood) const {
+  return Sample(maximum_likelihood, DPPConstraints());
+}
+
+template <class Field>
+std::vector<Int> SupernodalHermitianDPP<Field>::Sample(
+    bool maximum_likelihood, const DPPConstraints& constraints) const {
+  Buffer<DPPItemConstraint> row_constraints;
+  if (!constraints.included.empty() || !constraints.excluded.empty()) {
+    PermuteConstraints(constraints, &row_constraints);
+  }
+  const DPPItemConstraint* constraints_data =
+      row_constraints.Empty() ? nullptr : row_constraints.Data();
+
   if (control_.algorithm == kLeftLookingLDL) {
     // We no longer support OpenMP for the left-looking sampling.
-    return LeftLookingSample(maximum_likelihood);
+    return LeftLookingSample(maximum_likelihood, constraints_data);
   } else {
-#ifdef CATAMARI_OPENMP
-    if (omp_get_max_threads() > 1) {
-      return OpenMPRightLookingSample(maximum_likelihood);
+    if (get_max_num_tbb_threads() > 1) {
+      return OpenMPRightLookingSample(maximum_likelihood, constraints_data);
+    }
+    return RightLookingSample(maximum_likelihood, constraints_data);
+  }
+}
+
+template <class Field>
+void SupernodalHermitianDPP<Field>::PermuteConstraints(
+    const DPPConstraints& constraints,
+    Buffer<DPPItemConstraint>* row_constraints) const {
+  const Int num_rows = matrix_.NumRows();
+  row_constraints->Resize(num_rows, kFreeItem);
+  auto impose = [&](const std::vector<Int>& items,
+                    DPPItemConstraint constraint) {
+    for (const Int& item : items) {
+      CATAMARI_ASSERT(item >= 0 && item < num_rows,
+                      "Constrained item was out of bounds.");
+      const Int row =
+          ordering_.permutation.Empty() ? item : ordering_.permutation[item];
+      CATAMARI_ASSERT((*row_constraints)[row] == kFreeItem ||
+                          (*row_constraints)[row] == constraint,
+                      "Item was both included and excluded.");
+      (*row_constraints)[row] = constraint;
     }
-#endif
-    return RightLookingSample(maximum_likelihood);
+  };
+  impose(constraints.included, kIncludedItem);
+  impose(constraints.excluded, kExcludedItem);
+}
+
+template <class Field>
+PhiloxEngine SupernodalHermitianDPP<Field>::SupernodeGenerator(
+    Int supernode, Int sample_index) const {
+  return PhiloxEngine(seed_, static_cast<std::uint32_t>(supernode),
+                      static_cast<std::uint32_t>(sample_index));
+}
+
+template <class Field>
+BlasMatrixView<Field> SupernodalHermitianDPP<Field>::PrivateBlock(
+    const BlasMatrixView<Field>& block, PrivateState* private_state) const {
+  if (private_state->factor_values.Empty()) {
+    return block;
   }
+  BlasMatrixView<Field> private_block = block;
+  private_block.data = private_state->factor_values.Data() +
+                       (block.data - factor_values_.Data());
+  return private_block;
 }
 
 template <typename Field>
@@ -7,7 +7,6 @@
  */
 #ifndef CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_COMMON_OPENMP_IMPL_H_
 #define CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_COMMON_OPENMP_IMPL_H_
-#ifdef CATAMARI_OPENMP
 
 #include <algorithm>
 
@@ -79,10 +78,7 @@ void SupernodalHermitianDPP<Field>::OpenMPFormStructure() {
   CATAMARI_ASSERT(supernode_degrees_.Size() == ordering_.supernode_sizes.Size(),
                   "Invalid supernode degrees size.");
 
-  lower_factor_.reset(new supernodal_ldl::LowerFactor<Field>(
-      ordering_.supernode_sizes, supernode_degrees_));
-  diagonal_factor_.reset(
-      new supernodal_ldl::DiagonalFactor<Field>(ordering_.supernode_sizes));
+  AllocateFactors();
 
   max_supernode_size_ = *std::max_element(ordering_.supernode_sizes.begin(),
                                           ordering_.supernode_sizes.end());
@@ -90,6 +86,7 @@ void SupernodalHermitianDPP<Field>::OpenMPFormStructure() {
   supernodal_ldl::OpenMPFillStructureIndices(
       control_.sort_grain_size, matrix_, ordering_, supernode_member_to_index_,
       lower_factor_.get());
+  MapChildrenIntoFronts();
 
   if (control_.algorithm == kLeftLookingLDL) {
     // TODO(Jack Poulson): Switch to a multithreaded equivalent.
@@ -132,5 +129,4 @@ void SupernodalHermitianDPP<Field>::OpenMPFormStructure() {
 
 }  // namespace catamari
 
-#endif  // ifdef CATAMARI_OPENMP
 #endif  // ifndef CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_COMMON_OPENMP_IMPL_H_
@@ -226,9 +226,15 @@ void SupernodalHermitianDPP<Field>::LeftLookingSupernodeSample(
   BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
 
   // Sample and factor the diagonal block.
-  const std::vector<Int> supernode_sample =
-      SampleLowerHermitianDPP(control_.block_size, maximum_likelihood,
-                              &diagonal_block, &private_state->generator);
+  PhiloxEngine generator =
+      SupernodeGenerator(supernode, private_state->sample_index);
+  const DPPItemConstraint* supernode_constraints =
+      private_state->constraints
+          ? private_state->constraints + ordering_.supernode_offsets[supernode]
+          : nullptr;
+  const std::vector<Int> supernode_sample = SampleLowerHermitianDPP(
+      control_.block_size, maximum_likelihood, supernode_constraints,
+      &diagonal_block, &generator);
   AppendSupernodeSample(supernode, supernode_sample, sample);
 
   supernodal_ldl::SolveAgainstDiagonalBlock(
@@ -237,16 +243,12 @@ void SupernodalHermitianDPP<Field>::LeftLookingSupernodeSample(
 
 template <class Field>
 std::vector<Int> SupernodalHermitianDPP<Field>::LeftLookingSample(
-    bool maximum_likelihood) const {
+    bool maximum_likelihood, const DPPItemConstraint* constraints) const {
   const Int num_rows = ordering_.supernode_offsets.Back();
   const Int num_supernodes = ordering_.supernode_sizes.Size();
 
-  supernodal_ldl::FillZeros(ordering_, lower_factor_.get(),
-                            diagonal_factor_.get());
-
   // Initialize the factors with the input matrix.
-  supernodal_ldl::FillNonzeros(matrix_, ordering_, supernode_member_to_index_,
-                               lower_factor_.get(), diagonal_factor_.get());
+  InitializeFactors(/* multithreaded = */ false);
 
   std::vector<Int> sample;
   sample.reserve(num_rows);
@@ -259,15 +261,15 @@ std::vector<Int> SupernodalHermitianDPP<Field>::LeftLookingSample(
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-  std::random_device random_device;
   PrivateState private_state;
+  private_state.sample_index = num_samples_drawn_++;
+  private_state.constraints = constraints;
   private_state.ldl_state.pattern_flags.Resize(num_rows);
   private_state.ldl_state.relative_indices.Resize(num_rows);
   private_state.ldl_state.scaled_transpose_buffer.Resize(
       left_looking_scaled_transpose_size_, Field{0});
   private_state.ldl_state.workspace_buffer.Resize(left_looking_workspace_size_,
                                                   Field{0});
-  private_state.generator.seed(random_device());
 
   // Note that any postordering of the supernodal elimination forest suffices.
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
@@ -48,9 +48,11 @@ void SupernodalHermitianDPP<Field>::OpenMPLeftLookingSupernodeSample(
     const int thread = omp_get_thread_num();
     PrivateState& private_state = (*private_states)[thread];
     Buffer<Field>* buffer = &private_state.ldl_state.scaled_transpose_buffer;
+    PhiloxEngine generator =
+        SupernodeGenerator(main_supernode, private_state.sample_index);
     supernode_sample = OpenMPSampleLowerHermitianDPP(
         control_.factor_tile_size, control_.block_size, maximum_likelihood,
-        &main_diagonal_block, &private_state.generator, buffer);
+        &main_diagonal_block, &generator, buffer);
   }
   AppendSupernodeSample(main_supernode, supernode_sample, sample);
 
@@ -158,13 +160,8 @@ std::vector<Int> SupernodalHermitianDPP<Field>::OpenMPLeftLookingSample(
   const Int num_roots = ordering_.assembly_forest.roots.Size();
   const int max_threads = omp_get_max_threads();
 
-  supernodal_ldl::OpenMPFillZeros(ordering_, lower_factor_.get(),
-                                  diagonal_factor_.get());
-
   // Initialize the factors with the input matrix.
-  supernodal_ldl::OpenMPFillNonzeros(
-      matrix_, ordering_, supernode_member_to_index_, lower_factor_.get(),
-      diagonal_factor_.get());
+  InitializeFactors(/* multithreaded = */ true);
 
   std::vector<Int> sample;
   sample.reserve(num_rows);
@@ -179,7 +176,7 @@ std::vector<Int> SupernodalHermitianDPP<Field>::OpenMPLeftLookingSample(
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-  std::random_device random_device;
+  const Int sample_index = num_samples_drawn_++;
   Buffer<PrivateState> private_states(max_threads);
   for (PrivateState& private_state : private_states) {
     private_state.ldl_state.row_structure.Resize(num_supernodes);
@@ -188,7 +185,7 @@ std::vector<Int> SupernodalHermitianDPP<Field>::OpenMPLeftLookingSample(
         max_supernode_size_ * max_supernode_size_, Field{0});
     private_state.ldl_state.workspace_buffer.Resize(
         max_supernode_size_ * (max_supernode_size_ - 1), Field{0});
-    private_state.generator.seed(random_device());
+    private_state.sample_index = sample_index;
   }
 
   if (total_work_ < min_parallel_work_) {
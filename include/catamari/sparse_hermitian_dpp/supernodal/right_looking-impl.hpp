@@ -22,30 +22,25 @@ void SupernodalHermitianDPP<Field>::RightLookingSupernodeSample(
     Int supernode, bool maximum_likelihood,
     supernodal_ldl::RightLookingSharedState<Field>* shared_state,
     PrivateState* private_state, std::vector<Int>* sample) const {
-  BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
-  BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+  BlasMatrixView<Field> diagonal_block =
+      PrivateBlock(diagonal_factor_->blocks[supernode], private_state);
+  BlasMatrixView<Field> lower_block =
+      PrivateBlock(lower_factor_->blocks[supernode], private_state);
   const Int degree = lower_block.height;
   const Int supernode_size = lower_block.width;
-
-  // Initialize this supernode's Schur complement as the zero matrix.
-  Buffer<Field>& schur_complement_buffer =
-      shared_state->schur_complement_buffers[supernode];
-  BlasMatrixView<Field>& schur_complement =
-      shared_state->schur_complements[supernode];
-  schur_complement_buffer.Resize(degree * degree, Field{0});
-  schur_complement.height = degree;
-  schur_complement.width = degree;
-  schur_complement.leading_dim = degree;
-  schur_complement.data = schur_complement_buffer.Data();
-
-  supernodal_ldl::MergeChildSchurComplements(
-      supernode, ordering_, lower_factor_.get(), diagonal_factor_.get(),
-      shared_state);
+  const bool has_children =
+      ordering_.assembly_forest.NumChildren(supernode) > 0;
 
   // Sample and factor the diagonal block.
-  const std::vector<Int> supernode_sample =
-      SampleLowerHermitianDPP(control_.block_size, maximum_likelihood,
-                              &diagonal_block, &private_state->generator);
+  PhiloxEngine generator =
+      SupernodeGenerator(supernode, private_state->sample_index);
+  const DPPItemConstraint* supernode_constraints =
+      private_state->constraints
+          ? private_state->constraints + ordering_.supernode_offsets[supernode]
+          : nullptr;
+  const std::vector<Int> supernode_sample = SampleLowerHermitianDPP(
+      control_.block_size, maximum_likelihood, supernode_constraints,
+      &diagonal_block, &generator);
   AppendSupernodeSample(supernode, supernode_sample, sample);
 
   if (!degree) {
@@ -59,7 +54,12 @@ void SupernodalHermitianDPP<Field>::RightLookingSupernodeSample(
   supernodal_ldl::SolveAgainstDiagonalBlock(
       factorization_type, diagonal_block.ToConst(), &lower_block);
 
-  Buffer<Field> scaled_transpose_buffer(degree * supernode_size);
+  // Reuse the private scaled transpose buffer across supernodes.
+  Buffer<Field>& scaled_transpose_buffer =
+      private_state->ldl_state.scaled_transpose_buffer;
+  if (scaled_transpose_buffer.Size() < degree * supernode_size) {
+    scaled_transpose_buffer.Resize(degree * supernode_size);
+  }
   BlasMatrixView<Field> scaled_transpose;
   scaled_transpose.height = supernode_size;
   scaled_transpose.width = degree;
@@ -69,77 +69,106 @@ void SupernodalHermitianDPP<Field>::RightLookingSupernodeSample(
                                       diagonal_block.ToConst(),
                                       lower_block.ToConst(), &scaled_transpose);
 
-  MatrixMultiplyLowerNormalNormal(Field{-1}, lower_block.ToConst(),
-                                  scaled_transpose.ToConst(), Field{1},
-                                  &schur_complement);
+  // The Schur complement of a supernode without children has not been
+  // initialized, so it is overwritten rather than updated.
+  MatrixMultiplyLowerNormalNormal(
+      Field{-1}, lower_block.ToConst(), scaled_transpose.ToConst(),
+      has_children ? Field{1} : Field{0},
+      &shared_state->schur_complements[supernode]);
 }
 
 template <class Field>
 void SupernodalHermitianDPP<Field>::RightLookingSubtree(
     Int supernode, bool maximum_likelihood,
     supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-    PrivateState* private_state, std::vector<Int>* sample) const {
+    PrivateState* private_state,
+    supernodal_ldl::SchurComplementStorage<Field>* subtree_storage,
+    std::vector<Int>* sample) const {
   const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
   const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
 
   CATAMARI_START_TIMER(shared_state->inclusive_timers[supernode]);
 
+  // Push this supernode's Schur complement beneath those of its children so
+  // that each child's can be popped as soon as it is merged.
+  BlasMatrixView<Field> lower_block =
+      PrivateBlock(lower_factor_->blocks[supernode], private_state);
+  BlasMatrixView<Field> diagonal_block =
+      PrivateBlock(diagonal_factor_->blocks[supernode], private_state);
+  shared_state->schur_complements[supernode] =
+      subtree_storage->push(lower_block.height);
+
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
         ordering_.assembly_forest.children[child_beg + child_index];
     CATAMARI_ASSERT(ordering_.assembly_forest.parents[child] == supernode,
                     "Incorrect child index");
     RightLookingSubtree(child, maximum_likelihood, shared_state, private_state,
-                        sample);
+                        subtree_storage, sample);
+
+    BlasMatrixView<Field>& child_schur_complement =
+        shared_state->schur_complements[child];
+    supernodal_ldl::MergeChildSchurComplement(
+        supernode, child, ordering_, lower_factor_.get(),
+        child_schur_complement, lower_block, diagonal_block,
+        shared_state->schur_complements[supernode],
+        /* freshShurComplement = */ child_index == 0);
+    subtree_storage->free(child_schur_complement);
   }
 
   CATAMARI_START_TIMER(shared_state->exclusive_timers[supernode]);
 
-  std::vector<Int> subsample;
   RightLookingSupernodeSample(supernode, maximum_likelihood, shared_state,
-                              private_state, &subsample);
-  sample->insert(sample->end(), subsample.begin(), subsample.end());
+                              private_state, sample);
 
   CATAMARI_STOP_TIMER(shared_state->inclusive_timers[supernode]);
   CATAMARI_STOP_TIMER(shared_state->exclusive_timers[supernode]);
 }
 
+template <class Field>
+void SupernodalHermitianDPP<Field>::RightLookingForest(
+    bool maximum_likelihood,
+    supernodal_ldl::RightLookingSharedState<Field>* shared_state,
+    PrivateState* private_state, std::vector<Int>* sample) const {
+  for (const Int& root : ordering_.assembly_forest.roots) {
+    supernodal_ldl::SchurComplementStorage<Field>& storage =
+        shared_state->schur_complement_storage[root];
+    storage.reallocate(storage.getStoragedNeeded(
+        root, ordering_.assembly_forest, *lower_factor_));
+    RightLookingSubtree(root, maximum_likelihood, shared_state, private_state,
+                        &storage, sample);
+    storage.deallocate();
+  }
+}
+
 template <class Field>
 std::vector<Int> SupernodalHermitianDPP<Field>::RightLookingSample(
-    bool maximum_likelihood) const {
+    bool maximum_likelihood, const DPPItemConstraint* constraints) const {
   const Int num_rows = matrix_.NumRows();
   const Int num_supernodes = ordering_.supernode_sizes.Size();
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
-
-  supernodal_ldl::FillZeros(ordering_, lower_factor_.get(),
-                            diagonal_factor_.get());
 
   // Initialize the factors with the input matrix.
-  supernodal_ldl::FillNonzeros(matrix_, ordering_, supernode_member_to_index_,
-                               lower_factor_.get(), diagonal_factor_.get());
+  InitializeFactors(/* multithreaded = */ false);
 
   std::vector<Int> sample;
   sample.reserve(num_rows);
 
   supernodal_ldl::RightLookingSharedState<Field> shared_state;
-  shared_state.schur_complement_buffers.Resize(num_supernodes);
   shared_state.schur_complements.Resize(num_supernodes);
+  shared_state.schur_complement_storage.Resize(num_supernodes);
 #ifdef CATAMARI_ENABLE_TIMERS
   shared_state.inclusive_timers.Resize(num_supernodes);
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-  // We only need the random number generator.
-  std::random_device random_device;
+  // We only need the index of the sample and its constraints.
   PrivateState private_state;
-  private_state.generator.seed(random_device());
+  private_state.sample_index = num_samples_drawn_++;
+  private_state.constraints = constraints;
 
-  for (Int root_index = 0; root_index < num_roots; ++root_index) {
-    const Int root = ordering_.assembly_forest.roots[root_index];
-    RightLookingSubtree(root, maximum_likelihood, &shared_state, &private_state,
-                        &sample);
-  }
+  RightLookingForest(maximum_likelihood, &shared_state, &private_state,
+                     &sample);
 
   std::sort(sample.begin(), sample.end());
 
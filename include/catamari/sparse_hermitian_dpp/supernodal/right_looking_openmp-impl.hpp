@@ -7,10 +7,12 @@
  */
 #ifndef CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_RIGHT_LOOKING_OPENMP_IMPL_H_
 #define CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_RIGHT_LOOKING_OPENMP_IMPL_H_
-#ifdef CATAMARI_OPENMP
 
 #include <algorithm>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
 #include "catamari/dense_dpp.hpp"
 #include "catamari/io_utils.hpp"
 
@@ -18,115 +20,62 @@
 
 namespace catamari {
 
-template <class Field>
-void SupernodalHermitianDPP<Field>::OpenMPRightLookingSupernodeSample(
-    Int supernode, bool maximum_likelihood,
-    supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-    Buffer<PrivateState>* private_states, std::vector<Int>* sample) const {
-  BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
-  BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
-  const Int degree = lower_block.height;
-  const Int supernode_size = lower_block.width;
-
-  // Initialize this supernode's Schur complement as the zero matrix.
-  Buffer<Field>& schur_complement_buffer =
-      shared_state->schur_complement_buffers[supernode];
-  BlasMatrixView<Field>& schur_complement =
-      shared_state->schur_complements[supernode];
-  schur_complement_buffer.Resize(degree * degree, Field{0});
-  schur_complement.height = degree;
-  schur_complement.width = degree;
-  schur_complement.leading_dim = degree;
-  schur_complement.data = schur_complement_buffer.Data();
-
-  supernodal_ldl::OpenMPMergeChildSchurComplements(
-      control_.merge_grain_size, supernode, ordering_, lower_factor_.get(),
-      diagonal_factor_.get(), shared_state);
-
-  // Sample and factor the diagonal block.
-  std::vector<Int> supernode_sample;
-  #pragma omp taskgroup
-  {
-    const int thread = omp_get_thread_num();
-    PrivateState& private_state = (*private_states)[thread];
-    Buffer<Field>* buffer = &private_state.ldl_state.scaled_transpose_buffer;
-    supernode_sample = OpenMPSampleLowerHermitianDPP(
-        control_.factor_tile_size, control_.block_size, maximum_likelihood,
-        &diagonal_block, &private_state.generator, buffer);
-  }
-  AppendSupernodeSample(supernode, supernode_sample, sample);
-
-  if (!degree) {
-    // We can early exit.
-    return;
-  }
-
-  CATAMARI_ASSERT(supernode_size > 0, "Supernode size was non-positive.");
-  const SymmetricFactorizationType factorization_type =
-      kLDLAdjointFactorization;
-  #pragma omp taskgroup
-  supernodal_ldl::OpenMPSolveAgainstDiagonalBlock(
-      control_.outer_product_tile_size, factorization_type,
-      diagonal_block.ToConst(), &lower_block);
-
-  // TODO(Jack Poulson): See if this can be pre-allocated.
-  Buffer<Field> scaled_transpose_buffer(degree * supernode_size);
-  BlasMatrixView<Field> scaled_transpose;
-  scaled_transpose.height = supernode_size;
-  scaled_transpose.width = degree;
-  scaled_transpose.leading_dim = supernode_size;
-  scaled_transpose.data = scaled_transpose_buffer.Data();
-
-  #pragma omp taskgroup
-  supernodal_ldl::OpenMPFormScaledTranspose(
-      control_.outer_product_tile_size, factorization_type,
-      diagonal_block.ToConst(), lower_block.ToConst(), &scaled_transpose);
-
-  #pragma omp taskgroup
-  OpenMPMatrixMultiplyLowerNormalNormal(
-      control_.outer_product_tile_size, Field{-1}, lower_block.ToConst(),
-      scaled_transpose.ToConst(), Field{1}, &schur_complement);
-}
-
 template <class Field>
 void SupernodalHermitianDPP<Field>::OpenMPRightLookingSubtree(
     Int supernode, bool maximum_likelihood,
     supernodal_ldl::RightLookingSharedState<Field>* shared_state,
-    Buffer<PrivateState>* private_states, std::vector<Int>* sample) const {
+    PrivateStates* private_states,
+    supernodal_ldl::SchurComplementStorage<Field>* subtree_storage,
+    std::vector<Int>* sample) const {
+  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int num_children = child_end - child_beg;
+
   const double work_estimate = work_estimates_[supernode];
-  if (work_estimate < min_parallel_work_) {
-    const int thread = omp_get_thread_num();
-    PrivateState& private_state = (*private_states)[thread];
+  const bool parallel =
+      (work_estimate >= min_parallel_work_) && (num_children > 1);
+  if (!parallel) {
+    // Construct a stack for holding the Schur complements of the subtree
+    // rooted at 'supernode' (if it doesn't exist already). It is deallocated
+    // by the parent of the serial subtree root once merged.
+    if (subtree_storage == nullptr) {
+      subtree_storage = &shared_state->schur_complement_storage[supernode];
+      subtree_storage->reallocate(subtree_storage->getStoragedNeeded(
+          supernode, ordering_.assembly_forest, *lower_factor_));
+    }
     RightLookingSubtree(supernode, maximum_likelihood, shared_state,
-                        &private_state, sample);
+                        &private_states->local(), subtree_storage, sample);
     return;
   }
-
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
-  const Int num_children = child_end - child_beg;
+  CATAMARI_ASSERT(subtree_storage == nullptr,
+                  "Parallel subtrees cannot be nested in serial subtrees.");
 
   CATAMARI_START_TIMER(shared_state->inclusive_timers[supernode]);
 
+  // Spawn all but the first child, which is processed by this thread (so
+  // that the highest-priority child starts immediately).
+  //
   // NOTE: We could alternatively avoid switch to maintaining a single, shared
   // boolean list of length 'num_rows' which flags each entry as 'in' or
   // 'out' of the sample.
   Buffer<std::vector<Int>> subsamples(num_children);
-
-  #pragma omp taskgroup
-  for (Int child_index = 0; child_index < num_children; ++child_index) {
+  tbb::task_group tg;
+  for (Int child_index = 1; child_index < num_children; ++child_index) {
     const Int child =
         ordering_.assembly_forest.children[child_beg + child_index];
     CATAMARI_ASSERT(ordering_.assembly_forest.parents[child] == supernode,
                     "Incorrect child index");
     std::vector<Int>* subsample = &subsamples[child_index];
-
-    #pragma omp task default(none)                         \
-        firstprivate(child, maximum_likelihood, subsample) \
-        shared(shared_state, private_states)
-    OpenMPRightLookingSubtree(child, maximum_likelihood, shared_state,
-                              private_states, subsample);
+    tg.run([this, child, maximum_likelihood, shared_state, private_states,
+            subsample]() {
+      OpenMPRightLookingSubtree(child, maximum_likelihood, shared_state,
+                                private_states, nullptr, subsample);
+    });
   }
+  OpenMPRightLookingSubtree(ordering_.assembly_forest.children[child_beg],
+                            maximum_likelihood, shared_state, private_states,
+                            nullptr, &subsamples[0]);
+  tg.wait();
 
   CATAMARI_START_TIMER(shared_state->exclusive_timers[supernode]);
 
@@ -135,11 +84,30 @@ void SupernodalHermitianDPP<Field>::OpenMPRightLookingSubtree(
     sample->insert(sample->end(), subsample.begin(), subsample.end());
   }
 
-  std::vector<Int> subsample;
-  #pragma omp taskgroup
-  OpenMPRightLookingSupernodeSample(supernode, maximum_likelihood, shared_state,
-                                    private_states, &subsample);
-  sample->insert(sample->end(), subsample.begin(), subsample.end());
+  // Assemble the front from the children's Schur complements, then clear out
+  // all of the storage used by the children's subtrees.
+  BlasMatrixView<Field> lower_block = lower_factor_->blocks[supernode];
+  BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
+  BlasMatrixView<Field>& schur_complement =
+      shared_state->schur_complements[supernode];
+  schur_complement = shared_state->schur_complement_storage[supernode]
+                         .allocateSingleMatrixForDegree(lower_block.height);
+  for (Int child_index = 0; child_index < num_children; ++child_index) {
+    const Int child =
+        ordering_.assembly_forest.children[child_beg + child_index];
+    BlasMatrixView<Field>& child_schur_complement =
+        shared_state->schur_complements[child];
+    supernodal_ldl::MergeChildSchurComplement(
+        supernode, child, ordering_, lower_factor_.get(),
+        child_schur_complement, lower_block, diagonal_block, schur_complement,
+        /* freshShurComplement = */ child_index == 0);
+    child_schur_complement.width = child_schur_complement.height = 0;
+    child_schur_complement.data = nullptr;
+    shared_state->schur_complement_storage[child].deallocate();
+  }
+
+  RightLookingSupernodeSample(supernode, maximum_likelihood, shared_state,
+                              &private_states->local(), sample);
 
   CATAMARI_STOP_TIMER(shared_state->inclusive_timers[supernode]);
   CATAMARI_STOP_TIMER(shared_state->exclusive_timers[supernode]);
@@ -147,84 +115,67 @@ void SupernodalHermitianDPP<Field>::OpenMPRightLookingSubtree(
 
 template <class Field>
 std::vector<Int> SupernodalHermitianDPP<Field>::OpenMPRightLookingSample(
-    bool maximum_likelihood) const {
+    bool maximum_likelihood, const DPPItemConstraint* constraints) const {
+  if (total_work_ < min_parallel_work_) {
+    return RightLookingSample(maximum_likelihood, constraints);
+  }
+
   const Int num_rows = matrix_.NumRows();
   const Int num_supernodes = ordering_.supernode_sizes.Size();
   const Int num_roots = ordering_.assembly_forest.roots.Size();
 
-  supernodal_ldl::OpenMPFillZeros(ordering_, lower_factor_.get(),
-                                  diagonal_factor_.get());
-
   // Initialize the factors with the input matrix.
-  supernodal_ldl::OpenMPFillNonzeros(
-      matrix_, ordering_, supernode_member_to_index_, lower_factor_.get(),
-      diagonal_factor_.get());
+  InitializeFactors(/* multithreaded = */ true);
 
   std::vector<Int> sample;
   sample.reserve(num_rows);
 
   supernodal_ldl::RightLookingSharedState<Field> shared_state;
-  shared_state.schur_complement_buffers.Resize(num_supernodes);
   shared_state.schur_complements.Resize(num_supernodes);
+  shared_state.schur_complement_storage.Resize(num_supernodes);
 #ifdef CATAMARI_ENABLE_TIMERS
   shared_state.inclusive_timers.Resize(num_supernodes);
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-  const int max_threads = omp_get_max_threads();
-
-  if (total_work_ < min_parallel_work_) {
-    // We only need the random number generator.
-    std::random_device random_device;
-    PrivateState private_state;
-    // TODO(Jack Poulson): Use RUNNING_ON_VALGRIND to change seeding
-    // mechanism.
-    private_state.generator.seed(random_device());
-
-    for (Int root_index = 0; root_index < num_roots; ++root_index) {
-      const Int root = ordering_.assembly_forest.roots[root_index];
-      RightLookingSubtree(root, maximum_likelihood, &shared_state,
-                          &private_state, &sample);
-    }
-  } else {
-    std::random_device random_device;
-    Buffer<PrivateState> private_states(max_threads);
-    for (PrivateState& private_state : private_states) {
-      private_state.ldl_state.scaled_transpose_buffer.Resize(
-          max_supernode_size_ * max_supernode_size_, Field{0});
-      // TODO(Jack Poulson): Use RUNNING_ON_VALGRIND to change seeding
-      // mechanism.
-      private_state.generator.seed(random_device());
-    }
+  // The random number streams are keyed by the supernode rather than the
+  // thread, so the threads only share the index of the sample (and its
+  // constraints).
+  PrivateState exemplar_state;
+  exemplar_state.sample_index = num_samples_drawn_++;
+  exemplar_state.constraints = constraints;
+  PrivateStates private_states(exemplar_state);
 
-    const int old_max_threads = GetMaxBlasThreads();
-    SetNumBlasThreads(1);
-
-    // NOTE: We could alternatively avoid switch to maintaining a single, shared
-    // boolean list of length 'num_rows' which flags each entry as 'in' or
-    // 'out' of the sample.
-    Buffer<std::vector<Int>> subsamples(num_roots);
-
-    #pragma omp parallel
-    #pragma omp single
-    for (Int root_index = 0; root_index < num_roots; ++root_index) {
-      const Int root = ordering_.assembly_forest.roots[root_index];
-      std::vector<Int>* subsample = &subsamples[root_index];
-      #pragma omp task default(none)                         \
-          firstprivate(root, maximum_likelihood, subsample)  \
-          shared(shared_state, private_states)
-      OpenMPRightLookingSubtree(root, maximum_likelihood, &shared_state,
-                                &private_states, subsample);
-    }
+  const int old_max_threads = GetMaxBlasThreads();
+  SetNumBlasThreads(1);
 
-    // Merge the subsamples into the current sample.
-    for (const std::vector<Int>& subsample : subsamples) {
-      sample.insert(sample.end(), subsample.begin(), subsample.end());
-    }
+  // NOTE: We could alternatively avoid switch to maintaining a single, shared
+  // boolean list of length 'num_rows' which flags each entry as 'in' or
+  // 'out' of the sample.
+  Buffer<std::vector<Int>> subsamples(num_roots);
+
+  auto process_root = [&](Int root_index) {
+    const Int root = ordering_.assembly_forest.roots[root_index];
+    OpenMPRightLookingSubtree(root, maximum_likelihood, &shared_state,
+                              &private_states, nullptr,
+                              &subsamples[root_index]);
+    shared_state.schur_complement_storage[root].deallocate();
+  };
+
+  tbb::task_group tg;
+  for (Int root_index = 0; root_index < num_roots - 1; ++root_index) {
+    tg.run([&process_root, root_index]() { process_root(root_index); });
+  }
+  if (num_roots > 0) process_root(num_roots - 1);
+  tg.wait();
 
-    SetNumBlasThreads(old_max_threads);
+  // Merge the subsamples into the current sample.
+  for (const std::vector<Int>& subsample : subsamples) {
+    sample.insert(sample.end(), subsample.begin(), subsample.end());
   }
 
+  SetNumBlasThreads(old_max_threads);
+
   std::sort(sample.begin(), sample.end());
 
 #ifdef CATAMARI_ENABLE_TIMERS
@@ -241,8 +192,71 @@ std::vector<Int> SupernodalHermitianDPP<Field>::OpenMPRightLookingSample(
   return sample;
 }
 
+template <class Field>
+std::vector<std::vector<Int>> SupernodalHermitianDPP<Field>::SampleMany(
+    Int num_samples, bool maximum_likelihood) const {
+  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  std::vector<std::vector<Int>> samples(num_samples);
+  if (num_samples <= 0) {
+    return samples;
+  }
+
+  // Each sample begins from the input matrix loaded into the factor. Build
+  // it in the shared storage and swap it out, so that the factor from the
+  // last call to 'Sample' is kept.
+  Buffer<Field> initial_values = factor_values_.data;
+  InitializeFactors(/* multithreaded = */ get_max_num_tbb_threads() > 1);
+  std::swap_ranges(factor_values_.data.begin(), factor_values_.data.end(),
+                   initial_values.begin());
+
+  // Every thread reuses its Schur complement stacks and factor copy across
+  // the samples it draws.
+  tbb::enumerable_thread_specific<SampleManyWorkspace> workspaces;
+
+  // The samples take the next 'num_samples' indices, in order, so that they
+  // match those of as many calls to 'Sample'.
+  const Int first_sample_index = num_samples_drawn_;
+  num_samples_drawn_ += num_samples;
+
+  const int old_max_threads = GetMaxBlasThreads();
+  SetNumBlasThreads(1);
+
+  tbb::parallel_for(Int(0), num_samples, [&](Int sample_index) {
+    SampleManyWorkspace& workspace = workspaces.local();
+    supernodal_ldl::RightLookingSharedState<Field>& shared_state =
+        workspace.shared_state;
+    if (shared_state.schur_complements.Size() != num_supernodes) {
+      shared_state.schur_complements.Resize(num_supernodes);
+      shared_state.schur_complement_storage.Resize(num_supernodes);
+      for (auto& storage : shared_state.schur_complement_storage) {
+        storage.setPersistent(true);
+      }
+#ifdef CATAMARI_ENABLE_TIMERS
+      shared_state.inclusive_timers.Resize(num_supernodes);
+      shared_state.exclusive_timers.Resize(num_supernodes);
+#endif  // ifdef CATAMARI_ENABLE_TIMERS
+    }
+
+    PrivateState& private_state = workspace.private_state;
+    if (private_state.factor_values.Size() != initial_values.Size()) {
+      private_state.factor_values.Resize(initial_values.Size());
+    }
+    std::copy(initial_values.begin(), initial_values.end(),
+              private_state.factor_values.begin());
+    private_state.sample_index = first_sample_index + sample_index;
+
+    std::vector<Int>& sample = samples[sample_index];
+    RightLookingForest(maximum_likelihood, &shared_state, &private_state,
+                       &sample);
+    std::sort(sample.begin(), sample.end());
+  });
+
+  SetNumBlasThreads(old_max_threads);
+
+  return samples;
+}
+
 }  // namespace catamari
 
-#endif  // ifdef CATAMARI_OPENMP
 #endif  // ifndef
         // CATAMARI_SPARSE_HERMITIAN_DPP_SUPERNODAL_RIGHT_LOOKING_OPENMP_IMPL_H_
@@ -7,19 +7,189 @@
 #ifndef CATAMARI_SPARSE_LDL_IMPL_H_
 #define CATAMARI_SPARSE_LDL_IMPL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
 
 #include "catamari/apply_sparse.hpp"
 #include "catamari/blas_matrix.hpp"
 #include "catamari/equilibrate_symmetric_matrix.hpp"
-#include "catamari/flush_to_zero.hpp"
+#include "catamari/norms.hpp"
 #include "catamari/refined_solve.hpp"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl.hpp"
 
 namespace catamari {
 
+namespace sparse_ldl {
+
+// Adds 'alpha' times the dynamic regularization of 'result', in either its
+// list or its diagonal form, applied to 'input' onto 'output'.
+template <class Field, class Scalar>
+void ApplyDynamicRegularization(const SparseLDLResult<Field>& result,
+                                Scalar alpha,
+                                const ConstBlasMatrixView<Scalar>& input,
+                                BlasMatrixView<Scalar>* output) {
+  typedef ComplexBase<Field> Real;
+  const Buffer<Real>& diagonal = result.dynamic_regularization_diagonal;
+  if (!diagonal.Empty()) {
+    for (Int j = 0; j < output->width; ++j) {
+      for (Int i = 0; i < output->height; ++i) {
+        const ComplexBase<Scalar> regularization = diagonal[i];
+        output->Entry(i, j) += alpha * regularization * input(i, j);
+      }
+    }
+    return;
+  }
+  for (const std::pair<Int, Real>& perturb : result.dynamic_regularization) {
+    const Int i = perturb.first;
+    const ComplexBase<Scalar> regularization = perturb.second;
+    for (Int j = 0; j < output->width; ++j) {
+      output->Entry(i, j) += alpha * regularization * input(i, j);
+    }
+  }
+}
+
+// The number of candidate reorderings of 'SelectReordering'.
+static constexpr Int kNumReorderingCandidates = 3;
+
+// Fills 'ordering' with the reordering, out of minimum degree and nested
+// dissections with the configured and with eight-times coarser leaves, which
+// is estimated to be the cheapest to factor with 'num_threads' threads, and
+// returns its estimate. The candidates are computed concurrently.
+template <class Field>
+ReorderingEstimate SelectReordering(const CoordinateMatrix<Field>& matrix,
+                                    const SparseLDLControl<Field>& control,
+                                    Int num_threads,
+                                    SymmetricOrdering* ordering) {
+  TraceScope trace_scope("SelectReordering");
+  std::vector<SymmetricOrdering> candidates(kNumReorderingCandidates);
+  std::vector<ReorderingEstimate> estimates(kNumReorderingCandidates);
+  const std::string names[kNumReorderingCandidates] = {
+      "minimum degree", "nested dissection", "coarse nested dissection"};
+
+  tbb::task_group group;
+  group.run([&]() {
+    quotient::QuotientGraph quotient_graph(matrix.NumRows(), matrix.Entries(),
+                                           control.md_control);
+    quotient::MinimumDegree(&quotient_graph);
+    quotient_graph.ComputePostorder(&candidates[0].inverse_permutation);
+    quotient::InvertPermutation(candidates[0].inverse_permutation,
+                                &candidates[0].permutation);
+    estimates[0] = EstimateReordering(matrix, candidates[0]);
+  });
+  for (Int index = 1; index < kNumReorderingCandidates; ++index) {
+    group.run([&, index]() {
+      NestedDissectionControl nd_control = control.nd_control;
+      if (index == 2) {
+        nd_control.leaf_size *= 8;
+      }
+      NestedDissection(matrix, nd_control, &candidates[index]);
+      estimates[index] = EstimateReordering(matrix, candidates[index]);
+    });
+  }
+  group.wait();
+
+  Int best = 0;
+  for (Int index = 0; index < kNumReorderingCandidates; ++index) {
+    if (control.verbose) {
+      std::cout << "Reordering candidate " << names[index] << ": "
+                << estimates[index].num_flops << " flops, "
+                << estimates[index].critical_path_flops
+                << " critical-path flops, " << estimates[index].num_nonzeros
+                << " nonzeros" << std::endl;
+    }
+    if (estimates[index].Cost(num_threads) <
+        estimates[best].Cost(num_threads)) {
+      best = index;
+    }
+  }
+  if (control.verbose) {
+    std::cout << "Selected the " << names[best] << " reordering for "
+              << num_threads << " threads" << std::endl;
+  }
+  *ordering = std::move(candidates[best]);
+  return estimates[best];
+}
+
+// Returns the number of threads which an automatic reordering is selected for.
+template <class Field>
+Int ReorderingNumThreads(const SparseLDLControl<Field>& control) {
+  return control.reordering_num_threads > 0
+             ? control.reordering_num_threads
+             : Int(tbb::this_task_arena::max_concurrency());
+}
+
+}  // namespace sparse_ldl
+
+template <class Field>
+ReorderingEstimate EstimateReordering(const CoordinateMatrix<Field>& matrix,
+                                      const SymmetricOrdering& ordering) {
+  const Int num_rows = matrix.NumRows();
+  Buffer<Int> parents;
+  Buffer<Int> postorder;
+  Buffer<Int> degrees;
+  scalar_ldl::EliminationForest(matrix, ordering, &parents);
+  scalar_ldl::PostorderFromEliminationForest(parents, &postorder);
+  scalar_ldl::DegreesFromEliminationForest(matrix, ordering, parents,
+                                           postorder, &degrees);
+
+  Buffer<Int> num_children(num_rows, 0);
+  for (Int j = 0; j < num_rows; ++j) {
+    if (parents[j] >= 0) {
+      ++num_children[parents[j]];
+    }
+  }
+
+  // Each column is merged into the fundamental supernode of its predecessor
+  // if it is the only child of the column and their structures are nested.
+  // Since the parent of a column follows it, the paths through the forest can
+  // be accumulated in a single forward pass, one supernode at a time.
+  ReorderingEstimate estimate;
+  Buffer<double> path_flops(num_rows, 0.);
+  Int supernode_beg = 0;
+  double supernode_flops = 0;
+  for (Int j = 0; j < num_rows; ++j) {
+    const double degree = degrees[j];
+    const double column_flops = degree * degree + degree;
+    estimate.num_nonzeros += degree + 1;
+    estimate.num_flops += column_flops;
+    supernode_flops += column_flops;
+
+    const bool supernode_end =
+        j == num_rows - 1 || parents[j] != j + 1 ||
+        num_children[j + 1] != 1 || degrees[j] != degrees[j + 1] + 1;
+    if (!supernode_end) {
+      continue;
+    }
+    const Int supernode_size = j + 1 - supernode_beg;
+    double flops = 0;
+    for (Int i = supernode_beg; i <= j; ++i) {
+      flops = std::max(flops, path_flops[i]);
+    }
+    flops += supernode_flops / supernode_size;
+    if (parents[j] >= 0) {
+      path_flops[parents[j]] = std::max(path_flops[parents[j]], flops);
+    }
+    estimate.critical_path_flops =
+        std::max(estimate.critical_path_flops, flops);
+    supernode_beg = j + 1;
+    supernode_flops = 0;
+  }
+  return estimate;
+}
+
 template <class Field>
 SparseLDL<Field>::SparseLDL() {
   // Julian Panetta: we now apply the floating point settings only to the
@@ -34,19 +204,108 @@ SparseLDLResult<Field> SparseLDL<Field>::Factor(
     const CoordinateMatrix<Field>& matrix,
     const SparseLDLControl<Field>& control,
     bool symbolic_only) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("SparseLDL.Factor (no ordering)");
+  execution_context_ = control.execution_context;
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return Factor(matrix, control, symbolic_only); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return Factor(matrix, control, symbolic_only); });
+  }
+
+  if (control.block_size > 1) {
+    return FactorBlocks(matrix, control, symbolic_only);
+  }
+
+  OrderingCache::Key cache_key;
+  if (control.cache_orderings) {
+    cache_key.fingerprint = PatternFingerprint(matrix);
+    cache_key.reordering_strategy = control.reordering_strategy;
+    if (control.reordering_strategy == kAutomaticReordering) {
+      cache_key.num_threads = sparse_ldl::ReorderingNumThreads(control);
+    }
+    CachedOrdering cached;
+    if (OrderingCache::Global().Lookup(cache_key, &cached)) {
+      SparseLDLControl<Field> cached_control = control;
+      if (control.supernodal_strategy == kAdaptiveSupernodalStrategy) {
+        cached_control.supernodal_strategy = cached.supernodal
+                                                 ? kSupernodalFactorization
+                                                 : kScalarFactorization;
+      }
+      return Factor(matrix, cached.ordering, cached_control, symbolic_only);
+    }
+  }
+
+  if (control.reordering_strategy == kAutomaticReordering) {
+    CachedOrdering cached;
+    const ReorderingEstimate estimate = sparse_ldl::SelectReordering(
+        matrix, control, sparse_ldl::ReorderingNumThreads(control),
+        &cached.ordering);
+    const double intensity = estimate.num_flops / estimate.num_nonzeros;
+    cached.supernodal =
+        estimate.num_flops >= control.supernodal_flop_threshold &&
+        intensity >= control.supernodal_intensity_threshold;
+    if (control.cache_orderings) {
+      OrderingCache::Global().Insert(cache_key, cached);
+    }
+    SparseLDLControl<Field> selected_control = control;
+    if (control.supernodal_strategy == kAdaptiveSupernodalStrategy) {
+      selected_control.supernodal_strategy =
+          cached.supernodal ? kSupernodalFactorization : kScalarFactorization;
+    }
+    return Factor(matrix, cached.ordering, selected_control, symbolic_only);
+  }
+
+  if (control.reordering_strategy == kNestedDissectionReordering) {
+    CachedOrdering cached;
+    {
+      TraceScope trace_scope("NestedDissection");
+      NestedDissection(matrix, control.nd_control, &cached.ordering);
+    }
+    if (control.cache_orderings) {
+      OrderingCache::Global().Insert(cache_key, cached);
+    }
+    return Factor(matrix, cached.ordering, control, symbolic_only);
+  }
+
+  if (control.reordering_strategy == kParallelMinimumDegreeReordering) {
+    CachedOrdering cached;
+    {
+      TraceScope trace_scope("ParallelMinimumDegree");
+      ParallelMinimumDegree(matrix, control.pmd_control, &cached.ordering);
+    }
+    if (control.cache_orderings) {
+      OrderingCache::Global().Insert(cache_key, cached);
+    }
+    return Factor(matrix, cached.ordering, control, symbolic_only);
+  }
+
+  TraceScope trace_scope("SparseLDL.Factor (no ordering)");
   scalar_factorization.reset();
   supernodal_factorization.reset();
 
-  ScopedEnableFlushToZero scope_guard;
+  // Remove any dense rows from the graph to be reordered.
+  DenseRowPartition dense_partition;
+  const bool defer_dense_rows =
+      DetectDenseRows(matrix, control.dense_row_control, &dense_partition);
+  Buffer<MatrixEntry<Field>> sparse_entries;
+  if (defer_dense_rows) {
+    SparseRowEntries(matrix, dense_partition, &sparse_entries);
+  }
+  const Int num_reordered_rows = defer_dense_rows
+                                     ? dense_partition.sparse_rows.Size()
+                                     : matrix.NumRows();
 
 #ifdef CATAMARI_ENABLE_TIMERS
   quotient::Timer timer;
   timer.Start();
 #endif
   std::unique_ptr<quotient::QuotientGraph> quotient_graph(
-      new quotient::QuotientGraph(matrix.NumRows(), matrix.Entries(),
-                                  control.md_control));
+      new quotient::QuotientGraph(
+          num_reordered_rows,
+          defer_dense_rows ? sparse_entries : matrix.Entries(),
+          control.md_control));
   const quotient::MinimumDegreeResult analysis =
       quotient::MinimumDegree(quotient_graph.get());
 #ifdef QUOTIENT_ENABLE_TIMERS
@@ -74,26 +333,29 @@ SparseLDLResult<Field> SparseLDL<Field>::Factor(
   } else if (control.supernodal_strategy == kSupernodalFactorization) {
     is_supernodal = true;
   } else {
-    const double intensity =
-        analysis.num_cholesky_flops / analysis.num_cholesky_nonzeros;
-    is_supernodal =
-        analysis.num_cholesky_flops >= control.supernodal_flop_threshold &&
-        intensity >= control.supernodal_intensity_threshold;
+    double num_cholesky_flops = analysis.num_cholesky_flops;
+    double num_cholesky_nonzeros = analysis.num_cholesky_nonzeros;
+    if (defer_dense_rows) {
+      // Roughly account for the dense root supernode and the entries of the
+      // dense rows in the sparse columns.
+      const double num_dense = dense_partition.dense_rows.Size();
+      num_cholesky_flops += num_dense * num_dense * num_dense / 3;
+      num_cholesky_nonzeros += num_dense * (num_dense + 1) / 2;
+      for (const Int& row : dense_partition.dense_rows) {
+        num_cholesky_nonzeros +=
+            matrix.RowEntryOffset(row + 1) - matrix.RowEntryOffset(row);
+      }
+    }
+    const double intensity = num_cholesky_flops / num_cholesky_nonzeros;
+    is_supernodal = num_cholesky_flops >= control.supernodal_flop_threshold &&
+                    intensity >= control.supernodal_intensity_threshold;
   }
 
-  // Optionally equilibrate the matrix.
-  const CoordinateMatrix<Field>* matrix_to_factor;
+  // Optionally equilibrate the matrix (once the factorization is created).
   CoordinateMatrix<Field> equilibrated_matrix;
-  if (control.equilibrate) {
-    equilibrated_matrix = matrix;
-    EquilibrateSymmetricMatrix(&equilibrated_matrix, &equilibration_,
-                               control.verbose);
-    matrix_to_factor = &equilibrated_matrix;
-    have_equilibration_ = true;
-  } else {
-    matrix_to_factor = &matrix;
-    have_equilibration_ = false;
-  }
+  have_equilibration_ = control.equilibrate;
+  fused_equilibration_ = control.equilibrate && control.fuse_equilibration;
+  equilibration_control_ = control.equilibration_control;
 
   SparseLDLResult<Field> result;
   if (is_supernodal) {
@@ -113,33 +375,174 @@ SparseLDLResult<Field> SparseLDL<Field>::Factor(
     quotient_graph->PermutedSupernodeSizes(ordering.inverse_permutation,
                                            &ordering.supernode_sizes);
     OffsetScan(ordering.supernode_sizes, &ordering.supernode_offsets);
+    if (defer_dense_rows) {
+      AppendDenseRows(matrix, dense_partition, true, &ordering);
+    }
 #ifdef CATAMARI_ENABLE_TIMERS
     std::cout << "Ordering postprocessing: " << timer.Stop() << " seconds."
               << std::endl;
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
     quotient_graph.release();
+    if (control.cache_orderings) {
+      OrderingCache::Global().Insert(cache_key, CachedOrdering{ordering, true});
+    }
     supernodal_factorization.reset(new supernodal_ldl::Factorization<Field>);
-    result = supernodal_factorization->Factor(*matrix_to_factor, ordering,
-                                              control.supernodal_control,
-                                              symbolic_only);
+    const CoordinateMatrix<Field>* matrix_to_factor =
+        EquilibrateMatrix(matrix, control.verbose, &equilibrated_matrix);
+    result = FactorSupernodal(*matrix_to_factor, ordering, control,
+                              symbolic_only);
   } else {
     quotient_graph.release();
+    if (defer_dense_rows) {
+      AppendDenseRows(matrix, dense_partition, false, &ordering);
+    }
+    if (control.cache_orderings) {
+      OrderingCache::Global().Insert(cache_key,
+                                     CachedOrdering{ordering, false});
+    }
     scalar_factorization.reset(new scalar_ldl::Factorization<Field>);
+    const CoordinateMatrix<Field>* matrix_to_factor =
+        EquilibrateMatrix(matrix, control.verbose, &equilibrated_matrix);
     result = scalar_factorization->Factor(*matrix_to_factor, ordering,
-                                          control.scalar_control);
+                                          control.scalar_control,
+                                          symbolic_only);
+  }
+  EstimateAccuracy(&result);
+  UnequilibrateResult(&result);
+  if (defer_dense_rows) {
+    result.num_deferred_dense_rows = dense_partition.dense_rows.Size();
+    result.max_deferred_row_degree = dense_partition.max_dense_degree;
+  }
+  result.dense_row_degree_threshold = dense_partition.degree_threshold;
+  if (control.verbose && defer_dense_rows) {
+    std::cout << "Deferred " << result.num_deferred_dense_rows
+              << " dense rows (threshold " << result.dense_row_degree_threshold
+              << ", max degree " << result.max_deferred_row_degree << ")"
+              << std::endl;
   }
 
   return result;
 }
 
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::FactorBlocks(
+    const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control,
+    bool symbolic_only) {
+  TraceScope trace_scope("SparseLDL.FactorBlocks");
+  const Int block_size = control.block_size;
+  CoordinateMatrix<Field> block_graph;
+  FormBlockGraph(matrix, block_size, &block_graph);
+
+  // The rows of a node are only guaranteed to form a fundamental supernode
+  // if each of its couplings is dense.
+  CoordinateMatrix<Field> padded_matrix;
+  const CoordinateMatrix<Field>* blocked_matrix = &matrix;
+  if (block_graph.NumEntries() * block_size * block_size !=
+      matrix.NumEntries()) {
+    PadBlockPattern(matrix, block_graph, block_size, &padded_matrix);
+    blocked_matrix = &padded_matrix;
+  }
+
+  SparseLDLControl<Field> blocked_control = control;
+  blocked_control.block_size = 1;
+  OrderingCache::Key cache_key;
+  CachedOrdering cached;
+  if (control.cache_orderings) {
+    cache_key.fingerprint = PatternFingerprint(matrix);
+    cache_key.reordering_strategy = control.reordering_strategy;
+    cache_key.block_size = block_size;
+    if (control.reordering_strategy == kAutomaticReordering) {
+      cache_key.num_threads = sparse_ldl::ReorderingNumThreads(control);
+    }
+    if (OrderingCache::Global().Lookup(cache_key, &cached)) {
+      if (control.supernodal_strategy == kAdaptiveSupernodalStrategy) {
+        blocked_control.supernodal_strategy =
+            cached.supernodal ? kSupernodalFactorization
+                              : kScalarFactorization;
+      }
+      return Factor(*blocked_matrix, cached.ordering, blocked_control,
+                    symbolic_only);
+    }
+  }
+
+  SymmetricOrdering block_ordering;
+  if (control.reordering_strategy == kNestedDissectionReordering) {
+    TraceScope nd_trace_scope("NestedDissection");
+    NestedDissection(block_graph, control.nd_control, &block_ordering);
+    cached.supernodal = true;
+  } else if (control.reordering_strategy ==
+             kParallelMinimumDegreeReordering) {
+    TraceScope pmd_trace_scope("ParallelMinimumDegree");
+    ParallelMinimumDegree(block_graph, control.pmd_control, &block_ordering);
+    cached.supernodal = true;
+  } else if (control.reordering_strategy == kAutomaticReordering) {
+    const ReorderingEstimate estimate = sparse_ldl::SelectReordering(
+        block_graph, control, sparse_ldl::ReorderingNumThreads(control),
+        &block_ordering);
+
+    // As below, the estimate of the graph is scaled to dense blocks.
+    const double num_block_entries = block_size * block_size;
+    const double num_cholesky_flops =
+        estimate.num_flops * num_block_entries * block_size;
+    const double num_cholesky_nonzeros =
+        estimate.num_nonzeros * num_block_entries;
+    const double intensity = num_cholesky_flops / num_cholesky_nonzeros;
+    cached.supernodal =
+        num_cholesky_flops >= control.supernodal_flop_threshold &&
+        intensity >= control.supernodal_intensity_threshold;
+  } else {
+    // Dense rows are not deferred from the (already compressed) graph.
+    quotient::QuotientGraph quotient_graph(
+        block_graph.NumRows(), block_graph.Entries(), control.md_control);
+    const quotient::MinimumDegreeResult analysis =
+        quotient::MinimumDegree(&quotient_graph);
+    quotient_graph.ComputePostorder(&block_ordering.inverse_permutation);
+    quotient::InvertPermutation(block_ordering.inverse_permutation,
+                                &block_ordering.permutation);
+
+    // Each entry of the factor of the graph is a dense block, and each flop
+    // of its factorization is a product of dense blocks.
+    const double num_block_entries = block_size * block_size;
+    const double num_cholesky_flops =
+        analysis.num_cholesky_flops * num_block_entries * block_size;
+    const double num_cholesky_nonzeros =
+        analysis.num_cholesky_nonzeros * num_block_entries;
+    const double intensity = num_cholesky_flops / num_cholesky_nonzeros;
+    cached.supernodal =
+        num_cholesky_flops >= control.supernodal_flop_threshold &&
+        intensity >= control.supernodal_intensity_threshold;
+  }
+  ExpandBlockOrdering(block_ordering, block_size, &cached.ordering);
+  if (control.cache_orderings) {
+    OrderingCache::Global().Insert(cache_key, cached);
+  }
+
+  if (control.supernodal_strategy == kAdaptiveSupernodalStrategy) {
+    blocked_control.supernodal_strategy =
+        cached.supernodal ? kSupernodalFactorization : kScalarFactorization;
+  }
+  return Factor(*blocked_matrix, cached.ordering, blocked_control,
+                symbolic_only);
+}
+
 template <class Field>
 SparseLDLResult<Field> SparseLDL<Field>::Factor(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
     const SparseLDLControl<Field>& control,
     bool symbolic_only) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("SparseLDL.Factor");
-  ScopedEnableFlushToZero scope_guard;
+  execution_context_ = control.execution_context;
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return Factor(matrix, ordering, control, symbolic_only); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return Factor(matrix, ordering, control, symbolic_only); });
+  }
+
+  TraceScope trace_scope("SparseLDL.Factor");
   scalar_factorization.reset();
   supernodal_factorization.reset();
 
@@ -153,40 +556,201 @@ SparseLDLResult<Field> SparseLDL<Field>::Factor(
     is_supernodal = true;
   }
 
-  // Optionally equilibrate the matrix.
-  const CoordinateMatrix<Field>* matrix_to_factor;
+  // Optionally equilibrate the matrix (once the factorization is created).
   CoordinateMatrix<Field> equilibrated_matrix;
-  if (control.equilibrate) {
-    equilibrated_matrix = matrix;
-    EquilibrateSymmetricMatrix(&equilibrated_matrix, &equilibration_,
-                               control.verbose);
-    matrix_to_factor = &equilibrated_matrix;
-    have_equilibration_ = true;
-  } else {
-    matrix_to_factor = &matrix;
-    have_equilibration_ = false;
-  }
+  have_equilibration_ = control.equilibrate;
+  fused_equilibration_ = control.equilibrate && control.fuse_equilibration;
+  equilibration_control_ = control.equilibration_control;
 
   SparseLDLResult<Field> result;
   if (is_supernodal) {
     supernodal_factorization.reset(new supernodal_ldl::Factorization<Field>);
-    result = supernodal_factorization->Factor(*matrix_to_factor, ordering,
-                                              control.supernodal_control, symbolic_only);
+    const CoordinateMatrix<Field>* matrix_to_factor =
+        EquilibrateMatrix(matrix, control.verbose, &equilibrated_matrix);
+    result = FactorSupernodal(*matrix_to_factor, ordering, control,
+                              symbolic_only);
   } else {
     scalar_factorization.reset(new scalar_ldl::Factorization<Field>);
+    const CoordinateMatrix<Field>* matrix_to_factor =
+        EquilibrateMatrix(matrix, control.verbose, &equilibrated_matrix);
     result = scalar_factorization->Factor(*matrix_to_factor, ordering,
-                                          control.scalar_control);
+                                          control.scalar_control,
+                                          symbolic_only);
   }
-  if (have_equilibration_) {
-    // We factored inv(D) A inv(D), so the regularization needs to be wrapped
-    // with D . D.
-    for (std::pair<Int, Real>& reg : result.dynamic_regularization) {
-      reg.second *= equilibration_(reg.first) * equilibration_(reg.first);
+  EstimateAccuracy(&result);
+  UnequilibrateResult(&result);
+  return result;
+}
+
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::FactorAndSolve(
+    const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control,
+    BlasMatrixView<Field>* right_hand_sides) {
+  fused_right_hand_sides_ = right_hand_sides;
+  SparseLDLResult<Field> result;
+  try {
+    result = Factor(matrix, control);
+  } catch (...) {
+    fused_right_hand_sides_ = nullptr;
+    throw;
+  }
+  // Only a supernodal factorization takes over the solve.
+  const bool solved = fused_right_hand_sides_ == nullptr;
+  fused_right_hand_sides_ = nullptr;
+  if (!solved && result.num_successful_pivots == NumRows()) {
+    Solve(right_hand_sides);
+  }
+  return result;
+}
+
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::FactorAndSolve(
+    const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+    const SparseLDLControl<Field>& control,
+    BlasMatrixView<Field>* right_hand_sides) {
+  fused_right_hand_sides_ = right_hand_sides;
+  SparseLDLResult<Field> result;
+  try {
+    result = Factor(matrix, ordering, control);
+  } catch (...) {
+    fused_right_hand_sides_ = nullptr;
+    throw;
+  }
+  const bool solved = fused_right_hand_sides_ == nullptr;
+  fused_right_hand_sides_ = nullptr;
+  if (!solved && result.num_successful_pivots == NumRows()) {
+    Solve(right_hand_sides);
+  }
+  return result;
+}
+
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::FactorSupernodal(
+    const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+    const SparseLDLControl<Field>& control, bool symbolic_only) {
+  BlasMatrixView<Field>* right_hand_sides = fused_right_hand_sides_;
+  if (!right_hand_sides || symbolic_only) {
+    return supernodal_factorization->Factor(
+        matrix, ordering, control.supernodal_control, symbolic_only);
+  }
+  fused_right_hand_sides_ = nullptr;
+
+  // An equilibration which is not fused into the factorization is applied
+  // around the solve, as in 'Solve'.
+  const bool separate_equilibration =
+      have_equilibration_ && !fused_equilibration_;
+  if (separate_equilibration) {
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      for (Int i = 0; i < right_hand_sides->height; ++i) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+  const SparseLDLResult<Field> result =
+      supernodal_factorization->FactorAndSolve(
+          matrix, ordering, control.supernodal_control, right_hand_sides);
+  if (separate_equilibration &&
+      result.num_successful_pivots == matrix.NumRows()) {
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      for (Int i = 0; i < right_hand_sides->height; ++i) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
     }
   }
   return result;
 }
 
+template <class Field>
+const CoordinateMatrix<Field>* SparseLDL<Field>::EquilibrateMatrix(
+    const CoordinateMatrix<Field>& matrix, bool verbose,
+    CoordinateMatrix<Field>* equilibrated_matrix) {
+  if (!have_equilibration_) {
+    factored_max_norm_ = MaxNorm(matrix);
+    return &matrix;
+  }
+  if (!is_supernodal) {
+    fused_equilibration_ = false;
+  }
+  EquilibrationControl<Real> equilibration_control = equilibration_control_;
+  equilibration_control.verbose = verbose;
+  if (fused_equilibration_) {
+    ComputeSymmetricEquilibration(matrix, &equilibration_,
+                                  equilibration_control);
+    supernodal_factorization->SetInputScaling(equilibration_.data);
+
+    // The entries are only rescaled as they are loaded, so compute the max
+    // norm of the rescaled matrix on the fly.
+    factored_max_norm_ = 0;
+    for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+      factored_max_norm_ = std::max(
+          factored_max_norm_,
+          std::abs(entry.value) /
+              (equilibration_(entry.row) * equilibration_(entry.column)));
+    }
+    return &matrix;
+  }
+  *equilibrated_matrix = matrix;
+  EquilibrateSymmetricMatrix(equilibrated_matrix, &equilibration_,
+                             equilibration_control);
+  factored_max_norm_ = MaxNorm(*equilibrated_matrix);
+  return equilibrated_matrix;
+}
+
+template <class Field>
+void SparseLDL<Field>::EstimateAccuracy(SparseLDLResult<Field>* result) {
+  const Real epsilon = std::numeric_limits<Real>::epsilon();
+  backward_error_estimate_ = std::numeric_limits<Real>::infinity();
+  if (!is_supernodal || result->num_successful_pivots < NumRows() ||
+      factored_max_norm_ == Real(0)) {
+    return;
+  }
+  result->pivot_growth = result->largest_abs_pivot / factored_max_norm_;
+
+  // Dynamic regularization perturbs the factored matrix away from the one
+  // that the solutions are measured against.
+  Real max_regularization = 0;
+  for (const std::pair<Int, Real>& reg : result->dynamic_regularization) {
+    max_regularization = std::max(max_regularization, std::abs(reg.second));
+  }
+  for (const Real& reg : result->dynamic_regularization_diagonal) {
+    max_regularization = std::max(max_regularization, std::abs(reg));
+  }
+  backward_error_estimate_ =
+      epsilon * std::max(Real(1), result->pivot_growth) +
+      max_regularization / factored_max_norm_;
+}
+
+template <class Field>
+void SparseLDL<Field>::UnequilibrateResult(
+    SparseLDLResult<Field>* result) const {
+  if (!have_equilibration_) {
+    return;
+  }
+
+  // We factored inv(D) A inv(D), so the regularization needs to be wrapped
+  // with D . D.
+  for (std::pair<Int, Real>& reg : result->dynamic_regularization) {
+    reg.second *= equilibration_(reg.first) * equilibration_(reg.first);
+  }
+  Buffer<Real>& diagonal = result->dynamic_regularization_diagonal;
+  for (Int i = 0; i < diagonal.Size(); ++i) {
+    diagonal[i] *= equilibration_(i) * equilibration_(i);
+  }
+
+  // And det(A) = det(D)^2 det(inv(D) A inv(D)).
+  if (is_supernodal && result->num_successful_pivots == NumRows()) {
+    for (Int i = 0; i < equilibration_.Height(); ++i) {
+      result->log_abs_determinant += 2 * std::log(equilibration_(i));
+    }
+  }
+}
+
+template <class Field>
+ComplexBase<Field> SparseLDL<Field>::BackwardErrorEstimate() const {
+  return backward_error_estimate_;
+}
+
 template <class Field>
 Int SparseLDL<Field>::NumRows() const {
   if (is_supernodal) {
@@ -196,6 +760,13 @@ Int SparseLDL<Field>::NumRows() const {
   }
 }
 
+template <class Field>
+void SparseLDL<Field>::ReleaseWorkspace() {
+  if (is_supernodal && supernodal_factorization) {
+    supernodal_factorization->ReleaseWorkspace();
+  }
+}
+
 template <class Field>
 const Buffer<Int>& SparseLDL<Field>::Permutation() const {
   if (is_supernodal) {
@@ -214,6 +785,426 @@ const Buffer<Int>& SparseLDL<Field>::InversePermutation() const {
   }
 }
 
+template <class Field>
+supernodal_ldl::MemoryEstimate SparseLDL<Field>::EstimateMemory(
+    const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control, Int num_threads,
+    Int num_right_hand_sides) {
+  SparseLDLControl<Field> symbolic_control = control;
+  symbolic_control.supernodal_strategy = kSupernodalFactorization;
+  Factor(matrix, symbolic_control, /* symbolic_only = */ true);
+  return supernodal_factorization->EstimateMemory(num_threads,
+                                                  num_right_hand_sides);
+}
+
+template <class Field>
+supernodal_ldl::AnalysisReport SparseLDL<Field>::Analyze(
+    const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control, Int num_threads,
+    Int num_right_hand_sides) {
+  SparseLDLControl<Field> symbolic_control = control;
+  symbolic_control.supernodal_strategy = kSupernodalFactorization;
+  Factor(matrix, symbolic_control, /* symbolic_only = */ true);
+  return supernodal_factorization->Analyze(num_threads, num_right_hand_sides);
+}
+
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::FactorPartial(
+    const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+    Int num_interior, const SparseLDLControl<Field>& control,
+    BlasMatrix<Field>* schur_complement, bool symbolic_only) {
+  execution_context_ = control.execution_context;
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute([&]() {
+      return FactorPartial(matrix, ordering, num_interior, control,
+                           schur_complement, symbolic_only);
+    });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero([&]() {
+      return FactorPartial(matrix, ordering, num_interior, control,
+                           schur_complement, symbolic_only);
+    });
+  }
+
+  TraceScope trace_scope("SparseLDL.FactorPartial");
+  scalar_factorization.reset();
+  is_supernodal = true;
+
+  // Optionally equilibrate the matrix (once the factorization is created).
+  CoordinateMatrix<Field> equilibrated_matrix;
+  have_equilibration_ = control.equilibrate;
+  fused_equilibration_ = control.equilibrate && control.fuse_equilibration;
+  equilibration_control_ = control.equilibration_control;
+
+  supernodal_factorization.reset(new supernodal_ldl::Factorization<Field>);
+  const CoordinateMatrix<Field>* matrix_to_factor =
+      EquilibrateMatrix(matrix, control.verbose, &equilibrated_matrix);
+  SparseLDLResult<Field> result = supernodal_factorization->FactorPartial(
+      *matrix_to_factor, ordering, num_interior, control.supernodal_control,
+      nullptr, symbolic_only);
+  if (have_equilibration_) {
+    for (std::pair<Int, Real>& reg : result.dynamic_regularization) {
+      reg.second *= equilibration_(reg.first) * equilibration_(reg.first);
+    }
+    Buffer<Real>& diagonal = result.dynamic_regularization_diagonal;
+    for (Int i = 0; i < diagonal.Size(); ++i) {
+      diagonal[i] *= equilibration_(i) * equilibration_(i);
+    }
+  }
+  if (!symbolic_only && schur_complement &&
+      result.num_successful_pivots == num_interior) {
+    PartialSchurComplement(schur_complement);
+  }
+  return result;
+}
+
+template <class Field>
+void SparseLDL<Field>::PartialSchurComplement(
+    BlasMatrix<Field>* schur_complement) const {
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  supernodal_factorization->PartialSchurComplement(schur_complement);
+  if (have_equilibration_) {
+    // We factored inv(D) A inv(D), whose Schur complement onto the interface
+    // is inv(E) S inv(E), where E is the interface block of D.
+    const Buffer<Int>& inverse_permutation = InversePermutation();
+    const Int num_interface = schur_complement->Height();
+    const Int num_interior = NumRows() - num_interface;
+    Buffer<Real> scaling(num_interface);
+    for (Int i = 0; i < num_interface; ++i) {
+      const Int row = inverse_permutation.Empty()
+                          ? num_interior + i
+                          : inverse_permutation[num_interior + i];
+      scaling[i] = equilibration_(row);
+    }
+    for (Int j = 0; j < num_interface; ++j) {
+      for (Int i = 0; i < num_interface; ++i) {
+        (*schur_complement)(i, j) *= scaling[i] * scaling[j];
+      }
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::PartialForwardSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { PartialForwardSolve(right_hand_sides); });
+    return;
+  }
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() { PartialForwardSolve(right_hand_sides); });
+    return;
+  }
+  if (!have_equilibration_) {
+    supernodal_factorization->PartialForwardSolve(right_hand_sides);
+    return;
+  }
+
+  // We solve against inv(E) A inv(E), so the interface rows are scaled back
+  // by E to match the unscaled Schur complement.
+  const Int num_rows = right_hand_sides->height;
+  const Int num_interior = supernodal_factorization->NumInteriorRows();
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) /= equilibration_(i);
+    }
+  }
+  supernodal_factorization->PartialForwardSolve(right_hand_sides);
+  const Buffer<Int>& inverse_permutation = InversePermutation();
+  for (Int i = num_interior; i < num_rows; ++i) {
+    const Int row =
+        inverse_permutation.Empty() ? i : inverse_permutation[i];
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      right_hand_sides->Entry(row, j) *= equilibration_(row);
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::PartialBackwardSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { PartialBackwardSolve(right_hand_sides); });
+    return;
+  }
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() { PartialBackwardSolve(right_hand_sides); });
+    return;
+  }
+  if (!have_equilibration_) {
+    supernodal_factorization->PartialBackwardSolve(right_hand_sides);
+    return;
+  }
+
+  // Map the interface solution into the equilibrated space, back-substitute,
+  // and then undo the equilibration of every row.
+  const Int num_rows = right_hand_sides->height;
+  const Int num_interior = supernodal_factorization->NumInteriorRows();
+  const Buffer<Int>& inverse_permutation = InversePermutation();
+  for (Int i = num_interior; i < num_rows; ++i) {
+    const Int row =
+        inverse_permutation.Empty() ? i : inverse_permutation[i];
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      right_hand_sides->Entry(row, j) *= equilibration_(row);
+    }
+  }
+  supernodal_factorization->PartialBackwardSolve(right_hand_sides);
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) /= equilibration_(i);
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::Save(const std::string& filename,
+                            bool include_values) const {
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (include_values && have_equilibration_) {
+    throw std::runtime_error(
+        "The factor of an equilibrated matrix cannot be saved.");
+  }
+  supernodal_factorization->Save(filename, include_values);
+}
+
+template <class Field>
+bool SparseLDL<Field>::Load(const std::string& filename,
+                            const SparseLDLControl<Field>& control) {
+  auto factorization =
+      std::make_unique<supernodal_ldl::Factorization<Field>>();
+  const bool has_values =
+      factorization->Load(filename, control.supernodal_control);
+  if (has_values && control.equilibrate) {
+    throw std::runtime_error(
+        "The factor of an equilibrated matrix cannot be loaded.");
+  }
+  is_supernodal = true;
+  scalar_factorization.reset();
+  supernodal_factorization = std::move(factorization);
+  have_equilibration_ = control.equilibrate;
+  fused_equilibration_ = control.equilibrate && control.fuse_equilibration;
+  equilibration_control_ = control.equilibration_control;
+  execution_context_ = control.execution_context;
+  return has_values;
+}
+
+template <class Field>
+Int SparseLDL<Field>::RefactorWithShifts(
+    const ConversionPlan& cplan, const Field* Ax, const Buffer<Field>& sigmas,
+    const Field* Bx, Buffer<SparseLDLResult<Field>>* results) {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return RefactorWithShifts(cplan, Ax, sigmas, Bx, results); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return RefactorWithShifts(cplan, Ax, sigmas, Bx, results); });
+  }
+  TraceScope trace_scope("SparseLDL.RefactorWithShifts");
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  const Int num_rows = NumRows();
+  const Int num_shifts = sigmas.Size();
+  results->Resize(num_shifts);
+  if (!num_shifts) {
+    return -1;
+  }
+
+  // Every attempt shares the symbolic structure of this factorization, but
+  // has its own copy of the factor values.
+  std::vector<std::unique_ptr<supernodal_ldl::Factorization<Field>>> attempts(
+      num_shifts);
+  for (Int index = 1; index < num_shifts; ++index) {
+    attempts[index] = supernodal_factorization->Clone();
+  }
+  attempts[0] = std::move(supernodal_factorization);
+
+  // Only the attempts strictly between the largest failed shift and the
+  // smallest successful one can affect the outcome.
+  std::mutex mutex;
+  Int largest_failure = -1;
+  Int smallest_success = num_shifts;
+  auto needed = [&](Int index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return largest_failure < index && index < smallest_success;
+  };
+
+  auto attempt = [&](Int index) {
+    SparseLDLResult<Field>& result = (*results)[index];
+    if (!needed(index)) {
+      result.num_successful_pivots = -1;
+      return;
+    }
+    result = attempts[index]->RefactorWithFixedSparsityPattern(
+        cplan, Ax, sigmas[index], Bx);
+    if (result.cancelled) {
+      // A cancellation through the control's token says nothing of the shift.
+      result.num_successful_pivots = -1;
+      return;
+    }
+    const bool succeeded = result.num_successful_pivots == num_rows;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (succeeded) {
+      for (Int other = index + 1; other < smallest_success; ++other) {
+        attempts[other]->CancelFactorization();
+      }
+      smallest_success = std::min(smallest_success, index);
+    } else if (largest_failure < index && index < smallest_success) {
+      for (Int other = largest_failure + 1; other < index; ++other) {
+        attempts[other]->CancelFactorization();
+      }
+      largest_failure = index;
+    } else {
+      // The failure may have been due to a cancellation.
+      result.num_successful_pivots = -1;
+    }
+  };
+
+  tbb::task_group group;
+  for (Int index = 1; index < num_shifts; ++index) {
+    group.run([&attempt, index]() { attempt(index); });
+  }
+  attempt(0);
+  group.wait();
+
+  const bool succeeded = smallest_success < num_shifts;
+  supernodal_factorization =
+      std::move(attempts[succeeded ? smallest_success : num_shifts - 1]);
+  return succeeded ? smallest_success : -1;
+}
+
+template <class Field>
+void SparseLDL<Field>::ShiftedInertias(
+    const ConversionPlan& cplan, const Field* Ax, const Buffer<Field>& sigmas,
+    const Field* Bx, Buffer<SparseLDLResult<Field>>* results) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { ShiftedInertias(cplan, Ax, sigmas, Bx, results); });
+    return;
+  }
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero(
+        [&]() { ShiftedInertias(cplan, Ax, sigmas, Bx, results); });
+    return;
+  }
+  TraceScope trace_scope("SparseLDL.ShiftedInertias");
+  if (!is_supernodal) {
+    throw std::runtime_error("Implemented for supernodal only");
+  }
+  const Int num_shifts = sigmas.Size();
+  results->Resize(num_shifts);
+
+  // The copies of the factor values are recycled between shifts, so that
+  // only as many are formed as there are shifts being factored at once. Each
+  // shift takes its own copy out of the pool, since a thread waiting within
+  // a factorization can pick up the factorization of another shift.
+  std::mutex mutex;
+  std::vector<std::unique_ptr<supernodal_ldl::Factorization<Field>>> idle;
+  tbb::parallel_for(Int(0), num_shifts, [&](Int index) {
+    std::unique_ptr<supernodal_ldl::Factorization<Field>> attempt;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!idle.empty()) {
+        attempt = std::move(idle.back());
+        idle.pop_back();
+      }
+    }
+    if (!attempt) attempt = supernodal_factorization->Clone();
+    (*results)[index] = attempt->RefactorWithFixedSparsityPattern(
+        cplan, Ax, -sigmas[index], Bx);
+    if (!attempt->ConversionPlanIsCurrent(cplan)) {
+      // Delayed pivots refolded the copy, so the plan no longer fits it.
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(std::move(attempt));
+  });
+}
+
+template <class Field>
+template <typename Callback>
+void SparseLDL<Field>::RefactorCombinations(
+    const ConversionPlan& cplan, const Buffer<const Field*>& values,
+    const ConstBlasMatrixView<Field>& coefficients,
+    const Callback& callback) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { RefactorCombinations(cplan, values, coefficients, callback); });
+    return;
+  }
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero(
+        [&]() { RefactorCombinations(cplan, values, coefficients, callback); });
+    return;
+  }
+  TraceScope trace_scope("SparseLDL.RefactorCombinations");
+  const Int num_terms = values.Size();
+  if (coefficients.height != num_terms) {
+    throw std::runtime_error("There must be a coefficient per value array");
+  }
+
+  // As in 'ShiftedInertias', each combination takes its own clone out of the
+  // pool, since a thread waiting within a factorization can pick up another.
+  std::mutex mutex;
+  std::vector<std::unique_ptr<SparseLDL<Field>>> idle;
+  tbb::parallel_for(Int(0), coefficients.width, [&](Int index) {
+    std::unique_ptr<SparseLDL<Field>> ldl;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!idle.empty()) {
+        ldl = std::move(idle.back());
+        idle.pop_back();
+      }
+    }
+    if (!ldl) ldl = Clone();
+    Buffer<Field> column_coefficients(num_terms);
+    for (Int term = 0; term < num_terms; ++term) {
+      column_coefficients[term] = coefficients(term, index);
+    }
+    const SparseLDLResult<Field> result =
+        ldl->RefactorWithFixedSparsityPattern(cplan, values,
+                                              column_coefficients);
+    callback(index, static_cast<const SparseLDL<Field>&>(*ldl), result);
+    if (!ldl->ConversionPlanIsCurrent(cplan)) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(std::move(ldl));
+  });
+}
+
+template <class Field>
+void SparseLDL<Field>::FormConversionPlan(const CoordinateMatrix<Field>& matrix,
+                                          ConversionPlan* cplan) const {
+  if (!is_supernodal) {
+    // The scalar factorizations only form pattern-based plans.
+    FormConversionPlan(matrix.NumRows(), matrix.RowEntryOffsets().Data(),
+                       matrix.ColumnIndices().Data(),
+                       /* compressed_rows = */ true, cplan);
+    return;
+  }
+  supernodal_factorization->FormConversionPlan(matrix, cplan);
+}
+
+template <class Field>
+void SparseLDL<Field>::FormConversionPlan(Int num_rows, const Int* offsets,
+                                          const Int* indices,
+                                          bool compressed_rows,
+                                          ConversionPlan* cplan) const {
+  if (!is_supernodal) {
+    scalar_factorization->FormConversionPlan(num_rows, offsets, indices,
+                                             compressed_rows, cplan);
+    return;
+  }
+  supernodal_factorization->FormConversionPlan(num_rows, offsets, indices,
+                                               compressed_rows, cplan);
+}
+
 template <class Field>
 void SparseLDL<Field>::DynamicRegularizationDiagonal(
     const SparseLDLResult<Field>& result,
@@ -221,6 +1212,12 @@ void SparseLDL<Field>::DynamicRegularizationDiagonal(
   typedef ComplexBase<Field> Real;
   const Int height = NumRows();
   diagonal->Resize(height, 1, Real(0));
+  if (!result.dynamic_regularization_diagonal.Empty()) {
+    for (Int i = 0; i < height; ++i) {
+      diagonal->Entry(i) = result.dynamic_regularization_diagonal[i];
+    }
+    return;
+  }
   for (const auto& perturbation : result.dynamic_regularization) {
     const Int index = perturbation.first;
     const Real regularization = perturbation.second;
@@ -228,24 +1225,81 @@ void SparseLDL<Field>::DynamicRegularizationDiagonal(
   }
 }
 
+template <class Field>
+template <class Function>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::LaunchAsync(
+    tbb::task_arena* arena, Function&& function) {
+  // The task must be copyable to be enqueued, so it is shared.
+  auto task = std::make_shared<std::packaged_task<SparseLDLResult<Field>()>>(
+      std::forward<Function>(function));
+  std::future<SparseLDLResult<Field>> future = task->get_future();
+  arena->enqueue([task]() { (*task)(); });
+  return future;
+}
+
+template <class Field>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::FactorAsync(
+    tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control, bool symbolic_only) {
+  return LaunchAsync(arena, [this, &matrix, control, symbolic_only]() {
+    return Factor(matrix, control, symbolic_only);
+  });
+}
+
+template <class Field>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::FactorAsync(
+    tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+    const SymmetricOrdering& ordering, const SparseLDLControl<Field>& control,
+    bool symbolic_only) {
+  return LaunchAsync(
+      arena, [this, &matrix, ordering, control, symbolic_only]() {
+        return Factor(matrix, ordering, control, symbolic_only);
+      });
+}
+
+template <class Field>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::RefactorAsync(
+    tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix) {
+  return LaunchAsync(arena, [this, &matrix]() {
+    return RefactorWithFixedSparsityPattern(matrix);
+  });
+}
+
+template <class Field>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::RefactorAsync(
+    tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+    const SparseLDLControl<Field>& control) {
+  return LaunchAsync(arena, [this, &matrix, control]() {
+    return RefactorWithFixedSparsityPattern(matrix, control);
+  });
+}
+
+template <class Field>
+std::future<SparseLDLResult<Field>> SparseLDL<Field>::RefactorAsync(
+    tbb::task_arena* arena, const ConversionPlan& cplan, const Field* Ax,
+    Field sigma, const Field* Bx) {
+  return LaunchAsync(arena, [this, &cplan, Ax, sigma, Bx]() {
+    return RefactorWithFixedSparsityPattern(cplan, Ax, sigma, Bx);
+  });
+}
+
 template <class Field>
 SparseLDLResult<Field> SparseLDL<Field>::RefactorWithFixedSparsityPattern(
     const CoordinateMatrix<Field>& matrix) {
-  ScopedEnableFlushToZero scope_guard;
-  typedef ComplexBase<Field> Real;
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return RefactorWithFixedSparsityPattern(matrix); });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return RefactorWithFixedSparsityPattern(matrix); });
+  }
 
   // Optionally equilibrate the matrix.
-  const CoordinateMatrix<Field>* matrix_to_factor;
+  const bool kVerboseEquil = false;
   CoordinateMatrix<Field> equilibrated_matrix;
-  if (have_equilibration_) {
-    const bool kVerboseEquil = false;
-    equilibrated_matrix = matrix;
-    EquilibrateSymmetricMatrix(&equilibrated_matrix, &equilibration_,
-                               kVerboseEquil);
-    matrix_to_factor = &equilibrated_matrix;
-  } else {
-    matrix_to_factor = &matrix;
-  }
+  const CoordinateMatrix<Field>* matrix_to_factor =
+      EquilibrateMatrix(matrix, kVerboseEquil, &equilibrated_matrix);
 
   SparseLDLResult<Field> result;
   if (is_supernodal) {
@@ -255,13 +1309,8 @@ SparseLDLResult<Field> SparseLDL<Field>::RefactorWithFixedSparsityPattern(
     result = scalar_factorization->RefactorWithFixedSparsityPattern(
         *matrix_to_factor);
   }
-  if (have_equilibration_) {
-    // We factored inv(D) A inv(D), so the regularization needs to be wrapped
-    // with D . D.
-    for (std::pair<Int, Real>& reg : result.dynamic_regularization) {
-      reg.second *= equilibration_(reg.first) * equilibration_(reg.first);
-    }
-  }
+  EstimateAccuracy(&result);
+  UnequilibrateResult(&result);
   return result;
 }
 
@@ -269,24 +1318,24 @@ template <class Field>
 SparseLDLResult<Field> SparseLDL<Field>::RefactorWithFixedSparsityPattern(
     const CoordinateMatrix<Field>& matrix,
     const SparseLDLControl<Field>& control) {
-  typedef ComplexBase<Field> Real;
-  ScopedEnableFlushToZero scope_guard;
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute([&]() {
+      return RefactorWithFixedSparsityPattern(matrix, control);
+    });
+  }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return RefactorWithFixedSparsityPattern(matrix, control); });
+  }
 
   // TODO(Jack Poulson): Add sanity checks here that, for example, the algorithm
   // hasn't changed.
 
   // Optionally equilibrate the matrix.
-  const CoordinateMatrix<Field>* matrix_to_factor;
+  const bool kVerboseEquil = false;
   CoordinateMatrix<Field> equilibrated_matrix;
-  if (have_equilibration_) {
-    const bool kVerboseEquil = false;
-    equilibrated_matrix = matrix;
-    EquilibrateSymmetricMatrix(&equilibrated_matrix, &equilibration_,
-                               kVerboseEquil);
-    matrix_to_factor = &equilibrated_matrix;
-  } else {
-    matrix_to_factor = &matrix;
-  }
+  const CoordinateMatrix<Field>* matrix_to_factor =
+      EquilibrateMatrix(matrix, kVerboseEquil, &equilibrated_matrix);
 
   SparseLDLResult<Field> result;
   if (is_supernodal) {
@@ -296,57 +1345,405 @@ SparseLDLResult<Field> SparseLDL<Field>::RefactorWithFixedSparsityPattern(
     result = scalar_factorization->RefactorWithFixedSparsityPattern(
         *matrix_to_factor, control.scalar_control);
   }
-  if (have_equilibration_) {
-    // We factored inv(D) A inv(D), so the regularization needs to be wrapped
-    // with D . D.
-    for (std::pair<Int, Real>& reg : result.dynamic_regularization) {
-      reg.second *= equilibration_(reg.first) * equilibration_(reg.first);
-    }
+  EstimateAccuracy(&result);
+  UnequilibrateResult(&result);
+  return result;
+}
+
+template <class Field>
+SparseLDLResult<Field> SparseLDL<Field>::RefactorWithGrownSparsityPattern(
+    const CoordinateMatrix<Field>& matrix) {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    return execution_context_->Execute(
+        [&]() { return RefactorWithGrownSparsityPattern(matrix); });
+  }
+  if (!is_supernodal) {
+    throw std::runtime_error("Implemented for supernodal only");
   }
+  if (ShouldEnterFlushToZero()) {
+    return RunWithFlushToZero(
+        [&]() { return RefactorWithGrownSparsityPattern(matrix); });
+  }
+
+  // Optionally equilibrate the matrix.
+  const bool kVerboseEquil = false;
+  CoordinateMatrix<Field> equilibrated_matrix;
+  const CoordinateMatrix<Field>* matrix_to_factor =
+      EquilibrateMatrix(matrix, kVerboseEquil, &equilibrated_matrix);
+
+  SparseLDLResult<Field> result =
+      supernodal_factorization->RefactorWithGrownSparsityPattern(
+          *matrix_to_factor);
+  EstimateAccuracy(&result);
+  UnequilibrateResult(&result);
   return result;
 }
 
+template <class Field>
+void SparseLDL<Field>::PrepareSolve(Int max_num_rhs,
+                                    SolveWorkspace<Field>* workspace) const {
+  if (is_supernodal) {
+    supernodal_factorization->PrepareSolve(max_num_rhs, workspace);
+  } else if (workspace) {
+    const Int size = max_num_rhs * NumRows();
+    if (workspace->permute_scratch.Size() < size) {
+      workspace->permute_scratch.Resize(size);
+    }
+  }
+}
+
 template <class Field>
 void SparseLDL<Field>::Solve(BlasMatrixView<Field>* right_hand_sides, bool already_permuted) const {
-  ScopedEnableFlushToZero scope_guard;
-  if (have_equilibration_) {
+  Solve(right_hand_sides, nullptr, already_permuted);
+}
+
+template <class Field>
+void SparseLDL<Field>::Solve(BlasMatrixView<Field>* right_hand_sides,
+                             SolveWorkspace<Field>* workspace,
+                             bool already_permuted) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { Solve(right_hand_sides, workspace, already_permuted); });
+    return;
+  }
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero(
+        [&]() { Solve(right_hand_sides, workspace, already_permuted); });
+    return;
+  }
+  // A fused equilibration is applied by the supernodal solve as it permutes
+  // the right-hand sides.
+  const bool separate_equilibration =
+      have_equilibration_ && !fused_equilibration_;
+  if (separate_equilibration) {
     // Apply the inverse of the equilibration matrix.
     for (Int j = 0; j < right_hand_sides->width; ++j) {
       for (Int i = 0; i < right_hand_sides->height; ++i) {
-        right_hand_sides->Entry(i) /= equilibration_(i);
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
       }
     }
   }
   if (is_supernodal) {
-    supernodal_factorization->Solve(right_hand_sides, already_permuted);
+    supernodal_factorization->Solve(right_hand_sides, workspace,
+                                    already_permuted);
+  } else if (workspace) {
+    scalar_factorization->Solve(right_hand_sides, &workspace->permute_scratch,
+                                already_permuted);
   } else {
+    // The scalar solves keep no state between calls.
     if (already_permuted) throw std::runtime_error("Unimplemented");
     scalar_factorization->Solve(right_hand_sides);
   }
-  if (have_equilibration_) {
+  if (separate_equilibration) {
     // Apply the inverse of the equilibration matrix.
     for (Int j = 0; j < right_hand_sides->width; ++j) {
       for (Int i = 0; i < right_hand_sides->height; ++i) {
-        right_hand_sides->Entry(i) /= equilibration_(i);
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::Solve(BlasMatrixView<Field>* right_hand_sides,
+                             supernodal_ldl::SolveOperation operation,
+                             SolveWorkspace<Field>* workspace) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { Solve(right_hand_sides, operation, workspace); });
+    return;
+  }
+  if (!is_supernodal) {
+    const bool symmetric = scalar_factorization->control.factorization_type ==
+                           kLDLTransposeFactorization;
+    const bool conjugate =
+        IsComplex<Field>::value &&
+        (operation == supernodal_ldl::kSolveConjugate ||
+         operation == (symmetric ? supernodal_ldl::kSolveAdjoint
+                                 : supernodal_ldl::kSolveTranspose));
+    if (conjugate) ConjugateMatrix(right_hand_sides);
+    Solve(right_hand_sides, workspace);
+    if (conjugate) ConjugateMatrix(right_hand_sides);
+    return;
+  }
+
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero(
+        [&]() { Solve(right_hand_sides, operation, workspace); });
+    return;
+  }
+
+  // The equilibration is real, so it commutes with the conjugations.
+  const bool separate_equilibration =
+      have_equilibration_ && !fused_equilibration_;
+  if (separate_equilibration) {
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      for (Int i = 0; i < right_hand_sides->height; ++i) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+  supernodal_factorization->Solve(right_hand_sides, operation, workspace);
+  if (separate_equilibration) {
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      for (Int i = 0; i < right_hand_sides->height; ++i) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::SolveBatches(
+    const Buffer<BlasMatrixView<Field>*>& batches,
+    SolveWorkspace<Field>* workspace) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute([&]() { SolveBatches(batches, workspace); });
+    return;
+  }
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() { SolveBatches(batches, workspace); });
+    return;
+  }
+  TraceScope trace_scope("SparseLDL.SolveBatches");
+  const Int num_rows = NumRows();
+  Int num_rhs = 0;
+  for (const BlasMatrixView<Field>* batch : batches) {
+    if (batch->height != num_rows) {
+      throw std::runtime_error("Each batch must have one row per unknown");
+    }
+    num_rhs += batch->width;
+  }
+  if (!num_rhs) return;
+  if (batches.Size() == 1) {
+    Solve(batches[0], workspace);
+    return;
+  }
+
+  BlasMatrix<Field> packed;
+  packed.Resize(num_rows, num_rhs);
+  for (Int index = 0, offset = 0; index < Int(batches.Size()); ++index) {
+    const BlasMatrixView<Field>& batch = *batches[index];
+    for (Int j = 0; j < batch.width; ++j, ++offset) {
+      std::copy(batch.Pointer(0, j), batch.Pointer(num_rows, j),
+                packed.Pointer(0, offset));
+    }
+  }
+
+  Solve(&packed.view, workspace);
+
+  for (Int index = 0, offset = 0; index < Int(batches.Size()); ++index) {
+    BlasMatrixView<Field>& batch = *batches[index];
+    for (Int j = 0; j < batch.width; ++j, ++offset) {
+      std::copy(packed.Pointer(0, offset), packed.Pointer(num_rows, offset),
+                batch.Pointer(0, j));
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::SolveSparse(const Buffer<Int>& rhs_support,
+                                   const Buffer<Int>& requested_indices,
+                                   BlasMatrixView<Field>* right_hand_sides) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute([&]() {
+      SolveSparse(rhs_support, requested_indices, right_hand_sides);
+    });
+    return;
+  }
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (ShouldEnterFlushToZero()) {
+    RunWithFlushToZero([&]() {
+      SolveSparse(rhs_support, requested_indices, right_hand_sides);
+    });
+    return;
+  }
+  if (have_equilibration_) {
+    for (const Int& i : rhs_support) {
+      for (Int j = 0; j < right_hand_sides->width; ++j) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+  supernodal_factorization->SolveSparse(rhs_support, requested_indices,
+                                        right_hand_sides);
+  if (have_equilibration_) {
+    std::vector<Int> sorted_requests(requested_indices.begin(),
+                                     requested_indices.end());
+    std::sort(sorted_requests.begin(), sorted_requests.end());
+    for (const Int& i : rhs_support) {
+      // Restore the input rows which were not overwritten by the solution.
+      if (std::binary_search(sorted_requests.begin(), sorted_requests.end(), i)) continue;
+      for (Int j = 0; j < right_hand_sides->width; ++j) {
+        right_hand_sides->Entry(i, j) *= equilibration_(i);
+      }
+    }
+    sorted_requests.erase(
+        std::unique(sorted_requests.begin(), sorted_requests.end()),
+        sorted_requests.end());
+    for (const Int& i : sorted_requests) {
+      for (Int j = 0; j < right_hand_sides->width; ++j) {
+        right_hand_sides->Entry(i, j) /= equilibration_(i);
+      }
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::InverseDiagonal(Buffer<Field>* diagonal) const {
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  supernodal_factorization->InverseDiagonal(diagonal);
+  if (have_equilibration_) {
+    // As in Solve, inv(A) = inv(E) inv(F) inv(E), where F is the factored
+    // matrix and E is the diagonal equilibration matrix.
+    for (Int i = 0; i < Int(diagonal->Size()); ++i) {
+      (*diagonal)[i] /= equilibration_(i) * equilibration_(i);
+    }
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::NullSpaceBasis(BlasMatrix<Field>* basis) const {
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  *basis = supernodal_factorization->NullSpaceBasis();
+  if (have_equilibration_ && !fused_equilibration_) {
+    // The factored matrix is inv(E) A inv(E), so inv(E) maps its null space
+    // onto that of A.
+    for (Int j = 0; j < basis->view.width; ++j) {
+      for (Int i = 0; i < basis->view.height; ++i) {
+        basis->Entry(i, j) /= equilibration_(i);
       }
     }
+    supernodal_ldl::OrthonormalizeColumns(&basis->view);
+  }
+}
+
+template <class Field>
+void SparseLDL<Field>::PseudoinverseSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  if (ShouldEnterExecutionContext(execution_context_)) {
+    execution_context_->Execute(
+        [&]() { PseudoinverseSolve(right_hand_sides); });
+    return;
+  }
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (!have_equilibration_ || fused_equilibration_) {
+    RunWithFlushToZero([&]() {
+      supernodal_factorization->PseudoinverseSolve(right_hand_sides);
+    });
+    return;
+  }
+
+  // The projections must use the null space of A rather than that of the
+  // equilibrated matrix.
+  BlasMatrix<Field> basis;
+  NullSpaceBasis(&basis);
+  const bool conjugate =
+      supernodal_factorization->GetControl().factorization_type ==
+      kLDLTransposeFactorization;
+  supernodal_ldl::ProjectOutBasis(basis.ConstView(), conjugate,
+                                  right_hand_sides);
+  Solve(right_hand_sides);
+  supernodal_ldl::ProjectOutBasis(basis.ConstView(), false, right_hand_sides);
+}
+
+template <class Field>
+bool SparseLDL<Field>::UpdateDowndate(const ConstBlasMatrixView<Field>& vectors,
+                                      Int sign) {
+  if (!is_supernodal) throw std::runtime_error("Implemented for supernodal only");
+  if (!have_equilibration_) {
+    return supernodal_factorization->UpdateDowndate(vectors, sign);
+  }
+
+  // We factored inv(D) A inv(D), so the vectors must be scaled by inv(D).
+  BlasMatrix<Field> scaled_vectors;
+  scaled_vectors.Resize(vectors.height, vectors.width);
+  for (Int j = 0; j < vectors.width; ++j) {
+    for (Int i = 0; i < vectors.height; ++i) {
+      scaled_vectors(i, j) = vectors(i, j) / equilibration_(i);
+    }
+  }
+  return supernodal_factorization->UpdateDowndate(scaled_vectors.ConstView(),
+                                                  sign);
+}
+
+template <class Field>
+void SparseLDL<Field>::Checkpoint(
+    SparseLDLCheckpoint<Field>* checkpoint) const {
+  if (is_supernodal) {
+    supernodal_factorization->Checkpoint(&checkpoint->supernodal);
+  } else {
+    checkpoint->scalar_lower_values =
+        scalar_factorization->lower_factor.values;
+    checkpoint->scalar_diagonal_values =
+        scalar_factorization->diagonal_factor.values;
+  }
+  checkpoint->have_equilibration = have_equilibration_;
+  checkpoint->fused_equilibration = fused_equilibration_;
+  checkpoint->equilibration = equilibration_;
+  checkpoint->factored_max_norm = factored_max_norm_;
+  checkpoint->backward_error_estimate = backward_error_estimate_;
+}
+
+template <class Field>
+void SparseLDL<Field>::Restore(const SparseLDLCheckpoint<Field>& checkpoint) {
+  if (is_supernodal) {
+    supernodal_factorization->Restore(checkpoint.supernodal);
+  } else {
+    if (checkpoint.scalar_lower_values.Size() !=
+            scalar_factorization->lower_factor.values.Size() ||
+        checkpoint.scalar_diagonal_values.Size() !=
+            scalar_factorization->diagonal_factor.values.Size()) {
+      throw std::runtime_error(
+          "The checkpoint does not match the structure of the factor");
+    }
+    scalar_factorization->lower_factor.values =
+        checkpoint.scalar_lower_values;
+    scalar_factorization->diagonal_factor.values =
+        checkpoint.scalar_diagonal_values;
+  }
+  have_equilibration_ = checkpoint.have_equilibration;
+  fused_equilibration_ = checkpoint.fused_equilibration;
+  equilibration_ = checkpoint.equilibration;
+  factored_max_norm_ = checkpoint.factored_max_norm;
+  backward_error_estimate_ = checkpoint.backward_error_estimate;
+}
+
+template <class Field>
+bool SparseLDL<Field>::SolveIfEstimatedAccurate(
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace,
+    RefinedSolveStatus<Real>* status) const {
+  if (!control.skip_if_estimated_accurate ||
+      backward_error_estimate_ > control.relative_tol) {
+    return false;
+  }
+  if (control.verbose) {
+    std::cout << "Skipping refinement: estimated backward error "
+              << backward_error_estimate_ << " <= " << control.relative_tol
+              << std::endl;
   }
+  Solve(right_hand_sides, &workspace->solve);
+  status->num_iterations = 0;
+  status->residual_relative_max_norm = backward_error_estimate_;
+  status->backward_error_estimate = backward_error_estimate_;
+  return true;
 }
 
 template <class Field>
+template <class ApplyOperator>
 RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::RefinedSolveHelper(
-    const CoordinateMatrix<Field>& matrix,
+    const ApplyOperator& apply_matrix,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides) const {
-  auto apply_matrix = [&](Field alpha, const ConstBlasMatrixView<Field>& input,
-                          Field beta, BlasMatrixView<Field>* output) {
-    ApplySparse(alpha, matrix, input, beta, output);
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  auto apply_inverse = [&](BlasMatrixView<Field>* input) {
+    Solve(input, &workspace->solve);
   };
 
-  auto apply_inverse = [&](BlasMatrixView<Field>* input) { Solve(input); };
-
   return catamari::RefinedSolve(apply_matrix, apply_inverse, control,
-                                right_hand_sides);
+                                right_hand_sides, &workspace->refinement);
 }
 
 template <class Field>
@@ -354,7 +1751,8 @@ RefinedSolveStatus<ComplexBase<Field>>
 SparseLDL<Field>::PromotedRefinedSolveHelper(
     const CoordinateMatrix<Field>& matrix,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides_lower) const {
+    BlasMatrixView<Field>* right_hand_sides_lower,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
   auto apply_matrix = [&](Promote<Field> alpha,
                           const ConstBlasMatrixView<Promote<Field>>& input,
                           Promote<Field> beta,
@@ -362,10 +1760,13 @@ SparseLDL<Field>::PromotedRefinedSolveHelper(
     ApplySparse(alpha, matrix, input, beta, output);
   };
 
-  auto apply_inverse = [&](BlasMatrixView<Field>* input) { Solve(input); };
+  auto apply_inverse = [&](BlasMatrixView<Field>* input) {
+    Solve(input, &workspace->solve);
+  };
 
   return catamari::PromotedRefinedSolve(apply_matrix, apply_inverse, control,
-                                        right_hand_sides_lower);
+                                        right_hand_sides_lower,
+                                        &workspace->refinement);
 }
 
 template <class Field>
@@ -373,11 +1774,67 @@ RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::RefinedSolve(
     const CoordinateMatrix<Field>& matrix,
     const RefinedSolveControl<Real>& control,
     BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return RefinedSolve(matrix, control, right_hand_sides, &workspace);
+}
+
+template <class Field>
+RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::RefinedSolve(
+    const CoordinateMatrix<Field>& matrix,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  RefinedSolveStatus<Real> status;
+  if (SolveIfEstimatedAccurate(control, right_hand_sides, workspace,
+                               &status)) {
+    return status;
+  }
   if (control.promote) {
-    return PromotedRefinedSolveHelper(matrix, control, right_hand_sides);
+    status = PromotedRefinedSolveHelper(matrix, control, right_hand_sides,
+                                        workspace);
   } else {
-    return RefinedSolveHelper(matrix, control, right_hand_sides);
+    auto apply_matrix = [&](Field alpha,
+                            const ConstBlasMatrixView<Field>& input,
+                            Field beta, BlasMatrixView<Field>* output) {
+      ApplySparse(alpha, matrix, input, beta, output);
+    };
+    status = RefinedSolveHelper(apply_matrix, control, right_hand_sides,
+                                workspace);
+  }
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
+}
+
+template <class Field>
+template <class ApplyOperator>
+RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::RefinedSolve(
+    const ApplyOperator& apply_matrix,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return RefinedSolve(apply_matrix, control, right_hand_sides, &workspace);
+}
+
+template <class Field>
+template <class ApplyOperator>
+RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::RefinedSolve(
+    const ApplyOperator& apply_matrix,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  if (control.promote) {
+    throw std::runtime_error(
+        "Matrix-free refinement does not support promotion");
   }
+  RefinedSolveStatus<Real> status;
+  if (SolveIfEstimatedAccurate(control, right_hand_sides, workspace,
+                               &status)) {
+    return status;
+  }
+  status =
+      RefinedSolveHelper(apply_matrix, control, right_hand_sides, workspace);
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
 }
 
 template <class Field>
@@ -385,23 +1842,20 @@ RefinedSolveStatus<ComplexBase<Field>>
 SparseLDL<Field>::DynamicallyRegularizedRefinedSolveHelper(
     const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides) const {
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
   auto apply_matrix = [&](Field alpha, const ConstBlasMatrixView<Field>& input,
                           Field beta, BlasMatrixView<Field>* output) {
     ApplySparse(alpha, matrix, input, beta, output);
-    for (const std::pair<Int, Real>& perturb : result.dynamic_regularization) {
-      const Int i = perturb.first;
-      const Real regularization = perturb.second;
-      for (Int j = 0; j < output->width; ++j) {
-        output->Entry(i, j) += alpha * regularization * input(i, j);
-      }
-    }
+    sparse_ldl::ApplyDynamicRegularization(result, alpha, input, output);
   };
 
-  auto apply_inverse = [&](BlasMatrixView<Field>* input) { Solve(input); };
+  auto apply_inverse = [&](BlasMatrixView<Field>* input) {
+    Solve(input, &workspace->solve);
+  };
 
   return catamari::RefinedSolve(apply_matrix, apply_inverse, control,
-                                right_hand_sides);
+                                right_hand_sides, &workspace->refinement);
 }
 
 template <class Field>
@@ -409,25 +1863,23 @@ RefinedSolveStatus<ComplexBase<Field>>
 SparseLDL<Field>::PromotedDynamicallyRegularizedRefinedSolveHelper(
     const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides_lower) const {
+    BlasMatrixView<Field>* right_hand_sides_lower,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
   auto apply_matrix = [&](Promote<Field> alpha,
                           const ConstBlasMatrixView<Promote<Field>>& input,
                           Promote<Field> beta,
                           BlasMatrixView<Promote<Field>>* output) {
     ApplySparse(alpha, matrix, input, beta, output);
-    for (const std::pair<Int, Real>& perturb : result.dynamic_regularization) {
-      const Int i = perturb.first;
-      const Promote<Real> regularization = perturb.second;
-      for (Int j = 0; j < output->width; ++j) {
-        output->Entry(i, j) += alpha * regularization * input(i, j);
-      }
-    }
+    sparse_ldl::ApplyDynamicRegularization(result, alpha, input, output);
   };
 
-  auto apply_inverse = [&](BlasMatrixView<Field>* input) { Solve(input); };
+  auto apply_inverse = [&](BlasMatrixView<Field>* input) {
+    Solve(input, &workspace->solve);
+  };
 
   return catamari::PromotedRefinedSolve(apply_matrix, apply_inverse, control,
-                                        right_hand_sides_lower);
+                                        right_hand_sides_lower,
+                                        &workspace->refinement);
 }
 
 template <class Field>
@@ -436,32 +1888,54 @@ SparseLDL<Field>::DynamicallyRegularizedRefinedSolve(
     const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
     const RefinedSolveControl<Real>& control,
     BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return DynamicallyRegularizedRefinedSolve(matrix, result, control,
+                                            right_hand_sides, &workspace);
+}
+
+template <class Field>
+RefinedSolveStatus<ComplexBase<Field>>
+SparseLDL<Field>::DynamicallyRegularizedRefinedSolve(
+    const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  RefinedSolveStatus<Real> status;
+  if (SolveIfEstimatedAccurate(control, right_hand_sides, workspace,
+                               &status)) {
+    return status;
+  }
   if (control.promote) {
-    return PromotedDynamicallyRegularizedRefinedSolveHelper(
-        matrix, result, control, right_hand_sides);
+    status = PromotedDynamicallyRegularizedRefinedSolveHelper(
+        matrix, result, control, right_hand_sides, workspace);
   } else {
-    return DynamicallyRegularizedRefinedSolveHelper(matrix, result, control,
-                                                    right_hand_sides);
+    status = DynamicallyRegularizedRefinedSolveHelper(
+        matrix, result, control, right_hand_sides, workspace);
   }
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
 }
 
 template <class Field>
+template <class ApplyOperator>
 RefinedSolveStatus<ComplexBase<Field>>
 SparseLDL<Field>::DiagonallyScaledRefinedSolveHelper(
-    const CoordinateMatrix<Field>& matrix,
+    const ApplyOperator& apply_matrix,
     const ConstBlasMatrixView<Real>& scaling,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides) const {
-  BlasMatrix<Field> scaled_input;
-  auto apply_matrix = [&](Field alpha, const ConstBlasMatrixView<Field>& input,
-                          Field beta, BlasMatrixView<Field>* output) {
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  BlasMatrix<Field>& scaled_input = workspace->refinement.scaled_input;
+  auto apply_scaled_matrix = [&](Field alpha,
+                                 const ConstBlasMatrixView<Field>& input,
+                                 Field beta, BlasMatrixView<Field>* output) {
     scaled_input.Resize(input.height, input.width);
     for (Int j = 0; j < input.width; ++j) {
       for (Int i = 0; i < input.height; ++i) {
         scaled_input(i, j) = input(i, j) * scaling(i);
       }
     }
-    ApplySparse(alpha, matrix, scaled_input.ConstView(), beta, output);
+    apply_matrix(alpha, scaled_input.ConstView(), beta, output);
     for (Int j = 0; j < output->width; ++j) {
       for (Int i = 0; i < output->height; ++i) {
         output->Entry(i, j) *= scaling(i);
@@ -475,7 +1949,7 @@ SparseLDL<Field>::DiagonallyScaledRefinedSolveHelper(
         input->Entry(i, j) /= scaling(i);
       }
     }
-    Solve(input);
+    Solve(input, &workspace->solve);
     for (Int j = 0; j < input->width; ++j) {
       for (Int i = 0; i < input->height; ++i) {
         input->Entry(i, j) /= scaling(i);
@@ -490,8 +1964,9 @@ SparseLDL<Field>::DiagonallyScaledRefinedSolveHelper(
     }
   }
 
-  auto state = catamari::RefinedSolve(apply_matrix, apply_inverse, control,
-                                      right_hand_sides);
+  auto state = catamari::RefinedSolve(apply_scaled_matrix, apply_inverse,
+                                      control, right_hand_sides,
+                                      &workspace->refinement);
 
   // *right_hand_sides := scaling * solution
   for (Int j = 0; j < right_hand_sides->width; ++j) {
@@ -509,8 +1984,10 @@ SparseLDL<Field>::PromotedDiagonallyScaledRefinedSolveHelper(
     const CoordinateMatrix<Field>& matrix,
     const ConstBlasMatrixView<Real>& scaling,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides_lower) const {
-  BlasMatrix<Promote<Field>> scaled_input;
+    BlasMatrixView<Field>* right_hand_sides_lower,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  BlasMatrix<Promote<Field>>& scaled_input =
+      workspace->refinement.scaled_input_higher;
   auto apply_matrix = [&](Promote<Field> alpha,
                           const ConstBlasMatrixView<Promote<Field>>& input,
                           Promote<Field> beta,
@@ -535,7 +2012,7 @@ SparseLDL<Field>::PromotedDiagonallyScaledRefinedSolveHelper(
         input->Entry(i, j) /= scaling(i);
       }
     }
-    Solve(input);
+    Solve(input, &workspace->solve);
     for (Int j = 0; j < input->width; ++j) {
       for (Int i = 0; i < input->height; ++i) {
         input->Entry(i, j) /= scaling(i);
@@ -550,8 +2027,9 @@ SparseLDL<Field>::PromotedDiagonallyScaledRefinedSolveHelper(
     }
   }
 
-  auto state = catamari::PromotedRefinedSolve(apply_matrix, apply_inverse,
-                                              control, right_hand_sides_lower);
+  auto state = catamari::PromotedRefinedSolve(
+      apply_matrix, apply_inverse, control, right_hand_sides_lower,
+      &workspace->refinement);
 
   // *right_hand_sides := scaling * solution
   for (Int j = 0; j < right_hand_sides_lower->width; ++j) {
@@ -570,13 +2048,66 @@ SparseLDL<Field>::DiagonallyScaledRefinedSolve(
     const ConstBlasMatrixView<Real>& scaling,
     const RefinedSolveControl<Real>& control,
     BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return DiagonallyScaledRefinedSolve(matrix, scaling, control,
+                                      right_hand_sides, &workspace);
+}
+
+template <class Field>
+RefinedSolveStatus<ComplexBase<Field>>
+SparseLDL<Field>::DiagonallyScaledRefinedSolve(
+    const CoordinateMatrix<Field>& matrix,
+    const ConstBlasMatrixView<Real>& scaling,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  RefinedSolveStatus<Real> status;
   if (control.promote) {
-    return PromotedDiagonallyScaledRefinedSolveHelper(matrix, scaling, control,
-                                                      right_hand_sides);
+    status = PromotedDiagonallyScaledRefinedSolveHelper(
+        matrix, scaling, control, right_hand_sides, workspace);
   } else {
-    return DiagonallyScaledRefinedSolveHelper(matrix, scaling, control,
-                                              right_hand_sides);
+    auto apply_matrix = [&](Field alpha,
+                            const ConstBlasMatrixView<Field>& input,
+                            Field beta, BlasMatrixView<Field>* output) {
+      ApplySparse(alpha, matrix, input, beta, output);
+    };
+    status = DiagonallyScaledRefinedSolveHelper(
+        apply_matrix, scaling, control, right_hand_sides, workspace);
+  }
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
+}
+
+template <class Field>
+template <class ApplyOperator>
+RefinedSolveStatus<ComplexBase<Field>>
+SparseLDL<Field>::DiagonallyScaledRefinedSolve(
+    const ApplyOperator& apply_matrix,
+    const ConstBlasMatrixView<Real>& scaling,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return DiagonallyScaledRefinedSolve(apply_matrix, scaling, control,
+                                      right_hand_sides, &workspace);
+}
+
+template <class Field>
+template <class ApplyOperator>
+RefinedSolveStatus<ComplexBase<Field>>
+SparseLDL<Field>::DiagonallyScaledRefinedSolve(
+    const ApplyOperator& apply_matrix,
+    const ConstBlasMatrixView<Real>& scaling,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  if (control.promote) {
+    throw std::runtime_error(
+        "Matrix-free refinement does not support promotion");
   }
+  RefinedSolveStatus<Real> status = DiagonallyScaledRefinedSolveHelper(
+      apply_matrix, scaling, control, right_hand_sides, workspace);
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
 }
 
 template <class Field>
@@ -585,8 +2116,9 @@ SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
     const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
     const ConstBlasMatrixView<Real>& scaling,
     const RefinedSolveControl<Real>& control,
-    BlasMatrixView<Field>* right_hand_sides) const {
-  BlasMatrix<Field> scaled_input;
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  BlasMatrix<Field>& scaled_input = workspace->refinement.scaled_input;
   auto apply_matrix = [&](Field alpha, const ConstBlasMatrixView<Field>& input,
                           Field beta, BlasMatrixView<Field>* output) {
     scaled_input.Resize(input.height, input.width);
@@ -596,13 +2128,8 @@ SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
       }
     }
     ApplySparse(alpha, matrix, scaled_input.ConstView(), beta, output);
-    for (const std::pair<Int, Real>& perturb : result.dynamic_regularization) {
-      const Int i = perturb.first;
-      const Real regularization = perturb.second;
-      for (Int j = 0; j < output->width; ++j) {
-        output->Entry(i, j) += alpha * regularization * scaled_input(i, j);
-      }
-    }
+    sparse_ldl::ApplyDynamicRegularization(result, alpha,
+                                           scaled_input.ConstView(), output);
     for (Int j = 0; j < output->width; ++j) {
       for (Int i = 0; i < output->height; ++i) {
         output->Entry(i, j) *= scaling(i);
@@ -616,7 +2143,7 @@ SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
         input->Entry(i, j) /= scaling(i);
       }
     }
-    Solve(input);
+    Solve(input, &workspace->solve);
     for (Int j = 0; j < input->width; ++j) {
       for (Int i = 0; i < input->height; ++i) {
         input->Entry(i, j) /= scaling(i);
@@ -632,7 +2159,8 @@ SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
   }
 
   auto state = catamari::RefinedSolve(apply_matrix, apply_inverse, control,
-                                      right_hand_sides);
+                                      right_hand_sides,
+                                      &workspace->refinement);
 
   // *right_hand_sides := scaling * solution
   for (Int j = 0; j < right_hand_sides->width; ++j) {
@@ -651,8 +2179,10 @@ RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::
         const SparseLDLResult<Field>& result,
         const ConstBlasMatrixView<Real>& scaling,
         const RefinedSolveControl<Real>& control,
-        BlasMatrixView<Field>* right_hand_sides_lower) const {
-  BlasMatrix<Promote<Field>> scaled_input;
+        BlasMatrixView<Field>* right_hand_sides_lower,
+        SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  BlasMatrix<Promote<Field>>& scaled_input =
+      workspace->refinement.scaled_input_higher;
   auto apply_matrix = [&](Promote<Field> alpha,
                           const ConstBlasMatrixView<Promote<Field>>& input,
                           Promote<Field> beta,
@@ -664,13 +2194,8 @@ RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::
       }
     }
     ApplySparse(alpha, matrix, scaled_input.ConstView(), beta, output);
-    for (const std::pair<Int, Real>& perturb : result.dynamic_regularization) {
-      const Int i = perturb.first;
-      const Promote<Real> regularization = perturb.second;
-      for (Int j = 0; j < output->width; ++j) {
-        output->Entry(i, j) += alpha * regularization * scaled_input(i, j);
-      }
-    }
+    sparse_ldl::ApplyDynamicRegularization(result, alpha,
+                                           scaled_input.ConstView(), output);
     for (Int j = 0; j < output->width; ++j) {
       for (Int i = 0; i < output->height; ++i) {
         output->Entry(i, j) *= Promote<Real>(scaling(i));
@@ -684,7 +2209,7 @@ RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::
         input->Entry(i, j) /= scaling(i);
       }
     }
-    Solve(input);
+    Solve(input, &workspace->solve);
     for (Int j = 0; j < input->width; ++j) {
       for (Int i = 0; i < input->height; ++i) {
         input->Entry(i, j) /= scaling(i);
@@ -699,8 +2224,9 @@ RefinedSolveStatus<ComplexBase<Field>> SparseLDL<Field>::
     }
   }
 
-  auto state = catamari::PromotedRefinedSolve(apply_matrix, apply_inverse,
-                                              control, right_hand_sides_lower);
+  auto state = catamari::PromotedRefinedSolve(
+      apply_matrix, apply_inverse, control, right_hand_sides_lower,
+      &workspace->refinement);
 
   // *right_hand_sides := scaling * solution
   for (Int j = 0; j < right_hand_sides_lower->width; ++j) {
@@ -719,13 +2245,29 @@ SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolve(
     const ConstBlasMatrixView<Real>& scaling,
     const RefinedSolveControl<Real>& control,
     BlasMatrixView<Field>* right_hand_sides) const {
+  SparseLDLRefinedSolveWorkspace<Field> workspace;
+  return DiagonallyScaledDynamicallyRegularizedRefinedSolve(
+      matrix, result, scaling, control, right_hand_sides, &workspace);
+}
+
+template <class Field>
+RefinedSolveStatus<ComplexBase<Field>>
+SparseLDL<Field>::DiagonallyScaledDynamicallyRegularizedRefinedSolve(
+    const CoordinateMatrix<Field>& matrix, const SparseLDLResult<Field>& result,
+    const ConstBlasMatrixView<Real>& scaling,
+    const RefinedSolveControl<Real>& control,
+    BlasMatrixView<Field>* right_hand_sides,
+    SparseLDLRefinedSolveWorkspace<Field>* workspace) const {
+  RefinedSolveStatus<Real> status;
   if (control.promote) {
-    return PromotedDiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
-        matrix, result, scaling, control, right_hand_sides);
+    status = PromotedDiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
+        matrix, result, scaling, control, right_hand_sides, workspace);
   } else {
-    return DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
-        matrix, result, scaling, control, right_hand_sides);
+    status = DiagonallyScaledDynamicallyRegularizedRefinedSolveHelper(
+        matrix, result, scaling, control, right_hand_sides, workspace);
   }
+  status.backward_error_estimate = backward_error_estimate_;
+  return status;
 }
 
 template <class Field>
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_C_H_
+#define CATAMARI_SPARSE_LDL_C_H_
+
+#include "catamari/integers.h"
+#include "catamari/macros.h"
+
+#include "catamari/blas_matrix_view.h"
+#include "catamari/buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // ifdef __cplusplus
+
+// The status codes returned by the sparse LDL routines.
+enum CatamariStatus {
+  // The routine succeeded.
+  CatamariSuccess = 0,
+
+  // An argument was invalid (e.g., a null handle or a right-hand side of the
+  // wrong height) or the routines were called out of order.
+  CatamariInvalidArgument = 1,
+
+  // The factorization encountered an illegal pivot. The number of successful
+  // pivots is returned through the result.
+  CatamariFactorizationFailure = 2,
+
+  // Any other error, such as a failed allocation.
+  CatamariInternalError = 3,
+};
+
+// Mirrors catamari::SymmetricFactorizationType.
+enum CatamariSymmetricFactorizationType {
+  CatamariCholeskyFactorization = 0,
+  CatamariLDLAdjointFactorization = 1,
+  CatamariLDLTransposeFactorization = 2,
+};
+
+// Mirrors catamari::ReorderingStrategy.
+enum CatamariReorderingStrategy {
+  CatamariMinimumDegreeReordering = 0,
+  CatamariNestedDissectionReordering = 1,
+};
+
+// The configuration options of the sparse LDL routines. A supernodal
+// factorization is always used.
+struct CatamariSparseLDLControl {
+  CatamariSymmetricFactorizationType factorization_type;
+
+  CatamariReorderingStrategy reordering_strategy;
+
+  // If only one triangle (including the diagonal) of the symmetric pattern is
+  // stored. Which one does not matter: the entries of either triangle are
+  // mirrored into the other without conjugation, so complex matrices must be
+  // fully stored unless an LDL^T factorization is requested.
+  bool triangle_storage;
+
+  // If progress information should be printed.
+  bool verbose;
+};
+
+// The statistics of a (re)factorization.
+struct CatamariSparseLDLResult {
+  CatamariInt num_successful_pivots;
+  CatamariInt num_positive_pivots;
+  CatamariInt num_negative_pivots;
+  CatamariInt largest_supernode;
+  CatamariInt num_factorization_entries;
+  double num_factorization_flops;
+};
+
+// The opaque handles of the sparse LDL factorizations over each field. Each
+// handle holds the symbolic analysis of a single sparsity pattern and the
+// numerical factor of the last matrix with that pattern.
+struct CatamariSparseLDLFloat;
+struct CatamariSparseLDLDouble;
+struct CatamariSparseLDLComplexFloat;
+struct CatamariSparseLDLComplexDouble;
+
+// Fills the control structure with the default options: a Cholesky
+// factorization of a fully stored matrix, reordered by minimum degree.
+CATAMARI_EXPORT void CatamariSparseLDLControlInit(
+    CatamariSparseLDLControl* control);
+
+// For each field, the routines of the sparse LDL handles are:
+//
+//   Create: Allocates an empty handle.
+//
+//   Destroy: Frees the handle (which may be null) and sets it to null.
+//
+//   Analyze: Reorders and symbolically factors the symmetric
+//     compressed-sparse-column (or, if 'compressed_rows', compressed-sparse-
+//     row) pattern 'offsets'/'indices' of 'num_rows' rows and forms the plan
+//     for loading values stored in that pattern into the factor. The pattern
+//     is only read during the call and the indices within each column (or
+//     row) need not be sorted.
+//
+//   Refactor: Numerically factors the matrix whose values, in the order of
+//     the 'indices' of the analyzed pattern, are given by 'values'. The values
+//     are loaded directly into the factor, without an intermediate copy of
+//     the matrix, so a pattern may be refactored with any number of value
+//     arrays. The 'result' may be null.
+//
+//   Factor: Analyzes the pattern and then refactors with the given values.
+//
+//   Solve: Overwrites the caller-owned, column-major right-hand sides, which
+//     must have 'num_rows' rows, with the solution against the last numerical
+//     factorization.
+//
+// Each returns a CatamariStatus.
+
+CATAMARI_EXPORT int CatamariSparseLDLFloatCreate(
+    CatamariSparseLDLFloat** handle);
+CATAMARI_EXPORT void CatamariSparseLDLFloatDestroy(
+    CatamariSparseLDLFloat** handle);
+CATAMARI_EXPORT int CatamariSparseLDLFloatAnalyze(
+    CatamariSparseLDLFloat* handle, const CatamariSparseLDLControl* control,
+    CatamariInt num_rows, const CatamariInt* offsets,
+    const CatamariInt* indices, bool compressed_rows);
+CATAMARI_EXPORT int CatamariSparseLDLFloatRefactor(
+    CatamariSparseLDLFloat* handle, const float* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLFloatFactor(
+    CatamariSparseLDLFloat* handle, const CatamariSparseLDLControl* control,
+    CatamariInt num_rows, const CatamariInt* offsets,
+    const CatamariInt* indices, bool compressed_rows, const float* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLFloatSolve(
+    const CatamariSparseLDLFloat* handle,
+    CatamariBlasMatrixViewFloat* right_hand_sides);
+
+CATAMARI_EXPORT int CatamariSparseLDLDoubleCreate(
+    CatamariSparseLDLDouble** handle);
+CATAMARI_EXPORT void CatamariSparseLDLDoubleDestroy(
+    CatamariSparseLDLDouble** handle);
+CATAMARI_EXPORT int CatamariSparseLDLDoubleAnalyze(
+    CatamariSparseLDLDouble* handle, const CatamariSparseLDLControl* control,
+    CatamariInt num_rows, const CatamariInt* offsets,
+    const CatamariInt* indices, bool compressed_rows);
+CATAMARI_EXPORT int CatamariSparseLDLDoubleRefactor(
+    CatamariSparseLDLDouble* handle, const double* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLDoubleFactor(
+    CatamariSparseLDLDouble* handle, const CatamariSparseLDLControl* control,
+    CatamariInt num_rows, const CatamariInt* offsets,
+    const CatamariInt* indices, bool compressed_rows, const double* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLDoubleSolve(
+    const CatamariSparseLDLDouble* handle,
+    CatamariBlasMatrixViewDouble* right_hand_sides);
+
+CATAMARI_EXPORT int CatamariSparseLDLComplexFloatCreate(
+    CatamariSparseLDLComplexFloat** handle);
+CATAMARI_EXPORT void CatamariSparseLDLComplexFloatDestroy(
+    CatamariSparseLDLComplexFloat** handle);
+CATAMARI_EXPORT int CatamariSparseLDLComplexFloatAnalyze(
+    CatamariSparseLDLComplexFloat* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows);
+CATAMARI_EXPORT int CatamariSparseLDLComplexFloatRefactor(
+    CatamariSparseLDLComplexFloat* handle, const BlasComplexFloat* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLComplexFloatFactor(
+    CatamariSparseLDLComplexFloat* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows, const BlasComplexFloat* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLComplexFloatSolve(
+    const CatamariSparseLDLComplexFloat* handle,
+    CatamariBlasMatrixViewComplexFloat* right_hand_sides);
+
+CATAMARI_EXPORT int CatamariSparseLDLComplexDoubleCreate(
+    CatamariSparseLDLComplexDouble** handle);
+CATAMARI_EXPORT void CatamariSparseLDLComplexDoubleDestroy(
+    CatamariSparseLDLComplexDouble** handle);
+CATAMARI_EXPORT int CatamariSparseLDLComplexDoubleAnalyze(
+    CatamariSparseLDLComplexDouble* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows);
+CATAMARI_EXPORT int CatamariSparseLDLComplexDoubleRefactor(
+    CatamariSparseLDLComplexDouble* handle, const BlasComplexDouble* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLComplexDoubleFactor(
+    CatamariSparseLDLComplexDouble* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows, const BlasComplexDouble* values,
+    CatamariSparseLDLResult* result);
+CATAMARI_EXPORT int CatamariSparseLDLComplexDoubleSolve(
+    const CatamariSparseLDLComplexDouble* handle,
+    CatamariBlasMatrixViewComplexDouble* right_hand_sides);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // ifdef __cplusplus
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_C_H_
@@ -8,10 +8,20 @@
 #ifndef CATAMARI_SPARSE_LDL_H_
 #define CATAMARI_SPARSE_LDL_H_
 
+#include <future>
 #include <limits>
 #include <memory>
 #include <stdexcept>
 
+#include <tbb/task_arena.h>
+
+#include "catamari/dense_row_deferral.hpp"
+#include "catamari/equilibrate_symmetric_matrix.hpp"
+#include "catamari/execution_context.hpp"
+#include "catamari/nested_dissection.hpp"
+#include "catamari/ordering_cache.hpp"
+#include "catamari/parallel_minimum_degree.hpp"
+#include "catamari/refined_solve.hpp"
 #include "catamari/sparse_ldl/scalar.hpp"
 #include "catamari/sparse_ldl/supernodal.hpp"
 #include "quotient/minimum_degree.hpp"
@@ -29,12 +39,96 @@ enum SupernodalStrategy {
   kAdaptiveSupernodalStrategy,
 };
 
+enum ReorderingStrategy {
+  // Use the (approximate) Minimum Degree reordering.
+  kMinimumDegreeReordering,
+
+  // Use a nested-dissection reordering of the graph of the matrix, whose
+  // separator tree is typically far shallower and more balanced, and which
+  // therefore exposes more parallelism to the factorization.
+  kNestedDissectionReordering,
+
+  // Compute several candidate reorderings (minimum degree and nested
+  // dissections with fine and coarse leaves) concurrently and keep the one
+  // whose symbolic estimate (see 'EstimateReordering') is cheapest for the
+  // number of threads.
+  kAutomaticReordering,
+
+  // Use a minimum degree reordering computed in parallel over the subgraphs
+  // of a shallow dissection (see 'ParallelMinimumDegree').
+  kParallelMinimumDegreeReordering,
+};
+
+// A symbolic estimate of the cost of the factorization of a matrix with a
+// given reordering, formed from the structure sizes of its elimination forest.
+struct ReorderingEstimate {
+  // The number of nonzeros of the lower-triangular factor.
+  double num_nonzeros = 0;
+
+  // The number of flops of the factorization.
+  double num_flops = 0;
+
+  // The flops along the most expensive leaf-to-root path of the elimination
+  // forest, where the flops of each fundamental supernode are divided by its
+  // number of columns, over which its dense kernels are parallelized.
+  double critical_path_flops = 0;
+
+  // Returns the estimated time, measured in flops, of a factorization with
+  // the given number of threads through Brent's bound, i.e., the flops per
+  // thread plus those along the critical path.
+  double Cost(Int num_threads) const {
+    return num_flops / num_threads + critical_path_flops;
+  }
+};
+
+// Returns the symbolic estimate of the cost of factoring 'matrix' (with both
+// triangles stored) in the given reordering, from its elimination forest and
+// the structure sizes computed by 'DegreesFromEliminationForest'.
+template <class Field>
+ReorderingEstimate EstimateReordering(const CoordinateMatrix<Field>& matrix,
+                                      const SymmetricOrdering& ordering);
+
+// The caller-owned workspace of a (reentrant) solve.
+template <typename Field>
+using SolveWorkspace = supernodal_ldl::SolveWorkspace<Field>;
+
 // Configuration options for LDL' factorization.
 template <typename Field>
 struct SparseLDLControl {
+  // The fill-reducing reordering used when no ordering is provided.
+  ReorderingStrategy reordering_strategy = kMinimumDegreeReordering;
+
   // The configuration options for the Minimum Degree reordering.
   quotient::MinimumDegreeControl md_control;
 
+  // The configuration options for the nested-dissection reordering.
+  NestedDissectionControl nd_control;
+
+  // The configuration options for the parallel minimum degree reordering.
+  ParallelMinimumDegreeControl pmd_control;
+
+  // The number of threads which an automatic reordering is selected for, or
+  // zero for the concurrency of the current task arena.
+  Int reordering_num_threads = 0;
+
+  // The configuration options for the detection of dense rows, which are
+  // removed from the minimum degree reordering and ordered last.
+  DenseRowControl dense_row_control;
+
+  // The number of consecutive rows (e.g., the degrees of freedom of a mesh
+  // vertex) forming each node of the matrix graph. When it is greater than
+  // one, the reordering computed when no ordering is provided is that of the
+  // (smaller) graph of the nodes, the rows of each node are kept contiguous,
+  // and the couplings between nodes are padded with explicit zeros as needed
+  // so that the rows of each node lie in the same fundamental supernode. The
+  // number of rows of the matrix must be a multiple of the block size.
+  Int block_size = 1;
+
+  // If the reorderings computed when no ordering is provided should be looked
+  // up in, and stored into, the process-wide 'OrderingCache', so that
+  // matrices with a previously factored sparsity pattern skip the reordering.
+  bool cache_orderings = false;
+
   // Whether or not a supernodal factorization should be used.
   SupernodalStrategy supernodal_strategy = kAdaptiveSupernodalStrategy;
 
@@ -56,9 +150,24 @@ struct SparseLDLControl {
   // of the factorization and solve.
   bool equilibrate = false;
 
+  // The number of equilibration passes and their convergence tolerance. The
+  // verbosity is taken from 'verbose'.
+  EquilibrationControl<ComplexBase<Field>> equilibration_control;
+
+  // If the equilibration of a supernodal factorization should be fused into
+  // the loading of the matrix entries into the factor and into the
+  // permutations of the solves, rather than formed in a rescaled copy of the
+  // matrix and applied in separate passes over the right-hand sides.
+  bool fuse_equilibration = false;
+
   // If the high-level logic should print progress information.
   bool verbose = false;
 
+  // If non-null, the execution context which the factorization -- and the
+  // later refactorizations and solves against it -- run within. The context
+  // must outlive the factorization (and its clones).
+  const ExecutionContext* execution_context = nullptr;
+
   // Sets the factorization type for both the scalar and supernodal control
   // structures.
   void SetFactorizationType(SymmetricFactorizationType type) {
@@ -75,37 +184,33 @@ struct SparseLDLControl {
   }
 };
 
-// Configuration options for solving linear systems with iterative refinement.
-template <typename Real>
-struct RefinedSolveControl {
-  // The desired relative error (in the max norm) of the solution. Iteration
-  // stops early if this tolerance is achieved.
-  Real relative_tol = 10 * std::numeric_limits<Real>::epsilon();
-
-  // The maximum number of iterations of iterative refinement to perform.
-  Int max_iters = 3;
-
-  // Whether (typically) higher-precision arithmetic should be used for the
-  // iterative refinement.
-  bool promote = false;
-
-  // Whether convergence progress information should be printed.
-  bool verbose = false;
+// The caller-owned workspace of the iteratively-refined solves against a
+// 'SparseLDL': the buffers of the refinement and of the solves it performs.
+template <typename Field>
+struct SparseLDLRefinedSolveWorkspace {
+  RefinedSolveWorkspace<Field> refinement;
+  SolveWorkspace<Field> solve;
 };
 
-// The return value of iterative refinement.
-template <typename Real>
-struct RefinedSolveStatus {
-  // The number of performed refinement iterations.
-  Int num_iterations;
-
-  // The maximum of the relative max norms of the residual matrix, i.e.,
-  //
-  //   max_j || b_j - A x_j ||_{max} / || b_j ||_{max},
-  //
-  // where we replace any division by zero with division by one. That is, we
-  // use absolute residual norms for any zero right-hand sides.
-  Real residual_relative_max_norm;
+// A snapshot of the numerical state of a 'SparseLDL' (see
+// 'SparseLDL::Checkpoint').
+template <typename Field>
+struct SparseLDLCheckpoint {
+  // The values of a supernodal factorization.
+  supernodal_ldl::FactorCheckpoint<Field> supernodal;
+
+  // The values of the lower and diagonal factors of a scalar factorization.
+  Buffer<Field> scalar_lower_values;
+  Buffer<Field> scalar_diagonal_values;
+
+  // The equilibration of the factored matrix and the statistics of the
+  // factorization which depend upon its values.
+  bool have_equilibration = false;
+  bool fused_equilibration = false;
+  BlasMatrix<ComplexBase<Field>> equilibration;
+  ComplexBase<Field> factored_max_norm = 0;
+  ComplexBase<Field> backward_error_estimate =
+      std::numeric_limits<ComplexBase<Field>>::infinity();
 };
 
 // A wrapper for the scalar and supernodal factorization data structures.
@@ -129,11 +234,20 @@ class SparseLDL {
   std::unique_ptr<SparseLDL> Clone() const {
     std::unique_ptr<SparseLDL> result = std::make_unique<SparseLDL>();
     result->is_supernodal = is_supernodal;
-    if (!is_supernodal || !supernodal_factorization || scalar_factorization)
-        throw std::runtime_error("Only supernodal factorizations support cloning");
-    result->supernodal_factorization = supernodal_factorization->Clone();
+    if (is_supernodal && supernodal_factorization) {
+      result->supernodal_factorization = supernodal_factorization->Clone();
+    } else if (!is_supernodal && scalar_factorization) {
+      result->scalar_factorization = scalar_factorization->Clone();
+    } else {
+      throw std::runtime_error("There is no factorization to clone");
+    }
     result ->have_equilibration_     = have_equilibration_;
     result->equilibration_           = equilibration_;
+    result->fused_equilibration_     = fused_equilibration_;
+    result->equilibration_control_   = equilibration_control_;
+    result->factored_max_norm_       = factored_max_norm_;
+    result->execution_context_       = execution_context_;
+    result->backward_error_estimate_ = backward_error_estimate_;
 
     return result;
   }
@@ -152,6 +266,116 @@ class SparseLDL {
                                 const SparseLDLControl<Field>& control,
                                 bool symbolic_only = false);
 
+  // Performs the factorization using an automatically determined ordering
+  // and overwrites 'right_hand_sides' with the solution of the factored
+  // system. The forward solve of a supernodal factorization is fused into
+  // its right-looking elimination (see
+  // supernodal_ldl::Factorization::FactorAndSolve), which avoids a second
+  // pass over the factor for systems which are only solved once. The
+  // right-hand sides are unspecified if the factorization fails.
+  SparseLDLResult<Field> FactorAndSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const SparseLDLControl<Field>& control,
+      BlasMatrixView<Field>* right_hand_sides);
+
+  // Performs the factorization using a prescribed ordering and solves
+  // against 'right_hand_sides' (see the above 'FactorAndSolve').
+  SparseLDLResult<Field> FactorAndSolve(
+      const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+      const SparseLDLControl<Field>& control,
+      BlasMatrixView<Field>* right_hand_sides);
+
+  // Runs the reordering and the supernodal symbolic analysis of 'matrix' and
+  // returns the estimate of the memory of its numerical factorization with
+  // 'num_threads' threads and of a subsequent solve against
+  // 'num_right_hand_sides' right-hand sides (see
+  // supernodal_ldl::Factorization::EstimateMemory). A supernodal strategy is
+  // always used, and the symbolic factorization replaces any existing one, so
+  // it must be refactored (e.g., through 'RefactorWithFixedSparsityPattern')
+  // before it is used to solve.
+  supernodal_ldl::MemoryEstimate EstimateMemory(
+      const CoordinateMatrix<Field>& matrix,
+      const SparseLDLControl<Field>& control, Int num_threads,
+      Int num_right_hand_sides = 1);
+
+  // Runs the reordering and the supernodal symbolic analysis of 'matrix' (as
+  // in 'EstimateMemory') and returns the report on it, e.g., its factor
+  // nonzeros, flops, tree shape, parallelism and frontal storage (see
+  // supernodal_ldl::Factorization::Analyze), so that orderings and machine
+  // sizes can be compared before any numerical factorization.
+  supernodal_ldl::AnalysisReport Analyze(
+      const CoordinateMatrix<Field>& matrix,
+      const SparseLDLControl<Field>& control, Int num_threads,
+      Int num_right_hand_sides = 1);
+
+  // Eliminates only the first 'num_interior' rows of the matrix reordered by
+  // 'ordering' (whose trailing rows form the interface) and returns the dense
+  // Schur complement onto the interface rows (see
+  // supernodal_ldl::Factorization::FactorPartial). A supernodal factorization
+  // is always used.
+  SparseLDLResult<Field> FactorPartial(const CoordinateMatrix<Field>& matrix,
+                                       const SymmetricOrdering& ordering,
+                                       Int num_interior,
+                                       const SparseLDLControl<Field>& control,
+                                       BlasMatrix<Field>* schur_complement,
+                                       bool symbolic_only = false);
+
+  // Fills 'schur_complement' with the Schur complement onto the interface rows
+  // of the last partial (re)factorization.
+  void PartialSchurComplement(BlasMatrix<Field>* schur_complement) const;
+
+  // Eliminates the interior rows of the right-hand sides of the last partial
+  // factorization, leaving the right-hand sides of the system against
+  // 'PartialSchurComplement' in the interface rows (see
+  // supernodal_ldl::Factorization::PartialForwardSolve).
+  void PartialForwardSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Back-substitutes the interface solution, stored in the interface rows of
+  // the output of 'PartialForwardSolve', into the interior rows.
+  void PartialBackwardSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Saves the symbolic analysis -- and, if 'include_values' is true, the
+  // numerical factor -- of a supernodal factorization into a binary archive
+  // (see supernodal_ldl::Factorization::Save). The numerical factor of an
+  // equilibrated factorization cannot be saved.
+  void Save(const std::string& filename, bool include_values) const;
+
+  // Restores a supernodal factorization from an archive written by 'Save'
+  // (see supernodal_ldl::Factorization::Load), mapping rather than reading
+  // its numerical factor. If the archive holds only the symbolic analysis,
+  // the factorization must be refactored before it is used. Returns whether
+  // the numerical factor was loaded.
+  bool Load(const std::string& filename,
+            const SparseLDLControl<Field>& control);
+
+  // Forms the plan for refactoring through 'RefactorWithFixedSparsityPattern'
+  // with the values of the entries of 'matrix' (see
+  // supernodal_ldl::Factorization::FormConversionPlan). The values are loaded
+  // as-is, so the factorization should not have been equilibrated unless the
+  // equilibration is fused, in which case they are rescaled by the
+  // equilibration of the last factored matrix.
+  void FormConversionPlan(const CoordinateMatrix<Field>& matrix,
+                          ConversionPlan* cplan) const;
+
+  // Forms the plan for refactoring through 'RefactorWithFixedSparsityPattern'
+  // with the values of a compressed-sparse-column (or, if 'compressed_rows',
+  // compressed-sparse-row) matrix with the given pattern, typically after a
+  // symbolic factorization (see
+  // supernodal_ldl::Factorization::FormConversionPlan and, for scalar
+  // factorizations, scalar_ldl::Factorization::FormConversionPlan).
+  void FormConversionPlan(Int num_rows, const Int* offsets, const Int* indices,
+                          bool compressed_rows, ConversionPlan* cplan) const;
+
+  // Returns whether 'cplan' can still load values into the factor. A
+  // supernodal refactorization which delays pivots refolds the layout of the
+  // factor (see 'supernodal_ldl::Control::delayed_pivoting'), after which
+  // the plans formed before it must be re-formed (see
+  // supernodal_ldl::Factorization::ConversionPlanIsCurrent).
+  bool ConversionPlanIsCurrent(const ConversionPlan& cplan) const {
+    return !is_supernodal ||
+           supernodal_factorization->ConversionPlanIsCurrent(cplan);
+  }
+
   // Returns the diagonal perturbation -- in the original ordering -- given
   // the list of diagonal dynamic regularization permutations in the
   // factorization ordering.
@@ -170,25 +394,284 @@ class SparseLDL {
       const CoordinateMatrix<Field>& matrix,
       const SparseLDLControl<Field>& control);
 
+  // Factors a new matrix whose sparsity pattern contains that of a previous
+  // (supernodal) factorization in its leading block, reusing the symbolic
+  // analysis of the subtrees which the new entries and rows do not touch.
+  // Any new rows are eliminated last.
+  SparseLDLResult<Field> RefactorWithGrownSparsityPattern(
+      const CoordinateMatrix<Field>& matrix);
+
+  // Refactors 'A + sigma B' (or 'A + sigma I' if 'Bx' is null) with the
+  // values loaded in place through a plan from 'FormConversionPlan'. A scalar
+  // factorization is refactored with the left-looking algorithm, which
+  // avoids any threading or supernodal overhead for small matrices.
   SparseLDLResult<Field> RefactorWithFixedSparsityPattern(const ConversionPlan &cplan, const Field *Ax, Field sigma = 0, const Field *Bx = nullptr) {
+      if (ShouldEnterExecutionContext(execution_context_)) {
+        return execution_context_->Execute([&]() {
+          return RefactorWithFixedSparsityPattern(cplan, Ax, sigma, Bx);
+        });
+      }
+      if (ShouldEnterFlushToZero()) {
+        return RunWithFlushToZero([&]() {
+          return RefactorWithFixedSparsityPattern(cplan, Ax, sigma, Bx);
+        });
+      }
       if (is_supernodal) {
         return supernodal_factorization->RefactorWithFixedSparsityPattern(cplan, Ax, sigma, Bx);
       }
-      throw std::runtime_error("Implemented for supernodal only");
+      return scalar_factorization->RefactorWithFixedSparsityPattern(cplan, Ax,
+                                                                    sigma, Bx);
+  }
+
+  // Refactors the linear combination 'sum_k coefficients[k] X_k + shift I'
+  // of the value arrays 'X_k = values[k]' -- such as 'K - omega^2 M +
+  // i omega C' at one frequency of a sweep -- each loaded in place through
+  // 'cplan'. The combination is formed as the entries are loaded into the
+  // factor, so that it is never stored.
+  SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
+      const ConversionPlan& cplan, const Buffer<const Field*>& values,
+      const Buffer<Field>& coefficients, Field shift = 0) {
+    if (ShouldEnterExecutionContext(execution_context_)) {
+      return execution_context_->Execute([&]() {
+        return RefactorWithFixedSparsityPattern(cplan, values, coefficients,
+                                                shift);
+      });
+    }
+    if (ShouldEnterFlushToZero()) {
+      return RunWithFlushToZero([&]() {
+        return RefactorWithFixedSparsityPattern(cplan, values, coefficients,
+                                                shift);
+      });
+    }
+    if (is_supernodal) {
+      return supernodal_factorization->RefactorWithFixedSparsityPattern(
+          cplan, values, coefficients, shift);
+    }
+    return scalar_factorization->RefactorWithFixedSparsityPattern(
+        cplan, values, coefficients, shift);
   }
 
+  // Refactors the combination (as above) of 'values' with the coefficients
+  // of each column of 'coefficients', which has a row per value array, and
+  // calls 'callback(index, ldl, result)' with the factorization 'ldl' of
+  // column 'index' and its result, e.g., to solve at the frequency 'index' of
+  // a sweep. The columns are factored concurrently, each in a clone of this
+  // (unmodified) factorization which is recycled once its callback returns,
+  // so that only as many clones are formed as there are columns in flight.
+  // The callback may thus be called concurrently.
+  template <typename Callback>
+  void RefactorCombinations(const ConversionPlan& cplan,
+                            const Buffer<const Field*>& values,
+                            const ConstBlasMatrixView<Field>& coefficients,
+                            const Callback& callback) const;
+
+  // Refactors 'A + sigma B' (or 'A + sigma I' if 'Bx' is null) as above after
+  // only the columns 'changed_columns' (in the original ordering) changed in
+  // value, recomputing only the affected supernodes (see
+  // supernodal_ldl::Factorization::RefactorChangedColumns). A scalar
+  // factorization, which is only used for small matrices, is refactored in
+  // full.
+  SparseLDLResult<Field> RefactorChangedColumns(
+      const Buffer<Int>& changed_columns, const ConversionPlan& cplan,
+      const Field* Ax, Field sigma = 0, const Field* Bx = nullptr) {
+    if (ShouldEnterExecutionContext(execution_context_)) {
+      return execution_context_->Execute([&]() {
+        return RefactorChangedColumns(changed_columns, cplan, Ax, sigma, Bx);
+      });
+    }
+    if (ShouldEnterFlushToZero()) {
+      return RunWithFlushToZero([&]() {
+        return RefactorChangedColumns(changed_columns, cplan, Ax, sigma, Bx);
+      });
+    }
+    if (is_supernodal) {
+      return supernodal_factorization->RefactorChangedColumns(
+          changed_columns, cplan, Ax, sigma, Bx);
+    }
+    return scalar_factorization->RefactorWithFixedSparsityPattern(cplan, Ax,
+                                                                  sigma, Bx);
+  }
+
+  // Refactors 'A + sigma B' (or 'A + sigma I' if 'Bx' is null) for each of
+  // the increasing shifts 'sigmas' concurrently, each in its own copy of the
+  // factor values, and keeps the factorization with the smallest shift for
+  // which every pivot succeeded, whose index is returned (or -1 if there is
+  // none, in which case the factorization with the largest shift is kept).
+  // Success is assumed to be monotone in the shift -- as it is for Cholesky
+  // factorizations with positive semidefinite B -- so a failure cancels the
+  // attempts with smaller shifts and a success those with larger shifts.
+  // Cancelled attempts are reported with 'num_successful_pivots' set to -1.
+  Int RefactorWithShifts(const ConversionPlan& cplan, const Field* Ax,
+                         const Buffer<Field>& sigmas, const Field* Bx,
+                         Buffer<SparseLDLResult<Field>>* results);
+
+  // Refactors 'A - sigma B' (or 'A - sigma I' if 'Bx' is null) for each of
+  // the shifts 'sigmas' through copies of the factor values, reusing the
+  // symbolic analysis of this (unmodified) factorization, and returns the
+  // pivot counts at each shift in 'results'. For a self-adjoint 'A' and a
+  // positive-definite 'B', 'num_negative_pivots' is then the number of
+  // eigenvalues of the pencil (A, B) less than the shift, so that the number
+  // within an interval is a difference of two counts (spectrum slicing). The
+  // shifts are factored concurrently, with a copy of the factor values per
+  // shift in flight. A shift which is (numerically) an eigenvalue can stop its
+  // factorization early, as reported by 'num_successful_pivots'.
+  void ShiftedInertias(const ConversionPlan& cplan, const Field* Ax,
+                       const Buffer<Field>& sigmas, const Field* Bx,
+                       Buffer<SparseLDLResult<Field>>* results) const;
+
+  // Launches 'Factor(matrix, control, symbolic_only)' as a task enqueued in
+  // 'arena' and returns a future for its result (which rethrows any error of
+  // the factorization), so that the calling thread can, e.g., assemble the
+  // next matrix while it runs. Several independent factorizations can be in
+  // flight in the same arena, where their parallel loops share its worker
+  // threads rather than each occupying a thread of its own. The matrix must
+  // remain valid, and this factorization must not otherwise be used, until
+  // the future is ready; the control structure is copied. The future should
+  // not be waited upon from within a task of 'arena'.
+  std::future<SparseLDLResult<Field>> FactorAsync(
+      tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+      const SparseLDLControl<Field>& control, bool symbolic_only = false);
+
+  // As above, but with a prescribed ordering, which is copied.
+  std::future<SparseLDLResult<Field>> FactorAsync(
+      tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+      const SymmetricOrdering& ordering,
+      const SparseLDLControl<Field>& control, bool symbolic_only = false);
+
+  // Launches 'RefactorWithFixedSparsityPattern(matrix)' in 'arena' (see
+  // 'FactorAsync').
+  std::future<SparseLDLResult<Field>> RefactorAsync(
+      tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix);
+
+  // Launches 'RefactorWithFixedSparsityPattern(matrix, control)' in 'arena'
+  // (see 'FactorAsync').
+  std::future<SparseLDLResult<Field>> RefactorAsync(
+      tbb::task_arena* arena, const CoordinateMatrix<Field>& matrix,
+      const SparseLDLControl<Field>& control);
+
+  // Launches 'RefactorWithFixedSparsityPattern(cplan, Ax, sigma, Bx)' in
+  // 'arena' (see 'FactorAsync'). The plan and the values must remain valid
+  // until the future is ready.
+  std::future<SparseLDLResult<Field>> RefactorAsync(
+      tbb::task_arena* arena, const ConversionPlan& cplan, const Field* Ax,
+      Field sigma = 0, const Field* Bx = nullptr);
+
   // Returns the number of rows of the last factored matrix.
   Int NumRows() const;
 
+  // Frees any factorization workspace that was kept alive between
+  // refactorizations (see 'supernodal_ldl::Control::persistent_workspace').
+  void ReleaseWorkspace();
+
   // Solves a set of linear systems using the factorization.
   void Solve(BlasMatrixView<Field>* right_hand_sides, bool already_permuted = false) const;
 
+  // Solves a set of linear systems using a caller-owned workspace, so that
+  // any number of threads may solve concurrently against this factorization,
+  // each with its own (reusable) workspace (see
+  // supernodal_ldl::Factorization::Solve). Scalar factorizations only use its
+  // 'permute_scratch'.
+  void Solve(BlasMatrixView<Field>* right_hand_sides,
+             SolveWorkspace<Field>* workspace,
+             bool already_permuted = false) const;
+
+  // Solves a set of linear systems against the transpose, conjugate, or
+  // adjoint of the factored matrix (see
+  // supernodal_ldl::Factorization::Solve). Scalar factorizations conjugate
+  // the right-hand sides around a standard solve.
+  void Solve(BlasMatrixView<Field>* right_hand_sides,
+             supernodal_ldl::SolveOperation operation,
+             SolveWorkspace<Field>* workspace = nullptr) const;
+
+  // Solves several independent batches of right-hand sides (e.g., from
+  // different clients) with a single traversal of the factorization, so that
+  // each supernodal panel is loaded once for all of the batches rather than
+  // once per batch. The batches are packed side by side into one block of
+  // right-hand sides, solved, and unpacked. Each batch must have 'NumRows()'
+  // rows. The workspace serves as in the single-batch 'Solve'.
+  void SolveBatches(const Buffer<BlasMatrixView<Field>*>& batches,
+                    SolveWorkspace<Field>* workspace = nullptr) const;
+
+  // Prepares the right-hand-side independent state of the solves against up
+  // to 'max_num_rhs' right-hand sides in the given workspace (or, if it is
+  // null, the factorization's own) -- see
+  // supernodal_ldl::Factorization::PrepareSolve. It may run concurrently with
+  // a numerical refactorization. Only the 'permute_scratch' of a workspace is
+  // prepared for scalar factorizations, whose own solves keep no state.
+  void PrepareSolve(Int max_num_rhs,
+                    SolveWorkspace<Field>* workspace = nullptr) const;
+
+  // Solves a set of linear systems whose right-hand sides are only nonzero in
+  // the rows 'rhs_support', only computing the rows 'requested_indices' of
+  // the solution (see supernodal_ldl::Factorization::SolveSparse). Neither
+  // index list may contain duplicates. The remaining rows of
+  // 'right_hand_sides' are left unmodified.
+  void SolveSparse(const Buffer<Int>& rhs_support,
+                   const Buffer<Int>& requested_indices,
+                   BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Fills 'diagonal' with the diagonal of the inverse of the factored matrix
+  // (see supernodal_ldl::Factorization::InverseDiagonal).
+  void InverseDiagonal(Buffer<Field>* diagonal) const;
+
+  // Fills 'basis' with an orthonormal basis for the null space of a matrix
+  // factored with rank detection (see
+  // supernodal_ldl::Control::rank_detection), which is empty if no pivot was
+  // singular.
+  void NullSpaceBasis(BlasMatrix<Field>* basis) const;
+
+  // Overwrites the right-hand sides with the pseudo-inverse of a matrix
+  // factored with rank detection applied to them (see
+  // supernodal_ldl::Factorization::PseudoinverseSolve).
+  void PseudoinverseSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Modifies the factorization of A into that of A + sign W W' (see
+  // supernodal_ldl::Factorization::UpdateDowndate).
+  bool UpdateDowndate(const ConstBlasMatrixView<Field>& vectors, Int sign);
+
+  // Snapshots the numerical values of the factorization so that a later
+  // refactorization with the same sparsity pattern (e.g., the trial step of
+  // a line search) can be undone by 'Restore' at the cost of a copy (see
+  // supernodal_ldl::Factorization::Checkpoint).
+  void Checkpoint(SparseLDLCheckpoint<Field>* checkpoint) const;
+
+  // Restores the numerical values snapshotted by 'Checkpoint' in place.
+  void Restore(const SparseLDLCheckpoint<Field>& checkpoint);
+
   // Solves a set of linear systems using iterative refinement.
   RefinedSolveStatus<Real> RefinedSolve(
       const CoordinateMatrix<Field>& matrix,
       const RefinedSolveControl<Real>& control,
       BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  RefinedSolveStatus<Real> RefinedSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
+  // Solves a set of linear systems using iterative refinement whose
+  // residuals are formed by a matrix-free operator rather than an assembled
+  // matrix, so that the matrix need not be kept. As with 'FGMRES',
+  // 'apply_matrix(alpha, input, beta, &output)' must overwrite 'output' with
+  // 'alpha A input + beta output' for views with any number of columns. The
+  // residuals are formed in the working precision, so 'control.promote' is
+  // not supported.
+  template <class ApplyOperator>
+  RefinedSolveStatus<Real> RefinedSolve(
+      const ApplyOperator& apply_matrix,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  template <class ApplyOperator>
+  RefinedSolveStatus<Real> RefinedSolve(
+      const ApplyOperator& apply_matrix,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
   // Solve with iterative refinement and a diagonal scaling:
   //
   //     (D A D) (inv(D) x) = (D b).
@@ -204,6 +687,32 @@ class SparseLDL {
       const RefinedSolveControl<Real>& control,
       BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  RefinedSolveStatus<ComplexBase<Field>> DiagonallyScaledRefinedSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const ConstBlasMatrixView<Real>& scaling,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
+  // The diagonally-scaled refinement with a matrix-free operator applying
+  // the unscaled matrix (see the matrix-free 'RefinedSolve').
+  template <class ApplyOperator>
+  RefinedSolveStatus<ComplexBase<Field>> DiagonallyScaledRefinedSolve(
+      const ApplyOperator& apply_matrix,
+      const ConstBlasMatrixView<Real>& scaling,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  template <class ApplyOperator>
+  RefinedSolveStatus<ComplexBase<Field>> DiagonallyScaledRefinedSolve(
+      const ApplyOperator& apply_matrix,
+      const ConstBlasMatrixView<Real>& scaling,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
   // Solves a set of linear systems using iterative refinement in the presence
   // of dynamic regularization.
   RefinedSolveStatus<Real> DynamicallyRegularizedRefinedSolve(
@@ -212,6 +721,14 @@ class SparseLDL {
       const RefinedSolveControl<Real>& control,
       BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  RefinedSolveStatus<Real> DynamicallyRegularizedRefinedSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const SparseLDLResult<Field>& result,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
   // Solve with iterative refinement and a diagonal scaling in the presence of
   // dynamic regularization:
   //
@@ -230,6 +747,16 @@ class SparseLDL {
       const RefinedSolveControl<Real>& control,
       BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Equivalent to the above, but reuses the buffers held by 'workspace'.
+  RefinedSolveStatus<ComplexBase<Field>>
+  DiagonallyScaledDynamicallyRegularizedRefinedSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const SparseLDLResult<Field>& result,
+      const ConstBlasMatrixView<Real>& scaling,
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
+
   // Solves a set of linear systems using the lower-triangular factor.
   void LowerTriangularSolve(BlasMatrixView<Field>* right_hand_sides) const;
 
@@ -247,6 +774,19 @@ class SparseLDL {
   // Prints the diagonal factor of the factorization.
   void PrintDiagonalFactor(const std::string& label, std::ostream& os) const;
 
+  // Returns the a priori estimate of the relative (normwise) backward error of
+  // a single solve with the last factorization,
+  //
+  //   epsilon * max(1, pivot_growth) + max |regularization| / || A ||_{max},
+  //
+  // where 'A' is the factored (possibly equilibrated) matrix and the pivot
+  // growth is that of the returned 'SparseLDLResult'. The estimate is
+  // infinite if the factorization was incomplete or did not track its pivots
+  // (i.e., was not supernodal). The sparse-direct refined solves report it
+  // and can skip refinement based upon it (see
+  // 'RefinedSolveControl::skip_if_estimated_accurate').
+  Real BackwardErrorEstimate() const;
+
   // Returns an immutable reference to the permutation mapping from the original
   // indices into the factorization's.
   const Buffer<Int>& Permutation() const;
@@ -260,18 +800,87 @@ class SparseLDL {
   bool have_equilibration_;
   BlasMatrix<Real> equilibration_;
 
-  // Solves a set of linear systems using iterative refinement.
+  // Whether the equilibration is applied by the supernodal factorization as
+  // it loads the matrix and permutes the right-hand sides (see
+  // 'SparseLDLControl::fuse_equilibration').
+  bool fused_equilibration_ = false;
+
+  // The configuration of the equilibration passes.
+  EquilibrationControl<Real> equilibration_control_;
+
+  // The max norm of the factored (and possibly equilibrated) matrix and the a
+  // priori backward error estimate of the last factorization.
+  Real factored_max_norm_ = 0;
+  Real backward_error_estimate_ = std::numeric_limits<Real>::infinity();
+
+  // The execution context of the last factorization (see
+  // 'SparseLDLControl::execution_context'), if any.
+  const ExecutionContext* execution_context_ = nullptr;
+
+  // The right-hand sides of the running 'FactorAndSolve' until a supernodal
+  // factorization takes over their solve.
+  BlasMatrixView<Field>* fused_right_hand_sides_ = nullptr;
+
+  // Runs the supernodal factorization of the (possibly equilibrated) matrix,
+  // fused with the solve of a running 'FactorAndSolve' (if any).
+  SparseLDLResult<Field> FactorSupernodal(
+      const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
+      const SparseLDLControl<Field>& control, bool symbolic_only);
+
+  // Factors a matrix whose rows form nodes of 'control.block_size' rows by
+  // reordering the graph of the nodes (see 'SparseLDLControl::block_size').
+  SparseLDLResult<Field> FactorBlocks(const CoordinateMatrix<Field>& matrix,
+                                      const SparseLDLControl<Field>& control,
+                                      bool symbolic_only);
+
+  // Enqueues 'function', which returns the result of a factorization, as a
+  // task in 'arena' and returns a future for its result.
+  template <class Function>
+  static std::future<SparseLDLResult<Field>> LaunchAsync(
+      tbb::task_arena* arena, Function&& function);
+
+  // Computes the equilibration of the given matrix (if enabled) and returns
+  // the matrix to factor: a fused equilibration is handed to the supernodal
+  // factorization, which rescales the entries as it loads them, and otherwise
+  // the rescaled matrix is formed in 'equilibrated_matrix'.
+  const CoordinateMatrix<Field>* EquilibrateMatrix(
+      const CoordinateMatrix<Field>& matrix, bool verbose,
+      CoordinateMatrix<Field>* equilibrated_matrix);
+
+  // Wraps the dynamic regularization and the log-determinant of a full
+  // factorization of the equilibrated matrix so that they refer to the
+  // original matrix.
+  void UnequilibrateResult(SparseLDLResult<Field>* result) const;
+
+  // Fills in the pivot growth of a factorization of the matrix most recently
+  // passed to 'EquilibrateMatrix' and updates the backward error estimate.
+  void EstimateAccuracy(SparseLDLResult<Field>* result);
+
+  // If the control allows refinement to be skipped and the backward error
+  // estimate is within its tolerance, solves the systems directly, fills in
+  // 'status', and returns true.
+  bool SolveIfEstimatedAccurate(
+      const RefinedSolveControl<Real>& control,
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace,
+      RefinedSolveStatus<Real>* status) const;
+
+  // Solves a set of linear systems using iterative refinement, where
+  // 'apply_matrix' forms the residuals (see the matrix-free 'RefinedSolve').
+  template <class ApplyOperator>
   RefinedSolveStatus<Real> RefinedSolveHelper(
-      const CoordinateMatrix<Field>& matrix,
+      const ApplyOperator& apply_matrix,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides) const;
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solves a set of linear systems using iterative refinement with
   // higher-precision forward multiplies.
   RefinedSolveStatus<Real> PromotedRefinedSolveHelper(
       const CoordinateMatrix<Field>& matrix,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides_lower) const;
+      BlasMatrixView<Field>* right_hand_sides_lower,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solve with iterative refinement and a diagonal scaling:
   //
@@ -281,12 +890,15 @@ class SparseLDL {
   // several subgroups, and the relative accuracy of each subgroup is desired
   // to be controlled. One can thus construct the diagonal matrix D to be
   // piecewise constant, with each piece being set to the inverse of the norm
-  // of the subgroup of the right-hand side vector.
+  // of the subgroup of the right-hand side vector. The unscaled matrix is
+  // applied by 'apply_matrix' (see the matrix-free 'RefinedSolve').
+  template <class ApplyOperator>
   RefinedSolveStatus<ComplexBase<Field>> DiagonallyScaledRefinedSolveHelper(
-      const CoordinateMatrix<Field>& matrix,
+      const ApplyOperator& apply_matrix,
       const ConstBlasMatrixView<Real>& scaling,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides) const;
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Uses a higher-precision to solve with iterative refinement and a diagonal
   // scaling:
@@ -303,7 +915,8 @@ class SparseLDL {
       const CoordinateMatrix<Field>& matrix,
       const ConstBlasMatrixView<Real>& scaling,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides_lower) const;
+      BlasMatrixView<Field>* right_hand_sides_lower,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solves a set of linear systems using iterative refinement in the presence
   // of dynamic regularization.
@@ -311,7 +924,8 @@ class SparseLDL {
       const CoordinateMatrix<Field>& matrix,
       const SparseLDLResult<Field>& result,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides) const;
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solves a set of linear systems using iterative refinement in the presence
   // of dynamic regularization.
@@ -319,7 +933,8 @@ class SparseLDL {
       const CoordinateMatrix<Field>& matrix,
       const SparseLDLResult<Field>& result,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides_lower) const;
+      BlasMatrixView<Field>* right_hand_sides_lower,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solve with iterative refinement and a diagonal scaling in the presence of
   // dynamic regularization:
@@ -337,7 +952,8 @@ class SparseLDL {
       const SparseLDLResult<Field>& result,
       const ConstBlasMatrixView<Real>& scaling,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides) const;
+      BlasMatrixView<Field>* right_hand_sides,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 
   // Solve with higher-precision iterative refinement and a diagonal scaling in
   // the presence of dynamic regularization:
@@ -355,7 +971,8 @@ class SparseLDL {
       const SparseLDLResult<Field>& result,
       const ConstBlasMatrixView<Real>& scaling,
       const RefinedSolveControl<Real>& control,
-      BlasMatrixView<Field>* right_hand_sides_lower) const;
+      BlasMatrixView<Field>* right_hand_sides_lower,
+      SparseLDLRefinedSolveWorkspace<Field>* workspace) const;
 };
 
 // Append the children's dynamic regularizations.
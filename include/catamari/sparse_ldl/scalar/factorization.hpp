@@ -8,10 +8,13 @@
 #ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_H_
 #define CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_H_
 
+#include <cstddef>
+#include <memory>
 #include <ostream>
 
 #include "catamari/blas_matrix_view.hpp"
 #include "catamari/buffer.hpp"
+#include "catamari/conversion_plan.hpp"
 #include "catamari/coordinate_matrix.hpp"
 #include "catamari/dynamic_regularization.hpp"
 #include "catamari/integers.hpp"
@@ -68,12 +71,92 @@ struct SparseLDLResult {
   // equal the number of rows in the matrix.
   Int num_successful_pivots = 0;
 
+  // The number of successful pivots with positive (resp. negative) real part,
+  // which, for self-adjoint factorizations, determine the inertia of the
+  // matrix. These are only tracked by the supernodal factorizations.
+  Int num_positive_pivots = 0;
+  Int num_negative_pivots = 0;
+
+  // The number of successful pivots with zero real part. Since an exactly
+  // zero pivot stops the factorization, this can only be nonzero for pivots
+  // with a nonzero imaginary part in complex-symmetric factorizations.
+  Int num_zero_pivots = 0;
+
+  // The logarithm of the absolute value of the product of the successful
+  // pivots and the phase, of unit modulus, of that product. If the
+  // factorization succeeded, the determinant of the matrix (including any
+  // dynamic regularization) is 'determinant_phase * exp(log_abs_determinant)'.
+  // These are accumulated from the diagonal blocks as they are factored, and
+  // are only tracked by the supernodal factorizations.
+  Real log_abs_determinant = 0;
+  Field determinant_phase = Field{1};
+
+  // The largest modulus of the successful pivots of the factored (and possibly
+  // equilibrated) matrix, where the pivots of a Cholesky factorization are the
+  // squares of the diagonal of L, and its ratio to the largest entry modulus
+  // of that matrix. The latter measures the growth of the factorization and
+  // drives the a priori backward error estimate of the solves (see
+  // 'SparseLDL::BackwardErrorEstimate'). These are only tracked by the
+  // supernodal factorizations.
+  Real largest_abs_pivot = 0;
+  Real pivot_growth = 0;
+
   // The largest supernode size (after any relaxation).
   Int largest_supernode = 1;
 
   // The number of explicit entries in the factor.
   Int num_factorization_entries = 0;
 
+  // The numbers of fundamental supernodes and of supernodes after relaxation,
+  // and the number of explicit zeros stored in the factor due to the
+  // relaxation. These are only tracked by the supernodal factorizations.
+  Int num_fundamental_supernodes = 0;
+  Int num_relaxed_supernodes = 0;
+  Int num_relaxation_zeros = 0;
+
+  // The factorization time of the relaxed supernode partition predicted by
+  // the relaxation cost model (see 'SupernodalRelaxationControl'), so that
+  // partitions from the fixed explicit-zero ratios and from the cost model
+  // may be compared.
+  double relaxation_estimated_seconds = 0;
+
+  // The number of dense rows which were removed from the minimum degree
+  // reordering and ordered last (see 'DenseRowControl'), the number of
+  // off-diagonal entries above which a row was considered dense, and the
+  // largest number of off-diagonal entries of a deferred row.
+  Int num_deferred_dense_rows = 0;
+  Int dense_row_degree_threshold = 0;
+  Int max_deferred_row_degree = 0;
+
+  // The number of supernodes whose subdiagonal blocks were compressed by the
+  // block low-rank mode of the supernodal factorization, the number of
+  // entries of those blocks, and the number of entries (and of bytes, which
+  // reflect any reduced storage precision) which their compressed tiles
+  // store instead.
+  Int num_compressed_supernodes = 0;
+  Int num_compressed_block_entries = 0;
+  Int num_low_rank_entries = 0;
+  std::size_t num_low_rank_bytes = 0;
+
+  // The number of fronts finished on a CUDA device by the offload mode of
+  // the supernodal factorization.
+  Int num_device_fronts = 0;
+
+  // The number of pivots which the delayed-pivoting mode of the supernodal
+  // factorization delayed from a front into that of its parent, where a
+  // pivot delayed across several fronts is counted once per delay.
+  Int num_delayed_pivots = 0;
+
+  // The number of pivots which the rank detection of the supernodal
+  // factorization recorded as singular (and replaced by zero). They count as
+  // successful pivots but are excluded from the pivot signs and the
+  // determinant, which is then that of the nonsingular part.
+  Int num_singular_pivots = 0;
+
+  // Whether the factorization was stopped early by its cancellation token
+  // (see 'CancellationToken'), in which case the factor is incomplete.
+  bool cancelled = false;
+
   // The rough number of flops required to factorize the diagonal blocks.
   //
   // In the case of complex factorizations, this is in terms of the number of
@@ -100,11 +183,40 @@ struct SparseLDLResult {
   // real flops.
   double num_factorization_flops = 0;
 
+  // Always-on counters of the work of the phases of the supernodal
+  // factorizations: the numbers of diagonal blocks factored, of subdiagonal
+  // blocks solved against them, of Schur complements formed, and of child
+  // Schur complements merged into their parents' fronts, together with the
+  // bytes of the merged child Schur complements and the largest number of
+  // bytes of any serial subtree's Schur complement stack in use at once.
+  // Each thread accumulates them into the result of the subtree it is
+  // processing, so no synchronization is needed; the merges and the stack
+  // are only tracked by the right-looking factorization.
+  Int num_factor_tasks = 0;
+  Int num_trsm_tasks = 0;
+  Int num_herk_tasks = 0;
+  Int num_merge_tasks = 0;
+  std::size_t num_merged_bytes = 0;
+  std::size_t max_stack_bytes = 0;
+
+  // The high-water mark of the bytes held at once by all of the Schur
+  // complement storage of the multithreaded right-looking factorization
+  // (including any workspace kept from a previous factorization). Unless the
+  // workspace is persistent, it should not exceed the
+  // 'parallel_frontal_bytes' of 'supernodal_ldl::MemoryEstimate'.
+  std::size_t peak_frontal_bytes = 0;
+
   // If dynamic regularization is enabled, this will hold the dynamically
   // generated diagonal shifts. We require these modifications to be
   // real-valued and store them as sparse corrections in the factorization
   // ordering. The indexing is with respect to the *original* matrix ordering.
   std::vector<std::pair<Int, Real>> dynamic_regularization;
+
+  // If 'DynamicRegularizationControl::diagonal_output' was set for a
+  // supernodal factorization, the list above is left empty and this instead
+  // holds the shift of each index of the original ordering (zero for those
+  // which were not regularized).
+  Buffer<Real> dynamic_regularization_diagonal;
 };
 
 namespace scalar_ldl {
@@ -120,6 +232,18 @@ struct Control {
 
   // The amount of dynamic regularization -- if any -- to use.
   DynamicRegularizationControl<Field> dynamic_regularization;
+
+  // The maximum number of rows of a subtree of the elimination forest which
+  // the multithreaded up-looking factorization factors as a single task. The
+  // up-looking factorization is only multithreaded if more than one TBB
+  // thread is available and the matrix has more rows than this.
+  Int up_looking_grain_size = 1024;
+
+  // The minimum number of rows of a factorization before the level sets of
+  // its elimination forest are formed, so that the triangular solves can
+  // process the rows of each level concurrently when more than one TBB
+  // thread is available.
+  Int min_level_scheduled_solve_rows = 4096;
 };
 
 // The nonzero patterns below the diagonal of the lower-triangular factor.
@@ -232,10 +356,13 @@ class Factorization {
   SymmetricOrdering ordering;
 
   // Set the factor to the L L^T, L D L^T, or L D L' factorization of the given
-  // permutation of the given matrix.
+  // permutation of the given matrix. If 'symbolic_only' is true, only the
+  // structure of the factor is formed (as by the left-looking setup), so that
+  // conversion plans may be formed before the first numerical factorization.
   SparseLDLResult<Field> Factor(const CoordinateMatrix<Field>& matrix,
                                 const SymmetricOrdering& ordering,
-                                const Control<Field>& control_value);
+                                const Control<Field>& control_value,
+                                bool symbolic_only = false);
 
   // Factors a matrix which has the same sparsity pattern as the previously
   // factored matrix.
@@ -249,6 +376,38 @@ class Factorization {
       const CoordinateMatrix<Field>& matrix,
       const Control<Field>& control_value);
 
+  // Returns a deep copy of the factorization, so that the copies may be
+  // refactored and solved against independently (e.g., one per thread).
+  std::unique_ptr<Factorization> Clone() const;
+
+  // Forms the plan for loading the values of a symmetric matrix stored in the
+  // compressed-sparse-column (or, if 'compressed_rows' is true,
+  // compressed-sparse-row) pattern 'offsets'/'indices', in the original
+  // ordering, into the factor (cf.
+  // supernodal_ldl::Factorization::FormConversionPlan). The source of each
+  // entry is its index in 'indices'; the destinations below
+  // 'lower_factor.values.Size()' index the strictly lower factor and the
+  // remaining ones the diagonal. The structure of the factor must have been
+  // formed, i.e., the first factorization must have been left-looking or
+  // have succeeded.
+  void FormConversionPlan(Int num_rows, const Int* offsets, const Int* indices,
+                          bool compressed_rows, ConversionPlan* cplan) const;
+
+  // Factors 'A + sigma B' (or 'A + sigma I' if 'Bx' is null), whose values
+  // are loaded through 'cplan' directly into the factor, with the
+  // left-looking algorithm. Neither the matrix nor its pattern is needed, so
+  // only the values change hands.
+  SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
+      const ConversionPlan& cplan, const Field* Ax, Field sigma = 0,
+      const Field* Bx = nullptr);
+
+  // Factors the linear combination 'sum_k coefficients[k] X_k + shift I' of
+  // the value arrays 'X_k = values[k]', each loaded through 'cplan' as by the
+  // above.
+  SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
+      const ConversionPlan& cplan, const Buffer<const Field*>& values,
+      const Buffer<Field>& coefficients, Field shift = 0);
+
   // Pretty-prints the diagonal matrix.
   void PrintDiagonalFactor(const std::string& label, std::ostream& os) const;
 
@@ -258,6 +417,15 @@ class Factorization {
   // Solves a linear system using the factorization.
   void Solve(BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Solves a linear system using the factorization, permuting the right-hand
+  // sides into the caller-owned 'permute_scratch' (which is grown as needed)
+  // so that repeated solves do not allocate and any number of threads may
+  // solve concurrently, each with its own scratch. If 'already_permuted', the
+  // right-hand sides are in the ordering of the factorization.
+  void Solve(BlasMatrixView<Field>* right_hand_sides,
+             Buffer<Field>* permute_scratch,
+             bool already_permuted = false) const;
+
   // Solves against the lower-triangular factor.
   void LowerTriangularSolve(BlasMatrixView<Field>* right_hand_sides) const;
 
@@ -268,6 +436,16 @@ class Factorization {
   void LowerTransposeTriangularSolve(
       BlasMatrixView<Field>* right_hand_sides) const;
 
+  // Solves against the lower-triangular factor, with the rows of each level
+  // of the elimination forest solved concurrently.
+  void OpenMPLowerTriangularSolve(
+      BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Solves against the transpose (or adjoint) of the lower factor, with the
+  // columns of each level of the elimination forest solved concurrently.
+  void OpenMPLowerTransposeTriangularSolve(
+      BlasMatrixView<Field>* right_hand_sides) const;
+
   // Returns the number of rows of the factored matrix.
   Int NumRows() const;
 
@@ -280,6 +458,31 @@ class Factorization {
   const Buffer<Int>& InversePermutation() const;
 
  private:
+  // Whether every index of 'lower_factor.structure' has been filled.
+  bool structure_formed_ = false;
+
+  // The patterns of the rows of the strictly lower factor (the transpose of
+  // 'lower_factor.structure'), which are formed by the first refactorization
+  // through a conversion plan or along with the solve levels.
+  LowerStructure row_patterns_;
+
+  // The offset in 'lower_factor.values' of each entry of 'row_patterns_',
+  // which is only formed along with the solve levels.
+  Buffer<Int> row_value_offsets_;
+
+  // The rows of each level of the elimination forest, where a row's level is
+  // one more than the largest level of its children (and zero for leaves).
+  // Level 'level' consists of
+  //   solve_level_rows_[solve_level_offsets_[level] :
+  //       solve_level_offsets_[level + 1] - 1].
+  // Both are empty unless the solves are level scheduled.
+  Buffer<Int> solve_level_offsets_;
+  Buffer<Int> solve_level_rows_;
+
+  // Forms the row patterns and levels used by the level-scheduled solves if
+  // the factorization is large enough and they have not yet been formed.
+  void FormSolveLevels();
+
   // Performs a non-supernodal left-looking LDL' factorization.
   // Cf. Section 4.8 of Tim Davis, "Direct Methods for Sparse Linear Systems".
   //
@@ -291,11 +494,31 @@ class Factorization {
   SparseLDLResult<Field> LeftLooking(const CoordinateMatrix<Field>& matrix)
       CATAMARI_NOEXCEPT;
 
+  // The left-looking factorization of the values already loaded into the
+  // factor, where 'row_pattern(column, &state, &pattern)' points 'pattern'
+  // to the pattern of row 'column' of the strictly lower factor and returns
+  // its length.
+  template <class RowPattern>
+  SparseLDLResult<Field> LeftLookingKernel(
+      Int num_rows, const ComplexBase<Field>& matrix_max_norm,
+      const RowPattern& row_pattern) CATAMARI_NOEXCEPT;
+
+  // Returns the offset of entry (row, column), with row >= column, of the
+  // permuted matrix in the destinations of a conversion plan.
+  Int FactorEntryOffset(Int row, Int column) const;
+
   // Performs a non-supernodal up-looking LDL' factorization.
   // Cf. Section 4.7 of Tim Davis, "Direct Methods for Sparse Linear Systems".
   SparseLDLResult<Field> UpLooking(const CoordinateMatrix<Field>& matrix)
       CATAMARI_NOEXCEPT;
 
+  // Performs the up-looking factorization with the maximal subtrees of at
+  // most 'control.up_looking_grain_size' rows of the elimination forest
+  // factored concurrently, and each row above them factored by the task
+  // which completes the last of its children.
+  SparseLDLResult<Field> OpenMPUpLooking(
+      const CoordinateMatrix<Field>& matrix) CATAMARI_NOEXCEPT;
+
   // Fill the factorization with the nonzeros from the (permuted) input matrix.
   void FillNonzeros(const CoordinateMatrix<Field>& matrix) CATAMARI_NOEXCEPT;
 
@@ -320,9 +543,12 @@ class Factorization {
 }  // namespace catamari
 
 #include "catamari/sparse_ldl/scalar/factorization/common-impl.hpp"
+#include "catamari/sparse_ldl/scalar/factorization/conversion_plan-impl.hpp"
 #include "catamari/sparse_ldl/scalar/factorization/io-impl.hpp"
 #include "catamari/sparse_ldl/scalar/factorization/left_looking-impl.hpp"
 #include "catamari/sparse_ldl/scalar/factorization/solve-impl.hpp"
+#include "catamari/sparse_ldl/scalar/factorization/solve_openmp-impl.hpp"
 #include "catamari/sparse_ldl/scalar/factorization/up_looking-impl.hpp"
+#include "catamari/sparse_ldl/scalar/factorization/up_looking_openmp-impl.hpp"
 
 #endif  // ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_H_
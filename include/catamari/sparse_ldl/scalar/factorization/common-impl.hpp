@@ -9,6 +9,7 @@
 #define CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_COMMON_IMPL_H_
 
 #include <cmath>
+#include <memory>
 
 #include "catamari/index_utils.hpp"
 #include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
@@ -68,27 +69,45 @@ template <class Field>
 SparseLDLResult<Field> Factorization<Field>::Factor(
     const CoordinateMatrix<Field>& matrix,
     const SymmetricOrdering& manual_ordering,
-    const Control<Field>& control_value) {
+    const Control<Field>& control_value, bool symbolic_only) {
   ordering = manual_ordering;
   control = control_value;
-  if (control.algorithm == kLeftLookingLDL) {
+  structure_formed_ = false;
+  row_patterns_ = LowerStructure();
+  row_value_offsets_.Clear();
+  solve_level_offsets_.Clear();
+  solve_level_rows_.Clear();
+  SparseLDLResult<Field> result;
+  if (symbolic_only || control.algorithm == kLeftLookingLDL) {
     LeftLookingSetup(matrix);
-    return LeftLooking(matrix);
+    if (symbolic_only) {
+      return result;
+    }
+    result = LeftLooking(matrix);
   } else {
     UpLookingSetup(matrix);
-    return UpLooking(matrix);
+    result = UpLooking(matrix);
   }
+  if (result.num_successful_pivots == NumRows()) {
+    FormSolveLevels();
+  }
+  return result;
 }
 
 template <class Field>
 SparseLDLResult<Field> Factorization<Field>::RefactorWithFixedSparsityPattern(
     const CoordinateMatrix<Field>& matrix) {
+  SparseLDLResult<Field> result;
   if (control.algorithm == kLeftLookingLDL) {
     FillNonzeros(matrix);
-    return LeftLooking(matrix);
+    result = LeftLooking(matrix);
   } else {
-    return UpLooking(matrix);
+    result = UpLooking(matrix);
+  }
+  if (result.num_successful_pivots == NumRows()) {
+    FormSolveLevels();
   }
+  return result;
 }
 
 template <class Field>
@@ -96,12 +115,22 @@ SparseLDLResult<Field> Factorization<Field>::RefactorWithFixedSparsityPattern(
     const CoordinateMatrix<Field>& matrix,
     const Control<Field>& control_value) {
   control = control_value;
+  SparseLDLResult<Field> result;
   if (control.algorithm == kLeftLookingLDL) {
     FillNonzeros(matrix);
-    return LeftLooking(matrix);
+    result = LeftLooking(matrix);
   } else {
-    return UpLooking(matrix);
+    result = UpLooking(matrix);
   }
+  if (result.num_successful_pivots == NumRows()) {
+    FormSolveLevels();
+  }
+  return result;
+}
+
+template <class Field>
+std::unique_ptr<Factorization<Field>> Factorization<Field>::Clone() const {
+  return std::make_unique<Factorization<Field>>(*this);
 }
 
 template <class Field>
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
+
+#include "catamari/sparse_ldl/scalar/factorization.hpp"
+
+namespace catamari {
+namespace scalar_ldl {
+
+template <class Field>
+Int Factorization<Field>::FactorEntryOffset(Int row, Int column) const {
+  const LowerStructure& lower_structure = lower_factor.structure;
+  if (row == column) {
+    return lower_structure.indices.Size() + column;
+  }
+  const Int* iter = std::lower_bound(lower_structure.ColumnBeg(column),
+                                     lower_structure.ColumnEnd(column), row);
+  CATAMARI_ASSERT(iter != lower_structure.ColumnEnd(column) && *iter == row,
+                  "Entry (" + std::to_string(row) + ", " +
+                      std::to_string(column) + ") wasn't in the structure.");
+  return std::distance(lower_structure.indices.Data(), iter);
+}
+
+template <class Field>
+void Factorization<Field>::FormConversionPlan(Int num_rows,
+                                              const Int* offsets,
+                                              const Int* indices,
+                                              bool compressed_rows,
+                                              ConversionPlan* cplan) const {
+  if (num_rows != NumRows()) {
+    throw std::runtime_error("Invalid number of pattern rows: " +
+                             std::to_string(num_rows));
+  }
+  if (!structure_formed_) {
+    throw std::runtime_error(
+        "The structure of the factor has not been formed");
+  }
+  const Int num_entries = offsets[num_rows];
+  const bool have_permutation = !ordering.permutation.Empty();
+
+  // The (permuted) column and factor destination of each stored entry, and
+  // whether it was mirrored from the upper triangle of the permuted matrix.
+  struct PatternEntry {
+    Int column, dst, src;
+    bool mirrored;
+  };
+  Buffer<PatternEntry> pattern_entries(num_entries);
+  for (Int outer = 0; outer < num_rows; ++outer) {
+    for (Int index = offsets[outer]; index < offsets[outer + 1]; ++index) {
+      const Int inner = indices[index];
+      Int row = compressed_rows ? outer : inner;
+      Int column = compressed_rows ? inner : outer;
+      if (have_permutation) {
+        row = ordering.permutation[row];
+        column = ordering.permutation[column];
+      }
+      const bool mirrored = row < column;
+      if (mirrored) {
+        std::swap(row, column);
+      }
+      PatternEntry& entry = pattern_entries[index];
+      entry.column = column;
+      entry.dst = FactorEntryOffset(row, column);
+      entry.src = index;
+      entry.mirrored = mirrored;
+    }
+  }
+
+  // Sort the entries by column and then by destination, keeping the copy
+  // which was not mirrored when both triangles are stored.
+  std::sort(pattern_entries.begin(), pattern_entries.end(),
+            [](const PatternEntry& a, const PatternEntry& b) {
+              if (a.column != b.column) return a.column < b.column;
+              if (a.dst != b.dst) return a.dst < b.dst;
+              return !a.mirrored && b.mirrored;
+            });
+  Int num_unique = 0;
+  cplan->columnOffsets.setZero(num_rows + 1);
+  for (Int index = 0; index < num_entries; ++index) {
+    const PatternEntry& entry = pattern_entries[index];
+    if (index == 0 || entry.dst != pattern_entries[index - 1].dst) {
+      ++cplan->columnOffsets[entry.column + 1];
+      ++num_unique;
+    }
+  }
+  for (Int column = 0; column < num_rows; ++column) {
+    cplan->columnOffsets[column + 1] += cplan->columnOffsets[column];
+  }
+  cplan->resize(num_unique);
+  ConversionPlan::Entry* plan_entry = cplan->entries();
+  for (Int index = 0; index < num_entries; ++index) {
+    const PatternEntry& entry = pattern_entries[index];
+    if (index == 0 || entry.dst != pattern_entries[index - 1].dst) {
+      plan_entry->dst = entry.dst;
+      plan_entry->src = entry.src;
+      ++plan_entry;
+    }
+  }
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::RefactorWithFixedSparsityPattern(
+    const ConversionPlan& cplan, const Field* Ax, Field sigma,
+    const Field* Bx) {
+  Buffer<const Field*> values(Bx ? 2 : 1);
+  Buffer<Field> coefficients(values.Size());
+  values[0] = Ax;
+  coefficients[0] = Field{1};
+  if (Bx) {
+    values[1] = Bx;
+    coefficients[1] = sigma;
+  }
+  return RefactorWithFixedSparsityPattern(cplan, values, coefficients,
+                                          Bx ? Field{0} : sigma);
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::RefactorWithFixedSparsityPattern(
+    const ConversionPlan& cplan, const Buffer<const Field*>& values,
+    const Buffer<Field>& coefficients, Field shift) {
+  typedef ComplexBase<Field> Real;
+  if (values.Empty() || values.Size() != coefficients.Size()) {
+    throw std::runtime_error(
+        "Each of the (one or more) terms requires a coefficient");
+  }
+  if (!structure_formed_) {
+    throw std::runtime_error(
+        "The structure of the factor has not been formed");
+  }
+  const Int num_rows = NumRows();
+  if (cplan.columnOffsets.size() != num_rows + 1) {
+    throw std::runtime_error("The conversion plan has the wrong size");
+  }
+  if (row_patterns_.column_offsets.Empty()) {
+    FormRowPatterns(lower_factor.structure, &row_patterns_);
+  }
+
+  // Load the combination directly into the factor.
+  const Int num_terms = values.Size();
+  const Int num_lower_entries = lower_factor.structure.indices.Size();
+  std::fill(lower_factor.values.begin(), lower_factor.values.end(), Field{0});
+  std::fill(diagonal_factor.values.begin(), diagonal_factor.values.end(),
+            Field{0});
+  const ConversionPlan::Entry* entries = cplan.entries();
+  const Int num_plan_entries = cplan.columnOffsets[num_rows];
+  for (Int index = 0; index < num_plan_entries; ++index) {
+    const ConversionPlan::Entry& entry = entries[index];
+    Field value = coefficients[0] * values[0][entry.src];
+    for (Int term = 1; term < num_terms; ++term) {
+      value += coefficients[term] * values[term][entry.src];
+    }
+    if (entry.dst < num_lower_entries) {
+      lower_factor.values[entry.dst] = value;
+    } else {
+      diagonal_factor.values[entry.dst - num_lower_entries] = value;
+    }
+  }
+  if (shift != Field{0}) {
+    for (Int row = 0; row < num_rows; ++row) {
+      diagonal_factor.values[row] += shift;
+    }
+  }
+
+  // The largest modulus of the symmetric matrix is that of its lower
+  // triangle.
+  Real matrix_max_norm = 1;
+  if (control.dynamic_regularization.relative) {
+    matrix_max_norm = 0;
+    for (const Field& value : lower_factor.values) {
+      matrix_max_norm = std::max(matrix_max_norm, Real(std::abs(value)));
+    }
+    for (const Field& value : diagonal_factor.values) {
+      matrix_max_norm = std::max(matrix_max_norm, Real(std::abs(value)));
+    }
+  }
+
+  // The rows of the factor are read from their transposed patterns, so the
+  // matrix pattern is not needed.
+  auto row_pattern = [&](Int column, LeftLookingState* /* state */,
+                         const Int** pattern) {
+    *pattern = row_patterns_.ColumnBeg(column);
+    return row_patterns_.Degree(column);
+  };
+  SparseLDLResult<Field> result =
+      LeftLookingKernel(num_rows, matrix_max_norm, row_pattern);
+  if (result.num_successful_pivots == num_rows) {
+    FormSolveLevels();
+  }
+  return result;
+}
+
+}  // namespace scalar_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+// CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
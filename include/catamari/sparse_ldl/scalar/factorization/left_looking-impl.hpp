@@ -35,14 +35,32 @@ void Factorization<Field>::LeftLookingSetup(
                        &lower_factor.structure);
 
   FillNonzeros(matrix);
+  structure_formed_ = true;
 }
 
 template <class Field>
 SparseLDLResult<Field> Factorization<Field>::LeftLooking(
     const CoordinateMatrix<Field>& matrix) CATAMARI_NOEXCEPT {
-  typedef ComplexBase<Field> Real;
-  const Int num_rows = matrix.NumRows();
   const Buffer<Int>& parents = ordering.assembly_forest.parents;
+  const ComplexBase<Field> matrix_max_norm =
+      control.dynamic_regularization.relative ? MaxNorm(matrix)
+                                              : ComplexBase<Field>(1);
+  auto row_pattern = [&](Int column, LeftLookingState* state,
+                         const Int** pattern) {
+    *pattern = state->row_structure.Data();
+    return ComputeRowPattern(matrix, ordering, parents, column,
+                             state->pattern_flags.Data(),
+                             state->row_structure.Data());
+  };
+  return LeftLookingKernel(matrix.NumRows(), matrix_max_norm, row_pattern);
+}
+
+template <class Field>
+template <class RowPattern>
+SparseLDLResult<Field> Factorization<Field>::LeftLookingKernel(
+    Int num_rows, const ComplexBase<Field>& matrix_max_norm,
+    const RowPattern& row_pattern) CATAMARI_NOEXCEPT {
+  typedef ComplexBase<Field> Real;
   const LowerStructure& lower_structure = lower_factor.structure;
 
   // Fill the dynamic regularization instance.
@@ -56,7 +74,6 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
   reg_params.negative_threshold = std::pow(
       kEpsilon, control.dynamic_regularization.negative_threshold_exponent);
   if (control.dynamic_regularization.relative) {
-    const Real matrix_max_norm = MaxNorm(matrix);
     reg_params.positive_threshold *= matrix_max_norm;
     reg_params.negative_threshold *= matrix_max_norm;
   }
@@ -73,14 +90,13 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
     state.column_update_ptrs[column] = lower_structure.ColumnOffset(column);
 
     // Compute the row pattern.
-    const Int num_packed = ComputeRowPattern(matrix, ordering, parents, column,
-                                             state.pattern_flags.Data(),
-                                             state.row_structure.Data());
+    const Int* pattern;
+    const Int num_packed = row_pattern(column, &state, &pattern);
 
     // for j = find(L(column, :))
     //   L(column:n, column) -= L(column:n, j) * (d(j) * conj(L(column, j)))
     for (Int index = 0; index < num_packed; ++index) {
-      const Int j = state.row_structure[index];
+      const Int j = pattern[index];
       CATAMARI_ASSERT(j < column, "Looking into upper triangle.");
 
       // Find L(column, j) in the j'th column.
@@ -10,6 +10,8 @@
 
 #include <cmath>
 
+#include <tbb/task_arena.h>
+
 #include "catamari/index_utils.hpp"
 #include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
 #include "quotient/io_utils.hpp"
@@ -39,6 +41,41 @@ void Factorization<Field>::Solve(
   }
 }
 
+template <class Field>
+void Factorization<Field>::Solve(BlasMatrixView<Field>* right_hand_sides,
+                                 Buffer<Field>* permute_scratch,
+                                 bool already_permuted) const {
+  const bool have_permutation =
+      !ordering.permutation.Empty() && !already_permuted;
+  if (!have_permutation) {
+    LowerTriangularSolve(right_hand_sides);
+    DiagonalSolve(right_hand_sides);
+    LowerTransposeTriangularSolve(right_hand_sides);
+    return;
+  }
+
+  // Gather the input into the scratch space in the permutation of the
+  // factorization, so that no column copies need be allocated.
+  const Int size = right_hand_sides->height * right_hand_sides->width;
+  if (permute_scratch->Size() < size) {
+    permute_scratch->Resize(size);
+  }
+  BlasMatrixView<Field> permuted_right_hand_sides;
+  permuted_right_hand_sides.height = right_hand_sides->height;
+  permuted_right_hand_sides.width = right_hand_sides->width;
+  permuted_right_hand_sides.leading_dim = right_hand_sides->height;
+  permuted_right_hand_sides.data = permute_scratch->Data();
+  Permute(ordering.permutation, *right_hand_sides, &permuted_right_hand_sides);
+
+  LowerTriangularSolve(&permuted_right_hand_sides);
+  DiagonalSolve(&permuted_right_hand_sides);
+  LowerTransposeTriangularSolve(&permuted_right_hand_sides);
+
+  // Scatter the solution back into the original ordering.
+  Permute(ordering.inverse_permutation, permuted_right_hand_sides,
+          right_hand_sides);
+}
+
 template <class Field>
 void Factorization<Field>::LowerTriangularSolve(
     BlasMatrixView<Field>* right_hand_sides) const {
@@ -49,6 +86,11 @@ void Factorization<Field>::LowerTriangularSolve(
 
   CATAMARI_ASSERT(right_hand_sides->height == num_rows,
                   "matrix was an incorrect height.");
+  if (!solve_level_offsets_.Empty() &&
+      tbb::this_task_arena::max_concurrency() > 1) {
+    OpenMPLowerTriangularSolve(right_hand_sides);
+    return;
+  }
 
   for (Int column = 0; column < num_rows; ++column) {
     if (is_cholesky) {
@@ -103,6 +145,11 @@ void Factorization<Field>::LowerTransposeTriangularSolve(
 
   CATAMARI_ASSERT(right_hand_sides->height == num_rows,
                   "matrix was an incorrect height.");
+  if (!solve_level_offsets_.Empty() &&
+      tbb::this_task_arena::max_concurrency() > 1) {
+    OpenMPLowerTransposeTriangularSolve(right_hand_sides);
+    return;
+  }
 
   for (Int column = num_rows - 1; column >= 0; --column) {
     const Int factor_column_beg = lower_structure.ColumnOffset(column);
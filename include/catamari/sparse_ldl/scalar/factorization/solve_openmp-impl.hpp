@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_SOLVE_OPENMP_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_SOLVE_OPENMP_IMPL_H_
+
+#include <algorithm>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/index_utils.hpp"
+#include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
+
+#include "catamari/sparse_ldl/scalar/factorization.hpp"
+
+namespace catamari {
+namespace scalar_ldl {
+
+// The minimum number of rows of a level which are handed to a single task
+// of the level-scheduled solves. Smaller levels are solved sequentially.
+static constexpr Int kSolveLevelGrainSize = 64;
+
+template <class Field>
+void Factorization<Field>::FormSolveLevels() {
+  const Int num_rows = NumRows();
+  if (!solve_level_offsets_.Empty() ||
+      num_rows < control.min_level_scheduled_solve_rows) {
+    return;
+  }
+  FormRowPatterns(lower_factor.structure, &row_patterns_,
+                  &row_value_offsets_);
+
+  // Since each parent has a larger index than its children, the levels are
+  // formed by a single ascending sweep.
+  const Buffer<Int>& parents = ordering.assembly_forest.parents;
+  Buffer<Int> levels(num_rows, 0);
+  Int num_levels = 0;
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int parent = parents[row];
+    if (parent >= 0) {
+      levels[parent] = std::max(levels[parent], levels[row] + 1);
+    }
+    num_levels = std::max(num_levels, levels[row] + 1);
+  }
+
+  Buffer<Int> level_sizes(num_levels, 0);
+  for (Int row = 0; row < num_rows; ++row) {
+    ++level_sizes[levels[row]];
+  }
+  OffsetScan(level_sizes, &solve_level_offsets_);
+  solve_level_rows_.Resize(num_rows);
+  Buffer<Int> level_ptrs = solve_level_offsets_;
+  for (Int row = 0; row < num_rows; ++row) {
+    solve_level_rows_[level_ptrs[levels[row]]++] = row;
+  }
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPLowerTriangularSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int num_rhs = right_hand_sides->width;
+  const Int num_levels = solve_level_offsets_.Size() - 1;
+  const bool is_cholesky = control.factorization_type == kCholeskyFactorization;
+
+  // Since every column in the pattern of a row is a descendant of the row,
+  // it belongs to an earlier level, and the rows of a level can gather their
+  // updates independently.
+  auto solve_row = [&](Int row) {
+    const Int pattern_beg = row_patterns_.ColumnOffset(row);
+    const Int pattern_end = row_patterns_.ColumnOffset(row + 1);
+    for (Int j = 0; j < num_rhs; ++j) {
+      Field eta = right_hand_sides->Entry(row, j);
+      for (Int index = pattern_beg; index < pattern_end; ++index) {
+        const Int column = row_patterns_.indices[index];
+        const Field& value = lower_factor.values[row_value_offsets_[index]];
+        eta -= value * right_hand_sides->Entry(column, j);
+      }
+      if (is_cholesky) {
+        eta /= diagonal_factor.values[row];
+      }
+      right_hand_sides->Entry(row, j) = eta;
+    }
+  };
+
+  for (Int level = 0; level < num_levels; ++level) {
+    const Int level_beg = solve_level_offsets_[level];
+    const Int level_end = solve_level_offsets_[level + 1];
+    if (level_end - level_beg < 2 * kSolveLevelGrainSize) {
+      for (Int index = level_beg; index < level_end; ++index) {
+        solve_row(solve_level_rows_[index]);
+      }
+      continue;
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(level_beg, level_end, kSolveLevelGrainSize),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int index = range.begin(); index < range.end(); ++index) {
+            solve_row(solve_level_rows_[index]);
+          }
+        });
+  }
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPLowerTransposeTriangularSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int num_rhs = right_hand_sides->width;
+  const LowerStructure& lower_structure = lower_factor.structure;
+  const Int num_levels = solve_level_offsets_.Size() - 1;
+  const bool is_cholesky = control.factorization_type == kCholeskyFactorization;
+  const bool is_selfadjoint =
+      control.factorization_type != kLDLTransposeFactorization;
+
+  // Since every row in the structure of a column is an ancestor of the
+  // column, it belongs to a later level, and the columns of a level can
+  // gather their updates independently.
+  auto solve_column = [&](Int column) {
+    const Int factor_column_beg = lower_structure.ColumnOffset(column);
+    const Int factor_column_end = lower_structure.ColumnOffset(column + 1);
+    for (Int j = 0; j < num_rhs; ++j) {
+      Field eta = right_hand_sides->Entry(column, j);
+      for (Int index = factor_column_beg; index < factor_column_end; ++index) {
+        const Int i = lower_structure.indices[index];
+        const Field& value = lower_factor.values[index];
+        if (is_selfadjoint) {
+          eta -= Conjugate(value) * right_hand_sides->Entry(i, j);
+        } else {
+          eta -= value * right_hand_sides->Entry(i, j);
+        }
+      }
+      if (is_cholesky) {
+        eta /= diagonal_factor.values[column];
+      }
+      right_hand_sides->Entry(column, j) = eta;
+    }
+  };
+
+  for (Int level = num_levels - 1; level >= 0; --level) {
+    const Int level_beg = solve_level_offsets_[level];
+    const Int level_end = solve_level_offsets_[level + 1];
+    if (level_end - level_beg < 2 * kSolveLevelGrainSize) {
+      for (Int index = level_beg; index < level_end; ++index) {
+        solve_column(solve_level_rows_[index]);
+      }
+      continue;
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(level_beg, level_end, kSolveLevelGrainSize),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int index = range.begin(); index < range.end(); ++index) {
+            solve_column(solve_level_rows_[index]);
+          }
+        });
+  }
+}
+
+}  // namespace scalar_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_SOLVE_OPENMP_IMPL_H_
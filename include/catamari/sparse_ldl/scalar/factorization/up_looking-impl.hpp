@@ -10,6 +10,8 @@
 
 #include <cmath>
 
+#include <tbb/task_arena.h>
+
 #include "catamari/index_utils.hpp"
 #include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
 #include "quotient/io_utils.hpp"
@@ -29,6 +31,7 @@ void Factorization<Field>::UpLookingSetup(const CoordinateMatrix<Field>& matrix)
   Buffer<Int> degrees;
   EliminationForestAndDegrees(matrix, ordering,
                               &ordering.assembly_forest.parents, &degrees);
+  ordering.assembly_forest.FillFromParents();
 
   LowerStructure& lower_structure = lower_factor.structure;
   OffsetScan(degrees, &lower_structure.column_offsets);
@@ -106,6 +109,10 @@ SparseLDLResult<Field> Factorization<Field>::UpLooking(
     const CoordinateMatrix<Field>& matrix) CATAMARI_NOEXCEPT {
   typedef ComplexBase<Field> Real;
   const Int num_rows = matrix.NumRows();
+  if (num_rows > control.up_looking_grain_size &&
+      tbb::this_task_arena::max_concurrency() > 1) {
+    return OpenMPUpLooking(matrix);
+  }
   const Buffer<Int>& parents = ordering.assembly_forest.parents;
   const LowerStructure& lower_structure = lower_factor.structure;
 
@@ -220,6 +227,8 @@ SparseLDLResult<Field> Factorization<Field>::UpLooking(
     ++result.num_successful_pivots;
   }
 
+  // Every row of the structure has now been appended.
+  structure_formed_ = true;
   return result;
 }
 
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_UP_LOOKING_OPENMP_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_UP_LOOKING_OPENMP_IMPL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
+
+#include "catamari/sparse_ldl/scalar/factorization.hpp"
+
+namespace catamari {
+namespace scalar_ldl {
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::OpenMPUpLooking(
+    const CoordinateMatrix<Field>& matrix) CATAMARI_NOEXCEPT {
+  typedef ComplexBase<Field> Real;
+  const Int num_rows = matrix.NumRows();
+  const AssemblyForest& forest = ordering.assembly_forest;
+  const Buffer<Int>& parents = forest.parents;
+  const LowerStructure& lower_structure = lower_factor.structure;
+  const Int grain_size = std::max(control.up_looking_grain_size, Int(1));
+
+  // Fill the dynamic regularization instance.
+  const Real kEpsilon = std::numeric_limits<Real>::epsilon();
+  DynamicRegularizationParams<Field> reg_params;
+  reg_params.enabled = control.dynamic_regularization.enabled;
+  reg_params.offset = 0;
+  reg_params.positive_threshold = std::pow(
+      kEpsilon, control.dynamic_regularization.positive_threshold_exponent);
+  reg_params.negative_threshold = std::pow(
+      kEpsilon, control.dynamic_regularization.negative_threshold_exponent);
+  if (control.dynamic_regularization.relative) {
+    const Real matrix_max_norm = MaxNorm(matrix);
+    reg_params.positive_threshold *= matrix_max_norm;
+    reg_params.negative_threshold *= matrix_max_norm;
+  }
+  reg_params.signatures = &control.dynamic_regularization.signatures;
+
+  // The update pointers are shared, since each column is only appended to by
+  // the rows of its ancestors, which are processed in order. The remaining
+  // state is private to each thread, since different subtrees can have
+  // intersecting row patterns.
+  Buffer<Int> column_update_ptrs(num_rows);
+  for (Int row = 0; row < num_rows; ++row) {
+    column_update_ptrs[row] = lower_structure.ColumnOffset(row);
+  }
+  const int max_threads = tbb::this_task_arena::max_concurrency();
+  Buffer<UpLookingState<Field>> private_states(max_threads);
+  {
+    tbb::task_group tg;
+    for (int t = 0; t < max_threads; ++t) {
+      tg.run([&, t]() {
+        UpLookingState<Field>& state = private_states[t];
+        state.pattern_flags.Resize(num_rows, -1);
+        state.row_structure.Resize(num_rows);
+        state.row_workspace.Resize(num_rows, Field{0});
+      });
+    }
+    tg.wait();
+  }
+
+  // Whether each row was successfully factored and, if so, the amount of
+  // dynamic regularization (if any) applied to its pivot.
+  Buffer<bool> succeeded(num_rows, false);
+  Buffer<Real> regularizations;
+  if (reg_params.enabled) {
+    regularizations.Resize(num_rows, Real(0));
+  }
+
+  // Factors a single row, whose children have all been processed. A row is
+  // skipped if any of its children failed, since its pattern depends upon
+  // them.
+  auto process_row = [&](Int row, UpLookingState<Field>* state) {
+    for (Int index = forest.child_offsets[row];
+         index < forest.child_offsets[row + 1]; ++index) {
+      if (!succeeded[forest.children[index]]) {
+        return;
+      }
+    }
+
+    state->pattern_flags[row] = row;
+    const Int start = ComputeTopologicalRowPatternAndScatterNonzeros(
+        matrix, ordering, parents, row, state->pattern_flags.Data(),
+        state->row_structure.Data(), state->row_workspace.Data());
+    diagonal_factor.values[row] = state->row_workspace[row];
+    state->row_workspace[row] = Field{0};
+    UpLookingRowUpdate(row, state->row_structure.Data() + start,
+                       state->row_structure.Data() + num_rows,
+                       column_update_ptrs.Data(), state->row_workspace.Data());
+
+    Field pivot = diagonal_factor.values[row];
+    if (reg_params.enabled) {
+      const Real real_pivot = std::real(pivot);
+      const Buffer<bool>& signatures = *reg_params.signatures;
+      const Int orig_index = ordering.inverse_permutation.Empty()
+                                 ? row
+                                 : ordering.inverse_permutation[row];
+      if (signatures[orig_index]) {
+        // Handle a positive pivot.
+        if (real_pivot <= -reg_params.positive_threshold) {
+          return;
+        } else if (real_pivot < reg_params.positive_threshold) {
+          regularizations[row] = reg_params.positive_threshold - real_pivot;
+          pivot = reg_params.positive_threshold;
+        }
+      } else {
+        // Handle a negative pivot.
+        if (real_pivot >= reg_params.negative_threshold) {
+          return;
+        } else if (real_pivot > -reg_params.negative_threshold) {
+          regularizations[row] =
+              -(reg_params.negative_threshold - (-real_pivot));
+          pivot = -reg_params.negative_threshold;
+        }
+      }
+    }
+
+    if (control.factorization_type == kCholeskyFactorization) {
+      if (RealPart(pivot) <= Real{0}) {
+        return;
+      }
+      diagonal_factor.values[row] = std::sqrt(RealPart(pivot));
+    } else if (control.factorization_type == kLDLAdjointFactorization) {
+      if (RealPart(pivot) == Real{0}) {
+        return;
+      }
+      diagonal_factor.values[row] = RealPart(pivot);
+    } else {
+      if (pivot == Field{0}) {
+        return;
+      }
+    }
+    succeeded[row] = true;
+  };
+
+  // The number of rows in the subtree rooted at each row. Since every
+  // parent has a larger index than its children, a single ascending sweep
+  // suffices.
+  Buffer<Int> subtree_sizes(num_rows, 1);
+  for (Int row = 0; row < num_rows; ++row) {
+    if (parents[row] >= 0) {
+      subtree_sizes[parents[row]] += subtree_sizes[row];
+    }
+  }
+
+  // Each task sequentially factors a maximal subtree of at most
+  // 'grain_size' rows. The rows above these subtrees are factored by
+  // whichever task completes the last of their children, so that chains of
+  // the elimination forest are walked without recursion.
+  Buffer<Int> task_roots;
+  std::vector<std::atomic<Int>> num_pending_children(num_rows);
+  {
+    Int num_tasks = 0;
+    for (Int row = 0; row < num_rows; ++row) {
+      const Int parent = parents[row];
+      if (subtree_sizes[row] <= grain_size &&
+          (parent < 0 || subtree_sizes[parent] > grain_size)) {
+        ++num_tasks;
+      }
+      num_pending_children[row] = forest.NumChildren(row);
+    }
+    task_roots.Resize(num_tasks);
+    num_tasks = 0;
+    for (Int row = 0; row < num_rows; ++row) {
+      const Int parent = parents[row];
+      if (subtree_sizes[row] <= grain_size &&
+          (parent < 0 || subtree_sizes[parent] > grain_size)) {
+        task_roots[num_tasks++] = row;
+      }
+    }
+  }
+
+  tbb::parallel_for(Int(0), Int(task_roots.Size()), [&](Int task) {
+    const int thread = tbb::this_task_arena::current_thread_index();
+    UpLookingState<Field>& state = private_states[thread];
+    const Int root = task_roots[task];
+
+    // Gather the subtree in preorder; its reversal lists every row after
+    // all of its descendants.
+    Buffer<Int> subtree(subtree_sizes[root]);
+    {
+      Int num_gathered = 0;
+      Int num_visited = 0;
+      subtree[num_gathered++] = root;
+      while (num_visited < num_gathered) {
+        const Int row = subtree[num_visited++];
+        for (Int index = forest.child_offsets[row];
+             index < forest.child_offsets[row + 1]; ++index) {
+          subtree[num_gathered++] = forest.children[index];
+        }
+      }
+    }
+    for (Int index = subtree.Size() - 1; index >= 0; --index) {
+      process_row(subtree[index], &state);
+    }
+
+    // Continue up the forest for as long as this task completed the last
+    // child of the parent.
+    Int row = parents[root];
+    while (row >= 0 && --num_pending_children[row] == 0) {
+      process_row(row, &state);
+      row = parents[row];
+    }
+  });
+
+  // Form the result from the leading successful pivots, exactly as the
+  // sequential factorization would have.
+  SparseLDLResult<Field> result;
+  for (Int row = 0; row < num_rows; ++row) {
+    if (!succeeded[row]) {
+      return result;
+    }
+    if (reg_params.enabled && regularizations[row] != Real(0)) {
+      const Int orig_index = ordering.inverse_permutation.Empty()
+                                 ? row
+                                 : ordering.inverse_permutation[row];
+      result.dynamic_regularization.emplace_back(orig_index,
+                                                 regularizations[row]);
+    }
+
+    const Int degree = lower_structure.Degree(row);
+    result.num_factorization_entries += 1 + degree;
+
+    const double solve_flops = (IsComplex<Field>::value ? 6. : 1.) * degree;
+
+    const double schur_complement_flops =
+        (IsComplex<Field>::value ? 4. : 1.) * (1. * degree) * (1. * degree);
+
+    result.num_subdiag_solve_flops += solve_flops;
+    result.num_schur_complement_flops += schur_complement_flops;
+    result.num_factorization_flops += solve_flops + schur_complement_flops;
+
+    ++result.num_successful_pivots;
+  }
+
+  structure_formed_ = true;
+  return result;
+}
+
+}  // namespace scalar_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+// CATAMARI_SPARSE_LDL_SCALAR_FACTORIZATION_UP_LOOKING_OPENMP_IMPL_H_
@@ -52,12 +52,12 @@ void EliminationForest(const CoordinateMatrix<Field>& matrix,
   // For performing path compression.
   ancestors->Resize(num_rows, -1);
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row = 0; row < num_rows; ++row) {
     const Int row_beg = matrix.RowEntryOffset(row);
     const Int row_end = matrix.RowEntryOffset(row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      ProcessEdge(row, entries[index].column, parents, ancestors);
+      ProcessEdge(row, column_indices[index], parents, ancestors);
     }
   }
 }
@@ -77,16 +77,16 @@ void EliminationForest(const CoordinateMatrix<Field>& matrix,
   // For performing path compression.
   ancestors->Resize(num_rows, -1);
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row = 0; row < num_rows; ++row) {
     const Int orig_row = ordering.inverse_permutation[row];
     const Int row_beg = matrix.RowEntryOffset(orig_row);
     const Int row_end = matrix.RowEntryOffset(orig_row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const Int orig_col = entries[index].column;
+      const Int orig_col = column_indices[index];
       // if (orig_col >= orig_row) continue; // Skip upper triangle
       ProcessEdge(row, ordering.permutation[orig_col], parents, ancestors);
-      // ProcessEdge(ordering.permutation[entries[index].column], row, parents, ancestors); // JP: Symmetry
+      // ProcessEdge(ordering.permutation[column_indices[index]], row, parents, ancestors); // JP: Symmetry
     }
   }
 }
@@ -212,7 +212,7 @@ void DegreesFromEliminationForest(const CoordinateMatrix<Field>& matrix,
     set_parents[i] = i;
   }
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row_post = 0; row_post < num_rows; ++row_post) {
     const Int row = postorder[row_post];
 
@@ -228,8 +228,7 @@ void DegreesFromEliminationForest(const CoordinateMatrix<Field>& matrix,
     const Int row_beg = matrix.RowEntryOffset(row);
     const Int row_end = matrix.RowEntryOffset(row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      const Int column = entry.column;
+      const Int column = column_indices[index];
       if (column <= row) {
         continue;
       }
@@ -336,7 +335,7 @@ void DegreesFromEliminationForest(const CoordinateMatrix<Field>& matrix,
     set_parents[i] = i;
   }
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row_post = 0; row_post < num_rows; ++row_post) {
     const Int row = postorder[row_post];
 
@@ -353,8 +352,7 @@ void DegreesFromEliminationForest(const CoordinateMatrix<Field>& matrix,
     const Int row_beg = matrix.RowEntryOffset(orig_row);
     const Int row_end = matrix.RowEntryOffset(orig_row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      const Int column = ordering.permutation[entry.column];
+      const Int column = ordering.permutation[column_indices[index]];
       if (column <= row) {
         continue;
       }
@@ -424,14 +422,13 @@ void SimpleEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
   // each column.
   degrees->Resize(num_rows, 0);
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row = 0; row < num_rows; ++row) {
     pattern_flags[row] = row;
     const Int row_beg = matrix.RowEntryOffset(row);
     const Int row_end = matrix.RowEntryOffset(row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      Int column = entry.column;
+      Int column = column_indices[index];
 
       // We are traversing the strictly lower triangle and know that the
       // indices are sorted.
@@ -484,7 +481,7 @@ void SimpleEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
   // each column.
   degrees->Resize(num_rows, 0);
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row = 0; row < num_rows; ++row) {
     pattern_flags[row] = row;
 
@@ -492,8 +489,7 @@ void SimpleEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
     const Int row_beg = matrix.RowEntryOffset(orig_row);
     const Int row_end = matrix.RowEntryOffset(orig_row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
-      Int column = ordering.permutation[entry.column];
+      Int column = ordering.permutation[column_indices[index]];
 
       // We are traversing the strictly lower triangle and know that the
       // indices are sorted.
@@ -558,12 +554,12 @@ Int ComputeRowPattern(const CoordinateMatrix<Field>& matrix,
       have_permutation ? ordering.inverse_permutation[row] : row;
   const Int row_beg = matrix.RowEntryOffset(orig_row);
   const Int row_end = matrix.RowEntryOffset(orig_row + 1);
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   Int num_packed = 0;
   for (Int index = row_beg; index < row_end; ++index) {
-    const MatrixEntry<Field>& entry = entries[index];
+    const Int entry_column = column_indices[index];
     Int column =
-        have_permutation ? ordering.permutation[entry.column] : entry.column;
+        have_permutation ? ordering.permutation[entry_column] : entry_column;
 
     if (column >= row) {
       if (have_permutation) {
@@ -660,7 +656,7 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
   // indices.
   Buffer<Int> column_ptrs(num_rows);
 
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int row = 0; row < num_rows; ++row) {
     pattern_flags[row] = row;
     column_ptrs[row] = lower_structure->ColumnOffset(row);
@@ -670,9 +666,9 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
     const Int row_beg = matrix.RowEntryOffset(orig_row);
     const Int row_end = matrix.RowEntryOffset(orig_row + 1);
     for (Int index = row_beg; index < row_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
+      const Int entry_column = column_indices[index];
       Int column =
-          have_permutation ? ordering.permutation[entry.column] : entry.column;
+          have_permutation ? ordering.permutation[entry_column] : entry_column;
 
       // We are traversing the strictly lower triangle and know that the
       // indices are sorted.
@@ -700,6 +696,39 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
   }
 }
 
+inline void FormRowPatterns(const LowerStructure& lower_structure,
+                            LowerStructure* row_patterns,
+                            Buffer<Int>* value_offsets) {
+  const Int num_rows = lower_structure.column_offsets.Size() - 1;
+  const Int num_entries = lower_structure.indices.Size();
+
+  Buffer<Int> degrees(num_rows, 0);
+  for (Int index = 0; index < num_entries; ++index) {
+    ++degrees[lower_structure.indices[index]];
+  }
+  OffsetScan(degrees, &row_patterns->column_offsets);
+
+  // Since the columns are visited in order, each row pattern is sorted.
+  row_patterns->indices.Resize(num_entries);
+  if (value_offsets) {
+    value_offsets->Resize(num_entries);
+  }
+  Buffer<Int> row_ptrs(num_rows);
+  for (Int row = 0; row < num_rows; ++row) {
+    row_ptrs[row] = row_patterns->ColumnOffset(row);
+  }
+  for (Int column = 0; column < num_rows; ++column) {
+    for (Int index = lower_structure.ColumnOffset(column);
+         index < lower_structure.ColumnOffset(column + 1); ++index) {
+      const Int row_ptr = row_ptrs[lower_structure.indices[index]]++;
+      row_patterns->indices[row_ptr] = column;
+      if (value_offsets) {
+        (*value_offsets)[row_ptr] = index;
+      }
+    }
+  }
+}
+
 }  // namespace scalar_ldl
 }  // namespace catamari
 
@@ -68,12 +68,13 @@ void SimpleEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
                                        const SymmetricOrdering& ordering,
                                        Buffer<Int>* parents,
                                        Buffer<Int>* degrees);
-#ifdef CATAMARI_OPENMP
+
+// A multithreaded equivalent which processes the subtrees of the assembly
+// forest of 'ordering' as separate TBB tasks.
 template <class Field>
 void OpenMPSimpleEliminationForestAndDegrees(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
     Buffer<Int>* parents, Buffer<Int>* degrees);
-#endif  // ifdef CATAMARI_OPENMP
 
 // Computes the elimination forest (via the 'parents' array) and sizes of the
 // structures of a scalar (simplicial) LDL' factorization.
@@ -87,13 +88,14 @@ template <class Field>
 void EliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
                                  const SymmetricOrdering& ordering,
                                  Buffer<Int>* parents, Buffer<Int>* degrees);
-#ifdef CATAMARI_OPENMP
+
+// A multithreaded equivalent which processes the subtrees of the assembly
+// forest of 'ordering' as separate TBB tasks.
 template <class Field>
 void OpenMPEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
                                        const SymmetricOrdering& ordering,
                                        Buffer<Int>* parents,
                                        Buffer<Int>* degrees);
-#endif  // ifdef CATAMARI_OPENMP
 
 // Computes the nonzero pattern of L(row, :) in
 // row_structure[0 : num_packed - 1].
@@ -119,6 +121,14 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
                           const AssemblyForest& forest,
                           const Buffer<Int>& degrees,
                           LowerStructure* lower_structure);
+// Fills 'row_patterns' with the patterns of the rows of the strictly lower
+// factor with the given structure (i.e., its transpose), each sorted. If
+// 'value_offsets' is non-null, it is filled with the offset, within the
+// column-major values of the factor, of each entry of the row patterns.
+void FormRowPatterns(const LowerStructure& lower_structure,
+                     LowerStructure* row_patterns,
+                     Buffer<Int>* value_offsets = nullptr);
+
 #ifdef CATAMARI_OPENMP
 template <class Field>
 void OpenMPFillStructureIndices(const CoordinateMatrix<Field>& matrix,
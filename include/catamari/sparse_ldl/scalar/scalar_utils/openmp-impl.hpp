@@ -7,7 +7,12 @@
  */
 #ifndef CATAMARI_SPARSE_LDL_SCALAR_SCALAR_UTILS_OPENMP_IMPL_H_
 #define CATAMARI_SPARSE_LDL_SCALAR_SCALAR_UTILS_OPENMP_IMPL_H_
-#ifdef CATAMARI_OPENMP
+
+#include <algorithm>
+#include <vector>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
 #include "catamari/sparse_ldl/scalar/scalar_utils.hpp"
 
@@ -23,20 +28,21 @@ void OpenMPSimpleEliminationForestAndDegreesRecursion(
     Buffer<Buffer<Int>>* private_tmp_structures) {
   const Int order_child_beg = ordering.assembly_forest.child_offsets[root];
   const Int order_child_end = ordering.assembly_forest.child_offsets[root + 1];
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (Int index = order_child_beg; index < order_child_end; ++index) {
     const Int child = ordering.assembly_forest.children[index];
-
-    #pragma omp task default(none) firstprivate(child, keep_structures)    \
-        shared(matrix, ordering, parents, degrees, private_children_lists, \
-        structures, private_pattern_flags, private_tmp_structures)
-    OpenMPSimpleEliminationForestAndDegreesRecursion(
-        matrix, ordering, child, keep_structures, parents, degrees,
-        private_children_lists, structures, private_pattern_flags,
-        private_tmp_structures);
+    tg.run([&, child]() {
+      OpenMPSimpleEliminationForestAndDegreesRecursion(
+          matrix, ordering, child, keep_structures, parents, degrees,
+          private_children_lists, structures, private_pattern_flags,
+          private_tmp_structures);
+    });
   }
+  tg.wait();
 
-  const int thread = omp_get_thread_num();
+  // The thread's workspaces are only acquired once the children have
+  // completed, since the wait may have run other subtrees on this thread.
+  const int thread = tbb::this_task_arena::current_thread_index();
   Buffer<std::vector<Int>>& children_list = (*private_children_lists)[thread];
   Buffer<Int>& pattern_flags = (*private_pattern_flags)[thread];
   Buffer<Int>& tmp_structure = (*private_tmp_structures)[thread];
@@ -44,7 +50,7 @@ void OpenMPSimpleEliminationForestAndDegreesRecursion(
   const Int supernode_size = ordering.supernode_sizes[root];
   const Int supernode_offset = ordering.supernode_offsets[root];
   const bool have_permutation = !ordering.permutation.Empty();
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int column = supernode_offset;
        column < supernode_offset + supernode_size; ++column) {
     const Int orig_column =
@@ -88,9 +94,9 @@ void OpenMPSimpleEliminationForestAndDegreesRecursion(
     if (num_children == 0) {
       // Incorporate this column's structure.
       for (Int index = column_beg; index < column_end; ++index) {
-        const MatrixEntry<Field>& entry = entries[index];
-        const Int row = have_permutation ? ordering.permutation[entry.column]
-                                         : entry.column;
+        const Int entry_column = column_indices[index];
+        const Int row = have_permutation ? ordering.permutation[entry_column]
+                                         : entry_column;
         if (row > column) {
           if (!degree || row < parent) {
             parent = row;
@@ -135,9 +141,9 @@ void OpenMPSimpleEliminationForestAndDegreesRecursion(
 
       // Incorporate this column's structure.
       for (Int index = column_beg; index < column_end; ++index) {
-        const MatrixEntry<Field>& entry = entries[index];
-        const Int row = have_permutation ? ordering.permutation[entry.column]
-                                         : entry.column;
+        const Int entry_column = column_indices[index];
+        const Int row = have_permutation ? ordering.permutation[entry_column]
+                                         : entry_column;
         if (row > column && pattern_flags[row] != column) {
           if (!degree || row < parent) {
             parent = row;
@@ -172,7 +178,7 @@ void OpenMPSimpleEliminationForestAndDegrees(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
     Buffer<Int>* parents, Buffer<Int>* degrees) {
   const Int num_rows = matrix.NumRows();
-  const int max_threads = omp_get_max_threads();
+  const int max_threads = tbb::this_task_arena::max_concurrency();
   parents->Resize(num_rows);
   degrees->Resize(num_rows);
 
@@ -185,31 +191,28 @@ void OpenMPSimpleEliminationForestAndDegrees(
 
   Buffer<Buffer<Int>> private_tmp_structures(max_threads);
 
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (int t = 0; t < max_threads; ++t) {
-    #pragma omp task default(none) firstprivate(t, num_rows)  \
-        shared(private_children_lists, private_pattern_flags, \
-            private_tmp_structures)
-    {
+    tg.run([&, t]() {
       private_children_lists[t].Resize(num_rows);
       private_pattern_flags[t].Resize(num_rows, -1);
-      private_tmp_structures[t].Resize(num_rows - 1);
-    }
+      private_tmp_structures[t].Resize(std::max(num_rows - 1, Int(0)));
+    });
   }
+  tg.wait();
 
   const bool keep_structures = false;
   Buffer<Buffer<Int>> structures(num_rows);
 
-  #pragma omp taskgroup
   for (const Int root : ordering.assembly_forest.roots) {
-    #pragma omp task default(none) firstprivate(root, keep_structures)     \
-        shared(matrix, ordering, parents, degrees, private_children_lists, \
-            structures, private_pattern_flags, private_tmp_structures)
-    OpenMPSimpleEliminationForestAndDegreesRecursion(
-        matrix, ordering, root, keep_structures, parents, degrees,
-        &private_children_lists, &structures, &private_pattern_flags,
-        &private_tmp_structures);
+    tg.run([&, root]() {
+      OpenMPSimpleEliminationForestAndDegreesRecursion(
+          matrix, ordering, root, keep_structures, parents, degrees,
+          &private_children_lists, &structures, &private_pattern_flags,
+          &private_tmp_structures);
+    });
   }
+  tg.wait();
 }
 
 template <class Field>
@@ -224,6 +227,8 @@ void OpenMPEliminationForestAndDegrees(const CoordinateMatrix<Field>& matrix,
   OpenMPSimpleEliminationForestAndDegrees(matrix, ordering, parents, degrees);
 }
 
+#ifdef CATAMARI_OPENMP
+
 template <class Field>
 void OpenMPFillStructureIndicesRecursion(
     const CoordinateMatrix<Field>& matrix, const SymmetricOrdering& ordering,
@@ -249,7 +254,7 @@ void OpenMPFillStructureIndicesRecursion(
   const Int supernode_size = ordering.supernode_sizes[root];
   const Int supernode_offset = ordering.supernode_offsets[root];
   const bool have_permutation = !ordering.permutation.Empty();
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int column = supernode_offset;
        column < supernode_offset + supernode_size; ++column) {
     const Int orig_column =
@@ -265,9 +270,9 @@ void OpenMPFillStructureIndicesRecursion(
     if (num_children == 0) {
       // Incorporate this column's structure.
       for (Int index = column_beg; index < column_end; ++index) {
-        const MatrixEntry<Field>& entry = entries[index];
-        const Int row = have_permutation ? ordering.permutation[entry.column]
-                                         : entry.column;
+        const Int entry_column = column_indices[index];
+        const Int row = have_permutation ? ordering.permutation[entry_column]
+                                         : entry_column;
         if (row > column) {
           *(struct_ptr++) = row;
         }
@@ -317,9 +322,9 @@ void OpenMPFillStructureIndicesRecursion(
 
       // Incorporate this column's structure.
       for (Int index = column_beg; index < column_end; ++index) {
-        const MatrixEntry<Field>& entry = entries[index];
-        const Int row = have_permutation ? ordering.permutation[entry.column]
-                                         : entry.column;
+        const Int entry_column = column_indices[index];
+        const Int row = have_permutation ? ordering.permutation[entry_column]
+                                         : entry_column;
         if (row > column && pattern_flags[row] != column) {
           *(struct_ptr++) = row;
         }
@@ -449,8 +454,9 @@ void OpenMPFillStructureIndices(const CoordinateMatrix<Field>& matrix,
   }
 }
 
+#endif  // ifdef CATAMARI_OPENMP
+
 }  // namespace scalar_ldl
 }  // namespace catamari
 
-#endif  // ifdef CATAMARI_OPENMP
 #endif  // ifndef CATAMARI_SPARSE_LDL_SCALAR_SCALAR_UTILS_OPENMP_IMPL_H_
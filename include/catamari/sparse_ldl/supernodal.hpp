@@ -10,6 +10,7 @@
 
 #include "catamari/index_utils.hpp"
 #include "catamari/sparse_ldl/scalar.hpp"
+#include "catamari/sparse_ldl/supernodal/autotune.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 #include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
 
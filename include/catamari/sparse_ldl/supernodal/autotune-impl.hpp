@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "catamari/sparse_ldl/supernodal/autotune.hpp"
+#include "quotient/timer.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+namespace autotune {
+
+// A front of a given shape whose diagonal block is diagonally dominant (and
+// hence positive-definite), along with a pristine copy of its entries which
+// each trial restores before it is timed.
+template <class Field>
+struct SampleFront {
+  Int size = 0;
+  Int degree = 0;
+
+  // The diagonal and subdiagonal blocks, stored contiguously, and their
+  // pristine values.
+  Buffer<Field> panel;
+  Buffer<Field> initial_panel;
+
+  // The Schur complement of the front.
+  Buffer<Field> schur_complement;
+
+  SampleFront(Int front_size, Int front_degree, std::uint64_t seed)
+      : size(front_size), degree(front_degree) {
+    const Int height = size + degree;
+    initial_panel.Resize(height * size);
+    for (Int j = 0; j < size; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        // A linear congruential generator of values within [0, 1).
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const double value = (seed >> 11) * (1. / 9007199254740992.);
+        initial_panel[i + j * height] = Field(i == j ? height : value);
+      }
+    }
+    panel.Resize(height * size);
+    schur_complement.Resize(degree * degree);
+    Reset();
+  }
+
+  void Reset() {
+    std::copy(initial_panel.begin(), initial_panel.end(), panel.begin());
+  }
+
+  BlasMatrixView<Field> DiagonalBlock() {
+    BlasMatrixView<Field> view;
+    view.height = view.width = size;
+    view.leading_dim = size + degree;
+    view.data = panel.Data();
+    return view;
+  }
+
+  BlasMatrixView<Field> LowerBlock() {
+    BlasMatrixView<Field> view;
+    view.height = degree;
+    view.width = size;
+    view.leading_dim = size + degree;
+    view.data = panel.Data() + size;
+    return view;
+  }
+
+  BlasMatrixView<Field> SchurComplement() {
+    BlasMatrixView<Field> view;
+    view.height = view.width = view.leading_dim = degree;
+    view.data = schur_complement.Data();
+    return view;
+  }
+
+  // The flops of the factorization of the diagonal block.
+  double DiagonalFlops() const { return std::pow(1. * size, 3.) / 3.; }
+
+  // The flops of the factorization of the entire front.
+  double FrontFlops() const {
+    return DiagonalFlops() + std::pow(1. * size, 2.) * degree +
+           std::pow(1. * degree, 2.) * size;
+  }
+};
+
+// Returns the median of the seconds taken by 'num_repetitions' calls of
+// 'trial', each of which is preceded by an (untimed) call of 'reset'.
+template <class Reset, class Trial>
+double MedianSeconds(Int num_repetitions, const Reset& reset,
+                     const Trial& trial) {
+  std::vector<double> seconds;
+  for (Int repetition = 0; repetition < std::max(num_repetitions, Int(1));
+       ++repetition) {
+    reset();
+    quotient::Timer timer;
+    timer.Start();
+    trial();
+    seconds.push_back(timer.Stop());
+  }
+  std::nth_element(seconds.begin(), seconds.begin() + seconds.size() / 2,
+                   seconds.end());
+  return seconds[seconds.size() / 2];
+}
+
+// Returns the candidate minimizing the summed median seconds of 'trial' over
+// the sample fronts.
+template <class Field, class Trial>
+Int FastestCandidate(const char* name, const std::vector<Int>& candidates,
+                     Int default_candidate,
+                     std::vector<SampleFront<Field>>* fronts,
+                     const AutoTuneControl& control, const Trial& trial) {
+  Int best_candidate = default_candidate;
+  double best_seconds = std::numeric_limits<double>::infinity();
+  for (const Int candidate : candidates) {
+    double seconds = 0;
+    for (SampleFront<Field>& front : *fronts) {
+      seconds += MedianSeconds(control.num_repetitions,
+                               [&]() { front.Reset(); },
+                               [&]() { trial(candidate, &front); });
+    }
+    if (control.verbose) {
+      std::cout << name << " " << candidate << ": " << seconds << " seconds"
+                << std::endl;
+    }
+    if (seconds < best_seconds) {
+      best_seconds = seconds;
+      best_candidate = candidate;
+    }
+  }
+  return best_candidate;
+}
+
+// Returns the seconds of overhead of spawning (and waiting upon) an empty
+// task in a TBB task group.
+inline double TaskOverheadSeconds(Int num_repetitions) {
+  const Int num_tasks = 1000;
+  const double seconds = MedianSeconds(num_repetitions, []() {}, [&]() {
+    tbb::task_group group;
+    for (Int task = 0; task < num_tasks; ++task) {
+      group.run([]() {});
+    }
+    group.wait();
+  });
+  return seconds / num_tasks;
+}
+
+// Returns the seconds per entry of the scattered addition of a child Schur
+// complement of the given degree into a parent's front of twice its degree,
+// as performed by the merges.
+template <class Field>
+double MergeEntrySeconds(Int child_degree, Int num_repetitions) {
+  const Int parent_degree = 2 * child_degree;
+  Buffer<Field> child(child_degree * child_degree, Field(1));
+  Buffer<Field> parent(parent_degree * parent_degree, Field(0));
+  Buffer<Int> relative_indices(child_degree);
+  for (Int i = 0; i < child_degree; ++i) {
+    relative_indices[i] = 2 * i + 1;
+  }
+  const double seconds = MedianSeconds(num_repetitions, []() {}, [&]() {
+    for (Int j = 0; j < child_degree; ++j) {
+      Field* parent_column =
+          parent.Data() + relative_indices[j] * parent_degree;
+      const Field* child_column = child.Data() + j * child_degree;
+      for (Int i = j; i < child_degree; ++i) {
+        parent_column[relative_indices[i]] += child_column[i];
+      }
+    }
+  });
+  const double num_entries = 0.5 * child_degree * (child_degree + 1);
+  return seconds / num_entries;
+}
+
+}  // namespace autotune
+
+template <class Field>
+TuningProfile AutoTune(const Factorization<Field>* factorization,
+                       const AutoTuneControl& control) {
+  typedef ComplexBase<Field> Real;
+  const Control<Field> defaults;
+  SymmetricFactorizationType factorization_type = kCholeskyFactorization;
+
+  // Sample the distinct shapes of the largest fronts (by their flops).
+  std::vector<std::pair<Int, Int>> shapes;
+  if (factorization) {
+    factorization_type = factorization->GetControl().factorization_type;
+    Buffer<Int> sizes, degrees;
+    factorization->SupernodeShapes(&sizes, &degrees);
+    for (Int supernode = 0; supernode < sizes.Size(); ++supernode) {
+      if (sizes[supernode] >= control.min_sample_front_size) {
+        shapes.emplace_back(sizes[supernode], degrees[supernode]);
+      }
+    }
+    std::sort(shapes.begin(), shapes.end(),
+              [](const std::pair<Int, Int>& a, const std::pair<Int, Int>& b) {
+                const double a_height = a.first + a.second;
+                const double b_height = b.first + b.second;
+                return a.first * a_height * a_height >
+                       b.first * b_height * b_height;
+              });
+    shapes.erase(std::unique(shapes.begin(), shapes.end()), shapes.end());
+    if (Int(shapes.size()) > control.num_sample_fronts) {
+      shapes.resize(std::max(control.num_sample_fronts, Int(1)));
+    }
+  }
+  if (shapes.empty()) {
+    for (const Int size : control.proxy_front_sizes) {
+      shapes.emplace_back(size, 2 * size);
+    }
+  }
+
+  std::vector<autotune::SampleFront<Field>> fronts;
+  for (std::size_t index = 0; index < shapes.size(); ++index) {
+    fronts.emplace_back(shapes[index].first, shapes[index].second, index + 1);
+  }
+
+  DynamicRegularizationParams<Field> dynamic_reg_params;
+  std::vector<std::pair<Int, Real>> dynamic_regularization;
+
+  TuningProfile profile;
+  profile.num_threads = tbb::this_task_arena::max_concurrency();
+
+  // The block size of the (recursive) factorizations of the diagonal blocks.
+  profile.block_size = autotune::FastestCandidate(
+      "block_size", control.block_sizes, defaults.block_size, &fronts,
+      control, [&](Int block_size, autotune::SampleFront<Field>* front) {
+        BlasMatrixView<Field> diagonal_block = front->DiagonalBlock();
+        FactorDiagonalBlock(block_size, factorization_type,
+                            dynamic_reg_params, &diagonal_block,
+                            &dynamic_regularization);
+      });
+
+  // The panel width, and then the tile size, of the tiled fronts.
+  auto factor_front = [&](Int factor_tile_size, Int outer_product_tile_size,
+                          autotune::SampleFront<Field>* front) {
+    BlasMatrixView<Field> diagonal_block = front->DiagonalBlock();
+    BlasMatrixView<Field> lower_block = front->LowerBlock();
+    BlasMatrixView<Field> schur_complement = front->SchurComplement();
+    TiledFactorFront(factor_tile_size, outer_product_tile_size,
+                     profile.block_size, factorization_type,
+                     dynamic_reg_params, true, &diagonal_block, &lower_block,
+                     &schur_complement, &dynamic_regularization);
+  };
+  profile.factor_tile_size = autotune::FastestCandidate(
+      "factor_tile_size", control.factor_tile_sizes,
+      defaults.factor_tile_size, &fronts, control,
+      [&](Int tile_size, autotune::SampleFront<Field>* front) {
+        factor_front(tile_size, defaults.outer_product_tile_size, front);
+      });
+  profile.outer_product_tile_size = autotune::FastestCandidate(
+      "outer_product_tile_size", control.outer_product_tile_sizes,
+      defaults.outer_product_tile_size, &fronts, control,
+      [&](Int tile_size, autotune::SampleFront<Field>* front) {
+        factor_front(profile.factor_tile_size, tile_size, front);
+      });
+
+  // The flop rate of the tuned fronts.
+  double front_flops = 0;
+  double front_seconds = 0;
+  for (autotune::SampleFront<Field>& front : fronts) {
+    front_flops += front.FrontFlops();
+    front_seconds += autotune::MedianSeconds(
+        control.num_repetitions, [&]() { front.Reset(); },
+        [&]() {
+          factor_front(profile.factor_tile_size,
+                       profile.outer_product_tile_size, &front);
+        });
+  }
+  const double flops_per_second =
+      front_seconds > 0 ? front_flops / front_seconds : 1e9;
+
+  // Each task should outweigh the overhead of spawning it.
+  const double task_seconds =
+      control.task_overhead_factor *
+      autotune::TaskOverheadSeconds(control.num_repetitions);
+  profile.min_parallel_threshold =
+      std::min(std::max(task_seconds * flops_per_second, 1e3), 1e9);
+  profile.min_parallel_solve_threshold = profile.min_parallel_threshold;
+
+  // The merges of the fronts' Schur complements into parents of twice their
+  // degree are split into tasks over at least this many columns.
+  std::vector<Int> sample_degrees;
+  for (const autotune::SampleFront<Field>& front : fronts) {
+    sample_degrees.push_back(std::max(front.degree, Int(1)));
+  }
+  std::nth_element(sample_degrees.begin(),
+                   sample_degrees.begin() + sample_degrees.size() / 2,
+                   sample_degrees.end());
+  const Int merge_degree = sample_degrees[sample_degrees.size() / 2];
+  const double merge_column_seconds =
+      merge_degree *
+      autotune::MergeEntrySeconds<Field>(merge_degree, control.num_repetitions);
+  profile.merge_grain_size =
+      merge_column_seconds > 0
+          ? Int(std::min(std::max(std::ceil(task_seconds /
+                                            merge_column_seconds),
+                                  16.),
+                         4096.))
+          : defaults.merge_grain_size;
+
+  if (control.verbose) {
+    std::cout << "Tuned profile (" << flops_per_second / 1e9
+              << " GFlop/sec):\n";
+    profile.Write(std::cout);
+  }
+
+  if (control.save) {
+    const std::string filename = control.filename.empty()
+                                     ? DefaultTuningProfileFilename()
+                                     : control.filename;
+    if (filename.empty() || !profile.Save(filename)) {
+      std::cerr << "Could not save the tuning profile into '" << filename
+                << "'" << std::endl;
+    } else {
+      ReloadMachineTuningProfile();
+    }
+  }
+
+  return profile;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_IMPL_H_
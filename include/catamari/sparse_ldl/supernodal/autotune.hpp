@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_H_
+
+#include <string>
+#include <vector>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/sparse_ldl/supernodal/tuning_profile.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// Configuration options for 'AutoTune'.
+struct AutoTuneControl {
+  // The candidates for 'Control::block_size'.
+  std::vector<Int> block_sizes{32, 48, 64, 96, 128};
+
+  // The candidates for 'Control::factor_tile_size'.
+  std::vector<Int> factor_tile_sizes{64, 128, 192, 256};
+
+  // The candidates for 'Control::outer_product_tile_size'.
+  std::vector<Int> outer_product_tile_sizes{120, 240, 360, 480};
+
+  // The number of the largest fronts of the symbolic tree which are sampled.
+  Int num_sample_fronts = 4;
+
+  // The sizes of the fronts of the synthetic proxy, whose degrees are twice
+  // their sizes (roughly as for the separators of a 3D mesh), which is used
+  // when no symbolic tree is given or when its fronts are all tiny.
+  std::vector<Int> proxy_front_sizes{64, 128, 256, 512};
+
+  // The fronts with fewer columns than this are not sampled.
+  Int min_sample_front_size = 32;
+
+  // The number of timed repetitions of each candidate, of which the median
+  // is used.
+  Int num_repetitions = 3;
+
+  // The factor by which the work of each task should exceed the measured
+  // overhead of spawning a task, which sets the minimum flops of a parallel
+  // subtree and the merge grain size.
+  double task_overhead_factor = 100;
+
+  // Whether the profile should be saved into 'filename' (or, if it is empty,
+  // into 'DefaultTuningProfileFilename()'). The profile of the default file
+  // is reloaded by the subsequent factorizations of this process and loaded
+  // by those of later ones.
+  bool save = true;
+  std::string filename;
+
+  // Whether the timings of the candidates should be printed.
+  bool verbose = false;
+};
+
+// Benchmarks the candidate block and tile sizes on a sample of the largest
+// fronts of the symbolic tree of 'factorization' (e.g., from a 'Factor' call
+// with 'symbolic_only' set), or, if it is null, on a synthetic proxy, and
+// derives the parallel thresholds and the merge grain size from the measured
+// task overhead, flop rate, and merge bandwidth. The fronts are factored
+// with the factorization type of 'factorization' (or as Cholesky
+// factorizations for the proxy) by the threads of the calling TBB arena.
+//
+// Once saved into the default file, the profile is applied to the settings
+// left at their defaults by the subsequent factorizations which have
+// 'Control::use_tuning_profile' set.
+template <class Field>
+TuningProfile AutoTune(const Factorization<Field>* factorization,
+                       const AutoTuneControl& control = AutoTuneControl());
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/autotune-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_AUTOTUNE_H_
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+
+#include "catamari/sparse_ldl/supernodal/block_low_rank.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+void CompressTile(const ConstBlasMatrixView<Field>& tile,
+                  const ComplexBase<Field>& tolerance,
+                  LowRankTile<Field>* compressed) {
+  typedef ComplexBase<Field> Real;
+  const Int height = tile.height;
+  const Int width = tile.width;
+  compressed->height = height;
+  compressed->width = width;
+  if (tolerance <= Real{0}) {
+    compressed->rank = -1;
+    compressed->u = tile;
+    compressed->w = BlasMatrix<Field>();
+    return;
+  }
+
+  // A rank-r approximation stores r (height + width) entries, so it only
+  // saves storage below this rank.
+  const Int max_rank = height && width ? (height * width - 1) / (height + width)
+                                       : 0;
+
+  BlasMatrix<Field> residual = tile;
+  Buffer<Real> column_norms_squared(width);
+  Real norm_squared = 0;
+  for (Int j = 0; j < width; ++j) {
+    Real column_norm_squared = 0;
+    for (Int i = 0; i < height; ++i) {
+      const Real entry = std::abs(residual(i, j));
+      column_norm_squared += entry * entry;
+    }
+    column_norms_squared[j] = column_norm_squared;
+    norm_squared += column_norm_squared;
+  }
+  const Real threshold = tolerance * tolerance * norm_squared;
+
+  BlasMatrix<Field> u(height, max_rank);
+  BlasMatrix<Field> w(max_rank, width);
+  Int rank = 0;
+  while (true) {
+    Real residual_norm_squared = 0;
+    Int pivot = 0;
+    for (Int j = 0; j < width; ++j) {
+      residual_norm_squared += column_norms_squared[j];
+      if (column_norms_squared[j] > column_norms_squared[pivot]) pivot = j;
+    }
+    if (residual_norm_squared <= threshold) break;
+    if (rank == max_rank) {
+      rank = -1;
+      break;
+    }
+
+    // Orthonormalize the pivot column against the basis, with a second
+    // Gram-Schmidt pass to retain orthogonality.
+    Field* basis_column = u.Pointer(0, rank);
+    for (Int i = 0; i < height; ++i) basis_column[i] = residual(i, pivot);
+    for (Int k = 0; k < rank; ++k) {
+      const Field* previous_column = u.Pointer(0, k);
+      Field dot = 0;
+      for (Int i = 0; i < height; ++i) {
+        dot += Conjugate(previous_column[i]) * basis_column[i];
+      }
+      for (Int i = 0; i < height; ++i) basis_column[i] -= dot * previous_column[i];
+    }
+    Real basis_norm_squared = 0;
+    for (Int i = 0; i < height; ++i) {
+      const Real entry = std::abs(basis_column[i]);
+      basis_norm_squared += entry * entry;
+    }
+    if (basis_norm_squared <= Real{0}) {
+      rank = -1;
+      break;
+    }
+    const Real inverse_basis_norm = Real{1} / std::sqrt(basis_norm_squared);
+    for (Int i = 0; i < height; ++i) basis_column[i] *= inverse_basis_norm;
+
+    // Project the new basis column out of the residual.
+    for (Int j = 0; j < width; ++j) {
+      Field* residual_column = residual.Pointer(0, j);
+      Field coefficient = 0;
+      for (Int i = 0; i < height; ++i) {
+        coefficient += Conjugate(basis_column[i]) * residual_column[i];
+      }
+      w(rank, j) = coefficient;
+      Real column_norm_squared = 0;
+      for (Int i = 0; i < height; ++i) {
+        residual_column[i] -= basis_column[i] * coefficient;
+        const Real entry = std::abs(residual_column[i]);
+        column_norm_squared += entry * entry;
+      }
+      column_norms_squared[j] = column_norm_squared;
+    }
+    ++rank;
+  }
+
+  compressed->rank = rank;
+  if (rank < 0) {
+    compressed->u = tile;
+    compressed->w = BlasMatrix<Field>();
+    return;
+  }
+  compressed->u = u.Submatrix(0, 0, height, rank);
+  compressed->w = w.Submatrix(0, 0, rank, width);
+}
+
+template <class Field>
+void ReduceTilePrecision(StoragePrecision precision,
+                         LowRankTile<Field>* tile) {
+  if (precision == kWorkingPrecision) return;
+  tile->reduced_u.Assign(precision, tile->u.ConstView());
+  tile->u = BlasMatrix<Field>();
+  if (tile->rank > 0) {
+    tile->reduced_w.Assign(precision, tile->w.ConstView());
+  }
+  tile->w = BlasMatrix<Field>();
+}
+
+template <class Field>
+void BlockLowRankFactor<Field>::Compress(
+    const BlockLowRankControl& control, const Buffer<Int>& supernode_sizes,
+    const LowerFactor<Field>& lower_factor) {
+  const Int num_supernodes = supernode_sizes.Size();
+  const Int tile_size = std::max<Int>(control.tile_size, 1);
+  tile_offsets_.Resize(num_supernodes + 1);
+  tiles_.clear();
+  num_compressed_supernodes_ = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    tile_offsets_[supernode] = tiles_.size();
+    const ConstBlasMatrixView<Field> block = lower_factor.blocks[supernode];
+    if (supernode_sizes[supernode] < control.min_supernode_size ||
+        !block.height) {
+      continue;
+    }
+    ++num_compressed_supernodes_;
+    for (Int column = 0; column < block.width; column += tile_size) {
+      for (Int row = 0; row < block.height; row += tile_size) {
+        LowRankTile<Field> tile;
+        tile.row_offset = row;
+        tile.column_offset = column;
+        tile.height = std::min(tile_size, block.height - row);
+        tile.width = std::min(tile_size, block.width - column);
+        tiles_.push_back(std::move(tile));
+      }
+    }
+  }
+  tile_offsets_[num_supernodes] = tiles_.size();
+
+  // Recover the supernode of each tile so that all of the tiles may be
+  // compressed in a single parallel loop.
+  Buffer<Int> tile_supernodes(tiles_.size());
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    for (Int index = tile_offsets_[supernode];
+         index < tile_offsets_[supernode + 1]; ++index) {
+      tile_supernodes[index] = supernode;
+    }
+  }
+
+  const ComplexBase<Field> tolerance = control.tolerance;
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, tiles_.size()),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int index = range.begin(); index < range.end(); ++index) {
+          LowRankTile<Field>& tile = tiles_[index];
+          const ConstBlasMatrixView<Field> block =
+              lower_factor.blocks[tile_supernodes[index]];
+          CompressTile(block.Submatrix(tile.row_offset, tile.column_offset,
+                                       tile.height, tile.width),
+                       tolerance, &tile);
+          ReduceTilePrecision(control.storage_precision, &tile);
+        }
+      });
+
+  if (!num_compressed_supernodes_) Clear();
+}
+
+template <class Field>
+void BlockLowRankFactor<Field>::Clear() {
+  tile_offsets_.Clear();
+  tiles_.clear();
+  num_compressed_supernodes_ = 0;
+}
+
+template <class Field>
+bool BlockLowRankFactor<Field>::Empty() const {
+  return num_compressed_supernodes_ == 0;
+}
+
+template <class Field>
+bool BlockLowRankFactor<Field>::Compressed(Int supernode) const {
+  return !Empty() && tile_offsets_[supernode + 1] > tile_offsets_[supernode];
+}
+
+template <class Field>
+Int BlockLowRankFactor<Field>::NumCompressedSupernodes() const {
+  return num_compressed_supernodes_;
+}
+
+template <class Field>
+Int BlockLowRankFactor<Field>::NumDenseEntries() const {
+  Int num_entries = 0;
+  for (const LowRankTile<Field>& tile : tiles_) {
+    num_entries += tile.height * tile.width;
+  }
+  return num_entries;
+}
+
+template <class Field>
+Int BlockLowRankFactor<Field>::NumEntries() const {
+  Int num_entries = 0;
+  for (const LowRankTile<Field>& tile : tiles_) {
+    num_entries += tile.rank < 0 ? tile.height * tile.width
+                                 : tile.rank * (tile.height + tile.width);
+  }
+  return num_entries;
+}
+
+template <class Field>
+std::size_t BlockLowRankFactor<Field>::NumBytes() const {
+  std::size_t num_bytes = 0;
+  for (const LowRankTile<Field>& tile : tiles_) {
+    num_bytes += tile.reduced_u.NumBytes() + tile.reduced_w.NumBytes() +
+                 (tile.u.view.height * tile.u.view.width +
+                  tile.w.view.height * tile.w.view.width) *
+                     sizeof(Field);
+  }
+  return num_bytes;
+}
+
+template <class Field>
+void BlockLowRankFactor<Field>::MultiplyNormal(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+  const Int num_rhs = input.width;
+  BlasMatrix<Field> coefficients;
+  Buffer<Field> workspace;
+  for (Int index = tile_offsets_[supernode];
+       index < tile_offsets_[supernode + 1]; ++index) {
+    const LowRankTile<Field>& tile = tiles_[index];
+    const ConstBlasMatrixView<Field> tile_input =
+        input.Submatrix(tile.column_offset, 0, tile.width, num_rhs);
+    BlasMatrixView<Field> tile_output =
+        output->Submatrix(tile.row_offset, 0, tile.height, num_rhs);
+    if (!tile.reduced_u.Empty()) {
+      if (tile.rank < 0) {
+        tile.reduced_u.MultiplyNormal(alpha, tile_input, &tile_output,
+                                      &workspace);
+      } else if (tile.rank > 0) {
+        coefficients.Resize(tile.rank, num_rhs, Field{0});
+        tile.reduced_w.MultiplyNormal(Field{1}, tile_input,
+                                      &coefficients.view, &workspace);
+        tile.reduced_u.MultiplyNormal(alpha, coefficients.ConstView(),
+                                      &tile_output, &workspace);
+      }
+    } else if (tile.rank < 0) {
+      MatrixMultiplyNormalNormal(alpha, tile.u.ConstView(), tile_input,
+                                 Field{1}, &tile_output);
+    } else if (tile.rank > 0) {
+      coefficients.Resize(tile.rank, num_rhs);
+      MatrixMultiplyNormalNormal(Field{1}, tile.w.ConstView(), tile_input,
+                                 Field{0}, &coefficients.view);
+      MatrixMultiplyNormalNormal(alpha, tile.u.ConstView(),
+                                 coefficients.ConstView(), Field{1},
+                                 &tile_output);
+    }
+  }
+}
+
+template <class Field>
+void BlockLowRankFactor<Field>::MultiplyAdjoint(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+  const Int num_rhs = input.width;
+  BlasMatrix<Field> coefficients;
+  Buffer<Field> workspace;
+  for (Int index = tile_offsets_[supernode];
+       index < tile_offsets_[supernode + 1]; ++index) {
+    const LowRankTile<Field>& tile = tiles_[index];
+    const ConstBlasMatrixView<Field> tile_input =
+        input.Submatrix(tile.row_offset, 0, tile.height, num_rhs);
+    BlasMatrixView<Field> tile_output =
+        output->Submatrix(tile.column_offset, 0, tile.width, num_rhs);
+    if (!tile.reduced_u.Empty()) {
+      if (tile.rank < 0) {
+        tile.reduced_u.MultiplyAdjoint(alpha, tile_input, &tile_output,
+                                       &workspace);
+      } else if (tile.rank > 0) {
+        coefficients.Resize(tile.rank, num_rhs, Field{0});
+        tile.reduced_u.MultiplyAdjoint(Field{1}, tile_input,
+                                       &coefficients.view, &workspace);
+        tile.reduced_w.MultiplyAdjoint(alpha, coefficients.ConstView(),
+                                       &tile_output, &workspace);
+      }
+    } else if (tile.rank < 0) {
+      MatrixMultiplyAdjointNormal(alpha, tile.u.ConstView(), tile_input,
+                                  Field{1}, &tile_output);
+    } else if (tile.rank > 0) {
+      coefficients.Resize(tile.rank, num_rhs);
+      MatrixMultiplyAdjointNormal(Field{1}, tile.u.ConstView(), tile_input,
+                                  Field{0}, &coefficients.view);
+      MatrixMultiplyAdjointNormal(alpha, tile.w.ConstView(),
+                                  coefficients.ConstView(), Field{1},
+                                  &tile_output);
+    }
+  }
+}
+
+template <class Field>
+void BlockLowRankFactor<Field>::MultiplyTranspose(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+  const Int num_rhs = input.width;
+  BlasMatrix<Field> coefficients;
+  Buffer<Field> workspace;
+  for (Int index = tile_offsets_[supernode];
+       index < tile_offsets_[supernode + 1]; ++index) {
+    const LowRankTile<Field>& tile = tiles_[index];
+    const ConstBlasMatrixView<Field> tile_input =
+        input.Submatrix(tile.row_offset, 0, tile.height, num_rhs);
+    BlasMatrixView<Field> tile_output =
+        output->Submatrix(tile.column_offset, 0, tile.width, num_rhs);
+    if (!tile.reduced_u.Empty()) {
+      if (tile.rank < 0) {
+        tile.reduced_u.MultiplyTranspose(alpha, tile_input, &tile_output,
+                                         &workspace);
+      } else if (tile.rank > 0) {
+        coefficients.Resize(tile.rank, num_rhs, Field{0});
+        tile.reduced_u.MultiplyTranspose(Field{1}, tile_input,
+                                         &coefficients.view, &workspace);
+        tile.reduced_w.MultiplyTranspose(alpha, coefficients.ConstView(),
+                                         &tile_output, &workspace);
+      }
+    } else if (tile.rank < 0) {
+      MatrixMultiplyTransposeNormal(alpha, tile.u.ConstView(), tile_input,
+                                    Field{1}, &tile_output);
+    } else if (tile.rank > 0) {
+      coefficients.Resize(tile.rank, num_rhs);
+      MatrixMultiplyTransposeNormal(Field{1}, tile.u.ConstView(), tile_input,
+                                    Field{0}, &coefficients.view);
+      MatrixMultiplyTransposeNormal(alpha, tile.w.ConstView(),
+                                    coefficients.ConstView(), Field{1},
+                                    &tile_output);
+    }
+  }
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_IMPL_H_
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/complex.hpp"
+#include "catamari/reduced_precision.hpp"
+#include "catamari/sparse_ldl/supernodal/lower_factor.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// Configuration of the block low-rank (BLR) compression of the subdiagonal
+// blocks of large supernodes. Each such block is split into square tiles,
+// which are replaced by truncated, column-pivoted QR approximations whenever
+// that requires less storage. The compressed factorization is then only an
+// approximation of the matrix, and is meant to be used as a preconditioner
+// (e.g., for 'FGMRES' or iterative refinement).
+struct BlockLowRankControl {
+  // Whether the subdiagonal blocks should be compressed.
+  bool enabled = false;
+
+  // The minimum number of columns of a supernode before its subdiagonal
+  // block is compressed.
+  Int min_supernode_size = 512;
+
+  // The height and width of the (square) tiles of each compressed block.
+  Int tile_size = 256;
+
+  // The relative accuracy, in the Frobenius norm, of each compressed tile.
+  // A non-positive tolerance stores every tile densely without attempting
+  // to compress it.
+  double tolerance = 1e-8;
+
+  // The precision in which the dense tiles and low-rank factors are stored.
+  // The reduced precisions are upcast as the tiles are applied by the
+  // solves, so that, e.g., a non-positive tolerance with half or bfloat16
+  // storage yields a preconditioner with a half or a quarter of the
+  // subdiagonal storage and solve bandwidth of a double-precision factor.
+  StoragePrecision storage_precision = kWorkingPrecision;
+};
+
+// A tile of a compressed subdiagonal block, either stored densely or as the
+// product U W of a 'height x rank' matrix with orthonormal columns and a
+// 'rank x width' matrix. Either is stored in the working precision or, after
+// 'ReduceTilePrecision', in reduced precision.
+template <class Field>
+struct LowRankTile {
+  // The position of the tile within its subdiagonal block.
+  Int row_offset = 0;
+  Int column_offset = 0;
+
+  // The dimensions of the tile.
+  Int height = 0;
+  Int width = 0;
+
+  // The rank of the approximation, or -1 if the tile is stored densely in
+  // 'u'.
+  Int rank = -1;
+
+  // The (orthonormal) column basis of the tile, or the dense tile.
+  BlasMatrix<Field> u;
+
+  // The coefficients of the tile within its column basis.
+  BlasMatrix<Field> w;
+
+  // The reduced-precision copies of 'u' and 'w', which replace them when
+  // the tile is stored in reduced precision.
+  ReducedPrecisionMatrix<Field> reduced_u;
+  ReducedPrecisionMatrix<Field> reduced_w;
+};
+
+// The BLR compression of the subdiagonal blocks of a supernodal factor.
+template <class Field>
+class BlockLowRankFactor {
+ public:
+  // Compresses the subdiagonal block of every supernode of at least
+  // 'control.min_supernode_size' columns.
+  void Compress(const BlockLowRankControl& control,
+                const Buffer<Int>& supernode_sizes,
+                const LowerFactor<Field>& lower_factor);
+
+  // Discards the compressed blocks.
+  void Clear();
+
+  // Returns true if no block is compressed.
+  bool Empty() const;
+
+  // Returns true if the subdiagonal block of the supernode is compressed.
+  bool Compressed(Int supernode) const;
+
+  // Returns the number of compressed supernodes.
+  Int NumCompressedSupernodes() const;
+
+  // Returns the number of entries of the compressed blocks when stored
+  // densely.
+  Int NumDenseEntries() const;
+
+  // Returns the number of entries stored by the compressed blocks.
+  Int NumEntries() const;
+
+  // Returns the number of bytes used to store the entries of the compressed
+  // blocks.
+  std::size_t NumBytes() const;
+
+  // Performs 'output += alpha B input', where B is the compressed subdiagonal
+  // block of the supernode.
+  void MultiplyNormal(Int supernode, const Field& alpha,
+                      const ConstBlasMatrixView<Field>& input,
+                      BlasMatrixView<Field>* output) const;
+
+  // Performs 'output += alpha B' input', where B is the compressed
+  // subdiagonal block of the supernode.
+  void MultiplyAdjoint(Int supernode, const Field& alpha,
+                       const ConstBlasMatrixView<Field>& input,
+                       BlasMatrixView<Field>* output) const;
+
+  // Performs 'output += alpha B^T input', where B is the compressed
+  // subdiagonal block of the supernode.
+  void MultiplyTranspose(Int supernode, const Field& alpha,
+                         const ConstBlasMatrixView<Field>& input,
+                         BlasMatrixView<Field>* output) const;
+
+ private:
+  // The offsets of each supernode's tiles within 'tiles_', which are empty
+  // for uncompressed supernodes.
+  Buffer<Int> tile_offsets_;
+
+  // The tiles of the compressed blocks, ordered by supernode, then by tile
+  // column, then by tile row.
+  std::vector<LowRankTile<Field>> tiles_;
+
+  // The number of compressed supernodes.
+  Int num_compressed_supernodes_ = 0;
+};
+
+// Approximates the tile so that the Frobenius norm of the error is at most
+// 'tolerance' times that of the tile, using a column-pivoted Gram-Schmidt QR
+// factorization which is truncated as soon as the residual is small enough.
+// The tile is stored densely if the approximation would not save storage.
+template <class Field>
+void CompressTile(const ConstBlasMatrixView<Field>& tile,
+                  const ComplexBase<Field>& tolerance,
+                  LowRankTile<Field>* compressed);
+
+// Replaces the working-precision factors of a tile with copies in the given
+// reduced precision.
+template <class Field>
+void ReduceTilePrecision(StoragePrecision precision,
+                         LowRankTile<Field>* tile);
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/block_low_rank-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_BLOCK_LOW_RANK_H_
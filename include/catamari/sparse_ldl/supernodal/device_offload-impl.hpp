@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "catamari/sparse_ldl/supernodal/device_offload.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+DeviceFront<Field>::~DeviceFront() {
+  if (offload_) offload_->ReleaseFront(this);
+}
+
+template <class Field>
+DeviceOffload<Field>::~DeviceOffload() {
+  ClearResidentBlocks();
+#ifdef CATAMARI_HAVE_CUDA
+  Shutdown();
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+bool DeviceOffload<Field>::Supported() {
+#ifdef CATAMARI_HAVE_CUDA
+  return cublas::IsDeviceField<Field>::value;
+#else
+  return false;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+bool DeviceOffload<Field>::Initialize(const DeviceOffloadControl& control,
+                                      Int num_supernodes) {
+  ClearResidentBlocks();
+  num_offloaded_fronts_ = 0;
+  control_ = control;
+  active_ = false;
+  if (!control.enabled || !Supported()) return false;
+#ifdef CATAMARI_HAVE_CUDA
+  if (cudaSetDevice(control.device) != cudaSuccess) return false;
+  if (!handle_ && cublasCreate(&handle_) != CUBLAS_STATUS_SUCCESS) {
+    handle_ = nullptr;
+    return false;
+  }
+  resident_blocks_.assign(num_supernodes, nullptr);
+  resident_heights_.Resize(num_supernodes, 0);
+  resident_widths_.Resize(num_supernodes, 0);
+  active_ = true;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+  return active_;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::Active() const {
+  return active_;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::UseFront(double front_work) const {
+  return active_ && front_work >= control_.min_front_work;
+}
+
+template <class Field>
+Int DeviceOffload<Field>::NumOffloadedFronts() const {
+  return num_offloaded_fronts_;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::Resident(Int supernode) const {
+#ifdef CATAMARI_HAVE_CUDA
+  return Int(resident_blocks_.size()) > supernode &&
+         resident_blocks_[supernode] != nullptr;
+#else
+  return false;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+void DeviceOffload<Field>::ClearResidentBlocks() {
+#ifdef CATAMARI_HAVE_CUDA
+  bool have_resident_blocks = false;
+  for (const Field* block : resident_blocks_) {
+    if (block) have_resident_blocks = true;
+  }
+  if (!have_resident_blocks) return;
+  cudaSetDevice(control_.device);
+  for (Field*& block : resident_blocks_) {
+    if (block) cudaFree(block);
+    block = nullptr;
+  }
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+bool DeviceOffload<Field>::MultiplyNormal(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+#ifdef CATAMARI_HAVE_CUDA
+  return Multiply(supernode, CUBLAS_OP_N, alpha, input, output);
+#else
+  return false;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+bool DeviceOffload<Field>::MultiplyAdjoint(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+#ifdef CATAMARI_HAVE_CUDA
+  return Multiply(supernode, CUBLAS_OP_C, alpha, input, output);
+#else
+  return false;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+template <class Field>
+bool DeviceOffload<Field>::MultiplyTranspose(
+    Int supernode, const Field& alpha, const ConstBlasMatrixView<Field>& input,
+    BlasMatrixView<Field>* output) const {
+#ifdef CATAMARI_HAVE_CUDA
+  return Multiply(supernode, CUBLAS_OP_T, alpha, input, output);
+#else
+  return false;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+}
+
+#ifndef CATAMARI_HAVE_CUDA
+
+template <class Field>
+bool DeviceOffload<Field>::BeginFront(
+    const ConstBlasMatrixView<Field>& /* lower_block */,
+    const ConstBlasMatrixView<Field>& /* schur_complement */,
+    bool /* accumulate */, DeviceFront<Field>* /* front */) {
+  return false;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::FinishFront(
+    Int /* supernode */, SymmetricFactorizationType /* factorization_type */,
+    const ConstBlasMatrixView<Field>& /* diagonal_block */,
+    DeviceFront<Field>* /* front */, BlasMatrixView<Field>* /* lower_block */,
+    BlasMatrixView<Field>* /* schur_complement */) {
+  return false;
+}
+
+template <class Field>
+void DeviceOffload<Field>::ReleaseFront(DeviceFront<Field>* front) {
+  front->offload_ = nullptr;
+}
+
+#else
+
+template <class Field>
+void DeviceOffload<Field>::Shutdown() {
+  cudaSetDevice(control_.device);
+  for (const std::pair<Field*, Int>& staging : staging_pool_) {
+    cudaFreeHost(staging.first);
+  }
+  staging_pool_.clear();
+  if (handle_) cublasDestroy(handle_);
+  handle_ = nullptr;
+}
+
+template <class Field>
+Field* DeviceOffload<Field>::AcquireStaging(Int size, Int* capacity) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = std::find_if(
+        staging_pool_.begin(), staging_pool_.end(),
+        [&](const std::pair<Field*, Int>& staging) {
+          return staging.second >= size;
+        });
+    if (iter != staging_pool_.end()) {
+      Field* staging = iter->first;
+      *capacity = iter->second;
+      staging_pool_.erase(iter);
+      return staging;
+    }
+  }
+  void* staging = nullptr;
+  if (cudaMallocHost(&staging, size * sizeof(Field)) != cudaSuccess) {
+    return nullptr;
+  }
+  *capacity = size;
+  return static_cast<Field*>(staging);
+}
+
+template <class Field>
+void DeviceOffload<Field>::ReleaseStaging(Field* staging, Int capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  staging_pool_.emplace_back(staging, capacity);
+}
+
+template <class Field>
+void DeviceOffload<Field>::ReleaseFront(DeviceFront<Field>* front) {
+  cudaSetDevice(control_.device);
+  if (front->compute_stream_) cudaStreamSynchronize(front->compute_stream_);
+  if (front->copy_stream_) cudaStreamSynchronize(front->copy_stream_);
+  if (front->uploaded_) cudaEventDestroy(front->uploaded_);
+  if (front->solved_) cudaEventDestroy(front->solved_);
+  if (front->compute_stream_) cudaStreamDestroy(front->compute_stream_);
+  if (front->copy_stream_) cudaStreamDestroy(front->copy_stream_);
+  if (front->lower_) cudaFree(front->lower_);
+  if (front->workspace_) cudaFree(front->workspace_);
+  if (front->staging_) ReleaseStaging(front->staging_, front->staging_size_);
+  front->uploaded_ = front->solved_ = nullptr;
+  front->compute_stream_ = front->copy_stream_ = nullptr;
+  front->lower_ = front->workspace_ = front->staging_ = nullptr;
+  front->offload_ = nullptr;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::BeginFront(
+    const ConstBlasMatrixView<Field>& lower_block,
+    const ConstBlasMatrixView<Field>& schur_complement, bool accumulate,
+    DeviceFront<Field>* front) {
+  if (!active_) return false;
+  const Int degree = lower_block.height;
+  const Int supernode_size = lower_block.width;
+  front->offload_ = this;
+  front->degree_ = degree;
+  front->supernode_size_ = supernode_size;
+  front->accumulate_ = accumulate;
+
+  // The workspace holds the Schur complement, the diagonal block, the
+  // inverse pivots, and the scaled subdiagonal block.
+  const Int lower_size = degree * supernode_size;
+  const Int workspace_size = degree * degree +
+                             supernode_size * supernode_size +
+                             supernode_size + lower_size;
+  const Int staging_size = lower_size + degree * degree +
+                           supernode_size * supernode_size + supernode_size;
+  void* lower = nullptr;
+  void* workspace = nullptr;
+  if (cudaSetDevice(control_.device) != cudaSuccess ||
+      cudaStreamCreateWithFlags(&front->compute_stream_,
+                                cudaStreamNonBlocking) != cudaSuccess ||
+      cudaStreamCreateWithFlags(&front->copy_stream_,
+                                cudaStreamNonBlocking) != cudaSuccess ||
+      cudaEventCreateWithFlags(&front->uploaded_, cudaEventDisableTiming) !=
+          cudaSuccess ||
+      cudaEventCreateWithFlags(&front->solved_, cudaEventDisableTiming) !=
+          cudaSuccess ||
+      cudaMalloc(&lower, lower_size * sizeof(Field)) != cudaSuccess) {
+    ReleaseFront(front);
+    return false;
+  }
+  front->lower_ = static_cast<Field*>(lower);
+  if (cudaMalloc(&workspace, workspace_size * sizeof(Field)) != cudaSuccess) {
+    ReleaseFront(front);
+    return false;
+  }
+  front->workspace_ = static_cast<Field*>(workspace);
+  front->staging_ = AcquireStaging(staging_size, &front->staging_size_);
+  if (!front->staging_) {
+    ReleaseFront(front);
+    return false;
+  }
+
+  // Pack the subdiagonal block and Schur complement into the pinned buffer
+  // so that the uploads proceed while the host factors the diagonal block.
+  // The Schur complement is uploaded even if it is to be overwritten so that
+  // the download leaves its (unreferenced) upper triangle unchanged.
+  Field* staged_lower = front->staging_;
+  Field* staged_schur_complement = staged_lower + lower_size;
+  for (Int j = 0; j < supernode_size; ++j) {
+    const Field* column = lower_block.Pointer(0, j);
+    std::copy(column, column + degree, staged_lower + j * degree);
+  }
+  for (Int j = 0; j < degree; ++j) {
+    const Field* column = schur_complement.Pointer(0, j);
+    std::copy(column, column + degree, staged_schur_complement + j * degree);
+  }
+  bool succeeded =
+      cudaMemcpyAsync(front->lower_, staged_lower, lower_size * sizeof(Field),
+                      cudaMemcpyHostToDevice,
+                      front->copy_stream_) == cudaSuccess &&
+      cudaMemcpyAsync(front->workspace_, staged_schur_complement,
+                      degree * degree * sizeof(Field), cudaMemcpyHostToDevice,
+                      front->copy_stream_) == cudaSuccess;
+  succeeded = succeeded && cudaEventRecord(front->uploaded_,
+                                           front->copy_stream_) == cudaSuccess;
+  if (!succeeded) {
+    ReleaseFront(front);
+    return false;
+  }
+  return true;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::FinishFront(
+    Int supernode, SymmetricFactorizationType factorization_type,
+    const ConstBlasMatrixView<Field>& diagonal_block,
+    DeviceFront<Field>* front, BlasMatrixView<Field>* lower_block,
+    BlasMatrixView<Field>* schur_complement) {
+  typedef ComplexBase<Field> Real;
+  if (!front->offload_) return false;
+  const Int degree = front->degree_;
+  const Int supernode_size = front->supernode_size_;
+  const Int lower_size = degree * supernode_size;
+  const bool is_cholesky = factorization_type == kCholeskyFactorization;
+  const cublasOperation_t operation =
+      factorization_type == kLDLTransposeFactorization ? CUBLAS_OP_T
+                                                       : CUBLAS_OP_C;
+
+  Field* device_schur_complement = front->workspace_;
+  Field* device_diagonal = device_schur_complement + degree * degree;
+  Field* device_inverse_pivots =
+      device_diagonal + supernode_size * supernode_size;
+  Field* device_scaled_lower = device_inverse_pivots + supernode_size;
+
+  // Stage the factored diagonal block and its inverse pivots.
+  Field* staged_diagonal = front->staging_ + lower_size + degree * degree;
+  Field* staged_inverse_pivots =
+      staged_diagonal + supernode_size * supernode_size;
+  for (Int j = 0; j < supernode_size; ++j) {
+    const Field* column = diagonal_block.Pointer(0, j);
+    std::copy(column, column + supernode_size,
+              staged_diagonal + j * supernode_size);
+    staged_inverse_pivots[j] = Field{1} / diagonal_block(j, j);
+  }
+
+  if (cudaSetDevice(control_.device) != cudaSuccess ||
+      cudaMemcpyAsync(device_diagonal, staged_diagonal,
+                      (supernode_size * supernode_size + supernode_size) *
+                          sizeof(Field),
+                      cudaMemcpyHostToDevice,
+                      front->compute_stream_) != cudaSuccess ||
+      cudaStreamWaitEvent(front->compute_stream_, front->uploaded_, 0) !=
+          cudaSuccess) {
+    return false;
+  }
+
+  bool launched = true;
+  if constexpr (cublas::IsDeviceField<Field>::value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    launched = cublasSetStream(handle_, front->compute_stream_) ==
+               CUBLAS_STATUS_SUCCESS;
+
+    // Solve against L(K, K)' (or D(K, K) L(K, K)^{'/T}) from the right. For
+    // the LDL factorizations, the unit-triangular solve yields L(B, K) D(K),
+    // which forms the Schur complement update with the final L(B, K).
+    launched = launched &&
+               cublas::Trsm(handle_, CUBLAS_SIDE_RIGHT, CUBLAS_FILL_MODE_LOWER,
+                            operation,
+                            is_cholesky ? CUBLAS_DIAG_NON_UNIT
+                                        : CUBLAS_DIAG_UNIT,
+                            degree, supernode_size, Field{1}, device_diagonal,
+                            supernode_size, front->lower_,
+                            degree) == CUBLAS_STATUS_SUCCESS;
+    if (!is_cholesky) {
+      launched =
+          launched &&
+          cudaMemcpyAsync(device_scaled_lower, front->lower_,
+                          lower_size * sizeof(Field),
+                          cudaMemcpyDeviceToDevice,
+                          front->compute_stream_) == cudaSuccess &&
+          cublas::Dgmm(handle_, CUBLAS_SIDE_RIGHT, degree, supernode_size,
+                       device_scaled_lower, degree, device_inverse_pivots, 1,
+                       front->lower_, degree) == CUBLAS_STATUS_SUCCESS;
+    }
+    launched = launched && cudaEventRecord(front->solved_,
+                                           front->compute_stream_) ==
+                               cudaSuccess;
+
+    const Real beta = front->accumulate_ ? Real{1} : Real{0};
+    if (is_cholesky) {
+      launched = launched &&
+                 cublas::Herk(handle_, CUBLAS_FILL_MODE_LOWER, CUBLAS_OP_N,
+                              degree, supernode_size, Real{-1}, front->lower_,
+                              degree, beta, device_schur_complement,
+                              degree) == CUBLAS_STATUS_SUCCESS;
+    } else if (factorization_type == kLDLAdjointFactorization) {
+      launched = launched &&
+                 cublas::Herkx(handle_, CUBLAS_FILL_MODE_LOWER, CUBLAS_OP_N,
+                               degree, supernode_size, Field{-1},
+                               device_scaled_lower, degree, front->lower_,
+                               degree, beta, device_schur_complement,
+                               degree) == CUBLAS_STATUS_SUCCESS;
+    } else {
+      launched = launched &&
+                 cublas::Syrkx(handle_, CUBLAS_FILL_MODE_LOWER, CUBLAS_OP_N,
+                               degree, supernode_size, Field{-1},
+                               device_scaled_lower, degree, front->lower_,
+                               degree, Field(beta), device_schur_complement,
+                               degree) == CUBLAS_STATUS_SUCCESS;
+    }
+  } else {
+    launched = false;
+  }
+  if (!launched) {
+    // Nothing has been written to the host views, so the caller can still
+    // finish the front on the host.
+    cudaStreamSynchronize(front->compute_stream_);
+    return false;
+  }
+
+  // Download the solved subdiagonal block while the Schur complement update
+  // runs, then the Schur complement.
+  bool downloaded =
+      cudaStreamWaitEvent(front->copy_stream_, front->solved_, 0) ==
+          cudaSuccess &&
+      cudaMemcpy2DAsync(lower_block->data,
+                        lower_block->leading_dim * sizeof(Field),
+                        front->lower_, degree * sizeof(Field),
+                        degree * sizeof(Field), supernode_size,
+                        cudaMemcpyDeviceToHost,
+                        front->copy_stream_) == cudaSuccess &&
+      cudaMemcpy2DAsync(schur_complement->data,
+                        schur_complement->leading_dim * sizeof(Field),
+                        device_schur_complement, degree * sizeof(Field),
+                        degree * sizeof(Field), degree,
+                        cudaMemcpyDeviceToHost,
+                        front->compute_stream_) == cudaSuccess;
+  downloaded = cudaStreamSynchronize(front->copy_stream_) == cudaSuccess &&
+               downloaded;
+  downloaded = cudaStreamSynchronize(front->compute_stream_) == cudaSuccess &&
+               downloaded;
+  if (!downloaded) {
+    throw std::runtime_error("Could not download an offloaded front");
+  }
+  ++num_offloaded_fronts_;
+
+  if (control_.keep_blocks_on_device) {
+    if (resident_blocks_[supernode]) cudaFree(resident_blocks_[supernode]);
+    resident_blocks_[supernode] = front->lower_;
+    resident_heights_[supernode] = degree;
+    resident_widths_[supernode] = supernode_size;
+    front->lower_ = nullptr;
+  }
+  ReleaseFront(front);
+  return true;
+}
+
+template <class Field>
+bool DeviceOffload<Field>::Multiply(Int supernode,
+                                    cublasOperation_t operation,
+                                    const Field& alpha,
+                                    const ConstBlasMatrixView<Field>& input,
+                                    BlasMatrixView<Field>* output) const {
+  if (!Resident(supernode)) return false;
+  const Int height = resident_heights_[supernode];
+  const Int width = resident_widths_[supernode];
+  const Int num_rhs = input.width;
+  const Int contraction_size = operation == CUBLAS_OP_N ? width : height;
+
+  cudaStream_t stream = nullptr;
+  void* buffer = nullptr;
+  if (cudaSetDevice(control_.device) != cudaSuccess ||
+      cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking) !=
+          cudaSuccess) {
+    return false;
+  }
+  const Int output_height = output->height;
+  if (cudaMalloc(&buffer, (contraction_size + output_height) * num_rhs *
+                              sizeof(Field)) != cudaSuccess) {
+    cudaStreamDestroy(stream);
+    return false;
+  }
+  Field* device_input = static_cast<Field*>(buffer);
+  Field* device_output = device_input + contraction_size * num_rhs;
+
+  bool launched =
+      cudaMemcpy2DAsync(device_input, contraction_size * sizeof(Field),
+                        input.data, input.leading_dim * sizeof(Field),
+                        contraction_size * sizeof(Field), num_rhs,
+                        cudaMemcpyHostToDevice, stream) == cudaSuccess &&
+      cudaMemcpy2DAsync(device_output, output_height * sizeof(Field),
+                        output->data, output->leading_dim * sizeof(Field),
+                        output_height * sizeof(Field), num_rhs,
+                        cudaMemcpyHostToDevice, stream) == cudaSuccess;
+  if constexpr (cublas::IsDeviceField<Field>::value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    launched = launched &&
+               cublasSetStream(handle_, stream) == CUBLAS_STATUS_SUCCESS &&
+               cublas::Gemm(handle_, operation, CUBLAS_OP_N, output_height,
+                            num_rhs, contraction_size, alpha,
+                            resident_blocks_[supernode], height, device_input,
+                            contraction_size, Field{1}, device_output,
+                            output_height) == CUBLAS_STATUS_SUCCESS;
+  } else {
+    launched = false;
+  }
+
+  bool downloaded = false;
+  if (launched) {
+    downloaded =
+        cudaMemcpy2DAsync(output->data, output->leading_dim * sizeof(Field),
+                          device_output, output_height * sizeof(Field),
+                          output_height * sizeof(Field), num_rhs,
+                          cudaMemcpyDeviceToHost, stream) == cudaSuccess;
+    downloaded = cudaStreamSynchronize(stream) == cudaSuccess && downloaded;
+  } else {
+    cudaStreamSynchronize(stream);
+  }
+  cudaFree(buffer);
+  cudaStreamDestroy(stream);
+  if (launched && !downloaded) {
+    throw std::runtime_error("Could not download an offloaded solve update");
+  }
+  return launched;
+}
+
+#endif  // ifndef CATAMARI_HAVE_CUDA
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_IMPL_H_
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_H_
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef CATAMARI_HAVE_CUDA
+#include "catamari/blas/cublas.hpp"
+#endif  // ifdef CATAMARI_HAVE_CUDA
+
+#include "catamari/blas_matrix_view.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/complex.hpp"
+#include "catamari/sparse_ldl/scalar/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// Configuration of the offload of the largest fronts of the right-looking
+// factorization to a CUDA device. The diagonal block of an offloaded front is
+// still factored on the host, while its subdiagonal block and Schur
+// complement are uploaded; cuBLAS then solves the subdiagonal block against
+// the diagonal block and forms the Schur complement update. The flag is
+// ignored unless catamari was built with CUDA support ('-Denable_cuda=true')
+// and a device is present.
+struct DeviceOffloadControl {
+  // Whether the large fronts should be offloaded.
+  bool enabled = false;
+
+  // The minimum number of flops, s^3 / 3 + d^2 s for a supernode of size s
+  // and degree d, of a front before it is offloaded. Smaller fronts, and
+  // hence the small subtrees, stay on the host.
+  double min_front_work = 1e10;
+
+  // Whether the solved subdiagonal blocks of the offloaded fronts should be
+  // kept on the device for the triangular solves.
+  bool keep_blocks_on_device = true;
+
+  // The index of the CUDA device.
+  int device = 0;
+};
+
+template <class Field>
+class DeviceOffload;
+
+// The device resources of a front between the start of its upload and the
+// download of its results. They are released upon destruction, so that a
+// front which is abandoned (e.g., after a failed pivot) leaks nothing.
+template <class Field>
+class DeviceFront {
+ public:
+  DeviceFront() = default;
+  DeviceFront(const DeviceFront&) = delete;
+  DeviceFront& operator=(const DeviceFront&) = delete;
+  ~DeviceFront();
+
+ private:
+  friend class DeviceOffload<Field>;
+
+  // The offload instance which acquired the resources, or null.
+  DeviceOffload<Field>* offload_ = nullptr;
+
+  // The dimensions of the front.
+  Int supernode_size_ = 0;
+  Int degree_ = 0;
+
+  // Whether the update is added to the Schur complement accumulated from the
+  // children rather than overwriting it.
+  bool accumulate_ = false;
+
+#ifdef CATAMARI_HAVE_CUDA
+  // The stream of the cuBLAS kernels and the stream of the transfers which
+  // overlap with them.
+  cudaStream_t compute_stream_ = nullptr;
+  cudaStream_t copy_stream_ = nullptr;
+
+  // Recorded once the subdiagonal block and Schur complement are uploaded,
+  // and once the subdiagonal block is solved, respectively.
+  cudaEvent_t uploaded_ = nullptr;
+  cudaEvent_t solved_ = nullptr;
+
+  // The 'degree x supernode_size' subdiagonal block, with a leading
+  // dimension of 'degree'. It is kept by the offload instance if the blocks
+  // are to remain on the device.
+  Field* lower_ = nullptr;
+
+  // A single allocation holding the 'degree x degree' Schur complement, the
+  // 'supernode_size x supernode_size' diagonal block, the inverse pivots
+  // and, for LDL factorizations, the 'degree x supernode_size' product of
+  // the subdiagonal block with the pivots.
+  Field* workspace_ = nullptr;
+
+  // A pinned host buffer (from the offload instance's pool) through which
+  // the uploads are staged so that they are asynchronous.
+  Field* staging_ = nullptr;
+  Int staging_size_ = 0;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+};
+
+// The device state of a supernodal factorization: the cuBLAS handle, the
+// pool of pinned staging buffers, and the subdiagonal blocks kept on the
+// device for the triangular solves. All members may be called concurrently
+// from the tasks of the factorization and of the solves.
+template <class Field>
+class DeviceOffload {
+ public:
+  DeviceOffload() = default;
+  DeviceOffload(const DeviceOffload&) = delete;
+  DeviceOffload& operator=(const DeviceOffload&) = delete;
+  ~DeviceOffload();
+
+  // Returns whether this build can offload fronts of this field.
+  static bool Supported();
+
+  // Prepares for a factorization with the given number of supernodes,
+  // discarding any blocks kept from a previous factorization. Returns whether
+  // the fronts above the threshold will be offloaded.
+  bool Initialize(const DeviceOffloadControl& control, Int num_supernodes);
+
+  // Returns whether fronts are currently offloaded.
+  bool Active() const;
+
+  // Returns whether a front with the given number of flops should be
+  // offloaded.
+  bool UseFront(double front_work) const;
+
+  // Begins the asynchronous upload of the (unsolved) subdiagonal block and
+  // the Schur complement of a front, so that the transfers overlap with the
+  // factorization of the diagonal block on the host. If 'accumulate' is
+  // false, the Schur complement will be overwritten by the update rather than
+  // added to. Returns false if the device resources could not be acquired,
+  // in which case the front must be finished on the host.
+  bool BeginFront(const ConstBlasMatrixView<Field>& lower_block,
+                  const ConstBlasMatrixView<Field>& schur_complement,
+                  bool accumulate, DeviceFront<Field>* front);
+
+  // Given the factored diagonal block, solves the uploaded subdiagonal block
+  // against it and applies the resulting Schur complement update on the
+  // device, downloading both into the host views. The download of the
+  // subdiagonal block overlaps with the Schur complement update. Returns
+  // false, without modifying either view, if the kernels could not be
+  // launched; a failed download throws a std::runtime_error.
+  bool FinishFront(Int supernode,
+                   SymmetricFactorizationType factorization_type,
+                   const ConstBlasMatrixView<Field>& diagonal_block,
+                   DeviceFront<Field>* front,
+                   BlasMatrixView<Field>* lower_block,
+                   BlasMatrixView<Field>* schur_complement);
+
+  // Returns the number of fronts finished on the device since the last
+  // initialization.
+  Int NumOffloadedFronts() const;
+
+  // Discards the subdiagonal blocks kept on the device, e.g., because the
+  // host factor was modified.
+  void ClearResidentBlocks();
+
+  // Returns whether the subdiagonal block of the supernode is kept on the
+  // device.
+  bool Resident(Int supernode) const;
+
+  // Performs 'output += alpha B input' on the device, where B is the resident
+  // subdiagonal block of the supernode. Returns false, without modifying
+  // 'output', if the device could not be used.
+  bool MultiplyNormal(Int supernode, const Field& alpha,
+                      const ConstBlasMatrixView<Field>& input,
+                      BlasMatrixView<Field>* output) const;
+
+  // Performs 'output += alpha B' input' on the device.
+  bool MultiplyAdjoint(Int supernode, const Field& alpha,
+                       const ConstBlasMatrixView<Field>& input,
+                       BlasMatrixView<Field>* output) const;
+
+  // Performs 'output += alpha B^T input' on the device.
+  bool MultiplyTranspose(Int supernode, const Field& alpha,
+                         const ConstBlasMatrixView<Field>& input,
+                         BlasMatrixView<Field>* output) const;
+
+ private:
+  friend class DeviceFront<Field>;
+
+  // The control structure of the current factorization.
+  DeviceOffloadControl control_;
+
+  // Whether fronts are currently offloaded.
+  bool active_ = false;
+
+  // The number of fronts finished on the device.
+  std::atomic<Int> num_offloaded_fronts_{0};
+
+  // Releases the resources of a front.
+  void ReleaseFront(DeviceFront<Field>* front);
+
+#ifdef CATAMARI_HAVE_CUDA
+  // Performs 'output += alpha op(B) input' for the given cuBLAS operation.
+  bool Multiply(Int supernode, cublasOperation_t operation, const Field& alpha,
+                const ConstBlasMatrixView<Field>& input,
+                BlasMatrixView<Field>* output) const;
+
+  // Returns a pinned host buffer of at least the given size from the pool,
+  // or null.
+  Field* AcquireStaging(Int size, Int* capacity);
+
+  // Returns a pinned host buffer to the pool.
+  void ReleaseStaging(Field* staging, Int capacity);
+
+  // Frees the staging pool and the handle.
+  void Shutdown();
+
+  // The cuBLAS handle, whose stream is set under 'mutex_' before each
+  // sequence of kernel launches.
+  cublasHandle_t handle_ = nullptr;
+  mutable std::mutex mutex_;
+
+  // The free pinned staging buffers and their capacities.
+  std::vector<std::pair<Field*, Int>> staging_pool_;
+
+  // The device copies of the solved subdiagonal blocks (with leading
+  // dimensions equal to their heights), or null, and their dimensions.
+  std::vector<Field*> resident_blocks_;
+  Buffer<Int> resident_heights_;
+  Buffer<Int> resident_widths_;
+#endif  // ifdef CATAMARI_HAVE_CUDA
+};
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/device_offload-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_DEVICE_OFFLOAD_H_
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_IMPL_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // if !defined _WIN32
+
+#include "catamari/sparse_ldl/supernodal/factor_archive.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+inline FactorArchiveWriter::FactorArchiveWriter(const std::string& filename)
+    : file_(filename, std::ios::binary | std::ios::trunc) {
+  if (!file_) {
+    throw std::runtime_error("Could not open factor archive " + filename);
+  }
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "CATAMARI", sizeof(header.magic));
+  header.version = kFactorArchiveVersion;
+  header.byte_order = 0x01020304;
+  header.int_size = sizeof(Int);
+  header.local_int_size = sizeof(LocalInt);
+
+  // Reserve the header, which is overwritten by 'Finish'.
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  num_bytes_ = sizeof(header);
+}
+
+template <typename T>
+void FactorArchiveWriter::WriteSection(FactorArchiveSectionIndex index,
+                                       const T* entries, Int num_entries) {
+  static const char kPadding[kFactorArchiveAlignment] = {};
+  const std::uint64_t padding =
+      (kFactorArchiveAlignment - num_bytes_ % kFactorArchiveAlignment) %
+      kFactorArchiveAlignment;
+  file_.write(kPadding, padding);
+  num_bytes_ += padding;
+
+  FactorArchiveSection& section = header.sections[index];
+  section.offset = num_bytes_;
+  section.num_bytes = num_entries * sizeof(T);
+  file_.write(reinterpret_cast<const char*>(entries), section.num_bytes);
+  num_bytes_ += section.num_bytes;
+}
+
+template <typename T>
+void FactorArchiveWriter::WriteSection(FactorArchiveSectionIndex index,
+                                       const Buffer<T>& entries) {
+  WriteSection(index, entries.Data(), entries.Size());
+}
+
+inline void FactorArchiveWriter::Finish() {
+  file_.seekp(0);
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_.close();
+  if (!file_) throw std::runtime_error("Could not write factor archive.");
+}
+
+inline void MappedFactorArchive::Map(const std::string& filename) {
+  Unmap();
+#if !defined _WIN32
+  const int file_descriptor = open(filename.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    throw std::runtime_error("Could not open factor archive " + filename +
+                             ": " + std::strerror(errno));
+  }
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0 ||
+      std::size_t(file_status.st_size) < sizeof(FactorArchiveHeader)) {
+    close(file_descriptor);
+    throw std::runtime_error(filename + " is not a factor archive.");
+  }
+
+  // The mapping is private so that the factor values may be refactored in
+  // place without modifying the archive; the mapping outlives the descriptor.
+  num_bytes_ = file_status.st_size;
+  void* mapping = mmap(nullptr, num_bytes_, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, file_descriptor, 0);
+  close(file_descriptor);
+  if (mapping == MAP_FAILED) {
+    num_bytes_ = 0;
+    throw std::runtime_error("Could not map factor archive " + filename +
+                             ": " + std::strerror(errno));
+  }
+  data_ = static_cast<char*>(mapping);
+#else
+  throw std::runtime_error("Factor archives require POSIX memory mappings.");
+#endif  // if !defined _WIN32
+
+  const FactorArchiveHeader& header = Header();
+  std::string error;
+  if (std::memcmp(header.magic, "CATAMARI", sizeof(header.magic))) {
+    error = " is not a factor archive.";
+  } else if (header.version != kFactorArchiveVersion) {
+    error = " has unsupported version " + std::to_string(header.version) + ".";
+  } else if (header.byte_order != 0x01020304 ||
+             header.int_size != sizeof(Int) ||
+             header.local_int_size != sizeof(LocalInt)) {
+    error = " was written on an incompatible platform.";
+  }
+  for (const FactorArchiveSection& section : header.sections) {
+    if (!error.empty()) break;
+    if (section.offset % kFactorArchiveAlignment ||
+        section.offset > num_bytes_ ||
+        section.num_bytes > num_bytes_ - section.offset) {
+      error = " is truncated or corrupt.";
+    }
+  }
+  if (!error.empty()) {
+    Unmap();
+    throw std::runtime_error(filename + error);
+  }
+}
+
+inline void MappedFactorArchive::Unmap() {
+#if !defined _WIN32
+  if (data_) munmap(data_, num_bytes_);
+#endif  // if !defined _WIN32
+  data_ = nullptr;
+  num_bytes_ = 0;
+}
+
+inline const FactorArchiveHeader& MappedFactorArchive::Header() const {
+  return *reinterpret_cast<const FactorArchiveHeader*>(data_);
+}
+
+template <typename T>
+T* MappedFactorArchive::Section(FactorArchiveSectionIndex index,
+                                Int* num_entries) const {
+  const FactorArchiveSection& section = Header().sections[index];
+  if (section.num_bytes % sizeof(T)) {
+    throw std::runtime_error("Factor archive section has an invalid length.");
+  }
+  *num_entries = section.num_bytes / sizeof(T);
+  return reinterpret_cast<T*>(data_ + section.offset);
+}
+
+template <typename T>
+void MappedFactorArchive::CopySection(FactorArchiveSectionIndex index,
+                                      Buffer<T>* entries) const {
+  Int num_entries;
+  const T* section = Section<T>(index, &num_entries);
+  entries->Resize(num_entries);
+  std::copy(section, section + num_entries, entries->Data());
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_IMPL_H_
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "catamari/buffer.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// The version of the factor archive format. It must be incremented whenever
+// the layout of the header or the meaning of a section changes.
+static constexpr std::uint32_t kFactorArchiveVersion = 2;
+
+// The alignment, in bytes, of the beginning of each section of an archive
+// (relative to the beginning of the file, which is page-aligned once mapped).
+static constexpr std::uint64_t kFactorArchiveAlignment = 64;
+
+// The arrays stored within a factor archive.
+enum FactorArchiveSectionIndex {
+  // SymmetricOrdering.
+  kArchivePermutation,
+  kArchiveInversePermutation,
+  kArchiveSupernodeSizes,
+  kArchiveSupernodeOffsets,
+
+  // AssemblyForest.
+  kArchiveParents,
+  kArchiveChildren,
+  kArchiveChildOffsets,
+  kArchiveRoots,
+
+  // ChildRelativeIndices.
+  kArchiveRelativeIndexOffsets,
+  kArchiveRelativeIndices,
+  kArchiveNumDiagIndices,
+
+  // The supernode of each (permuted) index.
+  kArchiveSupernodeMemberToIndex,
+
+  // The LowerFactor structure.
+  kArchiveSupernodeDegrees,
+  kArchiveStructureIndices,
+
+  // The (optional) numerical values: the unified supernode panels and, for
+  // supernodal pivoting, the supernode permutations.
+  kArchiveFactorValues,
+  kArchiveSupernodePermutations,
+
+  kNumFactorArchiveSections,
+};
+
+// The location of a section within an archive.
+struct FactorArchiveSection {
+  // The offset, in bytes, of the section from the beginning of the file.
+  std::uint64_t offset;
+
+  // The length of the section in bytes.
+  std::uint64_t num_bytes;
+};
+
+// The fixed-size header at the beginning of a factor archive. Each section
+// is a raw array in native byte order, so that a mapping of the file can
+// back the arrays directly without any parsing; the header records enough of
+// the writing platform to reject archives with an incompatible layout.
+struct FactorArchiveHeader {
+  // Always "CATAMARI".
+  char magic[8];
+
+  // The format version (see 'kFactorArchiveVersion').
+  std::uint32_t version;
+
+  // The value 0x01020304 as written in the native byte order.
+  std::uint32_t byte_order;
+
+  // The sizes of 'Int', of 'LocalInt', and of the scalar type, and whether
+  // the latter is complex.
+  std::uint32_t int_size;
+  std::uint32_t local_int_size;
+  std::uint32_t field_size;
+  std::uint32_t is_complex;
+
+  // The factorization type, the (resolved) algorithm, whether supernodal
+  // pivoting was used, and the child order of the assembly forest.
+  std::int32_t factorization_type;
+  std::int32_t algorithm;
+  std::int32_t supernodal_pivoting;
+  std::int32_t child_order;
+
+  // Whether the numerical values sections are populated.
+  std::int32_t has_values;
+
+  // The scalar members of the symbolic analysis.
+  std::int64_t num_rows;
+  std::int64_t num_supernodes;
+  std::int64_t num_interior;
+  std::int64_t max_degree;
+  std::int64_t max_lower_block_size;
+  std::int64_t left_looking_workspace_size;
+  std::int64_t left_looking_scaled_transpose_size;
+
+  // The locations of the arrays, indexed by 'FactorArchiveSectionIndex'.
+  FactorArchiveSection sections[kNumFactorArchiveSections];
+};
+
+// Writes the sections of a factor archive into a file.
+class FactorArchiveWriter {
+ public:
+  // Opens the file and reserves its header.
+  explicit FactorArchiveWriter(const std::string& filename);
+
+  // The header, which is written by 'Finish'.
+  FactorArchiveHeader header;
+
+  // Appends an (aligned) section holding the given entries.
+  template <typename T>
+  void WriteSection(FactorArchiveSectionIndex index, const T* entries,
+                    Int num_entries);
+  template <typename T>
+  void WriteSection(FactorArchiveSectionIndex index, const Buffer<T>& entries);
+
+  // Writes the header and closes the file.
+  void Finish();
+
+ private:
+  // The output file.
+  std::ofstream file_;
+
+  // The current length of the file in bytes.
+  std::uint64_t num_bytes_ = 0;
+};
+
+// A private, copy-on-write mapping of a factor archive. The sections may be
+// read (and written, without modifying the file) in place, and the clean
+// pages are shared with every other process which maps the same archive.
+class MappedFactorArchive {
+ public:
+  MappedFactorArchive() = default;
+  MappedFactorArchive(const MappedFactorArchive&) = delete;
+  MappedFactorArchive& operator=(const MappedFactorArchive&) = delete;
+  ~MappedFactorArchive() { Unmap(); }
+
+  // Maps the given archive and validates its header and section bounds.
+  void Map(const std::string& filename);
+
+  // Unmaps the archive.
+  void Unmap();
+
+  // Returns the header of the archive.
+  const FactorArchiveHeader& Header() const;
+
+  // Returns a pointer to the entries of the given section and sets
+  // 'num_entries' to their number.
+  template <typename T>
+  T* Section(FactorArchiveSectionIndex index, Int* num_entries) const;
+
+  // Fills 'entries' with a copy of the given section.
+  template <typename T>
+  void CopySection(FactorArchiveSectionIndex index, Buffer<T>* entries) const;
+
+ private:
+  // The mapped file.
+  char* data_ = nullptr;
+
+  // The number of mapped bytes.
+  std::size_t num_bytes_ = 0;
+};
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/factor_archive-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTOR_ARCHIVE_H_
@@ -8,14 +8,29 @@
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_H_
 
+#include "catamari/aligned_buffer.hpp"
 #include "catamari/blas_matrix.hpp"
 #include "catamari/buffer.hpp"
+#include "catamari/conversion_plan.hpp"
+#include "catamari/hardware_counters.hpp"
+#include "catamari/sparse_ldl/supernodal/block_low_rank.hpp"
+#include "catamari/sparse_ldl/supernodal/device_offload.hpp"
 #include "catamari/sparse_ldl/supernodal/diagonal_factor.hpp"
+#include "catamari/sparse_ldl/supernodal/factor_archive.hpp"
 #include "catamari/sparse_ldl/supernodal/lower_factor.hpp"
+#include "catamari/sparse_ldl/supernodal/out_of_core_storage.hpp"
 #include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
+#include "catamari/sparse_ldl/supernodal/tuning_profile.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/SchurComplementStorage.hpp"
+#include <tbb/info.h>
+#include <tbb/task_arena.h>
 #include <tbb/task_group.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 #ifdef CATAMARI_ENABLE_TIMERS
 #include "quotient/timer.hpp"
@@ -27,26 +42,6 @@
 
 namespace catamari {
 
-// Sparse record of destination location and source entry for each input
-// matrix entry in the lower factor. This is stored in a
-// compressed-sparse-column-type format.
-struct ConversionPlan {
-    // Destination and source of each input matrix entry appearing in the factor.
-    // Crucially does no value initialization, unlike std::pair!
-    struct Entry { Int dst, src; };
-
-    void resize(size_t size) { m_entries.Resize(size); }
-    bool empty() const { return m_entries.Size() == 0; }
-
-    const Entry *entries() const { return m_entries.Data(); }
-          Entry *entries()       { return m_entries.Data(); }
-    const Entry *columnData(int j) const { return entries() + columnOffsets[j]; }
-
-    Eigen::Array<Int, Eigen::Dynamic, 1> columnOffsets;
-private:
-    Buffer<Entry> m_entries;
-};
-
 template<class Field>
 auto eigenMap(BlasMatrixView<Field> &bm) {
     if (bm.leading_dim != bm.height) throw std::runtime_error("map fail!");
@@ -76,6 +71,40 @@ auto eigenMap(Field *ptr, int size) {
 
 namespace supernodal_ldl {
 
+// The layouts of the factor read by the triangular solves.
+enum SolveLayout {
+  // The solves read the factor in place, where each supernode's diagonal and
+  // subdiagonal blocks form a single column-major front. The row-wise
+  // traversals of the subdiagonal blocks by the small-supernode kernels are
+  // then strided by the height of the front.
+  kFrontSolveLayout,
+
+  // After each factorization, the factor is also copied into one row panel
+  // per supernode: its diagonal block followed by the adjoint (or, for LDL^T
+  // factorizations, the transpose) of its subdiagonal block, as a single
+  // column-major matrix whose leading dimension is the supernode size. The
+  // panels are stored contiguously in postorder, so that each sweep streams
+  // through every panel exactly once with unit stride, at the cost of a
+  // second copy of the factor.
+  kRowPanelSolveLayout,
+};
+
+// The operators whose inverses the solves can apply, where A is the factored
+// matrix.
+enum SolveOperation {
+  // inv(A).
+  kSolveMatrix,
+
+  // inv(A^T).
+  kSolveTranspose,
+
+  // inv(conj(A)).
+  kSolveConjugate,
+
+  // inv(A^H).
+  kSolveAdjoint,
+};
+
 // Configuration options for supernodal LDL' factorization.
 template <typename Field>
 struct Control {
@@ -85,16 +114,73 @@ struct Control {
   // Configuration for the supernodal relaxation.
   SupernodalRelaxationControl relaxation_control;
 
+  // Whether the (relaxed) supernodes should be relabeled, if needed, into a
+  // depth-first postorder of the assembly forest, so that the factor blocks
+  // of each subtree are stored contiguously, in the order in which the
+  // factorization and the solves traverse them. Orderings which do not
+  // postorder their elimination forests (e.g., prescribed orderings) would
+  // otherwise interleave the blocks of distinct subtrees.
+  bool postorder_supernodes = true;
+
   // The choice of either left-looking or right-looking LDL' factorization.
   // There is currently no supernodal up-looking support.
   LDLAlgorithm algorithm = kAdaptiveLDL;
 
+  // If positive, the number of bytes which a multithreaded factorization
+  // may occupy before the adaptive algorithm choice falls back from the
+  // right-looking factorization, whose Schur complements are held by
+  // concurrent subtrees (see 'EstimateMemory'), to the left-looking
+  // factorization, which only requires a workspace for each thread.
+  double factorization_memory_budget = 0;
+
   // Whether pivoting within each supernodal diagonal block should be enabled.
   bool supernodal_pivoting = false;
 
+  // Whether the pivots of each LDL' (or LDL^T) front which fail the threshold
+  // test (see 'delayed_pivot_threshold') should be delayed into the front of
+  // its parent, which is grown by the delayed columns, as in MUMPS. Rather
+  // than failing, a factorization of an indefinite matrix then only fails
+  // at a root which cannot accept its remaining pivots. Unless every pivot
+  // was accepted in order, the supernodes and the ordering are then refolded
+  // so that each supernode consists of the pivots it accepted, in the order
+  // in which it accepted them; subsequent refactorizations start from that
+  // analysis, and conversion plans formed before it must be re-formed (see
+  // 'Factorization::ConversionPlanIsCurrent'). The mode is serial, subsumes
+  // 'supernodal_pivoting', and does not apply dynamic regularization. It is
+  // ignored by Cholesky, partial, and out-of-core factorizations, and by
+  // factorizations into externally provided storage.
+  bool delayed_pivoting = false;
+
+  // The relative threshold, in (0, 1], of the delayed pivoting: a pivot is
+  // only accepted if its modulus is at least this multiple of that of every
+  // other entry of its (updated) column in the front.
+  double delayed_pivot_threshold = 0.01;
+
+  // Whether the delayed pivoting (which this implies) should also detect the
+  // rank of singular matrices: a pivot whose modulus is at most
+  // 'rank_detection_tolerance' times the largest modulus of the entries of
+  // the matrix is never accepted, so tiny pivots are delayed up to the
+  // roots. The pivots which remain at a root are recorded as singular,
+  // provided that what remains of its front is also below the tolerance, in
+  // which case their pivots and that remainder are replaced by zero. The
+  // factorization then succeeds, 'Solve' applies the generalized inverse
+  // which annihilates the singular pivots, 'NullSpaceBasis' returns an
+  // orthonormal basis for the null space of the factored matrix, and
+  // 'PseudoinverseSolve' applies its pseudo-inverse.
+  bool rank_detection = false;
+  double rank_detection_tolerance = 1e-10;
+
   // The amount of dynamic regularization -- if any -- to use.
   DynamicRegularizationControl<Field> dynamic_regularization;
 
+  // If nonnegative, the expected number of positive (resp. negative) pivots
+  // of the (self-adjoint) factorization. The factorization is aborted, and
+  // reported as a failure, as soon as the pivots factored so far exceed
+  // either count. For example, requiring zero negative pivots aborts at the
+  // first nonpositive pivot of an attempted positive-definite factorization.
+  Int expected_num_positive_pivots = -1;
+  Int expected_num_negative_pivots = -1;
+
   // The minimal supernode size for an out-of-place trapezoidal solve to be
   // used.
   Int forward_solve_out_of_place_supernode_threshold = 20;
@@ -109,9 +195,45 @@ struct Control {
   // The size of the matrix tiles for factorization OpenMP tasks.
   Int factor_tile_size = 128;
 
-  // The size of the matrix tiles for dense outer product OpenMP tasks.
+  // The size of the matrix tiles for dense outer product OpenMP tasks. This
+  // is also the width of the block columns of the Schur complement which the
+  // right-looking L D L' (or L D L^T) updates form from a freshly packed
+  // scaled transpose (see 'LowerScaledOuterProduct').
   Int outer_product_tile_size = 240;
 
+  // The minimum number of flops in the factorization of a single front (its
+  // diagonal block, triangular solve, and Schur complement update) before
+  // the multithreaded right-looking factorization splits it into TBB tile
+  // tasks (of sizes 'factor_tile_size' and 'outer_product_tile_size') rather
+  // than relying upon multithreaded BLAS. This is typically only the case for
+  // the large fronts near the roots, where there is little tree parallelism.
+  // A non-positive value disables the tiled fronts.
+  double min_tiled_front_work = 1e8;
+
+  // If true, the multithreaded right-looking factorization manages the BLAS
+  // threading per front: the fronts within the tree-parallel subtrees, which
+  // run as concurrent TBB tasks, use single-threaded BLAS, while the fronts
+  // above them use a thread-local count of 'root_blas_threads' BLAS threads
+  // (via mkl_set_num_threads_local). The caller's BLAS setting is restored
+  // once the factorization completes. Since OpenBLAS has no thread-local
+  // equivalent, its root fronts are then also single-threaded and rely
+  // upon the tiled fronts (see 'min_tiled_front_work') for parallelism.
+  bool mixed_blas_threading = true;
+
+  // The thread-local number of BLAS threads for the fronts above the
+  // tree-parallel subtrees when 'mixed_blas_threading' is enabled. A
+  // non-positive value selects the caller's global BLAS thread count.
+  int root_blas_threads = 0;
+
+  // The minimum number of equally-shaped leaf supernodes of a sequentially
+  // factored subtree before the multithreaded right-looking factorization
+  // factors their fronts together, in lockstep, from an interleaved copy
+  // (see 'InterleavedFactorFronts'). This amortizes the per-call overhead of
+  // the dense kernels over the many tiny leaves of large meshes. Only
+  // supernodes of at most 'kMaxSmallKernelSize' columns are batched, and a
+  // non-positive value disables the batching.
+  Int min_leaf_batch_size = 8;
+
   // The number of columns to group into a single task when multithreading
   // the addition of child Schur complement updates onto the parent.
   Int merge_grain_size = 500;
@@ -129,6 +251,188 @@ struct Control {
   // generated.
   double min_parallel_threshold = 1e5;
 
+  // If true, the multithreaded factorizations also split the chains of
+  // heavy supernodes, i.e., a supernode whose only child roots a subtree
+  // with at least the minimum parallel work is factored above that subtree
+  // rather than serially along with it. Otherwise, the first supernode of a
+  // chain with at least the minimum parallel work would serialize all of its
+  // descendants, which, for the unbalanced assembly trees of minimum-degree
+  // orderings, leaves the threads idle until the top of the tree. The fronts
+  // of a split chain are those above the tree-parallel subtrees, so their
+  // merges are multithreaded and their dense kernels use the root BLAS
+  // threads and the tiled fronts.
+  bool split_heavy_chains = true;
+
+  // The number of domains (e.g., NUMA nodes) onto which the subtrees of the
+  // multithreaded right-looking factorization are proportionally mapped (see
+  // 'ProportionalSubtreeMapping'). Each mapped subtree is factored within the
+  // task arena of its domain, which is pinned to the corresponding NUMA node
+  // when TBB detects at least that many nodes. A value of -1 requests one
+  // domain per detected NUMA node, while zero disables the mapping.
+  Int subtree_mapping_domains = 0;
+
+  // Whether the first right-looking factorization after the symbolic
+  // analysis should first-touch each mapped subtree's portion of the factor
+  // from within the task arena of its domain (see 'subtree_mapping_domains'),
+  // so that a first-touch page placement policy puts it on the NUMA node of
+  // the threads which factor it. Otherwise the pages are placed wherever
+  // they happen to be first written.
+  bool first_touch_factor_values = false;
+
+  // If nonempty, the factor is stored out-of-core in an (already unlinked)
+  // memory-mapped file within this directory rather than in main memory, so
+  // that factorizations larger than the available memory can be computed.
+  std::string out_of_core_directory;
+
+  // The number of bytes of an out-of-core factor which are kept resident.
+  // The budget is filled with the panels nearest to the roots of the assembly
+  // forest, since they are the largest and are revisited by the updates of
+  // their descendants; once factored, all other panels are written back and
+  // dropped from memory.
+  double out_of_core_memory_budget = 0;
+
+  // The number of supernode panels of an out-of-core factor which are
+  // prefetched ahead of the multithreaded triangular solves.
+  Int out_of_core_prefetch_distance = 8;
+
+  // The minimum number of flops (summed over all right-hand sides) in a
+  // subtree of the multithreaded triangular solves before its children are
+  // solved as separate tasks.
+  double min_parallel_solve_threshold = 1e5;
+
+  // The maximum number of right-hand sides swept through the multithreaded
+  // triangular solves at once. Wider right-hand sides are split into column
+  // blocks of this width so that each supernode's portion stays cache
+  // resident. A non-positive value disables the blocking.
+  Int solve_rhs_block_size = 64;
+
+  // If true, the multithreaded solves only give dedicated storage to the
+  // updates of the supernodes scheduled by dataflow and of the roots of the
+  // sequential subtrees. The other updates of each sequential subtree are
+  // pushed onto and popped from a per-thread stack (as with the Schur
+  // complements of the factorization), so that the workspace is bounded by
+  // the frontal stack profile of the subtrees rather than the sum of the
+  // degrees of all supernodes.
+  bool stack_solve_workspace = false;
+
+  // If positive, the factorization's own solve workspace is prepared for
+  // this many right-hand sides (see 'PrepareSolve') concurrently with each
+  // numerical factorization after a symbolic analysis (or directly after a
+  // symbolic-only analysis), so that the first solve does not allocate it.
+  Int prepared_solve_num_rhs = 0;
+
+  // The layout of the factor read by the triangular solves. The row-panel
+  // layout is ignored for out-of-core factors, since it would hold a copy of
+  // the factor in memory.
+  SolveLayout solve_layout = kFrontSolveLayout;
+
+  // The block low-rank compression of the subdiagonal blocks of the large
+  // supernodes, which is applied after each successful factorization (other
+  // than partial or out-of-core factorizations, and factorizations into
+  // externally provided storage). The compressed blocks replace the dense
+  // ones, which are restored (with uninitialized values) by the next
+  // refactorization. A compressed factorization supports the triangular
+  // solves, but not selected inversion, updates and downdates, or saving its
+  // values.
+  BlockLowRankControl block_low_rank;
+
+  // The offload of the largest fronts of the (multithreaded) right-looking
+  // factorization, and of the triangular-solve updates from their subdiagonal
+  // blocks, to a CUDA device. Supernodal pivoting disables it.
+  DeviceOffloadControl device_offload;
+
+  // Whether the serial subtrees of the multifrontal factorization should grow
+  // each supernode's Schur complement over that of its first child rather
+  // than allocating it before descending into the children. The child with
+  // the largest storage requirement is then visited first, which reduces the
+  // peak size of each subtree's Schur complement stack from
+  // `SchurComplementStorage::storageNeeded` to
+  // `SchurComplementStorage::storageNeededExpandInPlaceOptimal`.
+  bool expand_schur_complements_in_place = false;
+
+  // If positive, the Schur complements held on the stacks of the serial
+  // subtrees of the right-looking factorization (those of all but the roots
+  // of the subtrees) store only their lower triangles, in panels of this
+  // many columns (see 'PackedLowerMatrixView'), which nearly halves the peak
+  // size of the stacks and the memory traffic of their merges while still
+  // forming each panel through BLAS. Their fronts are neither tiled nor
+  // offloaded, and they are zeroed rather than written once (see
+  // 'write_once_assembly') before the children are merged. Zero stores full
+  // squares, as does 'expand_schur_complements_in_place', which takes
+  // precedence.
+  Int schur_complement_panel_width = 0;
+
+  // Whether the right-looking factorization should write each entry of the
+  // fronts exactly once while assembling them rather than zeroing them
+  // before accumulating into them: the matrix entries are loaded with zeros
+  // only written between them, and the first child merged into a Schur
+  // complement (or the first to contribute to one of its columns) overwrites
+  // it. This saves a pass over the front memory per refactorization, but
+  // only applies to the loading of the matrix entries if the destinations of
+  // each column of the conversion plan are sorted.
+  bool write_once_assembly = false;
+
+  // The order in which the children of each supernode are traversed by the
+  // right-looking factorization. The reordering is stored in the assembly
+  // forest, so it is only computed once per sparsity pattern.
+  ChildOrder child_order = kDefaultChildOrder;
+
+  // Whether the right-looking factorization should keep the Schur complement
+  // stacks of its subtrees and fronts allocated between factorizations so
+  // that refactorizations with the same sparsity pattern (e.g., via
+  // 'RefactorWithFixedSparsityPattern') do not reallocate them. The memory
+  // is held until 'ReleaseWorkspace' is called.
+  bool persistent_workspace = false;
+
+  // The work estimate of a subtree (see 'FillSubtreeWorkEstimates') at or
+  // above which the right-looking factorization keeps a copy of the Schur
+  // complement of its root after merging it into the parent front, so that
+  // 'RefactorChangedColumns' can add the copy in place of revisiting the
+  // subtree when none of its columns changed. Zero retains no copies. The
+  // copies are dropped by any other modification of the factor and by
+  // 'ReleaseWorkspace'.
+  double schur_complement_retention_work = 0;
+
+  // If positive, each sequential subtree of the right-looking factorization
+  // (one whose work estimate is below the threshold for spawning tasks, see
+  // 'min_parallel_threshold') with more than one supernode and whose fronts,
+  // the supernode sizes plus their degrees, are all at most this size is
+  // instead factored left-looking, with neither a stack of Schur complements
+  // nor extend-adds, before the Schur complement of its root is formed from
+  // the factored panels. Zero factors every subtree right-looking.
+  Int left_looking_subtree_max_front = 0;
+
+  // Whether the settings left at their defaults should be replaced by those
+  // of the tuning profile of this machine, if it has one (see 'AutoTune' and
+  // 'MachineTuningProfile').
+  bool use_tuning_profile = true;
+
+  // The alignment and transparent huge page policy for the factor values,
+  // the Schur complement stacks, and the row panels of the solves, and
+  // whether the leading dimensions of the row panels are padded (see
+  // 'AllocationControl').
+  AllocationControl allocation;
+
+  // Whether the multithreaded right-looking factorization should schedule
+  // the supernodes above its serial subtrees as a dataflow graph rather than
+  // through recursive fork-join task groups. Each finished child then
+  // immediately merges its Schur complement into its parent's front (the
+  // merges into any one front are serialized), and the last child of a
+  // supernode to finish goes on to factor it, so that no thread idles while
+  // waiting for the slowest of its siblings. Mapped subtrees (see
+  // 'subtree_mapping_domains') are still factored by fork-join recursion
+  // within their domains.
+  bool dataflow_scheduling = false;
+
+  // If non-null, a token through which the right-looking factorizations can
+  // be cancelled from another thread or bounded by a deadline. The token is
+  // polled as the fronts (and the left-looking subtrees) are scheduled, so a
+  // cancelled factorization returns after roughly the time of its current
+  // fronts, with 'SparseLDLResult::cancelled' set. The left-looking and
+  // delayed-pivoting factorizations do not observe it. The token must
+  // outlive the factorizations which use this control structure.
+  const CancellationToken* cancellation = nullptr;
+
 #ifdef CATAMARI_ENABLE_TIMERS
   // The max number of levels of the supernodal tree to visualize timings of.
   Int max_timing_levels = 4;
@@ -142,6 +446,12 @@ struct Control {
   // The name of the Graphviz file for the exclusive timing annotations.
   std::string exclusive_timings_filename = "exclusive.gv";
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
+
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+  // The name of the file for the roofline-style report of the hardware
+  // counters of each supernode (see 'SupernodeCountersToReport').
+  std::string hardware_counters_filename = "counters.txt";
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
 };
 
 #ifdef CATAMARI_ENABLE_TIMERS
@@ -248,6 +558,206 @@ std::ostream& operator<<(std::ostream& os,
 }
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
+// A pre-flight estimate, in bytes, of the memory of a supernodal
+// factorization, formed from its symbolic analysis alone.
+struct MemoryEstimate {
+  // The (dense) diagonal and subdiagonal blocks of the factor.
+  std::size_t factor_bytes = 0;
+
+  // The copy of the factor in row panels read by the solves, if
+  // 'Control::solve_layout' is 'kRowPanelSolveLayout'.
+  std::size_t solve_panel_bytes = 0;
+
+  // The (approximate) integer index structures of the factorization: the
+  // structures of the subdiagonal blocks, their relative indices within the
+  // parents' fronts, the permutations, and the per-supernode arrays.
+  std::size_t structure_bytes = 0;
+
+  // The peak of the Schur complement storage when the assembly forest is
+  // factored serially.
+  std::size_t serial_frontal_bytes = 0;
+
+  // The number of threads assumed by 'parallel_frontal_bytes'.
+  Int num_threads = 1;
+
+  // An upper bound on the peak of the Schur complement storage when the
+  // forest is factored by 'num_threads' threads, assuming each of the
+  // concurrently factored subtrees reaches its own peak at once.
+  std::size_t parallel_frontal_bytes = 0;
+
+  // The number of right-hand sides assumed by 'solve_workspace_bytes'.
+  Int num_right_hand_sides = 1;
+
+  // The workspace of a solve against the right-hand sides: the permuted
+  // right-hand sides and the updates of each supernode's structure.
+  std::size_t solve_workspace_bytes = 0;
+
+  // The estimated peak of a factorization by 'num_threads' threads followed
+  // by a solve.
+  std::size_t PeakBytes() const {
+    return factor_bytes + solve_panel_bytes + structure_bytes +
+           std::max(parallel_frontal_bytes, solve_workspace_bytes);
+  }
+};
+
+// Pretty prints the MemoryEstimate structure.
+inline std::ostream& operator<<(std::ostream& os,
+                                const MemoryEstimate& estimate) {
+  const double kMiB = 1024. * 1024.;
+  os << "factor:            " << estimate.factor_bytes / kMiB << " MiB\n"
+     << "solve panels:      " << estimate.solve_panel_bytes / kMiB
+     << " MiB\n"
+     << "index structures:  " << estimate.structure_bytes / kMiB << " MiB\n"
+     << "frontal (serial):  " << estimate.serial_frontal_bytes / kMiB
+     << " MiB\n"
+     << "frontal (" << estimate.num_threads
+     << " threads): " << estimate.parallel_frontal_bytes / kMiB << " MiB\n"
+     << "solve workspace (" << estimate.num_right_hand_sides
+     << " rhs): " << estimate.solve_workspace_bytes / kMiB << " MiB\n"
+     << "peak:              " << estimate.PeakBytes() / kMiB << " MiB\n";
+  return os;
+}
+
+// A report on the symbolic analysis of a supernodal factorization, formed
+// before any numerical factorization, for choosing between orderings and
+// machine sizes (see 'Factorization::Analyze'). The operation counts are
+// those of real arithmetic and the dense kernels of each front: the
+// factorization of its diagonal block, the triangular solve of its
+// subdiagonal block, and the Hermitian update of its Schur complement.
+struct AnalysisReport {
+  // The number of rows of the matrix.
+  Int num_rows = 0;
+
+  // The number of (relaxed) supernodes.
+  Int num_supernodes = 0;
+
+  // The number of explicitly stored entries of the lower triangle of the
+  // factor, including the diagonal and any explicit zeros introduced by
+  // relaxation.
+  double num_factor_nonzeros = 0;
+
+  // The flops of the diagonal block factorizations.
+  double diagonal_flops = 0;
+
+  // The flops of the subdiagonal triangular solves.
+  double trsm_flops = 0;
+
+  // The flops of the Schur complement updates.
+  double herk_flops = 0;
+
+  // The number of supernodes whose sizes lie in [2^k, 2^(k + 1)) for each
+  // entry k.
+  Buffer<Int> supernode_size_histogram;
+
+  // The number of trees, and of leaves, of the assembly forest.
+  Int num_roots = 0;
+  Int num_leaves = 0;
+
+  // The largest number of supernodes along a leaf-to-root path of the
+  // assembly forest.
+  Int tree_depth = 0;
+
+  // The largest number of supernodes at any one depth of the forest.
+  Int tree_width = 0;
+
+  // The flops of the most expensive leaf-to-root path, i.e., of the
+  // factorization with unbounded threads and each front factored by one.
+  double critical_path_flops = 0;
+
+  // The peak of the Schur complement storage of a serial factorization
+  // which visits the children of each supernode in the order minimizing it
+  // [1], i.e., by decreasing excess of its peak over its Schur complement.
+  //
+  // [1] Joseph W.H. Liu, On the storage requirement in the out-of-core
+  //     multifrontal method for sparse factorization, ACM Transactions on
+  //     Mathematical Software, 12 (3), 1986.
+  //
+  std::size_t optimal_frontal_bytes = 0;
+
+  // The memory estimate of the factorization (see 'EstimateMemory'), of
+  // which the thread and right-hand side counts also apply to the below.
+  MemoryEstimate memory;
+
+  // The bytes moved by a forward and backward solve against the right-hand
+  // sides: each sweep streams every supernode panel and reads and writes the
+  // right-hand side rows and structure updates of each supernode.
+  double solve_bytes = 0;
+
+  // The flops of a forward and backward solve against the right-hand sides.
+  double solve_flops = 0;
+
+  // Returns the flops of the factorization.
+  double Flops() const { return diagonal_flops + trsm_flops + herk_flops; }
+
+  // Returns the average parallelism of the factorization, i.e., the ratio of
+  // its flops to those of its critical path, which bounds its speedup.
+  double Parallelism() const {
+    return critical_path_flops > 0 ? Flops() / critical_path_flops : 1.;
+  }
+
+  // Returns the bound on the speedup of the factorization with the given
+  // number of threads, i.e., the lesser of the thread count and the average
+  // parallelism.
+  double SpeedupBound(Int num_threads) const {
+    return std::min(double(std::max(num_threads, Int(1))), Parallelism());
+  }
+
+  // Returns the flops per byte of the solves, which are bound by the memory
+  // bandwidth unless it is large.
+  double SolveIntensity() const {
+    return solve_bytes > 0 ? solve_flops / solve_bytes : 0.;
+  }
+};
+
+// Pretty prints the AnalysisReport structure.
+inline std::ostream& operator<<(std::ostream& os,
+                                const AnalysisReport& report) {
+  const double kMiB = 1024. * 1024.;
+  os << "rows:                " << report.num_rows << "\n"
+     << "supernodes:          " << report.num_supernodes << "\n"
+     << "factor nonzeros:     " << report.num_factor_nonzeros << "\n"
+     << "flops:               " << report.Flops() << " (diagonal "
+     << report.diagonal_flops << ", trsm " << report.trsm_flops << ", herk "
+     << report.herk_flops << ")\n"
+     << "supernode sizes:     ";
+  for (Int k = 0; k < Int(report.supernode_size_histogram.Size()); ++k) {
+    os << "[" << (Int(1) << k) << ", " << (Int(1) << (k + 1))
+       << "): " << report.supernode_size_histogram[k] << " ";
+  }
+  os << "\n"
+     << "roots / leaves:      " << report.num_roots << " / "
+     << report.num_leaves << "\n"
+     << "tree depth / width:  " << report.tree_depth << " / "
+     << report.tree_width << "\n"
+     << "critical path flops: " << report.critical_path_flops << "\n"
+     << "parallelism:         " << report.Parallelism()
+     << " (speedup bound on " << report.memory.num_threads
+     << " threads: " << report.SpeedupBound(report.memory.num_threads)
+     << ")\n"
+     << "frontal (optimal):   " << report.optimal_frontal_bytes / kMiB
+     << " MiB\n"
+     << "solve traffic (" << report.memory.num_right_hand_sides
+     << " rhs): " << report.solve_bytes / kMiB << " MiB ("
+     << report.SolveIntensity() << " flops/byte)\n"
+     << report.memory;
+  return os;
+}
+
+// A snapshot of the numerical values of a supernodal factorization (see
+// 'Factorization::Checkpoint'). It may only be restored into a factorization
+// with the structure of the one it was taken from.
+template <class Field>
+struct FactorCheckpoint {
+  // The diagonal and subdiagonal blocks of the factor.
+  AlignedBuffer<Field> factor_values;
+
+  // The supernodal pivots, if supernodal pivoting was enabled.
+  BlasMatrix<Int> supernode_permutations;
+
+  // The diagonal scaling of the input matrix, if any.
+  Buffer<ComplexBase<Field>> input_scaling;
+};
+
 // The user-facing data structure for storing a supernodal LDL' factorization.
 template <class Field>
 class Factorization {
@@ -256,11 +766,117 @@ class Factorization {
   FactorizationProfile profile;
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+  // The cycles, last-level cache misses, and analytic flops of the merge,
+  // factor, trsm, and herk phases of each supernode in the last
+  // multithreaded right-looking factorization. Each phase is attributed to
+  // the thread which ran it, so the work of any helper threads (e.g., of a
+  // tiled front or a multithreaded BLAS call) is only reflected in its time.
+  Buffer<SupernodeCounters> supernode_counters;
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+
   // Factors the given matrix using the prescribed permutation.
   SparseLDLResult<Field> Factor(const CoordinateMatrix<Field>& matrix,
                                 const SymmetricOrdering& manual_ordering,
                                 const Control<Field>& control, bool symbolic_only = false);
 
+  // Factors the given matrix using the prescribed permutation and overwrites
+  // 'right_hand_sides' with the solution of the factored system. The
+  // right-looking factorization eliminates each supernode from the
+  // right-hand sides as soon as it is factored, while its panel is still in
+  // cache, so that only the diagonal and backward solves remain afterwards.
+  // Other factorizations are simply followed by 'Solve'. The right-hand
+  // sides are unspecified if the factorization fails.
+  SparseLDLResult<Field> FactorAndSolve(
+      const CoordinateMatrix<Field>& matrix,
+      const SymmetricOrdering& manual_ordering, const Control<Field>& control,
+      BlasMatrixView<Field>* right_hand_sides);
+
+  // Factors only the first 'num_interior' rows of the matrix permuted by
+  // 'manual_ordering', which should map the remaining (interface) rows to the
+  // trailing indices. The interface rows are gathered into a single root
+  // supernode whose front is assembled but left unfactored, and the resulting
+  // Schur complement onto the interface is returned in 'schur_complement'
+  // (if it is non-null) in the interface ordering of 'manual_ordering'. The
+  // right-looking algorithm is always used, and refactorizations with the
+  // same sparsity pattern (e.g., through a 'ConversionPlan') update the Schur
+  // complement, which can be retrieved with 'PartialSchurComplement'. A
+  // partial factorization cannot be used for solves.
+  SparseLDLResult<Field> FactorPartial(const CoordinateMatrix<Field>& matrix,
+                                       const SymmetricOrdering& manual_ordering,
+                                       Int num_interior,
+                                       const Control<Field>& control,
+                                       BlasMatrix<Field>* schur_complement,
+                                       bool symbolic_only = false);
+
+  // Fills 'schur_complement' with the (full) Schur complement onto the
+  // interface rows of the last partial (re)factorization.
+  void PartialSchurComplement(BlasMatrix<Field>* schur_complement) const;
+
+  // Returns the number of interior rows of the last (partial) factorization.
+  Int NumInteriorRows() const;
+
+  // Overwrites the interior rows of the right-hand sides (in the original
+  // ordering) of the last partial factorization with inv(D_I) inv(L_I) b_I
+  // and subtracts the interior updates, L_B inv(L_I) b_I, from the interface
+  // rows, which then hold the right-hand sides of the Schur complement
+  // system. The interface front is left untouched.
+  void PartialForwardSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Given the output of 'PartialForwardSolve' whose interface rows were
+  // overwritten with the solution of the Schur complement system, overwrites
+  // the interior rows with the interior portion of the solution.
+  void PartialBackwardSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Saves the symbolic analysis -- and, if 'include_values' is true, the
+  // numerical factor -- into a versioned binary archive (see
+  // 'FactorArchiveHeader') so that it may be reloaded without recomputing the
+  // ordering, supernodes, or structure.
+  void Save(const std::string& filename, bool include_values) const;
+
+  // Restores a factorization from an archive written by 'Save' with the same
+  // scalar type and factorization type. The numerical factor, if present, is
+  // backed directly by a private mapping of the archive, so it is available
+  // for solves without being read or parsed, and its unmodified pages are
+  // shared between all processes which load the same archive. Otherwise,
+  // the factorization must be refactored (e.g., with
+  // 'RefactorWithFixedSparsityPattern') before it is used. Returns whether the
+  // numerical factor was loaded.
+  bool Load(const std::string& filename, const Control<Field>& control);
+
+  // Forms the plan for copying the entries of 'matrix' which lie in the lower
+  // triangle of the permuted matrix into the factor storage. The source of
+  // each entry is its index in 'matrix.Entries()'.
+  void FormConversionPlan(const CoordinateMatrix<Field>& matrix,
+                          ConversionPlan* cplan) const;
+
+  // Forms the plan for copying the entries of a symmetric matrix stored in
+  // the compressed-sparse-column (or, if 'compressed_rows' is true,
+  // compressed-sparse-row) pattern 'offsets'/'indices', in the original
+  // ordering, into the factor storage. The source of each entry is its index
+  // in 'indices'. Either triangle, or the full matrix, may be stored: entries
+  // of the upper triangle of the permuted matrix are mirrored into the lower
+  // triangle (without conjugation), and, when both copies are stored, the
+  // one which did not require mirroring is used. The plan is formed in
+  // parallel and each supernode's entries are sorted by destination.
+  void FormConversionPlan(Int num_rows, const Int* offsets, const Int* indices,
+                          bool compressed_rows, ConversionPlan* cplan) const;
+
+  // Returns the identifier of the current layout of the factor, which is
+  // renewed by each symbolic analysis (and load) and by each change of the
+  // structure, e.g., the refolding after delayed pivots (see
+  // 'Control::delayed_pivoting') or the growth of the sparsity pattern.
+  // Distinct layouts never share an epoch, while a clone shares the epoch of
+  // its original.
+  Int StructureEpoch() const { return structure_epoch_; }
+
+  // Returns whether 'cplan' was formed against the current layout of the
+  // factor, so that it can still be used to load values. The refactorizations
+  // through a stale plan throw.
+  bool ConversionPlanIsCurrent(const ConversionPlan& cplan) const {
+    return cplan.structureEpoch == structure_epoch_;
+  }
+
   // Factors the given matrix after having previously factored another matrix
   // with the same sparsity pattern.
   SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
@@ -272,49 +888,333 @@ class Factorization {
   SparseLDLResult<Field> RefactorWithFixedSparsityPattern(
       const CoordinateMatrix<Field>& matrix, const Control<Field>& control);
 
+  // Factors the given matrix after having previously factored (in full) a
+  // matrix whose sparsity pattern is contained in the leading block of the
+  // new one. The existing rows keep their elimination order and the new rows
+  // are ordered last. Only the supernodes whose structure can change -- those
+  // coupled to new entries and their ancestors -- are re-analyzed, and the
+  // remaining subtrees keep their supernodes and structure.
+  SparseLDLResult<Field> RefactorWithGrownSparsityPattern(
+      const CoordinateMatrix<Field>& matrix);
+
   SparseLDLResult<Field> RefactorWithFixedSparsityPattern(const ConversionPlan &cplan, const Field *Ax, Field sigma = 0, const Field *Bx = nullptr) {
       CoordinateMatrix<Field> dummy;
-      m_inputData.cplan = &cplan;
-      m_inputData.Ax = Ax;
-      m_inputData.Bx = Bx;
-      m_inputData.sigma = sigma;
+      RequireCurrentConversionPlan(cplan);
+      m_inputData.set(cplan, Ax, sigma, Bx);
+      return RightLooking(dummy);
+  }
+
+  // Factors the linear combination 'sum_k coefficients[k] X_k + shift I' of
+  // the value arrays 'X_k = values[k]', each loaded through 'cplan' as by the
+  // above, e.g., 'K - omega^2 M + i omega C' at one frequency of a sweep.
+  SparseLDLResult<Field> RefactorWithFixedSparsityPattern(const ConversionPlan &cplan, const Buffer<const Field *> &values, const Buffer<Field> &coefficients, Field shift = 0) {
+      CoordinateMatrix<Field> dummy;
+      RequireCurrentConversionPlan(cplan);
+      m_inputData.set(cplan, values, coefficients, shift);
       return RightLooking(dummy);
   }
 
+  // Factors 'A + sigma B' (or 'A + sigma I'), loaded through 'cplan' as by
+  // the above, after only the columns 'changed_columns' (in the original
+  // ordering) of the previously factored matrix changed in value; an
+  // off-diagonal entry belongs to the columns of both its row and column.
+  // Only the supernodes containing a changed column and their ancestors in
+  // the assembly forest are refactored, each by a left-looking update from
+  // the retained factor of its descendants, so that no Schur complements
+  // need to be kept between factorizations; the copies kept by
+  // 'Control::schur_complement_retention_work' are added in place of the
+  // unchanged subtrees which they summarize. The previous factorization must
+  // have succeeded and must be neither compressed nor out-of-core. The
+  // dynamic regularizations of the retained supernodes are not reported.
+  SparseLDLResult<Field> RefactorChangedColumns(
+      const Buffer<Int>& changed_columns, const ConversionPlan& cplan,
+      const Field* Ax, Field sigma = 0, const Field* Bx = nullptr);
+
+  // The values loaded through `cplan` form the linear combination
+  // `sum_k coefficients[k] X_k` of the value arrays `X_k = terms[k]`, e.g.
+  // `A + sigma B` or `K - omega^2 M + i omega C`, with `shift` added to the
+  // diagonal, e.g. for `A + sigma I`. The combination is formed entry by
+  // entry as the values are scattered, so that it is never stored.
   struct MatrixData {
     const ConversionPlan *cplan = nullptr; // Plan for copying each entry lower_factor_.
-    const Field *Ax = nullptr; // Nonzero values of matrix to factor
-    Field sigma = 0;           // Hessian modification shift magnitude. This means we factor `A + sigma I` or `A + sigma B` depending on whether `Bx == nullptr`.
-    const Field *Bx = nullptr; // Nonzero values of Hessian modification shift
+    Buffer<const Field *> terms;           // Nonzero values of each term of the matrix to factor
+    Buffer<Field> coefficients;            // Coefficient of each term
+    Field shift = 0;                       // Diagonal shift
+
+    // Loads `A + sigma B`, or `A + sigma I` if `Bx == nullptr`.
+    void set(const ConversionPlan &plan, const Field *Ax, Field sigma, const Field *Bx) {
+      cplan = &plan;
+      terms.Resize(Bx ? 2 : 1);
+      coefficients.Resize(terms.Size());
+      terms[0] = Ax;
+      coefficients[0] = Field{1};
+      if (Bx) { terms[1] = Bx; coefficients[1] = sigma; }
+      shift = Bx ? Field{0} : sigma;
+    }
+
+    // Loads `sum_k termCoefficients[k] termValues[k] + termShift I`.
+    void set(const ConversionPlan &plan, const Buffer<const Field *> &termValues, const Buffer<Field> &termCoefficients, Field termShift) {
+      if (termValues.Empty() || termValues.Size() != termCoefficients.Size())
+        throw std::runtime_error("Each of the (one or more) terms requires a coefficient");
+      cplan = &plan;
+      terms = termValues;
+      coefficients = termCoefficients;
+      shift = termShift;
+    }
+
+    // Whether the values are those of the only term.
+    bool isCopy() const { return terms.Size() == 1 && coefficients[0] == Field{1}; }
+
+    Field combined(Int src) const {
+      Field value = coefficients[0] * terms[0][src];
+      for (Int k = 1; k < Int(terms.Size()); ++k) value += coefficients[k] * terms[k][src];
+      return value;
+    }
+
+    void combineRun(const ConversionPlan::Run &r, Field *factorVals) const {
+      Field *dst = factorVals + r.dst;
+      const Field *x = terms[0] + r.src;
+      if (isCopy()) { std::copy(x, x + r.length, dst); return; }
+      for (Int i = 0; i < r.length; ++i) dst[i] = coefficients[0] * x[i];
+      for (Int k = 1; k < Int(terms.Size()); ++k) {
+        const Field c = coefficients[k];
+        x = terms[k] + r.src;
+        for (Int i = 0; i < r.length; ++i) dst[i] += c * x[i];
+      }
+    }
+
     void injectEntries(const Int j, Field *factorVals, Field &diagEntry) {
-      if (Bx) {
-        for (const ConversionPlan::Entry *e = cplan->columnData(j); e < cplan->columnData(j + 1); ++e)
-            factorVals[e->dst] = Ax[e->src] + sigma * Bx[e->src];
+      if (cplan->hasRuns()) injectRuns(j, factorVals);
+      else                  injectScattered(j, factorVals);
+      diagEntry += shift;
+    }
+
+    void injectRuns(const Int j, Field *factorVals) {
+      for (const ConversionPlan::Run *r = cplan->columnRunsBegin(j); r < cplan->columnRunsEnd(j); ++r)
+        combineRun(*r, factorVals);
+    }
+
+    // Equivalent to zeroing entries 'columnBeg' through 'columnEnd - 1' of
+    // 'factorVals' (which must contain the destinations of column 'j') and
+    // then injecting the entries, but writes each entry exactly once. The
+    // column's destinations must be sorted.
+    void assignColumn(const Int j, Field *factorVals, Int columnBeg, Int columnEnd, Field &diagEntry) {
+      Int next = columnBeg;
+      if (cplan->hasRuns()) {
+        for (const ConversionPlan::Run *r = cplan->columnRunsBegin(j); r < cplan->columnRunsEnd(j); ++r) {
+          std::fill(factorVals + next, factorVals + r->dst, Field{0});
+          combineRun(*r, factorVals);
+          next = r->dst + r->length;
+        }
       }
       else {
-        for (const ConversionPlan::Entry *e = cplan->columnData(j); e < cplan->columnData(j + 1); ++e)
+        const bool copy = isCopy();
+        for (const ConversionPlan::Entry *e = cplan->columnData(j); e < cplan->columnData(j + 1); ++e) {
+          std::fill(factorVals + next, factorVals + e->dst, Field{0});
+          factorVals[e->dst] = copy ? terms[0][e->src] : combined(e->src);
+          next = e->dst + 1;
+        }
+      }
+      std::fill(factorVals + next, factorVals + columnEnd, Field{0});
+      diagEntry += shift;
+    }
+
+    void injectScattered(const Int j, Field *factorVals) {
+      // The sources are prefetched this many entries ahead.
+      const Int kPrefetchDistance = 16;
+      const ConversionPlan::Entry *begin = cplan->columnData(j), *end = cplan->columnData(j + 1);
+      const ConversionPlan::Entry *prefetchEnd = end - std::min<Int>(kPrefetchDistance, end - begin);
+      if (isCopy()) {
+        const Field *Ax = terms[0];
+        for (const ConversionPlan::Entry *e = begin; e < end; ++e) {
+            if (e < prefetchEnd) CATAMARI_PREFETCH(Ax + e[kPrefetchDistance].src);
             factorVals[e->dst] = Ax[e->src];
-        diagEntry += sigma;
+        }
+      }
+      else {
+        const Int numTerms = terms.Size();
+        for (const ConversionPlan::Entry *e = begin; e < end; ++e) {
+            if (e < prefetchEnd) {
+                for (Int k = 0; k < numTerms; ++k) CATAMARI_PREFETCH(terms[k] + e[kPrefetchDistance].src);
+            }
+            factorVals[e->dst] = combined(e->src);
+        }
       }
     }
   };
   MatrixData m_inputData;
 
   // Initialize column `j` of the factor by zero-initializing it and then copying
-  // in values of the matrix `A` or `A + sigma B`
+  // in values of the matrix `A` or of a combination such as `A + sigma B`. In
+  // the write-once mode (see `Control::write_once_assembly`), the zeros are
+  // only written between the injected entries.
   void InitializeFactorColumn(Int j, Int local_j, BlasMatrixView<Field> &diagonal_block) {
-      using VMap = Eigen::Map<Eigen::Matrix<Field, Eigen::Dynamic, 1>>;
-      VMap(diagonal_block.Pointer(local_j, local_j),
-           diagonal_block.leading_dim - local_j).setZero();
-      m_inputData.injectEntries(j, factor_values_.Data(), diagonal_block(local_j, local_j));
+      Field *column = diagonal_block.Pointer(local_j, local_j);
+      const Int column_size = diagonal_block.leading_dim - local_j;
+      if (WriteOnceAssembly() && m_inputData.cplan->sortedColumns()) {
+          const Int column_beg = column - factor_values_.Data();
+          m_inputData.assignColumn(j, factor_values_.Data(), column_beg,
+                                   column_beg + column_size, *column);
+      }
+      else {
+          std::fill(column, column + column_size, Field{0});
+          m_inputData.injectEntries(j, factor_values_.Data(), *column);
+      }
+      if (!input_scaling_.Empty()) ScaleFactorColumn(j, local_j, diagonal_block);
+  }
+
+  // Whether each entry of the fronts should be written exactly once during
+  // their assembly (see `Control::write_once_assembly`).
+  bool WriteOnceAssembly() const { return control_.write_once_assembly; }
+
+  // The width of the panels of the packed Schur complements of the serial
+  // subtrees, or zero if they are stored as full squares (see
+  // `Control::schur_complement_panel_width`).
+  Int SchurComplementPanelWidth() const {
+    return control_.expand_schur_complements_in_place
+               ? 0
+               : std::max(control_.schur_complement_panel_width, Int(0));
   }
 
   // Returns the number of rows in the last factored matrix.
   Int NumRows() const;
 
+  // Returns the control structure of the last factorization.
+  const Control<Field>& GetControl() const { return control_; }
+
+  // Fills the sizes and the degrees (the heights of the subdiagonal blocks)
+  // of the supernodes of the symbolic analysis.
+  void SupernodeShapes(Buffer<Int>* sizes, Buffer<Int>* degrees) const;
+
+  // Returns the work estimate (see 'FillSubtreeWorkEstimates') of the entire
+  // assembly forest, and fills 'critical_path_work' with that of its most
+  // expensive leaf-to-root path. Their ratio bounds the speedup of the
+  // tree-parallel factorization when each front is factored by one thread.
+  double WorkEstimates(double* critical_path_work) const;
+
+  // Estimates the memory of factoring the symbolically analyzed matrix with
+  // 'num_threads' threads and of then solving against 'num_right_hand_sides'
+  // right-hand sides. Only the symbolic analysis is required, e.g., from a
+  // 'Factor' call with 'symbolic_only' set.
+  MemoryEstimate EstimateMemory(Int num_threads,
+                                Int num_right_hand_sides = 1) const;
+
+  // Returns the report on the symbolic analysis, including the memory
+  // estimate of 'EstimateMemory' for the given numbers of threads and
+  // right-hand sides. As the latter, only the symbolic analysis is required.
+  // The per-supernode statistics are accumulated in parallel.
+  AnalysisReport Analyze(Int num_threads, Int num_right_hand_sides = 1) const;
+
+  // Frees the Schur complement storage kept alive by
+  // 'Control::persistent_workspace' and the Schur complements kept by
+  // 'Control::schur_complement_retention_work'.
+  void ReleaseWorkspace();
+
+  // Requests that a right-looking (re)factorization running on another thread
+  // stop as soon as possible, in which case it reports failure. A request
+  // issued before the factorization begins is ignored.
+  void CancelFactorization() { shared_state_.setFailed(); }
+
+  // Sets the (positive) diagonal scaling D, in the original ordering, so that
+  // the subsequent (re)factorizations factor inv(D) A inv(D) by rescaling the
+  // entries of A as they are loaded, and 'Solve' applies inv(D) to the
+  // right-hand sides and the solutions as it permutes them. The sparse,
+  // partial and triangular solves are unaffected. An empty scaling disables
+  // the rescaling.
+  void SetInputScaling(const Buffer<ComplexBase<Field>>& scaling) {
+    input_scaling_ = scaling;
+  }
+
   // Solve a set of linear systems using the factorization.
   void Solve(BlasMatrixView<Field>* right_hand_sides, bool already_permuted = false) const;
 
+  // Solves a set of linear systems using the given workspace, so that solves
+  // from different threads (each with its own workspace) may run
+  // concurrently. A null workspace selects the factorization's own, in which
+  // case the solve must not overlap any other. Solves with an explicit
+  // workspace leave the number of BLAS threads alone, since the caller
+  // controls the concurrency.
+  void Solve(BlasMatrixView<Field>* right_hand_sides,
+             SolveWorkspace<Field>* workspace,
+             bool already_permuted = false) const;
+
+  // Solves a set of linear systems against the given operator of the factored
+  // matrix. Since an LDL^T factorization is of a (complex-)symmetric matrix
+  // and the others are of Hermitian matrices, each operator is either the
+  // matrix itself or its conjugate, and inv(conj(A)) B = conj(inv(A) conj(B)).
+  // The conjugations are applied as the right-hand sides are permuted into
+  // (and out of) the factorization's ordering rather than in separate passes.
+  void Solve(BlasMatrixView<Field>* right_hand_sides, SolveOperation operation,
+             SolveWorkspace<Field>* workspace = nullptr) const;
+
+  // Allocates and lays out the right-hand-side independent state of the
+  // solves against up to 'max_num_rhs' right-hand sides in the given
+  // workspace (or, if it is null, the factorization's own), so that the
+  // first solve is as fast as later ones. Only the symbolic analysis is
+  // required, so this can overlap the numerical factorization (see
+  // 'Control::prepared_solve_num_rhs').
+  void PrepareSolve(Int max_num_rhs,
+                    SolveWorkspace<Field>* workspace = nullptr) const;
+
+  // Solves a set of linear systems whose right-hand sides are only nonzero in
+  // the rows 'rhs_support', computing the solution only in the rows
+  // 'requested_indices' (both in the original ordering). Only the supernodes
+  // on the paths from the support (resp. the requested rows) to the roots of
+  // the assembly forest are visited in the forward (resp. backward) solve.
+  // Only the rows 'rhs_support' of 'right_hand_sides' are read and only the
+  // rows 'requested_indices' are overwritten.
+  void SolveSparse(const Buffer<Int>& rhs_support,
+                   const Buffer<Int>& requested_indices,
+                   BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Returns the (original-ordering) orthonormal basis, with one column per
+  // singular pivot, of the null space of the matrix factored with
+  // 'Control::rank_detection'. It is formed from the factor when the
+  // factorization finishes, and is empty if no pivot was singular.
+  const BlasMatrix<Field>& NullSpaceBasis() const { return null_space_basis_; }
+
+  // Overwrites the right-hand sides B with the pseudo-inverse of the matrix
+  // factored with 'Control::rank_detection' applied to them: the components
+  // of B outside of the range of the matrix are removed, the systems are
+  // solved (see 'Solve'), and the null-space components of the solutions
+  // are removed, which yields the minimum-norm least-squares solutions.
+  // Without singular pivots, this is simply 'Solve'.
+  void PseudoinverseSolve(BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Computes the entries of the inverse of the (permuted) factored matrix
+  // which lie within the sparsity pattern of the factorization via a
+  // top-down (Takahashi) traversal of the assembly forest. The lower
+  // triangle of each supernode's diagonal block, and its subdiagonal block,
+  // are stored in 'inverse_values' at the same offsets as within
+  // 'factor_values_'.
+  void SelectedInversion(BlasMatrix<Field>* inverse_values) const;
+
+  // Fills 'diagonal' with the diagonal of the inverse of the factored matrix
+  // (in the original ordering).
+  void InverseDiagonal(Buffer<Field>* diagonal) const;
+
+  // Modifies the factorization of A into that of A + sign W W' in place,
+  // where W is the given set of (original-ordering) vectors, sign is either 1
+  // or -1, and W' is the adjoint (or, for LDL^T factorizations, the
+  // transpose) of W. The support of each vector must lie within that of the
+  // column of the factor indexed by the vector's leading (permuted) nonzero,
+  // so that no fill is introduced. Only the supernodes on the paths from
+  // these leading rows to the roots of the assembly forest are visited.
+  // Returns false, leaving the factorization invalid, if a zero (or, for
+  // Cholesky factorizations, nonpositive) pivot was encountered.
+  bool UpdateDowndate(const ConstBlasMatrixView<Field>& vectors, Int sign);
+
+  // Copies the numerical values of the factorization into 'checkpoint', so
+  // that they may later be restored in place (e.g., to reject the step of a
+  // line search) rather than recomputed by a refactorization. The factor must
+  // not be block low-rank compressed.
+  void Checkpoint(FactorCheckpoint<Field>* checkpoint) const;
+
+  // Overwrites the numerical values of the factorization with those of
+  // 'checkpoint', which must have been taken from a factorization with the
+  // same structure (e.g., this one, before a refactorization).
+  void Restore(const FactorCheckpoint<Field>& checkpoint);
+
   // Solves a set of linear systems using the lower-triangular factor.
   void LowerTriangularSolve(BlasMatrixView<Field>* right_hand_sides) const;
 
@@ -358,15 +1258,51 @@ class Factorization {
   // indices into those of the original matrix.
   const Buffer<Int>& InversePermutation() const;
 
+  // Returns an immutable reference to the offsets of the (relaxed)
+  // supernodes, which partition the factorization indices.
+  const Buffer<Int>& SupernodeOffsets() const;
+
   // Incorporates the details and work required to process the supernode with
   // the given size and degree into the factorization result.
   static void IncorporateSupernodeIntoLDLResult(Int supernode_size, Int degree,
                                                 SparseLDLResult<Field>* result);
 
+  // Counts the merge of a child Schur complement of the given degree into
+  // its parent's front in the factorization result.
+  static void IncorporateMergeIntoLDLResult(Int child_degree,
+                                            SparseLDLResult<Field>* result);
+
+  // Fills the relaxation statistics of the result.
+  void IncorporateRelaxationIntoLDLResult(SparseLDLResult<Field>* result) const;
+
   // Adds in the contribution of a subtree into an overall result.
   static void MergeContribution(const SparseLDLResult<Field>& contribution,
                                 SparseLDLResult<Field>* result);
 
+  // Adds the signs of the pivots of a factored diagonal block, and their
+  // contribution to the log-determinant, into 'result' and returns the
+  // numbers of positive and negative pivots.
+  std::pair<Int, Int> CountPivotSigns(
+      const ConstBlasMatrixView<Field>& diagonal_block,
+      SparseLDLResult<Field>* result) const;
+
+  // Returns whether the given numbers of positive and negative pivots do not
+  // exceed those expected by the control structure.
+  bool InertiaAttainable(Int num_positive_pivots,
+                         Int num_negative_pivots) const;
+
+  // Returns whether an expected inertia was specified.
+  bool HaveExpectedInertia() const;
+
+  // Rescales column 'j' (the 'local_j' column of its supernode) of the factor,
+  // just after the input matrix was loaded into it, by the input scaling.
+  void ScaleFactorColumn(Int j, Int local_j,
+                         BlasMatrixView<Field>& diagonal_block);
+
+  // Returns the max norm of the input matrix after its rescaling by the
+  // input scaling (if any).
+  ComplexBase<Field> InputMaxNorm(const CoordinateMatrix<Field>& matrix) const;
+
   // Initializes a supernodal block column of the factorization using the
   // input matrix.
   void InitializeBlockColumn(Int supernode,
@@ -387,19 +1323,41 @@ class Factorization {
     result->left_looking_workspace_size_        = left_looking_workspace_size_;
     result->left_looking_scaled_transpose_size_ = left_looking_scaled_transpose_size_;
     result->work_estimates_                     = work_estimates_;
+    result->expand_in_place_storage_            = expand_in_place_storage_;
     result->total_work_                         = total_work_;
+    result->solve_work_estimates_               = solve_work_estimates_;
+    result->subtree_domains_                    = subtree_domains_;
+    result->num_interior_                       = num_interior_;
+    result->relaxation_statistics_              = relaxation_statistics_;
+    result->input_scaling_                      = input_scaling_;
+    result->singular_pivots_                    = singular_pivots_;
+    result->structure_epoch_                    = structure_epoch_;
+    result->null_space_basis_                   = null_space_basis_;
 
     result->   lower_factor_ = std::make_unique<   LowerFactor<Field>>(*   lower_factor_);
     result->diagonal_factor_ = std::make_unique<DiagonalFactor<Field>>(*diagonal_factor_);
-    result->factor_values_   = factor_values_;
+    result->AllocateFactorValues(factor_values_.Height());
+    std::copy(factor_values_.Data(),
+              factor_values_.Data() + factor_values_.Height(),
+              result->factor_values_.Data());
+    result->factor_values_touched_ = true;
+
+    // The copy of an out-of-core factor is held in memory.
+    result->out_of_core_resident_.Resize(ordering_->supernode_sizes.Size(), true);
 
     // Point the lower/diagonal factors at the correct data.
     Int dataPtrOffset = result->factor_values_.Data() - factor_values_.Data();
-    const Int ns = ordering_.supernode_sizes.Size();
+    const Int ns = ordering_->supernode_sizes.Size();
     for (Int s = 0; s < ns; ++s) {
-        result->   lower_factor_->blocks[s].data += dataPtrOffset;
+        // The subdiagonal blocks of compressed supernodes are not stored.
+        if (result->lower_factor_->blocks[s].data)
+            result->lower_factor_->blocks[s].data += dataPtrOffset;
         result->diagonal_factor_->blocks[s].data += dataPtrOffset;
     }
+    result->block_low_rank_factor_ = block_low_rank_factor_;
+    result->dense_front_offsets_   = dense_front_offsets_;
+
+    if (!solve_panels_.Empty()) result->RepackSolvePanels();
 
     return result;
   }
@@ -410,15 +1368,28 @@ class Factorization {
 
   // The representation of the permutation matrix P so that P A P' should be
   // factored. Typically, this permutation is the composition of a
-  // fill-reducing ordering and a supernodal relaxation permutation.
+  // fill-reducing ordering and a supernodal relaxation permutation. It is
+  // immutable once formed, so that clones share it (see 'MutableOrdering').
 public:
-  SymmetricOrdering ordering_;
+  std::shared_ptr<const SymmetricOrdering> ordering_ =
+      std::make_shared<SymmetricOrdering>();
 private:
 
   // An array of length 'num_rows'; the i'th member is the index of the
   // supernode containing column 'i'.
   Buffer<Int> supernode_member_to_index_;
 
+  // The number of leading (permuted) rows which are eliminated; it is less
+  // than the number of rows only for a partial factorization.
+  Int num_interior_ = 0;
+
+  // The diagonal scaling of the input matrix in the original ordering (see
+  // 'SetInputScaling'), or empty if the input is not rescaled.
+  Buffer<ComplexBase<Field>> input_scaling_;
+
+  // The outcome of the relaxation of the fundamental supernodes.
+  SupernodalRelaxationStatistics relaxation_statistics_;
+
   // The largest degree of a supernode in the factorization.
   Int max_degree_;
 
@@ -444,57 +1415,320 @@ public:
   BlasMatrix<Field> factor_values_;
 private:
 
+  // The storage viewed by 'factor_values_' unless it is mapped from a file
+  // or provided externally.
+  AlignedBuffer<Field> factor_storage_;
+
+  // Whether 'factor_values_' has been first-touched since its allocation
+  // (see 'Control::first_touch_factor_values').
+  bool factor_values_touched_ = false;
+
+  // The memory-mapped file backing 'factor_values_' for an out-of-core
+  // factorization (see 'Control::out_of_core_directory'), or null.
+  std::unique_ptr<OutOfCoreStorage<Field>> out_of_core_storage_;
+
+  // Whether the panel of each supernode is kept resident rather than evicted
+  // once factored (see 'Control::out_of_core_memory_budget').
+  Buffer<char> out_of_core_resident_;
+
+  // The mapping of the archive backing 'factor_values_' after a 'Load' of a
+  // numerical factor, or null.
+  std::unique_ptr<MappedFactorArchive> archive_;
+
   // If supernodal_pivoting is enabled, all of the supernode permutation
   // vectors are stored within this single buffer.
   BlasMatrix<Int> supernode_permutations_;
 
+  // The (permuted) indices of the singular pivots of the last rank-detecting
+  // factorization (see 'Control::rank_detection'), and the orthonormal basis
+  // of the null space they determine.
+  Buffer<Int> singular_pivots_;
+  BlasMatrix<Field> null_space_basis_;
+
+  // The identifier of the current layout of the factor (see
+  // 'StructureEpoch').
+  Int structure_epoch_ = 0;
+
   // Julian Panetta: cache work estimates
   Buffer<double> work_estimates_;
   double total_work_;
-  mutable Buffer<Field> permute_scratch_;
-  mutable RightLookingSharedState<Field> solve_shared_state_;
+
+  // The per-right-hand-side work of the triangular solves against each
+  // subtree (computed during the symbolic analysis).
+  Buffer<double> solve_work_estimates_;
+
+  // The domain of each proportionally mapped subtree root (or -1 for all
+  // other supernodes), and the task arena of each domain (see
+  // 'Control::subtree_mapping_domains'). The arenas are created on demand.
+  Buffer<Int> subtree_domains_;
+  std::vector<std::unique_ptr<tbb::task_arena>> subtree_arenas_;
+
+  // The copies of the Schur complements kept by
+  // 'Control::schur_complement_retention_work', each the lower triangle of a
+  // square matrix of its supernode's degree (or empty if none was kept). It
+  // is empty unless the last factorization was right-looking and retained
+  // copies, and it is not copied by 'Clone'.
+  Buffer<Buffer<Field>> retained_schur_complements_;
+
+  // Cached per-supernode Schur complement stack sizes for the
+  // expand-in-place strategy (see `Control::expand_schur_complements_in_place`).
+  Buffer<Int> expand_in_place_storage_;
+  // The copy of the factor read by the triangular solves when
+  // 'Control::solve_layout' is 'kRowPanelSolveLayout' (and empty otherwise),
+  // along with the views of each supernode's diagonal block and of its
+  // transposed (or adjoint) subdiagonal block within it.
+  AlignedBuffer<Field> solve_panel_values_;
+  Buffer<BlasMatrixView<Field>> solve_diagonal_blocks_;
+  Buffer<BlasMatrixView<Field>> solve_panels_;
+
+  // The block low-rank compression of the subdiagonal blocks (see
+  // 'Control::block_low_rank'). While it is nonempty, the subdiagonal blocks
+  // of the compressed supernodes are not stored in 'factor_values_' (and
+  // have null data pointers).
+  BlockLowRankFactor<Field> block_low_rank_factor_;
+
+  // The offsets of the fronts within the uncompressed factor storage, which
+  // are only kept while the factor is compressed so that conversion plans
+  // remain valid for its refactorizations.
+  Buffer<Int> dense_front_offsets_;
+
+  // The device state of the offloaded fronts (see 'Control::device_offload'),
+  // including the copies of their subdiagonal blocks used by the solves.
+  // It is not copied by 'Clone'.
+  DeviceOffload<Field> device_offload_;
+
+  // The workspace of the solves which do not provide their own.
+  mutable SolveWorkspace<Field> solve_workspace_;
+
+  // The (permuted) right-hand sides of the forward solve fused into the
+  // ongoing factorization, and whether there is one.
+  BlasMatrixView<Field> fused_right_hand_sides_;
+  bool fused_solve_ = false;
 
   // Julian Panetta: cache right-looking shared state
   RightLookingSharedState<Field> shared_state_;
 
+  // The thread-local workspaces of the multithreaded right-looking
+  // factorization.
+  RightLookingPrivateStates<Field> private_states_;
+
+  // Maps the subtrees of the assembly forest onto the domains requested by
+  // 'Control::subtree_mapping_domains' (if they have not already been) and
+  // forms the task arenas for the domains.
+  void MapSubtreesToDomains(Int max_threads);
+
+  // Runs 'func' within the task arena of the domain of 'supernode' if it is
+  // the root of a mapped subtree, and directly otherwise.
+  template <class Function>
+  void RunInSubtreeDomain(Int supernode, const Function& func);
+
+  // Zeroes the portion of 'factor_values_' of each mapped subtree from within
+  // the task arena of its domain, and the remainder from the calling arena.
+  void FirstTouchFactorValues();
+
+  // Writes back the panel of a factored supernode of an out-of-core factor
+  // and drops it from memory, unless it is within the resident budget.
+  void EvictSupernodePanel(Int supernode) const;
+
+  // Asynchronously reads in the panels of the supernodes in [beg, end) of an
+  // out-of-core factor.
+  void PrefetchSupernodePanels(Int supernode_beg, Int supernode_end) const;
+
+  // Returns a modifiable reference to the ordering, which is first copied if
+  // it is shared with a clone.
+  SymmetricOrdering& MutableOrdering();
+
+  // Shared implementation of 'Factor' and 'FactorPartial'.
+  SparseLDLResult<Field> FactorHelper(const CoordinateMatrix<Field>& matrix,
+                                      const SymmetricOrdering& manual_ordering,
+                                      Int num_interior,
+                                      const Control<Field>& control,
+                                      bool symbolic_only,
+                                      BlasMatrixView<Field>* right_hand_sides =
+                                          nullptr);
+
+  // Lays out the solve workspace for a forward solve against
+  // 'right_hand_sides' fused into the factorization (see 'FactorAndSolve').
+  void BeginFusedSolve(BlasMatrixView<Field>* right_hand_sides);
+
+  // Eliminates a freshly-factored supernode from the fused right-hand sides.
+  void FusedForwardSolveSupernode(Int supernode);
+
+  // Completes a fused solve with the diagonal and backward solves if the
+  // factorization succeeded, and releases the fused right-hand sides.
+  void EndFusedSolve(bool factored, BlasMatrixView<Field>* right_hand_sides);
+
+  // Returns the index of the unfactored interface supernode of a partial
+  // factorization, or -1 if the factorization is not partial.
+  Int InterfaceSupernode() const;
+
+  // Returns the offset into 'factor_values_' of the entry (row, column) of
+  // the permuted matrix, which must lie in the lower triangle and within the
+  // structure of the factor.
+  Int FactorEntryOffset(Int row, Int column) const;
+
   // Performs the initial analysis (and factorization initialization) for a
   // particular sparisty pattern. Subsequent factorizations with the same
   // sparsity pattern can reuse the symbolic analysis.
   void InitialFactorizationSetup(const CoordinateMatrix<Field>& matrix);
-#ifdef CATAMARI_OPENMP
+
+  // A multithreaded equivalent which runs on the TBB scheduler of the
+  // numerical factorization. It requires the ordering to have supernodes.
   void OpenMPInitialFactorizationSetup(const CoordinateMatrix<Field>& matrix);
-#endif  // ifdef CATAMARI_OPENMP
 
   // TODO(Jack Poulson): Add ReinitializeFactorization.
 
   // Form the (possibly relaxed) supernodes for the factorization.
   void FormSupernodes(const CoordinateMatrix<Field>& matrix,
                       Buffer<Int>* supernode_degrees);
-#ifdef CATAMARI_OPENMP
   void OpenMPFormSupernodes(const CoordinateMatrix<Field>& matrix,
                             Buffer<Int>* supernode_degrees);
-#endif  // ifdef CATAMARI_OPENMP
 
 private:
   void InitializeFactors(const CoordinateMatrix<Field>& matrix,
                          const Buffer<Int>& supernode_degrees);
-#ifdef CATAMARI_OPENMP
   void OpenMPInitializeFactors(const CoordinateMatrix<Field>& matrix,
                                const Buffer<Int>& supernode_degrees);
-#endif  // ifdef CATAMARI_OPENMP
+
+  // Fills the structure runs, the workspace sizes and the pivot storage of
+  // freshly allocated factors whose structure has been filled.
+  void FinishInitializingFactors(Int num_rows,
+                                 const Buffer<Int>& supernode_degrees);
+
+  // Fills the intersection sizes of the structures and the workspace sizes
+  // of the left-looking updates.
+  void FormLeftLookingWorkspaces(const Buffer<Int>& supernode_degrees);
+
+  // Fills the solve work estimates and the relative indices of each
+  // supernode's structure within its parent's front, and renews the
+  // structure epoch.
+  void FinishSymbolicAnalysis();
+
+  // Throws if 'cplan' was formed against a previous layout of the factor.
+  void RequireCurrentConversionPlan(const ConversionPlan& cplan) const;
+
+  // Returns a structure epoch which no other layout in the process has had.
+  static Int NewStructureEpoch() {
+    static std::atomic<Int> last_epoch(0);
+    return ++last_epoch;
+  }
+
+  // Marks the supernodes whose structure can change when the pattern grows
+  // into that of 'matrix', along with their ancestors. Returns whether any
+  // were marked.
+  bool MarkGrownSupernodes(const CoordinateMatrix<Field>& matrix,
+                           Buffer<char>* affected) const;
+
+  // Re-analyzes the affected supernodes (and the new rows) for the grown
+  // pattern of 'matrix' and reallocates the factors.
+  void GrowSymbolicAnalysis(const CoordinateMatrix<Field>& matrix,
+                            const Buffer<char>& affected);
 
   SparseLDLResult<Field> LeftLooking(const CoordinateMatrix<Field>& matrix);
 
   SparseLDLResult<Field> RightLooking(const CoordinateMatrix<Field>& matrix);
+
+  // Returns whether the (re)factorizations use delayed pivoting (see
+  // 'Control::delayed_pivoting' and 'Control::rank_detection').
+  bool UseDelayedPivoting() const;
+
+  // Factors the supernodes in order with threshold-pivoted fronts which
+  // delay their unacceptable pivots into their parents' fronts, and then
+  // refolds the accepted pivots of each supernode into the ordering, the
+  // supernodes, and the factor storage.
+  SparseLDLResult<Field> DelayedPivotingFactorization(
+      const CoordinateMatrix<Field>& matrix);
+
+  // Forms 'null_space_basis_' from 'singular_pivots_' by solving
+  // L' x = e_k (or L^T x = e_k) for each singular pivot k, undoing the
+  // ordering and the input scaling, and orthonormalizing the solutions.
+  void FormNullSpaceBasis();
+
+  // Zeroes the (permuted) rows of the singular pivots of the right-hand
+  // sides, which completes the diagonal solve of a rank-detecting
+  // factorization.
+  void ZeroSingularPivots(BlasMatrixView<Field>* right_hand_sides) const;
+
   SparseLDLResult<Field> OpenMPRightLooking(
       const CoordinateMatrix<Field>& matrix);
 
+  // Lays out the packed per-supernode arrays of the multithreaded solves in
+  // 'workspace' for column blocks of up to 'block_size' right-hand sides.
+  // If 'stacked', only the supernodes given dedicated storage by
+  // 'DedicatedSolveUpdate' are laid out (see
+  // 'Control::stack_solve_workspace').
+  void LayoutSolveWorkspace(Int block_size, SolveWorkspace<Field>* workspace,
+                            bool stacked = false) const;
+
+  // Returns whether the forward solve schedules the given supernode by
+  // dataflow rather than within a sequential subtree.
+  bool DataflowSolveSupernode(Int supernode, double min_parallel_work) const;
+
+  // Returns whether the update of the given supernode has dedicated storage
+  // in a stacked solve workspace, i.e., whether it is scheduled by dataflow
+  // or is the root of a sequential subtree.
+  bool DedicatedSolveUpdate(Int supernode, double min_parallel_work) const;
+
+  // Returns the number of entries of the per-thread stack needed to
+  // sequentially solve the subtree rooted at the given supernode against
+  // 'num_rhs' right-hand sides, excluding the root's own update.
+  Int SolveStackSize(Int supernode, Int num_rhs) const;
+
+  // Sorts the children in the assembly forest into 'control_.child_order'
+  // (if they are not already).
+  void SortAssemblyForestChildren();
+
   bool LeftLookingSubtree(
       Int supernode, const CoordinateMatrix<Field>& matrix,
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
       LeftLookingSharedState* shared_state, PrivateState<Field>* private_state,
       SparseLDLResult<Field>* result);
 
+  // Factors the subtree rooted at 'supernode', whose children are factored
+  // as concurrent tasks if 'TaskParallelSubtree' holds, and otherwise
+  // serially by 'LeftLookingSubtree' with the workspaces of the executing
+  // thread.
+  bool OpenMPLeftLookingSubtree(
+      Int supernode, const CoordinateMatrix<Field>& matrix,
+      const DynamicRegularizationParams<Field>& dynamic_reg_params,
+      double min_parallel_work, LeftLookingSharedState* shared_state,
+      LeftLookingPrivateStates<Field>* private_states,
+      SparseLDLResult<Field>* result);
+
+  // Flags the sequential subtrees of the right-looking factorization which
+  // are factored left-looking (see 'Control::left_looking_subtree_max_front')
+  // and prepares the left-looking state shared by them.
+  void SelectLeftLookingSubtrees(double min_parallel_work,
+                                 RightLookingSharedState<Field>* shared_state);
+
+  // Factors the subtree rooted at 'supernode' left-looking within the
+  // right-looking factorization and forms the Schur complement of its root
+  // for the merge into its parent.
+  bool HybridLeftLookingSubtree(
+      Int supernode, const CoordinateMatrix<Field>& matrix,
+      const DynamicRegularizationParams<Field>& dynamic_reg_params,
+      RightLookingSharedState<Field>* shared_state,
+      RightLookingPrivateStates<Field>* private_states,
+      SparseLDLResult<Field>* result);
+
+  // Overwrites 'schur_complement' with the sum of the updates of the
+  // factored supernodes of the subtree rooted at 'root', whose members are
+  // given by 'subtree', onto the structure of the root.
+  void FormSubtreeSchurComplement(
+      Int root, const std::vector<Int>& subtree,
+      RightLookingPrivateState<Field>* private_state,
+      BlasMatrixView<Field>* schur_complement);
+
+  // Factors the trees of the assembly forest as concurrent tasks (see
+  // 'OpenMPLeftLookingSubtree') and merges their results into 'result'.
+  // Returns false if any of the trees failed.
+  bool OpenMPLeftLookingForest(
+      const CoordinateMatrix<Field>& matrix,
+      const DynamicRegularizationParams<Field>& dynamic_reg_params,
+      LeftLookingSharedState* shared_state,
+      LeftLookingPrivateStates<Field>* private_states,
+      SparseLDLResult<Field>* result);
+
   bool RightLookingSubtree(
       Int supernode, const CoordinateMatrix<Field>& matrix,
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
@@ -505,10 +1739,21 @@ private:
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
       const Buffer<double>& work_estimates, double min_parallel_work,
       RightLookingSharedState<Field>* shared_state,
-      Buffer<PrivateState<Field>>* private_states,
-      SparseLDLResult<Field>* result,
+      RightLookingPrivateStates<Field>* private_states,
       SchurComplementStorage<Field> *subtreeStorage = nullptr);
 
+  // Factors the assembly forest by scheduling the supernodes whose subtrees
+  // contain at least 'min_parallel_work' flops as a dataflow graph (see
+  // 'Control::dataflow_scheduling'); the remaining subtrees are factored by
+  // 'OpenMPRightLookingSubtree'. As in the latter, the statistics are
+  // accumulated into the results of the private states.
+  void OpenMPRightLookingDataflow(
+      const CoordinateMatrix<Field>& matrix,
+      const DynamicRegularizationParams<Field>& dynamic_reg_params,
+      const Buffer<double>& work_estimates, double min_parallel_work,
+      RightLookingSharedState<Field>* shared_state,
+      RightLookingPrivateStates<Field>* private_states);
+
   void LeftLookingSupernodeUpdate(Int main_supernode,
                                   const CoordinateMatrix<Field>& matrix,
                                   LeftLookingSharedState* shared_state,
@@ -519,6 +1764,29 @@ private:
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
       SparseLDLResult<Field>* result);
 
+  // Advances the descendants of a supernode whose factor is retained past it
+  // in a left-looking traversal, as 'LeftLookingSupernodeUpdate' would,
+  // without updating the supernode.
+  void LeftLookingSkipSupernode(Int supernode,
+                                LeftLookingSharedState* shared_state);
+
+  // Adds the retained Schur complements (see
+  // 'Control::schur_complement_retention_work') in the list of 'supernode'
+  // within 'contributors' into its block column, and moves each into the
+  // list of the next supernode it intersects. The position of each within
+  // its structure is tracked by 'rel_rows'.
+  void AddRetainedSchurComplements(Int supernode, LinkedLists* contributors,
+                                   Buffer<Int>* rel_rows,
+                                   PrivateState<Field>* private_state);
+
+  // Keeps a copy of the Schur complement of 'supernode' if its subtree meets
+  // 'Control::schur_complement_retention_work' (and drops any stale copy
+  // otherwise).
+  void RetainSchurComplement(
+      Int supernode, const ConstBlasMatrixView<Field>& schur_complement);
+  void RetainSchurComplement(
+      Int supernode, const PackedLowerMatrixView<Field>& schur_complement);
+
   bool RightLookingSupernodeFinalize(
       Int supernode,
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
@@ -528,9 +1796,35 @@ private:
       Int supernode,
       const DynamicRegularizationParams<Field>& dynamic_reg_params,
       RightLookingSharedState<Field>* shared_state,
-      Buffer<PrivateState<Field>>* private_state,
+      RightLookingPrivateStates<Field>* private_states,
       SparseLDLResult<Field>* result);
 
+  // Returns true if the children of the given supernode are factored as
+  // tasks above it rather than within a serial subtree rooted at it: its
+  // subtree must contain at least 'min_parallel_work' flops and it must have
+  // either several children or, when splitting heavy chains (see
+  // 'Control::split_heavy_chains'), a single child whose subtree does.
+  bool TaskParallelSubtree(Int supernode, const Buffer<double>& work_estimates,
+                           double min_parallel_work) const;
+
+  // Returns true if the front of the given supernode is large enough to be
+  // factored as TBB tile tasks (see 'min_tiled_front_work').
+  bool UseTiledFront(Int supernode) const;
+
+  // Returns true if the front of the given supernode is large enough to be
+  // offloaded to the device (see 'Control::device_offload').
+  bool UseDeviceFront(Int supernode) const;
+
+  // Initializes and factors, in interleaved batches, the fronts of the
+  // equally-shaped small leaves of the subtree rooted at the given supernode
+  // and marks them in 'shared_state->batch_factored' so that only their
+  // Schur complements remain to be formed when they are finalized.
+  void OpenMPBatchFactorLeaves(Int root,
+                               const DynamicRegularizationParams<Field>&
+                                   dynamic_reg_params,
+                               RightLookingSharedState<Field>* shared_state,
+                               RightLookingPrivateStates<Field>* private_states);
+
   // Performs the portion of the lower-triangular solve corresponding to the
   // subtree with the given root supernode.
   void LowerTriangularSolveRecursion(Int supernode,
@@ -538,7 +1832,97 @@ private:
                                      Buffer<Field>* workspace) const;
   void OpenMPLowerTriangularSolveRecursion(
       Int supernode, BlasMatrixView<Field>* right_hand_sides,
-      RightLookingSharedState<Field>* shared_state, int level) const;
+      RightLookingSharedState<Field>* shared_state,
+      double min_parallel_work) const;
+
+  // Sequentially solves against the subtree rooted at the given supernode,
+  // whose update must have storage, with the updates of its descendants
+  // pushed onto and popped from 'stack' (see
+  // 'Control::stack_solve_workspace').
+  void StackedLowerTriangularSolveRecursion(
+      Int supernode, BlasMatrixView<Field>* right_hand_sides,
+      RightLookingSharedState<Field>* shared_state,
+      SchurComplementStorage<Field>* stack) const;
+
+  // Copies the right-hand sides into the permuted ordering of the
+  // factorization, applying the inverse of the input scaling (if any) and,
+  // if requested, conjugating them.
+  void GatherRightHandSides(
+      const BlasMatrixView<Field>& unpermuted_right_hand_sides,
+      BlasMatrixView<Field>* right_hand_sides, bool conjugate = false) const;
+
+  // Copies the permuted solutions back into the original ordering, applying
+  // the inverse of the input scaling (if any) and, if requested, conjugating
+  // them.
+  void ScatterRightHandSides(
+      const BlasMatrixView<Field>& right_hand_sides,
+      BlasMatrixView<Field>* unpermuted_right_hand_sides,
+      bool conjugate = false) const;
+
+  // Applies the inverse of the input scaling to right-hand sides in the
+  // original (or, if 'permuted', the factorization's) ordering.
+  void ApplyInverseInputScaling(bool permuted,
+                                BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Copies the rows of a supernode from the unpermuted right-hand sides into
+  // the permuted right-hand sides (applying the inverse of the input scaling,
+  // if any, and conjugating them if requested).
+  void GatherSupernodeRightHandSides(
+      Int supernode, const BlasMatrixView<Field>& unpermuted_right_hand_sides,
+      BlasMatrixView<Field>* right_hand_sides, bool conjugate = false) const;
+
+  // Copies the rows of a supernode from the permuted right-hand sides back
+  // into the unpermuted right-hand sides (applying the inverse of the input
+  // scaling, if any, and conjugating them if requested).
+  void ScatterSupernodeRightHandSides(
+      Int supernode, const BlasMatrixView<Field>& right_hand_sides,
+      BlasMatrixView<Field>* unpermuted_right_hand_sides,
+      bool conjugate = false) const;
+
+  // Merges the children's updates into a supernode, whose children must have
+  // completed, and performs its trapezoidal solve.
+  void OpenMPLowerTriangularSolveSupernode(
+      Int supernode, BlasMatrixView<Field>* right_hand_sides,
+      RightLookingSharedState<Field>* shared_state) const;
+
+  // Gathers a supernode's rows of the right-hand sides (if they are
+  // unpermuted) and zeros its update.
+  void BeginLowerTriangularSolveSupernode(
+      Int supernode, BlasMatrixView<Field>* right_hand_sides,
+      RightLookingSharedState<Field>* shared_state) const;
+
+  // Adds the update of a completed child into the rows of its parent
+  // supernode and into the parent's update.
+  void MergeChildSolveUpdate(Int supernode, Int child,
+                             const BlasMatrixView<Field>& child_update,
+                             BlasMatrixView<Field>* right_hand_sides,
+                             BlasMatrixView<Field>* update) const;
+
+  // Performs a supernode's trapezoidal solve once its children's updates are
+  // merged.
+  void FinishLowerTriangularSolveSupernode(
+      Int supernode, BlasMatrixView<Field>* right_hand_sides,
+      RightLookingSharedState<Field>* shared_state) const;
+
+  // Sequentially solves against the given subtree and then eliminates each
+  // ancestor whose last pending child (as counted by 'num_pending_children')
+  // this completes.
+  void OpenMPLowerTriangularSolveDataflow(
+      Int subtree, BlasMatrixView<Field>* right_hand_sides,
+      RightLookingSharedState<Field>* shared_state, double min_parallel_work,
+      std::atomic<Int>* num_pending_children) const;
+
+  // Subtracts the packed rows of 'updates' from the rows of the structure of
+  // the given supernode within 'right_hand_sides'.
+  void ScatterSubtractStructure(Int supernode,
+                                const ConstBlasMatrixView<Field>& updates,
+                                BlasMatrixView<Field>* right_hand_sides) const;
+
+  // Packs the rows of the structure of the given supernode within
+  // 'right_hand_sides' into 'packed_right_hand_sides'.
+  void GatherStructure(Int supernode,
+                       const BlasMatrixView<Field>& right_hand_sides,
+                       BlasMatrixView<Field>* packed_right_hand_sides) const;
 
   // Performs the trapezoidal solve associated with a particular supernode.
   void LowerSupernodalTrapezoidalSolve(Int supernode,
@@ -548,6 +1932,13 @@ private:
       Int supernode, BlasMatrixView<Field>* right_hand_sides,
       BlasMatrixView<Field> *supernode_schur_complement) const;
 
+  // Subtracts the updates of the given (already solved) supernode from the
+  // rows of its structure using its row panel (see 'Control::solve_layout').
+  void LowerRowPanelUpdate(
+      Int supernode,
+      const ConstBlasMatrixView<Field>& right_hand_sides_supernode,
+      BlasMatrixView<Field>* right_hand_sides, Buffer<Field>* workspace) const;
+
   // Performs the portion of the transposed lower-triangular solve
   // corresponding to the subtree with the given root supernode.
   void LowerTransposeTriangularSolveRecursion(
@@ -555,7 +1946,8 @@ private:
       Buffer<Field>* packed_input_buf) const;
   void OpenMPLowerTransposeTriangularSolveRecursion(
       Int supernode, BlasMatrixView<Field>* right_hand_sides,
-      RightLookingSharedState<Field>* shared_state, int level, tbb::task_group &tg) const;
+      RightLookingSharedState<Field>* shared_state, double min_parallel_work,
+      tbb::task_group &tg) const;
 
   // Performs the trapezoidal solve associated with a particular supernode.
   void LowerTransposeSupernodalTrapezoidalSolve(
@@ -566,19 +1958,113 @@ private:
       Int supernode, BlasMatrixView<Field>* right_hand_sides,
       BlasMatrixView<Field> &work_right_hand_sides) const;
 
-  void m_allocateFactors(const Buffer<Int> &supernode_degrees);
+  // Subtracts the contributions of the rows of the structure of the given
+  // supernode from its portion of the solution using its row panel (see
+  // 'Control::solve_layout'). The workspace must have room for the degree
+  // of the supernode times the number of right-hand sides.
+  void LowerTransposeRowPanelUpdate(
+      Int supernode, const BlasMatrixView<Field>& right_hand_sides,
+      BlasMatrixView<Field>* right_hand_sides_supernode,
+      BlasMatrixView<Field>* work_right_hand_sides) const;
+
+  // Allocates the unified factor storage and points the diagonal and lower
+  // blocks into it. If 'values' is non-null, it is used as the storage
+  // rather than allocating any.
+  void m_allocateFactors(const Buffer<Int> &supernode_degrees,
+                         Field *values = nullptr);
+
+  // Points 'factor_values_' at the given number of uninitialized entries of
+  // 'factor_storage_', which is allocated following 'Control::allocation'.
+  void AllocateFactorValues(Int num_entries);
+
+  // Returns true if 'factor_values_' views 'factor_storage_' rather than a
+  // memory-mapped file or externally provided storage.
+  bool OwnsFactorValues() const;
+
+  // Invalidates the caches which depend upon the sparsity pattern.
+  void ClearSparsityPatternCaches();
+
+  // Copies the given supernodes (or, if 'supernodes' is null, all of them)
+  // of the numerical factor into the row panels of 'Control::solve_layout',
+  // or releases the panels if that layout is not in use.
+  void RepackSolvePanels(const Buffer<Int>* supernodes = nullptr);
+
+  // Completes a successful (full) factorization by compressing the large
+  // supernodes (see 'Control::block_low_rank') and repacking the row panels
+  // of the solves.
+  void FinishFactorization(SparseLDLResult<Field>* result);
+
+  // Compresses the subdiagonal blocks of the large supernodes and compacts
+  // the factor storage down to the remaining blocks, if the block low-rank
+  // mode is enabled.
+  void CompressLowRankBlocks(SparseLDLResult<Field>* result);
+
+  // Restores the dense storage of a compressed factor (without initializing
+  // the values) so that it may be refactored.
+  void ExpandCompressedFactor();
+
+  // Points the diagonal and subdiagonal blocks into 'factor_values_' so that
+  // each front is contiguous, in postorder, omitting the subdiagonal blocks
+  // of the compressed supernodes (whose diagonal blocks are then packed).
+  void LayOutFronts();
+
+  // Throws if the factor is compressed, since the named operation requires
+  // the dense subdiagonal blocks.
+  void RequireUncompressedFactor(const char* operation) const;
+
+  // Copies 'num_entries' factor values from 'source' to 'target' in parallel
+  // chunks, which also spreads the first touch of an unplaced target.
+  static void CopyFactorValues(const Field* source, Int num_entries,
+                               Field* target);
+
+  // Fills 'supernodes' with the (sorted) list of supernodes containing the
+  // given rows of the factorization ordering, along with all of their
+  // ancestors in the assembly forest.
+  void AncestralSupernodes(const Buffer<Int>& permuted_rows,
+                           Buffer<Int>* supernodes) const;
+
+  // Selected inversion of the subtree rooted at 'supernode', given the
+  // inverse restricted to its parent's front. Each front is pushed onto
+  // 'stack' within serial subtrees.
+  void SelectedInversionSubtree(
+      Int supernode, const ConstBlasMatrixView<Field>& parent_front,
+      const Buffer<double>& work_estimates, double min_parallel_work,
+      RightLookingPrivateStates<Field>* private_states,
+      Field* inverse_values, Buffer<Field>* diagonal,
+      SchurComplementStorage<Field>* stack) const;
+
+  // Computes the inverse restricted to the front of 'supernode' once the
+  // trailing block (the inverse restricted to its structure) is filled in.
+  void SelectedInversionFront(Int supernode, BlasMatrixView<Field>* front,
+                              RightLookingPrivateState<Field>* private_state) const;
+
+  // Shared implementation of 'SelectedInversion' and 'InverseDiagonal'; either
+  // output may be null.
+  void SelectedInversion(Field* inverse_values, Buffer<Field>* diagonal) const;
 };
 
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
+#include "catamari/sparse_ldl/supernodal/factorization/analysis-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/archive-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/checkpoint-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/common-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/common_openmp-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/conversion_plan-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/delayed_pivoting-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/grown_pattern-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/io-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/left_looking-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/left_looking_openmp-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/memory-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/partial-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/right_looking-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/right_looking_openmp-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/solve-impl.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization/solve_openmp-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/selected_inversion-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/solve_sparse-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization/update_downdate-impl.hpp"
 
 #endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_H_
@@ -19,26 +19,60 @@
 #ifndef SCHURCOMPLEMENTSTORAGE_HPP
 #define SCHURCOMPLEMENTSTORAGE_HPP
 
+#include "catamari/aligned_buffer.hpp"
+#include "catamari/packed_lower_matrix_view.hpp"
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
-#include <Eigen/Dense>
+#include <atomic>
 #include <limits>
 
 namespace catamari {
 namespace supernodal_ldl {
 
+// Tracks the bytes held by a collection of `SchurComplementStorage` objects,
+// which may be (re)allocated concurrently, along with their high-water mark.
+struct StorageHighWaterMark {
+    std::atomic<std::size_t> current{0};
+    std::atomic<std::size_t> peak{0};
+
+    // Restart the tracking with `bytes` already held.
+    void reset(std::size_t bytes) {
+        current.store(bytes, std::memory_order_relaxed);
+        peak.store(bytes, std::memory_order_relaxed);
+    }
+
+    void add(std::size_t bytes) {
+        const std::size_t held = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t old_peak = peak.load(std::memory_order_relaxed);
+        while (held > old_peak && !peak.compare_exchange_weak(old_peak, held, std::memory_order_relaxed)) { }
+    }
+
+    void subtract(std::size_t bytes) { current.fetch_sub(bytes, std::memory_order_relaxed); }
+};
+
 // Manage the storage used to evaluate the Schur complements of all
 // *children* of a supernode in serial.
 // (The subtree root supernode's Schur complement will be stored
 // on the heap by the parent "parallel" node).
 template<class Field>
 struct SchurComplementStorage {
+    // The number of entries of the Schur complement of a supernode of degree
+    // `degree`, which is packed into panels of `panel_width` columns if this
+    // is positive (see `PackedLowerMatrixView`) and a full square otherwise.
+    static Int entriesNeeded(Int degree, Int panel_width) {
+        return PackedLowerMatrixView<Field>::NumEntries(degree, panel_width);
+    }
+
     // Calculate the total storage needed to evaluate the Schur complement block of
-    // `supernode`'s frontal matrix (onto the top of the stack)
-    static Int storageNeeded(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf) {
+    // `supernode`'s frontal matrix (onto the top of the stack). If
+    // `panel_width` is positive, the Schur complements of the descendants
+    // (and, if `pack_supernode`, that of `supernode`) are packed.
+    static Int storageNeeded(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf,
+                             Int panel_width = 0, bool pack_supernode = false) {
         const Int degree = lf.blocks[supernode].height;
+        const Int entries = entriesNeeded(degree, pack_supernode ? panel_width : 0);
         if (af.NumChildren(supernode) == 0) {
             // At the leaves, we store only a single Schur complement
-            return degree * degree;
+            return entries;
         }
         const Int child_beg = af.child_offsets[supernode];
         const Int child_end = af.child_offsets[supernode + 1];
@@ -47,11 +81,13 @@ struct SchurComplementStorage {
         // into the parent immediately after computing it. This avoids the need to store
         // the Schur complements of all children on the stack. However, this is not optimal
         // as it can force storage of Schur complements at multiple levels of the tree.
-        Int maxStorage = storageNeeded(af.children[child_beg], af, lf) + degree * degree; // TODO: we can reduce this to `max(storageNeeded(child_beg), degree * degree)` by expanding the first child "in place"
+        // (See `storageNeededExpandInPlace` for the strategy avoiding this.)
+        const bool pack_children = panel_width > 0;
+        Int maxStorage = storageNeeded(af.children[child_beg], af, lf, panel_width, pack_children) + entries;
 
         for (Int child_index = child_beg + 1; child_index < child_end; ++child_index) {
             const Int child = af.children[child_index];
-            maxStorage = std::max(maxStorage, storageNeeded(child, af, lf) + degree * degree);
+            maxStorage = std::max(maxStorage, storageNeeded(child, af, lf, panel_width, pack_children) + entries);
         }
 
         return maxStorage;
@@ -66,11 +102,11 @@ struct SchurComplementStorage {
         const Int child_beg = af.child_offsets[supernode];
         const Int child_end = af.child_offsets[supernode + 1];
 
-        // We use a rather primitive strategy of merging the child Schur complement
-        // into the parent immediately after computing it. This avoids the need to store
-        // the Schur complements of all children on the stack. However, this is not optimal
-        // as it can force storage of Schur complements at multiple levels of the tree.
-        Int maxStorage = std::max(storageNeededExpandInPlace(af.children[child_beg], af, lf), degree * degree); // TODO: we can reduce this to `max(storageNeeded(child_beg), degree * degree)` by expanding the first child "in place"
+        // The parent's Schur complement is only allocated after the first child
+        // finishes, and it is grown over the first child's Schur complement
+        // (which sits alone at the bottom of the stack at that point).
+        // Subsequent children are then processed on top of the parent.
+        Int maxStorage = std::max(storageNeededExpandInPlace(af.children[child_beg], af, lf), degree * degree);
 
         for (Int child_index = child_beg + 1; child_index < child_end; ++child_index) {
             const Int child = af.children[child_index];
@@ -80,58 +116,143 @@ struct SchurComplementStorage {
         return maxStorage;
     }
 
+    // Storage needed by the expand-in-place strategy when each supernode's
+    // children are visited in the order minimizing this storage.
+    // Since only the first child's front is expanded in place, the peak
+    // `max(S_first, degree^2, S_other + degree^2)` is minimized by visiting the
+    // child with the largest requirement first.
     static Int storageNeededExpandInPlaceOptimal(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf) {
         const Int degree = lf.blocks[supernode].height;
-        if (af.NumChildren(supernode) == 0) {
-            // At the leaves, we store only a single Schur complement
-            return degree * degree;
+        const Int child_beg = af.child_offsets[supernode];
+        const Int child_end = af.child_offsets[supernode + 1];
+
+        Int largest = 0, second_largest = 0;
+        for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+            const Int s = storageNeededExpandInPlaceOptimal(af.children[child_index], af, lf);
+            if (s > largest) { second_largest = largest; largest = s; }
+            else second_largest = std::max(second_largest, s);
         }
+
+        return combineExpandInPlaceOptimal(degree, child_end - child_beg, largest, second_largest);
+    }
+
+    // Fill `storage` with `storageNeededExpandInPlaceOptimal` for every
+    // supernode in the subtree rooted at `supernode` using a single traversal.
+    static Int fillStorageNeededExpandInPlaceOptimal(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf, Buffer<Int> *storage) {
+        const Int degree = lf.blocks[supernode].height;
         const Int child_beg = af.child_offsets[supernode];
         const Int child_end = af.child_offsets[supernode + 1];
 
-        Int best = std::numeric_limits<Int>::max();
-        for (Int first_child = child_beg; first_child < child_end; ++first_child) {
-            Int maxStorage = std::max(storageNeededExpandInPlaceOptimal(af.children[first_child], af, lf), degree * degree);
-            for (Int child_index = child_beg + 1; child_index < child_end; ++child_index) {
-                if (child_index == first_child) continue;
-                const Int child = af.children[child_index];
-                maxStorage = std::max(maxStorage, storageNeededExpandInPlaceOptimal(child, af, lf) + degree * degree);
-            }
-            best = std::min(best, maxStorage);
+        Int largest = 0, second_largest = 0;
+        for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+            const Int s = fillStorageNeededExpandInPlaceOptimal(af.children[child_index], af, lf, storage);
+            if (s > largest) { second_largest = largest; largest = s; }
+            else second_largest = std::max(second_largest, s);
         }
 
-        return best;
+        return (*storage)[supernode] = combineExpandInPlaceOptimal(degree, child_end - child_beg, largest, second_largest);
+    }
+
+    // Index (into `af.children`) of the child of `supernode` that should be
+    // processed first--and expanded in place--according to the per-supernode
+    // storage requirements computed by `fillStorageNeededExpandInPlaceOptimal`.
+    static Int expandInPlaceFirstChild(Int supernode, const AssemblyForest &af, const Buffer<Int> &storage) {
+        const Int child_beg = af.child_offsets[supernode];
+        const Int child_end = af.child_offsets[supernode + 1];
+        Int first = child_beg;
+        for (Int child_index = child_beg + 1; child_index < child_end; ++child_index) {
+            if (storage[af.children[child_index]] > storage[af.children[first]])
+                first = child_index;
+        }
+        return first;
     }
 
     SchurComplementStorage(Int cap = 0) { reallocate(cap); }
 
-    void reallocate(Int s) { m_storage.resize(s); m_stackTop = 0; }
-    Int capacity() const { return m_storage.size(); }
+    // Empty the stack and size it to hold `s` entries. Persistent storage is
+    // only ever grown so that repeated factorizations reuse its memory.
+    void reallocate(Int s) {
+        const Int old_capacity = capacity();
+        if (!m_persistent || (s > capacity())) m_storage.Resize(s);
+        track(old_capacity);
+        m_stackTop = 0;
+        m_peak = 0;
+    }
+    Int capacity() const { return m_storage.Size(); }
     Int     size() const { return m_stackTop; }
 
+    // The largest number of entries in use since the last reallocation.
+    Int     peak() const { return m_peak; }
+
     BlasMatrixView<Field> allocateSingleMatrixForDegree(int degree) {
         reallocate(degree * degree);
         return push(degree);
     }
 
-    void deallocate() { m_storage.resize(0); m_stackTop = 0; }
+    // Empty the stack, freeing its memory unless the storage is persistent.
+    void deallocate() {
+        const Int old_capacity = capacity();
+        if (!m_persistent) m_storage.Clear();
+        track(old_capacity);
+        m_stackTop = 0;
+    }
+
+    // Free the stack's memory regardless of whether the storage is persistent.
+    void release() {
+        const Int old_capacity = capacity();
+        m_storage.Clear();
+        track(old_capacity);
+        m_stackTop = 0;
+    }
+
+    // Report subsequent changes of the capacity to `tracker` (if non-null).
+    void setMemoryTracker(StorageHighWaterMark *tracker) { m_tracker = tracker; }
+
+    // Whether `deallocate` should keep the memory around for reuse.
+    void setPersistent(bool persistent) { m_persistent = persistent; }
+    bool isPersistent() const { return m_persistent; }
+
+    // The alignment and huge page policy of subsequent (re)allocations.
+    void setAllocationControl(const AllocationControl &control) { m_storage.SetControl(control); }
 
     // Allocate a `n x n` matrix at the top of the stack
-    BlasMatrixView<Field> push(Int n) {
-        if (size() + n * n > capacity()) throw std::runtime_error("Ran out of stack space attempting push " + std::to_string(n * n) + " at size " + std::to_string(size()) + "/" + std::to_string(capacity()));
+    BlasMatrixView<Field> push(Int n) { return push(n, n); }
+
+    // Allocate the lower triangle of a `n x n` matrix, packed into panels of
+    // `panel_width` columns, at the top of the stack
+    PackedLowerMatrixView<Field> pushPacked(Int n, Int panel_width) {
+        BlasMatrixView<Field> storage = push(entriesNeeded(n, panel_width), 1);
+        PackedLowerMatrixView<Field> result;
+        result.size = n;
+        result.panel_width = panel_width;
+        result.data = storage.data;
+        return result;
+    }
+
+    // Allocate a `height x width` matrix (with leading dimension `height`) at
+    // the top of the stack
+    BlasMatrixView<Field> push(Int height, Int width) {
+        const Int n = height * width;
+        if (size() + n > capacity()) throw std::runtime_error("Ran out of stack space attempting push " + std::to_string(n) + " at size " + std::to_string(size()) + "/" + std::to_string(capacity()));
         BlasMatrixView<Field> result;
-        result.width = result.height = result.leading_dim = n;
-        result.data = m_storage.data() + m_stackTop;
-        m_stackTop += n * n;
-        // std::cout << "Push " << n * n << ", new size " << size() << "/" << capacity() << std::endl;
+        result.height = height;
+        result.width = width;
+        result.leading_dim = height;
+        result.data = m_storage.Data() + m_stackTop;
+        m_stackTop += n;
+        m_peak = std::max(m_peak, m_stackTop);
+        // std::cout << "Push " << n << ", new size " << size() << "/" << capacity() << std::endl;
         return result;
     }
 
     // Remove a `n x n` matrix from the top of the stack
-    void pop(Int n) {
-        // std::cout << "Pop " << n * n << " attempted at size " << size() << std::endl;
-        if (n * n > size()) throw std::runtime_error("Out-of-bounds pop");
-        m_stackTop -= n * n;
+    void pop(Int n) { pop(n, n); }
+
+    // Remove a `height x width` matrix from the top of the stack
+    void pop(Int height, Int width) {
+        // std::cout << "Pop " << height * width << " attempted at size " << size() << std::endl;
+        if (height * width > size()) throw std::runtime_error("Out-of-bounds pop");
+        m_stackTop -= height * width;
     }
 
     void free(BlasMatrixView<Field> &sc) {
@@ -140,16 +261,43 @@ struct SchurComplementStorage {
         sc.data = nullptr;
     }
 
-    Int getStoragedNeeded(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf) {
-        if (m_cachedStorageNeeded == -1)
-            m_cachedStorageNeeded = storageNeeded(supernode, af, lf);
+    void free(PackedLowerMatrixView<Field> &sc) {
+        pop(sc.NumEntries(), 1);
+        sc.size = 0;
+        sc.data = nullptr;
+    }
+
+    Int getStoragedNeeded(Int supernode, const AssemblyForest &af, const LowerFactor<Field> &lf,
+                          Int panel_width = 0) {
+        if (m_cachedStorageNeeded == -1 || m_cachedPanelWidth != panel_width) {
+            m_cachedStorageNeeded = storageNeeded(supernode, af, lf, panel_width);
+            m_cachedPanelWidth = panel_width;
+        }
         return m_cachedStorageNeeded;
     }
 
 private:
-    Eigen::Matrix<Field, Eigen::Dynamic, 1> m_storage;
+    // Report the change of the capacity from `old_capacity` to the tracker.
+    void track(Int old_capacity) {
+        if (!m_tracker || capacity() == old_capacity) return;
+        if (capacity() > old_capacity) m_tracker->add((capacity() - old_capacity) * sizeof(Field));
+        else                            m_tracker->subtract((old_capacity - capacity()) * sizeof(Field));
+    }
+
+    static Int combineExpandInPlaceOptimal(Int degree, Int num_children, Int largest, Int second_largest) {
+        if (num_children == 0) return degree * degree;
+        Int result = std::max(largest, degree * degree);
+        if (num_children > 1) result = std::max(result, second_largest + degree * degree);
+        return result;
+    }
+
+    AlignedBuffer<Field> m_storage;
     Int m_stackTop = 0;
+    Int m_peak = 0;
+    bool m_persistent = false;
+    StorageHighWaterMark *m_tracker = nullptr;
     Int m_cachedStorageNeeded = -1; // cache to avoid repeated calculation of subtree storage requirements.
+    Int m_cachedPanelWidth = 0;     // the panel width of the descendants' Schur complements in the cached requirement.
 };
 
 }  // namespace supernodal_ldl
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ANALYSIS_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ANALYSIS_IMPL_H_
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+namespace analysis_report {
+
+// The statistics of a range of supernodes which are summed by the parallel
+// reduction of 'Factorization::Analyze'.
+struct SupernodeTotals {
+  double num_factor_nonzeros = 0;
+  double diagonal_flops = 0;
+  double trsm_flops = 0;
+  double herk_flops = 0;
+  double solve_flops = 0;
+  double solve_entries = 0;
+  std::array<Int, 8 * sizeof(Int)> size_histogram{};
+
+  SupernodeTotals& operator+=(const SupernodeTotals& totals) {
+    num_factor_nonzeros += totals.num_factor_nonzeros;
+    diagonal_flops += totals.diagonal_flops;
+    trsm_flops += totals.trsm_flops;
+    herk_flops += totals.herk_flops;
+    solve_flops += totals.solve_flops;
+    solve_entries += totals.solve_entries;
+    for (std::size_t k = 0; k < size_histogram.size(); ++k) {
+      size_histogram[k] += totals.size_histogram[k];
+    }
+    return *this;
+  }
+};
+
+// Returns the index of the most significant bit of a positive integer.
+inline Int FloorLog2(Int value) {
+  Int log = 0;
+  while (value >>= 1) ++log;
+  return log;
+}
+
+}  // namespace analysis_report
+
+template <class Field>
+AnalysisReport Factorization<Field>::Analyze(Int num_threads,
+                                             Int num_right_hand_sides) const {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Int num_rows = NumRows();
+
+  AnalysisReport report;
+  report.num_rows = num_rows;
+  report.num_supernodes = num_supernodes;
+  report.memory = EstimateMemory(num_threads, num_right_hand_sides);
+  num_right_hand_sides = report.memory.num_right_hand_sides;
+
+  // The flops of each front, which weight the critical path below.
+  Buffer<double> front_flops(num_supernodes);
+
+  // Each supernode is independent of the others.
+  const analysis_report::SupernodeTotals totals = tbb::parallel_reduce(
+      tbb::blocked_range<Int>(0, num_supernodes),
+      analysis_report::SupernodeTotals(),
+      [&](const tbb::blocked_range<Int>& range,
+          analysis_report::SupernodeTotals totals) {
+        for (Int supernode = range.begin(); supernode < range.end();
+             ++supernode) {
+          const double size = ordering_->supernode_sizes[supernode];
+          const double degree = lower_factor_->blocks[supernode].height;
+          const double diagonal_flops = size * size * size / 3;
+          const double trsm_flops = size * size * degree;
+          const double herk_flops = degree * degree * size;
+          front_flops[supernode] = diagonal_flops + trsm_flops + herk_flops;
+
+          totals.num_factor_nonzeros += size * (size + 1) / 2 + size * degree;
+          totals.diagonal_flops += diagonal_flops;
+          totals.trsm_flops += trsm_flops;
+          totals.herk_flops += herk_flops;
+
+          // Each of the two sweeps applies the triangular diagonal block and
+          // the subdiagonal block to every right-hand side and reads and
+          // writes the supernode's rows and structure updates.
+          totals.solve_flops +=
+              2 * num_right_hand_sides * (size * size + 2 * size * degree);
+          totals.solve_entries += 4 * num_right_hand_sides * (size + degree);
+
+          if (size > 0) {
+            ++totals.size_histogram[analysis_report::FloorLog2(Int(size))];
+          }
+        }
+        return totals;
+      },
+      [](analysis_report::SupernodeTotals totals,
+         const analysis_report::SupernodeTotals& other) {
+        totals += other;
+        return totals;
+      });
+  report.num_factor_nonzeros = totals.num_factor_nonzeros;
+  report.diagonal_flops = totals.diagonal_flops;
+  report.trsm_flops = totals.trsm_flops;
+  report.herk_flops = totals.herk_flops;
+  report.solve_flops = totals.solve_flops;
+  report.solve_bytes =
+      2. * report.memory.factor_bytes + sizeof(Field) * totals.solve_entries;
+  Int num_buckets = totals.size_histogram.size();
+  while (num_buckets > 0 && !totals.size_histogram[num_buckets - 1]) {
+    --num_buckets;
+  }
+  report.supernode_size_histogram.Resize(num_buckets);
+  std::copy(totals.size_histogram.begin(),
+            totals.size_histogram.begin() + num_buckets,
+            report.supernode_size_histogram.begin());
+
+  // As in any elimination forest, each parent follows all of its children,
+  // so the depths are formed from the roots down and the critical paths and
+  // the storage peaks from the leaves up.
+  Buffer<Int> depths(num_supernodes);
+  for (Int supernode = num_supernodes - 1; supernode >= 0; --supernode) {
+    const Int parent = forest.parents[supernode];
+    depths[supernode] = parent < 0 ? 1 : depths[parent] + 1;
+    report.tree_depth = std::max(report.tree_depth, depths[supernode]);
+  }
+  Buffer<Int> level_sizes(report.tree_depth + 1, 0);
+  for (const Int& depth : depths) {
+    report.tree_width = std::max(report.tree_width, ++level_sizes[depth]);
+  }
+
+  Buffer<double> path_flops(num_supernodes);
+  Buffer<std::size_t> peak_entries(num_supernodes);
+  std::vector<std::pair<std::size_t, std::size_t>> children;
+  std::size_t optimal_entries = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int child_beg = forest.child_offsets[supernode];
+    const Int child_end = forest.child_offsets[supernode + 1];
+    const std::size_t degree = lower_factor_->blocks[supernode].height;
+    if (child_beg == child_end) ++report.num_leaves;
+
+    // Each child holds its Schur complement once it completes, so visiting
+    // the children by decreasing excess of their peaks over it minimizes the
+    // peak of the parent.
+    double max_child_path_flops = 0;
+    children.clear();
+    for (Int index = child_beg; index < child_end; ++index) {
+      const Int child = forest.children[index];
+      max_child_path_flops = std::max(max_child_path_flops, path_flops[child]);
+      const std::size_t child_degree = lower_factor_->blocks[child].height;
+      children.emplace_back(peak_entries[child] - child_degree * child_degree,
+                            child_degree * child_degree);
+    }
+    std::sort(children.begin(), children.end(),
+              std::greater<std::pair<std::size_t, std::size_t>>());
+    std::size_t held_entries = 0;
+    std::size_t peak = 0;
+    for (const std::pair<std::size_t, std::size_t>& child : children) {
+      peak = std::max(peak, held_entries + child.first + child.second);
+      held_entries += child.second;
+    }
+    peak_entries[supernode] = std::max(peak, held_entries + degree * degree);
+    path_flops[supernode] = front_flops[supernode] + max_child_path_flops;
+
+    if (forest.parents[supernode] < 0) {
+      ++report.num_roots;
+      report.critical_path_flops =
+          std::max(report.critical_path_flops, path_flops[supernode]);
+      optimal_entries = std::max(optimal_entries, peak_entries[supernode]);
+    }
+  }
+  report.optimal_frontal_bytes = sizeof(Field) * optimal_entries;
+
+  return report;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ANALYSIS_IMPL_H_
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ARCHIVE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ARCHIVE_IMPL_H_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+void Factorization<Field>::Save(const std::string& filename,
+                                bool include_values) const {
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  if (!forest.child_relative_indices) {
+    throw std::runtime_error("Only analyzed factorizations can be saved.");
+  }
+  if (include_values) RequireUncompressedFactor("Saving the factor values");
+
+  FactorArchiveWriter writer(filename);
+  FactorArchiveHeader& header = writer.header;
+  header.field_size = sizeof(Field);
+  header.is_complex = IsComplex<Field>::value;
+  header.factorization_type = control_.factorization_type;
+  header.algorithm = control_.algorithm;
+  header.supernodal_pivoting = control_.supernodal_pivoting;
+  header.child_order = forest.child_order;
+  header.has_values = include_values;
+  header.num_rows = supernode_member_to_index_.Size();
+  header.num_supernodes = num_supernodes;
+  header.num_interior = num_interior_;
+  header.max_degree = max_degree_;
+  header.max_lower_block_size = max_lower_block_size_;
+  header.left_looking_workspace_size = left_looking_workspace_size_;
+  header.left_looking_scaled_transpose_size =
+      left_looking_scaled_transpose_size_;
+
+  writer.WriteSection(kArchivePermutation, ordering_->permutation);
+  writer.WriteSection(kArchiveInversePermutation,
+                      ordering_->inverse_permutation);
+  writer.WriteSection(kArchiveSupernodeSizes, ordering_->supernode_sizes);
+  writer.WriteSection(kArchiveSupernodeOffsets, ordering_->supernode_offsets);
+  writer.WriteSection(kArchiveParents, forest.parents);
+  writer.WriteSection(kArchiveChildren, forest.children);
+  writer.WriteSection(kArchiveChildOffsets, forest.child_offsets);
+  writer.WriteSection(kArchiveRoots, forest.roots);
+  writer.WriteSection(kArchiveRelativeIndexOffsets,
+                      forest.child_relative_indices->offsets);
+  writer.WriteSection(kArchiveRelativeIndices,
+                      forest.child_relative_indices->indices);
+  writer.WriteSection(kArchiveNumDiagIndices,
+                      forest.child_relative_indices->num_diag_indices);
+  writer.WriteSection(kArchiveSupernodeMemberToIndex,
+                      supernode_member_to_index_);
+
+  Buffer<Int> supernode_degrees(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    supernode_degrees[supernode] = lower_factor_->blocks[supernode].height;
+  }
+  writer.WriteSection(kArchiveSupernodeDegrees, supernode_degrees);
+  const Int num_structure_indices =
+      num_supernodes ? lower_factor_->StructureEnd(num_supernodes - 1) -
+                           lower_factor_->StructureBeg(0)
+                     : 0;
+  writer.WriteSection(kArchiveStructureIndices,
+                      num_supernodes ? lower_factor_->StructureBeg(0) : nullptr,
+                      num_structure_indices);
+
+  if (include_values) {
+    writer.WriteSection(kArchiveFactorValues, factor_values_.Data(),
+                        factor_values_.view.height);
+    if (control_.supernodal_pivoting) {
+      writer.WriteSection(kArchiveSupernodePermutations,
+                          supernode_permutations_.Data(),
+                          supernode_permutations_.view.height);
+    }
+  }
+
+  writer.Finish();
+}
+
+template <class Field>
+bool Factorization<Field>::Load(const std::string& filename,
+                                const Control<Field>& control) {
+  std::unique_ptr<MappedFactorArchive> archive =
+      std::make_unique<MappedFactorArchive>();
+  archive->Map(filename);
+  const FactorArchiveHeader& header = archive->Header();
+  if (header.field_size != sizeof(Field) ||
+      header.is_complex != std::uint32_t(IsComplex<Field>::value)) {
+    throw std::runtime_error(filename + " holds a different scalar type.");
+  }
+  if (header.factorization_type != control.factorization_type) {
+    throw std::runtime_error(filename + " holds a different factorization type.");
+  }
+
+  // The analysis resolves the algorithm and may disable supernodal pivoting,
+  // so those choices are taken from the archive.
+  control_ = control;
+  control_.algorithm = LDLAlgorithm(header.algorithm);
+  control_.supernodal_pivoting = header.supernodal_pivoting;
+  ClearSparsityPatternCaches();
+
+  SymmetricOrdering& ordering = MutableOrdering();
+  archive->CopySection(kArchivePermutation, &ordering.permutation);
+  archive->CopySection(kArchiveInversePermutation,
+                       &ordering.inverse_permutation);
+  archive->CopySection(kArchiveSupernodeSizes, &ordering.supernode_sizes);
+  archive->CopySection(kArchiveSupernodeOffsets, &ordering.supernode_offsets);
+  AssemblyForest& forest = ordering.assembly_forest;
+  archive->CopySection(kArchiveParents, &forest.parents);
+  archive->CopySection(kArchiveChildren, &forest.children);
+  archive->CopySection(kArchiveChildOffsets, &forest.child_offsets);
+  archive->CopySection(kArchiveRoots, &forest.roots);
+  forest.child_order = ChildOrder(header.child_order);
+  auto child_relative_indices = std::make_shared<ChildRelativeIndices>();
+  archive->CopySection(kArchiveRelativeIndexOffsets,
+                       &child_relative_indices->offsets);
+  archive->CopySection(kArchiveRelativeIndices,
+                       &child_relative_indices->indices);
+  archive->CopySection(kArchiveNumDiagIndices,
+                       &child_relative_indices->num_diag_indices);
+  if (child_relative_indices->offsets.Empty() ||
+      Int(child_relative_indices->indices.Size()) !=
+          child_relative_indices->offsets.Back() ||
+      child_relative_indices->num_diag_indices.Size() + 1 !=
+          child_relative_indices->offsets.Size()) {
+    throw std::runtime_error(filename + " is truncated or corrupt.");
+  }
+  child_relative_indices->runs.Encode(
+      child_relative_indices->offsets.Size() - 1,
+      child_relative_indices->offsets.Data(),
+      child_relative_indices->indices.Data(),
+      child_relative_indices->num_diag_indices.Data());
+  child_relative_indices->SelectMergeKernels();
+  forest.child_relative_indices = std::move(child_relative_indices);
+  structure_epoch_ = NewStructureEpoch();
+  archive->CopySection(kArchiveSupernodeMemberToIndex,
+                       &supernode_member_to_index_);
+
+  num_interior_ = header.num_interior;
+  relaxation_statistics_ = SupernodalRelaxationStatistics();
+  max_degree_ = header.max_degree;
+  max_lower_block_size_ = header.max_lower_block_size;
+  left_looking_workspace_size_ = header.left_looking_workspace_size;
+  left_looking_scaled_transpose_size_ =
+      header.left_looking_scaled_transpose_size;
+
+  const Int num_supernodes = header.num_supernodes;
+  Buffer<Int> supernode_degrees;
+  archive->CopySection(kArchiveSupernodeDegrees, &supernode_degrees);
+  Int num_factor_entries = 0;
+  Int num_structure_entries = 0;
+  if (ordering_->supernode_sizes.Size() == num_supernodes &&
+      supernode_degrees.Size() == num_supernodes) {
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      const Int degree = supernode_degrees[supernode];
+      num_factor_entries += supernode_size * (supernode_size + degree);
+      num_structure_entries += degree;
+    }
+  }
+  Int num_structure_indices;
+  const Int* structure_indices =
+      archive->Section<Int>(kArchiveStructureIndices, &num_structure_indices);
+  if (ordering_->supernode_sizes.Size() != num_supernodes ||
+      supernode_degrees.Size() != num_supernodes ||
+      num_structure_indices != num_structure_entries) {
+    throw std::runtime_error(filename + " is truncated or corrupt.");
+  }
+
+  // Point the factor directly into the mapping if it holds the values.
+  Field* values = nullptr;
+  if (header.has_values) {
+    Int num_values;
+    values = archive->Section<Field>(kArchiveFactorValues, &num_values);
+    if (num_values != num_factor_entries) {
+      throw std::runtime_error(filename + " is truncated or corrupt.");
+    }
+  }
+  m_allocateFactors(supernode_degrees, values);
+  factor_values_touched_ = header.has_values;
+
+  if (num_supernodes) {
+    std::copy(structure_indices, structure_indices + num_structure_indices,
+              lower_factor_->StructureBeg(0));
+  }
+  lower_factor_->FillStructureRuns();
+  if (control_.algorithm == kLeftLookingLDL) {
+    lower_factor_->FillIntersectionSizes(ordering_->supernode_sizes,
+                                         supernode_member_to_index_);
+  }
+  if (control_.supernodal_pivoting) {
+    supernode_permutations_.Resize(header.num_rows, 1);
+    if (header.has_values) {
+      Int num_permutation_entries;
+      const Int* permutations = archive->Section<Int>(
+          kArchiveSupernodePermutations, &num_permutation_entries);
+      std::copy(permutations, permutations + num_permutation_entries,
+                supernode_permutations_.Data());
+    }
+  }
+
+  solve_work_estimates_.Resize(num_supernodes);
+  for (const Int& root : forest.roots) {
+    FillSubtreeSolveWorkEstimates(root, forest, *lower_factor_,
+                                  &solve_work_estimates_);
+  }
+
+  const bool has_values = header.has_values;
+  if (has_values) {
+    archive_ = std::move(archive);
+    RepackSolvePanels();
+  } else {
+    archive_.reset();
+  }
+  return has_values;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_ARCHIVE_IMPL_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CHECKPOINT_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CHECKPOINT_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+void Factorization<Field>::CopyFactorValues(const Field* source,
+                                            Int num_entries, Field* target) {
+  // Chunks of 1 MiB are large enough to stream at full bandwidth.
+  const Int grain_size = std::max(Int(1), Int((1 << 20) / sizeof(Field)));
+  tbb::parallel_for(tbb::blocked_range<Int>(0, num_entries, grain_size),
+                    [&](const tbb::blocked_range<Int>& range) {
+                      std::copy(source + range.begin(), source + range.end(),
+                                target + range.begin());
+                    });
+}
+
+template <class Field>
+void Factorization<Field>::Checkpoint(
+    FactorCheckpoint<Field>* checkpoint) const {
+  TraceScope trace_scope("Checkpoint");
+  RequireUncompressedFactor("Checkpointing");
+  const Int num_entries = factor_values_.Height();
+  checkpoint->factor_values.SetControl(control_.allocation);
+  checkpoint->factor_values.Resize(num_entries);
+  CopyFactorValues(factor_values_.Data(), num_entries,
+                   checkpoint->factor_values.Data());
+  checkpoint->supernode_permutations = supernode_permutations_;
+  checkpoint->input_scaling = input_scaling_;
+}
+
+template <class Field>
+void Factorization<Field>::Restore(const FactorCheckpoint<Field>& checkpoint) {
+  TraceScope trace_scope("Restore");
+  RequireUncompressedFactor("Restoring a checkpoint");
+  const Int num_entries = factor_values_.Height();
+  if (Int(checkpoint.factor_values.Size()) != num_entries ||
+      checkpoint.supernode_permutations.Height() !=
+          supernode_permutations_.Height()) {
+    throw std::runtime_error(
+        "The checkpoint does not match the structure of the factor");
+  }
+  CopyFactorValues(checkpoint.factor_values.Data(), num_entries,
+                   factor_values_.Data());
+  factor_values_touched_ = true;
+  supernode_permutations_ = checkpoint.supernode_permutations;
+  input_scaling_ = checkpoint.input_scaling;
+
+  // The device copies of the subdiagonal blocks, the row panels of the
+  // solves, and the retained Schur complements were formed from the
+  // overwritten values.
+  device_offload_.ClearResidentBlocks();
+  retained_schur_complements_.Clear();
+  if (!solve_panels_.Empty()) RepackSolvePanels();
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CHECKPOINT_IMPL_H_
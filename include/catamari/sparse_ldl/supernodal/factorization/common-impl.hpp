@@ -9,10 +9,15 @@
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_COMMON_IMPL_H_
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
 
 #include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dense_factorizations.hpp"
-#include "../../../../../../../src/lib/MeshFEM/GlobalBenchmark.hh"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 
@@ -47,6 +52,32 @@ void Factorization<Field>::IncorporateSupernodeIntoLDLResult(
   result->num_schur_complement_flops += schur_complement_flops;
   result->num_factorization_flops +=
       diagonal_flops + solve_flops + schur_complement_flops;
+
+  ++result->num_factor_tasks;
+  if (degree) {
+    ++result->num_trsm_tasks;
+    ++result->num_herk_tasks;
+  }
+}
+
+template <class Field>
+void Factorization<Field>::IncorporateMergeIntoLDLResult(
+    Int child_degree, SparseLDLResult<Field>* result) {
+  // Only the lower triangle of the child Schur complement is merged.
+  ++result->num_merge_tasks;
+  result->num_merged_bytes +=
+      sizeof(Field) * std::size_t(child_degree) * (child_degree + 1) / 2;
+}
+
+template <class Field>
+void Factorization<Field>::IncorporateRelaxationIntoLDLResult(
+    SparseLDLResult<Field>* result) const {
+  result->num_fundamental_supernodes =
+      relaxation_statistics_.num_fundamental_supernodes;
+  result->num_relaxed_supernodes = relaxation_statistics_.num_supernodes;
+  result->num_relaxation_zeros = relaxation_statistics_.num_explicit_zeros;
+  result->relaxation_estimated_seconds =
+      relaxation_statistics_.estimated_seconds;
 }
 
 template <class Field>
@@ -54,6 +85,13 @@ void Factorization<Field>::MergeContribution(
     const SparseLDLResult<Field>& contribution,
     SparseLDLResult<Field>* result) {
   result->num_successful_pivots += contribution.num_successful_pivots;
+  result->num_positive_pivots += contribution.num_positive_pivots;
+  result->num_negative_pivots += contribution.num_negative_pivots;
+  result->num_zero_pivots += contribution.num_zero_pivots;
+  result->log_abs_determinant += contribution.log_abs_determinant;
+  result->determinant_phase *= contribution.determinant_phase;
+  result->largest_abs_pivot =
+      std::max(result->largest_abs_pivot, contribution.largest_abs_pivot);
   result->largest_supernode =
       std::max(result->largest_supernode, contribution.largest_supernode);
   result->num_factorization_entries += contribution.num_factorization_entries;
@@ -62,33 +100,110 @@ void Factorization<Field>::MergeContribution(
   result->num_subdiag_solve_flops += contribution.num_subdiag_solve_flops;
   result->num_schur_complement_flops += contribution.num_schur_complement_flops;
   result->num_factorization_flops += contribution.num_factorization_flops;
+
+  result->num_factor_tasks += contribution.num_factor_tasks;
+  result->num_trsm_tasks += contribution.num_trsm_tasks;
+  result->num_herk_tasks += contribution.num_herk_tasks;
+  result->num_merge_tasks += contribution.num_merge_tasks;
+  result->num_merged_bytes += contribution.num_merged_bytes;
+  result->num_delayed_pivots += contribution.num_delayed_pivots;
+  result->num_singular_pivots += contribution.num_singular_pivots;
+  result->max_stack_bytes =
+      std::max(result->max_stack_bytes, contribution.max_stack_bytes);
+}
+
+template <class Field>
+std::pair<Int, Int> Factorization<Field>::CountPivotSigns(
+    const ConstBlasMatrixView<Field>& diagonal_block,
+    SparseLDLResult<Field>* result) const {
+  typedef ComplexBase<Field> Real;
+  const Int supernode_size = diagonal_block.height;
+  Int num_positive = 0;
+  Int num_negative = 0;
+  Int num_zero = 0;
+  Real log_abs_determinant = 0;
+  Real largest_abs_pivot = 0;
+  Field phase = Field{1};
+  if (control_.factorization_type == kCholeskyFactorization) {
+    // The determinant of L L' is the square of the product of the (positive)
+    // diagonal of L.
+    num_positive = supernode_size;
+    for (Int j = 0; j < supernode_size; ++j) {
+      const Real diagonal_entry = RealPart(diagonal_block(j, j));
+      log_abs_determinant += 2 * std::log(diagonal_entry);
+      largest_abs_pivot =
+          std::max(largest_abs_pivot, diagonal_entry * diagonal_entry);
+    }
+  } else {
+    for (Int j = 0; j < supernode_size; ++j) {
+      const Field& entry = diagonal_block(j, j);
+      const Real pivot = RealPart(entry);
+      if (pivot > Real{0}) {
+        ++num_positive;
+      } else if (pivot < Real{0}) {
+        ++num_negative;
+      } else {
+        ++num_zero;
+      }
+      const Real abs_entry = std::abs(entry);
+      log_abs_determinant += std::log(abs_entry);
+      largest_abs_pivot = std::max(largest_abs_pivot, abs_entry);
+      phase *= entry / abs_entry;
+    }
+    // Renormalize so that rounding errors do not accumulate in the modulus.
+    phase /= std::abs(phase);
+  }
+  result->num_positive_pivots += num_positive;
+  result->num_negative_pivots += num_negative;
+  result->num_zero_pivots += num_zero;
+  result->log_abs_determinant += log_abs_determinant;
+  result->determinant_phase *= phase;
+  result->largest_abs_pivot =
+      std::max(result->largest_abs_pivot, largest_abs_pivot);
+  return std::make_pair(num_positive, num_negative);
+}
+
+template <class Field>
+bool Factorization<Field>::HaveExpectedInertia() const {
+  return control_.expected_num_positive_pivots >= 0 ||
+         control_.expected_num_negative_pivots >= 0;
+}
+
+template <class Field>
+bool Factorization<Field>::InertiaAttainable(Int num_positive_pivots,
+                                             Int num_negative_pivots) const {
+  if (control_.expected_num_positive_pivots >= 0 &&
+      num_positive_pivots > control_.expected_num_positive_pivots) {
+    return false;
+  }
+  if (control_.expected_num_negative_pivots >= 0 &&
+      num_negative_pivots > control_.expected_num_negative_pivots) {
+    return false;
+  }
+  return true;
 }
 
 template <class Field>
 void Factorization<Field>::FormSupernodes(const CoordinateMatrix<Field>& matrix,
                                           Buffer<Int>* supernode_degrees) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("FormSupernodes");
+  TraceScope trace_scope("FormSupernodes");
   CATAMARI_START_TIMER(profile.scalar_elimination_forest);
   Buffer<Int> scalar_parents;
   Buffer<Int> scalar_degrees;
-  const bool explicitly_permute = false;  // TODO(Jack Poulson): Make optional.
-  if (ordering_.permutation.Empty()) {
+  if (ordering_->permutation.Empty()) {
     scalar_ldl::EliminationForestAndDegrees(matrix, &scalar_parents,
                                             &scalar_degrees);
-  } else if (explicitly_permute) {
-    CoordinateMatrix<Field> reordered_matrix;
-    PermuteMatrix(matrix, ordering_, &reordered_matrix);
-    scalar_ldl::EliminationForestAndDegrees(reordered_matrix, &scalar_parents,
-                                            &scalar_degrees);
   } else {
-    scalar_ldl::EliminationForestAndDegrees(matrix, ordering_, &scalar_parents,
+    // The permuted matrix is traversed through the ordering rather than
+    // formed, which would double the memory of the input at its peak.
+    scalar_ldl::EliminationForestAndDegrees(matrix, *ordering_, &scalar_parents,
                                             &scalar_degrees);
   }
   CATAMARI_STOP_TIMER(profile.scalar_elimination_forest);
 
   SymmetricOrdering fund_ordering;
-  fund_ordering.permutation = ordering_.permutation;
-  fund_ordering.inverse_permutation = ordering_.inverse_permutation;
+  fund_ordering.permutation = ordering_->permutation;
+  fund_ordering.inverse_permutation = ordering_->inverse_permutation;
   FormFundamentalSupernodes(scalar_parents, scalar_degrees,
                             &fund_ordering.supernode_sizes);
   OffsetScan(fund_ordering.supernode_sizes, &fund_ordering.supernode_offsets);
@@ -96,12 +211,20 @@ void Factorization<Field>::FormSupernodes(const CoordinateMatrix<Field>& matrix,
                   "Supernodes did not sum to the matrix size.");
 #ifdef CATAMARI_DEBUG
   if (!supernodal_ldl::ValidFundamentalSupernodes(
-          matrix, ordering_, fund_ordering.supernode_sizes)) {
+          matrix, *ordering_, fund_ordering.supernode_sizes)) {
     std::cerr << "Invalid fundamental supernodes." << std::endl;
     return;
   }
 #endif  // ifdef CATAMARI_DEBUG
 
+  // A partial factorization keeps the interface rows in a single trailing
+  // supernode.
+  const bool partial = num_interior_ < matrix.NumRows();
+  if (partial) {
+    IsolateInterfaceSupernode(num_interior_, &fund_ordering.supernode_sizes);
+    OffsetScan(fund_ordering.supernode_sizes, &fund_ordering.supernode_offsets);
+  }
+
   Buffer<Int> fund_member_to_index;
   MemberToIndex(matrix.NumRows(), fund_ordering.supernode_offsets,
                 &fund_member_to_index);
@@ -124,38 +247,91 @@ void Factorization<Field>::FormSupernodes(const CoordinateMatrix<Field>& matrix,
   CATAMARI_START_TIMER(profile.relax_supernodes);
   const SupernodalRelaxationControl& relax_control =
       control_.relaxation_control;
+  SymmetricOrdering& ordering = MutableOrdering();
   if (relax_control.relax_supernodes) {
     RelaxSupernodes(fund_ordering, fund_supernode_degrees, relax_control,
-                    &ordering_, supernode_degrees, &supernode_member_to_index_);
+                    &ordering, supernode_degrees, &supernode_member_to_index_,
+                    partial ? num_fund_supernodes - 1 : -1);
   } else {
-    ordering_.supernode_sizes = fund_ordering.supernode_sizes;
-    ordering_.supernode_offsets = fund_ordering.supernode_offsets;
-    ordering_.assembly_forest.parents = fund_ordering.assembly_forest.parents;
-    ordering_.assembly_forest.FillFromParents();
+    ordering.supernode_sizes = fund_ordering.supernode_sizes;
+    ordering.supernode_offsets = fund_ordering.supernode_offsets;
+    ordering.assembly_forest.parents = fund_ordering.assembly_forest.parents;
+    ordering.assembly_forest.FillFromParents();
 
     supernode_member_to_index_ = fund_member_to_index;
     *supernode_degrees = fund_supernode_degrees;
   }
+  relaxation_statistics_ = RelaxationStatistics(
+      fund_ordering.supernode_sizes, fund_supernode_degrees,
+      ordering_->supernode_sizes, *supernode_degrees, relax_control.cost_model);
   CATAMARI_STOP_TIMER(profile.relax_supernodes);
+
+  // The relabeling preserves the trailing position of an interface
+  // supernode, since it is the last root.
+  if (control_.postorder_supernodes) {
+    PostorderSupernodes(&ordering, supernode_degrees,
+                        &supernode_member_to_index_);
+  }
 }
 
 template <class Field>
-void Factorization<Field>::m_allocateFactors(const Buffer<Int> &supernode_degrees) {
+void Factorization<Field>::AllocateFactorValues(Int num_entries) {
+  factor_storage_.SetControl(control_.allocation);
+  factor_storage_.Resize(num_entries);
+  factor_values_.data = Buffer<Field>();
+  factor_values_.view.height = factor_values_.view.leading_dim = num_entries;
+  factor_values_.view.width = 1;
+  factor_values_.view.data = factor_storage_.Data();
+}
+
+template <class Field>
+bool Factorization<Field>::OwnsFactorValues() const {
+  return factor_values_.view.data == factor_storage_.Data();
+}
+
+template <class Field>
+void Factorization<Field>::m_allocateFactors(const Buffer<Int> &supernode_degrees,
+                                             Field *values) {
     // Count sizes of the lower and diagonal parts of the factor.
     Int diagSize = 0, lowerSize = 0;
     const Int num_supernodes = supernode_degrees.Size();
     for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
         const Int degree = supernode_degrees[supernode];
-        const Int supernode_size = ordering_.supernode_sizes[supernode];
+        const Int supernode_size = ordering_->supernode_sizes[supernode];
          diagSize += supernode_size * supernode_size;
         lowerSize += supernode_size * degree;
     }
 
-    // Allocate a single buffer holding both parts of the factor.
-    factor_values_.Resize(diagSize + lowerSize, 1);
+    // Allocate a single buffer holding both parts of the factor. Its entries
+    // are not initialized, so its pages are only placed once first touched.
+    // An out-of-core factor is instead stored in a memory-mapped file, which
+    // 'factor_values_' merely views, as it does any externally provided
+    // storage.
+    const Int num_entries = diagSize + lowerSize;
+    out_of_core_storage_.reset();
+    if (!values) archive_.reset();
+    if (values) {
+        factor_storage_.Clear();
+        factor_values_.data = Buffer<Field>();
+        factor_values_.view.height = factor_values_.view.leading_dim = num_entries;
+        factor_values_.view.width = 1;
+        factor_values_.view.data = values;
+    } else if (control_.out_of_core_directory.empty()) {
+        AllocateFactorValues(num_entries);
+    } else {
+        out_of_core_storage_ = std::make_unique<OutOfCoreStorage<Field>>();
+        out_of_core_storage_->Allocate(control_.out_of_core_directory, num_entries);
+        factor_storage_.Clear();
+        factor_values_.data = Buffer<Field>();
+        factor_values_.view.height = factor_values_.view.leading_dim = num_entries;
+        factor_values_.view.width = 1;
+        factor_values_.view.data = out_of_core_storage_->Data();
+    }
+    factor_values_touched_ = false;
+    retained_schur_complements_.Clear();
     // std::cout << "Lower factor size: " << diagSize + lowerSize << std::endl;
-    diagonal_factor_ = std::make_unique<DiagonalFactor<Field>>(ordering_.supernode_sizes,                    factor_values_.Submatrix(       0, 0,  diagSize, 1));
-    lower_factor_    = std::make_unique<   LowerFactor<Field>>(ordering_.supernode_sizes, supernode_degrees, factor_values_.Submatrix(diagSize, 0, lowerSize, 1));
+    diagonal_factor_ = std::make_unique<DiagonalFactor<Field>>(ordering_->supernode_sizes,                    factor_values_.Submatrix(       0, 0,  diagSize, 1));
+    lower_factor_    = std::make_unique<   LowerFactor<Field>>(ordering_->supernode_sizes, supernode_degrees, factor_values_.Submatrix(diagSize, 0, lowerSize, 1));
 
     // Modify the diagonal/lower block pointers to that their data is
     // interleaved to form contiguous frontal matrix columns.
@@ -169,62 +345,360 @@ void Factorization<Field>::m_allocateFactors(const Buffer<Int> &supernode_degree
         db.leading_dim = lb.leading_dim = db.Height() + lb.Height();
         offset += db.Width() * (db.Height() + lb.Height());
     }
+
+    // Keep the panels of an out-of-core factor resident from the roots of the
+    // assembly forest downward, for as long as they fit within the budget.
+    out_of_core_resident_.Resize(num_supernodes);
+    std::fill(out_of_core_resident_.begin(), out_of_core_resident_.end(), !out_of_core_storage_);
+    if (out_of_core_storage_) {
+        const AssemblyForest& forest = ordering_->assembly_forest;
+        double num_resident_bytes = 0;
+        std::vector<Int> queue(forest.roots.begin(), forest.roots.end());
+        for (std::size_t index = 0; index < queue.size(); ++index) {
+            const Int supernode = queue[index];
+            const auto &db = diagonal_factor_->blocks[supernode];
+            const double panel_bytes = sizeof(Field) * double(db.Width()) * db.leading_dim;
+            if (num_resident_bytes + panel_bytes > control_.out_of_core_memory_budget) continue;
+            num_resident_bytes += panel_bytes;
+            out_of_core_resident_[supernode] = true;
+            for (Int child_index = forest.child_offsets[supernode];
+                 child_index < forest.child_offsets[supernode + 1]; ++child_index) {
+                queue.push_back(forest.children[child_index]);
+            }
+        }
+    }
+}
+
+template <class Field>
+void Factorization<Field>::EvictSupernodePanel(Int supernode) const {
+    if (!out_of_core_storage_ || out_of_core_resident_[supernode]) return;
+    const ConstBlasMatrixView<Field> db = diagonal_factor_->blocks[supernode];
+    out_of_core_storage_->Evict(db.data, db.data + db.width * db.leading_dim);
+}
+
+template <class Field>
+void Factorization<Field>::PrefetchSupernodePanels(Int supernode_beg, Int supernode_end) const {
+    if (!out_of_core_storage_) return;
+    supernode_beg = std::max(supernode_beg, Int(0));
+    supernode_end = std::min(supernode_end, Int(ordering_->supernode_sizes.Size()));
+    if (supernode_beg >= supernode_end) return;
+
+    // The panels are stored contiguously in the order of the supernodes.
+    const ConstBlasMatrixView<Field> first = diagonal_factor_->blocks[supernode_beg];
+    const ConstBlasMatrixView<Field> last = diagonal_factor_->blocks[supernode_end - 1];
+    out_of_core_storage_->Prefetch(first.data, last.data + last.width * last.leading_dim);
+}
+
+template <class Field>
+void Factorization<Field>::RepackSolvePanels(const Buffer<Int>* supernodes) {
+  if (control_.solve_layout != kRowPanelSolveLayout || out_of_core_storage_ ||
+      InterfaceSupernode() >= 0 || !block_low_rank_factor_.Empty()) {
+    solve_panel_values_.Clear();
+    solve_diagonal_blocks_.Clear();
+    solve_panels_.Clear();
+    return;
+  }
+  TraceScope trace_scope("RepackSolvePanels");
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const bool is_selfadjoint =
+      control_.factorization_type != kLDLTransposeFactorization;
+
+  // Lay out the panels, in postorder, if they do not match the factor.
+  bool relayout = solve_panels_.Size() != num_supernodes;
+  for (Int supernode = 0; !relayout && supernode < num_supernodes;
+       ++supernode) {
+    relayout = solve_panels_[supernode].height !=
+                   ordering_->supernode_sizes[supernode] ||
+               solve_panels_[supernode].width !=
+                   lower_factor_->blocks[supernode].height;
+  }
+  if (relayout) {
+    Int num_entries = 0;
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      const Int degree = lower_factor_->blocks[supernode].height;
+      num_entries +=
+          PaddedLeadingDimension<Field>(supernode_size, control_.allocation) *
+          (supernode_size + degree);
+    }
+    solve_panel_values_.SetControl(control_.allocation);
+    solve_panel_values_.Resize(num_entries);
+    solve_diagonal_blocks_.Resize(num_supernodes);
+    solve_panels_.Resize(num_supernodes);
+    Int offset = 0;
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      const Int degree = lower_factor_->blocks[supernode].height;
+      BlasMatrixView<Field>& diagonal_block = solve_diagonal_blocks_[supernode];
+      diagonal_block.height = supernode_size;
+      diagonal_block.width = supernode_size;
+      diagonal_block.leading_dim =
+          PaddedLeadingDimension<Field>(supernode_size, control_.allocation);
+      diagonal_block.data = solve_panel_values_.Data() + offset;
+
+      BlasMatrixView<Field>& panel = solve_panels_[supernode];
+      panel.height = supernode_size;
+      panel.width = degree;
+      panel.leading_dim = diagonal_block.leading_dim;
+      panel.data = diagonal_block.data +
+                   diagonal_block.leading_dim * supernode_size;
+      offset += diagonal_block.leading_dim * (supernode_size + degree);
+    }
+    supernodes = nullptr;
+  }
+
+  // The subdiagonal blocks are transposed in square tiles so that both the
+  // reads and the writes stay within a few cache lines.
+  const Int kTileSize = 32;
+  auto repack = [&](Int supernode) {
+    const ConstBlasMatrixView<Field> diagonal_block =
+        diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field>& solve_diagonal_block =
+        solve_diagonal_blocks_[supernode];
+    for (Int j = 0; j < diagonal_block.width; ++j) {
+      const Field* column = diagonal_block.Pointer(j, j);
+      std::copy(column, column + diagonal_block.height - j,
+                solve_diagonal_block.Pointer(j, j));
+    }
+
+    const ConstBlasMatrixView<Field> subdiagonal =
+        lower_factor_->blocks[supernode];
+    BlasMatrixView<Field>& panel = solve_panels_[supernode];
+    for (Int i_beg = 0; i_beg < subdiagonal.height; i_beg += kTileSize) {
+      const Int i_end = std::min(i_beg + kTileSize, subdiagonal.height);
+      for (Int k_beg = 0; k_beg < subdiagonal.width; k_beg += kTileSize) {
+        const Int k_end = std::min(k_beg + kTileSize, subdiagonal.width);
+        for (Int i = i_beg; i < i_end; ++i) {
+          Field* panel_column = panel.Pointer(0, i);
+          for (Int k = k_beg; k < k_end; ++k) {
+            panel_column[k] = is_selfadjoint ? Conjugate(subdiagonal(i, k))
+                                             : subdiagonal(i, k);
+          }
+        }
+      }
+    }
+  };
+
+  const Int num_repacked = supernodes ? supernodes->Size() : num_supernodes;
+  tbb::parallel_for(tbb::blocked_range<Int>(0, num_repacked),
+                    [&](const tbb::blocked_range<Int>& range) {
+                      for (Int index = range.begin(); index < range.end();
+                           ++index) {
+                        repack(supernodes ? (*supernodes)[index] : index);
+                      }
+                    });
+}
+
+template <class Field>
+void Factorization<Field>::FinishFactorization(SparseLDLResult<Field>* result) {
+  // A rank-detecting factorization records its singular pivots afterwards.
+  singular_pivots_.Clear();
+  null_space_basis_.Resize(0, 0);
+  CompressLowRankBlocks(result);
+  RepackSolvePanels();
+}
+
+template <class Field>
+void Factorization<Field>::LayOutFronts() {
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  Int offset = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+    const Int supernode_size = diagonal_block.height;
+    const Int degree = lower_block.height;
+    diagonal_block.data = factor_values_.Data() + offset;
+    if (block_low_rank_factor_.Compressed(supernode)) {
+      diagonal_block.leading_dim = supernode_size;
+      lower_block.data = nullptr;
+      lower_block.leading_dim = std::max<Int>(degree, 1);
+      offset += supernode_size * supernode_size;
+    } else {
+      lower_block.data = diagonal_block.data + supernode_size;
+      diagonal_block.leading_dim = lower_block.leading_dim =
+          supernode_size + degree;
+      offset += supernode_size * (supernode_size + degree);
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::CompressLowRankBlocks(
+    SparseLDLResult<Field>* result) {
+  block_low_rank_factor_.Clear();
+  dense_front_offsets_.Clear();
+  // The compressed factor must be able to compact its own storage.
+  if (!control_.block_low_rank.enabled || InterfaceSupernode() >= 0 ||
+      out_of_core_storage_ || !OwnsFactorValues()) {
+    return;
+  }
+  TraceScope trace_scope("CompressLowRankBlocks");
+  block_low_rank_factor_.Compress(control_.block_low_rank,
+                                  ordering_->supernode_sizes, *lower_factor_);
+  if (block_low_rank_factor_.Empty()) return;
+  result->num_compressed_supernodes =
+      block_low_rank_factor_.NumCompressedSupernodes();
+  result->num_compressed_block_entries =
+      block_low_rank_factor_.NumDenseEntries();
+  result->num_low_rank_entries = block_low_rank_factor_.NumEntries();
+  result->num_low_rank_bytes = block_low_rank_factor_.NumBytes();
+
+  // Copy the dense diagonal blocks of the compressed supernodes, and the
+  // fronts of the others, into compacted storage.
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  dense_front_offsets_.Resize(num_supernodes);
+  Buffer<Int> compacted_offsets(num_supernodes);
+  Int num_compacted_entries = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int degree = lower_factor_->blocks[supernode].height;
+    dense_front_offsets_[supernode] =
+        diagonal_factor_->blocks[supernode].data - factor_values_.Data();
+    compacted_offsets[supernode] = num_compacted_entries;
+    num_compacted_entries +=
+        supernode_size * (block_low_rank_factor_.Compressed(supernode)
+                              ? supernode_size
+                              : supernode_size + degree);
+  }
+  AlignedBuffer<Field> compacted_values(control_.allocation);
+  compacted_values.Resize(num_compacted_entries);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_supernodes),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int supernode = range.begin(); supernode < range.end();
+             ++supernode) {
+          const ConstBlasMatrixView<Field> diagonal_block =
+              diagonal_factor_->blocks[supernode];
+          Field* compacted = compacted_values.Data() +
+                             compacted_offsets[supernode];
+          if (block_low_rank_factor_.Compressed(supernode)) {
+            for (Int j = 0; j < diagonal_block.width; ++j) {
+              const Field* column = diagonal_block.Pointer(0, j);
+              std::copy(column, column + diagonal_block.height,
+                        compacted + j * diagonal_block.height);
+            }
+          } else {
+            std::copy(diagonal_block.data,
+                      diagonal_block.data +
+                          diagonal_block.width * diagonal_block.leading_dim,
+                      compacted);
+          }
+        }
+      });
+
+  // Adopting the compacted copy releases the dense storage.
+  factor_storage_ = std::move(compacted_values);
+  factor_values_.view.height = factor_values_.view.leading_dim =
+      num_compacted_entries;
+  factor_values_.view.data = factor_storage_.Data();
+  LayOutFronts();
+}
+
+template <class Field>
+void Factorization<Field>::ExpandCompressedFactor() {
+  if (block_low_rank_factor_.Empty()) return;
+  block_low_rank_factor_.Clear();
+  dense_front_offsets_.Clear();
+
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  Int num_entries = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int degree = lower_factor_->blocks[supernode].height;
+    num_entries += supernode_size * (supernode_size + degree);
+  }
+  // Release the compacted storage before allocating the dense one.
+  factor_storage_.Clear();
+  AllocateFactorValues(num_entries);
+  factor_values_touched_ = false;
+  LayOutFronts();
+}
+
+template <class Field>
+void Factorization<Field>::RequireUncompressedFactor(
+    const char* operation) const {
+  if (!block_low_rank_factor_.Empty()) {
+    throw std::runtime_error(std::string(operation) +
+                             " requires an uncompressed (non-BLR) factor");
+  }
 }
 
 template <class Field>
 void Factorization<Field>::InitializeFactors(
     const CoordinateMatrix<Field>& matrix,
     const Buffer<Int>& supernode_degrees) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("InitializeFactors");
+  TraceScope trace_scope("InitializeFactors");
 
-  CATAMARI_ASSERT(supernode_degrees.Size() == ordering_.supernode_sizes.Size(),
+  CATAMARI_ASSERT(supernode_degrees.Size() == ordering_->supernode_sizes.Size(),
                   "Invalid supernode degrees size.");
 
   m_allocateFactors(supernode_degrees);
+  FillStructureIndices(matrix, *ordering_, supernode_member_to_index_,
+                       lower_factor_.get());
+  FinishInitializingFactors(matrix.NumRows(), supernode_degrees);
+}
 
+template <class Field>
+void Factorization<Field>::FormLeftLookingWorkspaces(
+    const Buffer<Int>& supernode_degrees) {
+  lower_factor_->FillIntersectionSizes(ordering_->supernode_sizes,
+                                       supernode_member_to_index_);
+
+  // Compute the maximum of the diagonal and subdiagonal update sizes.
+  Int workspace_size = 0;
+  Int scaled_transpose_size = 0;
+  const Int num_supernodes = supernode_degrees.Size();
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    Int degree_remaining = supernode_degrees[supernode];
+    const Int* intersect_sizes_beg =
+        lower_factor_->IntersectionSizesBeg(supernode);
+    const Int* intersect_sizes_end =
+        lower_factor_->IntersectionSizesEnd(supernode);
+    for (const Int* iter = intersect_sizes_beg; iter != intersect_sizes_end;
+         ++iter) {
+      const Int intersect_size = *iter;
+      degree_remaining -= intersect_size;
+
+      // Handle the space for the diagonal block update.
+      workspace_size =
+          std::max(workspace_size, intersect_size * intersect_size);
+
+      // Handle the space for the lower update.
+      workspace_size =
+          std::max(workspace_size, intersect_size * degree_remaining);
+
+      if (control_.factorization_type != kCholeskyFactorization) {
+        // Increment the maximum scaled transpose size if necessary.
+        scaled_transpose_size =
+            std::max(scaled_transpose_size, supernode_size * intersect_size);
+      }
+    }
+  }
+  left_looking_workspace_size_ = workspace_size;
+  left_looking_scaled_transpose_size_ = scaled_transpose_size;
+}
+
+template <class Field>
+void Factorization<Field>::FinishInitializingFactors(
+    Int num_rows, const Buffer<Int>& supernode_degrees) {
   // Store the largest degree of the factorization for use in the solve phase.
   max_degree_ =
       *std::max_element(supernode_degrees.begin(), supernode_degrees.end());
 
-  FillStructureIndices(matrix, ordering_, supernode_member_to_index_,
-                       lower_factor_.get());
+  lower_factor_->FillStructureRuns();
+  if (control_.algorithm == kAdaptiveLDL) {
+    // Fall back to the left-looking factorization, which holds no Schur
+    // complements, if the right-looking one would exceed the memory budget.
+    const MemoryEstimate estimate =
+        EstimateMemory(get_max_num_tbb_threads(), 0);
+    control_.algorithm =
+        estimate.PeakBytes() > control_.factorization_memory_budget
+            ? kLeftLookingLDL
+            : kRightLookingLDL;
+  }
   if (control_.algorithm == kLeftLookingLDL) {
-    lower_factor_->FillIntersectionSizes(ordering_.supernode_sizes,
-                                         supernode_member_to_index_);
-
-    // Compute the maximum of the diagonal and subdiagonal update sizes.
-    Int workspace_size = 0;
-    Int scaled_transpose_size = 0;
-    const Int num_supernodes = supernode_degrees.Size();
-    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-      const Int supernode_size = ordering_.supernode_sizes[supernode];
-      Int degree_remaining = supernode_degrees[supernode];
-      const Int* intersect_sizes_beg =
-          lower_factor_->IntersectionSizesBeg(supernode);
-      const Int* intersect_sizes_end =
-          lower_factor_->IntersectionSizesEnd(supernode);
-      for (const Int* iter = intersect_sizes_beg; iter != intersect_sizes_end;
-           ++iter) {
-        const Int intersect_size = *iter;
-        degree_remaining -= intersect_size;
-
-        // Handle the space for the diagonal block update.
-        workspace_size =
-            std::max(workspace_size, intersect_size * intersect_size);
-
-        // Handle the space for the lower update.
-        workspace_size =
-            std::max(workspace_size, intersect_size * degree_remaining);
-
-        if (control_.factorization_type != kCholeskyFactorization) {
-          // Increment the maximum scaled transpose size if necessary.
-          scaled_transpose_size =
-              std::max(scaled_transpose_size, supernode_size * intersect_size);
-        }
-      }
-    }
-    left_looking_workspace_size_ = workspace_size;
-    left_looking_scaled_transpose_size_ = scaled_transpose_size;
+    FormLeftLookingWorkspaces(supernode_degrees);
   } else {
     // Compute the maximum number of entries below the diagonal block of a
     // supernode.
@@ -232,25 +706,26 @@ void Factorization<Field>::InitializeFactors(
     const Int num_supernodes = supernode_degrees.Size();
     for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
       const Int lower_block_size =
-          supernode_degrees[supernode] * ordering_.supernode_sizes[supernode];
+          supernode_degrees[supernode] * ordering_->supernode_sizes[supernode];
       max_lower_block_size_ = std::max(max_lower_block_size_, lower_block_size);
     }
   }
 
-  if (control_.factorization_type != kLDLAdjointFactorization) {
-    // We currently only support supernodal pivoting with LDL^H fact'ns.
+  if (control_.factorization_type != kLDLAdjointFactorization ||
+      UseDelayedPivoting()) {
+    // We currently only support supernodal pivoting with LDL^H fact'ns, and
+    // delayed pivoting folds its pivots into the ordering instead.
     control_.supernodal_pivoting = false;
   }
   if (control_.supernodal_pivoting) {
-    const Int num_rows = matrix.NumRows();
     supernode_permutations_.Resize(num_rows, 1);
   }
 }
 
 template <class Field>
 BlasMatrixView<Int> Factorization<Field>::SupernodePermutation(Int supernode) {
-  const Int supernode_offset = ordering_.supernode_offsets[supernode];
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
+  const Int supernode_offset = ordering_->supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
   return supernode_permutations_.Submatrix(supernode_offset, 0, supernode_size,
                                            1);
 }
@@ -258,8 +733,8 @@ BlasMatrixView<Int> Factorization<Field>::SupernodePermutation(Int supernode) {
 template <class Field>
 ConstBlasMatrixView<Int> Factorization<Field>::SupernodePermutation(
     Int supernode) const {
-  const Int supernode_offset = ordering_.supernode_offsets[supernode];
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
+  const Int supernode_offset = ordering_->supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
   return supernode_permutations_.Submatrix(supernode_offset, 0, supernode_size,
                                            1);
 }
@@ -267,7 +742,7 @@ ConstBlasMatrixView<Int> Factorization<Field>::SupernodePermutation(
 template <class Field>
 void Factorization<Field>::InitialFactorizationSetup(
     const CoordinateMatrix<Field>& matrix) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("FormSupernodes");
+  TraceScope trace_scope("FormSupernodes");
   Buffer<Int> supernode_degrees;
   FormSupernodes(matrix, &supernode_degrees);
   CATAMARI_START_TIMER(profile.initialize_factors);
@@ -275,6 +750,48 @@ void Factorization<Field>::InitialFactorizationSetup(
   CATAMARI_STOP_TIMER(profile.initialize_factors);
 }
 
+template <class Field>
+void Factorization<Field>::ScaleFactorColumn(
+    Int j, Int local_j, BlasMatrixView<Field>& diagonal_block) {
+  typedef ComplexBase<Field> Real;
+  const Int supernode = supernode_member_to_index_[j];
+  const Int supernode_start = j - local_j;
+  const bool have_permutation = !ordering_->permutation.Empty();
+  auto scaling = [&](Int row) {
+    return input_scaling_[have_permutation ? ordering_->inverse_permutation[row]
+                                           : row];
+  };
+  const Real column_scaling = scaling(j);
+
+  Field* diag_column_ptr = diagonal_block.Pointer(0, local_j);
+  for (Int i = local_j; i < diagonal_block.height; ++i) {
+    diag_column_ptr[i] /= column_scaling * scaling(supernode_start + i);
+  }
+
+  BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+  Field* lower_column_ptr = lower_block.Pointer(0, local_j);
+  const Int* index_beg = lower_factor_->StructureBeg(supernode);
+  for (Int i = 0; i < lower_block.height; ++i) {
+    lower_column_ptr[i] /= column_scaling * scaling(index_beg[i]);
+  }
+}
+
+template <class Field>
+ComplexBase<Field> Factorization<Field>::InputMaxNorm(
+    const CoordinateMatrix<Field>& matrix) const {
+  typedef ComplexBase<Field> Real;
+  if (input_scaling_.Empty()) {
+    return MaxNorm(matrix);
+  }
+  Real max_norm = 0;
+  for (const MatrixEntry<Field>& entry : matrix.Entries()) {
+    max_norm = std::max(max_norm, std::abs(entry.value) /
+                                      (input_scaling_[entry.row] *
+                                       input_scaling_[entry.column]));
+  }
+  return max_norm;
+}
+
 template <class Field>
 void Factorization<Field>::InitializeBlockColumn(
     Int supernode, const CoordinateMatrix<Field>& matrix) {
@@ -283,12 +800,14 @@ void Factorization<Field>::InitializeBlockColumn(
 
   const bool self_adjoint =
       control_.factorization_type != kLDLTransposeFactorization;
-  const bool have_permutation = !ordering_.permutation.Empty();
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
-  const Int supernode_end   = ordering_.supernode_offsets[supernode + 1];
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_end   = ordering_->supernode_offsets[supernode + 1];
   const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
   const Int* index_beg = lower_factor_->StructureBeg(supernode);
   const Int* index_end = lower_factor_->StructureEnd(supernode);
+  const ComplexBase<Field>* scaling =
+      input_scaling_.Empty() ? nullptr : input_scaling_.Data();
   assert(index_beg <= index_end);
 
 #if !LOAD_MATRIX_OUTSIDE
@@ -298,7 +817,7 @@ void Factorization<Field>::InitializeBlockColumn(
 
   for (Int j = supernode_start; j < supernode_end; ++j) {
     const Int j_rel = j - supernode_start;
-    const Int j_orig = have_permutation ? ordering_.inverse_permutation[j] : j;
+    const Int j_orig = have_permutation ? ordering_->inverse_permutation[j] : j;
 
     Field*  diag_column_ptr = diagonal_block.Pointer(0, j_rel);
     Field* lower_column_ptr =    lower_block.Pointer(0, j_rel);
@@ -309,11 +828,12 @@ void Factorization<Field>::InitializeBlockColumn(
     for (Int index = row_beg; index < row_end; ++index) {
       const MatrixEntry<Field>& entry = entries[index];
       const Int row =
-          have_permutation ? ordering_.permutation[entry.column] : entry.column;
+          have_permutation ? ordering_->permutation[entry.column] : entry.column;
       if (row < supernode_start) {
         continue;
       }
-      const Field value = self_adjoint ? Conjugate(entry.value) : entry.value;
+      Field value = self_adjoint ? Conjugate(entry.value) : entry.value;
+      if (scaling) value /= scaling[j_orig] * scaling[entry.column];
       if (row < supernode_end) {
         diag_column_ptr[row - supernode_start] = value;
       } else {
@@ -334,49 +854,167 @@ SparseLDLResult<Field> Factorization<Field>::Factor(
     const CoordinateMatrix<Field>& matrix,
     const SymmetricOrdering& manual_ordering, const Control<Field>& control,
     bool symbolic_only) {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("supernodal_ldl.Factorization.Factor");
-  control_ = control;
-  ordering_ = manual_ordering;
+  return FactorHelper(matrix, manual_ordering, matrix.NumRows(), control,
+                      symbolic_only);
+}
 
-  // Invalidate sparsity-pattern-dependent caches
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::FactorAndSolve(
+    const CoordinateMatrix<Field>& matrix,
+    const SymmetricOrdering& manual_ordering, const Control<Field>& control,
+    BlasMatrixView<Field>* right_hand_sides) {
+  return FactorHelper(matrix, manual_ordering, matrix.NumRows(), control,
+                      false, right_hand_sides);
+}
+
+template <class Field>
+SymmetricOrdering& Factorization<Field>::MutableOrdering() {
+  if (ordering_.use_count() > 1) {
+    ordering_ = std::make_shared<SymmetricOrdering>(*ordering_);
+  }
+  // The ordering is never shared while being modified, and it was created as
+  // a modifiable object.
+  return const_cast<SymmetricOrdering&>(*ordering_);
+}
+
+template <class Field>
+void Factorization<Field>::ClearSparsityPatternCaches() {
   work_estimates_.Clear();
+  subtree_domains_.Clear();
+  expand_in_place_storage_.Clear();
+  retained_schur_complements_.Clear();
   shared_state_.schur_complements.Clear();
-  solve_shared_state_.schur_complements.Clear();
+  shared_state_.schur_complement_storage.Clear();
+  private_states_.clear();
+  solve_workspace_.shared_state.schur_complements.Clear();
+  solve_workspace_.shared_state.schur_complement_buffers.Clear();
+  solve_panel_values_.Clear();
+  solve_diagonal_blocks_.Clear();
+  solve_panels_.Clear();
+  block_low_rank_factor_.Clear();
+  dense_front_offsets_.Clear();
+}
+
+template <class Field>
+void Factorization<Field>::FinishSymbolicAnalysis() {
+  // Estimate the work of the triangular solves against each subtree.
+  solve_work_estimates_.Resize(ordering_->supernode_sizes.Size());
+  for (const Int& root : ordering_->assembly_forest.roots) {
+    FillSubtreeSolveWorkEstimates(root, ordering_->assembly_forest,
+                                  *lower_factor_, &solve_work_estimates_);
+  }
+
+  // Map each supernode's structure into its parent's front once, for reuse by
+  // every subsequent (re)factorization and solve.
+  auto child_relative_indices = std::make_shared<ChildRelativeIndices>();
+  FillChildRelativeIndices(*ordering_, *lower_factor_,
+                           child_relative_indices.get());
+  MutableOrdering().assembly_forest.child_relative_indices =
+      std::move(child_relative_indices);
+
+  structure_epoch_ = NewStructureEpoch();
+}
+
+template <class Field>
+void Factorization<Field>::RequireCurrentConversionPlan(
+    const ConversionPlan& cplan) const {
+  if (!ConversionPlanIsCurrent(cplan)) {
+    throw std::runtime_error(
+        "The conversion plan was formed against a previous layout of the "
+        "factor and must be re-formed");
+  }
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::FactorHelper(
+    const CoordinateMatrix<Field>& matrix,
+    const SymmetricOrdering& manual_ordering, Int num_interior,
+    const Control<Field>& control, bool symbolic_only,
+    BlasMatrixView<Field>* right_hand_sides) {
+  TraceScope trace_scope("supernodal_ldl.Factorization.Factor");
+  control_ = control;
+  if (control_.use_tuning_profile) {
+    if (const TuningProfile* profile = MachineTuningProfile()) {
+      ApplyTuningProfile(*profile, &control_);
+    }
+  }
+  ordering_ = std::make_shared<SymmetricOrdering>(manual_ordering);
+  num_interior_ = num_interior;
+
+  ClearSparsityPatternCaches();
 
 #ifdef CATAMARI_ENABLE_TIMERS
   profile.Reset();
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-#ifdef CATAMARI_OPENMP
   // Parallelize only if the specified ordering has the necessary information.
-  if ((manual_ordering.supernode_sizes.Size() > 0) && omp_get_max_threads() > 1) {
-    if (control_.algorithm == kAdaptiveLDL) {
-      control_.algorithm = kRightLookingLDL;
+  const bool parallel_setup =
+      manual_ordering.supernode_sizes.Size() > 0 && get_max_num_tbb_threads() > 1;
+  if (control_.algorithm == kAdaptiveLDL) {
+#ifdef CATAMARI_OPENMP
+    const bool right_looking = parallel_setup && omp_get_max_threads() > 1;
+#else
+    const bool right_looking = false;
+#endif  // ifdef CATAMARI_OPENMP
+    // A memory budget defers the choice until the structure of the factor,
+    // and thus the memory required by the right-looking factorization, is
+    // known (see 'FinishInitializingFactors').
+    if (!right_looking || control_.factorization_memory_budget <= 0) {
+      control_.algorithm = right_looking ? kRightLookingLDL : kLeftLookingLDL;
     }
-    #pragma omp parallel
-    #pragma omp single
+  }
+
+  // The symbolic analysis is run on the same TBB scheduler as the numerical
+  // factorization so that the two never oversubscribe the cores.
+  if (parallel_setup) {
     OpenMPInitialFactorizationSetup(matrix);
   } else {
-    if (control_.algorithm == kAdaptiveLDL) {
-      control_.algorithm = kLeftLookingLDL;
-    }
     InitialFactorizationSetup(matrix);
   }
-#else
-  if (control_.algorithm == kAdaptiveLDL) {
-    control_.algorithm = kLeftLookingLDL;
-  }
-  InitialFactorizationSetup(matrix);
-#endif  // ifdef CATAMARI_OPENMP
+
+  FinishSymbolicAnalysis();
 
   SparseLDLResult<Field> result;
-  if (symbolic_only) return result;
+  IncorporateRelaxationIntoLDLResult(&result);
+  const Int prepared_num_rhs = control_.prepared_solve_num_rhs;
+  if (symbolic_only) {
+    if (prepared_num_rhs > 0) PrepareSolve(prepared_num_rhs);
+    return result;
+  }
+
+  // The right-looking factorization eliminates each supernode from the
+  // right-hand sides of a subsequent solve as soon as it is factored. The
+  // panels of an out-of-core factor are instead visited by the solves in
+  // their storage order.
+  const bool fused_solve = right_hand_sides &&
+                           control_.algorithm != kLeftLookingLDL &&
+                           !out_of_core_storage_ && !UseDelayedPivoting();
+  if (fused_solve) {
+    if (prepared_num_rhs > 0) PrepareSolve(prepared_num_rhs);
+    BeginFusedSolve(right_hand_sides);
+  }
 
+  // The solve workspace only depends upon the structure of the factor, so it
+  // is allocated while the numerical factorization runs (unless delayed
+  // pivoting will refold that structure, in which case it is allocated by
+  // the factorization).
+  tbb::task_group prepare_group;
+  if (prepared_num_rhs > 0 && !fused_solve && !UseDelayedPivoting()) {
+    prepare_group.run([&]() { PrepareSolve(prepared_num_rhs); });
+  }
   if (control_.algorithm == kLeftLookingLDL) {
     result = LeftLooking(matrix);
   } else {
     result = RightLooking(matrix);
   }
+  prepare_group.wait();
+
+  const bool factored = result.num_successful_pivots == NumRows();
+  if (fused_solve) {
+    EndFusedSolve(factored, right_hand_sides);
+  } else if (right_hand_sides && factored) {
+    Solve(right_hand_sides);
+  }
 
 #ifdef CATAMARI_ENABLE_TIMERS
   std::cout << profile << std::endl;
@@ -451,14 +1089,62 @@ Int Factorization<Field>::NumRows() const {
   return supernode_member_to_index_.Size();
 }
 
+template <class Field>
+double Factorization<Field>::WorkEstimates(double* critical_path_work) const {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  Buffer<double> work_estimates(num_supernodes, 0.);
+  for (const Int& root : forest.roots) {
+    FillSubtreeWorkEstimates(root, forest, *lower_factor_, &work_estimates);
+  }
+
+  // As in any elimination forest, each parent follows all of its children.
+  Buffer<double> path_work(num_supernodes, 0.);
+  double total_work = 0;
+  *critical_path_work = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    double own_work = work_estimates[supernode];
+    double max_child_path_work = 0;
+    for (Int index = forest.child_offsets[supernode];
+         index < forest.child_offsets[supernode + 1]; ++index) {
+      const Int child = forest.children[index];
+      own_work -= work_estimates[child];
+      max_child_path_work = std::max(max_child_path_work, path_work[child]);
+    }
+    path_work[supernode] = own_work + max_child_path_work;
+    if (forest.parents[supernode] < 0) {
+      total_work += work_estimates[supernode];
+      *critical_path_work =
+          std::max(*critical_path_work, path_work[supernode]);
+    }
+  }
+  return total_work;
+}
+
+template <class Field>
+void Factorization<Field>::SupernodeShapes(Buffer<Int>* sizes,
+                                           Buffer<Int>* degrees) const {
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  *sizes = ordering_->supernode_sizes;
+  degrees->Resize(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    (*degrees)[supernode] = lower_factor_->blocks[supernode].height;
+  }
+}
+
 template <class Field>
 const Buffer<Int>& Factorization<Field>::Permutation() const {
-  return ordering_.permutation;
+  return ordering_->permutation;
 }
 
 template <class Field>
 const Buffer<Int>& Factorization<Field>::InversePermutation() const {
-  return ordering_.inverse_permutation;
+  return ordering_->inverse_permutation;
+}
+
+template <class Field>
+const Buffer<Int>& Factorization<Field>::SupernodeOffsets() const {
+  return ordering_->supernode_offsets;
 }
 
 }  // namespace supernodal_ldl
@@ -7,7 +7,6 @@
  */
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_COMMON_OPENMP_IMPL_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_COMMON_OPENMP_IMPL_H_
-#ifdef CATAMARI_OPENMP
 
 #include <algorithm>
 
@@ -31,19 +30,14 @@ void Factorization<Field>::OpenMPInitialFactorizationSetup(
 #ifdef CATAMARI_ENABLE_TIMERS
   quotient::Timer timer;
   timer.Start();
-  #pragma omp taskgroup
   OpenMPFormSupernodes(matrix, &supernode_degrees);
   std::cout << "OpenMPFormSupernodes: " << timer.Stop() << std::endl;
 
   timer.Start();
-  #pragma omp taskgroup
   OpenMPInitializeFactors(matrix, supernode_degrees);
   std::cout << "OpenMPInitializeFactors: " << timer.Stop() << std::endl;
 #else
-  #pragma omp taskgroup
   OpenMPFormSupernodes(matrix, &supernode_degrees);
-
-  #pragma omp taskgroup
   OpenMPInitializeFactors(matrix, supernode_degrees);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 }
@@ -55,12 +49,12 @@ void Factorization<Field>::OpenMPFormSupernodes(
   Buffer<Int> scalar_parents;
   Buffer<Int> scalar_degrees;
   scalar_ldl::OpenMPEliminationForestAndDegrees(
-      matrix, ordering_, &scalar_parents, &scalar_degrees);
+      matrix, *ordering_, &scalar_parents, &scalar_degrees);
   CATAMARI_STOP_TIMER(profile.scalar_elimination_forest);
 
   SymmetricOrdering fund_ordering;
-  fund_ordering.permutation = ordering_.permutation;
-  fund_ordering.inverse_permutation = ordering_.inverse_permutation;
+  fund_ordering.permutation = ordering_->permutation;
+  fund_ordering.inverse_permutation = ordering_->inverse_permutation;
   FormFundamentalSupernodes(scalar_parents, scalar_degrees,
                             &fund_ordering.supernode_sizes);
   OffsetScan(fund_ordering.supernode_sizes, &fund_ordering.supernode_offsets);
@@ -68,12 +62,20 @@ void Factorization<Field>::OpenMPFormSupernodes(
                   "Supernodes did not sum to the matrix size.");
 #ifdef CATAMARI_DEBUG
   if (!supernodal_ldl::ValidFundamentalSupernodes(
-          matrix, ordering_, fund_ordering.supernode_sizes)) {
+          matrix, *ordering_, fund_ordering.supernode_sizes)) {
     std::cerr << "Invalid fundamental supernodes." << std::endl;
     return;
   }
 #endif  // ifdef CATAMARI_DEBUG
 
+  // A partial factorization keeps the interface rows in a single trailing
+  // supernode.
+  const bool partial = num_interior_ < matrix.NumRows();
+  if (partial) {
+    IsolateInterfaceSupernode(num_interior_, &fund_ordering.supernode_sizes);
+    OffsetScan(fund_ordering.supernode_sizes, &fund_ordering.supernode_offsets);
+  }
+
   Buffer<Int> fund_member_to_index;
   MemberToIndex(matrix.NumRows(), fund_ordering.supernode_offsets,
                 &fund_member_to_index);
@@ -99,97 +101,45 @@ void Factorization<Field>::OpenMPFormSupernodes(
   CATAMARI_START_TIMER(profile.relax_supernodes);
   const SupernodalRelaxationControl& relax_control =
       control_.relaxation_control;
+  SymmetricOrdering& ordering = MutableOrdering();
   if (relax_control.relax_supernodes) {
     RelaxSupernodes(fund_ordering, fund_supernode_degrees, relax_control,
-                    &ordering_, supernode_degrees, &supernode_member_to_index_);
+                    &ordering, supernode_degrees, &supernode_member_to_index_,
+                    partial ? num_fund_supernodes - 1 : -1);
   } else {
-    ordering_.supernode_sizes = fund_ordering.supernode_sizes;
-    ordering_.supernode_offsets = fund_ordering.supernode_offsets;
-    ordering_.assembly_forest.parents = fund_ordering.assembly_forest.parents;
-    ordering_.assembly_forest.FillFromParents();
+    ordering.supernode_sizes = fund_ordering.supernode_sizes;
+    ordering.supernode_offsets = fund_ordering.supernode_offsets;
+    ordering.assembly_forest.parents = fund_ordering.assembly_forest.parents;
+    ordering.assembly_forest.FillFromParents();
 
     supernode_member_to_index_ = fund_member_to_index;
     *supernode_degrees = fund_supernode_degrees;
   }
+  relaxation_statistics_ = RelaxationStatistics(
+      fund_ordering.supernode_sizes, fund_supernode_degrees,
+      ordering_->supernode_sizes, *supernode_degrees, relax_control.cost_model);
   CATAMARI_STOP_TIMER(profile.relax_supernodes);
+
+  if (control_.postorder_supernodes) {
+    PostorderSupernodes(&ordering, supernode_degrees,
+                        &supernode_member_to_index_);
+  }
 }
 
 template <class Field>
 void Factorization<Field>::OpenMPInitializeFactors(
     const CoordinateMatrix<Field>& matrix,
     const Buffer<Int>& supernode_degrees) {
-  CATAMARI_ASSERT(supernode_degrees.Size() == ordering_.supernode_sizes.Size(),
+  CATAMARI_ASSERT(supernode_degrees.Size() == ordering_->supernode_sizes.Size(),
                   "Invalid supernode degrees size.");
 
   m_allocateFactors(supernode_degrees);
-
-  // Store the largest degree of the factorization for use in the solve phase.
-  max_degree_ =
-      *std::max_element(supernode_degrees.begin(), supernode_degrees.end());
-
-  OpenMPFillStructureIndices(control_.sort_grain_size, matrix, ordering_,
+  OpenMPFillStructureIndices(control_.sort_grain_size, matrix, *ordering_,
                              supernode_member_to_index_, lower_factor_.get());
-  if (control_.algorithm == kLeftLookingLDL) {
-    // TODO(Jack Poulson): Switch to a multithreaded equivalent.
-    lower_factor_->FillIntersectionSizes(ordering_.supernode_sizes,
-                                         supernode_member_to_index_);
-
-    // Compute the maximum of the diagonal and subdiagonal update sizes.
-    // TODO(Jack Poulson): Avoid redundancy with common-impl.hpp implementation.
-    Int workspace_size = 0;
-    Int scaled_transpose_size = 0;
-    const Int num_supernodes = supernode_degrees.Size();
-    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-      const Int supernode_size = ordering_.supernode_sizes[supernode];
-      Int degree_remaining = supernode_degrees[supernode];
-      const Int* intersect_sizes_beg =
-          lower_factor_->IntersectionSizesBeg(supernode);
-      const Int* intersect_sizes_end =
-          lower_factor_->IntersectionSizesEnd(supernode);
-      for (const Int* iter = intersect_sizes_beg; iter != intersect_sizes_end;
-           ++iter) {
-        const Int intersect_size = *iter;
-        degree_remaining -= intersect_size;
-
-        // Handle the space for the diagonal block update.
-        workspace_size =
-            std::max(workspace_size, intersect_size * intersect_size);
-
-        // Handle the space for the lower update.
-        workspace_size =
-            std::max(workspace_size, intersect_size * degree_remaining);
-
-        if (control_.factorization_type != kCholeskyFactorization) {
-          // Increment the maximum scaled transpose size if necessary.
-          scaled_transpose_size =
-              std::max(scaled_transpose_size, supernode_size * intersect_size);
-        }
-      }
-    }
-    left_looking_workspace_size_ = workspace_size;
-    left_looking_scaled_transpose_size_ = scaled_transpose_size;
-  } else {
-    // Compute the maximum number of entries below the diagonal block of a
-    // supernode.
-    max_lower_block_size_ = 0;
-    const Int num_supernodes = supernode_degrees.Size();
-    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-      const Int lower_block_size =
-          supernode_degrees[supernode] * ordering_.supernode_sizes[supernode];
-      max_lower_block_size_ = std::max(max_lower_block_size_, lower_block_size);
-    }
-  }
-
-  if (control_.factorization_type != kLDLAdjointFactorization) {
-    // We currently only support supernodal pivoting with LDL^H fact'ns.
-    control_.supernodal_pivoting = false;
-  }
-  if (control_.supernodal_pivoting) {
-    const Int num_rows = matrix.NumRows();
-    supernode_permutations_.Resize(num_rows, 1);
-  }
+  FinishInitializingFactors(matrix.NumRows(), supernode_degrees);
 }
 
+#ifdef CATAMARI_OPENMP
 template <class Field>
 void Factorization<Field>::OpenMPInitializeBlockColumn(
     Int supernode, const CoordinateMatrix<Field>& matrix) {
@@ -198,17 +148,19 @@ void Factorization<Field>::OpenMPInitializeBlockColumn(
 
   const bool self_adjoint =
       control_.factorization_type != kLDLTransposeFactorization;
-  const bool have_permutation = !ordering_.permutation.Empty();
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
   const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
   const Int* index_beg = lower_factor_->StructureBeg(supernode);
   const Int* index_end = lower_factor_->StructureEnd(supernode);
+  const ComplexBase<Field>* scaling =
+      input_scaling_.Empty() ? nullptr : input_scaling_.Data();
 
   #pragma omp parallel for schedule(dynamic)
   for (Int j = supernode_start; j < supernode_start + supernode_size; ++j) {
     const Int j_rel = j - supernode_start;
-    const Int j_orig = have_permutation ? ordering_.inverse_permutation[j] : j;
+    const Int j_orig = have_permutation ? ordering_->inverse_permutation[j] : j;
 
     // Fill the diagonal block's column with zeros.
     Field* diag_column_ptr = diagonal_block.Pointer(0, j_rel);
@@ -225,11 +177,12 @@ void Factorization<Field>::OpenMPInitializeBlockColumn(
     for (Int index = row_beg; index < row_end; ++index) {
       const MatrixEntry<Field>& entry = entries[index];
       const Int row =
-          have_permutation ? ordering_.permutation[entry.column] : entry.column;
+          have_permutation ? ordering_->permutation[entry.column] : entry.column;
       if (row < supernode_start) {
         continue;
       }
-      const Field value = self_adjoint ? Conjugate(entry.value) : entry.value;
+      Field value = self_adjoint ? Conjugate(entry.value) : entry.value;
+      if (scaling) value /= scaling[j_orig] * scaling[entry.column];
       if (row < supernode_start + supernode_size) {
         diag_column_ptr[row - supernode_start] = value;
       } else {
@@ -245,9 +198,10 @@ void Factorization<Field>::OpenMPInitializeBlockColumn(
   }
 }
 
+#endif  // ifdef CATAMARI_OPENMP
+
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
-#endif  // ifdef CATAMARI_OPENMP
 #endif  // ifndef
         // CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_COMMON_OPENMP_IMPL_H_
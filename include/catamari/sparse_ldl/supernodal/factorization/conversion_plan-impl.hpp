@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+Int Factorization<Field>::FactorEntryOffset(Int row, Int column) const {
+  const Int supernode = supernode_member_to_index_[column];
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_end =
+      supernode_start + ordering_->supernode_sizes[supernode];
+  if (!block_low_rank_factor_.Empty()) {
+    // A compressed factor is expanded back into its original layout before
+    // it is refactored, so the offsets are those of the dense fronts.
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int leading_dim =
+        supernode_size + lower_factor_->blocks[supernode].height;
+    Int front_row = row - supernode_start;
+    if (row >= supernode_end) {
+      const Int* index_beg = lower_factor_->StructureBeg(supernode);
+      const Int* index_end = lower_factor_->StructureEnd(supernode);
+      const Int* iter = std::lower_bound(index_beg, index_end, row);
+      CATAMARI_ASSERT(iter != index_end && *iter == row,
+                      "Entry (" + std::to_string(row) + ", " +
+                          std::to_string(column) +
+                          ") wasn't in the structure.");
+      front_row = supernode_size + std::distance(index_beg, iter);
+    }
+    return dense_front_offsets_[supernode] + front_row +
+           (column - supernode_start) * leading_dim;
+  }
+  const Field* destination;
+  if (row < supernode_end) {
+    destination = diagonal_factor_->blocks[supernode].Pointer(
+        row - supernode_start, column - supernode_start);
+  } else {
+    const Int* index_beg = lower_factor_->StructureBeg(supernode);
+    const Int* index_end = lower_factor_->StructureEnd(supernode);
+    const Int* iter = std::lower_bound(index_beg, index_end, row);
+    CATAMARI_ASSERT(iter != index_end && *iter == row,
+                    "Entry (" + std::to_string(row) + ", " +
+                        std::to_string(column) + ") wasn't in the structure.");
+    destination = lower_factor_->blocks[supernode].Pointer(
+        std::distance(index_beg, iter), column - supernode_start);
+  }
+  return destination - factor_values_.Data();
+}
+
+template <class Field>
+void Factorization<Field>::FormConversionPlan(
+    const CoordinateMatrix<Field>& matrix, ConversionPlan* cplan) const {
+  const Int num_rows = matrix.NumRows();
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Int num_entries = entries.Size();
+
+  // Count the number of lower-triangular entries in each (permuted) column.
+  cplan->columnOffsets.setZero(num_rows + 1);
+  for (Int index = 0; index < num_entries; ++index) {
+    const MatrixEntry<Field>& entry = entries[index];
+    const Int row = have_permutation ? ordering_->permutation[entry.row]
+                                     : entry.row;
+    const Int column = have_permutation ? ordering_->permutation[entry.column]
+                                        : entry.column;
+    if (row >= column) {
+      ++cplan->columnOffsets[column + 1];
+    }
+  }
+  cplan->structureEpoch = structure_epoch_;
+  for (Int column = 0; column < num_rows; ++column) {
+    cplan->columnOffsets[column + 1] += cplan->columnOffsets[column];
+  }
+  cplan->resize(cplan->columnOffsets[num_rows]);
+
+  Buffer<Int> column_ptrs(num_rows);
+  for (Int column = 0; column < num_rows; ++column) {
+    column_ptrs[column] = cplan->columnOffsets[column];
+  }
+  for (Int index = 0; index < num_entries; ++index) {
+    const MatrixEntry<Field>& entry = entries[index];
+    const Int row = have_permutation ? ordering_->permutation[entry.row]
+                                     : entry.row;
+    const Int column = have_permutation ? ordering_->permutation[entry.column]
+                                        : entry.column;
+    if (row < column) {
+      continue;
+    }
+
+    ConversionPlan::Entry& plan_entry =
+        cplan->entries()[column_ptrs[column]++];
+    plan_entry.dst = FactorEntryOffset(row, column);
+    plan_entry.src = index;
+  }
+
+  // Sort each column by destination so that the values are streamed into
+  // the factor. The sort is stable so that, as before, the last of any
+  // duplicate entries is the one which is kept.
+  for (Int column = 0; column < num_rows; ++column) {
+    std::stable_sort(
+        cplan->entries() + cplan->columnOffsets[column],
+        cplan->entries() + cplan->columnOffsets[column + 1],
+        [](const ConversionPlan::Entry& a, const ConversionPlan::Entry& b) {
+          return a.dst < b.dst;
+        });
+  }
+  cplan->encodeRuns();
+}
+
+template <class Field>
+void Factorization<Field>::FormConversionPlan(Int num_rows,
+                                              const Int* offsets,
+                                              const Int* indices,
+                                              bool compressed_rows,
+                                              ConversionPlan* cplan) const {
+  TraceScope trace_scope("FormConversionPlan");
+  if (num_rows != NumRows()) {
+    throw std::runtime_error("Invalid number of pattern rows: " +
+                             std::to_string(num_rows));
+  }
+  const Int num_entries = offsets[num_rows];
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const bool have_permutation = !ordering_->permutation.Empty();
+  cplan->structureEpoch = structure_epoch_;
+
+  // The factor destination of each stored entry, and whether it was mirrored
+  // from the upper triangle of the permuted matrix.
+  struct PatternEntry {
+    Int dst, src;
+    bool mirrored;
+  };
+  Buffer<PatternEntry> pattern_entries(num_entries);
+  Buffer<Int> entry_columns(num_entries);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int outer = range.begin(); outer < range.end(); ++outer) {
+          for (Int index = offsets[outer]; index < offsets[outer + 1];
+               ++index) {
+            const Int inner = indices[index];
+            Int row = compressed_rows ? outer : inner;
+            Int column = compressed_rows ? inner : outer;
+            if (have_permutation) {
+              row = ordering_->permutation[row];
+              column = ordering_->permutation[column];
+            }
+            const bool mirrored = row < column;
+            if (mirrored) {
+              std::swap(row, column);
+            }
+            entry_columns[index] = column;
+            PatternEntry& entry = pattern_entries[index];
+            entry.dst = FactorEntryOffset(row, column);
+            entry.src = index;
+            entry.mirrored = mirrored;
+          }
+        }
+      });
+
+  // Bucket the entries by their (permuted) column.
+  Buffer<Int> column_offsets(num_rows + 1, 0);
+  for (Int index = 0; index < num_entries; ++index) {
+    ++column_offsets[entry_columns[index] + 1];
+  }
+  for (Int column = 0; column < num_rows; ++column) {
+    column_offsets[column + 1] += column_offsets[column];
+  }
+  Buffer<PatternEntry> column_entries(num_entries);
+  {
+    Buffer<Int> column_ptrs(num_rows);
+    for (Int column = 0; column < num_rows; ++column) {
+      column_ptrs[column] = column_offsets[column];
+    }
+    for (Int index = 0; index < num_entries; ++index) {
+      column_entries[column_ptrs[entry_columns[index]]++] =
+          pattern_entries[index];
+    }
+  }
+
+  // Sort each column by destination -- and, since the columns of a supernode
+  // are stored contiguously, each supernode -- so that the values are
+  // streamed into the factor. When both triangles are stored, the copy which
+  // was not mirrored is kept.
+  Buffer<Int> unique_counts(num_rows);
+  auto entry_less = [](const PatternEntry& a, const PatternEntry& b) {
+    return a.dst < b.dst || (a.dst == b.dst && !a.mirrored && b.mirrored);
+  };
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_supernodes),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int supernode = range.begin(); supernode < range.end();
+             ++supernode) {
+          const Int supernode_start = ordering_->supernode_offsets[supernode];
+          const Int supernode_end =
+              supernode_start + ordering_->supernode_sizes[supernode];
+          for (Int column = supernode_start; column < supernode_end;
+               ++column) {
+            PatternEntry* column_beg =
+                column_entries.Data() + column_offsets[column];
+            PatternEntry* column_end =
+                column_entries.Data() + column_offsets[column + 1];
+            std::sort(column_beg, column_end, entry_less);
+            Int num_unique = 0;
+            for (PatternEntry* entry = column_beg; entry != column_end;
+                 ++entry) {
+              if (entry == column_beg || entry->dst != entry[-1].dst) {
+                ++num_unique;
+              }
+            }
+            unique_counts[column] = num_unique;
+          }
+        }
+      });
+
+  cplan->columnOffsets.resize(num_rows + 1);
+  cplan->columnOffsets[0] = 0;
+  for (Int column = 0; column < num_rows; ++column) {
+    cplan->columnOffsets[column + 1] =
+        cplan->columnOffsets[column] + unique_counts[column];
+  }
+  cplan->resize(cplan->columnOffsets[num_rows]);
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_rows),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int column = range.begin(); column < range.end(); ++column) {
+          ConversionPlan::Entry* plan_entry =
+              cplan->entries() + cplan->columnOffsets[column];
+          const PatternEntry* column_beg =
+              column_entries.Data() + column_offsets[column];
+          const PatternEntry* column_end =
+              column_entries.Data() + column_offsets[column + 1];
+          for (const PatternEntry* entry = column_beg; entry != column_end;
+               ++entry) {
+            if (entry == column_beg || entry->dst != entry[-1].dst) {
+              plan_entry->dst = entry->dst;
+              plan_entry->src = entry->src;
+              ++plan_entry;
+            }
+          }
+        }
+      });
+  cplan->encodeRuns();
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+// CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_CONVERSION_PLAN_IMPL_H_
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_DELAYED_PIVOTING_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_DELAYED_PIVOTING_IMPL_H_
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+bool Factorization<Field>::UseDelayedPivoting() const {
+  return (control_.delayed_pivoting || control_.rank_detection) &&
+         control_.factorization_type != kCholeskyFactorization &&
+         num_interior_ == NumRows() && OwnsFactorValues();
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::DelayedPivotingFactorization(
+    const CoordinateMatrix<Field>& matrix) {
+  typedef ComplexBase<Field> Real;
+  TraceScope trace_scope("DelayedPivotingFactorization");
+  ExpandCompressedFactor();
+  device_offload_.ClearResidentBlocks();
+  retained_schur_complements_.Clear();
+  singular_pivots_.Clear();
+  null_space_basis_.Resize(0, 0);
+  const Int num_rows = NumRows();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const AssemblyForest& forest = ordering_->assembly_forest;
+
+  // The factored front of a supernode, which is kept until the factor is
+  // refolded (and its Schur complement until its parent is assembled).
+  struct DelayedPivotFront {
+    // The indices of the accepted pivots, in the order of their acceptance.
+    Buffer<Int> pivots;
+
+    // The indices of the rows below the accepted pivots: the columns which
+    // were delayed into the parent's front, followed by the structure of the
+    // supernode.
+    Buffer<Int> rows;
+    Int num_delayed = 0;
+
+    // The number of trailing pivots which were recorded as singular.
+    Int num_singular = 0;
+
+    // The factored columns of the accepted pivots, over 'pivots' followed by
+    // 'rows'.
+    BlasMatrix<Field> panel;
+
+    // The lower triangle of the Schur complement over 'rows'.
+    BlasMatrix<Field> schur_complement;
+  };
+  Buffer<DelayedPivotFront> fronts(num_supernodes);
+
+  SparseLDLResult<Field> result;
+  IncorporateRelaxationIntoLDLResult(&result);
+
+  // Load the matrix entries of every supernode through its factor blocks,
+  // which are not overwritten until the factor is refolded, so that the
+  // tolerance of the rank detection is relative to the largest of them.
+  Real max_abs_entry = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field> lower_block = lower_factor_->blocks[supernode];
+    const Int supernode_offset = ordering_->supernode_offsets[supernode];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int degree = lower_block.height;
+    if (m_inputData.cplan) {
+      for (Int j = 0; j < supernode_size; ++j) {
+        InitializeFactorColumn(supernode_offset + j, j, diagonal_block);
+      }
+    } else {
+      for (Int j = 0; j < supernode_size; ++j) {
+        std::fill(diagonal_block.Pointer(0, j),
+                  diagonal_block.Pointer(supernode_size, j), Field{0});
+        std::fill(lower_block.Pointer(0, j), lower_block.Pointer(degree, j),
+                  Field{0});
+      }
+      InitializeBlockColumn(supernode, matrix);
+    }
+    if (!control_.rank_detection) continue;
+    for (Int j = 0; j < supernode_size; ++j) {
+      for (Int i = j; i < supernode_size; ++i) {
+        max_abs_entry = std::max(max_abs_entry, std::abs(diagonal_block(i, j)));
+      }
+      for (Int i = 0; i < degree; ++i) {
+        max_abs_entry = std::max(max_abs_entry, std::abs(lower_block(i, j)));
+      }
+    }
+  }
+  const Real threshold = control_.delayed_pivot_threshold;
+  const Real pivot_tolerance =
+      control_.rank_detection
+          ? Real(control_.rank_detection_tolerance) * max_abs_entry
+          : Real(0);
+
+  Buffer<Int> positions(num_rows, -1);
+  std::vector<Int> indices;
+  Buffer<Int> permutation;
+  Buffer<Field> buffer;
+  BlasMatrix<Field> front;
+
+  // Since each supernode's indices precede those of its parent, the
+  // children are always factored before their parent.
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    DelayedPivotFront& factored = fronts[supernode];
+    BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field> lower_block = lower_factor_->blocks[supernode];
+    const Int supernode_offset = ordering_->supernode_offsets[supernode];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int degree = lower_block.height;
+    const Int* structure = lower_factor_->StructureBeg(supernode);
+    const Int child_beg = forest.child_offsets[supernode];
+    const Int child_end = forest.child_offsets[supernode + 1];
+
+    // The fully-summed columns of the front are those delayed by the
+    // children followed by those of the supernode.
+    indices.clear();
+    for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+      const DelayedPivotFront& child_front =
+          fronts[forest.children[child_index]];
+      indices.insert(indices.end(), child_front.rows.begin(),
+                     child_front.rows.begin() + child_front.num_delayed);
+    }
+    const Int num_delayed_children = indices.size();
+    for (Int j = 0; j < supernode_size; ++j) {
+      indices.push_back(supernode_offset + j);
+    }
+    const Int num_fully_summed = indices.size();
+    indices.insert(indices.end(), structure, structure + degree);
+    const Int height = indices.size();
+    for (Int i = 0; i < height; ++i) {
+      positions[indices[i]] = i;
+    }
+
+    front.Resize(height, height, Field{0});
+    for (Int j = 0; j < supernode_size; ++j) {
+      const Int column = num_delayed_children + j;
+      for (Int i = j; i < supernode_size; ++i) {
+        front(num_delayed_children + i, column) = diagonal_block(i, j);
+      }
+      for (Int i = 0; i < degree; ++i) {
+        front(num_fully_summed + i, column) = lower_block(i, j);
+      }
+    }
+
+    // Each child's delayed columns lead (in order) the front, and its
+    // structure is sorted, so its lower triangle maps into that of the front.
+    for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+      DelayedPivotFront& child_front = fronts[forest.children[child_index]];
+      const Int child_height = child_front.rows.Size();
+      for (Int j = 0; j < child_height; ++j) {
+        const Int column = positions[child_front.rows[j]];
+        for (Int i = j; i < child_height; ++i) {
+          front(positions[child_front.rows[i]], column) +=
+              child_front.schur_complement(i, j);
+        }
+      }
+      child_front.schur_complement = BlasMatrix<Field>();
+      IncorporateMergeIntoLDLResult(child_height, &result);
+    }
+    for (Int i = 0; i < height; ++i) {
+      positions[indices[i]] = -1;
+    }
+
+    const Int num_pivots = ThresholdPivotedPartialFactorization(
+        control_.outer_product_tile_size, control_.factorization_type,
+        threshold, pivot_tolerance, num_fully_summed, &front.view, &permutation,
+        &buffer);
+    Int num_delayed = num_fully_summed - num_pivots;
+    result.num_successful_pivots += num_pivots;
+    CountPivotSigns(front.ConstView().Submatrix(0, 0, num_pivots, num_pivots),
+                    &result);
+    if (HaveExpectedInertia() &&
+        !InertiaAttainable(result.num_positive_pivots,
+                           result.num_negative_pivots)) {
+      return result;
+    }
+
+    Int num_singular = 0;
+    if (num_delayed && forest.parents[supernode] < 0) {
+      // A root has no parent to delay its remaining pivots into, so they can
+      // only be recorded as singular, which requires the remainder of its
+      // front (all of whose rows are fully summed) to be negligible.
+      if (!control_.rank_detection) return result;
+      for (Int j = num_pivots; j < height; ++j) {
+        for (Int i = j; i < height; ++i) {
+          if (std::abs(front(i, j)) > pivot_tolerance) return result;
+          front(i, j) = Field{0};
+        }
+      }
+      num_singular = num_delayed;
+      num_delayed = 0;
+      result.num_successful_pivots += num_singular;
+      result.num_singular_pivots += num_singular;
+    }
+    result.num_delayed_pivots += num_delayed;
+    const Int num_factored = num_pivots + num_singular;
+    IncorporateSupernodeIntoLDLResult(num_factored, height - num_factored,
+                                      &result);
+
+    factored.pivots.Resize(num_factored);
+    for (Int k = 0; k < num_factored; ++k) {
+      factored.pivots[k] = indices[permutation[k]];
+    }
+    factored.num_delayed = num_delayed;
+    factored.num_singular = num_singular;
+    factored.rows.Resize(height - num_factored);
+    for (Int k = 0; k < num_delayed; ++k) {
+      factored.rows[k] = indices[permutation[num_pivots + k]];
+    }
+    std::copy(structure, structure + degree,
+              factored.rows.begin() + num_delayed);
+    factored.panel = front.ConstView().Submatrix(0, 0, height, num_factored);
+    factored.schur_complement =
+        front.ConstView().Submatrix(num_factored, num_factored,
+                                    height - num_factored,
+                                    height - num_factored);
+  }
+
+  // Refold the ordering, if needed, so that each supernode consists of its
+  // accepted pivots in the order of their acceptance.
+  Buffer<Int> new_indices(num_rows);
+  Buffer<Int> supernode_sizes(num_supernodes);
+  Buffer<Int> supernode_degrees(num_supernodes);
+  std::vector<Int> singular_pivots;
+  Int num_refolded = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const DelayedPivotFront& factored = fronts[supernode];
+    const Int supernode_size = factored.pivots.Size();
+    supernode_sizes[supernode] = supernode_size;
+    supernode_degrees[supernode] = factored.rows.Size();
+    for (const Int& pivot : factored.pivots) {
+      new_indices[pivot] = num_refolded++;
+    }
+    for (Int k = supernode_size - factored.num_singular; k < supernode_size;
+         ++k) {
+      singular_pivots.push_back(new_indices[factored.pivots[k]]);
+    }
+  }
+  Int first_refolded = 0;
+  while (first_refolded < num_rows &&
+         new_indices[first_refolded] == first_refolded) {
+    ++first_refolded;
+  }
+  const bool refold = first_refolded < num_rows;
+  if (refold) {
+    SymmetricOrdering& ordering = MutableOrdering();
+    if (ordering.permutation.Empty()) {
+      ordering.permutation = new_indices;
+    } else {
+      for (Int& index : ordering.permutation) {
+        index = new_indices[index];
+      }
+    }
+    ordering.inverse_permutation.Resize(num_rows);
+    for (Int row = 0; row < num_rows; ++row) {
+      ordering.inverse_permutation[ordering.permutation[row]] = row;
+    }
+    ordering.supernode_sizes = supernode_sizes;
+    OffsetScan(ordering.supernode_sizes, &ordering.supernode_offsets);
+    MemberToIndex(num_rows, ordering.supernode_offsets,
+                  &supernode_member_to_index_);
+    ClearSparsityPatternCaches();
+    m_allocateFactors(supernode_degrees);
+  }
+
+  // Copy the panels into the factor storage, with the rows below each
+  // supernode's pivots sorted into its (refolded) structure. Unless a pivot
+  // was delayed or accepted out of order, the structure is unchanged.
+  std::vector<Int> row_order;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    DelayedPivotFront& factored = fronts[supernode];
+    BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
+    BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+    const Int supernode_size = supernode_sizes[supernode];
+    const Int degree = supernode_degrees[supernode];
+
+    row_order.resize(degree);
+    std::iota(row_order.begin(), row_order.end(), Int(0));
+    if (refold) {
+      std::sort(row_order.begin(), row_order.end(), [&](Int i, Int j) {
+        return new_indices[factored.rows[i]] < new_indices[factored.rows[j]];
+      });
+      Int* structure = lower_factor_->StructureBeg(supernode);
+      for (Int i = 0; i < degree; ++i) {
+        structure[i] = new_indices[factored.rows[row_order[i]]];
+      }
+    }
+
+    for (Int j = 0; j < supernode_size; ++j) {
+      for (Int i = j; i < supernode_size; ++i) {
+        diagonal_block(i, j) = factored.panel(i, j);
+      }
+      for (Int i = 0; i < degree; ++i) {
+        lower_block(i, j) = factored.panel(supernode_size + row_order[i], j);
+      }
+    }
+    factored = DelayedPivotFront();
+  }
+  if (refold) {
+    FinishInitializingFactors(num_rows, supernode_degrees);
+    FinishSymbolicAnalysis();
+  }
+  FinishFactorization(&result);
+  if (refold && control_.prepared_solve_num_rhs > 0) {
+    PrepareSolve(control_.prepared_solve_num_rhs);
+  }
+  if (!singular_pivots.empty()) {
+    singular_pivots_.Resize(singular_pivots.size());
+    std::copy(singular_pivots.begin(), singular_pivots.end(),
+              singular_pivots_.begin());
+    FormNullSpaceBasis();
+  }
+
+  return result;
+}
+
+template <class Field>
+void Factorization<Field>::FormNullSpaceBasis() {
+  const Int num_singular = singular_pivots_.Size();
+  null_space_basis_.Resize(NumRows(), num_singular, Field{0});
+  for (Int j = 0; j < num_singular; ++j) {
+    null_space_basis_(singular_pivots_[j], j) = Field{1};
+  }
+
+  // Since the singular pivots of A = L D L' are zero, A inv(L') e_k = 0.
+  LowerTransposeTriangularSolve(&null_space_basis_.view);
+  if (!ordering_->permutation.Empty()) {
+    Permute(ordering_->inverse_permutation, &null_space_basis_.view);
+  }
+  if (!input_scaling_.Empty()) {
+    ApplyInverseInputScaling(false, &null_space_basis_.view);
+  }
+  OrthonormalizeColumns(&null_space_basis_.view);
+}
+
+template <class Field>
+void Factorization<Field>::PseudoinverseSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const ConstBlasMatrixView<Field> basis = null_space_basis_.ConstView();
+  if (!basis.width) {
+    Solve(right_hand_sides);
+    return;
+  }
+
+  // The range of a complex-symmetric matrix is the orthogonal complement of
+  // the conjugate of its null space (and that of a Hermitian matrix the
+  // complement of its null space).
+  ProjectOutBasis(basis,
+                  control_.factorization_type == kLDLTransposeFactorization,
+                  right_hand_sides);
+  Solve(right_hand_sides);
+  ProjectOutBasis(basis, false, right_hand_sides);
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+        // CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_DELAYED_PIVOTING_IMPL_H_
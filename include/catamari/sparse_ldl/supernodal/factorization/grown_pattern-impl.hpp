@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_GROWN_PATTERN_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_GROWN_PATTERN_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+bool Factorization<Field>::MarkGrownSupernodes(
+    const CoordinateMatrix<Field>& matrix, Buffer<char>* affected) const {
+  const Int num_rows = NumRows();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+
+  bool any_affected = false;
+  affected->Resize(num_supernodes, 0);
+  for (Int column = 0; column < num_rows; ++column) {
+    const Int supernode = supernode_member_to_index_[column];
+    const Int supernode_end = ordering_->supernode_offsets[supernode + 1];
+    const Int* index_beg = lower_factor_->StructureBeg(supernode);
+    const Int* index_end = lower_factor_->StructureEnd(supernode);
+    const Int orig_column =
+        have_permutation ? ordering_->inverse_permutation[column] : column;
+
+    const Int row_beg = matrix.RowEntryOffset(orig_column);
+    const Int row_end = matrix.RowEntryOffset(orig_column + 1);
+    for (Int index = row_beg; index < row_end; ++index) {
+      const Int orig_row = entries[index].column;
+      const Int row = have_permutation && orig_row < num_rows
+                          ? ordering_->permutation[orig_row]
+                          : orig_row;
+      if (row < supernode_end) {
+        continue;
+      }
+      if (row >= num_rows) {
+        // The column is coupled to a new row, which is ordered last.
+        (*affected)[supernode] = 1;
+        any_affected = true;
+      } else if (!std::binary_search(index_beg, index_end, row)) {
+        (*affected)[supernode] = 1;
+        (*affected)[supernode_member_to_index_[row]] = 1;
+        any_affected = true;
+      }
+    }
+  }
+
+  // The structure of every ancestor of a modified supernode can grow. Parents
+  // always have larger indices than their children.
+  const Buffer<Int>& parents = ordering_->assembly_forest.parents;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int parent = parents[supernode];
+    if ((*affected)[supernode] && parent >= 0) {
+      (*affected)[parent] = 1;
+    }
+  }
+
+  return any_affected;
+}
+
+template <class Field>
+void Factorization<Field>::GrowSymbolicAnalysis(
+    const CoordinateMatrix<Field>& matrix, const Buffer<char>& affected) {
+  const Int old_num_rows = NumRows();
+  const Int num_rows = matrix.NumRows();
+  const Int old_num_supernodes = ordering_->supernode_sizes.Size();
+  const Buffer<Int> old_member_to_index = supernode_member_to_index_;
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+
+  // The existing rows keep their positions and the new rows are eliminated
+  // last, in their original order.
+  const bool have_permutation = !ordering_->permutation.Empty();
+  if (have_permutation) {
+    Buffer<Int> permutation(num_rows);
+    Buffer<Int> inverse_permutation(num_rows);
+    for (Int row = 0; row < num_rows; ++row) {
+      const bool old_row = row < old_num_rows;
+      permutation[row] = old_row ? ordering_->permutation[row] : row;
+      inverse_permutation[row] =
+          old_row ? ordering_->inverse_permutation[row] : row;
+    }
+    SymmetricOrdering& ordering = MutableOrdering();
+    ordering.permutation = std::move(permutation);
+    ordering.inverse_permutation = std::move(inverse_permutation);
+  }
+
+  // Each new row is initially its own supernode, appended after the existing
+  // supernodes, which all keep their indices and sizes.
+  const Int num_singletons = old_num_supernodes + num_rows - old_num_rows;
+  Buffer<Int> singleton_offsets(num_singletons + 1);
+  Buffer<Int> member_to_singleton(num_rows);
+  for (Int supernode = 0; supernode <= old_num_supernodes; ++supernode) {
+    singleton_offsets[supernode] = ordering_->supernode_offsets[supernode];
+  }
+  for (Int row = 0; row < num_rows; ++row) {
+    member_to_singleton[row] =
+        row < old_num_rows ? old_member_to_index[row]
+                           : old_num_supernodes + row - old_num_rows;
+    if (row >= old_num_rows) {
+      singleton_offsets[member_to_singleton[row] + 1] = row + 1;
+    }
+  }
+
+  // The unaffected supernodes form descendant-closed subtrees whose
+  // structures are unchanged. The structure of the root of each such subtree
+  // is passed to its (affected) parent as an element, which stands in for all
+  // of the entries of the subtree.
+  const Buffer<Int>& old_parents = ordering_->assembly_forest.parents;
+  Buffer<Int> element_sizes(num_rows, 0);
+  for (Int supernode = 0; supernode < old_num_supernodes; ++supernode) {
+    const Int parent = old_parents[supernode];
+    if (affected[supernode] || parent < 0 || !affected[parent]) {
+      continue;
+    }
+    for (const Int* iter = lower_factor_->StructureBeg(supernode);
+         iter != lower_factor_->StructureEnd(supernode); ++iter) {
+      if (old_member_to_index[*iter] != parent) {
+        ++element_sizes[*iter];
+      }
+    }
+  }
+  Buffer<Int> element_offsets;
+  OffsetScan(element_sizes, &element_offsets);
+  Buffer<Int> element_parents(element_offsets.Back());
+  {
+    Buffer<Int> element_positions = element_offsets;
+    for (Int supernode = 0; supernode < old_num_supernodes; ++supernode) {
+      const Int parent = old_parents[supernode];
+      if (affected[supernode] || parent < 0 || !affected[parent]) {
+        continue;
+      }
+      for (const Int* iter = lower_factor_->StructureBeg(supernode);
+           iter != lower_factor_->StructureEnd(supernode); ++iter) {
+        if (old_member_to_index[*iter] != parent) {
+          element_parents[element_positions[*iter]++] = parent;
+        }
+      }
+    }
+  }
+
+  // Visits the supernodes from which the structure of 'row', a member of the
+  // supernode beginning at 'supernode_offset', is reached: those of the
+  // columns of its earlier entries and of the elements containing it. Entries
+  // within unaffected columns are accounted for by the elements.
+  auto for_each_start = [&](Int row, Int supernode_offset,
+                            const Buffer<Int>& member_to_index, auto&& visit) {
+    const Int orig_row =
+        have_permutation ? ordering_->inverse_permutation[row] : row;
+    const Int row_beg = matrix.RowEntryOffset(orig_row);
+    const Int row_end = matrix.RowEntryOffset(orig_row + 1);
+    for (Int index = row_beg; index < row_end; ++index) {
+      const Int orig_column = entries[index].column;
+      const Int column = have_permutation
+                             ? ordering_->permutation[orig_column]
+                             : orig_column;
+      if (column >= supernode_offset) {
+        continue;
+      }
+      if (column < old_num_rows && !affected[old_member_to_index[column]]) {
+        continue;
+      }
+      visit(member_to_index[column]);
+    }
+    for (Int index = element_offsets[row]; index < element_offsets[row + 1];
+         ++index) {
+      visit(element_parents[index]);
+    }
+  };
+
+  // Returns whether the given (possibly new) supernode is recomputed.
+  auto recomputed = [&](Int supernode) {
+    return supernode >= old_num_supernodes || affected[supernode];
+  };
+
+  // Form the new parents of the recomputed supernodes with Liu's algorithm
+  // (with path compression); the unaffected supernodes keep theirs.
+  Buffer<Int> singleton_parents(num_singletons, -1);
+  {
+    Buffer<Int> ancestors(num_singletons, -1);
+    for (Int supernode = 0; supernode < old_num_supernodes; ++supernode) {
+      if (!affected[supernode]) {
+        singleton_parents[supernode] = old_parents[supernode];
+      }
+    }
+    for (Int supernode = 0; supernode < num_singletons; ++supernode) {
+      if (!recomputed(supernode)) {
+        continue;
+      }
+      const Int supernode_offset = singleton_offsets[supernode];
+      for (Int row = supernode_offset; row < singleton_offsets[supernode + 1];
+           ++row) {
+        for_each_start(row, supernode_offset, member_to_singleton,
+                       [&](Int start) {
+                         Int ancestor = start;
+                         while (ancestors[ancestor] != -1 &&
+                                ancestors[ancestor] != supernode) {
+                           const Int next_ancestor = ancestors[ancestor];
+                           ancestors[ancestor] = supernode;
+                           ancestor = next_ancestor;
+                         }
+                         if (ancestors[ancestor] == -1) {
+                           ancestors[ancestor] = supernode;
+                           singleton_parents[ancestor] = supernode;
+                         }
+                       });
+      }
+    }
+  }
+
+  // Counts the structure sizes of the recomputed supernodes by walking up
+  // from the starts of each row until reaching its own supernode.
+  auto count_degrees = [&](const Buffer<Int>& offsets,
+                           const Buffer<Int>& member_to_index,
+                           const Buffer<Int>& parents, Buffer<Int>* degrees) {
+    const Int num_supernodes = offsets.Size() - 1;
+    Buffer<Int> pattern_flags(num_supernodes, -1);
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      if (!recomputed(supernode)) {
+        continue;
+      }
+      for (Int row = offsets[supernode]; row < offsets[supernode + 1]; ++row) {
+        pattern_flags[supernode] = row;
+        for_each_start(row, offsets[supernode], member_to_index,
+                       [&](Int start) {
+                         for (Int ancestor = start;
+                              pattern_flags[ancestor] < row;
+                              ancestor = parents[ancestor]) {
+                           ++(*degrees)[ancestor];
+                           pattern_flags[ancestor] = row;
+                         }
+                       });
+      }
+    }
+  };
+
+  // Merge each chain of new rows which forms a fundamental supernode.
+  Buffer<Int> singleton_degrees(num_singletons, 0);
+  count_degrees(singleton_offsets, member_to_singleton, singleton_parents,
+                &singleton_degrees);
+  Buffer<Int> num_children(num_singletons, 0);
+  for (Int supernode = 0; supernode < num_singletons; ++supernode) {
+    if (singleton_parents[supernode] >= 0) {
+      ++num_children[singleton_parents[supernode]];
+    }
+  }
+  Buffer<Int> singleton_to_supernode(num_singletons);
+  Int num_supernodes = old_num_supernodes;
+  for (Int supernode = 0; supernode < num_singletons; ++supernode) {
+    if (supernode < old_num_supernodes) {
+      singleton_to_supernode[supernode] = supernode;
+      continue;
+    }
+    const Int prev = supernode - 1;
+    const bool merge = prev >= old_num_supernodes &&
+                       singleton_parents[prev] == supernode &&
+                       num_children[supernode] == 1 &&
+                       singleton_degrees[supernode] ==
+                           singleton_degrees[prev] - 1;
+    if (!merge) {
+      ++num_supernodes;
+    }
+    singleton_to_supernode[supernode] = num_supernodes - 1;
+  }
+
+  Buffer<Int> supernode_sizes(num_supernodes, 0);
+  Buffer<Int> parents(num_supernodes, -1);
+  for (Int supernode = 0; supernode < num_singletons; ++supernode) {
+    const Int merged_supernode = singleton_to_supernode[supernode];
+    supernode_sizes[merged_supernode] +=
+        singleton_offsets[supernode + 1] - singleton_offsets[supernode];
+
+    // The parent of the last member of a merged chain is the parent of the
+    // chain.
+    const Int parent = singleton_parents[supernode];
+    parents[merged_supernode] =
+        parent >= 0 ? singleton_to_supernode[parent] : -1;
+  }
+  SymmetricOrdering& ordering = MutableOrdering();
+  ordering.supernode_sizes = std::move(supernode_sizes);
+  OffsetScan(ordering.supernode_sizes, &ordering.supernode_offsets);
+  ordering.assembly_forest.parents = std::move(parents);
+  ordering.assembly_forest.FillFromParents();
+  Buffer<Int> member_to_index;
+  MemberToIndex(num_rows, ordering_->supernode_offsets, &member_to_index);
+
+  Buffer<Int> supernode_degrees(num_supernodes, 0);
+  for (Int supernode = 0; supernode < old_num_supernodes; ++supernode) {
+    if (!affected[supernode]) {
+      supernode_degrees[supernode] =
+          lower_factor_->StructureEnd(supernode) -
+          lower_factor_->StructureBeg(supernode);
+    }
+  }
+  count_degrees(ordering_->supernode_offsets, member_to_index,
+                ordering_->assembly_forest.parents, &supernode_degrees);
+
+  // Allocate the new factor, copy the unchanged structures, and fill the
+  // recomputed ones in increasing order.
+  const std::unique_ptr<LowerFactor<Field>> old_lower_factor =
+      std::move(lower_factor_);
+  m_allocateFactors(supernode_degrees);
+  for (Int supernode = 0; supernode < old_num_supernodes; ++supernode) {
+    if (!affected[supernode]) {
+      std::copy(old_lower_factor->StructureBeg(supernode),
+                old_lower_factor->StructureEnd(supernode),
+                lower_factor_->StructureBeg(supernode));
+    }
+  }
+  {
+    const Buffer<Int>& offsets = ordering_->supernode_offsets;
+    const Buffer<Int>& forest_parents = ordering_->assembly_forest.parents;
+    Buffer<Int> pattern_flags(num_supernodes, -1);
+    Buffer<Int> num_filled(num_supernodes, 0);
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      if (!recomputed(supernode)) {
+        continue;
+      }
+      for (Int row = offsets[supernode]; row < offsets[supernode + 1]; ++row) {
+        pattern_flags[supernode] = row;
+        for_each_start(row, offsets[supernode], member_to_index,
+                       [&](Int start) {
+                         for (Int ancestor = start;
+                              pattern_flags[ancestor] < row;
+                              ancestor = forest_parents[ancestor]) {
+                           lower_factor_->StructureBeg(
+                               ancestor)[num_filled[ancestor]++] = row;
+                           pattern_flags[ancestor] = row;
+                         }
+                       });
+      }
+    }
+  }
+
+  supernode_member_to_index_ = std::move(member_to_index);
+  num_interior_ = num_rows;
+  FinishInitializingFactors(num_rows, supernode_degrees);
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::RefactorWithGrownSparsityPattern(
+    const CoordinateMatrix<Field>& matrix) {
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error(
+        "Growing the pattern of a partial factorization is not supported");
+  }
+  if (matrix.NumRows() < NumRows()) {
+    throw std::runtime_error("The grown matrix had fewer rows: " +
+                             std::to_string(matrix.NumRows()) + " < " +
+                             std::to_string(NumRows()));
+  }
+
+  Buffer<char> affected;
+  const bool any_affected = MarkGrownSupernodes(matrix, &affected);
+  if (!any_affected && matrix.NumRows() == NumRows()) {
+    return RefactorWithFixedSparsityPattern(matrix);
+  }
+
+  ClearSparsityPatternCaches();
+  GrowSymbolicAnalysis(matrix, affected);
+  FinishSymbolicAnalysis();
+
+  return RefactorWithFixedSparsityPattern(matrix);
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_GROWN_PATTERN_IMPL_H_
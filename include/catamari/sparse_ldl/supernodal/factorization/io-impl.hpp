@@ -22,7 +22,7 @@ template <class Field>
 void Factorization<Field>::PrintDiagonalFactor(const std::string& label,
                                                std::ostream& os) const {
   os << label << ": \n";
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
     const ConstBlasMatrixView<Field>& diag_matrix =
         diagonal_factor_->blocks[supernode];
@@ -42,6 +42,7 @@ void Factorization<Field>::PrintDiagonalFactor(const std::string& label,
 template <class Field>
 void Factorization<Field>::PrintLowerFactor(const std::string& label,
                                             std::ostream& os) const {
+  RequireUncompressedFactor("Printing the lower factor");
   const bool is_cholesky =
       control_.factorization_type == kCholeskyFactorization;
 
@@ -51,9 +52,9 @@ void Factorization<Field>::PrintLowerFactor(const std::string& label,
   };
 
   os << label << ": \n";
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-    const Int supernode_start = ordering_.supernode_offsets[supernode];
+    const Int supernode_start = ordering_->supernode_offsets[supernode];
     const Int* indices = lower_factor_->StructureBeg(supernode);
 
     const ConstBlasMatrixView<Field>& diag_matrix =
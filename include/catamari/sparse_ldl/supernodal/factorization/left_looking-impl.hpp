@@ -9,12 +9,17 @@
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_LEFT_LOOKING_IMPL_H_
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 #include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dense_factorizations.hpp"
 #include "catamari/io_utils.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
 
 namespace catamari {
 namespace supernodal_ldl {
@@ -29,7 +34,7 @@ void Factorization<Field>::LeftLookingSupernodeUpdate(
   BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
   const Int supernode_size = lower_block.width;
   const Int supernode_degree = lower_block.height;
-  const Int supernode_offset = ordering_.supernode_offsets[supernode];
+  const Int supernode_offset = ordering_->supernode_offsets[supernode];
 
   Int* pattern_flags = private_state->pattern_flags.Data();
   Int* rel_ind = private_state->relative_indices.Data();
@@ -217,7 +222,7 @@ void Factorization<Field>::LeftLookingSupernodeUpdate(
           const Int j = rel_ind[j_rel];
           CATAMARI_ASSERT(j >= 0 && j < supernode_size,
                           "Invalid unpacked column index.");
-          CATAMARI_ASSERT(j + ordering_.supernode_offsets[supernode] ==
+          CATAMARI_ASSERT(j + ordering_->supernode_offsets[supernode] ==
                               descendant_structure[j_rel],
                           "Mismatched unpacked column structure.");
 
@@ -240,19 +245,18 @@ void Factorization<Field>::LeftLookingSupernodeUpdate(
                              descendant_degree_remaining / 1.e9;
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-      // Insert the descendant supernode into the list of its next ancestor.
-      // NOTE: We would need a lock for this in a multithreaded setting.
+      // Insert the descendant supernode into the list of its next ancestor,
+      // which may be shared with a concurrently factored subtree.
       const Int next_ancestor =
           supernode_member_to_index_[descendant_structure[intersect_size]];
-      shared_state->descendants.Insert(next_ancestor, descendant);
+      shared_state->InsertDescendant(next_ancestor, descendant);
     }
   }
 
   if (supernode_degree > 0) {
     // Insert the supernode into the list of its parent.
-    // NOTE: We would need a lock for this in a multithreaded setting.
     const Int parent = supernode_member_to_index_[structure[0]];
-    shared_state->descendants.Insert(parent, supernode);
+    shared_state->InsertDescendant(parent, supernode);
   }
 
   // Clear the descendant list for this node.
@@ -285,11 +289,23 @@ bool Factorization<Field>::LeftLookingSupernodeFinalize(
         &diagonal_block, &result->dynamic_regularization);
   }
   CATAMARI_STOP_TIMER(profile.cholesky);
-  result->num_successful_pivots += num_supernode_pivots;
   if (num_supernode_pivots < supernode_size) {
+    result->num_successful_pivots += num_supernode_pivots;
     CATAMARI_STOP_TIMER(profile.left_looking_finalize);
     return false;
   }
+
+  // 'result' holds the running pivot counts of the supernodes finalized
+  // before this one (within its subtree, if the subtrees are factored
+  // concurrently), which can only grow. The pivots of a supernode which makes
+  // the expected inertia unattainable are not counted as successful.
+  CountPivotSigns(diagonal_block.ToConst(), result);
+  if (!InertiaAttainable(result->num_positive_pivots,
+                         result->num_negative_pivots)) {
+    CATAMARI_STOP_TIMER(profile.left_looking_finalize);
+    return false;
+  }
+  result->num_successful_pivots += num_supernode_pivots;
 #ifdef CATAMARI_ENABLE_TIMERS
   profile.cholesky_gflops +=
       supernode_size *
@@ -322,14 +338,98 @@ bool Factorization<Field>::LeftLookingSupernodeFinalize(
   return true;
 }
 
+template <class Field>
+void Factorization<Field>::LeftLookingSkipSupernode(
+    Int supernode, LeftLookingSharedState* shared_state) {
+  shared_state->rel_rows[supernode] = 0;
+  shared_state->intersect_ptrs[supernode] =
+      lower_factor_->IntersectionSizesBeg(supernode);
+
+  const Int head = shared_state->descendants.heads[supernode];
+  for (Int next_descendant = head; next_descendant >= 0;) {
+    const Int descendant = next_descendant;
+    next_descendant = shared_state->descendants.lists[descendant];
+
+    // Move the descendant past its intersection with this supernode and
+    // into the list of its next ancestor.
+    const Int intersect_size = *shared_state->intersect_ptrs[descendant];
+    shared_state->intersect_ptrs[descendant]++;
+    const Int rel_row = shared_state->rel_rows[descendant] + intersect_size;
+    shared_state->rel_rows[descendant] = rel_row;
+    if (rel_row < lower_factor_->blocks[descendant].height) {
+      const Int next_ancestor = supernode_member_to_index_[
+          lower_factor_->StructureBeg(descendant)[rel_row]];
+      shared_state->descendants.Insert(next_ancestor, descendant);
+    }
+  }
+
+  if (lower_factor_->blocks[supernode].height > 0) {
+    const Int parent =
+        supernode_member_to_index_[*lower_factor_->StructureBeg(supernode)];
+    shared_state->descendants.Insert(parent, supernode);
+  }
+  shared_state->descendants.heads[supernode] = -1;
+}
+
+template <class Field>
+void Factorization<Field>::AddRetainedSchurComplements(
+    Int supernode, LinkedLists* contributors, Buffer<Int>* rel_rows,
+    PrivateState<Field>* private_state) {
+  BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
+  BlasMatrixView<Field>& lower_block = lower_factor_->blocks[supernode];
+  const Int supernode_offset = ordering_->supernode_offsets[supernode];
+  const Int supernode_end = supernode_offset + diagonal_block.height;
+
+  // Scatter the pattern of this supernode into pattern_flags.
+  Int* pattern_flags = private_state->pattern_flags.Data();
+  const Int* structure = lower_factor_->StructureBeg(supernode);
+  for (Int i = 0; i < lower_block.height; ++i) {
+    pattern_flags[structure[i]] = i;
+  }
+
+  for (Int next = contributors->heads[supernode]; next >= 0;) {
+    const Int contributor = next;
+    next = contributors->lists[contributor];
+    const Int degree = lower_factor_->blocks[contributor].height;
+    const Int* contributor_structure =
+        lower_factor_->StructureBeg(contributor);
+    const Field* schur_complement =
+        retained_schur_complements_[contributor].Data();
+
+    // Add the lower triangle of the columns within this supernode.
+    Int j_rel = (*rel_rows)[contributor];
+    for (; j_rel < degree && contributor_structure[j_rel] < supernode_end;
+         ++j_rel) {
+      const Int j = contributor_structure[j_rel] - supernode_offset;
+      const Field* column = schur_complement + j_rel * degree;
+      for (Int i_rel = j_rel; i_rel < degree; ++i_rel) {
+        const Int row = contributor_structure[i_rel];
+        if (row < supernode_end) {
+          diagonal_block(row - supernode_offset, j) += column[i_rel];
+        } else {
+          lower_block(pattern_flags[row], j) += column[i_rel];
+        }
+      }
+    }
+
+    (*rel_rows)[contributor] = j_rel;
+    if (j_rel < degree) {
+      const Int next_ancestor =
+          supernode_member_to_index_[contributor_structure[j_rel]];
+      contributors->Insert(next_ancestor, contributor);
+    }
+  }
+  contributors->heads[supernode] = -1;
+}
+
 template <class Field>
 bool Factorization<Field>::LeftLookingSubtree(
     Int supernode, const CoordinateMatrix<Field>& matrix,
     const DynamicRegularizationParams<Field>& dynamic_reg_params,
     LeftLookingSharedState* shared_state, PrivateState<Field>* private_state,
     SparseLDLResult<Field>* result) {
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
 
   CATAMARI_START_TIMER(shared_state->inclusive_timers[supernode]);
@@ -340,12 +440,12 @@ bool Factorization<Field>::LeftLookingSubtree(
   // Recurse on the children.
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
-        ordering_.assembly_forest.children[child_beg + child_index];
-    CATAMARI_ASSERT(ordering_.assembly_forest.parents[child] == supernode,
+        ordering_->assembly_forest.children[child_beg + child_index];
+    CATAMARI_ASSERT(ordering_->assembly_forest.parents[child] == supernode,
                     "Incorrect child index");
 
     DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
-    subparams.offset = ordering_.supernode_offsets[child];
+    subparams.offset = ordering_->supernode_offsets[child];
     successes[child_index] =
         LeftLookingSubtree(child, matrix, subparams, shared_state,
                            private_state, &result_contributions[child_index]);
@@ -379,13 +479,16 @@ bool Factorization<Field>::LeftLookingSubtree(
   return succeeded;
 }
 
-// We no longer support OpenMP in the left-looking factorization.
 template <class Field>
 SparseLDLResult<Field> Factorization<Field>::LeftLooking(
     const CoordinateMatrix<Field>& matrix) {
   typedef ComplexBase<Field> Real;
+  if (UseDelayedPivoting()) return DelayedPivotingFactorization(matrix);
   CATAMARI_START_TIMER(profile.left_looking);
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  ExpandCompressedFactor();
+  device_offload_.ClearResidentBlocks();
+  retained_schur_complements_.Clear();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
 
   CATAMARI_START_TIMER(profile.left_looking_allocate);
   LeftLookingSharedState shared_state;
@@ -397,14 +500,20 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
-  PrivateState<Field> private_state;
-  private_state.pattern_flags.Resize(matrix.NumRows());
-  private_state.relative_indices.Resize(matrix.NumRows());
-  if (control_.factorization_type != kCholeskyFactorization) {
-    private_state.scaled_transpose_buffer.Resize(
-        left_looking_scaled_transpose_size_, Field{0});
-  }
-  private_state.workspace_buffer.Resize(left_looking_workspace_size_, Field{0});
+  // Each thread lazily allocates its own workspaces upon first use.
+  const Int num_rows = matrix.NumRows();
+  LeftLookingPrivateStates<Field> private_states([&]() {
+    PrivateState<Field> private_state;
+    private_state.pattern_flags.Resize(num_rows);
+    private_state.relative_indices.Resize(num_rows);
+    if (control_.factorization_type != kCholeskyFactorization) {
+      private_state.scaled_transpose_buffer.Resize(
+          left_looking_scaled_transpose_size_, Field{0});
+    }
+    private_state.workspace_buffer.Resize(left_looking_workspace_size_,
+                                          Field{0});
+    return private_state;
+  });
   CATAMARI_STOP_TIMER(profile.left_looking_allocate);
 
   // Set up the base value of the dynamic regularization parameters, and
@@ -417,30 +526,46 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
   dynamic_reg_params.negative_threshold = std::pow(
       kEpsilon, control_.dynamic_regularization.negative_threshold_exponent);
   if (control_.dynamic_regularization.relative) {
-    const Real matrix_max_norm = MaxNorm(matrix);
+    const Real matrix_max_norm = InputMaxNorm(matrix);
     dynamic_reg_params.positive_threshold *= matrix_max_norm;
     dynamic_reg_params.negative_threshold *= matrix_max_norm;
   }
   dynamic_reg_params.signatures = &control_.dynamic_regularization.signatures;
-  dynamic_reg_params.inverse_permutation = ordering_.inverse_permutation.Empty()
+  dynamic_reg_params.inverse_permutation = ordering_->inverse_permutation.Empty()
                                                ? nullptr
-                                               : &ordering_.inverse_permutation;
+                                               : &ordering_->inverse_permutation;
 
   // Note that any postordering of the supernodal elimination forest suffices.
   SparseLDLResult<Field> result;
-  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-    InitializeBlockColumn(supernode, matrix);
-    LeftLookingSupernodeUpdate(supernode, matrix, &shared_state,
-                               &private_state);
-
-    dynamic_reg_params.offset = ordering_.supernode_offsets[supernode];
-    const bool succeeded =
-        LeftLookingSupernodeFinalize(supernode, dynamic_reg_params, &result);
-    if (!succeeded) {
+  IncorporateRelaxationIntoLDLResult(&result);
+  if (dynamic_reg_params.enabled &&
+      control_.dynamic_regularization.diagonal_output) {
+    result.dynamic_regularization_diagonal.Resize(NumRows(), Real(0));
+    dynamic_reg_params.diagonal = result.dynamic_regularization_diagonal.Data();
+  }
+  if (get_max_num_tbb_threads() > 1) {
+    if (!OpenMPLeftLookingForest(matrix, dynamic_reg_params, &shared_state,
+                                 &private_states, &result)) {
       CATAMARI_STOP_TIMER(profile.left_looking);
       return result;
     }
+  } else {
+    PrivateState<Field>& private_state = private_states.local();
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      InitializeBlockColumn(supernode, matrix);
+      LeftLookingSupernodeUpdate(supernode, matrix, &shared_state,
+                                 &private_state);
+
+      dynamic_reg_params.offset = ordering_->supernode_offsets[supernode];
+      const bool succeeded =
+          LeftLookingSupernodeFinalize(supernode, dynamic_reg_params, &result);
+      if (!succeeded) {
+        CATAMARI_STOP_TIMER(profile.left_looking);
+        return result;
+      }
+    }
   }
+  FinishFactorization(&result);
 
 #ifdef CATAMARI_DEBUG
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
@@ -453,11 +578,11 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
 #ifdef CATAMARI_ENABLE_TIMERS
   TruncatedForestTimersToDot(
       control_.inclusive_timings_filename, shared_state.inclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
   TruncatedForestTimersToDot(
       control_.exclusive_timings_filename, shared_state.exclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
@@ -465,6 +590,181 @@ SparseLDLResult<Field> Factorization<Field>::LeftLooking(
   return result;
 }
 
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::RefactorChangedColumns(
+    const Buffer<Int>& changed_columns, const ConversionPlan& cplan,
+    const Field* Ax, Field sigma, const Field* Bx) {
+  typedef ComplexBase<Field> Real;
+  TraceScope trace_scope("RefactorChangedColumns");
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error(
+        "Refactoring changed columns requires a complete factorization");
+  }
+  RequireUncompressedFactor("Refactoring changed columns");
+  RequireCurrentConversionPlan(cplan);
+  if (out_of_core_storage_) {
+    throw std::runtime_error(
+        "Refactoring changed columns requires an in-memory factor");
+  }
+  device_offload_.ClearResidentBlocks();
+  const Int num_rows = NumRows();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const Buffer<Int>& parents = ordering_->assembly_forest.parents;
+
+  // Mark the supernodes containing a changed column and their ancestors.
+  Buffer<char> refactored(num_supernodes, 0);
+  Int num_refactored = 0;
+  for (const Int& column : changed_columns) {
+    if (column < 0 || column >= num_rows) {
+      throw std::runtime_error("Invalid changed column " +
+                               std::to_string(column));
+    }
+    const Int row = have_permutation ? ordering_->permutation[column] : column;
+    for (Int supernode = supernode_member_to_index_[row];
+         supernode >= 0 && !refactored[supernode];
+         supernode = parents[supernode]) {
+      refactored[supernode] = 1;
+      ++num_refactored;
+    }
+  }
+  Buffer<Int> refactored_supernodes(num_refactored);
+  for (Int supernode = 0, index = 0; supernode < num_supernodes; ++supernode) {
+    if (refactored[supernode]) refactored_supernodes[index++] = supernode;
+  }
+
+  // An unchanged subtree whose root's Schur complement was retained by the
+  // last right-looking factorization is summarized by that copy.
+  const bool have_retained =
+      Int(retained_schur_complements_.Size()) == num_supernodes;
+  Buffer<char> reused(num_supernodes, 0);
+  if (have_retained) {
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      const Int parent = parents[supernode];
+      reused[supernode] = parent >= 0 && refactored[parent] &&
+                          !refactored[supernode] &&
+                          !retained_schur_complements_[supernode].Empty();
+    }
+  }
+
+  // Since the parent of a supernode follows it, each supernode can inherit
+  // whether its tree contains a refactored supernode from its parent. The
+  // other trees update no refactored supernode and need not be traversed,
+  // and neither do the subtrees of the reused Schur complements.
+  Buffer<char> traversed(num_supernodes);
+  for (Int supernode = num_supernodes - 1; supernode >= 0; --supernode) {
+    const Int parent = parents[supernode];
+    traversed[supernode] = parent >= 0
+                               ? traversed[parent] && !reused[supernode]
+                               : refactored[supernode];
+  }
+
+  if (!lower_factor_->HaveIntersectionSizes()) {
+    Buffer<Int> supernode_degrees(num_supernodes);
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      supernode_degrees[supernode] = lower_factor_->blocks[supernode].height;
+    }
+    FormLeftLookingWorkspaces(supernode_degrees);
+  }
+
+  LeftLookingSharedState shared_state;
+  shared_state.rel_rows.Resize(num_supernodes);
+  shared_state.intersect_ptrs.Resize(num_supernodes);
+  shared_state.descendants.Initialize(num_supernodes);
+
+  PrivateState<Field> private_state;
+  private_state.pattern_flags.Resize(num_rows);
+  private_state.relative_indices.Resize(num_rows);
+  if (control_.factorization_type != kCholeskyFactorization) {
+    private_state.scaled_transpose_buffer.Resize(
+        left_looking_scaled_transpose_size_, Field{0});
+  }
+  private_state.workspace_buffer.Resize(left_looking_workspace_size_, Field{0});
+
+  // Queue each reused Schur complement on the supernode containing its
+  // leading structure index.
+  LinkedLists contributors;
+  contributors.Initialize(num_supernodes);
+  Buffer<Int> contributor_rel_rows(num_supernodes, 0);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    if (!reused[supernode]) continue;
+    const Int leading_row = *lower_factor_->StructureBeg(supernode);
+    contributors.Insert(supernode_member_to_index_[leading_row], supernode);
+  }
+
+  // As in the refactorizations through a conversion plan, the entries are
+  // loaded through 'cplan' rather than from a matrix.
+  CoordinateMatrix<Field> matrix;
+  m_inputData.set(cplan, Ax, sigma, Bx);
+
+  static const Real kEpsilon = std::numeric_limits<Real>::epsilon();
+  DynamicRegularizationParams<Field> dynamic_reg_params;
+  dynamic_reg_params.enabled = control_.dynamic_regularization.enabled;
+  dynamic_reg_params.positive_threshold = std::pow(
+      kEpsilon, control_.dynamic_regularization.positive_threshold_exponent);
+  dynamic_reg_params.negative_threshold = std::pow(
+      kEpsilon, control_.dynamic_regularization.negative_threshold_exponent);
+  if (control_.dynamic_regularization.relative) {
+    const Real matrix_max_norm = InputMaxNorm(matrix);
+    dynamic_reg_params.positive_threshold *= matrix_max_norm;
+    dynamic_reg_params.negative_threshold *= matrix_max_norm;
+  }
+  dynamic_reg_params.signatures = &control_.dynamic_regularization.signatures;
+  dynamic_reg_params.inverse_permutation =
+      ordering_->inverse_permutation.Empty() ? nullptr
+                                             : &ordering_->inverse_permutation;
+
+  SparseLDLResult<Field> result;
+  IncorporateRelaxationIntoLDLResult(&result);
+  if (dynamic_reg_params.enabled &&
+      control_.dynamic_regularization.diagonal_output) {
+    result.dynamic_regularization_diagonal.Resize(NumRows(), Real(0));
+    dynamic_reg_params.diagonal = result.dynamic_regularization_diagonal.Data();
+  }
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    BlasMatrixView<Field>& diagonal_block = diagonal_factor_->blocks[supernode];
+    const Int supernode_size = diagonal_block.height;
+    const Int supernode_offset = ordering_->supernode_offsets[supernode];
+    if (!refactored[supernode]) {
+      if (traversed[supernode]) {
+        LeftLookingSkipSupernode(supernode, &shared_state);
+      }
+
+      // The retained pivots still contribute to the result.
+      CountPivotSigns(diagonal_block.ToConst(), &result);
+      result.num_successful_pivots += supernode_size;
+      IncorporateSupernodeIntoLDLResult(
+          supernode_size, lower_factor_->blocks[supernode].height, &result);
+      continue;
+    }
+
+    for (Int j = 0; j < supernode_size; ++j) {
+      InitializeFactorColumn(supernode_offset + j, j, diagonal_block);
+    }
+    AddRetainedSchurComplements(supernode, &contributors,
+                                &contributor_rel_rows, &private_state);
+    LeftLookingSupernodeUpdate(supernode, matrix, &shared_state,
+                               &private_state);
+
+    dynamic_reg_params.offset = supernode_offset;
+    if (!LeftLookingSupernodeFinalize(supernode, dynamic_reg_params,
+                                      &result)) {
+      retained_schur_complements_.Clear();
+      return result;
+    }
+  }
+  RepackSolvePanels(&refactored_supernodes);
+
+  // The Schur complements of the refactored supernodes have changed.
+  if (have_retained) {
+    for (const Int& supernode : refactored_supernodes) {
+      retained_schur_complements_[supernode].Clear();
+    }
+  }
+
+  return result;
+}
+
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
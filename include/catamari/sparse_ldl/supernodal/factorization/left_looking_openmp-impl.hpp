@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_LEFT_LOOKING_OPENMP_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_LEFT_LOOKING_OPENMP_IMPL_H_
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+bool Factorization<Field>::OpenMPLeftLookingSubtree(
+    Int supernode, const CoordinateMatrix<Field>& matrix,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    double min_parallel_work, LeftLookingSharedState* shared_state,
+    LeftLookingPrivateStates<Field>* private_states,
+    SparseLDLResult<Field>* result) {
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
+  const Int num_children = child_end - child_beg;
+  if (shared_state->failed) return false;
+
+  if (!TaskParallelSubtree(supernode, work_estimates_, min_parallel_work)) {
+    // The subtree is factored serially with this thread's workspaces, which
+    // must not be picked up by another of our tasks if the dense kernels
+    // wait upon nested parallelism.
+    bool succeeded;
+    tbb::this_task_arena::isolate([&]() {
+      succeeded = LeftLookingSubtree(supernode, matrix, dynamic_reg_params,
+                                     shared_state, &private_states->local(),
+                                     result);
+    });
+    if (!succeeded) shared_state->failed = true;
+    return succeeded;
+  }
+
+  CATAMARI_START_TIMER(shared_state->inclusive_timers[supernode]);
+
+  // The children are independent, other than through the lists of their
+  // common ancestors.
+  Buffer<int> successes(num_children);
+  Buffer<SparseLDLResult<Field>> result_contributions(num_children);
+  tbb::task_group group;
+  for (Int child_index = 0; child_index < num_children; ++child_index) {
+    group.run([&, child_index]() {
+      const Int child =
+          ordering_->assembly_forest.children[child_beg + child_index];
+      DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+      subparams.offset = ordering_->supernode_offsets[child];
+      successes[child_index] = OpenMPLeftLookingSubtree(
+          child, matrix, subparams, min_parallel_work, shared_state,
+          private_states, &result_contributions[child_index]);
+    });
+  }
+  group.wait();
+
+  CATAMARI_START_TIMER(shared_state->exclusive_timers[supernode]);
+
+  // Merge the child results (stopping if a failure is detected).
+  bool succeeded = true;
+  for (Int child_index = 0; child_index < num_children; ++child_index) {
+    if (!successes[child_index]) {
+      succeeded = false;
+      break;
+    }
+    MergeContribution(result_contributions[child_index], result);
+  }
+  if (succeeded && dynamic_reg_params.enabled) {
+    MergeDynamicRegularizations(result_contributions, result);
+  }
+
+  if (succeeded) {
+    tbb::this_task_arena::isolate([&]() {
+      PrivateState<Field>* private_state = &private_states->local();
+      InitializeBlockColumn(supernode, matrix);
+      LeftLookingSupernodeUpdate(supernode, matrix, shared_state,
+                                 private_state);
+      succeeded =
+          LeftLookingSupernodeFinalize(supernode, dynamic_reg_params, result);
+    });
+    if (!succeeded) shared_state->failed = true;
+  }
+
+  CATAMARI_STOP_TIMER(shared_state->inclusive_timers[supernode]);
+  CATAMARI_STOP_TIMER(shared_state->exclusive_timers[supernode]);
+
+  return succeeded;
+}
+
+template <class Field>
+bool Factorization<Field>::OpenMPLeftLookingForest(
+    const CoordinateMatrix<Field>& matrix,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    LeftLookingSharedState* shared_state,
+    LeftLookingPrivateStates<Field>* private_states,
+    SparseLDLResult<Field>* result) {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Int num_roots = forest.roots.Size();
+  const Int max_threads = get_max_num_tbb_threads();
+
+  // The flop-count estimates are shared with the right-looking
+  // factorization.
+  if (work_estimates_.Size() != num_supernodes) {
+    work_estimates_.Resize(num_supernodes);
+    for (const Int& root : forest.roots) {
+      FillSubtreeWorkEstimates(root, forest, *lower_factor_,
+                               &work_estimates_);
+    }
+    total_work_ =
+        std::accumulate(work_estimates_.begin(), work_estimates_.end(), 0.);
+  }
+  const double min_parallel_work =
+      max_threads < 2
+          ? std::numeric_limits<double>::infinity()
+          : std::max(control_.min_parallel_threshold,
+                     (total_work_ * control_.parallel_ratio_threshold) /
+                         max_threads);
+
+  shared_state->concurrent = true;
+  shared_state->failed = false;
+  Buffer<int> successes(num_roots);
+  Buffer<SparseLDLResult<Field>> result_contributions(num_roots);
+  tbb::task_group group;
+  for (Int root_index = 0; root_index < num_roots; ++root_index) {
+    group.run([&, root_index]() {
+      const Int root = forest.roots[root_index];
+      DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+      subparams.offset = ordering_->supernode_offsets[root];
+      successes[root_index] = OpenMPLeftLookingSubtree(
+          root, matrix, subparams, min_parallel_work, shared_state,
+          private_states, &result_contributions[root_index]);
+    });
+  }
+  group.wait();
+  shared_state->concurrent = false;
+
+  // Merge the tree results (stopping if a failure is detected).
+  for (Int root_index = 0; root_index < num_roots; ++root_index) {
+    if (!successes[root_index]) return false;
+    MergeContribution(result_contributions[root_index], result);
+  }
+  if (dynamic_reg_params.enabled) {
+    MergeDynamicRegularizations(result_contributions, result);
+  }
+  return true;
+}
+
+template <class Field>
+void Factorization<Field>::SelectLeftLookingSubtrees(
+    double min_parallel_work, RightLookingSharedState<Field>* shared_state) {
+  Buffer<char>& selected = shared_state->left_looking_subtrees;
+  const Int max_front = control_.left_looking_subtree_max_front;
+  if (max_front <= 0 || InterfaceSupernode() >= 0) {
+    selected.Clear();
+    return;
+  }
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+
+  // The children precede their parents, so the largest front of each
+  // subtree is available once its root is visited. Single supernodes gain
+  // nothing from the left-looking method, and the subtrees with enough work
+  // to be split amongst threads are left to the right-looking scheduler.
+  Buffer<Int> max_fronts(num_supernodes);
+  selected.Resize(num_supernodes);
+  bool any_selected = false;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int child_beg = forest.child_offsets[supernode];
+    const Int child_end = forest.child_offsets[supernode + 1];
+    Int front = ordering_->supernode_sizes[supernode] +
+                lower_factor_->blocks[supernode].height;
+    for (Int index = child_beg; index < child_end; ++index) {
+      front = std::max(front, max_fronts[forest.children[index]]);
+    }
+    max_fronts[supernode] = front;
+    selected[supernode] = child_end > child_beg && front <= max_front &&
+                          work_estimates_[supernode] < min_parallel_work;
+    any_selected = any_selected || selected[supernode];
+  }
+  if (!any_selected) {
+    selected.Clear();
+    return;
+  }
+
+  if (!lower_factor_->HaveIntersectionSizes()) {
+    Buffer<Int> supernode_degrees(num_supernodes);
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      supernode_degrees[supernode] = lower_factor_->blocks[supernode].height;
+    }
+    FormLeftLookingWorkspaces(supernode_degrees);
+  }
+
+  // The lists of the descendants which are shared by the concurrently
+  // factored subtrees are those of their (right-looking) ancestors, which
+  // are never traversed.
+  LeftLookingSharedState& left_looking = shared_state->left_looking;
+  left_looking.rel_rows.Resize(num_supernodes);
+  left_looking.intersect_ptrs.Resize(num_supernodes);
+  left_looking.descendants.Initialize(num_supernodes);
+  std::fill(left_looking.descendants.heads.begin(),
+            left_looking.descendants.heads.end(), -1);
+  left_looking.concurrent = true;
+#ifdef CATAMARI_ENABLE_TIMERS
+  left_looking.inclusive_timers.Resize(num_supernodes);
+  left_looking.exclusive_timers.Resize(num_supernodes);
+#endif  // ifdef CATAMARI_ENABLE_TIMERS
+}
+
+template <class Field>
+void Factorization<Field>::FormSubtreeSchurComplement(
+    Int root, const std::vector<Int>& subtree,
+    RightLookingPrivateState<Field>* private_state,
+    BlasMatrixView<Field>* schur_complement) {
+  typedef ComplexBase<Field> Real;
+  const Int degree = lower_factor_->blocks[root].height;
+  if (!degree) return;
+  const Int root_end = ordering_->supernode_offsets[root + 1];
+  const Int tile_size = control_.outer_product_tile_size;
+
+  // Overwrites 'output' with the (lower triangle of the) update of the rows
+  // of 'supernode' past 'rel_row' onto themselves.
+  auto outer_product = [&](Int supernode, Int rel_row,
+                           BlasMatrixView<Field>* output) {
+    const ConstBlasMatrixView<Field> lower_block =
+        lower_factor_->blocks[supernode].ToConst();
+    const Int height = lower_block.height - rel_row;
+    const ConstBlasMatrixView<Field> rows =
+        lower_block.Submatrix(rel_row, 0, height, lower_block.width);
+    if (control_.factorization_type == kCholeskyFactorization) {
+      LowerNormalHermitianOuterProductDynamicBLASDispatch(Real{-1}, rows,
+                                                          Real{0}, output);
+    } else {
+      Field* buffer = private_state->ScaledTransposeBuffer(
+          std::min(tile_size, height) * lower_block.width);
+      LowerScaledOuterProduct(tile_size, control_.factorization_type,
+                              diagonal_factor_->blocks[supernode].ToConst(),
+                              rows, Field{0}, buffer, output);
+    }
+  };
+
+  // The root's own update initializes the Schur complement.
+  outer_product(root, 0, schur_complement);
+
+  // Scatter the structure of the root into pattern_flags.
+  Int* pattern_flags = private_state->left_looking.pattern_flags.Data();
+  const Int* structure = lower_factor_->StructureBeg(root);
+  for (Int i = 0; i < degree; ++i) {
+    pattern_flags[structure[i]] = i;
+  }
+
+  // The rows of each descendant past the root lie within its structure.
+  for (const Int& descendant : subtree) {
+    if (descendant == root) continue;
+    const Int* descendant_structure = lower_factor_->StructureBeg(descendant);
+    const Int* descendant_structure_end =
+        lower_factor_->StructureEnd(descendant);
+    const Int rel_row =
+        std::lower_bound(descendant_structure, descendant_structure_end,
+                         root_end) -
+        descendant_structure;
+    const Int height = (descendant_structure_end - descendant_structure) -
+                       rel_row;
+    if (!height) continue;
+
+    BlasMatrixView<Field> update;
+    update.height = height;
+    update.width = height;
+    update.leading_dim = height;
+    update.data = private_state->WorkspaceBuffer(height * height);
+    outer_product(descendant, rel_row, &update);
+
+    const Int* rows = descendant_structure + rel_row;
+    for (Int j = 0; j < height; ++j) {
+      Field* column = schur_complement->Pointer(0, pattern_flags[rows[j]]);
+      const Field* update_column = update.Pointer(0, j);
+      for (Int i = j; i < height; ++i) {
+        column[pattern_flags[rows[i]]] += update_column[i];
+      }
+    }
+  }
+}
+
+template <class Field>
+bool Factorization<Field>::HybridLeftLookingSubtree(
+    Int supernode, const CoordinateMatrix<Field>& matrix,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    RightLookingSharedState<Field>* shared_state,
+    RightLookingPrivateStates<Field>* private_states,
+    SparseLDLResult<Field>* result) {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_rows = NumRows();
+  const Int degree = lower_factor_->blocks[supernode].height;
+
+  // Gather the supernodes of the subtree in increasing order, which visits
+  // the descendants of each before it.
+  std::vector<Int> subtree;
+  std::vector<Int> stack(1, supernode);
+  while (!stack.empty()) {
+    const Int member = stack.back();
+    stack.pop_back();
+    subtree.push_back(member);
+    for (Int index = forest.child_offsets[member];
+         index < forest.child_offsets[member + 1]; ++index) {
+      stack.push_back(forest.children[index]);
+    }
+  }
+  std::sort(subtree.begin(), subtree.end());
+
+  // This thread's workspaces must not be picked up by another of our tasks
+  // if the dense kernels wait upon nested parallelism.
+  SparseLDLResult<Field> subtree_result;
+  bool succeeded;
+  tbb::this_task_arena::isolate([&]() {
+    RightLookingPrivateState<Field>& private_state = private_states->local();
+    PrivateState<Field>& left_looking = private_state.left_looking;
+    if (left_looking.pattern_flags.Size() != num_rows) {
+      left_looking.pattern_flags.Resize(num_rows);
+      left_looking.relative_indices.Resize(num_rows);
+    }
+    if (left_looking.scaled_transpose_buffer.Size() <
+        left_looking_scaled_transpose_size_) {
+      left_looking.scaled_transpose_buffer.Resize(
+          left_looking_scaled_transpose_size_, Field{0});
+    }
+    if (left_looking.workspace_buffer.Size() < left_looking_workspace_size_) {
+      left_looking.workspace_buffer.Resize(left_looking_workspace_size_,
+                                           Field{0});
+    }
+
+    succeeded = LeftLookingSubtree(supernode, matrix, dynamic_reg_params,
+                                   &shared_state->left_looking, &left_looking,
+                                   &subtree_result);
+    if (!succeeded) return;
+
+    BlasMatrixView<Field>& schur_complement =
+        shared_state->schur_complements[supernode];
+    schur_complement = shared_state->schur_complement_storage[supernode]
+                           .allocateSingleMatrixForDegree(degree);
+    FormSubtreeSchurComplement(supernode, subtree, &private_state,
+                               &schur_complement);
+  });
+  MergeContribution(subtree_result, result);
+  result->dynamic_regularization.insert(
+      result->dynamic_regularization.end(),
+      subtree_result.dynamic_regularization.begin(),
+      subtree_result.dynamic_regularization.end());
+  if (!succeeded) {
+    shared_state->setFailed();
+    return false;
+  }
+
+  // Abort the entire factorization as soon as the expected inertia cannot be
+  // matched.
+  if (HaveExpectedInertia()) {
+    const Int num_positive = shared_state->num_positive_pivots.fetch_add(
+                                 subtree_result.num_positive_pivots) +
+                             subtree_result.num_positive_pivots;
+    const Int num_negative = shared_state->num_negative_pivots.fetch_add(
+                                 subtree_result.num_negative_pivots) +
+                             subtree_result.num_negative_pivots;
+    if (!InertiaAttainable(num_positive, num_negative)) {
+      shared_state->setFailed();
+      return false;
+    }
+  }
+
+  // None of the descendants' Schur complements were formed, so no stale
+  // copies of them may be kept.
+  for (const Int& member : subtree) {
+    if (member != supernode && !retained_schur_complements_.Empty()) {
+      retained_schur_complements_[member].Clear();
+    }
+    FusedForwardSolveSupernode(member);
+    EvictSupernodePanel(member);
+  }
+  return true;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+        // CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_LEFT_LOOKING_OPENMP_IMPL_H_
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_MEMORY_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_MEMORY_IMPL_H_
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+namespace memory {
+
+// Returns the peak (in entries) of the Schur complement storage while the
+// children of a parent, whose own Schur complement has 'parent_entries'
+// entries, are factored by 'num_threads' threads. Each child holds 'held'
+// entries once it completes, and at most 'peak' while it is factored.
+inline std::size_t ConcurrentChildrenPeak(
+    const std::vector<std::size_t>& held, const std::vector<std::size_t>& peak,
+    std::size_t parent_entries, Int num_threads) {
+  const std::size_t total_held =
+      std::accumulate(held.begin(), held.end(), std::size_t(0));
+
+  // At most 'num_threads' of the children are in flight at once, while the
+  // remainder have either completed or not yet begun.
+  std::vector<std::size_t> excess(held.size());
+  for (std::size_t index = 0; index < held.size(); ++index) {
+    excess[index] = peak[index] - held[index];
+  }
+  const std::size_t num_in_flight =
+      std::min(excess.size(), std::size_t(std::max(num_threads, Int(1))));
+  std::partial_sort(excess.begin(), excess.begin() + num_in_flight,
+                    excess.end(), std::greater<std::size_t>());
+  const std::size_t in_flight = std::accumulate(
+      excess.begin(), excess.begin() + num_in_flight, std::size_t(0));
+
+  return std::max(total_held + in_flight, total_held + parent_entries);
+}
+
+}  // namespace memory
+
+template <class Field>
+MemoryEstimate Factorization<Field>::EstimateMemory(
+    Int num_threads, Int num_right_hand_sides) const {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Int num_rows = NumRows();
+  num_threads = std::max(num_threads, Int(1));
+
+  MemoryEstimate estimate;
+  estimate.num_threads = num_threads;
+  estimate.num_right_hand_sides = num_right_hand_sides;
+
+  std::size_t num_factor_entries = 0;
+  std::size_t total_degree = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const std::size_t size = ordering_->supernode_sizes[supernode];
+    const std::size_t degree = lower_factor_->blocks[supernode].height;
+    num_factor_entries += size * (size + degree);
+    total_degree += degree;
+  }
+  estimate.factor_bytes = num_factor_entries * sizeof(Field);
+  if (control_.solve_layout == kRowPanelSolveLayout) {
+    estimate.solve_panel_bytes = estimate.factor_bytes;
+  }
+
+  // The structures and their relative indices, the permutation and its
+  // inverse, the member-to-supernode map, and the sizes, offsets, parents,
+  // children and child offsets of the supernodes.
+  estimate.structure_bytes =
+      sizeof(Int) * (2 * total_degree + 3 * std::size_t(num_rows) +
+                     5 * std::size_t(num_supernodes + 1));
+
+  // Only the blocks of 'solve_rhs_block_size' columns swept at once keep
+  // updates of the supernodes' structures.
+  const Int rhs_block_size =
+      control_.solve_rhs_block_size > 0
+          ? std::min(num_right_hand_sides, control_.solve_rhs_block_size)
+          : num_right_hand_sides;
+  estimate.solve_workspace_bytes =
+      sizeof(Field) * (std::size_t(num_rows) * num_right_hand_sides +
+                       total_degree * rhs_block_size);
+
+  Buffer<double> work_estimates(num_supernodes, 0.);
+  for (const Int& root : forest.roots) {
+    FillSubtreeWorkEstimates(root, forest, *lower_factor_, &work_estimates);
+  }
+  const double total_work =
+      std::accumulate(work_estimates.begin(), work_estimates.end(), 0.);
+  const double min_parallel_work =
+      num_threads < 2
+          ? std::numeric_limits<double>::infinity()
+          : std::max(control_.min_parallel_threshold,
+                     (total_work * control_.parallel_ratio_threshold) /
+                         num_threads);
+
+  Buffer<Int> expand_in_place_storage;
+  if (control_.expand_schur_complements_in_place) {
+    expand_in_place_storage.Resize(num_supernodes);
+    for (const Int& root : forest.roots) {
+      SchurComplementStorage<Field>::fillStorageNeededExpandInPlaceOptimal(
+          root, forest, *lower_factor_, &expand_in_place_storage);
+    }
+  }
+
+  // Visit the children before their parents by reversing a preorder.
+  std::vector<Int> preorder;
+  preorder.reserve(num_supernodes);
+  std::vector<Int> stack(forest.roots.begin(), forest.roots.end());
+  while (!stack.empty()) {
+    const Int supernode = stack.back();
+    stack.pop_back();
+    preorder.push_back(supernode);
+    for (Int index = forest.child_offsets[supernode];
+         index < forest.child_offsets[supernode + 1]; ++index) {
+      stack.push_back(forest.children[index]);
+    }
+  }
+
+  // The entries of the stack of the serial subtree rooted at each supernode
+  // (and of the same subtree below the root of a larger one, where its Schur
+  // complement may be packed), and, if it is factored as the root of a
+  // subtree, the entries held once it completes and the (bound on the) peak
+  // while it is factored.
+  const Int panel_width = SchurComplementPanelWidth();
+  std::vector<std::size_t> stack_entries(num_supernodes);
+  std::vector<std::size_t> packed_stack_entries(num_supernodes);
+  std::vector<std::size_t> held_entries(num_supernodes);
+  std::vector<std::size_t> peak_entries(num_supernodes);
+  std::vector<std::size_t> children_held, children_peak;
+  for (auto iter = preorder.rbegin(); iter != preorder.rend(); ++iter) {
+    const Int supernode = *iter;
+    const Int child_beg = forest.child_offsets[supernode];
+    const Int child_end = forest.child_offsets[supernode + 1];
+    const std::size_t degree = lower_factor_->blocks[supernode].height;
+
+    std::size_t max_child_stack = 0;
+    for (Int index = child_beg; index < child_end; ++index) {
+      max_child_stack = std::max(
+          max_child_stack, packed_stack_entries[forest.children[index]]);
+    }
+    stack_entries[supernode] =
+        control_.expand_schur_complements_in_place
+            ? std::size_t(expand_in_place_storage[supernode])
+            : degree * degree + max_child_stack;
+    packed_stack_entries[supernode] =
+        panel_width > 0
+            ? std::size_t(SchurComplementStorage<Field>::entriesNeeded(
+                  degree, panel_width)) +
+                  max_child_stack
+            : stack_entries[supernode];
+
+    const bool parallel =
+        TaskParallelSubtree(supernode, work_estimates, min_parallel_work);
+    if (!parallel) {
+      // The subtree is factored serially on its own stack, which is kept
+      // until its parent has merged its Schur complement.
+      held_entries[supernode] = peak_entries[supernode] =
+          stack_entries[supernode];
+      continue;
+    }
+
+    // The children are factored as concurrent tasks, each releasing its own
+    // children's storage upon completion, so that only its Schur complement
+    // is held until it is merged into this supernode's front.
+    children_held.clear();
+    children_peak.clear();
+    for (Int index = child_beg; index < child_end; ++index) {
+      const Int child = forest.children[index];
+      children_held.push_back(held_entries[child]);
+      children_peak.push_back(peak_entries[child]);
+    }
+    held_entries[supernode] = degree * degree;
+    peak_entries[supernode] = memory::ConcurrentChildrenPeak(
+        children_held, children_peak, degree * degree, num_threads);
+  }
+
+  std::size_t serial_entries = 0;
+  children_held.clear();
+  children_peak.clear();
+  for (const Int& root : forest.roots) {
+    // Each root's storage is freed as soon as it has been factored.
+    serial_entries = std::max(serial_entries, stack_entries[root]);
+    children_held.push_back(0);
+    children_peak.push_back(peak_entries[root]);
+  }
+  estimate.serial_frontal_bytes = sizeof(Field) * serial_entries;
+  estimate.parallel_frontal_bytes =
+      total_work < min_parallel_work
+          ? estimate.serial_frontal_bytes
+          : sizeof(Field) * memory::ConcurrentChildrenPeak(
+                                children_held, children_peak, 0, num_threads);
+
+  return estimate;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_MEMORY_IMPL_H_
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_PARTIAL_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_PARTIAL_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+Int Factorization<Field>::InterfaceSupernode() const {
+  if (num_interior_ >= NumRows()) {
+    return -1;
+  }
+  return ordering_->supernode_sizes.Size() - 1;
+}
+
+template <class Field>
+Int Factorization<Field>::NumInteriorRows() const {
+  return std::min(num_interior_, NumRows());
+}
+
+template <class Field>
+SparseLDLResult<Field> Factorization<Field>::FactorPartial(
+    const CoordinateMatrix<Field>& matrix,
+    const SymmetricOrdering& manual_ordering, Int num_interior,
+    const Control<Field>& control, BlasMatrix<Field>* schur_complement,
+    bool symbolic_only) {
+  if (num_interior < 0 || num_interior > matrix.NumRows()) {
+    throw std::runtime_error("Invalid number of interior rows: " +
+                             std::to_string(num_interior));
+  }
+
+  // Only the multifrontal (right-looking) factorization assembles the
+  // interface front.
+  Control<Field> partial_control = control;
+  partial_control.algorithm = kRightLookingLDL;
+  SparseLDLResult<Field> result =
+      FactorHelper(matrix, manual_ordering, num_interior, partial_control,
+                   /* symbolic_only = */ true);
+  if (symbolic_only) {
+    return result;
+  }
+
+  // The right-looking factorization loads the matrix entries through a
+  // conversion plan.
+  ConversionPlan cplan;
+  FormConversionPlan(matrix, &cplan);
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  Buffer<Field> values(entries.Size());
+  for (std::size_t index = 0; index < entries.Size(); ++index) {
+    values[index] = entries[index].value;
+  }
+  result = RefactorWithFixedSparsityPattern(cplan, values.Data());
+  m_inputData = MatrixData();
+
+  if (schur_complement && result.num_successful_pivots == num_interior) {
+    PartialSchurComplement(schur_complement);
+  }
+  return result;
+}
+
+template <class Field>
+void Factorization<Field>::PartialSchurComplement(
+    BlasMatrix<Field>* schur_complement) const {
+  const Int supernode = InterfaceSupernode();
+  if (supernode < 0) {
+    throw std::runtime_error("The factorization is not partial.");
+  }
+
+  // Only the lower triangle of the assembled front is maintained.
+  const ConstBlasMatrixView<Field> front =
+      diagonal_factor_->blocks[supernode].ToConst();
+  const Int size = front.height;
+  const bool self_adjoint =
+      control_.factorization_type != kLDLTransposeFactorization;
+  schur_complement->Resize(size, size);
+  for (Int j = 0; j < size; ++j) {
+    (*schur_complement)(j, j) = front(j, j);
+    for (Int i = j + 1; i < size; ++i) {
+      const Field& value = front(i, j);
+      (*schur_complement)(i, j) = value;
+      (*schur_complement)(j, i) = self_adjoint ? Conjugate(value) : value;
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::PartialForwardSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int interface_supernode = InterfaceSupernode();
+  const bool needs_permutation = !ordering_->permutation.Empty();
+  if (needs_permutation) {
+    Permute(ordering_->permutation, right_hand_sides);
+  }
+
+  // Solve against each interior subtree, whose updates are subtracted from
+  // the interface rows, while skipping the interface front itself.
+  const Int num_rhs = right_hand_sides->width;
+  Buffer<Field> workspace(max_degree_ * num_rhs, Field{0});
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  for (Int root_index = 0; root_index < Int(forest.roots.Size());
+       ++root_index) {
+    const Int root = forest.roots[root_index];
+    if (root != interface_supernode) {
+      LowerTriangularSolveRecursion(root, right_hand_sides, &workspace);
+      continue;
+    }
+    for (Int index = forest.child_offsets[root];
+         index < forest.child_offsets[root + 1]; ++index) {
+      LowerTriangularSolveRecursion(forest.children[index], right_hand_sides,
+                                    &workspace);
+    }
+  }
+
+  if (control_.factorization_type != kCholeskyFactorization) {
+    const Int num_interior_supernodes =
+        interface_supernode >= 0 ? interface_supernode
+                                 : Int(ordering_->supernode_sizes.Size());
+    for (Int supernode = 0; supernode < num_interior_supernodes; ++supernode) {
+      const ConstBlasMatrixView<Field> diagonal_block =
+          diagonal_factor_->blocks[supernode];
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      const Int supernode_start = ordering_->supernode_offsets[supernode];
+      for (Int j = 0; j < num_rhs; ++j) {
+        for (Int i = 0; i < supernode_size; ++i) {
+          right_hand_sides->Entry(supernode_start + i, j) /=
+              diagonal_block(i, i);
+        }
+      }
+    }
+  }
+
+  if (needs_permutation) {
+    Permute(ordering_->inverse_permutation, right_hand_sides);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::PartialBackwardSolve(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const Int interface_supernode = InterfaceSupernode();
+  const bool needs_permutation = !ordering_->permutation.Empty();
+  if (needs_permutation) {
+    Permute(ordering_->permutation, right_hand_sides);
+  }
+
+  // The interface rows already hold their solution, which the interior
+  // subtrees read through their subdiagonal blocks.
+  Buffer<Field> packed_input_buf(max_degree_ * right_hand_sides->width);
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  for (Int root_index = 0; root_index < Int(forest.roots.Size());
+       ++root_index) {
+    const Int root = forest.roots[root_index];
+    if (root != interface_supernode) {
+      LowerTransposeTriangularSolveRecursion(root, right_hand_sides,
+                                             &packed_input_buf);
+      continue;
+    }
+    for (Int index = forest.child_offsets[root];
+         index < forest.child_offsets[root + 1]; ++index) {
+      LowerTransposeTriangularSolveRecursion(
+          forest.children[index], right_hand_sides, &packed_input_buf);
+    }
+  }
+
+  if (needs_permutation) {
+    Permute(ordering_->inverse_permutation, right_hand_sides);
+  }
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_PARTIAL_IMPL_H_
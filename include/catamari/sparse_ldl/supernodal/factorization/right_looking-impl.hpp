@@ -14,6 +14,7 @@
 #include "catamari/dense_factorizations.hpp"
 #include "catamari/io_utils.hpp"
 #include "catamari/norms.hpp"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 
@@ -46,7 +47,7 @@ bool Factorization<Field>::RightLookingSupernodeFinalize(
 #endif
 
   CATAMARI_START_TIMER(profile.merge);
-  MergeChildSchurComplements(supernode, ordering_, lower_factor_.get(),
+  MergeChildSchurComplements(supernode, *ordering_, lower_factor_.get(),
                              diagonal_factor_.get(), shared_state);
   CATAMARI_STOP_TIMER(profile.merge);
 
@@ -70,6 +71,7 @@ bool Factorization<Field>::RightLookingSupernodeFinalize(
   if (num_supernode_pivots < supernode_size) {
     return false;
   }
+  CountPivotSigns(diagonal_block.ToConst(), result);
   IncorporateSupernodeIntoLDLResult(supernode_size, degree, result);
 
   if (!degree) {
@@ -98,16 +100,18 @@ bool Factorization<Field>::RightLookingSupernodeFinalize(
     LowerNormalHermitianOuterProductDynamicBLASDispatch(Real{-1}, lower_block.ToConst(), Real{1},
                                                         &schur_complement);
   } else {
-    BlasMatrixView<Field> scaled_transpose;
-    scaled_transpose.height = supernode_size;
-    scaled_transpose.width = degree;
-    scaled_transpose.leading_dim = supernode_size;
-    scaled_transpose.data = private_state->scaled_transpose_buffer.Data();
-    FormScaledTranspose(control_.factorization_type, diagonal_block.ToConst(),
-                        lower_block.ToConst(), &scaled_transpose);
-    MatrixMultiplyLowerNormalNormal(Field{-1}, lower_block.ToConst(),
-                                    scaled_transpose.ToConst(), Field{1},
-                                    &schur_complement);
+    const Int buffer_size =
+        std::min(control_.outer_product_tile_size, degree) * supernode_size;
+    Buffer<Field>& scaled_transpose_buffer =
+        private_state->scaled_transpose_buffer;
+    if (scaled_transpose_buffer.Size() < buffer_size) {
+      scaled_transpose_buffer.Resize(buffer_size);
+    }
+    LowerScaledOuterProduct(control_.outer_product_tile_size,
+                            control_.factorization_type,
+                            diagonal_block.ToConst(), lower_block.ToConst(),
+                            Field{1}, scaled_transpose_buffer.Data(),
+                            &schur_complement);
   }
   CATAMARI_STOP_TIMER(profile.herk);
 #ifdef CATAMARI_ENABLE_TIMERS
@@ -124,8 +128,8 @@ bool Factorization<Field>::RightLookingSubtree(
     RightLookingSharedState<Field>* shared_state,
     PrivateState<Field>* private_state, SparseLDLResult<Field>* result) {
   // assert(false);
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
 
   CATAMARI_START_TIMER(shared_state->inclusive_timers[supernode]);
@@ -139,13 +143,13 @@ bool Factorization<Field>::RightLookingSubtree(
   bool succeeded = true;
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
-        ordering_.assembly_forest.children[child_beg + child_index];
-    CATAMARI_ASSERT(ordering_.assembly_forest.parents[child] == supernode,
+        ordering_->assembly_forest.children[child_beg + child_index];
+    CATAMARI_ASSERT(ordering_->assembly_forest.parents[child] == supernode,
                     "Incorrect child index");
     SparseLDLResult<Field>& result_contribution =
         result_contributions[child_index];
 
-    subparams.offset = ordering_.supernode_offsets[child];
+    subparams.offset = ordering_->supernode_offsets[child];
     bool success =
         RightLookingSubtree(child, matrix, subparams, shared_state,
                             private_state, &result_contribution);
@@ -170,7 +174,7 @@ bool Factorization<Field>::RightLookingSubtree(
 #if ALLOCATE_SCHUR_COMPLEMENT_OTF
   // Clear the child fronts.
   for (Int child_index = 0; child_index < num_children; ++child_index) {
-    const Int child = ordering_.assembly_forest.children[child_beg + child_index];
+    const Int child = ordering_->assembly_forest.children[child_beg + child_index];
     Buffer<Field>& child_schur_complement_buffer = shared_state->schur_complement_buffers[child];
     BlasMatrixView<Field>& child_schur_complement = shared_state->schur_complements[child];
     child_schur_complement.height = 0;
@@ -192,13 +196,15 @@ template <class Field>
 SparseLDLResult<Field> Factorization<Field>::RightLooking(
     const CoordinateMatrix<Field>& matrix) {
   typedef ComplexBase<Field> Real;
+  if (UseDelayedPivoting()) return DelayedPivotingFactorization(matrix);
+  ExpandCompressedFactor();
 
   const Int max_threads = get_max_num_tbb_threads();
   if (true || (max_threads > 1)) { // the tbb implementation is even faster in the single-threaded case...
     return OpenMPRightLooking(matrix);
   }
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Int num_roots = ordering_->assembly_forest.roots.Size();
 
   RightLookingSharedState<Field> &shared_state = shared_state_;
   if (shared_state.schur_complements.Size() != num_supernodes) {
@@ -207,7 +213,7 @@ SparseLDLResult<Field> Factorization<Field>::RightLooking(
       shared_state.schur_complement_buffers.Resize(num_supernodes);
 #else
       {
-          BENCHMARK_SCOPED_TIMER_SECTION atimer("Allocate buffers");
+          TraceScope trace_scope("Allocate buffers");
 
           Int total_size = 0;
           for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
@@ -242,19 +248,9 @@ SparseLDLResult<Field> Factorization<Field>::RightLooking(
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
   PrivateState<Field> private_state;
-  if (control_.factorization_type != kCholeskyFactorization) {
-    private_state.scaled_transpose_buffer.Resize(max_lower_block_size_);
-  }
-
-  // Allocate the map from child structures to parent fronts.
-  auto &ncdi = ordering_.assembly_forest.num_child_diag_indices;
-  auto &cri =  ordering_.assembly_forest.child_rel_indices;
-  if ( cri.Size() != num_supernodes) {
-      cri.Resize(num_supernodes);
-      ncdi.Resize(num_supernodes);
-  }
 
   SparseLDLResult<Field> result;
+  IncorporateRelaxationIntoLDLResult(&result);
 
   Buffer<SparseLDLResult<Field>> result_contributions(num_roots);
 
@@ -268,22 +264,27 @@ SparseLDLResult<Field> Factorization<Field>::RightLooking(
   dynamic_reg_params.negative_threshold = std::pow(
       kEpsilon, control_.dynamic_regularization.negative_threshold_exponent);
   if (control_.dynamic_regularization.relative) {
-    const Real matrix_max_norm = MaxNorm(matrix);
+    const Real matrix_max_norm = InputMaxNorm(matrix);
     dynamic_reg_params.positive_threshold *= matrix_max_norm;
     dynamic_reg_params.negative_threshold *= matrix_max_norm;
   }
   dynamic_reg_params.signatures = &control_.dynamic_regularization.signatures;
-  dynamic_reg_params.inverse_permutation = ordering_.inverse_permutation.Empty()
+  dynamic_reg_params.inverse_permutation = ordering_->inverse_permutation.Empty()
                                                ? nullptr
-                                               : &ordering_.inverse_permutation;
+                                               : &ordering_->inverse_permutation;
+  if (dynamic_reg_params.enabled &&
+      control_.dynamic_regularization.diagonal_output) {
+    result.dynamic_regularization_diagonal.Resize(NumRows(), Real(0));
+    dynamic_reg_params.diagonal = result.dynamic_regularization_diagonal.Data();
+  }
 
   // Factor the children.
   bool succeeded = true;
   for (Int root_index = 0; root_index < num_roots; ++root_index) {
-    const Int root = ordering_.assembly_forest.roots[root_index];
+    const Int root = ordering_->assembly_forest.roots[root_index];
     SparseLDLResult<Field>& result_contribution =
         result_contributions[root_index];
-    dynamic_reg_params.offset = ordering_.supernode_offsets[root];
+    dynamic_reg_params.offset = ordering_->supernode_offsets[root];
     bool success =
         RightLookingSubtree(root, matrix, dynamic_reg_params, &shared_state,
                             &private_state, &result_contribution);
@@ -295,15 +296,16 @@ SparseLDLResult<Field> Factorization<Field>::RightLooking(
   if (succeeded && dynamic_reg_params.enabled) {
     MergeDynamicRegularizations(result_contributions, &result);
   }
+  if (succeeded) FinishFactorization(&result);
 
 #ifdef CATAMARI_ENABLE_TIMERS
   TruncatedForestTimersToDot(
       control_.inclusive_timings_filename, shared_state.inclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
   TruncatedForestTimersToDot(
       control_.exclusive_timings_filename, shared_state.exclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
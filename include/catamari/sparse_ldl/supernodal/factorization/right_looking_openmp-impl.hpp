@@ -9,14 +9,23 @@
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_RIGHT_LOOKING_OPENMP_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dense_factorizations.hpp"
 #include "catamari/io_utils.hpp"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 
-#include "../../../../../../../src/lib/MeshFEM/GlobalBenchmark.hh"
 #include "../../../../../../../src/lib/MeshFEM/ParallelVectorOps.hh"
 #include "SchurComplementStorage.hpp"
 
@@ -25,58 +34,256 @@
 namespace catamari {
 namespace supernodal_ldl {
 
+template <class Field>
+bool Factorization<Field>::UseTiledFront(Int supernode) const {
+  const Int degree = lower_factor_->blocks[supernode].height;
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const double front_work = std::pow(1. * supernode_size, 3.) / 3 +
+                            std::pow(1. * degree, 2.) * supernode_size;
+  return !control_.supernodal_pivoting && control_.min_tiled_front_work > 0 &&
+         front_work >= control_.min_tiled_front_work &&
+         get_max_num_tbb_threads() > 1;
+}
+
+template <class Field>
+bool Factorization<Field>::TaskParallelSubtree(
+    Int supernode, const Buffer<double>& work_estimates,
+    double min_parallel_work) const {
+  if (work_estimates[supernode] < min_parallel_work) return false;
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int child_beg = forest.child_offsets[supernode];
+  const Int num_children = forest.child_offsets[supernode + 1] - child_beg;
+  if (num_children > 1) return true;
+  return num_children == 1 && control_.split_heavy_chains &&
+         work_estimates[forest.children[child_beg]] >= min_parallel_work;
+}
+
+template <class Field>
+bool Factorization<Field>::UseDeviceFront(Int supernode) const {
+  if (control_.supernodal_pivoting || !device_offload_.Active()) return false;
+  const Int degree = lower_factor_->blocks[supernode].height;
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const double front_work = std::pow(1. * supernode_size, 3.) / 3 +
+                            std::pow(1. * degree, 2.) * supernode_size;
+  return device_offload_.UseFront(front_work);
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPBatchFactorLeaves(
+    Int root, const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    RightLookingSharedState<Field>* shared_state,
+    RightLookingPrivateStates<Field>* private_states) {
+  // The number of fronts interleaved into a single batch is capped so that
+  // the interleaved copy of a batch remains cache-resident.
+  static constexpr Int kMaxLeafBatchSize = 64;
+
+  if (control_.min_leaf_batch_size <= 0 || control_.supernodal_pivoting ||
+      dynamic_reg_params.enabled) {
+    return;
+  }
+  const AssemblyForest& forest = ordering_->assembly_forest;
+
+  // Gather the small leaves of the subtree, then group them by shape.
+  std::vector<Int> leaves;
+  std::vector<Int> stack(1, root);
+  while (!stack.empty()) {
+    const Int supernode = stack.back();
+    stack.pop_back();
+    if (forest.NumChildren(supernode)) {
+      for (Int index = forest.child_offsets[supernode];
+           index < forest.child_offsets[supernode + 1]; ++index) {
+        stack.push_back(forest.children[index]);
+      }
+    } else if (ordering_->supernode_sizes[supernode] <= kMaxSmallKernelSize &&
+               supernode != InterfaceSupernode() && !UseTiledFront(supernode)) {
+      leaves.push_back(supernode);
+    }
+  }
+  if (Int(leaves.size()) < control_.min_leaf_batch_size) return;
+  auto shape = [&](Int supernode) {
+    return std::make_pair(ordering_->supernode_sizes[supernode],
+                          lower_factor_->blocks[supernode].height);
+  };
+  std::stable_sort(leaves.begin(), leaves.end(), [&](Int a, Int b) {
+    return shape(a) < shape(b);
+  });
+
+  RightLookingPrivateState<Field>& private_state = private_states->local();
+  for (std::size_t group_beg = 0; group_beg < leaves.size();) {
+    std::size_t group_end = group_beg + 1;
+    while (group_end < leaves.size() &&
+           shape(leaves[group_end]) == shape(leaves[group_beg])) {
+      ++group_end;
+    }
+    const Int supernode_size = shape(leaves[group_beg]).first;
+    const Int height = supernode_size + shape(leaves[group_beg]).second;
+    if (Int(group_end - group_beg) < control_.min_leaf_batch_size) {
+      group_beg = group_end;
+      continue;
+    }
+
+    for (std::size_t batch_beg = group_beg; batch_beg < group_end;
+         batch_beg += kMaxLeafBatchSize) {
+      if (shared_state->hasFailed()) return;
+      const Int batch_size =
+          std::min<Int>(kMaxLeafBatchSize, group_end - batch_beg);
+      Field* fronts =
+          private_state.WorkspaceBuffer(height * supernode_size * batch_size);
+
+      // Load the matrix entries of each front and interleave them.
+      for (Int b = 0; b < batch_size; ++b) {
+        const Int supernode = leaves[batch_beg + b];
+        BlasMatrixView<Field> diagonal_block =
+            diagonal_factor_->blocks[supernode];
+        const Int supernode_offset = ordering_->supernode_offsets[supernode];
+        for (Int j = 0; j < supernode_size; ++j) {
+          InitializeFactorColumn(supernode_offset + j, j, diagonal_block);
+          const Field* column = diagonal_block.Pointer(0, j);
+          for (Int i = j; i < height; ++i) {
+            fronts[(i + j * height) * batch_size + b] = column[i];
+          }
+        }
+      }
+
+      // A batch containing an unacceptable pivot is discarded so that its
+      // supernodes are refactored (and report their failure) individually.
+      if (!InterleavedFactorFronts(control_.factorization_type, height,
+                                   supernode_size, batch_size, fronts)) {
+        continue;
+      }
+
+      for (Int b = 0; b < batch_size; ++b) {
+        const Int supernode = leaves[batch_beg + b];
+        BlasMatrixView<Field> diagonal_block =
+            diagonal_factor_->blocks[supernode];
+        for (Int j = 0; j < supernode_size; ++j) {
+          Field* column = diagonal_block.Pointer(0, j);
+          for (Int i = j; i < height; ++i) {
+            column[i] = fronts[(i + j * height) * batch_size + b];
+          }
+        }
+        shared_state->batch_factored[supernode] = true;
+      }
+    }
+    group_beg = group_end;
+  }
+}
+
 template <class Field>
 bool Factorization<Field>::OpenMPRightLookingSupernodeFinalize(
     Int supernode, const DynamicRegularizationParams<Field>& dynamic_reg_params,
     RightLookingSharedState<Field>* shared_state,
-    Buffer<PrivateState<Field>>* private_states,
+    RightLookingPrivateStates<Field>* private_states,
     SparseLDLResult<Field>* result) {
+  TraceScope trace_scope("factor", supernode);
   typedef ComplexBase<Field> Real;
   BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
   BlasMatrixView<Field> lower_block = lower_factor_->blocks[supernode];
   const Int degree = lower_block.height;
   const Int supernode_size = lower_block.width;
-  const bool has_children = ordering_.assembly_forest.child_offsets[supernode + 1] > ordering_.assembly_forest.child_offsets[supernode];
+  const bool has_children = ordering_->assembly_forest.child_offsets[supernode + 1] > ordering_->assembly_forest.child_offsets[supernode];
+
+  // Leaves factored within an interleaved batch already hold their diagonal
+  // block factors and solved subdiagonal blocks.
+  const bool batch_factored = shared_state->batch_factored[supernode];
+  shared_state->batch_factored[supernode] = false;
+
+  // A packed Schur complement (see `Control::schur_complement_panel_width`)
+  // is formed a panel at a time on the host.
+  PackedLowerMatrixView<Field>& packed_schur_complement =
+      shared_state->packed_schur_complements[supernode];
+  const bool packed = packed_schur_complement.data != nullptr;
+
+  // The largest fronts are offloaded to the device, whose uploads of the
+  // subdiagonal block and Schur complement overlap with the factorization of
+  // the diagonal block on the host.
+  DeviceFront<Field> device_front;
+  const bool offloaded_front =
+      !batch_factored && !packed && degree && UseDeviceFront(supernode) &&
+      device_offload_.BeginFront(
+          lower_block.ToConst(),
+          shared_state->schur_complements[supernode].ToConst(), has_children,
+          &device_front);
+
+  // Large fronts are factored and applied as tile tasks so that the threads
+  // which have finished the sibling subtrees can help.
+  const bool tiled_front =
+      !batch_factored && !packed && !offloaded_front &&
+      UseTiledFront(supernode);
+
+  // The analytic operation counts of the phases attributed to the hardware
+  // counters. A tiled front also forms its subdiagonal block and Schur
+  // complement within its factorization.
+  const double diagonal_flops CATAMARI_UNUSED =
+      std::pow(1. * supernode_size, 3.) / 3.;
+  const double trsm_flops CATAMARI_UNUSED =
+      std::pow(1. * supernode_size, 2.) * degree;
+  const double herk_flops CATAMARI_UNUSED =
+      std::pow(1. * degree, 2.) * supernode_size;
 
   Int num_supernode_pivots;
-  if (control_.supernodal_pivoting) {
+  if (batch_factored) {
+    num_supernode_pivots = supernode_size;
+    result->num_successful_pivots += num_supernode_pivots;
+  } else if (tiled_front) {
+    CATAMARI_COUNT_PHASE(supernode_counters[supernode], kFactorCounterPhase,
+                         diagonal_flops + trsm_flops + herk_flops);
+    num_supernode_pivots = TiledFactorFront(
+        control_.factor_tile_size, control_.outer_product_tile_size,
+        control_.block_size, control_.factorization_type, dynamic_reg_params,
+        !has_children, &diagonal_block, &lower_block,
+        &shared_state->schur_complements[supernode],
+        &result->dynamic_regularization);
+    result->num_successful_pivots += num_supernode_pivots;
+  } else if (control_.supernodal_pivoting) {
     // TODO(Jack Poulson): Add support for OpenMP supernodal pivoting.
+    CATAMARI_COUNT_PHASE(supernode_counters[supernode], kFactorCounterPhase,
+                         diagonal_flops);
     BlasMatrixView<Int> permutation = SupernodePermutation(supernode);
     num_supernode_pivots = PivotedFactorDiagonalBlock(
         control_.block_size, control_.factorization_type, &diagonal_block,
         &permutation);
     result->num_successful_pivots += num_supernode_pivots;
   } else {
+    CATAMARI_COUNT_PHASE(supernode_counters[supernode], kFactorCounterPhase,
+                         diagonal_flops);
 #if FINEGRAINED_PARALLELISM
     // TODO(Jack Poulson): Preallocate this buffer.
     Buffer<Field> multithreaded_buffer;
-    // Buffer is not for Cholesky...
-    if (control_.factorization_type != kCholeskyFactorization)
-        multithreaded_buffer.Resize(supernode_size * supernode_size);
-#endif
-    {
-#if FINEGRAINED_PARALLELISM
-      #pragma omp taskgroup
-      num_supernode_pivots = OpenMPFactorDiagonalBlock(
-          control_.factor_tile_size, control_.block_size,
-          control_.factorization_type, dynamic_reg_params, &diagonal_block,
-          &multithreaded_buffer, &result->dynamic_regularization);
+    num_supernode_pivots = TiledFactorDiagonalBlock(
+        control_.factor_tile_size, control_.block_size,
+        control_.factorization_type, dynamic_reg_params, &diagonal_block,
+        &multithreaded_buffer, &result->dynamic_regularization);
 #else
-      num_supernode_pivots = FactorDiagonalBlock(
-          control_.block_size,
-          control_.factorization_type, dynamic_reg_params, &diagonal_block,
-          &result->dynamic_regularization);
+    num_supernode_pivots = FactorDiagonalBlock(
+        control_.block_size, control_.factorization_type, dynamic_reg_params,
+        &diagonal_block, &result->dynamic_regularization);
 #endif
-      result->num_successful_pivots += num_supernode_pivots;
-
-    }
+    result->num_successful_pivots += num_supernode_pivots;
   }
   if (num_supernode_pivots < supernode_size) {
     return false;
   }
+
+  // Abort the entire factorization as soon as the expected inertia cannot be
+  // matched.
+  const std::pair<Int, Int> pivot_signs =
+      CountPivotSigns(diagonal_block.ToConst(), result);
+  if (HaveExpectedInertia()) {
+    const Int num_positive =
+        shared_state->num_positive_pivots.fetch_add(pivot_signs.first) +
+        pivot_signs.first;
+    const Int num_negative =
+        shared_state->num_negative_pivots.fetch_add(pivot_signs.second) +
+        pivot_signs.second;
+    if (!InertiaAttainable(num_positive, num_negative)) {
+      shared_state->setFailed();
+      return false;
+    }
+  }
   IncorporateSupernodeIntoLDLResult(supernode_size, degree, result);
 
-  if (!degree) {
+  if (!degree || tiled_front) {
     // We can early exit.
     return true;
   }
@@ -92,9 +299,21 @@ bool Factorization<Field>::OpenMPRightLookingSupernodeFinalize(
     InversePermuteColumns(permutation, &lower_block);
   }
 
+  if (offloaded_front &&
+      device_offload_.FinishFront(
+          supernode, control_.factorization_type, diagonal_block.ToConst(),
+          &device_front, &lower_block,
+          &shared_state->schur_complements[supernode])) {
+    return true;
+  }
+
 #if 1
-  SolveAgainstDiagonalBlock(control_.factorization_type,
-                            diagonal_block.ToConst(), &lower_block);
+  if (!batch_factored) {
+    CATAMARI_COUNT_PHASE(supernode_counters[supernode], kTrsmCounterPhase,
+                         trsm_flops);
+    SolveAgainstDiagonalBlock(control_.factorization_type,
+                              diagonal_block.ToConst(), &lower_block);
+  }
 #else
   // TODO: try constructing and using the *transpose* of `lower_block`;
   // this seems like it would be more efficient (e.g., it lends itself to
@@ -121,7 +340,26 @@ bool Factorization<Field>::OpenMPRightLookingSupernodeFinalize(
 
   if (shared_state->hasFailed()) return false; // Stop immediately if another thread encountered a failure!
 
-  if (control_.factorization_type == kCholeskyFactorization) {
+  CATAMARI_COUNT_PHASE(supernode_counters[supernode], kHerkCounterPhase,
+                       herk_flops);
+  // The Schur complement of a leaf is pushed onto a reused stack without
+  // being zeroed, so it must be overwritten (beta = 0) rather than updated.
+  if (packed) {
+    if (control_.factorization_type == kCholeskyFactorization) {
+      PackedLowerNormalHermitianOuterProduct(
+          Real{-1}, lower_block.ToConst(), has_children ? Real{1} : Real{0},
+          &packed_schur_complement);
+    } else {
+      RightLookingPrivateState<Field>& private_state = private_states->local();
+      Field* buffer = private_state.ScaledTransposeBuffer(
+          std::min(packed_schur_complement.panel_width, degree) *
+          supernode_size);
+      PackedLowerScaledOuterProduct(
+          control_.factorization_type, diagonal_block.ToConst(),
+          lower_block.ToConst(), has_children ? Field{1} : Field{0}, buffer,
+          &packed_schur_complement);
+    }
+  } else if (control_.factorization_type == kCholeskyFactorization) {
     BlasMatrixView<Field>& schur_complement = shared_state->schur_complements[supernode];
 #if 1
     LowerNormalHermitianOuterProductDynamicBLASDispatch(
@@ -133,42 +371,22 @@ bool Factorization<Field>::OpenMPRightLookingSupernodeFinalize(
                                      has_children ? Real{1} : Real{0}, &schur_complement);
 #endif
   } else {
-    const int thread = tbb::this_task_arena::current_thread_index(); // TODO(Julian Panetta): switch to thread-local storage
-    PrivateState<Field> &private_state = (*private_states)[thread];
-    BlasMatrixView<Field> scaled_transpose;
-    scaled_transpose.height = supernode_size;
-    scaled_transpose.width = degree;
-    scaled_transpose.leading_dim = supernode_size;
-    scaled_transpose.data = private_state.scaled_transpose_buffer.Data();
-
-#if 0 // These parallelizations don't seem to make a huge difference
-    #pragma omp taskgroup
-    OpenMPFormScaledTranspose(
-        control_.outer_product_tile_size, control_.factorization_type,
-        diagonal_block.ToConst(), lower_block.ToConst(), &scaled_transpose);
-#else
-    FormScaledTranspose(
-        control_.factorization_type,
-        diagonal_block.ToConst(), lower_block.ToConst(), &scaled_transpose);
-#endif
+    RightLookingPrivateState<Field> &private_state = private_states->local();
+    const Int tile_size = control_.outer_product_tile_size;
+    Field* buffer = private_state.ScaledTransposeBuffer(
+        std::min(tile_size, degree) * supernode_size);
     BlasMatrixView<Field>& schur_complement = shared_state->schur_complements[supernode];
-
-#if 0 // These parallelizations don't seem to make a huge difference
-    // Note: does its own #paragma omp taskgroup...
-    OpenMPMatrixMultiplyLowerNormalNormal(
-        control_.outer_product_tile_size, Field{-1}, lower_block.ToConst(),
-        scaled_transpose.ToConst(), Field{1}, &schur_complement);
-#else
-    MatrixMultiplyLowerNormalNormal(
-        Field{-1}, lower_block.ToConst(),
-        scaled_transpose.ToConst(), Field{1}, &schur_complement);
-#endif
+    LowerScaledOuterProduct(
+        tile_size, control_.factorization_type, diagonal_block.ToConst(),
+        lower_block.ToConst(), has_children ? Field{1} : Field{0}, buffer,
+        &schur_complement);
   }
 
   return true;
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void MergeChildSchurComplement(Int supernode, Int child,
                                const SymmetricOrdering& ordering,
                                const LowerFactor<Field> *lower_factor,
@@ -178,18 +396,36 @@ void MergeChildSchurComplement(Int supernode, Int child,
                                BlasMatrixView<Field> schur_complement,
                                Factorization<Field> &ldl,
                                bool first_merge) {
+    TraceScope trace_scope("merge", supernode);
     const Int child_degree = child_schur_complement.height;
+    CATAMARI_COUNT_PHASE(ldl.supernode_counters[supernode], kMergeCounterPhase,
+                         0.5 * child_degree * (child_degree + 1));
     const Int sno = ordering.supernode_offsets[supernode];
-    populateChildToParentMap(supernode, child, child_degree, ordering, lower_factor);
 
     // Number of child rows/cols that map to the parent's diagonal block.
-    const Int num_child_diag_indices = ordering.assembly_forest.num_child_diag_indices[child];
+    const Int num_child_diag_indices = ordering.assembly_forest.NumChildDiagIndices(child);
 
     // Locations of child's rows/cols relative to the parent front's upper-left corner
-    const Buffer<Int> &child_rel_indices = ordering.assembly_forest.child_rel_indices[child];
+    const LocalInt *child_rel_indices = ordering.assembly_forest.ChildRelativeIndicesBeg(child);
 
     const Int supernode_size = ordering.supernode_sizes[supernode];
 
+    // Children with a precomputed merge plan are added once the front has
+    // been initialized (unless it is to be written once).
+    if (HasMergePlan(ordering.assembly_forest, child) &&
+        !(first_merge && ldl.WriteOnceAssembly())) {
+        if (first_merge) {
+            for (Int j = 0; j < supernode_size; ++j)
+                ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
+            eigenMap(schur_complement).setZero();
+        }
+        PlannedMergeChildSchurComplement(
+            ordering.assembly_forest, child, supernode_size,
+            child_schur_complement.ToConst(), diagonal_block,
+            schur_complement);
+        return;
+    }
+
     if (first_merge) {
         // Initialize each of the supernode's columns of the factor
         // and merge in the first child's Schur complement.
@@ -197,15 +433,33 @@ void MergeChildSchurComplement(Int supernode, Int child,
             ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
             Field* factor_column = diagonal_block.Pointer(0, j);
 
-            if (cj >= child_rel_indices.Size() || child_rel_indices[cj] != j) continue;
+            if (cj >= child_degree || child_rel_indices[cj] != j) continue;
 
             const Field* child_column = child_schur_complement.Pointer(0, cj);
             factor_column[j] += child_column[cj]; // diagonal entry
-            for (Int i = cj + 1; i < child_degree; ++i)
-                factor_column[child_rel_indices[i]] += child_column[i];
+            AddChildColumn(ordering.assembly_forest, child, child_degree,
+                           cj + 1, child_column, factor_column);
             ++cj;
         }
 
+        const Int sc_size = schur_complement.width;
+        if (ldl.WriteOnceAssembly()) {
+            // Overwrite each column of the bottom-right block of the front,
+            // with zeros wherever the child does not contribute.
+            const Int front_size = supernode_size + sc_size;
+            for (Int j = 0, cj = num_child_diag_indices; j < sc_size; ++j) {
+                const Int front_j = j + supernode_size;
+                Field *schur_column = schur_complement.Pointer(-supernode_size, j);
+                if (cj < child_degree && child_rel_indices[cj] == front_j) {
+                    const Field* child_column = child_schur_complement.Pointer(0, cj);
+                    AssignChildColumn(ordering.assembly_forest, child, child_degree, cj,
+                                      child_column, supernode_size, front_size, schur_column);
+                    ++cj;
+                }
+                else std::fill(schur_column + supernode_size, schur_column + front_size, Field{0});
+            }
+            return;
+        }
 #if 1 // This version seems faster...
         eigenMap(schur_complement).setZero();
         for (Int j = num_child_diag_indices; j < child_degree; ++j) {
@@ -213,11 +467,10 @@ void MergeChildSchurComplement(Int supernode, Int child,
             // Get pointer to the (conceptual) full parent front column, of which schur_complement is the bottom part.
             // Note: parent front's upper-left corner is (-supernode_size, -supernode_size) relative to this block...
             Field* schur_column = schur_complement.Pointer(-supernode_size, child_rel_indices[j] - supernode_size);
-            for (Int i = j; i < child_degree; ++i)
-                schur_column[child_rel_indices[i]] = child_column[i];
+            CopyChildColumn(ordering.assembly_forest, child, child_degree, j,
+                            child_column, schur_column);
         }
 #else
-        const Int sc_size = schur_complement.width;
         // Clear and contribute into the bottom-right block of the front.
         for (Int j = 0, cj = num_child_diag_indices; j < sc_size; ++j) {
             Int front_j = j + supernode_size;
@@ -238,26 +491,161 @@ void MergeChildSchurComplement(Int supernode, Int child,
         for (Int j = 0; j < num_child_diag_indices; ++j) {
             const Field* child_column = child_schur_complement.Pointer(0, j);
             Field* factor_column = diagonal_block.Pointer(0, child_rel_indices[j]);
-            for (Int i = j; i < child_degree; ++i)
-                factor_column[child_rel_indices[i]] += child_column[i];
+            AddChildColumn(ordering.assembly_forest, child, child_degree, j,
+                           child_column, factor_column);
         }
 
         // Contribute into the bottom-right block of the front.
         for (Int j = num_child_diag_indices; j < child_degree; ++j) {
             const Field* child_column = child_schur_complement.Pointer(0, j);
             Field* schur_column = schur_complement.Pointer(-supernode_size, child_rel_indices[j] - supernode_size);
-            for (Int i = j; i < child_degree; ++i)
-                schur_column[child_rel_indices[i]] += child_column[i];
+            AddChildColumn(ordering.assembly_forest, child, child_degree, j,
+                           child_column, schur_column);
+        }
+    }
+}
+
+// Adds the packed Schur complement of `child` (see
+// `Control::schur_complement_panel_width`) into `supernode`'s front, whose
+// Schur complement is either packed as well or a full square viewed through
+// `PackedLowerMatrixView::FromSquare`. The front is first initialized if this
+// is the first merge. Only the lower triangles are read and written, and each
+// child column is addressed exactly as that of a full square would be.
+template <class Field>
+void MergePackedChildSchurComplement(Int supernode, Int child,
+                                     const SymmetricOrdering& ordering,
+                                     const PackedLowerMatrixView<Field> &child_schur_complement,
+                                     BlasMatrixView<Field> diagonal_block,
+                                     const PackedLowerMatrixView<Field> &schur_complement,
+                                     Factorization<Field> &ldl,
+                                     bool first_merge) {
+    TraceScope trace_scope("merge", supernode);
+    const Int child_degree = child_schur_complement.size;
+    CATAMARI_COUNT_PHASE(ldl.supernode_counters[supernode], kMergeCounterPhase,
+                         0.5 * child_degree * (child_degree + 1));
+    const Int sno = ordering.supernode_offsets[supernode];
+    const Int supernode_size = ordering.supernode_sizes[supernode];
+
+    const Int num_child_diag_indices = ordering.assembly_forest.NumChildDiagIndices(child);
+    const LocalInt *child_rel_indices = ordering.assembly_forest.ChildRelativeIndicesBeg(child);
+
+    if (first_merge) {
+        for (Int j = 0; j < supernode_size; ++j)
+            ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
+        schur_complement.SetZero();
+    }
+
+    // Add the child columns which map into the diagonal block.
+    for (Int j = 0; j < num_child_diag_indices; ++j) {
+        const Field* child_column = child_schur_complement.ColumnPointer(j);
+        Field* factor_column = diagonal_block.Pointer(0, child_rel_indices[j]);
+        AddChildColumn(ordering.assembly_forest, child, child_degree, j,
+                       child_column, factor_column);
+    }
+
+    // Contribute into the bottom-right block of the front.
+    for (Int j = num_child_diag_indices; j < child_degree; ++j) {
+        const Field* child_column = child_schur_complement.ColumnPointer(j);
+        Field* schur_column = schur_complement.ColumnPointer(child_rel_indices[j] - supernode_size) - supernode_size;
+        AddChildColumn(ordering.assembly_forest, child, child_degree, j,
+                       child_column, schur_column);
+    }
+}
+
+// Merges the Schur complement of `supernode`'s first child, which must be
+// the only matrix on `stack` above `supernode`'s own position, into the
+// supernode's front. The supernode's Schur complement is allocated by growing
+// the child's Schur complement in place, so the two never coexist.
+template <class Field>
+void ExpandChildSchurComplementInPlace(Int supernode, Int child,
+                                       const SymmetricOrdering& ordering,
+                                       const LowerFactor<Field> *lower_factor,
+                                       BlasMatrixView<Field> &child_schur_complement,
+                                       BlasMatrixView<Field> diagonal_block,
+                                       BlasMatrixView<Field> &schur_complement,
+                                       SchurComplementStorage<Field> *stack,
+                                       Factorization<Field> &ldl) {
+    TraceScope trace_scope("merge", supernode);
+    const Int child_degree = child_schur_complement.height;
+    CATAMARI_COUNT_PHASE(ldl.supernode_counters[supernode], kMergeCounterPhase,
+                         0.5 * child_degree * (child_degree + 1));
+    const Int sno = ordering.supernode_offsets[supernode];
+    const Int supernode_size = ordering.supernode_sizes[supernode];
+    const Int degree = lower_factor->blocks[supernode].height;
+
+    const Int num_child_diag_indices = ordering.assembly_forest.NumChildDiagIndices(child);
+    const LocalInt *child_rel_indices = ordering.assembly_forest.ChildRelativeIndicesBeg(child);
+
+    // Initialize each of the supernode's columns of the factor and merge in
+    // the child's columns that map into the diagonal block. These live outside
+    // the stack, so they are unaffected by the in-place expansion.
+    for (Int j = 0, cj = 0; j < supernode_size; ++j) {
+        ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
+        Field* factor_column = diagonal_block.Pointer(0, j);
+
+        if (cj >= child_degree || child_rel_indices[cj] != j) continue;
+
+        const Field* child_column = child_schur_complement.Pointer(0, cj);
+        factor_column[j] += child_column[cj]; // diagonal entry
+        AddChildColumn(ordering.assembly_forest, child, child_degree, cj + 1,
+                       child_column, factor_column);
+        ++cj;
+    }
+
+    // Pack the lower triangle of the remaining bottom-right block of the child
+    // Schur complement at the start of its storage. Every destination precedes
+    // its source, so a forward sweep never overwrites unread entries.
+    Field *data = child_schur_complement.data;
+    const Int packed_degree = child_degree - num_child_diag_indices;
+    if (num_child_diag_indices > 0) {
+        for (Int j = 0; j < packed_degree; ++j) {
+            const Field *src = child_schur_complement.Pointer(num_child_diag_indices + j, num_child_diag_indices + j);
+            std::copy(src, src + (packed_degree - j), data + j * packed_degree + j);
+        }
+    }
+
+    // Grow the child's storage into the supernode's Schur complement.
+    stack->free(child_schur_complement);
+    schur_complement = stack->push(degree);
+    CATAMARI_ASSERT(schur_complement.data == data, "Expand-in-place requires the child to be on top of the stack");
+
+    // Scatter the packed child entries into the supernode's Schur complement
+    // (zeroing all other entries), sweeping backward through the columns and
+    // rows. Since (front) relative indices are increasing and
+    // `degree >= packed_degree`, each entry's destination is at or after its
+    // source, and all not-yet-read entries precede the current position.
+    const LocalInt *rel = child_rel_indices + num_child_diag_indices;
+    Int cj = packed_degree - 1;
+    for (Int j = degree - 1; j >= 0; --j) {
+        Field *schur_column = schur_complement.Pointer(0, j);
+        Int i = degree - 1;
+        if (cj >= 0 && rel[cj] - supernode_size == j) {
+            const Field *child_column = data + cj * packed_degree;
+            for (Int ci = packed_degree - 1; ci >= cj; --ci) {
+                const Int target = rel[ci] - supernode_size;
+                for (; i > target; --i) schur_column[i] = Field{0};
+                schur_column[i--] = child_column[ci];
+            }
+            --cj;
         }
+        for (; i >= 0; --i) schur_column[i] = Field{0};
     }
 }
 
+// Adds the Schur complements of all of `supernode`'s children into its front.
+// The front's columns (those of the diagonal block followed by those of the
+// Schur complement) are split into ranges of `merge_grain_size` columns that
+// are assembled in parallel. Each thread only writes to the columns of its
+// range, and locates the first child column mapping into the range by a
+// binary search over the (increasing) `child_rel_indices`.
 template <class Field>
 void MergeChildSchurComplements(Int supernode, Factorization<Field> &ldl,
-                                const Buffer<BlasMatrixView<Field>> &schur_complements) {
+                                const Buffer<BlasMatrixView<Field>> &schur_complements,
+                                Int merge_grain_size) {
+    TraceScope trace_scope("merge", supernode);
     using VMap = Eigen::Map<Eigen::Matrix<Field, Eigen::Dynamic, 1>>;
 
-    const auto &o = ldl.ordering_;
+    const auto &o = *ldl.ordering_;
     const auto &af = o.assembly_forest;
     const Int child_beg = af.child_offsets[supernode];
     const Int child_end = af.child_offsets[supernode + 1];
@@ -265,84 +653,102 @@ void MergeChildSchurComplements(Int supernode, Factorization<Field> &ldl,
     const Int sno = o.supernode_offsets[supernode];
 
     // Output destination buffers
-    BlasMatrixView<Field> lower_block      = ldl.lower_factor_->blocks[supernode];
     BlasMatrixView<Field> diagonal_block   = ldl.diagonal_factor_->blocks[supernode];
     BlasMatrixView<Field> schur_complement = schur_complements[supernode];
 
-    for (Int child_index = child_beg; child_index < child_end; ++child_index) {
-        const Int child = af.children[child_index];
-        const Int child_degree = schur_complements[child].height;
-        populateChildToParentMap(supernode, child, child_degree, o, ldl.lower_factor_.get());
-    }
-
     const Int supernode_size = o.supernode_sizes[supernode];
-    std::vector<size_t> child_j(num_children); // pointer into the child columns
-    const Int factor_height = diagonal_block.Height() + lower_block.Height();
-
-    // tbb::parallel_for(tbb::blocked_range<catamari::Int>(0, supernode_size), [&](const tbb::blocked_range<catamari::Int> &r) {
-    //   for (Int j = r.begin(); j < r.end(); ++j) {
-
-    for (Int j = 0; j < supernode_size; ++j) {
-        ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
-        Field* factor_column = diagonal_block.Pointer(0, j);
+    const Int sc_size = schur_complement.width;
+    const Int front_size = supernode_size + sc_size;
+    const bool write_once = ldl.WriteOnceAssembly();
+
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+    double merge_flops = 0;
+    for (Int ci = 0; ci < num_children; ++ci) {
+        const Int child_degree = schur_complements[af.children[child_beg + ci]].height;
+        merge_flops += 0.5 * child_degree * (child_degree + 1);
+    }
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+    CATAMARI_COUNT_PHASE(ldl.supernode_counters[supernode], kMergeCounterPhase,
+                         merge_flops);
+
+    auto merge_columns = [&](Int front_beg, Int front_end) {
+        // Pointers into the child columns, starting from the first child
+        // column which maps into the range.
+        std::vector<Int> child_j(num_children);
         for (Int ci = 0; ci < num_children; ++ci) {
-            Int cj = child_j[ci];
-
             const Int child = af.children[child_beg + ci];
-            const Int num_child_diag_indices = af.num_child_diag_indices[child];
-            const Buffer<Int> &child_rel_indices = af.child_rel_indices[child];
-
-            // Note: if we merge columns in parallel, we cannot use the `cj` pointer
-            // and instead have to search for the current column `j` in child_rel_indices.
-            //      auto end = child_rel_indices.begin() + num_child_diag_indices;
-            //      auto it = std::find(child_rel_indices.begin(), end, j);
-            //      if (it == end) continue;
-            //      const Int cj = std::distance(child_rel_indices.begin(), it);
-            if (cj >= child_rel_indices.Size() || child_rel_indices[cj] != j) continue;
-
-            const BlasMatrixView<Field> &child_schur_complement = schur_complements[child];
-            const Int child_degree = child_schur_complement.height;
-            const Field* child_column = child_schur_complement.Pointer(0, cj);
-
-            factor_column[j] += child_column[cj]; // diagonal entry
-            for (Int i = cj + 1; i < child_degree; ++i)
-                factor_column[child_rel_indices[i]] += child_column[i];
-
-            child_j[ci] = ++cj;
+            const LocalInt *child_rel_indices = af.ChildRelativeIndicesBeg(child);
+            const Int child_degree = schur_complements[child].height;
+            child_j[ci] = std::lower_bound(child_rel_indices, child_rel_indices + child_degree, front_beg) - child_rel_indices;
         }
-    } // });
-
-    const Int sc_size = schur_complement.width;
-    // tbb::parallel_for(tbb::blocked_range<catamari::Int>(0, sc_size), [&](const tbb::blocked_range<catamari::Int> &r) {
-    //     for (Int j = r.begin(); j < r.end(); ++j) {
-    for (Int j = 0; j < sc_size; ++j) {
-        Int front_j = j + supernode_size;
-        Field *schur_column = schur_complement.Pointer(-supernode_size, j);
-        VMap(schur_complement.Pointer(0, j), sc_size).setZero();
-
-        for (Int ci = 0; ci < num_children; ++ci) {
-            Int cj = child_j[ci];
 
-            const Int child = af.children[child_beg + ci];
-            const Int num_child_diag_indices = af.num_child_diag_indices[child];
-            const Buffer<Int> &child_rel_indices = af.child_rel_indices[child];
+        // Columns of the diagonal block.
+        for (Int j = front_beg; j < std::min(front_end, supernode_size); ++j) {
+            ldl.InitializeFactorColumn(sno + j, j, diagonal_block);
+            Field* factor_column = diagonal_block.Pointer(0, j);
+            for (Int ci = 0; ci < num_children; ++ci) {
+                Int cj = child_j[ci];
 
-            // auto it = std::lower_bound(child_rel_indices.begin() + num_child_diag_indices, child_rel_indices.end(), front_j);
-            // if (it == child_rel_indices.end() || *it != front_j) continue;
-            // Int cj = std::distance(child_rel_indices.begin(), it);
+                const Int child = af.children[child_beg + ci];
+                const LocalInt *child_rel_indices = af.ChildRelativeIndicesBeg(child);
+                const BlasMatrixView<Field> &child_schur_complement = schur_complements[child];
+                const Int child_degree = child_schur_complement.height;
+                if (cj >= child_degree || child_rel_indices[cj] != j) continue;
 
-            if (cj >= child_rel_indices.Size() || child_rel_indices[cj] != front_j) continue;
+                const Field* child_column = child_schur_complement.Pointer(0, cj);
 
-            const BlasMatrixView<Field> &child_schur_complement = schur_complements[child];
-            const Int child_degree = child_schur_complement.height;
+                factor_column[j] += child_column[cj]; // diagonal entry
+                AddChildColumn(af, child, child_degree, cj + 1, child_column,
+                               factor_column);
 
-            const Field* child_column = child_schur_complement.Pointer(0, cj);
-            for (Int i = cj; i < child_degree; ++i)
-                schur_column[child_rel_indices[i]] += child_column[i];
+                child_j[ci] = ++cj;
+            }
+        }
 
-            child_j[ci] = ++cj;
+        // Columns of the Schur complement.
+        for (Int front_j = std::max(front_beg, supernode_size); front_j < front_end; ++front_j) {
+            const Int j = front_j - supernode_size;
+            Field *schur_column = schur_complement.Pointer(-supernode_size, j);
+            // In the write-once mode, the first contributing child overwrites
+            // the column.
+            bool assigned = !write_once;
+            if (!write_once) VMap(schur_complement.Pointer(0, j), sc_size).setZero();
+
+            for (Int ci = 0; ci < num_children; ++ci) {
+                Int cj = child_j[ci];
+
+                const Int child = af.children[child_beg + ci];
+                const LocalInt *child_rel_indices = af.ChildRelativeIndicesBeg(child);
+                const BlasMatrixView<Field> &child_schur_complement = schur_complements[child];
+                const Int child_degree = child_schur_complement.height;
+                if (cj >= child_degree || child_rel_indices[cj] != front_j) continue;
+
+                const Field* child_column = child_schur_complement.Pointer(0, cj);
+                if (assigned) {
+                    AddChildColumn(af, child, child_degree, cj, child_column,
+                                   schur_column);
+                } else {
+                    AssignChildColumn(af, child, child_degree, cj, child_column,
+                                      supernode_size, front_size, schur_column);
+                    assigned = true;
+                }
+
+                child_j[ci] = ++cj;
+            }
+            if (!assigned) {
+                std::fill(schur_column + supernode_size,
+                          schur_column + front_size, Field{0});
+            }
         }
-    }//  });
+    };
+
+    const Int grain_size = std::max(merge_grain_size, Int(1));
+    if (front_size <= grain_size) {
+        merge_columns(0, front_size);
+        return;
+    }
+    tbb::parallel_for(tbb::blocked_range<Int>(0, front_size, grain_size),
+        [&](const tbb::blocked_range<Int> &r) { merge_columns(r.begin(), r.end()); });
 }
 
 template <class Field>
@@ -351,40 +757,43 @@ bool Factorization<Field>::OpenMPRightLookingSubtree(
     const DynamicRegularizationParams<Field>& dynamic_reg_params,
     const Buffer<double>& work_estimates, double min_parallel_work,
     RightLookingSharedState<Field>* shared_state,
-    Buffer<PrivateState<Field>>* private_states,
-    SparseLDLResult<Field>* result,
+    RightLookingPrivateStates<Field>* private_states,
     SchurComplementStorage<Field> *subtreeStorage) {
 
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
 
   const double work_estimate = work_estimates[supernode];
-  const bool parallel = (work_estimate >= min_parallel_work) && (num_children > 1);
+  const bool parallel =
+      TaskParallelSubtree(supernode, work_estimates, min_parallel_work);
 
   // Clear this supernode's factor columns and load matrix entries into them.
   auto init = [&](){
     BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
-    const Int sno = ordering_.supernode_offsets[supernode];
-    const Int supernode_size = ordering_.supernode_sizes[supernode];
+    const Int sno = ordering_->supernode_offsets[supernode];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
     for (Int j = 0; j < supernode_size; ++j)
         InitializeFactorColumn(sno + j, j, diagonal_block);
   };
 
-  // std::vector<Int> sorted_children(num_children);
-  // for (Int child_index = 0; child_index < num_children; ++child_index)
-  //     sorted_children[child_index] = ordering_.assembly_forest.children[child_beg + child_index];
-  // std::sort(sorted_children.begin(), sorted_children.end(),
-  //           [&](Int a, Int b) { return work_estimates[a] > work_estimates[b]; });
+  // The statistics are accumulated into the result of whichever thread runs
+  // each step, so that no per-child results need to be merged up the tree.
+  auto local_result = [private_states]() {
+      return &private_states->local().result;
+  };
 
-  auto process_child = [&, supernode, min_parallel_work, shared_state, private_states](Int child, SparseLDLResult<Field> *resultContrib, SchurComplementStorage<Field> *stack) {
-      const Int child_offset = ordering_.supernode_offsets[child];
+  auto process_child = [&, supernode, min_parallel_work, shared_state, private_states](Int child, SchurComplementStorage<Field> *stack) {
+      const Int child_offset = ordering_->supernode_offsets[child];
       DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
       subparams.offset = child_offset;
       if (shared_state->hasFailed()) return; // Stop immediately if another thread encountered a failure!
-      bool success = OpenMPRightLookingSubtree(
-              child, matrix, subparams, work_estimates, min_parallel_work,
-              shared_state, private_states, resultContrib, stack);
+      bool success = true;
+      RunInSubtreeDomain(child, [&]() {
+          success = OpenMPRightLookingSubtree(
+                  child, matrix, subparams, work_estimates, min_parallel_work,
+                  shared_state, private_states, stack);
+      });
       if (!success) shared_state->setFailed();
   };
 
@@ -406,37 +815,88 @@ bool Factorization<Field>::OpenMPRightLookingSubtree(
       if (shared_state->hasFailed()) return false; // Stop immediately if another thread encountered a failure!
 
       // Construct a stack for holding the child schur complements of the subtree rooted at `supernode` (if it doesn't exist already)
-      if (subtreeStorage == nullptr) {
+      const bool subtree_root = subtreeStorage == nullptr;
+      if (subtree_root && !shared_state->left_looking_subtrees.Empty() &&
+          shared_state->left_looking_subtrees[supernode]) {
+          return HybridLeftLookingSubtree(supernode, matrix, dynamic_reg_params,
+                                          shared_state, private_states,
+                                          local_result());
+      }
+      if (subtree_root) {
 #if CUSTOM_TIMERS
           shared_state->custom_timers[supernode].Start();
 #endif
           // std::cout << "Allocating subtree storage at supernode: " << supernode << std::endl;
           subtreeStorage = &(shared_state->schur_complement_storage[supernode]);
-          subtreeStorage->reallocate(subtreeStorage->getStoragedNeeded(supernode, ordering_.assembly_forest, *lower_factor_));
+          subtreeStorage->reallocate(control_.expand_schur_complements_in_place
+                  ? expand_in_place_storage_[supernode]
+                  : subtreeStorage->getStoragedNeeded(supernode, ordering_->assembly_forest, *lower_factor_,
+                                                      SchurComplementPanelWidth()));
 #if CUSTOM_TIMERS
           shared_state->custom_timers[supernode].Stop();
 #endif
+          // Factor the small leaves of this sequential subtree in batches.
+          OpenMPBatchFactorLeaves(supernode, dynamic_reg_params, shared_state, private_states);
       }
 
       if (shared_state->hasFailed()) return false; // Stop immediately if another thread encountered a failure!
-      if (num_children == 0)
+      if (num_children == 0 && !shared_state->batch_factored[supernode])
           init();
 
-      allocate_schur_complement(); // TODO: move this after `process_child` if/when we implement an expand-in-place strategy
-      for (Int child_index = 0; child_index < num_children; ++child_index) {
-          const Int child = ordering_.assembly_forest.children[child_beg + child_index]; // sorted_children[child_index];
+      // With the expand-in-place strategy, this supernode's Schur complement
+      // is only allocated once its first child's subtree has been processed.
+      const bool expand_in_place = control_.expand_schur_complements_in_place;
+      const Int first_child_index = expand_in_place
+          ? SchurComplementStorage<Field>::expandInPlaceFirstChild(supernode, ordering_->assembly_forest, expand_in_place_storage_) - child_beg
+          : 0;
+      // Below the root of the subtree, the Schur complements are packed if a
+      // panel width was requested (which excludes the expand-in-place
+      // strategy).
+      const Int panel_width = SchurComplementPanelWidth();
+      const bool packed = !subtree_root && panel_width > 0;
+      PackedLowerMatrixView<Field> &packed_sc = shared_state->packed_schur_complements[supernode];
+      if (packed) {
+          packed_sc = subtreeStorage->pushPacked(lower_factor_->blocks[supernode].height, panel_width);
+      } else if (!expand_in_place || (num_children == 0)) {
+          allocate_schur_complement();
+      }
 
-          SparseLDLResult<Field> resultContrib;
-          process_child(child, &resultContrib, subtreeStorage);
+      for (Int child_index = 0; child_index < num_children; ++child_index) {
+          // Visit the child at `first_child_index` first, followed by the
+          // remaining children in their original order.
+          const Int visit_index = (child_index == 0) ? first_child_index
+                                : child_index - (child_index <= first_child_index);
+          const Int child = ordering_->assembly_forest.children[child_beg + visit_index];
 
-          MergeContribution(resultContrib, result);
-          if (dynamic_reg_params.enabled) assert(false); /* MergeDynamicRegularizations(result_contributions, result); */
+          process_child(child, subtreeStorage);
 
           // Stop immediately if this child failed to finalize (or if another thread encountered a failure)
           if (shared_state->hasFailed()) return false;
 
+          auto &packed_sc_child = shared_state->packed_schur_complements[child];
+          if (packed_sc_child.data != nullptr) {
+              IncorporateMergeIntoLDLResult(packed_sc_child.size, local_result());
+              RetainSchurComplement(child, packed_sc_child);
+              MergePackedChildSchurComplement(supernode, child, *ordering_,
+                      packed_sc_child, diagonal_block,
+                      packed ? packed_sc : PackedLowerMatrixView<Field>::FromSquare(shared_state->schur_complements[supernode]),
+                      *this, /* first_merge = */ child_index == 0);
+              subtreeStorage->free(packed_sc_child);
+              continue;
+          }
+
           auto &sc_child = shared_state->schur_complements[child];
-          MergeChildSchurComplement(supernode, child, ordering_,
+          IncorporateMergeIntoLDLResult(sc_child.height, local_result());
+          RetainSchurComplement(child, sc_child.ToConst());
+          if (expand_in_place && (child_index == 0)) {
+              // Also pops the child Schur complement from the stack.
+              ExpandChildSchurComplementInPlace(supernode, child, *ordering_,
+                      lower_factor_.get(), sc_child, diagonal_block,
+                      shared_state->schur_complements[supernode], subtreeStorage, *this);
+              continue;
+          }
+
+          MergeChildSchurComplement(supernode, child, *ordering_,
                   lower_factor_.get(), sc_child,
                   lower_block, diagonal_block, shared_state->schur_complements[supernode], *this, /* first_merge = */ child_index == 0);
 
@@ -446,18 +906,27 @@ bool Factorization<Field>::OpenMPRightLookingSubtree(
           // top-level OpenMPRightLooking loop.
           subtreeStorage->free(sc_child);
       }
+
+      // This supernode's Schur complement, the last entries to be pushed,
+      // is on the stack by now.
+      if (subtree_root) {
+          SparseLDLResult<Field>* result = local_result();
+          result->max_stack_bytes = std::max(result->max_stack_bytes,
+              sizeof(Field) * std::size_t(subtreeStorage->peak()));
+      }
   }
   else {
+      // Spawn all but the first child, which is processed by this thread
+      // (so that the highest-priority child starts immediately).
       tbb::task_group tg;
-      Buffer<SparseLDLResult<Field>> result_contributions(num_children);
-      for (Int child_index = 0; child_index < num_children - 1; ++child_index) {
-          const Int child = ordering_.assembly_forest.children[child_beg + child_index]; // sorted_children[child_index];
-          tg.run([&process_child, &result_contributions, child, child_index, shared_state, &tg]() {
-                process_child(child, &result_contributions[child_index], nullptr);
+      for (Int child_index = 1; child_index < num_children; ++child_index) {
+          const Int child = ordering_->assembly_forest.children[child_beg + child_index];
+          tg.run([&process_child, child, shared_state, &tg]() {
+                process_child(child, nullptr);
                 if (shared_state->hasFailed()) tg.cancel();
             });
       }
-      process_child(ordering_.assembly_forest.children[child_end - 1], &result_contributions[num_children - 1], nullptr);
+      process_child(ordering_->assembly_forest.children[child_beg], nullptr);
       if (shared_state->hasFailed()) tg.cancel();
       auto status = tg.wait();
       if (status != tbb::task_group_status::complete)
@@ -465,38 +934,455 @@ bool Factorization<Field>::OpenMPRightLookingSubtree(
 
       if (!shared_state->hasFailed()) {
           allocate_schur_complement();
-          MergeChildSchurComplements(supernode, *this, shared_state->schur_complements);
+          MergeChildSchurComplements(supernode, *this, shared_state->schur_complements,
+                                     control_.merge_grain_size);
       }
 
       // Clear out all storage used by descendants' fronts.
       for (Int child_index = 0; child_index < num_children; ++child_index) {
-        const Int child = ordering_.assembly_forest.children[child_beg + child_index];
+        const Int child = ordering_->assembly_forest.children[child_beg + child_index];
         auto &sc = shared_state->schur_complements[child];
+        if (!shared_state->hasFailed()) {
+          IncorporateMergeIntoLDLResult(sc.height, local_result());
+          RetainSchurComplement(child, sc.ToConst());
+        }
         sc.width = sc.height = 0;
         sc.data = nullptr;
         shared_state->schur_complement_storage[child].deallocate();
       }
-
-      for (Int child_index = 0; child_index < num_children; ++child_index)
-          MergeContribution(result_contributions[child_index], result);
-      if (dynamic_reg_params.enabled) MergeDynamicRegularizations(result_contributions, result);
   }
 
   if (shared_state->hasFailed()) return false;
 
-  return OpenMPRightLookingSupernodeFinalize(supernode, dynamic_reg_params, shared_state, private_states, result);
+  // The assembled front of the interface supernode of a partial factorization
+  // is its Schur complement, so it is left unfactored.
+  if (supernode == InterfaceSupernode()) return true;
+
+  // The fronts above the tree-parallel subtrees may use multithreaded BLAS.
+  const bool root_front = shared_state->root_blas_threads > 0 &&
+                          work_estimate >= min_parallel_work;
+  const int old_local_blas_threads =
+      root_front ? SetNumLocalBlasThreads(shared_state->root_blas_threads) : 0;
+  const bool finalized = OpenMPRightLookingSupernodeFinalize(
+      supernode, dynamic_reg_params, shared_state, private_states,
+      local_result());
+  // The forward solve of a fused solve reads the panel while it is still in
+  // cache.
+  if (finalized) FusedForwardSolveSupernode(supernode);
+  if (root_front) SetNumLocalBlasThreads(old_local_blas_threads);
+  if (!finalized) return false;
+  EvictSupernodePanel(supernode);
+  return true;
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPRightLookingDataflow(
+    const CoordinateMatrix<Field>& matrix,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    const Buffer<double>& work_estimates, double min_parallel_work,
+    RightLookingSharedState<Field>* shared_state,
+    RightLookingPrivateStates<Field>* private_states) {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+
+  // Schedule the supernodes with enough work in their subtrees (outside of
+  // any mapped subtree); each of their remaining children roots a subtree
+  // which is factored as a single task.
+  std::vector<Int> slots(num_supernodes, -1);
+  std::vector<Int> scheduled_supernodes;
+  std::vector<Int> subtree_roots;
+  std::vector<Int> stack(forest.roots.begin(), forest.roots.end());
+  while (!stack.empty()) {
+    const Int supernode = stack.back();
+    stack.pop_back();
+    const bool mapped =
+        !subtree_domains_.Empty() && subtree_domains_[supernode] >= 0;
+    if (mapped || work_estimates[supernode] < min_parallel_work) {
+      subtree_roots.push_back(supernode);
+      continue;
+    }
+    slots[supernode] = scheduled_supernodes.size();
+    scheduled_supernodes.push_back(supernode);
+    for (Int index = forest.child_offsets[supernode];
+         index < forest.child_offsets[supernode + 1]; ++index) {
+      stack.push_back(forest.children[index]);
+    }
+  }
+  const Int num_scheduled = scheduled_supernodes.size();
+
+  // The number of unfinished children of each scheduled supernode, the lock
+  // serializing the merges into its front, whether its front has been
+  // initialized.
+  std::unique_ptr<std::atomic<Int>[]> num_pending(
+      new std::atomic<Int>[num_scheduled]);
+  std::unique_ptr<std::mutex[]> front_mutexes(new std::mutex[num_scheduled]);
+  std::vector<char> front_initialized(num_scheduled, false);
+  for (Int slot = 0; slot < num_scheduled; ++slot) {
+    num_pending[slot] = forest.NumChildren(scheduled_supernodes[slot]);
+  }
+
+  // Allocates the Schur complement of a scheduled supernode and loads the
+  // matrix entries into its factor columns.
+  auto allocate_front = [&](Int supernode) {
+    const Int degree = lower_factor_->blocks[supernode].height;
+    shared_state->schur_complements[supernode] =
+        shared_state->schur_complement_storage[supernode]
+            .allocateSingleMatrixForDegree(degree);
+  };
+  auto initialize_front = [&](Int supernode) {
+    allocate_front(supernode);
+    const Int degree = lower_factor_->blocks[supernode].height;
+    BlasMatrixView<Field>& schur_complement =
+        shared_state->schur_complements[supernode];
+    if (forest.NumChildren(supernode)) {
+      for (Int j = 0; j < degree; ++j) {
+        std::fill(schur_complement.Pointer(0, j),
+                  schur_complement.Pointer(degree, j), Field{0});
+      }
+    }
+    BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
+    const Int supernode_offset = ordering_->supernode_offsets[supernode];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    for (Int j = 0; j < supernode_size; ++j) {
+      InitializeFactorColumn(supernode_offset + j, j, diagonal_block);
+    }
+  };
+
+  // Merges a finished supernode into its parent's front, and factors the
+  // parent if this was its last unfinished child.
+  std::function<void(Int)> process_scheduled;
+  auto complete = [&](Int supernode) {
+    const Int parent = forest.parents[supernode];
+    if (parent < 0) return;
+    const Int parent_slot = slots[parent];
+    {
+      std::lock_guard<std::mutex> lock(front_mutexes[parent_slot]);
+      // In the write-once mode, the first child to finish initializes the
+      // parent's front as it is merged.
+      const bool first_merge =
+          !front_initialized[parent_slot] && control_.write_once_assembly;
+      if (first_merge) {
+        allocate_front(parent);
+      } else if (!front_initialized[parent_slot]) {
+        initialize_front(parent);
+      }
+      front_initialized[parent_slot] = true;
+      MergeChildSchurComplement(
+          parent, supernode, *ordering_, lower_factor_.get(),
+          shared_state->schur_complements[supernode],
+          lower_factor_->blocks[parent], diagonal_factor_->blocks[parent],
+          shared_state->schur_complements[parent], *this, first_merge);
+      IncorporateMergeIntoLDLResult(
+          shared_state->schur_complements[supernode].height,
+          &private_states->local().result);
+    }
+    BlasMatrixView<Field>& schur_complement =
+        shared_state->schur_complements[supernode];
+    RetainSchurComplement(supernode, schur_complement.ToConst());
+    schur_complement.width = schur_complement.height = 0;
+    schur_complement.data = nullptr;
+    shared_state->schur_complement_storage[supernode].deallocate();
+
+    if (num_pending[parent_slot].fetch_sub(1) == 1) {
+      process_scheduled(parent);
+    }
+  };
+
+  process_scheduled = [&](Int supernode) {
+    if (shared_state->hasFailed()) return;
+    const Int slot = slots[supernode];
+    if (!front_initialized[slot]) {
+      initialize_front(supernode);
+      front_initialized[slot] = true;
+    }
+    DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+    subparams.offset = ordering_->supernode_offsets[supernode];
+    const bool root_front = shared_state->root_blas_threads > 0;
+    const int old_local_blas_threads =
+        root_front ? SetNumLocalBlasThreads(shared_state->root_blas_threads)
+                   : 0;
+    const bool success =
+        supernode == InterfaceSupernode() ||
+        OpenMPRightLookingSupernodeFinalize(supernode, subparams, shared_state,
+                                            private_states,
+                                            &private_states->local().result);
+    if (success) FusedForwardSolveSupernode(supernode);
+    if (root_front) SetNumLocalBlasThreads(old_local_blas_threads);
+    if (!success) {
+      shared_state->setFailed();
+      return;
+    }
+    EvictSupernodePanel(supernode);
+    complete(supernode);
+  };
+
+  auto process_subtree = [&](Int supernode) {
+    if (shared_state->hasFailed()) return;
+    DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+    subparams.offset = ordering_->supernode_offsets[supernode];
+    bool success = true;
+    RunInSubtreeDomain(supernode, [&]() {
+      success = OpenMPRightLookingSubtree(
+          supernode, matrix, subparams, work_estimates, min_parallel_work,
+          shared_state, private_states);
+    });
+    if (!success) {
+      shared_state->setFailed();
+      return;
+    }
+    complete(supernode);
+  };
+
+  // Launch the subtrees and the scheduled leaves, the most expensive first.
+  std::vector<Int> sources = subtree_roots;
+  for (const Int& supernode : scheduled_supernodes) {
+    if (!forest.NumChildren(supernode)) sources.push_back(supernode);
+  }
+  std::sort(sources.begin(), sources.end(), [&](const Int& a, const Int& b) {
+    return work_estimates[a] > work_estimates[b];
+  });
+  tbb::task_group tg;
+  for (const Int& supernode : sources) {
+    tg.run([&, supernode]() {
+      if (slots[supernode] >= 0) {
+        process_scheduled(supernode);
+      } else {
+        process_subtree(supernode);
+      }
+    });
+  }
+  tg.wait();
+
+  // Release the fronts left behind by a failure (and those of the roots).
+  for (const Int& supernode : scheduled_supernodes) {
+    BlasMatrixView<Field>& schur_complement =
+        shared_state->schur_complements[supernode];
+    schur_complement.width = schur_complement.height = 0;
+    schur_complement.data = nullptr;
+    shared_state->schur_complement_storage[supernode].deallocate();
+  }
+  for (const Int& supernode : subtree_roots) {
+    BlasMatrixView<Field>& schur_complement =
+        shared_state->schur_complements[supernode];
+    schur_complement.width = schur_complement.height = 0;
+    schur_complement.data = nullptr;
+    shared_state->schur_complement_storage[supernode].deallocate();
+  }
+}
+
+template <class Field>
+void Factorization<Field>::ReleaseWorkspace() {
+  for (auto &sc : shared_state_.schur_complements) {
+      sc.width = sc.height = 0;
+      sc.data = nullptr;
+  }
+  for (auto &sc : shared_state_.packed_schur_complements)
+      sc = PackedLowerMatrixView<Field>();
+  for (auto &storage : shared_state_.schur_complement_storage)
+      storage.release();
+  private_states_.clear();
+  retained_schur_complements_.Clear();
+}
+
+template <class Field>
+void Factorization<Field>::RetainSchurComplement(
+    Int supernode, const ConstBlasMatrixView<Field>& schur_complement) {
+  if (retained_schur_complements_.Empty()) return;
+  Buffer<Field>& retained = retained_schur_complements_[supernode];
+  if (work_estimates_[supernode] < control_.schur_complement_retention_work) {
+    retained.Clear();
+    return;
+  }
+
+  // Only the lower triangle is meaningful (and copied).
+  const Int degree = schur_complement.height;
+  retained.Resize(degree * degree);
+  for (Int j = 0; j < degree; ++j) {
+    const Field* column = schur_complement.Pointer(j, j);
+    std::copy(column, column + (degree - j), retained.Data() + j * degree + j);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::RetainSchurComplement(
+    Int supernode, const PackedLowerMatrixView<Field>& schur_complement) {
+  if (retained_schur_complements_.Empty()) return;
+  Buffer<Field>& retained = retained_schur_complements_[supernode];
+  if (work_estimates_[supernode] < control_.schur_complement_retention_work) {
+    retained.Clear();
+    return;
+  }
+
+  // The retained copy is a full square whose lower triangle is meaningful.
+  const Int degree = schur_complement.size;
+  retained.Resize(degree * degree);
+  for (Int j = 0; j < degree; ++j) {
+    const Field* column = schur_complement.ColumnPointer(j);
+    std::copy(column + j, column + degree, retained.Data() + j * degree + j);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::SortAssemblyForestChildren() {
+  if (ordering_->assembly_forest.child_order == control_.child_order) return;
+  AssemblyForest& forest = MutableOrdering().assembly_forest;
+
+  // Cached quantities that depend upon the child order.
+  expand_in_place_storage_.Clear();
+
+  if (control_.child_order == kDefaultChildOrder) {
+    forest.SortChildrenByIndex();
+    return;
+  }
+
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  Buffer<double> priorities(num_supernodes);
+  if (control_.child_order == kMemoryMinimizingChildOrder) {
+    // Each child's Schur complement is merged into (or expanded into) its
+    // parent as soon as it is formed, so no contribution of a child remains on
+    // the stack while its siblings are processed. Liu's criterion -- decreasing
+    // subtree peak minus retained contribution -- then reduces to decreasing
+    // subtree peak.
+    Buffer<Int> storage(num_supernodes);
+    for (const Int& root : forest.roots) {
+      SchurComplementStorage<Field>::fillStorageNeededExpandInPlaceOptimal(
+          root, forest, *lower_factor_, &storage);
+    }
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      priorities[supernode] = storage[supernode];
+    }
+  } else {
+    for (const Int& root : forest.roots) {
+      FillSubtreeCriticalPaths(root, forest, *lower_factor_, &priorities);
+    }
+  }
+  forest.SortChildren(priorities, control_.child_order);
+}
+
+template <class Field>
+void Factorization<Field>::MapSubtreesToDomains(Int max_threads) {
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  if (!control_.subtree_mapping_domains || max_threads < 2) {
+    subtree_domains_.Clear();
+    subtree_arenas_.clear();
+    return;
+  }
+  const std::vector<tbb::numa_node_id> numa_nodes = tbb::info::numa_nodes();
+  const Int num_domains = control_.subtree_mapping_domains < 0
+                              ? Int(numa_nodes.size())
+                              : control_.subtree_mapping_domains;
+  if (num_domains < 2) {
+    subtree_domains_.Clear();
+    subtree_arenas_.clear();
+    return;
+  }
+
+  if (subtree_domains_.Size() != num_supernodes ||
+      Int(subtree_arenas_.size()) != num_domains) {
+    subtree_domains_.Resize(num_supernodes, -1);
+    const std::vector<Int> roots(ordering_->assembly_forest.roots.begin(),
+                                 ordering_->assembly_forest.roots.end());
+    ProportionalSubtreeMapping(ordering_->assembly_forest, work_estimates_,
+                               roots, 0, num_domains, &subtree_domains_);
+  }
+
+  // Pin each domain to a NUMA node when enough of them were detected, and
+  // otherwise split the threads evenly between the domains.
+  const bool pin_to_numa_nodes = Int(numa_nodes.size()) >= num_domains;
+  const Int domain_threads = std::max(Int(1), max_threads / num_domains);
+  if (Int(subtree_arenas_.size()) != num_domains) {
+    subtree_arenas_.clear();
+    for (Int domain = 0; domain < num_domains; ++domain) {
+      subtree_arenas_.push_back(
+          pin_to_numa_nodes
+              ? std::make_unique<tbb::task_arena>(
+                    tbb::task_arena::constraints(numa_nodes[domain]))
+              : std::make_unique<tbb::task_arena>(domain_threads));
+    }
+  }
+}
+
+template <class Field>
+template <class Function>
+void Factorization<Field>::RunInSubtreeDomain(Int supernode,
+                                              const Function& func) {
+  const Int domain =
+      subtree_domains_.Empty() ? -1 : subtree_domains_[supernode];
+  if (domain < 0) {
+    func();
+  } else {
+    subtree_arenas_[domain]->execute(func);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::FirstTouchFactorValues() {
+  TraceScope trace_scope("FirstTouchFactorValues");
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_domains = subtree_arenas_.size();
+
+  // Gather the supernodes of each domain's subtrees, and the unmapped
+  // supernodes above them.
+  std::vector<std::vector<Int>> domain_supernodes(num_domains + 1);
+  std::vector<std::pair<Int, Int>> stack;
+  for (const Int& root : forest.roots) {
+    stack.emplace_back(root, num_domains);
+  }
+  while (!stack.empty()) {
+    const Int supernode = stack.back().first;
+    Int domain = stack.back().second;
+    stack.pop_back();
+    if (domain == num_domains && !subtree_domains_.Empty() &&
+        subtree_domains_[supernode] >= 0) {
+      domain = subtree_domains_[supernode];
+    }
+    domain_supernodes[domain].push_back(supernode);
+    for (Int index = forest.child_offsets[supernode];
+         index < forest.child_offsets[supernode + 1]; ++index) {
+      stack.emplace_back(forest.children[index], domain);
+    }
+  }
+
+  // Each supernode's diagonal and subdiagonal blocks are stored contiguously.
+  auto touch = [&](const std::vector<Int>& supernodes) {
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, supernodes.size()),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+          for (std::size_t index = range.begin(); index < range.end();
+               ++index) {
+            const BlasMatrixView<Field>& diagonal_block =
+                diagonal_factor_->blocks[supernodes[index]];
+            std::fill(diagonal_block.data,
+                      diagonal_block.data +
+                          diagonal_block.width * diagonal_block.leading_dim,
+                      Field{0});
+          }
+        });
+  };
+  tbb::task_group tg;
+  for (Int domain = 0; domain < num_domains; ++domain) {
+    if (domain_supernodes[domain].empty()) continue;
+    tg.run([&, domain]() {
+      subtree_arenas_[domain]->execute(
+          [&, domain]() { touch(domain_supernodes[domain]); });
+    });
+  }
+  touch(domain_supernodes[num_domains]);
+  tg.wait();
+
+  factor_values_touched_ = true;
 }
 
 template <class Field>
 SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
     const CoordinateMatrix<Field>& matrix) {
 
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Int num_roots = ordering_->assembly_forest.roots.Size();
 
 #if 0
   {
-      const auto &af = ordering_.assembly_forest;
+      const auto &af = ordering_->assembly_forest;
       const auto &lf = *lower_factor_;
       std::cout << "Num roots: " << num_roots << std::endl;
       std::cout << "Serial memory required: " << SchurComplementStorage<Field>::storageNeeded(af.roots[0], af, lf) << std::endl;
@@ -511,7 +1397,7 @@ SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
       shared_state_.custom_timers[i].Reset();
 #endif
 
-  BENCHMARK_SCOPED_TIMER_SECTION timer("OpenMPRightLooking");
+  TraceScope trace_scope("OpenMPRightLooking");
   typedef ComplexBase<Field> Real;
 
   // {
@@ -521,7 +1407,7 @@ SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
   //       if (count >= child_count_statistics.size()) child_count_statistics.resize(count + 1);
   //       ++child_count_statistics[count];
   //   };
-  //   const auto &af = ordering_.assembly_forest;
+  //   const auto &af = ordering_->assembly_forest;
   //   for (size_t supernode = 0; supernode < num_supernodes; ++supernode) {
   //       const Int num_children = af.child_offsets[supernode + 1] - af.child_offsets[supernode];
   //       record(num_children);
@@ -565,24 +1451,19 @@ SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
   dynamic_reg_params.positive_threshold = std::pow(kEpsilon, control_.dynamic_regularization.positive_threshold_exponent);
   dynamic_reg_params.negative_threshold = std::pow(kEpsilon, control_.dynamic_regularization.negative_threshold_exponent);
   if (control_.dynamic_regularization.relative) {
-    const Real matrix_max_norm = MaxNorm(matrix);
+    const Real matrix_max_norm = InputMaxNorm(matrix);
     dynamic_reg_params.positive_threshold *= matrix_max_norm;
     dynamic_reg_params.negative_threshold *= matrix_max_norm;
   }
   dynamic_reg_params.signatures = &control_.dynamic_regularization.signatures;
-  dynamic_reg_params.inverse_permutation = ordering_.inverse_permutation.Empty()
+  dynamic_reg_params.inverse_permutation = ordering_->inverse_permutation.Empty()
                                                ? nullptr
-                                               : &ordering_.inverse_permutation;
+                                               : &ordering_->inverse_permutation;
 
   // const Int max_threads = omp_get_max_threads();
   const Int max_threads = get_max_num_tbb_threads();
-  Buffer<PrivateState<Field>> private_states(max_threads);
-  if (control_.factorization_type != kCholeskyFactorization) {
-    const Int workspace_size = max_lower_block_size_;
-    for (int t = 0; t < max_threads; ++t) {
-      private_states[t].scaled_transpose_buffer.Resize(workspace_size);
-    }
-  }
+
+  SortAssemblyForestChildren();
 
   // Compute flop-count estimates so that we may prioritize the expensive
   // tasks before the cheaper ones.
@@ -590,60 +1471,132 @@ SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
   double &total_work = total_work_;
   if (work_estimates.Size() != num_supernodes) {
       work_estimates.Resize(num_supernodes);
-      for (const Int& root : ordering_.assembly_forest.roots) {
-          FillSubtreeWorkEstimates(root, ordering_.assembly_forest, *lower_factor_,
+      for (const Int& root : ordering_->assembly_forest.roots) {
+          FillSubtreeWorkEstimates(root, ordering_->assembly_forest, *lower_factor_,
                   &work_estimates);
       }
 
       total_work = std::accumulate(work_estimates.begin(), work_estimates.end(), 0.);
   }
 
+  device_offload_.Initialize(control_.device_offload, num_supernodes);
+  MapSubtreesToDomains(max_threads);
+  if (control_.first_touch_factor_values && !factor_values_touched_) {
+      FirstTouchFactorValues();
+  }
+
+  if (control_.expand_schur_complements_in_place &&
+      expand_in_place_storage_.Size() != num_supernodes) {
+      expand_in_place_storage_.Resize(num_supernodes);
+      for (const Int& root : ordering_->assembly_forest.roots) {
+          SchurComplementStorage<Field>::fillStorageNeededExpandInPlaceOptimal(
+                  root, ordering_->assembly_forest, *lower_factor_, &expand_in_place_storage_);
+      }
+  }
+
   const double min_parallel_ratio_work = (total_work * control_.parallel_ratio_threshold) / max_threads;
   const double min_parallel_work = std::max(std::max(control_.min_parallel_threshold, min_parallel_ratio_work),
                                             max_threads < 2 ? std::numeric_limits<double>::infinity() : 0); // Forbid parallel execution
 
-  // Allocate the map from child structures to parent fronts.
-  auto &ncdi   = ordering_.assembly_forest.num_child_diag_indices;
-  auto &cri    = ordering_.assembly_forest.child_rel_indices;
-  if ( cri.Size() != num_supernodes) {
-      cri.Resize(num_supernodes);
-      ncdi.Resize(num_supernodes);
-  }
-
   RightLookingSharedState<Field> &shared_state = shared_state_;
   if (shared_state.schur_complements.Size() != num_supernodes) {
       shared_state.schur_complements.Resize(num_supernodes);
       shared_state.schur_complement_storage.Resize(num_supernodes);
   }
+  shared_state.batch_factored.Resize(num_supernodes);
+  std::fill(shared_state.batch_factored.begin(), shared_state.batch_factored.end(), false);
+  // Clear any packed Schur complements left behind by a failed factorization.
+  shared_state.packed_schur_complements.Resize(num_supernodes);
+  std::fill(shared_state.packed_schur_complements.begin(),
+            shared_state.packed_schur_complements.end(),
+            PackedLowerMatrixView<Field>());
+  std::size_t held_storage_bytes = 0;
+  for (auto &storage : shared_state.schur_complement_storage) {
+      storage.setMemoryTracker(nullptr);
+      storage.setPersistent(control_.persistent_workspace);
+      storage.setAllocationControl(control_.allocation);
+      if (!control_.persistent_workspace) storage.release(); // Drop any previously pooled memory.
+      held_storage_bytes += storage.capacity() * sizeof(Field);
+      storage.setMemoryTracker(&shared_state.schur_complement_memory);
+  }
+  shared_state.schur_complement_memory.reset(held_storage_bytes);
+
+  // Select the sequential subtrees which are factored left-looking.
+  SelectLeftLookingSubtrees(min_parallel_work, &shared_state);
+
+  // Every retained Schur complement is replaced as its supernode is merged.
+  if (control_.schur_complement_retention_work > 0 &&
+      InterfaceSupernode() < 0) {
+    retained_schur_complements_.Resize(num_supernodes);
+  } else {
+    retained_schur_complements_.Clear();
+  }
 
 #ifdef CATAMARI_ENABLE_TIMERS
   shared_state.inclusive_timers.Resize(num_supernodes);
   shared_state.exclusive_timers.Resize(num_supernodes);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+  supernode_counters.Resize(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    SupernodeCounters& counters = supernode_counters[supernode];
+    counters = SupernodeCounters();
+    counters.size = ordering_->supernode_sizes[supernode];
+    counters.degree = lower_factor_->blocks[supernode].height;
+  }
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+
   SparseLDLResult<Field> result;
+  IncorporateRelaxationIntoLDLResult(&result);
+  if (dynamic_reg_params.enabled &&
+      control_.dynamic_regularization.diagonal_output) {
+    result.dynamic_regularization_diagonal.Resize(NumRows(), Real(0));
+    dynamic_reg_params.diagonal = result.dynamic_regularization_diagonal.Data();
+  }
 
   shared_state.unsetFailed();
-
-  Buffer<SparseLDLResult<Field>> result_contributions(num_roots);
+  shared_state.cancellation = control_.cancellation;
+  shared_state.num_positive_pivots = 0;
+  shared_state.num_negative_pivots = 0;
+  for (RightLookingPrivateState<Field>& private_state : private_states_) {
+      private_state.result = SparseLDLResult<Field>();
+  }
 
   auto process_root = [&, min_parallel_work](Int root_index) {
-      const Int root = ordering_.assembly_forest.roots[root_index];
+      const Int root = ordering_->assembly_forest.roots[root_index];
       DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
-      subparams.offset = ordering_.supernode_offsets[root];
-      bool success = OpenMPRightLookingSubtree(
-              root, matrix, subparams, work_estimates, min_parallel_work,
-              &shared_state, &private_states, &result_contributions[root_index]);
+      subparams.offset = ordering_->supernode_offsets[root];
+      bool success = true;
+      RunInSubtreeDomain(root, [&]() {
+          success = OpenMPRightLookingSubtree(
+                  root, matrix, subparams, work_estimates, min_parallel_work,
+                  &shared_state, &private_states_);
+      });
       shared_state.schur_complement_storage[root].deallocate();
       if (!success) shared_state.setFailed();
   };
 
-  // const int old_max_threads = GetMaxBlasThreads();
   const bool parallel = (max_threads > 1) && (total_work >= min_parallel_work);
-  // if (parallel) SetNumBlasThreads(2);
+
+  // Single-thread the BLAS calls of the concurrent subtree tasks, leaving
+  // the fronts above them a thread-local count.
+  const int old_max_blas_threads = GetMaxBlasThreads();
+  shared_state.root_blas_threads = 0;
+  if (parallel && control_.mixed_blas_threading) {
+    shared_state.root_blas_threads = control_.root_blas_threads > 0
+                                         ? control_.root_blas_threads
+                                         : old_max_blas_threads;
+    SetNumBlasThreads(1);
+  }
 
   // Recurse on each tree in the elimination forest.
-  if (!parallel || num_roots <= 1) {
+  if (parallel && control_.dataflow_scheduling) {
+      OpenMPRightLookingDataflow(matrix, dynamic_reg_params, work_estimates,
+                                 min_parallel_work, &shared_state,
+                                 &private_states_);
+  }
+  else if (!parallel || num_roots <= 1) {
       for (Int root_index = 0; root_index < num_roots; ++root_index) {
           process_root(root_index);
           if (shared_state.hasFailed()) break;
@@ -658,27 +1611,50 @@ SparseLDLResult<Field> Factorization<Field>::OpenMPRightLooking(
       tg.wait();
   }
 
-  // if (parallel) SetNumBlasThreads(old_max_threads);
+  if (shared_state.root_blas_threads) {
+    SetNumBlasThreads(old_max_blas_threads);
+    shared_state.root_blas_threads = 0;
+  }
 
+  // A deadline passing after the traversal does not fail the factorization.
+  shared_state.cancellation = nullptr;
   bool succeeded = !shared_state.hasFailed();
+  result.cancelled = !succeeded && control_.cancellation &&
+                     control_.cancellation->Cancelled();
   if (succeeded) {
-    for (Int index = 0; index < num_roots; ++index)
-        MergeContribution(result_contributions[index], &result);
-    if (dynamic_reg_params.enabled)
-        MergeDynamicRegularizations(result_contributions, &result);
+    // Combine the results accumulated by each thread.
+    for (const RightLookingPrivateState<Field>& private_state :
+         private_states_) {
+        MergeContribution(private_state.result, &result);
+        result.dynamic_regularization.insert(
+                result.dynamic_regularization.end(),
+                private_state.result.dynamic_regularization.begin(),
+                private_state.result.dynamic_regularization.end());
+    }
+    result.num_device_fronts = device_offload_.NumOffloadedFronts();
+    result.peak_frontal_bytes =
+        shared_state.schur_complement_memory.peak.load();
+    FinishFactorization(&result);
+  } else {
+    retained_schur_complements_.Clear();
   }
 
 #ifdef CATAMARI_ENABLE_TIMERS
   TruncatedForestTimersToDot(
       control_.inclusive_timings_filename, shared_state.inclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
   TruncatedForestTimersToDot(
       control_.exclusive_timings_filename, shared_state.exclusive_timers,
-      ordering_.assembly_forest, control_.max_timing_levels,
+      ordering_->assembly_forest, control_.max_timing_levels,
       control_.avoid_timing_isolated_roots);
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
+#ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+  SupernodeCountersToReport(control_.hardware_counters_filename,
+                            supernode_counters);
+#endif  // ifdef CATAMARI_ENABLE_HARDWARE_COUNTERS
+
 #if CUSTOM_TIMERS
   double totalTime = 0;
   for (Int i = 0; i < num_supernodes; ++i) {
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SELECTED_INVERSION_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SELECTED_INVERSION_IMPL_H_
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include <tbb/task_group.h>
+
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// Given the factorization A = L D op(L) -- where op is either the adjoint or
+// the transpose and D is the identity for Cholesky factorizations -- and the
+// inverse Z restricted to the structure S of supernode J, the inverse
+// restricted to J's front is computed via
+//
+//   Y    = op(L(S, J) inv(L(J, J))),
+//   Z(J, S) = -Y Z(S, S),
+//   Z(J, J) = op(inv(L(J, J))) inv(D(J, J)) inv(L(J, J)) - Y op(Z(J, S)),
+//
+// and Z(S, J) = op(Z(J, S)).
+template <class Field>
+void Factorization<Field>::SelectedInversionFront(
+    Int supernode, BlasMatrixView<Field>* front,
+    RightLookingPrivateState<Field>* private_state) const {
+  const SymmetricFactorizationType type = control_.factorization_type;
+  const bool transpose = type == kLDLTransposeFactorization;
+  const ConstBlasMatrixView<Field> diagonal_block =
+      diagonal_factor_->blocks[supernode].ToConst();
+  const ConstBlasMatrixView<Field> lower_block =
+      lower_factor_->blocks[supernode].ToConst();
+  const Int supernode_size = lower_block.width;
+  const Int degree = lower_block.height;
+
+  Field* workspace = private_state->WorkspaceBuffer(
+      supernode_size * degree + 2 * supernode_size * supernode_size);
+  auto workspace_matrix = [&](Int height, Int width) {
+    BlasMatrixView<Field> matrix;
+    matrix.height = height;
+    matrix.width = width;
+    matrix.leading_dim = std::max<Int>(height, 1);
+    matrix.data = workspace;
+    workspace += height * width;
+    return matrix;
+  };
+  BlasMatrixView<Field> scaled_lower = workspace_matrix(supernode_size, degree);
+  BlasMatrixView<Field> inverse_triangle =
+      workspace_matrix(supernode_size, supernode_size);
+  BlasMatrixView<Field> scaled_inverse_triangle =
+      workspace_matrix(supernode_size, supernode_size);
+
+  BlasMatrixView<Field> diagonal_inverse =
+      front->Submatrix(0, 0, supernode_size, supernode_size);
+  BlasMatrixView<Field> upper_inverse =
+      front->Submatrix(0, supernode_size, supernode_size, degree);
+  const ConstBlasMatrixView<Field> structure_inverse =
+      front->ToConst().Submatrix(supernode_size, supernode_size, degree,
+                                 degree);
+
+  // inverse_triangle := inv(L(J, J)).
+  for (Int j = 0; j < supernode_size; ++j) {
+    for (Int i = 0; i < supernode_size; ++i) {
+      inverse_triangle(i, j) = i == j ? Field{1} : Field{0};
+    }
+  }
+  if (type == kCholeskyFactorization) {
+    LeftLowerTriangularSolves(diagonal_block, &inverse_triangle);
+  } else {
+    LeftLowerUnitTriangularSolves(diagonal_block, &inverse_triangle);
+  }
+
+  // Z(J, J) := op(inv(L(J, J))) inv(D(J, J)) inv(L(J, J)).
+  for (Int j = 0; j < supernode_size; ++j) {
+    for (Int i = 0; i < supernode_size; ++i) {
+      scaled_inverse_triangle(i, j) =
+          type == kCholeskyFactorization
+              ? inverse_triangle(i, j)
+              : inverse_triangle(i, j) / diagonal_block(i, i);
+    }
+  }
+  if (transpose) {
+    MatrixMultiplyTransposeNormal(Field{1}, inverse_triangle.ToConst(),
+                                  scaled_inverse_triangle.ToConst(), Field{0},
+                                  &diagonal_inverse);
+  } else {
+    MatrixMultiplyAdjointNormal(Field{1}, inverse_triangle.ToConst(),
+                                scaled_inverse_triangle.ToConst(), Field{0},
+                                &diagonal_inverse);
+  }
+  if (!degree) return;
+
+  // Y := op(L(S, J) inv(L(J, J))) = inv(op(L(J, J))) op(L(S, J)).
+  for (Int j = 0; j < degree; ++j) {
+    for (Int i = 0; i < supernode_size; ++i) {
+      scaled_lower(i, j) =
+          transpose ? lower_block(j, i) : Conjugate(lower_block(j, i));
+    }
+  }
+  if (type == kCholeskyFactorization) {
+    LeftLowerAdjointTriangularSolves(diagonal_block, &scaled_lower);
+  } else if (type == kLDLAdjointFactorization) {
+    LeftLowerAdjointUnitTriangularSolves(diagonal_block, &scaled_lower);
+  } else {
+    LeftLowerTransposeUnitTriangularSolves(diagonal_block, &scaled_lower);
+  }
+
+  // Z(J, S) := -Y Z(S, S).
+  MatrixMultiplyNormalNormal(Field{-1}, scaled_lower.ToConst(),
+                             structure_inverse, Field{0}, &upper_inverse);
+
+  // Z(J, J) -= Y op(Z(J, S)).
+  if (transpose) {
+    MatrixMultiplyNormalTranspose(Field{-1}, scaled_lower.ToConst(),
+                                  upper_inverse.ToConst(), Field{1},
+                                  &diagonal_inverse);
+  } else {
+    MatrixMultiplyNormalAdjoint(Field{-1}, scaled_lower.ToConst(),
+                                upper_inverse.ToConst(), Field{1},
+                                &diagonal_inverse);
+  }
+
+  // Z(S, J) := op(Z(J, S)).
+  for (Int j = 0; j < supernode_size; ++j) {
+    for (Int i = 0; i < degree; ++i) {
+      front->Entry(supernode_size + i, j) =
+          transpose ? upper_inverse(j, i) : Conjugate(upper_inverse(j, i));
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::SelectedInversionSubtree(
+    Int supernode, const ConstBlasMatrixView<Field>& parent_front,
+    const Buffer<double>& work_estimates, double min_parallel_work,
+    RightLookingPrivateStates<Field>* private_states, Field* inverse_values,
+    Buffer<Field>* diagonal, SchurComplementStorage<Field>* stack) const {
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int child_beg = forest.child_offsets[supernode];
+  const Int child_end = forest.child_offsets[supernode + 1];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int degree = lower_factor_->blocks[supernode].height;
+  const Int front_size = supernode_size + degree;
+  const bool parallel = (child_end - child_beg > 1) &&
+                        (work_estimates[supernode] >= min_parallel_work);
+
+  // Serial subtrees push their fronts onto a single stack, which only needs
+  // to hold the fronts along a root-to-leaf path at once.
+  SchurComplementStorage<Field> subtree_stack;
+  if (!parallel && !stack) {
+    std::function<Int(Int)> storage_needed = [&](Int node) {
+      const Int size = ordering_->supernode_sizes[node] +
+                       lower_factor_->blocks[node].height;
+      Int max_child_storage = 0;
+      for (Int index = forest.child_offsets[node];
+           index < forest.child_offsets[node + 1]; ++index) {
+        max_child_storage =
+            std::max(max_child_storage, storage_needed(forest.children[index]));
+      }
+      return size * size + max_child_storage;
+    };
+    subtree_stack.setAllocationControl(control_.allocation);
+    subtree_stack.reallocate(storage_needed(supernode));
+    stack = &subtree_stack;
+  }
+  Buffer<Field> front_buffer;
+  BlasMatrixView<Field> front;
+  if (stack) {
+    front = stack->push(front_size);
+  } else {
+    front_buffer.Resize(front_size * front_size);
+    front.height = front.width = front.leading_dim = front_size;
+    front.data = front_buffer.Data();
+  }
+
+  // Extract the inverse restricted to this supernode's structure from the
+  // parent's front.
+  if (degree) {
+    const LocalInt* child_rel_indices =
+        forest.ChildRelativeIndicesBeg(supernode);
+    for (Int j = 0; j < degree; ++j) {
+      const Field* parent_column = parent_front.Pointer(0, child_rel_indices[j]);
+      Field* column = front.Pointer(supernode_size, supernode_size + j);
+      for (Int i = 0; i < degree; ++i) {
+        column[i] = parent_column[child_rel_indices[i]];
+      }
+    }
+  }
+
+  SelectedInversionFront(supernode, &front, &private_states->local());
+
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  if (inverse_values) {
+    const ConstBlasMatrixView<Field> diagonal_block =
+        diagonal_factor_->blocks[supernode].ToConst();
+    Field* values =
+        inverse_values + (diagonal_block.data - factor_values_.Data());
+    for (Int j = 0; j < supernode_size; ++j) {
+      std::copy(front.Pointer(j, j), front.Pointer(front_size, j),
+                values + j * diagonal_block.leading_dim + j);
+    }
+  }
+  if (diagonal) {
+    const bool have_permutation = !ordering_->inverse_permutation.Empty();
+    for (Int i = 0; i < supernode_size; ++i) {
+      const Int row = supernode_start + i;
+      (*diagonal)[have_permutation ? ordering_->inverse_permutation[row] : row] =
+          front(i, i);
+    }
+  }
+
+  // Recurse on the children, which only read from this front.
+  const ConstBlasMatrixView<Field> const_front = front.ToConst();
+  if (parallel) {
+    tbb::task_group group;
+    for (Int index = child_beg + 1; index < child_end; ++index) {
+      const Int child = forest.children[index];
+      group.run([this, child, &const_front, &work_estimates, min_parallel_work,
+                 private_states, inverse_values, diagonal]() {
+        SelectedInversionSubtree(child, const_front, work_estimates,
+                                 min_parallel_work, private_states,
+                                 inverse_values, diagonal, nullptr);
+      });
+    }
+    SelectedInversionSubtree(forest.children[child_beg], const_front,
+                             work_estimates, min_parallel_work, private_states,
+                             inverse_values, diagonal, nullptr);
+    group.wait();
+  } else {
+    for (Int index = child_beg; index < child_end; ++index) {
+      SelectedInversionSubtree(forest.children[index], const_front,
+                               work_estimates, min_parallel_work,
+                               private_states, inverse_values, diagonal, stack);
+    }
+  }
+
+  if (stack) stack->pop(front_size);
+}
+
+template <class Field>
+void Factorization<Field>::SelectedInversion(Field* inverse_values,
+                                             Buffer<Field>* diagonal) const {
+  TraceScope trace_scope("SelectedInversion");
+  if (control_.supernodal_pivoting) {
+    throw std::runtime_error(
+        "Selected inversion does not support supernodal pivoting");
+  }
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error(
+        "Selected inversion requires a complete factorization");
+  }
+  RequireUncompressedFactor("Selected inversion");
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+
+  // The inversion has the same flop profile as the factorization.
+  Buffer<double> local_work_estimates;
+  const Buffer<double>* work_estimates = &work_estimates_;
+  if (work_estimates_.Size() != num_supernodes) {
+    local_work_estimates.Resize(num_supernodes, 0.);
+    for (const Int& root : forest.roots) {
+      FillSubtreeWorkEstimates(root, forest, *lower_factor_,
+                               &local_work_estimates);
+    }
+    work_estimates = &local_work_estimates;
+  }
+  const Int max_threads = get_max_num_tbb_threads();
+  const double min_parallel_work =
+      max_threads < 2 ? std::numeric_limits<double>::infinity()
+                      : control_.min_parallel_threshold;
+
+  RightLookingPrivateStates<Field> private_states;
+  const ConstBlasMatrixView<Field> no_parent_front;
+  tbb::task_group group;
+  for (const Int& root : forest.roots) {
+    auto process_root = [&, root]() {
+      SelectedInversionSubtree(root, no_parent_front, *work_estimates,
+                               min_parallel_work, &private_states,
+                               inverse_values, diagonal, nullptr);
+    };
+    if ((*work_estimates)[root] >= min_parallel_work) {
+      group.run(process_root);
+    } else {
+      process_root();
+    }
+  }
+  group.wait();
+}
+
+template <class Field>
+void Factorization<Field>::SelectedInversion(
+    BlasMatrix<Field>* inverse_values) const {
+  inverse_values->Resize(factor_values_.Height(), factor_values_.Width(),
+                         Field{0});
+  SelectedInversion(inverse_values->Data(), nullptr);
+}
+
+template <class Field>
+void Factorization<Field>::InverseDiagonal(Buffer<Field>* diagonal) const {
+  diagonal->Resize(NumRows());
+  SelectedInversion(nullptr, diagonal);
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+        // CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SELECTED_INVERSION_IMPL_H_
@@ -11,11 +11,11 @@
 #include <algorithm>
 #include <stdexcept>
 
-#include <MeshFEM/GlobalBenchmark.hh>
 #include <MeshFEM/Types.hh>
 #include <catamari/dense_basic_linear_algebra-impl.hpp>
 #include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dense_factorizations.hpp"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 #include <MeshFEM/Parallelism.hh>
@@ -30,94 +30,104 @@ namespace supernodal_ldl {
 template <class Field>
 void Factorization<Field>::Solve(
     BlasMatrixView<Field>* right_hand_sides, bool already_permuted) const {
-  const bool needs_permutation = !(ordering_.permutation.Empty() || already_permuted);
-  // Reorder the input into the permutation of the factorization.
+  Solve(right_hand_sides, nullptr, already_permuted);
+}
+
+template <class Field>
+void Factorization<Field>::Solve(
+    BlasMatrixView<Field>* right_hand_sides, SolveWorkspace<Field>* workspace,
+    bool already_permuted) const {
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error("Solves require a complete factorization");
+  }
+  const bool own_workspace = workspace == nullptr;
+  if (own_workspace) workspace = &solve_workspace_;
+  Buffer<Field> &permute_scratch = workspace->permute_scratch;
+  const bool needs_permutation = !(ordering_->permutation.Empty() || already_permuted);
+  const bool have_scaling = !input_scaling_.Empty();
+  const Int max_threads = get_max_num_tbb_threads();
+
+  // A conjugated solve (see 'SolveOperation') folds the conjugations into the
+  // permutations when there are any.
+  const bool conjugate = workspace->shared_state.conjugate_right_hand_sides;
+
+  // The parallel sweeps gather each supernode's rows straight from the
+  // caller's right-hand sides just before eliminating it and scatter them
+  // back once they are solved, which avoids two full permutation passes.
+  const bool fused_permutation = needs_permutation && max_threads > 1;
 
   BlasMatrixView<Field> permuted_right_hand_sides = *right_hand_sides;
-  if (needs_permutation) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("Permute");
+  if (fused_permutation) {
+    const Int size = right_hand_sides->width * right_hand_sides->height;
+    if (permute_scratch.Size() < size)
+        permute_scratch.Resize(size);
+    permuted_right_hand_sides.data = permute_scratch.Data();
+    permuted_right_hand_sides.leading_dim = right_hand_sides->height;
+  } else if (needs_permutation) {
+    // Reorder the input into the permutation of the factorization.
+    TraceScope trace_scope("Permute");
 #if SOLVE_PERMUTE_SCRATCH
     const Int size = right_hand_sides->width * right_hand_sides->height;
-    if (permute_scratch_.Size() < size)
-        permute_scratch_.Resize(size);
-    permuted_right_hand_sides.data = permute_scratch_.Data();
-    Permute(ordering_.permutation, *right_hand_sides, &permuted_right_hand_sides);
+    if (permute_scratch.Size() < size)
+        permute_scratch.Resize(size);
+    permuted_right_hand_sides.data = permute_scratch.Data();
+    permuted_right_hand_sides.leading_dim = right_hand_sides->height;
+    GatherRightHandSides(*right_hand_sides, &permuted_right_hand_sides,
+                         conjugate);
 #else
-    Permute(ordering_.permutation, right_hand_sides);
+    Permute(ordering_->permutation, right_hand_sides);
+    if (have_scaling) ApplyInverseInputScaling(true, right_hand_sides);
+    if (conjugate) ConjugateMatrix(right_hand_sides);
 #endif
+  } else {
+    if (have_scaling) {
+      ApplyInverseInputScaling(already_permuted, right_hand_sides);
+    }
+    if (conjugate) ConjugateMatrix(right_hand_sides);
   }
 
-  const Int max_threads = get_max_num_tbb_threads();
   if (max_threads > 1) {
-    const int old_max_threads = GetMaxBlasThreads();
-    SetNumBlasThreads(1);
-
-    // Set up the shared state holding the "supernode rhs" arrays.
-    // In order to allow the number of rhs to change without updating
-    // the offsets, we use a "column major" storage  where all
-    // supdernodes' data for the first rhs column comes first, followed
-    // by the data for the second column (if any), and so on.
-    const Int num_supernodes = ordering_.supernode_sizes.Size();
-    RightLookingSharedState<Field> &shared_state = solve_shared_state_;
-
-    {
-        // BENCHMARK_SCOPED_TIMER_SECTION timer("Allocate");
-        const Int num_rhs = right_hand_sides->width;
-
-        auto &scb = shared_state.schur_complement_buffers;
-        Int total_degree;
-        if (scb.Size() != 1) {
-            // First time allocating
-            scb.Resize(1);
-
-            total_degree = 0;
+    const int old_max_threads = own_workspace ? GetMaxBlasThreads() : 0;
+    if (own_workspace) SetNumBlasThreads(1);
+
+    // Set up the shared state holding the "supernode rhs" arrays. Each
+    // supernode's array is stored contiguously (with leading dimension equal
+    // to its degree) so that its panel is not strided across the arrays of
+    // all other supernodes. Wide right-hand sides are processed in column
+    // blocks of at most `solve_rhs_block_size` columns, which all reuse the
+    // same packed arrays.
+    const Int num_supernodes = ordering_->supernode_sizes.Size();
+    RightLookingSharedState<Field> &shared_state = workspace->shared_state;
+
+    const Int num_rhs = permuted_right_hand_sides.width;
+    const Int block_size = (control_.solve_rhs_block_size > 0)
+        ? std::min(num_rhs, control_.solve_rhs_block_size) : num_rhs;
+    LayoutSolveWorkspace(block_size, workspace,
+                         control_.stack_solve_workspace);
+
+    for (Int block_start = 0; block_start < num_rhs; block_start += block_size) {
+        const Int block_width = std::min(block_size, num_rhs - block_start);
+        BlasMatrixView<Field> block_right_hand_sides = permuted_right_hand_sides.Submatrix(
+                0, block_start, permuted_right_hand_sides.height, block_width);
+        if (shared_state.schur_complements.Size() && (shared_state.schur_complements[0].width != block_width)) {
             for (Int supernode = 0; supernode < num_supernodes; ++supernode)
-                total_degree += lower_factor_->blocks[supernode].height;
-
-            shared_state.schur_complements.Resize(num_supernodes);
-            for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-                auto &supernode_rhs = shared_state.schur_complements[supernode];
-                supernode_rhs.height = lower_factor_->blocks[supernode].height;
-                supernode_rhs.leading_dim = total_degree;
-            }
-        }
-        else {
-            // The leading dimension of each schur_complements matrix view
-            // is the total degree...
-            if (shared_state.schur_complements.Size() != num_supernodes) throw std::runtime_error("Unexpected size change");
-            total_degree = shared_state.schur_complements[0].leading_dim;
+                shared_state.schur_complements[supernode].width = block_width;
         }
 
-        Int total_size = total_degree * num_rhs;
-        Buffer<Field> &workspace_buffer = scb[0];
-        bool realloc = (total_size > workspace_buffer.Size());
-        if (realloc) workspace_buffer.Resize(total_size);
-        bool num_rhs_changed = shared_state.schur_complements[0].width != num_rhs;
-
-        if (realloc) {
-            Int offset = 0;
-            for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
-                const Int degree = lower_factor_->blocks[supernode].height;
-                auto &supernode_rhs = shared_state.schur_complements[supernode];
-                supernode_rhs.width = num_rhs; // num_rhs must also have changed to trigger a realloc!
-                supernode_rhs.data = workspace_buffer.Data() + offset;
-                offset += degree;
-            }
-        }
-        else if (num_rhs_changed) {
-            // num_rhs has shrunk, meaning we just must update each supernode_rhs.width
-            for (Int supernode = 0; supernode < num_supernodes; ++supernode)
-                shared_state.schur_complements[supernode].width = num_rhs;
+        BlasMatrixView<Field> block_unpermuted_right_hand_sides;
+        if (fused_permutation) {
+            block_unpermuted_right_hand_sides = right_hand_sides->Submatrix(
+                0, block_start, right_hand_sides->height, block_width);
+            shared_state.unpermuted_right_hand_sides = &block_unpermuted_right_hand_sides;
         }
-    }
 
-    {
-        OpenMPLowerTriangularSolve(&permuted_right_hand_sides, &shared_state);
-        OpenMPDiagonalSolve(&permuted_right_hand_sides);
-        OpenMPLowerTransposeTriangularSolve(&permuted_right_hand_sides, &shared_state);
+        OpenMPLowerTriangularSolve(&block_right_hand_sides, &shared_state);
+        OpenMPDiagonalSolve(&block_right_hand_sides);
+        OpenMPLowerTransposeTriangularSolve(&block_right_hand_sides, &shared_state);
+        shared_state.unpermuted_right_hand_sides = nullptr;
     }
 
-    SetNumBlasThreads(old_max_threads);
+    if (own_workspace) SetNumBlasThreads(old_max_threads);
 
   } else {
       LowerTriangularSolve(&permuted_right_hand_sides);
@@ -126,13 +136,327 @@ void Factorization<Field>::Solve(
   }
 
   // Reverse the factorization permutation.
-  if (needs_permutation) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("IPermute");
+  if (needs_permutation && !fused_permutation) {
+    TraceScope trace_scope("IPermute");
 #if SOLVE_PERMUTE_SCRATCH
-    Permute(ordering_.inverse_permutation, permuted_right_hand_sides, right_hand_sides);
+    ScatterRightHandSides(permuted_right_hand_sides, right_hand_sides,
+                          conjugate);
 #else
-    Permute(ordering_.inverse_permutation, right_hand_sides);
+    Permute(ordering_->inverse_permutation, right_hand_sides);
+    if (have_scaling) ApplyInverseInputScaling(false, right_hand_sides);
+    if (conjugate) ConjugateMatrix(right_hand_sides);
 #endif
+  } else if (!needs_permutation) {
+    if (have_scaling) {
+      ApplyInverseInputScaling(already_permuted, right_hand_sides);
+    }
+    if (conjugate) ConjugateMatrix(right_hand_sides);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::Solve(BlasMatrixView<Field>* right_hand_sides,
+                                 SolveOperation operation,
+                                 SolveWorkspace<Field>* workspace) const {
+  // Complex-symmetric matrices are their own transposes and Hermitian
+  // matrices their own adjoints; the remaining operators are conjugates.
+  const bool symmetric =
+      control_.factorization_type == kLDLTransposeFactorization;
+  const bool conjugate =
+      IsComplex<Field>::value &&
+      (operation == kSolveConjugate ||
+       operation == (symmetric ? kSolveAdjoint : kSolveTranspose));
+  if (!conjugate) {
+    Solve(right_hand_sides, workspace);
+    return;
+  }
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error("Solves require a complete factorization");
+  }
+  RightLookingSharedState<Field>& shared_state =
+      workspace ? workspace->shared_state : solve_workspace_.shared_state;
+  shared_state.conjugate_right_hand_sides = true;
+  Solve(right_hand_sides, workspace);
+  shared_state.conjugate_right_hand_sides = false;
+}
+
+template <class Field>
+void Factorization<Field>::PrepareSolve(
+    Int max_num_rhs, SolveWorkspace<Field>* workspace) const {
+  if (workspace == nullptr) workspace = &solve_workspace_;
+  const Int size = max_num_rhs * NumRows();
+  if (!ordering_->permutation.Empty() &&
+      workspace->permute_scratch.Size() < size) {
+    workspace->permute_scratch.Resize(size);
+  }
+  if (get_max_num_tbb_threads() > 1) {
+    const Int block_size = control_.solve_rhs_block_size > 0
+                               ? std::min(max_num_rhs,
+                                          control_.solve_rhs_block_size)
+                               : max_num_rhs;
+    LayoutSolveWorkspace(block_size, workspace,
+                         control_.stack_solve_workspace);
+  }
+}
+
+template <class Field>
+void Factorization<Field>::LayoutSolveWorkspace(
+    Int block_size, SolveWorkspace<Field>* workspace, bool stacked) const {
+    // TraceScope trace_scope("Allocate");
+    const Int num_supernodes = ordering_->supernode_sizes.Size();
+    RightLookingSharedState<Field> &shared_state = workspace->shared_state;
+    auto &scb = shared_state.schur_complement_buffers;
+    if (scb.Size() != 1) scb.Resize(1);
+
+    // A stacked layout gives storage to the same supernodes as the partition
+    // of the forward solve of the widest block; those of narrower blocks are
+    // a subset.
+    const double min_parallel_work =
+        control_.min_parallel_solve_threshold / std::max<Int>(block_size, 1);
+    auto dedicated = [&](Int supernode) {
+        return !stacked || DedicatedSolveUpdate(supernode, min_parallel_work);
+    };
+
+    // A workspace may have last been laid out for a factorization with a
+    // different structure or for a stacked solve which left this one's
+    // supernodes without storage.
+    bool relayout = shared_state.schur_complements.Size() != num_supernodes;
+    for (Int supernode = 0; !relayout && supernode < num_supernodes; ++supernode) {
+        const auto &supernode_rhs = shared_state.schur_complements[supernode];
+        relayout = supernode_rhs.height !=
+                   lower_factor_->blocks[supernode].height ||
+                   (supernode_rhs.height && !supernode_rhs.data &&
+                    dedicated(supernode));
+    }
+    if (relayout) {
+        shared_state.schur_complements.Resize(num_supernodes);
+        for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+            auto &supernode_rhs = shared_state.schur_complements[supernode];
+            supernode_rhs.height = lower_factor_->blocks[supernode].height;
+            supernode_rhs.leading_dim = std::max<Int>(supernode_rhs.height, 1);
+            supernode_rhs.width = 0;
+            supernode_rhs.data = nullptr;
+        }
+    }
+
+    // The arrays are laid out for the largest block width requested so
+    // far; narrower blocks only need their widths updated.
+    Buffer<Field> &workspace_buffer = scb[0];
+    Int total_degree = 0;
+    for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+        if (dedicated(supernode))
+            total_degree += lower_factor_->blocks[supernode].height;
+    }
+    const Int capacity = total_degree ? workspace_buffer.Size() / total_degree : 0;
+    if (total_degree && (relayout || (capacity < block_size))) {
+        const Int new_capacity = std::max(capacity, block_size);
+        if (capacity < block_size) workspace_buffer.Resize(total_degree * block_size);
+        Int offset = 0;
+        for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+            auto &supernode_rhs = shared_state.schur_complements[supernode];
+            if (!dedicated(supernode)) {
+                supernode_rhs.data = nullptr;
+                continue;
+            }
+            supernode_rhs.data = workspace_buffer.Data() + offset;
+            offset += supernode_rhs.height * new_capacity;
+        }
+    }
+}
+
+template <class Field>
+void Factorization<Field>::BeginFusedSolve(
+    BlasMatrixView<Field>* right_hand_sides) {
+  SolveWorkspace<Field>& workspace = solve_workspace_;
+  const Int num_rhs = right_hand_sides->width;
+  fused_right_hand_sides_ = *right_hand_sides;
+  if (!ordering_->permutation.Empty()) {
+    // Each supernode's rows are gathered from the caller's ordering just
+    // before it is eliminated and scattered back by the backward solve.
+    const Int size = num_rhs * right_hand_sides->height;
+    if (workspace.permute_scratch.Size() < size) {
+      workspace.permute_scratch.Resize(size);
+    }
+    fused_right_hand_sides_.data = workspace.permute_scratch.Data();
+    fused_right_hand_sides_.leading_dim = right_hand_sides->height;
+    workspace.shared_state.unpermuted_right_hand_sides = right_hand_sides;
+  } else if (!input_scaling_.Empty()) {
+    ApplyInverseInputScaling(false, right_hand_sides);
+  }
+
+  // The supernodes are eliminated in whatever order the factorization
+  // finishes them, so all of the right-hand sides form a single block.
+  LayoutSolveWorkspace(std::max<Int>(num_rhs, 1), &workspace);
+  for (BlasMatrixView<Field>& supernode_rhs :
+       workspace.shared_state.schur_complements) {
+    supernode_rhs.width = num_rhs;
+  }
+  fused_solve_ = true;
+}
+
+template <class Field>
+void Factorization<Field>::FusedForwardSolveSupernode(Int supernode) {
+  if (!fused_solve_) return;
+  OpenMPLowerTriangularSolveSupernode(supernode, &fused_right_hand_sides_,
+                                      &solve_workspace_.shared_state);
+}
+
+template <class Field>
+void Factorization<Field>::EndFusedSolve(
+    bool factored, BlasMatrixView<Field>* right_hand_sides) {
+  RightLookingSharedState<Field>& shared_state = solve_workspace_.shared_state;
+  fused_solve_ = false;
+  if (factored) {
+    const int old_max_threads = GetMaxBlasThreads();
+    SetNumBlasThreads(1);
+    OpenMPDiagonalSolve(&fused_right_hand_sides_);
+    OpenMPLowerTransposeTriangularSolve(&fused_right_hand_sides_,
+                                        &shared_state);
+    SetNumBlasThreads(old_max_threads);
+    if (ordering_->permutation.Empty() && !input_scaling_.Empty()) {
+      ApplyInverseInputScaling(false, right_hand_sides);
+    }
+  }
+  shared_state.unpermuted_right_hand_sides = nullptr;
+  fused_right_hand_sides_ = BlasMatrixView<Field>();
+}
+
+template <class Field>
+void Factorization<Field>::GatherRightHandSides(
+    const BlasMatrixView<Field>& unpermuted_right_hand_sides,
+    BlasMatrixView<Field>* right_hand_sides, bool conjugate) const {
+  if (conjugate) {
+    const Int num_rows = right_hand_sides->height;
+    const Int* permutation = ordering_->permutation.Data();
+    const bool have_scaling = !input_scaling_.Empty();
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      const Field* input_col = unpermuted_right_hand_sides.Pointer(0, j);
+      Field* rhs_col = right_hand_sides->Pointer(0, j);
+      for (Int i = 0; i < num_rows; ++i) {
+        Field value = Conjugate(input_col[i]);
+        if (have_scaling) value /= input_scaling_[i];
+        rhs_col[permutation[i]] = value;
+      }
+    }
+    return;
+  }
+  if (input_scaling_.Empty()) {
+    Permute(ordering_->permutation, unpermuted_right_hand_sides,
+            right_hand_sides);
+    return;
+  }
+  const Int num_rows = right_hand_sides->height;
+  const Int* permutation = ordering_->permutation.Data();
+  const ComplexBase<Field>* scaling = input_scaling_.Data();
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    const Field* input_col = unpermuted_right_hand_sides.Pointer(0, j);
+    Field* rhs_col = right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < num_rows; ++i) {
+      rhs_col[permutation[i]] = input_col[i] / scaling[i];
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::ScatterRightHandSides(
+    const BlasMatrixView<Field>& right_hand_sides,
+    BlasMatrixView<Field>* unpermuted_right_hand_sides, bool conjugate) const {
+  if (conjugate) {
+    const Int num_rows = right_hand_sides.height;
+    const Int* inverse_permutation = ordering_->inverse_permutation.Data();
+    const bool have_scaling = !input_scaling_.Empty();
+    for (Int j = 0; j < right_hand_sides.width; ++j) {
+      const Field* rhs_col = right_hand_sides.Pointer(0, j);
+      Field* output_col = unpermuted_right_hand_sides->Pointer(0, j);
+      for (Int i = 0; i < num_rows; ++i) {
+        const Int row = inverse_permutation[i];
+        output_col[row] = Conjugate(rhs_col[i]);
+        if (have_scaling) output_col[row] /= input_scaling_[row];
+      }
+    }
+    return;
+  }
+  if (input_scaling_.Empty()) {
+    Permute(ordering_->inverse_permutation, right_hand_sides,
+            unpermuted_right_hand_sides);
+    return;
+  }
+  const Int num_rows = right_hand_sides.height;
+  const Int* inverse_permutation = ordering_->inverse_permutation.Data();
+  const ComplexBase<Field>* scaling = input_scaling_.Data();
+  for (Int j = 0; j < right_hand_sides.width; ++j) {
+    const Field* rhs_col = right_hand_sides.Pointer(0, j);
+    Field* output_col = unpermuted_right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < num_rows; ++i) {
+      const Int row = inverse_permutation[i];
+      output_col[row] = rhs_col[i] / scaling[row];
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::ApplyInverseInputScaling(
+    bool permuted, BlasMatrixView<Field>* right_hand_sides) const {
+  const bool have_permutation = permuted && !ordering_->permutation.Empty();
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    Field* column = right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < right_hand_sides->height; ++i) {
+      const Int row = have_permutation ? ordering_->inverse_permutation[i] : i;
+      column[i] /= input_scaling_[row];
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::ScatterSubtractStructure(
+    Int supernode, const ConstBlasMatrixView<Field>& updates,
+    BlasMatrixView<Field>* right_hand_sides) const {
+  const IndexRunList& runs = lower_factor_->StructureRuns();
+  if (runs.Encoded(supernode)) {
+    for (Int j = 0; j < updates.width; ++j) {
+            Field * rhs_ptr = right_hand_sides->Pointer(0, j);
+      const Field *wrhs_ptr = updates.Pointer(0, j);
+      ForEachIndexRun(runs.Beg(supernode), runs.End(supernode), 0,
+                      [&](Int position, Int index, Int length) {
+                        for (Int i = 0; i < length; ++i)
+                          rhs_ptr[index + i] -= wrhs_ptr[position + i];
+                      });
+    }
+    return;
+  }
+  const Int* indices = lower_factor_->StructureBeg(supernode);
+  for (Int j = 0; j < updates.width; ++j) {
+          Field * rhs_ptr = right_hand_sides->Pointer(0, j);
+    const Field *wrhs_ptr = updates.Pointer(0, j);
+    for (Int i = 0; i < updates.height; ++i) {
+      rhs_ptr[indices[i]] -= wrhs_ptr[i];
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::GatherStructure(
+    Int supernode, const BlasMatrixView<Field>& right_hand_sides,
+    BlasMatrixView<Field>* packed_right_hand_sides) const {
+  const IndexRunList& runs = lower_factor_->StructureRuns();
+  if (runs.Encoded(supernode)) {
+    for (Int j = 0; j < packed_right_hand_sides->width; ++j) {
+            Field *wrhs_ptr = packed_right_hand_sides->Pointer(0, j);
+      const Field * rhs_ptr = right_hand_sides.Pointer(0, j);
+      ForEachIndexRun(runs.Beg(supernode), runs.End(supernode), 0,
+                      [&](Int position, Int index, Int length) {
+                        std::copy(rhs_ptr + index, rhs_ptr + index + length,
+                                  wrhs_ptr + position);
+                      });
+    }
+    return;
+  }
+  const Int* indices = lower_factor_->StructureBeg(supernode);
+  for (Int j = 0; j < packed_right_hand_sides->width; ++j) {
+          Field *wrhs_ptr = packed_right_hand_sides->Pointer(0, j);
+    const Field * rhs_ptr = right_hand_sides.Pointer(0, j);
+    for (Int i = 0; i < packed_right_hand_sides->height; ++i)
+      wrhs_ptr[i] = rhs_ptr[indices[i]];
   }
 }
 
@@ -144,11 +468,13 @@ void Factorization<Field>::LowerSupernodalTrapezoidalSolve(
   const Int num_rhs = right_hand_sides->width;
   const bool is_cholesky =
       control_.factorization_type == kCholeskyFactorization;
+  const bool row_panels = !solve_panels_.Empty();
   const ConstBlasMatrixView<Field> triangular_right_hand_sides =
-      diagonal_factor_->blocks[supernode];
+      row_panels ? solve_diagonal_blocks_[supernode]
+                 : diagonal_factor_->blocks[supernode];
 
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
   BlasMatrixView<Field> right_hand_sides_supernode =
       right_hand_sides->Submatrix(supernode_start, 0, supernode_size, num_rhs);
 
@@ -174,7 +500,34 @@ void Factorization<Field>::LowerSupernodalTrapezoidalSolve(
 
   // Handle the external updates for this supernode.
   const Int* indices = lower_factor_->StructureBeg(supernode);
-  if (supernode_size >= control_.forward_solve_out_of_place_supernode_threshold) {
+  if (block_low_rank_factor_.Compressed(supernode) ||
+      device_offload_.Resident(supernode)) {
+    // Form the updates from the compressed tiles or from the device copy of
+    // the subdiagonal block.
+    BlasMatrixView<Field> work_right_hand_sides;
+    work_right_hand_sides.height = subdiagonal.height;
+    work_right_hand_sides.width = num_rhs;
+    work_right_hand_sides.leading_dim = subdiagonal.height;
+    work_right_hand_sides.data = workspace->Data();
+    std::fill(workspace->Data(),
+              workspace->Data() + subdiagonal.height * num_rhs, Field{0});
+    if (block_low_rank_factor_.Compressed(supernode)) {
+      block_low_rank_factor_.MultiplyNormal(
+          supernode, Field{1}, right_hand_sides_supernode.ToConst(),
+          &work_right_hand_sides);
+    } else if (!device_offload_.MultiplyNormal(
+                   supernode, Field{1}, right_hand_sides_supernode.ToConst(),
+                   &work_right_hand_sides)) {
+      MatrixMultiplyNormalNormal(Field{1}, subdiagonal,
+                                 right_hand_sides_supernode.ToConst(),
+                                 Field{1}, &work_right_hand_sides);
+    }
+    ScatterSubtractStructure(supernode, work_right_hand_sides.ToConst(),
+                             right_hand_sides);
+  } else if (row_panels) {
+    LowerRowPanelUpdate(supernode, right_hand_sides_supernode.ToConst(),
+                        right_hand_sides, workspace);
+  } else if (supernode_size >= control_.forward_solve_out_of_place_supernode_threshold) {
     // Perform an out-of-place GEMM.
     BlasMatrixView<Field> work_right_hand_sides;
     work_right_hand_sides.height = subdiagonal.height;
@@ -188,13 +541,8 @@ void Factorization<Field>::LowerSupernodalTrapezoidalSolve(
                                &work_right_hand_sides);
 
     // Accumulate the workspace into the solution right_hand_sides.
-    for (Int j = 0; j < num_rhs; ++j) {
-            Field * rhs_ptr = right_hand_sides->Pointer(0, j);
-      const Field *wrhs_ptr = work_right_hand_sides.Pointer(0, j);
-      for (Int i = 0; i < subdiagonal.height; ++i) {
-        rhs_ptr[indices[i]] -= wrhs_ptr[i];
-      }
-    }
+    ScatterSubtractStructure(supernode, work_right_hand_sides.ToConst(),
+                             right_hand_sides);
   } else {
     for (Int j = 0; j < num_rhs; ++j) {
       const Field *srhs_ptr = right_hand_sides_supernode.Pointer(0, j);
@@ -256,17 +604,69 @@ void Factorization<Field>::LowerSupernodalTrapezoidalSolve(
   }
 }
 
+template <class Field>
+void Factorization<Field>::LowerRowPanelUpdate(
+    Int supernode, const ConstBlasMatrixView<Field>& right_hand_sides_supernode,
+    BlasMatrixView<Field>* right_hand_sides, Buffer<Field>* workspace) const {
+  const ConstBlasMatrixView<Field> panel = solve_panels_[supernode];
+  const Int num_rhs = right_hand_sides->width;
+  const Int supernode_size = panel.height;
+  const Int degree = panel.width;
+  const bool is_selfadjoint =
+      control_.factorization_type != kLDLTransposeFactorization;
+  const Int* indices = lower_factor_->StructureBeg(supernode);
+
+  if (supernode_size >= control_.forward_solve_out_of_place_supernode_threshold) {
+    // Perform an out-of-place GEMM against the (transposed) panel.
+    BlasMatrixView<Field> work_right_hand_sides;
+    work_right_hand_sides.height = degree;
+    work_right_hand_sides.width = num_rhs;
+    work_right_hand_sides.leading_dim = degree;
+    work_right_hand_sides.data = workspace->Data();
+    if (is_selfadjoint) {
+      MatrixMultiplyAdjointNormal(Field{1}, panel, right_hand_sides_supernode,
+                                  Field{0}, &work_right_hand_sides);
+    } else {
+      MatrixMultiplyTransposeNormal(Field{1}, panel, right_hand_sides_supernode,
+                                    Field{0}, &work_right_hand_sides);
+    }
+
+    ScatterSubtractStructure(supernode, work_right_hand_sides.ToConst(),
+                             right_hand_sides);
+    return;
+  }
+
+  // Each update is the dot product of a contiguous column of the panel with
+  // the supernode's portion of the solution.
+  for (Int j = 0; j < num_rhs; ++j) {
+    const Field *srhs_ptr = right_hand_sides_supernode.Pointer(0, j);
+          Field * rhs_ptr = right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < degree; ++i) {
+      const Field* panel_ptr = panel.Pointer(0, i);
+      Field val = 0;
+      if (is_selfadjoint) {
+        for (Int k = 0; k < supernode_size; ++k)
+          val += Conjugate(panel_ptr[k]) * srhs_ptr[k];
+      } else {
+        for (Int k = 0; k < supernode_size; ++k)
+          val += panel_ptr[k] * srhs_ptr[k];
+      }
+      rhs_ptr[indices[i]] -= val;
+    }
+  }
+}
+
 template <class Field>
 void Factorization<Field>::LowerTriangularSolveRecursion(
     Int supernode, BlasMatrixView<Field>* right_hand_sides,
     Buffer<Field>* workspace) const {
   // Recurse on this supernode's children.
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
-        ordering_.assembly_forest.children[child_beg + child_index];
+        ordering_->assembly_forest.children[child_beg + child_index];
     LowerTriangularSolveRecursion(child, right_hand_sides, workspace);
   }
 
@@ -277,16 +677,16 @@ void Factorization<Field>::LowerTriangularSolveRecursion(
 template <class Field>
 void Factorization<Field>::LowerTriangularSolve(
     BlasMatrixView<Field>* right_hand_sides) const {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("LowerTriangularSolve");
+  TraceScope trace_scope("LowerTriangularSolve");
 
   // Allocate the workspace.
   const Int workspace_size = max_degree_ * right_hand_sides->width;
   Buffer<Field> workspace(workspace_size, Field{0});
 
   // Recurse on each tree in the elimination forest.
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
+  const Int num_roots = ordering_->assembly_forest.roots.Size();
   for (Int root_index = 0; root_index < num_roots; ++root_index) {
-    const Int root = ordering_.assembly_forest.roots[root_index];
+    const Int root = ordering_->assembly_forest.roots[root_index];
     LowerTriangularSolveRecursion(root, right_hand_sides, &workspace);
   }
 }
@@ -295,7 +695,7 @@ template <class Field>
 void Factorization<Field>::DiagonalSolve(
     BlasMatrixView<Field>* right_hand_sides) const {
   const Int num_rhs = right_hand_sides->width;
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
   const bool is_cholesky =
       control_.factorization_type == kCholeskyFactorization;
   if (is_cholesky) {
@@ -307,8 +707,8 @@ void Factorization<Field>::DiagonalSolve(
     const ConstBlasMatrixView<Field> diagonal_right_hand_sides =
         diagonal_factor_->blocks[supernode];
 
-    const Int supernode_size = ordering_.supernode_sizes[supernode];
-    const Int supernode_start = ordering_.supernode_offsets[supernode];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int supernode_start = ordering_->supernode_offsets[supernode];
     BlasMatrixView<Field> right_hand_sides_supernode =
         right_hand_sides->Submatrix(supernode_start, 0, supernode_size,
                                     num_rhs);
@@ -320,6 +720,17 @@ void Factorization<Field>::DiagonalSolve(
       }
     }
   }
+  ZeroSingularPivots(right_hand_sides);
+}
+
+template <class Field>
+void Factorization<Field>::ZeroSingularPivots(
+    BlasMatrixView<Field>* right_hand_sides) const {
+  for (const Int& pivot : singular_pivots_) {
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      right_hand_sides->Entry(pivot, j) = Field{0};
+    }
+  }
 }
 
 template <class Field>
@@ -345,25 +756,56 @@ void Factorization<Field>::LowerTransposeSupernodalTrapezoidalSolve(
   const Int num_rhs = right_hand_sides->width;
   const bool is_selfadjoint =
       control_.factorization_type != kLDLTransposeFactorization;
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
   const Int* indices = lower_factor_->StructureBeg(supernode);
 
   BlasMatrixView<Field> right_hand_sides_supernode =
       right_hand_sides->Submatrix(supernode_start, 0, supernode_size, num_rhs);
 
+  const bool row_panels = !solve_panels_.Empty();
   const ConstBlasMatrixView<Field> & subdiagonal =
       lower_factor_->blocks[supernode];
   if (subdiagonal.height) {
     // Handle the external updates for this supernode.
-    if (supernode_size >= control_.backward_solve_out_of_place_supernode_threshold) {
-      // Fill the work right_hand_sides.
-      for (Int j = 0; j < num_rhs; ++j) {
-        Field *wrhs_ptr = work_right_hand_sides. Pointer(0, j);
-        Field * rhs_ptr =      right_hand_sides->Pointer(0, j);
-        for (Int i = 0; i < subdiagonal.height; ++i)
-          wrhs_ptr[i] = rhs_ptr[indices[i]];
+    if (block_low_rank_factor_.Compressed(supernode)) {
+      GatherStructure(supernode, *right_hand_sides, &work_right_hand_sides);
+      if (is_selfadjoint) {
+        block_low_rank_factor_.MultiplyAdjoint(
+            supernode, Field{-1}, work_right_hand_sides.ToConst(),
+            &right_hand_sides_supernode);
+      } else {
+        block_low_rank_factor_.MultiplyTranspose(
+            supernode, Field{-1}, work_right_hand_sides.ToConst(),
+            &right_hand_sides_supernode);
+      }
+    } else if (device_offload_.Resident(supernode)) {
+      // Apply the updates using the device copy of the subdiagonal block.
+      GatherStructure(supernode, *right_hand_sides, &work_right_hand_sides);
+      const bool offloaded =
+          is_selfadjoint
+              ? device_offload_.MultiplyAdjoint(
+                    supernode, Field{-1}, work_right_hand_sides.ToConst(),
+                    &right_hand_sides_supernode)
+              : device_offload_.MultiplyTranspose(
+                    supernode, Field{-1}, work_right_hand_sides.ToConst(),
+                    &right_hand_sides_supernode);
+      if (!offloaded && is_selfadjoint) {
+        MatrixMultiplyAdjointNormal(Field{-1}, subdiagonal,
+                                    work_right_hand_sides.ToConst(), Field{1},
+                                    &right_hand_sides_supernode);
+      } else if (!offloaded) {
+        MatrixMultiplyTransposeNormal(Field{-1}, subdiagonal,
+                                      work_right_hand_sides.ToConst(), Field{1},
+                                      &right_hand_sides_supernode);
       }
+    } else if (row_panels) {
+      LowerTransposeRowPanelUpdate(supernode, *right_hand_sides,
+                                   &right_hand_sides_supernode,
+                                   &work_right_hand_sides);
+    } else if (supernode_size >= control_.backward_solve_out_of_place_supernode_threshold) {
+      // Fill the work right_hand_sides.
+      GatherStructure(supernode, *right_hand_sides, &work_right_hand_sides);
 
       if (is_selfadjoint) {
         MatrixMultiplyAdjointNormal(Field{-1}, subdiagonal,
@@ -440,7 +882,8 @@ void Factorization<Field>::LowerTransposeSupernodalTrapezoidalSolve(
 
   // Solve against the diagonal block of this supernode.
   const ConstBlasMatrixView<Field> triangular_right_hand_sides =
-      diagonal_factor_->blocks[supernode];
+      row_panels ? solve_diagonal_blocks_[supernode]
+                 : diagonal_factor_->blocks[supernode];
   if (control_.factorization_type == kCholeskyFactorization) {
     LeftLowerAdjointTriangularSolvesDynamicBLASDispatch(triangular_right_hand_sides, &right_hand_sides_supernode);
   } else if (control_.factorization_type == kLDLAdjointFactorization) {
@@ -457,6 +900,41 @@ void Factorization<Field>::LowerTransposeSupernodalTrapezoidalSolve(
   }
 }
 
+template <class Field>
+void Factorization<Field>::LowerTransposeRowPanelUpdate(
+    Int supernode, const BlasMatrixView<Field>& right_hand_sides,
+    BlasMatrixView<Field>* right_hand_sides_supernode,
+    BlasMatrixView<Field>* work_right_hand_sides) const {
+  // The panel holds the adjoint (or transpose) of the subdiagonal block, so
+  // no conjugation is needed here.
+  const ConstBlasMatrixView<Field> panel = solve_panels_[supernode];
+  const Int num_rhs = right_hand_sides.width;
+  const Int supernode_size = panel.height;
+  const Int degree = panel.width;
+  const Int* indices = lower_factor_->StructureBeg(supernode);
+
+  if (supernode_size >= control_.backward_solve_out_of_place_supernode_threshold) {
+    GatherStructure(supernode, right_hand_sides, work_right_hand_sides);
+    MatrixMultiplyNormalNormal(Field{-1}, panel,
+                               work_right_hand_sides->ToConst(), Field{1},
+                               right_hand_sides_supernode);
+    return;
+  }
+
+  // Each ancestor row subtracts a multiple of a contiguous column of the
+  // panel from the supernode's portion of the solution.
+  for (Int j = 0; j < num_rhs; ++j) {
+    const Field *rhs_ptr = right_hand_sides.Pointer(0, j);
+    Field *srhs_ptr = right_hand_sides_supernode->Pointer(0, j);
+    for (Int i = 0; i < degree; ++i) {
+      const Field eta = rhs_ptr[indices[i]];
+      const Field* panel_ptr = panel.Pointer(0, i);
+      for (Int k = 0; k < supernode_size; ++k)
+        srhs_ptr[k] -= panel_ptr[k] * eta;
+    }
+  }
+}
+
 template <class Field>
 void Factorization<Field>::LowerTransposeTriangularSolveRecursion(
     Int supernode, BlasMatrixView<Field>* right_hand_sides,
@@ -466,12 +944,12 @@ void Factorization<Field>::LowerTransposeTriangularSolveRecursion(
                                            packed_input_buf);
 
   // Recurse on this supernode's children.
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
   const Int num_children = child_end - child_beg;
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
-        ordering_.assembly_forest.children[child_beg + child_index];
+        ordering_->assembly_forest.children[child_beg + child_index];
     LowerTransposeTriangularSolveRecursion(child, right_hand_sides,
                                            packed_input_buf);
   }
@@ -480,16 +958,16 @@ void Factorization<Field>::LowerTransposeTriangularSolveRecursion(
 template <class Field>
 void Factorization<Field>::LowerTransposeTriangularSolve(
     BlasMatrixView<Field>* right_hand_sides) const {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("LowerTransposeTriangularSolve");
+  TraceScope trace_scope("LowerTransposeTriangularSolve");
 
   // Allocate the workspace.
   const Int workspace_size = max_degree_ * right_hand_sides->width;
   Buffer<Field> packed_input_buf(workspace_size);
 
   // Recurse from each root of the elimination forest.
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
+  const Int num_roots = ordering_->assembly_forest.roots.Size();
   for (Int root_index = 0; root_index < num_roots; ++root_index) {
-    const Int root = ordering_.assembly_forest.roots[root_index];
+    const Int root = ordering_->assembly_forest.roots[root_index];
     LowerTransposeTriangularSolveRecursion(root, right_hand_sides,
                                            &packed_input_buf);
   }
@@ -9,18 +9,21 @@
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SOLVE_OPENMP_IMPL_H_
 
 #include <algorithm>
+#include <atomic>
 #include <catamari/dense_basic_linear_algebra-impl.hpp>
+#include <memory>
 #include <queue>
+#include <vector>
 #include <stdexcept>
 
 #include <tbb/task_group.h>
 
 #include "catamari/dense_basic_linear_algebra.hpp"
 #include "catamari/dense_factorizations.hpp"
+#include "catamari/trace.hpp"
 
 #include "catamari/sparse_ldl/supernodal/factorization.hpp"
 
-#include "../../../../../../../src/lib/MeshFEM/GlobalBenchmark.hh"
 
 namespace catamari {
 namespace supernodal_ldl {
@@ -33,11 +36,13 @@ void Factorization<Field>::OpenMPLowerSupernodalTrapezoidalSolve(
   const Int num_rhs = right_hand_sides->width;
   const bool is_cholesky =
       control_.factorization_type == kCholeskyFactorization;
+  const bool row_panels = !solve_panels_.Empty();
   const ConstBlasMatrixView<Field> triangular_right_hand_sides =
-      diagonal_factor_->blocks[supernode];
+      row_panels ? solve_diagonal_blocks_[supernode]
+                 : diagonal_factor_->blocks[supernode];
 
-  const Int supernode_size = ordering_.supernode_sizes[supernode];
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
   BlasMatrixView<Field> right_hand_sides_supernode =
       right_hand_sides->Submatrix(supernode_start, 0, supernode_size, num_rhs);
 
@@ -62,7 +67,31 @@ void Factorization<Field>::OpenMPLowerSupernodalTrapezoidalSolve(
   }
 
   // Store the updates in the workspace.
-  if (true) {
+  if (block_low_rank_factor_.Compressed(supernode)) {
+      block_low_rank_factor_.MultiplyNormal(
+          supernode, Field{-1}, right_hand_sides_supernode.ToConst(),
+          supernode_schur_complement);
+  }
+  else if (device_offload_.Resident(supernode) &&
+           device_offload_.MultiplyNormal(
+               supernode, Field{-1}, right_hand_sides_supernode.ToConst(),
+               supernode_schur_complement)) {
+      // The updates were formed from the device copy of the subdiagonal
+      // block.
+  }
+  else if (row_panels) {
+      const ConstBlasMatrixView<Field> panel = solve_panels_[supernode];
+      if (control_.factorization_type != kLDLTransposeFactorization) {
+          MatrixMultiplyAdjointNormal(Field{-1}, panel,
+                                      right_hand_sides_supernode.ToConst(),
+                                      Field{1}, supernode_schur_complement);
+      } else {
+          MatrixMultiplyTransposeNormal(Field{-1}, panel,
+                                        right_hand_sides_supernode.ToConst(),
+                                        Field{1}, supernode_schur_complement);
+      }
+  }
+  else if (true) {
       MatrixMultiplyNormalNormal(Field{-1}, subdiagonal,
                                  right_hand_sides_supernode.ToConst(), Field{1},
                                  supernode_schur_complement);
@@ -88,20 +117,107 @@ void Factorization<Field>::OpenMPLowerSupernodalTrapezoidalSolve(
   }
 }
 
+template <class Field>
+void Factorization<Field>::GatherSupernodeRightHandSides(
+    Int supernode, const BlasMatrixView<Field>& unpermuted_right_hand_sides,
+    BlasMatrixView<Field>* right_hand_sides, bool conjugate) const {
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int* inverse_permutation =
+      ordering_->inverse_permutation.Data() + supernode_start;
+  if (conjugate) {
+    const bool have_scaling = !input_scaling_.Empty();
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      const Field* input_col = unpermuted_right_hand_sides.Pointer(0, j);
+      Field* rhs_col = right_hand_sides->Pointer(supernode_start, j);
+      for (Int i = 0; i < supernode_size; ++i) {
+        const Int row = inverse_permutation[i];
+        rhs_col[i] = Conjugate(input_col[row]);
+        if (have_scaling) rhs_col[i] /= input_scaling_[row];
+      }
+    }
+    return;
+  }
+  if (!input_scaling_.Empty()) {
+    const ComplexBase<Field>* scaling = input_scaling_.Data();
+    for (Int j = 0; j < right_hand_sides->width; ++j) {
+      const Field* input_col = unpermuted_right_hand_sides.Pointer(0, j);
+      Field* rhs_col = right_hand_sides->Pointer(supernode_start, j);
+      for (Int i = 0; i < supernode_size; ++i) {
+        const Int row = inverse_permutation[i];
+        rhs_col[i] = input_col[row] / scaling[row];
+      }
+    }
+    return;
+  }
+  for (Int j = 0; j < right_hand_sides->width; ++j) {
+    const Field* input_col = unpermuted_right_hand_sides.Pointer(0, j);
+    Field* rhs_col = right_hand_sides->Pointer(supernode_start, j);
+    for (Int i = 0; i < supernode_size; ++i) {
+      rhs_col[i] = input_col[inverse_permutation[i]];
+    }
+  }
+}
+
+template <class Field>
+void Factorization<Field>::ScatterSupernodeRightHandSides(
+    Int supernode, const BlasMatrixView<Field>& right_hand_sides,
+    BlasMatrixView<Field>* unpermuted_right_hand_sides, bool conjugate) const {
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_size = ordering_->supernode_sizes[supernode];
+  const Int* inverse_permutation =
+      ordering_->inverse_permutation.Data() + supernode_start;
+  if (conjugate) {
+    const bool have_scaling = !input_scaling_.Empty();
+    for (Int j = 0; j < right_hand_sides.width; ++j) {
+      const Field* rhs_col = right_hand_sides.Pointer(supernode_start, j);
+      Field* output_col = unpermuted_right_hand_sides->Pointer(0, j);
+      for (Int i = 0; i < supernode_size; ++i) {
+        const Int row = inverse_permutation[i];
+        output_col[row] = Conjugate(rhs_col[i]);
+        if (have_scaling) output_col[row] /= input_scaling_[row];
+      }
+    }
+    return;
+  }
+  if (!input_scaling_.Empty()) {
+    const ComplexBase<Field>* scaling = input_scaling_.Data();
+    for (Int j = 0; j < right_hand_sides.width; ++j) {
+      const Field* rhs_col = right_hand_sides.Pointer(supernode_start, j);
+      Field* output_col = unpermuted_right_hand_sides->Pointer(0, j);
+      for (Int i = 0; i < supernode_size; ++i) {
+        const Int row = inverse_permutation[i];
+        output_col[row] = rhs_col[i] / scaling[row];
+      }
+    }
+    return;
+  }
+  for (Int j = 0; j < right_hand_sides.width; ++j) {
+    const Field* rhs_col = right_hand_sides.Pointer(supernode_start, j);
+    Field* output_col = unpermuted_right_hand_sides->Pointer(0, j);
+    for (Int i = 0; i < supernode_size; ++i) {
+      output_col[inverse_permutation[i]] = rhs_col[i];
+    }
+  }
+}
+
 template <class Field>
 void Factorization<Field>::OpenMPLowerTriangularSolveRecursion(
     Int supernode, BlasMatrixView<Field>* right_hand_sides,
-    RightLookingSharedState<Field>* shared_state, int level) const {
+    RightLookingSharedState<Field>* shared_state,
+    double min_parallel_work) const {
   // Recurse on this supernode's children.
-  const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-  const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
 
-  auto processChild = [&, shared_state, right_hand_sides, level](Int child_index) {
-      const Int child = ordering_.assembly_forest.children[child_index];
-      OpenMPLowerTriangularSolveRecursion(child, right_hand_sides, shared_state, level + 1);
+  auto processChild = [&, shared_state, right_hand_sides, min_parallel_work](Int child_index) {
+      const Int child = ordering_->assembly_forest.children[child_index];
+      OpenMPLowerTriangularSolveRecursion(child, right_hand_sides, shared_state, min_parallel_work);
   };
 
-  if ((child_end - child_beg) > 1 && (level < 8)) { // JP: avoid excessively fine-grained parallelism; TODO: use flop-based threshold
+  // Avoid excessively fine-grained parallelism by only spawning tasks for
+  // sufficiently expensive subtrees.
+  if ((child_end - child_beg) > 1 && (solve_work_estimates_[supernode] >= min_parallel_work)) {
       tbb::task_group group;
       for (Int child_index = child_beg; child_index < child_end - 1; ++child_index) {
           group.run([&processChild, child_index]() { processChild(child_index); });
@@ -115,77 +231,272 @@ void Factorization<Field>::OpenMPLowerTriangularSolveRecursion(
       }
   }
 
-  const Int supernode_start = ordering_.supernode_offsets[supernode];
-  const Int supernode_size  = ordering_.supernode_sizes[supernode];
-  const Int* main_indices   = lower_factor_->StructureBeg(supernode);
+  OpenMPLowerTriangularSolveSupernode(supernode, right_hand_sides, shared_state);
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPLowerTriangularSolveSupernode(
+    Int supernode, BlasMatrixView<Field>* right_hand_sides,
+    RightLookingSharedState<Field>* shared_state) const {
+  TraceScope trace_scope("forward_solve", supernode);
+  BeginLowerTriangularSolveSupernode(supernode, right_hand_sides, shared_state);
 
   // Merge the child Schur complements into the parent.
-  const Int degree = lower_factor_->blocks[supernode].height;
-  const Int num_rhs = right_hand_sides->width;
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
+  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+    const Int child = ordering_->assembly_forest.children[child_index];
+    MergeChildSolveUpdate(supernode, child,
+                          shared_state->schur_complements[child],
+                          right_hand_sides,
+                          &shared_state->schur_complements[supernode]);
+  }
 
+  FinishLowerTriangularSolveSupernode(supernode, right_hand_sides,
+                                      shared_state);
+}
+
+template <class Field>
+void Factorization<Field>::BeginLowerTriangularSolveSupernode(
+    Int supernode, BlasMatrixView<Field>* right_hand_sides,
+    RightLookingSharedState<Field>* shared_state) const {
+  // No other supernode writes into this one's rows of the right-hand sides,
+  // so they can be gathered from the caller's ordering only now.
+  if (shared_state->unpermuted_right_hand_sides) {
+    GatherSupernodeRightHandSides(
+        supernode, *shared_state->unpermuted_right_hand_sides,
+        right_hand_sides, shared_state->conjugate_right_hand_sides);
+  }
+
+  const Int num_rhs = right_hand_sides->width;
   BlasMatrixView<Field>& main_right_hand_sides = shared_state->schur_complements[supernode];
 
   using  VecMap = Eigen::Map<Eigen::Matrix<Field, Eigen::Dynamic, 1>>;
-  using CVecMap = Eigen::Map<const Eigen::Matrix<Field, Eigen::Dynamic, 1>>;
   // eigenMap(main_right_hand_sides).setZero(); // <----- this doesn't account for the stride/height mismatch in main_right_hand_sides!!!!!
   for (Int j = 0; j < num_rhs; ++j)
     VecMap(main_right_hand_sides.Pointer(0, j), main_right_hand_sides.height).setZero();
+}
 
-  auto &ncdi = ordering_.assembly_forest.num_child_diag_indices;
-  auto  &cri = ordering_.assembly_forest.child_rel_indices;
-
-  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
-    const Int child = ordering_.assembly_forest.children[child_index];
-    const Int* child_indices = lower_factor_->StructureBeg(child);
-    BlasMatrixView<Field>& child_right_hand_sides = shared_state->schur_complements[child];
-    const Int child_degree = child_right_hand_sides.height;
+template <class Field>
+void Factorization<Field>::MergeChildSolveUpdate(
+    Int supernode, Int child, const BlasMatrixView<Field>& child_update,
+    BlasMatrixView<Field>* right_hand_sides,
+    BlasMatrixView<Field>* update) const {
+  const Int supernode_start = ordering_->supernode_offsets[supernode];
+  const Int supernode_size  = ordering_->supernode_sizes[supernode];
+  const Int num_rhs = right_hand_sides->width;
+  const BlasMatrixView<Field>& child_right_hand_sides = child_update;
+  BlasMatrixView<Field>& main_right_hand_sides = *update;
+  const Int* child_indices = lower_factor_->StructureBeg(child);
+  const Int child_degree = child_right_hand_sides.height;
 
-    const Int &num_child_diag_indices = ncdi[child];
-    const Buffer<Int> &child_rel_indices = cri[child];
+  const Int num_child_diag_indices = ordering_->assembly_forest.NumChildDiagIndices(child);
+  const LocalInt *child_rel_indices = ordering_->assembly_forest.ChildRelativeIndicesBeg(child);
 
 #if 1
-    for (Int j = 0; j < num_rhs; ++j) {
-        Field* crhs_col = child_right_hand_sides.Pointer(0, j);
-        Field*  rhs_col = right_hand_sides->Pointer(0, j);
-        Field* mrhs_col = main_right_hand_sides.Pointer(0, j);
-        for (Int i = 0; i < num_child_diag_indices; ++i)
-            rhs_col[child_indices[i]] += crhs_col[i];
-
-        for (Int i = num_child_diag_indices; i < child_degree; ++i)
-            mrhs_col[child_rel_indices[i] - supernode_size] += crhs_col[i];
-    }
+  const IndexRunList& child_runs = ordering_->assembly_forest.child_relative_indices->runs;
+  if (child_runs.Encoded(child)) {
+      // Add in one run of relative indices at a time; the leading portion
+      // of a run may lie within this supernode's diagonal block.
+      for (Int j = 0; j < num_rhs; ++j) {
+          const Field* crhs_col = child_right_hand_sides.Pointer(0, j);
+          Field*  rhs_col = right_hand_sides->Pointer(supernode_start, j);
+          Field* mrhs_col = main_right_hand_sides.Pointer(0, j) - supernode_size;
+          ForEachIndexRun(child_runs.Beg(child), child_runs.End(child), 0,
+              [&](Int position, Int index, Int length) {
+                  const Field* source = crhs_col + position;
+                  const Int num_diag = std::min(length, std::max(supernode_size - index, Int(0)));
+                  for (Int i = 0; i < num_diag; ++i)
+                      rhs_col[index + i] += source[i];
+                  for (Int i = num_diag; i < length; ++i)
+                      mrhs_col[index + i] += source[i];
+              });
+      }
+      return;
+  }
+  for (Int j = 0; j < num_rhs; ++j) {
+      const Field* crhs_col = child_right_hand_sides.Pointer(0, j);
+      Field*  rhs_col = right_hand_sides->Pointer(0, j);
+      Field* mrhs_col = main_right_hand_sides.Pointer(0, j);
+      for (Int i = 0; i < num_child_diag_indices; ++i)
+          rhs_col[child_indices[i]] += crhs_col[i];
+
+      for (Int i = num_child_diag_indices; i < child_degree; ++i)
+          mrhs_col[child_rel_indices[i] - supernode_size] += crhs_col[i];
+  }
 #else
-    for (Int j = 0; j < num_rhs; ++j) {
-        for (Int i = 0; i < num_child_diag_indices; ++i) {
-            const Int row = child_indices[i];
-            right_hand_sides->Entry(row, j) += child_right_hand_sides(i, j);
-        }
-        for (Int i = num_child_diag_indices, main_i = 0; i < child_degree; ++i) {
-            const Int row = child_indices[i];
-            while (main_indices[main_i] != row) ++main_i;
-            main_right_hand_sides(main_i, j) += child_right_hand_sides(i, j);
-        }
-    }
+  const Int* main_indices = lower_factor_->StructureBeg(supernode);
+  for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_child_diag_indices; ++i) {
+          const Int row = child_indices[i];
+          right_hand_sides->Entry(row, j) += child_right_hand_sides(i, j);
+      }
+      for (Int i = num_child_diag_indices, main_i = 0; i < child_degree; ++i) {
+          const Int row = child_indices[i];
+          while (main_indices[main_i] != row) ++main_i;
+          main_right_hand_sides(main_i, j) += child_right_hand_sides(i, j);
+      }
+  }
 #endif
+}
+
+template <class Field>
+void Factorization<Field>::FinishLowerTriangularSolveSupernode(
+    Int supernode, BlasMatrixView<Field>* right_hand_sides,
+    RightLookingSharedState<Field>* shared_state) const {
+  // Perform this supernode's trapezoidal solve. The panels of an out-of-core
+  // factor are visited in postorder, so those which follow are read ahead.
+  const Int prefetch_distance = control_.out_of_core_prefetch_distance;
+  PrefetchSupernodePanels(supernode + 1, supernode + 1 + prefetch_distance);
+  OpenMPLowerSupernodalTrapezoidalSolve(
+      supernode, right_hand_sides, &shared_state->schur_complements[supernode]);
+  EvictSupernodePanel(supernode);
+}
+
+template <class Field>
+void Factorization<Field>::StackedLowerTriangularSolveRecursion(
+    Int supernode, BlasMatrixView<Field>* right_hand_sides,
+    RightLookingSharedState<Field>* shared_state,
+    SchurComplementStorage<Field>* stack) const {
+  TraceScope trace_scope("forward_solve", supernode);
+  BeginLowerTriangularSolveSupernode(supernode, right_hand_sides, shared_state);
+
+  // Each child's update is pushed just before its subtree is solved and is
+  // popped as soon as it is merged into this supernode.
+  const Int num_rhs = right_hand_sides->width;
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
+  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+    const Int child = ordering_->assembly_forest.children[child_index];
+    BlasMatrixView<Field>& child_update =
+        shared_state->schur_complements[child];
+    const Int child_degree = child_update.height;
+    child_update = stack->push(child_degree, num_rhs);
+    child_update.leading_dim = std::max<Int>(child_degree, 1);
+    StackedLowerTriangularSolveRecursion(child, right_hand_sides, shared_state,
+                                         stack);
+    MergeChildSolveUpdate(supernode, child, child_update, right_hand_sides,
+                          &shared_state->schur_complements[supernode]);
+    stack->pop(child_degree, num_rhs);
+    child_update.data = nullptr;
+  }
+
+  FinishLowerTriangularSolveSupernode(supernode, right_hand_sides,
+                                      shared_state);
+}
+
+template <class Field>
+Int Factorization<Field>::SolveStackSize(Int supernode, Int num_rhs) const {
+  const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+  const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
+  Int stack_size = 0;
+  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+    const Int child = ordering_->assembly_forest.children[child_index];
+    stack_size = std::max(stack_size, lower_factor_->blocks[child].height *
+                                          num_rhs +
+                                          SolveStackSize(child, num_rhs));
+  }
+  return stack_size;
+}
+
+template <class Field>
+bool Factorization<Field>::DataflowSolveSupernode(
+    Int supernode, double min_parallel_work) const {
+  return ordering_->assembly_forest.NumChildren(supernode) > 0 &&
+         solve_work_estimates_[supernode] >= min_parallel_work;
+}
+
+template <class Field>
+bool Factorization<Field>::DedicatedSolveUpdate(
+    Int supernode, double min_parallel_work) const {
+  const Int parent = ordering_->assembly_forest.parents[supernode];
+  return parent < 0 || DataflowSolveSupernode(supernode, min_parallel_work) ||
+         DataflowSolveSupernode(parent, min_parallel_work);
+}
+
+template <class Field>
+void Factorization<Field>::OpenMPLowerTriangularSolveDataflow(
+    Int subtree, BlasMatrixView<Field>* right_hand_sides,
+    RightLookingSharedState<Field>* shared_state, double min_parallel_work,
+    std::atomic<Int>* num_pending_children) const {
+  // Solve against the (sequential) subtree.
+  if (control_.stack_solve_workspace) {
+    // The calling thread's stack is empty between subtrees.
+    SchurComplementStorage<Field>& stack = shared_state->solve_stacks.local();
+    const Int stack_size = SolveStackSize(subtree, right_hand_sides->width);
+    if (stack.capacity() < stack_size) {
+      stack.setPersistent(true);
+      stack.reallocate(stack_size);
+    }
+    StackedLowerTriangularSolveRecursion(subtree, right_hand_sides,
+                                         shared_state, &stack);
+  } else {
+    OpenMPLowerTriangularSolveRecursion(subtree, right_hand_sides,
+                                        shared_state, min_parallel_work);
   }
 
-  // Perform this supernode's trapezoidal solve.
-  OpenMPLowerSupernodalTrapezoidalSolve(supernode, right_hand_sides,
-                                        &main_right_hand_sides);
+  // Continue up the tree for as long as this task completed the last pending
+  // child of the parent, so that no task ever waits on another.
+  const Buffer<Int>& parents = ordering_->assembly_forest.parents;
+  for (Int parent = parents[subtree]; parent >= 0; parent = parents[parent]) {
+    if (num_pending_children[parent].fetch_sub(
+            1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    OpenMPLowerTriangularSolveSupernode(parent, right_hand_sides, shared_state);
+  }
 }
 
 template <class Field>
 void Factorization<Field>::OpenMPLowerTriangularSolve(
     BlasMatrixView<Field>* right_hand_sides,
     RightLookingSharedState<Field>* shared_state) const {
-  BENCHMARK_SCOPED_TIMER_SECTION timer("OpenMPLowerTriangularSolve");
-
-  // Recurse on each tree in the elimination forest.
-  const Int num_roots = ordering_.assembly_forest.roots.Size();
-  for (Int root_index = 0; root_index < num_roots; ++root_index) {
-    const Int root = ordering_.assembly_forest.roots[root_index];
-    OpenMPLowerTriangularSolveRecursion(root, right_hand_sides, shared_state, 0);
+  TraceScope trace_scope("OpenMPLowerTriangularSolve");
+
+  // The spawning threshold is expressed in terms of per-right-hand-side work.
+  const double min_parallel_work =
+      control_.min_parallel_solve_threshold / std::max<Int>(right_hand_sides->width, 1);
+
+  // Supernodes with children whose subtrees are expensive enough are
+  // scheduled by dataflow: each is eliminated by whichever task completes
+  // its last child, rather than after a wait on all of them. The remaining
+  // supernodes are grouped into maximal subtrees which are each solved
+  // sequentially by a single task.
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const AssemblyForest& forest = ordering_->assembly_forest;
+  auto dataflow = [&](Int supernode) {
+    return DataflowSolveSupernode(supernode, min_parallel_work);
+  };
+  std::unique_ptr<std::atomic<Int>[]> num_pending_children(
+      new std::atomic<Int>[num_supernodes]);
+  std::vector<Int> subtrees;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    if (dataflow(supernode)) {
+      num_pending_children[supernode].store(forest.NumChildren(supernode),
+                                            std::memory_order_relaxed);
+    } else {
+      const Int parent = forest.parents[supernode];
+      if (parent < 0 || dataflow(parent)) {
+        subtrees.push_back(supernode);
+      }
+    }
   }
+  if (subtrees.empty()) return;
+
+  // The last subtree is solved by the calling thread.
+  tbb::task_group tg;
+  for (std::size_t index = 0; index + 1 < subtrees.size(); ++index) {
+    const Int subtree = subtrees[index];
+    tg.run([=, &num_pending_children]() {
+      OpenMPLowerTriangularSolveDataflow(subtree, right_hand_sides,
+                                         shared_state, min_parallel_work,
+                                         num_pending_children.get());
+    });
+  }
+  OpenMPLowerTriangularSolveDataflow(subtrees.back(), right_hand_sides,
+                                     shared_state, min_parallel_work,
+                                     num_pending_children.get());
+  tg.wait();
 }
 
 template <class Field>
@@ -196,10 +507,10 @@ void Factorization<Field>::OpenMPDiagonalSolve(
     return;
   }
 
-  const SymmetricOrdering* ordering_ptr = &ordering_;
+  const SymmetricOrdering* ordering_ptr = ordering_.get();
   const DiagonalFactor<Field>* diagonal_factor_ptr = diagonal_factor_.get();
 
-  const Int num_supernodes = ordering_.supernode_sizes.Size();
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
   // TODO(JP): re-parallelize
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
     {
@@ -221,28 +532,64 @@ void Factorization<Field>::OpenMPDiagonalSolve(
       }
     }
   }
+  ZeroSingularPivots(right_hand_sides);
 }
 
 template <class Field>
 void Factorization<Field>::OpenMPLowerTransposeTriangularSolveRecursion(
     Int supernode, BlasMatrixView<Field>* right_hand_sides,
-    RightLookingSharedState<Field>* shared_state, int level, tbb::task_group &tg) const {
+    RightLookingSharedState<Field>* shared_state, double min_parallel_work,
+    tbb::task_group &tg) const {
     // Perform this supernode's trapezoidal solve.
     // TODO(Jack Poulson): Add OpenMP support into the trapezoidal solve.
 
-    // Do the work for this supernode.
-    LowerTransposeSupernodalTrapezoidalSolve(supernode, right_hand_sides, shared_state->schur_complements[supernode]);
+    // Do the work for this supernode. The panels of an out-of-core factor are
+    // visited in reverse postorder, so those which precede are read ahead.
+    {
+      TraceScope trace_scope("backward_solve", supernode);
+      const Int prefetch_distance = control_.out_of_core_prefetch_distance;
+      PrefetchSupernodePanels(supernode - prefetch_distance, supernode);
+      const Int num_rhs = right_hand_sides->width;
+      BlasMatrixView<Field> workspace =
+          shared_state->schur_complements[supernode];
+      SchurComplementStorage<Field>* stack = nullptr;
+      if (workspace.height && !workspace.data) {
+        // A stacked solve workspace has no dedicated storage for this
+        // supernode, so its workspace is briefly pushed onto this thread's
+        // (otherwise empty) stack.
+        stack = &shared_state->solve_stacks.local();
+        const Int size = workspace.height * num_rhs;
+        if (stack->capacity() < size) {
+          stack->setPersistent(true);
+          stack->reallocate(size);
+        }
+        workspace.data = stack->push(workspace.height, num_rhs).data;
+      }
+      LowerTransposeSupernodalTrapezoidalSolve(supernode, right_hand_sides,
+                                               workspace);
+      if (stack) stack->pop(workspace.height, num_rhs);
+      EvictSupernodePanel(supernode);
+
+      // This supernode's rows of the solution are now final (its descendants
+      // only read them), so they are returned to the caller's ordering.
+      if (shared_state->unpermuted_right_hand_sides) {
+        ScatterSupernodeRightHandSides(
+            supernode, *right_hand_sides,
+            shared_state->unpermuted_right_hand_sides,
+            shared_state->conjugate_right_hand_sides);
+      }
+    }
 
-    auto processChild = [right_hand_sides, shared_state, level, &tg, this](Int child_index) {
-        const Int child = ordering_.assembly_forest.children[child_index];
-        OpenMPLowerTransposeTriangularSolveRecursion(child, right_hand_sides, shared_state, level + 1, tg);
+    auto processChild = [right_hand_sides, shared_state, min_parallel_work, &tg, this](Int child_index) {
+        const Int child = ordering_->assembly_forest.children[child_index];
+        OpenMPLowerTransposeTriangularSolveRecursion(child, right_hand_sides, shared_state, min_parallel_work, tg);
     };
 
     // Tail recurse on this supernode's children.
-    const Int child_beg = ordering_.assembly_forest.child_offsets[supernode];
-    const Int child_end = ordering_.assembly_forest.child_offsets[supernode + 1];
+    const Int child_beg = ordering_->assembly_forest.child_offsets[supernode];
+    const Int child_end = ordering_->assembly_forest.child_offsets[supernode + 1];
     const Int numChildren = child_end - child_beg;
-    if (numChildren <= 1 || level > 9) { // Avoid spawning unnecessary threads...
+    if (numChildren <= 1 || solve_work_estimates_[supernode] < min_parallel_work) { // Avoid spawning unnecessary tasks...
         for (Int child_index = child_beg; child_index < child_end; ++child_index)
             processChild(child_index);
         return;
@@ -257,19 +604,28 @@ template <class Field>
 void Factorization<Field>::OpenMPLowerTransposeTriangularSolve(
     BlasMatrixView<Field>* right_hand_sides,
     RightLookingSharedState<Field>* shared_state) const {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("OpenMPLowerTransposeTriangularSolve");
+    TraceScope trace_scope("OpenMPLowerTransposeTriangularSolve");
 
-    const Int num_roots = ordering_.assembly_forest.roots.Size();
+    const Int num_roots = ordering_->assembly_forest.roots.Size();
     if (num_roots == 0) return;
 
+    // The spawning threshold is expressed in terms of per-right-hand-side work.
+    const double min_parallel_work =
+        control_.min_parallel_solve_threshold / std::max<Int>(right_hand_sides->width, 1);
+
     // Tail recurse from each root of the elimination forest.
     tbb::task_group tg;
     for (Int root_index = 0; root_index < num_roots - 1; ++root_index) {
-        tg.run([right_hand_sides, shared_state, root_index, &tg, this]() {
-            OpenMPLowerTransposeTriangularSolveRecursion(ordering_.assembly_forest.roots[root_index], right_hand_sides, shared_state, 0, tg);
+        const Int root = ordering_->assembly_forest.roots[root_index];
+        if (solve_work_estimates_[root] < min_parallel_work) {
+            OpenMPLowerTransposeTriangularSolveRecursion(root, right_hand_sides, shared_state, min_parallel_work, tg);
+            continue;
+        }
+        tg.run([right_hand_sides, shared_state, root, min_parallel_work, &tg, this]() {
+            OpenMPLowerTransposeTriangularSolveRecursion(root, right_hand_sides, shared_state, min_parallel_work, tg);
         });
     }
-    OpenMPLowerTransposeTriangularSolveRecursion(ordering_.assembly_forest.roots[num_roots - 1], right_hand_sides, shared_state, 0, tg);
+    OpenMPLowerTransposeTriangularSolveRecursion(ordering_->assembly_forest.roots[num_roots - 1], right_hand_sides, shared_state, min_parallel_work, tg);
     tg.wait();
 }
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SOLVE_SPARSE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SOLVE_SPARSE_IMPL_H_
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+void Factorization<Field>::AncestralSupernodes(
+    const Buffer<Int>& permuted_rows, Buffer<Int>* supernodes) const {
+  const Int num_supernodes = ordering_->supernode_sizes.Size();
+  const Buffer<Int>& parents = ordering_->assembly_forest.parents;
+
+  // Walk up from each row's supernode until we hit a previously-marked
+  // supernode (whose ancestors are then also already marked).
+  Buffer<char> marked(num_supernodes, 0);
+  std::vector<Int> list;
+  for (const Int& row : permuted_rows) {
+    Int supernode = supernode_member_to_index_[row];
+    while (supernode >= 0 && !marked[supernode]) {
+      marked[supernode] = 1;
+      list.push_back(supernode);
+      supernode = parents[supernode];
+    }
+  }
+
+  // Children precede their parents in the supernodal ordering, so sorting
+  // yields a valid order for the forward solve (and, reversed, for the
+  // backward solve).
+  std::sort(list.begin(), list.end());
+  supernodes->Resize(list.size());
+  std::copy(list.begin(), list.end(), supernodes->Data());
+}
+
+template <class Field>
+void Factorization<Field>::SolveSparse(
+    const Buffer<Int>& rhs_support, const Buffer<Int>& requested_indices,
+    BlasMatrixView<Field>* right_hand_sides) const {
+  TraceScope trace_scope("SolveSparse");
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error("Solves require a complete factorization");
+  }
+  const Int num_rows = right_hand_sides->height;
+  const Int num_rhs = right_hand_sides->width;
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const bool is_cholesky =
+      control_.factorization_type == kCholeskyFactorization;
+
+  auto permuted_rows = [&](const Buffer<Int>& rows) {
+    Buffer<Int> result(rows.Size());
+    for (std::size_t i = 0; i < rows.Size(); ++i)
+      result[i] = have_permutation ? ordering_->permutation[rows[i]] : rows[i];
+    return result;
+  };
+  const Buffer<Int> permuted_support = permuted_rows(rhs_support);
+  const Buffer<Int> permuted_requests = permuted_rows(requested_indices);
+
+  // The supernodes touched by the forward and backward solves.
+  Buffer<Int> forward_supernodes, backward_supernodes;
+  AncestralSupernodes(permuted_support, &forward_supernodes);
+  AncestralSupernodes(permuted_requests, &backward_supernodes);
+
+  // Work in the permuted ordering, only initializing the rows that can be
+  // touched: the forward solve only updates (ancestral) rows of the forward
+  // supernodes, and the backward solve only reads those of the backward ones.
+  const Int size = num_rows * num_rhs;
+  Buffer<Field>& permute_scratch = solve_workspace_.permute_scratch;
+  if (permute_scratch.Size() < size) permute_scratch.Resize(size);
+  BlasMatrixView<Field> solution;
+  solution.height = num_rows;
+  solution.width = num_rhs;
+  solution.leading_dim = num_rows;
+  solution.data = permute_scratch.Data();
+  auto zero_supernodes = [&](const Buffer<Int>& supernodes) {
+    for (const Int& supernode : supernodes) {
+      const Int supernode_start = ordering_->supernode_offsets[supernode];
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      for (Int j = 0; j < num_rhs; ++j) {
+        std::fill(solution.Pointer(supernode_start, j),
+                  solution.Pointer(supernode_start + supernode_size, j),
+                  Field{0});
+      }
+    }
+  };
+  zero_supernodes(forward_supernodes);
+  zero_supernodes(backward_supernodes);
+  for (std::size_t i = 0; i < rhs_support.Size(); ++i) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      solution(permuted_support[i], j) = right_hand_sides->Entry(rhs_support[i], j);
+    }
+  }
+
+  Buffer<Field> workspace(max_degree_ * num_rhs, Field{0});
+
+  // Forward solve restricted to the ancestors of the right-hand side support.
+  for (const Int& supernode : forward_supernodes) {
+    LowerSupernodalTrapezoidalSolve(supernode, &solution, &workspace);
+  }
+
+  // Diagonal solve; only the rows read by the backward solve are needed.
+  if (!is_cholesky) {
+    for (const Int& supernode : backward_supernodes) {
+      const ConstBlasMatrixView<Field> diagonal_block =
+          diagonal_factor_->blocks[supernode];
+      const Int supernode_start = ordering_->supernode_offsets[supernode];
+      const Int supernode_size = ordering_->supernode_sizes[supernode];
+      for (Int j = 0; j < num_rhs; ++j) {
+        for (Int i = 0; i < supernode_size; ++i) {
+          solution(supernode_start + i, j) /= diagonal_block(i, i);
+        }
+      }
+    }
+    ZeroSingularPivots(&solution);
+  }
+
+  // Backward solve restricted to the ancestors of the requested rows.
+  for (Int index = backward_supernodes.Size() - 1; index >= 0; --index) {
+    LowerTransposeSupernodalTrapezoidalSolve(backward_supernodes[index],
+                                             &solution, &workspace);
+  }
+
+  for (std::size_t i = 0; i < requested_indices.Size(); ++i) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      right_hand_sides->Entry(requested_indices[i], j) = solution(permuted_requests[i], j);
+    }
+  }
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+        // CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_SOLVE_SPARSE_IMPL_H_
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_UPDATE_DOWNDATE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_UPDATE_DOWNDATE_IMPL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "catamari/sparse_ldl/supernodal/factorization.hpp"
+#include "catamari/trace.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+bool Factorization<Field>::UpdateDowndate(
+    const ConstBlasMatrixView<Field>& vectors, Int sign) {
+  typedef ComplexBase<Field> Real;
+  TraceScope trace_scope("UpdateDowndate");
+  if (control_.supernodal_pivoting) {
+    throw std::runtime_error(
+        "Updates and downdates do not support supernodal pivoting");
+  }
+  if (InterfaceSupernode() >= 0) {
+    throw std::runtime_error(
+        "Updates and downdates require a complete factorization");
+  }
+  RequireUncompressedFactor("Updating or downdating");
+  if (sign != 1 && sign != -1) {
+    throw std::runtime_error("The update sign must be either 1 or -1");
+  }
+  // The device copies of the subdiagonal blocks and the retained Schur
+  // complements would become stale.
+  device_offload_.ClearResidentBlocks();
+  retained_schur_complements_.Clear();
+  const Int num_rows = NumRows();
+  const Int rank = vectors.width;
+  if (vectors.height != num_rows) {
+    throw std::runtime_error("Invalid number of update rows");
+  }
+  const bool have_permutation = !ordering_->permutation.Empty();
+  const bool is_cholesky =
+      control_.factorization_type == kCholeskyFactorization;
+  const bool is_adjoint =
+      control_.factorization_type != kLDLTransposeFactorization;
+
+  // Find the leading (permuted) row of each nonzero vector.
+  Buffer<Int> leading_rows(rank);
+  std::vector<Int> nonzero_vectors;
+  for (Int t = 0; t < rank; ++t) {
+    Int leading_row = num_rows;
+    for (Int i = 0; i < num_rows; ++i) {
+      if (vectors(i, t) != Field{0}) {
+        const Int row = have_permutation ? ordering_->permutation[i] : i;
+        leading_row = std::min(leading_row, row);
+      }
+    }
+    if (leading_row < num_rows) {
+      leading_rows[nonzero_vectors.size()] = leading_row;
+      nonzero_vectors.push_back(t);
+    }
+  }
+  const Int num_vectors = nonzero_vectors.size();
+  if (!num_vectors) {
+    return true;
+  }
+  leading_rows.Resize(num_vectors);
+
+  // Only the supernodes on the paths from the leading rows to the roots of
+  // the assembly forest are modified.
+  Buffer<Int> supernodes;
+  AncestralSupernodes(leading_rows, &supernodes);
+  const Int num_path_supernodes = supernodes.Size();
+  auto path_index = [&](Int supernode) {
+    return std::lower_bound(supernodes.begin(), supernodes.end(), supernode) -
+           supernodes.begin();
+  };
+
+  // The rows of the path supernodes are packed contiguously.
+  Buffer<Int> path_offsets(num_path_supernodes + 1);
+  path_offsets[0] = 0;
+  Int max_front_height = 0;
+  for (Int index = 0; index < num_path_supernodes; ++index) {
+    const Int supernode = supernodes[index];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int degree = lower_factor_->blocks[supernode].height;
+    path_offsets[index + 1] = path_offsets[index] + supernode_size;
+    max_front_height = std::max(max_front_height, supernode_size + degree);
+  }
+  const Int num_path_rows = path_offsets[num_path_supernodes];
+
+  // Pack the vectors, ensuring that the support of each is contained within
+  // the structure of the column of its leading row so that the modification
+  // does not introduce any fill.
+  BlasMatrix<Field> packed_vectors;
+  packed_vectors.Resize(num_path_rows, num_vectors, Field{0});
+  for (Int t = 0; t < num_vectors; ++t) {
+    const Int leading_supernode = supernode_member_to_index_[leading_rows[t]];
+    const Int* index_beg = lower_factor_->StructureBeg(leading_supernode);
+    const Int* index_end = lower_factor_->StructureEnd(leading_supernode);
+    for (Int i = 0; i < num_rows; ++i) {
+      const Field& value = vectors(i, nonzero_vectors[t]);
+      if (value == Field{0}) {
+        continue;
+      }
+      const Int row = have_permutation ? ordering_->permutation[i] : i;
+      const Int supernode = supernode_member_to_index_[row];
+      if (supernode != leading_supernode &&
+          !std::binary_search(index_beg, index_end, row)) {
+        throw std::runtime_error(
+            "Update vector " + std::to_string(nonzero_vectors[t]) +
+            " does not lie within the fill pattern");
+      }
+      packed_vectors(path_offsets[path_index(supernode)] + row -
+                         ordering_->supernode_offsets[supernode],
+                     t) = value;
+    }
+  }
+
+  // Apply the rank-one recurrences of Gill, Golub, Murray, and Saunders
+  // ("Methods for modifying matrix factorizations", 1974, Method C1) one
+  // supernode at a time. All of the vectors are applied to each column of a
+  // front before moving to the next, which is equivalent to applying the
+  // rank-one modifications in sequence.
+  Buffer<Field> alphas(num_vectors, Field(Real(sign)));
+  BlasMatrix<Field> front_vectors;
+  front_vectors.Resize(max_front_height, num_vectors);
+  for (Int index = 0; index < num_path_supernodes; ++index) {
+    const Int supernode = supernodes[index];
+    const Int supernode_size = ordering_->supernode_sizes[supernode];
+    const Int* structure = lower_factor_->StructureBeg(supernode);
+    const Int degree = lower_factor_->blocks[supernode].height;
+    const Int front_height = supernode_size + degree;
+
+    // Map each structure row to its position within the packed vectors. The
+    // structure is sorted, so the owning path supernodes are nondecreasing.
+    Buffer<Int> packed_rows(front_height);
+    for (Int i = 0; i < supernode_size; ++i) {
+      packed_rows[i] = path_offsets[index] + i;
+    }
+    for (Int i = 0, ancestor_index = index; i < degree; ++i) {
+      const Int row = structure[i];
+      const Int ancestor = supernode_member_to_index_[row];
+      while (supernodes[ancestor_index] != ancestor) ++ancestor_index;
+      packed_rows[supernode_size + i] = path_offsets[ancestor_index] + row -
+                                        ordering_->supernode_offsets[ancestor];
+    }
+    for (Int t = 0; t < num_vectors; ++t) {
+      for (Int i = 0; i < front_height; ++i) {
+        front_vectors(i, t) = packed_vectors(packed_rows[i], t);
+      }
+    }
+
+    // The diagonal and subdiagonal blocks of each column of the factor are
+    // stored contiguously.
+    BlasMatrixView<Field> diagonal_block = diagonal_factor_->blocks[supernode];
+    for (Int j = 0; j < supernode_size; ++j) {
+      Field* column = diagonal_block.Pointer(0, j);
+      for (Int t = 0; t < num_vectors; ++t) {
+        Field* vector = front_vectors.Pointer(0, t);
+        const Field pivot = vector[j];
+        if (pivot == Field{0}) {
+          continue;
+        }
+        Field& alpha = alphas[t];
+        const Field pivot_factor = is_adjoint ? Conjugate(pivot) : pivot;
+        if (is_cholesky) {
+          // Cholesky columns are scaled by the square-roots of the diagonal.
+          const Real scale = RealPart(column[j]);
+          const Real diagonal = scale * scale;
+          const Real new_diagonal =
+              diagonal + RealPart(alpha * pivot_factor * pivot);
+          if (!(new_diagonal > Real{0})) {
+            return false;
+          }
+          const Real new_scale = std::sqrt(new_diagonal);
+          const Field beta = alpha * pivot_factor / new_diagonal;
+          alpha = alpha * diagonal / new_diagonal;
+          column[j] = new_scale;
+          for (Int i = j + 1; i < front_height; ++i) {
+            const Field unit_entry = column[i] / scale;
+            vector[i] -= pivot * unit_entry;
+            column[i] = (unit_entry + beta * vector[i]) * new_scale;
+          }
+        } else {
+          const Field diagonal = column[j];
+          const Field new_diagonal = diagonal + alpha * pivot_factor * pivot;
+          if (new_diagonal == Field{0}) {
+            return false;
+          }
+          const Field beta = alpha * pivot_factor / new_diagonal;
+          alpha = alpha * diagonal / new_diagonal;
+          column[j] = new_diagonal;
+          for (Int i = j + 1; i < front_height; ++i) {
+            vector[i] -= pivot * column[i];
+            column[i] += beta * vector[i];
+          }
+        }
+      }
+    }
+
+    // Pass the modified vectors on to the ancestors.
+    for (Int t = 0; t < num_vectors; ++t) {
+      for (Int i = supernode_size; i < front_height; ++i) {
+        packed_vectors(packed_rows[i], t) = front_vectors(i, t);
+      }
+    }
+  }
+  RepackSolvePanels(&supernodes);
+
+  return true;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef
+// CATAMARI_SPARSE_LDL_SUPERNODAL_FACTORIZATION_UPDATE_DOWNDATE_IMPL_H_
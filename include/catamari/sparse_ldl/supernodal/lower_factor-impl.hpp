@@ -16,18 +16,19 @@ namespace supernodal_ldl {
 template <class Field>
 LowerFactor<Field>::LowerFactor(const Buffer<Int>& supernode_sizes,
                                 const Buffer<Int>& supernode_degrees,
-                                BlasMatrixView<Field> storage) {
+                                BlasMatrixView<Field> storage)
+    : structure_(std::make_shared<Structure>()) {
   const Int num_supernodes = supernode_sizes.Size();
 
   Int degree_sum = 0;
   Int num_entries = 0;
-  structure_index_offsets_.Resize(num_supernodes + 1);
+  structure_->index_offsets.Resize(num_supernodes + 1);
   blocks.Resize(num_supernodes);
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
     const Int degree = supernode_degrees[supernode];
     const Int supernode_size = supernode_sizes[supernode];
 
-    structure_index_offsets_[supernode] = degree_sum;
+    structure_->index_offsets[supernode] = degree_sum;
 
     blocks[supernode].height = degree;
     blocks[supernode].width = supernode_size;
@@ -38,62 +39,87 @@ LowerFactor<Field>::LowerFactor(const Buffer<Int>& supernode_sizes,
     num_entries += degree * supernode_size;
   }
 
-  structure_index_offsets_[num_supernodes] = degree_sum;
-  structure_indices_.Resize(degree_sum);
+  structure_->index_offsets[num_supernodes] = degree_sum;
+  structure_->indices.Resize(degree_sum);
 }
 
 template <class Field>
 Int* LowerFactor<Field>::StructureBeg(Int supernode) {
-  return &structure_indices_[structure_index_offsets_[supernode]];
+  return &structure_->indices[structure_->index_offsets[supernode]];
 }
 
 template <class Field>
 const Int* LowerFactor<Field>::StructureBeg(Int supernode) const {
-  return &structure_indices_[structure_index_offsets_[supernode]];
+  return &structure_->indices[structure_->index_offsets[supernode]];
 }
 
 template <class Field>
 Int* LowerFactor<Field>::StructureEnd(Int supernode) {
-  return &structure_indices_[structure_index_offsets_[supernode + 1]];
+  return &structure_->indices[structure_->index_offsets[supernode + 1]];
 }
 
 template <class Field>
 const Int* LowerFactor<Field>::StructureEnd(Int supernode) const {
-  return &structure_indices_[structure_index_offsets_[supernode + 1]];
+  return &structure_->indices[structure_->index_offsets[supernode + 1]];
 }
 
 template <class Field>
 Int* LowerFactor<Field>::IntersectionSizesBeg(Int supernode) {
-  return &intersect_sizes_[intersect_size_offsets_[supernode]];
+  return &structure_->intersect_sizes[
+      structure_->intersect_size_offsets[supernode]];
 }
 
 template <class Field>
 const Int* LowerFactor<Field>::IntersectionSizesBeg(Int supernode) const {
-  return &intersect_sizes_[intersect_size_offsets_[supernode]];
+  return &structure_->intersect_sizes[
+      structure_->intersect_size_offsets[supernode]];
 }
 
 template <class Field>
 Int* LowerFactor<Field>::IntersectionSizesEnd(Int supernode) {
-  return &intersect_sizes_[intersect_size_offsets_[supernode + 1]];
+  return &structure_->intersect_sizes[
+      structure_->intersect_size_offsets[supernode + 1]];
 }
 
 template <class Field>
 const Int* LowerFactor<Field>::IntersectionSizesEnd(Int supernode) const {
-  return &intersect_sizes_[intersect_size_offsets_[supernode + 1]];
+  return &structure_->intersect_sizes[
+      structure_->intersect_size_offsets[supernode + 1]];
+}
+
+template <class Field>
+bool LowerFactor<Field>::HaveIntersectionSizes() const {
+  return structure_->intersect_size_offsets.Size() == blocks.Size() + 1;
+}
+
+template <class Field>
+void LowerFactor<Field>::FillStructureRuns() {
+  structure_->runs.Encode(blocks.Size(), structure_->index_offsets.Data(),
+                         structure_->indices.Data());
+}
+
+template <class Field>
+const IndexRunList& LowerFactor<Field>::StructureRuns() const {
+  return structure_->runs;
 }
 
 template <class Field>
 void LowerFactor<Field>::FillIntersectionSizes(
     const Buffer<Int>& /* supernode_sizes */,
     const Buffer<Int>& supernode_member_to_index) {
+  if (structure_.use_count() > 1) {
+    structure_ = std::make_shared<Structure>(*structure_);
+  }
   const Int num_supernodes = blocks.Size();
+  Buffer<Int>& intersect_sizes = structure_->intersect_sizes;
+  Buffer<Int>& intersect_size_offsets = structure_->intersect_size_offsets;
 
   // Compute the supernode offsets.
   std::size_t num_supernode_intersects = 0;
-  intersect_size_offsets_.Resize(num_supernodes + 1);
+  intersect_size_offsets.Resize(num_supernodes + 1);
   for (Int column_supernode = 0; column_supernode < num_supernodes;
        ++column_supernode) {
-    intersect_size_offsets_[column_supernode] = num_supernode_intersects;
+    intersect_size_offsets[column_supernode] = num_supernode_intersects;
     Int last_supernode = -1;
 
     const Int* index_beg = StructureBeg(column_supernode);
@@ -107,11 +133,11 @@ void LowerFactor<Field>::FillIntersectionSizes(
       }
     }
   }
-  intersect_size_offsets_[num_supernodes] = num_supernode_intersects;
+  intersect_size_offsets[num_supernodes] = num_supernode_intersects;
 
   // Fill the supernode intersection sizes (and simultaneously compute the
   // number of intersecting descendant entries for each supernode).
-  intersect_sizes_.Resize(num_supernode_intersects);
+  intersect_sizes.Resize(num_supernode_intersects);
   num_supernode_intersects = 0;
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
     Int last_supernode = -1;
@@ -125,7 +151,7 @@ void LowerFactor<Field>::FillIntersectionSizes(
       if (row_supernode != last_supernode) {
         if (last_supernode != -1) {
           // Close out the supernodal intersection.
-          intersect_sizes_[num_supernode_intersects++] = intersect_size;
+          intersect_sizes[num_supernode_intersects++] = intersect_size;
         }
         last_supernode = row_supernode;
         intersect_size = 0;
@@ -134,10 +160,10 @@ void LowerFactor<Field>::FillIntersectionSizes(
     }
     if (last_supernode != -1) {
       // Close out the last intersection count for this column supernode.
-      intersect_sizes_[num_supernode_intersects++] = intersect_size;
+      intersect_sizes[num_supernode_intersects++] = intersect_size;
     }
   }
-  CATAMARI_ASSERT(num_supernode_intersects == intersect_sizes_.Size(),
+  CATAMARI_ASSERT(num_supernode_intersects == intersect_sizes.Size(),
                   "Incorrect number of supernode intersections");
 }
 
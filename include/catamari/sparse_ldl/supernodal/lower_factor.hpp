@@ -8,10 +8,12 @@
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_LOWER_FACTOR_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_LOWER_FACTOR_H_
 
+#include <memory>
 #include <vector>
 
 #include "catamari/blas_matrix_view.hpp"
 #include "catamari/buffer.hpp"
+#include "catamari/index_runs.hpp"
 #include "catamari_config.hh"
 
 namespace catamari {
@@ -58,28 +60,54 @@ class LowerFactor {
   // sizes of a supernode.
   const Int* IntersectionSizesEnd(Int supernode) const;
 
+  // Fills the sizes of the intersections of the (already filled) structure
+  // of each supernode with its ancestors, which the left-looking
+  // factorizations traverse. A structure shared with copies of the factor is
+  // first unshared.
   void FillIntersectionSizes(const Buffer<Int>& supernode_sizes,
                              const Buffer<Int>& supernode_member_to_index);
 
+  // Returns true if the intersection sizes have been filled.
+  bool HaveIntersectionSizes() const;
+
+  // Encodes the runs of consecutive indices of the (already filled)
+  // structures of the supernodes.
+  void FillStructureRuns();
+
+  // Returns the runs of consecutive indices of the structures of the
+  // supernodes whose runs are long enough to be worth traversing as such.
+  const IndexRunList& StructureRuns() const;
+
  private:
-  // The concatenation of the structures of the supernodes. The structure of
-  // supernode j is stored between indices index_offsets[j] and
-  // index_offsets[j + 1].
-  Buffer<Int> structure_indices_;
-
-  // An array of length 'num_supernodes + 1'; the j'th index is the sum of the
-  // degrees (excluding the diagonal blocks) of supernodes 0 through j - 1.
-  Buffer<Int> structure_index_offsets_;
-
-  // The concatenation of the number of rows in each supernodal intersection.
-  // The supernodal intersection sizes for supernode j are stored in indices
-  // intersect_size_offsets[j] through intersect_size_offsets[j + 1].
-  Buffer<Int> intersect_sizes_;
-
-  // An array of length 'num_supernodes + 1'; the j'th index is the sum of the
-  // number of supernodes that supernodes 0 through j - 1 individually intersect
-  // with.
-  Buffer<Int> intersect_size_offsets_;
+  // The symbolic structure of the factor. It is only modified while the
+  // factor is formed, so it is shared by copies of the factor (such as those
+  // of 'Factorization::Clone'), which only own their numerical blocks.
+  struct Structure {
+    // The concatenation of the structures of the supernodes. The structure
+    // of supernode j is stored between indices index_offsets[j] and
+    // index_offsets[j + 1].
+    Buffer<Int> indices;
+
+    // An array of length 'num_supernodes + 1'; the j'th index is the sum of
+    // the degrees (excluding the diagonal blocks) of supernodes 0 through
+    // j - 1.
+    Buffer<Int> index_offsets;
+
+    // The runs of consecutive indices of the structures of the supernodes.
+    IndexRunList runs;
+
+    // The concatenation of the number of rows in each supernodal
+    // intersection. The supernodal intersection sizes for supernode j are
+    // stored in indices intersect_size_offsets[j] through
+    // intersect_size_offsets[j + 1].
+    Buffer<Int> intersect_sizes;
+
+    // An array of length 'num_supernodes + 1'; the j'th index is the sum of
+    // the number of supernodes that supernodes 0 through j - 1 individually
+    // intersect with.
+    Buffer<Int> intersect_size_offsets;
+  };
+  std::shared_ptr<Structure> structure_;
 };
 
 }  // namespace supernodal_ldl
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_IMPL_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // if !defined _WIN32
+
+#include "catamari/sparse_ldl/supernodal/out_of_core_storage.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+namespace out_of_core {
+
+// Returns the size of the pages of the mappings.
+inline std::uintptr_t PageSize() {
+#if !defined _WIN32
+  static const std::uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+#else
+  return 4096;
+#endif  // if !defined _WIN32
+}
+
+// Throws an exception describing the failure of a system call.
+inline void ThrowSystemError(const std::string& operation) {
+  throw std::runtime_error("Out-of-core storage: " + operation + " failed: " +
+                           std::strerror(errno));
+}
+
+}  // namespace out_of_core
+
+template <class Field>
+void OutOfCoreStorage<Field>::Allocate(const std::string& directory,
+                                       Int size) {
+  Release();
+#if !defined _WIN32
+  std::string path_template = directory + "/catamari-factor-XXXXXX";
+  std::vector<char> path(path_template.begin(), path_template.end());
+  path.push_back('\0');
+  file_descriptor_ = mkstemp(path.data());
+  if (file_descriptor_ < 0) out_of_core::ThrowSystemError("mkstemp");
+  unlink(path.data());
+
+  // Mappings of length zero are invalid.
+  num_bytes_ = std::max<std::size_t>(size * sizeof(Field), 1);
+  if (ftruncate(file_descriptor_, num_bytes_) != 0) {
+    close(file_descriptor_);
+    file_descriptor_ = -1;
+    out_of_core::ThrowSystemError("ftruncate");
+  }
+  void* mapping = mmap(nullptr, num_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       file_descriptor_, 0);
+  if (mapping == MAP_FAILED) {
+    close(file_descriptor_);
+    file_descriptor_ = -1;
+    out_of_core::ThrowSystemError("mmap");
+  }
+  data_ = static_cast<Field*>(mapping);
+  size_ = size;
+#else
+  throw std::runtime_error(
+      "Out-of-core storage requires POSIX memory mappings.");
+#endif  // if !defined _WIN32
+}
+
+template <class Field>
+void OutOfCoreStorage<Field>::Release() {
+#if !defined _WIN32
+  if (data_) munmap(data_, num_bytes_);
+  if (file_descriptor_ >= 0) close(file_descriptor_);
+#endif  // if !defined _WIN32
+  data_ = nullptr;
+  size_ = 0;
+  num_bytes_ = 0;
+  file_descriptor_ = -1;
+}
+
+template <class Field>
+void OutOfCoreStorage<Field>::Prefetch(const Field* beg,
+                                       const Field* end) const {
+#if !defined _WIN32
+  if (!data_ || end <= beg) return;
+  const std::uintptr_t page_size = out_of_core::PageSize();
+  const std::uintptr_t first =
+      reinterpret_cast<std::uintptr_t>(beg) / page_size * page_size;
+  const std::uintptr_t last = reinterpret_cast<std::uintptr_t>(end);
+  madvise(reinterpret_cast<void*>(first), last - first, MADV_WILLNEED);
+#endif  // if !defined _WIN32
+}
+
+template <class Field>
+void OutOfCoreStorage<Field>::Evict(const Field* beg, const Field* end) const {
+#if !defined _WIN32
+  if (!data_ || end <= beg) return;
+
+  // Only the pages lying entirely within the range are evicted, so that the
+  // pages shared with neighboring (possibly active) ranges are left alone.
+  const std::uintptr_t page_size = out_of_core::PageSize();
+  const std::uintptr_t first =
+      (reinterpret_cast<std::uintptr_t>(beg) + page_size - 1) / page_size *
+      page_size;
+  const std::uintptr_t last =
+      reinterpret_cast<std::uintptr_t>(end) / page_size * page_size;
+  if (last <= first) return;
+  void* pages = reinterpret_cast<void*>(first);
+  msync(pages, last - first, MS_ASYNC);
+  madvise(pages, last - first, MADV_DONTNEED);
+#endif  // if !defined _WIN32
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_IMPL_H_
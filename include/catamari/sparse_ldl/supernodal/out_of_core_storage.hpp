@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "catamari/integers.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+// A buffer of 'Field' entries that is backed by a memory-mapped file, so that
+// the pages which are no longer in use may be written back and reclaimed by
+// the kernel rather than occupying RAM. The file is unlinked as soon as it is
+// created, so that it is removed once the storage is released (even if the
+// process terminates abnormally).
+template <class Field>
+class OutOfCoreStorage {
+ public:
+  OutOfCoreStorage() = default;
+  OutOfCoreStorage(const OutOfCoreStorage&) = delete;
+  OutOfCoreStorage& operator=(const OutOfCoreStorage&) = delete;
+  ~OutOfCoreStorage() { Release(); }
+
+  // Maps a new (zero-initialized) file of 'size' entries within 'directory'.
+  void Allocate(const std::string& directory, Int size);
+
+  // Unmaps and closes the file.
+  void Release();
+
+  // Returns the number of entries of the storage.
+  Int Size() const { return size_; }
+
+  // Returns a pointer to the first entry of the storage.
+  Field* Data() { return data_; }
+  const Field* Data() const { return data_; }
+
+  // Asynchronously reads the pages overlapping the entries [beg, end) into
+  // memory.
+  void Prefetch(const Field* beg, const Field* end) const;
+
+  // Schedules the write-back of the pages lying entirely within the entries
+  // [beg, end) and drops them from the resident set. Their contents remain
+  // valid and are paged back in upon their next access.
+  void Evict(const Field* beg, const Field* end) const;
+
+ private:
+  // The mapped entries.
+  Field* data_ = nullptr;
+
+  // The number of mapped entries.
+  Int size_ = 0;
+
+  // The number of mapped bytes.
+  std::size_t num_bytes_ = 0;
+
+  // The descriptor of the (unlinked) backing file.
+  int file_descriptor_ = -1;
+};
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/out_of_core_storage-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_OUT_OF_CORE_STORAGE_H_
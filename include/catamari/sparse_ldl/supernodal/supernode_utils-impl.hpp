@@ -8,7 +8,11 @@
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_IMPL_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_IMPL_H_
 
-#include "catamari/dense_factorizations/cholesky-impl.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "catamari/dense_factorizations.hpp"
 #include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
 
 #include "quotient/index_utils.hpp"
@@ -22,7 +26,9 @@ inline void MemberToIndex(Int num_rows, const Buffer<Int>& supernode_starts,
 
   Int supernode = 0;
   for (Int column = 0; column < num_rows; ++column) {
-    if (column == supernode_starts[supernode + 1]) {
+    // Empty supernodes (e.g., those which delayed all of their pivots) are
+    // skipped.
+    while (column == supernode_starts[supernode + 1]) {
       ++supernode;
     }
     CATAMARI_ASSERT(column >= supernode_starts[supernode] &&
@@ -197,6 +203,132 @@ inline void FormFundamentalSupernodes(const Buffer<Int>& scalar_parents,
   supernode_sizes->Resize(num_supernodes);
 }
 
+inline void IsolateInterfaceSupernode(Int num_interior,
+                                      Buffer<Int>* supernode_sizes) {
+  const Int num_supernodes = supernode_sizes->Size();
+  Int num_rows = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    num_rows += (*supernode_sizes)[supernode];
+  }
+  if (num_interior >= num_rows) {
+    return;
+  }
+
+  // Truncate the supernodes at the interior boundary.
+  Int num_interior_supernodes = 0;
+  for (Int offset = 0; offset < num_interior; ++num_interior_supernodes) {
+    Int& supernode_size = (*supernode_sizes)[num_interior_supernodes];
+    supernode_size = std::min(supernode_size, num_interior - offset);
+    offset += supernode_size;
+  }
+
+  // Append a single supernode containing all of the interface rows.
+  supernode_sizes->Resize(num_interior_supernodes + 1);
+  (*supernode_sizes)[num_interior_supernodes] = num_rows - num_interior;
+}
+
+inline double RelaxationCostModelRate(
+    const SupernodalRelaxationCostModel& cost_model, Int front_size) {
+  const std::vector<std::pair<Int, double>>& curve = cost_model.gflops_curve;
+  CATAMARI_ASSERT(!curve.empty(), "The cost model had no rates.");
+  if (front_size <= curve.front().first) return curve.front().second;
+  for (std::size_t index = 1; index < curve.size(); ++index) {
+    const std::pair<Int, double>& upper = curve[index];
+    if (front_size > upper.first) continue;
+    const std::pair<Int, double>& lower = curve[index - 1];
+    const double weight =
+        std::log(double(front_size) / lower.first) /
+        std::log(double(upper.first) / lower.first);
+    return lower.second + weight * (upper.second - lower.second);
+  }
+  return curve.back().second;
+}
+
+inline double EstimatedSupernodeSeconds(
+    Int supernode_size, Int degree,
+    const SupernodalRelaxationCostModel& cost_model) {
+  // The operations for factoring the diagonal block, solving against the
+  // subdiagonal block, and forming the Schur complement.
+  const double size = supernode_size;
+  const double height = degree;
+  const double num_operations =
+      size * size * size / 3 + size * size * height + size * height * height;
+  const double rate =
+      RelaxationCostModelRate(cost_model, supernode_size + degree);
+
+  // The entries of the factor and of the Schur complement to be assembled.
+  const double num_entries =
+      size * (size + 1) / 2 + size * height + height * (height + 1) / 2;
+
+  return num_operations / (1e9 * rate) +
+         num_entries * cost_model.seconds_per_entry;
+}
+
+inline SupernodalRelaxationStatistics RelaxationStatistics(
+    const Buffer<Int>& fund_supernode_sizes,
+    const Buffer<Int>& fund_supernode_degrees,
+    const Buffer<Int>& supernode_sizes, const Buffer<Int>& supernode_degrees,
+    const SupernodalRelaxationCostModel& cost_model) {
+  // Fundamental supernodes store no explicit zeros, so the relaxation
+  // introduced precisely the additional entries of the relaxed factor.
+  auto num_entries = [](const Buffer<Int>& sizes, const Buffer<Int>& degrees) {
+    Int count = 0;
+    for (Int supernode = 0; supernode < sizes.Size(); ++supernode) {
+      const Int size = sizes[supernode];
+      count += (size * (size + 1)) / 2 + size * degrees[supernode];
+    }
+    return count;
+  };
+
+  SupernodalRelaxationStatistics statistics;
+  statistics.num_fundamental_supernodes = fund_supernode_sizes.Size();
+  statistics.num_supernodes = supernode_sizes.Size();
+  statistics.num_explicit_zeros =
+      num_entries(supernode_sizes, supernode_degrees) -
+      num_entries(fund_supernode_sizes, fund_supernode_degrees);
+  for (Int supernode = 0; supernode < supernode_sizes.Size(); ++supernode) {
+    statistics.estimated_seconds += EstimatedSupernodeSeconds(
+        supernode_sizes[supernode], supernode_degrees[supernode], cost_model);
+  }
+  return statistics;
+}
+
+template <class Field>
+SupernodalRelaxationCostModel CalibrateSupernodalRelaxationCostModel(
+    const std::vector<Int>& front_sizes, Int num_repetitions) {
+  typedef ComplexBase<Field> Real;
+  SupernodalRelaxationCostModel cost_model;
+  cost_model.gflops_curve.clear();
+
+  // The factorizations overwrite their input, so each repetition refactors a
+  // fresh copy of a diagonally-dominant matrix.
+  BlasMatrix<Field> front;
+  for (const Int& size : front_sizes) {
+    const double seconds =
+        small_kernels::AverageSeconds(num_repetitions, [&]() {
+          front.Resize(size, size, Field{1});
+          for (Int i = 0; i < size; ++i) front(i, i) = Real(size + 1);
+          LDLAdjointFactorization(Int(64), &front.view);
+        });
+    const double num_operations = std::pow(double(size), 3.) / 3;
+    cost_model.gflops_curve.emplace_back(size, num_operations / (1e9 * seconds));
+  }
+
+  // Time an update streaming through a buffer much larger than the caches,
+  // which reads and writes each entry once, as does an assembly.
+  const Int num_entries = Int(1) << 22;
+  Buffer<Field> source(num_entries, Field{1});
+  Buffer<Field> target(num_entries, Field{0});
+  const double seconds = small_kernels::AverageSeconds(num_repetitions, [&]() {
+    for (Int index = 0; index < num_entries; ++index) {
+      target[index] += source[index];
+    }
+  });
+  cost_model.seconds_per_entry = seconds / num_entries;
+
+  return cost_model;
+}
+
 inline MergableStatus MergableSupernode(
     Int child_size, Int child_degree, Int parent_size, Int parent_degree,
     Int num_child_zeros, Int num_parent_zeros,
@@ -209,16 +341,26 @@ inline MergableStatus MergableSupernode(
   // merger.
   const Int num_new_zeros =
       (parent_size + parent_degree - child_degree) * child_size;
+  const Int num_old_zeros = num_child_zeros + num_parent_zeros;
+  const Int num_zeros = num_new_zeros + num_old_zeros;
+  status.num_merged_zeros = num_zeros;
   if (num_new_zeros == 0) {
     status.mergable = true;
     return status;
   }
 
-  const Int num_old_zeros = num_child_zeros + num_parent_zeros;
-  const Int num_zeros = num_new_zeros + num_old_zeros;
-  status.num_merged_zeros = num_zeros;
-
   const Int combined_size = child_size + parent_size;
+  if (control.use_cost_model) {
+    const SupernodalRelaxationCostModel& cost_model = control.cost_model;
+    const double separate_seconds =
+        EstimatedSupernodeSeconds(child_size, child_degree, cost_model) +
+        EstimatedSupernodeSeconds(parent_size, parent_degree, cost_model);
+    const double merged_seconds =
+        EstimatedSupernodeSeconds(combined_size, parent_degree, cost_model);
+    status.mergable = merged_seconds <= separate_seconds;
+    return status;
+  }
+
   const Int num_expanded_entries =
       (combined_size * (combined_size + 1)) / 2 + parent_degree * combined_size;
   CATAMARI_ASSERT(
@@ -430,7 +572,8 @@ inline void RelaxSupernodes(const SymmetricOrdering& orig_ordering,
                             const SupernodalRelaxationControl& control,
                             SymmetricOrdering* relaxed_ordering,
                             Buffer<Int>* relaxed_supernode_degrees,
-                            Buffer<Int>* relaxed_supernode_member_to_index) {
+                            Buffer<Int>* relaxed_supernode_member_to_index,
+                            Int frozen_supernode) {
   const Int num_rows = orig_ordering.supernode_offsets.Back();
   const Int num_supernodes = orig_ordering.supernode_sizes.Size();
 
@@ -458,6 +601,9 @@ inline void RelaxSupernodes(const SymmetricOrdering& orig_ordering,
     Buffer<Int> num_zeros(num_supernodes, 0);
 
     for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+      if (supernode == frozen_supernode) {
+        continue;
+      }
       MergeChildren(supernode, orig_ordering.supernode_offsets,
                     orig_ordering.supernode_sizes, orig_supernode_degrees,
                     child_list_heads, child_lists, control, &supernode_sizes,
@@ -506,6 +652,83 @@ inline void RelaxSupernodes(const SymmetricOrdering& orig_ordering,
   relaxed_ordering->assembly_forest.FillFromParents();
 }
 
+inline bool PostorderSupernodes(SymmetricOrdering* ordering,
+                                Buffer<Int>* supernode_degrees,
+                                Buffer<Int>* supernode_member_to_index) {
+  const AssemblyForest& forest = ordering->assembly_forest;
+  const Int num_supernodes = ordering->supernode_sizes.Size();
+
+  // Form the postorder with an explicit stack of the active path.
+  Buffer<Int> postorder(num_supernodes);
+  Buffer<Int> next_child(num_supernodes);
+  Buffer<Int> stack(num_supernodes);
+  Int num_ordered = 0;
+  bool in_postorder = true;
+  for (const Int& root : forest.roots) {
+    Int stack_size = 0;
+    stack[stack_size++] = root;
+    next_child[root] = forest.child_offsets[root];
+    while (stack_size) {
+      const Int supernode = stack[stack_size - 1];
+      if (next_child[supernode] < forest.child_offsets[supernode + 1]) {
+        const Int child = forest.children[next_child[supernode]++];
+        next_child[child] = forest.child_offsets[child];
+        stack[stack_size++] = child;
+      } else {
+        --stack_size;
+        in_postorder = in_postorder && supernode == num_ordered;
+        postorder[num_ordered++] = supernode;
+      }
+    }
+  }
+  if (in_postorder) {
+    return false;
+  }
+
+  Buffer<Int> relabeling(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    relabeling[postorder[supernode]] = supernode;
+  }
+
+  // Move the rows of each supernode, in their existing order, into its new
+  // position.
+  const Int num_rows = ordering->supernode_offsets.Back();
+  const bool have_permutation = !ordering->inverse_permutation.Empty();
+  SymmetricOrdering relabeled;
+  relabeled.supernode_sizes.Resize(num_supernodes);
+  relabeled.supernode_offsets.Resize(num_supernodes + 1);
+  relabeled.inverse_permutation.Resize(num_rows);
+  relabeled.assembly_forest.parents.Resize(num_supernodes);
+  Buffer<Int> relabeled_degrees(num_supernodes);
+  Int offset = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int orig_supernode = postorder[supernode];
+    const Int orig_offset = ordering->supernode_offsets[orig_supernode];
+    const Int supernode_size = ordering->supernode_sizes[orig_supernode];
+    const Int parent = forest.parents[orig_supernode];
+    relabeled.supernode_sizes[supernode] = supernode_size;
+    relabeled.supernode_offsets[supernode] = offset;
+    relabeled.assembly_forest.parents[supernode] =
+        parent == -1 ? -1 : relabeling[parent];
+    relabeled_degrees[supernode] = (*supernode_degrees)[orig_supernode];
+    for (Int j = 0; j < supernode_size; ++j) {
+      const Int orig_row = orig_offset + j;
+      relabeled.inverse_permutation[offset + j] =
+          have_permutation ? ordering->inverse_permutation[orig_row]
+                           : orig_row;
+      (*supernode_member_to_index)[offset + j] = supernode;
+    }
+    offset += supernode_size;
+  }
+  relabeled.supernode_offsets[num_supernodes] = num_rows;
+  InvertPermutation(relabeled.inverse_permutation, &relabeled.permutation);
+  relabeled.assembly_forest.FillFromParents();
+
+  *ordering = std::move(relabeled);
+  *supernode_degrees = std::move(relabeled_degrees);
+  return true;
+}
+
 template <class Field>
 void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
                           const SymmetricOrdering& ordering,
@@ -527,7 +750,7 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
   }
 
   // Fill in the structure indices.
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
     const Int supernode_offset = ordering.supernode_offsets[supernode];
     const Int supernode_size = ordering.supernode_sizes[supernode];
@@ -541,9 +764,9 @@ void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
       const Int row_beg = matrix.RowEntryOffset(orig_row);
       const Int row_end = matrix.RowEntryOffset(orig_row + 1);
       for (Int index = row_beg; index < row_end; ++index) {
-        const MatrixEntry<Field>& entry = entries[index];
-        const Int column = have_permutation ? ordering.permutation[entry.column]
-                                            : entry.column;
+        const Int entry_column = column_indices[index];
+        const Int column = have_permutation ? ordering.permutation[entry_column]
+                                            : entry_column;
 
         // Skip this entry if it is not to the left of the diagonal block.
         if (column >= supernode_offset) {
@@ -617,6 +840,137 @@ void FillSubtreeWorkEstimates(Int root, const AssemblyForest& supernode_forest,
   (*work_estimates)[root] += std::pow(1. * degree, 2.) * supernode_size;
 }
 
+inline void ProportionalSubtreeMapping(const AssemblyForest& supernode_forest,
+                                       const Buffer<double>& work_estimates,
+                                       const std::vector<Int>& subtrees,
+                                       Int domain_beg, Int domain_end,
+                                       Buffer<Int>* subtree_domains) {
+  const Int num_subtrees = subtrees.size();
+  const Int num_domains = domain_end - domain_beg;
+  if (!num_subtrees || num_domains <= 0) {
+    return;
+  }
+  if (num_domains == 1) {
+    for (const Int& subtree : subtrees) {
+      (*subtree_domains)[subtree] = domain_beg;
+    }
+    return;
+  }
+  if (num_subtrees == 1) {
+    const Int root = subtrees[0];
+    const Int child_beg = supernode_forest.child_offsets[root];
+    const Int child_end = supernode_forest.child_offsets[root + 1];
+    if (child_beg == child_end) {
+      (*subtree_domains)[root] = domain_beg;
+      return;
+    }
+    const std::vector<Int> children(
+        supernode_forest.children.begin() + child_beg,
+        supernode_forest.children.begin() + child_end);
+    ProportionalSubtreeMapping(supernode_forest, work_estimates, children,
+                               domain_beg, domain_end, subtree_domains);
+    return;
+  }
+
+  std::vector<Int> sorted_subtrees = subtrees;
+  std::sort(sorted_subtrees.begin(), sorted_subtrees.end(),
+            [&](const Int& a, const Int& b) {
+              return work_estimates[a] > work_estimates[b];
+            });
+  double remaining_work = 0;
+  for (const Int& subtree : sorted_subtrees) {
+    remaining_work += work_estimates[subtree];
+  }
+
+  // Give each sufficiently heavy subtree its proportional share of domains,
+  // while reserving a domain for the remaining subtrees.
+  Int domain = domain_beg;
+  Int index = 0;
+  for (; index < num_subtrees; ++index) {
+    const Int subtree = sorted_subtrees[index];
+    const Int remaining_domains = domain_end - domain;
+    const bool last = index == num_subtrees - 1;
+    const double share = remaining_work > 0
+                             ? remaining_domains * work_estimates[subtree] /
+                                   remaining_work
+                             : 0;
+    const Int num_subtree_domains =
+        last ? remaining_domains
+             : std::min(Int(share + 0.5), remaining_domains - 1);
+    if (num_subtree_domains < 2) {
+      break;
+    }
+    ProportionalSubtreeMapping(supernode_forest, work_estimates, {subtree},
+                               domain, domain + num_subtree_domains,
+                               subtree_domains);
+    domain += num_subtree_domains;
+    remaining_work -= work_estimates[subtree];
+  }
+  if (index == num_subtrees) {
+    return;
+  }
+
+  // Pack the remaining subtrees onto the remaining domains, heaviest first
+  // onto the least loaded domain.
+  std::vector<double> loads(domain_end - domain, 0.);
+  for (; index < num_subtrees; ++index) {
+    const Int subtree = sorted_subtrees[index];
+    const Int lightest =
+        std::min_element(loads.begin(), loads.end()) - loads.begin();
+    loads[lightest] += work_estimates[subtree];
+    (*subtree_domains)[subtree] = domain + lightest;
+  }
+}
+
+template <class Field>
+void FillSubtreeCriticalPaths(Int root, const AssemblyForest& supernode_forest,
+                              const LowerFactor<Field>& lower_factor,
+                              Buffer<double>* critical_paths) {
+  const Int child_beg = supernode_forest.child_offsets[root];
+  const Int child_end = supernode_forest.child_offsets[root + 1];
+
+  double max_child_path = 0;
+  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+    const Int child = supernode_forest.children[child_index];
+    FillSubtreeCriticalPaths(child, supernode_forest, lower_factor,
+                             critical_paths);
+    max_child_path = std::max(max_child_path, (*critical_paths)[child]);
+  }
+
+  const ConstBlasMatrixView<Field>& lower_block =
+      lower_factor.blocks[root].ToConst();
+  const Int supernode_size = lower_block.width;
+  const Int degree = lower_block.height;
+  (*critical_paths)[root] = max_child_path +
+                            std::pow(1. * supernode_size, 3.) / 3 +
+                            std::pow(1. * degree, 2.) * supernode_size;
+}
+
+template <class Field>
+void FillSubtreeSolveWorkEstimates(Int root,
+                                   const AssemblyForest& supernode_forest,
+                                   const LowerFactor<Field>& lower_factor,
+                                   Buffer<double>* work_estimates) {
+  const Int child_beg = supernode_forest.child_offsets[root];
+  const Int child_end = supernode_forest.child_offsets[root + 1];
+
+  double work = 0;
+  for (Int child_index = child_beg; child_index < child_end; ++child_index) {
+    const Int child = supernode_forest.children[child_index];
+    FillSubtreeSolveWorkEstimates(child, supernode_forest, lower_factor,
+                                  work_estimates);
+    work += (*work_estimates)[child];
+  }
+
+  const ConstBlasMatrixView<Field>& lower_block =
+      lower_factor.blocks[root].ToConst();
+  const Int supernode_size = lower_block.width;
+  const Int degree = lower_block.height;
+  work += std::pow(1. * supernode_size, 2.);
+  work += 2. * supernode_size * degree;
+  (*work_estimates)[root] = work;
+}
+
 template <class Field>
 void FillNonzeros(const CoordinateMatrix<Field>& matrix,
                   const SymmetricOrdering& ordering,
@@ -696,6 +1050,7 @@ void FillZeros(const SymmetricOrdering& ordering,
 }
 
 template <class Field>
+CATAMARI_MULTIVERSIONED
 void FormScaledTranspose(SymmetricFactorizationType factorization_type,
                          const ConstBlasMatrixView<Field>& diagonal_block,
                          const ConstBlasMatrixView<Field>& matrix,
@@ -723,6 +1078,91 @@ void FormScaledTranspose(SymmetricFactorizationType factorization_type,
   }
 }
 
+template <class Field>
+void LowerScaledOuterProduct(Int block_size,
+                             SymmetricFactorizationType factorization_type,
+                             const ConstBlasMatrixView<Field>& diagonal_block,
+                             const ConstBlasMatrixView<Field>& lower_block,
+                             const Field& beta, Field* buffer,
+                             BlasMatrixView<Field>* schur_complement) {
+  const Int degree = lower_block.height;
+  const Int supernode_size = lower_block.width;
+  block_size = std::max(block_size, Int(1));
+  for (Int j = 0; j < degree; j += block_size) {
+    const Int bsize = std::min(block_size, degree - j);
+    const ConstBlasMatrixView<Field> block_rows =
+        lower_block.Submatrix(j, 0, bsize, supernode_size);
+
+    BlasMatrixView<Field> scaled_transpose;
+    scaled_transpose.height = supernode_size;
+    scaled_transpose.width = bsize;
+    scaled_transpose.leading_dim = supernode_size;
+    scaled_transpose.data = buffer;
+    FormScaledTranspose(factorization_type, diagonal_block, block_rows,
+                        &scaled_transpose);
+
+    BlasMatrixView<Field> diagonal_update =
+        schur_complement->Submatrix(j, j, bsize, bsize);
+    MatrixMultiplyLowerNormalNormal(Field{-1}, block_rows,
+                                    scaled_transpose.ToConst(), beta,
+                                    &diagonal_update);
+
+    const Int trailing_beg = j + bsize;
+    if (trailing_beg < degree) {
+      BlasMatrixView<Field> subdiagonal_update = schur_complement->Submatrix(
+          trailing_beg, j, degree - trailing_beg, bsize);
+      MatrixMultiplyNormalNormal(
+          Field{-1},
+          lower_block.Submatrix(trailing_beg, 0, degree - trailing_beg,
+                                supernode_size),
+          scaled_transpose.ToConst(), beta, &subdiagonal_update);
+    }
+  }
+}
+
+template <class Field>
+void PackedLowerScaledOuterProduct(
+    SymmetricFactorizationType factorization_type,
+    const ConstBlasMatrixView<Field>& diagonal_block,
+    const ConstBlasMatrixView<Field>& lower_block, const Field& beta,
+    Field* buffer, PackedLowerMatrixView<Field>* schur_complement) {
+  const Int degree = lower_block.height;
+  const Int supernode_size = lower_block.width;
+  const Int num_panels = schur_complement->NumPanels();
+  for (Int panel = 0; panel < num_panels; ++panel) {
+    BlasMatrixView<Field> panel_view = schur_complement->Panel(panel);
+    const Int j = schur_complement->PanelBeg(panel);
+    const Int bsize = panel_view.width;
+    const ConstBlasMatrixView<Field> block_rows =
+        lower_block.Submatrix(j, 0, bsize, supernode_size);
+
+    BlasMatrixView<Field> scaled_transpose;
+    scaled_transpose.height = supernode_size;
+    scaled_transpose.width = bsize;
+    scaled_transpose.leading_dim = supernode_size;
+    scaled_transpose.data = buffer;
+    FormScaledTranspose(factorization_type, diagonal_block, block_rows,
+                        &scaled_transpose);
+
+    BlasMatrixView<Field> diagonal_update =
+        panel_view.Submatrix(0, 0, bsize, bsize);
+    MatrixMultiplyLowerNormalNormal(Field{-1}, block_rows,
+                                    scaled_transpose.ToConst(), beta,
+                                    &diagonal_update);
+
+    const Int trailing_beg = j + bsize;
+    if (trailing_beg < degree) {
+      BlasMatrixView<Field> subdiagonal_update = panel_view.Submatrix(
+          bsize, 0, degree - trailing_beg, bsize);
+      MatrixMultiplyNormalNormal(
+          Field{-1},
+          lower_block.Submatrix(trailing_beg, 0, degree - trailing_beg,
+                                supernode_size),
+          scaled_transpose.ToConst(), beta, &subdiagonal_update);
+    }
+  }
+}
+
 template <class Field>
 void UpdateDiagonalBlock(
     SymmetricFactorizationType factorization_type,
@@ -851,39 +1291,333 @@ void UpdateSubdiagonalBlock(
 }
 
 template <class Field>
-void populateChildToParentMap(Int supernode, Int child, Int child_degree,
-                              const SymmetricOrdering& ordering,
-                              const LowerFactor<Field> *lower_factor) {
-    auto &child_rel_indices = ordering.assembly_forest.child_rel_indices[child]; // locations of child rows/cols relative to the parent front's upper-left corner
-    if (child_rel_indices.Size() == child_degree) return;
+void FillChildRelativeIndices(const SymmetricOrdering& ordering,
+                              const LowerFactor<Field>& lower_factor,
+                              ChildRelativeIndices* relative_indices) {
+  const Int num_supernodes = ordering.supernode_sizes.Size();
+  const Buffer<Int>& parents = ordering.assembly_forest.parents;
 
+  // Only non-root supernodes are mapped into a parent front.
+  relative_indices->offsets.Resize(num_supernodes + 1);
+  relative_indices->offsets[0] = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int degree =
+        parents[supernode] >= 0 ? lower_factor.blocks[supernode].height : 0;
+    relative_indices->offsets[supernode + 1] =
+        relative_indices->offsets[supernode] + degree;
+  }
+  relative_indices->indices.Resize(relative_indices->offsets[num_supernodes]);
+  relative_indices->num_diag_indices.Resize(num_supernodes, 0);
+
+  for (Int child = 0; child < num_supernodes; ++child) {
+    const Int supernode = parents[child];
+    if (supernode < 0) continue;
+    const Int child_degree = lower_factor.blocks[child].height;
     const Int supernode_size = ordering.supernode_sizes[supernode];
     const Int supernode_start = ordering.supernode_offsets[supernode];
     const Int supernode_end = supernode_start + supernode_size;
-
-    Int &num_child_diag_indices = ordering.assembly_forest.num_child_diag_indices[child];
-    const Int* parent_indices = lower_factor->StructureBeg(supernode);
-    // Fill the mapping from the child structure into the parent front.
-    child_rel_indices.Resize(child_degree);
-    num_child_diag_indices = 0;
-
-    const Int* child_indices = lower_factor->StructureBeg(child);
+    const Int* parent_indices = lower_factor.StructureBeg(supernode);
+    const Int* child_indices = lower_factor.StructureBeg(child);
+    LocalInt* child_rel_indices =
+        relative_indices->indices.Data() + relative_indices->offsets[child];
+
+    // Rows within the parent's supernode index its diagonal block, and the
+    // remainder index the (interleaved) lower block of its front.
+    Int num_child_diag_indices = 0;
     Int i_rel = 0;
     for (Int i = 0; i < child_degree; ++i) {
-        const Int row = child_indices[i];
-        if (row < supernode_end) {
-            child_rel_indices[i] = row - supernode_start;
-            ++num_child_diag_indices;
-        } else {
-            while (parent_indices[i_rel] != row) {
-                ++i_rel;
-                CATAMARI_ASSERT(i_rel < schur_complement.height, "Relative index is out-of-bounds.");
-            }
-            child_rel_indices[i] = supernode_size + i_rel; // index into the lower block of the front (diagonal and lower factor blocks are now unified/interleaved!)
+      const Int row = child_indices[i];
+      if (row < supernode_end) {
+        child_rel_indices[i] = row - supernode_start;
+        ++num_child_diag_indices;
+      } else {
+        while (parent_indices[i_rel] != row) {
+          ++i_rel;
+          CATAMARI_ASSERT(i_rel < lower_factor.blocks[supernode].height,
+                          "Relative index is out-of-bounds.");
         }
+        child_rel_indices[i] = supernode_size + i_rel;
+      }
     }
+    relative_indices->num_diag_indices[child] = num_child_diag_indices;
+  }
+  relative_indices->runs.Encode(
+      num_supernodes, relative_indices->offsets.Data(),
+      relative_indices->indices.Data(),
+      relative_indices->num_diag_indices.Data());
+  relative_indices->SelectMergeKernels();
+}
+
+template <class Field>
+void AddChildColumn(const AssemblyForest& forest, Int child, Int child_degree,
+                    Int begin, const Field* child_column, Field* front_column) {
+  const ChildRelativeIndices& relative_indices = *forest.child_relative_indices;
+  if (relative_indices.runs.Encoded(child)) {
+    ForEachIndexRun(relative_indices.runs.Beg(child),
+                    relative_indices.runs.End(child), begin,
+                    [&](Int position, Int index, Int length) {
+                      const Field* source = child_column + position;
+                      Field* target = front_column + index;
+                      for (Int i = 0; i < length; ++i) target[i] += source[i];
+                    });
+    return;
+  }
+  const LocalInt* child_rel_indices = forest.ChildRelativeIndicesBeg(child);
+  for (Int i = begin; i < child_degree; ++i)
+    front_column[child_rel_indices[i]] += child_column[i];
 }
 
+template <class Field>
+void CopyChildColumn(const AssemblyForest& forest, Int child, Int child_degree,
+                     Int begin, const Field* child_column,
+                     Field* front_column) {
+  const ChildRelativeIndices& relative_indices = *forest.child_relative_indices;
+  if (relative_indices.runs.Encoded(child)) {
+    ForEachIndexRun(relative_indices.runs.Beg(child),
+                    relative_indices.runs.End(child), begin,
+                    [&](Int position, Int index, Int length) {
+                      std::copy(child_column + position,
+                                child_column + position + length,
+                                front_column + index);
+                    });
+    return;
+  }
+  const LocalInt* child_rel_indices = forest.ChildRelativeIndicesBeg(child);
+  for (Int i = begin; i < child_degree; ++i)
+    front_column[child_rel_indices[i]] = child_column[i];
+}
+
+template <class Field>
+void AssignChildColumn(const AssemblyForest& forest, Int child,
+                       Int child_degree, Int begin, const Field* child_column,
+                       Int front_beg, Int front_end, Field* front_column) {
+  const ChildRelativeIndices& relative_indices = *forest.child_relative_indices;
+  Int next = front_beg;
+  if (relative_indices.runs.Encoded(child)) {
+    ForEachIndexRun(relative_indices.runs.Beg(child),
+                    relative_indices.runs.End(child), begin,
+                    [&](Int position, Int index, Int length) {
+                      std::fill(front_column + next, front_column + index,
+                                Field{0});
+                      std::copy(child_column + position,
+                                child_column + position + length,
+                                front_column + index);
+                      next = index + length;
+                    });
+  } else {
+    const LocalInt* child_rel_indices = forest.ChildRelativeIndicesBeg(child);
+    for (Int i = begin; i < child_degree; ++i) {
+      const Int index = child_rel_indices[i];
+      std::fill(front_column + next, front_column + index, Field{0});
+      front_column[index] = child_column[i];
+      next = index + 1;
+    }
+  }
+  std::fill(front_column + next, front_column + front_end, Field{0});
+}
+
+namespace merge_kernels {
+
+// Adds the lower triangle of the 'degree' x 'degree' child Schur complement
+// into the parent front. With the degree fixed at compile time, the relative
+// indices are held in registers and both loops can be fully unrolled.
+template <Int degree, class Field>
+CATAMARI_MULTIVERSIONED
+void AddChildSchurComplement(
+    const LocalInt* child_rel_indices, Int num_child_diag_indices,
+    Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field>* diagonal_block,
+    BlasMatrixView<Field>* schur_complement) {
+  LocalInt rel_indices[degree];
+  for (Int i = 0; i < degree; ++i) {
+    rel_indices[i] = child_rel_indices[i];
+  }
+  for (Int j = 0; j < degree; ++j) {
+    const Field* child_column = child_schur_complement.Pointer(0, j);
+    Field* front_column =
+        j < num_child_diag_indices
+            ? diagonal_block->Pointer(0, rel_indices[j])
+            : schur_complement->Pointer(-supernode_size,
+                                        rel_indices[j] - supernode_size);
+    for (Int i = j; i < degree; ++i) {
+      front_column[rel_indices[i]] += child_column[i];
+    }
+  }
+}
+
+// Dispatches to the kernel instance whose compile-time degree matches the
+// runtime degree 'degree', which must lie in [1, kMaxMergeKernelDegree].
+template <class Field, std::size_t... degrees>
+void AddChildSchurComplement(
+    Int degree, const LocalInt* child_rel_indices, Int num_child_diag_indices,
+    Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field>* diagonal_block,
+    BlasMatrixView<Field>* schur_complement, std::index_sequence<degrees...>) {
+  typedef void (*Kernel)(const LocalInt*, Int, Int,
+                         const ConstBlasMatrixView<Field>&,
+                         BlasMatrixView<Field>*, BlasMatrixView<Field>*);
+  static const Kernel kernels[] = {
+      &AddChildSchurComplement<Int(degrees) + 1, Field>...};
+  kernels[degree - 1](child_rel_indices, num_child_diag_indices,
+                      supernode_size, child_schur_complement, diagonal_block,
+                      schur_complement);
+}
+
+typedef std::make_index_sequence<ChildRelativeIndices::kMaxMergeKernelDegree>
+    KernelDegrees;
+
+}  // namespace merge_kernels
+
+inline Int MergeKernelDegree(const AssemblyForest& forest, Int child) {
+  const Buffer<Int>& kernel_degrees =
+      forest.child_relative_indices->merge_kernels;
+  return kernel_degrees.Empty() ? 0 : kernel_degrees[child];
+}
+
+template <class Field>
+void SpecializedMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement) {
+  const Int degree = MergeKernelDegree(forest, child);
+  CATAMARI_ASSERT(degree > 0 && degree == child_schur_complement.height,
+                  "The merge kernel did not match the child degree.");
+  merge_kernels::AddChildSchurComplement(
+      degree, forest.ChildRelativeIndicesBeg(child),
+      forest.NumChildDiagIndices(child), supernode_size,
+      child_schur_complement, &diagonal_block, &schur_complement,
+      merge_kernels::KernelDegrees());
+}
+
+template <class Field>
+void BlockMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement) {
+  const ChildRelativeIndices& relative_indices = *forest.child_relative_indices;
+  const Int num_child_diag_indices = relative_indices.num_diag_indices[child];
+  const IndexRun* runs_beg = relative_indices.runs.Beg(child);
+  const IndexRun* runs_end = relative_indices.runs.End(child);
+  const Int child_leading_dim = child_schur_complement.leading_dim;
+  for (const IndexRun* column_run = runs_beg; column_run != runs_end;
+       ++column_run) {
+    // Since no run straddles the parent's diagonal block, all of the columns
+    // of the run land in the same block of the front.
+    const bool diagonal = column_run->position < num_child_diag_indices;
+    Field* front_columns =
+        diagonal ? diagonal_block.Pointer(0, column_run->index)
+                 : schur_complement.Pointer(-supernode_size,
+                                            column_run->index - supernode_size);
+    const Int front_leading_dim =
+        diagonal ? diagonal_block.leading_dim : schur_complement.leading_dim;
+    const Field* child_columns =
+        child_schur_complement.Pointer(0, column_run->position);
+    const Int width = column_run->length;
+
+    // The lower triangle of the block of the run with itself.
+    for (Int j = 0; j < width; ++j) {
+      const Field* source =
+          child_columns + j * child_leading_dim + column_run->position;
+      Field* target = front_columns + j * front_leading_dim + column_run->index;
+      for (Int i = j; i < width; ++i) {
+        target[i] += source[i];
+      }
+    }
+
+    // The dense blocks of the subsequent (row) runs.
+    for (const IndexRun* row_run = column_run + 1; row_run != runs_end;
+         ++row_run) {
+      const Int height = row_run->length;
+      for (Int j = 0; j < width; ++j) {
+        const Field* source =
+            child_columns + j * child_leading_dim + row_run->position;
+        Field* target = front_columns + j * front_leading_dim + row_run->index;
+        for (Int i = 0; i < height; ++i) {
+          target[i] += source[i];
+        }
+      }
+    }
+  }
+}
+
+inline bool HasMergePlan(const AssemblyForest& forest, Int child) {
+  return MergeKernelDegree(forest, child) ||
+         forest.child_relative_indices->runs.Encoded(child);
+}
+
+template <class Field>
+void PlannedMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement) {
+  if (MergeKernelDegree(forest, child)) {
+    SpecializedMergeChildSchurComplement(forest, child, supernode_size,
+                                         child_schur_complement,
+                                         diagonal_block, schur_complement);
+  } else {
+    BlockMergeChildSchurComplement(forest, child, supernode_size,
+                                   child_schur_complement, diagonal_block,
+                                   schur_complement);
+  }
+}
+
+template <class Field>
+CATAMARI_MULTIVERSIONED
+void MergeChildSchurComplement(Int supernode, Int child,
+                               const SymmetricOrdering& ordering,
+                               const LowerFactor<Field>* lower_factor,
+                               const BlasMatrixView<Field>& child_schur_complement,
+                               BlasMatrixView<Field> lower_block,
+                               BlasMatrixView<Field> diagonal_block,
+                               BlasMatrixView<Field> schur_complement,
+                               bool freshShurComplement) {
+  const AssemblyForest& forest = ordering.assembly_forest;
+  const Int child_degree = child_schur_complement.height;
+  const Int supernode_size = ordering.supernode_sizes[supernode];
+  const Int num_child_diag_indices = forest.NumChildDiagIndices(child);
+  const LocalInt* child_rel_indices = forest.ChildRelativeIndicesBeg(child);
+
+  // Only the lower triangle of a Schur complement is ever read.
+  if (freshShurComplement) {
+    for (Int j = 0; j < schur_complement.width; ++j) {
+      std::fill(schur_complement.Pointer(j, j),
+                schur_complement.Pointer(schur_complement.height, j),
+                Field{0});
+    }
+  }
+
+  if (HasMergePlan(forest, child)) {
+    PlannedMergeChildSchurComplement(
+        forest, child, supernode_size, child_schur_complement.ToConst(),
+        diagonal_block, schur_complement);
+    return;
+  }
+
+  // Add the child's columns which map into the diagonal block. Their rows
+  // below the diagonal block land in the lower block, which is stored
+  // directly beneath it within the (contiguous) front.
+  for (Int j = 0; j < num_child_diag_indices; ++j) {
+    const Field* child_column = child_schur_complement.Pointer(0, j);
+    Field* factor_column = diagonal_block.Pointer(0, child_rel_indices[j]);
+    AddChildColumn(forest, child, child_degree, j, child_column,
+                   factor_column);
+  }
+
+  // Contribute into the bottom-right block of the front, whose upper-left
+  // corner is offset by 'supernode_size' in each dimension.
+  for (Int j = num_child_diag_indices; j < child_degree; ++j) {
+    const Field* child_column = child_schur_complement.Pointer(0, j);
+    Field* schur_column = schur_complement.Pointer(
+        -supernode_size, child_rel_indices[j] - supernode_size);
+    AddChildColumn(forest, child, child_degree, j, child_column,
+                   schur_column);
+  }
+}
 
 template <class Field>
 void MergeChildSchurComplements(Int supernode,
@@ -933,7 +1667,8 @@ Int FactorDiagonalBlock(
           block_size, dynamic_reg_params, diagonal_block,
           dynamic_regularization);
     } else {
-      num_pivots = LDLAdjointFactorization(block_size, diagonal_block);
+      num_pivots =
+          LDLAdjointFactorizationDynamicBLASDispatch(block_size, diagonal_block);
     }
   } else {
     num_pivots = LDLTransposeFactorization(block_size, diagonal_block);
@@ -953,6 +1688,160 @@ Int PivotedFactorDiagonalBlock(Int block_size,
   return num_pivots;
 }
 
+template <class Field>
+Int ThresholdPivotedPartialFactorization(
+    Int block_size, SymmetricFactorizationType factorization_type,
+    const ComplexBase<Field>& threshold,
+    const ComplexBase<Field>& pivot_tolerance, Int num_fully_summed,
+    BlasMatrixView<Field>* front, Buffer<Int>* permutation,
+    Buffer<Field>* buffer) {
+  typedef ComplexBase<Field> Real;
+  CATAMARI_ASSERT(factorization_type != kCholeskyFactorization,
+                  "Threshold pivoting requires an LDL' factorization.");
+  const bool transpose = factorization_type == kLDLTransposeFactorization;
+  const Int height = front->height;
+  BlasMatrixView<Field>& matrix = *front;
+  auto reflect = [&](const Field& value) {
+    return transpose ? value : Conjugate(value);
+  };
+
+  // Symmetrically swaps positions 'i' < 'j' of the lower triangle.
+  auto swap = [&](Int i, Int j) {
+    std::swap(matrix(i, i), matrix(j, j));
+    for (Int k = 0; k < i; ++k) {
+      std::swap(matrix(i, k), matrix(j, k));
+    }
+    for (Int k = i + 1; k < j; ++k) {
+      const Field value = matrix(k, i);
+      matrix(k, i) = reflect(matrix(j, k));
+      matrix(j, k) = reflect(value);
+    }
+    matrix(j, i) = reflect(matrix(j, i));
+    for (Int k = j + 1; k < height; ++k) {
+      std::swap(matrix(k, i), matrix(k, j));
+    }
+  };
+
+  permutation->Resize(num_fully_summed);
+  std::iota(permutation->begin(), permutation->end(), Int(0));
+
+  Int num_pivots = 0;
+  for (; num_pivots < num_fully_summed; ++num_pivots) {
+    const Int k = num_pivots;
+
+    // Find the first acceptable candidate.
+    Int pivot = -1;
+    for (Int candidate = k; candidate < num_fully_summed; ++candidate) {
+      const Real diagonal_abs = std::abs(matrix(candidate, candidate));
+      if (diagonal_abs <= pivot_tolerance) continue;
+      Real column_max = 0;
+      for (Int i = k; i < candidate; ++i) {
+        column_max = std::max(column_max, std::abs(matrix(candidate, i)));
+      }
+      for (Int i = candidate + 1; i < height; ++i) {
+        column_max = std::max(column_max, std::abs(matrix(i, candidate)));
+      }
+      if (diagonal_abs >= threshold * column_max) {
+        pivot = candidate;
+        break;
+      }
+    }
+    if (pivot < 0) break;
+    if (pivot != k) {
+      swap(k, pivot);
+      std::swap((*permutation)[k], (*permutation)[pivot]);
+    }
+
+    // Update the remaining fully-summed columns and then scale the pivot
+    // column into the factor.
+    Field& delta = matrix(k, k);
+    if (!transpose) delta = RealPart(delta);
+    for (Int j = k + 1; j < num_fully_summed; ++j) {
+      const Field coefficient = reflect(matrix(j, k)) / delta;
+      for (Int i = j; i < height; ++i) {
+        matrix(i, j) -= matrix(i, k) * coefficient;
+      }
+    }
+    for (Int i = k + 1; i < height; ++i) {
+      matrix(i, k) /= delta;
+    }
+  }
+
+  const Int degree = height - num_fully_summed;
+  if (num_pivots && degree) {
+    const Int buffer_size = std::min(block_size, degree) * num_pivots;
+    if (buffer->Size() < std::size_t(buffer_size)) buffer->Resize(buffer_size);
+    BlasMatrixView<Field> schur_complement = matrix.Submatrix(
+        num_fully_summed, num_fully_summed, degree, degree);
+    LowerScaledOuterProduct(
+        block_size, factorization_type,
+        matrix.ToConst().Submatrix(0, 0, num_pivots, num_pivots),
+        matrix.ToConst().Submatrix(num_fully_summed, 0, degree, num_pivots),
+        Field{1}, buffer->Data(), &schur_complement);
+  }
+  return num_pivots;
+}
+
+template <class Field>
+bool InterleavedFactorFronts(SymmetricFactorizationType factorization_type,
+                             Int height, Int width, Int batch_size,
+                             Field* fronts) {
+  typedef ComplexBase<Field> Real;
+  const bool cholesky = factorization_type == kCholeskyFactorization;
+  const bool transpose = factorization_type == kLDLTransposeFactorization;
+  auto entries = [&](Int i, Int j) {
+    return fronts + (i + j * height) * batch_size;
+  };
+
+  Buffer<Field> pivots(batch_size);
+  Buffer<Field> coefficients(batch_size);
+  for (Int k = 0; k < width; ++k) {
+    Field* diagonal = entries(k, k);
+    for (Int b = 0; b < batch_size; ++b) {
+      if (transpose) {
+        if (diagonal[b] == Field{0}) return false;
+      } else {
+        const Real delta = RealPart(diagonal[b]);
+        if (cholesky ? delta <= Real{0} : delta == Real{0}) return false;
+        diagonal[b] = cholesky ? std::sqrt(delta) : delta;
+      }
+      pivots[b] = diagonal[b];
+    }
+
+    // The Cholesky column is scaled before the trailing update, whereas the
+    // LDL updates divide by the pivot and the column is scaled afterwards.
+    if (cholesky) {
+      for (Int i = k + 1; i < height; ++i) {
+        Field* column = entries(i, k);
+        for (Int b = 0; b < batch_size; ++b) column[b] /= pivots[b];
+      }
+    }
+
+    for (Int j = k + 1; j < width; ++j) {
+      const Field* row = entries(j, k);
+      for (Int b = 0; b < batch_size; ++b) {
+        const Field value = transpose ? row[b] : Conjugate(row[b]);
+        coefficients[b] = cholesky ? value : value / pivots[b];
+      }
+      for (Int i = j; i < height; ++i) {
+        const Field* source = entries(i, k);
+        Field* target = entries(i, j);
+        for (Int b = 0; b < batch_size; ++b) {
+          target[b] -= source[b] * coefficients[b];
+        }
+      }
+    }
+
+    if (!cholesky) {
+      for (Int i = k + 1; i < height; ++i) {
+        Field* column = entries(i, k);
+        for (Int b = 0; b < batch_size; ++b) column[b] /= pivots[b];
+      }
+    }
+  }
+  return true;
+}
+
 template <class Field>
 void SolveAgainstDiagonalBlock(
     SymmetricFactorizationType factorization_type,
@@ -975,9 +1864,58 @@ void SolveAgainstDiagonalBlock(
   }
 }
 
+template <class Field>
+void OrthonormalizeColumns(BlasMatrixView<Field>* matrix) {
+  typedef ComplexBase<Field> Real;
+  const Int height = matrix->height;
+  const Int width = matrix->width;
+  for (Int j = 0; j < width; ++j) {
+    Field* column = matrix->Pointer(0, j);
+    for (Int pass = 0; pass < 2; ++pass) {
+      for (Int k = 0; k < j; ++k) {
+        const Field* basis_column = matrix->Pointer(0, k);
+        Field coefficient{0};
+        for (Int i = 0; i < height; ++i) {
+          coefficient += Conjugate(basis_column[i]) * column[i];
+        }
+        for (Int i = 0; i < height; ++i) {
+          column[i] -= coefficient * basis_column[i];
+        }
+      }
+    }
+    Real norm = 0;
+    for (Int i = 0; i < height; ++i) {
+      norm += RealPart(Conjugate(column[i]) * column[i]);
+    }
+    norm = std::sqrt(norm);
+    for (Int i = 0; i < height; ++i) {
+      column[i] /= norm;
+    }
+  }
+}
+
+template <class Field>
+void ProjectOutBasis(const ConstBlasMatrixView<Field>& basis, bool conjugate,
+                     BlasMatrixView<Field>* matrix) {
+  BlasMatrix<Field> conjugated_basis;
+  ConstBlasMatrixView<Field> projection_basis = basis;
+  if (conjugate && IsComplex<Field>::value) {
+    conjugated_basis = basis;
+    ConjugateMatrix(&conjugated_basis.view);
+    projection_basis = conjugated_basis.ConstView();
+  }
+  BlasMatrix<Field> coefficients;
+  coefficients.Resize(basis.width, matrix->width);
+  MatrixMultiplyAdjointNormal(Field{1}, projection_basis, matrix->ToConst(),
+                              Field{0}, &coefficients.view);
+  MatrixMultiplyNormalNormal(Field{-1}, projection_basis,
+                             coefficients.ConstView(), Field{1}, matrix);
+}
+
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
 #include "catamari/sparse_ldl/supernodal/supernode_utils/openmp-impl.hpp"
+#include "catamari/sparse_ldl/supernodal/supernode_utils/tiled-impl.hpp"
 
 #endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_IMPL_H_
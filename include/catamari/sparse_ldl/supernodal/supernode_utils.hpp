@@ -8,7 +8,17 @@
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_H_
 
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <tbb/cache_aligned_allocator.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/spin_mutex.h>
+
 #include "catamari/buffer.hpp"
+#include "catamari/cancellation_token.hpp"
 #include "catamari/sparse_ldl/scalar.hpp"
 #include "catamari/symmetric_ordering.hpp"
 
@@ -21,6 +31,35 @@
 
 namespace catamari {
 
+// A model of the time required to factor a supernode, used to decide
+// child/parent mergability by whether the merged supernode is predicted to be
+// cheaper to factor than the two separate supernodes (including the assembly
+// of the child's Schur complement into its parent).
+struct SupernodalRelaxationCostModel {
+  // A list of pairs of front sizes (the supernode size plus its degree) and
+  // the rates, in billions of operations on the scalar type per second, of the
+  // dense kernels on fronts of that size. The sizes must be increasing; the
+  // rate is interpolated linearly in the logarithm of the size and held
+  // constant beyond the ends of the list.
+  //
+  // The defaults are typical of a single core with an optimized BLAS; since
+  // the rates depend on the machine, the scalar type, and the number of
+  // threads given to each front, they should preferably be measured with
+  // 'CalibrateSupernodalRelaxationCostModel' from within the task arena
+  // which will run the factorization.
+  std::vector<std::pair<Int, double>> gflops_curve{
+      std::make_pair(8, 0.5),   std::make_pair(32, 2.),
+      std::make_pair(128, 6.),  std::make_pair(512, 12.),
+      std::make_pair(2048, 16.),
+  };
+
+  // The number of seconds charged for moving each entry of a front through
+  // memory, i.e., for storing each entry of the factor (including the explicit
+  // zeros introduced by a merger) and for assembling each entry of a child's
+  // Schur complement into its parent.
+  double seconds_per_entry = 1e-9;
+};
+
 struct SupernodalRelaxationControl {
   // If true, relaxed supernodes are created in a manner similar to the
   // suggestion from:
@@ -38,6 +77,34 @@ struct SupernodalRelaxationControl {
       std::make_pair(48, 0.1f),
       std::make_pair(std::numeric_limits<Int>::max(), 0.05f),
   };
+
+  // If true, the fixed 'cutoff_pairs' are ignored and a child is instead
+  // merged into its parent whenever 'cost_model' predicts that the merged
+  // supernode is no more expensive than the pair.
+  bool use_cost_model = false;
+
+  // The cost model for deciding mergability when 'use_cost_model' is true. It
+  // is also used to estimate the factorization time of the resulting
+  // partition (see 'SparseLDLResult::relaxation_estimated_seconds') so that
+  // the two strategies may be compared.
+  SupernodalRelaxationCostModel cost_model;
+};
+
+// The outcome of the (possible) relaxation of a fundamental supernode
+// partition.
+struct SupernodalRelaxationStatistics {
+  // The number of fundamental supernodes.
+  Int num_fundamental_supernodes = 0;
+
+  // The number of supernodes after relaxation.
+  Int num_supernodes = 0;
+
+  // The number of explicit zeros stored in the factor due to the relaxation.
+  Int num_explicit_zeros = 0;
+
+  // The factorization time of the relaxed partition predicted by the cost
+  // model.
+  double estimated_seconds = 0;
 };
 
 namespace supernodal_ldl {
@@ -91,6 +158,26 @@ struct LeftLookingSharedState {
   // of each supernode.
   LinkedLists descendants;
 
+  // Whether disjoint subtrees are concurrently factored, in which case
+  // the insertions into the (shared) lists of their common ancestors are
+  // serialized by 'descendants_mutex'.
+  bool concurrent = false;
+  tbb::spin_mutex descendants_mutex;
+
+  // Set once any concurrently factored subtree fails so that the others
+  // may stop early.
+  std::atomic<bool> failed{false};
+
+  // Inserts 'descendant' into the list of 'ancestor'.
+  void InsertDescendant(Int ancestor, Int descendant) {
+    if (concurrent) {
+      tbb::spin_mutex::scoped_lock lock(descendants_mutex);
+      descendants.Insert(ancestor, descendant);
+    } else {
+      descendants.Insert(ancestor, descendant);
+    }
+  }
+
 #ifdef CATAMARI_ENABLE_TIMERS
   // A separate timer for each supernode's inclusive processing time.
   Buffer<quotient::Timer> inclusive_timers;
@@ -110,6 +197,12 @@ struct RightLookingSharedState {
   // actively in use.
   Buffer<BlasMatrixView<Field>> schur_complements;
 
+  // The packed Schur complements (see 'Control::schur_complement_panel_width')
+  // of the supernodes whose fronts are held on the stacks of the serial
+  // subtrees; one is in use while its data is non-null, in which case the
+  // corresponding member of 'schur_complements' is unused.
+  Buffer<PackedLowerMatrixView<Field>> packed_schur_complements;
+
   // The underlying buffers for the Schur complement portions of the fronts.
   // They are allocated and deallocated as the factorization progresses.
   // (Julian Panetta: We no longer use this during factorization;
@@ -122,9 +215,63 @@ struct RightLookingSharedState {
 
   Buffer<SchurComplementStorage<Field>> schur_complement_storage;
 
+  // The bytes held by 'schur_complement_storage' and their high-water mark
+  // over the current factorization.
+  StorageHighWaterMark schur_complement_memory;
+
+  // Whether each (leaf) supernode's front was already factored as part of an
+  // interleaved batch, so that its finalization only forms the Schur
+  // complement.
+  Buffer<char> batch_factored;
+
+  // If non-null during a solve, the caller's (unpermuted) right-hand sides,
+  // whose rows are gathered into each supernode's rows of the permuted
+  // right-hand sides just before its forward elimination and scattered back
+  // once its backward solve completes, rather than being permuted in two
+  // separate full passes.
+  BlasMatrixView<Field>* unpermuted_right_hand_sides = nullptr;
+
+  // Whether a solve conjugates the right-hand sides on their way into the
+  // factorization's ordering and the solutions on their way out (see
+  // 'SolveOperation').
+  bool conjugate_right_hand_sides = false;
+
+  // The per-thread stacks of the updates of the sequential subtrees of the
+  // multithreaded solves (see 'Control::stack_solve_workspace').
+  tbb::enumerable_thread_specific<SchurComplementStorage<Field>> solve_stacks;
+
+  // If nonempty, whether each supernode roots a sequential subtree which is
+  // factored left-looking (see 'Control::left_looking_subtree_max_front'),
+  // and the left-looking state shared by all such subtrees.
+  Buffer<char> left_looking_subtrees;
+  LeftLookingSharedState left_looking;
+
+  // If non-null during a factorization, the token whose cancellation (see
+  // 'Control::cancellation') counts as a failure.
+  const CancellationToken* cancellation = nullptr;
+
   void unsetFailed() { m_fail.store(false, std::memory_order_relaxed); }
   void   setFailed() { m_fail.store(true, std::memory_order_relaxed); }
-  bool   hasFailed() const { return m_fail.load(std::memory_order_relaxed); }
+  // A cancellation is latched into the failure flag once it is observed.
+  bool hasFailed() const {
+    if (m_fail.load(std::memory_order_relaxed)) return true;
+    if (cancellation && cancellation->Cancelled()) {
+      m_fail.store(true, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  // Running totals of the positive and negative pivots over all subtrees, used
+  // to abort as soon as an expected inertia becomes unattainable.
+  std::atomic<Int> num_positive_pivots{0};
+  std::atomic<Int> num_negative_pivots{0};
+
+  // If positive, the thread-local number of BLAS threads used by the fronts
+  // above the tree-parallel subtrees, whose own fronts use the (then
+  // single-threaded) global BLAS setting. If zero, the BLAS threading is
+  // left as the caller configured it.
+  int root_blas_threads = 0;
 
 #ifdef CATAMARI_ENABLE_TIMERS
   // A separate timer for each supernode's inclusive processing time.
@@ -135,7 +282,20 @@ struct RightLookingSharedState {
 #endif  // ifdef CATAMARI_ENABLE_TIMERS
 
 private:
-  std::atomic<bool> m_fail; // Global flag to indicate factorization failure and accelerate early-exit in parallel case.
+  mutable std::atomic<bool> m_fail; // Global flag to indicate factorization failure and accelerate early-exit in parallel case.
+};
+
+// A caller-owned workspace for the solves against a supernodal
+// factorization. Any number of threads may solve concurrently against the
+// same factorization as long as each uses its own workspace, whose memory is
+// reused by all of its solves (against factorizations of any structure).
+template <typename Field>
+struct SolveWorkspace {
+  // The right-hand sides in the ordering of the factorization.
+  Buffer<Field> permute_scratch;
+
+  // The packed per-supernode update arrays of the multithreaded sweeps.
+  RightLookingSharedState<Field> shared_state;
 };
 
 template <typename Field>
@@ -155,6 +315,59 @@ struct PrivateState {
   Buffer<Field> workspace_buffer;
 };
 
+// The per-thread workspace of the multithreaded right-looking factorization.
+// The buffers start on cache-line boundaries and are grown lazily by the
+// thread that owns them, so they can be reused across factorizations.
+template <typename Field>
+struct RightLookingPrivateState {
+  // A buffer for storing (scaled) transposed blocks.
+  std::vector<Field, tbb::cache_aligned_allocator<Field>>
+      scaled_transpose_buffer;
+
+  // A general-purpose buffer (e.g., for the selected inversion).
+  std::vector<Field, tbb::cache_aligned_allocator<Field>> workspace_buffer;
+
+  // The statistics (pivot counts and signs, determinant, flops, tasks,
+  // extents and dynamic regularizations) of the fronts which this thread
+  // factored and merged during the current right-looking factorization.
+  // They are combined into the overall result only once the factorization
+  // completes, rather than being merged up every level of the tree.
+  SparseLDLResult<Field> result;
+
+  // The workspaces of the subtrees which this thread factored left-looking.
+  PrivateState<Field> left_looking;
+
+  // Returns a pointer to at least 'size' entries of the scaled transpose
+  // buffer.
+  Field* ScaledTransposeBuffer(Int size) {
+    if (Int(scaled_transpose_buffer.size()) < size) {
+      scaled_transpose_buffer.resize(size);
+    }
+    return scaled_transpose_buffer.data();
+  }
+
+  // Returns a pointer to at least 'size' entries of the workspace buffer.
+  Field* WorkspaceBuffer(Int size) {
+    if (Int(workspace_buffer.size()) < size) {
+      workspace_buffer.resize(size);
+    }
+    return workspace_buffer.data();
+  }
+};
+
+// Thread-local right-looking workspaces. Unlike an array indexed by
+// 'tbb::this_task_arena::current_thread_index()', this is valid from within
+// any (possibly nested or oversubscribed) task arena. The default
+// 'cache_aligned_allocator' pads each thread's entry to avoid false sharing.
+template <typename Field>
+using RightLookingPrivateStates =
+    tbb::enumerable_thread_specific<RightLookingPrivateState<Field>>;
+
+// Thread-local left-looking workspaces (see 'RightLookingPrivateStates').
+template <typename Field>
+using LeftLookingPrivateStates =
+    tbb::enumerable_thread_specific<PrivateState<Field>>;
+
 // Fills 'member_to_index' with a length 'num_rows' array whose i'th index
 // is the index of the supernode containing column 'i'.
 void MemberToIndex(Int num_rows, const Buffer<Int>& supernode_starts,
@@ -181,9 +394,26 @@ void FormFundamentalSupernodes(const Buffer<Int>& scalar_parents,
                                const Buffer<Int>& scalar_degrees,
                                Buffer<Int>* supernode_sizes);
 
+// Relabels the supernodes (and, accordingly, the rows) of the ordering into
+// a depth-first postorder of its assembly forest, with the children of each
+// supernode visited in their stored order, and permutes the supernode degrees
+// and the map from the rows to their supernodes to match. Returns false,
+// without modification, if the supernodes were already in that order.
+bool PostorderSupernodes(SymmetricOrdering* ordering,
+                         Buffer<Int>* supernode_degrees,
+                         Buffer<Int>* supernode_member_to_index);
+
+// Modifies a supernodal partition so that the rows beyond 'num_interior' form
+// a single (trailing) supernode, splitting any supernode which straddles the
+// boundary. Since the trailing supernode contains the ancestors of every row
+// it contains, it is a root of the assembly forest, and each interior
+// supernode coupled to it remains its descendant.
+void IsolateInterfaceSupernode(Int num_interior, Buffer<Int>* supernode_sizes);
+
 // Returns whether or not the child supernode can be merged into its parent by
 // counting the number of explicit zeros that would be introduced by the
-// merge.
+// merge (or, if 'control.use_cost_model' is true, by comparing the predicted
+// costs of the merged and separate supernodes).
 //
 // Consider the possibility of merging a child supernode '0' with parent
 // supernode '1', which would result in an expanded supernode of the form:
@@ -210,6 +440,35 @@ MergableStatus MergableSupernode(Int child_size, Int child_degree,
                                  Int num_child_zeros, Int num_parent_zeros,
                                  const SupernodalRelaxationControl& control);
 
+// Returns the rate, in billions of operations per second, predicted by the
+// cost model for a front of the given size.
+double RelaxationCostModelRate(const SupernodalRelaxationCostModel& cost_model,
+                               Int front_size);
+
+// Returns the number of seconds predicted by the cost model for factoring a
+// supernode of the given size and degree, storing its factor, and assembling
+// its Schur complement into its parent.
+double EstimatedSupernodeSeconds(Int supernode_size, Int degree,
+                                 const SupernodalRelaxationCostModel& cost_model);
+
+// Returns the statistics of the relaxation of the fundamental supernode
+// partition with the given sizes and degrees into the given relaxed one.
+SupernodalRelaxationStatistics RelaxationStatistics(
+    const Buffer<Int>& fund_supernode_sizes,
+    const Buffer<Int>& fund_supernode_degrees,
+    const Buffer<Int>& supernode_sizes, const Buffer<Int>& supernode_degrees,
+    const SupernodalRelaxationCostModel& cost_model);
+
+// Returns a cost model whose rates are measured by timing dense
+// factorizations of the given front sizes, over 'num_repetitions' calls each,
+// and whose memory charge is measured by timing a streaming update. Since the
+// dense kernels are run from the calling thread, calling this from within the
+// task arena of the factorization accounts for its threading.
+template <class Field>
+SupernodalRelaxationCostModel CalibrateSupernodalRelaxationCostModel(
+    const std::vector<Int>& front_sizes = {8, 16, 32, 64, 128, 256, 512, 1024},
+    Int num_repetitions = 10);
+
 void MergeChildren(Int parent, const Buffer<Int>& orig_supernode_starts,
                    const Buffer<Int>& orig_supernode_sizes,
                    const Buffer<Int>& orig_supernode_degrees,
@@ -222,12 +481,15 @@ void MergeChildren(Int parent, const Buffer<Int>& orig_supernode_starts,
 // Walk up the tree in the original postordering, merging supernodes as we
 // progress. The 'relaxed_permutation' and 'relaxed_inverse_permutation'
 // variables are also inputs.
+// If 'frozen_supernode' is non-negative, no children are merged into that
+// supernode.
 void RelaxSupernodes(const SymmetricOrdering& orig_ordering,
                      const Buffer<Int>& orig_supernode_degrees,
                      const SupernodalRelaxationControl& control,
                      SymmetricOrdering* relaxed_ordering,
                      Buffer<Int>* relaxed_supernode_degrees,
-                     Buffer<Int>* relaxed_supernode_member_to_index);
+                     Buffer<Int>* relaxed_supernode_member_to_index,
+                     Int frozen_supernode = -1);
 
 // Fills an estimate of the work required to eliminate the subtree in a
 // right-looking factorization.
@@ -236,20 +498,126 @@ void FillSubtreeWorkEstimates(Int root, const AssemblyForest& supernode_forest,
                               const LowerFactor<Field>& lower_factor,
                               Buffer<double>* work_estimates);
 
+// Proportionally maps the subtrees of the assembly forest onto the domains
+// [domain_beg, domain_end) using their (inclusive) work estimates, in the
+// manner of Pothen and Sun: a set of subtrees sharing a single domain is
+// assigned to it, a lone subtree spanning several domains passes them on to
+// its children, and otherwise each subtree receives a number of domains
+// proportional to its work, with the lighter subtrees packed onto the
+// remaining domains. The root of each mapped subtree has its domain set in
+// 'subtree_domains'; all other entries, including the supernodes above the
+// mapped subtrees, are left untouched (and should be initialized to -1).
+inline void ProportionalSubtreeMapping(const AssemblyForest& supernode_forest,
+                                       const Buffer<double>& work_estimates,
+                                       const std::vector<Int>& subtrees,
+                                       Int domain_beg, Int domain_end,
+                                       Buffer<Int>* subtree_domains);
+
+// Fills an estimate of the work along the critical path of each subtree, i.e.,
+// the work of a supernode plus the maximum critical path of its children.
+template <class Field>
+void FillSubtreeCriticalPaths(Int root, const AssemblyForest& supernode_forest,
+                              const LowerFactor<Field>& lower_factor,
+                              Buffer<double>* critical_paths);
+
+// Fills an estimate of the work, per right-hand side, required for the
+// triangular solves against the subtree, i.e., the sum over its supernodes of
+// the diagonal triangular solve and the subdiagonal update.
+template <class Field>
+void FillSubtreeSolveWorkEstimates(Int root,
+                                   const AssemblyForest& supernode_forest,
+                                   const LowerFactor<Field>& lower_factor,
+                                   Buffer<double>* work_estimates);
+
 // Fills in the structure indices for the lower factor.
 template <class Field>
 void FillStructureIndices(const CoordinateMatrix<Field>& matrix,
                           const SymmetricOrdering& ordering,
                           const Buffer<Int>& supernode_member_to_index,
                           LowerFactor<Field>* lower_factor);
-#ifdef CATAMARI_OPENMP
+
+// A multithreaded equivalent which forms the structures of the subtrees of
+// the assembly forest as separate TBB tasks and sorts them in parallel.
 template <class Field>
 void OpenMPFillStructureIndices(Int sort_grain_size,
                                 const CoordinateMatrix<Field>& matrix,
                                 const SymmetricOrdering& ordering,
                                 const Buffer<Int>& supernode_member_to_index,
                                 LowerFactor<Field>* lower_factor);
-#endif  // ifdef CATAMARI_OPENMP
+
+// Fills the map from the structure of each supernode into its parent's front.
+template <class Field>
+void FillChildRelativeIndices(const SymmetricOrdering& ordering,
+                              const LowerFactor<Field>& lower_factor,
+                              ChildRelativeIndices* relative_indices);
+
+// Adds entries 'begin' through 'child_degree - 1' of a column of a child's
+// Schur complement into the rows of its parent's front column given by the
+// child's relative indices, i.e.,
+//
+//   front_column[child_rel_indices[i]] += child_column[i],
+//
+// one contiguous run of relative indices at a time if the child's runs were
+// encoded.
+template <class Field>
+void AddChildColumn(const AssemblyForest& forest, Int child, Int child_degree,
+                    Int begin, const Field* child_column, Field* front_column);
+
+// Equivalent to 'AddChildColumn', but overwrites the rows of the parent's
+// front column rather than adding into them.
+template <class Field>
+void CopyChildColumn(const AssemblyForest& forest, Int child, Int child_degree,
+                     Int begin, const Field* child_column, Field* front_column);
+
+// Equivalent to zeroing rows 'front_beg' through 'front_end - 1' of the
+// parent's front column and then calling 'AddChildColumn', but writes each
+// of the rows exactly once. The relative indices of the child's entries must
+// lie within the range.
+template <class Field>
+void AssignChildColumn(const AssemblyForest& forest, Int child,
+                       Int child_degree, Int begin, const Field* child_column,
+                       Int front_beg, Int front_end, Field* front_column);
+
+// Returns the degree of the merge kernel which the symbolic analysis selected
+// for the given child (see 'ChildRelativeIndices::merge_kernels'), or zero if
+// its Schur complement must be merged by the generic loops.
+Int MergeKernelDegree(const AssemblyForest& forest, Int child);
+
+// Adds the lower triangle of a child's Schur complement into its parent's
+// front using the kernel specialized on the child's (nonzero) merge kernel
+// degree. The columns which map into the parent's diagonal block are added
+// into the (contiguous) diagonal and lower blocks, and the remainder into the
+// parent's Schur complement.
+template <class Field>
+void SpecializedMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement);
+
+// Equivalent to 'SpecializedMergeChildSchurComplement', but for a child whose
+// relative indices were encoded as runs: each pair of (column, row) runs is
+// added as a dense block.
+template <class Field>
+void BlockMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement);
+
+// Returns whether the Schur complement of the given child is merged as a
+// whole through a plan precomputed by the symbolic analysis (a specialized
+// merge kernel or its runs) rather than one column at a time.
+bool HasMergePlan(const AssemblyForest& forest, Int child);
+
+// Adds the Schur complement of a child with a merge plan into its parent's
+// front, as in 'SpecializedMergeChildSchurComplement'.
+template <class Field>
+void PlannedMergeChildSchurComplement(
+    const AssemblyForest& forest, Int child, Int supernode_size,
+    const ConstBlasMatrixView<Field>& child_schur_complement,
+    BlasMatrixView<Field> diagonal_block,
+    BlasMatrixView<Field> schur_complement);
 
 // Fill in the nonzeros from the original sparse matrix.
 template <class Field>
@@ -258,14 +626,15 @@ void FillNonzeros(const CoordinateMatrix<Field>& matrix,
                   const Buffer<Int>& supernode_member_to_index,
                   LowerFactor<Field>* lower_factor,
                   DiagonalFactor<Field>* diagonal_factor);
-#ifdef CATAMARI_OPENMP
+
+// A multithreaded equivalent which processes the subtrees of the assembly
+// forest as separate TBB tasks.
 template <class Field>
 void OpenMPFillNonzeros(const CoordinateMatrix<Field>& matrix,
                         const SymmetricOrdering& ordering,
                         const Buffer<Int>& supernode_member_to_index,
                         LowerFactor<Field>* lower_factor,
                         DiagonalFactor<Field>* diagonal_factor);
-#endif  // ifdef CATAMARI_OPENMP
 
 // Explicitly fill the factorization blocks with zeros.
 template <class Field>
@@ -273,12 +642,12 @@ void FillZeros(const SymmetricOrdering& ordering,
                LowerFactor<Field>* lower_factor,
                DiagonalFactor<Field>* diagonal_factor);
 
-#ifdef CATAMARI_OPENMP
+// A multithreaded equivalent which processes the subtrees of the assembly
+// forest as separate TBB tasks.
 template <class Field>
 void OpenMPFillZeros(const SymmetricOrdering& ordering,
                      LowerFactor<Field>* lower_factor,
                      DiagonalFactor<Field>* diagonal_factor);
-#endif  // ifdef CATAMARI_OPENMP
 
 // Store the scaled adjoint update matrix, Z(d, m) = D(d, d) L(m, d)', or
 // the scaled transpose, Z(d, m) = D(d, d) L(m, d)^T.
@@ -288,6 +657,35 @@ void FormScaledTranspose(SymmetricFactorizationType factorization_type,
                          const ConstBlasMatrixView<Field>& matrix,
                          BlasMatrixView<Field>* scaled_transpose);
 
+// Overwrites the lower triangle of 'schur_complement' with
+//
+//   beta schur_complement - L D L' (or L D L^T),
+//
+// where L is 'lower_block' and D is the diagonal of 'diagonal_block'. Rather
+// than first forming the scaled transpose of all of L, each block column of
+// (at most) 'block_size' columns of the Schur complement is updated from the
+// scaled transpose of just the corresponding rows of L, which is packed into
+// 'buffer' immediately before it is consumed -- while it is still in cache.
+// The Schur complement update thus makes a single pass over L and 'buffer'
+// need only hold 'min(block_size, degree) * supernode_size' entries.
+template <class Field>
+void LowerScaledOuterProduct(Int block_size,
+                             SymmetricFactorizationType factorization_type,
+                             const ConstBlasMatrixView<Field>& diagonal_block,
+                             const ConstBlasMatrixView<Field>& lower_block,
+                             const Field& beta, Field* buffer,
+                             BlasMatrixView<Field>* schur_complement);
+
+// Equivalent to 'LowerScaledOuterProduct' for a packed Schur complement (see
+// 'PackedLowerMatrixView'), whose panels serve as the block columns: 'buffer'
+// must hold 'min(panel_width, degree) * supernode_size' entries.
+template <class Field>
+void PackedLowerScaledOuterProduct(
+    SymmetricFactorizationType factorization_type,
+    const ConstBlasMatrixView<Field>& diagonal_block,
+    const ConstBlasMatrixView<Field>& lower_block, const Field& beta,
+    Field* buffer, PackedLowerMatrixView<Field>* schur_complement);
+
 #ifdef CATAMARI_OPENMP
 template <class Field>
 void OpenMPFormScaledTranspose(Int tile_size,
@@ -306,6 +704,9 @@ void MergeChildSchurComplements(Int supernode,
                                 RightLookingSharedState<Field>* shared_state);
 
 // Adds the schur complements of a single child onto its parent supernode's front.
+// The front's diagonal and lower blocks must already be initialized and stored
+// contiguously, and its Schur complement is first zeroed if
+// 'freshShurComplement' is true.
 template <class Field>
 void MergeChildSchurComplement(Int supernode, Int child,
                                const SymmetricOrdering& ordering,
@@ -364,6 +765,8 @@ void UpdateSubdiagonalBlock(
     BlasMatrixView<Field>* workspace_matrix);
 
 // Perform an in-place LDL' factorization of the supernodal diagonal block.
+// Blocks of height at least 'kMinRecursiveFactorizationSize' which are not
+// handed off to LAPACK are factored recursively.
 template <class Field>
 Int FactorDiagonalBlock(
     Int block_size, SymmetricFactorizationType factorization_type,
@@ -382,6 +785,30 @@ Int OpenMPFactorDiagonalBlock(
     std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
 #endif  // ifdef CATAMARI_OPENMP
 
+// Perform an in-place LDL' factorization of the supernodal diagonal block
+// with the TBB-parallel tiled dense factorizations, which can be called from
+// within a running TBB task.
+template <class Field>
+Int TiledFactorDiagonalBlock(
+    Int tile_size, Int block_size,
+    SymmetricFactorizationType factorization_type,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* diagonal_block, Buffer<Field>* buffer,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
+// Factors, in lockstep, 'batch_size' fronts of 'height' rows and 'width'
+// columns that are stored interleaved, with entry (i, j) of the b'th front at
+// 'fronts[(i + j * height) * batch_size + b]'. The leading 'width' x 'width'
+// block of each front is overwritten with its Cholesky or LDL factor, and the
+// rows below it are solved against it. Since the innermost loops run over the
+// batch, many tiny fronts are factored with unit-stride (vectorizable)
+// updates rather than one short dense kernel call at a time. Returns false if
+// any of the fronts encountered an unacceptable pivot.
+template <class Field>
+bool InterleavedFactorFronts(SymmetricFactorizationType factorization_type,
+                             Int height, Int width, Int batch_size,
+                             Field* fronts);
+
 // L(KNext:n, K) /= D(K, K) L(K, K)', or /= D(K, K) L(K, K)^T.
 template <class Field>
 void SolveAgainstDiagonalBlock(
@@ -398,6 +825,60 @@ void OpenMPSolveAgainstDiagonalBlock(
     BlasMatrixView<Field>* lower_matrix);
 #endif  // ifdef CATAMARI_OPENMP
 
+// Factors the front of a supernode -- its diagonal block, the subdiagonal
+// block below it, and the lower triangle of its Schur complement -- one
+// panel of width 'factor_tile_size' at a time. The triangular solves and the
+// scaled transposes of each panel, and the corresponding updates of the
+// trailing front, are split into TBB tasks over tiles of size
+// 'outer_product_tile_size', so that idle threads can take part in the
+// factorization of a single large front. If 'initialize_schur_complement'
+// is true, the Schur complement is overwritten rather than updated. Returns
+// the number of successful pivots.
+template <class Field>
+Int TiledFactorFront(
+    Int factor_tile_size, Int outer_product_tile_size, Int block_size,
+    SymmetricFactorizationType factorization_type,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    bool initialize_schur_complement, BlasMatrixView<Field>* diagonal_block,
+    BlasMatrixView<Field>* lower_block,
+    BlasMatrixView<Field>* schur_complement,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization);
+
+// Partially factors the lower triangle of a self-adjoint (or, for LDL^T
+// factorizations, complex-symmetric) front whose leading 'num_fully_summed'
+// columns are fully summed, using threshold diagonal pivoting: a
+// fully-summed column is only accepted as the next pivot if the modulus of
+// its (updated) diagonal entry exceeds 'pivot_tolerance' (which may be zero)
+// and is at least 'threshold' times that of every other entry of the
+// column, and the first such column is taken (so that fronts which need no
+// pivoting keep their order). Each accepted pivot is symmetrically swapped
+// into the next leading position, and 'permutation' receives the original
+// position of each of the fully-summed positions. The factorization stops at
+// the first step without an acceptable candidate. The accepted columns are
+// overwritten with their LDL' (or LDL^T) factor, while the remaining
+// fully-summed (delayed) columns and the trailing block are overwritten with
+// their Schur complement, the latter via 'LowerScaledOuterProduct' with tiles
+// of width 'block_size'. Returns the number of accepted pivots.
+template <class Field>
+Int ThresholdPivotedPartialFactorization(
+    Int block_size, SymmetricFactorizationType factorization_type,
+    const ComplexBase<Field>& threshold,
+    const ComplexBase<Field>& pivot_tolerance, Int num_fully_summed,
+    BlasMatrixView<Field>* front, Buffer<Int>* permutation,
+    Buffer<Field>* buffer);
+
+// Orthonormalizes the (linearly independent) columns of 'matrix' in place
+// by modified Gram-Schmidt with one reorthogonalization pass.
+template <class Field>
+void OrthonormalizeColumns(BlasMatrixView<Field>* matrix);
+
+// Removes from each column of 'matrix' its component within the span of the
+// orthonormal columns of 'basis' (or, if 'conjugate' is true, of their
+// conjugates).
+template <class Field>
+void ProjectOutBasis(const ConstBlasMatrixView<Field>& basis, bool conjugate,
+                     BlasMatrixView<Field>* matrix);
+
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
@@ -7,7 +7,13 @@
  */
 #ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_OPENMP_IMPL_H_
 #define CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_OPENMP_IMPL_H_
-#ifdef CATAMARI_OPENMP
+
+#include <algorithm>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 
 #include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
 
@@ -24,18 +30,20 @@ void OpenMPFillStructureIndicesRecursion(
     Buffer<Buffer<Int>>* private_pattern_flags) {
   const Int child_beg = ordering.assembly_forest.child_offsets[root];
   const Int child_end = ordering.assembly_forest.child_offsets[root + 1];
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (Int child_index = child_beg; child_index < child_end; ++child_index) {
     const Int child = ordering.assembly_forest.children[child_index];
-    #pragma omp task default(none) firstprivate(child)                    \
-        shared(matrix, ordering, supernode_member_to_index, lower_factor, \
-            private_pattern_flags)
-    OpenMPFillStructureIndicesRecursion(matrix, ordering,
-                                        supernode_member_to_index, child,
-                                        lower_factor, private_pattern_flags);
+    tg.run([&, child]() {
+      OpenMPFillStructureIndicesRecursion(matrix, ordering,
+                                          supernode_member_to_index, child,
+                                          lower_factor, private_pattern_flags);
+    });
   }
+  tg.wait();
 
-  const int thread = omp_get_thread_num();
+  // The flags are only acquired once the children have completed, since the
+  // wait may have run other subtrees on this thread.
+  const int thread = tbb::this_task_arena::current_thread_index();
   Buffer<Int>& pattern_flags = (*private_pattern_flags)[thread];
 
   // Form this node's structure by unioning that of its direct children
@@ -66,7 +74,7 @@ void OpenMPFillStructureIndicesRecursion(
   const Int supernode_size = ordering.supernode_sizes[root];
   const Int supernode_offset = ordering.supernode_offsets[root];
   const bool have_permutation = !ordering.permutation.Empty();
-  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<Int>& column_indices = matrix.ColumnIndices();
   for (Int column = supernode_offset;
        column < supernode_offset + supernode_size; ++column) {
     const Int orig_column =
@@ -74,9 +82,9 @@ void OpenMPFillStructureIndicesRecursion(
     const Int column_beg = matrix.RowEntryOffset(orig_column);
     const Int column_end = matrix.RowEntryOffset(orig_column + 1);
     for (Int index = column_beg; index < column_end; ++index) {
-      const MatrixEntry<Field>& entry = entries[index];
+      const Int entry_column = column_indices[index];
       const Int row =
-          have_permutation ? ordering.permutation[entry.column] : entry.column;
+          have_permutation ? ordering.permutation[entry_column] : entry_column;
       const Int row_supernode = supernode_member_to_index[row];
       if (row_supernode <= root) {
         continue;
@@ -102,44 +110,40 @@ void OpenMPFillStructureIndices(Int sort_grain_size,
                                 const Buffer<Int>& supernode_member_to_index,
                                 LowerFactor<Field>* lower_factor) {
   const Int num_rows = matrix.NumRows();
-  const int max_threads = omp_get_max_threads();
+  const int max_threads = tbb::this_task_arena::max_concurrency();
 
   // A data structure for marking whether or not a node is in the pattern of
   // the active row of the lower-triangular factor. Each thread potentially
   // needs its own since different subtrees can have intersecting structure.
   Buffer<Buffer<Int>> private_pattern_flags(max_threads);
 
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (int t = 0; t < max_threads; ++t) {
-    #pragma omp task default(none) firstprivate(t, num_rows) \
-        shared(private_pattern_flags)
-    private_pattern_flags[t].Resize(num_rows, -1);
+    tg.run([&, t]() { private_pattern_flags[t].Resize(num_rows, -1); });
   }
+  tg.wait();
 
-  #pragma omp taskgroup
   for (const Int root : ordering.assembly_forest.roots) {
-    #pragma omp task default(none) firstprivate(root)                     \
-        shared(matrix, ordering, supernode_member_to_index, lower_factor, \
-            private_pattern_flags)
-    OpenMPFillStructureIndicesRecursion(matrix, ordering,
-                                        supernode_member_to_index, root,
-                                        lower_factor, &private_pattern_flags);
+    tg.run([&, root]() {
+      OpenMPFillStructureIndicesRecursion(matrix, ordering,
+                                          supernode_member_to_index, root,
+                                          lower_factor, &private_pattern_flags);
+    });
   }
+  tg.wait();
 
   // Sort the structures.
   const Int num_supernodes = ordering.supernode_sizes.Size();
-  #pragma omp taskgroup
-  for (Int s = 0; s < num_supernodes; s += sort_grain_size) {
-    #pragma omp task default(none) \
-        firstprivate(sort_grain_size, s, num_supernodes) shared(lower_factor)
-    {
-      const Int supernode_end = std::min(num_supernodes, s + sort_grain_size);
-      for (Int supernode = s; supernode < supernode_end; ++supernode) {
-        std::sort(lower_factor->StructureBeg(supernode),
-                  lower_factor->StructureEnd(supernode));
-      }
-    }
-  }
+  tbb::parallel_for(
+      tbb::blocked_range<Int>(0, num_supernodes,
+                              std::max(sort_grain_size, Int(1))),
+      [&](const tbb::blocked_range<Int>& range) {
+        for (Int supernode = range.begin(); supernode < range.end();
+             ++supernode) {
+          std::sort(lower_factor->StructureBeg(supernode),
+                    lower_factor->StructureEnd(supernode));
+        }
+      });
 }
 
 template <class Field>
@@ -150,15 +154,15 @@ void OpenMPFillNonzerosRecursion(const CoordinateMatrix<Field>& matrix,
                                  DiagonalFactor<Field>* diagonal_factor) {
   const Int child_beg = ordering.assembly_forest.child_offsets[root];
   const Int child_end = ordering.assembly_forest.child_offsets[root + 1];
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (Int child_index = child_beg; child_index < child_end; ++child_index) {
     const Int child = ordering.assembly_forest.children[child_index];
-    #pragma omp task default(none) firstprivate(child)                    \
-        shared(matrix, ordering, supernode_member_to_index, lower_factor, \
-            diagonal_factor)
-    OpenMPFillNonzerosRecursion(matrix, ordering, supernode_member_to_index,
-                                child, lower_factor, diagonal_factor);
+    tg.run([&, child]() {
+      OpenMPFillNonzerosRecursion(matrix, ordering, supernode_member_to_index,
+                                  child, lower_factor, diagonal_factor);
+    });
   }
+  tg.wait();
 
   const bool have_permutation = !ordering.permutation.Empty();
   const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
@@ -217,14 +221,14 @@ void OpenMPFillNonzeros(const CoordinateMatrix<Field>& matrix,
                         const Buffer<Int>& supernode_member_to_index,
                         LowerFactor<Field>* lower_factor,
                         DiagonalFactor<Field>* diagonal_factor) {
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (const Int root : ordering.assembly_forest.roots) {
-    #pragma omp task default(none) firstprivate(root)                     \
-        shared(matrix, ordering, supernode_member_to_index, lower_factor, \
-            diagonal_factor)
-    OpenMPFillNonzerosRecursion(matrix, ordering, supernode_member_to_index,
-                                root, lower_factor, diagonal_factor);
+    tg.run([&, root]() {
+      OpenMPFillNonzerosRecursion(matrix, ordering, supernode_member_to_index,
+                                  root, lower_factor, diagonal_factor);
+    });
   }
+  tg.wait();
 }
 
 template <class Field>
@@ -233,13 +237,14 @@ void OpenMPFillZerosRecursion(const SymmetricOrdering& ordering, Int root,
                               DiagonalFactor<Field>* diagonal_factor) {
   const Int child_beg = ordering.assembly_forest.child_offsets[root];
   const Int child_end = ordering.assembly_forest.child_offsets[root + 1];
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (Int child_index = child_beg; child_index < child_end; ++child_index) {
     const Int child = ordering.assembly_forest.children[child_index];
-    #pragma omp task default(none) firstprivate(child) \
-        shared(ordering, lower_factor, diagonal_factor)
-    OpenMPFillZerosRecursion(ordering, child, lower_factor, diagonal_factor);
+    tg.run([&, child]() {
+      OpenMPFillZerosRecursion(ordering, child, lower_factor, diagonal_factor);
+    });
   }
+  tg.wait();
 
   BlasMatrixView<Field>& diagonal_block = diagonal_factor->blocks[root];
   std::fill(
@@ -257,14 +262,17 @@ template <class Field>
 void OpenMPFillZeros(const SymmetricOrdering& ordering,
                      LowerFactor<Field>* lower_factor,
                      DiagonalFactor<Field>* diagonal_factor) {
-  #pragma omp taskgroup
+  tbb::task_group tg;
   for (const Int root : ordering.assembly_forest.roots) {
-    #pragma omp task default(none) firstprivate(root) \
-        shared(ordering, lower_factor, diagonal_factor)
-    OpenMPFillZerosRecursion(ordering, root, lower_factor, diagonal_factor);
+    tg.run([&, root]() {
+      OpenMPFillZerosRecursion(ordering, root, lower_factor, diagonal_factor);
+    });
   }
+  tg.wait();
 }
 
+#ifdef CATAMARI_OPENMP
+
 template <class Field>
 void OpenMPFormScaledTranspose(Int tile_size,
                                SymmetricFactorizationType factorization_type,
@@ -334,39 +342,20 @@ void OpenMPMergeChildSchurComplements(
       shared_state->schur_complements[supernode];
 
   const Int supernode_size = ordering.supernode_sizes[supernode];
-  const Int supernode_start = ordering.supernode_offsets[supernode];
-  const Int* main_indices = lower_factor->StructureBeg(supernode);
   for (Int child_index = 0; child_index < num_children; ++child_index) {
     const Int child =
         ordering.assembly_forest.children[child_beg + child_index];
-    const Int* child_indices = lower_factor->StructureBeg(child);
     Buffer<Field>& child_schur_complement_buffer =
         shared_state->schur_complement_buffers[child];
     BlasMatrixView<Field> child_schur_complement =
         shared_state->schur_complements[child];
     const Int child_degree = child_schur_complement.height;
 
-    // Fill the mapping from the child structure into the parent front.
-    Int num_child_diag_indices = 0;
-    Buffer<Int> child_rel_indices(child_degree);
-    {
-      Int i_rel = supernode_size;
-      for (Int i = 0; i < child_degree; ++i) {
-        const Int row = child_indices[i];
-        if (row < supernode_start + supernode_size) {
-          child_rel_indices[i] = row - supernode_start;
-          ++num_child_diag_indices;
-        } else {
-          while (main_indices[i_rel - supernode_size] != row) {
-            ++i_rel;
-            CATAMARI_ASSERT(i_rel < supernode_size + schur_complement.height,
-                            "Relative index is out-of-bounds.");
-          }
-          child_rel_indices[i] = i_rel;
-        }
-      }
-    }
-    const Int* child_rel_indices_ptr = child_rel_indices.Data();
+    // The mapping from the child structure into the parent front.
+    const Int num_child_diag_indices =
+        ordering.assembly_forest.NumChildDiagIndices(child);
+    const LocalInt* child_rel_indices_ptr =
+        ordering.assembly_forest.ChildRelativeIndicesBeg(child);
 
     // Add the child Schur complement into this supernode's front.
     #pragma omp taskgroup
@@ -503,8 +492,9 @@ void OpenMPSolveAgainstDiagonalBlock(
   }
 }
 
+#endif  // ifdef CATAMARI_OPENMP
+
 }  // namespace supernodal_ldl
 }  // namespace catamari
 
-#endif  // ifdef CATAMARI_OPENMP
 #endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_OPENMP_IMPL_H_
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_TILED_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_TILED_IMPL_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "catamari/sparse_ldl/supernodal/supernode_utils.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <class Field>
+Int TiledFactorDiagonalBlock(
+    Int tile_size, Int block_size,
+    SymmetricFactorizationType factorization_type,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    BlasMatrixView<Field>* diagonal_block, Buffer<Field>* buffer,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  Int num_pivots;
+  if (factorization_type == kCholeskyFactorization) {
+    if (dynamic_reg_params.enabled) {
+      num_pivots = TiledDynamicallyRegularizedLowerCholeskyFactorization(
+          tile_size, block_size, dynamic_reg_params, diagonal_block,
+          dynamic_regularization);
+    } else {
+      num_pivots = TiledLowerCholeskyFactorization(tile_size, block_size,
+                                                   diagonal_block);
+    }
+  } else if (factorization_type == kLDLAdjointFactorization) {
+    if (dynamic_reg_params.enabled) {
+      num_pivots = TiledDynamicallyRegularizedLDLAdjointFactorization(
+          tile_size, block_size, dynamic_reg_params, diagonal_block, buffer,
+          dynamic_regularization);
+    } else {
+      num_pivots = TiledLDLAdjointFactorization(tile_size, block_size,
+                                                diagonal_block, buffer);
+    }
+  } else {
+    num_pivots = TiledLDLTransposeFactorization(tile_size, block_size,
+                                                diagonal_block, buffer);
+  }
+  return num_pivots;
+}
+
+template <class Field>
+Int TiledFactorFront(
+    Int factor_tile_size, Int outer_product_tile_size, Int block_size,
+    SymmetricFactorizationType factorization_type,
+    const DynamicRegularizationParams<Field>& dynamic_reg_params,
+    bool initialize_schur_complement, BlasMatrixView<Field>* diagonal_block,
+    BlasMatrixView<Field>* lower_block,
+    BlasMatrixView<Field>* schur_complement,
+    std::vector<std::pair<Int, ComplexBase<Field>>>* dynamic_regularization) {
+  const Int supernode_size = diagonal_block->height;
+  const Int degree = lower_block->height;
+  const Int panel_size = std::max(factor_tile_size, Int(1));
+  const Int tile_size = std::max(outer_product_tile_size, Int(1));
+
+  // The row (and column) tiles of the trailing front: first those of the
+  // remainder of the diagonal block, and then those of the lower block (and
+  // Schur complement), so that no tile straddles the two.
+  struct Tile {
+    bool lower;
+    Int beg;
+    Int size;
+  };
+  std::vector<Tile> tiles;
+  std::vector<std::pair<Int, Int>> tile_pairs;
+
+  // The scaled transpose of the solved panel is kept local to this front,
+  // as the calling thread may execute unrelated tasks while waiting on the
+  // tile tasks.
+  Buffer<Field> scaled_transpose_buffer(
+      std::min(panel_size, supernode_size) * (supernode_size + degree));
+
+  for (Int panel_beg = 0; panel_beg < supernode_size;
+       panel_beg += panel_size) {
+    const Int panel_width = std::min(panel_size, supernode_size - panel_beg);
+    const Int trailing_beg = panel_beg + panel_width;
+    const Int trailing_size = supernode_size - trailing_beg;
+
+    // Factor the diagonal tile of the panel.
+    BlasMatrixView<Field> panel_diagonal = diagonal_block->Submatrix(
+        panel_beg, panel_beg, panel_width, panel_width);
+    DynamicRegularizationParams<Field> subparams = dynamic_reg_params;
+    subparams.offset += panel_beg;
+    const Int num_panel_pivots =
+        FactorDiagonalBlock(block_size, factorization_type, subparams,
+                            &panel_diagonal, dynamic_regularization);
+    if (num_panel_pivots < panel_width) {
+      return panel_beg + num_panel_pivots;
+    }
+    const ConstBlasMatrixView<Field> const_panel_diagonal =
+        panel_diagonal.ToConst();
+
+    tiles.clear();
+    for (Int beg = 0; beg < trailing_size; beg += tile_size) {
+      tiles.push_back(
+          Tile{false, beg, std::min(tile_size, trailing_size - beg)});
+    }
+    for (Int beg = 0; beg < degree; beg += tile_size) {
+      tiles.push_back(Tile{true, beg, std::min(tile_size, degree - beg)});
+    }
+    const Int num_tiles = tiles.size();
+    if (!num_tiles) {
+      break;
+    }
+
+    // The solved portion of the panel within 'tile', and the corresponding
+    // columns of its scaled transpose.
+    BlasMatrixView<Field> scaled_transpose;
+    scaled_transpose.height = panel_width;
+    scaled_transpose.width = trailing_size + degree;
+    scaled_transpose.leading_dim = panel_width;
+    scaled_transpose.data = scaled_transpose_buffer.Data();
+    auto panel_rows = [&](const Tile& tile) {
+      return tile.lower
+                 ? lower_block->Submatrix(tile.beg, panel_beg, tile.size,
+                                          panel_width)
+                 : diagonal_block->Submatrix(trailing_beg + tile.beg,
+                                             panel_beg, tile.size,
+                                             panel_width);
+    };
+    auto scaled_columns = [&](const Tile& tile) {
+      return scaled_transpose.Submatrix(
+          0, (tile.lower ? trailing_size : 0) + tile.beg, panel_width,
+          tile.size);
+    };
+
+    // Solve against the diagonal tile and form the scaled transpose, one row
+    // tile per task.
+    tbb::parallel_for(
+        tbb::blocked_range<Int>(0, num_tiles, 1),
+        [&](const tbb::blocked_range<Int>& range) {
+          for (Int index = range.begin(); index < range.end(); ++index) {
+            BlasMatrixView<Field> rows = panel_rows(tiles[index]);
+            BlasMatrixView<Field> columns = scaled_columns(tiles[index]);
+            SolveAgainstDiagonalBlock(factorization_type, const_panel_diagonal,
+                                      &rows);
+            FormScaledTranspose(factorization_type, const_panel_diagonal,
+                                rows.ToConst(), &columns);
+          }
+        });
+
+    // Update the lower triangle of the trailing front, one tile per task.
+    tile_pairs.clear();
+    for (Int j = 0; j < num_tiles; ++j) {
+      for (Int i = j; i < num_tiles; ++i) {
+        tile_pairs.emplace_back(i, j);
+      }
+    }
+    const bool first_panel = panel_beg == 0;
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, tile_pairs.size(), 1),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+          for (std::size_t index = range.begin(); index < range.end();
+               ++index) {
+            const Tile& row_tile = tiles[tile_pairs[index].first];
+            const Tile& column_tile = tiles[tile_pairs[index].second];
+            BlasMatrixView<Field> update;
+            if (column_tile.lower) {
+              update = schur_complement->Submatrix(
+                  row_tile.beg, column_tile.beg, row_tile.size,
+                  column_tile.size);
+            } else if (row_tile.lower) {
+              update = lower_block->Submatrix(
+                  row_tile.beg, trailing_beg + column_tile.beg, row_tile.size,
+                  column_tile.size);
+            } else {
+              update = diagonal_block->Submatrix(
+                  trailing_beg + row_tile.beg, trailing_beg + column_tile.beg,
+                  row_tile.size, column_tile.size);
+            }
+            if (column_tile.lower && first_panel &&
+                initialize_schur_complement) {
+              for (Int j = 0; j < update.width; ++j) {
+                std::fill(update.Pointer(0, j),
+                          update.Pointer(update.height, j), Field{0});
+              }
+            }
+
+            const ConstBlasMatrixView<Field> left =
+                panel_rows(row_tile).ToConst();
+            const ConstBlasMatrixView<Field> right =
+                scaled_columns(column_tile).ToConst();
+            if (row_tile.lower == column_tile.lower &&
+                row_tile.beg == column_tile.beg) {
+              MatrixMultiplyLowerNormalNormal(Field{-1}, left, right,
+                                              Field{1}, &update);
+            } else {
+              MatrixMultiplyNormalNormal(Field{-1}, left, right, Field{1},
+                                         &update);
+            }
+          }
+        });
+  }
+
+  return supernode_size;
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_SUPERNODE_UTILS_TILED_IMPL_H_
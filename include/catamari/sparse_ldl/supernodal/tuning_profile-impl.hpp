@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_IMPL_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_IMPL_H_
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include "catamari/sparse_ldl/supernodal/tuning_profile.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+namespace tuning_profile {
+
+// The first line of a profile.
+static const char kHeader[] = "# catamari tuning profile";
+
+// The lazily loaded profile of this machine.
+struct MachineProfileCache {
+  std::mutex mutex;
+  bool loaded = false;
+  std::unique_ptr<TuningProfile> profile;
+};
+
+inline MachineProfileCache& MachineCache() {
+  static MachineProfileCache cache;
+  return cache;
+}
+
+}  // namespace tuning_profile
+
+inline void TuningProfile::Write(std::ostream& os) const {
+  os << tuning_profile::kHeader << "\n"
+     << "num_threads " << num_threads << "\n"
+     << "block_size " << block_size << "\n"
+     << "factor_tile_size " << factor_tile_size << "\n"
+     << "outer_product_tile_size " << outer_product_tile_size << "\n"
+     << "merge_grain_size " << merge_grain_size << "\n"
+     << "min_parallel_threshold " << min_parallel_threshold << "\n"
+     << "min_parallel_solve_threshold " << min_parallel_solve_threshold
+     << "\n";
+}
+
+inline bool TuningProfile::Read(std::istream& is) {
+  std::string line;
+  if (!std::getline(is, line) || line != tuning_profile::kHeader) {
+    return false;
+  }
+  while (std::getline(is, line)) {
+    std::istringstream line_stream(line);
+    std::string name;
+    if (!(line_stream >> name) || name[0] == '#') continue;
+    if (name == "num_threads") {
+      line_stream >> num_threads;
+    } else if (name == "block_size") {
+      line_stream >> block_size;
+    } else if (name == "factor_tile_size") {
+      line_stream >> factor_tile_size;
+    } else if (name == "outer_product_tile_size") {
+      line_stream >> outer_product_tile_size;
+    } else if (name == "merge_grain_size") {
+      line_stream >> merge_grain_size;
+    } else if (name == "min_parallel_threshold") {
+      line_stream >> min_parallel_threshold;
+    } else if (name == "min_parallel_solve_threshold") {
+      line_stream >> min_parallel_solve_threshold;
+    }
+  }
+  return true;
+}
+
+inline bool TuningProfile::Save(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file) return false;
+  Write(file);
+  return bool(file);
+}
+
+inline bool TuningProfile::Load(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file) return false;
+  return Read(file);
+}
+
+inline std::string DefaultTuningProfileFilename() {
+  if (const char* filename = std::getenv("CATAMARI_TUNING_PROFILE")) {
+    return filename;
+  }
+  if (const char* home = std::getenv("HOME")) {
+    return std::string(home) + "/.catamari_tuning_profile";
+  }
+  return std::string();
+}
+
+inline const TuningProfile* MachineTuningProfile() {
+  tuning_profile::MachineProfileCache& cache = tuning_profile::MachineCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (!cache.loaded) {
+    cache.loaded = true;
+    const std::string filename = DefaultTuningProfileFilename();
+    std::unique_ptr<TuningProfile> profile(new TuningProfile);
+    if (!filename.empty() && profile->Load(filename)) {
+      cache.profile = std::move(profile);
+    }
+  }
+  return cache.profile.get();
+}
+
+inline void ReloadMachineTuningProfile() {
+  tuning_profile::MachineProfileCache& cache = tuning_profile::MachineCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.loaded = false;
+  cache.profile.reset();
+}
+
+template <typename Field>
+void ApplyTuningProfile(const TuningProfile& profile,
+                        Control<Field>* control) {
+  const Control<Field> defaults;
+  if (profile.block_size > 0 && control->block_size == defaults.block_size) {
+    control->block_size = profile.block_size;
+  }
+  if (profile.factor_tile_size > 0 &&
+      control->factor_tile_size == defaults.factor_tile_size) {
+    control->factor_tile_size = profile.factor_tile_size;
+  }
+  if (profile.outer_product_tile_size > 0 &&
+      control->outer_product_tile_size == defaults.outer_product_tile_size) {
+    control->outer_product_tile_size = profile.outer_product_tile_size;
+  }
+  if (profile.merge_grain_size > 0 &&
+      control->merge_grain_size == defaults.merge_grain_size) {
+    control->merge_grain_size = profile.merge_grain_size;
+  }
+  if (profile.min_parallel_threshold > 0 &&
+      control->min_parallel_threshold == defaults.min_parallel_threshold) {
+    control->min_parallel_threshold = profile.min_parallel_threshold;
+  }
+  if (profile.min_parallel_solve_threshold > 0 &&
+      control->min_parallel_solve_threshold ==
+          defaults.min_parallel_solve_threshold) {
+    control->min_parallel_solve_threshold =
+        profile.min_parallel_solve_threshold;
+  }
+}
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_IMPL_H_
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_H_
+#define CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_H_
+
+#include <iostream>
+#include <string>
+
+#include "catamari/integers.hpp"
+
+namespace catamari {
+namespace supernodal_ldl {
+
+template <typename Field>
+struct Control;
+
+// The per-machine settings of the supernodal factorization chosen by
+// 'AutoTune'. A field which was not tuned holds a non-positive value.
+struct TuningProfile {
+  // The number of threads the profile was tuned with.
+  Int num_threads = 0;
+
+  // See 'Control::block_size'.
+  Int block_size = 0;
+
+  // See 'Control::factor_tile_size'.
+  Int factor_tile_size = 0;
+
+  // See 'Control::outer_product_tile_size'.
+  Int outer_product_tile_size = 0;
+
+  // See 'Control::merge_grain_size'.
+  Int merge_grain_size = 0;
+
+  // See 'Control::min_parallel_threshold'.
+  double min_parallel_threshold = 0;
+
+  // See 'Control::min_parallel_solve_threshold'.
+  double min_parallel_solve_threshold = 0;
+
+  // Writes the profile as lines of 'name value' pairs.
+  void Write(std::ostream& os) const;
+
+  // Reads a profile written by 'Write'. Unknown names are skipped, and the
+  // fields which are not listed are left untouched. Returns false if the
+  // stream did not hold a profile.
+  bool Read(std::istream& is);
+
+  // Saves the profile into the given file and returns whether it succeeded.
+  bool Save(const std::string& filename) const;
+
+  // Loads the profile from the given file and returns whether it succeeded.
+  bool Load(const std::string& filename);
+};
+
+// Returns the file holding the profile of this machine: the value of the
+// 'CATAMARI_TUNING_PROFILE' environment variable if it is set, and otherwise
+// '.catamari_tuning_profile' within the home directory (or an empty string if
+// neither variable is set).
+std::string DefaultTuningProfileFilename();
+
+// Returns the profile of this machine, which is loaded from
+// 'DefaultTuningProfileFilename()' upon the first call (or the first call
+// after 'ReloadMachineTuningProfile'), or null if there is none.
+const TuningProfile* MachineTuningProfile();
+
+// Discards the cached profile of this machine so that the next call to
+// 'MachineTuningProfile' reloads it (e.g., after 'AutoTune' saved a new one).
+void ReloadMachineTuningProfile();
+
+// Overwrites the settings of 'control' which still hold their built-in
+// defaults with the tuned fields of the profile, so that explicitly chosen
+// settings are kept.
+template <typename Field>
+void ApplyTuningProfile(const TuningProfile& profile, Control<Field>* control);
+
+}  // namespace supernodal_ldl
+}  // namespace catamari
+
+#include "catamari/sparse_ldl/supernodal/tuning_profile-impl.hpp"
+
+#endif  // ifndef CATAMARI_SPARSE_LDL_SUPERNODAL_TUNING_PROFILE_H_
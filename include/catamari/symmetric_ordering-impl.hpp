@@ -8,10 +8,27 @@
 #ifndef CATAMARI_SYMMETRIC_ORDERING_IMPL_H_
 #define CATAMARI_SYMMETRIC_ORDERING_IMPL_H_
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "catamari/symmetric_ordering.hpp"
 
 namespace catamari {
 
+inline void ChildRelativeIndices::SelectMergeKernels() {
+  const Int num_nodes = offsets.Size() - 1;
+  merge_kernels.Resize(num_nodes);
+  for (Int node = 0; node < num_nodes; ++node) {
+    // Encoded runs are already merged with contiguous copies.
+    const Int degree = offsets[node + 1] - offsets[node];
+    merge_kernels[node] =
+        degree <= kMaxMergeKernelDegree && !runs.Encoded(node) ? degree : 0;
+  }
+}
+
 inline void AssemblyForest::FillFromParents() {
   const Int num_indices = parents.Size();
 
@@ -40,6 +57,7 @@ inline void AssemblyForest::FillFromParents() {
   // Pack the children into the 'children' buffer.
   children.Resize(num_total_children);
   roots.Resize(num_roots);
+  child_order = kDefaultChildOrder;
   Int counter = 0;
   Buffer<Int> offsets_copy = child_offsets;
   for (Int index = 0; index < num_indices; ++index) {
@@ -56,6 +74,36 @@ inline Int AssemblyForest::NumChildren(Int index) const {
   return child_offsets[index + 1] - child_offsets[index];
 }
 
+inline const LocalInt* AssemblyForest::ChildRelativeIndicesBeg(
+    Int index) const {
+  return child_relative_indices->indices.Data() +
+         child_relative_indices->offsets[index];
+}
+
+inline Int AssemblyForest::NumChildDiagIndices(Int index) const {
+  return child_relative_indices->num_diag_indices[index];
+}
+
+inline void AssemblyForest::SortChildren(const Buffer<double>& priorities,
+                                         ChildOrder order) {
+  const Int num_indices = parents.Size();
+  for (Int index = 0; index < num_indices; ++index) {
+    std::stable_sort(children.begin() + child_offsets[index],
+                     children.begin() + child_offsets[index + 1],
+                     [&](Int a, Int b) { return priorities[a] > priorities[b]; });
+  }
+  child_order = order;
+}
+
+inline void AssemblyForest::SortChildrenByIndex() {
+  const Int num_indices = parents.Size();
+  for (Int index = 0; index < num_indices; ++index) {
+    std::sort(children.begin() + child_offsets[index],
+              children.begin() + child_offsets[index + 1]);
+  }
+  child_order = kDefaultChildOrder;
+}
+
 template <class Field>
 void PermuteMatrix(const CoordinateMatrix<Field>& matrix,
                    const SymmetricOrdering& ordering,
@@ -63,27 +111,11 @@ void PermuteMatrix(const CoordinateMatrix<Field>& matrix,
   const Int num_rows = matrix.NumRows();
   reordered_matrix->Resize(num_rows, num_rows);
 
-  // Compute the offsets for the reordered matrix.
-  const auto& row_entry_offsets = matrix.RowEntryOffsets();
-  auto& reordered_row_entry_offsets = reordered_matrix->RowEntryOffsets();
-  {
-    reordered_row_entry_offsets.Resize(num_rows + 1);
-    Int offset = 0;
-    for (Int i = 0; i < num_rows; ++i) {
-      reordered_row_entry_offsets[i] = offset;
-      const Int i_old = ordering.inverse_permutation[i];
-      const Int row_count =
-          row_entry_offsets[i_old + 1] - row_entry_offsets[i_old];
-      offset += row_count;
-    }
-    reordered_row_entry_offsets[num_rows] = offset;
-  }
-
   // Fill in the rows of the reordered matrix, with each row initially
   // arbitrarily ordered, then sorted.
+  const auto& row_entry_offsets = matrix.RowEntryOffsets();
   const auto& entries = matrix.Entries();
-  auto& reordered_entries = reordered_matrix->Entries();
-  reordered_entries.Resize(entries.Size());
+  Buffer<MatrixEntry<Field>> reordered_entries(entries.Size());
   {
     Int row_beg = 0;
     for (Int row = 0; row < num_rows; ++row) {
@@ -102,6 +134,118 @@ void PermuteMatrix(const CoordinateMatrix<Field>& matrix,
       row_beg = row_end;
     }
   }
+
+  // The row offsets and column indices are recomputed from the entries.
+  reordered_matrix->SetSortedEntries(std::move(reordered_entries));
+}
+
+template <class Field>
+void FormBlockGraph(const CoordinateMatrix<Field>& matrix, Int block_size,
+                    CoordinateMatrix<Field>* block_graph) {
+  const Int num_rows = matrix.NumRows();
+  if (block_size < 1 || num_rows % block_size) {
+    throw std::runtime_error("The number of rows, " +
+                             std::to_string(num_rows) +
+                             ", is not a multiple of the block size, " +
+                             std::to_string(block_size));
+  }
+  const Int num_blocks = num_rows / block_size;
+  block_graph->Resize(num_blocks, num_blocks);
+
+  // Since the entries are sorted by row, each block row is formed from a
+  // contiguous range of them, which is then sorted and deduplicated.
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  std::vector<MatrixEntry<Field>> block_entries;
+  block_entries.reserve(entries.Size() / block_size);
+  for (Int block = 0; block < num_blocks; ++block) {
+    const Int entry_beg = matrix.RowEntryOffset(block * block_size);
+    const Int entry_end = matrix.RowEntryOffset((block + 1) * block_size);
+    const std::size_t row_beg = block_entries.size();
+    for (Int index = entry_beg; index < entry_end; ++index) {
+      block_entries.push_back(MatrixEntry<Field>{
+          block, entries[index].column / block_size, Field{1}});
+    }
+    std::sort(block_entries.begin() + row_beg, block_entries.end(),
+              [](const MatrixEntry<Field>& a, const MatrixEntry<Field>& b) {
+                return a.column < b.column;
+              });
+    block_entries.erase(
+        std::unique(block_entries.begin() + row_beg, block_entries.end(),
+                    [](const MatrixEntry<Field>& a,
+                       const MatrixEntry<Field>& b) {
+                      return a.column == b.column;
+                    }),
+        block_entries.end());
+  }
+
+  Buffer<MatrixEntry<Field>> sorted_entries(block_entries.size());
+  std::copy(block_entries.begin(), block_entries.end(),
+            sorted_entries.begin());
+  block_graph->SetSortedEntries(std::move(sorted_entries));
+}
+
+template <class Field>
+void PadBlockPattern(const CoordinateMatrix<Field>& matrix,
+                     const CoordinateMatrix<Field>& block_graph,
+                     Int block_size, CoordinateMatrix<Field>* padded_matrix) {
+  const Int num_rows = matrix.NumRows();
+  const Buffer<MatrixEntry<Field>>& entries = matrix.Entries();
+  const Buffer<MatrixEntry<Field>>& block_entries = block_graph.Entries();
+  padded_matrix->Resize(num_rows, num_rows);
+
+  Buffer<MatrixEntry<Field>> padded_entries(block_entries.Size() *
+                                            block_size * block_size);
+  Int padded_index = 0;
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int block = row / block_size;
+    Int index = matrix.RowEntryOffset(row);
+    const Int entry_end = matrix.RowEntryOffset(row + 1);
+    for (Int block_index = block_graph.RowEntryOffset(block);
+         block_index < block_graph.RowEntryOffset(block + 1); ++block_index) {
+      const Int column_beg = block_entries[block_index].column * block_size;
+      for (Int column = column_beg; column < column_beg + block_size;
+           ++column) {
+        Field value{0};
+        if (index < entry_end && entries[index].column == column) {
+          value = entries[index++].value;
+        }
+        padded_entries[padded_index++] =
+            MatrixEntry<Field>{row, column, value};
+      }
+    }
+  }
+  padded_matrix->SetSortedEntries(std::move(padded_entries));
+}
+
+inline void ExpandBlockOrdering(const SymmetricOrdering& block_ordering,
+                                Int block_size, SymmetricOrdering* ordering) {
+  const Int num_blocks = block_ordering.inverse_permutation.Size();
+  const Int num_rows = num_blocks * block_size;
+  ordering->permutation.Resize(num_rows);
+  ordering->inverse_permutation.Resize(num_rows);
+  for (Int block = 0; block < num_blocks; ++block) {
+    const Int orig_block = block_ordering.inverse_permutation[block];
+    for (Int offset = 0; offset < block_size; ++offset) {
+      const Int row = offset + block * block_size;
+      const Int orig_row = offset + orig_block * block_size;
+      ordering->inverse_permutation[row] = orig_row;
+      ordering->permutation[orig_row] = row;
+    }
+  }
+
+  const Int num_supernodes = block_ordering.supernode_sizes.Size();
+  ordering->supernode_sizes.Resize(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    ordering->supernode_sizes[supernode] =
+        block_size * block_ordering.supernode_sizes[supernode];
+  }
+  ordering->supernode_offsets.Resize(block_ordering.supernode_offsets.Size());
+  for (Int index = 0; index < block_ordering.supernode_offsets.Size();
+       ++index) {
+    ordering->supernode_offsets[index] =
+        block_size * block_ordering.supernode_offsets[index];
+  }
+  ordering->assembly_forest = block_ordering.assembly_forest;
 }
 
 }  // namespace catamari
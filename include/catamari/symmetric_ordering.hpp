@@ -8,12 +8,71 @@
 #ifndef CATAMARI_SYMMETRIC_ORDERING_H_
 #define CATAMARI_SYMMETRIC_ORDERING_H_
 
+#include <memory>
+
 #include "catamari/buffer.hpp"
 #include "catamari/coordinate_matrix.hpp"
+#include "catamari/index_runs.hpp"
 #include "quotient/integers.hpp"
 
 namespace catamari {
 
+// The order in which the children of each node of an assembly forest are
+// stored (and hence traversed by the multifrontal factorization).
+enum ChildOrder {
+  // The order produced by 'FillFromParents' (increasing child index).
+  kDefaultChildOrder,
+
+  // Decreasing peak frontal stack usage of each child's subtree, which
+  // minimizes the peak stack usage of the parent (Liu's ordering).
+  kMemoryMinimizingChildOrder,
+
+  // Decreasing length of the critical path of each child's subtree, so that
+  // the longest chains of dependent work are started first.
+  kCriticalPathChildOrder,
+};
+
+// The relative indices of the structure of each (super)node within the front
+// of its parent, packed contiguously.
+struct ChildRelativeIndices {
+  // The relative indices of (super)node 'j' are stored between indices
+  // 'offsets[j]' and 'offsets[j + 1]' of 'indices'. The length of this array
+  // is one more than the number of (super)nodes.
+  Buffer<Int> offsets;
+
+  // The packed relative indices, which are offsets from the upper-left corner
+  // of the parent front (whose leading indices are those of the parent's
+  // diagonal block). Since they are bounded by the size of the parent front,
+  // they are stored as 'LocalInt'.
+  Buffer<LocalInt> indices;
+
+  // The number of leading relative indices of each (super)node which lie
+  // within the diagonal block of its parent.
+  Buffer<Int> num_diag_indices;
+
+  // The runs of consecutive relative indices of each (super)node, so that
+  // its columns can be merged into those of its parent one contiguous run at
+  // a time. The runs are split at the boundary of the parent's diagonal
+  // block, so that they form the extend-add plan of the (super)node: each
+  // pair of runs is a dense block of its Schur complement which is added
+  // into a dense block of either the diagonal and lower blocks or the Schur
+  // complement of the parent front.
+  IndexRunList runs;
+
+  // The largest number of relative indices for which the merge of a
+  // (super)node is specialized at compile time.
+  static constexpr Int kMaxMergeKernelDegree = 16;
+
+  // The number of relative indices of each (super)node if the merge of its
+  // Schur complement dispatches to the kernel specialized on that degree, and
+  // zero if it is merged by the generic (run-based) loops.
+  Buffer<Int> merge_kernels;
+
+  // Selects the merge kernel of each (super)node from the offsets and the
+  // (already encoded) runs.
+  void SelectMergeKernels();
+};
+
 // A representation of a (scalar or supernodal) assembly forest via its up and
 // down links.
 struct AssemblyForest {
@@ -33,15 +92,34 @@ struct AssemblyForest {
   // The indices of the root supernodes in the forest.
   Buffer<Int> roots;
 
-  // Julian Panetta: mapping from each child structure to its parent front.
-  mutable Buffer<Buffer<Int>> child_rel_indices;
-  mutable Buffer<Int> num_child_diag_indices;
+  // The order in which 'children' is currently sorted.
+  ChildOrder child_order = kDefaultChildOrder;
+
+  // The map from the structure of each (super)node into the front of its
+  // parent. It is formed once during the symbolic analysis and is then shared,
+  // without copying, by all copies of the forest.
+  std::shared_ptr<const ChildRelativeIndices> child_relative_indices;
 
   // Fills the children and root list from the parent list.
   void FillFromParents();
 
   // Returns the number of children for the node with the given index.
   Int NumChildren(Int index) const;
+
+  // Returns a pointer to the relative indices of the structure of the node
+  // with the given index within the front of its parent.
+  const LocalInt* ChildRelativeIndicesBeg(Int index) const;
+
+  // Returns the number of leading relative indices of the node with the given
+  // index which lie within the diagonal block of its parent.
+  Int NumChildDiagIndices(Int index) const;
+
+  // Stably sorts the children of each node into decreasing order of
+  // 'priorities' (indexed by node) and records the order as 'order'.
+  void SortChildren(const Buffer<double>& priorities, ChildOrder order);
+
+  // Restores the children of each node to increasing index order.
+  void SortChildrenByIndex();
 };
 
 // A mechanism for passing reordering information into the factorization.
@@ -71,11 +149,41 @@ struct SymmetricOrdering {
 };
 
 // Permutes a symmetric matrix using the given reordering.
+//
+// This forms an explicit copy of the permuted matrix. The setup routines of
+// the factorizations (the elimination forests and structure sizes, the
+// structure indices, and the loading of the nonzeros) instead read the entries
+// of the permuted matrix from the original one on the fly, through
+// 'ordering.inverse_permutation' (for the rows) and 'ordering.permutation'
+// (for the columns), and never call it.
 template <class Field>
 void PermuteMatrix(const CoordinateMatrix<Field>& matrix,
                    const SymmetricOrdering& ordering,
                    CoordinateMatrix<Field>* reordered_matrix);
 
+// Fills 'block_graph' with the pattern (with unit values) of the graph of
+// the node blocks of the matrix, where block 'i' consists of rows
+// 'i * block_size' through '(i + 1) * block_size - 1'. The number of rows
+// must be a multiple of the block size.
+template <class Field>
+void FormBlockGraph(const CoordinateMatrix<Field>& matrix, Int block_size,
+                    CoordinateMatrix<Field>* block_graph);
+
+// Fills 'padded_matrix' with a copy of 'matrix' in which each block coupling
+// of 'block_graph' (see 'FormBlockGraph') is dense, with explicit zeros
+// added where the matrix has no entry.
+template <class Field>
+void PadBlockPattern(const CoordinateMatrix<Field>& matrix,
+                     const CoordinateMatrix<Field>& block_graph,
+                     Int block_size, CoordinateMatrix<Field>* padded_matrix);
+
+// Expands a reordering of the graph of the node blocks into a reordering of
+// their rows, with the rows of each block kept contiguous (and in their
+// original order). The supernodes, if any, are expanded by the block size,
+// so that the rows of each block belong to the same supernode.
+void ExpandBlockOrdering(const SymmetricOrdering& block_ordering,
+                         Int block_size, SymmetricOrdering* ordering);
+
 }  // namespace catamari
 
 #include "catamari/symmetric_ordering-impl.hpp"
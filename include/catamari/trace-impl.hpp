@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_TRACE_IMPL_H_
+#define CATAMARI_TRACE_IMPL_H_
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CATAMARI_TRACE_USE_TSC
+#endif  // if defined(__x86_64__) || defined(__i386__)
+
+#include "catamari/trace.hpp"
+
+namespace catamari {
+
+namespace trace {
+
+// Returns the nanoseconds elapsed on the steady clock since its epoch.
+inline std::uint64_t SteadyNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace trace
+
+inline std::uint64_t TraceTimestamp() {
+#ifdef CATAMARI_TRACE_USE_TSC
+  return __rdtsc();
+#else
+  return trace::SteadyNanoseconds();
+#endif  // ifdef CATAMARI_TRACE_USE_TSC
+}
+
+inline Tracer& Tracer::Global() {
+  // The tracer is never destroyed so that threads which outlive the static
+  // destructors may still record into it.
+  static Tracer* tracer = new Tracer;
+  return *tracer;
+}
+
+inline void Tracer::Enable(std::size_t capacity) {
+  capacity_ = std::max(capacity, std::size_t(1));
+  Clear();
+  start_nanoseconds_ = trace::SteadyNanoseconds();
+  start_ticks_ = TraceTimestamp();
+  enabled_.store(true, std::memory_order_release);
+}
+
+inline void Tracer::Disable() {
+  enabled_.store(false, std::memory_order_release);
+}
+
+inline bool Tracer::Enabled() const {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+inline void Tracer::Clear() {
+  generation_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline Tracer::ThreadBuffer* Tracer::LocalBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.emplace_back(new ThreadBuffer);
+    buffer = buffers_.back().get();
+    buffer->thread = buffers_.size() - 1;
+  }
+  return buffer;
+}
+
+inline void Tracer::Record(const char* name, Int supernode,
+                           std::uint64_t begin, std::uint64_t end) {
+  ThreadBuffer* buffer = LocalBuffer();
+  const std::uint64_t generation =
+      generation_.load(std::memory_order_relaxed);
+  if (buffer->generation != generation) {
+    buffer->generation = generation;
+    buffer->num_recorded = 0;
+    if (std::size_t(buffer->events.Size()) != capacity_) {
+      buffer->events.Resize(capacity_);
+    }
+  }
+  TraceEvent& event = buffer->events[buffer->num_recorded % capacity_];
+  event.name = name;
+  event.supernode = supernode;
+  event.begin = begin;
+  event.end = end;
+  event.thread = buffer->thread;
+  ++buffer->num_recorded;
+}
+
+inline std::vector<TraceEvent> Tracer::Events() const {
+  const std::uint64_t generation =
+      generation_.load(std::memory_order_relaxed);
+  std::vector<TraceEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+      if (buffer->generation != generation) continue;
+      const std::size_t num_retained = std::min(
+          buffer->num_recorded, std::size_t(buffer->events.Size()));
+      events.insert(events.end(), buffer->events.begin(),
+                    buffer->events.begin() + num_retained);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.begin < b.begin;
+                   });
+  return events;
+}
+
+inline std::size_t Tracer::NumDroppedEvents() const {
+  const std::uint64_t generation =
+      generation_.load(std::memory_order_relaxed);
+  std::size_t num_dropped = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+    if (buffer->generation != generation) continue;
+    const std::size_t capacity = buffer->events.Size();
+    if (buffer->num_recorded > capacity) {
+      num_dropped += buffer->num_recorded - capacity;
+    }
+  }
+  return num_dropped;
+}
+
+inline double Tracer::TicksPerMicrosecond() const {
+#ifdef CATAMARI_TRACE_USE_TSC
+  // Calibrate over at least a millisecond so that the clock readings'
+  // latencies are negligible.
+  std::uint64_t nanoseconds = trace::SteadyNanoseconds();
+  while (nanoseconds < start_nanoseconds_ + 1000000) {
+    nanoseconds = trace::SteadyNanoseconds();
+  }
+  const std::uint64_t ticks = TraceTimestamp();
+  return 1.e3 * double(ticks - start_ticks_) /
+         double(nanoseconds - start_nanoseconds_);
+#else
+  return 1.e3;
+#endif  // ifdef CATAMARI_TRACE_USE_TSC
+}
+
+inline void Tracer::WriteChromeTrace(std::ostream& os) const {
+  const std::vector<TraceEvent> events = Events();
+  const double ticks_per_microsecond = TicksPerMicrosecond();
+  int num_threads = 0;
+  for (const TraceEvent& event : events) {
+    num_threads = std::max(num_threads, event.thread + 1);
+  }
+
+  const auto old_flags = os.flags();
+  const auto old_precision = os.precision();
+  os.setf(std::ios::fixed, std::ios::floatfield);
+  os.precision(3);
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  for (int thread = 0; thread < num_threads; ++thread) {
+    os << (first ? "\n" : ",\n")
+       << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+       << "\"tid\": " << thread << ", \"args\": {\"name\": \"thread "
+       << thread << "\"}}";
+    first = false;
+  }
+  for (const TraceEvent& event : events) {
+    // Events from before the tracer was enabled are clamped to its start.
+    const std::uint64_t begin = std::max(event.begin, start_ticks_);
+    const std::uint64_t end = std::max(event.end, begin);
+    os << (first ? "\n" : ",\n") << "  {\"name\": \"" << event.name
+       << "\", \"cat\": \"catamari\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+       << event.thread
+       << ", \"ts\": " << (begin - start_ticks_) / ticks_per_microsecond
+       << ", \"dur\": " << (end - begin) / ticks_per_microsecond;
+    if (event.supernode >= 0) {
+      os << ", \"args\": {\"supernode\": " << event.supernode << "}";
+    }
+    os << "}";
+    first = false;
+  }
+  os << "\n]}" << std::endl;
+  os.flags(old_flags);
+  os.precision(old_precision);
+}
+
+inline bool Tracer::WriteChromeTrace(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file) return false;
+  WriteChromeTrace(file);
+  return bool(file);
+}
+
+inline TraceScope::TraceScope(const char* name, Int supernode)
+    : name_(name),
+      supernode_(supernode),
+      begin_(Tracer::Global().Enabled() ? TraceTimestamp() : 0) {}
+
+inline TraceScope::~TraceScope() {
+  if (begin_) {
+    Tracer::Global().Record(name_, supernode_, begin_, TraceTimestamp());
+  }
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_TRACE_IMPL_H_
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_TRACE_H_
+#define CATAMARI_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "catamari/buffer.hpp"
+#include "catamari/integers.hpp"
+
+namespace catamari {
+
+// Returns a timestamp in the units of the tracer's clock: the time-stamp
+// counter on x86, and nanoseconds of a steady clock elsewhere.
+std::uint64_t TraceTimestamp();
+
+// A completed span of work on some thread.
+struct TraceEvent {
+  // The (static) name of the event, e.g., "factor", "merge", or "solve".
+  const char* name = nullptr;
+
+  // The supernode the work was performed on, or -1 if the event is not
+  // associated with one.
+  Int supernode = -1;
+
+  // The timestamps of the beginning and the end of the event.
+  std::uint64_t begin = 0;
+  std::uint64_t end = 0;
+
+  // The index of the thread which recorded the event (in the order in which
+  // the threads first recorded events).
+  int thread = 0;
+};
+
+// A process-wide recorder of trace events. Each thread appends to its own
+// ring buffer, so recording requires no synchronization; once a buffer is
+// full, the oldest of its events are overwritten. When tracing is disabled,
+// a 'TraceScope' costs a single relaxed atomic load.
+//
+// The buffers must only be read ('Events', 'WriteChromeTrace') or reset
+// ('Enable', 'Clear') while no thread is recording, e.g., between
+// factorizations and solves.
+class Tracer {
+ public:
+  // The default number of events retained per thread.
+  static constexpr std::size_t kDefaultCapacity = std::size_t(1) << 16;
+
+  // Returns the process-wide tracer.
+  static Tracer& Global();
+
+  // Discards any recorded events and enables recording, retaining up to
+  // 'capacity' events per thread.
+  void Enable(std::size_t capacity = kDefaultCapacity);
+
+  // Disables recording while keeping the recorded events.
+  void Disable();
+
+  // Returns true if events are being recorded.
+  bool Enabled() const;
+
+  // Discards the recorded events.
+  void Clear();
+
+  // Appends an event to the calling thread's buffer.
+  void Record(const char* name, Int supernode, std::uint64_t begin,
+              std::uint64_t end);
+
+  // Returns the retained events ordered by their beginnings.
+  std::vector<TraceEvent> Events() const;
+
+  // Returns the number of events which were overwritten since the events
+  // were last discarded.
+  std::size_t NumDroppedEvents() const;
+
+  // Returns the number of tracer clock ticks per microsecond, as calibrated
+  // against a steady clock since tracing was enabled.
+  double TicksPerMicrosecond() const;
+
+  // Writes the retained events in the Chrome trace event format, which is
+  // read by chrome://tracing and Perfetto. Each thread is shown as its own
+  // track, and the supernode of each event is stored in its arguments.
+  void WriteChromeTrace(std::ostream& os) const;
+
+  // Writes the Chrome trace into the given file, returning false if it could
+  // not be opened.
+  bool WriteChromeTrace(const std::string& filename) const;
+
+ private:
+  // The ring buffer of events of a single thread.
+  struct ThreadBuffer {
+    // The index of the thread.
+    int thread = 0;
+
+    // The generation of the tracer the buffer was last reset in.
+    std::uint64_t generation = 0;
+
+    // The total number of events recorded into the buffer in its generation.
+    std::size_t num_recorded = 0;
+
+    // The ring of events.
+    Buffer<TraceEvent> events;
+  };
+
+  // The tracer is only constructed by 'Global'.
+  Tracer() = default;
+
+  // Whether events are being recorded.
+  std::atomic<bool> enabled_{false};
+
+  // Incremented whenever the events are discarded, so that each thread
+  // lazily resets its buffer.
+  std::atomic<std::uint64_t> generation_{1};
+
+  // The number of events retained per thread.
+  std::size_t capacity_ = kDefaultCapacity;
+
+  // The tracer and steady clock readings when tracing was last enabled.
+  std::uint64_t start_ticks_ = 0;
+  std::uint64_t start_nanoseconds_ = 0;
+
+  // Serializes the registration of the thread buffers.
+  mutable std::mutex mutex_;
+
+  // The buffers of all threads which have recorded events. They are never
+  // freed, since threads keep pointers to them.
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+  // Returns the calling thread's buffer, registering it if need be.
+  ThreadBuffer* LocalBuffer();
+};
+
+// Records the lifetime of the scope as an event of the global tracer, if it
+// is enabled upon construction.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name, Int supernode = -1);
+  ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  // The name of the event.
+  const char* name_;
+
+  // The supernode of the event.
+  Int supernode_;
+
+  // The timestamp of the beginning of the event, or zero if tracing was
+  // disabled.
+  std::uint64_t begin_;
+};
+
+}  // namespace catamari
+
+#include "catamari/trace-impl.hpp"
+
+#endif  // ifndef CATAMARI_TRACE_H_
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_UNIFORM_SPANNING_TREE_IMPL_H_
+#define CATAMARI_UNIFORM_SPANNING_TREE_IMPL_H_
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+#include <tbb/parallel_for.h>
+
+#include "catamari/dense_dpp.hpp"
+#include "catamari/philox.hpp"
+#include "catamari/trace.hpp"
+
+#include "catamari/uniform_spanning_tree.hpp"
+
+namespace catamari {
+
+template <typename Real>
+UniformSpanningTreeSampler<Real>::UniformSpanningTreeSampler(
+    const quotient::CoordinateGraph& graph,
+    const UniformSpanningTreeControl<Real>& control) {
+  TraceScope trace_scope("UniformSpanningTreeSampler");
+  num_vertices_ = graph.NumSources();
+  if (control.seed >= 0) {
+    seed_ = control.seed;
+  } else {
+    std::random_device random_device;
+    seed_ = (std::uint64_t(random_device()) << 32) | random_device();
+  }
+
+  // Merge the duplicates of each unordered pair of distinct vertices.
+  const Int num_graph_edges = graph.NumEdges();
+  edges_.reserve(num_graph_edges);
+  for (Int index = 0; index < num_graph_edges; ++index) {
+    const GraphEdge& edge = graph.Edge(index);
+    if (edge.first == edge.second) continue;
+    edges_.emplace_back(std::min(edge.first, edge.second),
+                        std::max(edge.first, edge.second));
+  }
+  std::sort(edges_.begin(), edges_.end());
+  edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+  const Int num_edges = edges_.size();
+  const Int rank = num_vertices_ - 1;
+
+  // A singular grounded Laplacian need not be caught by a failed pivot in
+  // floating-point, so the connectivity is checked by merging the components
+  // joined by each edge.
+  Buffer<Int> component(num_vertices_);
+  for (Int vertex = 0; vertex < num_vertices_; ++vertex) {
+    component[vertex] = vertex;
+  }
+  auto find_root = [&](Int vertex) {
+    while (component[vertex] != vertex) {
+      component[vertex] = component[component[vertex]];
+      vertex = component[vertex];
+    }
+    return vertex;
+  };
+  Int num_components = num_vertices_;
+  for (const GraphEdge& edge : edges_) {
+    const Int first_root = find_root(edge.first);
+    const Int second_root = find_root(edge.second);
+    if (first_root != second_root) {
+      component[first_root] = second_root;
+      --num_components;
+    }
+  }
+  if (num_components > 1) {
+    throw std::runtime_error("The graph is not connected");
+  }
+  if (rank <= 0) {
+    kernel_factor_.Resize(num_edges, 0);
+    return;
+  }
+
+  // Form the Laplacian grounded at the last vertex, whose row and column are
+  // dropped.
+  CoordinateMatrix<Real> laplacian;
+  laplacian.Resize(rank, rank);
+  laplacian.ReserveEntryAdditions(4 * num_edges);
+  for (const GraphEdge& edge : edges_) {
+    laplacian.QueueEntryAddition(edge.first, edge.first, Real{1});
+    if (edge.second == rank) continue;
+    laplacian.QueueEntryAddition(edge.second, edge.second, Real{1});
+    laplacian.QueueEntryAddition(edge.first, edge.second, Real{-1});
+    laplacian.QueueEntryAddition(edge.second, edge.first, Real{-1});
+  }
+  laplacian.FlushEntryQueues();
+
+  SparseLDLControl<Real> ldl_control = control.ldl_control;
+  ldl_control.SetFactorizationType(kCholeskyFactorization);
+  ldl_control.equilibrate = false;
+  SparseLDL<Real> ldl;
+  const SparseLDLResult<Real> result = ldl.Factor(laplacian, ldl_control);
+  if (result.num_successful_pivots < rank) {
+    throw std::runtime_error("The grounded Laplacian could not be factored");
+  }
+
+  // Each batch of rows of W' = inv(C) P B is formed by a triangular solve
+  // against the corresponding columns of the (permuted) grounded incidence
+  // matrix, and then transposed into W.
+  const Buffer<Int>& permutation = ldl.Permutation();
+  auto permuted = [&](Int vertex) {
+    return permutation.Empty() ? vertex : permutation[vertex];
+  };
+  const Int batch_size = std::max(control.solve_batch_size, Int(1));
+  const Int num_batches = (num_edges + batch_size - 1) / batch_size;
+  kernel_factor_.Resize(num_edges, rank);
+  tbb::parallel_for(Int(0), num_batches, [&](Int batch) {
+    const Int edge_beg = batch * batch_size;
+    const Int edge_end = std::min(num_edges, edge_beg + batch_size);
+    BlasMatrix<Real> incidence;
+    incidence.Resize(rank, edge_end - edge_beg, Real{0});
+    for (Int index = edge_beg; index < edge_end; ++index) {
+      const GraphEdge& edge = edges_[index];
+      incidence(permuted(edge.first), index - edge_beg) = Real{1};
+      if (edge.second != rank) {
+        incidence(permuted(edge.second), index - edge_beg) = Real{-1};
+      }
+    }
+    ldl.LowerTriangularSolve(&incidence.view);
+    for (Int j = 0; j < rank; ++j) {
+      for (Int index = edge_beg; index < edge_end; ++index) {
+        kernel_factor_(index, j) = incidence(j, index - edge_beg);
+      }
+    }
+  });
+}
+
+template <typename Real>
+Int UniformSpanningTreeSampler<Real>::NumVertices() const {
+  return num_vertices_;
+}
+
+template <typename Real>
+const std::vector<GraphEdge>& UniformSpanningTreeSampler<Real>::Edges()
+    const {
+  return edges_;
+}
+
+template <typename Real>
+std::vector<GraphEdge> UniformSpanningTreeSampler<Real>::SampleFromStream(
+    Int sample_index, bool maximum_likelihood) const {
+  PhiloxEngine generator(seed_, static_cast<std::uint32_t>(sample_index));
+  const std::vector<Int> sample =
+      low_rank_herm_dpp::SampleFactoredMarginalKernel(
+          maximum_likelihood, kernel_factor_.ConstView(), &generator);
+  std::vector<GraphEdge> tree;
+  tree.reserve(sample.size());
+  for (const Int& index : sample) {
+    tree.push_back(edges_[index]);
+  }
+  return tree;
+}
+
+template <typename Real>
+std::vector<GraphEdge> UniformSpanningTreeSampler<Real>::Sample(
+    bool maximum_likelihood) const {
+  return SampleFromStream(num_samples_drawn_++, maximum_likelihood);
+}
+
+template <typename Real>
+std::vector<std::vector<GraphEdge>>
+UniformSpanningTreeSampler<Real>::SampleMany(Int num_samples,
+                                             bool maximum_likelihood) const {
+  TraceScope trace_scope("UniformSpanningTreeSampler.SampleMany");
+  const Int first_sample_index = num_samples_drawn_;
+  num_samples_drawn_ += num_samples;
+  std::vector<std::vector<GraphEdge>> trees(num_samples);
+  tbb::parallel_for(Int(0), num_samples, [&](Int index) {
+    trees[index] =
+        SampleFromStream(first_sample_index + index, maximum_likelihood);
+  });
+  return trees;
+}
+
+template <typename Real>
+std::vector<std::vector<GraphEdge>> SampleSpanningTrees(
+    const quotient::CoordinateGraph& graph, Int num_samples) {
+  const UniformSpanningTreeSampler<Real> sampler(
+      graph, UniformSpanningTreeControl<Real>());
+  return sampler.SampleMany(num_samples);
+}
+
+}  // namespace catamari
+
+#endif  // ifndef CATAMARI_UNIFORM_SPANNING_TREE_IMPL_H_
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_UNIFORM_SPANNING_TREE_H_
+#define CATAMARI_UNIFORM_SPANNING_TREE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+namespace catamari {
+
+template <typename Real>
+struct UniformSpanningTreeControl {
+  // The configuration of the sparse Cholesky factorization of the grounded
+  // graph Laplacian. The factorization type is overridden with Cholesky and
+  // equilibration is disabled.
+  SparseLDLControl<Real> ldl_control;
+
+  // The number of edges whose rows of the kernel factor are formed by each
+  // (concurrent) batch of triangular solves.
+  Int solve_batch_size = 256;
+
+  // The key of the counter-based random number streams. Each sample draws
+  // from its own stream, so that the samples are reproducible regardless of
+  // the number of threads. If negative, a key is drawn from
+  // std::random_device.
+  Int seed = -1;
+};
+
+// A sampler of the uniform distribution over the spanning trees of a
+// connected, undirected graph. Each edge (i, j) with i != j of the input
+// graph is treated as undirected, and the duplicates of each unordered pair
+// -- such as the two directions of a symmetric graph -- are merged.
+//
+// The edges of a uniform spanning tree form the determinantal point process
+// whose marginal kernel is the transfer current matrix [1],
+//
+//   K = B' inv(L) B,
+//
+// where B is the signed vertex-edge incidence matrix with the row of the last
+// vertex removed and L = B B' is the (correspondingly grounded) graph
+// Laplacian. The Laplacian is factored once as P L P' = C C' with the sparse
+// Cholesky factorization, so that K = W W' with the dense
+// num_edges x (num_vertices - 1) factor
+//
+//   W = B' P' inv(C)',
+//
+// which is formed once through triangular solves and shared by all of the
+// samples. Each sample then eliminates the edges in turn through rank-one
+// updates of a (num_vertices - 1) x (num_vertices - 1) matrix (cf.
+// SampleLowRankHermitianDPP), which requires O(num_edges num_vertices^2) work
+// rather than the O(num_edges^3) of sampling the dense kernel.
+//
+// [1] Burton and Pemantle, Local Characteristics, Entropy and Limit Theorems
+//     for Spanning Trees and Domino Tilings Via Transfer-Impedances,
+//     The Annals of Probability, 21 (3) 1993.
+//
+template <typename Real>
+class UniformSpanningTreeSampler {
+ public:
+  // Factors the grounded Laplacian of the graph and forms the kernel factor.
+  // An exception is thrown if the graph is not connected.
+  UniformSpanningTreeSampler(const quotient::CoordinateGraph& graph,
+                             const UniformSpanningTreeControl<Real>& control);
+
+  // Returns the number of vertices of the graph.
+  Int NumVertices() const;
+
+  // Returns the undirected edges of the graph, each with its source less
+  // than its target, in lexicographic order. These are the ground set of the
+  // samples.
+  const std::vector<GraphEdge>& Edges() const;
+
+  // Returns the 'NumVertices() - 1' edges of a spanning tree, in the order of
+  // 'Edges()'. If 'maximum_likelihood' is true, then each edge is kept based
+  // upon which choice is most likely.
+  std::vector<GraphEdge> Sample(bool maximum_likelihood = false) const;
+
+  // Returns 'num_samples' independent spanning trees, which are drawn
+  // concurrently while sharing the factorization and the kernel factor. With
+  // a fixed seed, the result matches 'num_samples' calls to 'Sample'.
+  std::vector<std::vector<GraphEdge>> SampleMany(
+      Int num_samples, bool maximum_likelihood = false) const;
+
+ private:
+  // The number of vertices of the graph.
+  Int num_vertices_;
+
+  // The unique undirected edges of the graph.
+  std::vector<GraphEdge> edges_;
+
+  // The num_edges x (num_vertices - 1) factor, W, of the transfer current
+  // matrix.
+  BlasMatrix<Real> kernel_factor_;
+
+  // The key of the random number streams.
+  std::uint64_t seed_;
+
+  // The number of samples drawn so far, which is the index of the random
+  // number stream of the next sample.
+  mutable Int num_samples_drawn_ = 0;
+
+  // Returns the spanning tree drawn from the given random number stream.
+  std::vector<GraphEdge> SampleFromStream(Int sample_index,
+                                          bool maximum_likelihood) const;
+};
+
+// Returns 'num_samples' independent uniform samples of the spanning trees of
+// a connected, undirected graph, each as its list of 'num_vertices - 1'
+// edges, through a 'UniformSpanningTreeSampler' with the default control.
+template <typename Real = double>
+std::vector<std::vector<GraphEdge>> SampleSpanningTrees(
+    const quotient::CoordinateGraph& graph, Int num_samples);
+
+}  // namespace catamari
+
+#include "catamari/uniform_spanning_tree-impl.hpp"
+
+#endif  // ifndef CATAMARI_UNIFORM_SPANNING_TREE_H_
@@ -8,6 +8,14 @@
 #ifndef CATAMARI_UNIT_REACH_NESTED_DISSECTION_IMPL_H_
 #define CATAMARI_UNIT_REACH_NESTED_DISSECTION_IMPL_H_
 
+#include <algorithm>
+#include <array>
+#include <map>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
 #include "catamari/unit_reach_nested_dissection.hpp"
 
 namespace catamari {
@@ -385,6 +393,207 @@ void UnitReachNestedDissection3D(Int num_x_elements, Int num_y_elements,
   ordering->assembly_forest.roots[0] = num_supernodes - 1;
 }
 
+// Returns the axis (0, 1, or 2 for x, y, or z) along which a box of the given
+// per-axis numbers of vertices is cut, or -1 if it is a leaf.
+inline int UnitReachNestedDissectionCutAxis(
+    const Int sizes[3], const UnitReachNestedDissectionControl& control) {
+  const Int min_cut_size = std::max(control.min_cut_size, Int(3));
+  const double scales[3] = {control.x_scale, control.y_scale, control.z_scale};
+  int axis = -1;
+  double max_extent = 0;
+  for (int candidate = 0; candidate < 3; ++candidate) {
+    if (sizes[candidate] < min_cut_size) {
+      continue;
+    }
+    const double extent = sizes[candidate] * scales[candidate];
+    if (axis < 0 || extent > max_extent) {
+      axis = candidate;
+      max_extent = extent;
+    }
+  }
+  return axis;
+}
+
+// The number of supernodes generated by the dissection of a box with the
+// given per-axis numbers of vertices. Since it only depends upon the sizes,
+// it is memoized over the (few) distinct sizes of the boxes.
+inline Int UnitReachNestedDissectionNumSupernodes(
+    const Int sizes[3], const UnitReachNestedDissectionControl& control,
+    std::map<std::array<Int, 3>, Int>* num_supernodes) {
+  const std::array<Int, 3> key{{sizes[0], sizes[1], sizes[2]}};
+  auto iter = num_supernodes->find(key);
+  if (iter != num_supernodes->end()) {
+    return iter->second;
+  }
+  const int axis = UnitReachNestedDissectionCutAxis(sizes, control);
+  Int count = 1;
+  if (axis >= 0) {
+    Int left_sizes[3] = {sizes[0], sizes[1], sizes[2]};
+    Int right_sizes[3] = {sizes[0], sizes[1], sizes[2]};
+    left_sizes[axis] = sizes[axis] / 2;
+    right_sizes[axis] = sizes[axis] - sizes[axis] / 2 - 1;
+    count += UnitReachNestedDissectionNumSupernodes(left_sizes, control,
+                                                    num_supernodes);
+    count += UnitReachNestedDissectionNumSupernodes(right_sizes, control,
+                                                    num_supernodes);
+  }
+  (*num_supernodes)[key] = count;
+  return count;
+}
+
+// Appends the rows of the vertices of the box '[beg, end)', in
+// lexicographic order with the degrees of freedom of each vertex contiguous,
+// to the inverse permutation starting at 'offset'.
+inline void UnitReachNestedDissectionFillBox(const Int beg[3], const Int end[3],
+                                             const Int strides[3],
+                                             Int num_dofs, Int offset,
+                                             SymmetricOrdering* ordering) {
+  for (Int z = beg[2]; z < end[2]; ++z) {
+    for (Int y = beg[1]; y < end[1]; ++y) {
+      for (Int x = beg[0]; x < end[0]; ++x) {
+        const Int vertex = x * strides[0] + y * strides[1] + z * strides[2];
+        for (Int dof = 0; dof < num_dofs; ++dof) {
+          ordering->inverse_permutation[offset++] = dof + vertex * num_dofs;
+        }
+      }
+    }
+  }
+}
+
+// Fills the supernodes 'supernode_beg' onward, and the rows starting at
+// 'offset', with the postordered dissection of the box '[beg, end)'. The two
+// halves of large boxes are generated concurrently.
+inline void UnitReachNestedDissectionRecursion(
+    const Int beg[3], const Int end[3], const Int strides[3], Int offset,
+    Int supernode_beg, const UnitReachNestedDissectionControl& control,
+    const std::map<std::array<Int, 3>, Int>& num_supernodes,
+    SymmetricOrdering* ordering) {
+  const Int num_dofs = control.num_dofs_per_vertex;
+  const Int sizes[3] = {end[0] - beg[0], end[1] - beg[1], end[2] - beg[2]};
+  const Int num_vertices = sizes[0] * sizes[1] * sizes[2];
+  const int axis = UnitReachNestedDissectionCutAxis(sizes, control);
+  if (axis < 0) {
+    UnitReachNestedDissectionFillBox(beg, end, strides, num_dofs, offset,
+                                     ordering);
+    ordering->supernode_sizes[supernode_beg] = num_vertices * num_dofs;
+    ordering->assembly_forest.parents[supernode_beg] = -1;
+    return;
+  }
+
+  // Split the box into its two halves and the separating plane.
+  const Int cut = beg[axis] + sizes[axis] / 2;
+  Int left_end[3] = {end[0], end[1], end[2]};
+  Int right_beg[3] = {beg[0], beg[1], beg[2]};
+  Int separator_beg[3] = {beg[0], beg[1], beg[2]};
+  Int separator_end[3] = {end[0], end[1], end[2]};
+  left_end[axis] = cut;
+  right_beg[axis] = cut + 1;
+  separator_beg[axis] = cut;
+  separator_end[axis] = cut + 1;
+
+  Int left_sizes[3] = {sizes[0], sizes[1], sizes[2]};
+  Int right_sizes[3] = {sizes[0], sizes[1], sizes[2]};
+  left_sizes[axis] = cut - beg[axis];
+  right_sizes[axis] = end[axis] - (cut + 1);
+  const Int num_left_supernodes = num_supernodes.at(
+      std::array<Int, 3>{{left_sizes[0], left_sizes[1], left_sizes[2]}});
+  const Int num_right_supernodes = num_supernodes.at(
+      std::array<Int, 3>{{right_sizes[0], right_sizes[1], right_sizes[2]}});
+  const Int left_offset = offset;
+  const Int right_offset =
+      left_offset + left_sizes[0] * left_sizes[1] * left_sizes[2] * num_dofs;
+  const Int separator_offset =
+      right_offset +
+      right_sizes[0] * right_sizes[1] * right_sizes[2] * num_dofs;
+  const Int left_supernode_beg = supernode_beg;
+  const Int right_supernode_beg = supernode_beg + num_left_supernodes;
+  const Int supernode = right_supernode_beg + num_right_supernodes;
+
+  if (num_vertices >= control.min_parallel_vertices) {
+    tbb::task_group tg;
+    tg.run([&]() {
+      UnitReachNestedDissectionRecursion(beg, left_end, strides, left_offset,
+                                         left_supernode_beg, control,
+                                         num_supernodes, ordering);
+    });
+    tg.run([&]() {
+      UnitReachNestedDissectionRecursion(right_beg, end, strides,
+                                         right_offset, right_supernode_beg,
+                                         control, num_supernodes, ordering);
+    });
+    UnitReachNestedDissectionFillBox(separator_beg, separator_end, strides,
+                                     num_dofs, separator_offset, ordering);
+    tg.wait();
+  } else {
+    UnitReachNestedDissectionRecursion(beg, left_end, strides, left_offset,
+                                       left_supernode_beg, control,
+                                       num_supernodes, ordering);
+    UnitReachNestedDissectionRecursion(right_beg, end, strides, right_offset,
+                                       right_supernode_beg, control,
+                                       num_supernodes, ordering);
+    UnitReachNestedDissectionFillBox(separator_beg, separator_end, strides,
+                                     num_dofs, separator_offset, ordering);
+  }
+
+  ordering->supernode_sizes[supernode] =
+      (num_vertices / sizes[axis]) * num_dofs;
+  ordering->assembly_forest.parents[supernode_beg + num_left_supernodes - 1] =
+      supernode;
+  ordering->assembly_forest.parents[supernode - 1] = supernode;
+  ordering->assembly_forest.parents[supernode] = -1;
+}
+
+inline void UnitReachNestedDissection3D(
+    Int num_x_elements, Int num_y_elements, Int num_z_elements,
+    const UnitReachNestedDissectionControl& control,
+    SymmetricOrdering* ordering) {
+  const Int num_dofs = control.num_dofs_per_vertex;
+  const Int sizes[3] = {num_x_elements + 1, num_y_elements + 1,
+                        num_z_elements + 1};
+  const Int strides[3] = {1, sizes[0], sizes[0] * sizes[1]};
+  const Int num_rows = sizes[0] * sizes[1] * sizes[2] * num_dofs;
+
+  std::map<std::array<Int, 3>, Int> num_supernodes_map;
+  const Int num_supernodes = UnitReachNestedDissectionNumSupernodes(
+      sizes, control, &num_supernodes_map);
+
+  ordering->permutation.Resize(num_rows);
+  ordering->inverse_permutation.Resize(num_rows);
+  ordering->supernode_sizes.Resize(num_supernodes);
+  ordering->assembly_forest.parents.Resize(num_supernodes);
+
+  const Int beg[3] = {0, 0, 0};
+  UnitReachNestedDissectionRecursion(beg, sizes, strides, 0, 0, control,
+                                     num_supernodes_map, ordering);
+
+  // Invert the inverse permutation.
+  tbb::parallel_for(tbb::blocked_range<Int>(0, num_rows, 4096),
+                    [&](const tbb::blocked_range<Int>& range) {
+                      for (Int row = range.begin(); row < range.end(); ++row) {
+                        ordering->permutation[ordering->inverse_permutation
+                                                  [row]] = row;
+                      }
+                    });
+
+  quotient::ChildrenFromParents(ordering->assembly_forest.parents,
+                                &ordering->assembly_forest.children,
+                                &ordering->assembly_forest.child_offsets);
+
+  OffsetScan(ordering->supernode_sizes, &ordering->supernode_offsets);
+
+  ordering->assembly_forest.roots.Resize(1);
+  ordering->assembly_forest.roots[0] = num_supernodes - 1;
+}
+
+inline void UnitReachNestedDissection2D(
+    Int num_x_elements, Int num_y_elements,
+    const UnitReachNestedDissectionControl& control,
+    SymmetricOrdering* ordering) {
+  // A planar grid is a single layer of vertices, which is never cut along z.
+  UnitReachNestedDissection3D(num_x_elements, num_y_elements, 0, control,
+                              ordering);
+}
+
 }  // namespace catamari
 
 #endif  // ifndef CATAMARI_UNIT_REACH_NESTED_DISSECTION_IMPL_H_
@@ -12,19 +12,64 @@
 
 namespace catamari {
 
+// Configuration options for the (multithreaded) generation of analytical
+// nested dissection orderings of structured grids.
+struct UnitReachNestedDissectionControl {
+  // The number of degrees of freedom at each vertex of the grid. The rows of
+  // the matrix are assumed to be ordered with the degrees of freedom of each
+  // vertex contiguous, i.e., row 'dof + num_dofs_per_vertex * vertex', and
+  // they remain contiguous (and in the same supernode) in the ordering, e.g.,
+  // for the three displacements of each vertex in linear elasticity.
+  Int num_dofs_per_vertex = 1;
+
+  // The relative extents of a grid cell along each axis. Each box is cut
+  // perpendicular to the axis of its largest scaled extent, so that grids
+  // with strongly anisotropic cells are dissected in their physical, rather
+  // than index, proportions.
+  double x_scale = 1.;
+  double y_scale = 1.;
+  double z_scale = 1.;
+
+  // The minimum number of vertices along an axis of a box before it will be
+  // cut along that axis. Boxes which cannot be cut form the leaves.
+  Int min_cut_size = 5;
+
+  // The minimum number of vertices of a box before its two halves are
+  // generated as separate TBB tasks.
+  Int min_parallel_vertices = 32768;
+};
+
 // Analytically performs nested dissection on a
 // 'num_x_elements x num_y_elements' grid where each vertex only touches its
 // nearest neighbors.
-void UnitReach2DNestedDissection(Int num_x_elements, Int num_y_elements,
+void UnitReachNestedDissection2D(Int num_x_elements, Int num_y_elements,
                                  SymmetricOrdering* ordering);
 
 // Analytically performs nested dissection on a
 // 'num_x_elements x num_y_elements x num_z_elements' grid where each vertex
 // only touches its nearest neighbors.
-void UnitReach3DNestedDissection(Int num_x_elements, Int num_y_elements,
+void UnitReachNestedDissection3D(Int num_x_elements, Int num_y_elements,
                                  Int num_z_elements,
                                  SymmetricOrdering* ordering);
 
+// Analytically performs nested dissection on a
+// 'num_x_elements x num_y_elements' grid where each vertex only touches its
+// nearest neighbors, generating the sub-boxes concurrently. With the default
+// control, the result matches the sequential version.
+void UnitReachNestedDissection2D(
+    Int num_x_elements, Int num_y_elements,
+    const UnitReachNestedDissectionControl& control,
+    SymmetricOrdering* ordering);
+
+// Analytically performs nested dissection on a
+// 'num_x_elements x num_y_elements x num_z_elements' grid where each vertex
+// only touches its nearest neighbors, generating the sub-boxes concurrently.
+// With the default control, the result matches the sequential version.
+void UnitReachNestedDissection3D(
+    Int num_x_elements, Int num_y_elements, Int num_z_elements,
+    const UnitReachNestedDissectionControl& control,
+    SymmetricOrdering* ordering);
+
 }  // namespace catamari
 
 #include "catamari/unit_reach_nested_dissection-impl.hpp"
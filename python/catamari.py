@@ -1,4 +1,5 @@
-# A preliminary Python interface to Catamari's dense DPP samplers.
+# A preliminary Python interface to Catamari's dense DPP samplers and sparse
+# LDL factorizations.
 import ctypes
 import numpy as np
 import time
@@ -154,20 +155,37 @@ class BlasMatrixView(object):
 
     @classmethod
     def from_numpy(cls, matrix):
-        """Converts a numpy matrix into a BlasMatrixView."""
+        """Converts a numpy matrix into a BlasMatrixView.
+
+        A matrix with unit-stride columns, such as a Fortran-ordered array or
+        a block of one, is viewed in place using its column stride as the
+        leading dimension; any other matrix is first copied into Fortran
+        order. The view keeps a reference to the array that it points into.
+        """
         if len(matrix.shape) != 2:
             raise ValueError(
                 'Expected a matrix input for BlasMatrixView.from_numpy')
-        mat_f = matrix if matrix.flags.f_contiguous else np.asfortranarray(
-            matrix)
+        itemsize = matrix.dtype.itemsize
+        row_stride, column_stride = matrix.strides
+        if matrix.flags.f_contiguous:
+            mat_f = matrix
+            leading_dim = mat_f.shape[0]
+        elif (row_stride == itemsize and column_stride % itemsize == 0 and
+              column_stride // itemsize >= matrix.shape[0]):
+            mat_f = matrix
+            leading_dim = column_stride // itemsize
+        else:
+            mat_f = np.asfortranarray(matrix)
+            leading_dim = mat_f.shape[0]
 
         ctypes_dtype = numpy_dtype_to_ctypes(mat_f.dtype)
 
         view = BlasMatrixView(mat_f.dtype)
         view.view.height = mat_f.shape[0]
         view.view.width = mat_f.shape[1]
-        view.view.leading_dim = mat_f.shape[0]
+        view.view.leading_dim = leading_dim
         view.view.data = mat_f.ctypes.data_as(POINTER(ctypes_dtype))
+        view.array = mat_f
 
         return view
 
@@ -284,6 +302,73 @@ def SampleLowerHermitianDPP(matrix_view,
     return np.frombuffer(sample_memory_view, catamari_int).copy()
 
 
+def SampleLowerHermitianDPPBatch(kernel,
+                                 num_samples,
+                                 seed=None,
+                                 maximum_likelihood=False,
+                                 block_size=64):
+    """Draws independent samples from a Hermitian DPP's marginal kernel.
+
+    Unlike SampleLowerHermitianDPP, the kernel is neither copied by the
+    caller nor overwritten: each sample factors a private copy of its lower
+    triangle, and the samples are drawn concurrently by Catamari's threads.
+    The i'th sample uses the i'th random stream keyed by 'seed', so that no
+    generator is shared between concurrent calls and the result does not
+    depend upon the number of threads. Since the routine is called through
+    ctypes.CDLL, the GIL is released while it runs.
+
+    Args:
+      kernel (numpy.ndarray): The marginal kernel matrix. A Fortran-ordered
+          array (or a block of one) is read in place. So is a C-ordered
+          array, through its transpose, which, for a Hermitian kernel, is its
+          conjugate: it has the same pivots and thus the same samples.
+      num_samples (int): The number of samples to draw.
+      seed (int): The key of the random streams. If None, one is drawn from
+          numpy.random.
+      maximum_likelihood (bool): Whether maximum-likelihood samples are
+          desired.
+      block_size (int): The algorithmic block size of the factorization.
+
+    Returns:
+      A list of 'num_samples' numpy arrays containing the samples.
+    """
+    matrix = np.asarray(kernel)
+    if matrix.ndim != 2 or matrix.shape[0] != matrix.shape[1]:
+        raise ValueError('Expected a square kernel matrix.')
+    if not matrix.flags.f_contiguous and matrix.flags.c_contiguous:
+        matrix = matrix.T
+    if num_samples == 0:
+        return []
+    if seed is None:
+        seed = np.random.randint(np.iinfo(catamari_np_int).max)
+    suffix = numpy_dtype_to_suffix(matrix.dtype)
+    matrix_view = BlasMatrixView.from_numpy(matrix)
+
+    routine = getattr(lib, 'CatamariSampleLowerHermitianDPPBatch' + suffix)
+    routine.argtypes = [
+        catamari_int, c_bool, catamari_int, catamari_int,
+        POINTER(type(matrix_view.view)),
+        POINTER(BufferInt),
+        POINTER(BufferInt)
+    ]
+    offsets = BufferInt()
+    samples = BufferInt()
+    routine(catamari_int(block_size), c_bool(maximum_likelihood),
+            catamari_int(num_samples), catamari_int(seed),
+            ctypes.byref(matrix_view.view), ctypes.byref(offsets),
+            ctypes.byref(samples))
+
+    # Copy out of the C buffers once, and split the copy into views.
+    offsets_array = np.ctypeslib.as_array(offsets.data,
+                                          (offsets.size,)).copy()
+    if samples.size == 0:
+        samples_array = np.zeros(0, dtype=catamari_np_int)
+    else:
+        samples_array = np.ctypeslib.as_array(samples.data,
+                                              (samples.size,)).copy()
+    return np.split(samples_array, offsets_array[1:-1])
+
+
 def SampleNonHermitianDPP(matrix_view,
                           maximum_likelihood=False,
                           use_openmp=False,
@@ -445,6 +530,227 @@ def DPPLogLikelihood(matrix_view):
         raise ValueError('Invalid np.dtype for DPPLogLikelihood.')
 
 
+
+# The values of CatamariStatus.
+CATAMARI_SUCCESS = 0
+CATAMARI_INVALID_ARGUMENT = 1
+CATAMARI_FACTORIZATION_FAILURE = 2
+CATAMARI_INTERNAL_ERROR = 3
+
+# The values of CatamariSymmetricFactorizationType.
+CHOLESKY_FACTORIZATION = 0
+LDL_ADJOINT_FACTORIZATION = 1
+LDL_TRANSPOSE_FACTORIZATION = 2
+
+# The values of CatamariReorderingStrategy.
+MINIMUM_DEGREE_REORDERING = 0
+NESTED_DISSECTION_REORDERING = 1
+
+
+class SparseLDLControl(ctypes.Structure):
+    """An equivalent of the C structure CatamariSparseLDLControl."""
+    _fields_ = [('factorization_type', c_int), ('reordering_strategy', c_int),
+                ('triangle_storage', c_bool), ('verbose', c_bool)]
+    lib.CatamariSparseLDLControlInit.argtypes = [c_void_p]
+
+    def __init__(self):
+        lib.CatamariSparseLDLControlInit(ctypes.byref(self))
+
+
+class SparseLDLResult(ctypes.Structure):
+    """An equivalent of the C structure CatamariSparseLDLResult."""
+    _fields_ = [('num_successful_pivots', catamari_int),
+                ('num_positive_pivots', catamari_int),
+                ('num_negative_pivots', catamari_int),
+                ('largest_supernode', catamari_int),
+                ('num_factorization_entries', catamari_int),
+                ('num_factorization_flops', c_double)]
+
+
+def numpy_dtype_to_suffix(dtype):
+    """Converts a numpy.dtype into the suffix of the C routines' names."""
+    if dtype == np.float32:
+        return 'Float'
+    elif dtype == np.float64:
+        return 'Double'
+    elif dtype == np.complex64:
+        return 'ComplexFloat'
+    elif dtype == np.complex128:
+        return 'ComplexDouble'
+    else:
+        raise ValueError('Invalid numpy datatype')
+
+
+class SparseLDL(object):
+    """An analogue of catamari::SparseLDL<Field> over the C interface.
+
+    The compressed-sparse-column (or row) arrays of a scipy.sparse.csc_matrix
+    (or csr_matrix), or of any objects exposing the buffer protocol, are read
+    in place whenever their datatypes and layouts match those of Catamari (the
+    indices must be of type catamari_np_int), and are converted otherwise. The
+    right-hand sides of 'solve' are overwritten in place when they are
+    Fortran-contiguous and of the factorization's datatype. Since the routines
+    are called through ctypes.CDLL, the GIL is released while they run.
+    """
+
+    def __init__(self,
+                 dtype=np.float64,
+                 factorization_type=CHOLESKY_FACTORIZATION,
+                 reordering_strategy=MINIMUM_DEGREE_REORDERING,
+                 triangle_storage=False,
+                 verbose=False):
+        """Creates an empty factorization.
+
+        Args:
+          dtype (numpy.dtype): The datatype of the matrix entries.
+          factorization_type (int): One of the *_FACTORIZATION values.
+          reordering_strategy (int): One of the *_REORDERING values.
+          triangle_storage (bool): If only one triangle of the symmetric
+              matrix is stored.
+          verbose (bool): If progress information should be printed.
+        """
+        self.dtype = np.dtype(dtype)
+        suffix = numpy_dtype_to_suffix(self.dtype)
+        prefix = 'CatamariSparseLDL' + suffix
+        self._create = getattr(lib, prefix + 'Create')
+        self._destroy = getattr(lib, prefix + 'Destroy')
+        self._analyze = getattr(lib, prefix + 'Analyze')
+        self._refactor = getattr(lib, prefix + 'Refactor')
+        self._solve = getattr(lib, prefix + 'Solve')
+
+        self._create.argtypes = [POINTER(c_void_p)]
+        self._create.restype = c_int
+        self._destroy.argtypes = [POINTER(c_void_p)]
+        self._analyze.argtypes = [
+            c_void_p, POINTER(SparseLDLControl), catamari_int, c_void_p,
+            c_void_p, c_bool
+        ]
+        self._analyze.restype = c_int
+        self._refactor.argtypes = [
+            c_void_p, c_void_p, POINTER(SparseLDLResult)
+        ]
+        self._refactor.restype = c_int
+        self._solve.argtypes = [c_void_p, c_void_p]
+        self._solve.restype = c_int
+
+        self.control = SparseLDLControl()
+        self.control.factorization_type = factorization_type
+        self.control.reordering_strategy = reordering_strategy
+        self.control.triangle_storage = triangle_storage
+        self.control.verbose = verbose
+        self.result = SparseLDLResult()
+        self.num_rows = 0
+        self.num_entries = 0
+
+        self._handle = c_void_p()
+        status = self._create(ctypes.byref(self._handle))
+        if status != CATAMARI_SUCCESS:
+            raise MemoryError('Could not create a SparseLDL handle.')
+
+    def __del__(self):
+        if getattr(self, '_handle', None):
+            self._destroy(ctypes.byref(self._handle))
+
+    def _check(self, status, routine):
+        if status == CATAMARI_FACTORIZATION_FAILURE:
+            raise ArithmeticError(
+                '{} only had {} of {} successful pivots.'.format(
+                    routine, self.result.num_successful_pivots,
+                    self.num_rows))
+        elif status != CATAMARI_SUCCESS:
+            raise RuntimeError('{} failed with status {}.'.format(
+                routine, status))
+
+    def _values(self, data):
+        """Returns a contiguous array of the values, converting if needed."""
+        values = np.ascontiguousarray(np.asarray(data), dtype=self.dtype)
+        if values.ndim != 1 or values.shape[0] != self.num_entries:
+            raise ValueError('Expected {} values.'.format(self.num_entries))
+        return values
+
+    def analyze(self, matrix):
+        """Symbolically factors the pattern of a scipy.sparse matrix.
+
+        Args:
+          matrix (scipy.sparse.csc_matrix or csr_matrix): The matrix whose
+              pattern (and only its pattern) is analyzed.
+        """
+        if matrix.shape[0] != matrix.shape[1]:
+            raise ValueError('Expected a square matrix.')
+        if matrix.format == 'csc':
+            compressed_rows = False
+        elif matrix.format == 'csr':
+            compressed_rows = True
+        else:
+            raise ValueError('Expected a CSC or CSR matrix.')
+        offsets = np.ascontiguousarray(matrix.indptr, dtype=catamari_np_int)
+        indices = np.ascontiguousarray(matrix.indices, dtype=catamari_np_int)
+
+        self.num_rows = matrix.shape[0]
+        self.num_entries = int(offsets[-1])
+        status = self._analyze(self._handle, ctypes.byref(self.control),
+                               catamari_int(self.num_rows),
+                               offsets.ctypes.data, indices.ctypes.data,
+                               c_bool(compressed_rows))
+        self._check(status, 'Analyze')
+
+    def refactor(self, data):
+        """Numerically factors new values in the analyzed pattern.
+
+        Args:
+          data (array-like): The values, in the order of the 'indices' of the
+              analyzed matrix, e.g., the 'data' array of a scipy.sparse
+              matrix with the same pattern.
+
+        Returns:
+          The SparseLDLResult of the factorization.
+        """
+        values = self._values(data)
+        status = self._refactor(self._handle, values.ctypes.data,
+                                ctypes.byref(self.result))
+        self._check(status, 'Refactor')
+        return self.result
+
+    def factor(self, matrix):
+        """Analyzes the pattern of a scipy.sparse matrix and factors it.
+
+        Args:
+          matrix (scipy.sparse.csc_matrix or csr_matrix): The matrix.
+
+        Returns:
+          The SparseLDLResult of the factorization.
+        """
+        self.analyze(matrix)
+        return self.refactor(matrix.data)
+
+    def solve(self, right_hand_sides, overwrite=False):
+        """Solves against the last factorization.
+
+        Args:
+          right_hand_sides (numpy.ndarray): A vector or a matrix whose columns
+              are the right-hand sides.
+          overwrite (bool): If a Fortran-contiguous input of the
+              factorization's datatype should be overwritten with the
+              solution rather than copied.
+
+        Returns:
+          The solution, with the shape of the right-hand sides.
+        """
+        rhs = np.asarray(right_hand_sides)
+        if rhs.ndim not in (1, 2) or rhs.shape[0] != self.num_rows:
+            raise ValueError('Expected right-hand sides with {} rows.'.format(
+                self.num_rows))
+        if overwrite:
+            solution = np.asfortranarray(rhs, dtype=self.dtype)
+        else:
+            solution = np.array(rhs, dtype=self.dtype, order='F')
+        matrix = solution.reshape((self.num_rows, -1), order='F')
+
+        view = BlasMatrixView.from_numpy(matrix)
+        status = self._solve(self._handle, ctypes.byref(view.view))
+        self._check(status, 'Solve')
+        return solution
+
 if __name__ == '__main__':
     num_rows = 10000
     identity = np.identity(num_rows, dtype=np.complex128)
@@ -5,12 +5,17 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include <cstdint>
 #include <random>
 #include <vector>
 
+#include <tbb/parallel_for.h>
+
+#include "catamari/blas_matrix.hpp"
 #include "catamari/blas_matrix_view.hpp"
 #include "catamari/complex.hpp"
 #include "catamari/dense_dpp.hpp"
+#include "catamari/philox.hpp"
 
 #include "catamari.h"
 
@@ -66,6 +71,46 @@ catamari::BlasMatrixView<catamari::Complex<double>> BlasMatrixViewToCxx(
   return matrix_cxx;
 }
 
+// Concurrently draws independent samples from copies of the lower triangle of
+// the kernel, each from its own random stream, and returns them in the
+// compressed C format.
+template <typename Field>
+void SampleLowerHermitianDPPBatch(
+    catamari::Int block_size, bool maximum_likelihood,
+    catamari::Int num_samples, catamari::Int seed,
+    const catamari::ConstBlasMatrixView<Field>& matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples) {
+  const catamari::Int height = matrix.height;
+  std::vector<std::vector<catamari::Int>> samples_cxx(num_samples);
+  tbb::parallel_for(catamari::Int(0), num_samples, [&](catamari::Int index) {
+    // Only the lower triangle is read by the factorization.
+    catamari::BlasMatrix<Field> kernel;
+    kernel.Resize(height, height);
+    for (catamari::Int j = 0; j < height; ++j) {
+      for (catamari::Int i = j; i < height; ++i) {
+        kernel(i, j) = matrix(i, j);
+      }
+    }
+    catamari::PhiloxEngine generator(static_cast<std::uint64_t>(seed),
+                                     static_cast<std::uint32_t>(index));
+    samples_cxx[index] = catamari::SampleLowerHermitianDPP(
+        block_size, maximum_likelihood, &kernel.view, &generator);
+  });
+
+  std::vector<catamari::Int> offsets(num_samples + 1);
+  offsets[0] = 0;
+  for (catamari::Int index = 0; index < num_samples; ++index) {
+    offsets[index + 1] = offsets[index] + samples_cxx[index].size();
+  }
+  std::vector<catamari::Int> flattened;
+  flattened.reserve(offsets[num_samples]);
+  for (const std::vector<catamari::Int>& sample : samples_cxx) {
+    flattened.insert(flattened.end(), sample.begin(), sample.end());
+  }
+  VectorIntToC(offsets, sample_offsets);
+  VectorIntToC(flattened, samples);
+}
+
 }  // anonymous namespace
 
 void CatamariSampleLowerHermitianDPPFloat(CatamariInt block_size,
@@ -130,6 +175,42 @@ void CatamariSampleLowerHermitianDPPComplexDouble(
   VectorIntToC(sample_cxx, sample);
 }
 
+void CatamariSampleLowerHermitianDPPBatchFloat(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewFloat* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples) {
+  SampleLowerHermitianDPPBatch(block_size, maximum_likelihood, num_samples,
+                               seed, BlasMatrixViewToCxx(matrix).ToConst(),
+                               sample_offsets, samples);
+}
+
+void CatamariSampleLowerHermitianDPPBatchDouble(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewDouble* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples) {
+  SampleLowerHermitianDPPBatch(block_size, maximum_likelihood, num_samples,
+                               seed, BlasMatrixViewToCxx(matrix).ToConst(),
+                               sample_offsets, samples);
+}
+
+void CatamariSampleLowerHermitianDPPBatchComplexFloat(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewComplexFloat* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples) {
+  SampleLowerHermitianDPPBatch(block_size, maximum_likelihood, num_samples,
+                               seed, BlasMatrixViewToCxx(matrix).ToConst(),
+                               sample_offsets, samples);
+}
+
+void CatamariSampleLowerHermitianDPPBatchComplexDouble(
+    CatamariInt block_size, bool maximum_likelihood, CatamariInt num_samples,
+    CatamariInt seed, CatamariBlasMatrixViewComplexDouble* matrix,
+    CatamariBufferInt* sample_offsets, CatamariBufferInt* samples) {
+  SampleLowerHermitianDPPBatch(block_size, maximum_likelihood, num_samples,
+                               seed, BlasMatrixViewToCxx(matrix).ToConst(),
+                               sample_offsets, samples);
+}
+
 #ifdef CATAMARI_OPENMP
 void CatamariOpenMPSampleLowerHermitianDPPFloat(
     CatamariInt tile_size, CatamariInt block_size, bool maximum_likelihood,
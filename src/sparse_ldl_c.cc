@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include <exception>
+#include <new>
+
+#include "catamari/blas_matrix_view.hpp"
+#include "catamari/complex.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+#include "catamari.h"
+
+// The state behind each opaque handle: the factorization and the plan for
+// loading the values of the analyzed pattern into it.
+template <typename Field>
+struct CatamariSparseLDLHandle {
+  catamari::SparseLDL<Field> ldl;
+  catamari::ConversionPlan cplan;
+  catamari::Int num_rows = 0;
+  catamari::Int num_entries = 0;
+  bool analyzed = false;
+  bool factored = false;
+};
+
+struct CatamariSparseLDLFloat : public CatamariSparseLDLHandle<float> {};
+
+struct CatamariSparseLDLDouble : public CatamariSparseLDLHandle<double> {};
+
+struct CatamariSparseLDLComplexFloat
+    : public CatamariSparseLDLHandle<catamari::Complex<float>> {};
+
+struct CatamariSparseLDLComplexDouble
+    : public CatamariSparseLDLHandle<catamari::Complex<double>> {};
+
+namespace {
+
+template <typename Field>
+catamari::SparseLDLControl<Field> ControlToCxx(
+    const CatamariSparseLDLControl& control) {
+  catamari::SparseLDLControl<Field> control_cxx;
+  switch (control.factorization_type) {
+    case CatamariLDLAdjointFactorization:
+      control_cxx.SetFactorizationType(catamari::kLDLAdjointFactorization);
+      break;
+    case CatamariLDLTransposeFactorization:
+      control_cxx.SetFactorizationType(catamari::kLDLTransposeFactorization);
+      break;
+    default:
+      control_cxx.SetFactorizationType(catamari::kCholeskyFactorization);
+  }
+  control_cxx.reordering_strategy =
+      control.reordering_strategy == CatamariNestedDissectionReordering
+          ? catamari::kNestedDissectionReordering
+          : catamari::kMinimumDegreeReordering;
+  control_cxx.supernodal_strategy = catamari::kSupernodalFactorization;
+  control_cxx.verbose = control.verbose;
+  return control_cxx;
+}
+
+template <typename Field>
+void ResultToC(const catamari::SparseLDLResult<Field>& result_cxx,
+               CatamariSparseLDLResult* result) {
+  result->num_successful_pivots = result_cxx.num_successful_pivots;
+  result->num_positive_pivots = result_cxx.num_positive_pivots;
+  result->num_negative_pivots = result_cxx.num_negative_pivots;
+  result->largest_supernode = result_cxx.largest_supernode;
+  result->num_factorization_entries = result_cxx.num_factorization_entries;
+  result->num_factorization_flops = result_cxx.num_factorization_flops;
+}
+
+template <typename Field, typename MatrixViewC>
+catamari::BlasMatrixView<Field> BlasMatrixViewToCxx(MatrixViewC* matrix) {
+  catamari::BlasMatrixView<Field> matrix_cxx;
+  matrix_cxx.height = matrix->height;
+  matrix_cxx.width = matrix->width;
+  matrix_cxx.leading_dim = matrix->leading_dim;
+  matrix_cxx.data = reinterpret_cast<Field*>(matrix->data);
+  return matrix_cxx;
+}
+
+template <typename Handle>
+int Create(Handle** handle) {
+  if (!handle) return CatamariInvalidArgument;
+  *handle = new (std::nothrow) Handle;
+  return *handle ? CatamariSuccess : CatamariInternalError;
+}
+
+template <typename Handle>
+void Destroy(Handle** handle) {
+  if (!handle) return;
+  delete *handle;
+  *handle = nullptr;
+}
+
+// The symbolic analysis needs a coordinate matrix, so the pattern (with unit
+// values, and with a stored triangle mirrored into both) is expanded into a
+// temporary one which is freed before returning. The conversion plan is then
+// formed directly from the caller's arrays, so that the values of later
+// refactorizations are read in place.
+template <typename Field>
+int Analyze(CatamariSparseLDLHandle<Field>* handle,
+            const CatamariSparseLDLControl* control, catamari::Int num_rows,
+            const catamari::Int* offsets, const catamari::Int* indices,
+            bool compressed_rows) {
+  typedef catamari::Int Int;
+  if (!handle || !control || num_rows < 0 || !offsets ||
+      (offsets[num_rows] > 0 && !indices)) {
+    return CatamariInvalidArgument;
+  }
+  if (catamari::IsComplex<Field>::value && control->triangle_storage &&
+      control->factorization_type != CatamariLDLTransposeFactorization) {
+    // The mirrored entries of a triangle are not conjugated.
+    return CatamariInvalidArgument;
+  }
+  handle->analyzed = false;
+  handle->factored = false;
+
+  try {
+    const catamari::SparseLDLControl<Field> control_cxx =
+        ControlToCxx<Field>(*control);
+    {
+      catamari::CoordinateMatrix<Field> pattern;
+      pattern.Resize(num_rows, num_rows);
+      pattern.ReserveEntryAdditions(
+          (control->triangle_storage ? 2 : 1) * offsets[num_rows]);
+      for (Int j = 0; j < num_rows; ++j) {
+        for (Int index = offsets[j]; index < offsets[j + 1]; ++index) {
+          const Int i = indices[index];
+          if (i < 0 || i >= num_rows) return CatamariInvalidArgument;
+          pattern.QueueEntryAddition(i, j, Field{1});
+          if (control->triangle_storage && i != j) {
+            pattern.QueueEntryAddition(j, i, Field{1});
+          }
+        }
+      }
+      pattern.FlushEntryQueues();
+      handle->ldl.Factor(pattern, control_cxx, /* symbolic_only = */ true);
+    }
+    handle->ldl.FormConversionPlan(num_rows, offsets, indices, compressed_rows,
+                                   &handle->cplan);
+  } catch (const std::bad_alloc&) {
+    return CatamariInternalError;
+  } catch (const std::exception&) {
+    return CatamariInternalError;
+  }
+
+  handle->num_rows = num_rows;
+  handle->num_entries = offsets[num_rows];
+  handle->analyzed = true;
+  return CatamariSuccess;
+}
+
+template <typename Field, typename FieldC>
+int Refactor(CatamariSparseLDLHandle<Field>* handle, const FieldC* values,
+             CatamariSparseLDLResult* result) {
+  if (!handle || !handle->analyzed || (handle->num_entries > 0 && !values)) {
+    return CatamariInvalidArgument;
+  }
+  handle->factored = false;
+
+  catamari::SparseLDLResult<Field> result_cxx;
+  try {
+    result_cxx = handle->ldl.RefactorWithFixedSparsityPattern(
+        handle->cplan, reinterpret_cast<const Field*>(values));
+  } catch (const std::exception&) {
+    return CatamariInternalError;
+  }
+  if (result) ResultToC(result_cxx, result);
+
+  handle->factored = result_cxx.num_successful_pivots == handle->num_rows;
+  return handle->factored ? CatamariSuccess : CatamariFactorizationFailure;
+}
+
+template <typename Field, typename FieldC>
+int Factor(CatamariSparseLDLHandle<Field>* handle,
+           const CatamariSparseLDLControl* control, catamari::Int num_rows,
+           const catamari::Int* offsets, const catamari::Int* indices,
+           bool compressed_rows, const FieldC* values,
+           CatamariSparseLDLResult* result) {
+  const int status =
+      Analyze(handle, control, num_rows, offsets, indices, compressed_rows);
+  if (status != CatamariSuccess) return status;
+  return Refactor(handle, values, result);
+}
+
+template <typename Field, typename MatrixViewC>
+int Solve(const CatamariSparseLDLHandle<Field>* handle,
+          MatrixViewC* right_hand_sides) {
+  if (!handle || !handle->factored || !right_hand_sides ||
+      right_hand_sides->height != handle->num_rows ||
+      right_hand_sides->leading_dim < right_hand_sides->height) {
+    return CatamariInvalidArgument;
+  }
+
+  auto right_hand_sides_cxx = BlasMatrixViewToCxx<Field>(right_hand_sides);
+  try {
+    handle->ldl.Solve(&right_hand_sides_cxx);
+  } catch (const std::exception&) {
+    return CatamariInternalError;
+  }
+  return CatamariSuccess;
+}
+
+}  // anonymous namespace
+
+void CatamariSparseLDLControlInit(CatamariSparseLDLControl* control) {
+  control->factorization_type = CatamariCholeskyFactorization;
+  control->reordering_strategy = CatamariMinimumDegreeReordering;
+  control->triangle_storage = false;
+  control->verbose = false;
+}
+
+int CatamariSparseLDLFloatCreate(CatamariSparseLDLFloat** handle) {
+  return Create(handle);
+}
+
+void CatamariSparseLDLFloatDestroy(CatamariSparseLDLFloat** handle) {
+  Destroy(handle);
+}
+
+int CatamariSparseLDLFloatAnalyze(CatamariSparseLDLFloat* handle,
+                                  const CatamariSparseLDLControl* control,
+                                  CatamariInt num_rows,
+                                  const CatamariInt* offsets,
+                                  const CatamariInt* indices,
+                                  bool compressed_rows) {
+  return Analyze<float>(handle, control, num_rows, offsets, indices,
+                        compressed_rows);
+}
+
+int CatamariSparseLDLFloatRefactor(CatamariSparseLDLFloat* handle,
+                                   const float* values,
+                                   CatamariSparseLDLResult* result) {
+  return Refactor<float>(handle, values, result);
+}
+
+int CatamariSparseLDLFloatFactor(CatamariSparseLDLFloat* handle,
+                                 const CatamariSparseLDLControl* control,
+                                 CatamariInt num_rows,
+                                 const CatamariInt* offsets,
+                                 const CatamariInt* indices,
+                                 bool compressed_rows, const float* values,
+                                 CatamariSparseLDLResult* result) {
+  return Factor<float>(handle, control, num_rows, offsets, indices,
+                       compressed_rows, values, result);
+}
+
+int CatamariSparseLDLFloatSolve(const CatamariSparseLDLFloat* handle,
+                                CatamariBlasMatrixViewFloat* right_hand_sides) {
+  return Solve<float>(handle, right_hand_sides);
+}
+
+int CatamariSparseLDLDoubleCreate(CatamariSparseLDLDouble** handle) {
+  return Create(handle);
+}
+
+void CatamariSparseLDLDoubleDestroy(CatamariSparseLDLDouble** handle) {
+  Destroy(handle);
+}
+
+int CatamariSparseLDLDoubleAnalyze(CatamariSparseLDLDouble* handle,
+                                   const CatamariSparseLDLControl* control,
+                                   CatamariInt num_rows,
+                                   const CatamariInt* offsets,
+                                   const CatamariInt* indices,
+                                   bool compressed_rows) {
+  return Analyze<double>(handle, control, num_rows, offsets, indices,
+                         compressed_rows);
+}
+
+int CatamariSparseLDLDoubleRefactor(CatamariSparseLDLDouble* handle,
+                                    const double* values,
+                                    CatamariSparseLDLResult* result) {
+  return Refactor<double>(handle, values, result);
+}
+
+int CatamariSparseLDLDoubleFactor(CatamariSparseLDLDouble* handle,
+                                  const CatamariSparseLDLControl* control,
+                                  CatamariInt num_rows,
+                                  const CatamariInt* offsets,
+                                  const CatamariInt* indices,
+                                  bool compressed_rows, const double* values,
+                                  CatamariSparseLDLResult* result) {
+  return Factor<double>(handle, control, num_rows, offsets, indices,
+                        compressed_rows, values, result);
+}
+
+int CatamariSparseLDLDoubleSolve(
+    const CatamariSparseLDLDouble* handle,
+    CatamariBlasMatrixViewDouble* right_hand_sides) {
+  return Solve<double>(handle, right_hand_sides);
+}
+
+int CatamariSparseLDLComplexFloatCreate(
+    CatamariSparseLDLComplexFloat** handle) {
+  return Create(handle);
+}
+
+void CatamariSparseLDLComplexFloatDestroy(
+    CatamariSparseLDLComplexFloat** handle) {
+  Destroy(handle);
+}
+
+int CatamariSparseLDLComplexFloatAnalyze(
+    CatamariSparseLDLComplexFloat* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows) {
+  return Analyze<catamari::Complex<float>>(handle, control, num_rows, offsets,
+                                           indices, compressed_rows);
+}
+
+int CatamariSparseLDLComplexFloatRefactor(
+    CatamariSparseLDLComplexFloat* handle, const BlasComplexFloat* values,
+    CatamariSparseLDLResult* result) {
+  return Refactor<catamari::Complex<float>>(handle, values, result);
+}
+
+int CatamariSparseLDLComplexFloatFactor(
+    CatamariSparseLDLComplexFloat* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows, const BlasComplexFloat* values,
+    CatamariSparseLDLResult* result) {
+  return Factor<catamari::Complex<float>>(handle, control, num_rows, offsets,
+                                          indices, compressed_rows, values,
+                                          result);
+}
+
+int CatamariSparseLDLComplexFloatSolve(
+    const CatamariSparseLDLComplexFloat* handle,
+    CatamariBlasMatrixViewComplexFloat* right_hand_sides) {
+  return Solve<catamari::Complex<float>>(handle, right_hand_sides);
+}
+
+int CatamariSparseLDLComplexDoubleCreate(
+    CatamariSparseLDLComplexDouble** handle) {
+  return Create(handle);
+}
+
+void CatamariSparseLDLComplexDoubleDestroy(
+    CatamariSparseLDLComplexDouble** handle) {
+  Destroy(handle);
+}
+
+int CatamariSparseLDLComplexDoubleAnalyze(
+    CatamariSparseLDLComplexDouble* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows) {
+  return Analyze<catamari::Complex<double>>(handle, control, num_rows,
+                                            offsets, indices, compressed_rows);
+}
+
+int CatamariSparseLDLComplexDoubleRefactor(
+    CatamariSparseLDLComplexDouble* handle, const BlasComplexDouble* values,
+    CatamariSparseLDLResult* result) {
+  return Refactor<catamari::Complex<double>>(handle, values, result);
+}
+
+int CatamariSparseLDLComplexDoubleFactor(
+    CatamariSparseLDLComplexDouble* handle,
+    const CatamariSparseLDLControl* control, CatamariInt num_rows,
+    const CatamariInt* offsets, const CatamariInt* indices,
+    bool compressed_rows, const BlasComplexDouble* values,
+    CatamariSparseLDLResult* result) {
+  return Factor<catamari::Complex<double>>(handle, control, num_rows, offsets,
+                                           indices, compressed_rows, values,
+                                           result);
+}
+
+int CatamariSparseLDLComplexDoubleSolve(
+    const CatamariSparseLDLComplexDouble* handle,
+    CatamariBlasMatrixViewComplexDouble* right_hand_sides) {
+  return Solve<catamari::Complex<double>>(handle, right_hand_sides);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cstdint>
+#include <utility>
+#include "catamari/aligned_buffer.hpp"
+#include "catamari/complex.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::AlignedBuffer;
+using catamari::AllocationControl;
+using catamari::Int;
+
+namespace {
+
+// Returns true if the pointer is a multiple of the alignment.
+template <typename T>
+bool IsAligned(const T* pointer, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Alignment", "[Alignment]") {
+  for (const std::size_t alignment : {16, 64, 256, 4096}) {
+    AllocationControl control;
+    control.alignment = alignment;
+    for (const std::size_t size : {1, 3, 1000}) {
+      AlignedBuffer<double> buffer(control);
+      buffer.Resize(size);
+      REQUIRE(buffer.Size() == size);
+      REQUIRE(IsAligned(buffer.Data(), alignment));
+      for (std::size_t i = 0; i < size; ++i) buffer[i] = i;
+
+      // Copies are allocated with the same policy.
+      const AlignedBuffer<double> copy = buffer;
+      REQUIRE(IsAligned(copy.Data(), alignment));
+      for (std::size_t i = 0; i < size; ++i) REQUIRE(copy[i] == i);
+
+      // Moves transfer the allocation.
+      const double* data = buffer.Data();
+      AlignedBuffer<double> moved = std::move(buffer);
+      REQUIRE(moved.Data() == data);
+      REQUIRE(buffer.Empty());
+    }
+  }
+
+  // The alignment is raised to that of the entry type.
+  AllocationControl control;
+  control.alignment = 1;
+  AlignedBuffer<catamari::Complex<double>> buffer(control);
+  buffer.Resize(7);
+  REQUIRE(IsAligned(buffer.Data(), alignof(catamari::Complex<double>)));
+
+  buffer.Clear();
+  REQUIRE(buffer.Empty());
+  REQUIRE(buffer.Data() == nullptr);
+}
+
+TEST_CASE("Huge pages", "[Huge pages]") {
+  AllocationControl control;
+  control.huge_page_threshold = std::size_t(1) << 20;
+  AlignedBuffer<float> buffer(control);
+
+  // Small allocations keep the requested alignment...
+  buffer.Resize(1000);
+  REQUIRE(IsAligned(buffer.Data(), control.alignment));
+
+  // ...while large ones begin on a huge page.
+  buffer.Resize(3 << 20);
+  REQUIRE(IsAligned(buffer.Data(), catamari::kHugePageSize));
+  for (std::size_t i = 0; i < buffer.Size(); i += 4096) buffer[i] = 1.f;
+  buffer[buffer.Size() - 1] = 2.f;
+  REQUIRE(buffer[buffer.Size() - 1] == 2.f);
+}
+
+TEST_CASE("Padded leading dimensions", "[Padding]") {
+  AllocationControl control;
+  REQUIRE(catamari::PaddedLeadingDimension<double>(512, control) == 512);
+  REQUIRE(catamari::PaddedLeadingDimension<double>(0, control) == 1);
+
+  control.pad_leading_dimensions = true;
+  for (Int height = 1; height < 2000; ++height) {
+    const Int leading_dim =
+        catamari::PaddedLeadingDimension<double>(height, control);
+    REQUIRE(leading_dim >= height);
+    REQUIRE(leading_dim <= height + 15);
+    if (height > 1) {
+      REQUIRE((leading_dim * sizeof(double)) % control.alignment == 0);
+      REQUIRE((leading_dim * sizeof(double)) % 4096 != 0);
+    }
+  }
+  REQUIRE(catamari::PaddedLeadingDimension<double>(512, control) == 520);
+  REQUIRE(catamari::PaddedLeadingDimension<catamari::Complex<double>>(
+              250, control) == 252);
+}
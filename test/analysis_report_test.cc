@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+TEST_CASE("Laplacian", "[Laplacian]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 25, 0.1);
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_control.min_parallel_threshold = 0;
+  ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+  catamari::SparseLDL<double> ldl;
+  const catamari::supernodal_ldl::AnalysisReport report =
+      ldl.Analyze(matrix, ldl_control, 4, 8);
+  REQUIRE(report.num_rows == matrix.NumRows());
+  REQUIRE(report.num_supernodes > 0);
+  REQUIRE(report.num_factor_nonzeros >= matrix.NumRows());
+  REQUIRE(sizeof(double) * report.num_factor_nonzeros <=
+          report.memory.factor_bytes);
+  REQUIRE(report.Flops() == report.diagonal_flops + report.trsm_flops +
+                                report.herk_flops);
+  REQUIRE(report.herk_flops > 0);
+
+  const catamari::Buffer<Int>& histogram = report.supernode_size_histogram;
+  REQUIRE(std::accumulate(histogram.begin(), histogram.end(), Int(0)) ==
+          report.num_supernodes);
+
+  // The tree of a connected matrix is a single tree whose levels hold all of
+  // its supernodes.
+  REQUIRE(report.num_roots == 1);
+  REQUIRE(report.num_leaves > 1);
+  REQUIRE(report.tree_depth > 1);
+  REQUIRE(report.tree_width >= report.num_leaves / report.tree_depth);
+  REQUIRE(report.tree_depth * report.tree_width >= report.num_supernodes);
+  REQUIRE(report.critical_path_flops > 0);
+  REQUIRE(report.critical_path_flops <= report.Flops());
+  REQUIRE(report.Parallelism() >= 1);
+  REQUIRE(report.SpeedupBound(1) == 1);
+  REQUIRE(report.SpeedupBound(4) <= 4);
+
+  REQUIRE(report.memory.num_threads == 4);
+  REQUIRE(report.memory.num_right_hand_sides == 8);
+  REQUIRE(report.optimal_frontal_bytes > 0);
+  REQUIRE(report.solve_bytes >= 2. * report.memory.factor_bytes);
+  REQUIRE(report.SolveIntensity() > 0);
+
+  // The report matches the memory estimate of the same analysis.
+  const catamari::supernodal_ldl::MemoryEstimate estimate =
+      ldl.supernodal_factorization->EstimateMemory(4, 8);
+  REQUIRE(estimate.PeakBytes() == report.memory.PeakBytes());
+
+  std::ostringstream os;
+  os << report;
+  REQUIRE(!os.str().empty());
+}
+
+TEST_CASE("Diagonal", "[Diagonal]") {
+  // Each row of a diagonal matrix is its own tree, and a serial factorization
+  // only ever holds one (empty) Schur complement.
+  const Int num_rows = 20;
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(num_rows);
+  for (Int row = 0; row < num_rows; ++row) {
+    matrix.QueueEntryAddition(row, row, 1. + row);
+  }
+  matrix.FlushEntryQueues();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.supernodal_control.relaxation_control.relax_supernodes = false;
+  catamari::SparseLDL<double> ldl;
+  const catamari::supernodal_ldl::AnalysisReport report =
+      ldl.Analyze(matrix, ldl_control, 2);
+  REQUIRE(report.num_factor_nonzeros == num_rows);
+  REQUIRE(report.trsm_flops == 0);
+  REQUIRE(report.herk_flops == 0);
+  REQUIRE(report.num_roots == report.num_supernodes);
+  REQUIRE(report.num_leaves == report.num_supernodes);
+  REQUIRE(report.tree_depth == 1);
+  REQUIRE(report.tree_width == report.num_supernodes);
+  REQUIRE(report.optimal_frontal_bytes == 0);
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::CoordinateMatrix;
+using catamari::Int;
+
+namespace {
+
+enum Operation { kNormal, kTranspose, kAdjoint };
+
+// Returns a random sparse matrix with (at most) the given number of entries.
+template <typename Field>
+std::unique_ptr<CoordinateMatrix<Field>> RandomMatrix(Int num_rows,
+                                                      Int num_columns,
+                                                      Int num_entries,
+                                                      std::mt19937* generator) {
+  std::uniform_int_distribution<Int> row_dist(0, num_rows - 1);
+  std::uniform_int_distribution<Int> column_dist(0, num_columns - 1);
+  std::uniform_real_distribution<double> value_dist(-1., 1.);
+  Buffer<Int> rows(num_entries), columns(num_entries);
+  Buffer<Field> values(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    rows[index] = row_dist(*generator);
+    columns[index] = column_dist(*generator);
+    values[index] = Field(value_dist(*generator), value_dist(*generator));
+  }
+  return CoordinateMatrix<Field>::FromTriplets(num_rows, num_columns, rows,
+                                               columns, values);
+}
+
+// Checks the given sparse multiplication against a direct accumulation over
+// the entries.
+template <typename Field>
+void RunTest(Int num_rows, Int num_columns, Int num_entries, Int num_rhs,
+             Operation operation) {
+  std::mt19937 generator(num_rows + num_columns + num_rhs);
+  std::uniform_real_distribution<double> value_dist(-1., 1.);
+  std::unique_ptr<CoordinateMatrix<Field>> matrix =
+      RandomMatrix<Field>(num_rows, num_columns, num_entries, &generator);
+
+  const Int input_height = operation == kNormal ? num_columns : num_rows;
+  const Int result_height = operation == kNormal ? num_rows : num_columns;
+  BlasMatrix<Field> input, result;
+  input.Resize(input_height, num_rhs);
+  result.Resize(result_height, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < input_height; ++i) {
+      input(i, j) = Field(value_dist(generator), value_dist(generator));
+    }
+    for (Int i = 0; i < result_height; ++i) {
+      result(i, j) = Field(value_dist(generator), value_dist(generator));
+    }
+  }
+
+  const Field alpha(0.75, -0.25);
+  const Field beta(-0.5, 0.125);
+  BlasMatrix<Field> expected = result;
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < result_height; ++i) {
+      expected(i, j) *= beta;
+    }
+  }
+  for (const catamari::MatrixEntry<Field>& entry : matrix->Entries()) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      if (operation == kNormal) {
+        expected(entry.row, j) += alpha * entry.value * input(entry.column, j);
+      } else if (operation == kTranspose) {
+        expected(entry.column, j) += alpha * entry.value * input(entry.row, j);
+      } else {
+        expected(entry.column, j) +=
+            alpha * mantis::Conjugate(entry.value) * input(entry.row, j);
+      }
+    }
+  }
+
+  if (operation == kNormal) {
+    catamari::ApplySparse(alpha, *matrix, input.ConstView(), beta,
+                          &result.view);
+  } else if (operation == kTranspose) {
+    catamari::ApplyTransposeSparse(alpha, *matrix, input.ConstView(), beta,
+                                   &result.view);
+  } else {
+    catamari::ApplyAdjointSparse(alpha, *matrix, input.ConstView(), beta,
+                                 &result.view);
+  }
+
+  double error = 0;
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < result_height; ++i) {
+      error = std::max(error, double(std::abs(result(i, j) - expected(i, j))));
+    }
+  }
+  REQUIRE(error <= 1e-12);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Small", "[Small]") {
+  typedef mantis::Complex<double> Field;
+  for (Operation operation : {kNormal, kTranspose, kAdjoint}) {
+    RunTest<Field>(30, 20, 200, 1, operation);
+    RunTest<Field>(20, 30, 200, 3, operation);
+  }
+}
+
+// These are large enough to be split over multiple threads.
+TEST_CASE("Large", "[Large]") {
+  typedef mantis::Complex<double> Field;
+  for (Operation operation : {kNormal, kTranspose, kAdjoint}) {
+    RunTest<Field>(4000, 3000, 200000, 1, operation);
+    RunTest<Field>(3000, 4000, 200000, 4, operation);
+
+    // Leave many of the rows empty.
+    RunTest<Field>(400000, 4000, 200000, 2, operation);
+  }
+}
+
+// Each row sums 2^60 + (i + 1) - 2^60, whose double-precision accumulation
+// loses the small term, so the higher-precision products must be exact.
+TEST_CASE("Promoted", "[Promoted]") {
+  typedef catamari::Promote<double> Scalar;
+  const double big = std::ldexp(1., 60);
+  for (const Int num_rows : {10, 40000}) {
+    const Int num_columns = num_rows + 2;
+    CoordinateMatrix<double> matrix;
+    matrix.Resize(num_rows, num_columns);
+    matrix.ReserveEntryAdditions(3 * num_rows);
+    for (Int i = 0; i < num_rows; ++i) {
+      matrix.QueueEntryAddition(i, 0, 1.);
+      matrix.QueueEntryAddition(i, i + 1, 1.);
+      matrix.QueueEntryAddition(i, num_columns - 1, -1.);
+    }
+    matrix.FlushEntryQueues();
+
+    BlasMatrix<Scalar> input(num_columns, 1), result(num_rows, 1);
+    input(0) = input(num_columns - 1) = Scalar(big);
+    for (Int i = 0; i < num_rows; ++i) {
+      input(i + 1) = Scalar(i + 1.);
+      result(i) = Scalar(0.);
+    }
+    catamari::ApplySparse(Scalar(1.), matrix, input.ConstView(), Scalar(0.),
+                          &result.view);
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(result(i).Upper() == i + 1.);
+      REQUIRE(result(i).Lower() == 0.);
+    }
+
+    // The transpose scatters the same cancellation into the first column.
+    BlasMatrix<Scalar> transpose_input(num_rows, 1);
+    BlasMatrix<Scalar> transpose_result(num_columns, 1);
+    for (Int i = 0; i < num_rows; ++i) {
+      transpose_input(i) = Scalar(0.);
+    }
+    transpose_input(0) = Scalar(big);
+    transpose_input(1) = Scalar(1.);
+    transpose_input(num_rows - 1) = Scalar(-big);
+    for (Int i = 0; i < num_columns; ++i) {
+      transpose_result(i) = Scalar(0.);
+    }
+    catamari::ApplyTransposeSparse(Scalar(1.), matrix,
+                                   transpose_input.ConstView(), Scalar(0.),
+                                   &transpose_result.view);
+    REQUIRE(transpose_result(0).Upper() == 1.);
+    REQUIRE(transpose_result(0).Lower() == 0.);
+  }
+}
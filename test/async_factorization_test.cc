@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <vector>
+
+#include <tbb/task_arena.h>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+TEST_CASE("Concurrent factorizations", "[Concurrent factorizations]") {
+  const Int num_factorizations = 4;
+  tbb::task_arena arena;
+
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+
+  std::vector<catamari::CoordinateMatrix<double>> matrices;
+  for (Int index = 0; index < num_factorizations; ++index) {
+    const Int num_x_elements = 30 + 5 * index;
+    matrices.push_back(
+        ShiftedLaplacian(num_x_elements, num_x_elements, 0.5 + index));
+  }
+  std::vector<catamari::SparseLDL<double>> ldls(num_factorizations);
+  std::vector<std::future<catamari::SparseLDLResult<double>>> futures;
+  for (Int index = 0; index < num_factorizations; ++index) {
+    futures.push_back(
+        ldls[index].FactorAsync(&arena, matrices[index], control));
+  }
+  for (Int index = 0; index < num_factorizations; ++index) {
+    const catamari::SparseLDLResult<double> result = futures[index].get();
+    REQUIRE(result.num_successful_pivots == matrices[index].NumRows());
+    REQUIRE(RelativeResidual(matrices[index], ldls[index]) < 1e-12);
+  }
+
+  // Overlap the assembly of the next matrix with the refactorization.
+  const catamari::CoordinateMatrix<double> refactor_matrix =
+      ShiftedLaplacian(30, 30, 2.);
+  std::future<catamari::SparseLDLResult<double>> refactor_future =
+      ldls[0].RefactorAsync(&arena, refactor_matrix);
+  const catamari::CoordinateMatrix<double> next_matrix =
+      ShiftedLaplacian(30, 30, 3.);
+  REQUIRE(refactor_future.get().num_successful_pivots ==
+          refactor_matrix.NumRows());
+  REQUIRE(RelativeResidual(refactor_matrix, ldls[0]) < 1e-12);
+
+  refactor_future = ldls[0].RefactorAsync(&arena, next_matrix, control);
+  REQUIRE(refactor_future.get().num_successful_pivots ==
+          next_matrix.NumRows());
+  REQUIRE(RelativeResidual(next_matrix, ldls[0]) < 1e-12);
+}
+
+TEST_CASE("Plan refactorization", "[Plan refactorization]") {
+  tbb::task_arena arena;
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 40, 1.);
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.FactorAsync(&arena, matrix, control, true).get()
+              .num_successful_pivots >= 0);
+
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<double> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+  const catamari::SparseLDLResult<double> result =
+      ldl.RefactorAsync(&arena, cplan, values.Data()).get();
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) < 1e-12);
+}
+
+TEST_CASE("Errors", "[Errors]") {
+  tbb::task_arena arena;
+  catamari::CoordinateMatrix<double> matrix = ShiftedLaplacian(10, 10, 1.);
+  catamari::SparseLDLControl<double> control;
+  control.block_size = 3;
+  catamari::SparseLDL<double> ldl;
+  std::future<catamari::SparseLDLResult<double>> future =
+      ldl.FactorAsync(&arena, matrix, control);
+  REQUIRE_THROWS(future.get());
+}
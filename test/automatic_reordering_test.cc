@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari::OrderingCache;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns the identity ordering of the given size.
+catamari::SymmetricOrdering IdentityOrdering(Int num_rows) {
+  catamari::SymmetricOrdering ordering;
+  ordering.permutation.Resize(num_rows);
+  std::iota(ordering.permutation.begin(), ordering.permutation.end(), Int(0));
+  ordering.inverse_permutation = ordering.permutation;
+  return ordering;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Dense estimate", "[Dense estimate]") {
+  const Int num_rows = 20;
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(num_rows * num_rows);
+  for (Int i = 0; i < num_rows; ++i) {
+    for (Int j = 0; j < num_rows; ++j) {
+      matrix.QueueEntryAddition(i, j, i == j ? num_rows : 1.);
+    }
+  }
+  matrix.FlushEntryQueues();
+
+  // A dense matrix forms a single supernode whose columns are each updated by
+  // all of the later ones.
+  const catamari::ReorderingEstimate estimate =
+      catamari::EstimateReordering(matrix, IdentityOrdering(num_rows));
+  double num_flops = 0;
+  for (Int j = 0; j < num_rows; ++j) {
+    const double degree = num_rows - 1 - j;
+    num_flops += degree * degree + degree;
+  }
+  REQUIRE(estimate.num_nonzeros == num_rows * (num_rows + 1) / 2);
+  REQUIRE(estimate.num_flops == num_flops);
+  REQUIRE(std::abs(estimate.critical_path_flops - num_flops / num_rows) <=
+          1e-10 * num_flops);
+  REQUIRE(estimate.Cost(1) == num_flops + estimate.critical_path_flops);
+}
+
+TEST_CASE("Tridiagonal estimate", "[Tridiagonal estimate]") {
+  const Int num_rows = 50;
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(3 * num_rows);
+  for (Int i = 0; i < num_rows; ++i) {
+    matrix.QueueEntryAddition(i, i, 2.);
+    if (i > 0) matrix.QueueEntryAddition(i, i - 1, -1.);
+    if (i < num_rows - 1) matrix.QueueEntryAddition(i, i + 1, -1.);
+  }
+  matrix.FlushEntryQueues();
+
+  // The natural ordering of a path is a chain of singleton supernodes (other
+  // than the trailing pair), so its critical path carries nearly every flop.
+  const catamari::ReorderingEstimate estimate =
+      catamari::EstimateReordering(matrix, IdentityOrdering(num_rows));
+  REQUIRE(estimate.num_nonzeros == 2 * num_rows - 1);
+  REQUIRE(estimate.num_flops == 2 * (num_rows - 1));
+  REQUIRE(estimate.critical_path_flops == 2 * (num_rows - 2) + 1);
+}
+
+TEST_CASE("Automatic factorization", "[Automatic factorization]") {
+  OrderingCache& cache = OrderingCache::Global();
+  cache.Clear();
+  const OrderingCache::Statistics initial = cache.LookupStatistics();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.reordering_strategy = catamari::kAutomaticReordering;
+  ldl_control.cache_orderings = true;
+
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 40, 1.);
+  const catamari::CoordinateMatrix<double> shifted =
+      ShiftedLaplacian(40, 40, 2.);
+  catamari::SparseLDL<double> ldl;
+  ldl_control.reordering_num_threads = 1;
+  REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots ==
+          matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  // The selection is cached along with the thread count it was made for.
+  REQUIRE(ldl.Factor(shifted, ldl_control).num_successful_pivots ==
+          shifted.NumRows());
+  REQUIRE(RelativeResidual(shifted, ldl) <= tolerance);
+  OrderingCache::Statistics statistics = cache.LookupStatistics();
+  REQUIRE(statistics.num_misses == initial.num_misses + 1);
+  REQUIRE(statistics.num_hits == initial.num_hits + 1);
+
+  ldl_control.reordering_num_threads = 64;
+  ldl.Factor(matrix, ldl_control);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  REQUIRE(cache.NumOrderings() == 2);
+
+  // The block path selects amongst orderings of the graph of the nodes.
+  ldl_control.block_size = 2;
+  ldl_control.reordering_num_threads = 0;
+  ldl.Factor(matrix, ldl_control);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  REQUIRE(cache.NumOrderings() == 3);
+  cache.Clear();
+}
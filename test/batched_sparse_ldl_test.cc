@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+
+namespace {
+
+// The compressed-sparse-column pattern of the lower triangle of the 5-point
+// stencil over an 'n x n' grid.
+struct Pattern {
+  Int num_rows;
+  std::vector<Int> offsets;
+  std::vector<Int> indices;
+};
+
+Pattern LowerLaplacianPattern(Int n) {
+  Pattern pattern;
+  pattern.num_rows = n * n;
+  pattern.offsets.push_back(0);
+  for (Int y = 0; y < n; ++y) {
+    for (Int x = 0; x < n; ++x) {
+      const Int column = x + y * n;
+      pattern.indices.push_back(column);
+      if (x < n - 1) pattern.indices.push_back(column + 1);
+      if (y < n - 1) pattern.indices.push_back(column + n);
+      pattern.offsets.push_back(pattern.indices.size());
+    }
+  }
+  return pattern;
+}
+
+// Returns the value of entry 'index' of system 'item', which forms a shifted
+// negative Laplacian whose off-diagonal couplings vary with the item.
+template <typename Field>
+Field EntryValue(const Pattern& pattern, Int item, Int index, Int column,
+                 catamari::SymmetricFactorizationType type) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real scale = Real(1) + Real(item % 7) / Real(10);
+  if (pattern.indices[index] == column) {
+    // Indefinite systems have a negative diagonal over half of the grid.
+    const bool negate = type != catamari::kCholeskyFactorization &&
+                        2 * column >= pattern.num_rows;
+    const Real value = Real(5) * scale;
+    return Field(negate ? -value : value);
+  }
+  return Field(-scale - Real(index % 3) / Real(10));
+}
+
+// Returns a copy of system 'item' of the batch.
+template <typename Field>
+catamari::CoordinateMatrix<Field> ItemMatrix(
+    const Pattern& pattern, Int item, const Buffer<Field>& values,
+    Int batch_size, catamari::SymmetricFactorizationType type) {
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(pattern.num_rows, pattern.num_rows);
+  matrix.ReserveEntryAdditions(2 * pattern.indices.size());
+  for (Int column = 0; column < pattern.num_rows; ++column) {
+    for (Int index = pattern.offsets[column];
+         index < pattern.offsets[column + 1]; ++index) {
+      const Int row = pattern.indices[index];
+      const Field value = values[item + index * batch_size];
+      matrix.QueueEntryAddition(row, column, value);
+      if (row != column) {
+        const Field mirrored_value =
+            type == catamari::kLDLTransposeFactorization
+                ? value
+                : catamari::Conjugate(value);
+        matrix.QueueEntryAddition(column, row, mirrored_value);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType type, Int lanes_per_task) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Pattern pattern = LowerLaplacianPattern(6);
+  const Int num_rows = pattern.num_rows;
+  const Int num_entries = pattern.indices.size();
+  const Int batch_size = 37;
+
+  catamari::BatchedSparseLDLControl<Field> control;
+  control.ldl_control.SetFactorizationType(type);
+  control.lanes_per_task = lanes_per_task;
+
+  catamari::BatchedSparseLDL<Field> batched_ldl;
+  batched_ldl.Analyze(num_rows, pattern.offsets.data(),
+                      pattern.indices.data(), false, batch_size, control);
+  REQUIRE(batched_ldl.NumRows() == num_rows);
+  REQUIRE(batched_ldl.BatchSize() == batch_size);
+
+  Buffer<Field> values(num_entries * batch_size);
+  for (Int column = 0; column < num_rows; ++column) {
+    for (Int index = pattern.offsets[column];
+         index < pattern.offsets[column + 1]; ++index) {
+      for (Int item = 0; item < batch_size; ++item) {
+        values[item + index * batch_size] =
+            EntryValue<Field>(pattern, item, index, column, type);
+      }
+    }
+  }
+  Buffer<Int> num_successful_pivots;
+  REQUIRE(batched_ldl.Factor(values.Data(), &num_successful_pivots) ==
+          batch_size);
+  for (Int item = 0; item < batch_size; ++item) {
+    REQUIRE(num_successful_pivots[item] == num_rows);
+  }
+
+  BlasMatrix<Field> right_hand_sides;
+  right_hand_sides.Resize(batch_size, num_rows);
+  for (Int row = 0; row < num_rows; ++row) {
+    for (Int item = 0; item < batch_size; ++item) {
+      right_hand_sides(item, row) = Field(Real(1) + Real((item + row) % 5));
+    }
+  }
+  BlasMatrix<Field> solutions = right_hand_sides;
+  batched_ldl.Solve(&solutions.view);
+
+  // Each solution matches that of an individual factorization.
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(type);
+  for (Int item = 0; item < batch_size; ++item) {
+    const catamari::CoordinateMatrix<Field> matrix =
+        ItemMatrix(pattern, item, values, batch_size, type);
+    catamari::SparseLDL<Field> ldl;
+    const catamari::SparseLDLResult<Field> result =
+        ldl.Factor(matrix, ldl_control);
+    REQUIRE(result.num_successful_pivots == num_rows);
+
+    BlasMatrix<Field> solution;
+    solution.Resize(num_rows, 1);
+    for (Int row = 0; row < num_rows; ++row) {
+      solution(row, 0) = right_hand_sides(item, row);
+    }
+    ldl.Solve(&solution.view);
+    for (Int row = 0; row < num_rows; ++row) {
+      REQUIRE(std::abs(solution(row, 0) - solutions(item, row)) <=
+              Real(1e-10) * (Real(1) + std::abs(solution(row, 0))));
+    }
+  }
+
+  // A Cholesky factorization of a negated system fails in that system only.
+  if (type == catamari::kCholeskyFactorization) {
+    const Int failed_item = batch_size / 2;
+    for (Int index = 0; index < num_entries; ++index) {
+      values[failed_item + index * batch_size] *= Real(-1);
+    }
+    REQUIRE(batched_ldl.Factor(values.Data(), &num_successful_pivots) ==
+            batch_size - 1);
+    for (Int item = 0; item < batch_size; ++item) {
+      if (item == failed_item) {
+        REQUIRE(num_successful_pivots[item] < num_rows);
+      } else {
+        REQUIRE(num_successful_pivots[item] == num_rows);
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Double Cholesky", "[Double Cholesky]") {
+  RunTest<double>(catamari::kCholeskyFactorization, 8);
+}
+
+TEST_CASE("Double LDL^T", "[Double LDL^T]") {
+  RunTest<double>(catamari::kLDLTransposeFactorization, 64);
+}
+
+TEST_CASE("Complex LDL^H", "[Complex LDL^H]") {
+  RunTest<catamari::Complex<double>>(catamari::kLDLAdjointFactorization, 5);
+}
+
+TEST_CASE("Complex LDL^T", "[Complex LDL^T]") {
+  RunTest<catamari::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                     16);
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/reduced_precision.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::ConstBlasMatrixView;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeDifference;
+using catamari_test::RightHandSides;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns sparse-direct controls which compress every supernode of at least
+// 16 columns into 16 x 16 tiles.
+template <typename Field>
+catamari::SparseLDLControl<Field> CompressedControl(
+    catamari::SymmetricFactorizationType factorization_type,
+    double tolerance) {
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  catamari::supernodal_ldl::BlockLowRankControl& block_low_rank =
+      ldl_control.supernodal_control.block_low_rank;
+  block_low_rank.enabled = true;
+  block_low_rank.min_supernode_size = 16;
+  block_low_rank.tile_size = 16;
+  block_low_rank.tolerance = tolerance;
+  return ldl_control;
+}
+
+// Factors a matrix with and without the compression at a tight tolerance,
+// then refactors both with a different shift, and returns the maximum
+// relative difference between their single-threaded and four-threaded
+// solutions.
+template <typename Field>
+catamari::ComplexBase<Field> RunAccuracyTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, const Field& refactor_shift, Int num_rhs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(12, 11, 10, shift);
+  const catamari::CoordinateMatrix<Field> refactor_matrix =
+      ShiftedLaplacian(12, 11, 10, refactor_shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> compressed_control =
+      CompressedControl<Field>(factorization_type, 1e-13);
+  catamari::SparseLDLControl<Field> ldl_control = compressed_control;
+  ldl_control.supernodal_control.block_low_rank.enabled = false;
+
+  tbb::task_arena arena(4);
+  tbb::task_arena serial_arena(1);
+  catamari::SparseLDL<Field> ldl, compressed_ldl;
+  arena.execute([&]() {
+    REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots == num_rows);
+    const catamari::SparseLDLResult<Field> result =
+        compressed_ldl.Factor(matrix, compressed_control);
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(result.num_compressed_supernodes > 0);
+  });
+
+  Real max_difference = 0;
+  for (Int factorization = 0; factorization < 2; ++factorization) {
+    if (factorization == 1) {
+      // The compressed factor must be expanded for the refactorization.
+      arena.execute([&]() {
+        REQUIRE(ldl.RefactorWithFixedSparsityPattern(refactor_matrix)
+                    .num_successful_pivots == num_rows);
+        const catamari::SparseLDLResult<Field> result =
+            compressed_ldl.RefactorWithFixedSparsityPattern(refactor_matrix);
+        REQUIRE(result.num_successful_pivots == num_rows);
+        REQUIRE(result.num_compressed_supernodes > 0);
+      });
+    }
+
+    BlasMatrix<Field> reference;
+    RightHandSides(num_rows, num_rhs, &reference);
+    serial_arena.execute([&]() { ldl.Solve(&reference.view); });
+
+    for (tbb::task_arena* solve_arena : {&serial_arena, &arena}) {
+      BlasMatrix<Field> solution;
+      RightHandSides(num_rows, num_rhs, &solution);
+      solve_arena->execute([&]() { compressed_ldl.Solve(&solution.view); });
+      max_difference = std::max(
+          max_difference, RelativeDifference(solution.view, reference.view));
+    }
+  }
+  return max_difference;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Tile compression", "[Tile]") {
+  typedef catamari::Complex<double> Field;
+  const Int height = 40;
+  const Int width = 30;
+  BlasMatrix<Field> tile(height, width);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      tile(i, j) = Field(1. / (1. + std::abs(i + 50. - j)), 1. / (2. + i + j));
+    }
+  }
+
+  for (const double tolerance : {1e-2, 1e-6, 1e-12}) {
+    catamari::supernodal_ldl::LowRankTile<Field> compressed;
+    catamari::supernodal_ldl::CompressTile(tile.ConstView(), tolerance,
+                                           &compressed);
+    REQUIRE(compressed.rank >= 0);
+    REQUIRE(compressed.rank * (height + width) < height * width);
+
+    double error_squared = 0;
+    double norm_squared = 0;
+    for (Int j = 0; j < width; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        Field approximation = 0;
+        for (Int k = 0; k < compressed.rank; ++k) {
+          approximation += compressed.u(i, k) * compressed.w(k, j);
+        }
+        error_squared += std::pow(std::abs(approximation - tile(i, j)), 2.);
+        norm_squared += std::pow(std::abs(tile(i, j)), 2.);
+      }
+    }
+    REQUIRE(std::sqrt(error_squared / norm_squared) <= 1.01 * tolerance);
+  }
+
+  // An exact approximation of a full-rank tile does not save storage.
+  catamari::supernodal_ldl::LowRankTile<Field> dense;
+  catamari::supernodal_ldl::CompressTile(tile.ConstView(), 0., &dense);
+  REQUIRE(dense.rank == -1);
+}
+
+TEST_CASE("Accurate Cholesky", "[Cholesky]") {
+  const double tolerance = 1e-9;
+  REQUIRE(RunAccuracyTest<double>(catamari::kCholeskyFactorization, 0.1, 0.3,
+                                  1) <= tolerance);
+  REQUIRE(RunAccuracyTest<double>(catamari::kCholeskyFactorization, 0.1, 0.3,
+                                  5) <= tolerance);
+}
+
+TEST_CASE("Accurate Adjoint", "[Adjoint]") {
+  const double tolerance = 1e-9;
+  REQUIRE(RunAccuracyTest<catamari::Complex<double>>(
+              catamari::kLDLAdjointFactorization,
+              catamari::Complex<double>(-1., 0.),
+              catamari::Complex<double>(-2., 0.), 3) <= tolerance);
+}
+
+TEST_CASE("Accurate Transpose", "[Transpose]") {
+  const double tolerance = 1e-9;
+  REQUIRE(RunAccuracyTest<catamari::Complex<double>>(
+              catamari::kLDLTransposeFactorization,
+              catamari::Complex<double>(-1., 0.5),
+              catamari::Complex<double>(-2., 0.25), 4) <= tolerance);
+}
+
+TEST_CASE("Preconditioner", "[Preconditioner]") {
+  typedef double Field;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(16, 16, 16, 0.);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result = ldl.Factor(
+      matrix, CompressedControl<Field>(catamari::kCholeskyFactorization, 1e-4));
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_compressed_supernodes > 0);
+  REQUIRE(result.num_low_rank_entries < result.num_compressed_block_entries);
+
+  // The compressed factorization no longer solves the system directly, but
+  // iterative refinement quickly recovers the solution.
+  catamari::RefinedSolveControl<Field> refined_solve_control;
+  refined_solve_control.relative_tol = 1e-10;
+  refined_solve_control.max_iters = 20;
+  BlasMatrix<Field> solution;
+  RightHandSides(num_rows, 2, &solution);
+  const catamari::RefinedSolveStatus<Field> status =
+      ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+  REQUIRE(status.residual_relative_max_norm <= 1e-10);
+  REQUIRE(status.num_iterations > 0);
+
+  // Operations which require the dense subdiagonal blocks are rejected.
+  Buffer<Field> diagonal;
+  REQUIRE_THROWS(ldl.InverseDiagonal(&diagonal));
+}
+
+TEST_CASE("Reduced precision conversions", "[Conversions]") {
+  // Every finite half and bfloat16 survives a round trip through float.
+  for (std::uint32_t bits = 0; bits < 65536; ++bits) {
+    const std::uint16_t value = static_cast<std::uint16_t>(bits);
+    if ((value & 0x7c00u) != 0x7c00u) {
+      REQUIRE(catamari::FloatToHalf(catamari::HalfToFloat(value)) == value);
+    }
+    if ((value & 0x7f80u) != 0x7f80u) {
+      REQUIRE(catamari::FloatToBFloat16(catamari::BFloat16ToFloat(value)) ==
+              value);
+    }
+  }
+
+  // Ties round to even.
+  auto half_round = [](float value) {
+    return catamari::HalfToFloat(catamari::FloatToHalf(value));
+  };
+  auto bfloat16_round = [](float value) {
+    return catamari::BFloat16ToFloat(catamari::FloatToBFloat16(value));
+  };
+  REQUIRE(half_round(1.f + std::ldexp(1.f, -11)) == 1.f);
+  REQUIRE(half_round(1.f + std::ldexp(3.f, -11)) == 1.f + std::ldexp(1.f, -9));
+  REQUIRE(bfloat16_round(1.f + std::ldexp(1.f, -8)) == 1.f);
+  REQUIRE(bfloat16_round(1.f + std::ldexp(3.f, -8)) ==
+          1.f + std::ldexp(1.f, -6));
+
+  // Subnormal halves are kept, and overflows become infinite.
+  REQUIRE(half_round(std::ldexp(1.f, -24)) == std::ldexp(1.f, -24));
+  REQUIRE(half_round(-std::ldexp(1.f, -25)) == 0.f);
+  REQUIRE(half_round(65504.f) == 65504.f);
+  REQUIRE(std::isinf(half_round(65520.f)));
+  REQUIRE(std::isnan(half_round(std::numeric_limits<float>::quiet_NaN())));
+  REQUIRE(
+      std::isnan(bfloat16_round(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST_CASE("Reduced precision multiplies", "[Reduced multiplies]") {
+  typedef catamari::Complex<double> Field;
+  const Int height = 37;
+  const Int width = 23;
+  const Int num_rhs = 3;
+  BlasMatrix<Field> matrix(height, width);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      // Vary the column scales well beyond the range of half precision.
+      matrix(i, j) = std::pow(10., j - 10.) *
+                     Field(std::cos(1. + i * j), std::sin(2. * i + j));
+    }
+  }
+  BlasMatrix<Field> normal_input(width, num_rhs);
+  BlasMatrix<Field> adjoint_input(height, num_rhs);
+  for (Int k = 0; k < num_rhs; ++k) {
+    for (Int j = 0; j < width; ++j) {
+      normal_input(j, k) = Field(std::pow(10., 10. - j), k - 1.);
+    }
+    for (Int i = 0; i < height; ++i) {
+      adjoint_input(i, k) = Field(std::sin(1. * i * k), 1.);
+    }
+  }
+
+  for (const catamari::StoragePrecision precision :
+       {catamari::kHalfPrecision, catamari::kBFloat16Precision}) {
+    const double tolerance =
+        precision == catamari::kHalfPrecision ? 2e-3 : 2e-2;
+    catamari::ReducedPrecisionMatrix<Field> reduced;
+    reduced.Assign(precision, matrix.ConstView());
+    REQUIRE(reduced.NumBytes() ==
+            2 * height * width * sizeof(std::uint16_t) +
+                width * sizeof(double));
+    Buffer<Field> workspace;
+
+    for (Int mode = 0; mode < 3; ++mode) {
+      const bool normal = mode == 0;
+      const ConstBlasMatrixView<Field> input =
+          normal ? normal_input.ConstView() : adjoint_input.ConstView();
+      BlasMatrix<Field> output(normal ? height : width, num_rhs, Field{1});
+      BlasMatrix<Field> reference = output;
+      const Field alpha(0.5, -2.);
+      if (mode == 0) {
+        reduced.MultiplyNormal(alpha, input, &output.view, &workspace);
+        catamari::MatrixMultiplyNormalNormal(alpha, matrix.ConstView(), input,
+                                             Field{1}, &reference.view);
+      } else if (mode == 1) {
+        reduced.MultiplyAdjoint(alpha, input, &output.view, &workspace);
+        catamari::MatrixMultiplyAdjointNormal(alpha, matrix.ConstView(), input,
+                                              Field{1}, &reference.view);
+      } else {
+        reduced.MultiplyTranspose(alpha, input, &output.view, &workspace);
+        catamari::MatrixMultiplyTransposeNormal(
+            alpha, matrix.ConstView(), input, Field{1}, &reference.view);
+      }
+      REQUIRE(RelativeDifference(output.view, reference.view) <= tolerance);
+    }
+
+    for (Int j = 0; j < width; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        REQUIRE(std::abs(reduced.Entry(i, j) - matrix(i, j)) <=
+                tolerance * std::pow(10., j - 10.));
+      }
+    }
+  }
+}
+
+TEST_CASE("Reduced precision preconditioner", "[Reduced preconditioner]") {
+  typedef catamari::Complex<double> Field;
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(16, 16, 16, Field(-1., 0.5));
+  const Int num_rows = matrix.NumRows();
+
+  for (const catamari::StoragePrecision precision :
+       {catamari::kHalfPrecision, catamari::kBFloat16Precision}) {
+    // Store every compressed tile densely, but in reduced precision.
+    catamari::SparseLDLControl<Field> ldl_control =
+        CompressedControl<Field>(catamari::kLDLTransposeFactorization, 0.);
+    ldl_control.supernodal_control.block_low_rank.storage_precision =
+        precision;
+
+    catamari::SparseLDL<Field> ldl;
+    const catamari::SparseLDLResult<Field> result =
+        ldl.Factor(matrix, ldl_control);
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(result.num_compressed_supernodes > 0);
+    REQUIRE(result.num_low_rank_entries ==
+            result.num_compressed_block_entries);
+    REQUIRE(3 * result.num_low_rank_bytes <
+            result.num_compressed_block_entries * sizeof(Field));
+
+    catamari::RefinedSolveControl<Real> refined_solve_control;
+    refined_solve_control.relative_tol = 1e-10;
+    refined_solve_control.max_iters = 40;
+    BlasMatrix<Field> solution;
+    RightHandSides(num_rows, 2, &solution);
+    const catamari::RefinedSolveStatus<Real> status =
+        ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+    REQUIRE(status.residual_relative_max_norm <= 1e-10);
+    REQUIRE(status.num_iterations > 0);
+  }
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+
+namespace {
+
+// Returns a diagonally-dominant 2D Laplacian over an n x n grid with
+// 'block_size' degrees of freedom per vertex. If 'dense_couplings' is true,
+// every pair of degrees of freedom of neighbouring vertices is coupled;
+// otherwise, only the like degrees of freedom of neighbours are, and only
+// the first two degrees of freedom of each vertex are coupled to each other.
+catamari::CoordinateMatrix<double> VectorLaplacian(Int num_x_elements,
+                                                   Int block_size,
+                                                   bool dense_couplings) {
+  const Int num_vertices = num_x_elements * num_x_elements;
+  const Int num_rows = num_vertices * block_size;
+  const double diagonal = 1 + 5 * block_size;
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows * block_size);
+  auto couple = [&](Int vertex, Int neighbor) {
+    for (Int i = 0; i < block_size; ++i) {
+      for (Int j = 0; j < block_size; ++j) {
+        if (!dense_couplings && i != j) continue;
+        matrix.QueueEntryAddition(vertex * block_size + i,
+                                  neighbor * block_size + j, -1);
+      }
+    }
+  };
+  for (Int y = 0; y < num_x_elements; ++y) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      const Int vertex = x + y * num_x_elements;
+      for (Int i = 0; i < block_size; ++i) {
+        const Int row = vertex * block_size + i;
+        matrix.QueueEntryAddition(row, row, diagonal);
+        for (Int j = 0; j < block_size; ++j) {
+          if (i != j && (dense_couplings || i + j == 1)) {
+            matrix.QueueEntryAddition(row, vertex * block_size + j, 0.5);
+          }
+        }
+      }
+      if (x > 0) couple(vertex, vertex - 1);
+      if (x < num_x_elements - 1) couple(vertex, vertex + 1);
+      if (y > 0) couple(vertex, vertex - num_x_elements);
+      if (y < num_x_elements - 1) couple(vertex, vertex + num_x_elements);
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Checks that the rows of each vertex are contiguous (and in order) in the
+// reordering and that they lie in a single supernode.
+void CheckBlocks(const Buffer<Int>& inverse_permutation,
+                 const Buffer<Int>& supernode_offsets, Int block_size) {
+  const Int num_rows = inverse_permutation.Size();
+  for (Int row = 0; row < num_rows; row += block_size) {
+    REQUIRE(inverse_permutation[row] % block_size == 0);
+    for (Int offset = 1; offset < block_size; ++offset) {
+      REQUIRE(inverse_permutation[row + offset] ==
+              inverse_permutation[row] + offset);
+    }
+  }
+  for (const Int& offset : supernode_offsets) {
+    REQUIRE(offset % block_size == 0);
+  }
+}
+
+void RunTest(catamari::ReorderingStrategy reordering_strategy,
+             catamari::SupernodalStrategy supernodal_strategy,
+             bool dense_couplings) {
+  const Int block_size = 3;
+  const catamari::CoordinateMatrix<double> matrix =
+      VectorLaplacian(20, block_size, dense_couplings);
+
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.reordering_strategy = reordering_strategy;
+  control.supernodal_strategy = supernodal_strategy;
+  control.block_size = block_size;
+  control.supernodal_control.relaxation_control.relax_supernodes = false;
+
+  catamari::SparseLDL<double> ldl;
+  const catamari::SparseLDLResult<double> result =
+      ldl.Factor(matrix, control);
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) < 1e-12);
+
+  if (ldl.is_supernodal) {
+    CheckBlocks(ldl.supernodal_factorization->InversePermutation(),
+                ldl.supernodal_factorization->SupernodeOffsets(),
+                block_size);
+  } else {
+    CheckBlocks(ldl.scalar_factorization->ordering.inverse_permutation,
+                Buffer<Int>(), block_size);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Block graph", "[Block graph]") {
+  const Int block_size = 3;
+  const catamari::CoordinateMatrix<double> matrix =
+      VectorLaplacian(4, block_size, false);
+  catamari::CoordinateMatrix<double> block_graph;
+  catamari::FormBlockGraph(matrix, block_size, &block_graph);
+  REQUIRE(block_graph.NumRows() == 16);
+  REQUIRE(block_graph.NumEntries() == 16 + 2 * 2 * 4 * 3);
+
+  catamari::CoordinateMatrix<double> padded_matrix;
+  catamari::PadBlockPattern(matrix, block_graph, block_size, &padded_matrix);
+  REQUIRE(padded_matrix.NumEntries() ==
+          block_graph.NumEntries() * block_size * block_size);
+  double matrix_sum = 0;
+  for (const catamari::MatrixEntry<double>& entry : matrix.Entries()) {
+    matrix_sum += entry.value;
+  }
+  double padded_sum = 0;
+  for (const catamari::MatrixEntry<double>& entry : padded_matrix.Entries()) {
+    padded_sum += entry.value;
+  }
+  REQUIRE(padded_sum == matrix_sum);
+
+  REQUIRE_THROWS(catamari::FormBlockGraph(matrix, 5, &block_graph));
+}
+
+TEST_CASE("Minimum degree supernodal", "[MD supernodal]") {
+  RunTest(catamari::kMinimumDegreeReordering,
+          catamari::kSupernodalFactorization, true);
+  RunTest(catamari::kMinimumDegreeReordering,
+          catamari::kSupernodalFactorization, false);
+}
+
+TEST_CASE("Minimum degree scalar", "[MD scalar]") {
+  RunTest(catamari::kMinimumDegreeReordering, catamari::kScalarFactorization,
+          false);
+}
+
+TEST_CASE("Minimum degree adaptive", "[MD adaptive]") {
+  RunTest(catamari::kMinimumDegreeReordering,
+          catamari::kAdaptiveSupernodalStrategy, true);
+}
+
+TEST_CASE("Nested dissection supernodal", "[ND supernodal]") {
+  RunTest(catamari::kNestedDissectionReordering,
+          catamari::kSupernodalFactorization, false);
+}
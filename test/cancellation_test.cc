@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <limits>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/cancellation_token.hpp"
+#include "catamari/norms.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns the relative residual of the solution of 'matrix x = ones'.
+template <typename Field>
+catamari::ComplexBase<Field> RelativeResidual(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    const catamari::SparseLDL<Field>& ldl) {
+  const Int num_rows = matrix.NumRows();
+  BlasMatrix<Field> right_hand_sides;
+  right_hand_sides.Resize(num_rows, 1, Field{1});
+  BlasMatrix<Field> solution = right_hand_sides;
+  ldl.Solve(&solution.view);
+  BlasMatrix<Field> residual = right_hand_sides;
+  catamari::ApplySparse(Field{-1}, matrix, solution.ConstView(), Field{1},
+                        &residual.view);
+  return catamari::EuclideanNorm(residual.ConstView()) /
+         catamari::EuclideanNorm(right_hand_sides.ConstView());
+}
+
+catamari::SparseLDLControl<double> CancellableControl(
+    const catamari::CancellationToken* token) {
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.cancellation = token;
+  return ldl_control;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cancel", "[Cancel]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 40, 1.);
+  const Int num_rows = matrix.NumRows();
+  catamari::CancellationToken token;
+  catamari::SparseLDL<double> ldl;
+
+  // A factorization with an already cancelled token stops immediately.
+  token.Cancel();
+  REQUIRE(token.Cancelled());
+  catamari::SparseLDLResult<double> result =
+      ldl.Factor(matrix, CancellableControl(&token));
+  REQUIRE(result.cancelled);
+  REQUIRE(result.num_successful_pivots < num_rows);
+
+  // Once reset, the token lets the refactorization run to completion.
+  token.Reset();
+  REQUIRE(!token.Cancelled());
+  result = ldl.RefactorWithFixedSparsityPattern(matrix);
+  REQUIRE(!result.cancelled);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <=
+          1e3 * std::numeric_limits<double>::epsilon());
+}
+
+TEST_CASE("Deadline", "[Deadline]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 40, 1.);
+  const Int num_rows = matrix.NumRows();
+  catamari::CancellationToken token;
+  catamari::SparseLDL<double> ldl;
+
+  // An expired deadline cancels the factorization.
+  token.SetTimeLimit(0.);
+  REQUIRE(token.Cancelled());
+  catamari::SparseLDLResult<double> result =
+      ldl.Factor(matrix, CancellableControl(&token));
+  REQUIRE(result.cancelled);
+  REQUIRE(result.num_successful_pivots < num_rows);
+
+  // A distant deadline does not.
+  token.SetTimeLimit(3600.);
+  REQUIRE(!token.Cancelled());
+  result = ldl.RefactorWithFixedSparsityPattern(matrix);
+  REQUIRE(!result.cancelled);
+  REQUIRE(result.num_successful_pivots == num_rows);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns the solution of the factored system against the vector of all
+// ones.
+BlasMatrix<double> SolveOnes(const catamari::SparseLDL<double>& ldl,
+                             Int num_rows) {
+  BlasMatrix<double> solution;
+  solution.Resize(num_rows, 1, 1.);
+  ldl.Solve(&solution.view);
+  return solution;
+}
+
+// Checks that refactoring after a local change of the values agrees with a
+// full refactorization.
+void RunTest(const catamari::SparseLDLControl<double>& control) {
+  const Int num_x_elements = 30;
+  catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(num_x_elements, num_x_elements, 0.5);
+  const Int num_rows = matrix.NumRows();
+  const Int num_entries = matrix.NumEntries();
+
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+
+  // Strengthen the couplings within a small patch of the grid.
+  auto in_patch = [&](Int index) {
+    const Int x = index % num_x_elements;
+    const Int y = index / num_x_elements;
+    return x >= 3 && x < 6 && y >= 20 && y < 23;
+  };
+  Buffer<double> values(num_entries);
+  Buffer<char> changed(num_rows, 0);
+  for (Int index = 0; index < num_entries; ++index) {
+    const catamari::MatrixEntry<double>& entry = matrix.Entries()[index];
+    values[index] = entry.value;
+    if (in_patch(entry.row) && in_patch(entry.column)) {
+      values[index] *= 1.5;
+      changed[entry.row] = changed[entry.column] = 1;
+    }
+  }
+  Int num_changed = 0;
+  for (Int row = 0; row < num_rows; ++row) num_changed += changed[row];
+  Buffer<Int> changed_columns(num_changed);
+  for (Int row = 0, index = 0; row < num_rows; ++row) {
+    if (changed[row]) changed_columns[index++] = row;
+  }
+
+  catamari::CoordinateMatrix<double> changed_matrix;
+  changed_matrix.Resize(num_rows, num_rows);
+  changed_matrix.ReserveEntryAdditions(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    const catamari::MatrixEntry<double>& entry = matrix.Entries()[index];
+    changed_matrix.QueueEntryAddition(entry.row, entry.column, values[index]);
+  }
+  changed_matrix.FlushEntryQueues();
+  catamari::SparseLDL<double> full_ldl;
+  const catamari::SparseLDLResult<double> full_result =
+      full_ldl.Factor(changed_matrix, control);
+  REQUIRE(full_result.num_successful_pivots == num_rows);
+  const BlasMatrix<double> expected = SolveOnes(full_ldl, num_rows);
+
+  const catamari::SparseLDLResult<double> result =
+      ldl.RefactorChangedColumns(changed_columns, cplan, values.Data());
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(std::abs(result.log_abs_determinant -
+                   full_result.log_abs_determinant) <=
+          1e-10 * std::abs(full_result.log_abs_determinant));
+
+  const BlasMatrix<double> solution = SolveOnes(ldl, num_rows);
+  double max_error = 0;
+  double max_entry = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    max_error = std::max(max_error, std::abs(solution(i, 0) - expected(i, 0)));
+    max_entry = std::max(max_entry, std::abs(expected(i, 0)));
+  }
+  REQUIRE(max_error <= 1e-12 * max_entry);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Right-looking Cholesky", "[Right-looking Cholesky]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  RunTest(control);
+}
+
+TEST_CASE("Retained Schur complements", "[Retained Schur complements]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  control.reordering_strategy = catamari::kNestedDissectionReordering;
+  control.supernodal_control.schur_complement_retention_work = 1;
+  RunTest(control);
+
+  control.supernodal_control.expand_schur_complements_in_place = true;
+  RunTest(control);
+}
+
+TEST_CASE("Left-looking LDL^H", "[Left-looking LDL^H]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kLeftLookingLDL;
+  control.reordering_strategy = catamari::kNestedDissectionReordering;
+  RunTest(control);
+}
+
+TEST_CASE("Row-panel solves", "[Row-panel solves]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.solve_layout =
+      catamari::supernodal_ldl::kRowPanelSolveLayout;
+  RunTest(control);
+}
+
+TEST_CASE("Invalid columns", "[Invalid columns]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(10, 10, 1.);
+  catamari::SparseLDLControl<double> control;
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(matrix, control);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<double> values(matrix.NumEntries(), 1.);
+  REQUIRE_THROWS(
+      ldl.RefactorChangedColumns(Buffer<Int>(1, 100), cplan, values.Data()));
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/sparse_ldl.hpp"
+#include "catamari/symmetric_ordering.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a matrix with the right-looking supernodal factorization visiting
+// the children of each supernode in the given order, either serially or
+// within a multithreaded task arena with every subtree scheduled in
+// parallel, checks the residual, and returns the factorization statistics.
+template <typename Field>
+catamari::SparseLDLResult<Field> Factor(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    catamari::SymmetricFactorizationType factorization_type,
+    catamari::ChildOrder child_order, bool expand_in_place, bool parallel) {
+  typedef catamari::ComplexBase<Field> Real;
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.child_order = child_order;
+  ldl_control.supernodal_control.expand_schur_complements_in_place =
+      expand_in_place;
+  if (parallel) {
+    ldl_control.supernodal_control.min_parallel_threshold = 0;
+    ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+  } else {
+    ldl_control.supernodal_control.min_parallel_threshold =
+        std::numeric_limits<double>::infinity();
+  }
+
+  catamari::SparseLDL<Field> ldl;
+  catamari::SparseLDLResult<Field> result;
+  if (parallel) {
+    tbb::task_arena arena(4);
+    arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  } else {
+    result = ldl.Factor(matrix, ldl_control);
+  }
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) <=
+          1e3 * std::numeric_limits<Real>::epsilon());
+  return result;
+}
+
+// Checks the residuals of the factorizations under each child order and
+// that the memory-minimizing order does not increase the peak of the serial
+// Schur complement stacks over that of the default order.
+template <typename Field>
+void RunTest(const catamari::CoordinateMatrix<Field>& matrix,
+             catamari::SymmetricFactorizationType factorization_type) {
+  for (const bool expand_in_place : {false, true}) {
+    const catamari::SparseLDLResult<Field> default_result =
+        Factor(matrix, factorization_type, catamari::kDefaultChildOrder,
+               expand_in_place, false);
+    const catamari::SparseLDLResult<Field> memory_result =
+        Factor(matrix, factorization_type,
+               catamari::kMemoryMinimizingChildOrder, expand_in_place, false);
+    REQUIRE(memory_result.peak_frontal_bytes > 0);
+    REQUIRE(memory_result.peak_frontal_bytes <=
+            default_result.peak_frontal_bytes);
+    REQUIRE(memory_result.max_stack_bytes <= default_result.max_stack_bytes);
+    Factor(matrix, factorization_type, catamari::kCriticalPathChildOrder,
+           expand_in_place, false);
+
+    for (const catamari::ChildOrder child_order :
+         {catamari::kDefaultChildOrder, catamari::kMemoryMinimizingChildOrder,
+          catamari::kCriticalPathChildOrder}) {
+      Factor(matrix, factorization_type, child_order, expand_in_place, true);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Sort children", "[Sort children]") {
+  // A root with four children, the second of which has two of its own.
+  catamari::AssemblyForest forest;
+  forest.parents.Resize(7);
+  const Int parents[] = {6, 6, 6, 6, 1, 1, -1};
+  for (Int index = 0; index < 7; ++index) {
+    forest.parents[index] = parents[index];
+  }
+  forest.FillFromParents();
+  const Buffer<Int> child_offsets = forest.child_offsets;
+
+  // Ties keep their index order.
+  Buffer<double> priorities(7);
+  const double values[] = {1., 3., 1., 2., 5., 7., 0.};
+  for (Int index = 0; index < 7; ++index) priorities[index] = values[index];
+  forest.SortChildren(priorities, catamari::kCriticalPathChildOrder);
+  REQUIRE(forest.child_order == catamari::kCriticalPathChildOrder);
+  for (Int index = 0; index <= 7; ++index) {
+    REQUIRE(forest.child_offsets[index] == child_offsets[index]);
+  }
+  const Int root_children[] = {1, 3, 0, 2};
+  for (Int index = 0; index < 4; ++index) {
+    REQUIRE(forest.children[forest.child_offsets[6] + index] ==
+            root_children[index]);
+  }
+  REQUIRE(forest.children[forest.child_offsets[1]] == 5);
+  REQUIRE(forest.children[forest.child_offsets[1] + 1] == 4);
+
+  forest.SortChildrenByIndex();
+  REQUIRE(forest.child_order == catamari::kDefaultChildOrder);
+  for (Int index = 0; index < 4; ++index) {
+    REQUIRE(forest.children[forest.child_offsets[6] + index] == index);
+  }
+  REQUIRE(forest.children[forest.child_offsets[1]] == 4);
+  REQUIRE(forest.children[forest.child_offsets[1] + 1] == 5);
+}
+
+TEST_CASE("2D Cholesky", "[2D Cholesky]") {
+  RunTest(ShiftedLaplacian(30, 25, 0.1), catamari::kCholeskyFactorization);
+}
+
+TEST_CASE("2D Transpose", "[2D Transpose]") {
+  typedef mantis::Complex<double> Field;
+  RunTest(ShiftedLaplacian(25, 20, Field(-1., 0.5)),
+          catamari::kLDLTransposeFactorization);
+}
+
+TEST_CASE("3D Adjoint", "[3D Adjoint]") {
+  RunTest(ShiftedLaplacian(10, 9, 8, -1.),
+          catamari::kLDLAdjointFactorization);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Fills the right-hand sides of the given solve request.
+void RightHandSides(Int num_rows, Int num_rhs, Int request,
+                    BlasMatrix<double>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = double((i * 5 + j + request) % 13) - 6.;
+    }
+  }
+}
+
+// Serves many solve requests concurrently against one factorization, with a
+// workspace per concurrent task, and compares them against the sequential
+// solutions. Returns the maximum relative difference.
+double RunTest(catamari::SymmetricFactorizationType factorization_type,
+               double shift, bool equilibrate) {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 35, shift);
+  const Int num_rows = matrix.NumRows();
+  const Int num_requests = 32;
+  const Int num_rhs = 2;
+  const int num_tasks = 4;
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  ldl_control.equilibrate = equilibrate;
+
+  tbb::task_arena arena(4);
+  catamari::SparseLDL<double> ldl;
+  catamari::SparseLDLResult<double> result;
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  std::vector<BlasMatrix<double>> expected(num_requests);
+  for (Int request = 0; request < num_requests; ++request) {
+    RightHandSides(num_rows, num_rhs, request, &expected[request]);
+    arena.execute([&]() { ldl.Solve(&expected[request].view); });
+  }
+
+  std::vector<BlasMatrix<double>> solutions(num_requests);
+  std::vector<std::unique_ptr<catamari::SolveWorkspace<double>>> workspaces;
+  for (int task = 0; task < num_tasks; ++task) {
+    workspaces.emplace_back(new catamari::SolveWorkspace<double>);
+  }
+  arena.execute([&]() {
+    tbb::task_group group;
+    for (int task = 0; task < num_tasks; ++task) {
+      group.run([&, task]() {
+        for (Int request = task; request < num_requests;
+             request += num_tasks) {
+          RightHandSides(num_rows, num_rhs, request, &solutions[request]);
+          ldl.Solve(&solutions[request].view, workspaces[task].get());
+        }
+      });
+    }
+    group.wait();
+  });
+
+  double max_difference = 0;
+  double max_entry = 0;
+  for (Int request = 0; request < num_requests; ++request) {
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        max_difference = std::max(
+            max_difference, std::abs(expected[request](i, j) -
+                                     solutions[request](i, j)));
+        max_entry = std::max(max_entry, std::abs(expected[request](i, j)));
+      }
+    }
+  }
+  return max_difference / max_entry;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest(catamari::kCholeskyFactorization, 0.1, false) <= tolerance);
+  REQUIRE(RunTest(catamari::kCholeskyFactorization, 0.1, true) <= tolerance);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest(catamari::kLDLAdjointFactorization, -1., false) <=
+          tolerance);
+}
+
+TEST_CASE("Prepared solves", "[Prepared solves]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(40, 35, 0.1);
+  const Int num_rows = matrix.NumRows();
+  const Int num_rhs = 3;
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+
+  tbb::task_arena arena(4);
+  catamari::SparseLDL<double> unprepared_ldl;
+  arena.execute([&]() { unprepared_ldl.Factor(matrix, ldl_control); });
+
+  // The factorization's own workspace is prepared during the factorization
+  // and a separate one afterwards; both give the unprepared solutions.
+  ldl_control.supernodal_control.prepared_solve_num_rhs = num_rhs;
+  catamari::SparseLDL<double> ldl;
+  catamari::SparseLDLResult<double> result;
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == num_rows);
+  catamari::SolveWorkspace<double> workspace;
+  ldl.PrepareSolve(num_rhs, &workspace);
+  REQUIRE(workspace.permute_scratch.Size() >= num_rows * num_rhs);
+
+  BlasMatrix<double> expected, solution, workspace_solution;
+  RightHandSides(num_rows, num_rhs, 0, &expected);
+  solution = expected;
+  workspace_solution = expected;
+  arena.execute([&]() {
+    unprepared_ldl.Solve(&expected.view);
+    ldl.Solve(&solution.view);
+    ldl.Solve(&workspace_solution.view, &workspace);
+  });
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      const double scale = 1 + std::abs(expected(i, j));
+      REQUIRE(std::abs(solution(i, j) - expected(i, j)) <= tolerance * scale);
+      REQUIRE(std::abs(workspace_solution(i, j) - expected(i, j)) <=
+              tolerance * scale);
+    }
+  }
+}
@@ -0,0 +1,472 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// A compressed-sparse-column (or -row) copy of (a triangle of) a matrix.
+template <typename Field>
+struct CompressedMatrix {
+  Buffer<Int> offsets;
+  Buffer<Int> indices;
+  Buffer<Field> values;
+};
+
+// Compresses the entries of 'matrix' by column (or, if 'compressed_rows', by
+// row), keeping only those with row >= column if 'lower' is positive, only
+// those with row <= column if 'lower' is negative, and all of them otherwise.
+template <typename Field>
+CompressedMatrix<Field> Compress(const catamari::CoordinateMatrix<Field>& matrix,
+                                 bool compressed_rows, Int lower) {
+  const Int num_rows = matrix.NumRows();
+  CompressedMatrix<Field> compressed;
+  compressed.offsets.Resize(num_rows + 1, 0);
+  auto keep = [&](const catamari::MatrixEntry<Field>& entry) {
+    return lower == 0 || (lower > 0 && entry.row >= entry.column) ||
+           (lower < 0 && entry.row <= entry.column);
+  };
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (keep(entry)) {
+      ++compressed.offsets[(compressed_rows ? entry.row : entry.column) + 1];
+    }
+  }
+  for (Int i = 0; i < num_rows; ++i) {
+    compressed.offsets[i + 1] += compressed.offsets[i];
+  }
+  const Int num_entries = compressed.offsets[num_rows];
+  compressed.indices.Resize(num_entries);
+  compressed.values.Resize(num_entries);
+  Buffer<Int> ptrs(num_rows);
+  for (Int i = 0; i < num_rows; ++i) {
+    ptrs[i] = compressed.offsets[i];
+  }
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    if (!keep(entry)) continue;
+    const Int outer = compressed_rows ? entry.row : entry.column;
+    const Int inner = compressed_rows ? entry.column : entry.row;
+    compressed.indices[ptrs[outer]] = inner;
+    compressed.values[ptrs[outer]++] = entry.value;
+  }
+  return compressed;
+}
+
+// Symbolically factors a shifted 2D negative Laplacian and then refactors it
+// through conversion plans formed from compressed representations of its
+// full pattern and of each of its triangles, loading the values both through
+// contiguous runs and through per-entry scatters.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::CoordinateMatrix<Field> doubled_matrix = matrix;
+  doubled_matrix.ReserveEntryAdditions(matrix.NumEntries());
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    doubled_matrix.QueueEntryAddition(entry.row, entry.column, entry.value);
+  }
+  doubled_matrix.FlushEntryQueues();
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (bool compressed_rows : {false, true}) {
+    for (Int lower : {-1, 0, 1}) {
+      const CompressedMatrix<Field> compressed =
+          Compress(matrix, compressed_rows, lower);
+      catamari::ConversionPlan cplan;
+      ldl.FormConversionPlan(num_rows, compressed.offsets.Data(),
+                             compressed.indices.Data(), compressed_rows,
+                             &cplan);
+
+      // Each destination must be written exactly once, in increasing order
+      // within each supernode.
+      REQUIRE(cplan.columnOffsets[num_rows] ==
+              Compress(matrix, false, 1).indices.Size());
+      bool sorted = true;
+      for (Int column = 0; column < num_rows; ++column) {
+        for (const catamari::ConversionPlan::Entry* entry =
+                 cplan.columnData(column) + 1;
+             entry < cplan.columnData(column + 1); ++entry) {
+          sorted = sorted && entry[-1].dst < entry->dst;
+        }
+      }
+      REQUIRE(sorted);
+
+      // Load the values both through contiguous runs and one at a time.
+      for (Int min_average_length : {Int(1), num_rows}) {
+        cplan.encodeRuns(min_average_length);
+        REQUIRE(cplan.hasRuns() == (min_average_length == 1));
+
+        catamari::SparseLDLResult<Field> result =
+            ldl.RefactorWithFixedSparsityPattern(cplan,
+                                                 compressed.values.Data());
+        REQUIRE(result.num_successful_pivots == num_rows);
+        REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+        // Factor A + A through a shift by the matrix itself.
+        result = ldl.RefactorWithFixedSparsityPattern(
+            cplan, compressed.values.Data(), Field{1},
+            compressed.values.Data());
+        REQUIRE(result.num_successful_pivots == num_rows);
+        REQUIRE(RelativeResidual(doubled_matrix, ldl) <= tolerance);
+      }
+    }
+  }
+}
+
+// Refactors an indefinite shifted 2D negative Laplacian through a Cholesky
+// shift sweep and checks that the smallest sufficient shift is kept.
+template <typename Field>
+void RunShiftSweepTest(Int num_x_elements, Int num_y_elements) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+
+  // The smallest eigenvalue of the unshifted Laplacian lies in (0, 0.1).
+  const Field shift = Field{-1};
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  Buffer<Field> sigmas(5);
+  sigmas[0] = Field{0.5};
+  sigmas[1] = Field{0.9};
+  sigmas[2] = Field{1.5};
+  sigmas[3] = Field{2};
+  sigmas[4] = Field{3};
+  Buffer<catamari::SparseLDLResult<Field>> results;
+  const Int selected = ldl.RefactorWithShifts(cplan, values.Data(), sigmas,
+                                              nullptr, &results);
+  REQUIRE(selected == 2);
+  REQUIRE(results[2].num_successful_pivots == num_rows);
+  for (Int index = 0; index < 2; ++index) {
+    REQUIRE(results[index].num_successful_pivots < num_rows);
+  }
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  const catamari::CoordinateMatrix<Field> shifted_matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift + sigmas[2]);
+  REQUIRE(RelativeResidual(shifted_matrix, ldl) <= tolerance);
+
+  // None of the shifts suffice.
+  sigmas.Resize(2);
+  REQUIRE(ldl.RefactorWithShifts(cplan, values.Data(), sigmas, nullptr,
+                                 &results) == -1);
+  REQUIRE(results[1].num_successful_pivots < num_rows);
+}
+
+// Refactors a shifted 2D negative Laplacian, and then twice its value, with
+// the fronts assembled by writing each of their entries exactly once, so
+// that any entry left stale from the preceding factorization would spoil the
+// solution.
+template <typename Field>
+void RunWriteOnceTest(Int num_x_elements, Int num_y_elements,
+                      catamari::SymmetricFactorizationType factorization_type,
+                      const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.write_once_assembly = true;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  REQUIRE(cplan.sortedColumns());
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (Int min_average_length : {Int(1), num_rows}) {
+    cplan.encodeRuns(min_average_length);
+    REQUIRE(cplan.sortedColumns());
+
+    catamari::SparseLDLResult<Field> result =
+        ldl.RefactorWithFixedSparsityPattern(cplan, values.Data(), Field{1},
+                                             values.Data());
+    REQUIRE(result.num_successful_pivots == num_rows);
+
+    result = ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  }
+}
+
+// Refactors clones of a scalar factorization of a small shifted 2D negative
+// Laplacian through a shared conversion plan, after either a symbolic
+// left-looking or a full up-looking factorization, and solves against each
+// clone with a reusable workspace.
+template <typename Field>
+void RunScalarTest(Int num_x_elements, Int num_y_elements,
+                   catamari::SymmetricFactorizationType factorization_type,
+                   const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+  catamari::CoordinateMatrix<Field> doubled_matrix = matrix;
+  doubled_matrix.ReserveEntryAdditions(matrix.NumEntries());
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    doubled_matrix.QueueEntryAddition(entry.row, entry.column, entry.value);
+  }
+  doubled_matrix.FlushEntryQueues();
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (const catamari::LDLAlgorithm algorithm :
+       {catamari::kLeftLookingLDL, catamari::kUpLookingLDL}) {
+    catamari::SparseLDLControl<Field> ldl_control;
+    ldl_control.SetFactorizationType(factorization_type);
+    ldl_control.supernodal_strategy = catamari::kScalarFactorization;
+    ldl_control.scalar_control.algorithm = algorithm;
+
+    catamari::SparseLDL<Field> ldl;
+    const bool symbolic_only = algorithm == catamari::kLeftLookingLDL;
+    ldl.Factor(matrix, ldl_control, symbolic_only);
+    REQUIRE(!ldl.is_supernodal);
+
+    for (Int lower : {0, 1}) {
+      const CompressedMatrix<Field> compressed = Compress(matrix, false, lower);
+      catamari::ConversionPlan cplan;
+      ldl.FormConversionPlan(num_rows, compressed.offsets.Data(),
+                             compressed.indices.Data(), false, &cplan);
+      REQUIRE(cplan.columnOffsets[num_rows] ==
+              Compress(matrix, false, 1).indices.Size());
+
+      std::unique_ptr<catamari::SparseLDL<Field>> clone = ldl.Clone();
+      catamari::SparseLDLResult<Field> result =
+          ldl.RefactorWithFixedSparsityPattern(cplan,
+                                               compressed.values.Data());
+      REQUIRE(result.num_successful_pivots == num_rows);
+      result = clone->RefactorWithFixedSparsityPattern(
+          cplan, compressed.values.Data(), Field{1},
+          compressed.values.Data());
+      REQUIRE(result.num_successful_pivots == num_rows);
+      REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+      REQUIRE(RelativeResidual(doubled_matrix, *clone) <= tolerance);
+
+      // Solves through a reusable workspace match the allocating solves.
+      catamari::SolveWorkspace<Field> workspace;
+      BlasMatrix<Field> expected;
+      expected.Resize(num_rows, 2, Field{1});
+      clone->Solve(&expected.view);
+      for (Int repetition = 0; repetition < 2; ++repetition) {
+        BlasMatrix<Field> solution;
+        solution.Resize(num_rows, 2, Field{1});
+        clone->Solve(&solution.view, &workspace);
+        for (Int j = 0; j < 2; ++j) {
+          for (Int i = 0; i < num_rows; ++i) {
+            REQUIRE(solution(i, j) == expected(i, j));
+          }
+        }
+      }
+    }
+  }
+}
+
+// Refactors the linear combinations 'c_0 L + c_1 I + c_2 L' of the values of
+// a 2D negative Laplacian, L, and of the identity, I, stored in its pattern,
+// with the coefficients of each column of 'coefficients' -- both with a
+// supernodal and a scalar factorization, and both one at a time (through
+// contiguous runs and per-entry scatters) and concurrently in clones.
+template <typename Field>
+void RunCombinationTest(
+    Int num_x_elements, Int num_y_elements,
+    catamari::SymmetricFactorizationType factorization_type,
+    const BlasMatrix<Field>& coefficients) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, Field{0});
+  const Int num_rows = matrix.NumRows();
+  const Int num_entries = matrix.NumEntries();
+  Buffer<Field> laplacian_values(num_entries);
+  Buffer<Field> identity_values(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    const catamari::MatrixEntry<Field>& entry = matrix.Entries()[index];
+    laplacian_values[index] = entry.value;
+    identity_values[index] = entry.row == entry.column ? Field{1} : Field{0};
+  }
+  Buffer<const Field*> values(3);
+  values[0] = laplacian_values.Data();
+  values[1] = identity_values.Data();
+  values[2] = laplacian_values.Data();
+
+  // Returns the combination with the coefficients of the given column, plus
+  // 'shift' times the identity.
+  auto combination = [&](Int column, const Field& shift) {
+    catamari::CoordinateMatrix<Field> combined;
+    combined.Resize(num_rows, num_rows);
+    combined.ReserveEntryAdditions(num_entries);
+    for (Int index = 0; index < num_entries; ++index) {
+      const catamari::MatrixEntry<Field>& entry = matrix.Entries()[index];
+      Field value = (coefficients(0, column) + coefficients(2, column)) *
+                        laplacian_values[index] +
+                    coefficients(1, column) * identity_values[index];
+      if (entry.row == entry.column) value += shift;
+      combined.QueueEntryAddition(entry.row, entry.column, value);
+    }
+    combined.FlushEntryQueues();
+    return combined;
+  };
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (const catamari::SupernodalStrategy strategy :
+       {catamari::kSupernodalFactorization, catamari::kScalarFactorization}) {
+    catamari::SparseLDLControl<Field> ldl_control;
+    ldl_control.SetFactorizationType(factorization_type);
+    ldl_control.supernodal_strategy = strategy;
+    ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+    ldl_control.scalar_control.algorithm = catamari::kLeftLookingLDL;
+
+    catamari::SparseLDL<Field> ldl;
+    ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+    catamari::ConversionPlan cplan;
+    ldl.FormConversionPlan(matrix, &cplan);
+
+    const Field shift = Field{0.25};
+    for (Int min_average_length : {Int(1), num_rows}) {
+      cplan.encodeRuns(min_average_length);
+      for (Int column = 0; column < coefficients.Width(); ++column) {
+        Buffer<Field> column_coefficients(3);
+        for (Int term = 0; term < 3; ++term) {
+          column_coefficients[term] = coefficients(term, column);
+        }
+        const catamari::SparseLDLResult<Field> result =
+            ldl.RefactorWithFixedSparsityPattern(cplan, values,
+                                                 column_coefficients, shift);
+        REQUIRE(result.num_successful_pivots == num_rows);
+        REQUIRE(RelativeResidual(combination(column, shift), ldl) <=
+                tolerance);
+      }
+    }
+
+    Buffer<Real> residuals(coefficients.Width(), Real{1});
+    ldl.RefactorCombinations(
+        cplan, values, coefficients.ConstView(),
+        [&](Int column, const catamari::SparseLDL<Field>& column_ldl,
+            const catamari::SparseLDLResult<Field>& result) {
+          if (result.num_successful_pivots == num_rows) {
+            residuals[column] =
+                RelativeResidual(combination(column, Field{0}), column_ldl);
+          }
+        });
+    for (Int column = 0; column < coefficients.Width(); ++column) {
+      REQUIRE(residuals[column] <= tolerance);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization, 0.1);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kCholeskyFactorization,
+                                   0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(20, 15, catamari::kLDLAdjointFactorization, -1.);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kLDLAdjointFactorization,
+                                   -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<double>(20, 15, catamari::kLDLTransposeFactorization, -1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization,
+      mantis::Complex<double>(-1., 0.5));
+}
+
+TEST_CASE("Shift sweep", "[Shift sweep]") {
+  RunShiftSweepTest<double>(20, 15);
+  RunShiftSweepTest<mantis::Complex<double>>(20, 15);
+}
+
+TEST_CASE("Write-once assembly", "[Write-once assembly]") {
+  RunWriteOnceTest<double>(20, 15, catamari::kCholeskyFactorization, 0.1);
+  RunWriteOnceTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLAdjointFactorization, -1.);
+}
+
+TEST_CASE("Scalar", "[Scalar]") {
+  RunScalarTest<double>(7, 6, catamari::kCholeskyFactorization, 0.1);
+  RunScalarTest<mantis::Complex<double>>(
+      7, 6, catamari::kLDLAdjointFactorization, -1.);
+  RunScalarTest<double>(7, 6, catamari::kLDLTransposeFactorization, -1.);
+}
+
+TEST_CASE("Linear combinations", "[Linear combinations]") {
+  BlasMatrix<double> coefficients;
+  coefficients.Resize(3, 4);
+  for (Int column = 0; column < 4; ++column) {
+    coefficients(0, column) = 1;
+    coefficients(1, column) = 0.5 * column;
+    coefficients(2, column) = 0.25 * column;
+  }
+  RunCombinationTest<double>(20, 15, catamari::kCholeskyFactorization,
+                             coefficients);
+
+  // The Helmholtz-like operators 'L - omega^2 I + i omega L'.
+  typedef mantis::Complex<double> Field;
+  BlasMatrix<Field> complex_coefficients;
+  complex_coefficients.Resize(3, 6);
+  for (Int column = 0; column < 6; ++column) {
+    const double omega = 0.5 * (column + 1);
+    complex_coefficients(0, column) = Field{1};
+    complex_coefficients(1, column) = Field{-omega * omega};
+    complex_coefficients(2, column) = Field(0., omega);
+  }
+  RunCombinationTest<Field>(20, 15, catamari::kLDLTransposeFactorization,
+                            complex_coefficients);
+}
@@ -85,3 +85,118 @@ TEST_CASE("Basic", "[Basic]") {
   };
   REQUIRE(entries == update3_entries);
 }
+
+TEST_CASE("Column indices", "[Column indices]") {
+  catamari::CoordinateMatrix<float> matrix;
+  auto require_consistent_indices = [&]() {
+    const catamari::Buffer<catamari::MatrixEntry<float>>& entries =
+        matrix.Entries();
+    const catamari::Buffer<quotient::Int>& column_indices =
+        matrix.ColumnIndices();
+    REQUIRE(column_indices.Size() == entries.Size());
+    for (std::size_t index = 0; index < entries.Size(); ++index) {
+      REQUIRE(column_indices[index] == entries[index].column);
+    }
+  };
+
+  matrix.Resize(4, 4);
+  require_consistent_indices();
+
+  matrix.ReserveEntryAdditions(5);
+  matrix.QueueEntryAdditions(std::vector<catamari::MatrixEntry<float>>{
+      {3, 1, 1.f},
+      {0, 2, 2.f},
+      {1, 1, -1.f},
+      {3, 0, -2.f},
+      {0, 0, 3.f},
+  });
+  matrix.FlushEntryQueues();
+  require_consistent_indices();
+  const catamari::Buffer<quotient::Int> expected_indices{0, 2, 1, 0, 1};
+  REQUIRE(matrix.ColumnIndices() == expected_indices);
+
+  matrix.RemoveEntry(0, 2);
+  require_consistent_indices();
+
+  const catamari::CoordinateMatrix<float> copy = matrix;
+  REQUIRE(copy.ColumnIndices() == matrix.ColumnIndices());
+
+  matrix.Empty();
+  require_consistent_indices();
+}
+
+TEST_CASE("Triplets", "[Triplets]") {
+  // A shuffled list of triplets with duplicates.
+  const catamari::Buffer<quotient::Int> rows{3, 0, 2, 3, 0, 3, 1};
+  const catamari::Buffer<quotient::Int> columns{1, 2, 0, 1, 2, 0, 3};
+  const catamari::Buffer<float> values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f};
+
+  std::unique_ptr<catamari::CoordinateMatrix<float>> matrix =
+      catamari::CoordinateMatrix<float>::FromTriplets(4, 5, rows, columns,
+                                                       values);
+  const catamari::Buffer<catamari::MatrixEntry<float>> expected_entries{
+      {0, 2, 7.f}, {1, 3, 7.f}, {2, 0, 3.f}, {3, 0, 6.f}, {3, 1, 5.f},
+  };
+  REQUIRE(matrix->NumRows() == 4);
+  REQUIRE(matrix->NumColumns() == 5);
+  REQUIRE(matrix->Entries() == expected_entries);
+  REQUIRE(matrix->RowEntryOffset(1) == 1);
+  REQUIRE(matrix->RowEntryOffset(4) == 5);
+  REQUIRE(matrix->Value(3, 1) == 5.f);
+
+  // The result matches assembly through the entry queues.
+  catamari::CoordinateMatrix<float> queued_matrix;
+  queued_matrix.Resize(4, 5);
+  queued_matrix.ReserveEntryAdditions(rows.Size());
+  for (std::size_t index = 0; index < rows.Size(); ++index) {
+    queued_matrix.QueueEntryAddition(rows[index], columns[index],
+                                     values[index]);
+  }
+  queued_matrix.FlushEntryQueues();
+  REQUIRE(queued_matrix.Entries() == matrix->Entries());
+  REQUIRE(queued_matrix.ColumnIndices() == matrix->ColumnIndices());
+
+  matrix = catamari::CoordinateMatrix<float>::FromTriplets(
+      4, 5, rows, columns, values, catamari::kKeepFirstDuplicate);
+  REQUIRE(matrix->Value(0, 2) == 2.f);
+  REQUIRE(matrix->Value(3, 1) == 1.f);
+
+  matrix = catamari::CoordinateMatrix<float>::FromTriplets(
+      4, 5, rows, columns, values, catamari::kKeepLastDuplicate);
+  REQUIRE(matrix->Value(0, 2) == 5.f);
+  REQUIRE(matrix->Value(3, 1) == 4.f);
+}
+
+TEST_CASE("Value assembly", "[Value assembly]") {
+  std::unique_ptr<catamari::CoordinateMatrix<float>> matrix =
+      catamari::CoordinateMatrix<float>::FromTriplets(
+          3, 3, {0, 0, 1, 1, 2}, {0, 1, 0, 1, 2}, {1.f, 1.f, 1.f, 1.f, 1.f});
+
+  catamari::EntryValuesView<float> values = matrix->ValuesView();
+  REQUIRE(values.Size() == 5);
+  values[3] = 4.f;
+  REQUIRE(matrix->Value(1, 1) == 4.f);
+
+  // Two overlapping "element" contributions; entry (1, 0) receives none.
+  const catamari::Buffer<quotient::Int> rows{0, 0, 1, 1, 1, 2, 0};
+  const catamari::Buffer<quotient::Int> columns{0, 1, 1, 1, 1, 2, 0};
+  const catamari::ValueAssemblyPlan plan =
+      matrix->FormValueAssemblyPlan(rows, columns);
+  REQUIRE(plan.num_contributions == 7);
+  REQUIRE(plan.contribution_offsets ==
+          catamari::Buffer<quotient::Int>{0, 2, 3, 3, 6, 7});
+  REQUIRE(plan.contributions ==
+          catamari::Buffer<quotient::Int>{0, 6, 1, 2, 3, 4, 5});
+
+  const catamari::Buffer<float> contributions{1.f, 2.f, 3.f, 4.f,
+                                              5.f, 6.f, 7.f};
+  matrix->AssembleValues(plan, contributions);
+  const catamari::Buffer<catamari::MatrixEntry<float>> expected_entries{
+      {0, 0, 8.f}, {0, 1, 2.f}, {1, 0, 0.f}, {1, 1, 12.f}, {2, 2, 6.f},
+  };
+  REQUIRE(matrix->Entries() == expected_entries);
+
+  // Contributions outside of the pattern are rejected.
+  REQUIRE_THROWS_AS(matrix->FormValueAssemblyPlan({2}, {0}),
+                    std::invalid_argument);
+}
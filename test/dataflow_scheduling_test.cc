@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Refactors a shifted 2D negative Laplacian through a conversion plan with
+// its supernodes scheduled either as a dataflow graph or by fork-join
+// recursion (with the child Schur complements merged in parallel over
+// ranges of 'merge_grain_size' columns), optionally with its subtrees mapped
+// onto 'num_domains' domains. The factorization is run within a
+// multithreaded task arena, as single-threaded factorizations are never
+// scheduled in parallel. Returns the number of successful pivots.
+template <typename Field>
+Int RunTest(Int num_x_elements, Int num_y_elements,
+            catamari::SymmetricFactorizationType factorization_type,
+            const Field& shift, Int num_domains, bool dataflow = true,
+            Int merge_grain_size = 500) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.dataflow_scheduling = dataflow;
+  ldl_control.supernodal_control.merge_grain_size = merge_grain_size;
+  ldl_control.supernodal_control.subtree_mapping_domains = num_domains;
+  ldl_control.supernodal_control.min_parallel_threshold = 0;
+  ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  tbb::task_arena arena(4);
+  Int num_successful_pivots = 0;
+  for (Int refactorization = 0; refactorization < 2; ++refactorization) {
+    catamari::SparseLDLResult<Field> result;
+    arena.execute([&]() {
+      result = ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+    });
+    num_successful_pivots = result.num_successful_pivots;
+    if (num_successful_pivots == matrix.NumRows()) {
+      REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+    }
+  }
+  return num_successful_pivots;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  for (Int num_domains : {0, 2}) {
+    REQUIRE(RunTest<double>(30, 25, catamari::kCholeskyFactorization, 0.1,
+                            num_domains) == 750);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                30, 25, catamari::kCholeskyFactorization, 0.1,
+                num_domains) == 750);
+
+    // The shifted matrix is indefinite, so the factorization must fail.
+    REQUIRE(RunTest<double>(30, 25, catamari::kCholeskyFactorization, -1.,
+                            num_domains) < 750);
+  }
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  for (Int num_domains : {0, 2}) {
+    REQUIRE(RunTest<double>(30, 25, catamari::kLDLAdjointFactorization, -1.,
+                            num_domains) == 750);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                30, 25, catamari::kLDLAdjointFactorization, -1.,
+                num_domains) == 750);
+  }
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  for (Int num_domains : {0, 2}) {
+    REQUIRE(RunTest<double>(30, 25, catamari::kLDLTransposeFactorization, -1.,
+                            num_domains) == 750);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                30, 25, catamari::kLDLTransposeFactorization,
+                mantis::Complex<double>(-1., 0.5), num_domains) == 750);
+  }
+}
+
+TEST_CASE("Fork-join merges", "[Fork-join merges]") {
+  for (Int merge_grain_size : {1, 7}) {
+    REQUIRE(RunTest<double>(30, 25, catamari::kCholeskyFactorization, 0.1, 0,
+                            false, merge_grain_size) == 750);
+    REQUIRE(RunTest<double>(30, 25, catamari::kLDLAdjointFactorization, -1.,
+                            0, false, merge_grain_size) == 750);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                30, 25, catamari::kLDLTransposeFactorization,
+                mantis::Complex<double>(-1., 0.5), 0, false,
+                merge_grain_size) == 750);
+  }
+}
+
+TEST_CASE("Work counters", "[Work counters]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 25, 0.1);
+
+  // Factors under the given schedule within a multithreaded task arena.
+  auto factor = [&](bool dataflow, double min_parallel_threshold) {
+    catamari::SparseLDLControl<double> ldl_control;
+    ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+    ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+    ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+    ldl_control.supernodal_control.dataflow_scheduling = dataflow;
+    ldl_control.supernodal_control.min_parallel_threshold =
+        min_parallel_threshold;
+    ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+    catamari::SparseLDL<double> ldl;
+    catamari::SparseLDLResult<double> result;
+    tbb::task_arena arena(4);
+    arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+    REQUIRE(result.num_successful_pivots == matrix.NumRows());
+    return result;
+  };
+
+  const catamari::SparseLDLResult<double> serial =
+      factor(false, std::numeric_limits<double>::infinity());
+  REQUIRE(serial.num_factor_tasks == serial.num_relaxed_supernodes);
+  REQUIRE(serial.num_trsm_tasks == serial.num_herk_tasks);
+  REQUIRE(serial.num_trsm_tasks <= serial.num_factor_tasks);
+  REQUIRE(serial.num_merge_tasks > 0);
+  REQUIRE(serial.num_merge_tasks < serial.num_factor_tasks);
+  REQUIRE(serial.num_merged_bytes > 0);
+  REQUIRE(serial.max_stack_bytes > 0);
+
+  // The counted work does not depend upon the schedule.
+  for (bool dataflow : {false, true}) {
+    const catamari::SparseLDLResult<double> result = factor(dataflow, 0);
+    REQUIRE(result.num_factor_tasks == serial.num_factor_tasks);
+    REQUIRE(result.num_trsm_tasks == serial.num_trsm_tasks);
+    REQUIRE(result.num_herk_tasks == serial.num_herk_tasks);
+    REQUIRE(result.num_merge_tasks == serial.num_merge_tasks);
+    REQUIRE(result.num_merged_bytes == serial.num_merged_bytes);
+    REQUIRE(result.max_stack_bytes <= serial.max_stack_bytes);
+  }
+}
+
+TEST_CASE("Memory estimate", "[Memory estimate]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 25, 0.1);
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.min_parallel_threshold = 0;
+  ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+  catamari::SparseLDL<double> ldl;
+  const catamari::supernodal_ldl::MemoryEstimate estimate =
+      ldl.EstimateMemory(matrix, ldl_control, 4, 8);
+  REQUIRE(estimate.num_threads == 4);
+  REQUIRE(estimate.factor_bytes > 0);
+  REQUIRE(estimate.solve_panel_bytes == 0);
+  REQUIRE(estimate.structure_bytes > 0);
+  REQUIRE(estimate.serial_frontal_bytes > 0);
+  REQUIRE(estimate.parallel_frontal_bytes > 0);
+  REQUIRE(estimate.solve_workspace_bytes >=
+          8 * sizeof(double) * std::size_t(matrix.NumRows()));
+  const catamari::supernodal_ldl::MemoryEstimate serial_estimate =
+      ldl.supernodal_factorization->EstimateMemory(1);
+  REQUIRE(serial_estimate.parallel_frontal_bytes ==
+          serial_estimate.serial_frontal_bytes);
+  REQUIRE(serial_estimate.factor_bytes == estimate.factor_bytes);
+
+  // A serial factorization frees each root's stack before the next, so it
+  // attains the serial peak, while four threads stay within their bound.
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_threshold =
+      std::numeric_limits<double>::infinity();
+  catamari::SparseLDLResult<double> result = ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(result.peak_frontal_bytes == estimate.serial_frontal_bytes);
+  REQUIRE(result.max_stack_bytes <= result.peak_frontal_bytes);
+
+  ldl_control.supernodal_control.min_parallel_threshold = 0;
+  tbb::task_arena arena(4);
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(result.peak_frontal_bytes > 0);
+  REQUIRE(result.peak_frontal_bytes <= estimate.parallel_frontal_bytes);
+}
+
+TEST_CASE("Heavy chains", "[Heavy chains]") {
+  // A banded matrix, whose assembly tree is dominated by chains, and a 2D
+  // Laplacian.
+  const Int num_band_rows = 600;
+  const Int bandwidth = 6;
+  catamari::CoordinateMatrix<double> banded;
+  banded.Resize(num_band_rows, num_band_rows);
+  banded.ReserveEntryAdditions((2 * bandwidth + 1) * num_band_rows);
+  for (Int row = 0; row < num_band_rows; ++row) {
+    banded.QueueEntryAddition(row, row, 2. * bandwidth + 1.);
+    for (Int offset = 1; offset <= bandwidth; ++offset) {
+      if (row >= offset) banded.QueueEntryAddition(row, row - offset, -1.);
+      if (row + offset < num_band_rows) {
+        banded.QueueEntryAddition(row, row + offset, -1.);
+      }
+    }
+  }
+  banded.FlushEntryQueues();
+  const catamari::CoordinateMatrix<double> laplacian =
+      ShiftedLaplacian(30, 25, 0.1);
+
+  // Factors within a multithreaded task arena with every subtree scheduled
+  // in parallel, with or without splitting the chains.
+  auto factor = [&](const catamari::CoordinateMatrix<double>& matrix,
+                    bool split_heavy_chains) {
+    catamari::SparseLDLControl<double> ldl_control;
+    ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+    ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+    ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+    ldl_control.supernodal_control.dataflow_scheduling = false;
+    ldl_control.supernodal_control.split_heavy_chains = split_heavy_chains;
+    ldl_control.supernodal_control.min_parallel_threshold = 0;
+    ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+    catamari::SparseLDL<double> ldl;
+    const catamari::supernodal_ldl::MemoryEstimate estimate =
+        ldl.EstimateMemory(matrix, ldl_control, 4, 1);
+    catamari::SparseLDLResult<double> result;
+    tbb::task_arena arena(4);
+    arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+    REQUIRE(result.num_successful_pivots == matrix.NumRows());
+    REQUIRE(RelativeResidual(matrix, ldl) <=
+            1e3 * std::numeric_limits<double>::epsilon());
+    REQUIRE(result.peak_frontal_bytes <= estimate.parallel_frontal_bytes);
+    return result;
+  };
+
+  // The counted work does not depend upon the splitting.
+  const catamari::CoordinateMatrix<double>* matrices[] = {&banded,
+                                                          &laplacian};
+  for (const catamari::CoordinateMatrix<double>* matrix : matrices) {
+    const catamari::SparseLDLResult<double> unsplit = factor(*matrix, false);
+    const catamari::SparseLDLResult<double> split = factor(*matrix, true);
+    REQUIRE(split.num_factor_tasks == unsplit.num_factor_tasks);
+    REQUIRE(split.num_trsm_tasks == unsplit.num_trsm_tasks);
+    REQUIRE(split.num_herk_tasks == unsplit.num_herk_tasks);
+    REQUIRE(split.num_merge_tasks == unsplit.num_merge_tasks);
+    REQUIRE(split.num_merged_bytes == unsplit.num_merged_bytes);
+  }
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <limits>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/norms.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns the saddle-point matrix
+//
+//   | H  B' |
+//   | B  0  |,
+//
+// where H is a shifted 1D negative Laplacian over 'num_nodes' nodes and each
+// row of B constrains the difference of two neighboring nodes.
+template <typename Field>
+catamari::CoordinateMatrix<Field> SaddlePointMatrix(Int num_nodes,
+                                                    const Field& shift) {
+  const Int num_rows = 2 * num_nodes - 1;
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(7 * num_nodes);
+  for (Int node = 0; node < num_nodes; ++node) {
+    matrix.QueueEntryAddition(node, node, Field{2} + shift);
+    if (node > 0) matrix.QueueEntryAddition(node, node - 1, Field{-1});
+    if (node < num_nodes - 1) {
+      const Int constraint = num_nodes + node;
+      matrix.QueueEntryAddition(node, node + 1, Field{-1});
+      matrix.QueueEntryAddition(node, constraint, Field{1});
+      matrix.QueueEntryAddition(node + 1, constraint, Field{-1});
+      matrix.QueueEntryAddition(constraint, node, Field{1});
+      matrix.QueueEntryAddition(constraint, node + 1, Field{-1});
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the relative residual of the solution of 'matrix x = ones'.
+template <typename Field>
+catamari::ComplexBase<Field> RelativeResidual(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    const catamari::SparseLDL<Field>& ldl) {
+  const Int num_rows = matrix.NumRows();
+  BlasMatrix<Field> right_hand_sides;
+  right_hand_sides.Resize(num_rows, 1, Field{1});
+  BlasMatrix<Field> solution = right_hand_sides;
+  ldl.Solve(&solution.view);
+  BlasMatrix<Field> residual = right_hand_sides;
+  catamari::ApplySparse(Field{-1}, matrix, solution.ConstView(), Field{1},
+                        &residual.view);
+  return catamari::EuclideanNorm(residual.ConstView()) /
+         catamari::EuclideanNorm(right_hand_sides.ConstView());
+}
+
+// Returns the ordering of the saddle-point matrix with its (zero-diagonal)
+// constraint rows first, so that each of them forms a leaf supernode whose
+// pivot must be delayed into its parent.
+catamari::SymmetricOrdering ConstraintsFirstOrdering(Int num_nodes) {
+  const Int num_rows = 2 * num_nodes - 1;
+  catamari::SymmetricOrdering ordering;
+  ordering.permutation.Resize(num_rows);
+  for (Int node = 0; node < num_nodes; ++node) {
+    ordering.permutation[node] = num_nodes - 1 + node;
+    if (node < num_nodes - 1) {
+      ordering.permutation[num_nodes + node] = node;
+    }
+  }
+  catamari::InvertPermutation(ordering.permutation,
+                              &ordering.inverse_permutation);
+  return ordering;
+}
+
+// Factors the saddle-point matrix with its constraint rows ordered first and
+// then refactors it with the refolded analysis.
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_nodes = 100;
+  const catamari::CoordinateMatrix<Field> matrix =
+      SaddlePointMatrix(num_nodes, shift);
+  const Int num_rows = matrix.NumRows();
+  const catamari::SymmetricOrdering ordering =
+      ConstraintsFirstOrdering(num_nodes);
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.delayed_pivoting = true;
+
+  catamari::SparseLDL<Field> ldl;
+  catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ordering, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_delayed_pivots > 0);
+  if (factorization_type == catamari::kLDLAdjointFactorization) {
+    REQUIRE(result.num_positive_pivots == num_nodes);
+    REQUIRE(result.num_negative_pivots == num_nodes - 1);
+  }
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  // The refolded supernodes accept their pivots in order.
+  result = ldl.RefactorWithFixedSparsityPattern(matrix);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_delayed_pivots == 0);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+}
+
+// Refactors the saddle-point matrix through a conversion plan, which the
+// refolding after the delayed pivots of the first refactorization leaves
+// stale, and then twice through the re-formed plan.
+template <typename Field>
+void RunPlanTest(catamari::SymmetricFactorizationType factorization_type,
+                 const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_nodes = 100;
+  const catamari::CoordinateMatrix<Field> matrix =
+      SaddlePointMatrix(num_nodes, shift);
+  const Int num_rows = matrix.NumRows();
+  catamari::Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.delayed_pivoting = true;
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ConstraintsFirstOrdering(num_nodes), ldl_control,
+             /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  REQUIRE(ldl.ConversionPlanIsCurrent(cplan));
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  catamari::SparseLDLResult<Field> result =
+      ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_delayed_pivots > 0);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  // The refolding moved the destinations of the plan's entries.
+  REQUIRE(!ldl.ConversionPlanIsCurrent(cplan));
+  REQUIRE_THROWS(ldl.RefactorWithFixedSparsityPattern(cplan, values.Data()));
+
+  ldl.FormConversionPlan(matrix, &cplan);
+  for (Int pass = 0; pass < 2; ++pass) {
+    result = ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(result.num_delayed_pivots == 0);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+    REQUIRE(ldl.ConversionPlanIsCurrent(cplan));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, 0.1);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(0.1, 0.5));
+}
+
+TEST_CASE("Plan", "[Plan]") {
+  RunPlanTest<double>(catamari::kLDLAdjointFactorization, 0.1);
+  RunPlanTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                       mantis::Complex<double>(0.1, 0.5));
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <vector>
+
+#include "catamari.h"
+#include "catch2/catch.hpp"
+
+namespace {
+
+// Draws a batch of samples from the lower triangle of the kernel, which is
+// stored with the given leading dimension.
+std::vector<std::vector<CatamariInt>> SampleBatch(
+    CatamariInt num_rows, CatamariInt leading_dim, CatamariInt num_samples,
+    CatamariInt seed, std::vector<double>* kernel) {
+  CatamariBlasMatrixViewDouble view;
+  view.height = num_rows;
+  view.width = num_rows;
+  view.leading_dim = leading_dim;
+  view.data = kernel->data();
+
+  CatamariBufferInt offsets, samples;
+  CatamariBufferIntInit(&offsets);
+  CatamariBufferIntInit(&samples);
+  CatamariSampleLowerHermitianDPPBatchDouble(
+      16 /* block_size */, false /* maximum_likelihood */, num_samples, seed,
+      &view, &offsets, &samples);
+  REQUIRE(offsets.size == num_samples + 1);
+  REQUIRE(offsets.data[0] == 0);
+  REQUIRE(offsets.data[num_samples] == samples.size);
+
+  std::vector<std::vector<CatamariInt>> batch(num_samples);
+  for (CatamariInt index = 0; index < num_samples; ++index) {
+    batch[index].assign(samples.data + offsets.data[index],
+                        samples.data + offsets.data[index + 1]);
+  }
+  CatamariBufferIntDestroy(&offsets);
+  CatamariBufferIntDestroy(&samples);
+  return batch;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("C DPP batch", "[C DPP batch]") {
+  // A kernel with diagonal 1/2 and small off-diagonal entries, stored as the
+  // leading block of a larger array whose remaining entries are sentinels.
+  const CatamariInt num_rows = 60;
+  const CatamariInt leading_dim = 2 * num_rows;
+  const double sentinel = 7.;
+  std::vector<double> kernel(leading_dim * num_rows, sentinel);
+  for (CatamariInt j = 0; j < num_rows; ++j) {
+    for (CatamariInt i = j; i < num_rows; ++i) {
+      kernel[i + j * leading_dim] = i == j ? 0.5 : 0.01;
+    }
+  }
+  const std::vector<double> kernel_copy = kernel;
+
+  const CatamariInt num_samples = 200;
+  const std::vector<std::vector<CatamariInt>> batch =
+      SampleBatch(num_rows, leading_dim, num_samples, 5, &kernel);
+
+  // The kernel is left unmodified.
+  REQUIRE(kernel == kernel_copy);
+
+  // Each sample is sorted and the mean sample size is near the trace.
+  double mean_size = 0;
+  for (const std::vector<CatamariInt>& sample : batch) {
+    for (std::size_t index = 1; index < sample.size(); ++index) {
+      REQUIRE(sample[index - 1] < sample[index]);
+    }
+    mean_size += sample.size();
+  }
+  mean_size /= num_samples;
+  REQUIRE(std::abs(mean_size - 0.5 * num_rows) < 2.);
+
+  // The samples are reproducible from the seed.
+  REQUIRE(SampleBatch(num_rows, leading_dim, num_samples, 5, &kernel) ==
+          batch);
+  REQUIRE(SampleBatch(num_rows, leading_dim, num_samples, 6, &kernel) !=
+          batch);
+}
@@ -7,6 +7,7 @@
  */
 #define CATCH_CONFIG_MAIN
 #include <iostream>
+#include <tbb/task_arena.h>
 #include "catamari/blas_matrix.hpp"
 #include "catamari/dense_factorizations.hpp"
 #include "catamari/norms.hpp"
@@ -283,6 +284,258 @@ void RunLDLTransposeFactorization(Int tile_size, Int block_size,
   REQUIRE(relative_residual <= tolerance);
 }
 
+// Sets the coupling between the primal index 'j' and a dual index.
+template <typename Real>
+void KKTCoupling(Int j, Real* value) {
+  *value = 1 + j % 4;
+}
+
+template <typename Real>
+void KKTCoupling(Int j, Complex<Real>* value) {
+  *value = Complex<Real>(1 + j % 4, j % 2);
+}
+
+// Fills 'matrix' with the saddle-point matrix [-shift I, B; B', H], where H
+// is Hermitian positive-definite with 'primal_size' rows and B has
+// 'dual_size' (at most 'primal_size') rows. The dual variables are ordered
+// first so that, without a shift, the leading pivot is zero.
+template <typename Field>
+void InitializeKKT(Int primal_size, Int dual_size, double shift,
+                   BlasMatrix<Field>* matrix) {
+  const Int matrix_size = primal_size + dual_size;
+  matrix->Resize(matrix_size, matrix_size, Field{0});
+  for (Int i = 0; i < dual_size; ++i) {
+    matrix->Entry(i, i) = Field(-shift);
+  }
+  for (Int j = 0; j < primal_size; ++j) {
+    const Int index = dual_size + j;
+    matrix->Entry(index, index) = Field(2 + j % 3);
+    if (j + 1 < primal_size) {
+      matrix->Entry(index + 1, index) = Field{-1};
+      matrix->Entry(index, index + 1) = Field{-1};
+    }
+    for (Int i = 0; i < dual_size; ++i) {
+      if ((i + 2 * j) % 5 == 0 || j == i) {
+        Field value;
+        KKTCoupling(j, &value);
+        if (j == i) {
+          // Ensure that B has full row rank.
+          value += Field(4 + i);
+        }
+        matrix->Entry(index, i) = value;
+        matrix->Entry(i, index) = catamari::Conjugate(value);
+      }
+    }
+  }
+}
+
+// Checks that the Bunch-Kaufman factorization of 'matrix' (stored in full)
+// succeeds, and that its solves have small residuals, returning the number
+// of 2x2 pivots.
+template <typename Field>
+Int RunBunchKaufmanLDLAdjointFactorization(Int block_size,
+                                           const BlasMatrix<Field>& matrix) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int matrix_size = matrix.Height();
+  const Int num_rhs = 3;
+  BlasMatrix<Field> factor = matrix;
+  BlasMatrix<Int> permutation(matrix_size, 1);
+  Buffer<Int> pivot_sizes;
+  REQUIRE(catamari::BunchKaufmanLDLAdjointFactorization(
+              block_size, &factor.view, &permutation.view, &pivot_sizes) ==
+          matrix_size);
+
+  BlasMatrix<Field> right_hand_sides(matrix_size, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < matrix_size; ++i) {
+      right_hand_sides(i, j) = Field(double((3 * i + j) % 7) - 3.);
+    }
+  }
+  BlasMatrix<Field> solutions = right_hand_sides;
+  catamari::BunchKaufmanLDLAdjointSolve(factor.ConstView(),
+                                        permutation.ConstView(), pivot_sizes,
+                                        &solutions.view);
+
+  BlasMatrix<Field> residuals = right_hand_sides;
+  catamari::MatrixMultiplyNormalNormal(Field{-1}, matrix.ConstView(),
+                                       solutions.ConstView(), Field{1},
+                                       &residuals.view);
+  const Real relative_residual =
+      catamari::EuclideanNorm(residuals.ConstView()) /
+      catamari::EuclideanNorm(right_hand_sides.ConstView());
+  const Real tolerance = 100 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(relative_residual <= tolerance);
+
+  Int num_two_by_two = 0;
+  for (Int i = 0; i < matrix_size; ++i) {
+    num_two_by_two += pivot_sizes[i] == 2;
+  }
+  return num_two_by_two;
+}
+
+// Returns the maximum deviation of the lower triangle of the factorization of
+// 'matrix' computed, within a TBB arena of four threads, by 'factorization'
+// from that computed sequentially by 'reference_factorization', relative to
+// the largest entry of the latter.
+template <typename Field, class Factorization, class ReferenceFactorization>
+catamari::ComplexBase<Field> FactorizationDeviation(
+    const BlasMatrix<Field>& matrix, const Factorization& factorization,
+    const ReferenceFactorization& reference_factorization) {
+  typedef catamari::ComplexBase<Field> Real;
+  BlasMatrix<Field> expected = matrix;
+  BlasMatrix<Field> factored = matrix;
+  const Int matrix_size = matrix.Height();
+  REQUIRE(reference_factorization(&expected.view) == matrix_size);
+
+  tbb::task_arena arena(4);
+  Int num_pivots;
+  arena.execute([&]() { num_pivots = factorization(&factored.view); });
+  REQUIRE(num_pivots == matrix_size);
+
+  Real deviation = 0;
+  Real max_entry = 0;
+  for (Int j = 0; j < matrix_size; ++j) {
+    for (Int i = j; i < matrix_size; ++i) {
+      deviation =
+          std::max(deviation, std::abs(factored(i, j) - expected(i, j)));
+      max_entry = std::max(max_entry, std::abs(expected(i, j)));
+    }
+  }
+  return deviation / max_entry;
+}
+
+// Checks that the tiled factorizations match the sequential ones.
+template <typename Field>
+void RunTiledFactorizations(Int tile_size, Int block_size, Int matrix_size) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 100 * std::numeric_limits<Real>::epsilon();
+  BlasMatrix<Field> matrix;
+  Buffer<Field> buffer;
+
+  InitializeHPD(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::TiledLowerCholeskyFactorization(
+                    tile_size, block_size, view);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::LowerCholeskyFactorization(block_size,
+                                                            view);
+              }) <= tolerance);
+
+  InitializeHermitian(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::TiledLDLAdjointFactorization(
+                    tile_size, block_size, view, &buffer);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::LDLAdjointFactorization(block_size, view);
+              }) <= tolerance);
+
+  InitializeSymmetric(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::TiledLDLTransposeFactorization(
+                    tile_size, block_size, view, &buffer);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::LDLTransposeFactorization(block_size, view);
+              }) <= tolerance);
+}
+
+// Checks that the recursive factorizations match the blocked ones, including
+// the dynamic regularizations, which are here applied to every pivot.
+template <typename Field>
+void RunRecursiveFactorizations(Int block_size, Int matrix_size) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 100 * std::numeric_limits<Real>::epsilon();
+  BlasMatrix<Field> matrix;
+
+  InitializeHPD(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::RecursiveLowerCholeskyFactorization(view);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::BlockedLowerCholeskyFactorization(
+                    block_size, view);
+              }) <= tolerance);
+
+  Buffer<bool> signatures(matrix_size, true);
+  catamari::DynamicRegularizationParams<Field> params;
+  params.enabled = true;
+  params.positive_threshold = 5 * matrix_size;
+  params.negative_threshold = 5 * matrix_size;
+  params.signatures = &signatures;
+  params.inverse_permutation = nullptr;
+  std::vector<std::pair<Int, Real>> regularization, expected_regularization;
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::
+                    RecursiveDynamicallyRegularizedLowerCholeskyFactorization(
+                        params, view, &regularization);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::
+                    BlockedDynamicallyRegularizedLowerCholeskyFactorization(
+                        block_size, params, view, &expected_regularization);
+              }) <= tolerance);
+  REQUIRE(regularization.size() == std::size_t(matrix_size));
+  for (Int i = 0; i < matrix_size; ++i) {
+    REQUIRE(regularization[i].first == expected_regularization[i].first);
+    REQUIRE(std::abs(regularization[i].second -
+                     expected_regularization[i].second) <=
+            tolerance * matrix_size);
+  }
+
+  regularization.clear();
+  expected_regularization.clear();
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::
+                    RecursiveDynamicallyRegularizedLDLAdjointFactorization(
+                        params, view, &regularization);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::
+                    BlockedDynamicallyRegularizedLDLAdjointFactorization(
+                        block_size, params, view, &expected_regularization);
+              }) <= tolerance);
+  REQUIRE(regularization.size() == expected_regularization.size());
+  for (std::size_t i = 0; i < regularization.size(); ++i) {
+    REQUIRE(regularization[i].first == expected_regularization[i].first);
+  }
+
+  InitializeHermitian(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::RecursiveLDLAdjointFactorization(view);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::BlockedLDLAdjointFactorization(block_size,
+                                                                view);
+              }) <= tolerance);
+
+  InitializeSymmetric(matrix_size, &matrix);
+  REQUIRE(FactorizationDeviation(
+              matrix,
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::RecursiveLDLTransposeFactorization(view);
+              },
+              [&](BlasMatrixView<Field>* view) {
+                return catamari::BlockedLDLTransposeFactorization(block_size,
+                                                                  view);
+              }) <= tolerance);
+}
+
 }  // anonymous namespace
 
 TEST_CASE("Double", "Double") {
@@ -434,3 +687,42 @@ TEST_CASE("ComplexDoubleDouble", "ComplexDoubleDouble") {
                                       &extra_buffer);
   }
 }
+
+TEST_CASE("Tiled", "Tiled") {
+  // Include a partial trailing tile.
+  RunTiledFactorizations<double>(64, 16, 300);
+  RunTiledFactorizations<Complex<double>>(48, 16, 200);
+}
+
+TEST_CASE("Recursive", "Recursive") {
+  // Include sizes at, and just beyond, the base case and uneven splits.
+  for (Int matrix_size : {32, 33, 97, 300}) {
+    RunRecursiveFactorizations<double>(16, matrix_size);
+    RunRecursiveFactorizations<Complex<double>>(16, matrix_size);
+  }
+}
+
+TEST_CASE("Bunch-Kaufman", "Bunch-Kaufman") {
+  for (Int block_size : {1, 7, 64}) {
+    BlasMatrix<double> matrix;
+
+    // Without a regularization of the dual block, the unpivoted
+    // factorization breaks down at its first zero pivot.
+    InitializeKKT(40, 30, 0., &matrix);
+    BlasMatrix<double> unpivoted = matrix;
+    REQUIRE(catamari::LDLAdjointFactorization(block_size, &unpivoted.view) <
+            matrix.Height());
+    REQUIRE(RunBunchKaufmanLDLAdjointFactorization(block_size, matrix) > 0);
+
+    InitializeKKT(40, 30, 1e-8, &matrix);
+    RunBunchKaufmanLDLAdjointFactorization(block_size, matrix);
+
+    BlasMatrix<Complex<double>> complex_matrix;
+    InitializeKKT(50, 45, 0., &complex_matrix);
+    REQUIRE(RunBunchKaufmanLDLAdjointFactorization(block_size,
+                                                   complex_matrix) > 0);
+
+    InitializeHermitian(100, &matrix);
+    RunBunchKaufmanLDLAdjointFactorization(block_size, matrix);
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_row_deferral.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+
+namespace {
+
+// Returns a diagonally-dominant 2D Laplacian over an n x n grid, bordered by
+// 'num_dense' trailing rows which couple to every grid vertex, and followed by
+// 'num_isolated' decoupled rows.
+catamari::CoordinateMatrix<double> BorderedLaplacian(Int num_x_elements,
+                                                     Int num_dense,
+                                                     Int num_isolated) {
+  catamari::CoordinateMatrix<double> matrix;
+  const Int num_grid_rows = num_x_elements * num_x_elements;
+  const Int num_rows = num_grid_rows + num_dense + num_isolated;
+  const double coupling = 0.1;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions((5 + 2 * num_dense) * num_grid_rows +
+                               num_dense + num_isolated);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_x_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, 5 + coupling * num_dense);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -1);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -1);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, -1);
+      }
+      if (y < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, -1);
+      }
+      for (Int dense = 0; dense < num_dense; ++dense) {
+        const Int dense_row = num_grid_rows + dense;
+        matrix.QueueEntryAddition(index, dense_row, coupling);
+        matrix.QueueEntryAddition(dense_row, index, coupling);
+      }
+    }
+  }
+  for (Int dense = 0; dense < num_dense; ++dense) {
+    const Int dense_row = num_grid_rows + dense;
+    matrix.QueueEntryAddition(dense_row, dense_row, 1 + coupling * num_rows);
+  }
+  for (Int row = num_grid_rows + num_dense; row < num_rows; ++row) {
+    matrix.QueueEntryAddition(row, row, 1);
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Detection", "[Detection]") {
+  const Int num_x_elements = 20;
+  const Int num_grid_rows = num_x_elements * num_x_elements;
+  const catamari::CoordinateMatrix<double> matrix =
+      BorderedLaplacian(num_x_elements, 2, 3);
+
+  catamari::DenseRowControl control;
+  catamari::DenseRowPartition partition;
+  REQUIRE(catamari::DetectDenseRows(matrix, control, &partition));
+  REQUIRE(partition.dense_rows.Size() == 2);
+  REQUIRE(partition.dense_rows[0] == num_grid_rows);
+  REQUIRE(partition.dense_rows[1] == num_grid_rows + 1);
+  REQUIRE(partition.max_dense_degree == num_grid_rows);
+  REQUIRE(partition.sparse_index[num_grid_rows + 2] == num_grid_rows);
+
+  Buffer<catamari::MatrixEntry<double>> sparse_entries;
+  catamari::SparseRowEntries(matrix, partition, &sparse_entries);
+  for (const catamari::MatrixEntry<double>& entry : sparse_entries) {
+    REQUIRE(entry.row < partition.sparse_rows.Size());
+    REQUIRE(entry.column < partition.sparse_rows.Size());
+  }
+
+  // Orders of each sparse row as its own supernode, where the grid rows form a
+  // chain and the isolated rows are roots, so that only the chain is coupled.
+  const Int num_sparse = partition.sparse_rows.Size();
+  catamari::SymmetricOrdering ordering;
+  ordering.permutation.Resize(num_sparse);
+  ordering.inverse_permutation.Resize(num_sparse);
+  ordering.supernode_sizes.Resize(num_sparse, 1);
+  ordering.assembly_forest.parents.Resize(num_sparse);
+  for (Int index = 0; index < num_sparse; ++index) {
+    ordering.permutation[index] = index;
+    ordering.inverse_permutation[index] = index;
+    ordering.assembly_forest.parents[index] =
+        index < num_grid_rows - 1 ? index + 1 : -1;
+  }
+  catamari::AppendDenseRows(matrix, partition, true, &ordering);
+
+  // The isolated rows move first, then the chain, then the dense supernode.
+  const Int num_rows = matrix.NumRows();
+  REQUIRE(ordering.supernode_sizes.Size() == num_sparse + 1);
+  REQUIRE(ordering.supernode_sizes[num_sparse] == 2);
+  REQUIRE(ordering.supernode_offsets[num_sparse + 1] == num_rows);
+  for (Int index = 0; index < 3; ++index) {
+    REQUIRE(ordering.inverse_permutation[index] == num_grid_rows + 2 + index);
+    REQUIRE(ordering.assembly_forest.parents[index] == -1);
+  }
+  REQUIRE(ordering.inverse_permutation[3] == 0);
+  REQUIRE(ordering.assembly_forest.parents[num_sparse - 1] == num_sparse);
+  REQUIRE(ordering.inverse_permutation[num_rows - 1] == num_grid_rows + 1);
+  REQUIRE(ordering.assembly_forest.roots.Size() == 4);
+  for (Int row = 0; row < num_rows; ++row) {
+    REQUIRE(ordering.inverse_permutation[ordering.permutation[row]] == row);
+  }
+}
+
+TEST_CASE("Factorization", "[Factorization]") {
+  const catamari::CoordinateMatrix<double> matrix = BorderedLaplacian(30, 3, 2);
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+
+  for (const catamari::SupernodalStrategy strategy :
+       {catamari::kScalarFactorization, catamari::kSupernodalFactorization}) {
+    catamari::SparseLDLControl<double> ldl_control;
+    ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+    ldl_control.supernodal_strategy = strategy;
+
+    catamari::SparseLDL<double> ldl;
+    catamari::SparseLDLResult<double> result = ldl.Factor(matrix, ldl_control);
+    REQUIRE(result.num_successful_pivots == matrix.NumRows());
+    REQUIRE(result.num_deferred_dense_rows == 3);
+    REQUIRE(result.max_deferred_row_degree == 900);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+    ldl_control.dense_row_control.defer_dense_rows = false;
+    result = ldl.Factor(matrix, ldl_control);
+    REQUIRE(result.num_deferred_dense_rows == 0);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::RelativeDifference;
+using catamari_test::RightHandSides;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors and solves a matrix with and without offloading every front with a
+// subdiagonal block (when a device is available), then refactors both, and
+// returns the maximum relative difference between their solutions.
+template <typename Field>
+catamari::ComplexBase<Field> RunOffloadTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, const Field& refactor_shift, Int num_rhs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(10, 9, 8, shift);
+  const catamari::CoordinateMatrix<Field> refactor_matrix =
+      ShiftedLaplacian(10, 9, 8, refactor_shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  catamari::SparseLDLControl<Field> offload_control = ldl_control;
+  offload_control.supernodal_control.device_offload.enabled = true;
+  offload_control.supernodal_control.device_offload.min_front_work = 0;
+
+  const bool supported =
+      catamari::supernodal_ldl::DeviceOffload<Field>::Supported();
+  tbb::task_arena arena(4);
+  catamari::SparseLDL<Field> ldl, offload_ldl;
+  Real max_difference = 0;
+  for (Int factorization = 0; factorization < 2; ++factorization) {
+    arena.execute([&]() {
+      catamari::SparseLDLResult<Field> result, offload_result;
+      if (factorization == 0) {
+        result = ldl.Factor(matrix, ldl_control);
+        offload_result = offload_ldl.Factor(matrix, offload_control);
+      } else {
+        result = ldl.RefactorWithFixedSparsityPattern(refactor_matrix);
+        offload_result =
+            offload_ldl.RefactorWithFixedSparsityPattern(refactor_matrix);
+      }
+      REQUIRE(result.num_successful_pivots == num_rows);
+      REQUIRE(offload_result.num_successful_pivots == num_rows);
+      REQUIRE(result.num_device_fronts == 0);
+      if (!supported) REQUIRE(offload_result.num_device_fronts == 0);
+    });
+
+    BlasMatrix<Field> reference, solution;
+    RightHandSides(num_rows, num_rhs, &reference);
+    RightHandSides(num_rows, num_rhs, &solution);
+    arena.execute([&]() {
+      ldl.Solve(&reference.view);
+      offload_ldl.Solve(&solution.view);
+    });
+    max_difference = std::max(
+        max_difference, RelativeDifference(solution.view, reference.view));
+  }
+  return max_difference;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Offloaded Cholesky", "[Cholesky]") {
+  REQUIRE(RunOffloadTest<double>(catamari::kCholeskyFactorization, 0.1, 0.3,
+                                 3) <= 1e-10);
+}
+
+TEST_CASE("Offloaded Adjoint", "[Adjoint]") {
+  REQUIRE(RunOffloadTest<catamari::Complex<double>>(
+              catamari::kLDLAdjointFactorization,
+              catamari::Complex<double>(-1., 0.),
+              catamari::Complex<double>(-2., 0.), 2) <= 1e-10);
+}
+
+TEST_CASE("Offloaded Transpose", "[Transpose]") {
+  REQUIRE(RunOffloadTest<catamari::Complex<float>>(
+              catamari::kLDLTransposeFactorization,
+              catamari::Complex<float>(-1., 0.5),
+              catamari::Complex<float>(-2., 0.25), 1) <= 1e-3);
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_RUNNER
+#include <mpi.h>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/distributed_sparse_ldl.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::RelativeDifference;
+using catamari_test::RightHandSides;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors and solves a matrix over all processes and with the shared-memory
+// factorization, and returns the maximum relative difference between their
+// solutions over all processes.
+template <typename Field>
+catamari::ComplexBase<Field> RunDistributedTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, Int num_rhs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(12, 11, 10, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<Field> ldl;
+  REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots == num_rows);
+
+  // Use small blocks and subgraphs so that every process shares several
+  // distributed fronts of several blocks.
+  catamari::DistributedSparseLDLControl<Field> control;
+  control.ldl_control = ldl_control;
+  control.block_size = 8;
+  control.min_distributed_size = 64;
+  catamari::DistributedSparseLDL<Field> distributed_ldl(MPI_COMM_WORLD);
+  const catamari::SparseLDLResult<Field> result =
+      distributed_ldl.Factor(matrix, control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<Field> reference, solution;
+  RightHandSides(num_rows, num_rhs, &reference);
+  RightHandSides(num_rows, num_rhs, &solution);
+  ldl.Solve(&reference.view);
+  distributed_ldl.Solve(&solution.view);
+
+  double difference = RelativeDifference(solution.view, reference.view);
+  MPI_Allreduce(MPI_IN_PLACE, &difference, 1, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+  return Real(difference);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Distributed Cholesky", "[Cholesky]") {
+  REQUIRE(RunDistributedTest<double>(catamari::kCholeskyFactorization, 0.1,
+                                     3) <= 1e-10);
+}
+
+TEST_CASE("Distributed Adjoint", "[Adjoint]") {
+  REQUIRE(RunDistributedTest<catamari::Complex<double>>(
+              catamari::kLDLAdjointFactorization,
+              catamari::Complex<double>(-1., 0.), 2) <= 1e-10);
+}
+
+TEST_CASE("Distributed Transpose", "[Transpose]") {
+  REQUIRE(RunDistributedTest<catamari::Complex<float>>(
+              catamari::kLDLTransposeFactorization,
+              catamari::Complex<float>(-1., 0.5), 1) <= 1e-3);
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  const int result = Catch::Session().run(argc, argv);
+  MPI_Finalize();
+  return result;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <vector>
+#include "catamari/sparse_hermitian_dpp.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+
+namespace {
+
+// Returns a scaled 2D negative Laplacian, whose eigenvalues lie in (0, 1).
+template <typename Field>
+catamari::CoordinateMatrix<Field> ScaledLaplacian(Int num_x_elements,
+                                                  Int num_y_elements) {
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_y_elements;
+  const Field scale{0.1};
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, Field{4} * scale);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -scale);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -scale);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, -scale);
+      }
+      if (y < num_y_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, -scale);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+bool Contains(const std::vector<Int>& sample, Int item) {
+  return std::binary_search(sample.begin(), sample.end(), item);
+}
+
+template <typename Field>
+void RunTest(catamari::SupernodalStrategy strategy,
+             catamari::LDLAlgorithm algorithm) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ScaledLaplacian<Field>(30, 25);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseHermitianDPPControl control;
+  control.supernodal_strategy = strategy;
+  control.supernodal_control.algorithm = algorithm;
+  catamari::SparseHermitianDPP<Field> dpp(matrix, control);
+
+  // Constraining each item to its maximum-likelihood decision leaves the
+  // maximum-likelihood sample unchanged.
+  const std::vector<Int> sample = dpp.Sample(true);
+  catamari::DPPConstraints consistent_constraints;
+  for (Int item = 0; item < num_rows; item += 7) {
+    if (Contains(sample, item)) {
+      consistent_constraints.included.push_back(item);
+    } else {
+      consistent_constraints.excluded.push_back(item);
+    }
+  }
+  REQUIRE(dpp.Sample(true, consistent_constraints) == sample);
+
+  // Random samples respect arbitrary constraints.
+  catamari::DPPConstraints constraints;
+  for (Int item = 0; item < num_rows; item += 11) {
+    constraints.included.push_back(item);
+  }
+  for (Int item = 5; item < num_rows; item += 13) {
+    if (item % 11) constraints.excluded.push_back(item);
+  }
+  for (Int iteration = 0; iteration < 10; ++iteration) {
+    const std::vector<Int> constrained_sample = dpp.Sample(false, constraints);
+    for (const Int& item : constraints.included) {
+      REQUIRE(Contains(constrained_sample, item));
+    }
+    for (const Int& item : constraints.excluded) {
+      REQUIRE(!Contains(constrained_sample, item));
+    }
+  }
+
+  // Forcing every item in the maximum-likelihood sample out removes it.
+  catamari::DPPConstraints exclusions;
+  exclusions.excluded = sample;
+  const std::vector<Int> excluded_sample = dpp.Sample(true, exclusions);
+  for (const Int& item : sample) {
+    REQUIRE(!Contains(excluded_sample, item));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") {
+  RunTest<double>(catamari::kSupernodalFactorization,
+                  catamari::kRightLookingLDL);
+  RunTest<double>(catamari::kSupernodalFactorization,
+                  catamari::kLeftLookingLDL);
+  RunTest<double>(catamari::kScalarFactorization, catamari::kRightLookingLDL);
+}
+
+TEST_CASE("Complex", "[Complex]") {
+  RunTest<catamari::Complex<double>>(catamari::kSupernodalFactorization,
+                                     catamari::kRightLookingLDL);
+}
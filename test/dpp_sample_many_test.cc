@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <vector>
+#include "catamari/sparse_hermitian_dpp.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+
+namespace {
+
+// Returns a scaled 2D negative Laplacian, whose eigenvalues lie in (0, 1).
+template <typename Field>
+catamari::CoordinateMatrix<Field> ScaledLaplacian(Int num_x_elements,
+                                                  Int num_y_elements) {
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_y_elements;
+  const Field scale{0.1};
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, Field{4} * scale);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -scale);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -scale);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, -scale);
+      }
+      if (y < num_y_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, -scale);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns true if the sample is a sorted list of distinct, valid indices.
+bool ValidSample(const std::vector<Int>& sample, Int num_rows) {
+  for (std::size_t index = 0; index < sample.size(); ++index) {
+    if (sample[index] < 0 || sample[index] >= num_rows) return false;
+    if (index > 0 && sample[index] <= sample[index - 1]) return false;
+  }
+  return true;
+}
+
+template <typename Field>
+void RunTest(catamari::LDLAlgorithm algorithm) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ScaledLaplacian<Field>(30, 25);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseHermitianDPPControl control;
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = algorithm;
+  catamari::SparseHermitianDPP<Field> dpp(matrix, control);
+
+  // Maximum-likelihood samples are deterministic, so every concurrent sample
+  // must match a sequential one.
+  const std::vector<Int> sample = dpp.Sample(true);
+  const catamari::ComplexBase<Field> log_likelihood = dpp.LogLikelihood();
+  const std::vector<std::vector<Int>> samples = dpp.SampleMany(12, true);
+  REQUIRE(samples.size() == 12u);
+  for (const std::vector<Int>& other_sample : samples) {
+    REQUIRE(other_sample == sample);
+  }
+
+  // The factor of the last sequential sample is preserved.
+  REQUIRE(dpp.LogLikelihood() == log_likelihood);
+
+  const std::vector<std::vector<Int>> random_samples =
+      dpp.SampleMany(20, false);
+  REQUIRE(random_samples.size() == 20u);
+  for (const std::vector<Int>& random_sample : random_samples) {
+    REQUIRE(ValidSample(random_sample, num_rows));
+  }
+
+  REQUIRE(dpp.SampleMany(0, false).empty());
+}
+
+// Checks that samplers with a common seed draw identical samples, whether one
+// at a time or concurrently.
+template <typename Field>
+void RunReproducibilityTest(catamari::LDLAlgorithm algorithm) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ScaledLaplacian<Field>(30, 25);
+  const Int num_samples = 5;
+
+  catamari::SparseHermitianDPPControl control;
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = algorithm;
+  control.supernodal_control.seed = 17;
+  catamari::SparseHermitianDPP<Field> dpp(matrix, control);
+  catamari::SparseHermitianDPP<Field> other_dpp(matrix, control);
+
+  std::vector<std::vector<Int>> samples;
+  for (Int index = 0; index < num_samples; ++index) {
+    samples.push_back(dpp.Sample(false));
+    REQUIRE(other_dpp.Sample(false) == samples.back());
+  }
+
+  if (algorithm == catamari::kRightLookingLDL) {
+    catamari::SparseHermitianDPP<Field> many_dpp(matrix, control);
+    REQUIRE(many_dpp.SampleMany(num_samples, false) == samples);
+
+    // The next sample continues from the streams consumed by 'SampleMany'.
+    REQUIRE(many_dpp.Sample(false) == dpp.Sample(false));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") {
+  RunTest<double>(catamari::kRightLookingLDL);
+  RunTest<double>(catamari::kLeftLookingLDL);
+}
+
+TEST_CASE("Complex", "[Complex]") {
+  RunTest<catamari::Complex<double>>(catamari::kRightLookingLDL);
+}
+
+TEST_CASE("Reproducible", "[Reproducible]") {
+  RunReproducibilityTest<double>(catamari::kRightLookingLDL);
+  RunReproducibilityTest<double>(catamari::kLeftLookingLDL);
+  RunReproducibilityTest<catamari::Complex<double>>(
+      catamari::kRightLookingLDL);
+}
@@ -107,6 +107,92 @@ void RunTest(Int num_rows,
   REQUIRE(relative_residual <= tolerance);
 }
 
+// Factors a tridiagonal matrix whose diagonal alternates between unit and
+// tiny entries (of the given signatures) and whose tiny couplings leave the
+// tiny pivots in need of regularization. Unlike a diagonal matrix, its
+// elimination tree is a path, so the regularizations of the children of the
+// serial subtrees of the multithreaded right-looking factorization must be
+// collected. If 'diagonal_output' is set, the shifts are instead written into
+// the result's diagonal.
+template <typename Field>
+void RunChainTest(Int num_rows,
+                  catamari::SymmetricFactorizationType factorization_type,
+                  const Buffer<bool>& signatures, bool diagonal_output) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real kEpsilon = std::numeric_limits<Real>::epsilon();
+
+  catamari::DynamicRegularizationControl<Field> dynamic_reg_control;
+  dynamic_reg_control.enabled = true;
+  dynamic_reg_control.signatures = signatures;
+  dynamic_reg_control.positive_threshold_exponent = 0.5;
+  dynamic_reg_control.negative_threshold_exponent = 0.5;
+  dynamic_reg_control.diagonal_output = diagonal_output;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.SetDynamicRegularization(dynamic_reg_control);
+
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(3 * num_rows);
+  for (Int index = 0; index < num_rows; ++index) {
+    const Real magnitude = index % 2 ? Real(1) : kEpsilon / 2;
+    matrix.QueueEntryAddition(index, index,
+                              signatures[index] ? magnitude : -magnitude);
+    if (index > 0) matrix.QueueEntryAddition(index, index - 1, kEpsilon);
+    if (index < num_rows - 1) {
+      matrix.QueueEntryAddition(index, index + 1, kEpsilon);
+    }
+  }
+  matrix.FlushEntryQueues();
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<Real> diagonal_reg;
+  ldl.DynamicRegularizationDiagonal(result, &diagonal_reg);
+  Int num_regularized = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    if (diagonal_reg(i) != Real(0)) ++num_regularized;
+  }
+  REQUIRE(num_regularized >= num_rows / 2);
+  if (diagonal_output) {
+    REQUIRE(result.dynamic_regularization.empty());
+    REQUIRE(result.dynamic_regularization_diagonal.Size() == num_rows);
+  } else {
+    REQUIRE(Int(result.dynamic_regularization.size()) == num_regularized);
+  }
+
+  // The refined solve must apply the same shifts that were factored.
+  catamari::RefinedSolveControl<Real> refined_control;
+  BlasMatrix<Field> refined_solution;
+  refined_solution.Resize(num_rows, 1, Field{0});
+  refined_solution(num_rows / 2, 0) = Field{1};
+  const catamari::RefinedSolveStatus<Real> refined_status =
+      ldl.DynamicallyRegularizedRefinedSolve(matrix, result, refined_control,
+                                             &refined_solution.view);
+  REQUIRE(refined_status.num_iterations >= 0);
+
+  BlasMatrix<Field> right_hand_sides;
+  right_hand_sides.Resize(num_rows, 1, Field{0});
+  right_hand_sides(num_rows / 2, 0) = Field{1};
+  BlasMatrix<Field> solution = right_hand_sides;
+  ldl.Solve(&solution.view);
+
+  BlasMatrix<Field> residual = right_hand_sides;
+  catamari::ApplySparse(Field{-1}, matrix, solution.ConstView(), Field{1},
+                        &residual.view);
+  for (Int i = 0; i < num_rows; ++i) {
+    residual(i) -= diagonal_reg(i) * solution(i);
+  }
+  const Real relative_residual = catamari::EuclideanNorm(residual.ConstView());
+  REQUIRE(relative_residual <= 100 * kEpsilon);
+}
+
 void RunTests(Int num_rows,
               catamari::SymmetricFactorizationType factorization_type,
               catamari::LDLAlgorithm ldl_algorithm, bool analytical_ordering,
@@ -224,3 +310,18 @@ TEST_CASE("2D left adjoint", "2D left adjoint") {
            dynamically_regularize, signatures, positive_threshold_exponent,
            negative_threshold_exponent);
 }
+
+TEST_CASE("Chain right adjoint", "[chain right adjoint]") {
+  const Int num_rows = 1000;
+  Buffer<bool> signatures(num_rows);
+  for (Int i = 0; i < num_rows; ++i) {
+    signatures[i] = i % 3 != 0;
+  }
+  for (const bool diagonal_output : {false, true}) {
+    RunChainTest<double>(num_rows, catamari::kLDLAdjointFactorization,
+                         signatures, diagonal_output);
+    RunChainTest<mantis::Complex<double>>(
+        num_rows, catamari::kLDLAdjointFactorization, signatures,
+        diagonal_output);
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <complex>
+#include <limits>
+#include <vector>
+#include "catamari/eigen_sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+
+namespace {
+
+// Returns the shifted 2D negative Laplacian, with either both triangles or
+// only the lower triangle stored.
+template <typename Scalar, typename StorageIndex>
+Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex> ShiftedLaplacian(
+    Int num_x_elements, Int num_y_elements, const Scalar& shift,
+    bool lower_only) {
+  const Int num_rows = num_x_elements * num_y_elements;
+  std::vector<Eigen::Triplet<Scalar, StorageIndex>> triplets;
+  auto add = [&](Int row, Int column, const Scalar& value) {
+    if (!lower_only || row >= column) {
+      triplets.emplace_back(row, column, value);
+    }
+  };
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      add(index, index, Scalar(4) + shift);
+      if (x > 0) add(index, index - 1, Scalar(-1));
+      if (x < num_x_elements - 1) add(index, index + 1, Scalar(-1));
+      if (y > 0) add(index, index - num_x_elements, Scalar(-1));
+      if (y < num_y_elements - 1) {
+        add(index, index + num_x_elements, Scalar(-1));
+      }
+    }
+  }
+  Eigen::SparseMatrix<Scalar, Eigen::ColMajor, StorageIndex> matrix(num_rows,
+                                                                    num_rows);
+  matrix.setFromTriplets(triplets.begin(), triplets.end());
+  matrix.makeCompressed();
+  return matrix;
+}
+
+// Factors the Laplacian, solves in place against a strided block of a larger
+// dense matrix, and then refactors a rescaled copy through the same plan.
+template <typename Field, typename StorageIndex>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, bool lower_only) {
+  typedef catamari::EigenSparseLDL<Field, StorageIndex> EigenLDL;
+  typedef typename EigenLDL::Scalar Scalar;
+  typedef catamari::ComplexBase<Field> Real;
+  const Scalar eigen_shift = catamari::EigenScalar<Field>::ToEigen(shift);
+  typename EigenLDL::SparseMatrix matrix =
+      ShiftedLaplacian<Scalar, StorageIndex>(20, 15, eigen_shift, lower_only);
+  const Int num_rows = matrix.rows();
+  const Int num_rhs = 3;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+
+  // The full matrix, from which the residuals are formed.
+  const typename EigenLDL::SparseMatrix full_matrix =
+      ShiftedLaplacian<Scalar, StorageIndex>(20, 15, eigen_shift, false);
+
+  EigenLDL ldl;
+  ldl.triangle_storage = lower_only;
+  for (Int pass = 0; pass < 2; ++pass) {
+    const catamari::SparseLDLResult<Field> result =
+        pass == 0 ? ldl.Factor(matrix, ldl_control)
+                  : ldl.RefactorWithFixedSparsityPattern(matrix);
+    REQUIRE(result.num_successful_pivots == num_rows);
+
+    typename EigenLDL::DenseMatrix storage =
+        EigenLDL::DenseMatrix::Random(num_rows + 7, num_rhs);
+    const typename EigenLDL::DenseMatrix right_hand_sides =
+        storage.topRows(num_rows);
+    ldl.Solve(storage.topRows(num_rows));
+    const Real scale = pass == 0 ? Real(1) : Real(2);
+    const typename EigenLDL::DenseMatrix residual =
+        right_hand_sides - scale * (full_matrix * storage.topRows(num_rows));
+    const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+    REQUIRE(residual.norm() <= tolerance * right_hand_sides.norm());
+
+    // Refactor twice the matrix through the plan.
+    matrix *= Scalar(2);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Full", "[Full]") {
+  RunTest<double, int>(catamari::kLDLAdjointFactorization, 0.1, false);
+}
+
+TEST_CASE("Lower", "[Lower]") {
+  RunTest<double, int>(catamari::kCholeskyFactorization, 0.1, true);
+}
+
+TEST_CASE("Wide indices", "[Wide indices]") {
+  RunTest<double, Int>(catamari::kLDLAdjointFactorization, 0.5, false);
+}
+
+TEST_CASE("Complex", "[Complex]") {
+  RunTest<mantis::Complex<double>, int>(catamari::kLDLTransposeFactorization,
+                                        mantis::Complex<double>(-1., 0.5),
+                                        false);
+}
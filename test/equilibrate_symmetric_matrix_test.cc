@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "catamari/equilibrate_symmetric_matrix.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns a symmetric matrix with a tridiagonal pattern (plus a coupling of
+// the first and last rows) whose entries span many orders of magnitude.
+catamari::CoordinateMatrix<double> BadlyScaledMatrix(Int num_rows) {
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(num_rows, num_rows);
+  auto scale = [](Int index) { return std::pow(10., (index % 9) - 4.); };
+  for (Int i = 0; i < num_rows; ++i) {
+    matrix.QueueEntryAddition(i, i, 3. * scale(i) * scale(i));
+    const Int j = (i + 1) % num_rows;
+    const double value = -(1. + (i % 3)) * scale(i) * scale(j);
+    matrix.QueueEntryAddition(i, j, value);
+    matrix.QueueEntryAddition(j, i, value);
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the maximum deviation from one of the row infinity norms.
+double MaxRowNormDeviation(const catamari::CoordinateMatrix<double>& matrix) {
+  std::vector<double> row_max_abs(matrix.NumRows(), 0.);
+  for (const catamari::MatrixEntry<double>& entry : matrix.Entries()) {
+    row_max_abs[entry.row] =
+        std::max(row_max_abs[entry.row], std::abs(entry.value));
+  }
+  double deviation = 0;
+  for (const double& norm : row_max_abs) {
+    deviation = std::max(deviation, std::abs(1. - norm));
+  }
+  return deviation;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Single pass", "[Single pass]") {
+  const catamari::CoordinateMatrix<double> matrix = BadlyScaledMatrix(50);
+  BlasMatrix<double> scaling;
+  catamari::ComputeSymmetricEquilibration(matrix, &scaling);
+  for (Int i = 0; i < matrix.NumRows(); ++i) {
+    double max_abs = 0;
+    for (Int index = matrix.RowEntryOffset(i);
+         index < matrix.RowEntryOffset(i + 1); ++index) {
+      max_abs = std::max(max_abs, std::abs(matrix.Entry(index).value));
+    }
+    REQUIRE(scaling(i) == std::sqrt(max_abs));
+  }
+}
+
+TEST_CASE("Convergence", "[Convergence]") {
+  const catamari::CoordinateMatrix<double> matrix = BadlyScaledMatrix(50);
+  const double tolerance = 1e-6;
+
+  catamari::EquilibrationControl<double> control;
+  control.max_iterations = 1;
+  catamari::CoordinateMatrix<double> single_pass = matrix;
+  BlasMatrix<double> scaling;
+  REQUIRE(catamari::EquilibrateSymmetricMatrix(&single_pass, &scaling,
+                                               control) == 1);
+  const double single_pass_deviation = MaxRowNormDeviation(single_pass);
+
+  control.max_iterations = 100;
+  control.tolerance = tolerance;
+  catamari::CoordinateMatrix<double> equilibrated = matrix;
+  const Int num_passes =
+      catamari::EquilibrateSymmetricMatrix(&equilibrated, &scaling, control);
+  REQUIRE(num_passes > 1);
+  REQUIRE(num_passes < control.max_iterations);
+  REQUIRE(MaxRowNormDeviation(equilibrated) <= tolerance);
+  REQUIRE(MaxRowNormDeviation(equilibrated) < single_pass_deviation);
+
+  // The matrix is rescaled by the returned scaling.
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    const catamari::MatrixEntry<double>& entry = matrix.Entry(index);
+    const double expected =
+        entry.value / (scaling(entry.row) * scaling(entry.column));
+    REQUIRE(std::abs(equilibrated.Entry(index).value - expected) <=
+            1e-12 * std::abs(expected));
+  }
+
+  // The scaling alone matches that of the in-place equilibration.
+  BlasMatrix<double> computed_scaling;
+  REQUIRE(catamari::ComputeSymmetricEquilibration(
+              matrix, &computed_scaling, control) == num_passes);
+  for (Int i = 0; i < matrix.NumRows(); ++i) {
+    REQUIRE(computed_scaling(i) == scaling(i));
+  }
+}
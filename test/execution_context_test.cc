@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/execution_context.hpp"
+#include "catamari/norms.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::ExecutionContext;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+#ifdef CATAMARI_HAVE_XMMINTRIN
+// Returns the number of the 'num_tasks' iterations of a parallel loop which
+// ran with both flush-to-zero and denormals-are-zero enabled.
+int NumFlushingTasks(int num_tasks) {
+  std::atomic<int> num_flushing(0);
+  tbb::parallel_for(0, num_tasks, [&](int task) {
+    // Keep each iteration busy long enough for the workers to join in.
+    volatile double sum = 0;
+    for (int i = 0; i < 1000; ++i) sum = sum + task * i;
+    if (_MM_GET_FLUSH_ZERO_MODE() == _MM_FLUSH_ZERO_ON &&
+        _MM_GET_DENORMALS_ZERO_MODE() == _MM_DENORMALS_ZERO_ON) {
+      ++num_flushing;
+    }
+  });
+  return num_flushing.load();
+}
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
+
+}  // anonymous namespace
+
+TEST_CASE("Arena", "[Arena]") {
+  catamari::ExecutionContextControl control;
+  control.num_threads = 2;
+  const ExecutionContext context(control);
+  REQUIRE(context.NumThreads() == 2);
+  REQUIRE(!context.IsActive());
+
+  // The work runs within the arena, whose concurrency bounds that of the
+  // parallel loops it launches.
+  std::atomic<int> max_thread_index(0);
+  const int max_concurrency = context.Execute([&]() {
+    REQUIRE(context.IsActive());
+    tbb::parallel_for(0, 1000, [&](int) {
+      const int thread = tbb::this_task_arena::current_thread_index();
+      int previous = max_thread_index.load();
+      while (thread > previous &&
+             !max_thread_index.compare_exchange_weak(previous, thread)) {
+      }
+    });
+    return tbb::this_task_arena::max_concurrency();
+  });
+  REQUIRE(max_concurrency == 2);
+  REQUIRE(max_thread_index.load() < 2);
+  REQUIRE(!context.IsActive());
+
+  // Nested calls run directly, and a null context runs the work directly.
+  int depth = 0;
+  context.Execute([&]() { context.Execute([&]() { depth = 2; }); });
+  REQUIRE(depth == 2);
+  REQUIRE(catamari::RunInExecutionContext(nullptr, []() { return 3; }) == 3);
+  REQUIRE(catamari::RunInExecutionContext(&context, [&]() {
+            return context.IsActive();
+          }));
+}
+
+TEST_CASE("Bound factorization", "[Bound factorization]") {
+  catamari::ExecutionContextControl control;
+  control.num_threads = 3;
+  const ExecutionContext context(control);
+
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 30, 0.5);
+  const Int num_rows = matrix.NumRows();
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.execution_context = &context;
+
+  catamari::SparseLDL<double> ldl;
+  catamari::SparseLDLResult<double> result = ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<double> right_hand_sides(num_rows, 4, 1.);
+  BlasMatrix<double> solution = right_hand_sides;
+  ldl.Solve(&solution.view);
+  BlasMatrix<double> residual = right_hand_sides;
+  catamari::ApplySparse(-1., matrix, solution.ConstView(), 1.,
+                        &residual.view);
+  REQUIRE(catamari::EuclideanNorm(residual.ConstView()) <=
+          1e-10 * catamari::EuclideanNorm(right_hand_sides.ConstView()));
+
+  // A clone keeps the binding, and its solves match those of the original.
+  std::unique_ptr<catamari::SparseLDL<double>> clone = ldl.Clone();
+  BlasMatrix<double> clone_solution = right_hand_sides;
+  clone->Solve(&clone_solution.view);
+  for (Int j = 0; j < solution.Width(); ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(std::abs(clone_solution(i, j) - solution(i, j)) <= 1e-12);
+    }
+  }
+
+  // Several threads may share the context.
+  std::vector<BlasMatrix<double>> solutions(4, right_hand_sides);
+  tbb::task_arena outer_arena(4);
+  outer_arena.execute([&]() {
+    tbb::parallel_for(0, 4, [&](int index) {
+      catamari::SolveWorkspace<double> workspace;
+      ldl.Solve(&solutions[index].view, &workspace);
+    });
+  });
+  for (const BlasMatrix<double>& concurrent_solution : solutions) {
+    for (Int j = 0; j < solution.Width(); ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        REQUIRE(std::abs(concurrent_solution(i, j) - solution(i, j)) <=
+                1e-12);
+      }
+    }
+  }
+}
+
+#ifdef CATAMARI_HAVE_XMMINTRIN
+TEST_CASE("Flush to zero", "[Flush to zero]") {
+  const int num_tasks = 2000;
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    REQUIRE(NumFlushingTasks(num_tasks) == 0);
+
+    // Every task of the call flushes, whichever thread runs it.
+    REQUIRE(catamari::RunWithFlushToZero([&]() {
+              return NumFlushingTasks(num_tasks);
+            }) == num_tasks);
+
+    // Once the call returns, neither the calling thread nor the workers of
+    // the arena of the caller flush.
+    REQUIRE(NumFlushingTasks(num_tasks) == 0);
+
+    // Likewise for an unbound factorization and solve.
+    const catamari::CoordinateMatrix<double> matrix =
+        ShiftedLaplacian(40, 40, 0.5);
+    catamari::SparseLDLControl<double> ldl_control;
+    ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+    ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+    catamari::SparseLDL<double> ldl;
+    REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots ==
+            matrix.NumRows());
+    BlasMatrix<double> solution(matrix.NumRows(), 2, 1.);
+    ldl.Solve(&solution.view);
+    REQUIRE(NumFlushingTasks(num_tasks) == 0);
+  });
+
+  // Every task of a context flushes, and no worker keeps flushing once the
+  // context is destroyed.
+  {
+    catamari::ExecutionContextControl control;
+    control.num_threads = 4;
+    const ExecutionContext context(control);
+    REQUIRE(context.Execute([&]() { return NumFlushingTasks(num_tasks); }) ==
+            num_tasks);
+  }
+  arena.execute([&]() { REQUIRE(NumFlushingTasks(num_tasks) == 0); });
+}
+#endif  // ifdef CATAMARI_HAVE_XMMINTRIN
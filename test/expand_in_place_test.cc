@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::RelativeDifference;
+using catamari_test::RelativeResidual;
+using catamari_test::RightHandSides;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a matrix with the right-looking supernodal factorization, either
+// with every subtree processed serially or within a multithreaded task arena
+// with the default parallel thresholds, so that only the small subtrees are
+// serial.
+template <typename Field>
+void Factor(const catamari::CoordinateMatrix<Field>& matrix,
+            catamari::SymmetricFactorizationType factorization_type,
+            bool expand_in_place, bool parallel,
+            catamari::SparseLDL<Field>* ldl) {
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.expand_schur_complements_in_place =
+      expand_in_place;
+  catamari::SparseLDLResult<Field> result;
+  if (parallel) {
+    tbb::task_arena arena(4);
+    arena.execute([&]() { result = ldl->Factor(matrix, ldl_control); });
+  } else {
+    ldl_control.supernodal_control.min_parallel_threshold =
+        std::numeric_limits<double>::infinity();
+    result = ldl->Factor(matrix, ldl_control);
+  }
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+}
+
+// Checks that expanding the Schur complements in place over those of the
+// first children yields the same lower and diagonal factors, up to the
+// rounding of the reordered child updates, as the baseline stacks.
+template <typename Field>
+void RunTest(const catamari::CoordinateMatrix<Field>& matrix,
+             catamari::SymmetricFactorizationType factorization_type) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  const Int num_rows = matrix.NumRows();
+  const Int num_rhs = 3;
+
+  for (const bool parallel : {false, true}) {
+    catamari::SparseLDL<Field> baseline_ldl;
+    Factor(matrix, factorization_type, false, parallel, &baseline_ldl);
+    catamari::SparseLDL<Field> ldl;
+    Factor(matrix, factorization_type, true, parallel, &ldl);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(ldl.Permutation()[i] == baseline_ldl.Permutation()[i]);
+    }
+
+    BlasMatrix<Field> baseline_solution;
+    RightHandSides(num_rows, num_rhs, &baseline_solution);
+    BlasMatrix<Field> solution = baseline_solution;
+
+    baseline_ldl.LowerTriangularSolve(&baseline_solution.view);
+    ldl.LowerTriangularSolve(&solution.view);
+    REQUIRE(RelativeDifference(solution.view, baseline_solution.view) <=
+            tolerance);
+
+    baseline_ldl.DiagonalSolve(&baseline_solution.view);
+    ldl.DiagonalSolve(&solution.view);
+    REQUIRE(RelativeDifference(solution.view, baseline_solution.view) <=
+            tolerance);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("2D Cholesky", "[2D Cholesky]") {
+  RunTest(ShiftedLaplacian(40, 35, 0.1), catamari::kCholeskyFactorization);
+}
+
+TEST_CASE("2D Transpose", "[2D Transpose]") {
+  typedef mantis::Complex<double> Field;
+  RunTest(ShiftedLaplacian(30, 25, Field(-1., 0.5)),
+          catamari::kLDLTransposeFactorization);
+}
+
+TEST_CASE("3D Adjoint", "[3D Adjoint]") {
+  RunTest(ShiftedLaplacian(12, 11, 10, -1.),
+          catamari::kLDLAdjointFactorization);
+}
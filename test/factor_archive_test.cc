@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian, saves it into an archive, and
+// checks the solves of the reloaded factorization -- either directly from the
+// archived factor or after refactoring the archived symbolic analysis.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             catamari::LDLAlgorithm algorithm, const Field& shift,
+             bool include_values) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  const char* filename = "factor_archive_test.bin";
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = algorithm;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  {
+    catamari::SparseLDL<Field> ldl;
+    const catamari::SparseLDLResult<Field> result =
+        ldl.Factor(matrix, ldl_control, /* symbolic_only = */ !include_values);
+    if (include_values) {
+      REQUIRE(result.num_successful_pivots == num_rows);
+    }
+    ldl.Save(filename, include_values);
+  }
+
+  catamari::SparseLDL<Field> ldl;
+  REQUIRE(ldl.Load(filename, ldl_control) == include_values);
+  REQUIRE(ldl.NumRows() == num_rows);
+  if (include_values) {
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  }
+
+  // The archived factor is copied on write, so it may be refactored in place.
+  const catamari::SparseLDLResult<Field> result =
+      ldl.RefactorWithFixedSparsityPattern(matrix);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  std::remove(filename);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  for (bool include_values : {false, true}) {
+    for (catamari::LDLAlgorithm algorithm :
+         {catamari::kLeftLookingLDL, catamari::kRightLookingLDL}) {
+      RunTest<double>(60, 50, catamari::kCholeskyFactorization, algorithm,
+                      0.1, include_values);
+      RunTest<mantis::Complex<double>>(60, 50,
+                                       catamari::kCholeskyFactorization,
+                                       algorithm, 0.1, include_values);
+    }
+  }
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  for (bool include_values : {false, true}) {
+    RunTest<double>(60, 50, catamari::kLDLAdjointFactorization,
+                    catamari::kRightLookingLDL, -1., include_values);
+    RunTest<mantis::Complex<double>>(60, 50,
+                                     catamari::kLDLAdjointFactorization,
+                                     catamari::kRightLookingLDL, -1.,
+                                     include_values);
+  }
+}
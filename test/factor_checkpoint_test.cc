@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::PerturbedLaplacian;
+
+namespace {
+
+// Returns the solution of the factored system against a fixed right-hand
+// side.
+BlasMatrix<double> SolveFixed(const catamari::SparseLDL<double>& ldl,
+                              Int num_rows) {
+  BlasMatrix<double> solution;
+  solution.Resize(num_rows, 1);
+  for (Int i = 0; i < num_rows; ++i) {
+    solution(i, 0) = std::sin(1. + i);
+  }
+  ldl.Solve(&solution.view);
+  return solution;
+}
+
+// Checks that restoring a checkpoint undoes a refactorization exactly.
+void RunTest(const catamari::SparseLDLControl<double>& control) {
+  const catamari::CoordinateMatrix<double> matrix = PerturbedLaplacian(30, 4.5);
+  const catamari::CoordinateMatrix<double> step_matrix =
+      PerturbedLaplacian(30, 8.);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+  const BlasMatrix<double> expected = SolveFixed(ldl, num_rows);
+
+  catamari::SparseLDLCheckpoint<double> checkpoint;
+  ldl.Checkpoint(&checkpoint);
+  for (Int repetition = 0; repetition < 2; ++repetition) {
+    REQUIRE(ldl.RefactorWithFixedSparsityPattern(step_matrix)
+                .num_successful_pivots == num_rows);
+    REQUIRE(SolveFixed(ldl, num_rows)(0, 0) != expected(0, 0));
+
+    ldl.Restore(checkpoint);
+    const BlasMatrix<double> solution = SolveFixed(ldl, num_rows);
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(solution(i, 0) == expected(i, 0));
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Supernodal", "[Supernodal]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  RunTest(control);
+
+  control.supernodal_control.algorithm = catamari::kLeftLookingLDL;
+  RunTest(control);
+}
+
+TEST_CASE("Equilibrated", "[Equilibrated]") {
+  for (const bool fuse_equilibration : {false, true}) {
+    catamari::SparseLDLControl<double> control;
+    control.SetFactorizationType(catamari::kCholeskyFactorization);
+    control.supernodal_strategy = catamari::kSupernodalFactorization;
+    control.equilibrate = true;
+    control.fuse_equilibration = fuse_equilibration;
+    RunTest(control);
+  }
+}
+
+TEST_CASE("Scalar", "[Scalar]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kScalarFactorization;
+  RunTest(control);
+}
+
+TEST_CASE("Mismatched structure", "[Mismatched structure]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(PerturbedLaplacian(10, 5.), control);
+  catamari::SparseLDLCheckpoint<double> checkpoint;
+  ldl.Checkpoint(&checkpoint);
+  ldl.Factor(PerturbedLaplacian(12, 5.), control);
+  REQUIRE_THROWS(ldl.Restore(checkpoint));
+}
@@ -109,3 +109,160 @@ TEST_CASE("FGMRES double", "[FGMRES double]") {
   // after 11 inner iterations.
   REQUIRE(fgmres_status.num_iterations == 11);
 }
+
+TEST_CASE("FGMRES complex block", "[FGMRES complex block]") {
+  typedef mantis::Complex<double> Field;
+  const catamari::Int height = 5;
+  const catamari::Int num_rhs = 3;
+
+  // Build the complex symmetric matrix A + i I, with A as above.
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(height, height);
+  matrix.AddEntries(std::vector<catamari::MatrixEntry<Field>>{
+      {0, 0, Field(8., 1.)},
+      {0, 1, Field(-1.)},
+      {0, 2, Field(-3.)},
+      {0, 4, Field(13.)},
+      {1, 0, Field(-1.)},
+      {1, 1, Field(7., 1.)},
+      {1, 2, Field(-2.)},
+      {1, 3, Field(-4.)},
+      {2, 0, Field(-3.)},
+      {2, 1, Field(-2.)},
+      {2, 2, Field(-9., 1.)},
+      {3, 1, Field(-4.)},
+      {3, 3, Field(-10., 1.)},
+      {4, 0, Field(13.)},
+      {4, 4, Field(-11., 1.)},
+  });
+  catamari::Int num_matrix_applications = 0;
+  auto apply_matrix =
+      [&](Field alpha, const catamari::ConstBlasMatrixView<Field>& input,
+          Field beta, catamari::BlasMatrixView<Field>* output) {
+        ++num_matrix_applications;
+        catamari::ApplySparse(alpha, matrix, input, beta, output);
+      };
+
+  // Precondition with the LDL^T factorization of the perturbed matrix.
+  catamari::CoordinateMatrix<Field> perturbed_matrix = matrix;
+  for (catamari::Int i = 0; i < height; ++i) {
+    perturbed_matrix.AddEntry(i, i, Field(1.));
+  }
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(perturbed_matrix, ldl_control);
+  catamari::Int num_preconditioner_applications = 0;
+  auto apply_preconditioner =
+      [&](catamari::BlasMatrixView<Field>* right_hand_sides) {
+        ++num_preconditioner_applications;
+        ldl.Solve(right_hand_sides);
+      };
+
+  catamari::BlasMatrix<Field> right_hand_sides(height, num_rhs);
+  for (catamari::Int j = 0; j < num_rhs; ++j) {
+    for (catamari::Int i = 0; i < height; ++i) {
+      right_hand_sides(i, j) = Field(i + 1., j * (i % 2));
+    }
+  }
+
+  catamari::FGMRESControl<double> fgmres_control;
+  fgmres_control.max_inner_iterations = 2;
+  fgmres_control.relative_tolerance_coefficient = 1e-12;
+  fgmres_control.relative_tolerance_exponent = 0;
+  catamari::BlasMatrix<Field> fgmres_solutions;
+  const catamari::FGMRESStatus<double> fgmres_status =
+      catamari::FGMRES(apply_matrix, apply_preconditioner, fgmres_control,
+                       right_hand_sides.ConstView(), &fgmres_solutions);
+  REQUIRE(fgmres_status.relative_error <=
+          fgmres_control.relative_tolerance_coefficient);
+
+  // Every column individually meets the tolerance.
+  catamari::BlasMatrix<Field> residuals = right_hand_sides;
+  catamari::ApplySparse(Field(-1.), matrix, fgmres_solutions.ConstView(),
+                        Field(1.), &residuals.view);
+  for (catamari::Int j = 0; j < num_rhs; ++j) {
+    const double relative_residual_norm =
+        catamari::EuclideanNorm(
+            residuals.ConstView().Submatrix(0, j, height, 1)) /
+        catamari::EuclideanNorm(
+            right_hand_sides.ConstView().Submatrix(0, j, height, 1));
+    REQUIRE(relative_residual_norm <=
+            fgmres_control.relative_tolerance_coefficient);
+  }
+
+  // The columns are iterated in lockstep, so there is one preconditioner
+  // application per inner iteration rather than per column.
+  REQUIRE(num_preconditioner_applications == fgmres_status.num_iterations);
+}
+
+TEST_CASE("FGMRES workspace", "[FGMRES workspace]") {
+  const catamari::Int height = 5;
+
+  // The matrix of the "FGMRES double" test, preconditioned by its diagonal.
+  catamari::CoordinateMatrix<double> matrix;
+  matrix.Resize(height, height);
+  matrix.AddEntries(std::vector<catamari::MatrixEntry<double>>{
+      {0, 0, 8.},
+      {0, 1, -1.},
+      {0, 2, -3.},
+      {0, 4, 13.},
+      {1, 0, -1.},
+      {1, 1, 7.},
+      {1, 2, -2.},
+      {1, 3, -4.},
+      {2, 0, -3.},
+      {2, 1, -2.},
+      {2, 2, -9.},
+      {3, 1, -4.},
+      {3, 3, -10.},
+      {4, 0, 13.},
+      {4, 4, -11.},
+  });
+  const std::vector<double> diagonal{8., 7., -9., -10., -11.};
+  auto apply_matrix =
+      [&](double alpha, const catamari::ConstBlasMatrixView<double>& input,
+          double beta, catamari::BlasMatrixView<double>* output) {
+        catamari::ApplySparse(alpha, matrix, input, beta, output);
+      };
+  auto apply_preconditioner =
+      [&](catamari::BlasMatrixView<double>* right_hand_sides) {
+        for (catamari::Int j = 0; j < right_hand_sides->width; ++j) {
+          for (catamari::Int i = 0; i < height; ++i) {
+            right_hand_sides->Entry(i, j) /= diagonal[i];
+          }
+        }
+      };
+
+  catamari::FGMRESControl<double> fgmres_control;
+  fgmres_control.max_inner_iterations = 3;
+  fgmres_control.relative_tolerance_coefficient = 1e-12;
+  fgmres_control.relative_tolerance_exponent = 0;
+
+  // Solves with a varying number of right-hand sides through a single
+  // workspace must match those made without one.
+  catamari::FGMRESWorkspace<double> workspace;
+  for (const catamari::Int num_rhs : {3, 1, 3}) {
+    catamari::BlasMatrix<double> right_hand_sides(height, num_rhs);
+    for (catamari::Int j = 0; j < num_rhs; ++j) {
+      for (catamari::Int i = 0; i < height; ++i) {
+        right_hand_sides(i, j) = i + 1. + j * (i % 2);
+      }
+    }
+
+    catamari::BlasMatrix<double> expected, solutions;
+    const catamari::FGMRESStatus<double> expected_status = catamari::FGMRES(
+        apply_matrix, apply_preconditioner, fgmres_control,
+        right_hand_sides.ConstView(), &expected);
+    const catamari::FGMRESStatus<double> status = catamari::FGMRES(
+        apply_matrix, apply_preconditioner, fgmres_control,
+        right_hand_sides.ConstView(), &solutions, &workspace);
+    REQUIRE(status.num_iterations == expected_status.num_iterations);
+    REQUIRE(status.relative_error == expected_status.relative_error);
+    for (catamari::Int j = 0; j < num_rhs; ++j) {
+      for (catamari::Int i = 0; i < height; ++i) {
+        REQUIRE(solutions(i, j) == expected(i, j));
+      }
+    }
+  }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns a shifted 2D negative Laplacian whose rows and columns are rescaled
+// by factors spanning several orders of magnitude.
+template <typename Field>
+catamari::CoordinateMatrix<Field> BadlyScaledLaplacian(Int num_x_elements,
+                                                       Int num_y_elements,
+                                                       const Field& shift) {
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_y_elements;
+  auto scale = [](Int index) { return std::pow(10., (index % 7) - 3.); };
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      auto add = [&](Int column, const Field& value) {
+        matrix.QueueEntryAddition(index, column,
+                                  value * scale(index) * scale(column));
+      };
+      add(index, Field{4} + shift);
+      if (x > 0) add(index - 1, Field{-1});
+      if (x < num_x_elements - 1) add(index + 1, Field{-1});
+      if (y > 0) add(index - num_x_elements, Field{-1});
+      if (y < num_y_elements - 1) add(index + num_x_elements, Field{-1});
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Fills the right-hand sides with a deterministic pattern.
+template <typename Field>
+void RightHandSides(Int num_rows, Int num_rhs,
+                    BlasMatrix<Field>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = Field(double((i * 3 + j) % 11) - 5.);
+    }
+  }
+}
+
+// Returns the maximum relative difference between the solutions computed
+// from separately applied and fused equilibrations, first for the original
+// factorizations and then for refactorizations.
+template <typename Field>
+catamari::ComplexBase<Field> RunTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    catamari::LDLAlgorithm algorithm, const Field& shift, int num_threads) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      BadlyScaledLaplacian(20, 15, shift);
+  const Int num_rows = matrix.NumRows();
+  const Int num_rhs = 3;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = algorithm;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  ldl_control.equilibrate = true;
+
+  catamari::SparseLDLControl<Field> fused_control = ldl_control;
+  fused_control.fuse_equilibration = true;
+
+  tbb::task_arena arena(num_threads);
+  catamari::SparseLDL<Field> ldl, fused_ldl;
+  BlasMatrix<Field> expected, solution;
+  Real max_difference = 0;
+  for (int refactor = 0; refactor < 2; ++refactor) {
+    arena.execute([&]() {
+      if (refactor) {
+        REQUIRE(ldl.RefactorWithFixedSparsityPattern(matrix)
+                    .num_successful_pivots == num_rows);
+        REQUIRE(fused_ldl.RefactorWithFixedSparsityPattern(matrix)
+                    .num_successful_pivots == num_rows);
+      } else {
+        REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots ==
+                num_rows);
+        REQUIRE(fused_ldl.Factor(matrix, fused_control)
+                    .num_successful_pivots == num_rows);
+      }
+      RightHandSides(num_rows, num_rhs, &expected);
+      ldl.Solve(&expected.view);
+      RightHandSides(num_rows, num_rhs, &solution);
+      fused_ldl.Solve(&solution.view);
+    });
+
+    Real difference = 0;
+    Real max_entry = 0;
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        difference =
+            std::max(difference, std::abs(expected(i, j) - solution(i, j)));
+        max_entry = std::max(max_entry, std::abs(expected(i, j)));
+      }
+    }
+    max_difference = std::max(max_difference, difference / max_entry);
+  }
+  return max_difference;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  for (int num_threads : {1, 4}) {
+    REQUIRE(RunTest<double>(catamari::kCholeskyFactorization,
+                            catamari::kLeftLookingLDL, 0.1,
+                            num_threads) <= tolerance);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                catamari::kCholeskyFactorization, catamari::kRightLookingLDL,
+                0.1, num_threads) <= tolerance);
+  }
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  for (int num_threads : {1, 4}) {
+    REQUIRE(RunTest<double>(catamari::kLDLTransposeFactorization,
+                            catamari::kRightLookingLDL, -1.,
+                            num_threads) <= tolerance);
+    REQUIRE(RunTest<mantis::Complex<double>>(
+                catamari::kLDLTransposeFactorization,
+                catamari::kLeftLookingLDL, mantis::Complex<double>(-1., 0.5),
+                num_threads) <= tolerance);
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::PerturbedLaplacian;
+
+namespace {
+
+// Fills the right-hand sides with a deterministic, non-constant pattern.
+void FillRightHandSides(Int num_rows, Int num_rhs,
+                        BlasMatrix<double>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = std::sin(1. + i + 3. * j);
+    }
+  }
+}
+
+// Checks that 'FactorAndSolve' matches a factorization followed by a solve.
+void RunTest(const catamari::SparseLDLControl<double>& control, Int num_rhs) {
+  const catamari::CoordinateMatrix<double> matrix = PerturbedLaplacian(40, 4.5);
+  const Int num_rows = matrix.NumRows();
+
+  BlasMatrix<double> expected;
+  FillRightHandSides(num_rows, num_rhs, &expected);
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+  ldl.Solve(&expected.view);
+
+  BlasMatrix<double> solution;
+  FillRightHandSides(num_rows, num_rhs, &solution);
+  catamari::SparseLDL<double> fused_ldl;
+  const catamari::SparseLDLResult<double> result =
+      fused_ldl.FactorAndSolve(matrix, control, &solution.view);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  double max_error = 0;
+  double max_entry = 0;
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      max_error = std::max(max_error,
+                           std::abs(solution(i, j) - expected(i, j)));
+      max_entry = std::max(max_entry, std::abs(expected(i, j)));
+    }
+  }
+  REQUIRE(max_error <= 1e-12 * max_entry);
+
+  // The factorization remains available for subsequent solves.
+  FillRightHandSides(num_rows, num_rhs, &solution);
+  fused_ldl.Solve(&solution.view);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(std::abs(solution(i, j) - expected(i, j)) <= 1e-12 * max_entry);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Right-looking Cholesky", "[Right-looking Cholesky]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  RunTest(control, 1);
+  RunTest(control, 3);
+}
+
+TEST_CASE("Right-looking LDL^H", "[Right-looking LDL^H]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  control.reordering_strategy = catamari::kNestedDissectionReordering;
+  RunTest(control, 1);
+}
+
+TEST_CASE("Equilibrated", "[Equilibrated]") {
+  for (const bool fuse_equilibration : {false, true}) {
+    catamari::SparseLDLControl<double> control;
+    control.SetFactorizationType(catamari::kCholeskyFactorization);
+    control.supernodal_strategy = catamari::kSupernodalFactorization;
+    control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+    control.equilibrate = true;
+    control.fuse_equilibration = fuse_equilibration;
+    RunTest(control, 2);
+  }
+}
+
+TEST_CASE("Unfused", "[Unfused]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kLeftLookingLDL;
+  RunTest(control, 1);
+
+  control.supernodal_strategy = catamari::kScalarFactorization;
+  RunTest(control, 1);
+}
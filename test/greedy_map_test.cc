@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "catamari.hpp"
+#include "catamari/sparse_hermitian_dpp.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+template <typename Real>
+Real RandomEntry(std::mt19937* generator, Real*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  return normal_dist(*generator);
+}
+
+template <typename Real>
+Complex<Real> RandomEntry(std::mt19937* generator, Complex<Real>*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  const Real real_part = normal_dist(*generator);
+  return Complex<Real>{real_part, normal_dist(*generator)};
+}
+
+// Forms the Hermitian positive semi-definite kernel B B^H of a random n x k
+// factor B.
+template <typename Field>
+void FormKernel(Int height, Int rank, std::mt19937* generator,
+                BlasMatrix<Field>* kernel) {
+  BlasMatrix<Field> factor;
+  factor.Resize(height, rank);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      factor(i, j) = RandomEntry(generator, static_cast<Field*>(nullptr));
+    }
+  }
+  kernel->Resize(height, height, Field{0});
+  catamari::MatrixMultiplyNormalAdjoint(Field{1}, factor.view.ToConst(),
+                                        factor.view.ToConst(), Field{0},
+                                        &kernel->view);
+}
+
+// Returns log det(L_Y) via a Cholesky factorization, or -infinity if the
+// restriction is not numerically positive-definite.
+template <typename Field>
+catamari::ComplexBase<Field> LogDeterminant(const BlasMatrix<Field>& kernel,
+                                            const std::vector<Int>& subset) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int size = subset.size();
+  BlasMatrix<Field> submatrix;
+  submatrix.Resize(size, size);
+  for (Int j = 0; j < size; ++j) {
+    for (Int i = 0; i < size; ++i) {
+      submatrix(i, j) = kernel(subset[i], subset[j]);
+    }
+  }
+  if (catamari::LowerCholeskyFactorization(Int(16), &submatrix.view) !=
+      size) {
+    return -std::numeric_limits<Real>::infinity();
+  }
+  Real log_det = 0;
+  for (Int i = 0; i < size; ++i) {
+    log_det += 2 * std::log(catamari::RealPart(submatrix(i, i)));
+  }
+  return log_det;
+}
+
+// Returns the greedy selection formed by explicitly factoring each candidate
+// extension of the selection.
+template <typename Field>
+std::vector<Int> ReferenceGreedyMAP(Int max_size,
+                                    const BlasMatrix<Field>& kernel) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_items = kernel.view.height;
+  std::vector<Int> sample;
+  std::vector<char> selected(num_items, 0);
+  for (Int index = 0; index < max_size; ++index) {
+    Int pivot = -1;
+    Real pivot_log_det = -std::numeric_limits<Real>::infinity();
+    for (Int i = 0; i < num_items; ++i) {
+      if (selected[i]) continue;
+      std::vector<Int> extension = sample;
+      extension.push_back(i);
+      const Real log_det = LogDeterminant(kernel, extension);
+      if (log_det > pivot_log_det) {
+        pivot = i;
+        pivot_log_det = log_det;
+      }
+    }
+    sample.push_back(pivot);
+    selected[pivot] = 1;
+  }
+  return sample;
+}
+
+template <typename Field>
+void RunDenseTest(Int height, Int rank, Int max_size) {
+  typedef catamari::ComplexBase<Field> Real;
+  std::mt19937 generator(17);
+  BlasMatrix<Field> kernel;
+  FormKernel(height, rank, &generator, &kernel);
+
+  const std::vector<Int> sample =
+      catamari::GreedyLEnsembleMAP(max_size, Real(0), kernel.view.ToConst());
+  REQUIRE(sample == ReferenceGreedyMAP(max_size, kernel));
+
+  // The kernel has rank 'rank', so no larger selection is nonsingular.
+  REQUIRE(Int(catamari::GreedyLEnsembleMAP(height, Real(1e-8),
+                                           kernel.view.ToConst())
+                  .size()) == rank);
+
+  // A unit minimum gain only keeps items which increase the likelihood.
+  const std::vector<Int> map_sample =
+      catamari::GreedyLEnsembleMAP(height, Real(1), kernel.view.ToConst());
+  Real log_det = 0;
+  for (std::size_t size = 1; size <= map_sample.size(); ++size) {
+    const std::vector<Int> prefix(map_sample.begin(),
+                                  map_sample.begin() + size);
+    const Real new_log_det = LogDeterminant(kernel, prefix);
+    REQUIRE(new_log_det > log_det);
+    log_det = new_log_det;
+  }
+}
+
+// Returns a shifted 2D negative Laplacian over an n x n grid with distinct
+// diagonal entries.
+catamari::CoordinateMatrix<double> ShiftedLaplacian(Int num_x_elements) {
+  catamari::CoordinateMatrix<double> matrix;
+  const Int num_rows = num_x_elements * num_x_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int y = 0; y < num_x_elements; ++y) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, 4.5 + std::sin(1. + index));
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -1);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -1);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, -1);
+      }
+      if (y < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, -1);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") { RunDenseTest<double>(40, 12, 8); }
+
+TEST_CASE("Complex", "[Complex]") {
+  RunDenseTest<Complex<double>>(30, 9, 6);
+}
+
+TEST_CASE("Sparse", "[Sparse]") {
+  const catamari::CoordinateMatrix<double> matrix = ShiftedLaplacian(20);
+  const Int num_rows = matrix.NumRows();
+  BlasMatrix<double> kernel;
+  kernel.Resize(num_rows, num_rows, 0.);
+  for (const catamari::MatrixEntry<double>& entry : matrix.Entries()) {
+    kernel(entry.row, entry.column) += entry.value;
+  }
+
+  for (const double min_gain : {0., 4.}) {
+    const std::vector<Int> sample =
+        catamari::GreedyLEnsembleMAP(150, min_gain, matrix);
+    REQUIRE(sample == catamari::GreedyLEnsembleMAP(150, min_gain,
+                                                   kernel.view.ToConst()));
+    REQUIRE(!sample.empty());
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Adds (semidefinite) couplings between diagonal grid neighbours in the
+// leading 'num_coupled' columns of the first grid lines, which lie outside of
+// the pattern of the Laplacian.
+template <typename Field>
+void AddDiagonalCouplings(Int num_x_elements, Int num_coupled,
+                          catamari::CoordinateMatrix<Field>* matrix) {
+  const Field weight{0.25};
+  matrix->ReserveEntryAdditions(4 * num_coupled);
+  for (Int x = 0; x < num_coupled; ++x) {
+    const Int index = x;
+    const Int neighbor = x + 1 + num_x_elements;
+    matrix->QueueEntryAddition(index, index, weight);
+    matrix->QueueEntryAddition(neighbor, neighbor, weight);
+    matrix->QueueEntryAddition(index, neighbor, -weight);
+    matrix->QueueEntryAddition(neighbor, index, -weight);
+  }
+  matrix->FlushEntryQueues();
+}
+
+// Factors a shifted 2D negative Laplacian, then grows its pattern in place:
+// first with new couplings between existing rows, then with additional grid
+// lines (and hence new rows), and finally with both.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             catamari::LDLAlgorithm algorithm, const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = algorithm;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  catamari::SparseLDL<Field> ldl;
+  REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots ==
+          matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  // An unchanged pattern is simply refactored.
+  REQUIRE(ldl.RefactorWithGrownSparsityPattern(matrix).num_successful_pivots ==
+          matrix.NumRows());
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  catamari::CoordinateMatrix<Field> coupled_matrix = matrix;
+  AddDiagonalCouplings(num_x_elements, num_x_elements / 2, &coupled_matrix);
+  REQUIRE(ldl.RefactorWithGrownSparsityPattern(coupled_matrix)
+              .num_successful_pivots == coupled_matrix.NumRows());
+  REQUIRE(RelativeResidual(coupled_matrix, ldl) <= tolerance);
+
+  const catamari::CoordinateMatrix<Field> extended_matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements + 2, shift);
+  REQUIRE(ldl.RefactorWithGrownSparsityPattern(extended_matrix)
+              .num_successful_pivots == extended_matrix.NumRows());
+  REQUIRE(ldl.NumRows() == extended_matrix.NumRows());
+  REQUIRE(RelativeResidual(extended_matrix, ldl) <= tolerance);
+
+  catamari::CoordinateMatrix<Field> grown_matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements + 3, shift);
+  AddDiagonalCouplings(num_x_elements, num_x_elements - 1, &grown_matrix);
+  REQUIRE(ldl.RefactorWithGrownSparsityPattern(grown_matrix)
+              .num_successful_pivots == grown_matrix.NumRows());
+  REQUIRE(RelativeResidual(grown_matrix, ldl) <= tolerance);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization,
+                  catamari::kLeftLookingLDL, 0.1);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kCholeskyFactorization,
+                                   catamari::kRightLookingLDL, 0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  // A shift of -1 makes the matrix indefinite.
+  RunTest<double>(20, 15, catamari::kLDLAdjointFactorization,
+                  catamari::kRightLookingLDL, -1.);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kLDLAdjointFactorization,
+                                   catamari::kLeftLookingLDL, -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<double>(20, 15, catamari::kLDLTransposeFactorization,
+                  catamari::kLeftLookingLDL, -1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization, catamari::kRightLookingLDL,
+      mantis::Complex<double>(-1., 0.5));
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "catamari/hardware_counters.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Buffer;
+using catamari::HardwareCounterReading;
+using catamari::Int;
+using catamari::PhaseCounterScope;
+using catamari::PhaseCounters;
+using catamari::SupernodeCounters;
+
+namespace {
+
+// Streams through a buffer so that time passes and cycles are spent.
+double Stream(const Buffer<double>& buffer) {
+  volatile double sum = 0;
+  for (const double value : buffer) {
+    sum = sum + value;
+  }
+  return sum;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Readings", "[Readings]") {
+  const HardwareCounterReading begin = catamari::ReadHardwareCounters();
+  Buffer<double> buffer(1 << 20, 1.);
+  Stream(buffer);
+  const HardwareCounterReading end = catamari::ReadHardwareCounters();
+  REQUIRE(end.nanoseconds > begin.nanoseconds);
+  if (catamari::HardwareCountersAvailable()) {
+    REQUIRE(end.cycles > begin.cycles);
+    REQUIRE(end.llc_misses >= begin.llc_misses);
+  } else {
+    REQUIRE(end.cycles == 0);
+    REQUIRE(end.llc_misses == 0);
+  }
+}
+
+TEST_CASE("Scopes", "[Scopes]") {
+  Buffer<double> buffer(1 << 16, 1.);
+  PhaseCounters counters;
+  for (Int iteration = 0; iteration < 3; ++iteration) {
+    PhaseCounterScope scope(&counters, 1.e6);
+    Stream(buffer);
+  }
+  REQUIRE(counters.flops == 3.e6);
+  REQUIRE(counters.seconds > 0);
+  REQUIRE((counters.cycles > 0) == catamari::HardwareCountersAvailable());
+}
+
+TEST_CASE("Report", "[Report]") {
+  Buffer<SupernodeCounters> counters(3);
+  counters[0].size = 4;
+  counters[0].degree = 8;
+  counters[0].phases[catamari::kFactorCounterPhase].seconds = 1.;
+  counters[0].phases[catamari::kFactorCounterPhase].flops = 2.e9;
+  counters[0].phases[catamari::kFactorCounterPhase].llc_misses = 1000;
+  counters[2].size = 16;
+  counters[2].degree = 0;
+  counters[2].phases[catamari::kHerkCounterPhase].seconds = 2.;
+  counters[2].phases[catamari::kHerkCounterPhase].flops = 1.e9;
+
+  const std::string filename = "hardware_counters_test_report.txt";
+  catamari::SupernodeCountersToReport(filename, counters, 64);
+  std::ifstream file(filename);
+  REQUIRE(file.is_open());
+  std::stringstream stream;
+  stream << file.rdbuf();
+  const std::string report = stream.str();
+  std::remove(filename.c_str());
+
+  // The slower supernode is listed first, and the idle one is skipped.
+  const std::size_t supernodes_pos = report.find("# Supernodes");
+  REQUIRE(supernodes_pos != std::string::npos);
+  std::istringstream lines(report.substr(supernodes_pos));
+  std::string line;
+  std::getline(lines, line);
+  std::getline(lines, line);
+
+  Int supernode, size, degree;
+  std::string phase;
+  double seconds, gflops, gflops_per_second, flops_per_byte;
+  std::size_t cycles, llc_misses;
+  REQUIRE(lines >> supernode >> size >> degree >> phase >> seconds >> cycles >>
+          llc_misses >> gflops >> gflops_per_second >> flops_per_byte);
+  REQUIRE(supernode == 2);
+  REQUIRE(size == 16);
+  REQUIRE(phase == "herk");
+  REQUIRE(gflops_per_second == Approx(0.5));
+  REQUIRE(flops_per_byte == 0.);
+  std::getline(lines, line);
+
+  REQUIRE(lines >> supernode >> size >> degree >> phase >> seconds >> cycles >>
+          llc_misses >> gflops >> gflops_per_second >> flops_per_byte);
+  REQUIRE(supernode == 0);
+  REQUIRE(phase == "factor");
+  REQUIRE(gflops_per_second == Approx(2.));
+  REQUIRE(flops_per_byte == Approx(2.e9 / 64.e3));
+  std::getline(lines, line);
+  REQUIRE(!(lines >> supernode));
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <limits>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/helmholtz_pml.hpp"
+#include "catamari/norms.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Complex;
+using catamari::CoordinateMatrix;
+using catamari::Int;
+using catamari::helmholtz_pml::GaussianSource2D;
+using catamari::helmholtz_pml::GaussianSource3D;
+using catamari::helmholtz_pml::HelmholtzPMLProblem2D;
+using catamari::helmholtz_pml::HelmholtzPMLProblem3D;
+using catamari::helmholtz_pml::HelmholtzWithPMLQ4;
+using catamari::helmholtz_pml::HelmholtzWithPMLTrilinearHexahedra;
+using catamari::helmholtz_pml::Point2D;
+using catamari::helmholtz_pml::Point3D;
+using catamari::helmholtz_pml::Speed;
+
+namespace {
+
+typedef Complex<double> Field;
+
+const catamari::helmholtz_pml::SpeedProfile kProfile =
+    catamari::helmholtz_pml::kConvergingLens;
+const double kPMLScale = 100.;
+const double kPMLExponent = 3.;
+const Int kNumPMLElements = 2;
+
+// Serially assembles the Q4 discretization through the entry queue.
+void SerialMatrix2D(Int num_x_elements, Int num_y_elements, double omega,
+                    CoordinateMatrix<Field>* matrix) {
+  const HelmholtzWithPMLQ4<double> discretization(
+      num_x_elements, num_y_elements, omega, kPMLScale, kPMLExponent,
+      kNumPMLElements, Speed<double>(kProfile));
+  BlasMatrix<Field> element_updates;
+  element_updates.Resize(4, 4);
+  const Int y_stride = num_x_elements + 1;
+  const Int num_rows = y_stride * (num_y_elements + 1);
+  matrix->Resize(num_rows, num_rows);
+  for (Int y_element = 0; y_element < num_y_elements; ++y_element) {
+    for (Int x_element = 0; x_element < num_x_elements; ++x_element) {
+      discretization.ElementBilinearForms(x_element, y_element,
+                                          &element_updates.view);
+      const Int offset = x_element + y_element * y_stride;
+      for (int element_row = 0; element_row < 4; ++element_row) {
+        const Int row =
+            offset + (element_row & 1) + (element_row >> 1) * y_stride;
+        for (int element_column = 0; element_column < 4; ++element_column) {
+          const Int column =
+              offset + (element_column & 1) + (element_column >> 1) * y_stride;
+          matrix->QueueEntryAddition(
+              row, column, element_updates(element_row, element_column));
+        }
+      }
+    }
+  }
+  matrix->FlushEntryQueues();
+}
+
+// Serially assembles the trilinear hexahedral discretization through the
+// entry queue.
+void SerialMatrix3D(Int num_x_elements, Int num_y_elements,
+                    Int num_z_elements, double omega,
+                    CoordinateMatrix<Field>* matrix) {
+  const HelmholtzWithPMLTrilinearHexahedra<double> discretization(
+      num_x_elements, num_y_elements, num_z_elements, omega, kPMLScale,
+      kPMLExponent, kNumPMLElements, Speed<double>(kProfile));
+  BlasMatrix<Field> element_updates;
+  element_updates.Resize(8, 8);
+  const Int y_stride = num_x_elements + 1;
+  const Int z_stride = y_stride * (num_y_elements + 1);
+  const Int num_rows = z_stride * (num_z_elements + 1);
+  auto node_offset = [&](int element_node) {
+    return (element_node & 1) + ((element_node >> 1) & 1) * y_stride +
+           (element_node >> 2) * z_stride;
+  };
+  matrix->Resize(num_rows, num_rows);
+  for (Int z_element = 0; z_element < num_z_elements; ++z_element) {
+    for (Int y_element = 0; y_element < num_y_elements; ++y_element) {
+      for (Int x_element = 0; x_element < num_x_elements; ++x_element) {
+        discretization.ElementBilinearForms(x_element, y_element, z_element,
+                                            &element_updates.view);
+        const Int offset =
+            x_element + y_element * y_stride + z_element * z_stride;
+        for (int element_row = 0; element_row < 8; ++element_row) {
+          for (int element_column = 0; element_column < 8; ++element_column) {
+            matrix->QueueEntryAddition(
+                offset + node_offset(element_row),
+                offset + node_offset(element_column),
+                element_updates(element_row, element_column));
+          }
+        }
+      }
+    }
+  }
+  matrix->FlushEntryQueues();
+}
+
+// Requires that the two matrices have the same pattern and (nearly) the same
+// values, as the parallel assembly sums the element contributions in a
+// different order.
+void RequireMatch(const CoordinateMatrix<Field>& matrix,
+                  const CoordinateMatrix<Field>& expected) {
+  REQUIRE(matrix.NumRows() == expected.NumRows());
+  REQUIRE(matrix.NumEntries() == expected.NumEntries());
+  double max_value = 0;
+  for (Int index = 0; index < expected.NumEntries(); ++index) {
+    max_value = std::max(max_value, std::abs(expected.Entry(index).value));
+  }
+  const double tolerance =
+      1e2 * std::numeric_limits<double>::epsilon() * max_value;
+  for (Int index = 0; index < expected.NumEntries(); ++index) {
+    const catamari::MatrixEntry<Field>& entry = matrix.Entry(index);
+    const catamari::MatrixEntry<Field>& expected_entry = expected.Entry(index);
+    REQUIRE(entry.row == expected_entry.row);
+    REQUIRE(entry.column == expected_entry.column);
+    REQUIRE(std::abs(entry.value - expected_entry.value) <= tolerance);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Matrix 2D", "[Matrix 2D]") {
+  const Int num_x_elements = 7;
+  const Int num_y_elements = 6;
+  const double omega = 20.;
+  HelmholtzPMLProblem2D<double> problem(kProfile, num_x_elements,
+                                        num_y_elements, kPMLScale,
+                                        kPMLExponent, kNumPMLElements);
+  CoordinateMatrix<Field> expected;
+  SerialMatrix2D(num_x_elements, num_y_elements, omega, &expected);
+
+  CoordinateMatrix<Field> matrix;
+  problem.FormMatrix(omega, &matrix);
+  RequireMatch(matrix, expected);
+
+  // The values are also available without the pattern, in entry order.
+  Buffer<Field> values;
+  problem.AssembleValues(omega, &values);
+  REQUIRE(values.Size() == expected.NumEntries());
+  for (Int index = 0; index < expected.NumEntries(); ++index) {
+    REQUIRE(values[index] == matrix.Entry(index).value);
+  }
+}
+
+TEST_CASE("Matrix 3D", "[Matrix 3D]") {
+  const Int num_x_elements = 5;
+  const Int num_y_elements = 4;
+  const Int num_z_elements = 3;
+  const double omega = 15.;
+  HelmholtzPMLProblem3D<double> problem(kProfile, num_x_elements,
+                                        num_y_elements, num_z_elements,
+                                        kPMLScale, kPMLExponent,
+                                        kNumPMLElements);
+  CoordinateMatrix<Field> expected;
+  SerialMatrix3D(num_x_elements, num_y_elements, num_z_elements, omega,
+                 &expected);
+
+  CoordinateMatrix<Field> matrix;
+  problem.FormMatrix(omega, &matrix);
+  RequireMatch(matrix, expected);
+}
+
+TEST_CASE("Right-hand sides", "[Right-hand sides]") {
+  // A constant source has the same integral over each element, so each node
+  // contributes a quarter (or an eighth) of it per element it belongs to.
+  const Int num_elements = 4;
+  const Buffer<GaussianSource2D<double>> sources_2d{
+      GaussianSource2D<double>{Point2D<double>{0.5, 0.5}, 1., 1e10}};
+  HelmholtzPMLProblem2D<double> problem_2d(kProfile, num_elements,
+                                           num_elements, kPMLScale,
+                                           kPMLExponent, kNumPMLElements);
+  BlasMatrix<Field> right_hand_sides;
+  problem_2d.FormRightHandSides(sources_2d, &right_hand_sides);
+  REQUIRE(right_hand_sides.Height() == problem_2d.NumRows());
+  REQUIRE(right_hand_sides.Width() == 1);
+  const double element_area = 1. / (num_elements * num_elements);
+  const double tolerance = 1e-8;
+  REQUIRE(std::abs(right_hand_sides(0, 0) - element_area / 4) <= tolerance);
+  REQUIRE(std::abs(right_hand_sides(1, 0) - element_area / 2) <= tolerance);
+  REQUIRE(std::abs(right_hand_sides(num_elements + 2, 0) - element_area) <=
+          tolerance);
+
+  const Buffer<GaussianSource3D<double>> sources_3d{
+      GaussianSource3D<double>{Point3D<double>{0.5, 0.5, 0.5}, 1., 1e10},
+      GaussianSource3D<double>{Point3D<double>{0.5, 0.5, 0.5}, 2., 1e10}};
+  HelmholtzPMLProblem3D<double> problem_3d(
+      kProfile, num_elements, num_elements, num_elements, kPMLScale,
+      kPMLExponent, kNumPMLElements);
+  problem_3d.FormRightHandSides(sources_3d, &right_hand_sides);
+  REQUIRE(right_hand_sides.Width() == 2);
+  const double element_volume = element_area / num_elements;
+  const Int interior_node = 1 + (num_elements + 1) + (num_elements + 1) *
+                                                         (num_elements + 1);
+  REQUIRE(std::abs(right_hand_sides(0, 0) - element_volume / 8) <=
+          tolerance);
+  REQUIRE(std::abs(right_hand_sides(interior_node, 0) - element_volume) <=
+          tolerance);
+  REQUIRE(std::abs(right_hand_sides(interior_node, 1) - 2 * element_volume) <=
+          tolerance);
+}
+
+TEST_CASE("Frequency sweep", "[Frequency sweep]") {
+  const Int num_x_elements = 20;
+  const Int num_y_elements = 20;
+  HelmholtzPMLProblem2D<double> problem(kProfile, num_x_elements,
+                                        num_y_elements, kPMLScale,
+                                        kPMLExponent, kNumPMLElements);
+  const Int num_rows = problem.NumRows();
+  const Buffer<GaussianSource2D<double>> sources{
+      GaussianSource2D<double>{Point2D<double>{0.5, 0.5}, 1000., 0.05}};
+  BlasMatrix<Field> right_hand_sides;
+  problem.FormRightHandSides(sources, &right_hand_sides);
+  const double right_hand_side_norm =
+      catamari::EuclideanNorm(right_hand_sides.ConstView());
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  CoordinateMatrix<Field> matrix;
+  problem.FormMatrix(10., &matrix);
+  catamari::SparseLDL<Field> ldl;
+  catamari::SparseLDLResult<Field> result = ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  catamari::ConversionPlan plan;
+  problem.FormConversionPlan(ldl, &plan);
+  Buffer<Field> values;
+  for (const double omega : {10., 12.5, 15.}) {
+    problem.AssembleValues(omega, &values);
+    result = ldl.RefactorWithFixedSparsityPattern(plan, values.Data());
+    REQUIRE(result.num_successful_pivots == num_rows);
+
+    BlasMatrix<Field> solution = right_hand_sides;
+    ldl.Solve(&solution.view);
+    problem.FormMatrix(omega, &matrix);
+    BlasMatrix<Field> residual = right_hand_sides;
+    catamari::ApplySparse(Field{-1}, matrix, solution.ConstView(), Field{1},
+                          &residual.view);
+    REQUIRE(catamari::EuclideanNorm(residual.ConstView()) <=
+            1e-8 * right_hand_side_norm);
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <vector>
+#include "catamari/index_runs.hpp"
+#include "catamari/symmetric_ordering.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+using catamari::IndexRun;
+using catamari::IndexRunList;
+
+namespace {
+
+// Three lists: two runs, four isolated indices, and a single run.
+const std::vector<Int> kIndices{3, 4, 5, 6, 7, 10, 11, 12, 13,
+                                1, 5, 9, 12,
+                                20, 21, 22, 23, 24};
+const std::vector<Int> kListOffsets{0, 9, 13, 18};
+
+}  // anonymous namespace
+
+TEST_CASE("Encoding", "[Encoding]") {
+  IndexRunList runs;
+  runs.Encode(3, kListOffsets.data(), kIndices.data());
+
+  // The list of isolated indices is not worth encoding.
+  REQUIRE(runs.Encoded(0));
+  REQUIRE(!runs.Encoded(1));
+  REQUIRE(runs.Encoded(2));
+  REQUIRE(runs.NumRuns() == 3);
+
+  REQUIRE(runs.End(0) - runs.Beg(0) == 2);
+  const IndexRun& second = runs.Beg(0)[1];
+  REQUIRE(second.position == 5);
+  REQUIRE(second.index == 10);
+  REQUIRE(second.length == 4);
+}
+
+TEST_CASE("Traversal", "[Traversal]") {
+  IndexRunList runs;
+  runs.Encode(3, kListOffsets.data(), kIndices.data());
+
+  // Every suffix of each encoded list is visited in order.
+  for (Int list : {0, 2}) {
+    const Int list_beg = kListOffsets[list];
+    const Int list_size = kListOffsets[list + 1] - list_beg;
+    for (Int begin = 0; begin <= list_size; ++begin) {
+      std::vector<Int> visited;
+      catamari::ForEachIndexRun(
+          runs.Beg(list), runs.End(list), begin,
+          [&](Int position, Int index, Int length) {
+            for (Int i = 0; i < length; ++i) {
+              REQUIRE(kIndices[list_beg + position + i] == index + i);
+              visited.push_back(position + i);
+            }
+          });
+      REQUIRE(Int(visited.size()) == list_size - begin);
+      for (Int i = 0; i < Int(visited.size()); ++i) {
+        REQUIRE(visited[i] == begin + i);
+      }
+    }
+  }
+}
+
+TEST_CASE("Breaks", "[Breaks]") {
+  // A single run of twelve indices, twice.
+  std::vector<Int> indices(24);
+  for (Int i = 0; i < 24; ++i) {
+    indices[i] = 10 + i % 12;
+  }
+  const std::vector<Int> list_offsets{0, 12, 24};
+
+  // The run of the first list is split before its fifth position, while a
+  // break at the start of the second list has no effect.
+  const std::vector<Int> breaks{4, 0};
+  IndexRunList runs;
+  runs.Encode(2, list_offsets.data(), indices.data(), breaks.data());
+  REQUIRE(runs.End(0) - runs.Beg(0) == 2);
+  REQUIRE(runs.End(1) - runs.Beg(1) == 1);
+  const IndexRun& first = runs.Beg(0)[0];
+  REQUIRE(first.position == 0);
+  REQUIRE(first.index == 10);
+  REQUIRE(first.length == 4);
+  const IndexRun& second = runs.Beg(0)[1];
+  REQUIRE(second.position == 4);
+  REQUIRE(second.index == 14);
+  REQUIRE(second.length == 8);
+  REQUIRE(runs.Beg(1)->length == 12);
+}
+
+TEST_CASE("Merge kernels", "[Merge kernels]") {
+  // The lists above, followed by twenty isolated indices.
+  catamari::ChildRelativeIndices relative_indices;
+  const Int num_indices = kIndices.size() + 20;
+  relative_indices.offsets.Resize(5);
+  for (Int list = 0; list < 4; ++list) {
+    relative_indices.offsets[list] = kListOffsets[list];
+  }
+  relative_indices.offsets[4] = num_indices;
+  relative_indices.indices.Resize(num_indices);
+  for (Int i = 0; i < num_indices; ++i) {
+    relative_indices.indices[i] =
+        i < Int(kIndices.size()) ? kIndices[i] : 2 * i;
+  }
+  relative_indices.runs.Encode(4, relative_indices.offsets.Data(),
+                               relative_indices.indices.Data());
+  relative_indices.SelectMergeKernels();
+
+  // Only the short list which was not encoded gets a specialized kernel.
+  REQUIRE(relative_indices.merge_kernels.Size() == 4);
+  REQUIRE(relative_indices.merge_kernels[0] == 0);
+  REQUIRE(relative_indices.merge_kernels[1] == 4);
+  REQUIRE(relative_indices.merge_kernels[2] == 0);
+  REQUIRE(relative_indices.merge_kernels[3] == 0);
+}
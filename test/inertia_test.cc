@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns the number of negative eigenvalues of the shifted 2D negative
+// Laplacian.
+Int NumNegativeEigenvalues(Int num_x_elements, Int num_y_elements,
+                           double shift) {
+  const double pi = std::acos(-1.);
+  Int num_negative = 0;
+  for (Int i = 1; i <= num_x_elements; ++i) {
+    for (Int j = 1; j <= num_y_elements; ++j) {
+      const double eigenvalue =
+          4. + shift - 2. * std::cos(pi * i / (num_x_elements + 1)) -
+          2. * std::cos(pi * j / (num_y_elements + 1));
+      num_negative += eigenvalue < 0;
+    }
+  }
+  return num_negative;
+}
+
+// Returns the logarithm of the absolute value of the determinant of the
+// shifted 2D negative Laplacian.
+double LogAbsDeterminant(Int num_x_elements, Int num_y_elements,
+                         double shift) {
+  const double pi = std::acos(-1.);
+  double log_abs_determinant = 0;
+  for (Int i = 1; i <= num_x_elements; ++i) {
+    for (Int j = 1; j <= num_y_elements; ++j) {
+      const double eigenvalue =
+          4. + shift - 2. * std::cos(pi * i / (num_x_elements + 1)) -
+          2. * std::cos(pi * j / (num_y_elements + 1));
+      log_abs_determinant += std::log(std::abs(eigenvalue));
+    }
+  }
+  return log_abs_determinant;
+}
+
+// Factors the matrix with the given expected inertia using either the
+// left-looking or (through a conversion plan) the right-looking algorithm.
+template <typename Field>
+catamari::SparseLDLResult<Field> FactorWithInertia(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    catamari::LDLAlgorithm algorithm, Int expected_num_positive_pivots,
+    Int expected_num_negative_pivots) {
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = algorithm;
+  ldl_control.supernodal_control.expected_num_positive_pivots =
+      expected_num_positive_pivots;
+  ldl_control.supernodal_control.expected_num_negative_pivots =
+      expected_num_negative_pivots;
+
+  catamari::SparseLDL<Field> ldl;
+  if (algorithm != catamari::kRightLookingLDL) {
+    return ldl.Factor(matrix, ldl_control);
+  }
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+  return ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+}
+
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements, double shift,
+             catamari::LDLAlgorithm algorithm) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, Field{shift});
+  const Int num_rows = matrix.NumRows();
+  const Int num_negative =
+      NumNegativeEigenvalues(num_x_elements, num_y_elements, shift);
+  const Int num_positive = num_rows - num_negative;
+  REQUIRE(num_negative > 0);
+
+  // The pivot signs are counted without any expected inertia.
+  catamari::SparseLDLResult<Field> result =
+      FactorWithInertia(matrix, algorithm, -1, -1);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_positive_pivots == num_positive);
+  REQUIRE(result.num_negative_pivots == num_negative);
+  REQUIRE(result.num_zero_pivots == 0);
+
+  // As are the log-determinant and the sign of the determinant.
+  const double log_abs_determinant =
+      LogAbsDeterminant(num_x_elements, num_y_elements, shift);
+  REQUIRE(std::abs(double(result.log_abs_determinant) - log_abs_determinant) <=
+          1e-8 * std::abs(log_abs_determinant));
+  const double sign = num_negative % 2 ? -1. : 1.;
+  REQUIRE(std::abs(double(catamari::RealPart(result.determinant_phase)) -
+                   sign) <= 1e-10);
+
+  // The correct inertia succeeds.
+  result = FactorWithInertia(matrix, algorithm, num_positive, num_negative);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  // Too few negative pivots, such as when testing for positive-definiteness,
+  // abort the factorization.
+  result = FactorWithInertia(matrix, algorithm, -1, 0);
+  REQUIRE(result.num_successful_pivots < num_rows);
+  result = FactorWithInertia(matrix, algorithm, -1, num_negative - 1);
+  REQUIRE(result.num_successful_pivots < num_rows);
+
+  // As do too few positive pivots.
+  result = FactorWithInertia(matrix, algorithm, num_positive - 1, -1);
+  REQUIRE(result.num_successful_pivots < num_rows);
+}
+
+// Counts the eigenvalues of the 2D negative Laplacian, with respect to the
+// identity and to twice the identity, below each of several shifts.
+template <typename Field>
+void RunSpectrumSlicingTest(Int num_x_elements, Int num_y_elements) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, Field{0});
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  Buffer<Field> doubled_identity(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    const catamari::MatrixEntry<Field>& entry = matrix.Entries()[index];
+    values[index] = entry.value;
+    doubled_identity[index] = Field{entry.row == entry.column ? 2. : 0.};
+  }
+
+  const Buffer<double> shifts{-0.5, 1.03, 2.51, 3.8, 5.02, 7.2, 8.5};
+  Buffer<Field> sigmas(shifts.Size());
+  for (Int index = 0; index < Int(shifts.Size()); ++index) {
+    sigmas[index] = Field{shifts[index]};
+  }
+  Buffer<catamari::SparseLDLResult<Field>> results;
+  ldl.ShiftedInertias(cplan, values.Data(), sigmas, nullptr, &results);
+  REQUIRE(results.Size() == sigmas.Size());
+  for (Int index = 0; index < Int(shifts.Size()); ++index) {
+    const Int num_negative = NumNegativeEigenvalues(
+        num_x_elements, num_y_elements, -shifts[index]);
+    REQUIRE(results[index].num_successful_pivots == num_rows);
+    REQUIRE(results[index].num_negative_pivots == num_negative);
+    REQUIRE(results[index].num_positive_pivots == num_rows - num_negative);
+  }
+
+  ldl.ShiftedInertias(cplan, values.Data(), sigmas, doubled_identity.Data(),
+                      &results);
+  for (Int index = 0; index < Int(shifts.Size()); ++index) {
+    const Int num_negative = NumNegativeEigenvalues(
+        num_x_elements, num_y_elements, -2. * shifts[index]);
+    REQUIRE(results[index].num_successful_pivots == num_rows);
+    REQUIRE(results[index].num_negative_pivots == num_negative);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Left-looking", "[Left-looking]") {
+  RunTest<double>(20, 15, -1.05, catamari::kLeftLookingLDL);
+  RunTest<mantis::Complex<double>>(20, 15, -1.05, catamari::kLeftLookingLDL);
+}
+
+TEST_CASE("Right-looking", "[Right-looking]") {
+  RunTest<double>(20, 15, -1.05, catamari::kRightLookingLDL);
+  RunTest<mantis::Complex<double>>(20, 15, -1.05, catamari::kRightLookingLDL);
+}
+
+TEST_CASE("Spectrum slicing", "[Spectrum slicing]") {
+  RunSpectrumSlicingTest<double>(20, 15);
+  RunSpectrumSlicingTest<mantis::Complex<double>>(20, 15);
+}
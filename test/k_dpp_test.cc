@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <random>
+#include <vector>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catamari/dense_factorizations.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+template <typename Real>
+Real RandomEntry(std::mt19937* generator, Real*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  return normal_dist(*generator);
+}
+
+template <typename Real>
+Complex<Real> RandomEntry(std::mt19937* generator, Complex<Real>*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  const Real real_part = normal_dist(*generator);
+  return Complex<Real>{real_part, normal_dist(*generator)};
+}
+
+// Forms the Hermitian positive semi-definite kernel B B^H of a random n x r
+// factor B.
+template <typename Field>
+void FormKernel(Int height, Int rank, std::mt19937* generator,
+                BlasMatrix<Field>* kernel) {
+  BlasMatrix<Field> factor;
+  factor.Resize(height, rank);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      factor(i, j) = RandomEntry(generator, static_cast<Field*>(nullptr));
+    }
+  }
+  kernel->Resize(height, height, Field{0});
+  catamari::MatrixMultiplyNormalAdjoint(Field{1}, factor.view.ToConst(),
+                                        factor.view.ToConst(), Field{0},
+                                        &kernel->view);
+}
+
+// Returns det(L_Y) via a Cholesky factorization (or zero if it fails).
+template <typename Field>
+catamari::ComplexBase<Field> Determinant(const BlasMatrix<Field>& kernel,
+                                         const std::vector<Int>& subset) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int size = subset.size();
+  BlasMatrix<Field> submatrix;
+  submatrix.Resize(size, size);
+  for (Int j = 0; j < size; ++j) {
+    for (Int i = 0; i < size; ++i) {
+      submatrix(i, j) = kernel(subset[i], subset[j]);
+    }
+  }
+  if (catamari::LowerCholeskyFactorization(Int(16), &submatrix.view) !=
+      size) {
+    return Real(0);
+  }
+  Real determinant = 1;
+  for (Int i = 0; i < size; ++i) {
+    const Real pivot = catamari::RealPart(submatrix(i, i));
+    determinant *= pivot * pivot;
+  }
+  return determinant;
+}
+
+// Checks the frequencies of each item in k-DPP samples against the exact
+// marginals formed by enumerating all subsets of size k.
+template <typename Field>
+void RunTest(Int height, Int rank, Int size) {
+  typedef catamari::ComplexBase<Field> Real;
+  std::mt19937 generator(17);
+  BlasMatrix<Field> kernel;
+  FormKernel(height, rank, &generator, &kernel);
+
+  // Enumerate the subsets of the given size via bitmasks.
+  Real normalizer = 0;
+  std::vector<Real> marginals(height, Real(0));
+  for (Int mask = 0; mask < (Int(1) << height); ++mask) {
+    std::vector<Int> subset;
+    for (Int i = 0; i < height; ++i) {
+      if (mask & (Int(1) << i)) subset.push_back(i);
+    }
+    if (Int(subset.size()) != size) continue;
+    const Real determinant = Determinant(kernel, subset);
+    normalizer += determinant;
+    for (const Int i : subset) marginals[i] += determinant;
+  }
+
+  catamari::KDPPDecomposition<Field> decomposition;
+  catamari::FormKDPPDecomposition(size, kernel.view.ToConst(),
+                                  &decomposition);
+  const Real log_normalizer =
+      decomposition.log_elementary_polynomials[size + height * (size + 1)];
+  REQUIRE(std::abs(log_normalizer - std::log(normalizer)) <= Real(1e-8));
+
+  const Int num_samples = 20000;
+  std::vector<Real> frequencies(height, Real(0));
+  for (Int index = 0; index < num_samples; ++index) {
+    const std::vector<Int> sample =
+        catamari::SampleKDPP(decomposition, &generator);
+    REQUIRE(Int(sample.size()) == size);
+    for (std::size_t j = 1; j < sample.size(); ++j) {
+      REQUIRE(sample[j - 1] < sample[j]);
+    }
+    for (const Int i : sample) frequencies[i] += Real(1) / num_samples;
+  }
+  for (Int i = 0; i < height; ++i) {
+    REQUIRE(std::abs(frequencies[i] - marginals[i] / normalizer) <=
+            Real(0.03));
+  }
+
+  // The single-sample path decomposes the kernel itself.
+  REQUIRE(Int(catamari::SampleKDPP(size, kernel.view.ToConst(), &generator)
+                  .size()) == size);
+
+  // There are no nonsingular subsets larger than the rank.
+  REQUIRE_THROWS(catamari::FormKDPPDecomposition(
+      rank + 1, kernel.view.ToConst(), &decomposition));
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") { RunTest<double>(10, 6, 3); }
+
+TEST_CASE("Complex", "[Complex]") { RunTest<Complex<double>>(9, 5, 2); }
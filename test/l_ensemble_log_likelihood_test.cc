@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+// Fills the lower triangle of a diagonally-dominant HPD kernel.
+template <typename Field>
+void InitializeKernel(Int matrix_size, BlasMatrix<Field>* kernel) {
+  kernel->Resize(matrix_size, matrix_size, Field{0});
+  for (Int j = 0; j < matrix_size; ++j) {
+    (*kernel)(j, j) = Field{1};
+    for (Int i = j + 1; i < matrix_size; ++i) {
+      (*kernel)(i, j) = Field{0.3} / Field(i - j);
+    }
+  }
+}
+
+template <typename Field>
+void RunTest() {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+
+  // The likelihoods of every subset of a small ground set sum to one.
+  const Int small_size = 7;
+  BlasMatrix<Field> small_kernel;
+  InitializeKernel(small_size, &small_kernel);
+  std::vector<std::vector<Int>> subsets;
+  for (Int mask = 0; mask < (Int(1) << small_size); ++mask) {
+    std::vector<Int> subset;
+    for (Int i = 0; i < small_size; ++i) {
+      if (mask & (Int(1) << i)) subset.push_back(i);
+    }
+    subsets.push_back(subset);
+  }
+  const std::vector<Real> log_likelihoods = catamari::LEnsembleLogLikelihoods(
+      Int(4), small_kernel.view.ToConst(), subsets);
+  REQUIRE(log_likelihoods.size() == subsets.size());
+  Real total_likelihood = 0;
+  for (const Real& log_likelihood : log_likelihoods) {
+    total_likelihood += std::exp(log_likelihood);
+  }
+  REQUIRE(std::abs(total_likelihood - Real(1)) <= tolerance);
+
+  // Subsets beyond the small-kernel sizes, and in any order, agree with the
+  // log-determinants computed directly.
+  const Int matrix_size = 60;
+  BlasMatrix<Field> kernel;
+  InitializeKernel(matrix_size, &kernel);
+  const Real log_normalizer =
+      catamari::LEnsembleLogNormalizer(Int(8), kernel.view.ToConst());
+  std::vector<std::vector<Int>> large_subsets(3);
+  for (Int i = 0; i < 40; ++i) large_subsets[0].push_back(i);
+  for (Int i = matrix_size - 1; i >= 0; i -= 3) large_subsets[1].push_back(i);
+  large_subsets[2] = {5, 0, 17, 9};
+  const std::vector<Real> large_log_likelihoods =
+      catamari::LEnsembleLogLikelihoods(Int(8), kernel.view.ToConst(),
+                                        large_subsets, log_normalizer);
+  for (std::size_t index = 0; index < large_subsets.size(); ++index) {
+    const std::vector<Int>& subset = large_subsets[index];
+    const Int subset_size = subset.size();
+    BlasMatrix<Field> submatrix;
+    submatrix.Resize(subset_size, subset_size);
+    for (Int j = 0; j < subset_size; ++j) {
+      for (Int i = 0; i < subset_size; ++i) {
+        submatrix(i, j) = subset[i] >= subset[j]
+                              ? kernel(subset[i], subset[j])
+                              : catamari::Conjugate(kernel(subset[j], subset[i]));
+      }
+    }
+    REQUIRE(catamari::LowerCholeskyFactorization(Int(8), &submatrix.view) ==
+            subset_size);
+    Real log_determinant = 0;
+    for (Int i = 0; i < subset_size; ++i) {
+      log_determinant += 2 * std::log(catamari::RealPart(submatrix(i, i)));
+    }
+    REQUIRE(std::abs(large_log_likelihoods[index] -
+                     (log_determinant - log_normalizer)) <=
+            tolerance * std::abs(log_normalizer));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") { RunTest<double>(); }
+
+TEST_CASE("Complex", "[Complex]") { RunTest<Complex<double>>(); }
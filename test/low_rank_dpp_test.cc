@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <random>
+#include <vector>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catamari/dense_factorizations.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+template <typename Real>
+Real RandomEntry(std::mt19937* generator, Real*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  return normal_dist(*generator);
+}
+
+template <typename Real>
+Complex<Real> RandomEntry(std::mt19937* generator, Complex<Real>*) {
+  std::normal_distribution<Real> normal_dist{Real{0}, Real{1}};
+  const Real real_part = normal_dist(*generator);
+  return Complex<Real>{real_part, normal_dist(*generator)};
+}
+
+// Fills an n x k factor with scaled normal entries.
+template <typename Field>
+void InitializeFactor(Int height, Int rank, const Field& scale,
+                      std::mt19937* generator, BlasMatrix<Field>* factor) {
+  factor->Resize(height, rank);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      (*factor)(i, j) =
+          scale * RandomEntry(generator, static_cast<Field*>(nullptr));
+    }
+  }
+}
+
+// Forms the n x n marginal kernel B (I + B^H B)^{-1} B^H.
+template <typename Field>
+void FormMarginalKernel(const BlasMatrix<Field>& factor,
+                        BlasMatrix<Field>* kernel) {
+  const Int height = factor.view.height;
+  const Int rank = factor.view.width;
+  BlasMatrix<Field> dual;
+  dual.Resize(rank, rank, Field{0});
+  for (Int j = 0; j < rank; ++j) {
+    dual(j, j) = Field{1};
+  }
+  catamari::MatrixMultiplyAdjointNormal(Field{1}, factor.view.ToConst(),
+                                        factor.view.ToConst(), Field{1},
+                                        &dual.view);
+  REQUIRE(catamari::LowerCholeskyFactorization(Int(16), &dual.view) == rank);
+
+  BlasMatrix<Field> basis = factor;
+  catamari::RightLowerAdjointTriangularSolves(dual.view.ToConst(),
+                                              &basis.view);
+  kernel->Resize(height, height, Field{0});
+  catamari::MatrixMultiplyNormalAdjoint(Field{1}, basis.view.ToConst(),
+                                        basis.view.ToConst(), Field{0},
+                                        &kernel->view);
+}
+
+template <typename Field>
+void RunTest(Int height, Int rank) {
+  typedef catamari::ComplexBase<Field> Real;
+  std::mt19937 generator(17);
+  BlasMatrix<Field> factor;
+  InitializeFactor(height, rank, Field{0.4}, &generator, &factor);
+
+  BlasMatrix<Field> kernel;
+  FormMarginalKernel(factor, &kernel);
+  Real expected_size = 0;
+  for (Int i = 0; i < height; ++i) {
+    expected_size += catamari::RealPart(kernel(i, i));
+  }
+
+  // The maximum-likelihood sample matches that of the full marginal kernel.
+  const std::vector<Int> sample = catamari::SampleLowRankHermitianDPP(
+      Int(16), true, factor.view.ToConst(), &generator);
+  REQUIRE(sample == catamari::SampleLowerHermitianDPP(Int(16), true,
+                                                      &kernel.view,
+                                                      &generator));
+
+  // The expected sample size is the trace of the marginal kernel.
+  const Int num_samples = 2000;
+  Real mean_size = 0;
+  for (Int index = 0; index < num_samples; ++index) {
+    const std::vector<Int> random_sample = catamari::SampleLowRankHermitianDPP(
+        Int(16), false, factor.view.ToConst(), &generator);
+    REQUIRE(Int(random_sample.size()) <= rank);
+    for (std::size_t j = 1; j < random_sample.size(); ++j) {
+      REQUIRE(random_sample[j - 1] < random_sample[j]);
+    }
+    mean_size += random_sample.size();
+  }
+  mean_size /= num_samples;
+  REQUIRE(std::abs(mean_size - expected_size) <= Real(0.2));
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") { RunTest<double>(200, 12); }
+
+TEST_CASE("Complex", "[Complex]") { RunTest<Complex<double>>(150, 9); }
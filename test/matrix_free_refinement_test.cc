@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::BlasMatrixView;
+using catamari::ConstBlasMatrixView;
+using catamari::Int;
+
+namespace {
+
+const Int kNumXElements = 30;
+const double kDiagonal = 4.05;
+
+// Returns the index of the grid point (x, y), or -1 if it is off the grid.
+Int GridIndex(Int x, Int y) {
+  if (x < 0 || x >= kNumXElements || y < 0 || y >= kNumXElements) return -1;
+  return x + y * kNumXElements;
+}
+
+// Returns the assembled 2D negative Laplacian.
+catamari::CoordinateMatrix<double> Laplacian() {
+  catamari::CoordinateMatrix<double> matrix;
+  const Int num_rows = kNumXElements * kNumXElements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int y = 0; y < kNumXElements; ++y) {
+    for (Int x = 0; x < kNumXElements; ++x) {
+      const Int index = GridIndex(x, y);
+      matrix.QueueEntryAddition(index, index, kDiagonal);
+      for (const Int neighbor : {GridIndex(x - 1, y), GridIndex(x + 1, y),
+                                 GridIndex(x, y - 1), GridIndex(x, y + 1)}) {
+        if (neighbor >= 0) matrix.QueueEntryAddition(index, neighbor, -1);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Overwrites 'output' with alpha A input + beta output by applying the
+// five-point stencil of the Laplacian without assembling it.
+void ApplyStencil(double alpha, const ConstBlasMatrixView<double>& input,
+                  double beta, BlasMatrixView<double>* output) {
+  for (Int j = 0; j < input.width; ++j) {
+    for (Int y = 0; y < kNumXElements; ++y) {
+      for (Int x = 0; x < kNumXElements; ++x) {
+        const Int index = GridIndex(x, y);
+        double product = kDiagonal * input(index, j);
+        for (const Int neighbor : {GridIndex(x - 1, y), GridIndex(x + 1, y),
+                                   GridIndex(x, y - 1), GridIndex(x, y + 1)}) {
+          if (neighbor >= 0) product -= input(neighbor, j);
+        }
+        output->Entry(index, j) =
+            alpha * product + beta * output->Entry(index, j);
+      }
+    }
+  }
+}
+
+// Factors the assembled Laplacian.
+void Factor(catamari::SparseLDL<double>* ldl) {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  const catamari::CoordinateMatrix<double> matrix = Laplacian();
+  REQUIRE(ldl->Factor(matrix, control).num_successful_pivots ==
+          matrix.NumRows());
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Matches assembled", "[Matches assembled]") {
+  const catamari::CoordinateMatrix<double> matrix = Laplacian();
+  const Int num_rows = matrix.NumRows();
+  catamari::SparseLDL<double> ldl;
+  Factor(&ldl);
+
+  catamari::RefinedSolveControl<double> control;
+  BlasMatrix<double> expected;
+  expected.Resize(num_rows, 2, 1.);
+  ldl.RefinedSolve(matrix, control, &expected.view);
+
+  BlasMatrix<double> solution;
+  solution.Resize(num_rows, 2, 1.);
+  const catamari::RefinedSolveStatus<double> status =
+      ldl.RefinedSolve(ApplyStencil, control, &solution.view);
+  REQUIRE(status.residual_relative_max_norm <= 1e-13);
+  for (Int j = 0; j < 2; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(std::abs(solution(i, j) - expected(i, j)) <=
+              1e-12 * std::abs(expected(i, j)));
+    }
+  }
+}
+
+TEST_CASE("Diagonally scaled", "[Diagonally scaled]") {
+  const catamari::CoordinateMatrix<double> matrix = Laplacian();
+  const Int num_rows = matrix.NumRows();
+  catamari::SparseLDL<double> ldl;
+  Factor(&ldl);
+
+  BlasMatrix<double> scaling;
+  scaling.Resize(num_rows, 1);
+  for (Int i = 0; i < num_rows; ++i) scaling(i, 0) = i % 2 ? 1. : 1e-3;
+
+  catamari::RefinedSolveControl<double> control;
+  BlasMatrix<double> expected;
+  expected.Resize(num_rows, 1, 1.);
+  ldl.DiagonallyScaledRefinedSolve(matrix, scaling.ConstView(), control,
+                                   &expected.view);
+
+  BlasMatrix<double> solution;
+  solution.Resize(num_rows, 1, 1.);
+  ldl.DiagonallyScaledRefinedSolve(ApplyStencil, scaling.ConstView(), control,
+                                   &solution.view);
+  for (Int i = 0; i < num_rows; ++i) {
+    REQUIRE(std::abs(solution(i, 0) - expected(i, 0)) <=
+            1e-12 * std::abs(expected(i, 0)));
+  }
+}
+
+TEST_CASE("Promotion", "[Promotion]") {
+  catamari::SparseLDL<double> ldl;
+  Factor(&ldl);
+  catamari::RefinedSolveControl<double> control;
+  control.promote = true;
+  BlasMatrix<double> solution;
+  solution.Resize(kNumXElements * kNumXElements, 1, 1.);
+  REQUIRE_THROWS(ldl.RefinedSolve(ApplyStencil, control, &solution.view));
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <set>
+#include <sstream>
+#include <utility>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/matrix_market_pipeline.hpp"
+#include "catamari/norms.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::CoordinateMatrix;
+using catamari::Int;
+
+namespace {
+
+// Writes the given contents to a file with the given name.
+void WriteFile(const std::string& filename, const std::string& contents) {
+  std::ofstream file(filename);
+  file << contents;
+}
+
+// Loads the file in small chunks and requires that the pattern, along with
+// the values it indexes, agree exactly with the result of 'FromMatrixMarket'.
+template <typename Field>
+void CompareWithReader(const std::string& filename, bool skip_explicit_zeros,
+                       quotient::EntryMask mask) {
+  std::unique_ptr<CoordinateMatrix<Field>> matrix =
+      CoordinateMatrix<Field>::FromMatrixMarket(filename, skip_explicit_zeros,
+                                                mask);
+  catamari::PipelinedMatrixMarket<Field> input;
+  input.chunk_bytes = 64;
+  REQUIRE(matrix);
+  REQUIRE(input.Load(filename, skip_explicit_zeros, mask));
+  REQUIRE(input.pattern.NumRows() == matrix->NumRows());
+  REQUIRE(input.pattern.NumColumns() == matrix->NumColumns());
+  REQUIRE(input.pattern.NumEntries() == matrix->NumEntries());
+  REQUIRE(Int(input.sources.Size()) == matrix->NumEntries());
+  for (Int index = 0; index < matrix->NumEntries(); ++index) {
+    const catamari::MatrixEntry<Field>& entry = matrix->Entry(index);
+    const catamari::MatrixEntry<Field>& pattern_entry =
+        input.pattern.Entry(index);
+    REQUIRE(pattern_entry.row == entry.row);
+    REQUIRE(pattern_entry.column == entry.column);
+    REQUIRE(input.values[input.sources[index]] == entry.value);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("General", "[General]") {
+  // A random matrix, without duplicates, which is split into many chunks.
+  const Int num_rows = 100;
+  const Int num_entries = 2000;
+  std::mt19937 generator(17u);
+  std::uniform_int_distribution<Int> index_distribution(1, num_rows);
+  std::uniform_int_distribution<Int> value_distribution(-4, 4);
+  std::set<std::pair<Int, Int>> locations;
+  while (Int(locations.size()) < num_entries) {
+    locations.emplace(index_distribution(generator),
+                      index_distribution(generator));
+  }
+  std::ostringstream os;
+  os << "%%MatrixMarket matrix coordinate real general\n"
+     << num_rows << " " << num_rows << " " << num_entries << "\n";
+  for (const std::pair<Int, Int>& location : locations) {
+    os << location.first << " " << location.second << " "
+       << value_distribution(generator) / 8. << "\n";
+  }
+  const std::string filename = "matrix_market_pipeline_test_general.mtx";
+  WriteFile(filename, os.str());
+
+  CompareWithReader<double>(filename, false, quotient::kEntryMaskFull);
+  CompareWithReader<double>(filename, true, quotient::kEntryMaskFull);
+  CompareWithReader<double>(filename, true, quotient::kEntryMaskLowerTriangle);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Hermitian", "[Hermitian]") {
+  const std::string filename = "matrix_market_pipeline_test_hermitian.mtx";
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate complex hermitian\n"
+            "3 3 4\n"
+            "1 1 2. 0.\n"
+            "2 1 -1. 0.5\n"
+            "2 2 3. 0.\n"
+            "3 2 0.25 -1.\n");
+  CompareWithReader<mantis::Complex<double>>(filename, false,
+                                             quotient::kEntryMaskFull);
+
+  // The mirrors of the off-diagonal entries store their conjugates.
+  catamari::PipelinedMatrixMarket<mantis::Complex<double>> input;
+  REQUIRE(input.Load(filename, false));
+  REQUIRE(input.values.Size() == 6);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Refactor", "[Refactor]") {
+  // The lower triangle of a shifted 2D negative Laplacian.
+  const Int num_x_elements = 30;
+  const Int num_y_elements = 20;
+  const Int num_rows = num_x_elements * num_y_elements;
+  std::ostringstream entries;
+  Int num_entries = 0;
+  for (Int y = 0; y < num_y_elements; ++y) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      const Int index = x + y * num_x_elements;
+      entries << index + 1 << " " << index + 1 << " 4.5\n";
+      ++num_entries;
+      if (x > 0) {
+        entries << index + 1 << " " << index << " -1\n";
+        ++num_entries;
+      }
+      if (y > 0) {
+        entries << index + 1 << " " << index - num_x_elements + 1 << " -1\n";
+        ++num_entries;
+      }
+    }
+  }
+  std::ostringstream os;
+  os << "%%MatrixMarket matrix coordinate real symmetric\n"
+     << num_rows << " " << num_rows << " " << num_entries << "\n"
+     << entries.str();
+  const std::string filename = "matrix_market_pipeline_test_laplacian.mtx";
+  WriteFile(filename, os.str());
+  CompareWithReader<double>(filename, false, quotient::kEntryMaskFull);
+
+  catamari::PipelinedMatrixMarket<double> input;
+  input.chunk_bytes = 1024;
+  REQUIRE(input.Load(filename, false));
+  REQUIRE(Int(input.values.Size()) == num_entries);
+  std::unique_ptr<CoordinateMatrix<double>> matrix =
+      CoordinateMatrix<double>::FromMatrixMarket(filename, false);
+  REQUIRE(matrix);
+  std::remove(filename.c_str());
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(input.pattern, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan plan;
+  input.FormConversionPlan(ldl, &plan);
+  const catamari::SparseLDLResult<double> result =
+      ldl.RefactorWithFixedSparsityPattern(plan, input.values.Data());
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<double> right_hand_sides;
+  right_hand_sides.Resize(num_rows, 1, 1.);
+  BlasMatrix<double> solution = right_hand_sides;
+  ldl.Solve(&solution.view);
+  BlasMatrix<double> residual = right_hand_sides;
+  catamari::ApplySparse(-1., *matrix, solution.ConstView(), 1.,
+                        &residual.view);
+  REQUIRE(catamari::EuclideanNorm(residual.ConstView()) <=
+          1e3 * std::numeric_limits<double>::epsilon() *
+              catamari::EuclideanNorm(right_hand_sides.ConstView()));
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include "catamari/coordinate_matrix.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::CoordinateMatrix;
+using catamari::Int;
+
+namespace {
+
+// Writes the given contents to a file with the given name.
+void WriteFile(const std::string& filename, const std::string& contents) {
+  std::ofstream file(filename);
+  file << contents;
+}
+
+// Returns the value parsed from a null-terminated string, or NaN on failure.
+double ParseReal(const char* token) {
+  double value;
+  const char* end = token + std::strlen(token);
+  if (catamari::ParseMatrixMarketReal(token, end, &value) != end) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return value;
+}
+
+// Reads the file with both the streaming and the memory-mapped readers and
+// requires that the results agree exactly.
+template <typename Field>
+void CompareReaders(const std::string& filename, bool skip_explicit_zeros,
+                    quotient::EntryMask mask) {
+  std::unique_ptr<CoordinateMatrix<Field>> streamed =
+      CoordinateMatrix<Field>::FromMatrixMarket(filename, skip_explicit_zeros,
+                                                mask);
+  std::unique_ptr<CoordinateMatrix<Field>> mapped =
+      CoordinateMatrix<Field>::FromMappedMatrixMarket(
+          filename, skip_explicit_zeros, mask);
+  REQUIRE(streamed);
+  REQUIRE(mapped);
+  REQUIRE(mapped->NumRows() == streamed->NumRows());
+  REQUIRE(mapped->NumColumns() == streamed->NumColumns());
+  REQUIRE(mapped->NumEntries() == streamed->NumEntries());
+  for (Int index = 0; index < streamed->NumEntries(); ++index) {
+    const catamari::MatrixEntry<Field>& entry = streamed->Entry(index);
+    const catamari::MatrixEntry<Field>& mapped_entry = mapped->Entry(index);
+    REQUIRE(mapped_entry.row == entry.row);
+    REQUIRE(mapped_entry.column == entry.column);
+    REQUIRE(mapped_entry.value == entry.value);
+  }
+  for (Int row = 0; row <= streamed->NumRows(); ++row) {
+    REQUIRE(mapped->RowEntryOffset(row) == streamed->RowEntryOffset(row));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Parse reals", "[Parse reals]") {
+  REQUIRE(ParseReal("0") == 0.);
+  REQUIRE(ParseReal("-2.5") == -2.5);
+  REQUIRE(ParseReal("+.125") == 0.125);
+  REQUIRE(ParseReal("1e3") == 1e3);
+  REQUIRE(ParseReal("1.5E-7") == 1.5e-7);
+  REQUIRE(ParseReal("0.1") == 0.1);
+  REQUIRE(ParseReal("123456789012345") == 123456789012345.);
+
+  // These exceed the exact range and fall back to std::strtod.
+  REQUIRE(ParseReal("1.2345678901234567890") == 1.2345678901234567890);
+  REQUIRE(ParseReal("4.9e-324") == 4.9e-324);
+  REQUIRE(ParseReal("1.7976931348623157e308") == 1.7976931348623157e308);
+  REQUIRE(ParseReal("-3.14159e-100") == -3.14159e-100);
+
+  // Malformed tokens are rejected.
+  REQUIRE(std::isnan(ParseReal("")));
+  REQUIRE(std::isnan(ParseReal("1.0x")));
+  REQUIRE(std::isnan(ParseReal("e5")));
+
+  // The fast path rounds correctly.
+  std::mt19937 generator(17u);
+  std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+  for (Int trial = 0; trial < 1000; ++trial) {
+    std::ostringstream os;
+    os.precision(12);
+    os << distribution(generator);
+    REQUIRE(ParseReal(os.str().c_str()) == std::strtod(os.str().c_str(), 0));
+  }
+}
+
+TEST_CASE("Parse entries", "[Parse entries]") {
+  catamari::MatrixMarketDescription description;
+  description.field = quotient::kMatrixMarketFieldReal;
+  const std::string line = "  3 17\t-4.5e1\n";
+  Int row, column;
+  double value;
+  const char* end = line.data() + line.size();
+  const char* iter = catamari::ParseMatrixMarketCoordinateEntry(
+      description, line.data(), end, &row, &column, &value);
+  REQUIRE(iter != nullptr);
+  REQUIRE(row == 2);
+  REQUIRE(column == 16);
+  REQUIRE(value == -45.);
+
+  description.field = quotient::kMatrixMarketFieldPattern;
+  const std::string pattern_line = "5 6\n";
+  iter = catamari::ParseMatrixMarketCoordinateEntry(
+      description, pattern_line.data(),
+      pattern_line.data() + pattern_line.size(), &row, &column, &value);
+  REQUIRE(iter != nullptr);
+  REQUIRE(row == 4);
+  REQUIRE(column == 5);
+  REQUIRE(value == 1.);
+
+  description.field = quotient::kMatrixMarketFieldComplex;
+  const std::string complex_line = "1 2 0.5 -0.25\n";
+  std::complex<double> complex_value;
+  iter = catamari::ParseMatrixMarketCoordinateEntry(
+      description, complex_line.data(),
+      complex_line.data() + complex_line.size(), &row, &column,
+      &complex_value);
+  REQUIRE(iter != nullptr);
+  REQUIRE(complex_value == std::complex<double>(0.5, -0.25));
+
+  const std::string truncated_line = "1 2 0.5\n";
+  iter = catamari::ParseMatrixMarketCoordinateEntry(
+      description, truncated_line.data(),
+      truncated_line.data() + truncated_line.size(), &row, &column,
+      &complex_value);
+  REQUIRE(iter == nullptr);
+}
+
+TEST_CASE("General", "[General]") {
+  // A shuffled random matrix with duplicates and explicit zeros which is large
+  // enough to be split into many chunks.
+  const Int num_rows = 300;
+  const Int num_columns = 200;
+  const Int num_entries = 20000;
+  std::mt19937 generator(17u);
+  std::uniform_int_distribution<Int> row_distribution(1, num_rows);
+  std::uniform_int_distribution<Int> column_distribution(1, num_columns);
+  std::uniform_int_distribution<Int> value_distribution(-4, 4);
+  std::ostringstream os;
+  os << "%%MatrixMarket matrix coordinate real general\n"
+     << "% A comment line.\n"
+     << num_rows << " " << num_columns << " " << num_entries << "\n";
+  for (Int index = 0; index < num_entries; ++index) {
+    os << row_distribution(generator) << " " << column_distribution(generator)
+       << " " << value_distribution(generator) / 8. << "\n";
+  }
+  const std::string filename = "matrix_market_reader_test_general.mtx";
+  WriteFile(filename, os.str());
+
+  CompareReaders<double>(filename, false, quotient::kEntryMaskFull);
+  CompareReaders<double>(filename, true, quotient::kEntryMaskFull);
+  CompareReaders<double>(filename, true, quotient::kEntryMaskLowerTriangle);
+  CompareReaders<double>(filename, false, quotient::kEntryMaskUpperTriangle);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Symmetric", "[Symmetric]") {
+  const std::string filename = "matrix_market_reader_test_symmetric.mtx";
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate real symmetric\n"
+            "4 4 6\n"
+            "1 1 4.\n"
+            "2 1 -1.\n"
+            "2 2 4.\n"
+            "\n"
+            "4 2 -1.25e-1\n"
+            "3 3 4.\n"
+            "4 4 0\n");
+  CompareReaders<double>(filename, false, quotient::kEntryMaskFull);
+  CompareReaders<double>(filename, true, quotient::kEntryMaskFull);
+
+  std::unique_ptr<CoordinateMatrix<double>> matrix =
+      CoordinateMatrix<double>::FromMappedMatrixMarket(
+          filename, true, quotient::kEntryMaskFull);
+  REQUIRE(matrix);
+  REQUIRE(matrix->NumEntries() == 7);
+  REQUIRE(matrix->Value(1, 3) == -0.125);
+  REQUIRE(matrix->Value(3, 1) == -0.125);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Hermitian", "[Hermitian]") {
+  const std::string filename = "matrix_market_reader_test_hermitian.mtx";
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate complex hermitian\n"
+            "3 3 4\n"
+            "1 1 2. 0.\n"
+            "2 1 0.5 -1.5\n"
+            "3 2 1e-3 2e-3\n"
+            "3 3 1. 0.\n");
+  CompareReaders<mantis::Complex<double>>(filename, false,
+                                          quotient::kEntryMaskFull);
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("Malformed", "[Malformed]") {
+  const std::string filename = "matrix_market_reader_test_malformed.mtx";
+
+  // Too few entries.
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate real general\n"
+            "2 2 3\n"
+            "1 1 1.\n"
+            "2 2 1.\n");
+  REQUIRE(!CoordinateMatrix<double>::FromMappedMatrixMarket(
+      filename, false, quotient::kEntryMaskFull));
+
+  // An out-of-bounds index.
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate real general\n"
+            "2 2 2\n"
+            "1 1 1.\n"
+            "3 2 1.\n");
+  REQUIRE(!CoordinateMatrix<double>::FromMappedMatrixMarket(
+      filename, false, quotient::kEntryMaskFull));
+
+  // A missing file.
+  std::remove(filename.c_str());
+  REQUIRE(!CoordinateMatrix<double>::FromMappedMatrixMarket(
+      filename, false, quotient::kEntryMaskFull));
+}
+
+TEST_CASE("Binary", "[Binary]") {
+  const std::string filename = "matrix_market_reader_test_binary.mtx";
+  const std::string binary_filename = "matrix_market_reader_test_binary.bin";
+  WriteFile(filename,
+            "%%MatrixMarket matrix coordinate complex general\n"
+            "5 4 6\n"
+            "1 1 2. 0.5\n"
+            "4 1 0.5 -1.5\n"
+            "4 3 1e-3 2e-3\n"
+            "1 4 -1. 0.\n"
+            "5 2 3. 1.\n"
+            "4 1 0.5 0.5\n");
+  typedef mantis::Complex<double> Field;
+  std::unique_ptr<CoordinateMatrix<Field>> matrix =
+      CoordinateMatrix<Field>::FromMatrixMarket(filename, false,
+                                                quotient::kEntryMaskFull);
+  REQUIRE(matrix);
+  matrix->ToBinary(binary_filename);
+
+  std::unique_ptr<CoordinateMatrix<Field>> loaded =
+      CoordinateMatrix<Field>::FromBinary(binary_filename);
+  REQUIRE(loaded);
+  REQUIRE(loaded->NumRows() == matrix->NumRows());
+  REQUIRE(loaded->NumColumns() == matrix->NumColumns());
+  REQUIRE(loaded->NumEntries() == matrix->NumEntries());
+  for (Int index = 0; index < matrix->NumEntries(); ++index) {
+    REQUIRE(loaded->Entry(index).row == matrix->Entry(index).row);
+    REQUIRE(loaded->Entry(index).column == matrix->Entry(index).column);
+    REQUIRE(loaded->Entry(index).value == matrix->Entry(index).value);
+  }
+  for (Int row = 0; row <= matrix->NumRows(); ++row) {
+    REQUIRE(loaded->RowEntryOffset(row) == matrix->RowEntryOffset(row));
+  }
+
+  // The scalar type must match.
+  REQUIRE(!CoordinateMatrix<double>::FromBinary(binary_filename));
+
+  // A truncated file is rejected.
+  {
+    std::ifstream file(binary_filename, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+    WriteFile(binary_filename, contents.substr(0, contents.size() - 8));
+  }
+  REQUIRE(!CoordinateMatrix<Field>::FromBinary(binary_filename));
+
+  // A Matrix Market file is not a binary file.
+  REQUIRE(!CoordinateMatrix<Field>::FromBinary(filename));
+
+  std::remove(filename.c_str());
+  std::remove(binary_filename.c_str());
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian in the lower precision and checks
+// that the refined solution of A x = b, with b the vector of all ones (and
+// its double), reaches working-precision accuracy against 'matrix'.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, bool fgmres_fallback, Int max_iters) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::MixedPrecisionSparseLDLControl<Field> control;
+  control.ldl_control.SetFactorizationType(factorization_type);
+  control.fgmres_fallback = fgmres_fallback;
+  control.refined_solve_control.max_iters = max_iters;
+  control.refined_solve_control.relative_tol =
+      1e3 * std::numeric_limits<Real>::epsilon();
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::MixedPrecisionSparseLDL<Field> ldl;
+  const auto result = ldl.Factor(matrix, control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<Field> right_hand_sides(num_rows, 2);
+  for (Int i = 0; i < num_rows; ++i) {
+    right_hand_sides(i, 0) = Field{1};
+    right_hand_sides(i, 1) = Field{2};
+  }
+  BlasMatrix<Field> solutions = right_hand_sides;
+  const catamari::MixedPrecisionSolveStatus<Real> status =
+      ldl.Solve(matrix, &solutions.view);
+
+  // Single precision alone only reaches a relative residual of about 1e-7.
+  const Real tolerance = control.refined_solve_control.relative_tol;
+  REQUIRE(status.residual_relative_max_norm <= tolerance);
+
+  // Recompute the residual independently of the solve.
+  catamari::ApplySparse(Field{-1}, matrix, solutions.ConstView(), Field{1},
+                        &right_hand_sides.view);
+  for (Int j = 0; j < 2; ++j) {
+    const Real residual_norm =
+        catamari::MaxNorm(right_hand_sides.Submatrix(0, j, num_rows, 1));
+    REQUIRE(residual_norm <= tolerance * (j + 1));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(40, 30, catamari::kCholeskyFactorization, 0.1, false, 10);
+  RunTest<catamari::Complex<double>>(40, 30, catamari::kCholeskyFactorization,
+                                     0.1, false, 10);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(40, 30, catamari::kLDLAdjointFactorization, -1., false, 10);
+  RunTest<catamari::Complex<double>>(
+      40, 30, catamari::kLDLAdjointFactorization, -1., false, 10);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<catamari::Complex<double>>(
+      40, 30, catamari::kLDLTransposeFactorization,
+      catamari::Complex<double>(-1., 0.5), false, 10);
+}
+
+// A single refinement step cannot reach double precision from a
+// single-precision factorization, so the FGMRES fallback must finish.
+TEST_CASE("FGMRES fallback", "[FGMRES fallback]") {
+  RunTest<double>(40, 30, catamari::kLDLAdjointFactorization, -1., true, 1);
+  RunTest<catamari::Complex<double>>(
+      40, 30, catamari::kLDLAdjointFactorization, -1., true, 1);
+}
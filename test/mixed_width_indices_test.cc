@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::PerturbedLaplacian;
+
+namespace {
+
+// Checks that the factored solution of A x = b, with b the vector of all
+// ones, has a small relative residual.
+void RunTest(const catamari::SparseLDLControl<double>& control) {
+  const catamari::CoordinateMatrix<double> matrix = PerturbedLaplacian(40, 4.5);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+  BlasMatrix<double> solution;
+  solution.Resize(num_rows, 1, 1.);
+  ldl.Solve(&solution.view);
+
+  Buffer<double> residual(num_rows, 1.);
+  for (const catamari::MatrixEntry<double>& entry : matrix.Entries()) {
+    residual[entry.row] -= entry.value * solution(entry.column, 0);
+  }
+  double residual_norm = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    residual_norm = std::max(residual_norm, std::abs(residual[i]));
+  }
+  REQUIRE(residual_norm <= 1e-12);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Local index width", "[Local index width]") {
+  REQUIRE(std::is_same<catamari::LocalInt, std::int32_t>::value);
+}
+
+TEST_CASE("Right-looking Cholesky", "[Right-looking Cholesky]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  control.reordering_strategy = catamari::kNestedDissectionReordering;
+  RunTest(control);
+
+  control.supernodal_control.stack_solve_workspace = true;
+  RunTest(control);
+}
+
+TEST_CASE("Left-looking LDL^H", "[Left-looking LDL^H]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kLeftLookingLDL;
+  RunTest(control);
+}
+
+TEST_CASE("Row-panel solves", "[Row-panel solves]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.solve_layout =
+      catamari::supernodal_ldl::kRowPanelSolveLayout;
+  RunTest(control);
+}
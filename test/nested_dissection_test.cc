@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/nested_dissection.hpp"
+#include "catamari/parallel_minimum_degree.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+
+namespace {
+
+// Returns a shifted 3D negative Laplacian, along with 'num_isolated' trailing
+// rows which are decoupled from the rest of the matrix.
+template <typename Field>
+catamari::CoordinateMatrix<Field> ShiftedLaplacian(Int num_x_elements,
+                                                   Int num_y_elements,
+                                                   Int num_z_elements,
+                                                   Int num_isolated,
+                                                   const Field& shift) {
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int y_stride = num_x_elements;
+  const Int z_stride = num_x_elements * num_y_elements;
+  const Int num_grid_rows = z_stride * num_z_elements;
+  const Int num_rows = num_grid_rows + num_isolated;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(7 * num_grid_rows + num_isolated);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      for (Int z = 0; z < num_z_elements; ++z) {
+        const Int index = x + y * y_stride + z * z_stride;
+        matrix.QueueEntryAddition(index, index, Field{6} + shift);
+        if (x > 0) matrix.QueueEntryAddition(index, index - 1, Field{-1});
+        if (x < num_x_elements - 1) {
+          matrix.QueueEntryAddition(index, index + 1, Field{-1});
+        }
+        if (y > 0) {
+          matrix.QueueEntryAddition(index, index - y_stride, Field{-1});
+        }
+        if (y < num_y_elements - 1) {
+          matrix.QueueEntryAddition(index, index + y_stride, Field{-1});
+        }
+        if (z > 0) {
+          matrix.QueueEntryAddition(index, index - z_stride, Field{-1});
+        }
+        if (z < num_z_elements - 1) {
+          matrix.QueueEntryAddition(index, index + z_stride, Field{-1});
+        }
+      }
+    }
+  }
+  for (Int index = num_grid_rows; index < num_rows; ++index) {
+    matrix.QueueEntryAddition(index, index, Field{1});
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Checks that the ordering is a postordered separator tree of the graph of
+// the matrix: the supernodes are nonempty and follow their descendants, and
+// the earlier endpoint of each edge lies in a descendant of (or the same
+// supernode as) the later one.
+template <typename Field>
+void CheckOrdering(const catamari::CoordinateMatrix<Field>& matrix,
+                   const catamari::SymmetricOrdering& ordering) {
+  const Int num_rows = matrix.NumRows();
+  const Int num_supernodes = ordering.supernode_sizes.Size();
+  const Buffer<Int>& parents = ordering.assembly_forest.parents;
+  REQUIRE(ordering.permutation.Size() == num_rows);
+  REQUIRE(ordering.supernode_offsets[num_supernodes] == num_rows);
+
+  Buffer<Int> visited(num_rows, 0);
+  for (Int row = 0; row < num_rows; ++row) {
+    REQUIRE(ordering.inverse_permutation[ordering.permutation[row]] == row);
+    ++visited[ordering.permutation[row]];
+  }
+  for (Int row = 0; row < num_rows; ++row) REQUIRE(visited[row] == 1);
+
+  Buffer<Int> member_to_supernode(num_rows);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    REQUIRE(ordering.supernode_sizes[supernode] > 0);
+    REQUIRE((parents[supernode] == -1 || parents[supernode] > supernode));
+    for (Int index = ordering.supernode_offsets[supernode];
+         index < ordering.supernode_offsets[supernode + 1]; ++index) {
+      member_to_supernode[index] = supernode;
+    }
+  }
+
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    Int row = ordering.permutation[entry.row];
+    Int column = ordering.permutation[entry.column];
+    if (row < column) std::swap(row, column);
+    Int supernode = member_to_supernode[column];
+    while (supernode != -1 && supernode != member_to_supernode[row]) {
+      supernode = parents[supernode];
+    }
+    REQUIRE(supernode == member_to_supernode[row]);
+  }
+}
+
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(18, 15, 12, 3, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.reordering_strategy = catamari::kNestedDissectionReordering;
+  ldl_control.nd_control.leaf_size = 32;
+  ldl_control.nd_control.parallel_size = 256;
+
+  catamari::SymmetricOrdering ordering;
+  catamari::NestedDissection(matrix, ldl_control.nd_control, &ordering);
+  CheckOrdering(matrix, ordering);
+
+  // The three isolated rows and the grid are separate trees.
+  REQUIRE(ordering.assembly_forest.roots.Size() == 4);
+
+  catamari::SparseLDL<Field> ldl;
+  catamari::SparseLDLResult<Field> result;
+  tbb::task_arena arena(4);
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1);
+  RunTest<mantis::Complex<double>>(catamari::kCholeskyFactorization, 0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(-1., 0.5));
+}
+
+TEST_CASE("Parallel minimum degree", "[Parallel minimum degree]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(24, 20, 16, 3, 0.1);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.reordering_strategy = catamari::kParallelMinimumDegreeReordering;
+  ldl_control.pmd_control.num_threads = 4;
+  ldl_control.pmd_control.min_subgraph_size = 256;
+
+  // The subgraphs keep the supernodes of their minimum degree reorderings.
+  catamari::SymmetricOrdering ordering;
+  catamari::ParallelMinimumDegree(matrix, ldl_control.pmd_control, &ordering);
+  CheckOrdering(matrix, ordering);
+  const Int subgraph_size = num_rows / 16 + 1;
+  REQUIRE(ordering.supernode_sizes.Size() > 16);
+  for (const Int& supernode_size : ordering.supernode_sizes) {
+    REQUIRE(supernode_size < subgraph_size);
+  }
+
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, ordering, ldl_control).num_successful_pivots ==
+          num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  catamari::SparseLDLResult<double> result;
+  tbb::task_arena arena(4);
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+}
+
+TEST_CASE("Serial minimum degree", "[Serial minimum degree]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(10, 9, 8, 0, 0.1);
+
+  // A graph below the minimum subgraph size is reordered by a single minimum
+  // degree pass.
+  catamari::ParallelMinimumDegreeControl control;
+  catamari::SymmetricOrdering ordering;
+  catamari::ParallelMinimumDegree(matrix, control, &ordering);
+  CheckOrdering(matrix, ordering);
+
+  quotient::QuotientGraph quotient_graph(matrix.NumRows(), matrix.Entries(),
+                                         control.md_control);
+  quotient::MinimumDegree(&quotient_graph);
+  Buffer<Int> inverse_permutation;
+  quotient_graph.ComputePostorder(&inverse_permutation);
+  for (Int index = 0; index < matrix.NumRows(); ++index) {
+    REQUIRE(inverse_permutation[index] == ordering.inverse_permutation[index]);
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <tbb/task_arena.h>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catamari/philox.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Forms the marginal kernel K = L (I + L)^{-1} of a non-Hermitian L-ensemble
+// whose kernel L = B B^T + (C - C^T) has a positive semi-definite symmetric
+// part.
+void FormKernel(Int height, std::mt19937* generator,
+                BlasMatrix<double>* kernel) {
+  std::normal_distribution<double> normal_dist{0., 1.};
+  const Int rank = height / 4;
+  Eigen::MatrixXd factor(height, rank);
+  Eigen::MatrixXd skew(height, height);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      factor(i, j) = 0.3 * normal_dist(*generator);
+    }
+  }
+  for (Int j = 0; j < height; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      skew(i, j) = 0.1 * normal_dist(*generator);
+    }
+  }
+  const Eigen::MatrixXd ensemble =
+      factor * factor.transpose() + skew - skew.transpose();
+  const Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(height, height);
+  const Eigen::MatrixXd marginal =
+      identity - (identity + ensemble).partialPivLu().inverse();
+
+  kernel->Resize(height, height);
+  for (Int j = 0; j < height; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      kernel->Entry(i, j) = marginal(i, j);
+    }
+  }
+}
+
+// Checks that the reusable sampler matches the one-shot sampler, both for a
+// single sample and for each of a concurrent batch, regardless of the number
+// of threads and of the reuse of the workspaces.
+void RunTest(Int height, Int block_size) {
+  const Int num_samples = 9;
+  const std::uint64_t seed = 29;
+  std::mt19937 generator(17);
+  BlasMatrix<double> kernel;
+  FormKernel(height, &generator, &kernel);
+
+  const catamari::NonHermitianDPPSampler<double> sampler(kernel.ConstView(),
+                                                         block_size);
+  REQUIRE(sampler.NumItems() == height);
+
+  for (const bool maximum_likelihood : {true, false}) {
+    BlasMatrix<double> factor = kernel;
+    std::mt19937 expected_generator(23);
+    const std::vector<Int> expected = catamari::SampleNonHermitianDPP(
+        block_size, maximum_likelihood, &factor.view, &expected_generator);
+    std::mt19937 sampler_generator(23);
+    REQUIRE(sampler.Sample(maximum_likelihood, &sampler_generator) ==
+            expected);
+
+    std::vector<std::vector<Int>> expected_samples(num_samples);
+    for (Int index = 0; index < num_samples; ++index) {
+      factor = kernel;
+      catamari::PhiloxEngine philox(seed, static_cast<std::uint32_t>(index));
+      expected_samples[index] = catamari::SampleNonHermitianDPP(
+          block_size, maximum_likelihood, &factor.view, &philox);
+    }
+
+    for (const int num_threads : {1, 4}) {
+      tbb::task_arena arena(num_threads);
+      for (Int batch = 0; batch < 2; ++batch) {
+        std::vector<std::vector<Int>> samples;
+        arena.execute([&]() {
+          samples = sampler.SampleMany(num_samples, maximum_likelihood, seed);
+        });
+        REQUIRE(samples == expected_samples);
+      }
+    }
+  }
+
+  // An empty batch draws no samples.
+  REQUIRE(sampler.SampleMany(0, false, seed).empty());
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Unblocked", "[Unblocked]") { RunTest(60, 128); }
+
+TEST_CASE("Blocked", "[Blocked]") { RunTest(150, 32); }
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/ordering_cache.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari::OrderingCache;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+TEST_CASE("Fingerprint", "[Fingerprint]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(20, 20, 1.);
+  const catamari::CoordinateMatrix<double> shifted =
+      ShiftedLaplacian(20, 20, 2.);
+  const catamari::CoordinateMatrix<double> larger =
+      ShiftedLaplacian(21, 21, 1.);
+
+  // The fingerprint depends only upon the pattern.
+  REQUIRE(catamari::PatternFingerprint(matrix) ==
+          catamari::PatternFingerprint(shifted));
+  REQUIRE(!(catamari::PatternFingerprint(matrix) ==
+            catamari::PatternFingerprint(larger)));
+
+  // Moving a single entry (while preserving the row counts) changes it.
+  catamari::CoordinateMatrix<double> moved = matrix;
+  moved.QueueEntryRemoval(0, 1);
+  moved.QueueEntryAddition(0, 2, -1.);
+  moved.FlushEntryQueues();
+  REQUIRE(moved.NumEntries() == matrix.NumEntries());
+  REQUIRE(!(catamari::PatternFingerprint(matrix) ==
+            catamari::PatternFingerprint(moved)));
+}
+
+TEST_CASE("Factorization reuse", "[Reuse]") {
+  OrderingCache& cache = OrderingCache::Global();
+  cache.Clear();
+  cache.SetLimits(32, 0);
+  const OrderingCache::Statistics initial = cache.LookupStatistics();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.cache_orderings = true;
+
+  // A second factorization object with the same pattern hits the cache.
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 30, 1.);
+  const catamari::CoordinateMatrix<double> shifted =
+      ShiftedLaplacian(30, 30, 2.);
+  catamari::SparseLDL<double> ldl, shifted_ldl;
+  ldl.Factor(matrix, ldl_control);
+  REQUIRE(cache.NumOrderings() == 1);
+  REQUIRE(cache.NumBytes() > 0);
+  shifted_ldl.Factor(shifted, ldl_control);
+  REQUIRE(cache.NumOrderings() == 1);
+
+  OrderingCache::Statistics statistics = cache.LookupStatistics();
+  REQUIRE(statistics.num_misses == initial.num_misses + 1);
+  REQUIRE(statistics.num_hits == initial.num_hits + 1);
+
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  REQUIRE(RelativeResidual(shifted, shifted_ldl) <= tolerance);
+
+  // The reordering strategy is part of the key.
+  ldl_control.reordering_strategy = catamari::kNestedDissectionReordering;
+  shifted_ldl.Factor(shifted, ldl_control);
+  REQUIRE(cache.NumOrderings() == 2);
+  REQUIRE(RelativeResidual(shifted, shifted_ldl) <= tolerance);
+
+  cache.Clear();
+  REQUIRE(cache.NumOrderings() == 0);
+  REQUIRE(cache.NumBytes() == 0);
+}
+
+TEST_CASE("Eviction", "[Eviction]") {
+  OrderingCache& cache = OrderingCache::Global();
+  cache.Clear();
+  cache.SetLimits(1, 0);
+  const OrderingCache::Statistics initial = cache.LookupStatistics();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.cache_orderings = true;
+
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(10, 10, 1.);
+  const catamari::CoordinateMatrix<double> larger =
+      ShiftedLaplacian(12, 12, 1.);
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(matrix, ldl_control);
+  ldl.Factor(larger, ldl_control);
+  REQUIRE(cache.NumOrderings() == 1);
+  REQUIRE(cache.LookupStatistics().num_evictions == initial.num_evictions + 1);
+
+  // The first pattern was evicted, so it misses again.
+  ldl.Factor(matrix, ldl_control);
+  const OrderingCache::Statistics statistics = cache.LookupStatistics();
+  REQUIRE(statistics.num_misses == initial.num_misses + 3);
+  REQUIRE(statistics.num_hits == initial.num_hits);
+
+  // A byte limit below the size of any ordering empties the cache.
+  cache.SetLimits(1, 1);
+  REQUIRE(cache.NumOrderings() == 0);
+
+  cache.Clear();
+  cache.SetLimits(32, std::size_t(256) << 20);
+}
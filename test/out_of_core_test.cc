@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian with its factor stored
+// out-of-core, keeping at most the given number of bytes resident.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, double memory_budget) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.out_of_core_directory = ".";
+  ldl_control.supernodal_control.out_of_core_memory_budget = memory_budget;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  // Refactor so that the reuse of the mapped storage is also exercised.
+  catamari::SparseLDL<Field> ldl;
+  for (Int factorization = 0; factorization < 2; ++factorization) {
+    const catamari::SparseLDLResult<Field> result =
+        factorization ? ldl.RefactorWithFixedSparsityPattern(matrix)
+                      : ldl.Factor(matrix, ldl_control);
+    REQUIRE(result.num_successful_pivots == num_rows);
+
+    const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  for (double memory_budget : {0., 1e5, 1e12}) {
+    RunTest<double>(60, 50, catamari::kCholeskyFactorization, 0.1,
+                    memory_budget);
+    RunTest<mantis::Complex<double>>(60, 50, catamari::kCholeskyFactorization,
+                                     0.1, memory_budget);
+  }
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  for (double memory_budget : {0., 1e5}) {
+    RunTest<double>(60, 50, catamari::kLDLAdjointFactorization, -1.,
+                    memory_budget);
+    RunTest<mantis::Complex<double>>(60, 50,
+                                     catamari::kLDLAdjointFactorization, -1.,
+                                     memory_budget);
+  }
+}
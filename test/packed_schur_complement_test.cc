@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <set>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/packed_lower_matrix_view.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari::PackedLowerMatrixView;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian on a single thread, with the Schur
+// complements of its subtree packed into panels of 'panel_width' columns (or
+// stored as full squares if it is zero), and returns the result.
+template <typename Field>
+catamari::SparseLDLResult<Field> RunTest(
+    Int num_x_elements, Int num_y_elements,
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, Int panel_width) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.min_parallel_threshold =
+      std::numeric_limits<double>::infinity();
+  ldl_control.supernodal_control.schur_complement_panel_width = panel_width;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  return result;
+}
+
+// Factors with packed Schur complements of several panel widths and checks
+// that each shrinks the frontal stack.
+template <typename Field>
+void RunPanelWidths(catamari::SymmetricFactorizationType factorization_type,
+                    const Field& shift) {
+  const catamari::SparseLDLResult<Field> full =
+      RunTest<Field>(30, 25, factorization_type, shift, 0);
+  for (Int panel_width : {1, 4, 16}) {
+    const catamari::SparseLDLResult<Field> packed =
+        RunTest<Field>(30, 25, factorization_type, shift, panel_width);
+    REQUIRE(packed.num_merged_bytes == full.num_merged_bytes);
+    REQUIRE(packed.max_stack_bytes < full.max_stack_bytes);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Packed view", "[Packed view]") {
+  for (Int size = 0; size < 20; ++size) {
+    for (Int panel_width : {0, 1, 3, 7, 19, 25}) {
+      const Int num_entries =
+          PackedLowerMatrixView<double>::NumEntries(size, panel_width);
+      Buffer<double> storage(num_entries);
+      PackedLowerMatrixView<double> view;
+      view.size = size;
+      view.panel_width = panel_width;
+      view.data = storage.Data();
+
+      // Each entry of the lower triangle has its own position in the storage.
+      std::set<const double*> positions;
+      for (Int j = 0; j < size; ++j) {
+        for (Int i = j; i < size; ++i) {
+          const double* position = &view(i, j);
+          REQUIRE(position >= storage.Data());
+          REQUIRE(position < storage.Data() + num_entries);
+          REQUIRE(positions.insert(position).second);
+        }
+      }
+      if (panel_width <= 0 || panel_width >= size) {
+        REQUIRE(num_entries == size * size);
+      }
+
+      // The panels address the same entries.
+      for (Int panel = 0; panel < view.NumPanels(); ++panel) {
+        const catamari::BlasMatrixView<double> panel_view = view.Panel(panel);
+        const Int panel_beg = view.PanelBeg(panel);
+        for (Int j = 0; j < panel_view.width; ++j) {
+          for (Int i = j; i < panel_view.height; ++i) {
+            REQUIRE(panel_view.Pointer(i, j) ==
+                    &view(panel_beg + i, panel_beg + j));
+          }
+        }
+      }
+    }
+  }
+  REQUIRE(PackedLowerMatrixView<double>::NumEntries(100, 16) < 6000);
+}
+
+TEST_CASE("Packed outer product", "[Packed outer product]") {
+  const Int size = 37;
+  const Int rank = 5;
+  BlasMatrix<double> left;
+  left.Resize(size, rank);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < size; ++i) {
+      left(i, j) = 1. / (i + 2 * j + 1);
+    }
+  }
+
+  BlasMatrix<double> expected;
+  expected.Resize(size, size, 1.);
+  catamari::LowerNormalHermitianOuterProduct(-1., left.ConstView(), 1.,
+                                             &expected.view);
+
+  for (Int panel_width : {1, 4, 16, 37}) {
+    Buffer<double> storage(
+        PackedLowerMatrixView<double>::NumEntries(size, panel_width), 1.);
+    PackedLowerMatrixView<double> packed;
+    packed.size = size;
+    packed.panel_width = panel_width;
+    packed.data = storage.Data();
+    catamari::PackedLowerNormalHermitianOuterProduct(-1., left.ConstView(), 1.,
+                                                     &packed);
+    for (Int j = 0; j < size; ++j) {
+      for (Int i = j; i < size; ++i) {
+        REQUIRE(std::abs(packed(i, j) - expected(i, j)) <= 1e-14);
+      }
+    }
+  }
+}
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunPanelWidths<double>(catamari::kCholeskyFactorization, 0.1);
+  RunPanelWidths<mantis::Complex<double>>(catamari::kCholeskyFactorization,
+                                          0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunPanelWidths<double>(catamari::kLDLAdjointFactorization, -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunPanelWidths<mantis::Complex<double>>(
+      catamari::kLDLTransposeFactorization, mantis::Complex<double>(-1., 0.5));
+}
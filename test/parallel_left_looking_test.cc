@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Runs the supernodal left-looking factorization in a single-threaded arena
+// and, with every subtree containing more than 'min_parallel_work' flops
+// factored as concurrent tasks, in a four-threaded arena. The results and
+// the solutions must agree.
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, double min_parallel_work,
+             bool expect_success) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(10, 9, 8, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kLeftLookingLDL;
+  ldl_control.supernodal_control.min_parallel_threshold = min_parallel_work;
+  ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+  catamari::SparseLDL<Field> serial_ldl, parallel_ldl;
+  catamari::SparseLDLResult<Field> serial_result, parallel_result;
+  tbb::task_arena serial_arena(1);
+  serial_arena.execute(
+      [&]() { serial_result = serial_ldl.Factor(matrix, ldl_control); });
+  tbb::task_arena arena(4);
+  arena.execute(
+      [&]() { parallel_result = parallel_ldl.Factor(matrix, ldl_control); });
+
+  REQUIRE(parallel_result.num_factorization_entries ==
+          serial_result.num_factorization_entries);
+  if (!expect_success) {
+    // The concurrent subtrees may stop at different supernodes.
+    REQUIRE(serial_result.num_successful_pivots < num_rows);
+    REQUIRE(parallel_result.num_successful_pivots < num_rows);
+    return;
+  }
+  REQUIRE(serial_result.num_successful_pivots == num_rows);
+  REQUIRE(parallel_result.num_successful_pivots == num_rows);
+  REQUIRE(parallel_result.num_positive_pivots ==
+          serial_result.num_positive_pivots);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  BlasMatrix<Field> serial_solution, parallel_solution;
+  serial_solution.Resize(num_rows, 1, Field{1});
+  parallel_solution.Resize(num_rows, 1, Field{1});
+  serial_ldl.Solve(&serial_solution.view);
+  parallel_ldl.Solve(&parallel_solution.view);
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    max_difference =
+        std::max(max_difference,
+                 std::abs(serial_solution(i, 0) - parallel_solution(i, 0)));
+    max_entry = std::max(max_entry, std::abs(serial_solution(i, 0)));
+  }
+  REQUIRE(max_difference <= tolerance * max_entry);
+}
+
+// Runs the right-looking factorization with and without factoring its
+// sequential subtrees with fronts of at most 'max_front' rows left-looking,
+// in a four-threaded arena. The results and the solutions must agree.
+template <typename Field>
+void RunHybridTest(catamari::SymmetricFactorizationType factorization_type,
+                   const Field& shift, Int max_front) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(10, 9, 8, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+
+  catamari::SparseLDL<Field> ldl, hybrid_ldl;
+  catamari::SparseLDLResult<Field> result, hybrid_result;
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    result = ldl.Factor(matrix, ldl_control);
+    ldl_control.supernodal_control.left_looking_subtree_max_front = max_front;
+    hybrid_result = hybrid_ldl.Factor(matrix, ldl_control);
+    // The subtrees are selected anew by a refactorization.
+    hybrid_result = hybrid_ldl.RefactorWithFixedSparsityPattern(matrix);
+  });
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(hybrid_result.num_successful_pivots == num_rows);
+  REQUIRE(hybrid_result.num_positive_pivots == result.num_positive_pivots);
+  REQUIRE(hybrid_result.num_factorization_entries ==
+          result.num_factorization_entries);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  BlasMatrix<Field> solution, hybrid_solution;
+  solution.Resize(num_rows, 1, Field{1});
+  hybrid_solution.Resize(num_rows, 1, Field{1});
+  ldl.Solve(&solution.view);
+  hybrid_ldl.Solve(&hybrid_solution.view);
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    max_difference = std::max(
+        max_difference, std::abs(solution(i, 0) - hybrid_solution(i, 0)));
+    max_entry = std::max(max_entry, std::abs(solution(i, 0)));
+  }
+  REQUIRE(max_difference <= tolerance * max_entry);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1, 0., true);
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1, 1e4, true);
+}
+
+TEST_CASE("Cholesky failure", "[Cholesky failure]") {
+  RunTest<double>(catamari::kCholeskyFactorization, -3., 0., false);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, -1., 0., true);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(-1., 0.5), 0.,
+                                   true);
+}
+
+TEST_CASE("Hybrid", "[Hybrid]") {
+  // Every sequential subtree, and only those with small fronts.
+  RunHybridTest<double>(catamari::kCholeskyFactorization, 0.1, 1000);
+  RunHybridTest<double>(catamari::kCholeskyFactorization, 0.1, 40);
+  RunHybridTest<double>(catamari::kLDLAdjointFactorization, -1., 1000);
+  RunHybridTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                         mantis::Complex<double>(-1., 0.5),
+                                         40);
+}
+
+TEST_CASE("Memory budget", "[Memory budget]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(10, 9, 8, 0.1);
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kAdaptiveLDL;
+  ldl_control.supernodal_control.factorization_memory_budget = 1;
+
+  // No factorization fits within a single byte, so the adaptive choice must
+  // be the left-looking factorization.
+  catamari::SparseLDL<double> ldl;
+  tbb::task_arena arena(4);
+  catamari::SparseLDLResult<double> result;
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == matrix.NumRows());
+  REQUIRE(ldl.supernodal_factorization->GetControl().algorithm ==
+          catamari::kLeftLookingLDL);
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::BlasMatrixView;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Fills the first 'num_rows' rows of a (taller) matrix with deterministic
+// right-hand sides and returns a view of them.
+template <typename Field>
+BlasMatrixView<Field> RightHandSides(Int num_rows, Int num_rhs,
+                                     BlasMatrix<Field>* storage) {
+  storage->Resize(num_rows + 3, num_rhs, Field{0});
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      storage->Entry(i, j) = Field(double((i * 7 + j * 3) % 11) - 5.);
+    }
+  }
+  return storage->view.Submatrix(0, 0, num_rows, num_rhs);
+}
+
+// Solves with 'num_rhs' right-hand sides (stored with padding between the
+// columns) in a single-threaded arena and in a four-threaded arena, where the
+// latter runs the dataflow forward sweep and gathers and scatters the
+// permuted rows supernode by supernode, and returns the maximum difference.
+template <typename Field>
+catamari::ComplexBase<Field> RunTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, Int num_rhs, Int rhs_block_size) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(12, 11, 10, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  ldl_control.supernodal_control.solve_rhs_block_size = rhs_block_size;
+
+  catamari::SparseLDL<Field> ldl;
+  tbb::task_arena arena(4);
+  catamari::SparseLDLResult<Field> result;
+  arena.execute([&]() { result = ldl.Factor(matrix, ldl_control); });
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<Field> serial_storage, parallel_storage;
+  BlasMatrixView<Field> serial_solution =
+      RightHandSides(num_rows, num_rhs, &serial_storage);
+  BlasMatrixView<Field> parallel_solution =
+      RightHandSides(num_rows, num_rhs, &parallel_storage);
+  tbb::task_arena serial_arena(1);
+  serial_arena.execute([&]() { ldl.Solve(&serial_solution); });
+  arena.execute([&]() { ldl.Solve(&parallel_solution); });
+
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      max_difference =
+          std::max(max_difference, std::abs(serial_solution(i, j) -
+                                            parallel_solution(i, j)));
+      max_entry = std::max(max_entry, std::abs(serial_solution(i, j)));
+    }
+    // The padding rows are untouched.
+    REQUIRE(parallel_storage(num_rows, j) == Field{0});
+  }
+  return max_difference / max_entry;
+}
+
+// Solves with a scalar factorization, whose triangular solves are level
+// scheduled, in a single-threaded and a four-threaded arena and returns the
+// maximum difference.
+template <typename Field>
+catamari::ComplexBase<Field> RunScalarTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    catamari::LDLAlgorithm algorithm, const Field& shift, Int num_rhs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(12, 11, 10, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kScalarFactorization;
+  ldl_control.scalar_control.algorithm = algorithm;
+  ldl_control.scalar_control.min_level_scheduled_solve_rows = 0;
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  BlasMatrix<Field> serial_storage, parallel_storage;
+  BlasMatrixView<Field> serial_solution =
+      RightHandSides(num_rows, num_rhs, &serial_storage);
+  BlasMatrixView<Field> parallel_solution =
+      RightHandSides(num_rows, num_rhs, &parallel_storage);
+  tbb::task_arena serial_arena(1);
+  serial_arena.execute([&]() { ldl.Solve(&serial_solution); });
+  tbb::task_arena arena(4);
+  arena.execute([&]() { ldl.Solve(&parallel_solution); });
+
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      max_difference =
+          std::max(max_difference, std::abs(serial_solution(i, j) -
+                                            parallel_solution(i, j)));
+      max_entry = std::max(max_entry, std::abs(serial_solution(i, j)));
+    }
+  }
+  return max_difference / max_entry;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<double>(catamari::kCholeskyFactorization, 0.1, 1, 64) <=
+          tolerance);
+  REQUIRE(RunTest<double>(catamari::kCholeskyFactorization, 0.1, 7, 3) <=
+          tolerance);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<double>(catamari::kLDLAdjointFactorization, -1., 5, 2) <=
+          tolerance);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<mantis::Complex<double>>(
+              catamari::kLDLTransposeFactorization,
+              mantis::Complex<double>(-1., 0.5), 4, 64) <= tolerance);
+}
+
+TEST_CASE("Scalar level scheduling", "[Scalar level scheduling]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunScalarTest<double>(catamari::kCholeskyFactorization,
+                                catamari::kUpLookingLDL, 0.1, 3) <=
+          tolerance);
+  REQUIRE(RunScalarTest<double>(catamari::kLDLAdjointFactorization,
+                                catamari::kLeftLookingLDL, -1., 1) <=
+          tolerance);
+  REQUIRE(RunScalarTest<mantis::Complex<double>>(
+              catamari::kLDLTransposeFactorization, catamari::kUpLookingLDL,
+              mantis::Complex<double>(-1., 0.5), 2) <= tolerance);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Runs the scalar up-looking factorization in a single-threaded arena and,
+// with subtree tasks of at most 'grain_size' rows, in a four-threaded arena.
+// The results, the diagonal factors, and the solutions must agree.
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, Int grain_size, bool expect_success) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(9, 8, 7, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kScalarFactorization;
+  ldl_control.scalar_control.algorithm = catamari::kUpLookingLDL;
+  ldl_control.scalar_control.up_looking_grain_size = grain_size;
+
+  catamari::SparseLDL<Field> serial_ldl, parallel_ldl;
+  catamari::SparseLDLResult<Field> serial_result, parallel_result;
+  tbb::task_arena serial_arena(1);
+  serial_arena.execute(
+      [&]() { serial_result = serial_ldl.Factor(matrix, ldl_control); });
+  tbb::task_arena arena(4);
+  arena.execute(
+      [&]() { parallel_result = parallel_ldl.Factor(matrix, ldl_control); });
+
+  REQUIRE(parallel_result.num_successful_pivots ==
+          serial_result.num_successful_pivots);
+  REQUIRE(parallel_result.num_factorization_entries ==
+          serial_result.num_factorization_entries);
+  if (expect_success) {
+    REQUIRE(serial_result.num_successful_pivots == num_rows);
+  } else {
+    REQUIRE(serial_result.num_successful_pivots < num_rows);
+    return;
+  }
+
+  const Buffer<Field>& serial_diagonal =
+      serial_ldl.scalar_factorization->diagonal_factor.values;
+  const Buffer<Field>& parallel_diagonal =
+      parallel_ldl.scalar_factorization->diagonal_factor.values;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (Int row = 0; row < num_rows; ++row) {
+    REQUIRE(std::abs(serial_diagonal[row] - parallel_diagonal[row]) <=
+            tolerance * std::abs(serial_diagonal[row]));
+  }
+
+  BlasMatrix<Field> serial_solution, parallel_solution;
+  serial_solution.Resize(num_rows, 1, Field{1});
+  parallel_solution.Resize(num_rows, 1, Field{1});
+  serial_ldl.Solve(&serial_solution.view);
+  parallel_ldl.Solve(&parallel_solution.view);
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    max_difference =
+        std::max(max_difference,
+                 std::abs(serial_solution(i, 0) - parallel_solution(i, 0)));
+    max_entry = std::max(max_entry, std::abs(serial_solution(i, 0)));
+  }
+  REQUIRE(max_difference <= tolerance * max_entry);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1, 8, true);
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1, 64, true);
+}
+
+TEST_CASE("Cholesky failure", "[Cholesky failure]") {
+  RunTest<double>(catamari::kCholeskyFactorization, -3., 8, false);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, -1., 16, true);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(-1., 0.5), 8, true);
+}
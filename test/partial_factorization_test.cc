@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Returns the max norm of S inv(A)(interface, interface) - I, where S is the
+// given Schur complement onto the interface rows 'interface_rows'.
+template <typename Field>
+catamari::ComplexBase<Field> SchurComplementError(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    const catamari::SparseLDLControl<Field>& ldl_control,
+    const Buffer<Int>& interface_rows,
+    const BlasMatrix<Field>& schur_complement) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_rows = matrix.NumRows();
+  const Int num_interface = interface_rows.Size();
+
+  catamari::SparseLDL<Field> ldl;
+  catamari::SparseLDLControl<Field> control = ldl_control;
+  control.supernodal_strategy = catamari::kScalarFactorization;
+  const catamari::SparseLDLResult<Field> result = ldl.Factor(matrix, control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  // The interface block of the inverse is the inverse of the Schur complement.
+  BlasMatrix<Field> right_hand_sides;
+  right_hand_sides.Resize(num_rows, num_interface, Field{0});
+  for (Int j = 0; j < num_interface; ++j) {
+    right_hand_sides(interface_rows[j], j) = Field{1};
+  }
+  ldl.Solve(&right_hand_sides.view);
+
+  Real error = 0;
+  for (Int j = 0; j < num_interface; ++j) {
+    for (Int i = 0; i < num_interface; ++i) {
+      Field product = i == j ? Field{-1} : Field{0};
+      for (Int k = 0; k < num_interface; ++k) {
+        product +=
+            schur_complement(i, k) * right_hand_sides(interface_rows[k], j);
+      }
+      error = std::max(error, std::abs(product));
+    }
+  }
+  return error;
+}
+
+// Eliminates all but one grid line (plus one isolated corner vertex) of a 2D
+// negative Laplacian, and checks the resulting Schur complement, both from
+// the initial factorization and from a shifted refactorization through a
+// conversion plan.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  // Order the vertical grid line through the middle of the domain last, which
+  // separates the interior into two disconnected subdomains, followed by the
+  // (coupled) upper-left corner.
+  const Int separator_x = num_x_elements / 2;
+  const Int num_interface = num_y_elements + 1;
+  Buffer<Int> interface_rows(num_interface);
+  for (Int y = 0; y < num_y_elements; ++y) {
+    interface_rows[y] = separator_x + y * num_x_elements;
+  }
+  interface_rows[num_y_elements] = 0;
+  const Int num_interior = num_rows - num_interface;
+
+  catamari::SymmetricOrdering ordering;
+  ordering.permutation.Resize(num_rows, -1);
+  for (Int i = 0; i < num_interface; ++i) {
+    ordering.permutation[interface_rows[i]] = num_interior + i;
+  }
+  for (Int row = 0, interior_index = 0; row < num_rows; ++row) {
+    if (ordering.permutation[row] == -1) {
+      ordering.permutation[row] = interior_index++;
+    }
+  }
+  catamari::InvertPermutation(ordering.permutation,
+                              &ordering.inverse_permutation);
+
+  catamari::SparseLDL<Field> ldl;
+  BlasMatrix<Field> schur_complement;
+  const catamari::SparseLDLResult<Field> result = ldl.FactorPartial(
+      matrix, ordering, num_interior, ldl_control, &schur_complement);
+  REQUIRE(result.num_successful_pivots == num_interior);
+  REQUIRE(schur_complement.Height() == num_interface);
+  REQUIRE(schur_complement.Width() == num_interface);
+
+  const Real tolerance = 1e4 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(SchurComplementError(matrix, ldl_control, interface_rows,
+                               schur_complement) <= tolerance);
+
+  // Refactor 'matrix + shift_update I' using a conversion plan.
+  const Field shift_update = Field{0.5};
+  catamari::ConversionPlan cplan;
+  ldl.supernodal_factorization->FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+  const catamari::SparseLDLResult<Field> refactor_result =
+      ldl.RefactorWithFixedSparsityPattern(cplan, values.Data(), shift_update);
+  REQUIRE(refactor_result.num_successful_pivots == num_interior);
+  ldl.PartialSchurComplement(&schur_complement);
+
+  const catamari::CoordinateMatrix<Field> shifted_matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift + shift_update);
+  REQUIRE(SchurComplementError(shifted_matrix, ldl_control, interface_rows,
+                               schur_complement) <= tolerance);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization, 0.1);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kCholeskyFactorization,
+                                   0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  // A shift of -1 makes the matrix indefinite.
+  RunTest<double>(20, 15, catamari::kLDLAdjointFactorization, -1.);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kLDLAdjointFactorization,
+                                   -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<double>(20, 15, catamari::kLDLTransposeFactorization, -1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization,
+      mantis::Complex<double>(-1., 0.5));
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+// A regression guard for the throughput of the supernodal factorization,
+// refactorization, and solves of fixed-size problems. Each measured rate (the
+// best of several repetitions) is compared against the baseline of the same
+// name in the file named by 'CATAMARI_PERFORMANCE_BASELINES' (by default,
+// test/performance_baselines.txt relative to the source root), and a rate
+// which falls more than 'CATAMARI_PERFORMANCE_TOLERANCE' (by default, 0.25)
+// below its baseline fails the test. If 'CATAMARI_RECORD_PERFORMANCE' is set,
+// the measured rates are instead written into the baseline file, so that a
+// release machine can record its own baselines.
+//
+// The tests are registered as a benchmark in the 'performance' meson suite,
+// which is skipped by the default 'meson test' and run through
+// 'meson test --benchmark --suite performance'.
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "quotient/timer.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// The number of timed repetitions of each phase, of which the fastest is kept.
+const Int kNumRepetitions = 3;
+
+// The number of right-hand sides of the timed solves.
+const Int kNumRightHandSides = 8;
+
+// The measured throughputs (in GFlop/s) of the factorization,
+// refactorization, and solves of a problem.
+struct Throughputs {
+  double factor = 0;
+  double refactor = 0;
+  double solve = 0;
+};
+
+// The stored baselines, keyed by the names of the measurements.
+typedef std::map<std::string, double> Baselines;
+
+std::string BaselinesFilename() {
+  const char* filename = std::getenv("CATAMARI_PERFORMANCE_BASELINES");
+  return filename ? filename : "test/performance_baselines.txt";
+}
+
+double Tolerance() {
+  const char* tolerance = std::getenv("CATAMARI_PERFORMANCE_TOLERANCE");
+  return tolerance ? std::atof(tolerance) : 0.25;
+}
+
+bool Recording() {
+  return std::getenv("CATAMARI_RECORD_PERFORMANCE") != nullptr;
+}
+
+// Reads the lines of 'name GFlop/s' pairs of the baseline file, skipping
+// blank lines and those starting with '#'.
+Baselines ReadBaselines(const std::string& filename) {
+  Baselines baselines;
+  std::ifstream file(filename);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream line_stream(line);
+    std::string name;
+    double gflops;
+    if (!(line_stream >> name) || name[0] == '#') continue;
+    if (line_stream >> gflops) baselines[name] = gflops;
+  }
+  return baselines;
+}
+
+// Overwrites (or appends) the baselines of the given measurements while
+// keeping the remaining ones.
+void RecordBaselines(const std::string& filename, const Baselines& measured) {
+  Baselines baselines = ReadBaselines(filename);
+  for (const auto& entry : measured) {
+    baselines[entry.first] = entry.second;
+  }
+  std::ofstream file(filename);
+  file << "# catamari performance baselines (name GFlop/s)\n";
+  for (const auto& entry : baselines) {
+    file << entry.first << " " << entry.second << "\n";
+  }
+  REQUIRE(bool(file));
+}
+
+// Compares each measurement against its baseline (or records it).
+void CheckAgainstBaselines(const Baselines& measured) {
+  const std::string filename = BaselinesFilename();
+  if (Recording()) {
+    RecordBaselines(filename, measured);
+    return;
+  }
+
+  const Baselines baselines = ReadBaselines(filename);
+  const double tolerance = Tolerance();
+  for (const auto& entry : measured) {
+    std::cout << entry.first << ": " << entry.second << " GFlop/s";
+    auto iter = baselines.find(entry.first);
+    if (iter == baselines.end()) {
+      std::cout << " (no baseline)" << std::endl;
+      continue;
+    }
+    std::cout << " (baseline " << iter->second << ")" << std::endl;
+    INFO(entry.first << " ran at " << entry.second
+                     << " GFlop/s against a baseline of " << iter->second);
+    REQUIRE(entry.second >= (1 - tolerance) * iter->second);
+  }
+}
+
+// Fills 'matrix' with the (shifted) 7-point negative Laplacian over a
+// 'num_x_elements x num_y_elements x num_z_elements' grid (a single z element
+// yields the 5-point stencil in 2D).
+void NegativeLaplacian(Int num_x_elements, Int num_y_elements,
+                       Int num_z_elements, double shift,
+                       catamari::CoordinateMatrix<double>* matrix) {
+  const Int num_rows = num_x_elements * num_y_elements * num_z_elements;
+  const double diagonal = num_z_elements > 1 ? 6 : 4;
+  matrix->Resize(num_rows, num_rows);
+  matrix->ReserveEntryAdditions(7 * num_rows);
+  for (Int z = 0; z < num_z_elements; ++z) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      for (Int x = 0; x < num_x_elements; ++x) {
+        const Int row = x + (y + z * num_y_elements) * num_x_elements;
+        matrix->QueueEntryAddition(row, row, diagonal + shift);
+        if (x > 0) matrix->QueueEntryAddition(row, row - 1, -1);
+        if (x < num_x_elements - 1) {
+          matrix->QueueEntryAddition(row, row + 1, -1);
+        }
+        if (y > 0) {
+          matrix->QueueEntryAddition(row, row - num_x_elements, -1);
+        }
+        if (y < num_y_elements - 1) {
+          matrix->QueueEntryAddition(row, row + num_x_elements, -1);
+        }
+        if (z > 0) {
+          matrix->QueueEntryAddition(
+              row, row - num_x_elements * num_y_elements, -1);
+        }
+        if (z < num_z_elements - 1) {
+          matrix->QueueEntryAddition(
+              row, row + num_x_elements * num_y_elements, -1);
+        }
+      }
+    }
+  }
+  matrix->FlushEntryQueues();
+}
+
+// Times the supernodal factorization, a refactorization with shifted values,
+// and a multi-right-hand-side solve of the given grid Laplacian.
+Throughputs MeasureThroughputs(Int num_x_elements, Int num_y_elements,
+                               Int num_z_elements,
+                               catamari::SymmetricFactorizationType type) {
+  catamari::CoordinateMatrix<double> matrix;
+  NegativeLaplacian(num_x_elements, num_y_elements, num_z_elements, 0,
+                    &matrix);
+  catamari::CoordinateMatrix<double> shifted_matrix;
+  NegativeLaplacian(num_x_elements, num_y_elements, num_z_elements, 1,
+                    &shifted_matrix);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(type);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+
+  Throughputs throughputs;
+  catamari::SparseLDL<double> ldl;
+  double factor_seconds = std::numeric_limits<double>::max();
+  double refactor_seconds = std::numeric_limits<double>::max();
+  double flops = 0;
+  Int num_entries = 0;
+  quotient::Timer timer;
+  for (Int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    timer.Start();
+    const catamari::SparseLDLResult<double> result =
+        ldl.Factor(matrix, control);
+    factor_seconds = std::min(factor_seconds, timer.Stop());
+    REQUIRE(result.num_successful_pivots == num_rows);
+    flops = result.num_factorization_flops;
+    num_entries = result.num_factorization_entries;
+  }
+  for (Int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    timer.Start();
+    const catamari::SparseLDLResult<double> result =
+        ldl.RefactorWithFixedSparsityPattern(shifted_matrix);
+    refactor_seconds = std::min(refactor_seconds, timer.Stop());
+    REQUIRE(result.num_successful_pivots == num_rows);
+  }
+
+  // Each explicit entry of the factor costs a multiply-add in both the
+  // forward and the backward solve of each right-hand side.
+  BlasMatrix<double> right_hand_sides;
+  right_hand_sides.Resize(num_rows, kNumRightHandSides, 1.);
+  double solve_seconds = std::numeric_limits<double>::max();
+  for (Int repetition = 0; repetition < kNumRepetitions; ++repetition) {
+    BlasMatrix<double> solution = right_hand_sides;
+    timer.Start();
+    ldl.Solve(&solution.view);
+    solve_seconds = std::min(solve_seconds, timer.Stop());
+  }
+  const double solve_flops = 4. * num_entries * kNumRightHandSides;
+
+  throughputs.factor = flops / factor_seconds / 1.e9;
+  throughputs.refactor = flops / refactor_seconds / 1.e9;
+  throughputs.solve = solve_flops / solve_seconds / 1.e9;
+  return throughputs;
+}
+
+void RunPerformanceTest(const std::string& name, Int num_x_elements,
+                        Int num_y_elements, Int num_z_elements,
+                        catamari::SymmetricFactorizationType type) {
+  const Throughputs throughputs =
+      MeasureThroughputs(num_x_elements, num_y_elements, num_z_elements, type);
+  Baselines measured;
+  measured[name + ".factor"] = throughputs.factor;
+  measured[name + ".refactor"] = throughputs.refactor;
+  measured[name + ".solve"] = throughputs.solve;
+  CheckAgainstBaselines(measured);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("2D Cholesky throughput", "[performance]") {
+  RunPerformanceTest("laplacian_2d_cholesky", 400, 400, 1,
+                     catamari::kCholeskyFactorization);
+}
+
+TEST_CASE("2D LDL^H throughput", "[performance]") {
+  RunPerformanceTest("laplacian_2d_ldl_adjoint", 400, 400, 1,
+                     catamari::kLDLAdjointFactorization);
+}
+
+TEST_CASE("3D Cholesky throughput", "[performance]") {
+  RunPerformanceTest("laplacian_3d_cholesky", 40, 40, 40,
+                     catamari::kCholeskyFactorization);
+}
+
+TEST_CASE("3D LDL^H throughput", "[performance]") {
+  RunPerformanceTest("laplacian_3d_ldl_adjoint", 40, 40, 40,
+                     catamari::kLDLAdjointFactorization);
+}
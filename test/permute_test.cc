@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tbb/task_arena.h>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+
+namespace {
+
+// Returns a random permutation of the given size which fixes roughly a tenth
+// of the indices.
+Buffer<Int> RandomPermutation(Int size, unsigned int seed) {
+  std::mt19937 generator(seed);
+  Buffer<Int> permutation(size);
+  std::iota(permutation.begin(), permutation.end(), Int(0));
+  std::shuffle(permutation.begin(), permutation.end(), generator);
+  Buffer<Int> inverse_permutation(size);
+  for (Int index = 0; index < size; ++index) {
+    inverse_permutation[permutation[index]] = index;
+  }
+  std::uniform_int_distribution<Int> distribution(0, size - 1);
+  for (Int fixed = 0; fixed < size / 10; ++fixed) {
+    // Swap the images of 'index' and of its preimage so that it is fixed.
+    const Int index = distribution(generator);
+    const Int image = permutation[index];
+    const Int preimage = inverse_permutation[index];
+    permutation[preimage] = image;
+    inverse_permutation[image] = preimage;
+    permutation[index] = index;
+    inverse_permutation[index] = index;
+  }
+  return permutation;
+}
+
+// Checks the in-place and out-of-place (inverse) permutations of a matrix of
+// the given dimensions against their definitions.
+template <typename Field>
+void RunTest(Int height, Int width) {
+  const Buffer<Int> permutation = RandomPermutation(height, height + width);
+  BlasMatrix<Int> permutation_matrix;
+  permutation_matrix.Resize(height, 1);
+  for (Int i = 0; i < height; ++i) {
+    permutation_matrix(i, 0) = permutation[i];
+  }
+
+  BlasMatrix<Field> matrix;
+  matrix.Resize(height, width);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      matrix(i, j) = Field(i + height * j);
+    }
+  }
+
+  BlasMatrix<Field> permuted = matrix;
+  catamari::Permute(permutation, &permuted.view);
+  BlasMatrix<Field> inverse_permuted = matrix;
+  catamari::InversePermute(permutation_matrix.ConstView(),
+                           &inverse_permuted.view);
+  BlasMatrix<Field> scattered;
+  scattered.Resize(height, width);
+  catamari::Permute(permutation_matrix.ConstView(), matrix.view,
+                    &scattered.view);
+  BlasMatrix<Field> gathered;
+  gathered.Resize(height, width);
+  catamari::InversePermute(permutation, matrix.ConstView(), &gathered.view);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      REQUIRE(permuted(permutation[i], j) == matrix(i, j));
+      REQUIRE(inverse_permuted(i, j) == matrix(permutation[i], j));
+      REQUIRE(scattered(i, j) == permuted(i, j));
+      REQUIRE(gathered(i, j) == inverse_permuted(i, j));
+    }
+  }
+
+  // The inverse permutation undoes the permutation.
+  catamari::InversePermute(permutation, &permuted.view);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      REQUIRE(permuted(i, j) == matrix(i, j));
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Serial", "[Serial]") {
+  RunTest<double>(37, 1);
+  RunTest<double>(64, 11);
+  RunTest<mantis::Complex<double>>(50, 9);
+}
+
+TEST_CASE("Parallel", "[Parallel]") {
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    // A single tall column, many right-hand sides, and a partial trailing
+    // block of columns.
+    RunTest<double>(100000, 1);
+    RunTest<double>(4000, 64);
+    RunTest<mantis::Complex<double>>(3000, 29);
+  });
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <functional>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Refactors a shifted 2D negative Laplacian several times with its Schur
+// complement storage kept alive in between, then releases the storage and
+// refactors once more, checking the residual of every factorization. If
+// 'parallel' is true, the factorizations are run within a multithreaded task
+// arena with every subtree scheduled in parallel.
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, bool expand_in_place, bool parallel) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  const Int num_x_elements = 30;
+  const Int num_y_elements = 25;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.persistent_workspace = true;
+  ldl_control.supernodal_control.expand_schur_complements_in_place =
+      expand_in_place;
+  if (parallel) {
+    ldl_control.supernodal_control.min_parallel_threshold = 0;
+    ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+  } else {
+    ldl_control.supernodal_control.min_parallel_threshold =
+        std::numeric_limits<double>::infinity();
+  }
+
+  catamari::SparseLDL<Field> ldl;
+  tbb::task_arena arena(parallel ? 4 : 1);
+  auto run = [&](const std::function<catamari::SparseLDLResult<Field>()>&
+                     factor) {
+    catamari::SparseLDLResult<Field> result;
+    arena.execute([&]() { result = factor(); });
+    return result;
+  };
+
+  catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+  const catamari::SparseLDLResult<Field> first_result =
+      run([&]() { return ldl.Factor(matrix, ldl_control); });
+  REQUIRE(first_result.num_successful_pivots == num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  // The retained storage is counted as held from the start of each
+  // refactorization, so the peak can only grow.
+  for (Int refactorization = 1; refactorization <= 4; ++refactorization) {
+    matrix = ShiftedLaplacian(num_x_elements, num_y_elements,
+                              shift + Field(0.25 * refactorization));
+    const catamari::SparseLDLResult<Field> result =
+        run([&]() { return ldl.RefactorWithFixedSparsityPattern(matrix); });
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+    if (!parallel) {
+      REQUIRE(result.peak_frontal_bytes >= first_result.peak_frontal_bytes);
+    }
+  }
+
+  // Once released, the workspace is allocated afresh, as for the first
+  // factorization.
+  ldl.ReleaseWorkspace();
+  matrix = ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const catamari::SparseLDLResult<Field> released_result =
+      run([&]() { return ldl.RefactorWithFixedSparsityPattern(matrix); });
+  REQUIRE(released_result.num_successful_pivots == num_rows);
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  if (!parallel) {
+    REQUIRE(released_result.peak_frontal_bytes ==
+            first_result.peak_frontal_bytes);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  for (const bool expand_in_place : {false, true}) {
+    for (const bool parallel : {false, true}) {
+      RunTest<double>(catamari::kCholeskyFactorization, 0.1, expand_in_place,
+                      parallel);
+    }
+  }
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  for (const bool parallel : {false, true}) {
+    RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                     mantis::Complex<double>(-1., 0.5),
+                                     /* expand_in_place = */ false, parallel);
+  }
+}
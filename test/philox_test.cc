@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <array>
+#include <cstdint>
+#include <random>
+#include "catamari/philox.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::PhiloxEngine;
+
+namespace {
+
+typedef std::array<std::uint32_t, PhiloxEngine::kBlockSize> Counter;
+typedef std::array<std::uint32_t, 2> Key;
+
+}  // anonymous namespace
+
+TEST_CASE("Known answers", "[Known answers]") {
+  // The known-answer tests of the Random123 reference implementation.
+  REQUIRE(PhiloxEngine::Block(Counter{{0, 0, 0, 0}}, Key{{0, 0}}) ==
+          (Counter{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+  REQUIRE(PhiloxEngine::Block(
+              Counter{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+              Key{{0xffffffff, 0xffffffff}}) ==
+          (Counter{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}));
+  REQUIRE(PhiloxEngine::Block(
+              Counter{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+              Key{{0xa4093822, 0x299f31d0}}) ==
+          (Counter{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}));
+
+  // The engine begins at the zero counter of its stream.
+  PhiloxEngine engine(0x299f31d0a4093822ull, 0x13198a2e, 0x03707344);
+  engine.discard(0);
+  const Counter block =
+      PhiloxEngine::Block(Counter{{0, 0, 0x13198a2e, 0x03707344}},
+                          Key{{0xa4093822, 0x299f31d0}});
+  for (const std::uint32_t value : block) {
+    REQUIRE(engine() == value);
+  }
+}
+
+TEST_CASE("Streams", "[Streams]") {
+  PhiloxEngine engine(17, 3, 5);
+  PhiloxEngine same_engine(17, 3, 5);
+  PhiloxEngine other_engine(17, 3, 6);
+  bool differs = false;
+  for (int index = 0; index < 100; ++index) {
+    const std::uint32_t value = engine();
+    REQUIRE(same_engine() == value);
+    differs = differs || other_engine() != value;
+  }
+  REQUIRE(differs);
+
+  // Reseeding restarts the stream.
+  engine.Seed(17, 3, 5);
+  same_engine.Seed(17, 3, 5);
+  REQUIRE(engine() == same_engine());
+}
+
+TEST_CASE("Discard", "[Discard]") {
+  for (unsigned long long num_values : {0ull, 1ull, 3ull, 4ull, 13ull}) {
+    PhiloxEngine engine(5, 1, 2);
+    PhiloxEngine skipping_engine(5, 1, 2);
+    engine();
+    skipping_engine();
+    for (unsigned long long index = 0; index < num_values; ++index) {
+      engine();
+    }
+    skipping_engine.discard(num_values);
+    REQUIRE(engine() == skipping_engine());
+  }
+}
+
+TEST_CASE("Distributions", "[Distributions]") {
+  PhiloxEngine engine(11);
+  std::uniform_real_distribution<double> uniform_dist(0., 1.);
+  for (int index = 0; index < 1000; ++index) {
+    const double value = uniform_dist(engine);
+    REQUIRE(value >= 0.);
+    REQUIRE(value < 1.);
+  }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <limits>
+#include "catamari/apply_sparse.hpp"
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_basic_linear_algebra.hpp"
+#include "catamari/norms.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns the weighted graph Laplacian of 'num_bodies' disjoint 2D grids,
+// each of 'num_x_elements' x 'num_y_elements' nodes and with edge weight
+// 'weight'. Since none of the bodies is anchored, the matrix is singular,
+// with one rigid-body mode per body.
+template <typename Field>
+catamari::CoordinateMatrix<Field> FloatingBodiesLaplacian(Int num_bodies,
+                                                          Int num_x_elements,
+                                                          Int num_y_elements,
+                                                          const Field& weight) {
+  const Int body_size = num_x_elements * num_y_elements;
+  const Int num_rows = num_bodies * body_size;
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int body = 0; body < num_bodies; ++body) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      for (Int y = 0; y < num_y_elements; ++y) {
+        const Int index = body * body_size + x + y * num_x_elements;
+        Int num_neighbors = 0;
+        auto couple = [&](Int neighbor) {
+          matrix.QueueEntryAddition(index, neighbor, -weight);
+          ++num_neighbors;
+        };
+        if (x > 0) couple(index - 1);
+        if (x < num_x_elements - 1) couple(index + 1);
+        if (y > 0) couple(index - num_x_elements);
+        if (y < num_y_elements - 1) couple(index + num_x_elements);
+        const catamari::ComplexBase<Field> degree = num_neighbors;
+        matrix.QueueEntryAddition(index, index, degree * weight);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& weight) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_bodies = 3;
+  const catamari::CoordinateMatrix<Field> matrix =
+      FloatingBodiesLaplacian(num_bodies, 12, 10, weight);
+  const Int num_rows = matrix.NumRows();
+  const Real tolerance = 1e4 * std::numeric_limits<Real>::epsilon();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.rank_detection = true;
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_singular_pivots == num_bodies);
+
+  // The basis is orthonormal and annihilated by the matrix.
+  BlasMatrix<Field> basis;
+  ldl.NullSpaceBasis(&basis);
+  REQUIRE(basis.view.height == num_rows);
+  REQUIRE(basis.view.width == num_bodies);
+  BlasMatrix<Field> gram;
+  gram.Resize(num_bodies, num_bodies);
+  catamari::MatrixMultiplyAdjointNormal(Field{1}, basis.ConstView(),
+                                        basis.ConstView(), Field{0},
+                                        &gram.view);
+  for (Int j = 0; j < num_bodies; ++j) {
+    for (Int i = 0; i < num_bodies; ++i) {
+      const Field expected = i == j ? Field{1} : Field{0};
+      REQUIRE(std::abs(gram(i, j) - expected) <= tolerance);
+    }
+  }
+  BlasMatrix<Field> image;
+  image.Resize(num_rows, num_bodies, Field{0});
+  catamari::ApplySparse(Field{1}, matrix, basis.ConstView(), Field{0},
+                        &image.view);
+  REQUIRE(catamari::EuclideanNorm(image.ConstView()) <=
+          tolerance * catamari::MaxNorm(matrix));
+
+  // The pseudo-inverse solve of a consistent system yields a solution
+  // without null-space components.
+  BlasMatrix<Field> target;
+  target.Resize(num_rows, 1);
+  for (Int i = 0; i < num_rows; ++i) {
+    target(i, 0) = Field(std::sin(Real(i)));
+  }
+  BlasMatrix<Field> right_hand_side;
+  right_hand_side.Resize(num_rows, 1, Field{0});
+  catamari::ApplySparse(Field{1}, matrix, target.ConstView(), Field{0},
+                        &right_hand_side.view);
+  BlasMatrix<Field> solution = right_hand_side;
+  ldl.PseudoinverseSolve(&solution.view);
+  BlasMatrix<Field> residual = right_hand_side;
+  catamari::ApplySparse(Field{-1}, matrix, solution.ConstView(), Field{1},
+                        &residual.view);
+  REQUIRE(catamari::EuclideanNorm(residual.ConstView()) <=
+          1e2 * tolerance *
+              catamari::EuclideanNorm(right_hand_side.ConstView()));
+  BlasMatrix<Field> components;
+  components.Resize(num_bodies, 1);
+  catamari::MatrixMultiplyAdjointNormal(Field{1}, basis.ConstView(),
+                                        solution.ConstView(), Field{0},
+                                        &components.view);
+  REQUIRE(catamari::EuclideanNorm(components.ConstView()) <=
+          1e2 * tolerance * catamari::EuclideanNorm(solution.ConstView()));
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, 1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(1., 0.5));
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Returns a shifted 2D negative Laplacian whose couplings in the x direction
+// are scaled by 'coupling' below the diagonal and by its conjugate (if
+// 'conjugate' is true) or itself above it.
+template <typename Field>
+catamari::CoordinateMatrix<Field> CoupledLaplacian(Int num_x_elements,
+                                                   Int num_y_elements,
+                                                   const Field& shift,
+                                                   const Field& coupling,
+                                                   bool conjugate) {
+  const Field upper_coupling =
+      conjugate ? catamari::Conjugate(coupling) : coupling;
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_y_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, Field{4} + shift);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -coupling);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -upper_coupling);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, Field{-1});
+      }
+      if (y < num_y_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, Field{-1});
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the max norm of the difference of two single-column solutions.
+template <typename Field>
+catamari::ComplexBase<Field> SolutionDifference(
+    const BlasMatrix<Field>& solution, const BlasMatrix<Field>& expected) {
+  typedef catamari::ComplexBase<Field> Real;
+  Real difference = 0;
+  for (Int i = 0; i < solution.Height(); ++i) {
+    difference =
+        std::max(difference, std::abs(solution(i, 0) - expected(i, 0)));
+  }
+  return difference;
+}
+
+// Factors a shifted 2D negative Laplacian and checks that the iterative
+// refinements against it (with and without promotion and diagonal scaling)
+// converge to the direct solution.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             catamari::SupernodalStrategy supernodal_strategy,
+             const Field& shift, const Field& coupling) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  const bool conjugate =
+      factorization_type != catamari::kLDLTransposeFactorization;
+
+  const catamari::CoordinateMatrix<Field> matrix = CoupledLaplacian(
+      num_x_elements, num_y_elements, shift, coupling, conjugate);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = supernodal_strategy;
+  catamari::SparseLDL<Field> ldl;
+  REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots == num_rows);
+
+  BlasMatrix<Field> expected;
+  expected.Resize(num_rows, 1, Field{1});
+  ldl.Solve(&expected.view);
+
+  BlasMatrix<Real> scaling;
+  scaling.Resize(num_rows, 1);
+  for (Int i = 0; i < num_rows; ++i) scaling(i, 0) = Real(1 + i % 3);
+
+  catamari::RefinedSolveControl<Real> refined_solve_control;
+  refined_solve_control.relative_tol = tolerance;
+  for (const bool promote : {false, true}) {
+    refined_solve_control.promote = promote;
+
+    BlasMatrix<Field> solution;
+    solution.Resize(num_rows, 1, Field{1});
+    const catamari::RefinedSolveStatus<Real> status =
+        ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+    REQUIRE(status.residual_relative_max_norm <= tolerance);
+    REQUIRE(SolutionDifference(solution, expected) <= tolerance);
+
+    solution.Resize(num_rows, 1, Field{1});
+    const catamari::RefinedSolveStatus<Real> scaled_status =
+        ldl.DiagonallyScaledRefinedSolve(matrix, scaling.ConstView(),
+                                         refined_solve_control,
+                                         &solution.view);
+    REQUIRE(scaled_status.residual_relative_max_norm <= tolerance);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization,
+                  catamari::kSupernodalFactorization, 0.1, 1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kCholeskyFactorization,
+      catamari::kScalarFactorization, 0.1, mantis::Complex<double>(0.6, 0.8));
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization,
+      catamari::kSupernodalFactorization, mantis::Complex<double>(-1., 0.5),
+      mantis::Complex<double>(0.6, 0.8));
+}
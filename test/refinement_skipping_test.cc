@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "catamari/norms.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Fills the right-hand sides with a deterministic pattern.
+void RightHandSides(Int num_rows, Int num_rhs,
+                    BlasMatrix<double>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = double((i * 3 + j) % 11) - 5.;
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky skip", "[Cholesky skip]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 25, 0.1);
+  const Int num_rows = matrix.NumRows();
+  const double epsilon = std::numeric_limits<double>::epsilon();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kCholeskyFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<double> ldl;
+  const catamari::SparseLDLResult<double> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  // The Schur complements of a diagonally dominant matrix do not grow.
+  REQUIRE(result.largest_abs_pivot > 0.);
+  REQUIRE(result.pivot_growth > 0.);
+  REQUIRE(result.pivot_growth <= 1.);
+  REQUIRE(ldl.BackwardErrorEstimate() == epsilon);
+
+  catamari::RefinedSolveControl<double> refined_solve_control;
+  refined_solve_control.skip_if_estimated_accurate = true;
+  BlasMatrix<double> expected, solution;
+  RightHandSides(num_rows, 3, &expected);
+  ldl.Solve(&expected.view);
+  RightHandSides(num_rows, 3, &solution);
+  const catamari::RefinedSolveStatus<double> status =
+      ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+  REQUIRE(status.num_iterations == 0);
+  REQUIRE(status.backward_error_estimate == ldl.BackwardErrorEstimate());
+  REQUIRE(status.residual_relative_max_norm == ldl.BackwardErrorEstimate());
+  for (Int j = 0; j < solution.Width(); ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      REQUIRE(solution(i, j) == expected(i, j));
+    }
+  }
+
+  // The solution is backward stable.
+  BlasMatrix<double> residual;
+  RightHandSides(num_rows, 3, &residual);
+  catamari::ApplySparse(-1., matrix, solution.ConstView(), 1., &residual.view);
+  REQUIRE(catamari::MaxNorm(residual.ConstView()) <=
+          1e2 * epsilon * catamari::MaxNorm(matrix) *
+              catamari::MaxNorm(solution.ConstView()));
+
+  // A tolerance below the estimate still refines (and reports the estimate).
+  refined_solve_control.relative_tol = epsilon / 2;
+  RightHandSides(num_rows, 3, &solution);
+  const catamari::RefinedSolveStatus<double> refined_status =
+      ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+  REQUIRE(refined_status.backward_error_estimate ==
+          ldl.BackwardErrorEstimate());
+  REQUIRE(refined_status.residual_relative_max_norm !=
+          ldl.BackwardErrorEstimate());
+}
+
+TEST_CASE("Indefinite estimate", "[Indefinite estimate]") {
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(30, 25, -3.);
+  const Int num_rows = matrix.NumRows();
+  const double epsilon = std::numeric_limits<double>::epsilon();
+
+  catamari::SparseLDLControl<double> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<double> ldl;
+  const catamari::SparseLDLResult<double> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(ldl.BackwardErrorEstimate() ==
+          epsilon * std::max(1., result.pivot_growth));
+
+  // With refinement enabled, the estimate is reported either way.
+  catamari::RefinedSolveControl<double> refined_solve_control;
+  BlasMatrix<double> solution;
+  RightHandSides(num_rows, 2, &solution);
+  const catamari::RefinedSolveStatus<double> status =
+      ldl.RefinedSolve(matrix, refined_solve_control, &solution.view);
+  REQUIRE(status.backward_error_estimate == ldl.BackwardErrorEstimate());
+
+  // Scalar factorizations do not track their pivots.
+  ldl_control.supernodal_strategy = catamari::kScalarFactorization;
+  ldl.Factor(matrix, ldl_control);
+  REQUIRE(std::isinf(ldl.BackwardErrorEstimate()));
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian with supernodes relaxed either by
+// the fixed explicit-zero ratios or by the cost model, and returns the result.
+template <typename Field>
+catamari::SparseLDLResult<Field> RunTest(
+    Int num_x_elements, Int num_y_elements,
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, const catamari::SupernodalRelaxationControl& relax) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.relaxation_control = relax;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(result.num_relaxed_supernodes > 0);
+  REQUIRE(result.num_relaxed_supernodes <= result.num_fundamental_supernodes);
+  REQUIRE(result.num_relaxation_zeros >= 0);
+  REQUIRE(result.relaxation_estimated_seconds > 0);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+
+  return result;
+}
+
+template <typename Field>
+void RunComparison(catamari::SymmetricFactorizationType factorization_type,
+                   const Field& shift) {
+  catamari::SupernodalRelaxationControl relax;
+  relax.relax_supernodes = false;
+  const catamari::SparseLDLResult<Field> fundamental =
+      RunTest(60, 50, factorization_type, shift, relax);
+  REQUIRE(fundamental.num_relaxed_supernodes ==
+          fundamental.num_fundamental_supernodes);
+  REQUIRE(fundamental.num_relaxation_zeros == 0);
+
+  relax.relax_supernodes = true;
+  RunTest(60, 50, factorization_type, shift, relax);
+
+  // If memory traffic dominates, a merger only pays for itself when it
+  // introduces fewer explicit zeros than the assembly it avoids.
+  relax.use_cost_model = true;
+  relax.cost_model.seconds_per_entry = 1;
+  const catamari::SparseLDLResult<Field> memory_bound =
+      RunTest(60, 50, factorization_type, shift, relax);
+
+  // If the dense kernels are far faster on larger fronts, many more mergers
+  // introducing explicit zeros become profitable.
+  relax.cost_model.seconds_per_entry = 0;
+  relax.cost_model.gflops_curve = {std::make_pair(Int(4), 1e-3),
+                                   std::make_pair(Int(256), 1e3)};
+  const catamari::SparseLDLResult<Field> compute_bound =
+      RunTest(60, 50, factorization_type, shift, relax);
+  REQUIRE(compute_bound.num_relaxed_supernodes <
+          memory_bound.num_relaxed_supernodes);
+  REQUIRE(compute_bound.num_relaxation_zeros >
+          memory_bound.num_relaxation_zeros);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunComparison<double>(catamari::kCholeskyFactorization, 0.1);
+  RunComparison<mantis::Complex<double>>(catamari::kCholeskyFactorization,
+                                         0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunComparison<double>(catamari::kLDLAdjointFactorization, -1.);
+}
+
+TEST_CASE("Calibration", "[Calibration]") {
+  const catamari::SupernodalRelaxationCostModel cost_model =
+      catamari::supernodal_ldl::CalibrateSupernodalRelaxationCostModel<double>(
+          {8, 32, 128}, 2);
+  REQUIRE(cost_model.gflops_curve.size() == 3);
+  for (const std::pair<Int, double>& point : cost_model.gflops_curve) {
+    REQUIRE(point.second > 0);
+  }
+  REQUIRE(cost_model.seconds_per_entry > 0);
+}
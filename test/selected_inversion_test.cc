@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Checks the diagonal of the inverse of a shifted 2D negative Laplacian
+// against the result of solving against each column of the identity.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  Buffer<Field> inverse_diagonal;
+  ldl.InverseDiagonal(&inverse_diagonal);
+  REQUIRE(Int(inverse_diagonal.Size()) == num_rows);
+
+  BlasMatrix<Field> identity;
+  identity.Resize(num_rows, num_rows, Field{0});
+  for (Int i = 0; i < num_rows; ++i) identity(i, i) = Field{1};
+  ldl.Solve(&identity.view);
+
+  // Entries of the inverse of an indefinite matrix can be arbitrarily close to
+  // zero, so the error is measured relative to the largest diagonal entry. The
+  // tolerance is loose since both quantities carry forward errors that scale
+  // with the (moderate) condition number of the shifted operator.
+  Real max_abs_diagonal = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    max_abs_diagonal = std::max(max_abs_diagonal, std::abs(identity(i, i)));
+  }
+  const Real tolerance = 1e5 * std::numeric_limits<Real>::epsilon();
+  for (Int i = 0; i < num_rows; ++i) {
+    const Real error = std::abs(inverse_diagonal[i] - identity(i, i));
+    REQUIRE(error <= tolerance * max_abs_diagonal);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization, 0.1);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kCholeskyFactorization,
+                                   0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  // A shift of -1 makes the matrix indefinite.
+  RunTest<double>(20, 15, catamari::kLDLAdjointFactorization, -1.);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kLDLAdjointFactorization,
+                                   -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<double>(20, 15, catamari::kLDLTransposeFactorization, -1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization,
+      mantis::Complex<double>(-1., 0.5));
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "catamari.hpp"
+#include "catamari/shift_invert_lanczos.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+
+namespace {
+
+// Returns the stiffness (if 'mass' is false) or the mass matrix of piecewise
+// linear finite elements for -u'' = lambda u over a uniform mesh of (0, 1)
+// with homogeneous Dirichlet boundary conditions.
+template <typename Field>
+catamari::CoordinateMatrix<Field> FiniteElementMatrix(Int num_rows,
+                                                      bool mass) {
+  const double h = 1. / (num_rows + 1);
+  const double diagonal = mass ? 4. * h / 6. : 2. / h;
+  const double off_diagonal = mass ? h / 6. : -1. / h;
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(3 * num_rows);
+  for (Int i = 0; i < num_rows; ++i) {
+    matrix.QueueEntryAddition(i, i, Field{diagonal});
+    if (i > 0) matrix.QueueEntryAddition(i, i - 1, Field{off_diagonal});
+    if (i < num_rows - 1) {
+      matrix.QueueEntryAddition(i, i + 1, Field{off_diagonal});
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the eigenvalues of the finite element pencil nearest to 'shift',
+// in order of increasing distance.
+std::vector<double> NearestEigenvalues(Int num_rows, double shift,
+                                       Int num_eigenvalues) {
+  const double pi = std::acos(-1.);
+  const double h = 1. / (num_rows + 1);
+  std::vector<double> eigenvalues(num_rows);
+  for (Int k = 1; k <= num_rows; ++k) {
+    const double c = std::cos(k * pi * h);
+    eigenvalues[k - 1] = 6. / (h * h) * (1. - c) / (2. + c);
+  }
+  std::sort(eigenvalues.begin(), eigenvalues.end(), [&](double a, double b) {
+    return std::abs(a - shift) < std::abs(b - shift);
+  });
+  eigenvalues.resize(num_eigenvalues);
+  return eigenvalues;
+}
+
+// Computes the eigenpairs nearest to a few shifts, reusing the workspace, and
+// checks them against their analytical values.
+template <typename Field>
+void RunTest(Int num_rows, Int block_size, Int num_eigenpairs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> stiffness =
+      FiniteElementMatrix<Field>(num_rows, false);
+  const catamari::CoordinateMatrix<Field> mass =
+      FiniteElementMatrix<Field>(num_rows, true);
+  const Int num_entries = stiffness.NumEntries();
+  Buffer<Field> stiffness_values(num_entries);
+  Buffer<Field> mass_values(num_entries);
+  for (Int index = 0; index < num_entries; ++index) {
+    stiffness_values[index] = stiffness.Entries()[index].value;
+    mass_values[index] = mass.Entries()[index].value;
+  }
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(stiffness, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(stiffness, &cplan);
+
+  auto apply_mass = [&](const Field& alpha,
+                        const catamari::ConstBlasMatrixView<Field>& input,
+                        const Field& beta,
+                        catamari::BlasMatrixView<Field>* output) {
+    catamari::ApplySparse(alpha, mass, input, beta, output);
+  };
+
+  BlasMatrix<Field> initial_block;
+  initial_block.Resize(num_rows, block_size);
+  for (Int j = 0; j < block_size; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      initial_block(i, j) = Field{std::sin(1. + i + 7. * j)};
+    }
+  }
+
+  catamari::ShiftInvertLanczosControl<Real> control;
+  control.num_eigenpairs = num_eigenpairs;
+  control.max_iterations = 40;
+  catamari::ShiftInvertLanczosWorkspace<Field> workspace;
+  Buffer<Real> eigenvalues;
+  BlasMatrix<Field> eigenvectors;
+  BlasMatrix<Field> residuals;
+  BlasMatrix<Field> gram;
+  // The second run keeps the factorization of the first.
+  const std::vector<double> shifts{50., 50., 400.};
+  for (Int run = 0; run < Int(shifts.size()); ++run) {
+    const double shift = shifts[run];
+    const catamari::ShiftInvertLanczosStatus<Real> status =
+        catamari::ShiftInvertLanczos(cplan, stiffness_values.Data(),
+                                     mass_values.Data(), apply_mass,
+                                     Real(shift), control,
+                                     initial_block.ConstView(), &ldl,
+                                     &eigenvalues, &eigenvectors, &workspace);
+    REQUIRE(status.refactored == (run != 1));
+    REQUIRE(status.num_converged == num_eigenpairs);
+    REQUIRE(Int(eigenvalues.Size()) == num_eigenpairs);
+
+    const std::vector<double> expected =
+        NearestEigenvalues(num_rows, shift, num_eigenpairs);
+    for (Int k = 0; k < num_eigenpairs; ++k) {
+      REQUIRE(std::abs(eigenvalues[k] - expected[k]) <=
+              1e-8 * std::abs(expected[k]));
+    }
+
+    // The eigenvectors are B-orthonormal and satisfy A x = lambda B x.
+    residuals.Resize(num_rows, num_eigenpairs);
+    catamari::ApplySparse(Field{1}, mass, eigenvectors.ConstView(), Field{0},
+                          &residuals.view);
+    gram.Resize(num_eigenpairs, num_eigenpairs);
+    catamari::MatrixMultiplyAdjointNormal(Field{1}, eigenvectors.ConstView(),
+                                          residuals.ConstView(), Field{0},
+                                          &gram.view);
+    for (Int j = 0; j < num_eigenpairs; ++j) {
+      for (Int i = 0; i < num_eigenpairs; ++i) {
+        REQUIRE(std::abs(gram(i, j) - Field{i == j ? 1. : 0.}) <= 1e-10);
+      }
+      for (Int i = 0; i < num_rows; ++i) {
+        residuals(i, j) *= -eigenvalues[j];
+      }
+    }
+    catamari::ApplySparse(Field{1}, stiffness, eigenvectors.ConstView(),
+                          Field{1}, &residuals.view);
+    for (Int j = 0; j < num_eigenpairs; ++j) {
+      Real residual_norm = 0;
+      for (Int i = 0; i < num_rows; ++i) {
+        residual_norm = std::max(residual_norm, std::abs(residuals(i, j)));
+      }
+      REQUIRE(residual_norm <= 1e-5 * std::abs(eigenvalues[j]));
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Real", "[Real]") {
+  RunTest<double>(200, 1, 1);
+  RunTest<double>(200, 2, 3);
+}
+
+TEST_CASE("Complex", "[Complex]") {
+  RunTest<mantis::Complex<double>>(200, 2, 3);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_factorizations.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Complex;
+using catamari::Int;
+
+namespace {
+
+template <typename Real>
+Real Entry(Int i, Int j, Real*) {
+  return Real(1) / Real(1 + i + 2 * j);
+}
+
+template <typename Real>
+Complex<Real> Entry(Int i, Int j, Complex<Real>*) {
+  return Complex<Real>(Real(1) / Real(1 + i + 2 * j), Real(j - i) / 16);
+}
+
+// Fills a matrix with deterministic entries, boosting the diagonal so that
+// the leading square block is well-conditioned and Hermitian-dominant.
+template <typename Field>
+void Initialize(Int height, Int width, BlasMatrix<Field>* matrix) {
+  matrix->Resize(height, width);
+  for (Int j = 0; j < width; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      matrix->Entry(i, j) = Entry(i, j, static_cast<Field*>(nullptr));
+    }
+    if (j < height) {
+      matrix->Entry(j, j) = Field(catamari::ComplexBase<Field>(4 * width));
+    }
+  }
+}
+
+// Returns the maximum absolute difference of the lower triangles (or the
+// entire matrices) of 'matrix' and 'expected', relative to the largest entry
+// of 'expected'.
+template <typename Field>
+catamari::ComplexBase<Field> MaxDifference(const BlasMatrix<Field>& matrix,
+                                           const BlasMatrix<Field>& expected,
+                                           bool lower_only) {
+  catamari::ComplexBase<Field> difference = 0;
+  catamari::ComplexBase<Field> scale = 1;
+  for (Int j = 0; j < matrix.view.width; ++j) {
+    for (Int i = lower_only ? j : 0; i < matrix.view.height; ++i) {
+      difference =
+          std::max(difference, std::abs(matrix(i, j) - expected(i, j)));
+      scale = std::max(scale, std::abs(expected(i, j)));
+    }
+  }
+  return difference / scale;
+}
+
+template <typename Field>
+void RunSmallKernels(Int height, Int size) {
+  typedef catamari::ComplexBase<Field> Real;
+  const Real tolerance = 100 * std::numeric_limits<Real>::epsilon();
+
+  BlasMatrix<Field> left, right, output, expected;
+  Initialize(height, size, &left);
+  Initialize(size, 3, &right);
+
+  // Matrix multiplication, with a zero, a unit, and a general beta.
+  const Field general_beta = Entry(1, 2, static_cast<Field*>(nullptr));
+  for (const Field beta : {Field{0}, Field{1}, general_beta}) {
+    Initialize(height, 3, &output);
+    expected = output;
+    catamari::SmallMatrixMultiplyNormalNormal(
+        Field{-1}, left.ConstView(), right.ConstView(), beta, &output.view);
+    catamari::MatrixMultiplyNormalNormal(Field{-1}, left.ConstView(),
+                                         right.ConstView(), beta,
+                                         &expected.view);
+    REQUIRE(MaxDifference(output, expected, false) <= tolerance * size);
+  }
+
+  // The lower triangle of a Hermitian outer product.
+  Initialize(height, height, &output);
+  expected = output;
+  catamari::SmallLowerNormalHermitianOuterProduct(
+      Real{-1}, left.ConstView(), Real{1}, &output.view);
+  catamari::LowerNormalHermitianOuterProduct(Real{-1}, left.ConstView(),
+                                             Real{1}, &expected.view);
+  REQUIRE(MaxDifference(output, expected, true) <= tolerance * size);
+
+  // Triangular solves against the leading square block.
+  BlasMatrix<Field> triangle;
+  Initialize(size, size, &triangle);
+  Initialize(size, 3, &output);
+  expected = output;
+  catamari::SmallLeftLowerTriangularSolves(triangle.ConstView(), &output.view);
+  catamari::LeftLowerTriangularSolves(triangle.ConstView(), &expected.view);
+  REQUIRE(MaxDifference(output, expected, false) <= tolerance);
+  catamari::SmallLeftLowerAdjointTriangularSolves(triangle.ConstView(),
+                                                  &output.view);
+  catamari::LeftLowerAdjointTriangularSolves(triangle.ConstView(),
+                                             &expected.view);
+  REQUIRE(MaxDifference(output, expected, false) <= tolerance);
+
+  // An LDL^H factorization of a Hermitian matrix.
+  output = triangle;
+  for (Int j = 0; j < size; ++j) {
+    for (Int i = j + 1; i < size; ++i) {
+      output(j, i) = catamari::Conjugate(output(i, j));
+    }
+  }
+  expected = output;
+  REQUIRE(catamari::SmallLDLAdjointFactorization(&output.view) == size);
+  REQUIRE(catamari::LDLAdjointFactorization(size, &expected.view) == size);
+  REQUIRE(MaxDifference(output, expected, true) <= tolerance * size);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Double", "Double") {
+  for (Int size = 1; size <= catamari::kMaxSmallKernelSize; ++size) {
+    RunSmallKernels<double>(size, size);
+    RunSmallKernels<double>(3 * size + 7, size);
+  }
+}
+
+TEST_CASE("ComplexDouble", "ComplexDouble") {
+  for (Int size = 1; size <= catamari::kMaxSmallKernelSize; ++size) {
+    RunSmallKernels<Complex<double>>(size, size);
+    RunSmallKernels<Complex<double>>(3 * size + 7, size);
+  }
+}
+
+TEST_CASE("ComplexFloat", "ComplexFloat") {
+  for (Int size = 1; size <= catamari::kMaxSmallKernelSize; ++size) {
+    RunSmallKernels<Complex<float>>(size, size);
+    RunSmallKernels<Complex<float>>(3 * size + 7, size);
+  }
+}
+
+TEST_CASE("Thresholds", "Thresholds") {
+  const catamari::SmallKernelThresholds thresholds =
+      catamari::CalibrateSmallKernelThresholds<double>(8, 2);
+  REQUIRE(thresholds.triangular_solve_size <= catamari::kMaxSmallKernelSize);
+  REQUIRE(thresholds.factorization_size <= catamari::kMaxSmallKernelSize);
+}
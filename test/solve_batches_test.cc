@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::BlasMatrixView;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::PerturbedLaplacian;
+
+namespace {
+
+// Fills the right-hand sides with a deterministic pattern unique to 'seed'.
+void FillRightHandSides(Int num_rows, Int num_rhs, Int seed,
+                        BlasMatrix<double>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = std::sin(1. + i + 3. * j + 7. * seed);
+    }
+  }
+}
+
+// Checks that solving several batches at once matches solving each alone.
+void RunTest(const catamari::SparseLDLControl<double>& control) {
+  const catamari::CoordinateMatrix<double> matrix = PerturbedLaplacian(30, 4.5);
+  const Int num_rows = matrix.NumRows();
+  catamari::SparseLDL<double> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+
+  const Int batch_widths[] = {1, 3, 2};
+  const Int num_batches = 3;
+  Buffer<BlasMatrix<double>> expected(num_batches);
+  Buffer<BlasMatrix<double>> solutions(num_batches);
+  Buffer<BlasMatrixView<double>*> batches(num_batches);
+  for (Int index = 0; index < num_batches; ++index) {
+    FillRightHandSides(num_rows, batch_widths[index], index, &expected[index]);
+    ldl.Solve(&expected[index].view);
+    FillRightHandSides(num_rows, batch_widths[index], index,
+                       &solutions[index]);
+    batches[index] = &solutions[index].view;
+  }
+  ldl.SolveBatches(batches);
+
+  for (Int index = 0; index < num_batches; ++index) {
+    for (Int j = 0; j < batch_widths[index]; ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        REQUIRE(std::abs(solutions[index](i, j) - expected[index](i, j)) <=
+                1e-12 * (1 + std::abs(expected[index](i, j))));
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Supernodal", "[Supernodal]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLAdjointFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  RunTest(control);
+}
+
+TEST_CASE("Equilibrated", "[Equilibrated]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.equilibrate = true;
+  RunTest(control);
+}
+
+TEST_CASE("Scalar", "[Scalar]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kScalarFactorization;
+  RunTest(control);
+}
+
+TEST_CASE("Mismatched height", "[Mismatched height]") {
+  catamari::SparseLDL<double> ldl;
+  ldl.Factor(PerturbedLaplacian(10, 5.), catamari::SparseLDLControl<double>());
+  BlasMatrix<double> batch;
+  batch.Resize(5, 1, 1.);
+  Buffer<BlasMatrixView<double>*> batches(1, &batch.view);
+  REQUIRE_THROWS(ldl.SolveBatches(batches));
+}
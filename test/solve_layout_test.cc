@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::BlasMatrixView;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeDifference;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Fills the first 'num_rows' rows of a (taller) matrix with deterministic
+// right-hand sides and returns a view of them.
+template <typename Field>
+BlasMatrixView<Field> RightHandSides(Int num_rows, Int num_rhs,
+                                     BlasMatrix<Field>* storage) {
+  storage->Resize(num_rows + 3, num_rhs, Field{0});
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      storage->Entry(i, j) = Field(double((i * 7 + j * 3) % 11) - 5.);
+    }
+  }
+  return storage->view.Submatrix(0, 0, num_rows, num_rhs);
+}
+
+// Factors a matrix with the in-place and the row-panel solve layouts, then
+// refactors both with a different shift, and returns the maximum relative
+// difference between their single-threaded and four-threaded solutions.
+template <typename Field>
+catamari::ComplexBase<Field> RunTest(
+    catamari::SymmetricFactorizationType factorization_type,
+    const Field& shift, const Field& refactor_shift, Int num_rhs) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(12, 11, 10, shift);
+  const catamari::CoordinateMatrix<Field> refactor_matrix =
+      ShiftedLaplacian(12, 11, 10, refactor_shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.min_parallel_solve_threshold = 0;
+  // Exercise both the small-supernode loops and the BLAS calls.
+  ldl_control.supernodal_control.forward_solve_out_of_place_supernode_threshold = 4;
+  ldl_control.supernodal_control.backward_solve_out_of_place_supernode_threshold = 4;
+
+  catamari::SparseLDLControl<Field> panel_control = ldl_control;
+  panel_control.supernodal_control.solve_layout =
+      catamari::supernodal_ldl::kRowPanelSolveLayout;
+  // Pad the panels, and advise huge pages for the larger buffers.
+  panel_control.supernodal_control.allocation.pad_leading_dimensions = true;
+  panel_control.supernodal_control.allocation.huge_page_threshold = 1 << 16;
+
+  tbb::task_arena arena(4);
+  tbb::task_arena serial_arena(1);
+  catamari::SparseLDL<Field> ldl, panel_ldl;
+  arena.execute([&]() {
+    REQUIRE(ldl.Factor(matrix, ldl_control).num_successful_pivots == num_rows);
+    REQUIRE(panel_ldl.Factor(matrix, panel_control).num_successful_pivots ==
+            num_rows);
+  });
+
+  Real max_difference = 0;
+  for (Int factorization = 0; factorization < 2; ++factorization) {
+    if (factorization == 1) {
+      // The panels must follow a refactorization.
+      arena.execute([&]() {
+        REQUIRE(ldl.RefactorWithFixedSparsityPattern(refactor_matrix)
+                    .num_successful_pivots == num_rows);
+        REQUIRE(panel_ldl.RefactorWithFixedSparsityPattern(refactor_matrix)
+                    .num_successful_pivots == num_rows);
+      });
+    }
+
+    BlasMatrix<Field> reference_storage;
+    BlasMatrixView<Field> reference =
+        RightHandSides(num_rows, num_rhs, &reference_storage);
+    serial_arena.execute([&]() { ldl.Solve(&reference); });
+
+    for (tbb::task_arena* solve_arena : {&serial_arena, &arena}) {
+      BlasMatrix<Field> storage;
+      BlasMatrixView<Field> solution =
+          RightHandSides(num_rows, num_rhs, &storage);
+      solve_arena->execute([&]() { panel_ldl.Solve(&solution); });
+      max_difference =
+          std::max(max_difference, RelativeDifference(solution, reference));
+    }
+  }
+  return max_difference;
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<double>(catamari::kCholeskyFactorization, 0.1, 0.3, 1) <=
+          tolerance);
+  REQUIRE(RunTest<double>(catamari::kCholeskyFactorization, 0.1, 0.3, 5) <=
+          tolerance);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<mantis::Complex<double>>(
+              catamari::kLDLAdjointFactorization,
+              mantis::Complex<double>(-1., 0.), mantis::Complex<double>(-2., 0.),
+              3) <= tolerance);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  const double tolerance = 1e3 * std::numeric_limits<double>::epsilon();
+  REQUIRE(RunTest<mantis::Complex<double>>(
+              catamari::kLDLTransposeFactorization,
+              mantis::Complex<double>(-1., 0.5),
+              mantis::Complex<double>(-2., 0.25), 4) <= tolerance);
+}
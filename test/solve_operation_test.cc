@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari::supernodal_ldl::SolveOperation;
+typedef catamari::Complex<double> Field;
+
+namespace {
+
+// Returns a 2D negative Laplacian whose horizontal couplings are complex,
+// where the matrix is either Hermitian or complex-symmetric.
+catamari::CoordinateMatrix<Field> ComplexLaplacian(Int num_x_elements,
+                                                   bool hermitian) {
+  const Field diagonal = hermitian ? Field{4.5, 0.} : Field{4.5, 1.};
+  const Field coupling{-1., 0.3};
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_x_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int y = 0; y < num_x_elements; ++y) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, diagonal);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, coupling);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(
+            index, index + 1,
+            hermitian ? catamari::Conjugate(coupling) : coupling);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, Field{-1});
+      }
+      if (y < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, Field{-1});
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the maximum entry of b - op(A) x, where b is the vector of all
+// ones.
+double MaxResidual(const catamari::CoordinateMatrix<Field>& matrix,
+                   SolveOperation operation,
+                   const BlasMatrix<Field>& solution) {
+  Buffer<Field> residual(matrix.NumRows(), Field{1});
+  const bool transpose =
+      operation == catamari::supernodal_ldl::kSolveTranspose ||
+      operation == catamari::supernodal_ldl::kSolveAdjoint;
+  const bool conjugate =
+      operation == catamari::supernodal_ldl::kSolveConjugate ||
+      operation == catamari::supernodal_ldl::kSolveAdjoint;
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    const Field value =
+        conjugate ? catamari::Conjugate(entry.value) : entry.value;
+    if (transpose) {
+      residual[entry.column] -= value * solution(entry.row, 0);
+    } else {
+      residual[entry.row] -= value * solution(entry.column, 0);
+    }
+  }
+  double max_residual = 0;
+  for (const Field& value : residual) {
+    max_residual = std::max(max_residual, std::abs(value));
+  }
+  return max_residual;
+}
+
+// Checks each solve operation against the residual of its operator.
+void RunTest(bool hermitian, catamari::SparseLDLControl<Field> control) {
+  const catamari::CoordinateMatrix<Field> matrix =
+      ComplexLaplacian(25, hermitian);
+  const Int num_rows = matrix.NumRows();
+  control.SetFactorizationType(hermitian
+                                   ? catamari::kLDLAdjointFactorization
+                                   : catamari::kLDLTransposeFactorization);
+  catamari::SparseLDL<Field> ldl;
+  REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+
+  for (const SolveOperation operation :
+       {catamari::supernodal_ldl::kSolveMatrix,
+        catamari::supernodal_ldl::kSolveTranspose,
+        catamari::supernodal_ldl::kSolveConjugate,
+        catamari::supernodal_ldl::kSolveAdjoint}) {
+    BlasMatrix<Field> solution;
+    solution.Resize(num_rows, 1, Field{1});
+    ldl.Solve(&solution.view, operation);
+    REQUIRE(MaxResidual(matrix, operation, solution) <= 1e-12);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Complex-symmetric", "[Complex-symmetric]") {
+  catamari::SparseLDLControl<Field> control;
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  RunTest(false, control);
+
+  control.equilibrate = true;
+  RunTest(false, control);
+}
+
+TEST_CASE("Hermitian", "[Hermitian]") {
+  catamari::SparseLDLControl<Field> control;
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  RunTest(true, control);
+}
+
+TEST_CASE("Scalar", "[Scalar]") {
+  catamari::SparseLDLControl<Field> control;
+  control.supernodal_strategy = catamari::kScalarFactorization;
+  RunTest(false, control);
+  RunTest(true, control);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// The number of grid points in each direction. The separator is the middle
+// grid line in each direction.
+constexpr Int kNumElements = 21;
+constexpr Int kSeparator = kNumElements / 2;
+
+// Returns the row of the grid point (x, y).
+Int GridIndex(Int x, Int y) { return x + y * kNumElements; }
+
+// Returns the quadrant (0 through 3) of the grid point (x, y), or 4 if it
+// lies on the separator.
+Int Quadrant(Int x, Int y) {
+  if (x == kSeparator || y == kSeparator) return 4;
+  return (x > kSeparator) + 2 * (y > kSeparator);
+}
+
+// Returns the shifted 2D negative Laplacian with its rows and columns
+// rescaled, so that equilibration changes the factored matrix.
+template <typename Field>
+catamari::CoordinateMatrix<Field> ScaledLaplacian(const Field& shift) {
+  const catamari::CoordinateMatrix<Field> laplacian =
+      ShiftedLaplacian(kNumElements, kNumElements, shift);
+  auto scale = [](Int index) { return 1. + (index % 5); };
+  catamari::CoordinateMatrix<Field> matrix;
+  matrix.Resize(laplacian.NumRows(), laplacian.NumRows());
+  matrix.ReserveEntryAdditions(laplacian.NumEntries());
+  for (const catamari::MatrixEntry<Field>& entry : laplacian.Entries()) {
+    matrix.QueueEntryAddition(
+        entry.row, entry.column,
+        entry.value * scale(entry.row) * scale(entry.column));
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the ordering which eliminates each of the four quadrants of the
+// grid in turn and then the cross-shaped separator, so that the quadrants
+// form disjoint subtrees of the assembly forest.
+catamari::SymmetricOrdering QuadrantOrdering() {
+  std::vector<Int> order;
+  for (Int quadrant = 0; quadrant <= 4; ++quadrant) {
+    for (Int y = 0; y < kNumElements; ++y) {
+      for (Int x = 0; x < kNumElements; ++x) {
+        if (Quadrant(x, y) == quadrant) order.push_back(GridIndex(x, y));
+      }
+    }
+  }
+  catamari::SymmetricOrdering ordering;
+  ordering.permutation.Resize(order.size());
+  for (std::size_t index = 0; index < order.size(); ++index) {
+    ordering.permutation[order[index]] = index;
+  }
+  catamari::InvertPermutation(ordering.permutation,
+                              &ordering.inverse_permutation);
+  return ordering;
+}
+
+// Returns a buffer holding the rows of the given grid points.
+Buffer<Int> GridRows(const std::vector<std::pair<Int, Int>>& points) {
+  Buffer<Int> rows(points.size());
+  for (std::size_t index = 0; index < points.size(); ++index) {
+    rows[index] = GridIndex(points[index].first, points[index].second);
+  }
+  return rows;
+}
+
+// Checks the rows of a pruned solve against those of a dense solve, with the
+// right-hand sides supported in three of the four quadrants (and on the
+// separator), and checks that every other row is left unmodified.
+template <typename Field>
+void RunTest(catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const catamari::CoordinateMatrix<Field> matrix = ScaledLaplacian(shift);
+  const Int num_rows = matrix.NumRows();
+  const Int num_rhs = 2;
+
+  const Buffer<Int> rhs_support =
+      GridRows({{2, 3}, {15, 4}, {4, 17}, {kSeparator, 6}});
+  const Buffer<Int> requested_indices =
+      GridRows({{2, 3}, {3, 2}, {18, 16}, {16, 19}, {12, kSeparator}});
+  REQUIRE(Quadrant(2, 3) == 0);
+  REQUIRE(Quadrant(15, 4) == 1);
+  REQUIRE(Quadrant(4, 17) == 2);
+  REQUIRE(Quadrant(18, 16) == 3);
+
+  const Field sentinel{7};
+  auto rhs_value = [](Int i, Int j) { return Field(1. + (i % 3) + j); };
+  auto contains = [](const Buffer<Int>& rows, Int row) {
+    return std::find(rows.begin(), rows.end(), row) != rows.end();
+  };
+
+  for (int mode = 0; mode < 3; ++mode) {
+    catamari::SparseLDLControl<Field> ldl_control;
+    ldl_control.SetFactorizationType(factorization_type);
+    ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+    ldl_control.equilibrate = mode > 0;
+    ldl_control.fuse_equilibration = mode > 1;
+
+    catamari::SparseLDL<Field> ldl;
+    REQUIRE(ldl.Factor(matrix, QuadrantOrdering(), ldl_control)
+                .num_successful_pivots == num_rows);
+
+    BlasMatrix<Field> expected(num_rows, num_rhs, Field{0});
+    BlasMatrix<Field> solution(num_rows, num_rhs, sentinel);
+    for (const Int& row : rhs_support) {
+      for (Int j = 0; j < num_rhs; ++j) {
+        expected(row, j) = solution(row, j) = rhs_value(row, j);
+      }
+    }
+    ldl.Solve(&expected.view);
+    ldl.SolveSparse(rhs_support, requested_indices, &solution.view);
+
+    Real max_entry = 0;
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        max_entry = std::max(max_entry, std::abs(expected(i, j)));
+      }
+    }
+    const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+    for (Int j = 0; j < num_rhs; ++j) {
+      for (Int i = 0; i < num_rows; ++i) {
+        if (contains(requested_indices, i)) {
+          REQUIRE(std::abs(solution(i, j) - expected(i, j)) <=
+                  tolerance * max_entry);
+        } else if (contains(rhs_support, i)) {
+          // The equilibration of the input rows is undone.
+          REQUIRE(std::abs(solution(i, j) - rhs_value(i, j)) <=
+                  tolerance * std::abs(rhs_value(i, j)));
+        } else {
+          REQUIRE(solution(i, j) == sentinel);
+        }
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(catamari::kCholeskyFactorization, 0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  RunTest<double>(catamari::kLDLAdjointFactorization, -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<mantis::Complex<double>>(catamari::kLDLTransposeFactorization,
+                                   mantis::Complex<double>(-1., 0.5));
+}
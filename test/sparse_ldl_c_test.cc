@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "catamari.h"
+#include "catch2/catch.hpp"
+
+namespace {
+
+// The compressed-sparse-column pattern and values of the 5-point negative
+// Laplacian over an 'n x n' grid, optionally keeping only its lower triangle.
+struct Laplacian {
+  CatamariInt num_rows;
+  std::vector<CatamariInt> offsets;
+  std::vector<CatamariInt> indices;
+  std::vector<double> values;
+};
+
+Laplacian NegativeLaplacian(CatamariInt n, bool lower) {
+  Laplacian laplacian;
+  laplacian.num_rows = n * n;
+  laplacian.offsets.push_back(0);
+  for (CatamariInt y = 0; y < n; ++y) {
+    for (CatamariInt x = 0; x < n; ++x) {
+      const CatamariInt column = x + y * n;
+      const CatamariInt neighbors[] = {
+          y > 0 ? column - n : -1, x > 0 ? column - 1 : -1, column,
+          x < n - 1 ? column + 1 : -1, y < n - 1 ? column + n : -1};
+      for (const CatamariInt row : neighbors) {
+        if (row < 0 || (lower && row < column)) continue;
+        laplacian.indices.push_back(row);
+        laplacian.values.push_back(row == column ? 4. : -1.);
+      }
+      laplacian.offsets.push_back(laplacian.indices.size());
+    }
+  }
+  return laplacian;
+}
+
+// Returns the largest entry of |b - scale A x| over the full matrix.
+double ResidualMax(const Laplacian& full, double scale,
+                   const std::vector<double>& right_hand_side,
+                   const std::vector<double>& solution) {
+  std::vector<double> residual = right_hand_side;
+  for (CatamariInt column = 0; column < full.num_rows; ++column) {
+    for (CatamariInt index = full.offsets[column];
+         index < full.offsets[column + 1]; ++index) {
+      residual[full.indices[index]] -=
+          scale * full.values[index] * solution[column];
+    }
+  }
+  double residual_max = 0;
+  for (const double value : residual) {
+    residual_max = std::max(residual_max, std::abs(value));
+  }
+  return residual_max;
+}
+
+void RunTest(bool lower) {
+  const Laplacian full = NegativeLaplacian(20, false);
+  const Laplacian stored = NegativeLaplacian(20, lower);
+  const CatamariInt num_rows = full.num_rows;
+
+  CatamariSparseLDLControl control;
+  CatamariSparseLDLControlInit(&control);
+  control.triangle_storage = lower;
+
+  CatamariSparseLDLDouble* ldl = nullptr;
+  REQUIRE(CatamariSparseLDLDoubleCreate(&ldl) == CatamariSuccess);
+
+  // A solve before a factorization is rejected.
+  std::vector<double> right_hand_side(num_rows, 1.);
+  std::vector<double> solution = right_hand_side;
+  CatamariBlasMatrixViewDouble view;
+  view.height = num_rows;
+  view.width = 1;
+  view.leading_dim = num_rows;
+  view.data = solution.data();
+  REQUIRE(CatamariSparseLDLDoubleSolve(ldl, &view) ==
+          CatamariInvalidArgument);
+
+  CatamariSparseLDLResult result;
+  REQUIRE(CatamariSparseLDLDoubleFactor(
+              ldl, &control, num_rows, stored.offsets.data(),
+              stored.indices.data(), false, stored.values.data(),
+              &result) == CatamariSuccess);
+  REQUIRE(result.num_successful_pivots == num_rows);
+  REQUIRE(CatamariSparseLDLDoubleSolve(ldl, &view) == CatamariSuccess);
+  REQUIRE(ResidualMax(full, 1., right_hand_side, solution) <= 1e-10);
+
+  // Refactor with doubled values read in place from a new array.
+  std::vector<double> doubled_values = stored.values;
+  for (double& value : doubled_values) value *= 2;
+  REQUIRE(CatamariSparseLDLDoubleRefactor(ldl, doubled_values.data(),
+                                          nullptr) == CatamariSuccess);
+  solution = right_hand_side;
+  view.data = solution.data();
+  REQUIRE(CatamariSparseLDLDoubleSolve(ldl, &view) == CatamariSuccess);
+  REQUIRE(ResidualMax(full, 2., right_hand_side, solution) <= 1e-10);
+
+  // A negated matrix is not positive definite.
+  std::vector<double> negated_values = stored.values;
+  for (double& value : negated_values) value = -value;
+  REQUIRE(CatamariSparseLDLDoubleRefactor(ldl, negated_values.data(),
+                                          &result) ==
+          CatamariFactorizationFailure);
+  REQUIRE(result.num_successful_pivots < num_rows);
+
+  CatamariSparseLDLDoubleDestroy(&ldl);
+  REQUIRE(ldl == nullptr);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("C sparse LDL [full]", "[C sparse LDL full]") { RunTest(false); }
+
+TEST_CASE("C sparse LDL [lower]", "[C sparse LDL lower]") { RunTest(true); }
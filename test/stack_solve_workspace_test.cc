@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include <tbb/task_arena.h>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+using catamari_test::PerturbedLaplacian;
+
+namespace {
+
+// Fills the right-hand sides with a deterministic, non-constant pattern.
+void FillRightHandSides(Int num_rows, Int num_rhs,
+                        BlasMatrix<double>* right_hand_sides) {
+  right_hand_sides->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      right_hand_sides->Entry(i, j) = std::sin(1. + i + 3. * j);
+    }
+  }
+}
+
+// Returns the maximum entrywise difference of two solutions relative to the
+// largest entry of the first.
+double RelativeDifference(const BlasMatrix<double>& expected,
+                          const BlasMatrix<double>& solution) {
+  double max_error = 0;
+  double max_entry = 0;
+  for (Int j = 0; j < expected.view.width; ++j) {
+    for (Int i = 0; i < expected.view.height; ++i) {
+      max_error =
+          std::max(max_error, std::abs(solution(i, j) - expected(i, j)));
+      max_entry = std::max(max_entry, std::abs(expected(i, j)));
+    }
+  }
+  return max_error / max_entry;
+}
+
+// Checks that solves with a stacked workspace match those with the default
+// workspace, including when a single caller-owned workspace alternates
+// between the two.
+void RunTest(catamari::SparseLDLControl<double> control) {
+  const catamari::CoordinateMatrix<double> matrix = PerturbedLaplacian(40, 4.5);
+  const Int num_rows = matrix.NumRows();
+
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    catamari::SparseLDL<double> ldl;
+    REQUIRE(ldl.Factor(matrix, control).num_successful_pivots == num_rows);
+    control.supernodal_control.stack_solve_workspace = true;
+    catamari::SparseLDL<double> stacked_ldl;
+    REQUIRE(stacked_ldl.Factor(matrix, control).num_successful_pivots ==
+            num_rows);
+
+    catamari::SolveWorkspace<double> workspace;
+    for (const Int num_rhs : {1, 5, 100, 3}) {
+      BlasMatrix<double> expected;
+      FillRightHandSides(num_rows, num_rhs, &expected);
+      ldl.Solve(&expected.view);
+
+      BlasMatrix<double> solution;
+      FillRightHandSides(num_rows, num_rhs, &solution);
+      stacked_ldl.Solve(&solution.view);
+      REQUIRE(RelativeDifference(expected, solution) <= 1e-12);
+
+      FillRightHandSides(num_rows, num_rhs, &solution);
+      stacked_ldl.Solve(&solution.view, &workspace);
+      REQUIRE(RelativeDifference(expected, solution) <= 1e-12);
+
+      FillRightHandSides(num_rows, num_rhs, &solution);
+      ldl.Solve(&solution.view, &workspace);
+      REQUIRE(RelativeDifference(expected, solution) <= 1e-12);
+    }
+  });
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Right-looking Cholesky", "[Right-looking Cholesky]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kCholeskyFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  RunTest(control);
+}
+
+TEST_CASE("LDL^T", "[LDL^T]") {
+  catamari::SparseLDLControl<double> control;
+  control.SetFactorizationType(catamari::kLDLTransposeFactorization);
+  control.supernodal_strategy = catamari::kSupernodalFactorization;
+  control.reordering_strategy = catamari::kNestedDissectionReordering;
+  RunTest(control);
+}
+
+TEST_CASE("Parallel thresholds", "[Parallel thresholds]") {
+  for (const double threshold : {0., 1e3, 1e12}) {
+    catamari::SparseLDLControl<double> control;
+    control.SetFactorizationType(catamari::kCholeskyFactorization);
+    control.supernodal_strategy = catamari::kSupernodalFactorization;
+    control.supernodal_control.min_parallel_solve_threshold = threshold;
+    control.supernodal_control.solve_rhs_block_size = 16;
+    RunTest(control);
+  }
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Maps the trees of 'forest' onto 'num_domains' domains, using the subtree
+// sizes as the work estimates, and checks that each leaf lies within exactly
+// one mapped subtree. Returns the number of supernodes mapped to each domain.
+std::vector<Int> MapForest(const catamari::AssemblyForest& forest,
+                           Int num_domains) {
+  const Int num_supernodes = forest.parents.Size();
+  Buffer<double> work_estimates(num_supernodes, 0.);
+  std::vector<Int> postorder;
+  std::vector<Int> stack(forest.roots.begin(), forest.roots.end());
+  while (!stack.empty()) {
+    const Int supernode = stack.back();
+    stack.pop_back();
+    postorder.push_back(supernode);
+    for (Int index = forest.child_offsets[supernode];
+         index < forest.child_offsets[supernode + 1]; ++index) {
+      stack.push_back(forest.children[index]);
+    }
+  }
+  for (auto iter = postorder.rbegin(); iter != postorder.rend(); ++iter) {
+    work_estimates[*iter] += 1;
+    if (forest.parents[*iter] >= 0) {
+      work_estimates[forest.parents[*iter]] += work_estimates[*iter];
+    }
+  }
+
+  Buffer<Int> subtree_domains(num_supernodes, -1);
+  const std::vector<Int> roots(forest.roots.begin(), forest.roots.end());
+  catamari::supernodal_ldl::ProportionalSubtreeMapping(
+      forest, work_estimates, roots, 0, num_domains, &subtree_domains);
+
+  std::vector<Int> domain_sizes(num_domains, 0);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    Int num_mapped_ancestors = 0;
+    Int domain = -1;
+    for (Int ancestor = supernode; ancestor >= 0;
+         ancestor = forest.parents[ancestor]) {
+      if (subtree_domains[ancestor] >= 0) {
+        ++num_mapped_ancestors;
+        domain = subtree_domains[ancestor];
+      }
+    }
+    REQUIRE(num_mapped_ancestors <= 1);
+    if (forest.NumChildren(supernode) == 0) {
+      REQUIRE(num_mapped_ancestors == 1);
+    }
+    if (domain >= 0) {
+      REQUIRE(domain < num_domains);
+      ++domain_sizes[domain];
+    }
+  }
+  return domain_sizes;
+}
+
+// Symbolically factors a shifted 2D negative Laplacian and refactors it
+// through a conversion plan with its subtrees mapped onto 'num_domains'
+// domains, optionally first-touching the factor within the domains.
+template <typename Field>
+void RunFactorTest(Int num_x_elements, Int num_y_elements,
+                   catamari::SymmetricFactorizationType factorization_type,
+                   const Field& shift, Int num_domains,
+                   bool first_touch_factor_values) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.subtree_mapping_domains = num_domains;
+  ldl_control.supernodal_control.first_touch_factor_values =
+      first_touch_factor_values;
+  ldl_control.supernodal_control.min_parallel_threshold = 0;
+  ldl_control.supernodal_control.parallel_ratio_threshold = 0;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  for (Int refactorization = 0; refactorization < 2; ++refactorization) {
+    const catamari::SparseLDLResult<Field> result =
+        ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Balanced tree", "[Balanced tree]") {
+  // A perfect binary tree of depth four in heap order.
+  catamari::AssemblyForest forest;
+  forest.parents.Resize(31);
+  for (Int index = 0; index < 31; ++index) {
+    forest.parents[index] = index ? (index - 1) / 2 : -1;
+  }
+  forest.FillFromParents();
+
+  for (Int num_domains : {1, 2, 4, 8}) {
+    const std::vector<Int> domain_sizes = MapForest(forest, num_domains);
+    for (const Int& domain_size : domain_sizes) {
+      REQUIRE(domain_size == 32 / num_domains - 1);
+    }
+  }
+
+  // With three domains, the lighter half of the tree is shared by two of
+  // them.
+  const std::vector<Int> domain_sizes = MapForest(forest, 3);
+  REQUIRE(*std::max_element(domain_sizes.begin(), domain_sizes.end()) == 15);
+}
+
+TEST_CASE("Unbalanced forest", "[Unbalanced forest]") {
+  // A forest of a path, a star, and a caterpillar.
+  catamari::AssemblyForest forest;
+  forest.parents.Resize(40);
+  for (Int index = 0; index < 10; ++index) {
+    forest.parents[index] = index ? index - 1 : -1;
+  }
+  for (Int index = 10; index < 20; ++index) {
+    forest.parents[index] = index > 10 ? 10 : -1;
+  }
+  for (Int index = 20; index < 40; index += 2) {
+    forest.parents[index] = index > 20 ? index - 2 : -1;
+    forest.parents[index + 1] = index;
+  }
+  forest.FillFromParents();
+
+  for (Int num_domains : {1, 2, 3, 5, 7, 16}) {
+    const std::vector<Int> domain_sizes = MapForest(forest, num_domains);
+    Int num_mapped = 0;
+    for (const Int& domain_size : domain_sizes) {
+      num_mapped += domain_size;
+    }
+    REQUIRE(num_mapped > 0);
+  }
+}
+
+TEST_CASE("Factorization", "[Factorization]") {
+  for (Int num_domains : {0, -1, 2, 3}) {
+    for (bool first_touch : {false, true}) {
+      RunFactorTest<double>(40, 30, catamari::kCholeskyFactorization, 0.1,
+                            num_domains, first_touch);
+      RunFactorTest<double>(40, 30, catamari::kLDLAdjointFactorization, -1.,
+                            num_domains, first_touch);
+      RunFactorTest<mantis::Complex<double>>(
+          40, 30, catamari::kLDLTransposeFactorization,
+          mantis::Complex<double>(-1., 0.5), num_domains, first_touch);
+    }
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+
+#include "catamari.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+TEST_CASE("Relabeling", "[Relabeling]") {
+  // The forest 0 -> 2, 1 -> 3, 2 -> 4, 3 -> 4 interleaves the two subtrees
+  // of supernode 4. Supernode 'j' has 'j + 1' rows.
+  const Int num_supernodes = 5;
+  catamari::SymmetricOrdering ordering;
+  ordering.supernode_sizes.Resize(num_supernodes);
+  ordering.assembly_forest.parents.Resize(num_supernodes);
+  const Int parents[] = {2, 3, 4, 4, -1};
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    ordering.supernode_sizes[supernode] = supernode + 1;
+    ordering.assembly_forest.parents[supernode] = parents[supernode];
+  }
+  catamari::OffsetScan(ordering.supernode_sizes, &ordering.supernode_offsets);
+  ordering.assembly_forest.FillFromParents();
+  const Int num_rows = ordering.supernode_offsets.Back();
+
+  Buffer<Int> degrees(num_supernodes);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    degrees[supernode] = 10 * supernode;
+  }
+  Buffer<Int> member_to_index;
+  catamari::supernodal_ldl::MemberToIndex(
+      num_rows, ordering.supernode_offsets, &member_to_index);
+
+  REQUIRE(catamari::supernodal_ldl::PostorderSupernodes(&ordering, &degrees,
+                                                        &member_to_index));
+
+  // The new order is 0, 2, 1, 3, 4.
+  const Int orig_supernodes[] = {0, 2, 1, 3, 4};
+  const Int orig_offsets[] = {0, 1, 3, 6, 10};
+  const Int new_parents[] = {1, 4, 3, 4, -1};
+  Int row = 0;
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int orig_supernode = orig_supernodes[supernode];
+    REQUIRE(ordering.supernode_sizes[supernode] == orig_supernode + 1);
+    REQUIRE(ordering.supernode_offsets[supernode] == row);
+    REQUIRE(ordering.assembly_forest.parents[supernode] ==
+            new_parents[supernode]);
+    REQUIRE(degrees[supernode] == 10 * orig_supernode);
+    for (Int j = 0; j <= orig_supernode; ++j, ++row) {
+      REQUIRE(ordering.inverse_permutation[row] ==
+              orig_offsets[orig_supernode] + j);
+      REQUIRE(ordering.permutation[orig_offsets[orig_supernode] + j] == row);
+      REQUIRE(member_to_index[row] == supernode);
+    }
+  }
+
+  // A postordered forest is left unmodified.
+  REQUIRE(!catamari::supernodal_ldl::PostorderSupernodes(&ordering, &degrees,
+                                                         &member_to_index));
+}
+
+TEST_CASE("Prescribed ordering", "[Prescribed ordering]") {
+  const Int num_x_elements = 30;
+  const catamari::CoordinateMatrix<double> matrix =
+      ShiftedLaplacian(num_x_elements, num_x_elements, 1.);
+  const Int num_rows = matrix.NumRows();
+
+  // Eliminating the even grid columns, and then the odd ones, leaves the
+  // elimination forest far from postordered.
+  catamari::SymmetricOrdering ordering;
+  ordering.inverse_permutation.Resize(num_rows);
+  Int row = 0;
+  for (Int parity = 0; parity < 2; ++parity) {
+    for (Int x = parity; x < num_x_elements; x += 2) {
+      for (Int y = 0; y < num_x_elements; ++y) {
+        ordering.inverse_permutation[row++] = x + y * num_x_elements;
+      }
+    }
+  }
+  catamari::InvertPermutation(ordering.inverse_permutation,
+                              &ordering.permutation);
+
+  for (const bool postorder : {false, true}) {
+    catamari::SparseLDLControl<double> control;
+    control.SetFactorizationType(catamari::kCholeskyFactorization);
+    control.supernodal_strategy = catamari::kSupernodalFactorization;
+    control.supernodal_control.postorder_supernodes = postorder;
+    catamari::SparseLDL<double> ldl;
+    const catamari::SparseLDLResult<double> result =
+        ldl.Factor(matrix, ordering, control);
+    REQUIRE(result.num_successful_pivots == num_rows);
+    REQUIRE(RelativeResidual(matrix, ldl) < 1e-12);
+  }
+}
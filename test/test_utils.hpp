@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef CATAMARI_TEST_TEST_UTILS_H_
+#define CATAMARI_TEST_TEST_UTILS_H_
+
+#include <algorithm>
+#include <cmath>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/buffer.hpp"
+#include "catamari/coordinate_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+
+// The matrices and accuracy measures shared by the tests.
+namespace catamari_test {
+
+// Returns a shifted 2D negative Laplacian. Adding grid lines in the y
+// direction appends rows without changing the existing ones.
+template <typename Field>
+catamari::CoordinateMatrix<Field> ShiftedLaplacian(catamari::Int num_x_elements,
+                                                   catamari::Int num_y_elements,
+                                                   const Field& shift) {
+  typedef catamari::Int Int;
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int num_rows = num_x_elements * num_y_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, Field{4} + shift);
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, Field{-1});
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, Field{-1});
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, Field{-1});
+      }
+      if (y < num_y_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, Field{-1});
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns a shifted 3D negative Laplacian.
+template <typename Field>
+catamari::CoordinateMatrix<Field> ShiftedLaplacian(catamari::Int num_x_elements,
+                                                   catamari::Int num_y_elements,
+                                                   catamari::Int num_z_elements,
+                                                   const Field& shift) {
+  typedef catamari::Int Int;
+  catamari::CoordinateMatrix<Field> matrix;
+  const Int y_stride = num_x_elements;
+  const Int z_stride = num_x_elements * num_y_elements;
+  const Int num_rows = z_stride * num_z_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(7 * num_rows);
+  for (Int x = 0; x < num_x_elements; ++x) {
+    for (Int y = 0; y < num_y_elements; ++y) {
+      for (Int z = 0; z < num_z_elements; ++z) {
+        const Int index = x + y * y_stride + z * z_stride;
+        matrix.QueueEntryAddition(index, index, Field{6} + shift);
+        if (x > 0) matrix.QueueEntryAddition(index, index - 1, Field{-1});
+        if (x < num_x_elements - 1) {
+          matrix.QueueEntryAddition(index, index + 1, Field{-1});
+        }
+        if (y > 0) {
+          matrix.QueueEntryAddition(index, index - y_stride, Field{-1});
+        }
+        if (y < num_y_elements - 1) {
+          matrix.QueueEntryAddition(index, index + y_stride, Field{-1});
+        }
+        if (z > 0) {
+          matrix.QueueEntryAddition(index, index - z_stride, Field{-1});
+        }
+        if (z < num_z_elements - 1) {
+          matrix.QueueEntryAddition(index, index + z_stride, Field{-1});
+        }
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns a 2D negative Laplacian over an n x n grid whose diagonal entries
+// vary slightly above 'diagonal', so that its pivots are not all alike.
+inline catamari::CoordinateMatrix<double> PerturbedLaplacian(
+    catamari::Int num_x_elements, double diagonal) {
+  typedef catamari::Int Int;
+  catamari::CoordinateMatrix<double> matrix;
+  const Int num_rows = num_x_elements * num_x_elements;
+  matrix.Resize(num_rows, num_rows);
+  matrix.ReserveEntryAdditions(5 * num_rows);
+  for (Int y = 0; y < num_x_elements; ++y) {
+    for (Int x = 0; x < num_x_elements; ++x) {
+      const Int index = x + y * num_x_elements;
+      matrix.QueueEntryAddition(index, index, diagonal + 0.01 * (index % 7));
+      if (x > 0) matrix.QueueEntryAddition(index, index - 1, -1);
+      if (x < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + 1, -1);
+      }
+      if (y > 0) {
+        matrix.QueueEntryAddition(index, index - num_x_elements, -1);
+      }
+      if (y < num_x_elements - 1) {
+        matrix.QueueEntryAddition(index, index + num_x_elements, -1);
+      }
+    }
+  }
+  matrix.FlushEntryQueues();
+  return matrix;
+}
+
+// Returns the relative residual, || b - A x ||_max / (|| A ||_max || x ||_max),
+// of the factored solution of A x = b, where b is the vector of all ones.
+template <typename Field>
+catamari::ComplexBase<Field> RelativeResidual(
+    const catamari::CoordinateMatrix<Field>& matrix,
+    const catamari::SparseLDL<Field>& ldl) {
+  typedef catamari::Int Int;
+  typedef catamari::ComplexBase<Field> Real;
+  const Int num_rows = matrix.NumRows();
+  catamari::BlasMatrix<Field> solution;
+  solution.Resize(num_rows, 1, Field{1});
+  ldl.Solve(&solution.view);
+
+  catamari::Buffer<Field> residual(num_rows, Field{1});
+  Real matrix_norm = 0;
+  for (const catamari::MatrixEntry<Field>& entry : matrix.Entries()) {
+    residual[entry.row] -= entry.value * solution(entry.column, 0);
+    matrix_norm = std::max(matrix_norm, std::abs(entry.value));
+  }
+  Real residual_norm = 0;
+  Real solution_norm = 0;
+  for (Int i = 0; i < num_rows; ++i) {
+    residual_norm = std::max(residual_norm, std::abs(residual[i]));
+    solution_norm = std::max(solution_norm, std::abs(solution(i, 0)));
+  }
+  return residual_norm / (matrix_norm * solution_norm);
+}
+
+// Fills a matrix with deterministic right-hand sides.
+template <typename Field>
+void RightHandSides(catamari::Int num_rows, catamari::Int num_rhs,
+                    catamari::BlasMatrix<Field>* storage) {
+  typedef catamari::Int Int;
+  storage->Resize(num_rows, num_rhs);
+  for (Int j = 0; j < num_rhs; ++j) {
+    for (Int i = 0; i < num_rows; ++i) {
+      storage->Entry(i, j) = Field(double((i * 5 + j * 3) % 13) - 6.);
+    }
+  }
+}
+
+// Returns the maximum relative difference between two sets of solutions.
+template <typename Field>
+catamari::ComplexBase<Field> RelativeDifference(
+    const catamari::BlasMatrixView<Field>& solution,
+    const catamari::BlasMatrixView<Field>& reference) {
+  typedef catamari::Int Int;
+  typedef catamari::ComplexBase<Field> Real;
+  Real max_difference = 0;
+  Real max_entry = 0;
+  for (Int j = 0; j < reference.width; ++j) {
+    for (Int i = 0; i < reference.height; ++i) {
+      max_difference = std::max(max_difference,
+                                std::abs(solution(i, j) - reference(i, j)));
+      max_entry = std::max(max_entry, std::abs(reference(i, j)));
+    }
+  }
+  return max_difference / max_entry;
+}
+
+}  // namespace catamari_test
+
+#endif  // ifndef CATAMARI_TEST_TEST_UTILS_H_
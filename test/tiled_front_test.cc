@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include <tbb/task_arena.h>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Refactors a shifted 2D negative Laplacian through a conversion plan with
+// every front split into tile tasks of the given sizes. The factorization is
+// run within a multithreaded task arena, as single-threaded factorizations
+// never tile their fronts.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift, Int factor_tile_size,
+             Int outer_product_tile_size) {
+  typedef catamari::ComplexBase<Field> Real;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+  ldl_control.supernodal_control.algorithm = catamari::kRightLookingLDL;
+  ldl_control.supernodal_control.min_tiled_front_work = 1;
+  ldl_control.supernodal_control.factor_tile_size = factor_tile_size;
+  ldl_control.supernodal_control.outer_product_tile_size =
+      outer_product_tile_size;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  ldl.Factor(matrix, ldl_control, /* symbolic_only = */ true);
+  catamari::ConversionPlan cplan;
+  ldl.FormConversionPlan(matrix, &cplan);
+  Buffer<Field> values(matrix.NumEntries());
+  for (Int index = 0; index < matrix.NumEntries(); ++index) {
+    values[index] = matrix.Entries()[index].value;
+  }
+
+  catamari::SparseLDLResult<Field> result;
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    result = ldl.RefactorWithFixedSparsityPattern(cplan, values.Data());
+  });
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  for (Int tile_size : {1, 3, 8}) {
+    RunTest<double>(30, 25, catamari::kCholeskyFactorization, 0.1, tile_size,
+                    tile_size + 2);
+    RunTest<mantis::Complex<double>>(30, 25, catamari::kCholeskyFactorization,
+                                     0.1, tile_size, tile_size + 2);
+  }
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  for (Int tile_size : {1, 3, 8}) {
+    RunTest<double>(30, 25, catamari::kLDLAdjointFactorization, -1.,
+                    tile_size, tile_size + 2);
+    RunTest<mantis::Complex<double>>(30, 25,
+                                     catamari::kLDLAdjointFactorization, -1.,
+                                     tile_size, tile_size + 2);
+  }
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  for (Int tile_size : {1, 3, 8}) {
+    RunTest<double>(30, 25, catamari::kLDLTransposeFactorization, -1.,
+                    tile_size, tile_size + 2);
+    RunTest<mantis::Complex<double>>(
+        30, 25, catamari::kLDLTransposeFactorization,
+        mantis::Complex<double>(-1., 0.5), tile_size, tile_size + 2);
+  }
+}
+
+TEST_CASE("BlasThreading", "[BlasThreading]") {
+  // The multithreaded factorization restores the caller's BLAS threading.
+  catamari::SetNumBlasThreads(2);
+  const int num_blas_threads = catamari::GetMaxBlasThreads();
+  RunTest<double>(30, 25, catamari::kLDLAdjointFactorization, -1., 8, 10);
+  REQUIRE(catamari::GetMaxBlasThreads() == num_blas_threads);
+}
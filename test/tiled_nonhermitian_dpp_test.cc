@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <tbb/task_arena.h>
+
+#include "catamari/blas_matrix.hpp"
+#include "catamari/dense_dpp.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Int;
+
+namespace {
+
+// Forms the marginal kernel K = L (I + L)^{-1} of a non-Hermitian L-ensemble
+// whose kernel L = B B^T + (C - C^T) has a positive semi-definite symmetric
+// part.
+void FormKernel(Int height, std::mt19937* generator,
+                BlasMatrix<double>* kernel) {
+  std::normal_distribution<double> normal_dist{0., 1.};
+  const Int rank = height / 4;
+  Eigen::MatrixXd factor(height, rank);
+  Eigen::MatrixXd skew(height, height);
+  for (Int j = 0; j < rank; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      factor(i, j) = 0.3 * normal_dist(*generator);
+    }
+  }
+  for (Int j = 0; j < height; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      skew(i, j) = 0.1 * normal_dist(*generator);
+    }
+  }
+  const Eigen::MatrixXd ensemble =
+      factor * factor.transpose() + skew - skew.transpose();
+  const Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(height, height);
+  const Eigen::MatrixXd marginal =
+      identity - (identity + ensemble).partialPivLu().inverse();
+
+  kernel->Resize(height, height);
+  for (Int j = 0; j < height; ++j) {
+    for (Int i = 0; i < height; ++i) {
+      kernel->Entry(i, j) = marginal(i, j);
+    }
+  }
+}
+
+// Checks that the tiled sampler matches the sequential one for identically
+// seeded generators.
+void RunTest(Int height, Int tile_size) {
+  std::mt19937 generator(17);
+  BlasMatrix<double> kernel;
+  FormKernel(height, &generator, &kernel);
+
+  tbb::task_arena arena(4);
+  for (const bool maximum_likelihood : {true, false}) {
+    BlasMatrix<double> expected_factor = kernel;
+    std::mt19937 expected_generator(23);
+    const std::vector<Int> expected = catamari::SampleNonHermitianDPP(
+        Int(32), maximum_likelihood, &expected_factor.view,
+        &expected_generator);
+
+    BlasMatrix<double> factor = kernel;
+    std::mt19937 tiled_generator(23);
+    std::vector<Int> sample;
+    arena.execute([&]() {
+      sample = catamari::TiledSampleNonHermitianDPP(
+          tile_size, maximum_likelihood, &factor.view, &tiled_generator);
+    });
+    REQUIRE(sample == expected);
+
+    double max_error = 0;
+    for (Int j = 0; j < height; ++j) {
+      for (Int i = 0; i < height; ++i) {
+        max_error = std::max(
+            max_error, std::abs(factor(i, j) - expected_factor(i, j)));
+      }
+    }
+    REQUIRE(max_error <= 1e-8);
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Single tile", "[Single tile]") { RunTest(100, 128); }
+
+TEST_CASE("Multiple tiles", "[Multiple tiles]") { RunTest(300, 64); }
+
+TEST_CASE("Ragged tiles", "[Ragged tiles]") { RunTest(250, 48); }
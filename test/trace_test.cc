@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include "catamari/trace.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+using catamari::TraceEvent;
+using catamari::TraceScope;
+using catamari::Tracer;
+
+namespace {
+
+// Performs a small amount of work which the compiler cannot elide.
+void Spin() {
+  volatile double sum = 0;
+  for (int i = 0; i < 1000; ++i) {
+    sum = sum + i;
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Disabled", "[Disabled]") {
+  Tracer& tracer = Tracer::Global();
+  tracer.Enable();
+  tracer.Disable();
+  { TraceScope scope("factor", 0); }
+  REQUIRE(!tracer.Enabled());
+  REQUIRE(tracer.Events().empty());
+}
+
+TEST_CASE("Multithreaded", "[Multithreaded]") {
+  const Int num_supernodes = 200;
+  Tracer& tracer = Tracer::Global();
+  tracer.Enable();
+  tbb::task_arena arena(4);
+  arena.execute([&]() {
+    tbb::parallel_for(Int(0), num_supernodes, [](Int supernode) {
+      TraceScope scope("factor", supernode);
+      Spin();
+    });
+  });
+  { TraceScope scope("solve"); }
+  tracer.Disable();
+
+  const std::vector<TraceEvent> events = tracer.Events();
+  REQUIRE(events.size() == std::size_t(num_supernodes + 1));
+  REQUIRE(tracer.NumDroppedEvents() == 0);
+
+  std::set<Int> supernodes;
+  for (std::size_t index = 0; index < events.size(); ++index) {
+    const TraceEvent& event = events[index];
+    REQUIRE(event.begin <= event.end);
+    if (index > 0) {
+      REQUIRE(events[index - 1].begin <= event.begin);
+    }
+    if (std::string(event.name) == "factor") {
+      supernodes.insert(event.supernode);
+    } else {
+      REQUIRE(std::string(event.name) == "solve");
+      REQUIRE(event.supernode == -1);
+    }
+  }
+  REQUIRE(supernodes.size() == std::size_t(num_supernodes));
+
+  std::ostringstream os;
+  tracer.WriteChromeTrace(os);
+  const std::string trace = os.str();
+  REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+  REQUIRE(trace.find("\"ph\": \"X\"") != std::string::npos);
+  REQUIRE(trace.find("\"supernode\": 199") != std::string::npos);
+}
+
+TEST_CASE("Ring buffer", "[Ring buffer]") {
+  const Int capacity = 16;
+  const Int num_events = 100;
+  Tracer& tracer = Tracer::Global();
+  tracer.Enable(capacity);
+  for (Int supernode = 0; supernode < num_events; ++supernode) {
+    TraceScope scope("merge", supernode);
+  }
+  tracer.Disable();
+
+  // Only the most recent events are retained.
+  const std::vector<TraceEvent> events = tracer.Events();
+  REQUIRE(events.size() == std::size_t(capacity));
+  REQUIRE(tracer.NumDroppedEvents() == std::size_t(num_events - capacity));
+  for (Int index = 0; index < capacity; ++index) {
+    REQUIRE(events[index].supernode == num_events - capacity + index);
+  }
+
+  // Re-enabling the tracer discards the events.
+  tracer.Enable();
+  REQUIRE(tracer.Events().empty());
+  tracer.Disable();
+}
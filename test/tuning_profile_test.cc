@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Int;
+using catamari::supernodal_ldl::AutoTuneControl;
+using catamari::supernodal_ldl::Control;
+using catamari::supernodal_ldl::TuningProfile;
+
+TEST_CASE("Round trip", "[Round trip]") {
+  TuningProfile profile;
+  profile.num_threads = 8;
+  profile.block_size = 96;
+  profile.factor_tile_size = 192;
+  profile.outer_product_tile_size = 360;
+  profile.merge_grain_size = 250;
+  profile.min_parallel_threshold = 2.5e6;
+  profile.min_parallel_solve_threshold = 1.5e5;
+
+  std::stringstream stream;
+  profile.Write(stream);
+  TuningProfile loaded;
+  REQUIRE(loaded.Read(stream));
+  REQUIRE(loaded.num_threads == 8);
+  REQUIRE(loaded.block_size == 96);
+  REQUIRE(loaded.factor_tile_size == 192);
+  REQUIRE(loaded.outer_product_tile_size == 360);
+  REQUIRE(loaded.merge_grain_size == 250);
+  REQUIRE(loaded.min_parallel_threshold == 2.5e6);
+  REQUIRE(loaded.min_parallel_solve_threshold == 1.5e5);
+
+  std::istringstream not_a_profile("block_size 32\n");
+  REQUIRE(!loaded.Read(not_a_profile));
+}
+
+TEST_CASE("Apply", "[Apply]") {
+  TuningProfile profile;
+  profile.block_size = 96;
+  profile.outer_product_tile_size = 360;
+
+  // Only the tuned fields which were left at their defaults are replaced.
+  Control<double> control;
+  control.outer_product_tile_size = 100;
+  catamari::supernodal_ldl::ApplyTuningProfile(profile, &control);
+  REQUIRE(control.block_size == 96);
+  REQUIRE(control.outer_product_tile_size == 100);
+  REQUIRE(control.factor_tile_size == Control<double>().factor_tile_size);
+}
+
+TEST_CASE("Auto-tune", "[Auto-tune]") {
+  const std::string filename = "tuning_profile_test_profile.txt";
+  setenv("CATAMARI_TUNING_PROFILE", filename.c_str(), 1);
+  catamari::supernodal_ldl::ReloadMachineTuningProfile();
+  REQUIRE(catamari::supernodal_ldl::DefaultTuningProfileFilename() ==
+          filename);
+  REQUIRE(catamari::supernodal_ldl::MachineTuningProfile() == nullptr);
+
+  AutoTuneControl control;
+  control.block_sizes = {16, 32};
+  control.factor_tile_sizes = {32, 64};
+  control.outer_product_tile_sizes = {32, 64};
+  control.proxy_front_sizes = {32, 64};
+  control.num_repetitions = 1;
+  const TuningProfile profile =
+      catamari::supernodal_ldl::AutoTune<double>(nullptr, control);
+  REQUIRE((profile.block_size == 16 || profile.block_size == 32));
+  REQUIRE((profile.factor_tile_size == 32 || profile.factor_tile_size == 64));
+  REQUIRE((profile.outer_product_tile_size == 32 ||
+           profile.outer_product_tile_size == 64));
+  REQUIRE(profile.merge_grain_size >= 16);
+  REQUIRE(profile.min_parallel_threshold >= 1e3);
+
+  // The saved profile is loaded by the subsequent factorizations.
+  const TuningProfile* machine_profile =
+      catamari::supernodal_ldl::MachineTuningProfile();
+  REQUIRE(machine_profile != nullptr);
+  REQUIRE(machine_profile->block_size == profile.block_size);
+  REQUIRE(machine_profile->merge_grain_size == profile.merge_grain_size);
+
+  std::remove(filename.c_str());
+  unsetenv("CATAMARI_TUNING_PROFILE");
+  catamari::supernodal_ldl::ReloadMachineTuningProfile();
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "catamari/uniform_spanning_tree.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Buffer;
+using catamari::GraphEdge;
+using catamari::Int;
+
+namespace {
+
+// Returns the symmetric graph with the given undirected edges.
+quotient::CoordinateGraph Graph(Int num_vertices,
+                                const std::vector<GraphEdge>& edges) {
+  quotient::CoordinateGraph graph;
+  graph.Resize(num_vertices);
+  graph.ReserveEdgeAdditions(2 * edges.size());
+  for (const GraphEdge& edge : edges) {
+    graph.QueueEdgeAddition(edge.first, edge.second);
+    graph.QueueEdgeAddition(edge.second, edge.first);
+  }
+  graph.FlushEdgeQueues();
+  return graph;
+}
+
+// Returns the graph of an x_size x y_size grid.
+quotient::CoordinateGraph GridGraph(Int x_size, Int y_size) {
+  std::vector<GraphEdge> edges;
+  for (Int y = 0; y < y_size; ++y) {
+    for (Int x = 0; x < x_size; ++x) {
+      const Int vertex = x + y * x_size;
+      if (x + 1 < x_size) edges.emplace_back(vertex, vertex + 1);
+      if (y + 1 < y_size) edges.emplace_back(vertex, vertex + x_size);
+    }
+  }
+  return Graph(x_size * y_size, edges);
+}
+
+// Requires that the edges form a spanning tree over the given vertices.
+void RequireSpanningTree(Int num_vertices, const std::vector<GraphEdge>& tree) {
+  REQUIRE(Int(tree.size()) == num_vertices - 1);
+  Buffer<Int> component(num_vertices);
+  for (Int vertex = 0; vertex < num_vertices; ++vertex) {
+    component[vertex] = vertex;
+  }
+  auto find_root = [&](Int vertex) {
+    while (component[vertex] != vertex) vertex = component[vertex];
+    return vertex;
+  };
+  for (const GraphEdge& edge : tree) {
+    const Int first_root = find_root(edge.first);
+    const Int second_root = find_root(edge.second);
+    // A spanning tree has no cycles.
+    REQUIRE(first_root != second_root);
+    component[first_root] = second_root;
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Grid", "[Grid]") {
+  const Int x_size = 9;
+  const Int y_size = 7;
+  const quotient::CoordinateGraph graph = GridGraph(x_size, y_size);
+  catamari::UniformSpanningTreeControl<double> control;
+  control.solve_batch_size = 16;
+  control.seed = 17;
+  const catamari::UniformSpanningTreeSampler<double> sampler(graph, control);
+  REQUIRE(sampler.NumVertices() == x_size * y_size);
+  REQUIRE(Int(sampler.Edges().size()) ==
+          (x_size - 1) * y_size + x_size * (y_size - 1));
+
+  const Int num_samples = 8;
+  const std::vector<std::vector<GraphEdge>> trees =
+      sampler.SampleMany(num_samples);
+  REQUIRE(Int(trees.size()) == num_samples);
+  for (const std::vector<GraphEdge>& tree : trees) {
+    RequireSpanningTree(x_size * y_size, tree);
+  }
+
+  // The concurrent samples match sequential samples with the same seed.
+  const catamari::UniformSpanningTreeSampler<double> sequential_sampler(
+      graph, control);
+  for (Int index = 0; index < num_samples; ++index) {
+    REQUIRE(sequential_sampler.Sample() == trees[index]);
+  }
+  REQUIRE(sequential_sampler.Sample() != trees[0]);
+
+  RequireSpanningTree(x_size * y_size, sampler.Sample(true));
+}
+
+TEST_CASE("Marginals", "[Marginals]") {
+  // A triangle with a pendant vertex: the pendant edge is in every spanning
+  // tree and each triangle edge is in two of the three.
+  const std::vector<GraphEdge> edges{GraphEdge(0, 1), GraphEdge(0, 2),
+                                     GraphEdge(1, 2), GraphEdge(2, 3)};
+  const Int num_samples = 3000;
+  const std::vector<std::vector<GraphEdge>> trees =
+      catamari::SampleSpanningTrees(Graph(4, edges), num_samples);
+  std::vector<Int> counts(edges.size(), 0);
+  for (const std::vector<GraphEdge>& tree : trees) {
+    RequireSpanningTree(4, tree);
+    for (const GraphEdge& edge : tree) {
+      for (std::size_t index = 0; index < edges.size(); ++index) {
+        if (edge == edges[index]) ++counts[index];
+      }
+    }
+  }
+  REQUIRE(counts[3] == num_samples);
+  for (Int index = 0; index < 3; ++index) {
+    const double frequency = counts[index] / double(num_samples);
+    REQUIRE(std::abs(frequency - 2. / 3.) < 0.05);
+  }
+}
+
+TEST_CASE("Disconnected", "[Disconnected]") {
+  const std::vector<GraphEdge> edges{GraphEdge(0, 1), GraphEdge(2, 3)};
+  catamari::UniformSpanningTreeControl<double> control;
+  REQUIRE_THROWS_AS(
+      catamari::UniformSpanningTreeSampler<double>(Graph(4, edges), control),
+      std::runtime_error);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <vector>
+#include "catamari/unit_reach_nested_dissection.hpp"
+#include "catch2/catch.hpp"
+
+using catamari::Buffer;
+using catamari::Int;
+
+namespace {
+
+// Requires that two buffers are identical.
+void RequireEqual(const Buffer<Int>& a, const Buffer<Int>& b) {
+  REQUIRE(a.Size() == b.Size());
+  for (Int index = 0; index < a.Size(); ++index) {
+    REQUIRE(a[index] == b[index]);
+  }
+}
+
+// Requires that two orderings are identical.
+void RequireEqual(const catamari::SymmetricOrdering& a,
+                  const catamari::SymmetricOrdering& b) {
+  RequireEqual(a.permutation, b.permutation);
+  RequireEqual(a.inverse_permutation, b.inverse_permutation);
+  RequireEqual(a.supernode_sizes, b.supernode_sizes);
+  RequireEqual(a.supernode_offsets, b.supernode_offsets);
+  RequireEqual(a.assembly_forest.parents, b.assembly_forest.parents);
+  RequireEqual(a.assembly_forest.roots, b.assembly_forest.roots);
+}
+
+// Requires that the ordering is a permutation whose supernodes are
+// postordered, i.e., each parent follows all of its children.
+void RequireValid(const catamari::SymmetricOrdering& ordering, Int num_rows) {
+  REQUIRE(ordering.permutation.Size() == num_rows);
+  std::vector<bool> found(num_rows, false);
+  for (Int row = 0; row < num_rows; ++row) {
+    const Int orig_row = ordering.inverse_permutation[row];
+    REQUIRE(orig_row >= 0);
+    REQUIRE(orig_row < num_rows);
+    REQUIRE(!found[orig_row]);
+    found[orig_row] = true;
+    REQUIRE(ordering.permutation[orig_row] == row);
+  }
+  const Int num_supernodes = ordering.supernode_sizes.Size();
+  REQUIRE(ordering.supernode_offsets[num_supernodes] == num_rows);
+  for (Int supernode = 0; supernode < num_supernodes; ++supernode) {
+    const Int parent = ordering.assembly_forest.parents[supernode];
+    REQUIRE((parent > supernode || (parent == -1 &&
+                                    supernode == num_supernodes - 1)));
+  }
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Parallel 2D", "[Parallel 2D]") {
+  catamari::UnitReachNestedDissectionControl control;
+  control.min_parallel_vertices = 64;
+  for (const Int num_x_elements : {1, 17, 40}) {
+    for (const Int num_y_elements : {3, 33}) {
+      catamari::SymmetricOrdering serial, parallel;
+      catamari::UnitReachNestedDissection2D(num_x_elements, num_y_elements,
+                                            &serial);
+      catamari::UnitReachNestedDissection2D(num_x_elements, num_y_elements,
+                                            control, &parallel);
+      RequireValid(parallel, (num_x_elements + 1) * (num_y_elements + 1));
+      RequireEqual(serial, parallel);
+    }
+  }
+}
+
+TEST_CASE("Parallel 3D", "[Parallel 3D]") {
+  catamari::UnitReachNestedDissectionControl control;
+  control.min_parallel_vertices = 64;
+  catamari::SymmetricOrdering serial, parallel;
+  catamari::UnitReachNestedDissection3D(20, 13, 9, &serial);
+  catamari::UnitReachNestedDissection3D(20, 13, 9, control, &parallel);
+  RequireValid(parallel, 21 * 14 * 10);
+  RequireEqual(serial, parallel);
+}
+
+TEST_CASE("Multiple dofs", "[Multiple dofs]") {
+  const Int num_dofs = 3;
+  catamari::UnitReachNestedDissectionControl control;
+  control.min_parallel_vertices = 64;
+  catamari::SymmetricOrdering scalar, vector;
+  catamari::UnitReachNestedDissection3D(12, 10, 8, control, &scalar);
+  control.num_dofs_per_vertex = num_dofs;
+  catamari::UnitReachNestedDissection3D(12, 10, 8, control, &vector);
+  const Int num_vertices = 13 * 11 * 9;
+  RequireValid(vector, num_dofs * num_vertices);
+
+  // The degrees of freedom of each vertex are contiguous and within the
+  // vertex's supernode.
+  REQUIRE(vector.supernode_sizes.Size() == scalar.supernode_sizes.Size());
+  for (Int supernode = 0; supernode < scalar.supernode_sizes.Size();
+       ++supernode) {
+    REQUIRE(vector.supernode_sizes[supernode] ==
+            num_dofs * scalar.supernode_sizes[supernode]);
+  }
+  for (Int index = 0; index < num_vertices; ++index) {
+    for (Int dof = 0; dof < num_dofs; ++dof) {
+      REQUIRE(vector.inverse_permutation[dof + index * num_dofs] ==
+              dof + scalar.inverse_permutation[index] * num_dofs);
+    }
+  }
+}
+
+TEST_CASE("Anisotropic", "[Anisotropic]") {
+  // With cells which are much longer along z, the top separator of a cube of
+  // vertices is a z-plane rather than an x-plane.
+  const Int num_elements = 16;
+  const Int stride = num_elements + 1;
+  catamari::UnitReachNestedDissectionControl control;
+  control.z_scale = 10.;
+  catamari::SymmetricOrdering ordering;
+  catamari::UnitReachNestedDissection3D(num_elements, num_elements,
+                                        num_elements, control, &ordering);
+  RequireValid(ordering, stride * stride * stride);
+
+  const Int root = ordering.supernode_sizes.Size() - 1;
+  REQUIRE(ordering.supernode_sizes[root] == stride * stride);
+  const Int plane = num_elements / 2;
+  for (Int row = ordering.supernode_offsets[root];
+       row < ordering.supernode_offsets[root + 1]; ++row) {
+    REQUIRE(ordering.inverse_permutation[row] / (stride * stride) == plane);
+  }
+}
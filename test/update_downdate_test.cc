@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 Jack Poulson <jack@hodgestar.com>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#define CATCH_CONFIG_MAIN
+#include <algorithm>
+#include <limits>
+#include "catamari/blas_matrix.hpp"
+#include "catamari/sparse_ldl.hpp"
+#include "catch2/catch.hpp"
+#include "test_utils.hpp"
+
+using catamari::BlasMatrix;
+using catamari::Buffer;
+using catamari::Int;
+using catamari_test::RelativeResidual;
+using catamari_test::ShiftedLaplacian;
+
+namespace {
+
+// Factors a shifted 2D negative Laplacian, updates the factorization with a
+// low-rank modification whose vectors couple grid neighbours (and hence lie
+// within the fill pattern), and then downdates back to the original matrix.
+template <typename Field>
+void RunTest(Int num_x_elements, Int num_y_elements,
+             catamari::SymmetricFactorizationType factorization_type,
+             const Field& shift) {
+  typedef catamari::ComplexBase<Field> Real;
+  const bool is_adjoint =
+      factorization_type != catamari::kLDLTransposeFactorization;
+
+  catamari::SparseLDLControl<Field> ldl_control;
+  ldl_control.SetFactorizationType(factorization_type);
+  ldl_control.supernodal_strategy = catamari::kSupernodalFactorization;
+
+  const catamari::CoordinateMatrix<Field> matrix =
+      ShiftedLaplacian(num_x_elements, num_y_elements, shift);
+  const Int num_rows = matrix.NumRows();
+
+  catamari::SparseLDL<Field> ldl;
+  const catamari::SparseLDLResult<Field> result =
+      ldl.Factor(matrix, ldl_control);
+  REQUIRE(result.num_successful_pivots == num_rows);
+
+  // Form a scaled unit vector along with vectors coupling horizontal
+  // neighbours along the bottom grid line.
+  const Int rank = std::min(Int(4), num_x_elements);
+  BlasMatrix<Field> vectors;
+  vectors.Resize(num_rows, rank, Field{0});
+  vectors(num_rows / 2, 0) = Field{0.5};
+  for (Int t = 1; t < rank; ++t) {
+    vectors(t - 1, t) = Field{0.5};
+    vectors(t, t) = Field{-0.25};
+  }
+
+  catamari::CoordinateMatrix<Field> updated_matrix = matrix;
+  updated_matrix.ReserveEntryAdditions(4 * rank);
+  for (Int t = 0; t < rank; ++t) {
+    for (Int i = 0; i < num_rows; ++i) {
+      if (vectors(i, t) == Field{0}) continue;
+      for (Int j = 0; j < num_rows; ++j) {
+        if (vectors(j, t) == Field{0}) continue;
+        const Field value =
+            is_adjoint ? catamari::Conjugate(vectors(j, t)) : vectors(j, t);
+        updated_matrix.QueueEntryAddition(i, j, vectors(i, t) * value);
+      }
+    }
+  }
+  updated_matrix.FlushEntryQueues();
+
+  const Real tolerance = 1e3 * std::numeric_limits<Real>::epsilon();
+  REQUIRE(ldl.UpdateDowndate(vectors.ConstView(), 1));
+  REQUIRE(RelativeResidual(updated_matrix, ldl) <= tolerance);
+
+  REQUIRE(ldl.UpdateDowndate(vectors.ConstView(), -1));
+  REQUIRE(RelativeResidual(matrix, ldl) <= tolerance);
+}
+
+}  // anonymous namespace
+
+TEST_CASE("Cholesky", "[Cholesky]") {
+  RunTest<double>(20, 15, catamari::kCholeskyFactorization, 0.1);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kCholeskyFactorization,
+                                   0.1);
+}
+
+TEST_CASE("Adjoint", "[Adjoint]") {
+  // A shift of -1 makes the matrix indefinite.
+  RunTest<double>(20, 15, catamari::kLDLAdjointFactorization, -1.);
+  RunTest<mantis::Complex<double>>(20, 15, catamari::kLDLAdjointFactorization,
+                                   -1.);
+}
+
+TEST_CASE("Transpose", "[Transpose]") {
+  RunTest<double>(20, 15, catamari::kLDLTransposeFactorization, -1.);
+  RunTest<mantis::Complex<double>>(
+      20, 15, catamari::kLDLTransposeFactorization,
+      mantis::Complex<double>(-1., 0.5));
+}